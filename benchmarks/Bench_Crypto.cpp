@@ -0,0 +1,126 @@
+#include "BenchmarkRunner.h"
+#include "BenchmarkData.h"
+
+#include <Core/Validation/KernelSignatureValidator.h>
+#include <Core/Validation/KernelSumValidator.h>
+#include <Crypto/Crypto.h>
+#include <Crypto/RangeProofVerifier.h>
+#include <memory>
+
+static SecretKey NextSecretKey(BenchmarkData& data)
+{
+	return SecretKey(data.NextBigInteger<32>());
+}
+
+//
+// Valid bulletproofs, which take tens of milliseconds each to build, so only the most any benchmark needs are built, once.
+//
+static std::shared_ptr<const std::vector<std::pair<Commitment, RangeProof>>> GetRangeProofs(const size_t numProofs)
+{
+	static std::vector<std::pair<Commitment, RangeProof>> rangeProofs;
+
+	while (rangeProofs.size() < numProofs)
+	{
+		// Seeded by index, so each proof is the same no matter which benchmarks are selected.
+		BenchmarkData data(1000 + rangeProofs.size());
+		const uint64_t amount = data.NextU64() % 1'000'000'000'000;
+		const SecretKey blindingFactor = NextSecretKey(data);
+		const Commitment commitment = Crypto::CommitBlinded(amount, BlindingFactor(blindingFactor.GetBytes()));
+		RangeProof rangeProof = Crypto::GenerateRangeProof(amount, blindingFactor, NextSecretKey(data), NextSecretKey(data), ProofMessage(data.NextBigInteger<20>()));
+		rangeProofs.emplace_back(std::make_pair(commitment, std::move(rangeProof)));
+	}
+
+	return std::make_shared<const std::vector<std::pair<Commitment, RangeProof>>>(rangeProofs.cbegin(), rangeProofs.cbegin() + numProofs);
+}
+
+static std::shared_ptr<const std::vector<TransactionKernel>> CreateSignedKernels(const size_t numKernels)
+{
+	BenchmarkData data(6);
+
+	auto pKernels = std::make_shared<std::vector<TransactionKernel>>();
+	pKernels->reserve(numKernels);
+	for (size_t i = 0; i < numKernels; i++)
+	{
+		const SecretKey excess = NextSecretKey(data);
+		const Commitment excessCommitment = Crypto::CommitBlinded(0, BlindingFactor(excess.GetBytes()));
+		const uint64_t fee = data.NextU64() % 100'000'000;
+
+		const TransactionKernel unsignedKernel(EKernelFeatures::DEFAULT_KERNEL, fee, 0, excessCommitment, Signature());
+		auto pSignature = Crypto::BuildCoinbaseSignature(excess, excessCommitment, unsignedKernel.GetSignatureMessage());
+		pKernels->emplace_back(TransactionKernel(EKernelFeatures::DEFAULT_KERNEL, fee, 0, excessCommitment, *pSignature));
+	}
+
+	return pKernels;
+}
+
+void RegisterCryptoBenchmarks(BenchmarkRunner& runner)
+{
+	// The batch verification Bulletproofs::VerifyBulletproofs performs for proofs that aren't in its cache.
+	// VerifyBulletproofs itself would only verify each proof on the first run, and then find it in the cache.
+	for (const size_t batchSize : { 1, 10, 100 })
+	{
+		runner.Add("RangeProofVerifier::Verify/" + std::to_string(batchSize) + "_proofs", batchSize, [batchSize]() {
+			auto pRangeProofs = GetRangeProofs(batchSize);
+			auto pVerifier = std::shared_ptr<RangeProofVerifier>(RangeProofVerifier::Create());
+
+			return BenchmarkRunner::Ops{ [pRangeProofs, pVerifier]() {
+				BenchmarkData::Require(pVerifier->Verify(*pRangeProofs), "Rangeproofs failed to verify");
+			} };
+		});
+	}
+
+	for (const size_t numKernels : { 1, 100, 1000 })
+	{
+		runner.Add("KernelSignatureValidator::VerifyKernelSignatures/" + std::to_string(numKernels) + "_kernels", numKernels, [numKernels]() {
+			auto pKernels = CreateSignedKernels(numKernels);
+
+			return BenchmarkRunner::Ops{ [pKernels]() {
+				BenchmarkData::Require(KernelSignatureValidator::VerifyKernelSignatures(*pKernels), "Kernel signatures failed to verify");
+			} };
+		});
+	}
+
+	runner.Add("KernelSignatureValidator::VerifyKernelSignaturesParallel/10000_kernels", 10000, []() {
+		auto pKernels = CreateSignedKernels(10000);
+
+		return BenchmarkRunner::Ops{ [pKernels]() {
+			BenchmarkData::Require(KernelSignatureValidator::VerifyKernelSignaturesParallel(*pKernels), "Kernel signatures failed to verify");
+		} };
+	});
+
+	// Outputs, inputs and kernels that balance, for numOutputs 1 input, 1 output transactions with a total offset.
+	for (const size_t numOutputs : { 100, 10000 })
+	{
+		runner.Add("KernelSumValidator::ValidateKernelSums/" + std::to_string(numOutputs) + "_outputs", numOutputs, [numOutputs]() {
+			// Parsed commitments would otherwise be cached after the first run.
+			Crypto::SetCommitmentCacheCapacity(0);
+
+			BenchmarkData data(7);
+			const BlindingFactor offset(NextSecretKey(data).GetBytes());
+
+			auto pInputs = std::make_shared<std::vector<Commitment>>();
+			auto pOutputs = std::make_shared<std::vector<Commitment>>();
+			auto pKernels = std::make_shared<std::vector<Commitment>>();
+			for (size_t i = 0; i < numOutputs; i++)
+			{
+				const uint64_t amount = data.NextU64() % 1'000'000'000'000;
+				const BlindingFactor inputBlind(NextSecretKey(data).GetBytes());
+				const BlindingFactor outputBlind(NextSecretKey(data).GetBytes());
+				pInputs->push_back(Crypto::CommitBlinded(amount, inputBlind));
+				pOutputs->push_back(Crypto::CommitBlinded(amount, outputBlind));
+
+				std::vector<BlindingFactor> negative{ inputBlind };
+				if (i == numOutputs - 1)
+				{
+					negative.push_back(offset);
+				}
+
+				pKernels->push_back(Crypto::CommitBlinded(0, Crypto::AddBlindingFactors({ outputBlind }, negative)));
+			}
+
+			return BenchmarkRunner::Ops{ [pInputs, pOutputs, pKernels, offset]() {
+				KernelSumValidator::ValidateKernelSums(*pInputs, *pOutputs, *pKernels, 0, offset, std::nullopt);
+			} };
+		});
+	}
+}
@@ -0,0 +1,62 @@
+#include "BenchmarkRunner.h"
+#include "BenchmarkData.h"
+
+#include <PMMR/Common/HashFile.h>
+#include <PMMR/Common/MMRHashUtil.h>
+#include <PMMR/Common/MMRUtil.h>
+
+// The size of a serialized OutputIdentifier.
+static constexpr size_t LEAF_SIZE = 34;
+
+static std::vector<std::vector<unsigned char>> CreateLeaves(BenchmarkData& data, const size_t numLeaves)
+{
+	std::vector<std::vector<unsigned char>> leaves;
+	leaves.reserve(numLeaves);
+	for (size_t i = 0; i < numLeaves; i++)
+	{
+		leaves.emplace_back(data.NextBytes(LEAF_SIZE));
+	}
+
+	return leaves;
+}
+
+void RegisterMMRBenchmarks(BenchmarkRunner& runner)
+{
+	// The leaves are appended to an MMR that already has 100,000 leaves, and discarded after each run.
+	for (const size_t numLeaves : { 1, 1000, 10000 })
+	{
+		runner.Add("MMRHashUtil::AddHashes/" + std::to_string(numLeaves) + "_leaves", numLeaves, [numLeaves]() {
+			BenchmarkData data(3);
+			std::shared_ptr<HashFile> pHashFile = HashFile::Load(BenchmarkData::CreateTempDirectory("AddHashes") / "pmmr_hash.bin");
+			MMRHashUtil::AddHashes(pHashFile, CreateLeaves(data, 100'000), nullptr);
+			pHashFile->Commit();
+
+			auto pLeaves = std::make_shared<const std::vector<std::vector<unsigned char>>>(CreateLeaves(data, numLeaves));
+			const uint64_t expectedSize = MMRUtil::GetNumNodes(MMRUtil::GetPMMRIndex(100'000 + numLeaves - 1));
+
+			return BenchmarkRunner::Ops{
+				[pHashFile, pLeaves, expectedSize]() {
+					MMRHashUtil::AddHashes(pHashFile, *pLeaves, nullptr);
+					BenchmarkData::Require(pHashFile->GetSize() == expectedSize, "Unexpected MMR size");
+				},
+				[pHashFile]() { pHashFile->Rollback(); }
+			};
+		});
+	}
+
+	for (const size_t numLeaves : { 1000, 100'000 })
+	{
+		runner.Add("MMRHashUtil::Root/" + std::to_string(numLeaves) + "_leaves", 1, [numLeaves]() {
+			BenchmarkData data(4);
+			std::shared_ptr<HashFile> pHashFile = HashFile::Load(BenchmarkData::CreateTempDirectory("Root") / "pmmr_hash.bin");
+			MMRHashUtil::AddHashes(pHashFile, CreateLeaves(data, numLeaves), nullptr);
+			pHashFile->Commit();
+
+			const uint64_t size = pHashFile->GetSize();
+
+			return BenchmarkRunner::Ops{ [pHashFile, size]() {
+				BenchmarkData::Require(MMRHashUtil::Root(pHashFile, size, nullptr) != ZERO_HASH, "Empty root");
+			} };
+		});
+	}
+}
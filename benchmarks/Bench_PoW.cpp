@@ -0,0 +1,49 @@
+#include "BenchmarkRunner.h"
+#include "BenchmarkData.h"
+
+#include <Config/Genesis.h>
+#include <Crypto/Hasher.h>
+#include <PoW/Common.h>
+#include <PoW/Cuckaroo.h>
+
+static void AddVerifierBenchmark(
+	BenchmarkRunner& runner,
+	const std::string& name,
+	const BlockHeaderPtr& pHeader,
+	const std::function<bool(const BlockHeader&)>& validate)
+{
+	runner.Add(name, 1, [pHeader, validate]() {
+		return BenchmarkRunner::Ops{ [pHeader, validate]() {
+			BenchmarkData::Require(validate(*pHeader), "Proof of work failed to validate");
+		} };
+	});
+}
+
+template <int rotE>
+static void AddSipblocksBenchmark(BenchmarkRunner& runner, const std::string& name)
+{
+	runner.Add(name, PROOFSIZE, []() {
+		const BlockHeaderPtr pHeader = Genesis::MAINNET_GENESIS.GetHeader();
+		const Hash prePoWHash = Hasher::Blake2b(pHeader->GetPreProofOfWork());
+		auto pKeys = std::make_shared<siphash_keys>((const char*)prePoWHash.data());
+		auto pEdges = std::make_shared<const std::vector<uint64_t>>(pHeader->GetProofOfWork().GetProofNonces());
+		auto pBufs = std::make_shared<std::vector<u64[EDGE_BLOCK_SIZE]>>(PROOFSIZE);
+
+		return BenchmarkRunner::Ops{ [pKeys, pEdges, pBufs]() {
+			sipblocks<rotE>(*pKeys, pEdges->data(), PROOFSIZE, pBufs->data());
+			BenchmarkData::Require(sipblock_edge((*pBufs)[0], (*pEdges)[0]) != 0, "Empty siphash output");
+		} };
+	});
+}
+
+void RegisterPoWBenchmarks(BenchmarkRunner& runner)
+{
+	// Both genesis blocks have valid Cuckaroo29 proofs.
+	AddVerifierBenchmark(runner, "Cuckaroo::Validate/mainnet_genesis", Genesis::MAINNET_GENESIS.GetHeader(), Cuckaroo::Validate);
+	AddVerifierBenchmark(runner, "Cuckaroo::Validate/floonet_genesis", Genesis::FLOONET_GENESIS.GetHeader(), Cuckaroo::Validate);
+
+	// There are no valid proofs for the other variants in the tree, and rejecting an invalid one can stop
+	// before any hashing, so the siphash block generation they all spend their time in is measured instead.
+	AddSipblocksBenchmark<21>(runner, "sipblocks/cuckaroo_42_edges");
+	AddSipblocksBenchmark<25>(runner, "sipblocks/cuckarood_42_edges");
+}
@@ -0,0 +1,128 @@
+#include "BenchmarkRunner.h"
+#include "BenchmarkData.h"
+
+#include <Config/Genesis.h>
+#include <TxPool/Pool.h>
+#include <algorithm>
+#include <memory>
+
+static constexpr size_t NUM_TRANSACTIONS = 10'000;
+
+static std::shared_ptr<const std::vector<TransactionPtr>> CreateTransactions()
+{
+	BenchmarkData data(8);
+
+	auto pTransactions = std::make_shared<std::vector<TransactionPtr>>();
+	pTransactions->reserve(NUM_TRANSACTIONS);
+	for (size_t i = 0; i < NUM_TRANSACTIONS; i++)
+	{
+		pTransactions->push_back(data.NextTransaction(1, 2, 1 + data.NextU64() % 100'000'000));
+	}
+
+	return pTransactions;
+}
+
+static std::shared_ptr<Pool> CreatePool(const std::vector<TransactionPtr>& transactions)
+{
+	auto pPool = std::make_shared<Pool>();
+	for (const TransactionPtr& pTransaction : transactions)
+	{
+		pPool->AddTransaction(pTransaction, EDandelionStatus::FLUFFED);
+	}
+
+	return pPool;
+}
+
+void RegisterPoolBenchmarks(BenchmarkRunner& runner)
+{
+	runner.Add("Pool::AddTransaction/10000_transactions", NUM_TRANSACTIONS, []() {
+		auto pTransactions = CreateTransactions();
+		auto pPool = std::make_shared<Pool>();
+
+		return BenchmarkRunner::Ops{
+			[pTransactions, pPool]() {
+				for (const TransactionPtr& pTransaction : *pTransactions)
+				{
+					pPool->AddTransaction(pTransaction, EDandelionStatus::FLUFFED);
+				}
+			},
+			[pPool]() { pPool->Clear(); }
+		};
+	});
+
+	runner.Add("Pool::FindTransactionsByKernel/1000_of_10000", 1000, []() {
+		auto pTransactions = CreateTransactions();
+		auto pPool = CreatePool(*pTransactions);
+
+		auto pKernels = std::make_shared<std::set<TransactionKernel>>();
+		for (size_t i = 0; i < 1000; i++)
+		{
+			pKernels->insert(pTransactions->at(i * 10)->GetKernels().front());
+		}
+
+		return BenchmarkRunner::Ops{ [pPool, pKernels]() {
+			BenchmarkData::Require(pPool->FindTransactionsByKernel(*pKernels).size() == 1000, "Transactions not found");
+		} };
+	});
+
+	runner.Add("Pool::FindTransactionByOutput/10000_transactions", NUM_TRANSACTIONS, []() {
+		auto pTransactions = CreateTransactions();
+		auto pPool = CreatePool(*pTransactions);
+
+		return BenchmarkRunner::Ops{ [pTransactions, pPool]() {
+			for (const TransactionPtr& pTransaction : *pTransactions)
+			{
+				BenchmarkData::Require(pPool->FindTransactionByOutput(pTransaction->GetOutputs().back().GetCommitment()) != nullptr, "Transaction not found");
+			}
+		} };
+	});
+
+	runner.Add("Pool::GetTransactionsByFeeRate/10000_transactions", NUM_TRANSACTIONS, []() {
+		auto pPool = CreatePool(*CreateTransactions());
+
+		return BenchmarkRunner::Ops{ [pPool]() {
+			BenchmarkData::Require(pPool->GetTransactionsByFeeRate().size() == NUM_TRANSACTIONS, "Transactions missing");
+		} };
+	});
+
+	// A block that mines 1000 of the pool's transactions, which are restored after each run.
+	runner.Add("Pool::ReconcileBlock/1000_of_10000", 1000, []() {
+		auto pTransactions = CreateTransactions();
+		auto pPool = CreatePool(*pTransactions);
+
+		std::vector<TransactionInput> inputs;
+		std::vector<TransactionOutput> outputs;
+		std::vector<TransactionKernel> kernels;
+		auto pMined = std::make_shared<std::vector<TransactionPtr>>();
+		for (size_t i = 0; i < 1000; i++)
+		{
+			const TransactionPtr& pTransaction = pTransactions->at(i * 10);
+			const std::vector<TransactionInput>& txInputs = pTransaction->GetInputs();
+			const std::vector<TransactionOutput>& txOutputs = pTransaction->GetOutputs();
+			inputs.insert(inputs.end(), txInputs.cbegin(), txInputs.cend());
+			outputs.insert(outputs.end(), txOutputs.cbegin(), txOutputs.cend());
+			kernels.push_back(pTransaction->GetKernels().front());
+			pMined->push_back(pTransaction);
+		}
+
+		std::sort(inputs.begin(), inputs.end());
+		std::sort(outputs.begin(), outputs.end());
+		std::sort(kernels.begin(), kernels.end());
+		auto pBlock = std::make_shared<const FullBlock>(
+			Genesis::MAINNET_GENESIS.GetHeader(),
+			TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels))
+		);
+
+		return BenchmarkRunner::Ops{
+			[pPool, pBlock]() {
+				BenchmarkData::Require(pPool->ReconcileBlock(*pBlock, {}).mined.size() == 1000, "Transactions not mined");
+			},
+			[pPool, pMined]() {
+				for (const TransactionPtr& pTransaction : *pMined)
+				{
+					pPool->AddTransaction(pTransaction, EDandelionStatus::FLUFFED);
+				}
+			}
+		};
+	});
+}
@@ -0,0 +1,107 @@
+#include "BenchmarkRunner.h"
+#include "BenchmarkData.h"
+
+#include <Config/Genesis.h>
+#include <Core/Models/FullBlock.h>
+#include <Core/Serialization/Base58.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Serialization/Serializer.h>
+#include <memory>
+
+static constexpr size_t NUM_HEADERS = 1000;
+
+static void AddBlockBenchmarks(BenchmarkRunner& runner, const std::string& name, const std::function<FullBlock()>& createBlock)
+{
+	runner.Add("FullBlock::Serialize/" + name, 1, [createBlock]() {
+		auto pBlock = std::make_shared<FullBlock>(createBlock());
+
+		Serializer reference;
+		pBlock->Serialize(reference);
+		const size_t size = reference.size();
+
+		return BenchmarkRunner::Ops{ [pBlock, size]() {
+			Serializer serializer(size);
+			pBlock->Serialize(serializer);
+			BenchmarkData::Require(serializer.size() == size, "Unexpected block size");
+		} };
+	});
+
+	runner.Add("FullBlock::Deserialize/" + name, 1, [createBlock]() {
+		Serializer serializer;
+		createBlock().Serialize(serializer);
+		auto pBytes = std::make_shared<const std::vector<uint8_t>>(serializer.GetBytes());
+
+		return BenchmarkRunner::Ops{ [pBytes]() {
+			ByteBuffer byteBuffer(pBytes->data(), pBytes->size());
+			const FullBlock block = FullBlock::Deserialize(byteBuffer);
+			BenchmarkData::Require(byteBuffer.GetIndex() == pBytes->size(), "Block not fully read");
+		} };
+	});
+}
+
+void RegisterSerializationBenchmarks(BenchmarkRunner& runner)
+{
+	AddBlockBenchmarks(runner, "genesis", []() { return Genesis::MAINNET_GENESIS; });
+
+	// About the size of a full block's body.
+	AddBlockBenchmarks(runner, "1000_inputs_1000_outputs_500_kernels", []() {
+		BenchmarkData data(1);
+		return data.NextBlock(Genesis::MAINNET_GENESIS.GetHeader(), 1000, 1000, 500);
+	});
+
+	runner.Add("BlockHeader::Serialize", NUM_HEADERS, []() {
+		const BlockHeaderPtr pHeader = Genesis::MAINNET_GENESIS.GetHeader();
+
+		return BenchmarkRunner::Ops{ [pHeader]() {
+			Serializer serializer;
+			for (size_t i = 0; i < NUM_HEADERS; i++)
+			{
+				pHeader->Serialize(serializer);
+			}
+
+			BenchmarkData::Require(serializer.size() > 0, "Nothing serialized");
+		} };
+	});
+
+	runner.Add("BlockHeader::Deserialize", NUM_HEADERS, []() {
+		Serializer serializer;
+		for (size_t i = 0; i < NUM_HEADERS; i++)
+		{
+			Genesis::MAINNET_GENESIS.GetHeader()->Serialize(serializer);
+		}
+
+		auto pBytes = std::make_shared<const std::vector<uint8_t>>(serializer.GetBytes());
+
+		return BenchmarkRunner::Ops{ [pBytes]() {
+			ByteBuffer byteBuffer(pBytes->data(), pBytes->size());
+			for (size_t i = 0; i < NUM_HEADERS; i++)
+			{
+				BlockHeader::Deserialize(byteBuffer);
+			}
+
+			BenchmarkData::Require(byteBuffer.GetIndex() == pBytes->size(), "Headers not fully read");
+		} };
+	});
+
+	for (const size_t numBytes : { 32, 64 })
+	{
+		runner.Add("Base58::EncodeCheck/" + std::to_string(numBytes) + "_bytes", 1, [numBytes]() {
+			BenchmarkData data(2);
+			auto pBytes = std::make_shared<const std::vector<uint8_t>>(data.NextBytes(numBytes));
+
+			return BenchmarkRunner::Ops{ [pBytes]() {
+				BenchmarkData::Require(!Base58::EncodeCheck(*pBytes).empty(), "Nothing encoded");
+			} };
+		});
+
+		runner.Add("Base58::DecodeCheck/" + std::to_string(numBytes) + "_bytes", 1, [numBytes]() {
+			BenchmarkData data(2);
+			const std::vector<uint8_t> bytes = data.NextBytes(numBytes);
+			auto pEncoded = std::make_shared<const std::string>(Base58::EncodeCheck(bytes));
+
+			return BenchmarkRunner::Ops{ [pEncoded, numBytes]() {
+				BenchmarkData::Require(Base58::DecodeCheck(*pEncoded).size() == numBytes, "Decoding failed");
+			} };
+		});
+	}
+}
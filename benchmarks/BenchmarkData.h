@@ -0,0 +1,142 @@
+#pragma once
+
+#include <Core/Models/FullBlock.h>
+#include <Core/Models/Transaction.h>
+#include <Crypto/BigInteger.h>
+#include <Crypto/Commitment.h>
+#include <Crypto/RangeProof.h>
+#include <Crypto/Signature.h>
+#include <filesystem.h>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//
+// Inputs for the benchmarks, generated from a fixed seed so every run measures the same data.
+//
+class BenchmarkData
+{
+public:
+	static constexpr size_t RANGE_PROOF_SIZE = 675;
+
+	explicit BenchmarkData(const uint64_t seed) : m_random(seed) { }
+
+	uint64_t NextU64() { return m_random(); }
+
+	std::vector<uint8_t> NextBytes(const size_t numBytes)
+	{
+		std::vector<uint8_t> bytes(numBytes);
+		for (uint8_t& byte : bytes)
+		{
+			byte = (uint8_t)m_random();
+		}
+
+		return bytes;
+	}
+
+	template<size_t NUM_BYTES>
+	CBigInteger<NUM_BYTES> NextBigInteger()
+	{
+		return CBigInteger<NUM_BYTES>(NextBytes(NUM_BYTES));
+	}
+
+	//
+	// The transactions below are well-formed, so they serialize and index like real ones,
+	// but their commitments, proofs and signatures are random bytes that don't verify.
+	//
+	Commitment NextCommitment()
+	{
+		std::vector<uint8_t> bytes = NextBytes(33);
+		bytes[0] = 0x08 + (bytes[0] & 1);
+		return Commitment(CBigInteger<33>(std::move(bytes)));
+	}
+
+	TransactionOutput NextOutput()
+	{
+		return TransactionOutput(EOutputFeatures::DEFAULT, NextCommitment(), RangeProof(NextBytes(RANGE_PROOF_SIZE)));
+	}
+
+	TransactionKernel NextKernel(const uint64_t fee)
+	{
+		return TransactionKernel(EKernelFeatures::DEFAULT_KERNEL, fee, 0, NextCommitment(), Signature(NextBigInteger<64>()));
+	}
+
+	TransactionPtr NextTransaction(const size_t numInputs, const size_t numOutputs, const uint64_t fee)
+	{
+		std::vector<TransactionInput> inputs;
+		for (size_t i = 0; i < numInputs; i++)
+		{
+			inputs.emplace_back(TransactionInput(EOutputFeatures::DEFAULT, NextCommitment()));
+		}
+
+		std::vector<TransactionOutput> outputs;
+		for (size_t i = 0; i < numOutputs; i++)
+		{
+			outputs.emplace_back(NextOutput());
+		}
+
+		std::vector<TransactionKernel> kernels{ NextKernel(fee) };
+
+		return std::make_shared<Transaction>(
+			BlindingFactor(NextBigInteger<32>()),
+			TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels))
+		);
+	}
+
+	//
+	// A block with the header of the given block, and a body of the given size.
+	//
+	FullBlock NextBlock(const BlockHeaderPtr& pHeader, const size_t numInputs, const size_t numOutputs, const size_t numKernels)
+	{
+		std::vector<TransactionInput> inputs;
+		for (size_t i = 0; i < numInputs; i++)
+		{
+			inputs.emplace_back(TransactionInput(EOutputFeatures::DEFAULT, NextCommitment()));
+		}
+
+		std::vector<TransactionOutput> outputs;
+		for (size_t i = 0; i < numOutputs; i++)
+		{
+			outputs.emplace_back(NextOutput());
+		}
+
+		std::vector<TransactionKernel> kernels;
+		for (size_t i = 0; i < numKernels; i++)
+		{
+			kernels.emplace_back(NextKernel(NextU64() % 100'000'000));
+		}
+
+		return FullBlock(pHeader, TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels)));
+	}
+
+	//
+	// An empty directory for files a benchmark writes, replacing any left over from a previous run.
+	//
+	static fs::path CreateTempDirectory(const std::string& name)
+	{
+		const fs::path directory = fs::temp_directory_path() / "GrinPP_Benchmarks" / name;
+
+		std::error_code error;
+		fs::remove_all(directory, error);
+		fs::create_directories(directory, error);
+		if (error)
+		{
+			throw std::runtime_error("Failed to create " + directory.u8string());
+		}
+
+		return directory;
+	}
+
+	static void Require(const bool condition, const std::string& message)
+	{
+		if (!condition)
+		{
+			throw std::runtime_error(message);
+		}
+	}
+
+private:
+	std::mt19937_64 m_random;
+};
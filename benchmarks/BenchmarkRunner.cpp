@@ -0,0 +1,160 @@
+#include "BenchmarkRunner.h"
+
+#include <Core/Util/JsonUtil.h>
+#include <Common/Util/FileUtil.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <numeric>
+
+void BenchmarkRunner::Add(const std::string& name, const uint64_t itemsPerRun, const std::function<Ops()>& setup)
+{
+	m_benchmarks.push_back(Benchmark{ name, itemsPerRun, setup });
+}
+
+int BenchmarkRunner::Run(const Options& options) const
+{
+	std::vector<Result> results;
+	bool failed = false;
+
+	if (!options.listOnly)
+	{
+		std::printf("%-56s %14s %14s %14s %14s\n", "Benchmark", "median ns/run", "min ns/run", "mean ns/run", "median ns/item");
+	}
+
+	for (const Benchmark& benchmark : m_benchmarks)
+	{
+		if (benchmark.name.find(options.filter) == std::string::npos)
+		{
+			continue;
+		}
+
+		if (options.listOnly)
+		{
+			std::printf("%s\n", benchmark.name.c_str());
+			continue;
+		}
+
+		try
+		{
+			const Ops ops = benchmark.setup();
+			const Result result = Measure(benchmark, ops, options);
+
+			std::vector<double> sorted = result.samples;
+			std::sort(sorted.begin(), sorted.end());
+			const double median = sorted[sorted.size() / 2];
+			const double mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+
+			std::printf(
+				"%-56s %14.0f %14.0f %14.0f %14.1f\n",
+				benchmark.name.c_str(),
+				median,
+				sorted.front(),
+				mean,
+				median / benchmark.itemsPerRun
+			);
+			std::fflush(stdout);
+
+			results.push_back(result);
+		}
+		catch (std::exception& e)
+		{
+			std::printf("%-56s FAILED: %s\n", benchmark.name.c_str(), e.what());
+			failed = true;
+		}
+	}
+
+	if (!options.listOnly && options.jsonPath.has_value())
+	{
+		WriteJSON(results, options);
+	}
+
+	return failed ? 1 : 0;
+}
+
+BenchmarkRunner::Result BenchmarkRunner::Measure(const Benchmark& benchmark, const Ops& ops, const Options& options)
+{
+	using Clock = std::chrono::steady_clock;
+	const auto minSampleTime = std::chrono::milliseconds(options.minSampleMs);
+
+	// Without a reset, runs are timed together rather than one at a time.
+	// The number of runs per sample doubles until a sample takes minSampleTime, which also warms up the caches.
+	auto timeRuns = [&ops](const uint64_t numRuns) -> Clock::duration {
+		Clock::duration elapsed{ 0 };
+		if (ops.reset)
+		{
+			for (uint64_t run = 0; run < numRuns; run++)
+			{
+				ops.reset();
+				const auto start = Clock::now();
+				ops.run();
+				elapsed += Clock::now() - start;
+			}
+		}
+		else
+		{
+			const auto start = Clock::now();
+			for (uint64_t run = 0; run < numRuns; run++)
+			{
+				ops.run();
+			}
+			elapsed = Clock::now() - start;
+		}
+
+		return elapsed;
+	};
+
+	uint64_t runsPerSample = 1;
+	Clock::duration elapsed = timeRuns(runsPerSample);
+	while (elapsed < minSampleTime)
+	{
+		runsPerSample *= 2;
+		elapsed = timeRuns(runsPerSample);
+	}
+
+	Result result{ benchmark.name, benchmark.itemsPerRun, runsPerSample, {} };
+	result.samples.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / runsPerSample);
+	while (result.samples.size() < (std::max<size_t>)(options.samples, 1))
+	{
+		elapsed = timeRuns(runsPerSample);
+		result.samples.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / runsPerSample);
+	}
+
+	return result;
+}
+
+void BenchmarkRunner::WriteJSON(const std::vector<Result>& results, const Options& options)
+{
+	Json::Value json;
+	json["samples"] = (Json::UInt64)options.samples;
+	json["min_sample_ms"] = (Json::UInt64)options.minSampleMs;
+
+	Json::Value benchmarksJSON(Json::arrayValue);
+	for (const Result& result : results)
+	{
+		std::vector<double> sorted = result.samples;
+		std::sort(sorted.begin(), sorted.end());
+		const double median = sorted[sorted.size() / 2];
+
+		Json::Value resultJSON;
+		resultJSON["name"] = result.name;
+		resultJSON["items_per_run"] = (Json::UInt64)result.itemsPerRun;
+		resultJSON["runs_per_sample"] = (Json::UInt64)result.runsPerSample;
+		resultJSON["median_ns"] = median;
+		resultJSON["min_ns"] = sorted.front();
+		resultJSON["mean_ns"] = std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+		resultJSON["median_ns_per_item"] = median / result.itemsPerRun;
+
+		Json::Value samplesJSON(Json::arrayValue);
+		for (const double sample : result.samples)
+		{
+			samplesJSON.append(sample);
+		}
+		resultJSON["samples_ns"] = samplesJSON;
+
+		benchmarksJSON.append(resultJSON);
+	}
+	json["benchmarks"] = benchmarksJSON;
+
+	FileUtil::WriteTextToFile(options.jsonPath.value(), JsonUtil::WriteCondensed(json));
+}
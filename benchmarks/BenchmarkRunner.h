@@ -0,0 +1,80 @@
+#pragma once
+
+#include <filesystem.h>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+//
+// Times registered benchmarks and reports their results as a table, and optionally as JSON for comparing releases.
+//
+// Each sample repeats a benchmark until at least minSampleMs have been timed, and the per-run median, minimum, and mean
+// are reported across samples. Benchmarks with a reset function are reset before every run, outside of the timed region.
+//
+class BenchmarkRunner
+{
+public:
+	struct Options
+	{
+		// Only benchmarks whose name contains the filter are run.
+		std::string filter;
+		size_t samples = 10;
+		uint64_t minSampleMs = 100;
+		std::optional<fs::path> jsonPath;
+		bool listOnly = false;
+	};
+
+	struct Ops
+	{
+		// Timed. Throws if the result isn't what was expected, which also keeps the work from being optimized away.
+		std::function<void()> run;
+
+		// Not timed. Restores any state changed by run. Optional.
+		std::function<void()> reset;
+	};
+
+	//
+	// setup builds the benchmark's inputs, and is only called if the benchmark is selected.
+	// itemsPerRun is how many items (eg. proofs or headers) each run processes, for reporting the time per item.
+	//
+	void Add(const std::string& name, const uint64_t itemsPerRun, const std::function<Ops()>& setup);
+
+	//
+	// Returns the process exit code: non-zero if any benchmark failed.
+	//
+	int Run(const Options& options) const;
+
+private:
+	struct Benchmark
+	{
+		std::string name;
+		uint64_t itemsPerRun;
+		std::function<Ops()> setup;
+	};
+
+	struct Result
+	{
+		std::string name;
+		uint64_t itemsPerRun;
+		uint64_t runsPerSample;
+
+		// Nanoseconds per run for each sample.
+		std::vector<double> samples;
+	};
+
+	static Result Measure(const Benchmark& benchmark, const Ops& ops, const Options& options);
+	static void WriteJSON(const std::vector<Result>& results, const Options& options);
+
+	std::vector<Benchmark> m_benchmarks;
+};
+
+//
+// Every benchmark file registers its benchmarks with one of these.
+//
+void RegisterSerializationBenchmarks(BenchmarkRunner& runner);
+void RegisterMMRBenchmarks(BenchmarkRunner& runner);
+void RegisterCryptoBenchmarks(BenchmarkRunner& runner);
+void RegisterPoWBenchmarks(BenchmarkRunner& runner);
+void RegisterPoolBenchmarks(BenchmarkRunner& runner);
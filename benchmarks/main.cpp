@@ -0,0 +1,75 @@
+#include "BenchmarkRunner.h"
+
+#include <cstdio>
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+static void PrintUsage()
+{
+	printf("Usage: benchmarks [--list] [--filter=<substring>] [--samples=<n>] [--min-time-ms=<ms>] [--json=<path>]\n");
+}
+
+static bool ParseArg(const char* arg, const char* name, std::string& value)
+{
+	const size_t length = strlen(name);
+	if (strncmp(arg, name, length) != 0 || arg[length] != '=')
+	{
+		return false;
+	}
+
+	value = std::string(arg + length + 1);
+	return true;
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkRunner::Options options;
+
+	try
+	{
+		for (int i = 1; i < argc; i++)
+		{
+			std::string value;
+			if (strcmp(argv[i], "--list") == 0)
+			{
+				options.listOnly = true;
+			}
+			else if (ParseArg(argv[i], "--filter", value))
+			{
+				options.filter = value;
+			}
+			else if (ParseArg(argv[i], "--samples", value))
+			{
+				options.samples = (std::max)((size_t)std::stoul(value), (size_t)1);
+			}
+			else if (ParseArg(argv[i], "--min-time-ms", value))
+			{
+				options.minSampleMs = std::stoull(value);
+			}
+			else if (ParseArg(argv[i], "--json", value))
+			{
+				options.jsonPath = fs::u8path(value);
+			}
+			else
+			{
+				PrintUsage();
+				return -1;
+			}
+		}
+	}
+	catch (std::exception&)
+	{
+		PrintUsage();
+		return -1;
+	}
+
+	BenchmarkRunner runner;
+	RegisterSerializationBenchmarks(runner);
+	RegisterMMRBenchmarks(runner);
+	RegisterCryptoBenchmarks(runner);
+	RegisterPoWBenchmarks(runner);
+	RegisterPoolBenchmarks(runner);
+
+	return runner.Run(options);
+}
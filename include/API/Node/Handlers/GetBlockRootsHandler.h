@@ -0,0 +1,59 @@
+#pragma once
+
+#include <BlockChain/BlockChain.h>
+#include <Core/Exceptions/TxHashSetException.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+#include <API/Wallet/Owner/Models/Errors.h>
+
+//
+// Returns the output, rangeproof, and kernel roots and MMR sizes for a block body on top of the confirmed tip,
+// so a miner can build the header for a block template (see get_block_template) plus its coinbase.
+// The roots are calculated in memory from the MMRs' peaks, so this is cheap enough to call on every template refresh.
+//
+class GetBlockRootsHandler : public RPCMethod
+{
+public:
+	GetBlockRootsHandler(const IBlockChain::Ptr& pBlockChain)
+		: m_pBlockChain(pBlockChain) { }
+	~GetBlockRootsHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		if (!request.GetParams().has_value()) {
+			return request.BuildError(RPC::Errors::PARAMS_MISSING);
+		}
+
+		const Json::Value params = request.GetParams().value();
+		if (!params.isArray() || params.size() < 1 || !params[0].isObject()) {
+			return request.BuildError("INVALID_PARAMS", "Expected parameters: body");
+		}
+
+		const TransactionBody body = TransactionBody::FromJSON(params[0]);
+
+		try
+		{
+			const TxHashSetRoots roots = m_pBlockChain->GetBlockRoots(body);
+
+			Json::Value result;
+			result["output_root"] = roots.GetOutputInfo().root.ToHex();
+			result["range_proof_root"] = roots.GetRangeProofInfo().root.ToHex();
+			result["kernel_root"] = roots.GetKernelInfo().root.ToHex();
+			result["output_mmr_size"] = roots.GetOutputInfo().size;
+			result["kernel_mmr_size"] = roots.GetKernelInfo().size;
+
+			Json::Value ok;
+			ok["Ok"] = result;
+			return request.BuildResult(ok);
+		}
+		catch (const TxHashSetException& e)
+		{
+			return request.BuildError("INVALID_BODY", e.what());
+		}
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+
+private:
+	IBlockChain::Ptr m_pBlockChain;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <BlockChain/BlockChain.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+
+//
+// Returns the mempool txs a miner should include in the next block, selected by fee rate and aggregated into one tx.
+// The miner adds its own coinbase (see build_coinbase in the wallet's foreign API) before calculating the roots.
+//
+class GetBlockTemplateHandler : public RPCMethod
+{
+public:
+	GetBlockTemplateHandler(const IBlockChain::Ptr& pBlockChain)
+		: m_pBlockChain(pBlockChain) { }
+	~GetBlockTemplateHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		BlockTemplate::CPtr pTemplate = m_pBlockChain->GetBlockTemplate();
+
+		Json::Value result;
+		result["Ok"] = pTemplate->ToJSON();
+		return request.BuildResult(result);
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+
+private:
+	IBlockChain::Ptr m_pBlockChain;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <Common/CacheStats.h>
+#include <Crypto/Crypto.h>
+#include <PoW/PoWManager.h>
+#include <P2P/P2PServer.h>
+#include <BlockChain/BlockChain.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+#include <Net/Util/ResponseCache.h>
+
+class GetCacheStatsHandler : public RPCMethod
+{
+public:
+	GetCacheStatsHandler(const IBlockChain::Ptr& pBlockChain, const IP2PServerPtr& pP2PServer, const ResponseCache::Ptr& pResponseCache)
+		: m_pBlockChain(pBlockChain), m_pP2PServer(pP2PServer), m_pResponseCache(pResponseCache) { }
+	~GetCacheStatsHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		Json::Value statsJson;
+		statsJson["rangeproofs"] = ToJSON(Crypto::GetRangeProofCacheStats());
+		statsJson["kernel_signatures"] = ToJSON(Crypto::GetKernelSignatureCacheStats());
+		statsJson["pow_proofs"] = ToJSON(PoWManager::GetProofCacheStats());
+
+		Json::Value headersJson = ToJSON(m_pP2PServer->GetHeaderCacheStats());
+		headersJson["served_bytes_per_second"] = Json::UInt64(m_pP2PServer->GetServedHeaderBytesPerSecond());
+		statsJson["headers"] = headersJson;
+		statsJson["serialized_blocks"] = ToJSON(m_pBlockChain->GetSerializedBlockCacheStats());
+		statsJson["api_responses"] = ToJSON(m_pResponseCache->GetStats());
+
+		Json::Value result;
+		result["Ok"] = statsJson;
+		return request.BuildResult(result);
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+
+private:
+	static Json::Value ToJSON(const CacheStats& stats)
+	{
+		Json::Value json;
+		json["capacity"] = Json::UInt64(stats.capacity);
+		json["size"] = Json::UInt64(stats.size);
+		json["hits"] = Json::UInt64(stats.hits);
+		json["misses"] = Json::UInt64(stats.misses);
+
+		const uint64_t lookups = stats.hits + stats.misses;
+		json["hit_ratio"] = lookups > 0 ? (double)stats.hits / lookups : 0.0;
+		return json;
+	}
+
+	IBlockChain::Ptr m_pBlockChain;
+	IP2PServerPtr m_pP2PServer;
+	ResponseCache::Ptr m_pResponseCache;
+};
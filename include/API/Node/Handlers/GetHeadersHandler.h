@@ -0,0 +1,52 @@
+#pragma once
+
+#include <P2P/P2PServer.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+#include <API/Wallet/Owner/Models/Errors.h>
+
+//
+// Returns up to max (at most IP2PServer::MAX_HEADERS_PER_REQUEST) candidate chain headers starting at start_height,
+// from the P2P server's cache of serialized headers.
+//
+class GetHeadersHandler : public RPCMethod
+{
+public:
+	GetHeadersHandler(const IP2PServerPtr& pP2PServer)
+		: m_pP2PServer(pP2PServer) { }
+	~GetHeadersHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		if (!request.GetParams().has_value()) {
+			return request.BuildError(RPC::Errors::PARAMS_MISSING);
+		}
+
+		const Json::Value params = request.GetParams().value();
+		if (!params.isArray() || params.size() < 2 || params[0].isNull() || params[1].isNull()) {
+			return request.BuildError("INVALID_PARAMS", "Expected 2 parameters: start_height, max");
+		}
+
+		const uint64_t startHeight = JsonUtil::ConvertToUInt64(params[0]);
+		const uint64_t max = JsonUtil::ConvertToUInt64(params[1]);
+
+		uint64_t numHeaders = 0;
+		const std::vector<uint8_t> serializedHeaders = m_pP2PServer->GetSerializedHeaders(startHeight, max, numHeaders);
+
+		ByteBuffer byteBuffer(serializedHeaders);
+		Json::Value headersJson(Json::arrayValue);
+		for (uint64_t i = 0; i < numHeaders; i++) {
+			headersJson.append(BlockHeader::Deserialize(byteBuffer).ToJSON());
+		}
+
+		Json::Value result;
+		result["Ok"] = headersJson;
+		return request.BuildResult(result);
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+
+private:
+	IP2PServerPtr m_pP2PServer;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <Config/Config.h>
+#include <BlockChain/BlockChain.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+#include <API/Wallet/Owner/Models/Errors.h>
+#include <optional>
+
+class GetKernelHandler : public RPCMethod
+{
+public:
+	GetKernelHandler(const IBlockChain::Ptr& pBlockChain)
+		: m_pBlockChain(pBlockChain) { }
+	~GetKernelHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		if (!request.GetParams().has_value()) {
+			return request.BuildError(RPC::Errors::PARAMS_MISSING);
+		}
+
+		const Json::Value params = request.GetParams().value();
+		if (!params.isArray() || params.size() < 1 || params[0].isNull()) {
+			return request.BuildError("INVALID_PARAMS", "Expected parameters: excess, min_height, max_height");
+		}
+
+		const Commitment excess = JsonUtil::ConvertToCommitment(params[0]);
+
+		std::optional<uint64_t> minHeight = std::nullopt;
+		if (params.size() > 1 && !params[1].isNull()) {
+			minHeight = std::make_optional(JsonUtil::ConvertToUInt64(params[1]));
+		}
+
+		std::optional<uint64_t> maxHeight = std::nullopt;
+		if (params.size() > 2 && !params[2].isNull()) {
+			maxHeight = std::make_optional(JsonUtil::ConvertToUInt64(params[2]));
+		}
+
+		std::unique_ptr<LocatedTxKernel> pKernel = m_pBlockChain->GetKernel(excess, minHeight, maxHeight);
+		if (pKernel == nullptr) {
+			return request.BuildError("NOT_FOUND", "Kernel not found");
+		}
+
+		Json::Value result;
+		result["Ok"] = pKernel->ToJSON();
+		return request.BuildResult(result);
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+
+private:
+	IBlockChain::Ptr m_pBlockChain;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Config/Config.h>
+#include <BlockChain/BlockChain.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+#include <API/Wallet/Owner/Models/Errors.h>
+
+class GetMerkleProofHandler : public RPCMethod
+{
+public:
+	GetMerkleProofHandler(const IBlockChain::Ptr& pBlockChain)
+		: m_pBlockChain(pBlockChain) { }
+	~GetMerkleProofHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		if (!request.GetParams().has_value()) {
+			return request.BuildError(RPC::Errors::PARAMS_MISSING);
+		}
+
+		const Json::Value params = request.GetParams().value();
+		if (!params.isArray() || params.size() < 1 || params[0].isNull()) {
+			return request.BuildError("INVALID_PARAMS", "Expected parameters: commitment");
+		}
+
+		const Commitment commitment = JsonUtil::ConvertToCommitment(params[0]);
+
+		std::unique_ptr<OutputMerkleProof> pProof = m_pBlockChain->GetMerkleProof(commitment);
+		if (pProof == nullptr) {
+			return request.BuildError("NOT_FOUND", "Unspent output not found");
+		}
+
+		Json::Value result;
+		result["Ok"] = pProof->ToJSON();
+		return request.BuildResult(result);
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+
+private:
+	IBlockChain::Ptr m_pBlockChain;
+};
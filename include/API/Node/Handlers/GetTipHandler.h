@@ -15,7 +15,12 @@ public:
 
 	RPC::Response Handle(const RPC::Request& request) const final
 	{
-		auto pTip = m_pBlockChain->GetTipBlockHeader(EChainType::CONFIRMED);
+		// Read from the published snapshot, so polling the tip never waits on the chain state lock.
+		ChainSnapshot::CPtr pSnapshot = m_pBlockChain->GetSnapshot();
+		const BlockHeaderPtr& pTip = pSnapshot->GetTip(EChainType::CONFIRMED);
+		if (pTip == nullptr) {
+			return request.BuildError("NOT_FOUND", "Tip not found");
+		}
 
 		Json::Value tipJson;
 		tipJson["height"] = pTip->GetHeight();
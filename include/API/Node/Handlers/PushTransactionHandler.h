@@ -21,7 +21,7 @@ public:
 			return request.BuildError(RPC::Errors::PARAMS_MISSING);
 		}
 
-		const Json::Value params = request.GetParams().value();
+		const Json::Value& params = request.GetParams().value();
 		if (!params.isArray() || params.size() < 1 || params[0].isNull()) {
 			return request.BuildError("INVALID_PARAMS", "Expected 2 parameters: transaction, fluff");
 		}
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <BlockChain/BlockChain.h>
+#include <TxPool/TransactionPool.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+#include <API/Wallet/Owner/Models/Errors.h>
+#include <Common/ShutdownManager.h>
+#include <Core/Util/JsonUtil.h>
+#include <algorithm>
+#include <chrono>
+#include <optional>
+
+//
+// Long-polls for changes, so clients can refresh only when something happened instead of polling get_tip.
+// Params: [tip_hash, mempool_seq, timeout_secs]
+//   tip_hash: The confirmed tip the client last saw. Returns as soon as the tip changes. If null, returns right away.
+//   mempool_seq: The last mempool event sequence number seen. If given, also returns as soon as the mempool changes.
+//   timeout_secs: How long to wait for a change. Defaults to 30 seconds, and is capped at 60.
+// Returns the current tip and mempool sequence, whether the client's tip was reorged out (and the height of the
+// last block it has in common with the confirmed chain), and the mempool events since mempool_seq.
+// If mempool_seq is too old, mempool_events is omitted and mempool_truncated is set, so the client should refetch the pool.
+//
+class SubscribeHandler : public RPCMethod
+{
+public:
+	SubscribeHandler(const IBlockChain::Ptr& pBlockChain, const ITransactionPool::Ptr& pTransactionPool)
+		: m_pBlockChain(pBlockChain), m_pTransactionPool(pTransactionPool) { }
+	~SubscribeHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		Json::Value params(Json::arrayValue);
+		if (request.GetParams().has_value()) {
+			params = request.GetParams().value();
+		}
+
+		if (!params.isArray()) {
+			return request.BuildError("INVALID_PARAMS", "Expected parameters: tip_hash, mempool_seq, timeout_secs");
+		}
+
+		std::optional<Hash> knownTipHash = std::nullopt;
+		if (params.size() > 0 && !params[0].isNull()) {
+			knownTipHash = std::make_optional(JsonUtil::ConvertToHash(params[0]));
+		}
+
+		std::optional<uint64_t> knownMempoolSeq = std::nullopt;
+		if (params.size() > 1 && !params[1].isNull()) {
+			knownMempoolSeq = std::make_optional(JsonUtil::ConvertToUInt64(params[1]));
+		}
+
+		uint64_t timeoutSecs = DEFAULT_TIMEOUT_SECS;
+		if (params.size() > 2 && !params[2].isNull()) {
+			timeoutSecs = (std::min)(JsonUtil::ConvertToUInt64(params[2]), MAX_TIMEOUT_SECS);
+		}
+
+		ChainSnapshot::CPtr pSnapshot = m_pBlockChain->GetSnapshot();
+		if (knownTipHash.has_value()) {
+			pSnapshot = WaitForChange(knownTipHash.value(), knownMempoolSeq, std::chrono::seconds(timeoutSecs));
+		}
+
+		const BlockHeaderPtr& pTip = pSnapshot->GetTip(EChainType::CONFIRMED);
+		if (pTip == nullptr) {
+			return request.BuildError("NOT_FOUND", "Tip not found");
+		}
+
+		Json::Value tipJson;
+		tipJson["height"] = pTip->GetHeight();
+		tipJson["last_block_pushed"] = pTip->GetHash().ToHex();
+		tipJson["prev_block_to_last"] = pTip->GetPreviousHash().ToHex();
+		tipJson["total_difficulty"] = pTip->GetTotalDifficulty();
+
+		Json::Value resultJson;
+		resultJson["tip"] = tipJson;
+
+		if (knownTipHash.has_value() && knownTipHash.value() != pTip->GetHash()) {
+			const std::optional<uint64_t> forkHeight = FindForkHeight(knownTipHash.value());
+			if (!forkHeight.has_value()) {
+				// The block is unknown or too far back, so clients should rescan as they would after any reorg.
+				resultJson["reorg"] = true;
+			} else {
+				const bool reorg = forkHeight.value() < GetHeight(knownTipHash.value());
+				resultJson["reorg"] = reorg;
+				if (reorg) {
+					resultJson["fork_height"] = forkHeight.value();
+				}
+			}
+		} else {
+			resultJson["reorg"] = false;
+		}
+
+		resultJson["mempool_seq"] = Json::UInt64(m_pTransactionPool->GetEventSequence());
+		if (knownMempoolSeq.has_value()) {
+			const std::optional<std::vector<TxPoolEvent>> events = m_pTransactionPool->GetEventsSince(knownMempoolSeq.value());
+			if (events.has_value()) {
+				Json::Value eventsJson(Json::arrayValue);
+				for (const TxPoolEvent& event : events.value()) {
+					eventsJson.append(event.ToJSON());
+				}
+
+				// Reported from the events, in case more happened after reading mempool_seq.
+				if (!events.value().empty()) {
+					resultJson["mempool_seq"] = Json::UInt64(events.value().back().GetSequence());
+				}
+
+				resultJson["mempool_events"] = eventsJson;
+			} else {
+				resultJson["mempool_truncated"] = true;
+			}
+		}
+
+		Json::Value result;
+		result["Ok"] = resultJson;
+		return request.BuildResult(result);
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+
+	// Holds a server thread until something changes.
+	bool IsLongRunning() const noexcept final { return true; }
+
+private:
+	static constexpr uint64_t DEFAULT_TIMEOUT_SECS = 30;
+	static constexpr uint64_t MAX_TIMEOUT_SECS = 60;
+
+	// The deepest reorg reported with a fork height.
+	static constexpr uint64_t MAX_FORK_DEPTH = 1000;
+
+	ChainSnapshot::CPtr WaitForChange(
+		const Hash& knownTipHash,
+		const std::optional<uint64_t>& knownMempoolSeq,
+		const std::chrono::seconds& timeout) const
+	{
+		// Tip changes wake the wait immediately. The mempool and shutdown flag are only checked between slices.
+		const std::chrono::milliseconds slice(knownMempoolSeq.has_value() ? 250 : 1000);
+		const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+		ChainSnapshot::CPtr pSnapshot = m_pBlockChain->GetSnapshot();
+		while (!ShutdownManagerAPI::WasShutdownRequested())
+		{
+			const BlockHeaderPtr& pTip = pSnapshot->GetTip(EChainType::CONFIRMED);
+			if (pTip == nullptr || pTip->GetHash() != knownTipHash) {
+				break;
+			}
+
+			if (knownMempoolSeq.has_value() && m_pTransactionPool->GetEventSequence() != knownMempoolSeq.value()) {
+				break;
+			}
+
+			const auto now = std::chrono::steady_clock::now();
+			if (now >= deadline) {
+				break;
+			}
+
+			const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now);
+			pSnapshot = m_pBlockChain->WaitForSnapshot(knownTipHash, (std::min)(slice, remaining));
+		}
+
+		return pSnapshot;
+	}
+
+	uint64_t GetHeight(const Hash& blockHash) const
+	{
+		BlockHeaderPtr pHeader = m_pBlockChain->GetBlockHeaderByHash(blockHash);
+		return pHeader != nullptr ? pHeader->GetHeight() : 0;
+	}
+
+	//
+	// Walks back from the given block to the last one that's still on the confirmed chain.
+	//
+	std::optional<uint64_t> FindForkHeight(const Hash& blockHash) const
+	{
+		BlockHeaderPtr pHeader = m_pBlockChain->GetBlockHeaderByHash(blockHash);
+		for (uint64_t depth = 0; pHeader != nullptr && depth <= MAX_FORK_DEPTH; depth++)
+		{
+			BlockHeaderPtr pConfirmed = m_pBlockChain->GetBlockHeaderByHeight(pHeader->GetHeight(), EChainType::CONFIRMED);
+			if (pConfirmed != nullptr && pConfirmed->GetHash() == pHeader->GetHash()) {
+				return std::make_optional(pHeader->GetHeight());
+			}
+
+			if (pHeader->GetHeight() == 0) {
+				break;
+			}
+
+			pHeader = m_pBlockChain->GetBlockHeaderByHash(pHeader->GetPreviousHash());
+		}
+
+		return std::nullopt;
+	}
+
+	IBlockChain::Ptr m_pBlockChain;
+	ITransactionPool::Ptr m_pTransactionPool;
+};
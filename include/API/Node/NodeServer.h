@@ -4,6 +4,8 @@
 #include <BlockChain/BlockChain.h>
 #include <Net/Servers/RPC/RPCServer.h>
 #include <P2P/P2PServer.h>
+#include <TxPool/TransactionPool.h>
+#include <Net/Util/ResponseCache.h>
 
 class NodeServer
 {
@@ -24,7 +26,9 @@ public:
     static NodeServer::UPtr Create(
         const ServerPtr& pServer,
         const IBlockChain::Ptr& pBlockChain,
-        const IP2PServerPtr& pP2PServer
+        const IP2PServerPtr& pP2PServer,
+        const ITransactionPool::Ptr& pTransactionPool,
+        const ResponseCache::Ptr& pResponseCache
     );
 
 private:
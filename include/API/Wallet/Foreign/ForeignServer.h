@@ -18,10 +18,12 @@ public:
     ForeignServer(
         const TorProcess::Ptr& pTorProcess,
         const RPCServerPtr& pRPCServer,
-        const std::optional<TorAddress>& torAddressOpt)
+        const std::optional<TorAddress>& torAddressOpt,
+        const bool shared)
         : m_pTorProcess(pTorProcess),
         m_pRPCServer(pRPCServer),
-        m_torAddress(torAddressOpt)
+        m_torAddress(torAddressOpt),
+        m_shared(shared)
     {
         LOG_INFO("Starting foreign server");
     }
@@ -31,7 +33,14 @@ public:
         LOG_INFO("Shutting down foreign server");
         if (m_torAddress.has_value())
         {
-            m_pTorProcess->RemoveListener(m_torAddress.value());
+            if (m_shared)
+            {
+                m_pTorProcess->RemoveListenerAsync(m_torAddress.value());
+            }
+            else
+            {
+                m_pTorProcess->RemoveListener(m_torAddress.value());
+            }
         }
     }
 
@@ -39,25 +48,48 @@ public:
         const KeyChain& keyChain,
         const TorProcess::Ptr& pTorProcess,
         IWalletManager& walletManager,
-        const SessionToken& token
+        const SessionToken& token,
+        const HttpServerConfig& config
+    );
+
+    //
+    // Creates the wallet's foreign API on a server shared by every logged in wallet, without a listener of its own.
+    // Requests are passed to it by whatever routes the shared server's requests (see ForeignController).
+    // The onion service is added asynchronously, so this doesn't wait for tor.
+    //
+    static ForeignServer::UPtr CreateShared(
+        const KeyChain& keyChain,
+        const TorProcess::Ptr& pTorProcess,
+        IWalletManager& walletManager,
+        const SessionToken& token,
+        const ServerPtr& pSharedServer
     );
 
     uint16_t GetPortNumber() const noexcept { return m_pRPCServer->GetPortNumber(); }
     const std::optional<TorAddress>& GetTorAddress() const noexcept { return m_torAddress; }
+    const RPCServerPtr& GetRPCServer() const noexcept { return m_pRPCServer; }
+
+    static int StatusListener(mg_connection* pConnection, void*)
+    {
+        return HTTPUtil::BuildSuccessResponse(pConnection, "SUCCESS! Your wallet listener is working!");
+    }
 
 private:
+    static void AddMethods(
+        RPCServer& server,
+        const TorProcess::Ptr& pTorProcess,
+        IWalletManager& walletManager,
+        const SessionToken& token
+    );
+
     static std::optional<TorAddress> AddTorListener(
         const KeyChain& keyChain,
         const TorProcess::Ptr& pTorProcess,
         const uint16_t portNumber
     );
 
-    static int StatusListener(mg_connection* pConnection, void*)
-    {
-        return HTTPUtil::BuildSuccessResponse(pConnection, "SUCCESS! Your wallet listener is working!");
-    }
-
     TorProcess::Ptr m_pTorProcess;
     RPCServerPtr m_pRPCServer;
     std::optional<TorAddress> m_torAddress;
+    bool m_shared;
 };
\ No newline at end of file
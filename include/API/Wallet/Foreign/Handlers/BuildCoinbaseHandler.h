@@ -18,7 +18,7 @@ public:
 		);
 
 		auto wallet = m_walletManager.GetWallet(criteria.GetToken());
-		BuildCoinbaseResponse response = wallet.Write()->BuildCoinbase(criteria);
+		BuildCoinbaseResponse response = wallet.Read()->BuildCoinbase(criteria);
 
 		return request.BuildResult(response.ToJSON());
 	}
@@ -20,13 +20,13 @@ public:
 		try
 		{
 			FinalizeTxRequest finalizeTxRequest = FinalizeTxRequest::FromJSON(
-				paramsOpt.value_or(Json::Value(Json::nullValue))
+				paramsOpt.has_value() ? paramsOpt.value() : Json::Value::nullSingleton()
 			);
 
 			FinalizeCriteria criteria(
 				SessionToken(m_token),
 				std::nullopt,
-				Slate(finalizeTxRequest.GetSlate()),
+				std::move(finalizeTxRequest).GetSlate(),
 				std::make_optional(PostMethodDTO(EPostMethod::STEM, std::nullopt))
 			);
 
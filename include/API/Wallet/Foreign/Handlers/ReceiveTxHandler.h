@@ -20,13 +20,13 @@ public:
 		try
 		{
 			ReceiveTxRequest receiveTxRequest = ReceiveTxRequest::FromJSON(
-				paramsOpt.value_or(Json::Value(Json::nullValue))
+				paramsOpt.has_value() ? paramsOpt.value() : Json::Value::nullSingleton()
 			);
 
 			ReceiveCriteria criteria(
 				SessionToken(m_token),
 				std::nullopt,
-				Slate(receiveTxRequest.GetSlate()),
+				std::move(receiveTxRequest).GetSlate(),
 				std::nullopt
 			);
 
@@ -9,11 +9,12 @@
 class FinalizeTxRequest : public Traits::IJsonable
 {
 public:
-    FinalizeTxRequest(const Slate& slate)
-        : m_slate(slate) { }
+    FinalizeTxRequest(Slate slate)
+        : m_slate(std::move(slate)) { }
     virtual ~FinalizeTxRequest() = default;
 
-    const Slate& GetSlate() const noexcept { return m_slate; }
+    const Slate& GetSlate() const& noexcept { return m_slate; }
+    Slate GetSlate() && { return std::move(m_slate); }
 
     static FinalizeTxRequest FromJSON(const Json::Value& paramsJson)
     {
@@ -21,7 +22,7 @@ public:
         {
             Slate slate = Slate::FromJSON(paramsJson[0]);
 
-            return FinalizeTxRequest(slate);
+            return FinalizeTxRequest(std::move(slate));
         }
 
         throw API_EXCEPTION(
@@ -10,13 +10,14 @@ class ReceiveTxRequest : public Traits::IJsonable
 {
 public:
     ReceiveTxRequest(
-        const Slate& slate,
+        Slate slate,
         const std::optional<std::string>& accountName,
         const std::optional<std::string>& message
-    ) : m_slate(slate), m_accountName(accountName), m_message(message) { }
+    ) : m_slate(std::move(slate)), m_accountName(accountName), m_message(message) { }
     virtual ~ReceiveTxRequest() = default;
 
-    const Slate& GetSlate() const noexcept { return m_slate; }
+    const Slate& GetSlate() const& noexcept { return m_slate; }
+    Slate GetSlate() && { return std::move(m_slate); }
     const std::optional<std::string>& GetAccountName() const noexcept { return m_accountName; }
     const std::optional<std::string>& GetMsg() const noexcept { return m_message; }
 
@@ -37,7 +38,7 @@ public:
                 messageOpt = std::make_optional(paramsJson[2].asString());
             }
 
-            return ReceiveTxRequest(slate, accountNameOpt, messageOpt);
+            return ReceiveTxRequest(std::move(slate), accountNameOpt, messageOpt);
         }
 
         throw API_EXCEPTION(
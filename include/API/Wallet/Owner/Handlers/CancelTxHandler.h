@@ -24,7 +24,7 @@ public:
 		CancelTxCriteria criteria = CancelTxCriteria::FromJSON(request.GetParams().value());
 		auto wallet = m_pWalletManager->GetWallet(criteria.GetToken());
 
-		wallet.Write()->CancelTx(criteria.GetTxId());
+		wallet.Read()->CancelTx(criteria.GetTxId());
 
 		Json::Value result;
 		result["status"] = "SUCCESS";
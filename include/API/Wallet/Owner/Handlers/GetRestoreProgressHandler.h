@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Config/Config.h>
+#include <Wallet/WalletManager.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+#include <API/Wallet/Owner/Models/Errors.h>
+#include <optional>
+
+class GetRestoreProgressHandler : public RPCMethod
+{
+public:
+	GetRestoreProgressHandler(const IWalletManagerPtr& pWalletManager)
+		: m_pWalletManager(pWalletManager) { }
+	virtual ~GetRestoreProgressHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		if (!request.GetParams().has_value())
+		{
+			return request.BuildError(RPC::Errors::PARAMS_MISSING);
+		}
+
+		Json::Value tokenJson = JsonUtil::GetRequiredField(request.GetParams().value(), "session_token");
+		SessionToken token = SessionToken::FromBase64(tokenJson.asString());
+
+		RestoreProgressDTO progress = m_pWalletManager->GetRestoreProgress(token);
+
+		return request.BuildResult(progress.ToJSON());
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+
+private:
+	IWalletManagerPtr m_pWalletManager;
+};
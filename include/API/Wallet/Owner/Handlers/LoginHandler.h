@@ -43,6 +43,7 @@ public:
 	}
 
 	bool ContainsSecrets() const noexcept final { return true; }
+	bool IsLongRunning() const noexcept final { return true; }
 
 private:
 	void ValidateInput(const LoginCriteria& criteria) const
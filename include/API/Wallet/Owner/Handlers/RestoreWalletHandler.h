@@ -36,6 +36,7 @@ public:
 	}
 
 	bool ContainsSecrets() const noexcept final { return true; }
+	bool IsLongRunning() const noexcept final { return true; }
 
 private:
 	void ValidateInput(const RestoreWalletCriteria& criteria) const
@@ -71,6 +71,7 @@ public:
 	}
 
 	bool ContainsSecrets() const noexcept final { return false; }
+	bool IsLongRunning() const noexcept final { return true; }
 
 private:
 	TorProcess::Ptr m_pTorProcess;
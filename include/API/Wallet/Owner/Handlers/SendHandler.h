@@ -32,13 +32,58 @@ public:
 
 		auto wallet = m_pWalletManager->GetWallet(criteria.GetToken());
 		SlatepackAddress sender_address = wallet.Read()->GetSlatepackAddress();
-		std::vector<SlatepackAddress> recipients = GetRecipients(criteria);
+		std::vector<SlatepackAddress> recipients = PrepareSend(criteria);
+
+		Slate slate = m_pWalletManager->Send(criteria);
+
+		return request.BuildResult(Deliver(criteria, slate, sender_address, recipients).ToJSON());
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+	bool IsLongRunning() const noexcept final { return true; }
+
+	//
+	// The slatepack address of the recipient, if the criteria has a valid one.
+	//
+	std::vector<SlatepackAddress> GetRecipients(const SendCriteria& criteria) const noexcept
+	{
+		std::vector<SlatepackAddress> recipients;
+
+		if (criteria.GetAddress().has_value()) {
+			try
+			{
+				SlatepackAddress slatepack_address = SlatepackAddress::Parse(criteria.GetAddress().value());
+				recipients.emplace_back(std::move(slatepack_address));
+			}
+			catch (std::exception&) { }
+		}
+	
+		return recipients;
+	}
 
+	//
+	// Finds the recipient of the send, and sets the slate version to one they support.
+	//
+	std::vector<SlatepackAddress> PrepareSend(SendCriteria& criteria) const
+	{
+		std::vector<SlatepackAddress> recipients = GetRecipients(criteria);
 		if (!recipients.empty()) {
 			criteria.SetSlateVersion(GetSlateVersion(recipients.front().ToTorAddress()));
 		}
 
-		Slate slate = m_pWalletManager->Send(criteria);
+		return recipients;
+	}
+
+	//
+	// Sends the slate to the recipient over TOR and finalizes it, if there is one.
+	// Otherwise, or if that fails, the slatepack is returned so it can be sent manually.
+	//
+	SendResponse Deliver(
+		const SendCriteria& criteria,
+		Slate slate,
+		const SlatepackAddress& sender_address,
+		const std::vector<SlatepackAddress>& recipients) const
+	{
 		LOG_INFO_F("Sending slate: {}", slate.ToJSON().toStyledString());
 
 		SendResponse::EStatus status = SendResponse::EStatus::SENT;
@@ -56,32 +101,14 @@ public:
 			}
 			catch (const std::exception& e)
 			{
-				return request.BuildResult(SendResponse(status, slate, slatepack, e.what()).ToJSON());
+				return SendResponse(status, slate, slatepack, e.what());
 			}
 		}
 
-		return request.BuildResult(SendResponse(status, slate, slatepack).ToJSON());
+		return SendResponse(status, slate, slatepack);
 	}
 
-	bool ContainsSecrets() const noexcept final { return false; }
-
 private:
-	std::vector<SlatepackAddress> GetRecipients(const SendCriteria& criteria) const noexcept
-	{
-		std::vector<SlatepackAddress> recipients;
-
-		if (criteria.GetAddress().has_value()) {
-			try
-			{
-				SlatepackAddress slatepack_address = SlatepackAddress::Parse(criteria.GetAddress().value());
-				recipients.emplace_back(std::move(slatepack_address));
-			}
-			catch (std::exception&) { }
-		}
-	
-		return recipients;
-	}
-
 	uint16_t GetSlateVersion(const TorAddress& torAddress) const
 	{
 		TorConnectionPtr pTorConnection = m_pTorProcess->Connect(torAddress);
@@ -101,7 +128,7 @@ private:
 		return version_response.slate_version;
 	}
 
-	Slate SendViaTOR(SendCriteria& criteria, const Slate& sent_slate, const TorAddress& torAddress) const
+	Slate SendViaTOR(const SendCriteria& criteria, const Slate& sent_slate, const TorAddress& torAddress) const
 	{
 		TorConnectionPtr pTorConnection = m_pTorProcess->Connect(torAddress);
 		if (pTorConnection == nullptr) {
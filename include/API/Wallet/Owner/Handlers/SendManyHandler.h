@@ -0,0 +1,85 @@
+#pragma once
+
+#include <Wallet/WalletManager.h>
+#include <Net/Clients/RPC/RPC.h>
+#include <Net/Tor/TorProcess.h>
+#include <Net/Servers/RPC/RPCMethod.h>
+#include <API/Wallet/Owner/Models/Errors.h>
+#include <API/Wallet/Owner/Models/SendCriteria.h>
+#include <API/Wallet/Owner/Handlers/SendHandler.h>
+#include <vector>
+
+//
+// Builds many sends at once, refreshing the wallet and taking its lock only once,
+// and delivers each one the same way as the "send" method.
+//
+class SendManyHandler : public RPCMethod
+{
+public:
+	SendManyHandler(const TorProcess::Ptr& pTorProcess, const IWalletManagerPtr& pWalletManager)
+		: m_pTorProcess(pTorProcess), m_pWalletManager(pWalletManager), m_sendHandler(pTorProcess, pWalletManager) { }
+	~SendManyHandler() = default;
+
+	RPC::Response Handle(const RPC::Request& request) const final
+	{
+		if (!request.GetParams().has_value()) {
+			return request.BuildError(RPC::Errors::PARAMS_MISSING);
+		}
+
+		const Json::Value& params = request.GetParams().value();
+		const std::string token = JsonUtil::GetRequiredString(params, "session_token");
+		const Json::Value sendsJSON = JsonUtil::GetRequiredField(params, "sends");
+		if (!sendsJSON.isArray() || sendsJSON.empty()) {
+			return request.BuildError(RPC::ErrorCode::INVALID_PARAMS, "'sends' must be a non-empty array");
+		}
+
+		// Each send takes the same params as the "send" method, and shares the batch's session token.
+		std::vector<SendCriteria> sends;
+		for (Json::Value sendJSON : sendsJSON)
+		{
+			sendJSON["session_token"] = token;
+			sends.push_back(SendCriteria::FromJSON(sendJSON));
+		}
+
+		auto wallet = m_pWalletManager->GetWallet(sends.front().GetToken());
+		SlatepackAddress sender_address = wallet.Read()->GetSlatepackAddress();
+
+		// Build the circuits to every recipient at once, rather than one at a time as each is contacted.
+		std::vector<TorAddress> torAddresses;
+		for (const SendCriteria& send : sends)
+		{
+			for (const SlatepackAddress& recipient : m_sendHandler.GetRecipients(send))
+			{
+				torAddresses.push_back(recipient.ToTorAddress());
+			}
+		}
+
+		m_pTorProcess->PrewarmConnections(torAddresses);
+
+		std::vector<std::vector<SlatepackAddress>> recipients;
+		for (SendCriteria& send : sends)
+		{
+			recipients.push_back(m_sendHandler.PrepareSend(send));
+		}
+
+		const std::vector<Slate> slates = m_pWalletManager->SendMany(sends.front().GetToken(), sends);
+
+		Json::Value resultsJSON = Json::arrayValue;
+		for (size_t i = 0; i < slates.size(); i++)
+		{
+			resultsJSON.append(m_sendHandler.Deliver(sends[i], slates[i], sender_address, recipients[i]).ToJSON());
+		}
+
+		Json::Value result;
+		result["results"] = resultsJSON;
+		return request.BuildResult(result);
+	}
+
+	bool ContainsSecrets() const noexcept final { return false; }
+	bool IsLongRunning() const noexcept final { return true; }
+
+private:
+	TorProcess::Ptr m_pTorProcess;
+	IWalletManagerPtr m_pWalletManager;
+	SendHandler m_sendHandler;
+};
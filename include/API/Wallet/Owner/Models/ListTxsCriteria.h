@@ -17,8 +17,10 @@ public:
 		const SessionToken& token,
 		const std::optional<std::chrono::system_clock::time_point>& start_range,
 		const std::optional<std::chrono::system_clock::time_point>& end_range,
-		const std::unordered_set<EWalletTxType>& statuses
-	) : m_token(token), m_startRange(start_range), m_endRange(end_range), m_statuses(statuses) { }
+		const std::unordered_set<EWalletTxType>& statuses,
+		const std::optional<uint64_t>& limit = std::nullopt,
+		const uint64_t offset = 0
+	) : m_token(token), m_startRange(start_range), m_endRange(end_range), m_statuses(statuses), m_limit(limit), m_offset(offset) { }
 
 	static ListTxsCriteria FromJSON(const Json::Value& json)
 	{
@@ -70,17 +72,25 @@ public:
 			}
 		}
 
-		return ListTxsCriteria(token, start_range, end_range, statuses);
+		// Pages through the matching transactions, in order of id.
+		std::optional<uint64_t> limit = JsonUtil::GetUInt64Opt(json, "limit");
+		const uint64_t offset = JsonUtil::GetUInt64Opt(json, "offset").value_or(0);
+
+		return ListTxsCriteria(token, start_range, end_range, statuses, limit, offset);
 	}
 
 	const SessionToken& GetToken() const noexcept { return m_token; }
 	const std::optional<std::chrono::system_clock::time_point>& GetStartRange() const noexcept { return m_startRange; }
 	const std::optional<std::chrono::system_clock::time_point>& GetEndRange() const noexcept { return m_endRange; }
 	const std::unordered_set<EWalletTxType>& GetStatuses() const noexcept { return m_statuses; }
+	const std::optional<uint64_t>& GetLimit() const noexcept { return m_limit; }
+	uint64_t GetOffset() const noexcept { return m_offset; }
 
 private:
 	SessionToken m_token;
 	std::optional<std::chrono::system_clock::time_point> m_startRange;
 	std::optional<std::chrono::system_clock::time_point> m_endRange;
 	std::unordered_set<EWalletTxType> m_statuses;
+	std::optional<uint64_t> m_limit;
+	uint64_t m_offset;
 };
\ No newline at end of file
@@ -6,19 +6,32 @@
 
 #include <Common/ImportExport.h>
 #include <BlockChain/BlockChainStatus.h>
+#include <BlockChain/BlockProcessingStats.h>
 #include <TxPool/PoolType.h>
+#include <TxPool/BlockTemplate.h>
 #include <P2P/SyncStatus.h>
 #include <Core/Models/DTOs/BlockWithOutputs.h>
+#include <Core/Models/DTOs/LocatedTxKernel.h>
+#include <Core/Models/DTOs/OutputMerkleProof.h>
+#include <Core/Enums/ProtocolVersion.h>
+#include <Common/CacheStats.h>
 #include <BlockChain/ChainType.h>
+#include <BlockChain/ChainSnapshot.h>
 #include <Core/Models/BlockHeader.h>
+#include <Core/Models/FullBlock.h>
 #include <Core/Models/Transaction.h>
+#include <Core/Models/TxHashSetRoots.h>
 #include <Core/Traits/Lockable.h>
 #include <Crypto/BigInteger.h>
 #include <PMMR/HeaderMMR.h>
+#include <PMMR/TxHashSetArchive.h>
+#include <PMMR/TxHashSetDownload.h>
 #include <filesystem.h>
 
 #include <vector>
 #include <memory>
+#include <optional>
+#include <chrono>
 
 // Forward Declarations
 class Config;
@@ -48,15 +61,82 @@ public:
 
 	virtual void ResyncChain() = 0;
 
+	//
+	// Only for replicas (see NodeConfig::IsReplica). Reloads the chains and TxHashSet from the primary's files,
+	// and catches up with the primary's database, so reads see everything the primary committed.
+	//
+	virtual void CatchUpWithPrimary() = 0;
+
 	virtual void UpdateSyncStatus(SyncStatus& syncStatus) const = 0;
 	virtual uint64_t GetHeight(const EChainType chainType) const = 0;
 	virtual uint64_t GetTotalDifficulty(const EChainType chainType) const = 0;
 
+	//
+	// Verifies everything in the block that can be checked without chain state (rangeproofs, kernel signatures, cut-through, coinbase).
+	// Takes no locks, so it can be called concurrently for many blocks before they're added in order.
+	// The block is marked as validated, so AddBlock won't repeat these checks.
+	// Returns false if the block is invalid.
+	//
+	virtual bool VerifySelfConsistent(const FullBlock& block) const = 0;
+
 	virtual EBlockChainStatus AddBlock(const FullBlock& block) = 0;
+
+	//
+	// Adds consecutive blocks, applying as many as possible in a single commit. Used during initial block download,
+	// where committing every block separately makes the database and PMMR file flushes the bottleneck.
+	// If the group can't be applied together, each block is added individually, as with AddBlock.
+	// Returns the status of each block, in the same order.
+	//
+	virtual std::vector<EBlockChainStatus> AddBlocks(const std::vector<FullBlock::CPtr>& blocks) = 0;
+
+	//
+	// Hydrates the compact block from the transaction pool, and adds it. Its header is validated and added alongside.
+	// Returns INVALID if the header is invalid, or TRANSACTIONS_MISSING if the block couldn't be hydrated or failed to validate once it was.
+	//
 	virtual EBlockChainStatus AddCompactBlock(const CompactBlock& compactBlock) = 0;
 
-	virtual fs::path SnapshotTxHashSet(BlockHeaderPtr pBlockHeader) = 0;
-	virtual EBlockChainStatus ProcessTransactionHashSet(const Hash& blockHash, const fs::path& path, SyncStatus& syncStatus) = 0;
+	//
+	// Returns a TxHashSet archive to send a peer that requested one as of the given block.
+	// The archive may be for a different block, since one archive is shared by every peer syncing at the same time.
+	// Throws a BadDataException if the block is beyond the horizon.
+	//
+	virtual TxHashSetArchive::CPtr SnapshotTxHashSet(BlockHeaderPtr pBlockHeader) = 0;
+
+	//
+	// Loads and validates a downloaded TxHashSet zip. pDownload, if not null, is what was extracted and verified while downloading it.
+	//
+	virtual EBlockChainStatus ProcessTransactionHashSet(
+		const Hash& blockHash,
+		const fs::path& path,
+		const TxHashSetDownload::Ptr& pDownload,
+		SyncStatus& syncStatus
+	) = 0;
+
+	//
+	// Writes a TxHashSet snapshot of the given confirmed block under NodeConfig::GetSnapshotPath(), for bootstrapping our own nodes.
+	// Returns the snapshot's directory. Throws a BadDataException if the block is beyond the horizon,
+	// or a TxHashSetException if a snapshot of the block was already exported.
+	//
+	virtual fs::path ExportTxHashSetSnapshot(BlockHeaderPtr pBlockHeader) = 0;
+
+	//
+	// Loads and validates a snapshot written by ExportTxHashSetSnapshot, in place of a downloaded TxHashSet.
+	// Returns ORPHANED if the header chain doesn't reach the snapshot's block yet, and INVALID if it's on another chain or doesn't validate.
+	//
+	virtual EBlockChainStatus ImportTxHashSetSnapshot(const fs::path& directory, SyncStatus& syncStatus) = 0;
+
+	//
+	// Verifies everything in the transaction that can be checked without chain state (rangeproofs, kernel signatures, kernel sums).
+	// Like the block version, this takes no locks and marks the transaction as validated, so AddTransaction only checks it against the UTXO set and pool.
+	// Returns false if the transaction is invalid.
+	//
+	virtual bool VerifySelfConsistent(const Transaction& transaction) const = 0;
+
+	//
+	// Like the single transaction version, for transactions that arrived together (see TransactionValidator::ValidateBatch).
+	// Returns whether each is valid.
+	//
+	virtual std::vector<bool> VerifySelfConsistent(const std::vector<TransactionPtr>& transactions) const = 0;
 	virtual EBlockChainStatus AddTransaction(TransactionPtr pTransaction, const EPoolType poolType) = 0;
 	virtual TransactionPtr GetTransactionByKernelHash(const Hash& kernelHash) const = 0;
 
@@ -102,6 +182,15 @@ public:
 	//
 	virtual std::unique_ptr<CompactBlock> GetCompactBlockByHash(const Hash& hash) const = 0;
 
+	//
+	// Returns the block or compact block with the given hash, serialized as it's sent to peers using the given protocol version.
+	// Blocks accepted at the tip, and other recent blocks once requested, are cached already serialized.
+	// Returns nullptr if the block doesn't exist.
+	//
+	virtual std::shared_ptr<const std::vector<uint8_t>> GetSerializedBlock(const Hash& hash, const EProtocolVersion protocolVersion) const = 0;
+	virtual std::shared_ptr<const std::vector<uint8_t>> GetSerializedCompactBlock(const Hash& hash, const EProtocolVersion protocolVersion) const = 0;
+	virtual CacheStats GetSerializedBlockCacheStats() const = 0;
+
 	//
 	// Returns the block at the given height.
 	// This will be null if no matching block is found.
@@ -125,7 +214,9 @@ public:
 	//
 	virtual bool HasBlock(const uint64_t height, const Hash& blockHash) const = 0;
 
-
+	//
+	// Returns the unspent outputs of each confirmed block in the height range, read from the TxHashSet rather than the blocks.
+	//
 	virtual std::vector<BlockWithOutputs> GetOutputsByHeight(const uint64_t startHeight, const uint64_t maxHeight) const = 0;
 
 	//
@@ -133,7 +224,99 @@ public:
 	//
 	virtual std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t maxNumBlocks) const = 0;
 
+	//
+	// Like GetBlocksNeeded, but starting at firstHeight, so the blocks above a TxHashSet can be downloaded (into the orphan pool)
+	// while it's still being validated. Returns nothing while the orphan pool is half full.
+	//
+	virtual std::vector<std::pair<uint64_t, Hash>> GetBlocksToPrefetch(const uint64_t firstHeight, const uint64_t maxNumBlocks) const = 0;
+
+	//
+	// Connects the orphan block for the next candidate height, if we have it, returning true if one was connected.
+	// Orphans are normally connected as soon as their parent is added, so this only catches those missed meanwhile.
+	//
 	virtual bool ProcessNextOrphanBlock() = 0;
+
+	//
+	// Deletes the next batch of full blocks older than NODE.PRUNE_HORIZON, keeping their headers.
+	// Returns true if there are more blocks to prune. Does nothing unless pruning is enabled.
+	//
+	virtual bool PruneBlocks() = 0;
+
+	//
+	// True if the header is an ancestor of (or is) the NODE.ASSUME_VALID header on the candidate chain,
+	// in which case its rangeproofs and kernel signatures don't need to be verified.
+	//
+	virtual bool IsAssumedValid(const BlockHeader& header) const = 0;
+
+	//
+	// Fully verifies the next batch of stored blocks that were only checked as assumed valid.
+	// Returns true if there are more blocks to verify. Does nothing unless NODE.ASSUME_VALID_REVERIFY is set.
+	//
+	virtual bool ReverifyAssumedValid() = 0;
+
+	//
+	// Indexes the kernels of the next batch of confirmed blocks that aren't indexed yet, eg. those applied before NODE.KERNEL_INDEX was enabled.
+	// Returns true if there are more blocks to index. Does nothing unless NODE.KERNEL_INDEX is set.
+	//
+	virtual bool IndexKernels() = 0;
+
+	//
+	// Removes the outputs spent before the horizon from the TxHashSet, once the horizon has moved a day past the last compaction.
+	// The compacted files are written without holding the chain state lock, so block processing only waits while they're swapped in.
+	// Does nothing unless NODE.COMPACT_TXHASHSET is set.
+	//
+	virtual void CompactTxHashSet() = 0;
+
+	//
+	// Returns the kernel with the given excess commitment from the confirmed chain, along with its block height and MMR index.
+	// The heights, when given, limit the search to the blocks between them (inclusive).
+	// Uses the kernel index where it's been built. Otherwise, scans the kernel MMR newest first, which hints make much faster.
+	// This will be null if no matching kernel is found.
+	//
+	virtual std::unique_ptr<LocatedTxKernel> GetKernel(
+		const Commitment& excessCommitment,
+		const std::optional<uint64_t>& minHeight,
+		const std::optional<uint64_t>& maxHeight
+	) const = 0;
+
+	//
+	// Returns the merkle proof of the unspent output with the given commitment against the output root of the confirmed tip.
+	// Proofs are built under the chain state's read lock, so any number can be built at once.
+	// This will be null if the output is spent, or was never confirmed.
+	//
+	virtual std::unique_ptr<OutputMerkleProof> GetMerkleProof(const Commitment& outputCommitment) const = 0;
+
+	//
+	// Returns the per-call-site hold and wait times of the chain state lock, or nothing unless NODE.CHAIN_LOCK_PROFILE_SECS is set.
+	//
+	virtual std::vector<LockSiteStats> GetChainLockProfile() const = 0;
+
+	//
+	// Returns the time spent validating, applying, and committing blocks since the chain was opened.
+	//
+	virtual BlockProcessingStats GetProcessingStats() const = 0;
+
+	//
+	// Returns the latest snapshot of the confirmed and candidate tips. Never waits on block processing.
+	//
+	virtual ChainSnapshot::CPtr GetSnapshot() const = 0;
+
+	//
+	// Waits until the confirmed tip is no longer the given block, or until the timeout passes, then returns the latest snapshot.
+	//
+	virtual ChainSnapshot::CPtr WaitForSnapshot(const Hash& confirmedTipHash, const std::chrono::milliseconds& timeout) const = 0;
+
+	//
+	// Returns the mempool txs to mine on top of the confirmed tip, selected by fee rate. See ITransactionPool::GetBlockTemplate.
+	//
+	virtual BlockTemplate::CPtr GetBlockTemplate() const = 0;
+
+	//
+	// Returns the MMR roots and sizes for a block with the given body on top of the confirmed tip, eg. a template plus the miner's coinbase.
+	// Only takes the chain's read lock, and never touches the TxHashSet's files. See ITxHashSet::GetRoots.
+	// Throws a TxHashSetException if the body's inputs or outputs aren't valid for the current UTXO set.
+	//
+	virtual TxHashSetRoots GetBlockRoots(const TransactionBody& body) const = 0;
 };
 
 namespace BlockChainAPI
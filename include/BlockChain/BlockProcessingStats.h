@@ -0,0 +1,27 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+//
+// The time spent adding blocks since the chain was opened, split by phase.
+// Blocks can be verified on many threads at once, so validateTime is summed across threads rather than elapsed.
+//
+struct BlockProcessingStats
+{
+	// Blocks applied to the confirmed chain, including those applied and then rolled back by a reorg that didn't increase difficulty.
+	uint64_t numBlocks;
+
+	// Rangeproofs and kernel signatures verified while validating blocks. Those of assumed valid blocks aren't verified.
+	uint64_t numRangeProofs;
+	uint64_t numKernels;
+
+	// Verifying that blocks are self-consistent (rangeproofs, kernel signatures, cut-through, coinbase).
+	std::chrono::microseconds validateTime;
+
+	// Checking blocks against chain state and applying them to the TxHashSet and block database.
+	std::chrono::microseconds applyTime;
+
+	// Committing the applied blocks to disk.
+	std::chrono::microseconds commitTime;
+};
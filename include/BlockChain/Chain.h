@@ -5,6 +5,9 @@
 #include <BlockChain/ChainType.h>
 #include <Core/Traits/Lockable.h>
 #include <Core/File/DataFile.h>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 // Forward Declarations
 class BlockIndexAllocator;
@@ -23,16 +26,19 @@ public:
 		std::shared_ptr<const BlockIndex> pGenesisIndex
 	);
 
+	//
+	// Creates an index for the block at the given height, or returns nullptr if the chain isn't that long.
+	//
 	std::shared_ptr<const BlockIndex> GetByHeight(const uint64_t height) const;
 
-	const Hash& GetHash(const uint64_t height) const { return m_indices[height]->GetHash(); }
-	std::shared_ptr<const BlockIndex> GetTip() const { return m_indices[m_height]; }
-	const Hash& GetTipHash() const { return m_indices[m_height]->GetHash(); }
+	Hash GetHash(const uint64_t height) const { return Hash(GetHashBytes(height)); }
+	std::shared_ptr<const BlockIndex> GetTip() const { return GetByHeight(m_height); }
+	Hash GetTipHash() const { return GetHash(m_height); }
 	uint64_t GetHeight() const { return m_height; }
 
 	bool IsOnChain(const uint64_t height, const Hash& hash) const noexcept
 	{
-		return height <= m_height && m_indices[height]->GetHash() == hash;
+		return height <= m_height && memcmp(GetHashBytes(height), hash.data(), HASH_SIZE) == 0;
 	}
 
 	bool IsOnChain(const BlockHeaderPtr& pHeader) const noexcept
@@ -40,6 +46,12 @@ public:
 		return IsOnChain(pHeader->GetHeight(), pHeader->GetHash());
 	}
 
+	// True if both chains have the same block at the given height, which neither may be shorter than.
+	bool HasSameBlock(const Chain& other, const uint64_t height) const noexcept
+	{
+		return memcmp(GetHashBytes(height), other.GetHashBytes(height), HASH_SIZE) == 0;
+	}
+
 	EChainType GetType() const noexcept { return m_chainType; }
 
 	std::shared_ptr<const BlockIndex> AddBlock(const Hash& hash, const uint64_t height);
@@ -50,20 +62,52 @@ public:
 	void OnInitWrite() final;
 	void OnEndWrite() final;
 
+	//
+	// Hashes are stored contiguously, HASHES_PER_CHUNK to a chunk, rather than as an object per block.
+	// Chunks are copied on write, so a full chunk can be shared with the other chains (see BlockIndexAllocator)
+	// and with the state saved for Rollback.
+	//
+	static constexpr size_t HASH_SIZE = 32;
+	static constexpr size_t HASHES_PER_CHUNK = 1024;
+	using HashChunk = std::vector<uint8_t>;
+
+	//
+	// Returns the full chunk at the given index, or nullptr if it's not full.
+	//
+	std::shared_ptr<const HashChunk> GetFullChunk(const size_t chunkIndex) const noexcept;
+
 private:
 	Chain(
 		const EChainType chainType,
 		std::shared_ptr<BlockIndexAllocator> pBlockIndexAllocator,
 		std::shared_ptr<DataFile<32>> pDataFile,
-		std::vector<std::shared_ptr<const BlockIndex>>&& indices
+		std::vector<std::shared_ptr<const HashChunk>>&& chunks,
+		const uint64_t numHashes
+	);
+
+	static std::vector<std::shared_ptr<const HashChunk>> LoadChunks(
+		const BlockIndexAllocator& blockIndexAllocator,
+		const DataFile<32>& dataFile
 	);
 
+	const uint8_t* GetHashBytes(const uint64_t height) const noexcept
+	{
+		return m_chunks[height / HASHES_PER_CHUNK]->data() + (height % HASHES_PER_CHUNK) * HASH_SIZE;
+	}
+
+	// Returns the last chunk, after copying it if it's shared.
+	HashChunk& GetWritableChunk();
+
 	const EChainType m_chainType;
 	std::shared_ptr<BlockIndexAllocator> m_pBlockIndexAllocator;
-	std::vector<std::shared_ptr<const BlockIndex>> m_indices;
+	std::vector<std::shared_ptr<const HashChunk>> m_chunks;
 	size_t m_height;
 	Locked<DataFile<32>> m_dataFile;
 	Writer<DataFile<32>> m_dataFileWriter;
+
+	// The chunks and height as of OnInitWrite, for Rollback.
+	std::vector<std::shared_ptr<const HashChunk>> m_committedChunks;
+	size_t m_committedHeight;
 };
 
 class BlockIndexAllocator
@@ -78,21 +122,30 @@ public:
 
 	std::shared_ptr<const BlockIndex> GetOrCreateIndex(const Hash& hash, const uint64_t height) const
 	{
-		return GetOrCreateIndex(Hash(hash), height);
+		return std::make_shared<const BlockIndex>(BlockIndex(hash, height));
 	}
 
-	std::shared_ptr<const BlockIndex> GetOrCreateIndex(Hash&& hash, const uint64_t height) const
+	//
+	// Returns another chain's copy of the full chunk, if one matches, so the common prefix of the chains is only stored once.
+	//
+	std::shared_ptr<const Chain::HashChunk> ShareChunk(const size_t chunkIndex, const std::shared_ptr<const Chain::HashChunk>& pChunk) const
 	{
-		for (std::weak_ptr<const Chain> pChain : m_chains)
+		for (const std::weak_ptr<const Chain>& pWeakChain : m_chains)
 		{
-			std::shared_ptr<const BlockIndex> pIndex = pChain.lock()->GetByHeight(height);
-			if (pIndex != nullptr && pIndex->GetHash() == hash)
+			std::shared_ptr<const Chain> pChain = pWeakChain.lock();
+			if (pChain == nullptr)
+			{
+				continue;
+			}
+
+			std::shared_ptr<const Chain::HashChunk> pOtherChunk = pChain->GetFullChunk(chunkIndex);
+			if (pOtherChunk != nullptr && pOtherChunk != pChunk && *pOtherChunk == *pChunk)
 			{
-				return pIndex;
+				return pOtherChunk;
 			}
 		}
 
-		return std::make_shared<const BlockIndex>(BlockIndex(std::move(hash), height));
+		return pChunk;
 	}
 
 private:
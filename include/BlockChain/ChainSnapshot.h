@@ -0,0 +1,130 @@
+#pragma once
+
+#include <BlockChain/ChainType.h>
+#include <Core/Models/BlockHeader.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+//
+// An immutable view of the confirmed and candidate tips, published after every chain state commit.
+// Readers hold on to a snapshot for as long as they like without ever taking the chain state lock,
+// so a long reorg can't stall API and wallet queries, and those queries can't delay block processing.
+//
+class ChainSnapshot
+{
+public:
+	using CPtr = std::shared_ptr<const ChainSnapshot>;
+
+	ChainSnapshot(const BlockHeaderPtr& pConfirmedTip, const BlockHeaderPtr& pCandidateTip, const uint64_t generation)
+		: m_pConfirmedTip(pConfirmedTip), m_pCandidateTip(pCandidateTip), m_generation(generation) { }
+
+	//
+	// Only the confirmed and candidate chains are snapshotted. The sync chain returns the candidate tip.
+	//
+	const BlockHeaderPtr& GetTip(const EChainType chainType) const noexcept
+	{
+		return chainType == EChainType::CONFIRMED ? m_pConfirmedTip : m_pCandidateTip;
+	}
+
+	uint64_t GetHeight(const EChainType chainType) const noexcept
+	{
+		const BlockHeaderPtr& pTip = GetTip(chainType);
+		return pTip != nullptr ? pTip->GetHeight() : 0;
+	}
+
+	uint64_t GetTotalDifficulty(const EChainType chainType) const noexcept
+	{
+		const BlockHeaderPtr& pTip = GetTip(chainType);
+		return pTip != nullptr ? pTip->GetTotalDifficulty() : 0;
+	}
+
+	uint64_t GetOutputMMRSize() const noexcept { return m_pConfirmedTip != nullptr ? m_pConfirmedTip->GetOutputMMRSize() : 0; }
+	uint64_t GetKernelMMRSize() const noexcept { return m_pConfirmedTip != nullptr ? m_pConfirmedTip->GetKernelMMRSize() : 0; }
+
+	//
+	// Incremented every time the confirmed tip changes, and with it the output leafset,
+	// so wallets can tell whether anything they scanned may have changed.
+	//
+	uint64_t GetGeneration() const noexcept { return m_generation; }
+
+private:
+	BlockHeaderPtr m_pConfirmedTip;
+	BlockHeaderPtr m_pCandidateTip;
+	uint64_t m_generation;
+};
+
+//
+// Holds the latest ChainSnapshot, which is swapped atomically so readers never wait on the publisher.
+//
+class ChainSnapshotPublisher
+{
+public:
+	using Ptr = std::shared_ptr<ChainSnapshotPublisher>;
+
+	ChainSnapshotPublisher() : m_pSnapshot(std::make_shared<const ChainSnapshot>(nullptr, nullptr, 0)) { }
+
+	ChainSnapshot::CPtr Get() const { return std::atomic_load(&m_pSnapshot); }
+
+	//
+	// Publishes the tips if either changed. Only the chain state writer calls this, so it doesn't need to be atomic as a whole.
+	//
+	void Publish(const BlockHeaderPtr& pConfirmedTip, const BlockHeaderPtr& pCandidateTip)
+	{
+		ChainSnapshot::CPtr pCurrent = Get();
+		if (SameHeader(pCurrent->GetTip(EChainType::CONFIRMED), pConfirmedTip)
+			&& SameHeader(pCurrent->GetTip(EChainType::CANDIDATE), pCandidateTip))
+		{
+			return;
+		}
+
+		uint64_t generation = pCurrent->GetGeneration();
+		if (!SameHeader(pCurrent->GetTip(EChainType::CONFIRMED), pConfirmedTip))
+		{
+			++generation;
+		}
+
+		std::atomic_store(&m_pSnapshot, std::make_shared<const ChainSnapshot>(pConfirmedTip, pCandidateTip, generation));
+
+		// Taking the mutex means a waiter can't miss the change between checking the snapshot and waiting.
+		{
+			std::lock_guard<std::mutex> lock(m_waitMutex);
+		}
+		m_changed.notify_all();
+	}
+
+	//
+	// Blocks until the confirmed tip is no longer the given block, or the timeout passes, and returns the latest snapshot.
+	// Lets subscribers wake up as soon as a block is connected instead of polling.
+	//
+	ChainSnapshot::CPtr WaitForChange(const Hash& confirmedTipHash, const std::chrono::milliseconds& timeout) const
+	{
+		std::unique_lock<std::mutex> lock(m_waitMutex);
+		m_changed.wait_for(lock, timeout, [this, &confirmedTipHash] {
+			ChainSnapshot::CPtr pSnapshot = Get();
+			const BlockHeaderPtr& pTip = pSnapshot->GetTip(EChainType::CONFIRMED);
+			return pTip == nullptr || pTip->GetHash() != confirmedTipHash;
+		});
+
+		return Get();
+	}
+
+private:
+	static bool SameHeader(const BlockHeaderPtr& pHeader1, const BlockHeaderPtr& pHeader2)
+	{
+		if (pHeader1 == nullptr || pHeader2 == nullptr)
+		{
+			return pHeader1 == pHeader2;
+		}
+
+		return pHeader1->GetHash() == pHeader2->GetHash();
+	}
+
+	ChainSnapshot::CPtr m_pSnapshot;
+
+	mutable std::mutex m_waitMutex;
+	mutable std::condition_variable m_changed;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <Common/ImportExport.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#ifdef MW_INFRASTRUCTURE
+#define ALLOC_PROFILER_API EXPORT
+#else
+#define ALLOC_PROFILER_API IMPORT
+#endif
+
+//
+// The subsystem an allocation is counted under. Allocations made outside of any ScopedAllocTag are UNTAGGED.
+//
+enum class EAllocTag : uint8_t
+{
+	UNTAGGED = 0,
+	SERIALIZER,
+	BYTE_BUFFER,
+	PMMR_DATA,
+	P2P_MESSAGES,
+	TXPOOL,
+	WALLET_DB,
+	COUNT
+};
+
+struct AllocTagStats
+{
+	std::string name;
+	uint64_t numAllocs;
+	uint64_t numBytes;
+	uint64_t numFrees;
+	uint64_t liveBytes;
+	uint64_t peakLiveBytes;
+};
+
+//
+// Counts operator new allocations by the tag of the thread that made them, when built with GRINPP_ALLOC_PROFILING.
+// Each allocation is prefixed with its size and tag, so it's freed from the right tag's live bytes, whichever thread frees it.
+// Otherwise nothing is counted, and ScopedAllocTag compiles to nothing.
+//
+namespace AllocProfilerAPI
+{
+	ALLOC_PROFILER_API bool IsEnabled();
+
+	//
+	// Retrieves the counters of every tag, in EAllocTag order. Empty unless profiling is enabled.
+	//
+	ALLOC_PROFILER_API std::vector<AllocTagStats> GetStats();
+
+	//
+	// Sets the current thread's tag, returning the previous one. Use ScopedAllocTag rather than calling this directly.
+	//
+	ALLOC_PROFILER_API EAllocTag SetCurrentTag(const EAllocTag tag);
+}
+
+//
+// Counts the current thread's allocations under the tag until it goes out of scope, restoring the previous tag.
+// The innermost tag wins, eg. a Serializer used while handling a P2P message counts as SERIALIZER.
+//
+class ScopedAllocTag
+{
+public:
+#ifdef GRINPP_ALLOC_PROFILING
+	explicit ScopedAllocTag(const EAllocTag tag) : m_previous(AllocProfilerAPI::SetCurrentTag(tag)) { }
+	~ScopedAllocTag() { AllocProfilerAPI::SetCurrentTag(m_previous); }
+#else
+	explicit ScopedAllocTag(const EAllocTag) { }
+#endif
+
+	ScopedAllocTag(const ScopedAllocTag&) = delete;
+	ScopedAllocTag& operator=(const ScopedAllocTag&) = delete;
+
+#ifdef GRINPP_ALLOC_PROFILING
+private:
+	EAllocTag m_previous;
+#endif
+};
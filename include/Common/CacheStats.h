@@ -0,0 +1,15 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//
+// Point-in-time usage counters for an in-memory cache.
+//
+struct CacheStats
+{
+	size_t capacity;
+	size_t size;
+	uint64_t hits;
+	uint64_t misses;
+};
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <chrono>
 #include <deque>
+#include <memory>
 #include <vector>
 #include <thread>
 #include <functional>
@@ -86,28 +88,80 @@ public:
 		}
 	}
 
-	//T pop()
-	//{
-	//	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
-	//	while (m_deque.empty())
-	//	{
-	//		m_conditional.wait(writeLock);
-	//	}
-	//	auto item = m_deque.front();
-	//	m_deque.pop_front();
-	//	return item;
-	//}
-
-	//void pop(T& item)
-	//{
-	//	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
-	//	while (m_deque.empty())
-	//	{
-	//		m_conditional.wait(writeLock);
-	//	}
-	//	item = m_deque.front();
-	//	m_deque.pop_front();
-	//}
+	//
+	// Moves the front item out into item, if there is one.
+	//
+	bool try_pop(T& item)
+	{
+		std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+		if (m_deque.empty())
+		{
+			return false;
+		}
+
+		item = std::move(m_deque.front());
+		m_deque.pop_front();
+		return true;
+	}
+
+	//
+	// Blocks until an item is pushed (or wake_all is called) for up to timeout, then moves the front item out into item.
+	// Returns false if the queue is still empty.
+	//
+	template<class Rep, class Period>
+	bool pop(T& item, const std::chrono::duration<Rep, Period>& timeout)
+	{
+		std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+		if (!m_conditional.wait_for(writeLock, timeout, [this] { return !m_deque.empty() || m_wake; }) || m_deque.empty())
+		{
+			return false;
+		}
+
+		item = std::move(m_deque.front());
+		m_deque.pop_front();
+		return true;
+	}
+
+	//
+	// Blocking version of copy_front. Waits up to timeout for an item, leaving it in the queue until pop_front is called.
+	// Useful when the item must still be found by contains/push_back_unique while it's being processed.
+	//
+	template<class Rep, class Period>
+	std::unique_ptr<T> wait_front(const std::chrono::duration<Rep, Period>& timeout)
+	{
+		std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+		if (!m_conditional.wait_for(writeLock, timeout, [this] { return !m_deque.empty() || m_wake; }) || m_deque.empty())
+		{
+			return nullptr;
+		}
+
+		return std::make_unique<T>(m_deque.front());
+	}
+
+	//
+	// Wakes every blocked consumer, and keeps future waits from blocking. Used when shutting down.
+	//
+	void wake_all()
+	{
+		{
+			std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+			m_wake = true;
+		}
+
+		m_conditional.notify_all();
+	}
+
+	size_t size() const
+	{
+		std::shared_lock<std::shared_mutex> readLock(m_mutex);
+		return m_deque.size();
+	}
+
+	bool empty() const
+	{
+		std::shared_lock<std::shared_mutex> readLock(m_mutex);
+		return m_deque.empty();
+	}
 
 	void push_back(const T& item)
 	{
@@ -138,11 +192,14 @@ public:
 		}
 
 		m_deque.push_back(std::move(item));
+		writeLock.unlock();
+		m_conditional.notify_one();
 		return true;
 	}
 
 private:
 	std::deque<T> m_deque;
 	mutable std::shared_mutex m_mutex;
-	std::condition_variable m_conditional;
+	std::condition_variable_any m_conditional;
+	bool m_wake = false;
 };
\ No newline at end of file
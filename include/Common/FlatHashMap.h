@@ -0,0 +1,355 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+//
+// Open-addressing hash containers with linear probing, for hot lookups keyed by Hash, Commitment, or ids.
+// Entries live in one contiguous array rather than in a node per entry, so lookups touch a cache line or two instead of chasing pointers.
+// Erasing shifts the entries after it back, rather than leaving a tombstone, so probe lengths don't grow as entries come and go.
+//
+// Hashes are spread with a Fibonacci multiply, so sequential keys (eg. ids) don't cluster.
+// Unlike the std containers, references and iterators are invalidated by erase as well as by inserts that grow the table,
+// and entries can only be erased by key, so they can't be erased while iterating.
+//
+namespace FlatHash
+{
+	template<typename Value, typename Key, typename KeyOf, typename Hasher, typename KeyEqual>
+	class Table
+	{
+	public:
+		template<bool IS_CONST>
+		class Iterator
+		{
+		public:
+			using iterator_category = std::forward_iterator_tag;
+			using value_type = Value;
+			using difference_type = std::ptrdiff_t;
+			using pointer = std::conditional_t<IS_CONST, const Value*, Value*>;
+			using reference = std::conditional_t<IS_CONST, const Value&, Value&>;
+			using Slots = std::conditional_t<IS_CONST, const std::vector<std::optional<Value>>, std::vector<std::optional<Value>>>;
+
+			Iterator(Slots* pSlots, const size_t index) : m_pSlots(pSlots), m_index(index) { SkipEmpty(); }
+
+			// Allows iterator -> const_iterator.
+			operator Iterator<true>() const { return Iterator<true>(m_pSlots, m_index); }
+
+			reference operator*() const { return *(*m_pSlots)[m_index]; }
+			pointer operator->() const { return &*(*m_pSlots)[m_index]; }
+
+			Iterator& operator++()
+			{
+				++m_index;
+				SkipEmpty();
+				return *this;
+			}
+
+			Iterator operator++(int)
+			{
+				Iterator previous = *this;
+				++(*this);
+				return previous;
+			}
+
+			// iterators and const_iterators can be compared with each other.
+			template<bool RHS_CONST>
+			bool operator==(const Iterator<RHS_CONST>& rhs) const noexcept { return m_index == rhs.GetSlotIndex(); }
+			template<bool RHS_CONST>
+			bool operator!=(const Iterator<RHS_CONST>& rhs) const noexcept { return m_index != rhs.GetSlotIndex(); }
+
+			size_t GetSlotIndex() const noexcept { return m_index; }
+
+		private:
+			void SkipEmpty()
+			{
+				while (m_index < m_pSlots->size() && !(*m_pSlots)[m_index].has_value())
+				{
+					++m_index;
+				}
+			}
+
+			Slots* m_pSlots;
+			size_t m_index;
+		};
+
+		using iterator = Iterator<false>;
+		using const_iterator = Iterator<true>;
+
+		Table() = default;
+
+		size_t size() const noexcept { return m_size; }
+		bool empty() const noexcept { return m_size == 0; }
+
+		void clear()
+		{
+			m_slots.clear();
+			m_size = 0;
+			m_shift = 64;
+		}
+
+		//
+		// Makes room for numEntries without rehashing.
+		//
+		void reserve(const size_t numEntries)
+		{
+			size_t capacity = MIN_CAPACITY;
+			while (capacity * MAX_LOAD_NUMERATOR < numEntries * MAX_LOAD_DENOMINATOR)
+			{
+				capacity *= 2;
+			}
+
+			if (capacity > m_slots.size())
+			{
+				Rehash(capacity);
+			}
+		}
+
+		iterator begin() { return iterator(&m_slots, 0); }
+		iterator end() { return iterator(&m_slots, m_slots.size()); }
+		const_iterator begin() const { return const_iterator(&m_slots, 0); }
+		const_iterator end() const { return const_iterator(&m_slots, m_slots.size()); }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend() const { return end(); }
+
+		iterator find(const Key& key)
+		{
+			const std::optional<size_t> index = FindIndex(key);
+			return index.has_value() ? iterator(&m_slots, index.value()) : end();
+		}
+
+		const_iterator find(const Key& key) const
+		{
+			const std::optional<size_t> index = FindIndex(key);
+			return index.has_value() ? const_iterator(&m_slots, index.value()) : end();
+		}
+
+		size_t count(const Key& key) const { return FindIndex(key).has_value() ? 1 : 0; }
+		bool contains(const Key& key) const { return FindIndex(key).has_value(); }
+
+		size_t erase(const Key& key)
+		{
+			const std::optional<size_t> index = FindIndex(key);
+			if (!index.has_value())
+			{
+				return 0;
+			}
+
+			EraseAt(index.value());
+			return 1;
+		}
+
+	protected:
+		//
+		// Inserts value if its key isn't already present. Returns the position of the entry with that key, and whether it was inserted.
+		//
+		template<typename... Args>
+		std::pair<iterator, bool> EmplaceKey(const Key& key, Args&&... args)
+		{
+			if (!m_slots.empty())
+			{
+				const std::optional<size_t> existing = FindIndex(key);
+				if (existing.has_value())
+				{
+					return { iterator(&m_slots, existing.value()), false };
+				}
+			}
+
+			if ((m_size + 1) * MAX_LOAD_DENOMINATOR > m_slots.size() * MAX_LOAD_NUMERATOR)
+			{
+				Rehash(m_slots.empty() ? MIN_CAPACITY : m_slots.size() * 2);
+			}
+
+			const size_t mask = m_slots.size() - 1;
+			size_t index = IdealIndex(key);
+			while (m_slots[index].has_value())
+			{
+				index = (index + 1) & mask;
+			}
+
+			m_slots[index].emplace(std::forward<Args>(args)...);
+			++m_size;
+			return { iterator(&m_slots, index), true };
+		}
+
+	private:
+		// Tables are kept at most 3/4 full, where linear probes are still short.
+		static constexpr size_t MAX_LOAD_NUMERATOR = 3;
+		static constexpr size_t MAX_LOAD_DENOMINATOR = 4;
+		static constexpr size_t MIN_CAPACITY = 16;
+
+		size_t IdealIndex(const Key& key) const noexcept
+		{
+			return (size_t)(((uint64_t)Hasher()(key) * 0x9E3779B97F4A7C15ull) >> m_shift);
+		}
+
+		std::optional<size_t> FindIndex(const Key& key) const
+		{
+			if (m_size == 0)
+			{
+				return std::nullopt;
+			}
+
+			const size_t mask = m_slots.size() - 1;
+			for (size_t index = IdealIndex(key); m_slots[index].has_value(); index = (index + 1) & mask)
+			{
+				if (KeyEqual()(KeyOf()(*m_slots[index]), key))
+				{
+					return std::make_optional(index);
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		void EraseAt(size_t index)
+		{
+			const size_t mask = m_slots.size() - 1;
+			m_slots[index].reset();
+			--m_size;
+
+			// Shifts back each following entry that can't be found from its ideal slot once there's a gap before it.
+			for (size_t next = (index + 1) & mask; m_slots[next].has_value(); next = (next + 1) & mask)
+			{
+				const size_t ideal = IdealIndex(KeyOf()(*m_slots[next]));
+				if (((next - ideal) & mask) >= ((next - index) & mask))
+				{
+					m_slots[index] = std::move(m_slots[next]);
+					m_slots[next].reset();
+					index = next;
+				}
+			}
+		}
+
+		void Rehash(const size_t capacity)
+		{
+			std::vector<std::optional<Value>> slots(capacity);
+			slots.swap(m_slots);
+
+			m_shift = 64;
+			for (size_t bits = capacity; bits > 1; bits >>= 1)
+			{
+				--m_shift;
+			}
+
+			const size_t mask = capacity - 1;
+			for (std::optional<Value>& slot : slots)
+			{
+				if (slot.has_value())
+				{
+					size_t index = IdealIndex(KeyOf()(*slot));
+					while (m_slots[index].has_value())
+					{
+						index = (index + 1) & mask;
+					}
+
+					m_slots[index] = std::move(slot);
+				}
+			}
+		}
+
+		std::vector<std::optional<Value>> m_slots;
+		size_t m_size = 0;
+
+		// 64 - log2(capacity), so the top bits of the multiplied hash pick the slot.
+		uint8_t m_shift = 64;
+	};
+
+	template<typename K, typename V>
+	struct PairKey
+	{
+		const K& operator()(const std::pair<K, V>& value) const noexcept { return value.first; }
+	};
+
+	template<typename K>
+	struct IdentityKey
+	{
+		const K& operator()(const K& value) const noexcept { return value; }
+	};
+}
+
+//
+// A drop-in for the common parts of std::unordered_map. Keys must not be modified through iterators.
+//
+template<typename K, typename V, typename Hasher = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class FlatHashMap : public FlatHash::Table<std::pair<K, V>, K, FlatHash::PairKey<K, V>, Hasher, KeyEqual>
+{
+	using Base = FlatHash::Table<std::pair<K, V>, K, FlatHash::PairKey<K, V>, Hasher, KeyEqual>;
+
+public:
+	using iterator = typename Base::iterator;
+	using const_iterator = typename Base::const_iterator;
+
+	std::pair<iterator, bool> insert(const std::pair<K, V>& value) { return this->EmplaceKey(value.first, value); }
+	std::pair<iterator, bool> insert(std::pair<K, V>&& value) { return this->EmplaceKey(value.first, std::move(value)); }
+
+	template<typename... Args>
+	std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+	{
+		return this->EmplaceKey(key, std::piecewise_construct, std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	template<typename KArg, typename... Args>
+	std::pair<iterator, bool> emplace(KArg&& key, Args&&... args)
+	{
+		K k(std::forward<KArg>(key));
+		return this->EmplaceKey(k, std::piecewise_construct, std::forward_as_tuple(std::move(k)), std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+	V& at(const K& key)
+	{
+		auto iter = this->find(key);
+		if (iter == this->end())
+		{
+			throw std::out_of_range("FlatHashMap::at");
+		}
+
+		return iter->second;
+	}
+
+	const V& at(const K& key) const
+	{
+		auto iter = this->find(key);
+		if (iter == this->end())
+		{
+			throw std::out_of_range("FlatHashMap::at");
+		}
+
+		return iter->second;
+	}
+};
+
+//
+// A drop-in for the common parts of std::unordered_set.
+//
+template<typename K, typename Hasher = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+class FlatHashSet : public FlatHash::Table<K, K, FlatHash::IdentityKey<K>, Hasher, KeyEqual>
+{
+	using Base = FlatHash::Table<K, K, FlatHash::IdentityKey<K>, Hasher, KeyEqual>;
+
+public:
+	using iterator = typename Base::iterator;
+	using const_iterator = typename Base::const_iterator;
+
+	FlatHashSet() = default;
+
+	template<typename InputIt>
+	FlatHashSet(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first)
+		{
+			insert(*first);
+		}
+	}
+
+	std::pair<iterator, bool> insert(const K& key) { return this->EmplaceKey(key, key); }
+	std::pair<iterator, bool> insert(K&& key) { return this->EmplaceKey(key, std::move(key)); }
+};
@@ -2,6 +2,8 @@
 
 #include <Common/ImportExport.h>
 #include <Common/Util/StringUtil.h>
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 #ifdef MW_INFRASTRUCTURE
@@ -18,7 +20,16 @@ namespace LoggerAPI
 		WALLET
 	};
 
-	LOGGER_API void Initialize(const fs::path& logDirectory, const std::string& logLevel);
+	//
+	// Unless blockOnOverflow is set, messages are discarded (and counted) while a log's queue is full, so the threads logging them never wait on the disk.
+	// Each trace and debug call site logs at most callSiteRateLimit messages per second (0 for no limit). See CallSite.
+	//
+	LOGGER_API void Initialize(
+		const fs::path& logDirectory,
+		const std::string& logLevel,
+		const bool blockOnOverflow = false,
+		const uint32_t callSiteRateLimit = 0
+	);
 	LOGGER_API void Shutdown();
 
 	LOGGER_API void LogTrace(const std::string& message);
@@ -28,6 +39,24 @@ namespace LoggerAPI
 	LOGGER_API void LogError(const std::string& message);
 	LOGGER_API void Flush();
 
+	//
+	// Whether messages at the level would be written to the file's log.
+	// Checked by the trace and debug macros before they build their message, since most of them are discarded.
+	//
+	LOGGER_API bool IsTraceEnabled(const LogFile file);
+	LOGGER_API bool IsDebugEnabled(const LogFile file);
+
+	//
+	// The state of one trace or debug call site's rate limit, which counts its messages in 1 second windows.
+	// Messages over the limit are discarded, and counted in the grin_log_messages_dropped_total metric.
+	//
+	struct CallSite
+	{
+		std::atomic<int64_t> window{ 0 };
+		std::atomic<uint32_t> count{ 0 };
+	};
+
+	LOGGER_API bool IsAllowed(const LogFile file, CallSite& callSite);
 
 	LOGGER_API void LogTrace(const LogFile file, const std::string& function, const size_t line, const std::string& message);
 	LOGGER_API void LogDebug(const LogFile file, const std::string& function, const size_t line, const std::string& message);
@@ -36,28 +65,48 @@ namespace LoggerAPI
 	LOGGER_API void LogError(const LogFile file, const std::string& function, const size_t line, const std::string& message);
 }
 
+//
+// Trace and debug messages are only built if their level is enabled, and their call site is under its rate limit.
+// Each expansion gets its own CallSite, as the static of its own lambda.
+// Trace logging is compiled out of release builds, unless GRINPP_TRACE_LOGGING is defined.
+// The elided message is still type-checked, but never evaluated.
+//
+#define LOGGER_IF_ENABLED(level, file, log) \
+	((LoggerAPI::Is##level##Enabled(file) && LoggerAPI::IsAllowed(file, []() -> LoggerAPI::CallSite& { static LoggerAPI::CallSite site; return site; }())) ? log : (void)0)
+
+#if defined(NDEBUG) && !defined(GRINPP_TRACE_LOGGING)
+#define LOGGER_TRACE(file, message) ((void)sizeof(message))
+#define LOGGER_TRACE_F(file, message, ...) ((void)sizeof(StringUtil::Format(message, __VA_ARGS__)))
+#else
+#define LOGGER_TRACE(file, message) LOGGER_IF_ENABLED(Trace, file, LoggerAPI::LogTrace(file, __func__, __LINE__, message))
+#define LOGGER_TRACE_F(file, message, ...) LOGGER_IF_ENABLED(Trace, file, LoggerAPI::LogTrace(file, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__)))
+#endif
+
+#define LOGGER_DEBUG(file, message) LOGGER_IF_ENABLED(Debug, file, LoggerAPI::LogDebug(file, __func__, __LINE__, message))
+#define LOGGER_DEBUG_F(file, message, ...) LOGGER_IF_ENABLED(Debug, file, LoggerAPI::LogDebug(file, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__)))
+
 // Node Logger
-#define LOG_TRACE(message) LoggerAPI::LogTrace(LoggerAPI::LogFile::NODE, __func__, __LINE__, message)
-#define LOG_DEBUG(message) LoggerAPI::LogDebug(LoggerAPI::LogFile::NODE, __func__, __LINE__, message)
+#define LOG_TRACE(message) LOGGER_TRACE(LoggerAPI::LogFile::NODE, message)
+#define LOG_DEBUG(message) LOGGER_DEBUG(LoggerAPI::LogFile::NODE, message)
 #define LOG_INFO(message) LoggerAPI::LogInfo(LoggerAPI::LogFile::NODE, __func__, __LINE__, message)
 #define LOG_WARNING(message) LoggerAPI::LogWarning(LoggerAPI::LogFile::NODE, __func__, __LINE__, message)
 #define LOG_ERROR(message) LoggerAPI::LogError(LoggerAPI::LogFile::NODE, __func__, __LINE__, message)
 
-#define LOG_TRACE_F(message, ...) LoggerAPI::LogTrace(LoggerAPI::LogFile::NODE, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
-#define LOG_DEBUG_F(message, ...) LoggerAPI::LogDebug(LoggerAPI::LogFile::NODE, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
+#define LOG_TRACE_F(message, ...) LOGGER_TRACE_F(LoggerAPI::LogFile::NODE, message, __VA_ARGS__)
+#define LOG_DEBUG_F(message, ...) LOGGER_DEBUG_F(LoggerAPI::LogFile::NODE, message, __VA_ARGS__)
 #define LOG_INFO_F(message, ...) LoggerAPI::LogInfo(LoggerAPI::LogFile::NODE, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
 #define LOG_WARNING_F(message, ...) LoggerAPI::LogWarning(LoggerAPI::LogFile::NODE, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
 #define LOG_ERROR_F(message, ...) LoggerAPI::LogError(LoggerAPI::LogFile::NODE, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
 
 // Wallet Logger
-#define WALLET_TRACE(message) LoggerAPI::LogTrace(LoggerAPI::LogFile::WALLET, __func__, __LINE__, message)
-#define WALLET_DEBUG(message) LoggerAPI::LogDebug(LoggerAPI::LogFile::WALLET, __func__, __LINE__, message)
+#define WALLET_TRACE(message) LOGGER_TRACE(LoggerAPI::LogFile::WALLET, message)
+#define WALLET_DEBUG(message) LOGGER_DEBUG(LoggerAPI::LogFile::WALLET, message)
 #define WALLET_INFO(message) LoggerAPI::LogInfo(LoggerAPI::LogFile::WALLET, __func__, __LINE__, message)
 #define WALLET_WARNING(message) LoggerAPI::LogWarning(LoggerAPI::LogFile::WALLET, __func__, __LINE__, message)
 #define WALLET_ERROR(message) LoggerAPI::LogError(LoggerAPI::LogFile::WALLET, __func__, __LINE__, message)
 
-#define WALLET_TRACE_F(message, ...) LoggerAPI::LogTrace(LoggerAPI::LogFile::WALLET, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
-#define WALLET_DEBUG_F(message, ...) LoggerAPI::LogDebug(LoggerAPI::LogFile::WALLET, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
+#define WALLET_TRACE_F(message, ...) LOGGER_TRACE_F(LoggerAPI::LogFile::WALLET, message, __VA_ARGS__)
+#define WALLET_DEBUG_F(message, ...) LOGGER_DEBUG_F(LoggerAPI::LogFile::WALLET, message, __VA_ARGS__)
 #define WALLET_INFO_F(message, ...) LoggerAPI::LogInfo(LoggerAPI::LogFile::WALLET, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
 #define WALLET_WARNING_F(message, ...) LoggerAPI::LogWarning(LoggerAPI::LogFile::WALLET, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
 #define WALLET_ERROR_F(message, ...) LoggerAPI::LogError(LoggerAPI::LogFile::WALLET, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
\ No newline at end of file
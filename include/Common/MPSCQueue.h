@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+//
+// Unbounded, lock-free queue for many producers and a single consumer (Vyukov's intrusive MPSC design).
+//
+// push never blocks or takes a lock, so producers (eg. broadcasts from any thread) never contend with the consumer.
+// try_pop and empty must only be called by one consumer at a time (eg. from a connection's strand).
+// A push that is still in progress may not be visible to try_pop yet, so consumers should be
+// notified by the producer after pushing, rather than polling.
+//
+template <typename T>
+class MPSCQueue
+{
+public:
+	MPSCQueue()
+	{
+		Node* pStub = new Node();
+		m_head.store(pStub);
+		m_pTail = pStub;
+	}
+
+	~MPSCQueue()
+	{
+		Node* pNode = m_pTail;
+		while (pNode != nullptr)
+		{
+			Node* pNext = pNode->pNext.load(std::memory_order_acquire);
+			delete pNode;
+			pNode = pNext;
+		}
+	}
+
+	MPSCQueue(const MPSCQueue&) = delete;
+	MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+	void push(T&& item)
+	{
+		Node* pNode = new Node();
+		pNode->value.emplace(std::move(item));
+
+		Node* pPrevious = m_head.exchange(pNode, std::memory_order_acq_rel);
+		pPrevious->pNext.store(pNode, std::memory_order_release);
+	}
+
+	void push(const T& item)
+	{
+		T copy(item);
+		push(std::move(copy));
+	}
+
+	//
+	// Consumer only. Moves the oldest item out into item, if there is one.
+	//
+	bool try_pop(T& item)
+	{
+		Node* pNext = m_pTail->pNext.load(std::memory_order_acquire);
+		if (pNext == nullptr)
+		{
+			return false;
+		}
+
+		item = std::move(*pNext->value);
+		pNext->value.reset();
+
+		// The popped node becomes the new stub.
+		delete m_pTail;
+		m_pTail = pNext;
+		return true;
+	}
+
+	//
+	// Consumer only.
+	//
+	bool empty() const
+	{
+		return m_pTail->pNext.load(std::memory_order_acquire) == nullptr;
+	}
+
+private:
+	struct Node
+	{
+		std::atomic<Node*> pNext{ nullptr };
+		std::optional<T> value;
+	};
+
+	// Producers swap themselves in at the head.
+	alignas(64) std::atomic<Node*> m_head;
+
+	// Only touched by the consumer.
+	alignas(64) Node* m_pTail;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <Common/ImportExport.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef MW_INFRASTRUCTURE
+#define MEMORY_BUDGET_API EXPORT
+#else
+#define MEMORY_BUDGET_API IMPORT
+#endif
+
+//
+// A cache or pool whose size is governed by the node's memory budget.
+// getUsage estimates the bytes it currently uses, and setLimit is given the bytes it may use from now on, evicting down to them if needed.
+// Both are called from whichever thread changes the budget (holding the budget's lock), so must be thread safe and must not call MemoryBudgetAPI.
+//
+struct MemoryConsumer
+{
+	std::string name;
+
+	// The consumer's share of the budget is its priority over the sum of every consumer's priority.
+	uint32_t priority;
+
+	// The consumer is never limited to less than this, even if the budget is too small.
+	size_t minBytes;
+
+	std::function<size_t()> getUsage;
+	std::function<void(const size_t)> setLimit;
+};
+
+struct MemoryConsumerStats
+{
+	std::string name;
+	uint32_t priority;
+
+	// 0 while there's no budget, in which case the consumer keeps its configured size.
+	size_t limitBytes;
+	size_t usageBytes;
+};
+
+//
+// Unregisters the consumer when destroyed, so it should be the owner's last member, to be destroyed before what setLimit uses.
+//
+class MEMORY_BUDGET_API MemoryBudgetRegistration
+{
+public:
+	using UPtr = std::unique_ptr<MemoryBudgetRegistration>;
+
+	explicit MemoryBudgetRegistration(const uint64_t id) : m_id(id) { }
+	~MemoryBudgetRegistration();
+
+	MemoryBudgetRegistration(const MemoryBudgetRegistration&) = delete;
+	MemoryBudgetRegistration& operator=(const MemoryBudgetRegistration&) = delete;
+
+private:
+	uint64_t m_id;
+};
+
+//
+// Apportions a single memory budget across the registered caches and pools, by priority.
+// Without a budget (the default), consumers keep their configured sizes.
+//
+namespace MemoryBudgetAPI
+{
+	//
+	// Registers the consumer, and re-apportions the budget (if there is one) to include it.
+	//
+	MEMORY_BUDGET_API MemoryBudgetRegistration::UPtr Register(MemoryConsumer&& consumer);
+
+	//
+	// Sets the total bytes apportioned across consumers, and applies each one's new limit. Can be called at any time,
+	// eg. to shrink the caches when the machine runs low on memory. 0 stops managing the consumers, leaving their current limits.
+	//
+	MEMORY_BUDGET_API void SetBudget(const size_t budgetBytes);
+	MEMORY_BUDGET_API size_t GetBudget();
+
+	MEMORY_BUDGET_API std::vector<MemoryConsumerStats> GetStats();
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <Common/ImportExport.h>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef MW_INFRASTRUCTURE
+#define METRICS_API EXPORT
+#else
+#define METRICS_API IMPORT
+#endif
+
+//
+// A value that only goes up, eg. the number of messages received.
+//
+class MetricCounter
+{
+public:
+	void Add(const uint64_t amount = 1) noexcept { m_value.fetch_add(amount, std::memory_order_relaxed); }
+	uint64_t Get() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<uint64_t> m_value{ 0 };
+};
+
+//
+// A value that can go up and down, eg. the number of orphan blocks.
+//
+class MetricGauge
+{
+public:
+	void Set(const int64_t value) noexcept { m_value.store(value, std::memory_order_relaxed); }
+	int64_t Get() const noexcept { return m_value.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<int64_t> m_value{ 0 };
+};
+
+//
+// Counts observations into buckets with fixed upper bounds, eg. how long blocks take to process.
+// Each bucket counts only the observations that fall in it; they're made cumulative when written.
+//
+class MetricHistogram
+{
+public:
+	explicit MetricHistogram(std::vector<double> bounds)
+		: m_bounds(std::move(bounds)), m_pBuckets(new std::atomic<uint64_t>[m_bounds.size() + 1]())
+	{
+
+	}
+
+	void Observe(const double value) noexcept
+	{
+		size_t bucket = 0;
+		while (bucket < m_bounds.size() && value > m_bounds[bucket])
+		{
+			++bucket;
+		}
+
+		m_pBuckets[bucket].fetch_add(1, std::memory_order_relaxed);
+
+		double sum = m_sum.load(std::memory_order_relaxed);
+		while (!m_sum.compare_exchange_weak(sum, sum + value, std::memory_order_relaxed)) { }
+	}
+
+	const std::vector<double>& GetBounds() const noexcept { return m_bounds; }
+
+	// The last bucket holds everything above the largest bound.
+	uint64_t GetBucketCount(const size_t bucket) const noexcept { return m_pBuckets[bucket].load(std::memory_order_relaxed); }
+	double GetSum() const noexcept { return m_sum.load(std::memory_order_relaxed); }
+
+private:
+	std::vector<double> m_bounds;
+	std::unique_ptr<std::atomic<uint64_t>[]> m_pBuckets;
+	std::atomic<double> m_sum{ 0.0 };
+};
+
+//
+// Builds a scrape in the Prometheus text exposition format.
+// Samples that share a name must be added one after another, so their HELP and TYPE lines are written once.
+// Labels are passed preformatted, eg. "type=\"Block\"", which Label builds.
+//
+class METRICS_API MetricsWriter
+{
+public:
+	static std::string Label(const std::string& name, const std::string& value);
+
+	void AddCounter(const std::string& name, const std::string& help, const std::string& labels, const uint64_t value);
+	void AddGauge(const std::string& name, const std::string& help, const std::string& labels, const double value);
+	void AddHistogram(const std::string& name, const std::string& help, const std::string& labels, const MetricHistogram& histogram);
+
+	const std::string& GetText() const noexcept { return m_text; }
+
+private:
+	void AddFamily(const std::string& name, const std::string& help, const std::string& type);
+	void AddSample(const std::string& name, const std::string& labels, const std::string& value);
+
+	std::string m_text;
+	std::string m_lastFamily;
+};
+
+//
+// Metrics that live for the lifetime of the process.
+// Registering takes a lock and allocates, so it should be done once (eg. into a static), after which
+// updating the returned metric is a single relaxed atomic operation.
+// Registering the same name and labels again returns the existing metric.
+//
+namespace MetricsAPI
+{
+	METRICS_API MetricCounter& RegisterCounter(const std::string& name, const std::string& help, const std::string& labels = "");
+	METRICS_API MetricGauge& RegisterGauge(const std::string& name, const std::string& help, const std::string& labels = "");
+	METRICS_API MetricHistogram& RegisterHistogram(
+		const std::string& name,
+		const std::string& help,
+		const std::vector<double>& bounds,
+		const std::string& labels = ""
+	);
+
+	//
+	// Writes every registered metric, grouped by name.
+	//
+	METRICS_API void Write(MetricsWriter& writer);
+}
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <Common/CacheStats.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//
+// A fixed-capacity, internally synchronized cache, split into NUM_SHARDS independently locked shards (selected by key hash),
+// so concurrent readers rarely contend on the same lock.
+//
+// Each shard uses the W-TinyLFU policy, so scans (eg. serving old headers to syncing peers) don't evict frequently used entries:
+//   * New entries go into a small LRU window (1% of the shard), where recency alone decides what's kept.
+//   * Entries leaving the window are only admitted to the main area if they've been used more often than the entry they'd evict,
+//     as estimated by a count-min sketch of recent lookups and inserts, whose counters are halved periodically so it adapts.
+//   * The main area is a segmented LRU: admitted entries start in probation, and move to the protected segment (80%) when used again.
+//
+// Values are returned by copy, so they should be cheap to copy, eg. shared_ptrs.
+//
+template<typename K, typename V, typename Hasher = std::hash<K>>
+class ShardedCache
+{
+public:
+	static constexpr size_t NUM_SHARDS = 16;
+
+	ShardedCache(const size_t capacity) : m_hits(0), m_misses(0)
+	{
+		SetCapacity(capacity);
+	}
+
+	void SetCapacity(const size_t capacity)
+	{
+		const size_t shardCapacity = (std::max)((capacity + NUM_SHARDS - 1) / NUM_SHARDS, (size_t)1);
+		for (Shard& shard : m_shards)
+		{
+			std::unique_lock<std::mutex> lock(shard.mutex);
+			shard.SetCapacity(shardCapacity);
+		}
+	}
+
+	size_t GetCapacity() const
+	{
+		size_t capacity = 0;
+		for (const Shard& shard : m_shards)
+		{
+			std::unique_lock<std::mutex> lock(shard.mutex);
+			capacity += shard.capacity;
+		}
+
+		return capacity;
+	}
+
+	size_t Size() const
+	{
+		size_t size = 0;
+		for (const Shard& shard : m_shards)
+		{
+			std::unique_lock<std::mutex> lock(shard.mutex);
+			size += shard.entries.size();
+		}
+
+		return size;
+	}
+
+	//
+	// Returns the cached value, or std::nullopt if not cached. Either way, counts towards the key's frequency.
+	//
+	std::optional<V> Get(const K& key) const
+	{
+		const size_t hash = Hasher()(key);
+		Shard& shard = GetShard(hash);
+
+		std::unique_lock<std::mutex> lock(shard.mutex);
+		shard.sketch.Increment(hash);
+
+		auto iter = shard.entries.find(key);
+		if (iter == shard.entries.end())
+		{
+			lock.unlock();
+			m_misses.fetch_add(1, std::memory_order_relaxed);
+			return std::nullopt;
+		}
+
+		shard.OnAccess(iter->second);
+		std::optional<V> value = std::make_optional(iter->second.iter->second);
+		lock.unlock();
+
+		m_hits.fetch_add(1, std::memory_order_relaxed);
+		return value;
+	}
+
+	//
+	// Adds the value to the cache's window, or replaces the cached value for the key.
+	//
+	void Put(const K& key, const V& value)
+	{
+		const size_t hash = Hasher()(key);
+		Shard& shard = GetShard(hash);
+
+		std::unique_lock<std::mutex> lock(shard.mutex);
+		auto iter = shard.entries.find(key);
+		if (iter != shard.entries.end())
+		{
+			iter->second.iter->second = value;
+			shard.OnAccess(iter->second);
+			return;
+		}
+
+		shard.sketch.Increment(hash);
+		shard.window.emplace_front(key, value);
+		shard.entries.emplace(key, Location{ ESegment::WINDOW, shard.window.begin() });
+		shard.EvictFromWindow();
+	}
+
+	CacheStats GetStats() const
+	{
+		CacheStats stats{ 0, 0, m_hits.load(std::memory_order_relaxed), m_misses.load(std::memory_order_relaxed) };
+		for (const Shard& shard : m_shards)
+		{
+			std::unique_lock<std::mutex> lock(shard.mutex);
+			stats.capacity += shard.capacity;
+			stats.size += shard.entries.size();
+		}
+
+		return stats;
+	}
+
+private:
+	using Entries = std::list<std::pair<K, V>>;
+
+	enum class ESegment
+	{
+		WINDOW,
+		PROBATION,
+		PROTECTED
+	};
+
+	struct Location
+	{
+		ESegment segment;
+		typename Entries::iterator iter;
+	};
+
+	//
+	// Estimates how often each key was used recently, with 4 rows of saturating counters. Entries are never removed,
+	// but once as many increments as 10 times the capacity have been made, all counters are halved, so old usage fades.
+	//
+	class FrequencySketch
+	{
+	public:
+		void SetCapacity(const size_t capacity)
+		{
+			size_t width = 16;
+			while (width < capacity * 4)
+			{
+				width *= 2;
+			}
+
+			m_counters.assign(width * NUM_ROWS, 0);
+			m_mask = width - 1;
+			m_sampleSize = capacity * 10;
+			m_additions = 0;
+		}
+
+		void Increment(const size_t hash)
+		{
+			bool incremented = false;
+			for (size_t row = 0; row < NUM_ROWS; row++)
+			{
+				uint8_t& counter = m_counters[Index(hash, row)];
+				if (counter < MAX_COUNT)
+				{
+					++counter;
+					incremented = true;
+				}
+			}
+
+			if (incremented && ++m_additions >= m_sampleSize)
+			{
+				for (uint8_t& counter : m_counters)
+				{
+					counter /= 2;
+				}
+
+				m_additions /= 2;
+			}
+		}
+
+		uint8_t Frequency(const size_t hash) const
+		{
+			uint8_t frequency = MAX_COUNT;
+			for (size_t row = 0; row < NUM_ROWS; row++)
+			{
+				frequency = (std::min)(frequency, m_counters[Index(hash, row)]);
+			}
+
+			return frequency;
+		}
+
+	private:
+		static constexpr size_t NUM_ROWS = 4;
+		static constexpr uint8_t MAX_COUNT = 15;
+
+		size_t Index(const size_t hash, const size_t row) const noexcept
+		{
+			static constexpr std::array<uint64_t, NUM_ROWS> SEEDS = {
+				0xc3a5c85c97cb3127ull, 0xb492b66fbe98f273ull, 0x9ae16a3b2f90404full, 0xcbf29ce484222325ull
+			};
+
+			const uint64_t mixed = ((uint64_t)hash + row) * SEEDS[row];
+			return (row * (m_mask + 1)) + (size_t)((mixed >> 32) & m_mask);
+		}
+
+		std::vector<uint8_t> m_counters;
+		size_t m_mask = 0;
+		size_t m_sampleSize = 0;
+		size_t m_additions = 0;
+	};
+
+	struct Shard
+	{
+		mutable std::mutex mutex;
+		size_t capacity = 0;
+		size_t windowCapacity = 0;
+		size_t protectedCapacity = 0;
+
+		// Most recently used at the front.
+		Entries window;
+		Entries probation;
+		Entries protectedEntries;
+		std::unordered_map<K, Location, Hasher> entries;
+		FrequencySketch sketch;
+
+		void SetCapacity(const size_t newCapacity)
+		{
+			capacity = newCapacity;
+			windowCapacity = (std::max)(capacity / 100, (size_t)1);
+			protectedCapacity = ((capacity - windowCapacity) * 8) / 10;
+			sketch.SetCapacity(capacity);
+
+			// Shrinking just drops the least recently used entries of each segment.
+			Trim(window, windowCapacity);
+			Trim(protectedEntries, protectedCapacity);
+			Trim(probation, capacity - windowCapacity - protectedEntries.size());
+		}
+
+		void OnAccess(Location& location)
+		{
+			switch (location.segment)
+			{
+				case ESegment::WINDOW:
+				{
+					window.splice(window.begin(), window, location.iter);
+					break;
+				}
+				case ESegment::PROBATION:
+				{
+					// Used again since it was admitted, so it's promoted, demoting the protected segment's LRU entry if it's full.
+					protectedEntries.splice(protectedEntries.begin(), probation, location.iter);
+					location.segment = ESegment::PROTECTED;
+					if (protectedEntries.size() > protectedCapacity)
+					{
+						auto demoted = std::prev(protectedEntries.end());
+						entries.at(demoted->first).segment = ESegment::PROBATION;
+						probation.splice(probation.begin(), protectedEntries, demoted);
+					}
+					break;
+				}
+				case ESegment::PROTECTED:
+				{
+					protectedEntries.splice(protectedEntries.begin(), protectedEntries, location.iter);
+					break;
+				}
+			}
+		}
+
+		void EvictFromWindow()
+		{
+			if (window.size() <= windowCapacity)
+			{
+				return;
+			}
+
+			auto candidate = std::prev(window.end());
+			const size_t mainCapacity = capacity - windowCapacity;
+			if (probation.size() + protectedEntries.size() < mainCapacity)
+			{
+				Admit(candidate);
+				return;
+			}
+
+			Entries& victims = probation.empty() ? protectedEntries : probation;
+			if (mainCapacity == 0 || victims.empty())
+			{
+				Evict(window, candidate);
+				return;
+			}
+
+			auto victim = std::prev(victims.end());
+			if (sketch.Frequency(Hasher()(candidate->first)) > sketch.Frequency(Hasher()(victim->first)))
+			{
+				Evict(victims, victim);
+				Admit(candidate);
+			}
+			else
+			{
+				Evict(window, candidate);
+			}
+		}
+
+		void Admit(typename Entries::iterator candidate)
+		{
+			entries.at(candidate->first).segment = ESegment::PROBATION;
+			probation.splice(probation.begin(), window, candidate);
+		}
+
+		void Evict(Entries& segment, typename Entries::iterator iter)
+		{
+			entries.erase(iter->first);
+			segment.erase(iter);
+		}
+
+		void Trim(Entries& segment, const size_t maxSize)
+		{
+			while (segment.size() > maxSize)
+			{
+				Evict(segment, std::prev(segment.end()));
+			}
+		}
+	};
+
+	Shard& GetShard(const size_t hash) const noexcept
+	{
+		static_assert(NUM_SHARDS == 16, "Shards are selected by the top 4 bits");
+
+		// Keys like Hashes may only use some of their bytes for std::hash, so the bits are mixed before picking a shard.
+		return m_shards[(size_t)(((uint64_t)hash * 0x9E3779B97F4A7C15ull) >> 60)];
+	}
+
+	mutable std::array<Shard, NUM_SHARDS> m_shards;
+	mutable std::atomic<uint64_t> m_hits;
+	mutable std::atomic<uint64_t> m_misses;
+};
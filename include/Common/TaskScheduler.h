@@ -0,0 +1,159 @@
+#pragma once
+
+#include <Common/ThreadPool.h>
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// Point-in-time counters for a task of a TaskScheduler.
+// Lag is how late a run started compared to when it was due, including the time it spent queued on the thread pool.
+// An overrun is a run that was skipped, because the previous one was still queued or running when it came due.
+//
+struct ScheduledTaskStats
+{
+	std::string name;
+	uint64_t runs;
+	uint64_t overruns;
+	uint64_t totalRunMicros;
+	uint64_t maxRunMicros;
+	uint64_t totalLagMicros;
+	uint64_t maxLagMicros;
+};
+
+//
+// Runs periodic tasks on a thread pool of its own, from a single thread that drives a hierarchical timer wheel.
+// The tasks don't share the pool with validation, so they're neither queued behind it nor run by a thread waiting on it.
+// The wheel advances one slot per tick, and slots of the coarser levels are cascaded into the finer ones as their turn comes,
+// so adding, removing and expiring a task cost the same however many tasks are scheduled.
+// A task never runs concurrently with itself.
+//
+class THREAD_MANAGER_API TaskScheduler
+{
+public:
+	using Ptr = std::shared_ptr<TaskScheduler>;
+	using TaskId = uint64_t;
+
+	static TaskScheduler::Ptr Create(
+		const std::chrono::milliseconds& tickDuration = std::chrono::milliseconds(10),
+		const size_t numThreads = 4
+	);
+	~TaskScheduler();
+
+	//
+	// Stops the wheel, and waits for any runs in progress to finish. Nothing runs afterwards.
+	//
+	void Stop();
+
+	//
+	// Runs the task every period, starting one period from now. Runs that come due while the last is still running are skipped.
+	//
+	TaskId Interval(
+		const std::string& name,
+		const std::chrono::milliseconds& period,
+		std::function<void()>&& task,
+		const ETaskPriority priority = ETaskPriority::NORMAL
+	);
+
+	//
+	// Runs the task after the delay, and then again after each delay it returns, measured from the end of its run.
+	// If the task throws, it's run again after the delay of its previous run.
+	//
+	TaskId Schedule(
+		const std::string& name,
+		const std::chrono::milliseconds& delay,
+		std::function<std::chrono::milliseconds()>&& task,
+		const ETaskPriority priority = ETaskPriority::NORMAL
+	);
+
+	//
+	// Cancels the task. If it's running, waits for the run to finish, unless called from the task itself.
+	//
+	void RemoveTask(const TaskId taskId);
+
+	std::vector<ScheduledTaskStats> GetStats() const;
+
+	//
+	// Returns the stats of the tasks of every scheduler that is currently alive.
+	//
+	static std::vector<ScheduledTaskStats> GetAllStats();
+
+private:
+	struct Task
+	{
+		TaskId id;
+		std::string name;
+		ETaskPriority priority;
+		std::function<std::chrono::milliseconds()> func;
+
+		// Ticks between runs of an Interval task. 0 for Schedule tasks, which are re-added once each run finishes.
+		uint64_t periodTicks;
+		std::chrono::milliseconds lastDelay;
+
+		uint64_t expiryTick;
+		bool removed;
+
+		// Set from the time a run is posted to m_pPool until it finishes.
+		bool running;
+		std::thread::id runningThread;
+
+		ScheduledTaskStats stats;
+	};
+	using TaskPtr = std::shared_ptr<Task>;
+
+	struct DueRun
+	{
+		TaskPtr pTask;
+		std::chrono::steady_clock::time_point dueTime;
+	};
+
+	// Level 0 has a slot per tick. Each slot of level n covers a whole revolution of level n-1.
+	static constexpr size_t LEVEL0_BITS = 8;
+	static constexpr size_t LEVELN_BITS = 6;
+	static constexpr size_t NUM_LEVELS = 4;
+	static constexpr uint64_t MAX_TICKS = ((uint64_t)1 << (LEVEL0_BITS + LEVELN_BITS * (NUM_LEVELS - 1))) - 1;
+
+	TaskScheduler(const std::chrono::milliseconds& tickDuration);
+
+	TaskId AddTask(TaskPtr&& pTask, const std::chrono::milliseconds& delay);
+
+	// The number of whole ticks from the start until the time, and the first tick that expires no sooner than the time.
+	uint64_t GetElapsedTicks(const std::chrono::steady_clock::time_point& time) const;
+	uint64_t GetExpiryTick(const std::chrono::steady_clock::time_point& time) const;
+	std::chrono::steady_clock::time_point GetTickTime(const uint64_t tick) const;
+
+	// All of the below are called with m_mutex held.
+	void Insert(const TaskPtr& pTask);
+	size_t Cascade(const size_t level);
+	void ExpireTick(std::vector<DueRun>& dueRuns);
+
+	void Run(const DueRun& dueRun);
+
+	static void Thread_Tick(TaskScheduler& scheduler);
+
+	std::chrono::milliseconds m_tickDuration;
+	std::chrono::steady_clock::time_point m_start;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_wakeDriver;
+	std::condition_variable m_runFinished;
+
+	// The next tick to be expired.
+	uint64_t m_currentTick;
+	std::array<std::vector<std::vector<TaskPtr>>, NUM_LEVELS> m_wheel;
+	std::map<TaskId, TaskPtr> m_tasks;
+	TaskId m_nextId;
+	size_t m_numRunning;
+	bool m_stopping;
+
+	ThreadPool::Ptr m_pPool;
+	std::thread m_driverThread;
+};
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <map>
 #include <string>
 #include <thread>
+#include <vector>
 #include <Common/ImportExport.h>
 
 #ifdef MW_INFRASTRUCTURE
@@ -10,6 +14,38 @@
 #define THREAD_MANAGER_API IMPORT
 #endif
 
+class ThreadPool;
+struct ThreadPoolStats;
+
+//
+// Where a thread named with SetCurrentThreadName has spent its time since it was named.
+// cpuMicros is measured by the OS, and waitMicros is the time spent in ThreadWait scopes (sleeping or waiting for work).
+// The rest of the wall time was spent waiting for a core, or blocked in untracked calls (eg. socket reads).
+//
+struct ThreadStats
+{
+	std::string name;
+	std::string displayName;
+	uint64_t cpuMicros;
+	uint64_t waitMicros;
+	uint64_t wallMicros;
+
+	// What the thread is doing, if it's been tagged with a ThreadActivity. Empty otherwise.
+	std::string activity;
+};
+
+//
+// The totals of every thread with the same name, including those that have exited.
+//
+struct ThreadGroupStats
+{
+	std::string name;
+	size_t numThreads;
+	uint64_t cpuMicros;
+	uint64_t waitMicros;
+	uint64_t wallMicros;
+};
+
 namespace ThreadManagerAPI
 {
 	// Future: Implement a CreateThread method that takes the name, function, and parameters.
@@ -28,4 +64,96 @@ namespace ThreadManagerAPI
 	// Set the name of the current thread.
 	//
 	THREAD_MANAGER_API void SetCurrentThreadName(const std::string& threadName);
+
+	//
+	// Sets the number of threads used by the shared thread pool (0 to use one per core).
+	// Has no effect once the pool has been started by the first call to GetThreadPool.
+	//
+	THREAD_MANAGER_API void ConfigureThreadPool(const size_t numThreads);
+
+	//
+	// Retrieves the process-wide thread pool that validation, P2P and wallet work is submitted to.
+	//
+	THREAD_MANAGER_API ThreadPool& GetThreadPool();
+
+	//
+	// Sets the number of threads of a second pool for latency-sensitive work, like handling peer messages,
+	// so it isn't queued behind verification on the shared pool. 0 (the default) uses a quarter of the cores, and at least 2.
+	// Has no effect once the pool has been started by the first call to GetLatencyThreadPool.
+	//
+	THREAD_MANAGER_API void ConfigureLatencyThreadPool(const size_t numThreads);
+
+	//
+	// Retrieves the pool for latency-sensitive work. It's always separate from the shared pool.
+	//
+	THREAD_MANAGER_API ThreadPool& GetLatencyThreadPool();
+
+	//
+	// Pins threads to CPUs by name, keyed by name prefix (the longest matching prefix wins), eg. "WORKER" or "BLOCK".
+	// Applied when a thread is named with SetCurrentThreadName, so only threads named afterwards are pinned.
+	// Ignored where the OS has no thread affinity (macOS).
+	//
+	THREAD_MANAGER_API void ConfigureCpuAffinity(const std::map<std::string, std::vector<size_t>>& cpuSets);
+
+	//
+	// Retrieves the queue depth and busy time of every live thread pool.
+	//
+	THREAD_MANAGER_API std::vector<ThreadPoolStats> GetThreadPoolStats();
+
+	//
+	// Retrieves the CPU and wait time of every live thread named with SetCurrentThreadName.
+	//
+	THREAD_MANAGER_API std::vector<ThreadStats> GetThreadStats();
+
+	//
+	// Retrieves the CPU and wait time of every thread name, sorted by name. numThreads only counts live threads.
+	//
+	THREAD_MANAGER_API std::vector<ThreadGroupStats> GetThreadGroupStats();
+
+	//
+	// Adds to the current thread's wait time. Use ThreadWait rather than calling this directly.
+	//
+	THREAD_MANAGER_API void AddCurrentThreadWait(const uint64_t micros);
+
+	//
+	// Tags what the current thread is doing, returning the previous tag. The tag must outlive its use, eg. a string literal.
+	// Use ThreadActivity rather than calling this directly.
+	//
+	THREAD_MANAGER_API const char* SetCurrentThreadActivity(const char* activity);
+};
+
+//
+// Counts the time until it goes out of scope as the current thread's wait time, eg. around a sleep or condition variable wait.
+//
+class ThreadWait
+{
+public:
+	ThreadWait() : m_start(std::chrono::steady_clock::now()) { }
+	~ThreadWait()
+	{
+		const auto elapsed = std::chrono::steady_clock::now() - m_start;
+		ThreadManagerAPI::AddCurrentThreadWait((uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+	}
+
+	ThreadWait(const ThreadWait&) = delete;
+	ThreadWait& operator=(const ThreadWait&) = delete;
+
+private:
+	std::chrono::steady_clock::time_point m_start;
+};
+
+//
+// Tags what the current thread is doing until it goes out of scope, restoring the previous tag.
+//
+class ThreadActivity
+{
+public:
+	explicit ThreadActivity(const char* activity) : m_pPrevious(ThreadManagerAPI::SetCurrentThreadActivity(activity)) { }
+	~ThreadActivity() { ThreadManagerAPI::SetCurrentThreadActivity(m_pPrevious); }
+
+	ThreadActivity(const ThreadActivity&) = delete;
+	ThreadActivity& operator=(const ThreadActivity&) = delete;
+
+private:
+	const char* m_pPrevious;
 };
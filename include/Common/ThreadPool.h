@@ -0,0 +1,153 @@
+#pragma once
+
+#include <Common/ThreadManager.h>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// Higher priority tasks are always taken before lower priority ones, from a worker's own queue or when stealing.
+//
+enum class ETaskPriority
+{
+	HIGH = 0,	// Work a peer or the chain is waiting on (eg. block validation).
+	NORMAL = 1,
+	LOW = 2		// Background work (eg. wallet scanning).
+};
+
+//
+// Point-in-time usage counters for a ThreadPool.
+//
+struct ThreadPoolStats
+{
+	std::string name;
+	size_t numThreads;
+	size_t queueDepth;
+	uint64_t tasksCompleted;
+	uint64_t busyMicros;
+};
+
+//
+// A fixed set of worker threads, each with its own deque of tasks per priority.
+// Workers pop their own newest task first, and steal the oldest task of another worker when they run out.
+// Tasks submitted from outside the pool are spread round-robin over the workers.
+//
+class THREAD_MANAGER_API ThreadPool
+{
+public:
+	using Ptr = std::shared_ptr<ThreadPool>;
+
+	static ThreadPool::Ptr Create(const std::string& name, const size_t numThreads = GetDefaultNumThreads());
+	~ThreadPool();
+
+	//
+	// Stops accepting tasks, runs the queued ones, and joins the workers.
+	//
+	void Stop();
+
+	//
+	// Queues the task to be run by a worker. Exceptions thrown by the task are logged and discarded.
+	//
+	void Post(std::function<void()>&& task, const ETaskPriority priority = ETaskPriority::NORMAL);
+
+	//
+	// Queues the task, returning a future for its result (or exception).
+	//
+	template<typename F>
+	auto Submit(F&& func, const ETaskPriority priority = ETaskPriority::NORMAL) -> std::future<decltype(func())>
+	{
+		using Result = decltype(func());
+
+		auto pTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(func));
+		std::future<Result> future = pTask->get_future();
+		Post([pTask]() { (*pTask)(); }, priority);
+
+		return future;
+	}
+
+	//
+	// Blocks until the future is ready. Other queued tasks aren't run in the meantime, since the caller may be holding locks they need.
+	// Work split up by a task running on the pool should use RunParallel or RunAll, which only help with their own tasks.
+	//
+	template<typename T>
+	void Wait(const std::future<T>& future)
+	{
+		ThreadWait wait;
+		future.wait();
+	}
+
+	//
+	// Calls worker from numWorkers threads at once, one of them being the calling thread, and returns once every call has returned.
+	// Intended for loops that pull their work from a shared atomic index.
+	// While waiting, the calling thread only runs calls that no worker has started yet, never unrelated tasks.
+	//
+	void RunParallel(const size_t numWorkers, const std::function<void()>& worker, const ETaskPriority priority = ETaskPriority::NORMAL);
+
+	//
+	// Runs every task but the last on the pool, and the last on the calling thread, returning once all have finished.
+	// As with RunParallel, the calling thread then runs any of the tasks that no worker has started yet.
+	// The first exception thrown is rethrown once every task has finished.
+	//
+	void RunAll(const std::vector<std::function<void()>>& tasks, const ETaskPriority priority = ETaskPriority::NORMAL);
+
+	size_t GetNumThreads() const noexcept { return m_workers.size(); }
+	ThreadPoolStats GetStats() const;
+
+	static size_t GetDefaultNumThreads();
+
+	//
+	// Returns the stats of every pool that is currently alive.
+	//
+	static std::vector<ThreadPoolStats> GetAllStats();
+
+private:
+	struct Worker
+	{
+		std::mutex mutex;
+		std::array<std::deque<std::function<void()>>, 3> queues;
+	};
+
+	//
+	// The tasks of one RunAll call. Each task posted to the pool claims the next unstarted task of the group,
+	// so whichever of a worker and the waiting caller gets to a task first runs it.
+	//
+	struct TaskGroup
+	{
+		std::mutex mutex;
+		std::condition_variable finished;
+		size_t numTasks;
+		size_t nextTask;
+		size_t numFinished;
+		std::exception_ptr pException;
+	};
+
+	ThreadPool(const std::string& name, const size_t numThreads);
+
+	static bool RunNextInGroup(TaskGroup& group, const std::vector<std::function<void()>>& tasks);
+	bool TryPop(const size_t workerIndex, std::function<void()>& task);
+	void Run(std::function<void()>& task);
+
+	static void Thread_Work(ThreadPool& pool, const size_t workerIndex);
+
+	std::string m_name;
+	std::vector<std::unique_ptr<Worker>> m_workers;
+	std::vector<std::thread> m_threads;
+
+	std::mutex m_sleepMutex;
+	std::condition_variable m_taskQueued;
+	std::atomic_int64_t m_pending;
+	std::atomic_size_t m_nextWorker;
+	std::atomic_bool m_stopping;
+
+	std::atomic_uint64_t m_tasksCompleted;
+	std::atomic_uint64_t m_busyMicros;
+};
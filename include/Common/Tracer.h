@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Common/ImportExport.h>
+#include <filesystem.h>
+#include <chrono>
+#include <cstdint>
+
+#ifdef MW_INFRASTRUCTURE
+#define TRACER_API EXPORT
+#else
+#define TRACER_API IMPORT
+#endif
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+//
+// Records a span covering the rest of the enclosing scope, while tracing is enabled.
+// The name must be a string literal, since only the pointer is kept.
+//
+#define TRACE_SPAN(name) TraceSpan TRACE_CONCAT(traceSpan_, __LINE__)(name)
+
+namespace TracerAPI
+{
+	//
+	// Sets the directory that traces are dumped to, and the number of spans kept for each thread.
+	// Must be called before tracing is enabled.
+	//
+	TRACER_API void Configure(const fs::path& directory, const size_t eventsPerThread);
+
+	TRACER_API void SetEnabled(const bool enabled);
+	TRACER_API bool IsEnabled() noexcept;
+
+	//
+	// Microseconds since the process started, on the monotonic clock spans are timed with.
+	//
+	TRACER_API uint64_t GetTimestamp() noexcept;
+
+	//
+	// Adds a completed span to the calling thread's ring buffer, overwriting its oldest span once the buffer is full.
+	//
+	TRACER_API void Record(const char* name, const uint64_t startMicros, const uint64_t endMicros);
+
+	//
+	// Writes every thread's spans to a new file in the Chrome trace event format (chrome://tracing, Perfetto),
+	// and returns its path. Spans are kept, so a later dump includes them again until they're overwritten.
+	//
+	TRACER_API fs::path Dump();
+}
+
+class TraceSpan
+{
+public:
+	explicit TraceSpan(const char* name) noexcept
+		: m_name(TracerAPI::IsEnabled() ? name : nullptr), m_start(m_name != nullptr ? TracerAPI::GetTimestamp() : 0)
+	{
+
+	}
+
+	~TraceSpan()
+	{
+		if (m_name != nullptr)
+		{
+			try
+			{
+				TracerAPI::Record(m_name, m_start, TracerAPI::GetTimestamp());
+			}
+			catch (...) { }
+		}
+	}
+
+	TraceSpan(const TraceSpan&) = delete;
+	TraceSpan& operator=(const TraceSpan&) = delete;
+
+private:
+	const char* m_name;
+	uint64_t m_start;
+};
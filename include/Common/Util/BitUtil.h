@@ -5,7 +5,7 @@
 
 namespace BitUtil
 {
-	static uint64_t FillOnesToRight(const uint64_t input)
+	static constexpr uint64_t FillOnesToRight(const uint64_t input)
 	{
 		uint64_t x = input;
 		x = x | (x >> 1);
@@ -17,17 +17,50 @@ namespace BitUtil
 		return x;
 	}
 
-	static uint8_t CountBitsSet(const uint64_t input)
+	static constexpr uint8_t CountBitsSet(const uint64_t input)
 	{
+#if defined(__GNUC__) || defined(__clang__)
+		return (uint8_t)__builtin_popcountll(input);
+#else
 		uint64_t n = input;
 		uint8_t count = 0;
 		while (n)
 		{
-			count += (uint8_t)(n & 1);
-			n >>= 1;
+			n &= n - 1;
+			++count;
 		}
 
 		return count;
+#endif
+	}
+
+	// Index (0-63) of the most-significant bit set. Input must not be 0.
+	static constexpr uint8_t GetHighestBit(const uint64_t input)
+	{
+		assert(input != 0);
+#if defined(__GNUC__) || defined(__clang__)
+		return (uint8_t)(63 - __builtin_clzll(input));
+#else
+		uint8_t bit = 0;
+		uint64_t n = input;
+		while (n >>= 1)
+		{
+			++bit;
+		}
+
+		return bit;
+#endif
+	}
+
+	// Index (0-63) of the least-significant bit set. Input must not be 0.
+	static constexpr uint8_t GetLowestBit(const uint64_t input)
+	{
+		assert(input != 0);
+#if defined(__GNUC__) || defined(__clang__)
+		return (uint8_t)__builtin_ctzll(input);
+#else
+		return GetHighestBit(input & (~input + 1));
+#endif
 	}
 
 	// Check if bit (0-7) is set on the given byte.
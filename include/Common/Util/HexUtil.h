@@ -4,12 +4,22 @@
 #include <cstdint>
 #include <vector>
 
+//
+// Lowercase hex encoding and decoding, for hashes, commitments and rangeproofs in the APIs and JSON.
+// Both directions are vectorized with AVX2 or SSSE3 on x86-64 CPUs that support them, and fall back to a lookup table otherwise.
+//
 class HexUtil
 {
 public:
 	static bool IsValidHex(const std::string& data) noexcept;
+
+	//
+	// Accepts upper or lowercase digits, with or without a "0x" prefix, and ignores surrounding whitespace.
+	// Throws if any other character is found, or the number of digits is odd.
+	//
 	static std::vector<uint8_t> FromHex(const std::string& hex);
 
 	static std::string ConvertToHex(const std::vector<uint8_t>& data);
 	static std::string ConvertToHex(const std::vector<uint8_t>& data, const size_t numBytes);
-};
\ No newline at end of file
+	static std::string ConvertToHex(const uint8_t* pData, const size_t numBytes);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <Common/Util/TimeUtil.h>
+#include <Common/ThreadManager.h>
 #include <chrono>
 #include <atomic>
 #include <thread>
@@ -14,6 +15,7 @@ public:
 	//
 	static void SleepFor(const std::chrono::milliseconds& millisToSleep, const std::chrono::milliseconds& checkInterval, const std::atomic_bool& terminate)
 	{
+		ThreadWait wait;
 		std::chrono::time_point wakeTime = std::chrono::system_clock::now() + millisToSleep;
 		while (!terminate)
 		{
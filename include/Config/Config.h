@@ -39,6 +39,8 @@ public:
 	Json::Value& GetJSON() noexcept { return m_json; }
 
 	const std::string& GetLogLevel() const noexcept { return m_logLevel; }
+	bool BlockOnLogOverflow() const noexcept { return m_blockOnLogOverflow; }
+	uint32_t GetLogCallSiteRateLimit() const noexcept { return m_logCallSiteRateLimit; }
 	const Environment& GetEnvironment() const noexcept { return m_environment; }
 	const fs::path& GetDataDirectory() const noexcept { return m_dataPath; }
 	const fs::path& GetLogDirectory() const noexcept { return m_logPath; }
@@ -67,10 +69,14 @@ private:
 		fs::create_directories(m_logPath);
 
 		m_logLevel = "DEBUG";
+		m_blockOnLogOverflow = false;
+		m_logCallSiteRateLimit = 100;
 		if (json.isMember(ConfigProps::Logger::LOGGER))
 		{
 			const Json::Value& loggerJSON = json[ConfigProps::Logger::LOGGER];
 			m_logLevel = loggerJSON.get(ConfigProps::Logger::LOG_LEVEL, "DEBUG").asString();
+			m_blockOnLogOverflow = loggerJSON.get(ConfigProps::Logger::OVERFLOW_POLICY, "DROP").asString() == "BLOCK";
+			m_logCallSiteRateLimit = loggerJSON.get(ConfigProps::Logger::CALL_SITE_RATE_LIMIT, 100).asUInt();
 		}
 	}
 
@@ -80,6 +86,8 @@ private:
 	fs::path m_logPath;
 
 	std::string m_logLevel;
+	bool m_blockOnLogOverflow;
+	uint32_t m_logCallSiteRateLimit;
 	Environment m_environment;
 	NodeConfig m_nodeConfig;
 	WalletConfig m_walletConfig;
@@ -8,12 +8,72 @@ namespace ConfigProps
 	static const std::string ENVIRONMENT = "ENVIRONMENT";
 	static const std::string DATA_PATH = "DATA_PATH";
 
+	namespace Node
+	{
+		static const std::string NODE = "NODE";
+
+		static const std::string RANGEPROOF_CACHE_SIZE = "RANGEPROOF_CACHE_SIZE";
+		static const std::string COMMITMENT_CACHE_SIZE = "COMMITMENT_CACHE_SIZE";
+		static const std::string KERNEL_SIG_CACHE_SIZE = "KERNEL_SIG_CACHE_SIZE";
+		static const std::string WORKER_THREADS = "WORKER_THREADS";
+		static const std::string LATENCY_WORKER_THREADS = "LATENCY_WORKER_THREADS";
+		static const std::string CPU_AFFINITY = "CPU_AFFINITY";
+		static const std::string CHAIN_LOCK_PROFILE_SECS = "CHAIN_LOCK_PROFILE_SECS";
+		static const std::string SYNC_STATS_LOG_SECS = "SYNC_STATS_LOG_SECS";
+		static const std::string TRACE_EVENTS_PER_THREAD = "TRACE_EVENTS_PER_THREAD";
+		static const std::string MEMPOOL_MAX_BYTES = "MEMPOOL_MAX_BYTES";
+		static const std::string STEMPOOL_MAX_BYTES = "STEMPOOL_MAX_BYTES";
+		static const std::string MEMPOOL_SAVE_SECS = "MEMPOOL_SAVE_SECS";
+		static const std::string PERSIST_STEMPOOL = "PERSIST_STEMPOOL";
+		static const std::string ORPHAN_POOL_MAX_BYTES = "ORPHAN_POOL_MAX_BYTES";
+		static const std::string UTXO_INDEX = "UTXO_INDEX";
+		static const std::string KERNEL_INDEX = "KERNEL_INDEX";
+		static const std::string PRUNE_HORIZON = "PRUNE_HORIZON";
+		static const std::string COMPACT_TXHASHSET = "COMPACT_TXHASHSET";
+		static const std::string BLOCK_COMMIT_GROUP_SIZE = "BLOCK_COMMIT_GROUP_SIZE";
+		static const std::string ASSUME_VALID = "ASSUME_VALID";
+		static const std::string ASSUME_VALID_REVERIFY = "ASSUME_VALID_REVERIFY";
+		static const std::string SEQUENTIAL_SCAN_HINTS = "SEQUENTIAL_SCAN_HINTS";
+		static const std::string SNAPSHOT_SIGNING_KEY = "SNAPSHOT_SIGNING_KEY";
+		static const std::string SNAPSHOT_OPERATOR_KEY = "SNAPSHOT_OPERATOR_KEY";
+		static const std::string SNAPSHOT_IMPORT = "SNAPSHOT_IMPORT";
+		static const std::string REPLICA_OF = "REPLICA_OF";
+		static const std::string REPLICA_POLL_MS = "REPLICA_POLL_MS";
+		static const std::string NOTIFY_REPLICAS = "NOTIFY_REPLICAS";
+		static const std::string MEMORY_BUDGET_MB = "MEMORY_BUDGET_MB";
+		static const std::string THREAD_STATS_LOG_SECS = "THREAD_STATS_LOG_SECS";
+	}
+
+	namespace Database
+	{
+		static const std::string DATABASE = "DATABASE";
+
+		static const std::string BLOCK_CACHE_MB = "BLOCK_CACHE_MB";
+		static const std::string BLOOM_FILTER_BITS = "BLOOM_FILTER_BITS";
+		static const std::string COLD_COMPRESSION = "COLD_COMPRESSION";
+		static const std::string HOT_WRITE_BUFFER_MB = "HOT_WRITE_BUFFER_MB";
+		static const std::string COLD_WRITE_BUFFER_MB = "COLD_WRITE_BUFFER_MB";
+		static const std::string FLAT_FILE_BLOCKS = "FLAT_FILE_BLOCKS";
+		static const std::string BLOCK_SEGMENT_MB = "BLOCK_SEGMENT_MB";
+		static const std::string SPLIT_BLOCKS = "SPLIT_BLOCKS";
+		static const std::string HEADER_CACHE_SIZE = "HEADER_CACHE_SIZE";
+	}
+
 	namespace P2P
 	{
 		static const std::string P2P = "P2P";
 
 		static const std::string MIN_PEERS = "MIN_PEERS";
 		static const std::string MAX_PEERS = "MAX_PEERS";
+		static const std::string BLOCK_SYNC_WINDOW = "BLOCK_SYNC_WINDOW";
+		static const std::string MAX_BLOCKS_IN_FLIGHT_PER_PEER = "MAX_BLOCKS_IN_FLIGHT_PER_PEER";
+		static const std::string PARALLEL_HEADER_SYNC = "PARALLEL_HEADER_SYNC";
+		static const std::string RATE_LIMIT_BURST_SECS = "RATE_LIMIT_BURST_SECS";
+		static const std::string RATE_LIMITS = "RATE_LIMITS";
+		static const std::string MSGS_PER_SEC = "MSGS_PER_SEC";
+		static const std::string BYTES_PER_SEC = "BYTES_PER_SEC";
+		static const std::string BIND_IP = "BIND_IP";
+		static const std::string SEEDS = "SEEDS";
 	}
 
 	namespace Dandelion
@@ -32,6 +92,18 @@ namespace ConfigProps
 
 		static const std::string REST_API_PORT = "REST_API_PORT";
 		static const std::string OWNER_API_PORT = "OWNER_API_PORT";
+
+		// Per-listener sections within SERVER
+		static const std::string NODE_API = "NODE_API";
+		static const std::string FOREIGN_API = "FOREIGN_API";
+		static const std::string OWNER_API = "OWNER_API";
+
+		static const std::string THREADS = "THREADS";
+		static const std::string LISTEN_BACKLOG = "LISTEN_BACKLOG";
+		static const std::string KEEP_ALIVE = "KEEP_ALIVE";
+		static const std::string KEEP_ALIVE_MS = "KEEP_ALIVE_MS";
+		static const std::string MAX_LONG_RUNNING = "MAX_LONG_RUNNING";
+		static const std::string GZIP_MIN_BYTES = "GZIP_MIN_BYTES";
 	}
 
 	namespace Logger
@@ -39,6 +111,12 @@ namespace ConfigProps
 		static const std::string LOGGER = "LOGGER";
 
 		static const std::string LOG_LEVEL = "LOG_LEVEL";
+
+		// "DROP" (default) discards messages while the log queue is full, so logging never blocks. "BLOCK" waits for room instead.
+		static const std::string OVERFLOW_POLICY = "OVERFLOW_POLICY";
+
+		// The most trace or debug messages a single call site logs per second. 0 disables the limit.
+		static const std::string CALL_SITE_RATE_LIMIT = "CALL_SITE_RATE_LIMIT";
 	}
 
 	namespace Wallet
@@ -47,6 +125,9 @@ namespace ConfigProps
 
 		static const std::string DATABASE = "DATABASE";
 		static const std::string MIN_CONFIRMATIONS = "MIN_CONFIRMATIONS";
+		static const std::string SQLITE_SYNCHRONOUS = "SQLITE_SYNCHRONOUS";
+		static const std::string KDF_THREADS = "KDF_THREADS";
+		static const std::string SHARED_FOREIGN_LISTENER = "SHARED_FOREIGN_LISTENER";
 	}
 
 	namespace Tor
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <Common/Util/StringUtil.h>
+#include <Config/ConfigProps.h>
+#include <cstdint>
+#include <string>
+#include <json/json.h>
+
+enum class EDBCompression
+{
+	NONE,
+	LZ4,
+	ZSTD
+};
+
+//
+// Tuning for the chain database. Tables are split into two profiles:
+//   * hot tables (HEADER, BLOCK_SUMS, OUTPUT_POS) are small and read constantly, so they're uncompressed.
+//   * cold tables (BLOCK, BLOCK_INPUTS/OUTPUTS/PROOFS/KERNELS, SPENT_OUTPUTS) are large and rarely read, so they're compressed with smaller write buffers.
+// All tables share a single LRU block cache.
+//
+class DatabaseConfig
+{
+public:
+	// Size of the block cache shared by all tables.
+	size_t GetBlockCacheBytes() const { return m_blockCacheMB * 1024 * 1024; }
+
+	// Bloom filter bits per key, so point lookups of missing keys skip reading blocks. 0 disables bloom filters.
+	uint32_t GetBloomFilterBits() const { return m_bloomFilterBits; }
+
+	// Compression used for the cold tables.
+	EDBCompression GetColdCompression() const { return m_coldCompression; }
+
+	size_t GetHotWriteBufferBytes() const { return m_hotWriteBufferMB * 1024 * 1024; }
+	size_t GetColdWriteBufferBytes() const { return m_coldWriteBufferMB * 1024 * 1024; }
+
+	// Store full blocks in append-only segment files instead of the BLOCK table. Existing blocks are migrated on startup.
+	bool UseFlatFileBlocks() const { return m_flatFileBlocks; }
+	size_t GetBlockSegmentBytes() const { return m_blockSegmentMB * 1024 * 1024; }
+
+	// Store each block's inputs, outputs, rangeproofs, and kernels in separate tables, so readers that only need some of them
+	// (eg. rewinds, which never need rangeproofs) don't read the rest. Ignored when FLAT_FILE_BLOCKS is enabled.
+	// Blocks are migrated to or from the BLOCK table on startup when this changes.
+	bool UseSplitBlocks() const { return m_splitBlocks; }
+
+	// Number of deserialized headers kept in memory, in front of the HEADER table.
+	size_t GetHeaderCacheSize() const { return m_headerCacheSize; }
+
+	//
+	// Constructor
+	//
+	DatabaseConfig(const Json::Value& json)
+	{
+		m_blockCacheMB = 256;
+		m_bloomFilterBits = 10;
+		m_coldCompression = EDBCompression::LZ4;
+		m_hotWriteBufferMB = 64;
+		m_coldWriteBufferMB = 16;
+		m_flatFileBlocks = false;
+		m_blockSegmentMB = 128;
+		m_splitBlocks = false;
+		m_headerCacheSize = 4096;
+
+		if (json.isMember(ConfigProps::Database::DATABASE))
+		{
+			const Json::Value& databaseJSON = json[ConfigProps::Database::DATABASE];
+
+			if (databaseJSON.isMember(ConfigProps::Database::BLOCK_CACHE_MB))
+			{
+				m_blockCacheMB = (size_t)databaseJSON.get(ConfigProps::Database::BLOCK_CACHE_MB, 256).asUInt64();
+			}
+
+			if (databaseJSON.isMember(ConfigProps::Database::BLOOM_FILTER_BITS))
+			{
+				m_bloomFilterBits = databaseJSON.get(ConfigProps::Database::BLOOM_FILTER_BITS, 10).asUInt();
+			}
+
+			if (databaseJSON.isMember(ConfigProps::Database::COLD_COMPRESSION))
+			{
+				const std::string compression = StringUtil::ToLower(databaseJSON.get(ConfigProps::Database::COLD_COMPRESSION, "lz4").asString());
+				if (compression == "none")
+				{
+					m_coldCompression = EDBCompression::NONE;
+				}
+				else if (compression == "zstd")
+				{
+					m_coldCompression = EDBCompression::ZSTD;
+				}
+			}
+
+			if (databaseJSON.isMember(ConfigProps::Database::HOT_WRITE_BUFFER_MB))
+			{
+				m_hotWriteBufferMB = (size_t)databaseJSON.get(ConfigProps::Database::HOT_WRITE_BUFFER_MB, 64).asUInt64();
+			}
+
+			if (databaseJSON.isMember(ConfigProps::Database::COLD_WRITE_BUFFER_MB))
+			{
+				m_coldWriteBufferMB = (size_t)databaseJSON.get(ConfigProps::Database::COLD_WRITE_BUFFER_MB, 16).asUInt64();
+			}
+
+			if (databaseJSON.isMember(ConfigProps::Database::FLAT_FILE_BLOCKS))
+			{
+				m_flatFileBlocks = databaseJSON.get(ConfigProps::Database::FLAT_FILE_BLOCKS, false).asBool();
+			}
+
+			if (databaseJSON.isMember(ConfigProps::Database::BLOCK_SEGMENT_MB))
+			{
+				m_blockSegmentMB = (size_t)databaseJSON.get(ConfigProps::Database::BLOCK_SEGMENT_MB, 128).asUInt64();
+			}
+
+			if (databaseJSON.isMember(ConfigProps::Database::SPLIT_BLOCKS))
+			{
+				m_splitBlocks = databaseJSON.get(ConfigProps::Database::SPLIT_BLOCKS, false).asBool();
+			}
+
+			if (databaseJSON.isMember(ConfigProps::Database::HEADER_CACHE_SIZE))
+			{
+				m_headerCacheSize = (size_t)databaseJSON.get(ConfigProps::Database::HEADER_CACHE_SIZE, 4096).asUInt64();
+			}
+		}
+	}
+
+private:
+	size_t m_blockCacheMB;
+	uint32_t m_bloomFilterBits;
+	EDBCompression m_coldCompression;
+	size_t m_hotWriteBufferMB;
+	size_t m_coldWriteBufferMB;
+	bool m_flatFileBlocks;
+	size_t m_blockSegmentMB;
+	bool m_splitBlocks;
+	size_t m_headerCacheSize;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Config/ConfigProps.h>
+#include <json/json.h>
+#include <algorithm>
+#include <cstdint>
+
+//
+// The civetweb settings for one of the HTTP listeners (node REST, foreign RPC, or owner RPC).
+//
+class HttpServerConfig
+{
+public:
+	//
+	// Getters
+	//
+
+	// The number of worker threads, each of which handles one connection at a time.
+	uint32_t GetNumThreads() const noexcept { return m_numThreads; }
+
+	// The maximum number of connections waiting to be accepted.
+	uint32_t GetListenBacklog() const noexcept { return m_listenBacklog; }
+
+	bool IsKeepAliveEnabled() const noexcept { return m_keepAlive; }
+	uint32_t GetKeepAliveMs() const noexcept { return m_keepAliveMs; }
+
+	//
+	// The number of worker threads that may be busy with long-running requests (eg. restores) at once.
+	// Further long-running requests are turned away, so quick ones never wait behind them.
+	//
+	uint32_t GetMaxLongRunning() const noexcept { return m_maxLongRunning; }
+
+	//
+	// Successful responses of at least this many bytes are gzipped for clients that send "Accept-Encoding: gzip".
+	// Streamed responses are always compressed for those clients, since they're only used for large bodies. 0 disables compression.
+	//
+	uint32_t GetGzipMinBytes() const noexcept { return m_gzipMinBytes; }
+
+	//
+	// Constructor
+	//
+	HttpServerConfig(const uint32_t numThreads = 15)
+		: m_numThreads(numThreads),
+		m_listenBacklog(128),
+		m_keepAlive(true),
+		m_keepAliveMs(15000),
+		m_maxLongRunning(DefaultMaxLongRunning(numThreads)),
+		m_gzipMinBytes(1024) { }
+
+	HttpServerConfig(const Json::Value& serverJSON, const std::string& listener, const uint32_t defaultThreads)
+		: HttpServerConfig(defaultThreads)
+	{
+		if (serverJSON.isMember(listener))
+		{
+			const Json::Value& listenerJSON = serverJSON[listener];
+
+			m_numThreads = (std::max)(1u, listenerJSON.get(ConfigProps::Server::THREADS, m_numThreads).asUInt());
+			m_listenBacklog = (std::max)(1u, listenerJSON.get(ConfigProps::Server::LISTEN_BACKLOG, m_listenBacklog).asUInt());
+			m_keepAlive = listenerJSON.get(ConfigProps::Server::KEEP_ALIVE, m_keepAlive).asBool();
+			m_keepAliveMs = listenerJSON.get(ConfigProps::Server::KEEP_ALIVE_MS, m_keepAliveMs).asUInt();
+
+			const uint32_t maxLongRunning = listenerJSON.get(ConfigProps::Server::MAX_LONG_RUNNING, DefaultMaxLongRunning(m_numThreads)).asUInt();
+			m_maxLongRunning = (std::min)((std::max)(1u, maxLongRunning), m_numThreads);
+
+			m_gzipMinBytes = listenerJSON.get(ConfigProps::Server::GZIP_MIN_BYTES, m_gzipMinBytes).asUInt();
+		}
+	}
+
+private:
+	// Leaves at least two thirds of the threads for quick requests.
+	static uint32_t DefaultMaxLongRunning(const uint32_t numThreads) noexcept
+	{
+		return (std::max)(1u, numThreads / 3);
+	}
+
+	uint32_t m_numThreads;
+	uint32_t m_listenBacklog;
+	bool m_keepAlive;
+	uint32_t m_keepAliveMs;
+	uint32_t m_maxLongRunning;
+	uint32_t m_gzipMinBytes;
+};
@@ -1,11 +1,18 @@
 #pragma once
 
 #include <Common/Util/FileUtil.h>
+#include <Common/Util/StringUtil.h>
 #include <Config/DandelionConfig.h>
+#include <Config/DatabaseConfig.h>
 #include <Config/ClientMode.h>
 #include <Config/P2PConfig.h>
+#include <Crypto/Hash.h>
+#include <Crypto/SecretKey.h>
+#include <Crypto/Models/ed25519_public_key.h>
 
 #include <cstdint>
+#include <map>
+#include <optional>
 #include <json/json.h>
 
 class NodeConfig
@@ -16,38 +23,422 @@ public:
 	//
 	const P2PConfig& GetP2P() const { return m_p2pConfig; }
 	const DandelionConfig& GetDandelion() const { return m_dandelion; }
+	const DatabaseConfig& GetDatabase() const { return m_database; }
 	EClientMode GetClientMode() const { return EClientMode::FAST_SYNC; }
 	const fs::path& GetChainPath() const { return m_chainPath; }
 	const fs::path& GetDatabasePath() const { return m_databasePath; }
 	const fs::path& GetTxHashSetPath() const { return m_txHashSetPath; }
 
+	// Where TxHashSet snapshots are exported for our other nodes (see IBlockChain::ExportTxHashSetSnapshot).
+	const fs::path& GetSnapshotPath() const { return m_snapshotPath; }
+
+	// Number of verified rangeproof commitments to remember, so mempool and block validation can skip them.
+	size_t GetRangeProofCacheSize() const { return m_rangeProofCacheSize; }
+
+	// Number of parsed commitments to remember, so the same UTXO isn't parsed again for every sum and rangeproof batch. 0 disables the cache.
+	size_t GetCommitmentCacheSize() const { return m_commitmentCacheSize; }
+
+	// Number of verified kernel signatures to remember, so block validation can skip kernels already accepted to the mempool.
+	size_t GetKernelSignatureCacheSize() const { return m_kernelSigCacheSize; }
+
+	// Number of threads in the shared worker pool. 0 means one per core.
+	size_t GetNumWorkerThreads() const { return m_numWorkerThreads; }
+
+	// Number of threads in the pool for latency-sensitive work, like peer messages (see ThreadManagerAPI::GetLatencyThreadPool). 0 picks a default.
+	size_t GetNumLatencyWorkerThreads() const { return m_numLatencyWorkerThreads; }
+
+	//
+	// CPUs to pin threads to, keyed by thread name prefix, eg. { "WORKER": "2-7", "LATENCY": "0-1", "P2P_IO": "0-1", "HTTP": "0-1" }.
+	// Empty (the default) leaves every thread unpinned.
+	//
+	const std::map<std::string, std::vector<size_t>>& GetCpuAffinity() const { return m_cpuAffinity; }
+
+	// Interval between logged summaries of the chain state lock profile. 0 (the default) disables profiling.
+	uint32_t GetChainLockProfileSecs() const { return m_chainLockProfileSecs; }
+
+	// Interval between logged sync throughput summaries while syncing. 0 disables them.
+	uint32_t GetSyncStatsLogSecs() const { return m_syncStatsLogSecs; }
+
+	// Number of trace spans kept for each thread while tracing is enabled through /v1/trace.
+	size_t GetTraceEventsPerThread() const { return m_traceEventsPerThread; }
+
+	// Estimated memory the mempool and stempool may use before their lowest fee rate txs are evicted. 0 means unbounded.
+	size_t GetMemPoolMaxBytes() const { return m_memPoolMaxBytes; }
+	size_t GetStemPoolMaxBytes() const { return m_stemPoolMaxBytes; }
+
+	// Where the mempool is saved on shutdown (and every GetMemPoolSaveSecs()), to be revalidated and reloaded on the next start.
+	const fs::path& GetMemPoolPath() const { return m_memPoolPath; }
+
+	// Interval between saves of the mempool. 0 disables saving and reloading it.
+	uint32_t GetMemPoolSaveSecs() const { return m_memPoolSaveSecs; }
+
+	// Save and reload the stempool along with the mempool. Reloaded stem txs start a new stem phase.
+	bool IsStemPoolPersisted() const { return m_persistStemPool; }
+
+	// Estimated memory the orphan block pool may use before the least recently added orphans are dropped. 0 means unbounded.
+	size_t GetOrphanPoolMaxBytes() const { return m_orphanPoolMaxBytes; }
+
+	// Keep every output position in memory, rather than looking each one up in the database.
+	bool IsUTXOIndexEnabled() const { return m_utxoIndex; }
+
+	// Keep an index from each kernel's excess commitment to its block, so get_kernel doesn't need to scan the kernel MMR.
+	bool IsKernelIndexEnabled() const { return m_kernelIndex; }
+
+	// Number of recent full blocks to keep. Older blocks are deleted, keeping only their headers. 0 (the default) keeps every block.
+	uint64_t GetPruneHorizon() const { return m_pruneHorizon; }
+
+	// Remove outputs and rangeproofs spent before the horizon from the TxHashSet files, once a day. Off by default.
+	bool IsTxHashSetCompactionEnabled() const { return m_compactTxHashSet; }
+
+	// Maximum number of consecutive blocks applied in a single commit while far behind the header chain. 1 commits every block.
+	size_t GetBlockCommitGroupSize() const { return m_blockCommitGroupSize; }
+
+	// Hash of a trusted header. Rangeproofs and kernel signatures of its ancestors aren't verified, though roots, sums, and linkage still are.
+	const std::optional<Hash>& GetAssumeValid() const { return m_assumeValid; }
+
+	// Re-verify the blocks skipped because of GetAssumeValid() in the background, once synced.
+	bool IsAssumeValidReverifyEnabled() const { return m_assumeValidReverify; }
+
+	// Tell the OS the TxHashSet files are read front to back (and may use huge pages) while the TxHashSet is validated.
+	bool IsSequentialScanHintEnabled() const { return m_sequentialScanHints; }
+
+	// Ed25519 seed that exported TxHashSet snapshots are signed with. Unsigned if not configured.
+	const std::optional<SecretKey>& GetSnapshotSigningKey() const { return m_snapshotSigningKey; }
+
+	// Ed25519 key of the operator whose signed snapshots are trusted. Rangeproofs and kernel signatures of those aren't verified, though roots and sums still are.
+	const std::optional<ed25519_public_key_t>& GetSnapshotOperatorKey() const { return m_snapshotOperatorKey; }
+
+	// Directory of an exported snapshot to bootstrap from, instead of downloading a TxHashSet from peers.
+	const std::optional<fs::path>& GetSnapshotImportPath() const { return m_snapshotImportPath; }
+
+	// Data directory of a primary node on this host. When set, this node is a read-only replica that serves the API from
+	// the primary's chain, database, and TxHashSet, and follows the primary's commits instead of syncing from peers.
+	bool IsReplica() const { return m_replicaOf.has_value(); }
+	const std::optional<fs::path>& GetReplicaOf() const { return m_replicaOf; }
+
+	// The primary's chain database, which replicas open as a secondary instance. The same as GetDatabasePath() / "CHAIN" for primaries.
+	const fs::path& GetChainDatabasePath() const { return m_chainDatabasePath; }
+
+	// Where a replica keeps its secondary instance's own files. Replicas still keep their peers in their own GetDatabasePath().
+	const fs::path& GetReplicaPath() const { return m_replicaPath; }
+
+	// Rewritten by the primary after each chain commit (if NOTIFY_REPLICAS is enabled), and polled by its replicas.
+	const fs::path& GetCommitNotificationPath() const { return m_commitNotificationPath; }
+	bool IsReplicaNotificationEnabled() const { return m_notifyReplicas; }
+
+	// Interval between a replica's checks of the commit notification file.
+	uint32_t GetReplicaPollMs() const { return m_replicaPollMs; }
+
+	// Total memory shared by the caches and pools (see MemoryBudgetAPI), which then ignore their configured sizes. 0 leaves them unmanaged.
+	size_t GetMemoryBudgetBytes() const { return m_memoryBudgetBytes; }
+
+	// Interval between logs of each thread name's CPU and wait time (see ThreadManagerAPI::GetThreadGroupStats). 0 disables them.
+	uint32_t GetThreadStatsLogSecs() const { return m_threadStatsLogSecs; }
+
 	//
 	// Constructor
 	//
 	NodeConfig(const Json::Value& json, const fs::path& dataPath)
-		: m_p2pConfig(json), m_dandelion(json)
+		: m_p2pConfig(json), m_dandelion(json), m_database(json)
 	{
 		const fs::path nodePath = dataPath / "NODE";
 
-		m_chainPath = nodePath / "CHAIN";
-		fs::create_directories(m_chainPath);
+		// Replicas read the primary's chain and TxHashSet where they are, so only the primary creates them.
+		if (json.isMember(ConfigProps::Node::NODE) && json[ConfigProps::Node::NODE].isMember(ConfigProps::Node::REPLICA_OF))
+		{
+			const std::string replicaOf = json[ConfigProps::Node::NODE].get(ConfigProps::Node::REPLICA_OF, "").asString();
+			if (!replicaOf.empty())
+			{
+				m_replicaOf = std::make_optional(fs::path(StringUtil::ToWide(replicaOf)));
+			}
+		}
+
+		const fs::path primaryNodePath = m_replicaOf.has_value() ? m_replicaOf.value() / "NODE" : nodePath;
 
+		m_chainPath = primaryNodePath / "CHAIN";
 		m_databasePath = nodePath / "DB";
 		fs::create_directories(m_databasePath);
 
-		m_txHashSetPath = nodePath / "TXHASHSET";
-		fs::create_directories(m_txHashSetPath);
+		m_chainDatabasePath = primaryNodePath / "DB" / "CHAIN";
+		m_replicaPath = nodePath / "REPLICA";
+		m_commitNotificationPath = primaryNodePath / "commit.seq";
+
+		m_txHashSetPath = primaryNodePath / "TXHASHSET";
+		if (!m_replicaOf.has_value())
+		{
+			fs::create_directories(m_chainPath);
+			fs::create_directories(m_txHashSetPath);
+			fs::create_directories(m_txHashSetPath / "kernel");
+			fs::create_directories(m_txHashSetPath / "output");
+			fs::create_directories(m_txHashSetPath / "rangeproof");
+		}
+
+		m_snapshotPath = nodePath / "SNAPSHOTS";
+		m_memPoolPath = nodePath / "mempool.bin";
 
-		fs::create_directories(m_txHashSetPath / "kernel");
-		fs::create_directories(m_txHashSetPath / "output");
-		fs::create_directories(m_txHashSetPath / "rangeproof");
+		m_rangeProofCacheSize = 100'000;
+		m_commitmentCacheSize = 10'000;
+		m_kernelSigCacheSize = 100'000;
+		m_numWorkerThreads = 0;
+		m_numLatencyWorkerThreads = 0;
+		m_chainLockProfileSecs = 0;
+		m_syncStatsLogSecs = 30;
+		m_traceEventsPerThread = 16384;
+		m_memPoolMaxBytes = 100'000'000;
+		m_stemPoolMaxBytes = 20'000'000;
+		m_memPoolSaveSecs = 300;
+		m_persistStemPool = false;
+		m_orphanPoolMaxBytes = 200'000'000;
+		m_utxoIndex = true;
+		m_kernelIndex = false;
+		m_pruneHorizon = 0;
+		m_compactTxHashSet = false;
+		m_blockCommitGroupSize = 32;
+		m_assumeValidReverify = false;
+		m_sequentialScanHints = false;
+		m_notifyReplicas = false;
+		m_replicaPollMs = 250;
+		m_memoryBudgetBytes = 0;
+		m_threadStatsLogSecs = 300;
+
+		if (json.isMember(ConfigProps::Node::NODE))
+		{
+			const Json::Value& nodeJSON = json[ConfigProps::Node::NODE];
+
+			if (nodeJSON.isMember(ConfigProps::Node::RANGEPROOF_CACHE_SIZE))
+			{
+				m_rangeProofCacheSize = (size_t)nodeJSON.get(ConfigProps::Node::RANGEPROOF_CACHE_SIZE, 100'000).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::COMMITMENT_CACHE_SIZE))
+			{
+				m_commitmentCacheSize = (size_t)nodeJSON.get(ConfigProps::Node::COMMITMENT_CACHE_SIZE, 10'000).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::KERNEL_SIG_CACHE_SIZE))
+			{
+				m_kernelSigCacheSize = (size_t)nodeJSON.get(ConfigProps::Node::KERNEL_SIG_CACHE_SIZE, 100'000).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::WORKER_THREADS))
+			{
+				m_numWorkerThreads = (size_t)nodeJSON.get(ConfigProps::Node::WORKER_THREADS, 0).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::LATENCY_WORKER_THREADS))
+			{
+				m_numLatencyWorkerThreads = (size_t)nodeJSON.get(ConfigProps::Node::LATENCY_WORKER_THREADS, 0).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::CPU_AFFINITY))
+			{
+				const Json::Value& affinityJSON = nodeJSON[ConfigProps::Node::CPU_AFFINITY];
+				for (const std::string& threadName : affinityJSON.getMemberNames())
+				{
+					m_cpuAffinity[threadName] = ParseCpuList(affinityJSON[threadName].asString());
+				}
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::CHAIN_LOCK_PROFILE_SECS))
+			{
+				m_chainLockProfileSecs = nodeJSON.get(ConfigProps::Node::CHAIN_LOCK_PROFILE_SECS, 0).asUInt();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::SYNC_STATS_LOG_SECS))
+			{
+				m_syncStatsLogSecs = nodeJSON.get(ConfigProps::Node::SYNC_STATS_LOG_SECS, 30).asUInt();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::TRACE_EVENTS_PER_THREAD))
+			{
+				m_traceEventsPerThread = (size_t)nodeJSON.get(ConfigProps::Node::TRACE_EVENTS_PER_THREAD, 16384).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::MEMPOOL_MAX_BYTES))
+			{
+				m_memPoolMaxBytes = (size_t)nodeJSON.get(ConfigProps::Node::MEMPOOL_MAX_BYTES, 100'000'000).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::STEMPOOL_MAX_BYTES))
+			{
+				m_stemPoolMaxBytes = (size_t)nodeJSON.get(ConfigProps::Node::STEMPOOL_MAX_BYTES, 20'000'000).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::MEMPOOL_SAVE_SECS))
+			{
+				m_memPoolSaveSecs = nodeJSON.get(ConfigProps::Node::MEMPOOL_SAVE_SECS, 300).asUInt();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::PERSIST_STEMPOOL))
+			{
+				m_persistStemPool = nodeJSON.get(ConfigProps::Node::PERSIST_STEMPOOL, false).asBool();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::ORPHAN_POOL_MAX_BYTES))
+			{
+				m_orphanPoolMaxBytes = (size_t)nodeJSON.get(ConfigProps::Node::ORPHAN_POOL_MAX_BYTES, 200'000'000).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::UTXO_INDEX))
+			{
+				m_utxoIndex = nodeJSON.get(ConfigProps::Node::UTXO_INDEX, true).asBool();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::KERNEL_INDEX))
+			{
+				m_kernelIndex = nodeJSON.get(ConfigProps::Node::KERNEL_INDEX, false).asBool();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::PRUNE_HORIZON))
+			{
+				m_pruneHorizon = nodeJSON.get(ConfigProps::Node::PRUNE_HORIZON, 0).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::COMPACT_TXHASHSET))
+			{
+				m_compactTxHashSet = nodeJSON.get(ConfigProps::Node::COMPACT_TXHASHSET, false).asBool();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::BLOCK_COMMIT_GROUP_SIZE))
+			{
+				m_blockCommitGroupSize = (size_t)nodeJSON.get(ConfigProps::Node::BLOCK_COMMIT_GROUP_SIZE, 32).asUInt64();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::ASSUME_VALID))
+			{
+				const std::string assumeValid = nodeJSON.get(ConfigProps::Node::ASSUME_VALID, "").asString();
+				if (!assumeValid.empty())
+				{
+					m_assumeValid = std::make_optional(Hash::FromHex(assumeValid));
+				}
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::ASSUME_VALID_REVERIFY))
+			{
+				m_assumeValidReverify = nodeJSON.get(ConfigProps::Node::ASSUME_VALID_REVERIFY, false).asBool();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::SEQUENTIAL_SCAN_HINTS))
+			{
+				m_sequentialScanHints = nodeJSON.get(ConfigProps::Node::SEQUENTIAL_SCAN_HINTS, false).asBool();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::SNAPSHOT_SIGNING_KEY))
+			{
+				const std::string signingKey = nodeJSON.get(ConfigProps::Node::SNAPSHOT_SIGNING_KEY, "").asString();
+				if (!signingKey.empty())
+				{
+					m_snapshotSigningKey = std::make_optional(SecretKey(CBigInteger<32>::FromHex(signingKey)));
+				}
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::SNAPSHOT_OPERATOR_KEY))
+			{
+				const std::string operatorKey = nodeJSON.get(ConfigProps::Node::SNAPSHOT_OPERATOR_KEY, "").asString();
+				if (!operatorKey.empty())
+				{
+					m_snapshotOperatorKey = std::make_optional(ed25519_public_key_t(CBigInteger<32>::FromHex(operatorKey)));
+				}
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::SNAPSHOT_IMPORT))
+			{
+				const std::string importPath = nodeJSON.get(ConfigProps::Node::SNAPSHOT_IMPORT, "").asString();
+				if (!importPath.empty())
+				{
+					m_snapshotImportPath = std::make_optional(fs::path(StringUtil::ToWide(importPath)));
+				}
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::NOTIFY_REPLICAS))
+			{
+				m_notifyReplicas = nodeJSON.get(ConfigProps::Node::NOTIFY_REPLICAS, false).asBool();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::REPLICA_POLL_MS))
+			{
+				m_replicaPollMs = nodeJSON.get(ConfigProps::Node::REPLICA_POLL_MS, 250).asUInt();
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::MEMORY_BUDGET_MB))
+			{
+				m_memoryBudgetBytes = (size_t)nodeJSON.get(ConfigProps::Node::MEMORY_BUDGET_MB, 0).asUInt64() * 1024 * 1024;
+			}
+
+			if (nodeJSON.isMember(ConfigProps::Node::THREAD_STATS_LOG_SECS))
+			{
+				m_threadStatsLogSecs = nodeJSON.get(ConfigProps::Node::THREAD_STATS_LOG_SECS, 300).asUInt();
+			}
+		}
 	}
 
 private:
+	//
+	// Parses a list of CPUs and ranges of them, like Linux's cpuset format, eg. "0-3,6".
+	//
+	static std::vector<size_t> ParseCpuList(const std::string& cpuList)
+	{
+		std::vector<size_t> cpus;
+		for (const std::string& part : StringUtil::Split(cpuList, ","))
+		{
+			const std::string range = StringUtil::Trim(part);
+			if (range.empty())
+			{
+				continue;
+			}
+
+			const size_t dash = range.find('-');
+			const size_t first = (size_t)std::stoul(range.substr(0, dash));
+			const size_t last = dash == std::string::npos ? first : (size_t)std::stoul(range.substr(dash + 1));
+			for (size_t cpu = first; cpu <= last; cpu++)
+			{
+				cpus.push_back(cpu);
+			}
+		}
+
+		return cpus;
+	}
+
 	fs::path m_chainPath;
 	fs::path m_databasePath;
 	fs::path m_txHashSetPath;
+	fs::path m_snapshotPath;
+	fs::path m_memPoolPath;
+	size_t m_rangeProofCacheSize;
+	size_t m_commitmentCacheSize;
+	size_t m_kernelSigCacheSize;
+	size_t m_numWorkerThreads;
+	size_t m_numLatencyWorkerThreads;
+	std::map<std::string, std::vector<size_t>> m_cpuAffinity;
+	uint32_t m_chainLockProfileSecs;
+	uint32_t m_syncStatsLogSecs;
+	size_t m_traceEventsPerThread;
+	size_t m_memPoolMaxBytes;
+	size_t m_stemPoolMaxBytes;
+	uint32_t m_memPoolSaveSecs;
+	bool m_persistStemPool;
+	size_t m_orphanPoolMaxBytes;
+	bool m_utxoIndex;
+	bool m_kernelIndex;
+	uint64_t m_pruneHorizon;
+	bool m_compactTxHashSet;
+	size_t m_blockCommitGroupSize;
+	std::optional<Hash> m_assumeValid;
+	bool m_assumeValidReverify;
+	bool m_sequentialScanHints;
+	std::optional<SecretKey> m_snapshotSigningKey;
+	std::optional<ed25519_public_key_t> m_snapshotOperatorKey;
+	std::optional<fs::path> m_snapshotImportPath;
+	std::optional<fs::path> m_replicaOf;
+	fs::path m_chainDatabasePath;
+	fs::path m_replicaPath;
+	fs::path m_commitNotificationPath;
+	bool m_notifyReplicas;
+	uint32_t m_replicaPollMs;
+	size_t m_memoryBudgetBytes;
+	uint32_t m_threadStatsLogSecs;
 
 	P2PConfig m_p2pConfig;
 	DandelionConfig m_dandelion;
+	DatabaseConfig m_database;
 };
\ No newline at end of file
@@ -3,6 +3,18 @@
 #include <cstdint>
 #include <json/json.h>
 #include <Config/ConfigProps.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//
+// The rate a peer may send one type of message at. 0 means unlimited.
+//
+struct MessageRateLimit
+{
+	double messagesPerSec;
+	double bytesPerSec;
+};
 
 class P2PConfig
 {
@@ -13,6 +25,28 @@ public:
 	int GetMaxConnections() const { return m_maxConnections; }
 	int GetMinConnections() const { return m_minConnections; }
 
+	// Maximum number of blocks, beyond the confirmed tip, that may be requested at once during block sync.
+	uint64_t GetBlockSyncWindow() const { return m_blockSyncWindow; }
+
+	// Upper bound on the number of blocks outstanding with a single peer. The actual limit adapts to the peer's throughput.
+	uint64_t GetMaxBlocksInFlightPerPeer() const { return m_maxBlocksInFlightPerPeer; }
+
+	// When enabled, header ranges are requested from a rotation of peers while earlier ranges are still being validated.
+	bool IsParallelHeaderSyncEnabled() const { return m_parallelHeaderSync; }
+
+	// Number of seconds worth of messages a peer may send at once before being held to the per-type rate limits.
+	double GetRateLimitBurstSecs() const { return m_rateLimitBurstSecs; }
+
+	// Overrides of the default rate limits, keyed by message type name (eg. "TransactionMsg").
+	const std::unordered_map<std::string, MessageRateLimit>& GetRateLimits() const { return m_rateLimits; }
+
+	// IPv4 address to listen on and dial from, eg. to run several nodes on one host, each on its own loopback address.
+	// Peers are identified by IP, so dialing from the listening address lets peers tell the nodes apart. Empty for any.
+	const std::string& GetBindIP() const { return m_bindIP; }
+
+	// IPs of the peers to seed from instead of the DNS seeds. Empty to use the DNS seeds.
+	const std::vector<std::string>& GetSeeds() const { return m_seeds; }
+
 	//
 	// Constructor
 	//
@@ -20,6 +54,10 @@ public:
 	{
 		m_maxConnections = 50;
 		m_minConnections = 15;
+		m_blockSyncWindow = 512;
+		m_maxBlocksInFlightPerPeer = 128;
+		m_parallelHeaderSync = true;
+		m_rateLimitBurstSecs = 10.0;
 
 		if (json.isMember(ConfigProps::P2P::P2P))
 		{
@@ -34,10 +72,63 @@ public:
 			{
 				m_minConnections = p2pJSON.get(ConfigProps::P2P::MIN_PEERS, 15).asInt();
 			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::BLOCK_SYNC_WINDOW))
+			{
+				m_blockSyncWindow = p2pJSON.get(ConfigProps::P2P::BLOCK_SYNC_WINDOW, 512).asUInt64();
+			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::MAX_BLOCKS_IN_FLIGHT_PER_PEER))
+			{
+				m_maxBlocksInFlightPerPeer = p2pJSON.get(ConfigProps::P2P::MAX_BLOCKS_IN_FLIGHT_PER_PEER, 128).asUInt64();
+			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::PARALLEL_HEADER_SYNC))
+			{
+				m_parallelHeaderSync = p2pJSON.get(ConfigProps::P2P::PARALLEL_HEADER_SYNC, true).asBool();
+			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::RATE_LIMIT_BURST_SECS))
+			{
+				m_rateLimitBurstSecs = p2pJSON.get(ConfigProps::P2P::RATE_LIMIT_BURST_SECS, 10.0).asDouble();
+			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::RATE_LIMITS))
+			{
+				const Json::Value& limitsJSON = p2pJSON[ConfigProps::P2P::RATE_LIMITS];
+				for (const std::string& messageType : limitsJSON.getMemberNames())
+				{
+					const Json::Value& limitJSON = limitsJSON[messageType];
+					m_rateLimits[messageType] = MessageRateLimit{
+						limitJSON.get(ConfigProps::P2P::MSGS_PER_SEC, 0.0).asDouble(),
+						limitJSON.get(ConfigProps::P2P::BYTES_PER_SEC, 0.0).asDouble()
+					};
+				}
+			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::BIND_IP))
+			{
+				m_bindIP = p2pJSON.get(ConfigProps::P2P::BIND_IP, "").asString();
+			}
+
+			if (p2pJSON.isMember(ConfigProps::P2P::SEEDS))
+			{
+				for (const Json::Value& seedJSON : p2pJSON[ConfigProps::P2P::SEEDS])
+				{
+					m_seeds.push_back(seedJSON.asString());
+				}
+			}
 		}
 	}
 
 private:
 	int m_maxConnections;
 	int m_minConnections;
+	uint64_t m_blockSyncWindow;
+	uint64_t m_maxBlocksInFlightPerPeer;
+	bool m_parallelHeaderSync;
+	double m_rateLimitBurstSecs;
+	std::unordered_map<std::string, MessageRateLimit> m_rateLimits;
+	std::string m_bindIP;
+	std::vector<std::string> m_seeds;
 };
\ No newline at end of file
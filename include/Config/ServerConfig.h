@@ -4,6 +4,7 @@
 #include <json/json.h>
 #include <Config/ConfigProps.h>
 #include <Config/EnvironmentType.h>
+#include <Config/HttpServerConfig.h>
 
 class ServerConfig
 {
@@ -13,6 +14,10 @@ public:
 	//
 	uint16_t GetRestAPIPort() const { return m_restAPIPort; }
 
+	const HttpServerConfig& GetNodeAPIConfig() const { return m_nodeAPIConfig; }
+	const HttpServerConfig& GetForeignAPIConfig() const { return m_foreignAPIConfig; }
+	const HttpServerConfig& GetOwnerAPIConfig() const { return m_ownerAPIConfig; }
+
 	//
 	// Constructor
 	//
@@ -35,9 +40,16 @@ public:
 			{
 				m_restAPIPort = (uint16_t)serverJSON.get(ConfigProps::Server::REST_API_PORT, m_restAPIPort).asInt();
 			}
+
+			m_nodeAPIConfig = HttpServerConfig(serverJSON, ConfigProps::Server::NODE_API, 15);
+			m_foreignAPIConfig = HttpServerConfig(serverJSON, ConfigProps::Server::FOREIGN_API, 15);
+			m_ownerAPIConfig = HttpServerConfig(serverJSON, ConfigProps::Server::OWNER_API, 15);
 		}
 	}
 
 private:
 	uint16_t m_restAPIPort;
+	HttpServerConfig m_nodeAPIConfig;
+	HttpServerConfig m_foreignAPIConfig;
+	HttpServerConfig m_ownerAPIConfig;
 };
\ No newline at end of file
@@ -4,7 +4,9 @@
 #include <Config/EnvironmentType.h>
 #include <Common/Util/BitUtil.h>
 #include <Common/Util/FileUtil.h>
+#include <Common/Util/StringUtil.h>
 #include <json/json.h>
+#include <algorithm>
 #include <cstdint>
 #include <string>
 
@@ -33,12 +35,24 @@ public:
 
 		m_databaseType = "SQLITE";
 		m_minimumConfirmations = 10;
+		m_sqliteSynchronous = "NORMAL";
+		m_kdfThreads = 2;
+		m_sharedForeignListener = false;
 		if (json.isMember(ConfigProps::Wallet::WALLET))
 		{
 			const Json::Value& walletJSON = json[ConfigProps::Wallet::WALLET];
 
 			m_databaseType = walletJSON.get(ConfigProps::Wallet::DATABASE, "SQLITE").asString();
 			m_minimumConfirmations = walletJSON.get(ConfigProps::Wallet::MIN_CONFIRMATIONS, 10).asUInt();
+
+			const std::string synchronous = StringUtil::ToUpper(walletJSON.get(ConfigProps::Wallet::SQLITE_SYNCHRONOUS, "NORMAL").asString());
+			if (synchronous == "OFF" || synchronous == "NORMAL" || synchronous == "FULL" || synchronous == "EXTRA")
+			{
+				m_sqliteSynchronous = synchronous;
+			}
+
+			m_kdfThreads = (std::max)(1u, walletJSON.get(ConfigProps::Wallet::KDF_THREADS, 2).asUInt());
+			m_sharedForeignListener = walletJSON.get(ConfigProps::Wallet::SHARED_FOREIGN_LISTENER, false).asBool();
 		}
 	}
 
@@ -50,6 +64,17 @@ public:
 	uint32_t GetPrivateKeyVersion() const { return m_privateKeyVersion; }
 	uint32_t GetMinimumConfirmations() const { return m_minimumConfirmations; }
 
+	// PRAGMA synchronous level for wallet databases, which are opened in WAL mode.
+	// NORMAL only risks losing the most recent commits on power loss, never corrupting the database.
+	const std::string& GetSqliteSynchronous() const { return m_sqliteSynchronous; }
+
+	// Number of password KDFs (login, password checks) that can run at once. Each scrypt run uses 32MB.
+	uint32_t GetKdfThreads() const { return m_kdfThreads; }
+
+	// Serves every logged in wallet's foreign API from one listener, routing requests by their onion Host header,
+	// rather than starting a listener per wallet. Requests must then come through tor.
+	bool UseSharedForeignListener() const { return m_sharedForeignListener; }
+
 private:
 	fs::path m_walletPath;
 	std::string m_databaseType;
@@ -58,4 +83,7 @@ private:
 	uint32_t m_publicKeyVersion;
 	uint32_t m_privateKeyVersion;
 	uint32_t m_minimumConfirmations;
+	std::string m_sqliteSynchronous;
+	uint32_t m_kdfThreads;
+	bool m_sharedForeignListener;
 };
@@ -74,6 +74,20 @@ namespace Consensus
 	// easier to reason about.
 	static constexpr uint32_t STATE_SYNC_THRESHOLD = 2 * DAY_HEIGHT;
 
+	// TxHashSet archives are only served for blocks at multiples of this height, so that every syncing peer
+	// requests the same few blocks and a node serving them can reuse the same archive for 12 hours.
+	static constexpr uint32_t TXHASHSET_ARCHIVE_INTERVAL = 12 * HOUR_HEIGHT;
+
+	//
+	// Returns the height of the block to request (or serve) a TxHashSet archive for, given the height of the header chain.
+	// Matches grin's txhashset_archive_header.
+	//
+	static uint64_t GetTxHashSetArchiveHeight(const uint64_t headerHeight)
+	{
+		const uint64_t syncHeight = (std::max)(headerHeight, (uint64_t)STATE_SYNC_THRESHOLD) - STATE_SYNC_THRESHOLD;
+		return syncHeight - (syncHeight % TXHASHSET_ARCHIVE_INTERVAL);
+	}
+
 	// Time window in blocks to calculate block time median
 	static const uint64_t MEDIAN_TIME_WINDOW = 11;
 
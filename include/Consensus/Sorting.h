@@ -28,4 +28,21 @@ namespace Consensus
 
 		return true;
 	}
+
+	//
+	// Sorted by hash, with no two values sharing a hash.
+	//
+	template <class T, typename = std::enable_if_t<std::is_base_of<Traits::IHashable, T>::value>>
+	static bool IsSortedAndUnique(const std::vector<T>& values)
+	{
+		for (size_t i = 1; i < values.size(); i++)
+		{
+			if (!(values[i - 1].GetHash() < values[i].GetHash()))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 #include <Config/Config.h>
 #include <Net/Tor/TorProcess.h>
-#include <scheduler/Scheduler.h>
+#include <Common/TaskScheduler.h>
 #include <Common/Logger.h>
 #include <memory>
 #include <cassert>
@@ -14,7 +14,7 @@ public:
 
     Context(
         const ConfigPtr& pConfig,
-        const std::shared_ptr<Bosma::Scheduler>& pScheduler,
+        const TaskScheduler::Ptr& pScheduler,
         const TorProcess::Ptr& pTorProcess
     ) : m_pConfig(pConfig), m_pScheduler(pScheduler), m_pTorProcess(pTorProcess) { }
 
@@ -31,19 +31,19 @@ public:
         );
         return std::make_shared<Context>(
             pConfig,
-            std::make_shared<Bosma::Scheduler>(12),
+            TaskScheduler::Create(),
             pTorProcess
         );
     }
 
     const Config& GetConfig() const { return *m_pConfig; }
-    const std::shared_ptr<Bosma::Scheduler>& GetScheduler() const noexcept { return m_pScheduler; }
+    const TaskScheduler::Ptr& GetScheduler() const noexcept { return m_pScheduler; }
     const TorProcess::Ptr& GetTorProcess() const noexcept { return m_pTorProcess; }
 
 private:
     // TODO: Include logger
 
     ConfigPtr m_pConfig;
-    std::shared_ptr<Bosma::Scheduler> m_pScheduler;
+    TaskScheduler::Ptr m_pScheduler;
     TorProcess::Ptr m_pTorProcess;
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <Core/File/MappedFile.h>
 #include <filesystem.h>
 #include <cstdint>
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -36,6 +37,36 @@ public:
 		std::vector<unsigned char>& data
 	) const;
 
+	//
+	// Reads into the caller-provided pData, which must have room for numBytes.
+	// Lets callers reuse one buffer across many reads instead of allocating per read.
+	//
+	bool Read(
+		const uint64_t position,
+		const uint64_t numBytes,
+		unsigned char* pData
+	) const;
+
+	//
+	// Calls visitor with a pointer to numBytes starting at position, without copying them when possible.
+	// The pointer is only valid until visitor returns.
+	// Returns false if the range is past the end of the file.
+	//
+	bool Visit(
+		const uint64_t position,
+		const uint64_t numBytes,
+		const std::function<void(const unsigned char*)>& visitor
+	) const;
+
+	void SetAccessHint(const EFileAccess access);
+
+	const fs::path& GetPath() const noexcept { return m_path; }
+
+	//
+	// Moves the file at the given path over this one and loads it, discarding anything not yet flushed.
+	//
+	void Replace(const fs::path& path);
+
 private:
 	fs::path m_path;
 	uint64_t m_bufferIndex;
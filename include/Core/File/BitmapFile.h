@@ -9,6 +9,8 @@
 #pragma warning(pop)
 
 #include <Core/Traits/Batchable.h>
+#include <Core/File/MappedFile.h>
+#include <Core/Exceptions/FileException.h>
 #include <Roaring.h>
 #include <Common/Util/BitUtil.h>
 #include <Common/Util/FileUtil.h>
@@ -16,8 +18,10 @@
 #include <fstream>
 #include <functional>
 #include <algorithm>
+#include <cstring>
 #include <map>
 #include <memory>
+#include <vector>
 
 #ifdef _WIN32
 #define MPATH_STR m_path.wstring()
@@ -48,32 +52,69 @@ public:
 		return pBitmapFile;
 	}
 
+	//
+	// Modified bytes within the file are written straight to the writable mapping and synced together.
+	// Only bytes past the end of the file are written through a stream, as a single contiguous append,
+	// which is the only case where the file has to be remapped.
+	//
 	void Commit() final
 	{
-		if (!m_modifiedBytes.empty())
+		if (m_modifiedBytes.empty())
 		{
-			m_mmap.unmap();
+			return;
+		}
 
-			std::ofstream file(m_path.c_str(), std::ios_base::binary | std::ios_base::out | std::ios_base::in);
+		const uint64_t mappedSize = m_mmap.size();
+		auto iter = m_modifiedBytes.cbegin();
+		for (; iter != m_modifiedBytes.cend() && iter->first < mappedSize; iter++)
+		{
+			m_mmap[iter->first] = (char)iter->second;
+		}
 
-			for (auto iter : m_modifiedBytes)
+		if (mappedSize > 0)
+		{
+			std::error_code error;
+			m_mmap.sync(error);
+			if (error.value() != 0)
 			{
-				file.seekp(iter.first);
-				file.write((const char*)&iter.second, 1);
+				LOG_ERROR_F("Failed to sync file {}: {}", m_path, error.value());
+				throw FILE_EXCEPTION_F("Failed to sync file: {}", m_path);
 			}
+		}
+
+		if (iter != m_modifiedBytes.cend())
+		{
+			// Any gaps between the end of the file and the modified bytes are zero-filled.
+			std::vector<uint8_t> appended(m_modifiedBytes.crbegin()->first + 1 - mappedSize, 0);
+			for (; iter != m_modifiedBytes.cend(); iter++)
+			{
+				appended[iter->first - mappedSize] = iter->second;
+			}
+
+			m_mmap.unmap();
 
+			std::ofstream file(m_path.c_str(), std::ios_base::binary | std::ios_base::out | std::ios_base::app);
+			file.write((const char*)appended.data(), appended.size());
 			file.close();
+			if (file.fail())
+			{
+				LOG_ERROR_F("Failed to write file: {}", m_path);
+				throw FILE_EXCEPTION_F("Failed to write file: {}", m_path);
+			}
 
 			std::error_code error;
-			m_mmap = mio::make_mmap_source(MPATH_STR, error);
+			m_mmap = mio::make_mmap_sink(MPATH_STR, error);
 			if (error.value() != 0)
 			{
-				// TODO: Handle this
+				LOG_ERROR_F("Failed to mmap file: {}", error.value());
+				throw FILE_EXCEPTION_F("Failed to mmap file: {}", m_path);
 			}
 
-			m_modifiedBytes.clear();
-			SetDirty(false);
+			m_size = m_mmap.size();
 		}
+
+		m_modifiedBytes.clear();
+		SetDirty(false);
 	}
 
 	void Rollback() noexcept final
@@ -124,31 +165,94 @@ public:
 		return IsSet(leafIndex) ? s_true : s_false;
 	}
 
+	//
+	// Sets the leaves to add, then unsets every leaf from numLeaves on.
+	// Whole bytes past numLeaves are cleared at once, and ones that are already clear aren't touched,
+	// so rewinding many blocks doesn't modify each leaf individually.
+	//
 	void Rewind(const size_t numLeaves, const std::vector<uint64_t>& leavesToAdd)
 	{
+		SetDirty(true);
 		for (const uint64_t leafIndex : leavesToAdd)
 		{
 			Set(leafIndex);
 		}
 
-		size_t currentSize = GetNumBytes() * 8;
-		for (size_t i = numLeaves; i < currentSize; i++)
+		const uint64_t numBytes = GetNumBytes();
+		uint64_t byteIndex = numLeaves / 8;
+		if (numLeaves % 8 != 0 && byteIndex < numBytes)
+		{
+			for (size_t i = numLeaves; i < (byteIndex + 1) * 8; i++)
+			{
+				Unset(i);
+			}
+
+			byteIndex++;
+		}
+
+		for (; byteIndex < numBytes; byteIndex++)
 		{
-			Unset(i);
+			if (GetByte(byteIndex) != 0)
+			{
+				m_modifiedBytes[byteIndex] = 0;
+			}
+		}
+	}
+
+	//
+	// Returns up to maxLeaves of the set leaves in [firstLeaf, endLeaf), in order.
+	// Empty bytes are skipped whole, and empty 64-leaf words of the mapped file are skipped with a single compare,
+	// so sparse bitmaps aren't probed one leaf at a time.
+	//
+	std::vector<uint64_t> GetSetLeaves(const uint64_t firstLeaf, const uint64_t endLeaf, const size_t maxLeaves) const
+	{
+		std::vector<uint64_t> leaves;
+
+		uint64_t leafIndex = firstLeaf;
+		while (leafIndex < endLeaf && leaves.size() < maxLeaves)
+		{
+			const uint64_t byteIndex = leafIndex / 8;
+			if ((leafIndex % 64) == 0 && m_modifiedBytes.empty() && (byteIndex + 8) <= m_mmap.size())
+			{
+				uint64_t word = 0;
+				memcpy(&word, m_mmap.data() + byteIndex, sizeof(word));
+				if (word == 0)
+				{
+					leafIndex += 64;
+					continue;
+				}
+			}
+
+			const uint8_t byte = GetByte(byteIndex);
+			if (byte == 0)
+			{
+				leafIndex = (byteIndex + 1) * 8;
+				continue;
+			}
+
+			if ((byte & BitToByte(leafIndex % 8)) > 0)
+			{
+				leaves.push_back(leafIndex);
+			}
+
+			++leafIndex;
 		}
+
+		return leaves;
 	}
 
-	Roaring ToRoaring() const
+	// Returns the PMMR positions (plus 1) of the set leaves before numLeaves.
+	Roaring ToRoaring(const uint64_t numLeaves = UINT64_MAX) const
 	{
 		Roaring bitmap;
 
-		const uint64_t numBytes = GetNumBytes();
+		const uint64_t numBytes = (std::min)(GetNumBytes(), (numLeaves / 8) + 1);
 		for (uint32_t i = 0; i < (uint32_t)numBytes; i++)
 		{
 			const uint8_t byte = GetByte(i);
 			for (uint8_t j = 0; j < 8; j++)
 			{
-				if ((byte & BitToByte(j)) > 0)
+				if ((byte & BitToByte(j)) > 0 && ((i * 8ULL) + j) < numLeaves)
 				{
 					bitmap.add((uint32_t)(MMRUtil::GetPMMRIndex((i * 8) + j) + 1));
 				}
@@ -180,6 +284,25 @@ private:
 	{
 		fs::path version1Path = m_path.parent_path() / "version1";
 
+		// A read-only bitmap (see IMappedFile::SetReadOnly) is never created or converted, just mapped if it exists.
+		// Bitmaps only ever grow in place, so the mapping can't end up past the end of the file.
+		if (IMappedFile::IsReadOnly())
+		{
+			m_size = FileUtil::Exists(m_path) ? FileUtil::GetFileSize(m_path) : 0;
+			if (m_size > 0)
+			{
+				std::error_code error;
+				m_mmap = mio::make_mmap_sink(MPATH_STR, error);
+				if (error.value() != 0)
+				{
+					LOG_ERROR_F("Failed to mmap file: {}", error.value());
+					throw FILE_EXCEPTION_F("Failed to mmap file: {}", m_path);
+				}
+			}
+
+			return;
+		}
+
 		std::ifstream inFile(m_path.c_str(), std::ios::in | std::ifstream::ate | std::ifstream::binary);
 		if (inFile.is_open())
 		{
@@ -205,7 +328,7 @@ private:
 			ConvertToLeaves(version1Path);
 
 			std::error_code error;
-			m_mmap = mio::make_mmap_source(MPATH_STR, error);
+			m_mmap = mio::make_mmap_sink(MPATH_STR, error);
 			if (error.value() != 0)
 			{
 				LOG_ERROR_F("Failed to mmap file: {}", error.value());
@@ -292,7 +415,7 @@ private:
 
 	fs::path m_path;
 	std::map<uint64_t, uint8_t> m_modifiedBytes;
-	mio::mmap_source m_mmap;
+	mio::mmap_sink m_mmap;
 	uint64_t m_size;
 
 	static const bool s_true{ false };
@@ -4,7 +4,9 @@
 #include <Core/Exceptions/FileException.h>
 #include <Core/Traits/Batchable.h>
 #include <Crypto/BigInteger.h>
+#include <Common/AllocProfiler.h>
 #include <Common/Util/StringUtil.h>
+#include <functional>
 #include <memory>
 
 template<size_t NUM_BYTES>
@@ -60,6 +62,7 @@ public:
 
 	std::vector<unsigned char> GetDataAt(const uint64_t position) const
 	{
+		ScopedAllocTag allocTag(EAllocTag::PMMR_DATA);
 		std::vector<unsigned char> data;
 		if (!m_pFile->Read(position * NUM_BYTES, NUM_BYTES, data))
 		{
@@ -69,18 +72,79 @@ public:
 		return data;
 	}
 
+	//
+	// Reads numItems consecutive entries starting at position with a single read.
+	// Entries are returned back-to-back, each NUM_BYTES long.
+	//
+	std::vector<unsigned char> GetDataRange(const uint64_t position, const uint64_t numItems) const
+	{
+		ScopedAllocTag allocTag(EAllocTag::PMMR_DATA);
+		std::vector<unsigned char> data;
+		if (!m_pFile->Read(position * NUM_BYTES, numItems * NUM_BYTES, data))
+		{
+			throw FILE_EXCEPTION(StringUtil::Format("Failed to read {} items at position {}", numItems, position));
+		}
+
+		return data;
+	}
+
+	//
+	// Reads numItems consecutive entries starting at position into the caller-provided pData,
+	// which must have room for numItems * NUM_BYTES.
+	//
+	void ReadData(const uint64_t position, const uint64_t numItems, unsigned char* pData) const
+	{
+		if (!m_pFile->Read(position * NUM_BYTES, numItems * NUM_BYTES, pData))
+		{
+			throw FILE_EXCEPTION(StringUtil::Format("Failed to read {} items at position {}", numItems, position));
+		}
+	}
+
+	//
+	// Calls visitor with a pointer to numItems consecutive entries starting at position, read in place
+	// from the mapped file (or the unflushed buffer) whenever possible. The pointer is only valid until visitor returns.
+	//
+	void VisitData(const uint64_t position, const uint64_t numItems, const std::function<void(const unsigned char*)>& visitor) const
+	{
+		if (!m_pFile->Visit(position * NUM_BYTES, numItems * NUM_BYTES, visitor))
+		{
+			throw FILE_EXCEPTION(StringUtil::Format("Failed to read {} items at position {}", numItems, position));
+		}
+	}
+
+	//
+	// Hints how the file is about to be read, eg. EFileAccess::SEQUENTIAL before scanning all of it.
+	//
+	void SetAccessHint(const EFileAccess access)
+	{
+		m_pFile->SetAccessHint(access);
+	}
+
 	void AddData(const std::vector<unsigned char>& data)
 	{
+		ScopedAllocTag allocTag(EAllocTag::PMMR_DATA);
 		SetDirty(true);
 		m_pFile->Append(data);
 	}
 
 	void AddData(const CBigInteger<NUM_BYTES>& data)
 	{
+		ScopedAllocTag allocTag(EAllocTag::PMMR_DATA);
 		SetDirty(true);
 		m_pFile->Append(data.GetData());
 	}
 
+	const fs::path& GetPath() const noexcept { return m_pFile->GetPath(); }
+
+	//
+	// Replaces the file with the one at the given path (eg. a compacted copy), discarding any uncommitted changes.
+	//
+	void Replace(const fs::path& path)
+	{
+		m_pFile->Replace(path);
+		SetDirty(false);
+	}
+
 private:
 	DataFile(std::shared_ptr<AppendOnlyFile> pFile)
 		: m_pFile(pFile)
@@ -1,11 +1,23 @@
 #pragma once
 
+#include <functional>
 #include <mutex>
 #include <memory>
 #include <vector>
 #include <cstdint>
 #include <filesystem.h>
 
+//
+// How a mapped file is about to be read, so the OS can tune read-ahead for it.
+//
+enum class EFileAccess
+{
+    NORMAL,
+
+    // Long front-to-back scans, eg. validating every hash and rangeproof of the TxHashSet.
+    SEQUENTIAL
+};
+
 class IMappedFile
 {
 public:
@@ -14,7 +26,30 @@ public:
     static IMappedFile::UPtr Load(const fs::path& path);
     virtual ~IMappedFile() = default;
 
+    //
+    // Process-wide. Files loaded while set are opened read-only without being mapped, for replicas reading files
+    // another process writes (see ReadOnlyFile). Missing files aren't created, and writes fail.
+    //
+    static void SetReadOnly(const bool readOnly);
+    static bool IsReadOnly();
+
     virtual bool Write(const size_t startIndex, const std::vector<uint8_t>& data) = 0;
     virtual void Read(const uint64_t position, const uint64_t numBytes, std::vector<uint8_t>& data) const = 0;
+
+    //
+    // Copies numBytes starting at position into the caller-provided pData, which must have room for numBytes.
+    //
+    virtual void Read(const uint64_t position, const uint64_t numBytes, uint8_t* pData) const = 0;
+
+    //
+    // Calls visitor with a pointer directly into the mapped region [position, position + numBytes).
+    // The region is only guaranteed to stay mapped until visitor returns, so it must not keep the pointer.
+    //
+    virtual void Visit(const uint64_t position, const uint64_t numBytes, const std::function<void(const uint8_t*)>& visitor) const = 0;
+
+    //
+    // Only a hint. Implementations that can't tune read-ahead ignore it.
+    //
+    virtual void SetAccessHint(const EFileAccess access) = 0;
 };
 
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <Core/Models/TransactionKernel.h>
+#include <json/json.h>
+
+//
+// A kernel along with the height of the block that included it and its position in the kernel MMR.
+//
+class LocatedTxKernel
+{
+public:
+	LocatedTxKernel(TransactionKernel&& kernel, const uint64_t height, const uint64_t mmrIndex)
+		: m_kernel(std::move(kernel)), m_height(height), m_mmrIndex(mmrIndex) { }
+
+	const TransactionKernel& GetKernel() const noexcept { return m_kernel; }
+	uint64_t GetHeight() const noexcept { return m_height; }
+	uint64_t GetMMRIndex() const noexcept { return m_mmrIndex; }
+
+	Json::Value ToJSON() const
+	{
+		Json::Value json;
+		json["tx_kernel"] = m_kernel.ToJSON();
+		json["height"] = Json::UInt64(m_height);
+		json["mmr_index"] = Json::UInt64(m_mmrIndex + 1);
+		return json;
+	}
+
+private:
+	TransactionKernel m_kernel;
+	uint64_t m_height;
+	uint64_t m_mmrIndex;
+};
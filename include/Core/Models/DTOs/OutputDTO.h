@@ -34,6 +34,27 @@ public:
 	const OutputLocation& GetLocation() const { return m_location; }
 	const RangeProof& GetRangeProof() const { return m_rangeProof; }
 
+	//
+	// Serialization/Deserialization
+	//
+	void Serialize(Serializer& serializer) const
+	{
+		serializer.Append<uint8_t>(m_spent ? 1 : 0);
+		m_identifier.Serialize(serializer);
+		m_location.Serialize(serializer);
+		m_rangeProof.Serialize(serializer);
+	}
+
+	static OutputDTO Deserialize(ByteBuffer& byteBuffer)
+	{
+		const bool spent = byteBuffer.ReadU8() == 1;
+		OutputIdentifier identifier = OutputIdentifier::Deserialize(byteBuffer);
+		OutputLocation location = OutputLocation::Deserialize(byteBuffer);
+		RangeProof rangeProof = RangeProof::Deserialize(byteBuffer);
+
+		return OutputDTO(spent, std::move(identifier), std::move(location), std::move(rangeProof));
+	}
+
 	Json::Value ToJSON() const
 	{
 		Json::Value json;
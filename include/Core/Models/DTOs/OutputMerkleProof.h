@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Crypto/Commitment.h>
+#include <Core/Models/MerkleProof.h>
+#include <json/json.h>
+
+//
+// A merkle proof of an unspent output's inclusion in the output MMR, along with the output's block height and MMR index.
+//
+class OutputMerkleProof
+{
+public:
+	OutputMerkleProof(const Commitment& commitment, const uint64_t height, const uint64_t mmrIndex, MerkleProof&& proof)
+		: m_commitment(commitment), m_height(height), m_mmrIndex(mmrIndex), m_proof(std::move(proof)) { }
+
+	const Commitment& GetCommitment() const noexcept { return m_commitment; }
+	uint64_t GetHeight() const noexcept { return m_height; }
+	uint64_t GetMMRIndex() const noexcept { return m_mmrIndex; }
+	const MerkleProof& GetProof() const noexcept { return m_proof; }
+
+	Json::Value ToJSON() const
+	{
+		Json::Value json;
+		json["commit"] = m_commitment.ToHex();
+		json["height"] = Json::UInt64(m_height);
+		json["mmr_index"] = Json::UInt64(m_mmrIndex + 1);
+		json["merkle_proof"] = m_proof.ToJSON();
+		return json;
+	}
+
+private:
+	Commitment m_commitment;
+	uint64_t m_height;
+	uint64_t m_mmrIndex;
+	MerkleProof m_proof;
+};
\ No newline at end of file
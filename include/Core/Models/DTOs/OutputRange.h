@@ -15,6 +15,36 @@ public:
 	uint64_t GetLastRetrievedIndex() const { return m_lastRetrievedIndex; }
 	const std::vector<OutputDTO>& GetOutputs() const { return m_outputs; }
 
+	//
+	// Serialization/Deserialization
+	//
+	void Serialize(Serializer& serializer) const
+	{
+		serializer.Append(m_highestIndex);
+		serializer.Append(m_lastRetrievedIndex);
+		serializer.Append<uint64_t>(m_outputs.size());
+		for (const OutputDTO& output : m_outputs)
+		{
+			output.Serialize(serializer);
+		}
+	}
+
+	static OutputRange Deserialize(ByteBuffer& byteBuffer)
+	{
+		const uint64_t highestIndex = byteBuffer.ReadU64();
+		const uint64_t lastRetrievedIndex = byteBuffer.ReadU64();
+		const uint64_t numOutputs = byteBuffer.ReadU64();
+
+		std::vector<OutputDTO> outputs;
+		outputs.reserve((std::min)(numOutputs, (uint64_t)byteBuffer.GetRemainingSize()));
+		for (uint64_t i = 0; i < numOutputs; i++)
+		{
+			outputs.push_back(OutputDTO::Deserialize(byteBuffer));
+		}
+
+		return OutputRange(highestIndex, lastRetrievedIndex, std::move(outputs));
+	}
+
 	static OutputRange FromJSON(const Json::Value& json)
 	{
 		const uint64_t highestIndex = JsonUtil::GetRequiredUInt64(json, "highest_index");
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <Core/Models/DTOs/OutputRange.h>
+#include <memory>
+#include <memory_resource>
+
+//
+// A batch of unspent outputs scanned by leaf index, as returned by INodeClient::ScanOutputs.
+// When read straight from an in-process node's TxHashSet, the rangeproofs are allocated from a single arena owned by the batch,
+// instead of with a heap allocation per output. The outputs may point into the arena, so a batch can be moved, but never copied or assigned.
+//
+class OutputScanBatch
+{
+public:
+	OutputScanBatch(
+		const uint64_t highestIndex,
+		const uint64_t lastRetrievedIndex,
+		std::vector<OutputDTO>&& outputs,
+		std::shared_ptr<std::pmr::memory_resource> pArena)
+		: m_pArena(std::move(pArena)),
+		m_highestIndex(highestIndex),
+		m_lastRetrievedIndex(lastRetrievedIndex),
+		m_outputs(std::move(outputs))
+	{
+
+	}
+
+	OutputScanBatch(OutputScanBatch&& other) noexcept = default;
+	OutputScanBatch(const OutputScanBatch& other) = delete;
+	OutputScanBatch& operator=(const OutputScanBatch& other) = delete;
+	OutputScanBatch& operator=(OutputScanBatch&& other) = delete;
+
+	//
+	// For node clients that only support GetOutputsByLeafIndex. The outputs are copied, so no arena is needed.
+	//
+	static OutputScanBatch FromRange(const OutputRange& range)
+	{
+		return OutputScanBatch(
+			range.GetHighestIndex(),
+			range.GetLastRetrievedIndex(),
+			std::vector<OutputDTO>(range.GetOutputs()),
+			nullptr
+		);
+	}
+
+	uint64_t GetHighestIndex() const { return m_highestIndex; }
+	uint64_t GetLastRetrievedIndex() const { return m_lastRetrievedIndex; }
+	const std::vector<OutputDTO>& GetOutputs() const { return m_outputs; }
+
+	//
+	// Copies the outputs (and their rangeproofs) to the heap, so the range can outlive the batch.
+	//
+	OutputRange ToRange() const
+	{
+		return OutputRange(m_highestIndex, m_lastRetrievedIndex, std::vector<OutputDTO>(m_outputs));
+	}
+
+private:
+	// Declared first, so it's destroyed after the outputs allocated from it.
+	std::shared_ptr<std::pmr::memory_resource> m_pArena;
+	uint64_t m_highestIndex;
+	uint64_t m_lastRetrievedIndex;
+	std::vector<OutputDTO> m_outputs;
+};
@@ -12,6 +12,7 @@
 #include <json/json.h>
 #include <numeric>
 #include <memory>
+#include <memory_resource>
 #include <vector>
 
 class FullBlock : public Traits::IPrintable, public Traits::ISerializable
@@ -23,7 +24,7 @@ public:
 	// Constructors
 	//
 	FullBlock(BlockHeaderPtr pBlockHeader, TransactionBody&& transactionBody);
-	FullBlock(const FullBlock& other) = default;
+	FullBlock(const FullBlock& other);
 	FullBlock(FullBlock&& other) noexcept = default;
 	FullBlock();
 
@@ -35,8 +36,8 @@ public:
 	//
 	// Operators
 	//
-	FullBlock& operator=(const FullBlock& other) = default;
-	FullBlock& operator=(FullBlock&& other) noexcept = default;
+	FullBlock& operator=(const FullBlock& other);
+	FullBlock& operator=(FullBlock&& other) noexcept;
 
 	//
 	// Getters
@@ -80,6 +81,22 @@ public:
 		return commitments;
 	}
 
+	std::vector<Commitment> GetKernelCommitments() const
+	{
+		const auto& kernels = GetKernels();
+
+		std::vector<Commitment> commitments;
+		commitments.reserve(kernels.size());
+
+		std::transform(
+			kernels.cbegin(), kernels.cend(),
+			std::back_inserter(commitments),
+			[](const TransactionKernel& kernel) { return kernel.GetExcessCommitment(); }
+		);
+
+		return commitments;
+	}
+
 	uint64_t GetTotalFees() const noexcept
 	{
 		return std::accumulate(
@@ -99,6 +116,12 @@ public:
 	//
 	void Serialize(Serializer& serializer) const final;
 	static FullBlock Deserialize(ByteBuffer& byteBuffer);
+
+	//
+	// Deserializes the block with its rangeproofs allocated from a single arena, owned by the block and released with it,
+	// instead of with a heap allocation per output. Only moves keep the arena; copies are allocated from the heap.
+	//
+	static FullBlock DeserializeWithArena(ByteBuffer& byteBuffer);
 	Json::Value ToJSON() const;
 
 	//
@@ -118,6 +141,9 @@ public:
 	std::string Format() const final { return m_pBlockHeader->Format(); }
 
 private:
+	// Declared first, so it's destroyed after the rangeproofs that may have been allocated from it.
+	std::shared_ptr<std::pmr::memory_resource> m_pArena;
+
 	BlockHeaderPtr m_pBlockHeader;
 	TransactionBody m_transactionBody;
 	mutable bool m_validated;
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <Crypto/Hash.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Serialization/Serializer.h>
+#include <Core/Traits/Serializable.h>
+#include <json/json.h>
+#include <vector>
+
+//
+// Proves a leaf is included in an MMR of the given size, by the hashes needed to recalculate the root from the leaf's hash:
+// the siblings from the leaf up to its peak, then the bagged peaks to the right of that peak (if any),
+// then each of the peaks to its left, nearest first. Serialized the same way as grin's MerkleProof.
+//
+class MerkleProof : public Traits::ISerializable
+{
+public:
+	MerkleProof(const uint64_t mmrSize, std::vector<Hash>&& path)
+		: m_mmrSize(mmrSize), m_path(std::move(path)) { }
+
+	uint64_t GetMMRSize() const noexcept { return m_mmrSize; }
+	const std::vector<Hash>& GetPath() const noexcept { return m_path; }
+
+	void Serialize(Serializer& serializer) const final
+	{
+		serializer.Append<uint64_t>(m_mmrSize);
+		serializer.Append<uint64_t>(m_path.size());
+		for (const Hash& hash : m_path)
+		{
+			serializer.AppendBigInteger<32>(hash);
+		}
+	}
+
+	static MerkleProof Deserialize(ByteBuffer& byteBuffer)
+	{
+		const uint64_t mmrSize = byteBuffer.ReadU64();
+		const uint64_t pathLength = byteBuffer.ReadU64();
+
+		std::vector<Hash> path;
+		for (uint64_t i = 0; i < pathLength; i++)
+		{
+			path.emplace_back(byteBuffer.ReadBigInteger<32>());
+		}
+
+		return MerkleProof(mmrSize, std::move(path));
+	}
+
+	Json::Value ToJSON() const
+	{
+		Json::Value pathJSON(Json::arrayValue);
+		for (const Hash& hash : m_path)
+		{
+			pathJSON.append(hash.ToHex());
+		}
+
+		Json::Value json;
+		json["mmr_size"] = Json::UInt64(m_mmrSize);
+		json["path"] = pathJSON;
+		return json;
+	}
+
+private:
+	uint64_t m_mmrSize;
+	std::vector<Hash> m_path;
+};
\ No newline at end of file
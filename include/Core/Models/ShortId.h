@@ -4,6 +4,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file LICENSE or http://www.opensource.org/licenses/mit-license.php.
 
+#include <utility>
 #include <vector>
 #include <Core/Models/BlockHeader.h>
 #include <Core/Serialization/ByteBuffer.h>
@@ -21,6 +22,13 @@ public:
 	ShortId() = default;
 	static ShortId Create(const CBigInteger<32>& hash, const CBigInteger<32>& blockHash, const uint64_t nonce);
 
+	//
+	// The siphash keys (k0, k1) derived from a block's hash and nonce.
+	// Computing them once lets the short ids of many kernels be created for the same block without rehashing the block.
+	//
+	static std::pair<uint64_t, uint64_t> CalculateKeys(const CBigInteger<32>& blockHash, const uint64_t nonce);
+	static ShortId Create(const CBigInteger<32>& hash, const std::pair<uint64_t, uint64_t>& keys);
+
 	//
 	// Destructor
 	//
@@ -14,6 +14,7 @@
 #include <Core/Traits/Printable.h>
 #include <json/json.h>
 #include <mutex>
+#include <atomic>
 #include <memory>
 
 ////////////////////////////////////////
@@ -39,7 +40,7 @@ public:
 	// Operators
 	//
 	Transaction& operator=(const Transaction& transaction);
-	Transaction& operator=(Transaction&& transaction) noexcept = default;
+	Transaction& operator=(Transaction&& transaction) noexcept;
 	inline bool operator<(const Transaction& transaction) const { return GetHash() < transaction.GetHash(); }
 	inline bool operator==(const Transaction& transaction) const { return GetHash() == transaction.GetHash(); }
 	inline bool operator!=(const Transaction& transaction) const { return GetHash() != transaction.GetHash(); }
@@ -64,8 +65,18 @@ public:
 	//
 	// Hashing
 	//
+	// Calculated the first time it's needed, since it covers the whole serialized transaction, rangeproofs and all.
+	// Once calculated, it's read without locking, and carried along by copies and moves.
+	//
 	const Hash& GetHash() const;
 
+	//
+	// Set once TransactionValidator has verified everything that doesn't depend on chain state,
+	// so a transaction validated ahead of time (eg. by the p2p pipe) isn't verified again when added to the pool.
+	//
+	bool WasValidated() const noexcept { return m_validated; }
+	void MarkAsValidated() const noexcept { m_validated = true; }
+
 	//
 	// Traits
 	//
@@ -78,8 +89,14 @@ private:
 	// The transaction body.
 	TransactionBody m_transactionBody;
 
+	// Only written once, under m_mutex, before m_hashed is set.
 	mutable Hash m_hash;
 	mutable std::mutex m_mutex;
+	mutable std::atomic_bool m_hashed{ false };
+	mutable std::atomic_bool m_validated{ false };
+
+	void CopyHash(const Transaction& transaction);
+	void MoveHash(Transaction&& transaction) noexcept;
 };
 
 typedef std::shared_ptr<const Transaction> TransactionPtr;
\ No newline at end of file
@@ -23,8 +23,7 @@ public:
 	// Constructors
 	//
 	TransactionInput(const EOutputFeatures features, Commitment&& commitment);
-	TransactionInput(const EOutputFeatures features, const Commitment& commitment)
-		: m_features(features), m_commitment(commitment) { }
+	TransactionInput(const EOutputFeatures features, const Commitment& commitment);
 	TransactionInput(const TransactionInput& transactionInput) = default;
 	TransactionInput(TransactionInput&& transactionInput) noexcept = default;
 	TransactionInput() = default;
@@ -71,7 +70,8 @@ private:
 	// The commit referencing the output being spent.
 	Commitment m_commitment;
 
-	mutable Hash m_hash;
+	// Calculated once on construction, and carried along by copies and moves.
+	Hash m_hash;
 };
 
 static struct
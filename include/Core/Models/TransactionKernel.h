@@ -88,7 +88,8 @@ private:
 	// The signature proving the excess is a valid public key, which signs the transaction fee.
 	Signature m_excessSignature;
 
-	mutable Hash m_hash;
+	// Calculated once on construction, and carried along by copies and moves.
+	Hash m_hash;
 };
 
 static struct
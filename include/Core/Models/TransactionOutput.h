@@ -66,6 +66,12 @@ public:
 	const Hash& GetHash() const final { return m_hash; }
 	std::string Format() const final { return m_commitment.Format(); }
 
+	//
+	// Blake2b of the features and commitment, without the rangeproof.
+	// Inputs are hashed the same way, so an input has the same hash as the output it spends.
+	//
+	static Hash CalculateHash(const EOutputFeatures features, const Commitment& commitment);
+
 private:
 	// Options for an output's structure or use
 	EOutputFeatures m_features;
@@ -76,7 +82,8 @@ private:
 	// A proof that the commitment is in the right range
 	RangeProof m_rangeProof;
 
-	mutable Hash m_hash;
+	// Calculated once on construction, and carried along by copies and moves.
+	Hash m_hash;
 };
 
 static struct
@@ -7,6 +7,7 @@
 #include <Core/Serialization/EndianHelper.h>
 #include <Core/Exceptions/DeserializationException.h>
 #include <Core/Enums/ProtocolVersion.h>
+#include <Common/AllocProfiler.h>
 
 #include <vector>
 #include <string>
@@ -14,6 +15,8 @@
 #include <cstdint>
 #include <algorithm>
 #include <array>
+#include <memory_resource>
+#include <type_traits>
 
 #include <Crypto/BigInteger.h>
 
@@ -21,54 +24,53 @@ class ByteBuffer
 {
 public:
 	ByteBuffer(std::vector<unsigned char>&& bytes, const EProtocolVersion version = EProtocolVersion::V1)
-		: m_index(0), m_bytes(std::move(bytes)), m_protocolVersion(version) { }
+		: m_index(0), m_bytes(std::move(bytes)), m_pData(m_bytes.data()), m_size(m_bytes.size()), m_protocolVersion(version),
+		m_pMemoryResource(std::pmr::get_default_resource()) { }
 	ByteBuffer(const std::vector<unsigned char>& bytes, const EProtocolVersion version = EProtocolVersion::V1)
-		: m_index(0), m_bytes(bytes), m_protocolVersion(version) { }
-
-	template<class T>
-	void ReadBigEndian(T& t)
+		: m_index(0), m_bytes(bytes), m_pData(m_bytes.data()), m_size(m_bytes.size()), m_protocolVersion(version),
+		m_pMemoryResource(std::pmr::get_default_resource()) { }
+
+	//
+	// Creates a non-owning view over size bytes at pData, which must outlive the ByteBuffer.
+	//
+	ByteBuffer(const unsigned char* pData, const size_t size, const EProtocolVersion version = EProtocolVersion::V1)
+		: m_index(0), m_pData(pData), m_size(size), m_protocolVersion(version), m_pMemoryResource(std::pmr::get_default_resource()) { }
+
+	ByteBuffer(const ByteBuffer& other)
+		: m_index(other.m_index),
+		m_bytes(other.m_bytes),
+		m_pData(other.IsView() ? other.m_pData : m_bytes.data()),
+		m_size(other.m_size),
+		m_protocolVersion(other.m_protocolVersion),
+		m_pMemoryResource(other.m_pMemoryResource) { }
+	ByteBuffer(ByteBuffer&& other) noexcept
+		: m_index(other.m_index),
+		m_pData(other.m_pData),
+		m_size(other.m_size),
+		m_protocolVersion(other.m_protocolVersion),
+		m_pMemoryResource(other.m_pMemoryResource)
 	{
-		if (m_index + sizeof(T) > m_bytes.size())
-		{
-			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
-		}
-
-		if (EndianHelper::IsBigEndian())
+		if (!other.IsView())
 		{
-			memcpy(&t, &m_bytes[m_index], sizeof(T));
-		}
-		else
-		{
-			std::vector<unsigned char> temp;
-			temp.resize(sizeof(T));
-			std::reverse_copy(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + sizeof(T), temp.begin());
-			memcpy(&t, &temp[0], sizeof(T));
+			m_bytes = std::move(other.m_bytes);
+			m_pData = m_bytes.data();
 		}
+	}
+	ByteBuffer& operator=(const ByteBuffer&) = delete;
+	ByteBuffer& operator=(ByteBuffer&&) = delete;
 
-		m_index += sizeof(T);
+	template<class T>
+	void ReadBigEndian(T& t)
+	{
+		ReadRaw(t);
+		t = EndianHelper::ToBigEndian(t);
 	}
 
 	template<class T>
 	void ReadLittleEndian(T& t)
 	{
-		if (m_index + sizeof(T) > m_bytes.size())
-		{
-			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
-		}
-
-		if (EndianHelper::IsBigEndian())
-		{
-			std::vector<unsigned char> temp;
-			temp.resize(sizeof(T));
-			std::reverse_copy(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + sizeof(T), temp.begin());
-			memcpy(&t, &temp[0], sizeof(T));
-		}
-		else
-		{
-			memcpy(&t, &m_bytes[m_index], sizeof(T));
-		}
-
-		m_index += sizeof(T);
+		ReadRaw(t);
+		t = EndianHelper::ToLittleEndian(t);
 	}
 
 	int8_t Read8()
@@ -145,18 +147,19 @@ public:
 
 	std::string ReadVarStr()
 	{
+		ScopedAllocTag allocTag(EAllocTag::BYTE_BUFFER);
 		const uint64_t stringLength = ReadU64();
 		if (stringLength == 0)
 		{
 			return "";
 		}
 
-		if (m_index + stringLength > m_bytes.size())
+		if (m_index + stringLength > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
 		}
 
-		std::vector<unsigned char> temp(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + stringLength);
+		std::vector<unsigned char> temp(m_pData + m_index, m_pData + m_index + stringLength);
 		m_index += stringLength;
 
 		return std::string((char*)&temp[0], stringLength);
@@ -164,12 +167,13 @@ public:
 
 	std::string ReadString(const size_t size)
 	{
-		if (m_index + size > m_bytes.size())
+		ScopedAllocTag allocTag(EAllocTag::BYTE_BUFFER);
+		if (m_index + size > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
 		}
 
-		std::vector<unsigned char> temp(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + size);
+		std::vector<unsigned char> temp(m_pData + m_index, m_pData + m_index + size);
 		m_index += size;
 
 		return std::string((char*)&temp[0], size);
@@ -178,21 +182,39 @@ public:
 	template<size_t NUM_BYTES>
 	CBigInteger<NUM_BYTES> ReadBigInteger()
 	{
-		if (m_index + NUM_BYTES > m_bytes.size())
+		ScopedAllocTag allocTag(EAllocTag::BYTE_BUFFER);
+		if (m_index + NUM_BYTES > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
 		}
 
-		std::vector<unsigned char> data(m_bytes.cbegin() + m_index, m_bytes.cbegin() + m_index + NUM_BYTES);
-
+		const size_t index = m_index;
 		m_index += NUM_BYTES;
 
-		return CBigInteger<NUM_BYTES>(std::move(data));
+		return CBigInteger<NUM_BYTES>(m_pData + index);
 	}
 
 	std::vector<unsigned char> ReadVector(const uint64_t numBytes)
 	{
-		if (m_index + numBytes > m_bytes.size())
+		ScopedAllocTag allocTag(EAllocTag::BYTE_BUFFER);
+		if (m_index + numBytes > m_size)
+		{
+			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
+		}
+
+		const size_t index = m_index;
+		m_index += numBytes;
+
+		return std::vector<unsigned char>(m_pData + index, m_pData + index + numBytes);
+	}
+
+	//
+	// Reads the bytes into a vector allocated from the buffer's memory resource.
+	//
+	std::pmr::vector<unsigned char> ReadPmrVector(const uint64_t numBytes)
+	{
+		ScopedAllocTag allocTag(EAllocTag::BYTE_BUFFER);
+		if (m_index + numBytes > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
 		}
@@ -200,13 +222,13 @@ public:
 		const size_t index = m_index;
 		m_index += numBytes;
 
-		return std::vector<unsigned char>(m_bytes.cbegin() + index, m_bytes.cbegin() + index + numBytes);
+		return std::pmr::vector<unsigned char>(m_pData + index, m_pData + index + numBytes, m_pMemoryResource);
 	}
 
 	template<size_t T>
 	std::array<uint8_t, T> ReadArray()
 	{
-		if (m_index + T > m_bytes.size())
+		if (m_index + T > m_size)
 		{
 			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
 		}
@@ -215,26 +237,73 @@ public:
 		m_index += T;
 
 		std::array<uint8_t, T> arr;
-		std::copy(m_bytes.begin() + index, m_bytes.begin() + index + T, arr.begin());
+		std::copy(m_pData + index, m_pData + index + T, arr.begin());
 		return arr;
 	}
 
+	void Skip(const size_t numBytes)
+	{
+		if (m_index + numBytes > m_size)
+		{
+			throw DESERIALIZATION_EXCEPTION("Attempted to skip past end of ByteBuffer.");
+		}
+
+		m_index += numBytes;
+	}
+
+	size_t GetIndex() const noexcept
+	{
+		return m_index;
+	}
+
 	size_t GetRemainingSize() const noexcept
 	{
-		return m_bytes.size() - m_index;
+		return m_size - m_index;
 	}
 	
 	std::vector<uint8_t> ReadRemainingBytes() noexcept
 	{
+		ScopedAllocTag allocTag(EAllocTag::BYTE_BUFFER);
 		size_t prev_index = m_index;
 		m_index += GetRemainingSize();
-		return std::vector<unsigned char>(m_bytes.cbegin() + prev_index, m_bytes.cbegin() + m_index);
+		return std::vector<unsigned char>(m_pData + prev_index, m_pData + m_index);
 	}
 
 	EProtocolVersion GetProtocolVersion() const noexcept { return m_protocolVersion; }
 
+	//
+	// The memory resource that variable-length fields (eg. rangeproofs) are allocated from as they're read.
+	// Defaults to the heap. Returns the previous resource.
+	//
+	std::pmr::memory_resource* GetMemoryResource() const noexcept { return m_pMemoryResource; }
+	std::pmr::memory_resource* SetMemoryResource(std::pmr::memory_resource* pMemoryResource) noexcept
+	{
+		std::pmr::memory_resource* pPrevious = m_pMemoryResource;
+		m_pMemoryResource = pMemoryResource;
+		return pPrevious;
+	}
+
 private:
+	bool IsView() const noexcept { return m_pData != m_bytes.data(); }
+
+	template<class T>
+	void ReadRaw(T& t)
+	{
+		static_assert(std::is_integral<T>::value, "Only integers can be read with a byte order");
+
+		if (m_index + sizeof(T) > m_size)
+		{
+			throw DESERIALIZATION_EXCEPTION("Attempted to read past end of ByteBuffer.");
+		}
+
+		memcpy(&t, m_pData + m_index, sizeof(T));
+		m_index += sizeof(T);
+	}
+
 	size_t m_index;
 	std::vector<unsigned char> m_bytes;
+	const unsigned char* m_pData;
+	size_t m_size;
 	EProtocolVersion m_protocolVersion;
+	std::pmr::memory_resource* m_pMemoryResource;
 };
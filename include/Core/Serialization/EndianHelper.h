@@ -6,6 +6,11 @@
 
 #include <cstdint>
 #include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
 
 //
 // A header-only utility for determining and changing endianness of data.
@@ -13,6 +18,87 @@
 class EndianHelper
 {
 public:
+	//
+	// Host byte order, known at compile time on GCC/Clang.
+	// Other compilers fall back to the runtime check in IsBigEndian(), which they fold to a constant anyway.
+	//
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__)
+	static constexpr bool IS_BIG_ENDIAN = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+#else
+	static constexpr bool IS_BIG_ENDIAN = false;
+#endif
+
+	//
+	// Reverses the bytes of an integral value, using the compiler's bswap intrinsics where available.
+	//
+	template<class T>
+	static T ByteSwap(const T val) noexcept
+	{
+		static_assert(std::is_integral<T>::value, "ByteSwap requires an integral type");
+
+		if constexpr (sizeof(T) == 1)
+		{
+			return val;
+		}
+		else if constexpr (sizeof(T) == 2)
+		{
+#if defined(_MSC_VER)
+			return (T)_byteswap_ushort((uint16_t)val);
+#else
+			return (T)__builtin_bswap16((uint16_t)val);
+#endif
+		}
+		else if constexpr (sizeof(T) == 4)
+		{
+#if defined(_MSC_VER)
+			return (T)_byteswap_ulong((uint32_t)val);
+#else
+			return (T)__builtin_bswap32((uint32_t)val);
+#endif
+		}
+		else
+		{
+			static_assert(sizeof(T) == 8, "ByteSwap supports 1, 2, 4 and 8 byte integers");
+#if defined(_MSC_VER)
+			return (T)_byteswap_uint64((uint64_t)val);
+#else
+			return (T)__builtin_bswap64((uint64_t)val);
+#endif
+		}
+	}
+
+	//
+	// Converts between host order and big endian (network) order. The conversion is its own inverse.
+	//
+	template<class T>
+	static T ToBigEndian(const T val) noexcept
+	{
+		if constexpr (IS_BIG_ENDIAN)
+		{
+			return val;
+		}
+		else
+		{
+			return IsBigEndian() ? val : ByteSwap(val);
+		}
+	}
+
+	//
+	// Converts between host order and little endian order. The conversion is its own inverse.
+	//
+	template<class T>
+	static T ToLittleEndian(const T val) noexcept
+	{
+		if constexpr (IS_BIG_ENDIAN)
+		{
+			return ByteSwap(val);
+		}
+		else
+		{
+			return IsBigEndian() ? ByteSwap(val) : val;
+		}
+	}
+
 	static bool IsBigEndian() noexcept
 	{
 		union 
@@ -1,14 +1,18 @@
 #pragma once
 
+#include <Common/AllocProfiler.h>
 #include <Common/Secure.h>
 #include <Core/Serialization/EndianHelper.h>
 #include <Core/Enums/ProtocolVersion.h>
 #include <Crypto/BigInteger.h>
 
 #include <cstdint>
+#include <memory_resource>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstring>
+#include <type_traits>
 
 enum class ESerializeLength
 {
@@ -25,44 +29,45 @@ public:
 	Serializer(const size_t expectedSize, const EProtocolVersion protocolVersion = EProtocolVersion::V1)
 		: m_protocolVersion(protocolVersion)
 	{
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
 		m_serialized.reserve(expectedSize);
 	}
 
 	template <class T>
 	void Append(const T& t)
 	{
-		std::vector<uint8_t> temp(sizeof(T));
-		memcpy(&temp[0], &t, sizeof(T));
-
-		if (EndianHelper::IsBigEndian())
+		if constexpr (std::is_integral<T>::value || std::is_enum<T>::value)
 		{
-			m_serialized.insert(m_serialized.end(), temp.cbegin(), temp.cend());
+			AppendRaw(EndianHelper::ToBigEndian(ToIntegral(t)));
 		}
 		else
 		{
-			m_serialized.insert(m_serialized.end(), temp.crbegin(), temp.crend());
+			// Other trivially copyable types (eg. std::array) have always been written as one big endian value.
+			static_assert(std::is_trivially_copyable<T>::value, "Append requires a trivially copyable type");
+
+			const size_t offset = m_serialized.size();
+			ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
+			m_serialized.resize(offset + sizeof(T));
+			memcpy(m_serialized.data() + offset, &t, sizeof(T));
+			if (!EndianHelper::IsBigEndian())
+			{
+				std::reverse(m_serialized.begin() + offset, m_serialized.end());
+			}
 		}
 	}
 	template <class T>
 	void AppendLittleEndian(const T& t)
 	{
-		std::vector<uint8_t> temp(sizeof(T));
-		memcpy(&temp[0], &t, sizeof(T));
+		static_assert(std::is_integral<T>::value || std::is_enum<T>::value, "AppendLittleEndian requires an integral type");
 
-		if (EndianHelper::IsBigEndian())
-		{
-			m_serialized.insert(m_serialized.end(), temp.crbegin(), temp.crend());
-		}
-		else
-		{
-			m_serialized.insert(m_serialized.end(), temp.cbegin(), temp.cend());
-		}
+		AppendRaw(EndianHelper::ToLittleEndian(ToIntegral(t)));
 	}
 
 	void AppendBytes(const std::vector<uint8_t>& vectorToAppend, const ESerializeLength prepend_length = ESerializeLength::NONE)
 	{
 		AppendLength(prepend_length, vectorToAppend.size());
 
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
 		m_serialized.insert(m_serialized.end(), vectorToAppend.cbegin(), vectorToAppend.cend());
 	}
 
@@ -70,6 +75,7 @@ public:
 	{
 		AppendLength(prepend_length, vectorToAppend.size());
 
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
 		m_serialized.insert(m_serialized.end(), vectorToAppend.cbegin(), vectorToAppend.cend());
 	}
 
@@ -77,6 +83,15 @@ public:
 	{
 		AppendLength(prepend_length, vectorToAppend.size());
 
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
+		m_serialized.insert(m_serialized.end(), vectorToAppend.cbegin(), vectorToAppend.cend());
+	}
+
+	void AppendByteVector(const std::pmr::vector<uint8_t>& vectorToAppend, const ESerializeLength prepend_length = ESerializeLength::NONE)
+	{
+		AppendLength(prepend_length, vectorToAppend.size());
+
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
 		m_serialized.insert(m_serialized.end(), vectorToAppend.cbegin(), vectorToAppend.cend());
 	}
 
@@ -84,6 +99,7 @@ public:
 	{
 		AppendLength(ESerializeLength::U64, varString.length());
 
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
 		m_serialized.insert(m_serialized.end(), varString.cbegin(), varString.cend());
 	}
 
@@ -91,6 +107,7 @@ public:
 	{
 		AppendLength(prepend_length, str.length());
 
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
 		m_serialized.insert(m_serialized.end(), str.cbegin(), str.cend());
 	}
 
@@ -99,6 +116,7 @@ public:
 	{
 		const std::vector<uint8_t>& data = bigInteger.GetData();
 		//std::reverse(data.begin(), data.end());
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
 		m_serialized.insert(m_serialized.end(), data.cbegin(), data.cend());
 	}
 
@@ -119,6 +137,29 @@ public:
 	}
 
 private:
+	template<class T>
+	static auto ToIntegral(const T& t) noexcept
+	{
+		if constexpr (std::is_enum<T>::value)
+		{
+			return static_cast<std::underlying_type_t<T>>(t);
+		}
+		else
+		{
+			return t;
+		}
+	}
+
+	// Appends the bytes of an already byte-ordered integer, without allocating a temporary.
+	template<class T>
+	void AppendRaw(const T value)
+	{
+		const size_t offset = m_serialized.size();
+		ScopedAllocTag allocTag(EAllocTag::SERIALIZER);
+		m_serialized.resize(offset + sizeof(T));
+		memcpy(m_serialized.data() + offset, &value, sizeof(T));
+	}
+
 	void AppendLength(const ESerializeLength prepend_length, const size_t length)
 	{
 		if (prepend_length == ESerializeLength::U64) {
@@ -0,0 +1,214 @@
+#pragma once
+
+#include <Core/Traits/LockStats.h>
+#include <Common/Logger.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//
+// How one call site has used a profiled lock.
+// holdBuckets uses the same power-of-two microsecond buckets as LockWaitHistogram.
+//
+struct LockSiteStats
+{
+	std::string callSite;
+	uint64_t numReads;
+	uint64_t numWrites;
+	uint64_t totalWaitMicros;
+	uint64_t maxWaitMicros;
+	uint64_t totalHoldMicros;
+	uint64_t maxHoldMicros;
+
+	// Threads already waiting for the lock when this call site asked for it, summed over every acquisition.
+	uint64_t totalWaitersAhead;
+	uint64_t maxWaitersAhead;
+
+	std::array<uint64_t, LockWaitHistogram::NUM_BUCKETS> holdBuckets;
+};
+
+//
+// Opt-in instrumentation for a single Locked<> instance, recording wait times, hold times and waiter counts per call site.
+// Every record takes an internal mutex, so this is meant for diagnosing contention, not for running permanently on every lock.
+// When a report interval is given, a summary is logged at most once per interval, by whichever thread releases the lock first after it elapses.
+//
+class LockProfiler
+{
+public:
+	using Ptr = std::shared_ptr<LockProfiler>;
+
+	LockProfiler(const std::string& name, const std::chrono::seconds& reportInterval)
+		: m_name(name),
+		m_reportInterval(reportInterval),
+		m_numWaiting(0),
+		m_nextReport(std::chrono::steady_clock::now() + reportInterval)
+	{
+
+	}
+
+	const std::string& GetName() const noexcept { return m_name; }
+
+	//
+	// Returns the number of threads already waiting for the lock.
+	//
+	size_t BeginWait() noexcept { return m_numWaiting++; }
+
+	void EndWait(const char* callSite, const bool exclusive, const size_t waitersAhead, const std::chrono::steady_clock::duration& waited)
+	{
+		--m_numWaiting;
+
+		const uint64_t micros = ToMicros(waited);
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		LockSiteStats& stats = GetSite(callSite);
+		++(exclusive ? stats.numWrites : stats.numReads);
+		stats.totalWaitMicros += micros;
+		stats.maxWaitMicros = (std::max)(stats.maxWaitMicros, micros);
+		stats.totalWaitersAhead += waitersAhead;
+		stats.maxWaitersAhead = (std::max)(stats.maxWaitersAhead, (uint64_t)waitersAhead);
+	}
+
+	void RecordHold(const char* callSite, const std::chrono::steady_clock::duration& held)
+	{
+		const uint64_t micros = ToMicros(held);
+
+		size_t bucket = 0;
+		while (bucket < LockWaitHistogram::NUM_BUCKETS - 1 && (micros >> bucket) != 0)
+		{
+			++bucket;
+		}
+
+		bool report = false;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			LockSiteStats& stats = GetSite(callSite);
+			stats.totalHoldMicros += micros;
+			stats.maxHoldMicros = (std::max)(stats.maxHoldMicros, micros);
+			++stats.holdBuckets[bucket];
+
+			const auto now = std::chrono::steady_clock::now();
+			if (m_reportInterval.count() > 0 && now >= m_nextReport)
+			{
+				m_nextReport = now + m_reportInterval;
+				report = true;
+			}
+		}
+
+		if (report)
+		{
+			LogSummary();
+		}
+	}
+
+	//
+	// Returns the stats of every call site, the longest total hold time first.
+	//
+	std::vector<LockSiteStats> GetSiteStats() const
+	{
+		std::vector<LockSiteStats> sites;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			for (const auto& site : m_sites)
+			{
+				sites.push_back(site.second);
+			}
+		}
+
+		std::sort(
+			sites.begin(),
+			sites.end(),
+			[](const LockSiteStats& a, const LockSiteStats& b) { return a.totalHoldMicros > b.totalHoldMicros; }
+		);
+		return sites;
+	}
+
+	void LogSummary() const
+	{
+		for (const LockSiteStats& site : GetSiteStats())
+		{
+			const uint64_t acquisitions = (std::max)((uint64_t)1, site.numReads + site.numWrites);
+			LOG_INFO_F(
+				"{} lock at {}: {} reads, {} writes, hold avg {}us max {}us, wait avg {}us max {}us, waiters ahead avg {} max {}",
+				m_name,
+				site.callSite,
+				site.numReads,
+				site.numWrites,
+				site.totalHoldMicros / acquisitions,
+				site.maxHoldMicros,
+				site.totalWaitMicros / acquisitions,
+				site.maxWaitMicros,
+				site.totalWaitersAhead / acquisitions,
+				site.maxWaitersAhead
+			);
+		}
+	}
+
+private:
+	static uint64_t ToMicros(const std::chrono::steady_clock::duration& duration)
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+	}
+
+	LockSiteStats& GetSite(const char* callSite)
+	{
+		auto iter = m_sites.find(callSite);
+		if (iter == m_sites.end())
+		{
+			LockSiteStats stats{ callSite, 0, 0, 0, 0, 0, 0, 0, 0, {} };
+			iter = m_sites.emplace(callSite, std::move(stats)).first;
+		}
+
+		return iter->second;
+	}
+
+	std::string m_name;
+	std::chrono::seconds m_reportInterval;
+	std::atomic_size_t m_numWaiting;
+
+	mutable std::mutex m_mutex;
+	std::chrono::steady_clock::time_point m_nextReport;
+	std::map<std::string, LockSiteStats> m_sites;
+};
+
+//
+// Reports how long a lock was held to its LockProfiler when destroyed. Empty (and free) when profiling is disabled.
+//
+class LockHoldTimer
+{
+public:
+	LockHoldTimer() = default;
+	LockHoldTimer(const LockProfiler::Ptr& pProfiler, const char* callSite)
+		: m_pProfiler(pProfiler), m_callSite(callSite), m_acquired(std::chrono::steady_clock::now()) { }
+
+	LockHoldTimer(LockHoldTimer&& other) noexcept = default;
+	LockHoldTimer(const LockHoldTimer&) = delete;
+	LockHoldTimer& operator=(const LockHoldTimer&) = delete;
+	LockHoldTimer& operator=(LockHoldTimer&&) = delete;
+
+	~LockHoldTimer()
+	{
+		if (m_pProfiler != nullptr)
+		{
+			try
+			{
+				m_pProfiler->RecordHold(m_callSite, std::chrono::steady_clock::now() - m_acquired);
+			}
+			catch (std::exception&)
+			{
+				// Profiling must never affect the lock itself.
+			}
+		}
+	}
+
+private:
+	LockProfiler::Ptr m_pProfiler;
+	const char* m_callSite = nullptr;
+	std::chrono::steady_clock::time_point m_acquired;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <shared_mutex>
+
+//
+// Point-in-time copy of a LockStats.
+// Bucket 0 counts acquisitions that waited less than 1us (including every uncontended one),
+// and bucket i counts waits in [2^(i-1), 2^i) microseconds. The last bucket also counts everything longer.
+//
+struct LockWaitHistogram
+{
+	static constexpr size_t NUM_BUCKETS = 20;
+
+	std::array<uint64_t, NUM_BUCKETS> buckets;
+	uint64_t numReads;
+	uint64_t numWrites;
+	uint64_t numContended;
+	uint64_t totalWaitMicros;
+};
+
+//
+// Counts how long callers waited to acquire a lock.
+// Uncontended acquisitions are detected with a try_lock first, so they don't pay for reading the clock.
+//
+class LockStats
+{
+public:
+	LockStats()
+		: m_numReads(0), m_numWrites(0), m_numContended(0), m_totalWaitMicros(0)
+	{
+		for (std::atomic_uint64_t& bucket : m_buckets)
+		{
+			bucket = 0;
+		}
+	}
+
+	void LockShared(std::shared_mutex& mutex)
+	{
+		++m_numReads;
+		if (!mutex.try_lock_shared())
+		{
+			const auto start = std::chrono::steady_clock::now();
+			mutex.lock_shared();
+			RecordWait(std::chrono::steady_clock::now() - start);
+		}
+		else
+		{
+			++m_buckets[0];
+		}
+	}
+
+	void Lock(std::shared_mutex& mutex)
+	{
+		++m_numWrites;
+		if (!mutex.try_lock())
+		{
+			const auto start = std::chrono::steady_clock::now();
+			mutex.lock();
+			RecordWait(std::chrono::steady_clock::now() - start);
+		}
+		else
+		{
+			++m_buckets[0];
+		}
+	}
+
+	LockWaitHistogram GetHistogram() const
+	{
+		LockWaitHistogram histogram;
+		for (size_t i = 0; i < LockWaitHistogram::NUM_BUCKETS; i++)
+		{
+			histogram.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+		}
+
+		histogram.numReads = m_numReads.load(std::memory_order_relaxed);
+		histogram.numWrites = m_numWrites.load(std::memory_order_relaxed);
+		histogram.numContended = m_numContended.load(std::memory_order_relaxed);
+		histogram.totalWaitMicros = m_totalWaitMicros.load(std::memory_order_relaxed);
+		return histogram;
+	}
+
+private:
+	void RecordWait(const std::chrono::steady_clock::duration& waited)
+	{
+		const uint64_t micros = (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(waited).count();
+
+		size_t bucket = 0;
+		while (bucket < LockWaitHistogram::NUM_BUCKETS - 1 && (micros >> bucket) != 0)
+		{
+			++bucket;
+		}
+
+		++m_buckets[bucket];
+		++m_numContended;
+		m_totalWaitMicros += micros;
+	}
+
+	std::array<std::atomic_uint64_t, LockWaitHistogram::NUM_BUCKETS> m_buckets;
+	std::atomic_uint64_t m_numReads;
+	std::atomic_uint64_t m_numWrites;
+	std::atomic_uint64_t m_numContended;
+	std::atomic_uint64_t m_totalWaitMicros;
+};
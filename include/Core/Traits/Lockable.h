@@ -2,10 +2,105 @@
 
 #include <Common/Exceptions/UnimplementedException.h>
 #include <Core/Traits/Batchable.h>
+#include <Core/Traits/LockStats.h>
+#include <Core/Traits/LockProfiler.h>
 #include <memory>
 #include <shared_mutex>
 #include <mutex>
 #include <tuple>
+#include <type_traits>
+
+//
+// The IBatchable notifications sent to the locked object when a write begins and ends.
+// Objects that aren't IBatchable are left alone.
+//
+template<class U>
+class WriteHooks
+{
+public:
+	static void OnInitWrite(U* pObject)
+	{
+		Traits::IBatchable* pBatchable = GetBatchable(pObject);
+		if (pBatchable != nullptr)
+		{
+			pBatchable->SetDirty(true);
+			pBatchable->OnInitWrite();
+		}
+	}
+
+	static void Commit(U* pObject)
+	{
+		Traits::IBatchable* pBatchable = GetBatchable(pObject);
+		if (pBatchable != nullptr)
+		{
+			if (pBatchable->IsDirty())
+			{
+				pBatchable->Commit();
+				pBatchable->SetDirty(false);
+			}
+		}
+	}
+
+	static void Rollback(U* pObject) noexcept
+	{
+		Traits::IBatchable* pBatchable = GetBatchable(pObject);
+		if (pBatchable != nullptr)
+		{
+			if (pBatchable->IsDirty())
+			{
+				pBatchable->Rollback();
+				pBatchable->SetDirty(false);
+			}
+		}
+	}
+
+	static void OnEndWrite(U* pObject)
+	{
+		Traits::IBatchable* pBatchable = GetBatchable(pObject);
+		if (pBatchable != nullptr)
+		{
+			pBatchable->OnEndWrite();
+		}
+	}
+
+	//
+	// Rolls back (batched) or commits the write, then notifies the object that it ended.
+	// Exceptions are swallowed, since this runs from destructors.
+	//
+	static void EndWrite(U* pObject, const bool batched) noexcept
+	{
+		try
+		{
+			if (batched)
+			{
+				Rollback(pObject);
+			}
+			else
+			{
+				Commit(pObject);
+			}
+
+			OnEndWrite(pObject);
+		}
+		catch (std::exception&)
+		{
+			// TODO: Handle
+		}
+	}
+
+private:
+	static Traits::IBatchable* GetBatchable(U* pObject)
+	{
+		if constexpr (std::is_polymorphic_v<U>)
+		{
+			return dynamic_cast<Traits::IBatchable*>(pObject);
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
+};
 
 template<class T>
 class Reader
@@ -14,8 +109,8 @@ class Reader
 	class InnerReader
 	{
 	public:
-		InnerReader(std::shared_ptr<const U> pObject, std::shared_ptr<std::shared_mutex> pMutex, const bool lock, const bool unlock)
-			: m_pObject(pObject), m_pMutex(pMutex), m_unlock(unlock)
+		InnerReader(std::shared_ptr<const U> pObject, std::shared_ptr<std::shared_mutex> pMutex, const bool lock, const bool unlock, LockHoldTimer&& timer)
+			: m_pObject(pObject), m_pMutex(pMutex), m_unlock(unlock), m_timer(std::move(timer))
 		{
 			if (lock)
 			{
@@ -34,12 +129,13 @@ class Reader
 		std::shared_ptr<const U> m_pObject;
 		std::shared_ptr<std::shared_mutex> m_pMutex;
 		bool m_unlock;
+		LockHoldTimer m_timer;
 	};
 
 public:
-	static Reader Create(std::shared_ptr<T> pObject, std::shared_ptr<std::shared_mutex> pMutex, const bool lock, const bool unlock)
+	static Reader Create(std::shared_ptr<T> pObject, std::shared_ptr<std::shared_mutex> pMutex, const bool lock, const bool unlock, LockHoldTimer&& timer = LockHoldTimer())
 	{
-		return Reader(std::make_shared<InnerReader<T>>(pObject, pMutex, lock, unlock));
+		return Reader(std::make_shared<InnerReader<T>>(pObject, pMutex, lock, unlock, std::move(timer)));
 	}
 
 	Reader() = default;
@@ -100,107 +196,34 @@ class Writer : public Reader<T>
 	class InnerWriter
 	{
 	public:
-		InnerWriter(const bool batched, std::shared_ptr<U> pObject, std::shared_ptr<std::shared_mutex> pMutex, const bool lock)
-			: m_batched(batched), m_pObject(pObject), m_pMutex(pMutex)
+		InnerWriter(const bool batched, std::shared_ptr<U> pObject, std::shared_ptr<std::shared_mutex> pMutex, const bool lock, LockHoldTimer&& timer)
+			: m_batched(batched), m_pObject(pObject), m_pMutex(pMutex), m_timer(std::move(timer))
 		{
 			if (lock)
 			{
 				m_pMutex->lock();
 			}
 
-			OnInitWrite();
+			WriteHooks<U>::OnInitWrite(m_pObject.get());
 		}
 
 		~InnerWriter()
 		{
-			try
-			{
-				// Using MutexUnlocker in case exception is thrown.
-				MutexUnlocker unlocker(m_pMutex);
-				if (m_batched)
-				{
-					Rollback();
-				}
-				else
-				{
-					Commit();
-				}
-
-				OnEndWrite();
-			}
-			catch (std::exception&)
-			{
-				// TODO: Handle
-			}
-		}
-
-		void Commit()
-		{
-			Traits::IBatchable* pBatchable = GetBatchable(m_pObject);
-			if (pBatchable != nullptr)
-			{
-				if (pBatchable->IsDirty())
-				{
-					pBatchable->Commit();
-					pBatchable->SetDirty(false);
-				}
-			}
-		}
-
-		void Rollback() noexcept
-		{
-			Traits::IBatchable* pBatchable = GetBatchable(m_pObject);
-			if (pBatchable != nullptr)
-			{
-				if (pBatchable->IsDirty())
-				{
-					pBatchable->Rollback();
-					pBatchable->SetDirty(false);
-				}
-			}
-		}
-
-		void OnInitWrite()
-		{
-			Traits::IBatchable* pBatchable = GetBatchable(m_pObject);
-			if (pBatchable != nullptr)
-			{
-				pBatchable->SetDirty(true);
-				pBatchable->OnInitWrite();
-			}
-		}
-
-		void OnEndWrite()
-		{
-			Traits::IBatchable* pBatchable = GetBatchable(m_pObject);
-			if (pBatchable != nullptr)
-			{
-				pBatchable->OnEndWrite();
-			}
+			// Using MutexUnlocker in case exception is thrown.
+			MutexUnlocker unlocker(m_pMutex);
+			WriteHooks<U>::EndWrite(m_pObject.get(), m_batched);
 		}
 
 		bool m_batched;
 		std::shared_ptr<U> m_pObject;
 		std::shared_ptr<std::shared_mutex> m_pMutex;
-
-	private:
-		template<typename V = void, typename std::enable_if_t<std::is_polymorphic_v<U>, V>* = nullptr>
-		Traits::IBatchable* GetBatchable(const std::shared_ptr<U>& pObject) const
-		{
-			return dynamic_cast<Traits::IBatchable*>(pObject.get());
-		}
-
-		template<typename V = void, typename std::enable_if_t<!std::is_polymorphic_v<U>, V>* = nullptr>
-		Traits::IBatchable* GetBatchable(const std::shared_ptr<U>&) const
-		{
-			return nullptr;
-		}
+		LockHoldTimer m_timer;
 	};
 
 public:
-	static Writer Create(const bool batched, const std::shared_ptr<T>& pObject, const std::shared_ptr<std::shared_mutex>& pMutex, const bool lock)
+	static Writer Create(const bool batched, const std::shared_ptr<T>& pObject, const std::shared_ptr<std::shared_mutex>& pMutex, const bool lock, LockHoldTimer&& timer = LockHoldTimer())
 	{
-		return Writer(std::shared_ptr<InnerWriter<T>>(new InnerWriter<T>(batched, pObject, pMutex, lock)));
+		return Writer(std::shared_ptr<InnerWriter<T>>(new InnerWriter<T>(batched, pObject, pMutex, lock, std::move(timer))));
 	}
 
 	Writer() = default;
@@ -256,6 +279,100 @@ private:
 	std::shared_ptr<InnerWriter<T>> m_pWriter;
 };
 
+//
+// Move-only, stack-based alternatives to Reader<> and Writer<>, returned by Locked<>::ScopedRead/ScopedWrite/ScopedBatchWrite.
+// They hold plain pointers to the Locked<> object's state, so acquiring one never allocates,
+// but they must not outlive the Locked<> they came from, and can't be stored or shared.
+//
+template<class T>
+class ScopedReader
+{
+public:
+	// Adopts the shared lock already held on pMutex.
+	ScopedReader(const T* pObject, std::shared_mutex* pMutex, LockHoldTimer&& timer)
+		: m_pObject(pObject), m_pMutex(pMutex), m_timer(std::move(timer)) { }
+
+	ScopedReader(ScopedReader&& other) noexcept
+		: m_pObject(other.m_pObject), m_pMutex(other.m_pMutex), m_timer(std::move(other.m_timer))
+	{
+		other.m_pMutex = nullptr;
+	}
+
+	ScopedReader(const ScopedReader&) = delete;
+	ScopedReader& operator=(const ScopedReader&) = delete;
+	ScopedReader& operator=(ScopedReader&&) = delete;
+
+	~ScopedReader()
+	{
+		if (m_pMutex != nullptr)
+		{
+			m_pMutex->unlock_shared();
+		}
+	}
+
+	const T* operator->() const noexcept { return m_pObject; }
+	const T& operator*() const noexcept { return *m_pObject; }
+
+private:
+	const T* m_pObject;
+	std::shared_mutex* m_pMutex;
+	LockHoldTimer m_timer;
+};
+
+//
+// Commits (or for batched writes, rolls back anything not yet committed) when it goes out of scope,
+// exactly like Writer<>.
+//
+template<class T>
+class ScopedWriter
+{
+public:
+	// Adopts the exclusive lock already held on pMutex.
+	ScopedWriter(const bool batched, T* pObject, std::shared_mutex* pMutex, LockHoldTimer&& timer)
+		: m_batched(batched), m_pObject(pObject), m_pMutex(pMutex), m_timer(std::move(timer))
+	{
+		try
+		{
+			WriteHooks<T>::OnInitWrite(m_pObject);
+		}
+		catch (...)
+		{
+			m_pMutex->unlock();
+			throw;
+		}
+	}
+
+	ScopedWriter(ScopedWriter&& other) noexcept
+		: m_batched(other.m_batched), m_pObject(other.m_pObject), m_pMutex(other.m_pMutex), m_timer(std::move(other.m_timer))
+	{
+		other.m_pMutex = nullptr;
+	}
+
+	ScopedWriter(const ScopedWriter&) = delete;
+	ScopedWriter& operator=(const ScopedWriter&) = delete;
+	ScopedWriter& operator=(ScopedWriter&&) = delete;
+
+	~ScopedWriter()
+	{
+		if (m_pMutex != nullptr)
+		{
+			WriteHooks<T>::EndWrite(m_pObject, m_batched);
+			m_pMutex->unlock();
+		}
+	}
+
+	T* operator->() noexcept { return m_pObject; }
+	const T* operator->() const noexcept { return m_pObject; }
+	T& operator*() noexcept { return *m_pObject; }
+	const T& operator*() const noexcept { return *m_pObject; }
+
+private:
+	bool m_batched;
+	T* m_pObject;
+	std::shared_mutex* m_pMutex;
+	LockHoldTimer m_timer;
+};
+
 template<class T>
 class Locked
 {
@@ -263,14 +380,18 @@ class Locked
 
 public:
 	Locked(const std::shared_ptr<T>& pObject)
-		: m_pObject(pObject), m_pMutex(std::make_shared<std::shared_mutex>())
+		: m_pObject(pObject), m_pMutex(std::make_shared<std::shared_mutex>()), m_pStats(std::make_shared<LockStats>())
 	{
 
 	}
 
-	Reader<T> Read() const
+	//
+	// callSite defaults to the name of the calling function, and is only used when a LockProfiler is attached.
+	//
+	Reader<T> Read(const char* callSite = __builtin_FUNCTION()) const
 	{
-		return Reader<T>::Create(m_pObject, m_pMutex, true, true);
+		LockHoldTimer timer = Acquire(false, callSite);
+		return Reader<T>::Create(m_pObject, m_pMutex, false, true, std::move(timer));
 	}
 
 	Reader<T> Read(std::adopt_lock_t) const
@@ -278,9 +399,10 @@ public:
 		return Reader<T>::Create(m_pObject, m_pMutex, false, true);
 	}
 
-	Writer<T> Write()
+	Writer<T> Write(const char* callSite = __builtin_FUNCTION())
 	{
-		return Writer<T>::Create(false, m_pObject, m_pMutex, true);
+		LockHoldTimer timer = Acquire(true, callSite);
+		return Writer<T>::Create(false, m_pObject, m_pMutex, false, std::move(timer));
 	}
 
 	Writer<T> Write(std::adopt_lock_t)
@@ -288,7 +410,7 @@ public:
 		return Writer<T>::Create(false, m_pObject, m_pMutex, false);
 	}
 
-	Writer<T> BatchWrite()
+	Writer<T> BatchWrite(const char* callSite = __builtin_FUNCTION())
 	{
 		Traits::IBatchable* pBatchable = dynamic_cast<Traits::IBatchable*>(m_pObject.get());
 		if (pBatchable == nullptr)
@@ -296,7 +418,8 @@ public:
 			throw UNIMPLEMENTED_EXCEPTION;
 		}
 
-		return Writer<T>::Create(true, m_pObject, m_pMutex, true);
+		LockHoldTimer timer = Acquire(true, callSite);
+		return Writer<T>::Create(true, m_pObject, m_pMutex, false, std::move(timer));
 	}
 
 	Writer<T> BatchWrite(std::adopt_lock_t)
@@ -310,9 +433,74 @@ public:
 		return Writer<T>::Create(true, m_pObject, m_pMutex, false);
 	}
 
+	//
+	// Allocation-free versions of Read/Write/BatchWrite, for short-lived locks taken at high rates.
+	//
+	ScopedReader<T> ScopedRead(const char* callSite = __builtin_FUNCTION()) const
+	{
+		return ScopedReader<T>(m_pObject.get(), m_pMutex.get(), Acquire(false, callSite));
+	}
+
+	ScopedWriter<T> ScopedWrite(const char* callSite = __builtin_FUNCTION())
+	{
+		return ScopedWriter<T>(false, m_pObject.get(), m_pMutex.get(), Acquire(true, callSite));
+	}
+
+	ScopedWriter<T> ScopedBatchWrite(const char* callSite = __builtin_FUNCTION())
+	{
+		Traits::IBatchable* pBatchable = dynamic_cast<Traits::IBatchable*>(m_pObject.get());
+		if (pBatchable == nullptr)
+		{
+			throw UNIMPLEMENTED_EXCEPTION;
+		}
+
+		return ScopedWriter<T>(true, m_pObject.get(), m_pMutex.get(), Acquire(true, callSite));
+	}
+
+	//
+	// How long Read/Write/BatchWrite (and their scoped versions) waited for the lock.
+	// Locks taken through MultiLocker aren't counted.
+	//
+	LockWaitHistogram GetWaitHistogram() const
+	{
+		return m_pStats->GetHistogram();
+	}
+
+	//
+	// Attaches a profiler that records hold times and waiters per call site. Not thread safe, so it must be set
+	// before the Locked<> is shared. Copies of this Locked<> (eg. made by MultiLocker) share the profiler.
+	//
+	void SetProfiler(const LockProfiler::Ptr& pProfiler) { m_pProfiler = pProfiler; }
+	const LockProfiler::Ptr& GetProfiler() const noexcept { return m_pProfiler; }
+
 private:
+	LockHoldTimer Acquire(const bool exclusive, const char* callSite) const
+	{
+		if (m_pProfiler == nullptr)
+		{
+			exclusive ? m_pStats->Lock(*m_pMutex) : m_pStats->LockShared(*m_pMutex);
+			return LockHoldTimer();
+		}
+
+		const size_t waitersAhead = m_pProfiler->BeginWait();
+		const auto start = std::chrono::steady_clock::now();
+		exclusive ? m_pStats->Lock(*m_pMutex) : m_pStats->LockShared(*m_pMutex);
+		try
+		{
+			m_pProfiler->EndWait(callSite, exclusive, waitersAhead, std::chrono::steady_clock::now() - start);
+		}
+		catch (std::exception&)
+		{
+			// Profiling must never affect the lock itself.
+		}
+
+		return LockHoldTimer(m_pProfiler, callSite);
+	}
+
 	std::shared_ptr<T> m_pObject;
 	std::shared_ptr<std::shared_mutex> m_pMutex;
+	std::shared_ptr<LockStats> m_pStats;
+	LockProfiler::Ptr m_pProfiler;
 };
 
 //
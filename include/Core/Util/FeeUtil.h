@@ -33,7 +33,18 @@ public:
 		return feeBase * CalculateTxWeight(numInputs, numOutputs, numKernels);
 	}
 
-private:
+	//
+	// The weight fees are charged on, which favors txs that reduce the UTXO set.
+	//
+	static uint64_t CalculateTxWeight(const Transaction& transaction)
+	{
+		return CalculateTxWeight(
+			(int64_t)transaction.GetInputs().size(),
+			(int64_t)transaction.GetOutputs().size(),
+			(int64_t)transaction.GetKernels().size()
+		);
+	}
+
 	static uint64_t CalculateTxWeight(const int64_t numInputs, const int64_t numOutputs, const int64_t numKernels)
 	{
 		return (std::max)((-1 * numInputs) + (4 * numOutputs) + (1 * numKernels), (int64_t)1);
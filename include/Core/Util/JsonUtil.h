@@ -9,6 +9,7 @@
 #include <Core/Exceptions/DeserializationException.h>
 #include <Common/Logger.h>
 #include <json/json.h>
+#include <memory>
 #include <sstream>
 #include <optional>
 #include <vector>
@@ -19,12 +20,8 @@ public:
 	static Json::Value Parse(const std::vector<unsigned char>& bytes)
 	{
 		Json::Value json;
-		std::string errors;
-
-		std::string str((const char*)bytes.data(), bytes.size());
-		std::stringstream ss(str);
-		const bool jsonParsed = Json::parseFromStream(Json::CharReaderBuilder(), ss, &json, &errors);
-		if (!jsonParsed)
+		const char* pBegin = (const char*)bytes.data();
+		if (!Parse(pBegin, pBegin + bytes.size(), json))
 		{
 			LOG_ERROR("Failed to parse json");
 			throw DESERIALIZATION_EXCEPTION("Failed to parse json");
@@ -282,7 +279,7 @@ public:
 	//
 	static Json::Value ConvertToJSON(const RangeProof& rangeProof)
 	{
-		return ConvertToJSON(rangeProof.GetProofBytes());
+		return Json::Value(rangeProof.ToHex());
 	}
 
 	static RangeProof ConvertToRangeProof(const Json::Value& rangeProofJSON)
@@ -490,10 +487,16 @@ public:
 
 	// Parse
 	static bool Parse(const std::string& input, Json::Value& outputJSON)
+	{
+		return Parse(input.data(), input.data() + input.size(), outputJSON);
+	}
+
+	// Parses directly from the buffer, without copying it into a stream first.
+	static bool Parse(const char* pBegin, const char* pEnd, Json::Value& outputJSON)
 	{
 		std::string errors;
-		std::istringstream inputStream(input);
-		return Json::parseFromStream(Json::CharReaderBuilder(), inputStream, &outputJSON, &errors);
+		std::unique_ptr<Json::CharReader> pReader(Json::CharReaderBuilder().newCharReader());
+		return pReader->parse(pBegin, pEnd, &outputJSON, &errors);
 	}
 
 	// Write
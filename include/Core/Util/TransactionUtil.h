@@ -2,55 +2,53 @@
 
 #include <Core/Models/Transaction.h>
 #include <Crypto/Crypto.h>
+#include <algorithm>
 #include <cassert>
-#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 class TransactionUtil
 {
 public:
+	//
+	// Removes every input that spends one of the outputs, along with the output it spends.
+	// The remaining inputs and outputs keep their order.
+	//
 	static void PerformCutThrough(std::vector<TransactionInput>& inputs, std::vector<TransactionOutput>& outputs)
 	{
-		std::set<Commitment> inputCommitments;
+		std::unordered_set<Commitment> inputCommitments;
+		inputCommitments.reserve(inputs.size());
 		for (const TransactionInput& input : inputs)
 		{
 			inputCommitments.insert(input.GetCommitment());
 		}
 
-		std::set<Commitment> outputCommitments;
+		std::unordered_set<Commitment> outputCommitments;
+		outputCommitments.reserve(outputs.size());
 		for (const TransactionOutput& output : outputs)
 		{
 			outputCommitments.insert(output.GetCommitment());
 		}
 
-		auto inputIter = inputs.begin();
-		while (inputIter != inputs.end())
-		{
-			if (outputCommitments.find(inputIter->GetCommitment()) != outputCommitments.end())
-			{
-				inputIter = inputs.erase(inputIter);
-			}
-			else
-			{
-				++inputIter;
-			}
-		}
-
-		auto outputIter = outputs.begin();
-		while (outputIter != outputs.end())
-		{
-			if (inputCommitments.find(outputIter->GetCommitment()) != inputCommitments.end())
-			{
-				outputIter = outputs.erase(outputIter);
-			}
-			else
-			{
-				++outputIter;
-			}
-		}
+		inputs.erase(
+			std::remove_if(inputs.begin(), inputs.end(), [&outputCommitments](const TransactionInput& input) {
+				return outputCommitments.find(input.GetCommitment()) != outputCommitments.end();
+			}),
+			inputs.end()
+		);
+
+		outputs.erase(
+			std::remove_if(outputs.begin(), outputs.end(), [&inputCommitments](const TransactionOutput& output) {
+				return inputCommitments.find(output.GetCommitment()) != inputCommitments.end();
+			}),
+			outputs.end()
+		);
 	}
 
 	//
 	// Aggregates multiple transactions into 1.
+	// Each tx's inputs, outputs and kernels are already sorted, so they're merged rather than concatenated and re-sorted.
 	//
 	// Preconditions: transactions must not be empty
 	//
@@ -63,39 +61,54 @@ public:
 			return transactions.front();
 		}
 
-		std::vector<TransactionInput> inputs;
-		std::vector<TransactionOutput> outputs;
-		std::vector<TransactionKernel> kernels;
+		size_t numInputs = 0;
+		size_t numOutputs = 0;
+		size_t numKernels = 0;
+		std::vector<const std::vector<TransactionInput>*> inputRuns;
+		std::vector<const std::vector<TransactionOutput>*> outputRuns;
+		std::vector<const std::vector<TransactionKernel>*> kernelRuns;
 		std::vector<BlindingFactor> kernelOffsets;
+		inputRuns.reserve(transactions.size());
+		outputRuns.reserve(transactions.size());
+		kernelRuns.reserve(transactions.size());
+		kernelOffsets.reserve(transactions.size());
+		for (const TransactionPtr& pTransaction : transactions)
+		{
+			numInputs += pTransaction->GetInputs().size();
+			numOutputs += pTransaction->GetOutputs().size();
+			numKernels += pTransaction->GetKernels().size();
+			inputRuns.push_back(&pTransaction->GetInputs());
+			outputRuns.push_back(&pTransaction->GetOutputs());
+			kernelRuns.push_back(&pTransaction->GetKernels());
+			kernelOffsets.push_back(pTransaction->GetOffset());
+		}
 
-		// collect all the inputs, outputs and kernels from the txs
+		// Cut-through is performed during the merge, by skipping every input that spends one of the outputs, along with the output it spends.
+		std::unordered_set<Commitment> inputCommitments;
+		std::unordered_set<Commitment> outputCommitments;
+		inputCommitments.reserve(numInputs);
+		outputCommitments.reserve(numOutputs);
 		for (const TransactionPtr& pTransaction : transactions)
 		{
 			for (const TransactionInput& input : pTransaction->GetInputs())
 			{
-				inputs.push_back(input);
+				inputCommitments.insert(input.GetCommitment());
 			}
 
 			for (const TransactionOutput& output : pTransaction->GetOutputs())
 			{
-				outputs.push_back(output);
+				outputCommitments.insert(output.GetCommitment());
 			}
-
-			for (const TransactionKernel& kernel : pTransaction->GetKernels())
-			{
-				kernels.push_back(kernel);
-			}
-
-			kernelOffsets.push_back(pTransaction->GetOffset());
 		}
 
-		// Perform cut-through
-		TransactionUtil::PerformCutThrough(inputs, outputs);
-
-		// Sort the kernels.
-		std::sort(kernels.begin(), kernels.end(), SortKernelsByHash);
-		std::sort(inputs.begin(), inputs.end(), SortInputsByHash);
-		std::sort(outputs.begin(), outputs.end(), SortOutputsByHash);
+		// The copies carry their hashes along, so merging doesn't hash (or serialize) anything.
+		std::vector<TransactionInput> inputs = MergeSorted(inputRuns, numInputs, SortInputsByHash, [&outputCommitments](const TransactionInput& input) {
+			return outputCommitments.find(input.GetCommitment()) != outputCommitments.end();
+		});
+		std::vector<TransactionOutput> outputs = MergeSorted(outputRuns, numOutputs, SortOutputsByHash, [&inputCommitments](const TransactionOutput& output) {
+			return inputCommitments.find(output.GetCommitment()) != inputCommitments.end();
+		});
+		std::vector<TransactionKernel> kernels = MergeSorted(kernelRuns, numKernels, SortKernelsByHash, [](const TransactionKernel&) { return false; });
 
 		// Sum the kernel_offsets up to give us an aggregate offset for the transaction.
 		BlindingFactor totalKernelOffset = Crypto::AddBlindingFactors(kernelOffsets, std::vector<BlindingFactor>());
@@ -107,4 +120,60 @@ public:
 		//   * sum of all kernel offsets
 		return std::make_shared<Transaction>(std::move(totalKernelOffset), TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels)));
 	}
+
+private:
+	//
+	// Merges the sorted runs into 1 sorted vector in O(n log k), leaving out the elements skip returns true for.
+	// Each element kept is copied once, straight into its place. Runs that aren't sorted (eg. from txs that weren't validated)
+	// leave the merged vector unsorted, in which case it's sorted afterwards.
+	//
+	template<typename T, typename Compare, typename Skip>
+	static std::vector<T> MergeSorted(const std::vector<const std::vector<T>*>& runs, const size_t total, const Compare& compare, const Skip& skip)
+	{
+		using Cursor = std::pair<typename std::vector<T>::const_iterator, typename std::vector<T>::const_iterator>;
+
+		std::vector<Cursor> heap;
+		heap.reserve(runs.size());
+		for (const std::vector<T>* pRun : runs)
+		{
+			if (!pRun->empty())
+			{
+				heap.emplace_back(pRun->cbegin(), pRun->cend());
+			}
+		}
+
+		// std heaps keep the largest element on top, so the comparison is reversed.
+		auto greater = [&compare](const Cursor& a, const Cursor& b) { return compare(*b.first, *a.first); };
+		std::make_heap(heap.begin(), heap.end(), greater);
+
+		std::vector<T> merged;
+		merged.reserve(total);
+		bool sorted = true;
+		while (!heap.empty())
+		{
+			std::pop_heap(heap.begin(), heap.end(), greater);
+			Cursor& cursor = heap.back();
+			if (!skip(*cursor.first))
+			{
+				sorted = sorted && (merged.empty() || !compare(*cursor.first, merged.back()));
+				merged.push_back(*cursor.first);
+			}
+
+			if (++cursor.first == cursor.second)
+			{
+				heap.pop_back();
+			}
+			else
+			{
+				std::push_heap(heap.begin(), heap.end(), greater);
+			}
+		}
+
+		if (!sorted)
+		{
+			std::sort(merged.begin(), merged.end(), compare);
+		}
+
+		return merged;
+	}
 };
\ No newline at end of file
@@ -1,32 +1,95 @@
 #pragma once
 
 #include <Core/Models/TransactionBody.h>
-#include <set>
+#include <algorithm>
 
+//
+// Checks that the inputs and outputs of a body are each sorted by hash without duplicates,
+// and that no input spends an output of the same body. An input spends an output if their commitments match,
+// whatever the features of the input, so cut-through is checked by commitment rather than by hash.
+//
 class CutThroughVerifier
 {
 public:
-	static bool VerifyCutThrough(const TransactionBody& transactionBody)
+	enum class EResult
+	{
+		VALID,
+		NOT_SORTED,
+		DUPLICATE,
+		CUT_THROUGH
+	};
+
+	static EResult Verify(const TransactionBody& transactionBody)
 	{
-		return VerifyCutThrough(transactionBody.GetInputs(), transactionBody.GetOutputs());
+		return Verify(transactionBody.GetInputs(), transactionBody.GetOutputs());
 	}
 
-	static bool VerifyCutThrough(const std::vector<TransactionInput>& inputs, const std::vector<TransactionOutput>& outputs)
+	static EResult Verify(const std::vector<TransactionInput>& inputs, const std::vector<TransactionOutput>& outputs)
 	{
-		std::set<Commitment> commitments;
-		for (auto output : outputs)
+		EResult result = VerifySorted(inputs);
+		if (result == EResult::VALID)
 		{
-			commitments.insert(output.GetCommitment());
+			result = VerifySorted(outputs);
+		}
+
+		if (result != EResult::VALID)
+		{
+			return result;
+		}
+
+		std::vector<const Commitment*> outputCommitments;
+		outputCommitments.reserve(outputs.size());
+		for (const TransactionOutput& output : outputs)
+		{
+			outputCommitments.push_back(&output.GetCommitment());
+		}
+
+		auto compare = [](const Commitment* pLeft, const Commitment* pRight) { return *pLeft < *pRight; };
+		std::sort(outputCommitments.begin(), outputCommitments.end(), compare);
+
+		for (const TransactionInput& input : inputs)
+		{
+			if (std::binary_search(outputCommitments.cbegin(), outputCommitments.cend(), &input.GetCommitment(), compare))
+			{
+				return EResult::CUT_THROUGH;
+			}
 		}
 
-		for (auto input : inputs)
+		return EResult::VALID;
+	}
+
+	//
+	// Expects the inputs and outputs to be sorted, and returns false if they aren't.
+	//
+	static bool VerifyCutThrough(const TransactionBody& transactionBody)
+	{
+		return Verify(transactionBody) == EResult::VALID;
+	}
+
+	static bool VerifyCutThrough(const std::vector<TransactionInput>& inputs, const std::vector<TransactionOutput>& outputs)
+	{
+		return Verify(inputs, outputs) == EResult::VALID;
+	}
+
+private:
+	template<class T>
+	static EResult VerifySorted(const std::vector<T>& values)
+	{
+		for (size_t i = 1; i < values.size(); i++)
 		{
-			if (commitments.count(input.GetCommitment()) > 0)
+			const Hash& previous = values[i - 1].GetHash();
+			const Hash& current = values[i].GetHash();
+			if (previous == current)
+			{
+				return EResult::DUPLICATE;
+			}
+
+			if (current < previous)
 			{
-				return false;
+				return EResult::NOT_SORTED;
 			}
 		}
 
-		return true;
+		return EResult::VALID;
 	}
-};
\ No newline at end of file
+};
@@ -1,56 +1,190 @@
 #pragma once
 
 #include <Crypto/Crypto.h>
+#include <Core/Models/Transaction.h>
 #include <Core/Models/TransactionKernel.h>
 #include <Common/Logger.h>
+#include <Common/ThreadPool.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 class KernelSignatureValidator
 {
 public:
+	static constexpr size_t MIN_KERNELS_PER_THREAD = 500;
+
 	static bool VerifyKernelSignature(const TransactionKernel& kernel)
 	{
-		return VerifyKernelSignatures(std::vector<TransactionKernel>({ kernel }));
+		return VerifyKernelSignatures(&kernel, 1);
 	}
 
+	//
 	// Verify the tx kernels.
-	// No ability to batch verify these right now so just do them individually.
-	static bool VerifyKernelSignatures(const std::vector<TransactionKernel>& kernels)
-	{
-		std::vector<const Commitment*> commitments;
-		commitments.reserve(kernels.size());
-		std::vector<const Signature*> signatures;
-		signatures.reserve(kernels.size());
-		std::vector<Hash> msgs;
-		msgs.reserve(kernels.size());
-		std::vector<const Hash*> messages;
-		messages.reserve(kernels.size());
+	// Kernels already verified (eg. when their transaction was accepted to the mempool) are skipped,
+	// and the ones verified now are remembered unless cacheResults is false.
+	//
+	static bool VerifyKernelSignatures(const std::vector<TransactionKernel>& kernels, const bool cacheResults = true)
+	{
+		return VerifyKernelSignatures(kernels.data(), kernels.size(), cacheResults);
+	}
+
+	//
+	// Splits the kernels into chunks of at least MIN_KERNELS_PER_THREAD and batch verifies them on the shared thread pool.
+	// Falls back to verifying on the calling thread when there are too few kernels to be worth splitting.
+	//
+	static bool VerifyKernelSignaturesParallel(const std::vector<TransactionKernel>& kernels)
+	{
+		const size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+		const size_t numThreads = std::min(maxThreads, kernels.size() / MIN_KERNELS_PER_THREAD);
+		if (numThreads <= 1)
+		{
+			return VerifyKernelSignatures(kernels);
+		}
+
+		const size_t kernelsPerThread = (kernels.size() + numThreads - 1) / numThreads;
+
+		std::atomic_size_t nextChunk = 0;
+		std::atomic_bool valid = true;
+		ThreadManagerAPI::GetThreadPool().RunParallel(numThreads, [&]() {
+			while (valid)
+			{
+				const size_t first = (nextChunk++) * kernelsPerThread;
+				if (first >= kernels.size())
+				{
+					break;
+				}
+
+				const size_t numKernels = std::min(kernelsPerThread, kernels.size() - first);
+				if (!VerifyKernelSignatures(kernels.data() + first, numKernels))
+				{
+					valid = false;
+				}
+			}
+		}, ETaskPriority::HIGH);
+
+		return valid;
+	}
+
+	// Batch verifies the numKernels kernels starting at pKernels.
+	static bool VerifyKernelSignatures(const TransactionKernel* pKernels, const size_t numKernels, const bool cacheResults = true)
+	{
+		Batch& batch = GetBatch();
+		batch.Clear();
+		for (size_t i = 0; i < numKernels; i++)
+		{
+			batch.Add(pKernels[i]);
+		}
+
+		return batch.Verify(cacheResults);
+	}
+
+	//
+	// Verifies the kernels of all of the transactions as a single batch, which is all it takes when they're all valid.
+	// Only when the batch fails are the transactions bisected, to find exactly which ones have an invalid kernel signature.
+	// Returns the indices of those transactions, in order.
+	//
+	static std::vector<size_t> FindInvalidTransactions(const std::vector<TransactionPtr>& transactions)
+	{
+		std::vector<size_t> invalid;
+		FindInvalidTransactions(transactions, 0, transactions.size(), invalid);
+		return invalid;
+	}
+
+private:
+	//
+	// The pointer arrays and messages of a batch verification, reused by every batch on the same thread.
+	//
+	class Batch
+	{
+	public:
+		void Clear()
+		{
+			m_commitments.clear();
+			m_signatures.clear();
+			m_msgs.clear();
+			m_messages.clear();
+		}
+
+		void Add(const TransactionKernel& kernel)
+		{
+			m_commitments.push_back(&kernel.GetExcessCommitment());
+			m_signatures.push_back(&kernel.GetExcessSignature());
+			m_msgs.emplace_back(kernel.GetSignatureMessage());
+		}
+
+		size_t size() const noexcept { return m_signatures.size(); }
 
 		// Verify the transaction proof validity. Entails handling the commitment as a public key and checking the signature verifies with the fee as message.
-		for (size_t i = 0; i < kernels.size(); i++)
+		bool Verify(const bool cacheResults = true)
+		{
+			if (m_signatures.empty())
+			{
+				return true;
+			}
+
+			// m_msgs is done growing, so the pointers to its elements are stable now.
+			for (const Hash& msg : m_msgs)
+			{
+				m_messages.push_back(&msg);
+			}
+
+			LOG_TRACE("Start verify");
+			if (!Crypto::VerifyKernelSignatures(m_signatures, m_commitments, m_messages, cacheResults))
+			{
+				LOG_ERROR("Failed to verify kernels.");
+				return false;
+			}
+
+			LOG_TRACE("Verify success");
+			return true;
+		}
+
+	private:
+		std::vector<const Commitment*> m_commitments;
+		std::vector<const Signature*> m_signatures;
+		std::vector<Hash> m_msgs;
+		std::vector<const Hash*> m_messages;
+	};
+
+	static Batch& GetBatch()
+	{
+		static thread_local Batch batch;
+		return batch;
+	}
+
+	static void FindInvalidTransactions(const std::vector<TransactionPtr>& transactions, const size_t begin, const size_t end, std::vector<size_t>& invalid)
+	{
+		if (begin == end)
 		{
-			const TransactionKernel& kernel = kernels[i];
-			commitments.push_back(&kernel.GetExcessCommitment());
-			signatures.push_back(&kernel.GetExcessSignature());
-			msgs.emplace_back(kernel.GetSignatureMessage());
-			messages.push_back(&msgs[i]);
+			return;
+		}
 
-			//LOG_TRACE_F(
-			//	"Attempting to verify kernel with commitment {}, signature {} - compact {}, and message {}.",
-			//	kernel.GetExcessCommitment().ToHex(),
-			//	kernel.GetExcessSignature().ToHex(),
-			//	Crypto::ToCompact(kernel.GetExcessSignature()).ToHex(),
-			//	kernel.GetSignatureMessage().ToHex()
-			//);
+		Batch& batch = GetBatch();
+		batch.Clear();
+		for (size_t i = begin; i < end; i++)
+		{
+			for (const TransactionKernel& kernel : transactions[i]->GetKernels())
+			{
+				batch.Add(kernel);
+			}
+		}
+
+		if (batch.Verify())
+		{
+			return;
 		}
 
-		LOG_TRACE("Start verify");
-		if (!Crypto::VerifyKernelSignatures(signatures, commitments, messages))
+		if (end - begin == 1)
 		{
-			LOG_ERROR("Failed to verify kernels.");
-			return false;
+			LOG_DEBUG_F("Invalid kernel signature in transaction ({})", *transactions[begin]);
+			invalid.push_back(begin);
+			return;
 		}
 
-		LOG_TRACE("Verify success");
-		return true;
+		const size_t middle = begin + (end - begin) / 2;
+		FindInvalidTransactions(transactions, begin, middle, invalid);
+		FindInvalidTransactions(transactions, middle, end, invalid);
 	}
-};
\ No newline at end of file
+};
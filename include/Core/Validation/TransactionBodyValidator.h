@@ -7,9 +7,14 @@ class TransactionBodyValidator
 public:
 	void Validate(const TransactionBody& transactionBody, const bool withReward);
 
+	//
+	// Everything Validate checks except the rangeproofs and kernel signatures.
+	//
+	void ValidateStructure(const TransactionBody& transactionBody, const bool withReward);
+
 private:
 	void ValidateWeight(const TransactionBody& transactionBody, const bool withReward);
-	void VerifySorted(const TransactionBody& transactionBody);
-	void VerifyCutThrough(const TransactionBody& transactionBody);
+	void VerifyKernelsSorted(const TransactionBody& transactionBody);
+	void VerifyInputsAndOutputs(const TransactionBody& transactionBody);
 	void VerifyRangeProofs(const std::vector<TransactionOutput>& outputs);
 };
\ No newline at end of file
@@ -1,13 +1,28 @@
 #pragma once
 
 #include <Core/Models/Transaction.h>
+#include <vector>
 
 class TransactionValidator
 {
 public:
 	void Validate(const Transaction& transaction) const;
 
+	//
+	// Validates transactions that arrived together, returning whether each is valid. Valid ones are marked as validated.
+	// Each thread takes a chunk of them and verifies all of the chunk's rangeproofs as one batch, and its kernel signatures as another,
+	// which is much cheaper per proof than verifying each transaction's 1-3 outputs on their own.
+	// Only when a batch fails is the chunk bisected, so just the transactions with a bad proof or signature are rejected.
+	//
+	std::vector<bool> ValidateBatch(const std::vector<TransactionPtr>& transactions) const;
+
 private:
 	void ValidateFeatures(const TransactionBody& transactionBody) const;
 	void ValidateKernelSums(const Transaction& transaction) const;
+
+	// Validates transactions[begin, end), setting valid[i] for each valid one.
+	void ValidateChunk(const std::vector<TransactionPtr>& transactions, const size_t begin, const size_t end, std::vector<uint8_t>& valid) const;
+
+	// Adds the index of each of transactions[begin, end) with an invalid rangeproof to invalid, in order.
+	static void FindInvalidRangeProofs(const std::vector<TransactionPtr>& transactions, const size_t begin, const size_t end, std::vector<size_t>& invalid);
 };
\ No newline at end of file
@@ -32,6 +32,7 @@ private:
         const age::RecipientLine& recipient_line,
         const CBigInteger<16>& file_key_nonce,
         const age::Header& header,
-        const std::vector<uint8_t>& encrypted_payload
+        const uint8_t* pEncryptedPayload,
+        const size_t encryptedPayloadSize
     );
 };
\ No newline at end of file
@@ -13,6 +13,7 @@
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstring>
 
 #pragma warning(disable: 4505)
 
@@ -102,13 +103,7 @@ public:
 	const unsigned char* ToCharArray() const { return &m_data[0]; }
 	std::string ToHex() const
 	{
-		std::ostringstream stream;
-		for (const unsigned char byte : m_data)
-		{
-			stream << std::hex << std::setfill('0') << std::setw(2) << std::nouppercase << (int)byte;
-		}
-
-		return stream.str();
+		return HexUtil::ConvertToHex(m_data.data(), NUM_BYTES);
 	}
 	std::string Format() const final { return ToHex(); }
 
@@ -167,25 +162,13 @@ public:
 	unsigned char& operator[] (const size_t x) { return m_data[x]; }
 	const unsigned char& operator[] (const size_t x) const { return m_data[x]; }
 
+	//
+	// Compared with memcmp, which the standard libraries vectorize, rather than a byte at a time.
+	// Bytes compare as unsigned, so the order is the same as comparing them as big-endian numbers.
+	//
 	bool operator<(const CBigInteger& rhs) const
 	{
-		if (this == &rhs)
-		{
-			return false;
-		}
-
-		auto rhsIter = rhs.m_data.cbegin();
-		for (auto iter = this->m_data.cbegin(); iter != this->m_data.cend(); iter++)
-		{
-			if (*rhsIter != *iter)
-			{
-				return *iter < *rhsIter;
-			}
-
-			rhsIter++;
-		}
-
-		return false;
+		return Compare(rhs) < 0;
 	}
 
 	bool operator>(const CBigInteger& rhs) const
@@ -195,20 +178,7 @@ public:
 
 	bool operator==(const CBigInteger& rhs) const
 	{
-		if (this == &rhs)
-		{
-			return true;
-		}
-
-		for (size_t i = 0; i < NUM_BYTES; i++)
-		{
-			if (this->m_data[i] != rhs.m_data[i])
-			{
-				return false;
-			}
-		}
-
-		return true;
+		return Compare(rhs) == 0;
 	}
 
 	bool operator!=(const CBigInteger& rhs) const
@@ -218,12 +188,12 @@ public:
 
 	bool operator<=(const CBigInteger& rhs) const
 	{
-		return *this < rhs || *this == rhs;
+		return Compare(rhs) <= 0;
 	}
 
 	bool operator>=(const CBigInteger& rhs) const
 	{
-		return *this > rhs || *this == rhs;
+		return Compare(rhs) >= 0;
 	}
 
 	CBigInteger operator^=(const CBigInteger& rhs)
@@ -234,6 +204,11 @@ public:
 	}
 
 private:
+	int Compare(const CBigInteger& rhs) const noexcept
+	{
+		return this == &rhs ? 0 : std::memcmp(m_data.data(), rhs.m_data.data(), NUM_BYTES);
+	}
+
 	std::vector<unsigned char, ALLOC> m_data;
 };
 
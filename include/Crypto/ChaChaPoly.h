@@ -3,6 +3,8 @@
 #include <Crypto/SecretKey.h>
 #include <Crypto/CryptoException.h>
 #include <chachapoly.h>
+#include <algorithm>
+#include <vector>
 
 class ChaChaPoly
 {
@@ -49,30 +51,49 @@ public:
     std::vector<uint8_t> StreamEncrypt(const std::vector<uint8_t>& data)
     {
         std::vector<uint8_t> encrypted;
+        StreamEncrypt(data.data(), data.size(), encrypted);
+        return encrypted;
+    }
+
+    //
+    // Encrypts numBytes at pData in CHUNK_SIZE chunks, appending them to encrypted.
+    // Each chunk is encrypted straight into place, so the payload is never copied into per-chunk buffers.
+    //
+    void StreamEncrypt(const uint8_t* pData, const size_t numBytes, std::vector<uint8_t>& encrypted)
+    {
+        const size_t num_chunks = (numBytes + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        const size_t offset = encrypted.size();
+        encrypted.resize(offset + numBytes + (num_chunks * TAG_SIZE));
+        uint8_t* pOutput = encrypted.data() + offset;
 
         CBigInteger<11> counter;
 
         size_t index = 0;
-        while (index < data.size())
+        while (index < numBytes)
         {
-            size_t to_write = (std::min)(CHUNK_SIZE, (data.size() - index));
-            size_t next_index = index + to_write;
-
-            std::vector<uint8_t> nonce = counter.GetData();
-            nonce.push_back(next_index == data.size() ? 1 : 0);
-
-            std::vector<uint8_t> encrypted_chunk = Encrypt(
-                CBigInteger<12>{ nonce },
-                std::vector<uint8_t>{ data.begin() + index, data.begin() + index + to_write }
+            const size_t to_write = (std::min)(CHUNK_SIZE, (numBytes - index));
+            const size_t next_index = index + to_write;
+
+            const int crypt_result = chachapoly_crypt(
+                &m_context,
+                BuildStreamNonce(counter, next_index == numBytes).data(),
+                nullptr,
+                0,
+                pData + index,
+                (int)to_write,
+                pOutput,
+                pOutput + to_write,
+                (int)TAG_SIZE,
+                1
             );
+            if (crypt_result != 0) {
+                throw CryptoException("Failed to encrypt");
+            }
 
-            encrypted.insert(encrypted.end(), encrypted_chunk.cbegin(), encrypted_chunk.cend());
-
+            pOutput += to_write + TAG_SIZE;
             index = next_index;
             counter++;
         }
-
-        return encrypted;
     }
 
     std::vector<uint8_t> Decrypt(const CBigInteger<12>& nonce, const std::vector<uint8_t>& encrypted)
@@ -105,26 +126,49 @@ public:
 
     std::vector<uint8_t> StreamDecrypt(const std::vector<uint8_t>& encrypted)
     {
-        std::vector<uint8_t> decrypted;
+        return StreamDecrypt(encrypted.data(), encrypted.size());
+    }
+
+    //
+    // Decrypts numBytes of ENCRYPTED_CHUNK_SIZE chunks at pEncrypted, straight into the returned buffer.
+    //
+    std::vector<uint8_t> StreamDecrypt(const uint8_t* pEncrypted, const size_t numBytes)
+    {
+        const size_t num_chunks = (numBytes + ENCRYPTED_CHUNK_SIZE - 1) / ENCRYPTED_CHUNK_SIZE;
+        if (numBytes % ENCRYPTED_CHUNK_SIZE != 0 && numBytes % ENCRYPTED_CHUNK_SIZE <= TAG_SIZE) {
+            throw CryptoException("Invalid chunk size");
+        }
+
+        std::vector<uint8_t> decrypted(numBytes - (num_chunks * TAG_SIZE));
+        uint8_t* pOutput = decrypted.data();
 
         CBigInteger<11> counter;
 
         size_t index = 0;
-        while (index < encrypted.size())
+        while (index < numBytes)
         {
-            size_t to_read = (std::min)(ENCRYPTED_CHUNK_SIZE, (encrypted.size() - index));
-            size_t next_index = index + to_read;
-
-            std::vector<uint8_t> nonce = counter.GetData();
-            nonce.push_back(next_index == encrypted.size() ? 1 : 0);
-
-            std::vector<uint8_t> decrypted_chunk = Decrypt(
-                CBigInteger<12>{ nonce },
-                std::vector<uint8_t>{ encrypted.begin() + index, encrypted.begin() + index + to_read }
+            const size_t to_read = (std::min)(ENCRYPTED_CHUNK_SIZE, (numBytes - index));
+            const size_t next_index = index + to_read;
+            const size_t ciphertext_len = to_read - TAG_SIZE;
+
+            // The tag is only read when decrypting.
+            const int crypt_result = chachapoly_crypt(
+                &m_context,
+                BuildStreamNonce(counter, next_index == numBytes).data(),
+                nullptr,
+                0,
+                pEncrypted + index,
+                (int)ciphertext_len,
+                pOutput,
+                const_cast<uint8_t*>(pEncrypted + index + ciphertext_len),
+                (int)TAG_SIZE,
+                0
             );
+            if (crypt_result != 0) {
+                throw CryptoException("Failed to decrypt");
+            }
 
-            decrypted.insert(decrypted.end(), decrypted_chunk.cbegin(), decrypted_chunk.cend());
-
+            pOutput += ciphertext_len;
             index = next_index;
             counter++;
         }
@@ -133,6 +177,14 @@ public:
     }
 
 private:
+    // 11 byte big-endian chunk counter, followed by 1 if it's the last chunk.
+    static CBigInteger<12> BuildStreamNonce(const CBigInteger<11>& counter, const bool last)
+    {
+        std::vector<uint8_t> nonce = counter.GetData();
+        nonce.push_back(last ? 1 : 0);
+        return CBigInteger<12>{ nonce };
+    }
+
     ChaChaPoly(const chachapoly_ctx& context)
         : m_context(context) { }
 
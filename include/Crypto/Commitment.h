@@ -9,6 +9,7 @@
 #include <Core/Traits/Printable.h>
 #include <Core/Serialization/ByteBuffer.h>
 #include <Core/Serialization/Serializer.h>
+#include <cstring>
 
 class Commitment : public Traits::IPrintable
 {
@@ -91,10 +92,12 @@ namespace std
 	template<>
 	struct hash<Commitment>
 	{
-		size_t operator()(const Commitment& commitment) const
+		size_t operator()(const Commitment& commitment) const noexcept
 		{
-			const std::vector<unsigned char>& bytes = commitment.GetVec();
-			return BitUtil::ConvertToU64(bytes[0], bytes[4], bytes[8], bytes[12], bytes[16], bytes[20], bytes[24], bytes[28]);
+			// The first byte is the 0x08/0x09 sign prefix, but the x-coordinate after it is uniformly random.
+			uint64_t value;
+			std::memcpy(&value, commitment.GetVec().data() + 1, sizeof(value));
+			return (size_t)value;
 		}
 	};
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 // file LICENSE or http://www.opensource.org/licenses/mit-license.php.
 
 #include <Common/Secure.h>
+#include <Common/CacheStats.h>
 #include <Crypto/BigInteger.h>
 #include <Crypto/Commitment.h>
 #include <Crypto/RangeProof.h>
@@ -16,6 +17,7 @@
 #include <Crypto/PublicKey.h>
 #include <Crypto/SecretKey.h>
 #include <cstdint>
+#include <optional>
 #include <vector>
 #include <memory>
 
@@ -46,6 +48,15 @@ public:
 		const std::vector<Commitment>& negative
 	);
 
+	//
+	// Adds the commitments together like AddCommitments, but returns std::nullopt rather than throwing when they cancel out
+	// (ie. sum to the point at infinity), eg. for a kernel excess and its negation.
+	//
+	static std::optional<Commitment> TryAddCommitments(
+		const std::vector<Commitment>& positive,
+		const std::vector<Commitment>& negative
+	);
+
 	//
 	// Takes a vector of blinding factors and calculates an additional blinding value that adds to zero.
 	//
@@ -75,21 +86,67 @@ public:
 	);
 
 	//
+	// Rewinds each rangeproof with the nonce at the same index, in a single call.
+	// Returns nullptr for each proof that couldn't be rewound.
 	//
+	static std::vector<std::unique_ptr<RewoundProof>> RewindRangeProofs(
+		const std::vector<Commitment>& commitments,
+		const std::vector<const RangeProof*>& rangeProofs,
+		const std::vector<SecretKey>& nonces
+	);
+
+	//
+	// Verifies each rangeproof against the commitment at the same index, as a single batch.
+	// The proofs are referenced rather than copied, so they only need to outlive the call.
 	//
 	static bool VerifyRangeProofs(
-		const std::vector<std::pair<Commitment, RangeProof>>& rangeProofs
+		const std::vector<Commitment>& commitments,
+		const std::vector<const RangeProof*>& rangeProofs
 	);
 
 	//
+	// Sets the number of verified rangeproof commitments remembered, so repeat verifications can be skipped.
+	//
+	static void SetRangeProofCacheCapacity(const size_t capacity);
+
+	//
+	// Returns the size and hit/miss counters of the verified rangeproof cache.
+	//
+	static CacheStats GetRangeProofCacheStats();
+
+	//
+	// Sets the number of parsed commitments remembered, so commitments seen again (eg. a UTXO spent by a pool transaction
+	// and then by a block) don't need to be parsed again. A capacity of 0 disables the cache.
+	//
+	static void SetCommitmentCacheCapacity(const size_t capacity);
+
+	//
+	// Returns the size and hit/miss counters of the parsed commitment cache.
+	//
+	static CacheStats GetCommitmentCacheStats();
+
 	//
+	// Batch verifies the kernel signatures, skipping any already verified with the same excess and message.
+	// The signatures that verify are remembered only when cacheResults is set.
 	//
 	static bool VerifyKernelSignatures(
 		const std::vector<const Signature*>& signatures,
 		const std::vector<const Commitment*>& publicKeys,
-		const std::vector<const Hash*>& messages
+		const std::vector<const Hash*>& messages,
+		const bool cacheResults = true
 	);
 
+	//
+	// Sets the number of verified kernel signatures remembered, so kernels seen again (eg. in a block after being accepted
+	// to the mempool) don't need to be verified again.
+	//
+	static void SetKernelSignatureCacheCapacity(const size_t capacity);
+
+	//
+	// Returns the size and hit/miss counters of the verified kernel signature cache.
+	//
+	static CacheStats GetKernelSignatureCacheStats();
+
 	//
 	// Calculates the 33 byte public key from the 32 byte private key using curve secp256k1.
 	//
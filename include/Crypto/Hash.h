@@ -3,6 +3,7 @@
 #include <Crypto/BigInteger.h>
 #include <Common/Util/BitUtil.h>
 #include <Common/Util/HexUtil.h>
+#include <cstring>
 
 typedef CBigInteger<32> Hash;
 
@@ -21,12 +22,17 @@ public:
 
 namespace std
 {
+	//
+	// Hashes are already uniformly random, so their first 8 bytes are used as-is.
+	//
 	template<>
 	struct hash<Hash>
 	{
-		size_t operator()(const Hash& hash) const
+		size_t operator()(const Hash& hash) const noexcept
 		{
-			return BitUtil::ConvertToU64(hash[0], hash[4], hash[8], hash[12], hash[16], hash[20], hash[24], hash[28]);
+			uint64_t value;
+			std::memcpy(&value, hash.GetData().data(), sizeof(value));
+			return (size_t)value;
 		}
 	};
 }
\ No newline at end of file
@@ -10,6 +10,7 @@
 #include <Core/Traits/Serializable.h>
 #include <Core/Serialization/ByteBuffer.h>
 #include <Core/Serialization/Serializer.h>
+#include <memory_resource>
 
 static const int MAX_PROOF_SIZE = 675;
 
@@ -19,11 +20,18 @@ public:
 	//
 	// Constructors
 	//
-	RangeProof(std::vector<unsigned char>&& proofBytes)
+	RangeProof(const std::vector<unsigned char>& proofBytes)
+		: m_proofBytes(proofBytes.cbegin(), proofBytes.cend())
+	{
+
+	}
+	RangeProof(std::pmr::vector<unsigned char>&& proofBytes)
 		: m_proofBytes(std::move(proofBytes))
 	{
 
 	}
+
+	// Copies are always allocated from the heap, even when the original was allocated from a block's arena.
 	RangeProof(const RangeProof& other) = default;
 	RangeProof(RangeProof&& other) noexcept = default;
 
@@ -42,7 +50,7 @@ public:
 	//
 	// Getters
 	//
-	const std::vector<unsigned char>& GetProofBytes() const noexcept { return m_proofBytes; }
+	const std::pmr::vector<unsigned char>& GetProofBytes() const noexcept { return m_proofBytes; }
 
 	//
 	// Serialization/Deserialization
@@ -61,7 +69,7 @@ public:
 			throw DESERIALIZATION_EXCEPTION_F("Proof of size {} exceeds the maximum", proofSize);
 		}
 
-		return RangeProof(byteBuffer.ReadVector(proofSize));
+		return RangeProof(byteBuffer.ReadPmrVector(proofSize));
 	}
 
 	static RangeProof FromHex(const std::string& hex)
@@ -71,15 +79,16 @@ public:
 
 	std::string ToHex() const noexcept
 	{
-		return HexUtil::ConvertToHex(m_proofBytes);
+		return HexUtil::ConvertToHex(m_proofBytes.data(), m_proofBytes.size());
 	}
 
 	//
 	// Traits
 	//
-	std::string Format() const final { return HexUtil::ConvertToHex(m_proofBytes); }
+	std::string Format() const final { return ToHex(); }
 
 private:
 	// The proof itself, at most 675 bytes long.
-	std::vector<unsigned char> m_proofBytes;
+	// Allocated from the memory resource of the ByteBuffer it was read from, which may be a block's arena.
+	std::pmr::vector<unsigned char> m_proofBytes;
 };
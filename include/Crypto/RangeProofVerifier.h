@@ -0,0 +1,59 @@
+#pragma once
+
+#include <Crypto/Commitment.h>
+#include <Crypto/RangeProof.h>
+#include <memory>
+#include <vector>
+
+// Forward Declarations
+typedef struct secp256k1_context_struct secp256k1_context;
+typedef struct secp256k1_scratch_space_struct secp256k1_scratch_space;
+struct secp256k1_bulletproof_generators;
+
+//
+// Verifies batches of bulletproofs using a dedicated secp256k1 context and a scratch space that is reused across calls.
+// The scratch space is sized up front from the number of proofs in the batch, rather than to the maximum supported width,
+// and is kept for later batches that fit in it.
+// Unlike Crypto::VerifyRangeProofs, this does not consult or populate the shared VerifiedCache.
+// Instances are not thread-safe, so each worker thread should create its own.
+//
+class RangeProofVerifier
+{
+public:
+	using UPtr = std::unique_ptr<RangeProofVerifier>;
+
+	static RangeProofVerifier::UPtr Create();
+	~RangeProofVerifier();
+
+	RangeProofVerifier(const RangeProofVerifier&) = delete;
+	RangeProofVerifier& operator=(const RangeProofVerifier&) = delete;
+
+	bool Verify(const std::vector<std::pair<Commitment, RangeProof>>& rangeProofs);
+
+	//
+	// Verifies the proofs as a single batch. Each proof must be proofLength bytes.
+	//
+	bool Verify(const std::vector<Commitment>& commitments, const std::vector<const unsigned char*>& proofs, const size_t proofLength);
+
+	//
+	// The scratch space size used for a batch of numProofs proofs.
+	//
+	static size_t GetScratchSpaceSize(const size_t numProofs);
+	size_t GetReservedScratchSpace() const noexcept { return m_scratchSpaceSize; }
+
+	//
+	// Frees the scratch space, but keeps the context and generators. The next Verify allocates it again.
+	//
+	void ReleaseScratchSpace();
+
+private:
+	RangeProofVerifier(secp256k1_context* pContext, secp256k1_bulletproof_generators* pGenerators)
+		: m_pContext(pContext), m_pGenerators(pGenerators), m_pScratchSpace(nullptr), m_scratchSpaceSize(0) { }
+
+	void ReserveScratchSpace(const size_t size);
+
+	secp256k1_context* m_pContext;
+	secp256k1_bulletproof_generators* m_pGenerators;
+	secp256k1_scratch_space* m_pScratchSpace;
+	size_t m_scratchSpaceSize;
+};
@@ -3,8 +3,11 @@
 #include <Core/Models/BlockHeader.h>
 #include <Core/Models/SpentOutput.h>
 #include <Core/Traits/Batchable.h>
+#include <Database/BlockParts.h>
+#include <Database/DBStats.h>
 #include <unordered_map>
 #include <memory>
+#include <vector>
 
 // Forward Declarations
 class BlockSums;
@@ -19,23 +22,90 @@ public:
 
 	virtual BlockHeaderPtr GetBlockHeader(const Hash& hash) const = 0;
 
+	//
+	// Looks up the headers in a single batch. Returns a header for each hash, in the same order, or nullptr if not found.
+	//
+	virtual std::vector<BlockHeaderPtr> GetBlockHeaders(const std::vector<Hash>& hashes) const = 0;
+
 	virtual void AddBlockHeader(BlockHeaderPtr pBlockHeader) = 0;
 	virtual void AddBlockHeaders(const std::vector<BlockHeaderPtr>& blockHeaders) = 0;
 
 	virtual void AddBlock(const FullBlock& block) = 0;
 	virtual std::unique_ptr<FullBlock> GetBlock(const Hash& hash) const = 0;
+
+	//
+	// Looks up the blocks in a single batch. Returns a block for each hash, in the same order, or nullptr if not found.
+	//
+	virtual std::vector<std::unique_ptr<FullBlock>> GetBlocks(const std::vector<Hash>& hashes) const = 0;
+
+	//
+	// Checks whether the full block is stored, without reading it where the storage layout allows.
+	//
+	virtual bool HasBlock(const Hash& hash) const = 0;
+
+	//
+	// Looks up only the given EBlockParts of each block, in a single batch. Returns them for each hash, in the same order, or nullptr if not found.
+	// With DATABASE.SPLIT_BLOCKS enabled, each part is stored in its own table, so parts that weren't requested (eg. rangeproofs) aren't read at all.
+	//
+	virtual std::vector<std::unique_ptr<BlockParts>> GetBlockParts(const std::vector<Hash>& hashes, const uint8_t parts) const = 0;
 	virtual void ClearBlocks() = 0;
 
+	//
+	// Deletes the full blocks and their spent positions, keeping the headers and block sums.
+	// Used by pruned nodes to discard blocks that can no longer be rewound to.
+	//
+	virtual void RemoveBlocks(const std::vector<Hash>& hashes) = 0;
+
 	virtual void AddBlockSums(const Hash& blockHash, const BlockSums& blockSums) = 0;
 	virtual std::unique_ptr<BlockSums> GetBlockSums(const Hash& blockHash) const = 0;
 	virtual void ClearBlockSums() = 0;
 
 	virtual void AddOutputPosition(const Commitment& outputCommitment, const OutputLocation& location) = 0;
 	virtual std::unique_ptr<OutputLocation> GetOutputPosition(const Commitment& outputCommitment) const = 0;
+
+	//
+	// Looks up the positions in a single batch. Returns a position for each commitment, in the same order, or nullptr if not found.
+	//
+	virtual std::vector<std::unique_ptr<OutputLocation>> GetOutputPositions(const std::vector<Commitment>& outputCommitments) const = 0;
 	virtual void RemoveOutputPositions(const std::vector<Commitment>& outputCommitments) = 0;
 	virtual void ClearOutputPositions() = 0;
 
+	//
+	// Maps kernel excess commitments to their kernel MMR index and block height.
+	// Only maintained when NODE.KERNEL_INDEX is enabled. Otherwise, adds and removes do nothing and lookups return nullptr.
+	//
+	virtual void AddKernelPosition(const Commitment& excessCommitment, const OutputLocation& location) = 0;
+	virtual std::unique_ptr<OutputLocation> GetKernelPosition(const Commitment& excessCommitment) const = 0;
+	virtual void RemoveKernelPositions(const std::vector<Commitment>& excessCommitments) = 0;
+	virtual void ClearKernelPositions() = 0;
+
+	//
+	// Maps the excess commitments of NRD (no recent duplicate) kernels to the kernel MMR index and block height of their latest
+	// occurrence, for checking relative lock heights. Unlike the kernel positions, these are always maintained.
+	// Earlier occurrences within a week (the longest relative lock) of the latest are kept too, so rewinding can restore them.
+	//
+	virtual void AddNRDKernelPosition(const Commitment& excessCommitment, const OutputLocation& location) = 0;
+	virtual std::unique_ptr<OutputLocation> GetNRDKernelPosition(const Commitment& excessCommitment) const = 0;
+
+	//
+	// Removes the occurrences of each excess commitment at or above kernelMMRSize, ie. the ones added by rewound blocks.
+	//
+	virtual void RewindNRDKernelPositions(const std::vector<Commitment>& excessCommitments, const uint64_t kernelMMRSize) = 0;
+	virtual void ClearNRDKernelPositions() = 0;
+
 	virtual void AddSpentPositions(const Hash& blockHash, const std::vector<SpentOutput>& outputPositions) = 0;
-	virtual std::unordered_map<Commitment, OutputLocation> GetSpentPositions(const Hash& blockHash) const = 0;
+
+	//
+	// Looks up the outputs spent by each block in a single batch. Returns them for each hash, in the same order, or nullptr if not found.
+	// A block's spent outputs are in the same order as its inputs.
+	//
+	virtual std::vector<std::unique_ptr<SpentOutputs>> GetSpentOutputs(const std::vector<Hash>& blockHashes) const = 0;
 	virtual void ClearSpentPositions() = 0;
+
+	virtual DBStats GetStats() const = 0;
+
+	//
+	// Only for replicas (see NodeConfig::IsReplica). Makes the primary's writes since the last catch up visible to reads.
+	//
+	virtual void CatchUpWithPrimary() = 0;
 };
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Core/Models/BlockHeader.h>
+#include <Core/Models/OutputIdentifier.h>
+#include <Core/Models/TransactionInput.h>
+#include <Core/Models/TransactionKernel.h>
+#include <Crypto/RangeProof.h>
+#include <cstdint>
+#include <vector>
+
+//
+// Selects which parts of a block IBlockDB::GetBlockParts loads. Parts can be combined, eg. EBlockPart::INPUTS | EBlockPart::KERNELS.
+//
+namespace EBlockPart
+{
+	enum : uint8_t
+	{
+		INPUTS = 1 << 0,
+		OUTPUTS = 1 << 1,
+		RANGEPROOFS = 1 << 2,
+		KERNELS = 1 << 3,
+		ALL = INPUTS | OUTPUTS | RANGEPROOFS | KERNELS
+	};
+}
+
+//
+// The parts of a block loaded by IBlockDB::GetBlockParts. The header is always loaded, and parts that weren't requested are left empty.
+// Rangeproofs are in the same order as the outputs.
+//
+struct BlockParts
+{
+	BlockHeaderPtr pHeader;
+	std::vector<TransactionInput> inputs;
+	std::vector<OutputIdentifier> outputs;
+	std::vector<RangeProof> rangeProofs;
+	std::vector<TransactionKernel> kernels;
+};
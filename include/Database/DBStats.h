@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// Activity of a single table (column family) since startup, along with rocksdb's estimates of its current size.
+//
+struct DBTableStats
+{
+	std::string name;
+
+	// Keys looked up, including each key of a batched lookup.
+	uint64_t numReads;
+
+	// Keys written or deleted.
+	uint64_t numWrites;
+
+	uint64_t estimatedKeys;
+	uint64_t sstBytes;
+	uint64_t memtableBytes;
+};
+
+struct DBStats
+{
+	std::vector<DBTableStats> tables;
+
+	// Shared block cache, since startup.
+	uint64_t blockCacheHits;
+	uint64_t blockCacheMisses;
+	uint64_t blockCacheUsage;
+
+	// Time writes were stalled or slowed down waiting on flushes and compactions, since startup.
+	uint64_t stallMicros;
+	uint64_t pendingCompactionBytes;
+
+	// BlockDB's in-memory header cache, since startup.
+	uint64_t headerCacheHits;
+	uint64_t headerCacheMisses;
+	size_t headerCacheSize;
+	size_t headerCacheCapacity;
+};
@@ -28,10 +28,7 @@ public:
 protected:
 	void Connect(const SocketAddress& address, const asio::chrono::steady_clock::duration& timeout)
 	{
-		if (m_socket.is_open())
-		{
-			m_socket.close();
-		}
+		Close();
 
 		asio::ip::address ipAddress(asio::ip::address_v4::from_string(address.GetIPAddress().Format()));
 		asio::ip::tcp::endpoint endpoint(ipAddress, address.GetPortNumber());
@@ -55,10 +52,7 @@ protected:
 
 	void Connect(const std::string& host, const uint16_t port, const asio::chrono::steady_clock::duration& timeout)
 	{
-		if (m_socket.is_open())
-		{
-			m_socket.close();
-		}
+		Close();
 
 		asio::io_service ios;
 
@@ -160,6 +154,19 @@ protected:
 		return std::vector<uint8_t>(line.begin(), line.end());
 	}
 
+	bool IsOpen() const noexcept { return m_socket.is_open(); }
+
+	void Close()
+	{
+		if (m_socket.is_open())
+		{
+			asio::error_code ec;
+			m_socket.close(ec);
+		}
+
+		m_stringBuffer.clear();
+	}
+
 	template<class T>
 	void Write(const T& data, const asio::chrono::steady_clock::duration& timeout)
 	{
@@ -1,10 +1,15 @@
 #pragma once
 
 #include <Common/Util/StringUtil.h>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace HTTP
 {
+// Used by Grin++ nodes for consensus-serialized request and response bodies.
+static constexpr const char* CONTENT_TYPE_BINARY = "application/octet-stream";
+
 enum class EHTTPMethod
 {
 	GET,
@@ -25,24 +30,33 @@ public:
 		const std::string& location,
 		const std::string& host,
 		const uint16_t port,
-		const std::string& body)
+		const std::string& body,
+		const std::string& contentType = "application/json-rpc",
+		const std::string& accept = "*/*")
 		: m_method(method),
 		m_location(location),
 		m_host(host),
 		m_port(port),
-		m_body(body) { }
+		m_body(body),
+		m_contentType(contentType),
+		m_accept(accept) { }
 
 	std::string ToString() const
 	{
 		return StringUtil::Format(
 			"{} {} HTTP/1.1\r\n"
 			"Host: {}\r\n"
+			"Connection: keep-alive\r\n"
+			"Accept: {}\r\n"
+			"Accept-Encoding: gzip\r\n"
 			"Content-Length: {}\r\n"
-			"Content-Type: application/json-rpc\r\n\r\n{}",
+			"Content-Type: {}\r\n\r\n{}",
 			m_method == EHTTPMethod::GET ? "GET" : "POST",
 			m_location,
 			m_host,
+			m_accept,
 			m_body.size(),
+			m_contentType,
 			m_body
 		);
 	}
@@ -56,6 +70,8 @@ private:
 	std::string m_host;
 	uint16_t m_port;
 	std::string m_body;
+	std::string m_contentType;
+	std::string m_accept;
 };
 
 class Response
@@ -68,6 +84,19 @@ public:
 	const std::vector<Header>& GetHeaders() const { return m_headers; }
 	const std::string& GetBody() const { return m_body; }
 
+	std::optional<std::string> GetHeaderValue(const std::string& type) const
+	{
+		for (const Header& header : m_headers)
+		{
+			if (StringUtil::ToLower(header.m_type) == StringUtil::ToLower(type))
+			{
+				return header.m_value;
+			}
+		}
+
+		return std::nullopt;
+	}
+
 private:
 	unsigned int m_statusCode;
 	std::vector<Header> m_headers;
@@ -3,99 +3,189 @@
 #include <Net/Clients/Client.h>
 #include <Net/Clients/HTTP/HTTP.h>
 #include <Net/Clients/HTTP/HTTPException.h>
+#include <Net/Util/GzipUtil.h>
 #include <Common/Logger.h>
 #include <Common/GrinStr.h>
 #include <sstream>
 
+//
+// Sends HTTP/1.1 requests, keeping the connection alive between them unless the server asks to close it.
+// A request on a kept-alive connection that fails before any response is read is retried once on a new connection,
+// since the server may have closed it while idle.
+//
+// Requests accept gzip, and gzipped bodies are decompressed before the response is returned.
+//
 class IHTTPClient : public Client<HTTP::Request, HTTP::Response>
 {
 public:
-	IHTTPClient() : m_connected(false) { }
+	// Protects against bodies that decompress to far more than could've been sent (ie. gzip bombs).
+	static constexpr size_t MAX_DECOMPRESSED_SIZE = 512 * 1024 * 1024;
+
+	IHTTPClient() : m_connected(false), m_port(0) { }
 	virtual ~IHTTPClient() = default;
 
 	HTTP::Response Invoke(const HTTP::Request& request) final
 	{
-		//WALLET_INFO_F("Request: {}", request.ToString());
 		try
 		{
-			//if (!m_connected)
+			const bool reused = IsConnected(request.GetHost(), request.GetPort());
+			Open(request.GetHost(), request.GetPort());
+
+			bool responseStarted = false;
+			try
+			{
+				return Send(request, responseStarted);
+			}
+			catch (std::exception& e)
 			{
-				std::this_thread::sleep_for(std::chrono::seconds(1));
-				EstablishConnection(request.GetHost(), request.GetPort());
-				WALLET_INFO("Connection established");
-				m_connected = true;
+				Disconnect();
+				if (!reused || responseStarted)
+				{
+					throw;
+				}
+
+				WALLET_DEBUG_F("Kept-alive connection failed ({}). Reconnecting.", e.what());
+				Open(request.GetHost(), request.GetPort());
+				return Send(request, responseStarted);
 			}
+		}
+		catch (HTTPException& e)
+		{
+			WALLET_INFO_F("HTTPException: {}", e.what());
+			throw e;
+		}
+		catch (std::exception& e)
+		{
+			WALLET_INFO_F("Exception: {}", e.what());
+			throw HTTP_EXCEPTION(e.what());
+		}
+	}
+
+	//
+	// Establishes the connection ahead of the first request, if not already connected.
+	//
+	void Open(const std::string& host, const uint16_t port)
+	{
+		if (!IsConnected(host, port))
+		{
+			Disconnect();
+			EstablishConnection(host, port);
+			WALLET_INFO("Connection established");
+			m_connected = true;
+			m_host = host;
+			m_port = port;
+		}
+	}
+
+	bool IsConnected() const noexcept { return m_connected && IsOpen(); }
+	bool IsConnected(const std::string& host, const uint16_t port) const noexcept
+	{
+		return IsConnected() && m_host == host && m_port == port;
+	}
+
+	void Disconnect()
+	{
+		Close();
+		m_connected = false;
+	}
+
+private:
+	virtual void EstablishConnection(const std::string& host, const uint16_t port) = 0;
+
+	HTTP::Response Send(const HTTP::Request& request, bool& responseStarted)
+	{
+		std::string lineToWrite = request.ToString();
+		Write(lineToWrite, asio::chrono::seconds(2));
 
-			std::string lineToWrite = request.ToString();
-			Write(lineToWrite, asio::chrono::seconds(2));
+		std::string responseLine = ReadLine(asio::chrono::seconds(10));
+		responseStarted = true;
+		std::istringstream responseStream(responseLine);
 
-			std::string responseLine = ReadLine(asio::chrono::seconds(10));
-			std::istringstream responseStream(responseLine);
+		std::string http_version;
+		responseStream >> http_version;
 
-			std::string http_version;
-			responseStream >> http_version;
+		unsigned int statusCode;
+		responseStream >> statusCode;
 
-			unsigned int statusCode;
-			responseStream >> statusCode;
+		std::string statusMessage;
+		std::getline(responseStream, statusMessage);
 
-			std::string statusMessage;
-			std::getline(responseStream, statusMessage);
+		size_t contentLength = 0;
+		bool gzipped = false;
 
-			size_t contentLength = 0;
+		// HTTP/1.0 servers close the connection after each response, unless they say otherwise.
+		bool keepAlive = http_version != "HTTP/1.0";
 
-			std::vector<HTTP::Header> headers;
-			GrinStr header = ReadLine(asio::chrono::seconds(1));
-			while (header != "\r")
+		std::vector<HTTP::Header> headers;
+		GrinStr header = ReadLine(asio::chrono::seconds(1));
+		while (header != "\r")
+		{
+			std::vector<GrinStr> headerParts = header.Split(":");
+			if (headerParts.size() < 2)
 			{
-				std::vector<GrinStr> headerParts = header.Split(":");
-				if (headerParts.size() < 2)
-				{
-					throw HTTP_EXCEPTION("Invalid header: " + header);
-				}
+				throw HTTP_EXCEPTION("Invalid header: " + header);
+			}
 
-				if (headerParts[0].Trim().ToLower() == "content-length")
+			const GrinStr headerType = headerParts[0].Trim().ToLower();
+			if (headerType == "content-length")
+			{
+				std::istringstream contentLengthStream(headerParts[1]);
+				contentLengthStream >> contentLength;
+			}
+			else if (headerType == "connection")
+			{
+				keepAlive = headerParts[1].Trim().ToLower() == "keep-alive";
+			}
+			else if (headerType == "content-encoding")
+			{
+				const GrinStr encoding = headerParts[1].Trim().ToLower();
+				if (encoding != "gzip" && encoding != "identity")
 				{
-					std::istringstream contentLengthStream(headerParts[1]);
-					contentLengthStream >> contentLength;
+					throw HTTP_EXCEPTION("Unsupported Content-Encoding: " + encoding);
 				}
 
-				headers.push_back(HTTP::Header{
-					headerParts[0].Trim(),
-					headerParts[1].Trim()
-				});
-
+				// The body is returned decompressed, so the header no longer applies.
+				gzipped = encoding == "gzip";
 				header = ReadLine(asio::chrono::seconds(1));
+				continue;
 			}
 
-			if (contentLength == 0)
-			{
-				throw HTTP_EXCEPTION("No Content-Length provided");
-			}
+			headers.push_back(HTTP::Header{
+				headerParts[0].Trim(),
+				headerParts[1].Trim()
+			});
 
-			std::vector<uint8_t> body = Read(contentLength, asio::chrono::seconds(2));
+			header = ReadLine(asio::chrono::seconds(1));
+		}
 
-			return HTTP::Response(
-				statusCode,
-				std::move(headers),
-				std::string(body.begin(), body.end())
-			);
+		if (contentLength == 0)
+		{
+			throw HTTP_EXCEPTION("No Content-Length provided");
 		}
-		catch (HTTPException& e)
+
+		std::vector<uint8_t> body = Read(contentLength, asio::chrono::seconds(2));
+
+		if (!keepAlive)
 		{
-			WALLET_INFO_F("HTTPException: {}", e.what());
-			throw e;
+			Disconnect();
 		}
-		catch (std::exception& e)
+
+		std::string bodyStr(body.begin(), body.end());
+		if (gzipped)
 		{
-			WALLET_INFO_F("Exception: {}", e.what());
-			throw HTTP_EXCEPTION(e.what());
+			bodyStr = GzipUtil::Decompress(bodyStr, MAX_DECOMPRESSED_SIZE);
 		}
-	}
 
-private:
-	virtual void EstablishConnection(const std::string& host, const uint16_t port) = 0;
+		return HTTP::Response(
+			statusCode,
+			std::move(headers),
+			std::move(bodyStr)
+		);
+	}
 
 	bool m_connected;
+	std::string m_host;
+	uint16_t m_port;
 };
 
 class HTTPClient : public IHTTPClient
@@ -1,9 +1,11 @@
 #pragma once
 
+#include <Common/Util/StringUtil.h>
 #include <exception>
 #include <string>
 
 #define HTTP_EXCEPTION(msg) HTTPException(__func__, msg)
+#define HTTP_EXCEPTION_F(msg, ...) HTTPException(__func__, StringUtil::Format(msg, __VA_ARGS__))
 
 class HTTPException : public std::exception
 {
@@ -17,7 +17,8 @@ enum ErrorCode
 	INVALID_REQUEST = -32600,	// Invalid Request
 	METHOD_NOT_FOUND = -32601,	// Method not found
 	INVALID_PARAMS = -32602,	// Invalid params
-	INTERNAL_ERROR = -32603		// Internal error
+	INTERNAL_ERROR = -32603,	// Internal error
+	SERVER_BUSY = -32000		// Server error: Too many long-running requests. Retry later.
 };
 
 class Error
@@ -182,17 +183,36 @@ class Request
 {
 public:
 	static Request Parse(mg_connection* pConnection)
+	{
+		std::optional<Json::Value> jsonOpt = HTTPUtil::GetRequestBody(pConnection);
+		if (!jsonOpt.has_value())
+		{
+			throw RPC_EXCEPTION("json missing or invalid", std::nullopt);
+		}
+
+		return Parse(std::move(jsonOpt.value()));
+	}
+
+	//
+	// Parses a single request, eg. one element of a batch.
+	//
+	static Request Parse(const Json::Value& json)
+	{
+		return Parse(Json::Value(json));
+	}
+
+	//
+	// Moves the params out of json rather than copying them, since they can be large (eg. slates and transactions).
+	//
+	static Request Parse(Json::Value&& json)
 	{
 		try
 		{
-			std::optional<Json::Value> jsonOpt = HTTPUtil::GetRequestBody(pConnection);
-			if (!jsonOpt.has_value())
+			if (!json.isObject())
 			{
-				throw RPC_EXCEPTION("json missing or invalid", std::nullopt);
+				throw RPC_EXCEPTION("request must be an object", std::nullopt);
 			}
 
-			const Json::Value& json = jsonOpt.value();
-
 			// Parse id
 			std::optional<Json::Value> idOpt = JsonUtil::GetOptionalField(json, "id");
 			if (!idOpt.has_value())
@@ -237,7 +257,12 @@ public:
 			}
 
 			// Parse params
-			std::optional<Json::Value> paramsOpt = JsonUtil::GetOptionalField(json, "params");
+			std::optional<Json::Value> paramsOpt = std::nullopt;
+			Json::Value* pParams = json.isMember("params") ? &json["params"] : nullptr;
+			if (pParams != nullptr && !pParams->isNull())
+			{
+				paramsOpt = std::make_optional<Json::Value>(std::move(*pParams));
+			}
 
 			return Request(std::move(id), method, std::move(paramsOpt));
 		}
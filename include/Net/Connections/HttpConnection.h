@@ -8,7 +8,7 @@ public:
 	using UPtr = std::unique_ptr<HttpConnection>;
 
 	HttpConnection(const std::string& host, const uint16_t port)
-		: m_host(host), m_port(port) { }
+		: m_host(host), m_port(port), m_pHttpClient(std::make_shared<HTTPClient>()), m_rpcClient(m_pHttpClient) { }
 
 	static HttpConnection::UPtr Connect(const std::string& host, const uint16_t port)
 	{
@@ -41,8 +41,38 @@ public:
 		return Invoke(RPC::Request::BuildRequest(method));
 	}
 
+	//
+	// Sends a consensus-serialized request to one of the node's REST APIs, over the same connection as the RPCs.
+	// Throws an HTTPException unless the node responds with a binary body.
+	//
+	std::vector<uint8_t> InvokeBinary(const HTTP::EHTTPMethod method, const std::string& location, const std::vector<uint8_t>& body = {})
+	{
+		const HTTP::Request request(
+			method,
+			location,
+			m_host,
+			m_port,
+			std::string(body.begin(), body.end()),
+			HTTP::CONTENT_TYPE_BINARY,
+			HTTP::CONTENT_TYPE_BINARY
+		);
+		const HTTP::Response response = m_pHttpClient->Invoke(request);
+		if (response.GetStatusCode() != 200)
+		{
+			throw HTTP_EXCEPTION(StringUtil::Format("{} failed with status {}", location, response.GetStatusCode()));
+		}
+
+		if (response.GetHeaderValue("Content-Type").value_or("") != HTTP::CONTENT_TYPE_BINARY)
+		{
+			throw HTTP_EXCEPTION(StringUtil::Format("{} does not support binary responses", location));
+		}
+
+		return std::vector<uint8_t>(response.GetBody().begin(), response.GetBody().end());
+	}
+
 private:
 	std::string m_host;
 	uint16_t m_port;
+	std::shared_ptr<IHTTPClient> m_pHttpClient;
 	HttpRpcClient m_rpcClient;
 };
\ No newline at end of file
@@ -14,4 +14,10 @@ public:
 	// NOTE: Errors could still be logged, so never store secrets in exceptions or RPC errors.
 	//
 	virtual bool ContainsSecrets() const noexcept = 0;
+
+	//
+	// If true, the request may occupy a server thread for a long time (eg. key derivation or TOR round trips),
+	// so the number of them handled at once is limited by HttpServerConfig::GetMaxLongRunning.
+	//
+	virtual bool IsLongRunning() const noexcept { return false; }
 };
\ No newline at end of file
@@ -5,7 +5,9 @@
 #include <Net/Clients/RPC/RPC.h>
 #include <Core/Exceptions/APIException.h>
 #include <unordered_map>
+#include <atomic>
 #include <cassert>
+#include <memory>
 
 #define RPC_LOG_INFO_F(logFile, message, ...) LoggerAPI::LogInfo(logFile, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
 #define RPC_LOG_ERROR_F(logFile, message, ...) LoggerAPI::LogError(logFile, __func__, __LINE__, StringUtil::Format(message, __VA_ARGS__))
@@ -19,9 +21,10 @@ public:
 		const EServerType type,
 		const std::optional<uint16_t>& port,
 		const std::string& uri,
-		const LoggerAPI::LogFile& logFile)
+		const LoggerAPI::LogFile& logFile,
+		const HttpServerConfig& config = HttpServerConfig())
 	{
-		ServerPtr pServer = Server::Create(type, port);
+		ServerPtr pServer = Server::Create(type, port, config);
 		return RPCServer::Create(pServer, uri, logFile);
 	}
 
@@ -37,6 +40,17 @@ public:
 		return pRPCServer;
 	}
 
+	//
+	// Creates an RPCServer on pServer without adding a listener for it, for when one listener routes requests
+	// between several RPCServers (eg. the foreign APIs of hosted wallets, by Host header), passing them to HandleRequest.
+	//
+	static RPCServer::Ptr CreateUnlistened(const ServerPtr& pServer, const LoggerAPI::LogFile& logFile)
+	{
+		return std::shared_ptr<RPCServer>(new RPCServer(pServer, logFile));
+	}
+
+	int HandleRequest(mg_connection* pConnection) { return APIHandler(pConnection, this); }
+
 	uint16_t GetPortNumber() const noexcept { return m_pServer->GetPortNumber(); }
 
 	void AddMethod(const std::string& method, std::shared_ptr<RPCMethod> pMethod) noexcept
@@ -48,24 +62,64 @@ public:
 
 private:
 	RPCServer(const ServerPtr& pServer, const LoggerAPI::LogFile& logFile)
-		: m_pServer(pServer), m_logFile(logFile) { }
+		: m_pServer(pServer), m_logFile(logFile), m_numLongRunning(0) { }
+
+	// Holds one of the server's long-running slots until destroyed.
+	class LongRunningSlot
+	{
+	public:
+		LongRunningSlot(std::atomic<uint32_t>& numLongRunning) : m_numLongRunning(numLongRunning) { }
+		~LongRunningSlot() { --m_numLongRunning; }
+
+	private:
+		std::atomic<uint32_t>& m_numLongRunning;
+	};
+
+	std::unique_ptr<LongRunningSlot> TryReserveLongRunning()
+	{
+		if (++m_numLongRunning > m_pServer->GetConfig().GetMaxLongRunning())
+		{
+			--m_numLongRunning;
+			return nullptr;
+		}
+
+		return std::make_unique<LongRunningSlot>(m_numLongRunning);
+	}
 
 	static int APIHandler(mg_connection* pConnection, void* pCbContext)
 	{
 		RPCServer* pInstance = static_cast<RPCServer*>(pCbContext);
 		assert(pInstance != nullptr);
 
-		Json::Value responseJSON = Handle(pConnection, *pInstance).ToJSON();
+		std::optional<Json::Value> jsonOpt = HTTPUtil::GetRequestBody(pConnection);
+		if (jsonOpt.has_value() && jsonOpt.value().isArray() && !jsonOpt.value().empty())
+		{
+			// Batch: The requests are handled in order, and replied to with an array of their responses.
+			Json::Value responsesJSON = Json::arrayValue;
+			for (Json::Value& requestJSON : jsonOpt.value())
+			{
+				responsesJSON.append(Handle(std::make_optional(std::move(requestJSON)), *pInstance).ToJSON());
+			}
+
+			return HTTPUtil::BuildSuccessResponseJSON(pConnection, responsesJSON);
+		}
+
+		Json::Value responseJSON = Handle(std::move(jsonOpt), *pInstance).ToJSON();
 
 		return HTTPUtil::BuildSuccessResponseJSON(pConnection, responseJSON);
 	}
 
-	static RPC::Response Handle(mg_connection* pConnection, RPCServer& instance)
+	static RPC::Response Handle(std::optional<Json::Value>&& jsonOpt, RPCServer& instance)
 	{
 		Json::Value id(Json::nullValue);
 		try
 		{
-			RPC::Request request = RPC::Request::Parse(pConnection);
+			if (!jsonOpt.has_value())
+			{
+				throw RPC_EXCEPTION("json missing or invalid", std::nullopt);
+			}
+
+			RPC::Request request = RPC::Request::Parse(std::move(jsonOpt.value()));
 			id = request.GetId();
 			try
 			{
@@ -85,7 +139,21 @@ private:
 							method
 						);
 					}
-					
+
+					std::unique_ptr<LongRunningSlot> pSlot = nullptr;
+					if (iter->second->IsLongRunning())
+					{
+						pSlot = instance.TryReserveLongRunning();
+						if (pSlot == nullptr)
+						{
+							RPC_LOG_ERROR_F(instance.m_logFile, "Too many long-running requests. Rejected: {}", method);
+							return request.BuildError(
+								RPC::ErrorCode::SERVER_BUSY,
+								"Server busy. Try again later."
+							);
+						}
+					}
+
 					auto response = iter->second->Handle(request);
 
 					if (!iter->second->ContainsSecrets())
@@ -154,6 +222,7 @@ private:
 	ServerPtr m_pServer;
 	std::unordered_map<std::string, std::shared_ptr<RPCMethod>> m_methods;
 	LoggerAPI::LogFile m_logFile;
+	std::atomic<uint32_t> m_numLongRunning;
 };
 
 typedef std::shared_ptr<RPCServer> RPCServerPtr;
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <Config/HttpServerConfig.h>
 #include <cassert>
 #include <string>
 #include <optional>
@@ -19,23 +20,30 @@ typedef int(*mg_request_handler)(struct mg_connection* conn, void* cbdata);
 class Server
 {
 public:
-	static std::shared_ptr<Server> Create(const EServerType type, const std::optional<uint16_t>& port);
+	static std::shared_ptr<Server> Create(
+		const EServerType type,
+		const std::optional<uint16_t>& port,
+		const HttpServerConfig& config = HttpServerConfig()
+	);
 	virtual ~Server();
 
 	uint16_t GetPortNumber() const noexcept { return m_portNumber; }
+	const HttpServerConfig& GetConfig() const noexcept { return *m_pConfig; }
 
 	void AddListener(const std::string& uri, mg_request_handler handler, void* pCallbackData) noexcept;
 
 private:
-	Server(mg_context* pContext, const uint16_t portNumber)
-		: m_pContext(pContext), m_portNumber(portNumber)
+	Server(mg_context* pContext, const uint16_t portNumber, std::unique_ptr<const HttpServerConfig>&& pConfig)
+		: m_pContext(pContext), m_portNumber(portNumber), m_pConfig(std::move(pConfig))
 	{
 		assert(pContext != nullptr);
 		assert(portNumber > 0);
+		assert(m_pConfig != nullptr);
 	}
 
 	mg_context* m_pContext;
 	uint16_t m_portNumber;
+	std::unique_ptr<const HttpServerConfig> m_pConfig;
 };
 
 typedef std::shared_ptr<Server> ServerPtr;
\ No newline at end of file
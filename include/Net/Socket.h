@@ -9,6 +9,7 @@
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <chrono>
 #include <shared_mutex>
 
 #include <asio.hpp>
@@ -25,9 +26,38 @@ public:
 		NON_BLOCKING
 	};
 
-	bool Connect(std::shared_ptr<asio::io_context> pContext);
+	//
+	// Gives up on the connection if it isn't established within the timeout.
+	// When localIP is given, the connection is made from that (IPv4) address rather than one chosen by the OS.
+	//
+	bool Connect(
+		std::shared_ptr<asio::io_context> pContext,
+		const std::chrono::milliseconds& timeout = std::chrono::seconds(3),
+		const std::string& localIP = ""
+	);
 	bool Accept(std::shared_ptr<asio::io_context> pContext, asio::ip::tcp::acceptor& acceptor, const std::atomic_bool& terminate);
 
+	//
+	// Moves the connected socket onto the given io_context, so it can be driven by that context's threads.
+	//
+	bool Attach(std::shared_ptr<asio::io_context> pContext);
+
+	//
+	// Asynchronously waits until the socket is readable (data has arrived, or the peer closed the connection).
+	// The handler is invoked with the error_code on the handler's associated executor.
+	//
+	template<typename Handler>
+	void AsyncWaitForData(Handler&& handler)
+	{
+		std::shared_lock<std::shared_mutex> readLock(m_mutex);
+		m_pSocket->async_wait(asio::socket_base::wait_read, std::forward<Handler>(handler));
+	}
+
+	//
+	// Cancels any outstanding asynchronous operations. Their handlers are invoked with asio::error::operation_aborted.
+	//
+	void Cancel();
+
 	bool CloseSocket();
 	bool IsSocketOpen() const;
 	bool IsActive() const;
@@ -53,7 +83,30 @@ public:
 
 	bool Send(const std::vector<uint8_t>& message, const bool incrementCount);
 
+	//
+	// Writes all of the messages with a single gathered write.
+	// When incrementCount is true, each message counts towards the rate limit individually.
+	//
+	bool Send(const std::vector<std::shared_ptr<const std::vector<uint8_t>>>& messages, const bool incrementCount);
+
+	//
+	// Received bytes are read ahead into a per-socket buffer with as few reads as possible,
+	// so a burst of small messages (pings, announcements, peer addresses) costs a single recv instead of two per message.
+	// HasReceivedData and GetNumBytesAvailable count the bytes already in that buffer.
+	//
 	bool HasReceivedData();
+	size_t GetNumBytesAvailable();
+
+	//
+	// True if a message header has already been read into the buffer.
+	// AsyncWaitForData only fires for data the socket hasn't read yet, so callers check this before waiting.
+	//
+	bool HasBufferedData() const;
+
+	//
+	// Payloads of at least READ_AHEAD_SIZE bytes are read straight into data (eg. a pooled message buffer),
+	// rather than copied through the read-ahead buffer.
+	//
 	bool Receive(
 		const size_t numBytes,
 		const bool incrementCount,
@@ -61,7 +114,21 @@ public:
 		std::vector<uint8_t>& data
 	);
 
+	//
+	// Copies up to numBytes into pOut from what has already arrived, without waiting for more.
+	// Returns the number of bytes copied, and throws a SocketException if the connection failed.
+	//
+	size_t ReceiveAvailable(const size_t numBytes, uint8_t* pOut);
+
+	static const size_t READ_AHEAD_SIZE = 32 * 1024;
+
 private:
+	// Copies up to numBytes out of the read-ahead buffer. Must be called with m_mutex held.
+	size_t TakeBuffered(uint8_t* pOut, const size_t numBytes);
+
+	// Refills the (empty) read-ahead buffer with at least minBytes. Must be called with m_mutex held.
+	void FillReadAhead(const size_t minBytes);
+
 	std::shared_ptr<asio::ip::tcp::socket> m_pSocket;
 	std::shared_ptr<asio::io_context> m_pContext;
 
@@ -75,6 +142,10 @@ private:
 	mutable std::shared_mutex m_mutex;
 	asio::error_code m_errorCode;
 	bool m_socketOpen;
+
+	std::vector<uint8_t> m_readAhead;
+	size_t m_readAheadBegin;
+	size_t m_readAheadEnd;
 };
 
 typedef std::shared_ptr<Socket> SocketPtr;
\ No newline at end of file
@@ -4,11 +4,18 @@
 #include <Net/Clients/RPC/RPC.h>
 #include <Net/Tor/TorAddress.h>
 #include <Net/Tor/TorException.h>
+#include <chrono>
 #include <memory>
+#include <mutex>
 
 // Forward Declarations
+class IHTTPClient;
 class HttpRpcClient;
 
+//
+// A kept-alive connection to a hidden service through the tor SOCKS proxy.
+// Requests on the same connection are serialized, and reuse its circuit until it's closed.
+//
 class TorConnection
 {
 public:
@@ -16,9 +23,25 @@ public:
 
 	RPC::Response Invoke(const RPC::Request& request, const std::string& location);
 
+	//
+	// Builds the circuit and connects to the hidden service, without sending a request.
+	//
+	void Open();
+
+	//
+	// True if the connection hasn't been used (or is no longer open) within the given timeout.
+	//
+	bool IsIdle(const std::chrono::steady_clock::duration& timeout) const;
+
+	const TorAddress& GetAddress() const noexcept { return m_address; }
+
 private:
 	TorAddress m_address;
+	std::shared_ptr<IHTTPClient> m_pHttpClient;
 	std::shared_ptr<HttpRpcClient> m_pRpcClient;
+
+	mutable std::mutex m_mutex;
+	std::chrono::steady_clock::time_point m_lastUsed;
 };
 
-typedef std::shared_ptr<TorConnection> TorConnectionPtr;
\ No newline at end of file
+typedef std::shared_ptr<TorConnection> TorConnectionPtr;
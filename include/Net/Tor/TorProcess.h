@@ -2,9 +2,16 @@
 
 #include <Crypto/Models/ed25519_secret_key.h>
 #include <Net/Tor/TorAddress.h>
+#include <Common/ThreadPool.h>
 
+#include <chrono>
+#include <condition_variable>
 #include <thread>
 #include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 // Forward Declarations
 class TorControl;
@@ -25,19 +32,61 @@ public:
 
 	std::shared_ptr<TorAddress> AddListener(const ed25519_secret_key_t& secretKey, const uint16_t portNumber);
 	std::shared_ptr<TorAddress> AddListener(const std::string& serializedKey, const uint16_t portNumber);
+
+	//
+	// Re-adds a listener that was previously added with one of the above, using its cached key,
+	// so the key doesn't need to be derived from the seed again. Returns nullptr if the key isn't cached.
+	//
+	std::shared_ptr<TorAddress> AddListener(const TorAddress& torAddress, const uint16_t portNumber);
 	bool RemoveListener(const TorAddress& torAddress);
 
+	//
+	// Queues the listener to be added, and returns its address, which is derived from the key, without waiting for tor.
+	// Returns std::nullopt if tor isn't running. Queued additions and removals are sent on a background thread,
+	// each batch pipelined over the control connection, so logins and logouts that arrive together share one round trip.
+	// Failures are only logged. A listener queued again before its batch is sent replaces the queued change.
+	//
+	std::optional<TorAddress> AddListenerAsync(const ed25519_secret_key_t& secretKey, const uint16_t portNumber);
+	void RemoveListenerAsync(const TorAddress& torAddress);
+
+	//
+	// Returns the kept-alive connection to the address, creating a new one if there is none,
+	// or if it's been idle longer than TOR_CONNECTION_IDLE_TIMEOUT.
+	//
 	std::shared_ptr<TorConnection> Connect(const TorAddress& address);
 
+	//
+	// Opens connections to each of the addresses in parallel, so their circuits are built
+	// by the time they're needed. Returns without waiting for them.
+	//
+	void PrewarmConnections(const std::vector<TorAddress>& addresses);
+
 	// Returns true if TorControl connection is established.
 	bool RetryInit();
 
+	//
+	// Blocks until tor has bootstrapped, or it's no longer trying to.
+	// Returns true if it's bootstrapped.
+	//
+	bool WaitForBootstrap(const std::chrono::seconds& timeout);
+
 private:
 	TorProcess(const fs::path& torDataPath, const uint16_t socksPort, const uint16_t controlPort)
-		: m_torDataPath(torDataPath), m_socksPort(socksPort), m_controlPort(controlPort), m_pControl(nullptr) { }
+		: m_torDataPath(torDataPath), m_socksPort(socksPort), m_controlPort(controlPort), m_pControl(nullptr),
+		m_sendingChanges(false), m_bootstrapping(true), m_bootstrapped(false), m_pConnectPool(ThreadPool::Create("TOR_CONNECT", 4)) { }
+
+	// Kept below the foreign servers' keep-alive timeout, so cached connections are rarely closed under us.
+	static constexpr std::chrono::seconds TOR_CONNECTION_IDLE_TIMEOUT{ 10 };
+
+	static constexpr std::chrono::seconds TOR_BOOTSTRAP_TIMEOUT{ 60 };
 
 	static void Thread_Initialize(TorProcess* pProcess);
+	static bool WaitForPortsToClose(const uint16_t socksPort, const uint16_t controlPort);
+	void StartBootstrapDetection(const std::shared_ptr<TorControl>& pControl);
+	void SetBootstrapped(const bool bootstrapped);
 	static bool IsPortOpen(const uint16_t port);
+	void QueueListenerChange(const TorAddress& torAddress, std::optional<std::string>&& serializedKey, const uint16_t portNumber);
+	void SendListenerChanges();
 
 	fs::path m_torDataPath;
 	uint16_t m_socksPort;
@@ -46,4 +95,31 @@ private:
 
 	std::mutex m_mutex;
 	std::thread m_initThread;
+
+	// Serialized hidden service keys, by the address of the listener they were added for.
+	std::unordered_map<std::string, std::string> m_listenerKeys;
+
+	// Addresses of the listeners tor currently has, so changes that wouldn't do anything aren't sent.
+	std::unordered_set<std::string> m_activeListeners;
+
+	// A queued addition, or a removal if there's no key.
+	struct ListenerChange
+	{
+		TorAddress address;
+		std::optional<std::string> serializedKey;
+		uint16_t portNumber;
+	};
+
+	std::mutex m_queuedMutex;
+	std::unordered_map<std::string, ListenerChange> m_queuedChanges;
+	bool m_sendingChanges;
+
+	std::mutex m_bootstrapMutex;
+	std::condition_variable m_bootstrapCV;
+	bool m_bootstrapping;
+	bool m_bootstrapped;
+
+	std::mutex m_connectionsMutex;
+	std::unordered_map<std::string, std::shared_ptr<TorConnection>> m_connections;
+	ThreadPool::Ptr m_pConnectPool;
 };
\ No newline at end of file
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+//
+// Compresses HTTP bodies for "Content-Encoding: gzip", and decompresses them on the client.
+// Errors are thrown as HTTPExceptions.
+//
+class GzipUtil
+{
+public:
+	static std::string Compress(const std::string& data);
+	static std::string Compress(const void* pData, const size_t numBytes);
+
+	//
+	// Throws if the body is not valid gzip, or decompresses to more than maxSize bytes.
+	//
+	static std::string Decompress(const std::string& data, const size_t maxSize);
+};
+
+//
+// Compresses a body that's written in parts (eg. a chunked response) into a single gzip stream.
+// Each call to Write returns the compressed bytes for everything written so far, so each chunk can be decompressed as it arrives.
+//
+class GzipEncoder
+{
+public:
+	GzipEncoder();
+	~GzipEncoder();
+
+	std::string Write(const void* pData, const size_t numBytes);
+
+	//
+	// Returns the last of the compressed bytes, followed by the gzip trailer.
+	//
+	std::string Finish();
+
+private:
+	std::string Deflate(const void* pData, const size_t numBytes, const int flush);
+
+	struct Stream;
+	std::unique_ptr<Stream> m_pStream;
+	bool m_finished;
+};
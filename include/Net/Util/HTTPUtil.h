@@ -4,6 +4,7 @@
 #include <json/json.h>
 #include <cassert>
 #include <string>
+#include <vector>
 #include <optional>
 
 // Forward Declarations
@@ -20,13 +21,37 @@ public:
 	static std::optional<std::string> GetQueryParam(mg_connection* conn, const std::string& parameterName);
 	static std::optional<std::string> GetHeaderValue(mg_connection* conn, const std::string& headerName);
 	static HTTP::EHTTPMethod GetHTTPMethod(mg_connection* conn);
+
+	//
+	// Parses the JSON body straight from a per-thread buffer, which is reused across requests on the same server thread.
+	//
 	static std::optional<Json::Value> GetRequestBody(mg_connection* conn);
+	static std::vector<uint8_t> GetRequestBytes(mg_connection* conn);
+
+	//
+	// Reads the body into buffer, replacing its contents, but keeping its capacity.
+	//
+	static void ReadRequestBody(mg_connection* conn, std::string& buffer);
+
+	// Whether the client asked for a binary (consensus-serialized) response instead of JSON.
+	static bool AcceptsBinary(mg_connection* conn);
+
+	//
+	// Whether the client sent "Accept-Encoding: gzip", and the server has compression enabled (see HttpServerConfig::GetGzipMinBytes).
+	// Successful responses of at least GetGzipMinBytes are then compressed by the BuildSuccessResponse* functions.
+	//
+	static bool AcceptsGzip(mg_connection* conn);
 
 	static int BuildSuccessResponseJSON(mg_connection* conn, const Json::Value& json);
 	static int BuildSuccessResponse(mg_connection* conn, const std::string& response);
+	static int BuildSuccessResponseText(mg_connection* conn, const std::string& response);
+	static int BuildSuccessResponseBinary(mg_connection* conn, const std::vector<uint8_t>& response);
 	static int BuildBadRequestResponse(mg_connection* conn, const std::string& response);
 	static int BuildConflictResponse(mg_connection* conn, const std::string& response);
 	static int BuildUnauthorizedResponse(mg_connection* conn, const std::string& response);
 	static int BuildNotFoundResponse(mg_connection* conn, const std::string& response);
 	static int BuildInternalErrorResponse(mg_connection* conn, const std::string& response);
+
+private:
+	static int BuildSuccessResponse(mg_connection* conn, const char* contentType, const void* pData, const size_t numBytes);
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <json/json.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Forward Declarations
+struct mg_connection;
+class GzipEncoder;
+
+//
+// Writes a successful JSON response directly to the connection, using chunked transfer encoding,
+// so large responses never need to be built up as a single Json::Value or string.
+//
+// Output is compact unless styled is requested, in which case it's indented like Json::Value::toStyledString().
+// Nothing is sent until the first chunk is full or Finish is called, so if an exception is thrown
+// before then, callers can still respond with an error instead (see HasStarted).
+//
+// The chunks are gzipped as one stream when the client accepts it (see HTTPUtil::AcceptsGzip).
+//
+class JsonStreamWriter
+{
+public:
+	JsonStreamWriter(mg_connection* pConnection, const bool styled);
+	~JsonStreamWriter();
+
+	//
+	// Uses styled output when the request includes the "pretty" query parameter.
+	//
+	static std::unique_ptr<JsonStreamWriter> Create(mg_connection* pConnection);
+
+	void BeginObject();
+	void EndObject();
+	void BeginArray();
+	void EndArray();
+
+	void Key(const std::string& key);
+	void Value(const Json::Value& value);
+	void Member(const std::string& key, const Json::Value& value)
+	{
+		Key(key);
+		Value(value);
+	}
+
+	bool HasStarted() const noexcept { return m_started; }
+
+	//
+	// Flushes any buffered output and ends the chunked response.
+	// Returns the HTTP status code, like the HTTPUtil::Build*Response functions.
+	//
+	int Finish();
+
+private:
+	void BeginElement();
+	void Close(const char closer);
+	void NewLine();
+	void Flush();
+	void WriteChunk(const std::string& chunk);
+
+	mg_connection* m_pConnection;
+	bool m_styled;
+	std::unique_ptr<Json::StreamWriter> m_pValueWriter;
+	std::unique_ptr<GzipEncoder> m_pEncoder;
+
+	std::string m_buffer;
+	bool m_started;
+	bool m_finished;
+
+	// For each open object or array, whether it has any elements yet.
+	std::vector<bool> m_hasElements;
+	bool m_afterKey;
+};
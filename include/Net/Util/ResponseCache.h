@@ -0,0 +1,110 @@
+#pragma once
+
+#include <Common/CacheStats.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+//
+// Pre-rendered bodies for API responses that only change along with the chain tip or the mempool,
+// so frequently polled endpoints (eg. /v1/status) don't take locks and rebuild the same JSON on every request.
+//
+// Each body is kept with the Version of the state it was rendered from, and served until a request arrives with a different one.
+// A body that also reports fast-changing counters (eg. connected peers) can be given a maxAge, after which it's re-rendered anyway.
+//
+class ResponseCache
+{
+public:
+	using Ptr = std::shared_ptr<ResponseCache>;
+
+	//
+	// The state a body was rendered from. Fields a body doesn't depend on are left as 0.
+	//
+	struct Version
+	{
+		// ChainSnapshot::GetGeneration, which changes along with the confirmed tip.
+		uint64_t chainGeneration;
+		uint64_t candidateHeight;
+
+		// ITransactionPool::GetEventSequence, which changes along with the mempool and stempool.
+		uint64_t txPoolSequence;
+
+		bool operator==(const Version& rhs) const noexcept
+		{
+			return chainGeneration == rhs.chainGeneration && candidateHeight == rhs.candidateHeight && txPoolSequence == rhs.txPoolSequence;
+		}
+	};
+
+	ResponseCache() : m_hits(0), m_misses(0) { }
+
+	//
+	// Returns the body cached under key, if it was rendered for version (and less than maxAge ago, unless maxAge is 0).
+	// Otherwise, calls render and caches its result. render runs without the lock, so concurrent misses may each render,
+	// but only one body is kept. Nothing is cached if render throws.
+	//
+	std::shared_ptr<const std::string> Get(
+		const std::string& key,
+		const Version& version,
+		const std::function<std::string()>& render,
+		const std::chrono::milliseconds& maxAge = std::chrono::milliseconds(0))
+	{
+		const auto now = std::chrono::steady_clock::now();
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			auto iter = m_entries.find(key);
+			if (iter != m_entries.end() && iter->second.version == version
+				&& (maxAge.count() == 0 || now - iter->second.renderedAt < maxAge))
+			{
+				++m_hits;
+				return iter->second.pBody;
+			}
+		}
+
+		++m_misses;
+		auto pBody = std::make_shared<const std::string>(render());
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_entries.size() >= MAX_ENTRIES && m_entries.find(key) == m_entries.end())
+		{
+			// Keys can include query strings, so entries rendered for older versions are dropped to make room.
+			for (auto iter = m_entries.begin(); iter != m_entries.end();)
+			{
+				iter = iter->second.version == version ? std::next(iter) : m_entries.erase(iter);
+			}
+
+			if (m_entries.size() >= MAX_ENTRIES)
+			{
+				return pBody;
+			}
+		}
+
+		m_entries[key] = Entry{ version, now, pBody };
+		return pBody;
+	}
+
+	CacheStats GetStats() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return CacheStats{ MAX_ENTRIES, m_entries.size(), m_hits, m_misses };
+	}
+
+private:
+	static constexpr size_t MAX_ENTRIES = 256;
+
+	struct Entry
+	{
+		Version version;
+		std::chrono::steady_clock::time_point renderedAt;
+		std::shared_ptr<const std::string> pBody;
+	};
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, Entry> m_entries;
+
+	std::atomic<uint64_t> m_hits;
+	std::atomic<uint64_t> m_misses;
+};
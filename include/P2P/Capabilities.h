@@ -22,6 +22,15 @@ public:
 		// Can provide a list of healthy peers
 		PEER_LIST = 0x04,
 
+		// Accepts deflated header and block messages (Grin++ only). A high bit, so it can't collide with bits other implementations assign.
+		COMPRESSION = 0x10000,
+
+		// Accepts compact blocks for new tips without first being sent the header (Grin++ only).
+		COMPACT_BLOCK_PUSH = 0x20000,
+
+		// Accepts GetTransactions messages, which request several transactions by kernel hash at once (Grin++ only).
+		TX_BATCH_REQUESTS = 0x40000,
+
 		FAST_SYNC_NODE = (TXHASHET_HIST | PEER_LIST),
 
 		ARCHIVE_NODE = (FULL_HIST | TXHASHET_HIST | PEER_LIST)
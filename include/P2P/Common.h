@@ -32,6 +32,9 @@ namespace P2P
 	// Maximum number of block header hashes to send as part of a locator
 	static const uint32_t MAX_LOCATORS = 20;
 
+	// Maximum number of kernel hashes to ask for in a single GetTransactions message
+	static const uint32_t MAX_TX_REQUESTS = 256;
+
 	// How long a banned peer should be banned for
 	static const int64_t BAN_WINDOW = 10800;
 
@@ -2,18 +2,19 @@
 
 #include <P2P/Peer.h>
 #include <P2P/Direction.h>
+#include <P2P/PeerStats.h>
 #include <Core/Traits/Printable.h>
 
 class ConnectedPeer : public Traits::IPrintable
 {
 public:
 	ConnectedPeer(PeerPtr peer, const EDirection direction, const uint16_t portNumber)
-		: m_pPeer(peer), m_direction(direction), m_portNumber(portNumber), m_totalDifficulty(0), m_height(0)
+		: m_pPeer(peer), m_direction(direction), m_portNumber(portNumber), m_totalDifficulty(0), m_height(0), m_pStats(std::make_shared<PeerStats>())
 	{
 
 	}
 	ConnectedPeer(const ConnectedPeer& peer)
-		: m_pPeer(peer.m_pPeer), m_direction(peer.m_direction), m_portNumber(peer.m_portNumber), m_totalDifficulty(peer.m_totalDifficulty.load()), m_height(peer.m_height.load())
+		: m_pPeer(peer.m_pPeer), m_direction(peer.m_direction), m_portNumber(peer.m_portNumber), m_totalDifficulty(peer.m_totalDifficulty.load()), m_height(peer.m_height.load()), m_pStats(peer.m_pStats)
 	{
 
 	}
@@ -33,6 +34,7 @@ public:
 	uint64_t GetTotalDifficulty() const noexcept { return m_totalDifficulty.load(); }
 	uint64_t GetHeight() const noexcept { return m_height.load(); }
 	uint32_t GetProtocolVersion() const noexcept { return m_pPeer->GetVersion(); }
+	PeerStats& GetStats() const noexcept { return *m_pStats; }
 
 	void UpdateVersion(const uint32_t version) { m_pPeer->UpdateVersion(version); }
 	void UpdateCapabilities(const Capabilities& capabilities) { m_pPeer->UpdateCapabilities(capabilities); }
@@ -45,6 +47,7 @@ public:
 		json["direction"] = GetDirection() == EDirection::OUTBOUND ? "Outbound" : "Inbound";
 		json["total_difficulty"] = GetTotalDifficulty();
 		json["height"] = GetHeight();
+		json["stats"] = m_pStats->ToJSON();
 		return json;
 	}
 
@@ -56,5 +59,5 @@ private:
 	uint16_t m_portNumber;
 	std::atomic<uint64_t> m_totalDifficulty;
 	std::atomic<uint64_t> m_height;
-	// TODO: Add Connection Stats
+	PeerStats::Ptr m_pStats;
 };
\ No newline at end of file
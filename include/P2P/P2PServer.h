@@ -7,11 +7,13 @@
 #include <Common/ImportExport.h>
 #include <Crypto/BigInteger.h>
 #include <Core/Models/BlockHeader.h>
+#include <Core/Models/CompactBlock.h>
 #include <P2P/SyncStatus.h>
 #include <P2P/Peer.h>
 #include <P2P/ConnectedPeer.h>
 #include <TxPool/TransactionPool.h>
 #include <Database/Database.h>
+#include <Common/CacheStats.h>
 #include <optional>
 
 #ifdef MW_P2P
@@ -61,6 +63,29 @@ public:
 	virtual bool UnbanAllPeers() = 0;
 
 	virtual void BroadcastTransaction(const TransactionPtr& pTransaction) = 0;
+
+	//
+	// Announces a block added locally (eg. mined, or submitted through the API) to every peer, the same way relayed blocks are.
+	//
+	virtual void BroadcastBlock(const CompactBlock& compactBlock) = 0;
+
+	//
+	// Usage of the cache of serialized headers that GetHeaders requests are answered from.
+	//
+	virtual CacheStats GetHeaderCacheStats() const = 0;
+
+	//
+	// The average rate headers were served to peers (and through GetSerializedHeaders) at over the last few seconds.
+	//
+	virtual uint64_t GetServedHeaderBytesPerSecond() const = 0;
+
+	//
+	// Returns up to numHeaders (capped at MAX_HEADERS_PER_REQUEST) candidate chain headers starting at firstHeight,
+	// serialized back to back, from the same cache as GetHeaders requests. Stops early if the candidate chain ends.
+	// numHeadersFound is set to the number of headers returned.
+	//
+	static constexpr uint64_t MAX_HEADERS_PER_REQUEST = 2048;
+	virtual std::vector<uint8_t> GetSerializedHeaders(const uint64_t firstHeight, const uint64_t numHeaders, uint64_t& numHeadersFound) const = 0;
 };
 
 typedef std::shared_ptr<IP2PServer> IP2PServerPtr;
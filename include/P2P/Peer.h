@@ -85,6 +85,7 @@ public:
 		m_lastBanTime = other.m_lastBanTime.load();
 		m_banReason = other.m_banReason.load();
 		m_lastTxHashSetRequest = other.m_lastTxHashSetRequest.load();
+		m_throughputScore = other.m_throughputScore.load();
 		return *this;
 	}
 	Peer& operator=(Peer&& other) = default;
@@ -118,6 +119,7 @@ public:
 	}
 	void UpdateUserAgent(const std::string& userAgent) noexcept { m_userAgent = userAgent; }
 	void UpdateLastTxHashSetRequest() noexcept { m_lastTxHashSetRequest = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()); }
+	void UpdateThroughputScore(const double score) noexcept { m_throughputScore = score; }
 
 	//
 	// Getters
@@ -132,6 +134,7 @@ public:
 	std::time_t GetLastBanTime() const noexcept { return m_lastBanTime; }
 	EBanReason GetBanReason() const noexcept { return m_banReason; }
 	std::time_t GetLastTxHashSetRequest() const noexcept { return m_lastTxHashSetRequest; }
+	double GetThroughputScore() const noexcept { return m_throughputScore; }
 	bool IsBanned() const noexcept
 	{
 		const time_t maxBanTime = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() - std::chrono::seconds(P2P::BAN_WINDOW));
@@ -200,6 +203,9 @@ private:
 	std::atomic<std::time_t> m_lastBanTime;
 	std::atomic<EBanReason> m_banReason;
 	std::atomic<std::time_t> m_lastTxHashSetRequest;
+
+	// PeerStats::GetThroughputScore from the last connection that measured one. Not persisted.
+	std::atomic<double> m_throughputScore{ 0.0 };
 };
 
 typedef std::shared_ptr<Peer> PeerPtr;
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <Crypto/Hash.h>
+#include <json/json.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+//
+// Traffic and responsiveness of a connected peer, shared by every copy of its ConnectedPeer.
+// Message counts are relaxed atomics, updated for every message.
+// Latencies are moving averages, updated under a lock only when a ping or a requested block or headers come back.
+//
+class PeerStats
+{
+public:
+	using Ptr = std::shared_ptr<PeerStats>;
+	using Clock = std::chrono::steady_clock;
+
+	// Every message type, plus one slot that unknown types are counted in.
+	static constexpr size_t NUM_MESSAGE_TYPES = 24;
+
+	struct MessageCounts
+	{
+		uint64_t messagesReceived;
+		uint64_t bytesReceived;
+		uint64_t messagesSent;
+		uint64_t bytesSent;
+	};
+
+	void OnMessageReceived(const uint8_t messageType, const uint64_t numBytes) noexcept
+	{
+		const size_t index = GetIndex(messageType);
+		m_messagesReceived[index].fetch_add(1, std::memory_order_relaxed);
+		m_bytesReceived[index].fetch_add(numBytes, std::memory_order_relaxed);
+	}
+
+	void OnMessageSent(const uint8_t messageType, const uint64_t numBytes) noexcept
+	{
+		const size_t index = GetIndex(messageType);
+		m_messagesSent[index].fetch_add(1, std::memory_order_relaxed);
+		m_bytesSent[index].fetch_add(numBytes, std::memory_order_relaxed);
+	}
+
+	MessageCounts GetMessageCounts(const uint8_t messageType) const noexcept
+	{
+		const size_t index = GetIndex(messageType);
+		return MessageCounts{
+			m_messagesReceived[index].load(std::memory_order_relaxed),
+			m_bytesReceived[index].load(std::memory_order_relaxed),
+			m_messagesSent[index].load(std::memory_order_relaxed),
+			m_bytesSent[index].load(std::memory_order_relaxed)
+		};
+	}
+
+	//
+	// Ping round trips. Only the most recent ping is timed, so a pong for an older one is ignored.
+	//
+	void OnPingSent()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_pingSentTime = Clock::now();
+	}
+
+	void OnPongReceived()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_pingSentTime.has_value())
+		{
+			m_pingRtt.Add(Elapsed(m_pingSentTime.value()), 1.0);
+			m_pingSentTime = std::nullopt;
+		}
+	}
+
+	//
+	// Request-to-response latency of headers, timed from the most recent request.
+	//
+	void OnHeadersRequested()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_headersRequestTime = Clock::now();
+	}
+
+	void OnHeadersReceived(const size_t numHeaders)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_headersReceived += numHeaders;
+		if (m_headersRequestTime.has_value())
+		{
+			m_headerLatency.Add(Elapsed(m_headersRequestTime.value()), (double)numHeaders);
+			m_headersRequestTime = std::nullopt;
+		}
+	}
+
+	//
+	// Request-to-response latency and throughput of blocks, for each outstanding request.
+	// Only the most recent MAX_BLOCK_REQUESTS requests are remembered, so a peer that never responds can't grow the map.
+	//
+	void OnBlockRequested(const Hash& hash)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_blockRequests.size() >= MAX_BLOCK_REQUESTS)
+		{
+			m_blockRequests.clear();
+		}
+
+		m_blockRequests[hash] = Clock::now();
+	}
+
+	void OnBlockReceived(const Hash& hash, const uint64_t numBytes)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		++m_blocksReceived;
+
+		auto iter = m_blockRequests.find(hash);
+		if (iter != m_blockRequests.end())
+		{
+			m_blockLatency.Add(Elapsed(iter->second), (double)numBytes);
+			m_blockRequests.erase(iter);
+		}
+	}
+
+	std::optional<std::chrono::microseconds> GetPingRtt() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_pingRtt.GetLatency();
+	}
+
+	std::optional<std::chrono::microseconds> GetBlockLatency() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_blockLatency.GetLatency();
+	}
+
+	std::optional<std::chrono::microseconds> GetHeaderLatency() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_headerLatency.GetLatency();
+	}
+
+	//
+	// Headers per second the peer delivers in response to GetHeaders, or nullopt before any have been timed.
+	//
+	std::optional<double> GetHeaderThroughput() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_headerLatency.GetThroughput();
+	}
+
+	//
+	// Bytes per second the peer delivers in response to GetBlock, or nullopt before any have been timed.
+	//
+	std::optional<double> GetBlockThroughput() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_blockLatency.GetThroughput();
+	}
+
+	//
+	// A single number for comparing peers: the block throughput in bytes per second, discounted by the ping round trip,
+	// which every request pays before any bytes arrive. 0 until at least one block has been timed.
+	//
+	double GetThroughputScore() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		const std::optional<double> blockThroughput = m_blockLatency.GetThroughput();
+		if (!blockThroughput.has_value())
+		{
+			return 0.0;
+		}
+
+		const std::optional<std::chrono::microseconds> rtt = m_pingRtt.GetLatency();
+		const double rttSecs = rtt.has_value() ? rtt.value().count() / 1'000'000.0 : 0.0;
+		return blockThroughput.value() / (1.0 + rttSecs);
+	}
+
+	Json::Value ToJSON() const;
+
+private:
+	static constexpr size_t MAX_BLOCK_REQUESTS = 512;
+
+	//
+	// Exponentially weighted moving averages of a latency, and of the amount delivered with it.
+	//
+	class LatencyAverage
+	{
+	public:
+		void Add(const std::chrono::microseconds latency, const double amount)
+		{
+			const double latencyMicros = (double)std::max<int64_t>(latency.count(), 1);
+			if (m_numSamples == 0)
+			{
+				m_latencyMicros = latencyMicros;
+				m_amount = amount;
+			}
+			else
+			{
+				m_latencyMicros += ALPHA * (latencyMicros - m_latencyMicros);
+				m_amount += ALPHA * (amount - m_amount);
+			}
+
+			++m_numSamples;
+		}
+
+		std::optional<std::chrono::microseconds> GetLatency() const
+		{
+			if (m_numSamples == 0)
+			{
+				return std::nullopt;
+			}
+
+			return std::chrono::microseconds((int64_t)m_latencyMicros);
+		}
+
+		std::optional<double> GetThroughput() const
+		{
+			if (m_numSamples == 0)
+			{
+				return std::nullopt;
+			}
+
+			return m_amount * 1'000'000.0 / m_latencyMicros;
+		}
+
+	private:
+		static constexpr double ALPHA = 0.125;
+
+		uint64_t m_numSamples = 0;
+		double m_latencyMicros = 0.0;
+		double m_amount = 0.0;
+	};
+
+	static size_t GetIndex(const uint8_t messageType) noexcept
+	{
+		return messageType < NUM_MESSAGE_TYPES - 1 ? messageType : NUM_MESSAGE_TYPES - 1;
+	}
+
+	static std::chrono::microseconds Elapsed(const Clock::time_point& since)
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - since);
+	}
+
+	std::array<std::atomic<uint64_t>, NUM_MESSAGE_TYPES> m_messagesReceived{};
+	std::array<std::atomic<uint64_t>, NUM_MESSAGE_TYPES> m_bytesReceived{};
+	std::array<std::atomic<uint64_t>, NUM_MESSAGE_TYPES> m_messagesSent{};
+	std::array<std::atomic<uint64_t>, NUM_MESSAGE_TYPES> m_bytesSent{};
+
+	mutable std::mutex m_mutex;
+	std::optional<Clock::time_point> m_pingSentTime;
+	std::optional<Clock::time_point> m_headersRequestTime;
+	std::unordered_map<Hash, Clock::time_point> m_blockRequests;
+	uint64_t m_headersReceived = 0;
+	uint64_t m_blocksReceived = 0;
+	LatencyAverage m_pingRtt;
+	LatencyAverage m_headerLatency;
+	LatencyAverage m_blockLatency;
+};
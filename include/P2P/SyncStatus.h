@@ -3,6 +3,9 @@
 #include <cstdint>
 #include <memory>
 #include <atomic>
+#include <chrono>
+#include <map>
+#include <optional>
 
 enum class ESyncStatus
 {
@@ -15,6 +18,27 @@ enum class ESyncStatus
 	NOT_SYNCING
 };
 
+//
+// Sync throughput and progress, measured by the syncer about once a second.
+//
+struct SyncTelemetry
+{
+	using CPtr = std::shared_ptr<const SyncTelemetry>;
+
+	// Per second, measured over the last minute spent in the current status.
+	double headersPerSec = 0.0;
+	double blocksPerSec = 0.0;
+	double bytesDownloadedPerSec = 0.0;
+	double rangeProofsPerSec = 0.0;
+	double kernelsPerSec = 0.0;
+
+	// Estimated seconds until the current status (eg. SYNCING_HEADERS) completes, if it's making progress.
+	std::optional<uint64_t> etaSecs;
+
+	// Total time spent in each status since the node started.
+	std::map<ESyncStatus, std::chrono::milliseconds> timeInStatus;
+};
+
 class SyncStatus
 {
 public:
@@ -29,7 +53,12 @@ public:
 		m_blockDifficulty(0),
 		m_txHashSetDownloaded(0),
 		m_txHashSetTotalSize(0),
-		m_txHashSetProcessingStatus(0)
+		m_txHashSetProcessingStatus(0),
+		m_txHashSetRangeProofsVerified(0),
+		m_txHashSetKernelsVerified(0),
+		m_blockRangeProofsVerified(0),
+		m_blockKernelsVerified(0),
+		m_pTelemetry(std::make_shared<const SyncTelemetry>())
 	{
 
 	}
@@ -44,7 +73,12 @@ public:
 		m_blockDifficulty(other.m_blockDifficulty.load()),
 		m_txHashSetDownloaded(other.m_txHashSetDownloaded.load()),
 		m_txHashSetTotalSize(other.m_txHashSetTotalSize.load()),
-		m_txHashSetProcessingStatus(other.m_txHashSetProcessingStatus.load())
+		m_txHashSetProcessingStatus(other.m_txHashSetProcessingStatus.load()),
+		m_txHashSetRangeProofsVerified(other.m_txHashSetRangeProofsVerified.load()),
+		m_txHashSetKernelsVerified(other.m_txHashSetKernelsVerified.load()),
+		m_blockRangeProofsVerified(other.m_blockRangeProofsVerified.load()),
+		m_blockKernelsVerified(other.m_blockKernelsVerified.load()),
+		m_pTelemetry(other.GetTelemetry())
 	{
 
 	}
@@ -62,6 +96,12 @@ public:
 	uint64_t GetDownloadSize() const { return m_txHashSetTotalSize; }
 	uint8_t GetProcessingStatus() const { return m_txHashSetProcessingStatus; }
 
+	// Rangeproofs and kernel signatures verified since the node started, while validating TxHashSets and blocks.
+	uint64_t GetRangeProofsVerified() const { return m_txHashSetRangeProofsVerified + m_blockRangeProofsVerified; }
+	uint64_t GetKernelsVerified() const { return m_txHashSetKernelsVerified + m_blockKernelsVerified; }
+
+	SyncTelemetry::CPtr GetTelemetry() const { return std::atomic_load(&m_pTelemetry); }
+
 	void UpdateStatus(const ESyncStatus syncStatus) { m_syncStatus = syncStatus; }
 
 	void UpdateNetworkStatus(const uint64_t numActiveConnections, const uint64_t networkHeight, const uint64_t networkDifficulty)
@@ -87,6 +127,18 @@ public:
 	void UpdateDownloadSize(const uint64_t downloadSize) { m_txHashSetTotalSize = downloadSize; }
 	void UpdateProcessingStatus(const uint8_t processingStatus) { m_txHashSetProcessingStatus = processingStatus; }
 
+	void AddTxHashSetRangeProofsVerified(const uint64_t numRangeProofs) { m_txHashSetRangeProofsVerified += numRangeProofs; }
+	void AddTxHashSetKernelsVerified(const uint64_t numKernels) { m_txHashSetKernelsVerified += numKernels; }
+
+	// Totals from IBlockChain::GetProcessingStats.
+	void UpdateBlockVerificationStatus(const uint64_t numRangeProofs, const uint64_t numKernels)
+	{
+		m_blockRangeProofsVerified = numRangeProofs;
+		m_blockKernelsVerified = numKernels;
+	}
+
+	void UpdateTelemetry(const SyncTelemetry::CPtr& pTelemetry) { std::atomic_store(&m_pTelemetry, pTelemetry); }
+
 private:
 	std::atomic<ESyncStatus> m_syncStatus;
 	std::atomic<uint64_t> m_numActiveConnections;
@@ -99,6 +151,11 @@ private:
 	std::atomic<uint64_t> m_txHashSetDownloaded;
 	std::atomic<uint64_t> m_txHashSetTotalSize;
 	std::atomic<uint8_t> m_txHashSetProcessingStatus;
+	std::atomic<uint64_t> m_txHashSetRangeProofsVerified;
+	std::atomic<uint64_t> m_txHashSetKernelsVerified;
+	std::atomic<uint64_t> m_blockRangeProofsVerified;
+	std::atomic<uint64_t> m_blockKernelsVerified;
+	SyncTelemetry::CPtr m_pTelemetry;
 };
 
 typedef std::shared_ptr<SyncStatus> SyncStatusPtr;
@@ -19,6 +19,7 @@
 // Forward Declarations
 class Config;
 class BlockHeader;
+typedef std::shared_ptr<const BlockHeader> BlockHeaderPtr;
 
 class IHeaderMMR : public Traits::IBatchable
 {
@@ -26,6 +27,11 @@ public:
 	virtual ~IHeaderMMR() = default;
 
 	virtual void AddHeader(const BlockHeader& header) = 0;
+
+	//
+	// Adds the headers, in order, with a single write. The leaves are hashed in parallel when there are enough of them.
+	//
+	virtual void AddHeaders(const std::vector<BlockHeaderPtr>& headers) = 0;
 	virtual Hash Root(const uint64_t nextHeight) const = 0;
 	virtual void Rewind(const uint64_t nextHeight) = 0;
 };
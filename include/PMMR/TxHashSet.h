@@ -5,10 +5,14 @@
 #include <Core/Models/BlockHeader.h>
 #include <Core/Models/OutputLocation.h>
 #include <Core/Models/DTOs/OutputRange.h>
+#include <Core/Models/DTOs/OutputScanBatch.h>
+#include <Core/Models/DTOs/LocatedTxKernel.h>
+#include <Core/Models/MerkleProof.h>
 #include <Core/Models/TxHashSetRoots.h>
 #include <Core/Traits/Batchable.h>
 #include <BlockChain/Chain.h>
 #include <Crypto/Hash.h>
+#include <filesystem.h>
 
 // Forward Declarations
 class Config;
@@ -21,6 +25,61 @@ class Transaction;
 class TransactionBody;
 class SyncStatus;
 
+//
+// A compaction of the output and rangeproof PMMRs up to a horizon block, from ITxHashSet::PrepareCompaction.
+// Build does the slow part (rewriting the files below the horizon) without touching the TxHashSet, so it needs no lock.
+//
+class ITxHashSetCompaction
+{
+public:
+	using UPtr = std::unique_ptr<ITxHashSetCompaction>;
+
+	virtual ~ITxHashSetCompaction() = default;
+
+	virtual void Build() = 0;
+
+	virtual const BlockHeaderPtr& GetHorizonHeader() const noexcept = 0;
+
+	//
+	// True if no outputs were spent before the horizon since the last compaction, so there's nothing to apply. Only valid after Build.
+	//
+	virtual bool IsEmpty() const noexcept = 0;
+	virtual uint64_t GetNumPrunedOutputs() const noexcept = 0;
+};
+
+//
+// A copy-on-write view of a TxHashSet, from ITxHashSet::CreateOverlay, that transactions and blocks can be speculatively applied to.
+// The outputs it spends, and the outputs, rangeproofs, kernels, and hashes it appends, are kept in memory on top of the TxHashSet,
+// which is never changed. Discarding the overlay is all it takes to undo them.
+//
+// Any number of overlays can be in use at once, each from one thread at a time, so long as the TxHashSet doesn't change
+// while they are, eg. by holding the chain state's read lock.
+//
+class ITxHashSetOverlay
+{
+public:
+	using UPtr = std::unique_ptr<ITxHashSetOverlay>;
+
+	virtual ~ITxHashSetOverlay() = default;
+
+	//
+	// Returns true if all inputs in the transaction are valid and unspent, and none of its outputs exist, with everything applied so far.
+	// The rules are the same as for ITxHashSet::IsValid.
+	//
+	virtual bool IsValid(const Transaction& transaction) const = 0;
+
+	//
+	// Spends the inputs, and appends the outputs, rangeproofs, and kernels of the body, if they're valid (see IsValid).
+	// Otherwise, returns false and leaves the overlay unchanged.
+	//
+	virtual bool Apply(const TransactionBody& body) = 0;
+
+	//
+	// Returns the roots and sizes of each of the MMRs, with everything applied.
+	//
+	virtual TxHashSetRoots GetRoots() const = 0;
+};
+
 class ITxHashSet : public Traits::IBatchable
 {
 public:
@@ -45,6 +104,38 @@ public:
 		std::shared_ptr<IBlockDB> pBlockDB
 	) const = 0;
 
+	//
+	// Indexes the kernels of the blocks on the chain from firstHeight through lastHeight (see IBlockDB::AddKernelPosition).
+	//
+	virtual void SaveKernelPositions(
+		const Chain::CPtr& pChain,
+		std::shared_ptr<IBlockDB> pBlockDB,
+		const uint64_t firstHeight,
+		const uint64_t lastHeight
+	) const = 0;
+
+	//
+	// Indexes the NRD kernels of the blocks on the chain from firstHeight through lastHeight (see IBlockDB::AddNRDKernelPosition).
+	//
+	virtual void SaveNRDKernelPositions(
+		const Chain::CPtr& pChain,
+		std::shared_ptr<IBlockDB> pBlockDB,
+		const uint64_t firstHeight,
+		const uint64_t lastHeight
+	) const = 0;
+
+	//
+	// Scans the kernels of the blocks on the chain from firstHeight through lastHeight, newest first, for the given excess commitment.
+	// Returns nullptr if not found.
+	//
+	virtual std::unique_ptr<LocatedTxKernel> FindKernel(
+		const Chain::CPtr& pChain,
+		std::shared_ptr<const IBlockDB> pBlockDB,
+		const Commitment& excessCommitment,
+		const uint64_t firstHeight,
+		const uint64_t lastHeight
+	) const = 0;
+
 	//
 	// Returns true if all inputs in the transaction are valid and unspent. Otherwise, false.
 	//
@@ -53,6 +144,13 @@ public:
 		const Transaction& transaction
 	) const = 0;
 
+	//
+	// Creates an empty overlay on top of the TxHashSet as it is now. The TxHashSet must not change until the overlay is discarded.
+	//
+	virtual ITxHashSetOverlay::UPtr CreateOverlay(
+		std::shared_ptr<const IBlockDB> pBlockDB
+	) const = 0;
+
 	//
 	// Appends all new kernels, outputs, and rangeproofs to the MMRs, and prunes all of the inputs.
 	//
@@ -69,12 +167,13 @@ public:
 	) const = 0;
 
 	//
-	// Returns the roots and sizes of each of the MMRs.
+	// Returns the roots and sizes of each of the MMRs, as if the body was applied. The MMRs themselves are left unchanged.
+	// Throws a TxHashSetException if the body's inputs or outputs aren't valid for the current UTXO set.
 	//
 	virtual TxHashSetRoots GetRoots(
 		const std::shared_ptr<const IBlockDB>& pBlockDB,
 		const TransactionBody& body
-	) = 0;
+	) const = 0;
 
 
 
@@ -109,7 +208,17 @@ public:
 	) const = 0;
 
 	//
-	// Get outputs by leaf/insertion index.
+	// Same as GetOutputsByLeafIndex, but the rangeproofs are read into a single arena owned by the batch.
+	// Used by in-process wallets scanning the whole output set, where a heap allocation per rangeproof adds up.
+	//
+	virtual OutputScanBatch ScanOutputs(
+		std::shared_ptr<const IBlockDB> pBlockDB,
+		const uint64_t startIndex,
+		const uint64_t maxNumOutputs
+	) const = 0;
+
+	//
+	// Returns the unspent outputs with mmr indices in [startIndex, lastIndex], read in a batch like GetOutputsByLeafIndex.
 	//
 	virtual std::vector<OutputDTO> GetOutputsByMMRIndex(
 		std::shared_ptr<const IBlockDB> pBlockDB,
@@ -117,8 +226,24 @@ public:
 		const uint64_t lastIndex
 	) const = 0;
 
+	//
+	// Builds the merkle proof of the unspent output at mmrIndex against the output MMR as of the given size.
+	// Returns nullptr if the output at mmrIndex is spent, or isn't the given commitment.
+	//
+	virtual std::unique_ptr<MerkleProof> GetOutputMerkleProof(
+		const Commitment& commitment,
+		const uint64_t mmrIndex,
+		const uint64_t mmrSize
+	) const = 0;
+
 	virtual BlockHeaderPtr GetFlushedBlockHeader() const noexcept = 0;
 
+	//
+	// Returns the leaf indices of the outputs spent since the given block, which must be an ancestor of the flushed block.
+	// These are all that's needed to rewind a copy of the flushed files for a TxHashSet archive.
+	// Only spent positions are read, not the blocks themselves.
+	//
+	virtual std::vector<uint64_t> GetLeavesSpentSince(const IBlockDB& blockDB, const BlockHeader& header) const = 0;
 
 
 	//
@@ -140,9 +265,21 @@ public:
 	virtual void Rollback() noexcept = 0;
 
 	//
-	// Removes pruned leaves and hashes from the output and rangeproof PMMRs to reduce disk usage.
+	// Captures what's needed to remove the outputs spent before the given block (an ancestor of the flushed block)
+	// from the output and rangeproof PMMRs. Outputs spent since are kept, so the TxHashSet can still be rewound to it.
+	// Only this and ApplyCompaction need a lock.
+	//
+	virtual ITxHashSetCompaction::UPtr PrepareCompaction(
+		const IBlockDB& blockDB,
+		const BlockHeaderPtr& pHorizonHeader
+	) const = 0;
+
+	//
+	// Swaps in the compacted files, after copying over everything past the horizon, which is all that changed since they were built.
+	// Must be called under the write lock with no uncommitted changes. Throws a TxHashSetException if the files don't match.
+	// The compacted files are staged and committed to a manifest first, so a swap interrupted by a crash is finished on the next startup.
 	//
-	virtual void Compact() = 0;
+	virtual void ApplyCompaction(ITxHashSetCompaction& compaction) = 0;
 };
 
 typedef std::shared_ptr<ITxHashSet> ITxHashSetPtr;
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Core/Models/BlockHeader.h>
+#include <Common/Util/FileUtil.h>
+#include <filesystem.h>
+#include <memory>
+
+//
+// A zipped TxHashSet snapshot as of a block, ready to send to peers.
+// The zip is deleted once nothing references the archive, so a single archive can be shared by every peer syncing at once.
+//
+class TxHashSetArchive
+{
+public:
+	using CPtr = std::shared_ptr<const TxHashSetArchive>;
+
+	TxHashSetArchive(const BlockHeaderPtr& pHeader, const fs::path& zipFilePath)
+		: m_pHeader(pHeader), m_zipFilePath(zipFilePath) { }
+	~TxHashSetArchive() { FileUtil::RemoveFile(m_zipFilePath); }
+
+	TxHashSetArchive(const TxHashSetArchive&) = delete;
+	TxHashSetArchive& operator=(const TxHashSetArchive&) = delete;
+
+	const BlockHeaderPtr& GetHeader() const noexcept { return m_pHeader; }
+	const fs::path& GetPath() const noexcept { return m_zipFilePath; }
+
+private:
+	BlockHeaderPtr m_pHeader;
+	fs::path m_zipFilePath;
+};
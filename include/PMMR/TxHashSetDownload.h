@@ -0,0 +1,78 @@
+#pragma once
+
+#include <Common/ImportExport.h>
+#include <Core/Models/BlockHeader.h>
+#include <Config/Config.h>
+#include <filesystem.h>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_set>
+
+#ifdef MW_PMMR
+#define TXHASHSET_API EXPORT
+#else
+#define TXHASHSET_API IMPORT
+#endif
+
+// Forward Declarations
+class ZipStreamExtractor;
+
+//
+// Extracts a TxHashSet zip into a staging folder while it's still downloading,
+// and verifies the kernel signatures as soon as the kernel folder is complete, instead of after the download.
+//
+// If the zip can't be streamed (see ZipStreamExtractor), extraction just stops,
+// and TxHashSetManager::LoadFromZip extracts the downloaded zip as usual.
+//
+class TXHASHSET_API TxHashSetDownload
+{
+public:
+	using Ptr = std::shared_ptr<TxHashSetDownload>;
+
+	TxHashSetDownload(const Config& config, const BlockHeaderPtr& pHeader);
+	~TxHashSetDownload();
+
+	TxHashSetDownload(const TxHashSetDownload&) = delete;
+	TxHashSetDownload& operator=(const TxHashSetDownload&) = delete;
+
+	//
+	// Extracts what it can from the next bytes of the zip.
+	//
+	void Append(const unsigned char* pData, const size_t numBytes) noexcept;
+
+	//
+	// Waits for the kernel signature verification, if it was started.
+	// Must be called once the download completes, before the staged folders are used.
+	//
+	void Finish();
+
+	const BlockHeaderPtr& GetHeader() const noexcept { return m_pHeader; }
+	const fs::path& GetStagingPath() const noexcept { return m_stagingPath; }
+
+	//
+	// True if every TxHashSet file was extracted to the staging folder. Only valid after Finish.
+	//
+	bool IsExtracted() const noexcept;
+
+	//
+	// True if the kernel signatures of the staged kernel MMR, rewound to the header, are all valid. Only valid after Finish.
+	//
+	bool AreKernelSignaturesVerified() const noexcept { return m_kernelSignaturesVerified; }
+
+private:
+	void OnEntryExtracted(const std::string& entryName);
+	static void Thread_VerifyKernelSignatures(TxHashSetDownload& download);
+
+	const Config& m_config;
+	BlockHeaderPtr m_pHeader;
+	fs::path m_stagingPath;
+
+	std::unique_ptr<ZipStreamExtractor> m_pExtractor;
+	bool m_failed;
+	std::unordered_set<std::string> m_remainingEntries;
+
+	std::thread m_kernelThread;
+	std::atomic_bool m_kernelSignaturesVerified;
+};
@@ -2,6 +2,10 @@
 
 #include <Common/ImportExport.h>
 #include <PMMR/TxHashSet.h>
+#include <PMMR/TxHashSetArchive.h>
+#include <PMMR/TxHashSetDownload.h>
+#include <Core/File/FileRemover.h>
+#include <Core/Models/BlockSums.h>
 #include <Config/Config.h>
 #include <Core/Traits/Lockable.h>
 #include <filesystem.h>
@@ -31,8 +35,90 @@ public:
 	std::shared_ptr<const ITxHashSet> GetTxHashSet() const { return m_pTxHashSet; }
 	void SetTxHashSet(ITxHashSetPtr pTxHashSet) { m_pTxHashSet = pTxHashSet; }
 
-	static ITxHashSetPtr LoadFromZip(const Config& config, const fs::path& zipFilePath, BlockHeaderPtr pHeader);
-	fs::path SaveSnapshot(std::shared_ptr<IBlockDB> pBlockDB, BlockHeaderPtr pHeader) const;
+	//
+	// Loads the TxHashSet from the downloaded zip. If the download extracted every file while it was downloading,
+	// those are used instead of extracting the zip again.
+	//
+	static ITxHashSetPtr LoadFromZip(
+		const Config& config,
+		const fs::path& zipFilePath,
+		BlockHeaderPtr pHeader,
+		const TxHashSetDownload* pDownload = nullptr
+	);
+
+	//
+	// A copy of the flushed TxHashSet files, along with the leaves needed to rewind it to the archive's block.
+	// The copy is deleted when this is destroyed.
+	//
+	struct SnapshotCopy
+	{
+		SnapshotCopy(const BlockHeaderPtr& pHeader_, const fs::path& directory_)
+			: pHeader(pHeader_), directory(directory_), remover(directory_) { }
+
+		BlockHeaderPtr pHeader;
+		BlockHeaderPtr pFlushedHeader;
+		fs::path directory;
+		std::vector<uint64_t> spentLeaves;
+		FileRemover remover;
+	};
+
+	//
+	// Copies the TxHashSet files for an archive as of the given block.
+	// This is the only step that needs a consistent view of the TxHashSet, so callers only hold a chain state reader for this.
+	//
+	std::unique_ptr<SnapshotCopy> CopySnapshot(const IBlockDB& blockDB, BlockHeaderPtr pHeader) const;
+
+	//
+	// Rewinds the copy to its block and zips it. Only the copy is touched, so no lock is needed.
+	//
+	static TxHashSetArchive::CPtr BuildSnapshot(const Config& config, const SnapshotCopy& snapshotCopy);
+
+	//
+	// Rewinds the copy to its block like BuildSnapshot, but writes the MMR files to the destination directory as they are,
+	// along with a manifest of the block, its BlockSums, and the size and digest of each file.
+	// The manifest is signed if a snapshot signing key is configured. Throws if the destination already exists.
+	//
+	// These are for bootstrapping our own nodes, so unlike archives, importing them needs no leafset rebuild or extraction.
+	//
+	static void ExportSnapshot(
+		const Config& config,
+		const SnapshotCopy& snapshotCopy,
+		const BlockSums& blockSums,
+		const fs::path& destination
+	);
+
+	//
+	// The manifest of an exported snapshot.
+	//
+	struct SnapshotManifest
+	{
+		struct File
+		{
+			std::string path;
+			uint64_t size;
+			Hash digest;
+		};
+
+		BlockHeaderPtr pHeader;
+		BlockSums blockSums;
+		std::vector<File> files;
+
+		// True if the manifest was signed by the configured snapshot operator key.
+		bool trusted;
+	};
+
+	//
+	// Reads and checks the signature of an exported snapshot's manifest, but not its files.
+	// Throws a TxHashSetException if the manifest is malformed, or signed but the signature is invalid.
+	//
+	static std::unique_ptr<SnapshotManifest> ReadSnapshotManifest(const Config& config, const fs::path& directory);
+
+	//
+	// Checks each file of an exported snapshot against its manifest, then replaces the TxHashSet files with them.
+	// A trusted snapshot's rangeproofs and kernel signatures aren't verified by ValidateTxHashSet, but its roots, sizes, and sums still are.
+	// Returns null if any file is missing or doesn't match.
+	//
+	static ITxHashSetPtr LoadSnapshot(const Config& config, const fs::path& directory, const SnapshotManifest& manifest);
 
 	void Commit() final
 	{
@@ -4,6 +4,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file LICENSE or http://www.opensource.org/licenses/mit-license.php.
 
+#include <Common/CacheStats.h>
 #include <Common/ImportExport.h>
 #include <Config/Config.h>
 #include <Core/Models/BlockHeader.h>
@@ -33,6 +34,26 @@ public:
 		const BlockHeader& previousHeader
 	) const;
 
+	//
+	// Validates only the difficulty and secondary scaling of the header against the chain.
+	// The header's proof must already have been verified with IsProofValid (eg. up-front for a whole batch).
+	//
+	bool IsDifficultyValid(
+		const BlockHeader& header,
+		const BlockHeader& previousHeader
+	) const;
+
+	//
+	// Verifies the header's cuckoo cycle without touching the database.
+	// Safe to call concurrently from multiple threads.
+	//
+	bool IsProofValid(const BlockHeader& header) const;
+
+	//
+	// Usage of the cache of verified proofs, shared by every PoWManager.
+	//
+	static CacheStats GetProofCacheStats();
+
 private:
 	const Config& m_config;
 	std::shared_ptr<const IBlockDB> m_pBlockDB;
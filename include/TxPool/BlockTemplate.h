@@ -0,0 +1,82 @@
+#pragma once
+
+#include <Core/Models/BlockHeader.h>
+#include <Core/Models/Transaction.h>
+#include <Core/Util/JsonUtil.h>
+#include <Consensus/BlockWeight.h>
+#include <Crypto/Crypto.h>
+#include <json/json.h>
+#include <memory>
+
+//
+// The mempool transactions selected to be mined on top of a given block, aggregated into a single transaction.
+// The miner adds its coinbase output and kernel, then calculates the MMR roots and builds the header.
+//
+class BlockTemplate
+{
+public:
+	using CPtr = std::shared_ptr<const BlockTemplate>;
+
+	BlockTemplate(const BlockHeaderPtr& pPreviousHeader, const TransactionPtr& pTransaction, const size_t numTransactions, const uint64_t fees)
+		: m_pPreviousHeader(pPreviousHeader), m_pTransaction(pTransaction), m_numTransactions(numTransactions), m_fees(fees) { }
+
+	const BlockHeaderPtr& GetPreviousHeader() const noexcept { return m_pPreviousHeader; }
+	uint64_t GetHeight() const noexcept { return m_pPreviousHeader->GetHeight() + 1; }
+
+	//
+	// The aggregate of the selected transactions, or nullptr when none were selected.
+	//
+	const TransactionPtr& GetTransaction() const noexcept { return m_pTransaction; }
+	size_t GetNumTransactions() const noexcept { return m_numTransactions; }
+	uint64_t GetFees() const noexcept { return m_fees; }
+
+	//
+	// The block weight of the aggregate, not including the coinbase.
+	//
+	uint64_t GetWeight() const noexcept
+	{
+		if (m_pTransaction == nullptr)
+		{
+			return 0;
+		}
+
+		return (m_pTransaction->GetInputs().size() * Consensus::BLOCK_INPUT_WEIGHT)
+			+ (m_pTransaction->GetOutputs().size() * Consensus::BLOCK_OUTPUT_WEIGHT)
+			+ (m_pTransaction->GetKernels().size() * Consensus::BLOCK_KERNEL_WEIGHT);
+	}
+
+	Json::Value ToJSON() const
+	{
+		Json::Value json;
+		json["height"] = GetHeight();
+		json["previous_hash"] = m_pPreviousHeader->GetHash().ToHex();
+		json["previous_total_difficulty"] = m_pPreviousHeader->GetTotalDifficulty();
+		json["num_transactions"] = (uint64_t)m_numTransactions;
+		json["fees"] = m_fees;
+		json["weight"] = GetWeight();
+
+		if (m_pTransaction != nullptr)
+		{
+			json["transaction"] = m_pTransaction->ToJSON();
+
+			const BlindingFactor totalOffset = Crypto::AddBlindingFactors(
+				{ m_pPreviousHeader->GetTotalKernelOffset(), m_pTransaction->GetOffset() },
+				{}
+			);
+			json["total_kernel_offset"] = JsonUtil::ConvertToJSON(totalOffset);
+		}
+		else
+		{
+			json["transaction"] = Json::Value(Json::nullValue);
+			json["total_kernel_offset"] = JsonUtil::ConvertToJSON(m_pPreviousHeader->GetTotalKernelOffset());
+		}
+
+		return json;
+	}
+
+private:
+	BlockHeaderPtr m_pPreviousHeader;
+	TransactionPtr m_pTransaction;
+	size_t m_numTransactions;
+	uint64_t m_fees;
+};
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Core/Models/Transaction.h>
+#include <json/json.h>
+#include <cstdint>
+
+enum class EPoolEventType
+{
+	ADDED,
+	MINED,
+	EVICTED
+};
+
+//
+// A transaction entering or leaving the mempool, numbered in the order they happened.
+// Stempool transactions are never reported, since that would reveal which transactions this node is stemming.
+//
+class TxPoolEvent
+{
+public:
+	TxPoolEvent(const uint64_t sequence, const EPoolEventType type, const TransactionPtr& pTransaction)
+		: m_sequence(sequence), m_type(type), m_pTransaction(pTransaction) { }
+
+	uint64_t GetSequence() const noexcept { return m_sequence; }
+	EPoolEventType GetType() const noexcept { return m_type; }
+	const TransactionPtr& GetTransaction() const noexcept { return m_pTransaction; }
+
+	Json::Value ToJSON() const
+	{
+		Json::Value json;
+		json["seq"] = Json::UInt64(m_sequence);
+		json["type"] = GetTypeString(m_type);
+		json["tx_hash"] = m_pTransaction->GetHash().ToHex();
+
+		// Wallets identify their transactions by kernel excess.
+		Json::Value kernelsJson(Json::arrayValue);
+		for (const TransactionKernel& kernel : m_pTransaction->GetKernels())
+		{
+			kernelsJson.append(kernel.GetExcessCommitment().ToHex());
+		}
+		json["kernels"] = kernelsJson;
+
+		return json;
+	}
+
+	static std::string GetTypeString(const EPoolEventType type)
+	{
+		switch (type)
+		{
+			case EPoolEventType::ADDED: return "added";
+			case EPoolEventType::MINED: return "mined";
+			case EPoolEventType::EVICTED: return "evicted";
+		}
+
+		return "unknown";
+	}
+
+private:
+	uint64_t m_sequence;
+	EPoolEventType m_type;
+	TransactionPtr m_pTransaction;
+};
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//
+// Point-in-time occupancy of the mempool or stempool.
+//
+struct PoolStats
+{
+	size_t numTransactions;
+
+	// Estimated bytes used by the pool's transactions and indexes.
+	size_t memoryUsage;
+
+	// 0 when the pool is unbounded.
+	size_t maxBytes;
+
+	// Transactions evicted (along with their dependents) to stay within maxBytes, since startup.
+	uint64_t numEvicted;
+};
+
+struct TxPoolStats
+{
+	PoolStats memPool;
+	PoolStats stemPool;
+
+	// Blocks connected since startup, and the time spent removing their txs (and conflicts) from the pools, once the pool lock was held.
+	uint64_t numBlocksReconciled;
+	uint64_t reconcileMicros;
+};
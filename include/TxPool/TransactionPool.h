@@ -7,6 +7,9 @@
 #include <Common/ImportExport.h>
 #include <TxPool/DandelionStatus.h>
 #include <TxPool/PoolType.h>
+#include <TxPool/BlockTemplate.h>
+#include <TxPool/PoolStats.h>
+#include <TxPool/PoolEvent.h>
 #include <Core/Models/Transaction.h>
 #include <Core/Models/ShortId.h>
 #include <Core/Models/FullBlock.h>
@@ -16,6 +19,8 @@
 #include <Crypto/Hash.h>
 #include <vector>
 #include <set>
+#include <chrono>
+#include <optional>
 
 // Forward Declarations
 class IBlockDB;
@@ -73,13 +78,39 @@ public:
 
 	virtual std::vector<TransactionPtr> FindTransactionsByKernel(const std::set<TransactionKernel>& kernels) const = 0;
 	virtual TransactionPtr FindTransactionByKernelHash(const Hash& kernelHash) const = 0;
+
+	//
+	// Removes the pool txs that were mined in, or conflict with, the newly connected block, along with their dependents.
+	// Mined txs are remembered for a while in case the block is disconnected.
+	//
 	virtual void ReconcileBlock(
 		std::shared_ptr<const IBlockDB> pBlockDB,
 		ITxHashSetConstPtr pTxHashSet,
 		const FullBlock& block
 	) = 0;
 
+	//
+	// Adds the pool txs mined in the given blocks, which a reorg is disconnecting, back to the mempool.
+	// Call after rewinding the TxHashSet and before connecting the new blocks, with the blocks in order of increasing height.
+	//
+	virtual void ReinjectBlockTransactions(const std::vector<Hash>& disconnectedBlocks) = 0;
+
+	//
+	// Returns the highest fee rate mempool txs that fit in a block on top of the given tip, aggregated and ready to mine.
+	// The template is maintained as the mempool changes, so this is cheap unless a block was just connected.
+	//
+	virtual BlockTemplate::CPtr GetBlockTemplate(
+		std::shared_ptr<const IBlockDB> pBlockDB,
+		ITxHashSetConstPtr pTxHashSet,
+		const BlockHeaderPtr& pTipHeader
+	) = 0;
+
+	//
 	// Dandelion
+	// Each stempool entry is acted on at its own deadline: TO_STEM and TO_FLUFF entries once the oldest of them has waited
+	// the patience interval (so txs arriving meanwhile are aggregated with it), and every entry once its embargo expires.
+	// The stem and fluff getters return nullptr until their deadline.
+	//
 	virtual TransactionPtr GetTransactionToStem(
 		std::shared_ptr<const IBlockDB> pBlockDB,
 		ITxHashSetConstPtr pTxHashSet
@@ -88,7 +119,35 @@ public:
 		std::shared_ptr<const IBlockDB> pBlockDB,
 		ITxHashSetConstPtr pTxHashSet
 	) = 0;
-	virtual std::vector<TransactionPtr> GetExpiredTransactions() const = 0;
+	virtual std::vector<TransactionPtr> GetExpiredTransactions() = 0;
+
+	//
+	// Returns the earliest of the deadlines above, or time_point::max() if the stempool is empty.
+	//
+	virtual std::chrono::system_clock::time_point GetNextDandelionEvent() const = 0;
+
+	//
+	// Returns the occupancy and eviction counts of the mempool and stempool.
+	//
+	virtual TxPoolStats GetStats() const = 0;
+
+	//
+	// Returns the sequence number of the most recent mempool event, or 0 if there haven't been any.
+	// This never takes the pool lock, so it's cheap enough to poll.
+	//
+	virtual uint64_t GetEventSequence() const noexcept = 0;
+
+	//
+	// Returns the mempool events that happened after the given sequence number, oldest first.
+	// Only the most recent events are kept, so this is nullopt if any of them have already been discarded.
+	//
+	virtual std::optional<std::vector<TxPoolEvent>> GetEventsSince(const uint64_t sequence) const = 0;
+
+	//
+	// Saves the mempool's txs (and the stempool's, if includeStemPool) to the file, so they can be reloaded with
+	// TxPoolAPI::LoadTransactions after a restart. Returns the number of txs saved.
+	//
+	virtual size_t SaveTransactions(const fs::path& path, const bool includeStemPool) const = 0;
 };
 
 namespace TxPoolAPI
@@ -99,4 +158,11 @@ namespace TxPoolAPI
 	TX_POOL_API ITransactionPool::Ptr CreateTransactionPool(
 		const Config& config
 	);
+
+	//
+	// Returns the txs saved by ITransactionPool::SaveTransactions, oldest first, with the pool each was in.
+	// They still need to be revalidated against the current chain state, since blocks may have been mined since they were saved.
+	// Returns none if nothing was saved. Throws a DeserializationException if the file is corrupt.
+	//
+	TX_POOL_API std::vector<std::pair<EPoolType, TransactionPtr>> LoadTransactions(const fs::path& path);
 }
\ No newline at end of file
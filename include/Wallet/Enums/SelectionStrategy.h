@@ -7,7 +7,10 @@ enum class ESelectionStrategy
 {
 	SMALLEST,
 	CUSTOM,
-	ALL
+	ALL,
+
+	// The fewest inputs that cover the amount, eg. for large payouts from wallets with many small outputs.
+	FEWEST
 };
 
 namespace SelectionStrategy
@@ -26,6 +29,10 @@ namespace SelectionStrategy
 		{
 			return ESelectionStrategy::ALL;
 		}
+		else if (input == "FEWEST")
+		{
+			return ESelectionStrategy::FEWEST;
+		}
 
 		throw DESERIALIZATION_EXCEPTION_F("Invalid selection strategy: {}", input);
 	}
@@ -44,6 +51,10 @@ namespace SelectionStrategy
 		{
 			return "ALL";
 		}
+		else if (strategy == ESelectionStrategy::FEWEST)
+		{
+			return "FEWEST";
+		}
 
 		throw DESERIALIZATION_EXCEPTION("Invalid selection strategy");
 	}
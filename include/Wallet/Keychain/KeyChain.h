@@ -14,6 +14,8 @@
 #include <Crypto/Models/ed25519_keypair.h>
 #include <Crypto/ED25519.h>
 #include <Common/Secure.h>
+#include <map>
+#include <mutex>
 #include <vector>
 
 class KeyChain
@@ -33,6 +35,15 @@ public:
 		const EBulletproofType& bulletproofType
 	) const;
 
+	//
+	// Rewinds a batch of rangeproofs of the same type, returning nullptr for each one that doesn't belong to this keychain.
+	//
+	std::vector<std::unique_ptr<RewoundProof>> RewindRangeProofs(
+		const std::vector<Commitment>& commitments,
+		const std::vector<const RangeProof*>& rangeProofs,
+		const EBulletproofType& bulletproofType
+	) const;
+
 	RangeProof GenerateRangeProof(
 		const KeyChainPath& keyChainPath, 
 		const uint64_t amount, 
@@ -45,8 +56,21 @@ private:
 	KeyChain(const Config& config, PrivateExtKey&& masterKey, SecretKey&& bulletProofNonce);
 
 	SecretKey CreateNonce(const Commitment& commitment, const SecretKey& nonceHash) const;
+	PrivateExtKey DeriveParentKey(const std::vector<uint32_t>& parentIndices) const;
+	const SecretKey& GetRewindNonceHash(const EBulletproofType& bulletproofType) const;
 
 	const Config& m_config;
 	PrivateExtKey m_masterKey;
 	SecretKey m_bulletProofNonce;
+
+	// Hash of the master public key, used for ENHANCED rewind nonces.
+	// Calculated once, since every output scanned during a restore needs it.
+	SecretKey m_enhancedRewindNonceHash;
+
+	// Extended keys of the parent paths derived so far, so deriving many keys under the same account
+	// only costs one child step per key. A keychain only lives as long as the operation that created it,
+	// so the keys are never kept past the session. Their key material is held in SecretKeys (secure memory).
+	static constexpr size_t MAX_CACHED_PARENT_KEYS = 64;
+	mutable std::mutex m_parentKeysMutex;
+	mutable std::map<std::vector<uint32_t>, PrivateExtKey> m_parentKeys;
 };
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Core/Traits/Jsonable.h>
+#include <cstdint>
+
+class RestoreProgressDTO : public Traits::IJsonable
+{
+public:
+    RestoreProgressDTO(
+        const bool scanning,
+        const uint64_t next_leaf_index,
+        const uint64_t highest_leaf_index,
+        const uint64_t outputs_found
+    ) : m_scanning(scanning),
+        m_nextLeafIndex(next_leaf_index),
+        m_highestLeafIndex(highest_leaf_index),
+        m_outputsFound(outputs_found) { }
+
+    // True while outputs are being scanned for.
+    bool IsScanning() const noexcept { return m_scanning; }
+
+    // Scanning has been completed up to (but not including) this output leaf index.
+    uint64_t GetNextLeafIndex() const noexcept { return m_nextLeafIndex; }
+    uint64_t GetHighestLeafIndex() const noexcept { return m_highestLeafIndex; }
+    uint64_t GetOutputsFound() const noexcept { return m_outputsFound; }
+
+    Json::Value ToJSON() const noexcept final
+    {
+        Json::Value json;
+        json["scanning"] = m_scanning;
+        json["next_leaf_index"] = m_nextLeafIndex;
+        json["highest_leaf_index"] = m_highestLeafIndex;
+        json["outputs_found"] = m_outputsFound;
+        json["percentage_complete"] = m_highestLeafIndex > 0 ? (m_nextLeafIndex * 100) / (m_highestLeafIndex + 1) : 0;
+        return json;
+    }
+
+private:
+    bool m_scanning;
+    uint64_t m_nextLeafIndex;
+    uint64_t m_highestLeafIndex;
+    uint64_t m_outputsFound;
+};
@@ -67,6 +67,7 @@ private:
     static std::string FormatSpacing(const std::string& data)
     {
         std::string formatted = "";
+        formatted.reserve(data.size() + (data.size() / WORD_LENGTH));
         for (size_t i = 0; i < data.size(); i++)
         {
             if (i != 0 && i % WORD_LENGTH == 0) {
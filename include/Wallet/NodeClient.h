@@ -5,10 +5,17 @@
 #include <Core/Models/Transaction.h>
 #include <Core/Models/DTOs/BlockWithOutputs.h>
 #include <Core/Models/DTOs/OutputRange.h>
+#include <Core/Models/DTOs/OutputScanBatch.h>
 #include <TxPool/PoolType.h>
 #include <cstdint>
 #include <map>
 
+//
+// The most commitments a node will look up in a single /v1/chain/outputs/byids request.
+// Larger lookups are split into pages of this size, each a single batched read.
+//
+static const size_t MAX_OUTPUTS_BY_COMMITMENT = 10000;
+
 //
 // INodeClient is an interface whose implementations communicate with nodes in various ways.
 // For example, an HTTPNodeClient will connect to a node using HTTP and the node's REST APIs.
@@ -30,6 +37,7 @@ public:
 
 	//
 	// Returns the location (block height and mmr index) of each requested output, if it is *unspent*.
+	// Any number of commitments may be requested; clients page them by MAX_OUTPUTS_BY_COMMITMENT.
 	//
 	virtual std::map<Commitment, OutputLocation> GetOutputsByCommitment(const std::vector<Commitment>& commitments) const = 0;
 
@@ -43,6 +51,22 @@ public:
 	//
 	virtual std::unique_ptr<OutputRange> GetOutputsByLeafIndex(const uint64_t startIndex, const uint64_t maxNumOutputs) const = 0;
 
+	//
+	// Same as GetOutputsByLeafIndex, for scanning the whole output set (eg. during a restore).
+	// Clients of a node in the same process override this to read the batch straight from the TxHashSet,
+	// with the rangeproofs in a single arena rather than copied into an OutputRange.
+	//
+	virtual std::unique_ptr<OutputScanBatch> ScanOutputs(const uint64_t startIndex, const uint64_t maxNumOutputs) const
+	{
+		std::unique_ptr<OutputRange> pOutputRange = GetOutputsByLeafIndex(startIndex, maxNumOutputs);
+		if (pOutputRange == nullptr)
+		{
+			return std::unique_ptr<OutputScanBatch>(nullptr);
+		}
+
+		return std::make_unique<OutputScanBatch>(OutputScanBatch::FromRange(*pOutputRange));
+	}
+
 	//
 	// Posts the transaction to the P2P Network.
 	//
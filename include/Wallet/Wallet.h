@@ -32,7 +32,8 @@ public:
 	using CPtr = std::shared_ptr<const Wallet>;
 
 	Wallet(const Config::CPtr& pConfig, const Locked<IWalletDB>& walletDB, const SessionToken& token, const SecureVector& master_seed, const std::string& username, const KeyChainPath& user_path, const SlatepackAddress& address)
-		: m_pConfig(pConfig), m_walletDB(walletDB), m_token(token), m_master_seed(master_seed), m_username(username), m_userPath(user_path), m_address(address) { }
+		: m_pConfig(pConfig), m_walletDB(walletDB), m_token(token), m_master_seed(master_seed), m_username(username), m_userPath(user_path), m_address(address),
+		m_decryptKey(DeriveDecryptKey(*pConfig, master_seed)) { }
 
 	const std::string& GetUsername() const noexcept { return m_username; }
 	const KeyChainPath& GetUserPath() const noexcept { return m_userPath; }
@@ -75,9 +76,11 @@ public:
 
 	// Slate Finalize(const Slate& slate, const std::optional<SlatepackMessage>& slatepackOpt);
 
-	void CancelTx(const uint32_t walletTxId);
-
-	BuildCoinbaseResponse BuildCoinbase(const BuildCoinbaseCriteria& criteria);
+	//
+	// These only write to the wallet's database, which has its own lock, so they're safe to call with a read lock on the Wallet.
+	//
+	void CancelTx(const uint32_t walletTxId) const;
+	BuildCoinbaseResponse BuildCoinbase(const BuildCoinbaseCriteria& criteria) const;
 	SlatepackMessage DecryptSlatepack(const std::string& armoredSlatepack) const;
 
 	// //
@@ -95,6 +98,8 @@ public:
 	Locked<IWalletDB> GetDatabase() const { return m_walletDB; }
 
 private:
+	static x25519_keypair_t DeriveDecryptKey(const Config& config, const SecureVector& master_seed);
+
 	Config::CPtr m_pConfig;
 	Locked<IWalletDB> m_walletDB;
 	SessionToken m_token;
@@ -102,6 +107,10 @@ private:
 	std::string m_username; // Store Account (username and KeyChainPath), instead.
 	KeyChainPath m_userPath;
 	SlatepackAddress m_address;
+
+	// Derived once per session, rather than from the seed for every slatepack received.
+	x25519_keypair_t m_decryptKey;
+
 	std::optional<TorAddress> m_torAddressOpt;
 	uint16_t m_listenerPort;
 };
\ No newline at end of file
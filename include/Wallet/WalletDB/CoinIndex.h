@@ -0,0 +1,43 @@
+#pragma once
+
+#include <Wallet/WalletDB/Models/OutputDataEntity.h>
+#include <Crypto/Commitment.h>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+//
+// The wallet's spendable outputs, ordered by amount, so coins can be selected without copying or sorting every output.
+// Kept up to date by the wallet database as outputs are written, and only valid while the database's lock is held.
+//
+class CoinIndex
+{
+public:
+	using Coins = std::multimap<uint64_t, OutputDataEntity>;
+
+	CoinIndex() : m_loaded(false), m_total(0) { }
+
+	bool IsLoaded() const noexcept { return m_loaded; }
+
+	// Replaces the index with the SPENDABLE outputs among the given ones.
+	void Load(const std::vector<OutputDataEntity>& outputs);
+
+	// Adds, replaces or removes each output, based on whether it's now SPENDABLE. Ignored if the index isn't loaded.
+	void Update(const std::vector<OutputDataEntity>& outputs);
+
+	void Clear();
+
+	// Ordered from smallest to largest amount.
+	const Coins& GetCoins() const noexcept { return m_coins; }
+	uint64_t GetTotal() const noexcept { return m_total; }
+
+	const OutputDataEntity* Find(const Commitment& commitment) const;
+
+private:
+	void Remove(const Commitment& commitment);
+
+	bool m_loaded;
+	uint64_t m_total;
+	Coins m_coins;
+	std::unordered_map<Commitment, Coins::iterator> m_coinsByCommitment;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <Common/Util/TimeUtil.h>
+#include <Wallet/WalletTx.h>
+#include <Wallet/WalletTxType.h>
+#include <cstdint>
+#include <optional>
+#include <unordered_set>
+
+//
+// Selects a page of transactions using only their type and time, which are stored unencrypted,
+// so the transactions that don't match never need to be decrypted.
+// Transactions are returned in order of id.
+//
+class WalletTxQuery
+{
+public:
+	WalletTxQuery(
+		const std::unordered_set<EWalletTxType>& types,
+		const std::optional<int64_t>& startTimeMs,
+		const std::optional<int64_t>& endTimeMs,
+		const std::optional<uint64_t>& limit,
+		const uint64_t offset
+	) : m_types(types), m_startTimeMs(startTimeMs), m_endTimeMs(endTimeMs), m_limit(limit), m_offset(offset) { }
+
+	//
+	// The earlier of the creation and confirmation times, in milliseconds since epoch.
+	//
+	static int64_t GetTime(const WalletTx& walletTx)
+	{
+		std::chrono::system_clock::time_point txDateTime = walletTx.GetCreationTime();
+		if (walletTx.GetConfirmationTime().has_value() && walletTx.GetConfirmationTime().value() < txDateTime) {
+			txDateTime = walletTx.GetConfirmationTime().value();
+		}
+
+		return TimeUtil::ToInt64(txDateTime);
+	}
+
+	// Whether the transaction meets the type and time criteria. Ignores the limit and offset.
+	bool Matches(const WalletTx& walletTx) const
+	{
+		const int64_t txTime = GetTime(walletTx);
+		if (m_startTimeMs.has_value() && m_startTimeMs.value() > txTime) {
+			return false;
+		}
+
+		if (m_endTimeMs.has_value() && m_endTimeMs.value() < txTime) {
+			return false;
+		}
+
+		return m_types.empty() || m_types.count(walletTx.GetType()) > 0;
+	}
+
+	const std::unordered_set<EWalletTxType>& GetTypes() const noexcept { return m_types; }
+	const std::optional<int64_t>& GetStartTimeMs() const noexcept { return m_startTimeMs; }
+	const std::optional<int64_t>& GetEndTimeMs() const noexcept { return m_endTimeMs; }
+	const std::optional<uint64_t>& GetLimit() const noexcept { return m_limit; }
+	uint64_t GetOffset() const noexcept { return m_offset; }
+
+private:
+	std::unordered_set<EWalletTxType> m_types;
+	std::optional<int64_t> m_startTimeMs;
+	std::optional<int64_t> m_endTimeMs;
+	std::optional<uint64_t> m_limit;
+	uint64_t m_offset;
+};
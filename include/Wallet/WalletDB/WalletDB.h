@@ -11,6 +11,8 @@
 #include <Wallet/WalletDB/Models/SlateContextEntity.h>
 #include <Wallet/Models/Slate/Slate.h>
 #include <Wallet/WalletDB/Models/OutputDataEntity.h>
+#include <Wallet/WalletDB/CoinIndex.h>
+#include <Wallet/WalletDB/Models/WalletTxQuery.h>
 #include <Wallet/WalletTx.h>
 
 class IWalletDB : public Traits::IBatchable
@@ -31,14 +33,34 @@ public:
 		const Slate& slate
 	) = 0;
 
+	//
+	// Rewrites up to maxSlates slates saved in an older format in the current one, returning how many were rewritten.
+	// Called repeatedly in the background after login until it returns 0.
+	//
+	virtual size_t MigrateSlates(const SecureVector& masterSeed, const size_t maxSlates) = 0;
+
 	virtual std::unique_ptr<SlateContextEntity> LoadSlateContext(const SecureVector& masterSeed, const uuids::uuid& slateId) const = 0;
 	virtual void SaveSlateContext(const SecureVector& masterSeed, const uuids::uuid& slateId, const SlateContextEntity& slateContext) = 0;
 
 	virtual void AddOutputs(const SecureVector& masterSeed, const std::vector<OutputDataEntity>& outputs) = 0;
 	virtual std::vector<OutputDataEntity> GetOutputs(const SecureVector& masterSeed) const = 0;
 
+	// Every output not marked as SPENT, which for a long-lived wallet is a small fraction of its outputs.
+	virtual std::vector<OutputDataEntity> GetUnspentOutputs(const SecureVector& masterSeed) const = 0;
+
+	// The outputs belonging to the given transactions, selected using the unencrypted transaction_id column.
+	virtual std::vector<OutputDataEntity> GetOutputs(const SecureVector& masterSeed, const std::vector<uint32_t>& walletTxIds) const = 0;
+
+	//
+	// The SPENDABLE outputs, ordered by amount. Loaded on first use, and updated as each write is committed.
+	// The returned index must not be used after the lock on this database is released.
+	//
+	virtual const CoinIndex& GetCoinIndex(const SecureVector& masterSeed) const = 0;
+
 	virtual void AddTransaction(const SecureVector& masterSeed, const WalletTx& walletTx) = 0;
+	virtual void AddTransactions(const SecureVector& masterSeed, const std::vector<WalletTx>& walletTxs) = 0;
 	virtual std::vector<WalletTx> GetTransactions(const SecureVector& masterSeed) const = 0;
+	virtual std::vector<WalletTx> GetTransactions(const SecureVector& masterSeed, const WalletTxQuery& query) const = 0;
 	virtual std::unique_ptr<WalletTx> GetTransactionById(const SecureVector& masterSeed, const uint32_t walletTxId) const = 0;
 
 	virtual uint32_t GetNextTransactionId() = 0;
@@ -46,6 +68,9 @@ public:
 	virtual void UpdateRefreshBlockHeight(const uint64_t refreshBlockHeight) = 0;
 	virtual uint64_t GetRestoreLeafIndex() const = 0;
 	virtual void UpdateRestoreLeafIndex(const uint64_t lastLeafIndex) = 0;
+
+	// Drops any decrypted records held in memory, eg. once the wallet's sessions have logged out.
+	virtual void ClearCache() = 0;
 };
 
 typedef std::shared_ptr<IWalletDB> IWalletDBPtr;
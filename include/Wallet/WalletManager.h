@@ -27,6 +27,7 @@
 #include <API/Wallet/Foreign/Models/BuildCoinbaseResponse.h>
 #include <Wallet/Models/DTOs/WalletTxDTO.h>
 #include <Wallet/Models/DTOs/SelectionStrategyDTO.h>
+#include <Wallet/Models/DTOs/RestoreProgressDTO.h>
 #include <Wallet/Models/Slatepack/Armor.h>
 #include <Net/Tor/TorAddress.h>
 #include <Net/Tor/TorProcess.h>
@@ -72,6 +73,11 @@ public:
 		const bool fromGenesis
 	) = 0;
 
+	//
+	// Returns the progress of the wallet's current (or last) scan for outputs, without waiting on the scan.
+	//
+	virtual RestoreProgressDTO GetRestoreProgress(const SessionToken& token) const = 0;
+
 	virtual std::vector<GrinStr> GetAllAccounts() const = 0;
 
 	virtual std::optional<TorAddress> AddTorListener(
@@ -115,6 +121,15 @@ public:
 	//
 	virtual Slate Send(const SendCriteria& sendCriteria) = 0;
 
+	//
+	// Builds a slate for each send under a single wallet lock, in the same order. Each send spends different inputs.
+	// Inputs are selected for every send before any slate is built, so if any send can't be afforded, none are.
+	// Exceptions thrown:
+	// * SessionTokenException - If no matching session found, or if the token is invalid.
+	// * InsufficientFundsException - If there are not enough funds ready to spend for every send.
+	//
+	virtual std::vector<Slate> SendMany(const SessionToken& token, const std::vector<SendCriteria>& sends) = 0;
+
 	//
 	// Receives coins and builds a received slate to return to the sender.
 	//
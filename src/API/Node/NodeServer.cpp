@@ -1,21 +1,40 @@
 #include <API/Node/NodeServer.h>
 
 #include <API/Node/Handlers/GetHeaderHandler.h>
+#include <API/Node/Handlers/GetHeadersHandler.h>
 #include <API/Node/Handlers/GetBlockHandler.h>
+#include <API/Node/Handlers/GetKernelHandler.h>
+#include <API/Node/Handlers/GetMerkleProofHandler.h>
 #include <API/Node/Handlers/GetVersionHandler.h>
 #include <API/Node/Handlers/GetTipHandler.h>
 #include <API/Node/Handlers/PushTransactionHandler.h>
+#include <API/Node/Handlers/GetCacheStatsHandler.h>
+#include <API/Node/Handlers/GetBlockTemplateHandler.h>
+#include <API/Node/Handlers/GetBlockRootsHandler.h>
+#include <API/Node/Handlers/SubscribeHandler.h>
 
-NodeServer::UPtr NodeServer::Create(const ServerPtr& pServer, const IBlockChain::Ptr& pBlockChain, const IP2PServerPtr& pP2PServer)
+NodeServer::UPtr NodeServer::Create(
+    const ServerPtr& pServer,
+    const IBlockChain::Ptr& pBlockChain,
+    const IP2PServerPtr& pP2PServer,
+    const ITransactionPool::Ptr& pTransactionPool,
+    const ResponseCache::Ptr& pResponseCache)
 {
     RPCServer::Ptr pForeignServer = RPCServer::Create(pServer, "/v2/foreign", LoggerAPI::LogFile::NODE);
     pForeignServer->AddMethod("get_header", std::make_shared<GetHeaderHandler>(pBlockChain));
+    pForeignServer->AddMethod("get_headers", std::make_shared<GetHeadersHandler>(pP2PServer));
     pForeignServer->AddMethod("get_block", std::make_shared<GetBlockHandler>(pBlockChain));
+    pForeignServer->AddMethod("get_kernel", std::make_shared<GetKernelHandler>(pBlockChain));
+    pForeignServer->AddMethod("get_merkle_proof", std::make_shared<GetMerkleProofHandler>(pBlockChain));
     pForeignServer->AddMethod("get_version", std::make_shared<GetVersionHandler>(pBlockChain));
     pForeignServer->AddMethod("get_tip", std::make_shared<GetTipHandler>(pBlockChain));
     pForeignServer->AddMethod("push_transaction", std::make_shared<PushTransactionHandler>(pBlockChain, pP2PServer));
+    pForeignServer->AddMethod("subscribe", std::make_shared<SubscribeHandler>(pBlockChain, pTransactionPool));
 
     RPCServer::Ptr pOwnerServer = RPCServer::Create(pServer, "/v2/owner", LoggerAPI::LogFile::NODE);
+    pOwnerServer->AddMethod("get_cache_stats", std::make_shared<GetCacheStatsHandler>(pBlockChain, pP2PServer, pResponseCache));
+    pOwnerServer->AddMethod("get_block_template", std::make_shared<GetBlockTemplateHandler>(pBlockChain));
+    pOwnerServer->AddMethod("get_block_roots", std::make_shared<GetBlockRootsHandler>(pBlockChain));
 
     return std::make_unique<NodeServer>(pForeignServer, pOwnerServer);
 }
\ No newline at end of file
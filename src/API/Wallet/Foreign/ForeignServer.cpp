@@ -11,15 +11,55 @@ ForeignServer::UPtr ForeignServer::Create(
     const KeyChain& keyChain,
     const TorProcess::Ptr& pTorProcess,
     IWalletManager& walletManager,
-    const SessionToken& token)
+    const SessionToken& token,
+    const HttpServerConfig& config)
 {
     RPCServerPtr pServer = RPCServer::Create(
         EServerType::PUBLIC,
         std::nullopt,
         "/v2/foreign",
-        LoggerAPI::LogFile::WALLET
+        LoggerAPI::LogFile::WALLET,
+        config
     );
+    AddMethods(*pServer, pTorProcess, walletManager, token);
+
+    std::optional<TorAddress> addressOpt = AddTorListener(keyChain, pTorProcess, pServer->GetPortNumber());
+
+    pServer->GetServer()->AddListener("/status", StatusListener, nullptr);
+
+    return std::make_unique<ForeignServer>(pTorProcess, pServer, addressOpt, false);
+}
+
+ForeignServer::UPtr ForeignServer::CreateShared(
+    const KeyChain& keyChain,
+    const TorProcess::Ptr& pTorProcess,
+    IWalletManager& walletManager,
+    const SessionToken& token,
+    const ServerPtr& pSharedServer)
+{
+    RPCServerPtr pServer = RPCServer::CreateUnlistened(pSharedServer, LoggerAPI::LogFile::WALLET);
+    AddMethods(*pServer, pTorProcess, walletManager, token);
+
+    std::optional<TorAddress> addressOpt = std::nullopt;
+    try
+    {
+        ed25519_keypair_t torKey = keyChain.DeriveED25519Key(KeyChainPath::FromString("m/0/1/0"));
+        addressOpt = pTorProcess->AddListenerAsync(torKey.secret_key, pSharedServer->GetPortNumber());
+    }
+    catch (std::exception& e)
+    {
+        WALLET_ERROR_F("Exception thrown: {}", e.what());
+    }
+
+    return std::make_unique<ForeignServer>(pTorProcess, pServer, addressOpt, true);
+}
 
+void ForeignServer::AddMethods(
+    RPCServer& server,
+    const TorProcess::Ptr& pTorProcess,
+    IWalletManager& walletManager,
+    const SessionToken& token)
+{
     /*
         Request:
         {
@@ -170,9 +210,9 @@ ForeignServer::UPtr ForeignServer::Create(
             }
         }
     */
-    pServer->AddMethod("receive_tx", std::shared_ptr<RPCMethod>((RPCMethod*)new ReceiveTxHandler(walletManager, token)));
+    server.AddMethod("receive_tx", std::shared_ptr<RPCMethod>((RPCMethod*)new ReceiveTxHandler(walletManager, token)));
 
-    pServer->AddMethod("finalize_tx", std::shared_ptr<RPCMethod>((RPCMethod*)new FinalizeTxHandler(walletManager, token, pTorProcess)));
+    server.AddMethod("finalize_tx", std::shared_ptr<RPCMethod>((RPCMethod*)new FinalizeTxHandler(walletManager, token, pTorProcess)));
 
     /*
         Request:
@@ -197,7 +237,7 @@ ForeignServer::UPtr ForeignServer::Create(
             }
         }
     */
-    pServer->AddMethod("check_version", std::shared_ptr<RPCMethod>((RPCMethod*)new CheckVersionHandler()));
+    server.AddMethod("check_version", std::shared_ptr<RPCMethod>((RPCMethod*)new CheckVersionHandler()));
 
     /*
         Request:
@@ -237,13 +277,7 @@ ForeignServer::UPtr ForeignServer::Create(
             }
         }
     */
-    pServer->AddMethod("build_coinbase", std::shared_ptr<RPCMethod>((RPCMethod*)new BuildCoinbaseHandler(walletManager)));
-
-    std::optional<TorAddress> addressOpt = AddTorListener(keyChain, pTorProcess, pServer->GetPortNumber());
-
-    pServer->GetServer()->AddListener("/status", StatusListener, nullptr);
-
-    return std::make_unique<ForeignServer>(pTorProcess, pServer, addressOpt);
+    server.AddMethod("build_coinbase", std::shared_ptr<RPCMethod>((RPCMethod*)new BuildCoinbaseHandler(walletManager)));
 }
 
 std::optional<TorAddress> ForeignServer::AddTorListener(
@@ -8,6 +8,7 @@
 #include <API/Wallet/Owner/Handlers/LoginHandler.h>
 #include <API/Wallet/Owner/Handlers/LogoutHandler.h>
 #include <API/Wallet/Owner/Handlers/SendHandler.h>
+#include <API/Wallet/Owner/Handlers/SendManyHandler.h>
 #include <API/Wallet/Owner/Handlers/ReceiveHandler.h>
 #include <API/Wallet/Owner/Handlers/FinalizeHandler.h>
 #include <API/Wallet/Owner/Handlers/RetryTorHandler.h>
@@ -15,17 +16,22 @@
 #include <API/Wallet/Owner/Handlers/GetWalletSeedHandler.h>
 #include <API/Wallet/Owner/Handlers/CancelTxHandler.h>
 #include <API/Wallet/Owner/Handlers/GetBalanceHandler.h>
+#include <API/Wallet/Owner/Handlers/GetRestoreProgressHandler.h>
 #include <API/Wallet/Owner/Handlers/ListTxsHandler.h>
 #include <API/Wallet/Owner/Handlers/RepostTxHandler.h>
 #include <API/Wallet/Owner/Handlers/EstimateFeeHandler.h>
 
-OwnerServer::UPtr OwnerServer::Create(const TorProcess::Ptr& pTorProcess, const IWalletManagerPtr& pWalletManager)
+OwnerServer::UPtr OwnerServer::Create(
+    const TorProcess::Ptr& pTorProcess,
+    const IWalletManagerPtr& pWalletManager,
+    const HttpServerConfig& config)
 {
     RPCServerPtr pServer = RPCServer::Create(
         EServerType::LOCAL,
         std::make_optional<uint16_t>((uint16_t)3421), // TODO: Read port from config (Use same port as v1 owner)
         "/v2",
-        LoggerAPI::LogFile::WALLET
+        LoggerAPI::LogFile::WALLET,
+        config
     );
 
     /*
@@ -127,6 +133,39 @@ OwnerServer::UPtr OwnerServer::Create(const TorProcess::Ptr& pTorProcess, const
     pServer->AddMethod("logout", std::shared_ptr<RPCMethod>((RPCMethod*)new LogoutHandler(pWalletManager)));
 
     pServer->AddMethod("send", std::shared_ptr<RPCMethod>((RPCMethod*)new SendHandler(pTorProcess, pWalletManager)));
+
+    /*
+        Request:
+        {
+            "jsonrpc": "2.0",
+            "method": "send_many",
+            "id": 1,
+            "params": {
+                "session_token": "mFHve+/CFsPuQf1+Anp24+R1rLZCVBIyKF+fJEuxAappgT2WKMfpOiNwvRk=",
+                "sends": [
+                    {
+                        "amount": 1000000000,
+                        "fee_base": 500000,
+                        "change_outputs": 1,
+                        "selection_strategy": { "strategy": "SMALLEST" },
+                        "address": "grin1..."
+                    }
+                ]
+            }
+        }
+
+        Reply:
+        {
+            "id": 1,
+            "jsonrpc": "2.0",
+            "result": {
+                "results": [
+                    { "status": "FINALIZED", "slate": {...}, "slatepack": "BEGINSLATEPACK. ... ENDSLATEPACK." }
+                ]
+            }
+        }
+    */
+    pServer->AddMethod("send_many", std::shared_ptr<RPCMethod>((RPCMethod*)new SendManyHandler(pTorProcess, pWalletManager)));
     pServer->AddMethod("receive", std::shared_ptr<RPCMethod>((RPCMethod*)new ReceiveHandler(pWalletManager)));
     pServer->AddMethod("finalize", std::shared_ptr<RPCMethod>((RPCMethod*)new FinalizeHandler(pTorProcess, pWalletManager)));
     pServer->AddMethod("retry_tor", std::shared_ptr<RPCMethod>((RPCMethod*)new RetryTorHandler(pTorProcess, pWalletManager)));
@@ -226,6 +265,32 @@ OwnerServer::UPtr OwnerServer::Create(const TorProcess::Ptr& pTorProcess, const
     */
     pServer->AddMethod("get_balance", std::shared_ptr<RPCMethod>((RPCMethod*)new GetBalanceHandler(pWalletManager)));
 
+    /*
+        Request:
+        {
+            "jsonrpc": "2.0",
+            "method": "get_restore_progress",
+            "id": 1,
+            "params": {
+                "session_token": "mFHve+/CFsPuQf1+Anp24+R1rLZCVBIyKF+fJEuxAappgT2WKMfpOiNwvRk="
+            }
+        }
+
+        Reply:
+        {
+            "id": 1,
+            "jsonrpc": "2.0",
+            "result": {
+                "scanning": true,
+                "next_leaf_index": 1250000,
+                "highest_leaf_index": 5000000,
+                "outputs_found": 12,
+                "percentage_complete": 24
+            }
+        }
+    */
+    pServer->AddMethod("get_restore_progress", std::shared_ptr<RPCMethod>((RPCMethod*)new GetRestoreProgressHandler(pWalletManager)));
+
     /*
         Request:
         {
@@ -236,7 +301,9 @@ OwnerServer::UPtr OwnerServer::Create(const TorProcess::Ptr& pTorProcess, const
                 "session_token": "mFHve+/CFsPuQf1+Anp24+R1rLZCVBIyKF+fJEuxAappgT2WKMfpOiNwvRk=",
                 "start_range_ms": 1567361400000,
                 "end_range_ms": 1575227400000,
-                "statuses": ["COINBASE","SENT","RECEIVED","SENT_CANCELED","RECEIVED_CANCELED","SENDING_NOT_FINALIZED","RECEIVING_IN_PROGRESS", "SENDING_FINALIZED"]
+                "statuses": ["COINBASE","SENT","RECEIVED","SENT_CANCELED","RECEIVED_CANCELED","SENDING_NOT_FINALIZED","RECEIVING_IN_PROGRESS", "SENDING_FINALIZED"],
+                "limit": 50,
+                "offset": 0
             }
         }
 
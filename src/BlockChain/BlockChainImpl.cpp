@@ -10,12 +10,19 @@
 
 #include <GrinVersion.h>
 #include <Common/Logger.h>
+#include <Common/Metrics.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <Common/Util/FileUtil.h>
 #include <Core/Exceptions/BadDataException.h>
+#include <Core/Exceptions/BlockChainException.h>
 #include <Config/Config.h>
+#include <Core/Validation/TransactionValidator.h>
 #include <PMMR/TxHashSet.h>
 #include <Consensus/BlockTime.h>
 #include <filesystem.h>
 #include <algorithm>
+#include <deque>
 
 BlockChain::BlockChain(
 	const Config& config,
@@ -29,9 +36,29 @@ BlockChain::BlockChain(
 	m_pTxHashSetManager(pTxHashSetManager),
 	m_pTransactionPool(pTransactionPool),
 	m_pChainState(pChainState),
-	m_pHeaderMMR(pHeaderMMR)
+	m_pHeaderMMR(pHeaderMMR),
+	m_pArchiver(TxHashSetArchiver::Create(config, pChainState)),
+	m_pSnapshotPublisher(pChainState->Read()->GetSnapshotPublisher()),
+	m_pBlockCache(std::make_shared<SerializedBlockCache>()),
+	m_pProcessingTimers(std::make_shared<BlockProcessingTimers>()),
+	m_prunedHeight(0),
+	m_reverifiedHeight(0),
+	m_kernelIndexHeight(0),
+	m_compactedHeight(0)
 {
+	m_prunedHeight = LoadHeight("pruned_height.txt");
+	m_reverifiedHeight = LoadHeight("reverified_height.txt");
+	m_compactedHeight = LoadHeight("compacted_height.txt");
 
+	// The index is deleted whenever it's disabled (see BlockDB::OpenDB), so it's rebuilt from the start. Replicas leave that to the primary.
+	if (config.GetNodeConfig().IsKernelIndexEnabled() || config.GetNodeConfig().IsReplica())
+	{
+		m_kernelIndexHeight = LoadHeight("kernel_index_height.txt");
+	}
+	else
+	{
+		SaveHeight("kernel_index_height.txt", 0);
+	}
 }
 
 std::shared_ptr<BlockChain> BlockChain::Create(
@@ -44,7 +71,23 @@ std::shared_ptr<BlockChain> BlockChain::Create(
 	const FullBlock& genesisBlock = config.GetEnvironment().GetGenesisBlock();
 	auto pGenesisIndex = std::make_shared<BlockIndex>(genesisBlock.GetHash(), 0);
 
+	auto start = std::chrono::steady_clock::now();
+	auto logPhase = [&start](const char* phase) {
+		const auto now = std::chrono::steady_clock::now();
+		LOG_INFO_F("Startup: {} in {}ms", phase, std::chrono::duration_cast<std::chrono::milliseconds>(now - start).count());
+		start = now;
+	};
+
 	auto pChainStore = ChainStore::Load(config, pGenesisIndex);
+	logPhase("loaded chain store");
+
+	// Replicas never write, so everything below that initializes or upgrades the chain is left to the primary.
+	const bool replica = config.GetNodeConfig().IsReplica();
+	if (replica && pChainStore->Read()->GetCandidateChain()->GetHeight() == 0)
+	{
+		throw BLOCK_CHAIN_EXCEPTION("The primary's chain is empty");
+	}
+
 	auto pChainState = ChainState::Create(
 		config,
 		pChainStore,
@@ -54,8 +97,11 @@ std::shared_ptr<BlockChain> BlockChain::Create(
 		pTxHashSetManager,
 		genesisBlock
 	);
+	logPhase("loaded chain state and TxHashSet");
 
-	// Trigger Compaction
+	// A TxHashSet that's fallen behind the horizon can't be caught up, so it's closed to be downloaded again.
+	// Otherwise, it's compacted in the background by CompactTxHashSet.
+	if (!replica)
 	{
 		auto pBatch = pTxHashSetManager->BatchWrite();
 		auto pTxHashSet = pBatch->GetTxHashSet();
@@ -66,18 +112,15 @@ std::shared_ptr<BlockChain> BlockChain::Create(
 			{
 				pTxHashSetManager->Write()->Close();
 			}
-			else
-			{
-				pTxHashSet->Compact();
-			}
 
 			pBatch->Commit();
 		}
 	}
+	logPhase("checked TxHashSet horizon");
 
 	const auto versionPath = config.GetDataDirectory() / "NODE" / "version.txt";
 	std::vector<uint8_t> versionData;
-	if (!FileUtil::ReadFile(versionPath, versionData))
+	if (!replica && !FileUtil::ReadFile(versionPath, versionData))
 	{
 		LOG_WARNING_F("Updating chain for version {}", GRINPP_VERSION);
 		auto pBlockDB = pDatabase->Write();
@@ -110,34 +153,211 @@ std::shared_ptr<BlockChain> BlockChain::Create(
 void BlockChain::ResyncChain()
 {
 	ChainResyncer(m_pChainState).ResyncChain();
+
+	m_prunedHeight = 0;
+	SaveHeight("pruned_height.txt", 0);
+
+	m_reverifiedHeight = 0;
+	SaveHeight("reverified_height.txt", 0);
+
+	m_kernelIndexHeight = 0;
+	SaveHeight("kernel_index_height.txt", 0);
+
+	m_compactedHeight = 0;
+	SaveHeight("compacted_height.txt", 0);
+}
+
+void BlockChain::CatchUpWithPrimary()
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	// The batch is rolled back rather than committed, which only discards the (empty) batch of each part of the chain state.
+	auto pBatch = m_pChainState->BatchWrite();
+	pBatch->CatchUpWithPrimary(m_config.GetEnvironment().GetGenesisBlock());
+
+	LOG_DEBUG_F(
+		"Caught up with primary at height {} in {}ms",
+		pBatch->GetHeight(EChainType::CONFIRMED),
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+	);
 }
 
+//
+// The confirmed and candidate tips are read from the latest snapshot, without taking the chain state lock.
+//
 void BlockChain::UpdateSyncStatus(SyncStatus& syncStatus) const
 {
-	m_pChainState->Read()->UpdateSyncStatus(syncStatus);
+	ChainSnapshot::CPtr pSnapshot = m_pSnapshotPublisher->Get();
+
+	const BlockHeaderPtr& pCandidateHead = pSnapshot->GetTip(EChainType::CANDIDATE);
+	if (pCandidateHead != nullptr)
+	{
+		syncStatus.UpdateHeaderStatus(pCandidateHead->GetHeight(), pCandidateHead->GetTotalDifficulty());
+	}
+
+	const BlockHeaderPtr& pConfirmedHead = pSnapshot->GetTip(EChainType::CONFIRMED);
+	if (pConfirmedHead != nullptr)
+	{
+		syncStatus.UpdateBlockStatus(pConfirmedHead->GetHeight(), pConfirmedHead->GetTotalDifficulty());
+	}
+
+	const BlockProcessingStats stats = m_pProcessingTimers->GetStats();
+	syncStatus.UpdateBlockVerificationStatus(stats.numRangeProofs, stats.numKernels);
 }
 
 uint64_t BlockChain::GetHeight(const EChainType chainType) const
 {
-	return m_pChainState->Read()->GetHeight(chainType);
+	if (chainType == EChainType::SYNC)
+	{
+		return m_pChainState->ScopedRead()->GetHeight(chainType);
+	}
+
+	return m_pSnapshotPublisher->Get()->GetHeight(chainType);
 }
 
 uint64_t BlockChain::GetTotalDifficulty(const EChainType chainType) const
 {
-	return m_pChainState->Read()->GetTotalDifficulty(chainType);
+	if (chainType == EChainType::SYNC)
+	{
+		return m_pChainState->ScopedRead()->GetTotalDifficulty(chainType);
+	}
+
+	return m_pSnapshotPublisher->Get()->GetTotalDifficulty(chainType);
+}
+
+bool BlockChain::VerifySelfConsistent(const FullBlock& block) const
+{
+	try
+	{
+		BlockProcessor::VerifySelfConsistent(block, IsAssumedValid(*block.GetHeader()), *m_pProcessingTimers);
+		return true;
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Invalid block {}: {}", block, e.what());
+		return false;
+	}
+}
+
+//
+// Records how long it took to process each of numBlocks blocks that were processed together.
+//
+static void ObserveBlockLatency(const std::chrono::steady_clock::time_point& start, const size_t numBlocks)
+{
+	static MetricHistogram& latency = MetricsAPI::RegisterHistogram(
+		"grin_block_processing_seconds",
+		"Time taken to validate and apply a block, averaged over blocks processed together.",
+		{ 0.001, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0 }
+	);
+
+	if (numBlocks > 0)
+	{
+		const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		for (size_t i = 0; i < numBlocks; i++)
+		{
+			latency.Observe(seconds / numBlocks);
+		}
+	}
 }
 
 EBlockChainStatus BlockChain::AddBlock(const FullBlock& block)
 {
+	const auto start = std::chrono::steady_clock::now();
+
+	EBlockChainStatus status = EBlockChainStatus::INVALID;
 	try
 	{
-		return BlockProcessor(m_config, m_pChainState).ProcessBlock(block);
+		status = BlockProcessor(m_config, m_pChainState, m_pProcessingTimers).ProcessBlock(block);
 	}
 	catch (std::exception& e)
 	{
 		LOG_ERROR_F("Invalid block: {}", e.what());
 		return EBlockChainStatus::INVALID;
 	}
+
+	if (status == EBlockChainStatus::SUCCESS)
+	{
+		ObserveBlockLatency(start, 1);
+	}
+
+	if (status == EBlockChainStatus::SUCCESS)
+	{
+		// A new tip is about to be requested by every peer, but blocks added while syncing are not.
+		bool isNewTip = false;
+		{
+			auto pReader = m_pChainState->ScopedRead();
+			isNewTip = pReader->GetTipBlockHeader(EChainType::CONFIRMED)->GetHash() == block.GetHash()
+				&& pReader->GetTipBlockHeader(EChainType::CANDIDATE)->GetHash() == block.GetHash();
+		}
+
+		if (isNewTip)
+		{
+			m_pBlockCache->AddBlock(block);
+		}
+
+		ConnectOrphans(block.GetHash());
+	}
+
+	return status;
+}
+
+std::vector<EBlockChainStatus> BlockChain::AddBlocks(const std::vector<FullBlock::CPtr>& blocks)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	size_t numAdded = 0;
+	try
+	{
+		numAdded = BlockProcessor(m_config, m_pChainState, m_pProcessingTimers).ProcessBlocks(blocks);
+	}
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Failed to add {} blocks together: {}", blocks.size(), e.what());
+	}
+
+	ObserveBlockLatency(start, numAdded);
+
+	std::vector<EBlockChainStatus> statuses(numAdded, EBlockChainStatus::SUCCESS);
+	for (size_t i = 0; i < numAdded; i++)
+	{
+		ConnectOrphans(blocks[i]->GetHash());
+	}
+
+	// Whatever couldn't be added with the group is added one block at a time, so an invalid block is reported on its own.
+	for (size_t i = numAdded; i < blocks.size(); i++)
+	{
+		statuses.push_back(AddBlock(*blocks[i]));
+	}
+
+	return statuses;
+}
+
+// Breadth first, so each generation of descendants is connected as soon as its parent is.
+void BlockChain::ConnectOrphans(const Hash& parentHash)
+{
+	std::deque<Hash> parents({ parentHash });
+	while (!parents.empty())
+	{
+		const std::vector<std::shared_ptr<const FullBlock>> children = m_pChainState->ScopedRead()->GetOrphanChildren(parents.front());
+		parents.pop_front();
+
+		for (const std::shared_ptr<const FullBlock>& pChild : children)
+		{
+			try
+			{
+				if (BlockProcessor(m_config, m_pChainState, m_pProcessingTimers).ProcessBlock(*pChild) == EBlockChainStatus::SUCCESS)
+				{
+					LOG_DEBUG_F("Connected orphan {}", *pChild);
+					parents.push_back(pChild->GetHash());
+				}
+			}
+			catch (std::exception& e)
+			{
+				LOG_WARNING_F("Failed to connect orphan {}: {}", *pChild, e.what());
+				m_pChainState->Write()->GetOrphanPool()->RemoveOrphan(pChild->GetHash());
+			}
+		}
+	}
 }
 
 EBlockChainStatus BlockChain::AddCompactBlock(const CompactBlock& compactBlock)
@@ -146,7 +366,7 @@ EBlockChainStatus BlockChain::AddCompactBlock(const CompactBlock& compactBlock)
 	const uint64_t height = compactBlock.GetHeight();
 
 	{
-		auto pReader = m_pChainState->Read();
+		auto pReader = m_pChainState->ScopedRead();
 		auto pConfirmed = pReader->GetChainStore()->GetConfirmedChain()->GetByHeight(height);
 		if (pConfirmed != nullptr && pConfirmed->GetHash() == hash)
 		{
@@ -154,9 +374,32 @@ EBlockChainStatus BlockChain::AddCompactBlock(const CompactBlock& compactBlock)
 		}
 	}
 
+	// The header (mostly its proof-of-work) is validated on the pool while the block is hydrated, since compact blocks
+	// pushed by peers usually arrive before their header does.
+	ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+	std::future<EBlockChainStatus> headerAdded = threadPool.Submit(
+		[this, pHeader = compactBlock.GetHeader()]() { return AddBlockHeader(pHeader); },
+		ETaskPriority::HIGH
+	);
+
+	std::unique_ptr<FullBlock> pHydratedBlock = nullptr;
+	try
+	{
+		pHydratedBlock = BlockHydrator(m_pTransactionPool).Hydrate(compactBlock);
+	}
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Exception thrown: {}", e.what());
+	}
+
+	threadPool.Wait(headerAdded);
+	if (headerAdded.get() == EBlockChainStatus::INVALID)
+	{
+		return EBlockChainStatus::INVALID;
+	}
+
 	try
 	{
-		std::unique_ptr<FullBlock> pHydratedBlock = BlockHydrator(m_pTransactionPool).Hydrate(compactBlock);
 		if (pHydratedBlock != nullptr)
 		{
 			const EBlockChainStatus added = AddBlock(*pHydratedBlock);
@@ -176,42 +419,116 @@ EBlockChainStatus BlockChain::AddCompactBlock(const CompactBlock& compactBlock)
 	return EBlockChainStatus::TRANSACTIONS_MISSING;
 }
 
-fs::path BlockChain::SnapshotTxHashSet(BlockHeaderPtr pBlockHeader)
+EBlockChainStatus BlockChain::ProcessTransactionHashSet(
+	const Hash& blockHash,
+	const fs::path& path,
+	const TxHashSetDownload::Ptr& pDownload,
+	SyncStatus& syncStatus)
 {
-	// TODO: Use reader if possible
-	auto pBatch = m_pChainState->BatchWrite(); // DO NOT COMMIT THIS BATCH
-	const uint64_t horizon = Consensus::GetHorizonHeight(pBatch->GetHeight(EChainType::CONFIRMED));
-	if (pBlockHeader->GetHeight() < horizon)
+	try
+	{
+		const bool success = TxHashSetProcessor(m_config, *this, m_pChainState).ProcessTxHashSet(blockHash, path, pDownload.get(), syncStatus);
+		if (success)
+		{
+			OnTxHashSetReplaced();
+
+			// The blocks above the TxHashSet that were prefetched while it was validated (see BlockSyncer::PrefetchBlocks).
+			ConnectOrphans(blockHash);
+			return EBlockChainStatus::SUCCESS;
+		}
+	}
+	catch (std::exception& e)
 	{
-		throw BAD_DATA_EXCEPTION("TxHashSet snapshot requested beyond horizon.");
+		LOG_ERROR_F("Failed to process TxHashSet: {}", e.what());
 	}
 
-	return pBatch->GetTxHashSetManager()->SaveSnapshot(pBatch->GetBlockDB(), pBlockHeader);
+	return EBlockChainStatus::INVALID;
+}
+
+fs::path BlockChain::ExportTxHashSetSnapshot(BlockHeaderPtr pBlockHeader)
+{
+	const fs::path destination = m_config.GetNodeConfig().GetSnapshotPath() / pBlockHeader->GetHash().ToHex();
+	m_pArchiver->Export(pBlockHeader, destination);
+
+	return destination;
 }
 
-EBlockChainStatus BlockChain::ProcessTransactionHashSet(const Hash& blockHash, const fs::path& path, SyncStatus& syncStatus)
+EBlockChainStatus BlockChain::ImportTxHashSetSnapshot(const fs::path& directory, SyncStatus& syncStatus)
 {
 	try
 	{
-		const bool success = TxHashSetProcessor(m_config, *this, m_pChainState).ProcessTxHashSet(blockHash, path, syncStatus);
+		std::unique_ptr<TxHashSetManager::SnapshotManifest> pManifest = TxHashSetManager::ReadSnapshotManifest(m_config, directory);
+
+		// Only the TxHashSet comes from the snapshot. Its block must already be on the candidate chain from header sync.
+		BlockHeaderPtr pHeader = GetBlockHeaderByHeight(pManifest->pHeader->GetHeight(), EChainType::CANDIDATE);
+		if (pHeader == nullptr)
+		{
+			return EBlockChainStatus::ORPHANED;
+		}
+
+		if (pHeader->GetHash() != pManifest->pHeader->GetHash())
+		{
+			LOG_ERROR_F("Snapshot {} is not on the candidate chain", *pManifest->pHeader);
+			return EBlockChainStatus::INVALID;
+		}
+
+		const bool success = TxHashSetProcessor(m_config, *this, m_pChainState).ProcessSnapshot(directory, *pManifest, syncStatus);
 		if (success)
 		{
+			OnTxHashSetReplaced();
 			return EBlockChainStatus::SUCCESS;
 		}
 	}
 	catch (std::exception& e)
 	{
-		LOG_ERROR_F("Failed to process TxHashSet: {}", e.what());
+		LOG_ERROR_F("Failed to import TxHashSet snapshot: {}", e.what());
 	}
 
 	return EBlockChainStatus::INVALID;
 }
 
+void BlockChain::OnTxHashSetReplaced()
+{
+	// The kernel index was cleared along with the old TxHashSet.
+	m_kernelIndexHeight = 0;
+	SaveHeight("kernel_index_height.txt", 0);
+
+	m_compactedHeight = 0;
+	SaveHeight("compacted_height.txt", 0);
+}
+
+bool BlockChain::VerifySelfConsistent(const Transaction& transaction) const
+{
+	try
+	{
+		TransactionValidator().Validate(transaction);
+		return true;
+	}
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Invalid transaction {}: {}", transaction, e.what());
+		return false;
+	}
+}
+
+std::vector<bool> BlockChain::VerifySelfConsistent(const std::vector<TransactionPtr>& transactions) const
+{
+	try
+	{
+		return TransactionValidator().ValidateBatch(transactions);
+	}
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Failed to validate {} transactions: {}", transactions.size(), e.what());
+		return std::vector<bool>(transactions.size(), false);
+	}
+}
+
 EBlockChainStatus BlockChain::AddTransaction(TransactionPtr pTransaction, const EPoolType poolType)
 {
 	try
 	{
-		auto pReader = m_pChainState->Read();
+		auto pReader = m_pChainState->ScopedRead();
 		auto pLastConfimedHeader = pReader->GetTipBlockHeader(EChainType::CONFIRMED);
 		if (pLastConfimedHeader != nullptr)
 		{
@@ -249,6 +566,31 @@ TransactionPtr BlockChain::GetTransactionByKernelHash(const Hash& kernelHash) co
 	return m_pTransactionPool->FindTransactionByKernelHash(kernelHash);
 }
 
+BlockTemplate::CPtr BlockChain::GetBlockTemplate() const
+{
+	auto pReader = m_pChainState->ScopedRead();
+	auto pTipHeader = pReader->GetTipBlockHeader(EChainType::CONFIRMED);
+	auto pTxHashSet = pReader->GetTxHashSetManager()->GetTxHashSet();
+	if (pTipHeader == nullptr || pTxHashSet == nullptr)
+	{
+		throw BLOCK_CHAIN_EXCEPTION("Chain not synced.");
+	}
+
+	return m_pTransactionPool->GetBlockTemplate(pReader->GetBlockDB().GetShared(), pTxHashSet, pTipHeader);
+}
+
+TxHashSetRoots BlockChain::GetBlockRoots(const TransactionBody& body) const
+{
+	auto pReader = m_pChainState->ScopedRead();
+	auto pTxHashSet = pReader->GetTxHashSetManager()->GetTxHashSet();
+	if (pTxHashSet == nullptr)
+	{
+		throw BLOCK_CHAIN_EXCEPTION("Chain not synced.");
+	}
+
+	return pTxHashSet->GetRoots(pReader->GetBlockDB().GetShared(), body);
+}
+
 EBlockChainStatus BlockChain::AddBlockHeader(BlockHeaderPtr pBlockHeader)
 {
 	try
@@ -280,44 +622,40 @@ EBlockChainStatus BlockChain::AddBlockHeaders(const std::vector<BlockHeaderPtr>&
 
 std::vector<BlockHeaderPtr> BlockChain::GetBlockHeadersByHash(const std::vector<CBigInteger<32>>& hashes) const
 {
-	auto pReader = m_pChainState->Read();
-
-	std::vector<BlockHeaderPtr> headers;
-	for (const CBigInteger<32>& hash : hashes)
-	{
-		BlockHeaderPtr pHeader = pReader->GetBlockHeaderByHash(hash);
-		if (pHeader != nullptr)
-		{
-			headers.push_back(pHeader);
-		}
-	}
+	std::vector<BlockHeaderPtr> headers = m_pChainState->ScopedRead()->GetBlockHeadersByHash(hashes);
+	headers.erase(std::remove(headers.begin(), headers.end(), nullptr), headers.end());
 
 	return headers;
 }
 
 BlockHeaderPtr BlockChain::GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const
 {
-	return m_pChainState->Read()->GetBlockHeaderByHeight(height, chainType);
+	return m_pChainState->ScopedRead()->GetBlockHeaderByHeight(height, chainType);
 }
 
 BlockHeaderPtr BlockChain::GetBlockHeaderByHash(const CBigInteger<32>& hash) const
 {
-	return m_pChainState->Read()->GetBlockHeaderByHash(hash);
+	return m_pChainState->ScopedRead()->GetBlockHeaderByHash(hash);
 }
 
 BlockHeaderPtr BlockChain::GetBlockHeaderByCommitment(const Commitment& outputCommitment) const
 {
-	return m_pChainState->Read()->GetBlockHeaderByCommitment(outputCommitment);
+	return m_pChainState->ScopedRead()->GetBlockHeaderByCommitment(outputCommitment);
 }
 
 BlockHeaderPtr BlockChain::GetTipBlockHeader(const EChainType chainType) const
 {
-	return m_pChainState->Read()->GetTipBlockHeader(chainType);
+	if (chainType == EChainType::SYNC)
+	{
+		return m_pChainState->ScopedRead()->GetTipBlockHeader(chainType);
+	}
+
+	return m_pSnapshotPublisher->Get()->GetTip(chainType);
 }
 
 std::unique_ptr<CompactBlock> BlockChain::GetCompactBlockByHash(const Hash& hash) const
 {
-	std::unique_ptr<FullBlock> pBlock = m_pChainState->Read()->GetBlockByHash(hash);
+	std::unique_ptr<FullBlock> pBlock = m_pChainState->ScopedRead()->GetBlockByHash(hash);
 	if (pBlock != nullptr)
 	{
 		return std::make_unique<CompactBlock>(CompactBlockFactory::CreateCompactBlock(*pBlock));
@@ -326,9 +664,44 @@ std::unique_ptr<CompactBlock> BlockChain::GetCompactBlockByHash(const Hash& hash
 	return std::unique_ptr<CompactBlock>(nullptr);
 }
 
+std::shared_ptr<const std::vector<uint8_t>> BlockChain::GetSerializedBlock(const Hash& hash, const EProtocolVersion protocolVersion) const
+{
+	return GetSerializedBlock(hash, false, protocolVersion);
+}
+
+std::shared_ptr<const std::vector<uint8_t>> BlockChain::GetSerializedCompactBlock(const Hash& hash, const EProtocolVersion protocolVersion) const
+{
+	return GetSerializedBlock(hash, true, protocolVersion);
+}
+
+SerializedBlockCache::Bytes BlockChain::GetSerializedBlock(const Hash& hash, const bool compact, const EProtocolVersion protocolVersion) const
+{
+	SerializedBlockCache::Bytes pSerialized = m_pBlockCache->Get(hash, compact, protocolVersion);
+	if (pSerialized != nullptr)
+	{
+		return pSerialized;
+	}
+
+	std::unique_ptr<FullBlock> pBlock = GetBlockByHash(hash);
+	if (pBlock == nullptr)
+	{
+		return nullptr;
+	}
+
+	pSerialized = SerializedBlockCache::Serialize(*pBlock, compact, protocolVersion);
+
+	// Older blocks are only cached if they're recent enough that other peers are likely to request them too.
+	if (pBlock->GetHeight() + SerializedBlockCache::MAX_BLOCKS > GetHeight(EChainType::CONFIRMED))
+	{
+		m_pBlockCache->Add(hash, compact, protocolVersion, pSerialized);
+	}
+
+	return pSerialized;
+}
+
 std::unique_ptr<FullBlock> BlockChain::GetBlockByCommitment(const Commitment& outputCommitment) const
 {
-	auto pHeader = m_pChainState->Read()->GetBlockHeaderByCommitment(outputCommitment);
+	auto pHeader = m_pChainState->ScopedRead()->GetBlockHeaderByCommitment(outputCommitment);
 	if (pHeader != nullptr)
 	{
 		return GetBlockByHash(pHeader->GetHash());
@@ -339,40 +712,22 @@ std::unique_ptr<FullBlock> BlockChain::GetBlockByCommitment(const Commitment& ou
 
 std::unique_ptr<FullBlock> BlockChain::GetBlockByHash(const Hash& hash) const
 {
-	return m_pChainState->Read()->GetBlockByHash(hash);
+	return m_pChainState->ScopedRead()->GetBlockByHash(hash);
 }
 
 std::unique_ptr<FullBlock> BlockChain::GetBlockByHeight(const uint64_t height) const
 {
-	return m_pChainState->Read()->GetBlockByHeight(height);
+	return m_pChainState->ScopedRead()->GetBlockByHeight(height);
 }
 
 std::vector<BlockWithOutputs> BlockChain::GetOutputsByHeight(const uint64_t startHeight, const uint64_t maxHeight) const
 {
-	auto pChainStateReader = m_pChainState->Read();
-	const uint64_t highestHeight = (std::min)(pChainStateReader->GetHeight(EChainType::CONFIRMED), maxHeight);
-
-	std::vector<BlockWithOutputs> blocksWithOutputs;
-	blocksWithOutputs.reserve(highestHeight - startHeight + 1);
-
-	uint64_t height = startHeight;
-	while (height <= highestHeight)
-	{
-		std::unique_ptr<BlockWithOutputs> pBlockWithOutputs = pChainStateReader->GetBlockWithOutputs(height);
-		if (pBlockWithOutputs != nullptr)
-		{
-			blocksWithOutputs.push_back(*pBlockWithOutputs);
-		}
-
-		++height;
-	}
-
-	return blocksWithOutputs;
+	return m_pChainState->ScopedRead()->GetOutputsByHeight(startHeight, maxHeight);
 }
 
 bool BlockChain::HasBlock(const uint64_t height, const Hash& hash) const
 {
-	auto pChainStateReader = m_pChainState->Read();
+	auto pChainStateReader = m_pChainState->ScopedRead();
 	
 	auto pIndex = pChainStateReader->GetChainStore()->GetConfirmedChain()->GetByHeight(height);
 
@@ -381,7 +736,12 @@ bool BlockChain::HasBlock(const uint64_t height, const Hash& hash) const
 
 std::vector<std::pair<uint64_t, Hash>> BlockChain::GetBlocksNeeded(const uint64_t maxNumBlocks) const
 {
-	return m_pChainState->Read()->GetBlocksNeeded(maxNumBlocks);
+	return m_pChainState->ScopedRead()->GetBlocksNeeded(maxNumBlocks);
+}
+
+std::vector<std::pair<uint64_t, Hash>> BlockChain::GetBlocksToPrefetch(const uint64_t firstHeight, const uint64_t maxNumBlocks) const
+{
+	return m_pChainState->ScopedRead()->GetBlocksToPrefetch(firstHeight, maxNumBlocks);
 }
 
 bool BlockChain::ProcessNextOrphanBlock()
@@ -390,7 +750,7 @@ bool BlockChain::ProcessNextOrphanBlock()
 	std::shared_ptr<const FullBlock> pOrphanBlock = nullptr;
 
 	{
-		auto pReader = m_pChainState->Read();
+		auto pReader = m_pChainState->ScopedRead();
 		const uint64_t height = pReader->GetHeight(EChainType::CONFIRMED) + 1;
 		pNextHeader = pReader->GetBlockHeaderByHeight(height, EChainType::CANDIDATE);
 		if (pNextHeader == nullptr)
@@ -398,7 +758,7 @@ bool BlockChain::ProcessNextOrphanBlock()
 			return false;
 		}
 
-		pOrphanBlock = pReader->GetOrphanBlock(height, pNextHeader->GetHash());
+		pOrphanBlock = pReader->GetOrphanBlock(pNextHeader->GetHash());
 		if (pOrphanBlock == nullptr)
 		{
 			return false;
@@ -407,13 +767,403 @@ bool BlockChain::ProcessNextOrphanBlock()
 
 	try
 	{
-		return BlockProcessor(m_config, m_pChainState).ProcessBlock(*pOrphanBlock) == EBlockChainStatus::SUCCESS;
+		if (BlockProcessor(m_config, m_pChainState, m_pProcessingTimers).ProcessBlock(*pOrphanBlock) == EBlockChainStatus::SUCCESS)
+		{
+			ConnectOrphans(pOrphanBlock->GetHash());
+			return true;
+		}
+
+		return false;
 	}
 	catch (std::exception&)
 	{
-		m_pChainState->Write()->GetOrphanPool()->RemoveOrphan(pNextHeader->GetHeight(), pNextHeader->GetHash());
+		m_pChainState->Write()->GetOrphanPool()->RemoveOrphan(pNextHeader->GetHash());
+		return false;
+	}
+}
+
+//
+// Blocks are pruned in small batches, so the chain state lock is never held long enough to stall block processing.
+// The horizon is never below the cut-through horizon, since blocks within it may still be needed to rewind.
+//
+bool BlockChain::PruneBlocks()
+{
+	static const uint64_t MAX_BLOCKS_PER_BATCH = 500;
+
+	const uint64_t pruneHorizon = m_config.GetNodeConfig().GetPruneHorizon();
+	if (pruneHorizon == 0)
+	{
+		return false;
+	}
+
+	const uint64_t horizon = (std::max)(pruneHorizon, (uint64_t)Consensus::CUT_THROUGH_HORIZON);
+	const uint64_t confirmedHeight = m_pSnapshotPublisher->Get()->GetHeight(EChainType::CONFIRMED);
+	if (confirmedHeight <= horizon || (confirmedHeight - horizon) <= m_prunedHeight)
+	{
+		return false;
+	}
+
+	const uint64_t pruneToHeight = (std::min)(confirmedHeight - horizon, m_prunedHeight + MAX_BLOCKS_PER_BATCH);
+
+	std::vector<Hash> hashes;
+	{
+		auto pReader = m_pChainState->ScopedRead();
+		auto pConfirmedChain = pReader->GetChainStore()->GetConfirmedChain();
+		for (uint64_t height = m_prunedHeight + 1; height <= pruneToHeight; height++)
+		{
+			auto pIndex = pConfirmedChain->GetByHeight(height);
+			if (pIndex != nullptr)
+			{
+				hashes.push_back(pIndex->GetHash());
+			}
+		}
+	}
+
+	{
+		auto pBatch = m_pChainState->BatchWrite();
+		pBatch->GetBlockDB()->RemoveBlocks(hashes);
+		pBatch->Commit();
+	}
+
+	LOG_DEBUG_F("Pruned blocks up to height {}", pruneToHeight);
+
+	m_prunedHeight = pruneToHeight;
+	SaveHeight("pruned_height.txt", pruneToHeight);
+
+	return pruneToHeight < (confirmedHeight - horizon);
+}
+
+//
+// Compacts in three steps, so only the last one holds up block processing:
+// the leaves spent since the horizon are looked up under the read lock, the compacted files are written below the horizon
+// without any lock, and then the rest of each file is copied and the files swapped in under the write lock.
+//
+void BlockChain::CompactTxHashSet()
+{
+	static const uint64_t COMPACTION_INTERVAL = Consensus::DAY_HEIGHT;
+	static MetricCounter& numCompactions = MetricsAPI::RegisterCounter(
+		"grin_txhashset_compactions_total",
+		"Number of TxHashSet compactions applied."
+	);
+	static MetricCounter& numPrunedOutputs = MetricsAPI::RegisterCounter(
+		"grin_txhashset_compacted_outputs_total",
+		"Number of spent outputs removed from the TxHashSet by compaction."
+	);
+	static MetricCounter& buildMicros = MetricsAPI::RegisterCounter(
+		"grin_txhashset_compaction_micros_total",
+		"Time spent compacting the TxHashSet, by phase.",
+		MetricsWriter::Label("phase", "build")
+	);
+	static MetricCounter& swapMicros = MetricsAPI::RegisterCounter(
+		"grin_txhashset_compaction_micros_total",
+		"Time spent compacting the TxHashSet, by phase.",
+		MetricsWriter::Label("phase", "swap")
+	);
+
+	if (!m_config.GetNodeConfig().IsTxHashSetCompactionEnabled())
+	{
+		return;
+	}
+
+	const uint64_t horizon = Consensus::GetHorizonHeight(m_pSnapshotPublisher->Get()->GetHeight(EChainType::CONFIRMED));
+	if (horizon < m_compactedHeight + COMPACTION_INTERVAL)
+	{
+		return;
+	}
+
+	try
+	{
+		const auto start = std::chrono::steady_clock::now();
+
+		ITxHashSetCompaction::UPtr pCompaction = nullptr;
+		{
+			auto pReader = m_pChainState->ScopedRead();
+			auto pTxHashSet = pReader->GetTxHashSetManager()->GetTxHashSet();
+			BlockHeaderPtr pHorizonHeader = pReader->GetBlockHeaderByHeight(horizon, EChainType::CONFIRMED);
+			if (pTxHashSet == nullptr || pHorizonHeader == nullptr)
+			{
+				return;
+			}
+
+			pCompaction = pTxHashSet->PrepareCompaction(*pReader->GetBlockDB(), pHorizonHeader);
+		}
+
+		LOG_INFO_F("Compacting TxHashSet to {}", *pCompaction->GetHorizonHeader());
+		pCompaction->Build();
+
+		const auto built = std::chrono::steady_clock::now();
+		buildMicros.Add(std::chrono::duration_cast<std::chrono::microseconds>(built - start).count());
+
+		if (!pCompaction->IsEmpty())
+		{
+			auto pBatch = m_pChainState->BatchWrite();
+
+			// The TxHashSet checks that it's the one the compaction was prepared for, but a reorg could have replaced the horizon block.
+			BlockHeaderPtr pHorizonHeader = pBatch->GetBlockHeaderByHeight(horizon, EChainType::CONFIRMED);
+			auto pTxHashSet = pBatch->GetTxHashSetManager()->GetTxHashSet();
+			if (pTxHashSet == nullptr || pHorizonHeader == nullptr || pHorizonHeader->GetHash() != pCompaction->GetHorizonHeader()->GetHash())
+			{
+				throw BLOCK_CHAIN_EXCEPTION("Chain changed while compacting");
+			}
+
+			pTxHashSet->ApplyCompaction(*pCompaction);
+			pBatch->Commit();
+
+			const uint64_t swapUs = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - built).count();
+			swapMicros.Add(swapUs);
+			numCompactions.Add();
+			numPrunedOutputs.Add(pCompaction->GetNumPrunedOutputs());
+			LOG_INFO_F(
+				"Compacted TxHashSet in {}ms, holding the chain lock for {}ms",
+				std::chrono::duration_cast<std::chrono::milliseconds>(built - start).count(),
+				swapUs / 1000
+			);
+		}
+	}
+	catch (std::exception& e)
+	{
+		// Retried once the horizon moves another interval, rather than on every call.
+		LOG_ERROR_F("Failed to compact TxHashSet to height {}: {}", horizon, e.what());
+	}
+
+	m_compactedHeight = horizon;
+	SaveHeight("compacted_height.txt", horizon);
+}
+
+bool BlockChain::IsAssumedValid(const BlockHeader& header) const
+{
+	if (!m_config.GetNodeConfig().GetAssumeValid().has_value())
+	{
+		return false;
+	}
+
+	return m_pChainState->ScopedRead()->IsAssumedValid(header);
+}
+
+//
+// Blocks are re-verified in small batches, like PruneBlocks, and only once the confirmed chain is past the assume-valid header.
+// Blocks that were pruned, or were never downloaded because of fast sync, can't be re-verified and are skipped.
+// A failure is logged and re-verification stops there, since it means the configured assume-valid header can't be trusted.
+//
+bool BlockChain::ReverifyAssumedValid()
+{
+	static const uint64_t MAX_BLOCKS_PER_BATCH = 100;
+
+	const std::optional<Hash>& assumeValid = m_config.GetNodeConfig().GetAssumeValid();
+	if (!assumeValid.has_value() || !m_config.GetNodeConfig().IsAssumeValidReverifyEnabled())
+	{
 		return false;
 	}
+
+	std::vector<std::unique_ptr<FullBlock>> blocks;
+	uint64_t reverifyToHeight = 0;
+	uint64_t trustedHeight = 0;
+	{
+		auto pReader = m_pChainState->ScopedRead();
+		auto pConfirmedChain = pReader->GetChainStore()->GetConfirmedChain();
+		BlockHeaderPtr pTrustedHeader = pReader->GetBlockHeaderByHash(assumeValid.value());
+		if (pTrustedHeader == nullptr || !pConfirmedChain->IsOnChain(pTrustedHeader))
+		{
+			return false;
+		}
+
+		trustedHeight = pTrustedHeader->GetHeight();
+		if (m_reverifiedHeight >= trustedHeight)
+		{
+			return false;
+		}
+
+		reverifyToHeight = (std::min)(trustedHeight, m_reverifiedHeight + MAX_BLOCKS_PER_BATCH);
+		for (uint64_t height = m_reverifiedHeight + 1; height <= reverifyToHeight; height++)
+		{
+			auto pIndex = pConfirmedChain->GetByHeight(height);
+			if (pIndex != nullptr)
+			{
+				std::unique_ptr<FullBlock> pBlock = pReader->GetBlockByHash(pIndex->GetHash());
+				if (pBlock != nullptr)
+				{
+					blocks.push_back(std::move(pBlock));
+				}
+			}
+		}
+	}
+
+	// Freshly loaded blocks aren't marked as validated, so these are verified in full, without holding the lock.
+	for (const auto& pBlock : blocks)
+	{
+		try
+		{
+			BlockValidator::VerifySelfConsistent(*pBlock);
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_F("Assumed valid block {} failed re-verification: {}", *pBlock, e.what());
+			return false;
+		}
+	}
+
+	LOG_DEBUG_F("Re-verified assumed valid blocks up to height {}", reverifyToHeight);
+
+	m_reverifiedHeight = reverifyToHeight;
+	SaveHeight("reverified_height.txt", reverifyToHeight);
+
+	return reverifyToHeight < trustedHeight;
+}
+
+//
+// Kernels are indexed in batches, like PruneBlocks. Blocks applied meanwhile are indexed as they're applied,
+// so once this catches up to the confirmed tip, each call only indexes the blocks added since the last one.
+//
+bool BlockChain::IndexKernels()
+{
+	static const uint64_t MAX_BLOCKS_PER_BATCH = 1000;
+
+	if (!m_config.GetNodeConfig().IsKernelIndexEnabled())
+	{
+		return false;
+	}
+
+	const uint64_t confirmedHeight = m_pSnapshotPublisher->Get()->GetHeight(EChainType::CONFIRMED);
+	if (m_kernelIndexHeight > confirmedHeight)
+	{
+		return false;
+	}
+
+	const uint64_t indexToHeight = (std::min)(confirmedHeight, m_kernelIndexHeight + MAX_BLOCKS_PER_BATCH - 1);
+	{
+		auto pBatch = m_pChainState->BatchWrite();
+		auto pTxHashSet = pBatch->GetTxHashSetManager()->GetTxHashSet();
+		if (pTxHashSet == nullptr)
+		{
+			return false;
+		}
+
+		pTxHashSet->SaveKernelPositions(
+			pBatch->GetChainStore()->GetConfirmedChain(),
+			pBatch->GetBlockDB(),
+			m_kernelIndexHeight,
+			indexToHeight
+		);
+		pBatch->Commit();
+	}
+
+	LOG_DEBUG_F("Indexed kernels up to height {}", indexToHeight);
+
+	m_kernelIndexHeight = indexToHeight + 1;
+	SaveHeight("kernel_index_height.txt", indexToHeight + 1);
+
+	return indexToHeight < confirmedHeight;
+}
+
+std::unique_ptr<LocatedTxKernel> BlockChain::GetKernel(
+	const Commitment& excessCommitment,
+	const std::optional<uint64_t>& minHeight,
+	const std::optional<uint64_t>& maxHeight) const
+{
+	auto pReader = m_pChainState->ScopedRead();
+	auto pTxHashSet = pReader->GetTxHashSetManager()->GetTxHashSet();
+	if (pTxHashSet == nullptr)
+	{
+		return nullptr;
+	}
+
+	auto pConfirmedChain = pReader->GetChainStore()->GetConfirmedChain();
+	auto pBlockDB = pReader->GetBlockDB();
+	const uint64_t lowestHeight = minHeight.value_or(0);
+	const uint64_t highestHeight = (std::min)(maxHeight.value_or(UINT64_MAX), pReader->GetHeight(EChainType::CONFIRMED));
+	if (lowestHeight > highestHeight)
+	{
+		return nullptr;
+	}
+
+	// The index only gives the kernel's height, so the kernel itself is found by scanning just that block.
+	std::unique_ptr<OutputLocation> pPosition = pBlockDB->GetKernelPosition(excessCommitment);
+	if (pPosition != nullptr && pPosition->GetBlockHeight() >= lowestHeight && pPosition->GetBlockHeight() <= highestHeight)
+	{
+		auto pKernel = pTxHashSet->FindKernel(
+			pConfirmedChain,
+			pBlockDB.GetShared(),
+			excessCommitment,
+			pPosition->GetBlockHeight(),
+			pPosition->GetBlockHeight()
+		);
+		if (pKernel != nullptr)
+		{
+			return pKernel;
+		}
+	}
+
+	// Only the blocks the index doesn't cover yet need to be scanned.
+	const uint64_t scanFromHeight = m_config.GetNodeConfig().IsKernelIndexEnabled()
+		? (std::max)(lowestHeight, m_kernelIndexHeight.load())
+		: lowestHeight;
+
+	return pTxHashSet->FindKernel(pConfirmedChain, pBlockDB.GetShared(), excessCommitment, scanFromHeight, highestHeight);
+}
+
+std::unique_ptr<OutputMerkleProof> BlockChain::GetMerkleProof(const Commitment& outputCommitment) const
+{
+	auto pReader = m_pChainState->ScopedRead();
+	auto pTxHashSet = pReader->GetTxHashSetManager()->GetTxHashSet();
+	if (pTxHashSet == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<OutputLocation> pLocation = pReader->GetBlockDB()->GetOutputPosition(outputCommitment);
+	const uint64_t mmrSize = pReader->GetTipBlockHeader(EChainType::CONFIRMED)->GetOutputMMRSize();
+	if (pLocation == nullptr || pLocation->GetMMRIndex() >= mmrSize)
+	{
+		return nullptr;
+	}
+
+	std::unique_ptr<MerkleProof> pProof = pTxHashSet->GetOutputMerkleProof(outputCommitment, pLocation->GetMMRIndex(), mmrSize);
+	if (pProof == nullptr)
+	{
+		return nullptr;
+	}
+
+	return std::make_unique<OutputMerkleProof>(
+		outputCommitment,
+		pLocation->GetBlockHeight(),
+		pLocation->GetMMRIndex(),
+		std::move(*pProof)
+	);
+}
+
+uint64_t BlockChain::LoadHeight(const std::string& fileName) const
+{
+	std::vector<uint8_t> data;
+	if (!FileUtil::ReadFile(m_config.GetNodeConfig().GetChainPath() / fileName, data) || data.empty())
+	{
+		return 0;
+	}
+
+	try
+	{
+		return std::stoull(std::string(data.cbegin(), data.cend()));
+	}
+	catch (std::exception&)
+	{
+		LOG_WARNING_F("Failed to parse {}", fileName);
+		return 0;
+	}
+}
+
+void BlockChain::SaveHeight(const std::string& fileName, const uint64_t height) const
+{
+	FileUtil::WriteTextToFile(m_config.GetNodeConfig().GetChainPath() / fileName, std::to_string(height));
+}
+
+std::vector<LockSiteStats> BlockChain::GetChainLockProfile() const
+{
+	const LockProfiler::Ptr& pProfiler = m_pChainState->GetProfiler();
+	if (pProfiler == nullptr)
+	{
+		return std::vector<LockSiteStats>();
+	}
+
+	return pProfiler->GetSiteStats();
 }
 
 namespace BlockChainAPI
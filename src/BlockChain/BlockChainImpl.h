@@ -2,6 +2,9 @@
 
 #include "ChainState.h"
 #include "ChainStore.h"
+#include "TxHashSetArchiver.h"
+#include "SerializedBlockCache.h"
+#include "Processors/BlockProcessingTimers.h"
 
 #include <TxPool/TransactionPool.h>
 #include <BlockChain/BlockChain.h>
@@ -9,6 +12,7 @@
 #include <Database/Database.h>
 #include <PMMR/TxHashSetManager.h>
 #include <P2P/SyncStatus.h>
+#include <atomic>
 #include <cstdint>
 #include <mutex>
 
@@ -28,19 +32,31 @@ public:
 	);
 
 	void ResyncChain() final;
+	void CatchUpWithPrimary() final;
 
 	void UpdateSyncStatus(SyncStatus& syncStatus) const final;
 	uint64_t GetHeight(const EChainType chainType) const final;
 	uint64_t GetTotalDifficulty(const EChainType chainType) const final;
 
+	bool VerifySelfConsistent(const FullBlock& block) const final;
 	EBlockChainStatus AddBlock(const FullBlock& block) final;
+	std::vector<EBlockChainStatus> AddBlocks(const std::vector<FullBlock::CPtr>& blocks) final;
 	EBlockChainStatus AddCompactBlock(const CompactBlock& block) final;
 
 	EBlockChainStatus AddBlockHeader(BlockHeaderPtr pBlockHeader) final;
 	EBlockChainStatus AddBlockHeaders(const std::vector<BlockHeaderPtr>& blockHeaders) final;
 
-	fs::path SnapshotTxHashSet(BlockHeaderPtr pBlockHeader) final;
-	EBlockChainStatus ProcessTransactionHashSet(const Hash& blockHash, const fs::path& path, SyncStatus& syncStatus) final;
+	TxHashSetArchive::CPtr SnapshotTxHashSet(BlockHeaderPtr pBlockHeader) final { return m_pArchiver->GetArchive(pBlockHeader); }
+	EBlockChainStatus ProcessTransactionHashSet(
+		const Hash& blockHash,
+		const fs::path& path,
+		const TxHashSetDownload::Ptr& pDownload,
+		SyncStatus& syncStatus
+	) final;
+	fs::path ExportTxHashSetSnapshot(BlockHeaderPtr pBlockHeader) final;
+	EBlockChainStatus ImportTxHashSetSnapshot(const fs::path& directory, SyncStatus& syncStatus) final;
+	bool VerifySelfConsistent(const Transaction& transaction) const final;
+	std::vector<bool> VerifySelfConsistent(const std::vector<TransactionPtr>& transactions) const final;
 	EBlockChainStatus AddTransaction(TransactionPtr pTransaction, const EPoolType poolType) final;
 	TransactionPtr GetTransactionByKernelHash(const Hash& kernelHash) const final;
 
@@ -51,6 +67,9 @@ public:
 	std::vector<BlockHeaderPtr> GetBlockHeadersByHash(const std::vector<CBigInteger<32>>& hashes) const final;
 
 	std::unique_ptr<CompactBlock> GetCompactBlockByHash(const Hash& hash) const final;
+	std::shared_ptr<const std::vector<uint8_t>> GetSerializedBlock(const Hash& hash, const EProtocolVersion protocolVersion) const final;
+	std::shared_ptr<const std::vector<uint8_t>> GetSerializedCompactBlock(const Hash& hash, const EProtocolVersion protocolVersion) const final;
+	CacheStats GetSerializedBlockCacheStats() const final { return m_pBlockCache->GetStats(); }
 	std::unique_ptr<FullBlock> GetBlockByCommitment(const Commitment& blockHash) const final;
 	std::unique_ptr<FullBlock> GetBlockByHash(const Hash& blockHash) const final;
 	std::unique_ptr<FullBlock> GetBlockByHeight(const uint64_t height) const final;
@@ -58,8 +77,31 @@ public:
 
 	std::vector<BlockWithOutputs> GetOutputsByHeight(const uint64_t startHeight, const uint64_t maxHeight) const final;
 	std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t maxNumBlocks) const final;
+	std::vector<std::pair<uint64_t, Hash>> GetBlocksToPrefetch(const uint64_t firstHeight, const uint64_t maxNumBlocks) const final;
 
 	bool ProcessNextOrphanBlock() final;
+	bool PruneBlocks() final;
+	bool IsAssumedValid(const BlockHeader& header) const final;
+	bool ReverifyAssumedValid() final;
+	bool IndexKernels() final;
+	void CompactTxHashSet() final;
+	std::unique_ptr<LocatedTxKernel> GetKernel(
+		const Commitment& excessCommitment,
+		const std::optional<uint64_t>& minHeight,
+		const std::optional<uint64_t>& maxHeight
+	) const final;
+	std::unique_ptr<OutputMerkleProof> GetMerkleProof(const Commitment& outputCommitment) const final;
+
+	std::vector<LockSiteStats> GetChainLockProfile() const final;
+	BlockProcessingStats GetProcessingStats() const final { return m_pProcessingTimers->GetStats(); }
+
+	ChainSnapshot::CPtr GetSnapshot() const final { return m_pSnapshotPublisher->Get(); }
+	ChainSnapshot::CPtr WaitForSnapshot(const Hash& confirmedTipHash, const std::chrono::milliseconds& timeout) const final
+	{
+		return m_pSnapshotPublisher->WaitForChange(confirmedTipHash, timeout);
+	}
+	BlockTemplate::CPtr GetBlockTemplate() const final;
+	TxHashSetRoots GetBlockRoots(const TransactionBody& body) const final;
 
 private:
 	BlockChain(
@@ -71,10 +113,40 @@ private:
 		std::shared_ptr<Locked<IHeaderMMR>> pHeaderMMR
 	);
 
+	SerializedBlockCache::Bytes GetSerializedBlock(const Hash& hash, const bool compact, const EProtocolVersion protocolVersion) const;
+
+	//
+	// Connects the orphans descending from a block that was just added, rather than waiting for ProcessNextOrphanBlock to find them.
+	//
+	void ConnectOrphans(const Hash& parentHash);
+
+	// Progress heights are kept in small text files in the chain directory, so they survive restarts.
+	uint64_t LoadHeight(const std::string& fileName) const;
+	void SaveHeight(const std::string& fileName, const uint64_t height) const;
+
+	// Resets the progress of the background work that starts over on a new TxHashSet.
+	void OnTxHashSetReplaced();
+
 	const Config& m_config;
 	std::shared_ptr<Locked<IBlockDB>> m_pDatabase;
 	std::shared_ptr<Locked<TxHashSetManager>> m_pTxHashSetManager;
 	std::shared_ptr<ITransactionPool> m_pTransactionPool;
 	std::shared_ptr<Locked<ChainState>> m_pChainState;
 	std::shared_ptr<Locked<IHeaderMMR>> m_pHeaderMMR;
+	TxHashSetArchiver::Ptr m_pArchiver;
+	ChainSnapshotPublisher::Ptr m_pSnapshotPublisher;
+	SerializedBlockCache::Ptr m_pBlockCache;
+	BlockProcessingTimers::Ptr m_pProcessingTimers;
+
+	// Every full block at or below this height has been pruned.
+	std::atomic<uint64_t> m_prunedHeight;
+
+	// Every stored block at or below this height has been fully verified by ReverifyAssumedValid.
+	std::atomic<uint64_t> m_reverifiedHeight;
+
+	// Every confirmed block below this height has had its kernels indexed, whether by IndexKernels or when it was applied.
+	std::atomic<uint64_t> m_kernelIndexHeight;
+
+	// The horizon height the TxHashSet was last compacted to.
+	std::atomic<uint64_t> m_compactedHeight;
 };
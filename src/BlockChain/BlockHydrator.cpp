@@ -2,7 +2,7 @@
 
 #include <Core/Util/TransactionUtil.h>
 #include <Core/Validation/CutThroughVerifier.h>
-#include <unordered_set>
+#include <Common/FlatHashMap.h>
 
 BlockHydrator::BlockHydrator(std::shared_ptr<const ITransactionPool> pTransactionPool)
 	: m_pTransactionPool(pTransactionPool)
@@ -35,9 +35,9 @@ std::unique_ptr<FullBlock> BlockHydrator::Hydrate(const CompactBlock& compactBlo
 
 std::unique_ptr<FullBlock> BlockHydrator::Hydrate(const CompactBlock& compactBlock, const std::vector<TransactionPtr>& transactions) const
 {
-	std::unordered_set<Hash> inputsSet;
-	std::unordered_set<Hash> outputsSet;
-	std::unordered_set<Hash> kernelsSet;
+	FlatHashSet<Hash> inputsSet;
+	FlatHashSet<Hash> outputsSet;
+	FlatHashSet<Hash> kernelsSet;
 
 	std::vector<TransactionInput> allInputs;
 	std::vector<TransactionOutput> allOutputs;
@@ -48,27 +48,24 @@ std::unique_ptr<FullBlock> BlockHydrator::Hydrate(const CompactBlock& compactBlo
 	{
 		for (const TransactionInput& input : pTransaction->GetInputs())
 		{
-			if (inputsSet.count(input.GetHash()) == 0)
+			if (inputsSet.insert(input.GetHash()).second)
 			{
-				inputsSet.insert(input.GetHash());
 				allInputs.push_back(input);
 			}
 		}
 
 		for (const TransactionOutput& output : pTransaction->GetOutputs())
 		{
-			if (outputsSet.count(output.GetHash()) == 0)
+			if (outputsSet.insert(output.GetHash()).second)
 			{
-				outputsSet.insert(output.GetHash());
 				allOutputs.push_back(output);
 			}
 		}
 
 		for (const TransactionKernel& kernel : pTransaction->GetKernels())
 		{
-			if (kernelsSet.count(kernel.GetHash()) == 0)
+			if (kernelsSet.insert(kernel.GetHash()).second)
 			{
-				kernelsSet.insert(kernel.GetHash());
 				allKernels.push_back(kernel);
 			}
 		}
@@ -77,18 +74,16 @@ std::unique_ptr<FullBlock> BlockHydrator::Hydrate(const CompactBlock& compactBlo
 	// include the coinbase output(s) and kernel(s) from the compact_block
 	for (const TransactionOutput& output : compactBlock.GetOutputs())
 	{
-		if (outputsSet.count(output.GetHash()) == 0)
+		if (outputsSet.insert(output.GetHash()).second)
 		{
-			outputsSet.insert(output.GetHash());
 			allOutputs.push_back(output);
 		}
 	}
 
 	for (const TransactionKernel& kernel : compactBlock.GetKernels())
 	{
-		if (kernelsSet.count(kernel.GetHash()) == 0)
+		if (kernelsSet.insert(kernel.GetHash()).second)
 		{
-			kernelsSet.insert(kernel.GetHash());
 			allKernels.push_back(kernel);
 		}
 	}
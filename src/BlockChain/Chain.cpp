@@ -6,13 +6,15 @@ Chain::Chain(
 	const EChainType chainType,
 	std::shared_ptr<BlockIndexAllocator> pBlockIndexAllocator,
 	std::shared_ptr<DataFile<32>> pDataFile,
-	std::vector<std::shared_ptr<const BlockIndex>>&& indices)
+	std::vector<std::shared_ptr<const HashChunk>>&& chunks,
+	const uint64_t numHashes)
 	: m_chainType(chainType),
 	m_pBlockIndexAllocator(pBlockIndexAllocator),
+	m_chunks(std::move(chunks)),
+	m_height(numHashes - 1),
 	m_dataFile(pDataFile),
 	m_dataFileWriter(),
-	m_indices(std::move(indices)),
-	m_height(m_indices.size() - 1)
+	m_committedHeight(numHashes - 1)
 {
 
 }
@@ -32,28 +34,76 @@ std::shared_ptr<Chain> Chain::Load(
 		pDataFile->Commit();
 	}
 
-	std::vector<std::shared_ptr<const BlockIndex>> indices;
-	indices.push_back(pGenesisIndex);
+	std::vector<std::shared_ptr<const HashChunk>> chunks = LoadChunks(*pBlockIndexAllocator, *pDataFile);
+	const uint64_t numHashes = pDataFile->GetSize();
 
-	while (indices.size() < pDataFile->GetSize())
+	return std::shared_ptr<Chain>(new Chain(chainType, pBlockIndexAllocator, pDataFile, std::move(chunks), numHashes));
+}
+
+// Reads a chunk at a time, rather than a hash at a time.
+std::vector<std::shared_ptr<const Chain::HashChunk>> Chain::LoadChunks(const BlockIndexAllocator& blockIndexAllocator, const DataFile<32>& dataFile)
+{
+	const uint64_t numHashes = dataFile.GetSize();
+
+	std::vector<std::shared_ptr<const HashChunk>> chunks;
+	chunks.reserve((numHashes + HASHES_PER_CHUNK - 1) / HASHES_PER_CHUNK);
+	for (uint64_t firstHeight = 0; firstHeight < numHashes; firstHeight += HASHES_PER_CHUNK)
 	{
-		Hash hash = pDataFile->GetDataAt(indices.size());
-		indices.emplace_back(pBlockIndexAllocator->GetOrCreateIndex(std::move(hash), indices.size()));
+		const uint64_t numInChunk = (std::min)((uint64_t)HASHES_PER_CHUNK, numHashes - firstHeight);
+
+		auto pChunk = std::make_shared<HashChunk>();
+		pChunk->reserve(HASHES_PER_CHUNK * HASH_SIZE);
+		pChunk->resize(numInChunk * HASH_SIZE);
+		dataFile.ReadData(firstHeight, numInChunk, pChunk->data());
+
+		if (numInChunk == HASHES_PER_CHUNK)
+		{
+			chunks.push_back(blockIndexAllocator.ShareChunk(chunks.size(), pChunk));
+		}
+		else
+		{
+			chunks.push_back(pChunk);
+		}
 	}
 
-	return std::shared_ptr<Chain>(new Chain(chainType, pBlockIndexAllocator, pDataFile, std::move(indices)));
+	return chunks;
 }
 
 std::shared_ptr<const BlockIndex> Chain::GetByHeight(const uint64_t height) const
 {
-	if (m_height >= height && m_indices.size() > height)
+	if (m_height >= height)
 	{
-		return m_indices[height];
+		return std::make_shared<const BlockIndex>(GetHash(height), height);
 	}
 
 	return nullptr;
 }
 
+std::shared_ptr<const Chain::HashChunk> Chain::GetFullChunk(const size_t chunkIndex) const noexcept
+{
+	if ((chunkIndex + 1) * HASHES_PER_CHUNK <= m_height + 1)
+	{
+		return m_chunks[chunkIndex];
+	}
+
+	return nullptr;
+}
+
+Chain::HashChunk& Chain::GetWritableChunk()
+{
+	std::shared_ptr<const HashChunk>& pChunk = m_chunks.back();
+	if (pChunk.use_count() > 1)
+	{
+		auto pCopy = std::make_shared<HashChunk>();
+		pCopy->reserve(HASHES_PER_CHUNK * HASH_SIZE);
+		pCopy->assign(pChunk->cbegin(), pChunk->cend());
+		pChunk = pCopy;
+	}
+
+	// Only this chain references the chunk now.
+	return const_cast<HashChunk&>(*pChunk);
+}
+
 std::shared_ptr<const BlockIndex> Chain::AddBlock(const Hash& hash, const uint64_t height)
 {
 	if (height != m_height + 1)
@@ -64,14 +114,26 @@ std::shared_ptr<const BlockIndex> Chain::AddBlock(const Hash& hash, const uint64
 
 	SetDirty(true);
 
-	std::shared_ptr<const BlockIndex> pBlockIndex = m_pBlockIndexAllocator->GetOrCreateIndex(hash, height);
-	m_indices.push_back(pBlockIndex);
+	if (height % HASHES_PER_CHUNK == 0)
+	{
+		auto pChunk = std::make_shared<HashChunk>();
+		pChunk->reserve(HASHES_PER_CHUNK * HASH_SIZE);
+		m_chunks.push_back(pChunk);
+	}
 
-	const auto bytes = pBlockIndex->GetHash().GetData();
-	m_dataFileWriter->AddData(bytes);
+	HashChunk& chunk = GetWritableChunk();
+	chunk.insert(chunk.end(), hash.data(), hash.data() + HASH_SIZE);
 
+	m_dataFileWriter->AddData(hash.GetData());
 	++m_height;
-	return pBlockIndex;
+
+	// A chunk that just filled up may match one the other chain already has.
+	if ((m_height + 1) % HASHES_PER_CHUNK == 0)
+	{
+		m_chunks.back() = m_pBlockIndexAllocator->ShareChunk(m_chunks.size() - 1, m_chunks.back());
+	}
+
+	return std::make_shared<const BlockIndex>(hash, height);
 }
 
 void Chain::Rewind(const uint64_t lastHeight)
@@ -84,9 +146,15 @@ void Chain::Rewind(const uint64_t lastHeight)
 	if (m_height > lastHeight)
 	{
 		SetDirty(true);
-		m_indices.erase(m_indices.begin() + lastHeight + 1, m_indices.end());
 
-		m_dataFileWriter->Rewind(lastHeight + 1);
+		const uint64_t numHashes = lastHeight + 1;
+		m_chunks.resize((numHashes + HASHES_PER_CHUNK - 1) / HASHES_PER_CHUNK);
+		if (numHashes % HASHES_PER_CHUNK != 0)
+		{
+			GetWritableChunk().resize((numHashes % HASHES_PER_CHUNK) * HASH_SIZE);
+		}
+
+		m_dataFileWriter->Rewind(numHashes);
 		m_height = lastHeight;
 	}
 }
@@ -98,6 +166,8 @@ void Chain::Commit()
 		m_dataFileWriter->Commit();
 	}
 
+	m_committedChunks = m_chunks;
+	m_committedHeight = m_height;
 	SetDirty(false);
 }
 
@@ -106,15 +176,10 @@ void Chain::Rollback() noexcept
 	if (IsDirty())
 	{
 		m_dataFileWriter->Rollback();
-		m_indices.clear();
 
-		while (m_indices.size() < m_dataFileWriter->GetSize())
-		{
-			Hash hash = m_dataFileWriter->GetDataAt(m_indices.size());
-			m_indices.push_back(m_pBlockIndexAllocator->GetOrCreateIndex(std::move(hash), m_indices.size()));
-		}
-
-		m_height = m_indices.size() - 1;
+		// The saved chunks were never written to, since chunks are copied before being changed.
+		m_chunks = m_committedChunks;
+		m_height = m_committedHeight;
 	}
 
 	SetDirty(false);
@@ -124,9 +189,13 @@ void Chain::OnInitWrite()
 {
 	SetDirty(false);
 	m_dataFileWriter = m_dataFile.BatchWrite();
+
+	m_committedChunks = m_chunks;
+	m_committedHeight = m_height;
 }
 
 void Chain::OnEndWrite()
 {
 	m_dataFileWriter.Clear();
-}
\ No newline at end of file
+	m_committedChunks.clear();
+}
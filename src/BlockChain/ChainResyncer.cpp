@@ -1,7 +1,10 @@
 #include "ChainResyncer.h"
 
 #include <Common/Logger.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
 #include <Database/BlockDb.h>
+#include <future>
 
 ChainResyncer::ChainResyncer(const std::shared_ptr<Locked<ChainState>>& pChainState)
 	: m_pChainState(pChainState) { }
@@ -21,26 +24,80 @@ void ChainResyncer::ResyncChain()
 
 	pConfirmedChain->Rewind(0);
 
+	RebuildHeaderMMR(pBlockDB, pHeaderMMR, pCandidateChain, pLockedState->GetBlockHeaderByHeight(0, EChainType::CANDIDATE));
+
+	pLockedState->Commit();
+
+	LOG_WARNING("Chain resync initiated!");
+}
+
+//
+// Headers are read in batches of HEADER_BATCH_SIZE with a single MultiGet, and the next batch is read while the
+// current one is being added to the MMR. Stops at the first missing or unlinked header, rewinding the candidate chain to it.
+//
+void ChainResyncer::RebuildHeaderMMR(
+	const std::shared_ptr<IBlockDB>& pBlockDB,
+	const std::shared_ptr<IHeaderMMR>& pHeaderMMR,
+	const std::shared_ptr<Chain>& pCandidateChain,
+	BlockHeaderPtr pPrevHeader)
+{
 	pHeaderMMR->Rewind(1);
-	auto pPrevHeader = pLockedState->GetBlockHeaderByHeight(0, EChainType::CANDIDATE);
 
-	for (uint64_t i = 1; i <= pCandidateChain->GetHeight(); i++)
+	const uint64_t candidateHeight = pCandidateChain->GetHeight();
+	auto readBatch = [&pBlockDB, &pCandidateChain, candidateHeight](const uint64_t firstHeight) {
+		std::vector<Hash> hashes;
+		for (uint64_t height = firstHeight; height <= candidateHeight && hashes.size() < HEADER_BATCH_SIZE; height++)
+		{
+			hashes.push_back(pCandidateChain->GetHash(height));
+		}
+
+		return pBlockDB->GetBlockHeaders(hashes);
+	};
+
+	ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+	std::vector<BlockHeaderPtr> headers = readBatch(1);
+	uint64_t height = 1;
+	while (!headers.empty())
 	{
-		auto pIndex = pCandidateChain->GetByHeight(i);
-		auto pHeader = pBlockDB->GetBlockHeader(pIndex->GetHash());
-		if (pHeader == nullptr || pHeader->GetPreviousHash() != pPrevHeader->GetHash())
+		const uint64_t nextHeight = height + headers.size();
+		std::future<std::vector<BlockHeaderPtr>> nextHeaders = threadPool.Submit([&readBatch, nextHeight] { return readBatch(nextHeight); });
+
+		size_t numLinked = 0;
+		while (numLinked < headers.size() && headers[numLinked] != nullptr && headers[numLinked]->GetPreviousHash() == pPrevHeader->GetHash())
 		{
-			pCandidateChain->Rewind(i - 1);
-			break;
+			pPrevHeader = headers[numLinked++];
 		}
 
-		pPrevHeader = pHeader;
-		pHeaderMMR->AddHeader(*pHeader);
-	}
+		const bool complete = numLinked == headers.size();
+		headers.resize(numLinked);
 
-	pLockedState->Commit();
+		// The read in progress refers to readBatch, so it has to finish before any exception is rethrown.
+		std::exception_ptr pException = nullptr;
+		try
+		{
+			pHeaderMMR->AddHeaders(headers);
+		}
+		catch (...)
+		{
+			pException = std::current_exception();
+		}
 
-	LOG_WARNING("Chain resync initiated!");
+		threadPool.Wait(nextHeaders);
+		if (pException != nullptr)
+		{
+			std::rethrow_exception(pException);
+		}
+
+		if (!complete)
+		{
+			LOG_WARNING_F("Header at height {} is missing or not linked. Rewinding candidate chain.", height + numLinked);
+			pCandidateChain->Rewind(height + numLinked - 1);
+			break;
+		}
+
+		headers = nextHeaders.get();
+		height = nextHeight;
+	}
 }
 
 void ChainResyncer::CleanDatabase(const std::shared_ptr<IBlockDB>& pBlockDB)
@@ -49,4 +106,6 @@ void ChainResyncer::CleanDatabase(const std::shared_ptr<IBlockDB>& pBlockDB)
 	pBlockDB->ClearBlockSums();
 	pBlockDB->ClearOutputPositions();
 	pBlockDB->ClearSpentPositions();
+	pBlockDB->ClearKernelPositions();
+	pBlockDB->ClearNRDKernelPositions();
 }
\ No newline at end of file
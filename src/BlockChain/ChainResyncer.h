@@ -11,6 +11,15 @@ public:
 
 private:
 	void CleanDatabase(const std::shared_ptr<IBlockDB>& pBlockDB);
+	void RebuildHeaderMMR(
+		const std::shared_ptr<IBlockDB>& pBlockDB,
+		const std::shared_ptr<IHeaderMMR>& pHeaderMMR,
+		const std::shared_ptr<Chain>& pCandidateChain,
+		BlockHeaderPtr pPrevHeader
+	);
+
+	// Large enough that each MultiGet and parallel hash covers many headers, small enough to keep few in memory.
+	static constexpr size_t HEADER_BATCH_SIZE = 4096;
 
 	std::shared_ptr<Locked<ChainState>> m_pChainState;
 };
\ No newline at end of file
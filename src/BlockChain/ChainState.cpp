@@ -5,6 +5,11 @@
 #include <PMMR/TxHashSetManager.h>
 #include <TxPool/TransactionPool.h>
 #include <PMMR/TxHashSetManager.h>
+#include <Core/Exceptions/BlockChainException.h>
+#include <Core/Serialization/Serializer.h>
+#include <Common/Util/FileUtil.h>
+#include <Common/Logger.h>
+#include <algorithm>
 
 ChainState::ChainState(
 	const Config& config,
@@ -19,7 +24,9 @@ ChainState::ChainState(
 	m_pHeaderMMR(pHeaderMMR),
 	m_pTransactionPool(pTransactionPool),
 	m_pTxHashSetManager(pTxHashSetManager),
-	m_pOrphanPool(std::make_shared<OrphanPool>())
+	m_pOrphanPool(std::make_shared<OrphanPool>(config.GetNodeConfig().GetOrphanPoolMaxBytes())),
+	m_pSnapshotPublisher(std::make_shared<ChainSnapshotPublisher>()),
+	m_commitSequence(0)
 {
 
 }
@@ -54,7 +61,16 @@ std::shared_ptr<Locked<ChainState>> ChainState::Create(
 	pTxHashSetManager->Write()->Open(pConfirmedHeader, genesisBlock);
 
 	std::shared_ptr<ChainState> pChainState(new ChainState(config, pChainStore, pDatabase, pHeaderMMR, pTransactionPool, pTxHashSetManager));
-	return std::make_shared<Locked<ChainState>>(Locked<ChainState>(pChainState));
+	pChainState->PublishSnapshot();
+	auto pLockedChainState = std::make_shared<Locked<ChainState>>(Locked<ChainState>(pChainState));
+
+	const uint32_t profileSecs = config.GetNodeConfig().GetChainLockProfileSecs();
+	if (profileSecs > 0)
+	{
+		pLockedChainState->SetProfiler(std::make_shared<LockProfiler>("ChainState", std::chrono::seconds(profileSecs)));
+	}
+
+	return pLockedChainState;
 }
 
 void ChainState::UpdateSyncStatus(SyncStatus& syncStatus) const
@@ -102,6 +118,11 @@ BlockHeaderPtr ChainState::GetBlockHeaderByHash(const Hash& hash) const
 	return GetBlockDB()->GetBlockHeader(hash);
 }
 
+std::vector<BlockHeaderPtr> ChainState::GetBlockHeadersByHash(const std::vector<Hash>& hashes) const
+{
+	return GetBlockDB()->GetBlockHeaders(hashes);
+}
+
 BlockHeaderPtr ChainState::GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const
 {
 	auto pBlockIndex = GetChainStore()->GetChain(chainType)->GetByHeight(height);
@@ -113,6 +134,24 @@ BlockHeaderPtr ChainState::GetBlockHeaderByHeight(const uint64_t height, const E
 	return BlockHeaderPtr(nullptr);
 }
 
+bool ChainState::IsAssumedValid(const BlockHeader& header) const
+{
+	const std::optional<Hash>& assumeValid = m_config.GetNodeConfig().GetAssumeValid();
+	if (!assumeValid.has_value())
+	{
+		return false;
+	}
+
+	BlockHeaderPtr pTrustedHeader = GetBlockDB()->GetBlockHeader(assumeValid.value());
+	if (pTrustedHeader == nullptr || header.GetHeight() > pTrustedHeader->GetHeight())
+	{
+		return false;
+	}
+
+	auto pCandidateChain = GetChainStore()->GetCandidateChain();
+	return pCandidateChain->IsOnChain(pTrustedHeader) && pCandidateChain->IsOnChain(header.GetHeight(), header.GetHash());
+}
+
 BlockHeaderPtr ChainState::GetBlockHeaderByCommitment(const Commitment& outputCommitment) const
 {
 	BlockHeaderPtr pHeader(nullptr);
@@ -146,40 +185,89 @@ std::unique_ptr<FullBlock> ChainState::GetBlockByHeight(const uint64_t height) c
 	return std::unique_ptr<FullBlock>(nullptr);
 }
 
-std::shared_ptr<const FullBlock> ChainState::GetOrphanBlock(const uint64_t height, const Hash& hash) const
+std::shared_ptr<const FullBlock> ChainState::GetOrphanBlock(const Hash& hash) const
 {
-	return m_pOrphanPool->GetOrphanBlock(height, hash);
+	return m_pOrphanPool->GetOrphanBlock(hash);
 }
 
-std::unique_ptr<BlockWithOutputs> ChainState::GetBlockWithOutputs(const uint64_t height) const
+std::vector<std::shared_ptr<const FullBlock>> ChainState::GetOrphanChildren(const Hash& previousHash) const
 {
-	auto pBlockIndex = GetChainStore()->GetChain(EChainType::CONFIRMED)->GetByHeight(height);
-	if (pBlockIndex != nullptr)
+	return m_pOrphanPool->GetChildren(previousHash);
+}
+
+std::vector<BlockWithOutputs> ChainState::GetOutputsByHeight(const uint64_t startHeight, const uint64_t maxHeight) const
+{
+	std::vector<BlockWithOutputs> blocksWithOutputs;
+
+	std::shared_ptr<const ITxHashSet> pTxHashSet = GetTxHashSetManager()->GetTxHashSet();
+	const uint64_t highestHeight = (std::min)(GetHeight(EChainType::CONFIRMED), maxHeight);
+	if (pTxHashSet == nullptr || startHeight > highestHeight)
 	{
-		std::unique_ptr<FullBlock> pBlock = GetBlockDB()->GetBlock(pBlockIndex->GetHash());
-		if (pBlock != nullptr)
+		return blocksWithOutputs;
+	}
+
+	std::vector<BlockHeaderPtr> headers;
+	headers.reserve(highestHeight - startHeight + 1);
+	for (uint64_t height = startHeight; height <= highestHeight; height++)
+	{
+		BlockHeaderPtr pHeader = GetBlockHeaderByHeight(height, EChainType::CONFIRMED);
+		if (pHeader == nullptr)
 		{
-			std::vector<OutputDTO> outputsFound;
-			outputsFound.reserve(pBlock->GetTransactionBody().GetOutputs().size());
+			break;
+		}
 
-			const std::vector<TransactionOutput>& outputs = pBlock->GetTransactionBody().GetOutputs();
-			for (const TransactionOutput& output : outputs)
-			{
-				std::unique_ptr<OutputLocation> pOutputLocation = GetBlockDB()->GetOutputPosition(output.GetCommitment());
-				if (pOutputLocation != nullptr)
-				{
-					outputsFound.emplace_back(OutputDTO{ false, OutputIdentifier::FromOutput(output), *pOutputLocation, output.GetRangeProof() });
-				}
-			}
+		headers.push_back(pHeader);
+	}
+
+	if (headers.empty())
+	{
+		return blocksWithOutputs;
+	}
+
+	// Each block's outputs were appended to the output MMR right after the previous block's,
+	// so the whole range is read in one batch, then split between the blocks by their output MMR sizes.
+	BlockHeaderPtr pPreviousHeader = startHeight == 0 ? nullptr : GetBlockHeaderByHeight(startHeight - 1, EChainType::CONFIRMED);
+	const uint64_t firstIndex = pPreviousHeader == nullptr ? 0 : pPreviousHeader->GetOutputMMRSize();
+	const uint64_t endIndex = headers.back()->GetOutputMMRSize();
+
+	std::vector<OutputDTO> outputs;
+	if (endIndex > firstIndex)
+	{
+		outputs = pTxHashSet->GetOutputsByMMRIndex(GetBlockDB().GetShared(), firstIndex, endIndex - 1);
+	}
 
-			return std::make_unique<BlockWithOutputs>(BlockWithOutputs{ BlockIdentifier::FromHeader(*pBlock->GetHeader()), std::move(outputsFound) });
+	blocksWithOutputs.reserve(headers.size());
+	auto iter = outputs.begin();
+	for (const BlockHeaderPtr& pHeader : headers)
+	{
+		std::vector<OutputDTO> blockOutputs;
+		while (iter != outputs.end() && iter->GetLocation().GetMMRIndex() < pHeader->GetOutputMMRSize())
+		{
+			blockOutputs.push_back(std::move(*iter++));
 		}
+
+		blocksWithOutputs.emplace_back(BlockWithOutputs(BlockIdentifier::FromHeader(*pHeader), std::move(blockOutputs)));
 	}
 
-	return std::unique_ptr<BlockWithOutputs>(nullptr);
+	return blocksWithOutputs;
 }
 
 std::vector<std::pair<uint64_t, Hash>> ChainState::GetBlocksNeeded(const uint64_t maxNumBlocks) const
+{
+	return GetBlocksNeeded(maxNumBlocks, 0);
+}
+
+std::vector<std::pair<uint64_t, Hash>> ChainState::GetBlocksToPrefetch(const uint64_t firstHeight, const uint64_t maxNumBlocks) const
+{
+	if (m_pOrphanPool->GetMemoryUsage() >= (m_pOrphanPool->GetMaxBytes() / 2))
+	{
+		return {};
+	}
+
+	return GetBlocksNeeded(maxNumBlocks, firstHeight);
+}
+
+std::vector<std::pair<uint64_t, Hash>> ChainState::GetBlocksNeeded(const uint64_t maxNumBlocks, const uint64_t firstHeight) const
 {
 	std::vector<std::pair<uint64_t, Hash>> blocksNeeded;
 	blocksNeeded.reserve(maxNumBlocks);
@@ -187,13 +275,15 @@ std::vector<std::pair<uint64_t, Hash>> ChainState::GetBlocksNeeded(const uint64_
 	std::shared_ptr<const Chain> pCandidateChain = GetChainStore()->GetCandidateChain();
 	const uint64_t candidateHeight = pCandidateChain->GetTip()->GetHeight();
 
-	uint64_t nextHeight = GetChainStore()->FindCommonIndex(EChainType::CANDIDATE, EChainType::CONFIRMED)->GetHeight() + 1;
+	// Orphans are skipped with a lookup each, so this only walks the window plus any orphans already received.
+	const uint64_t forkHeight = GetChainStore()->FindCommonIndex(EChainType::CANDIDATE, EChainType::CONFIRMED)->GetHeight();
+	uint64_t nextHeight = (std::max)(forkHeight + 1, firstHeight);
 	while (nextHeight <= candidateHeight)
 	{
-		auto pIndex = pCandidateChain->GetByHeight(nextHeight);
-		if (!m_pOrphanPool->IsOrphan(nextHeight, pIndex->GetHash()))
+		Hash hash = pCandidateChain->GetHash(nextHeight);
+		if (!m_pOrphanPool->IsOrphan(hash))
 		{
-			blocksNeeded.emplace_back(std::pair<uint64_t, Hash>(nextHeight, pIndex->GetHash()));
+			blocksNeeded.emplace_back(std::pair<uint64_t, Hash>(nextHeight, std::move(hash)));
 
 			if (blocksNeeded.size() == maxNumBlocks)
 			{
@@ -207,6 +297,52 @@ std::vector<std::pair<uint64_t, Hash>> ChainState::GetBlocksNeeded(const uint64_
 	return blocksNeeded;
 }
 
+void ChainState::PublishSnapshot() const
+{
+	m_pSnapshotPublisher->Publish(GetTipBlockHeader(EChainType::CONFIRMED), GetTipBlockHeader(EChainType::CANDIDATE));
+}
+
+void ChainState::CatchUpWithPrimary(const FullBlock& genesisBlock)
+{
+	// The database is caught up first, so the headers of the reloaded chains can be read.
+	GetBlockDB()->CatchUpWithPrimary();
+	GetChainStore()->Reload(m_config);
+
+	auto pConfirmedHeader = GetBlockDB()->GetBlockHeader(GetChainStore()->GetConfirmedChain()->GetTipHash());
+	if (pConfirmedHeader == nullptr)
+	{
+		// The primary committed again while this was reloading. Its next notification is caught up with instead.
+		throw BLOCK_CHAIN_EXCEPTION("Confirmed tip not found");
+	}
+
+	GetTxHashSetManager()->Open(pConfirmedHeader, genesisBlock);
+	PublishSnapshot();
+}
+
+void ChainState::NotifyReplicas()
+{
+	if (!m_config.GetNodeConfig().IsReplicaNotificationEnabled())
+	{
+		return;
+	}
+
+	BlockHeaderPtr pConfirmedTip = GetTipBlockHeader(EChainType::CONFIRMED);
+
+	Serializer serializer;
+	serializer.Append<uint64_t>(++m_commitSequence);
+	serializer.Append<uint64_t>(pConfirmedTip != nullptr ? pConfirmedTip->GetHeight() : 0);
+	serializer.AppendBigInteger(pConfirmedTip != nullptr ? pConfirmedTip->GetHash() : ZERO_HASH);
+
+	try
+	{
+		FileUtil::SafeWriteToFile(m_config.GetNodeConfig().GetCommitNotificationPath(), serializer.GetBytes());
+	}
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Failed to notify replicas: {}", e.what());
+	}
+}
+
 void ChainState::Commit()
 {
 	if (!m_chainStoreWriter.IsNull())
@@ -228,6 +364,9 @@ void ChainState::Commit()
 	{
 		m_txHashSetWriter->Commit();
 	}
+
+	PublishSnapshot();
+	NotifyReplicas();
 }
 
 void ChainState::Rollback() noexcept
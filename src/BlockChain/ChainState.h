@@ -7,6 +7,7 @@
 #include <Core/Models/BlockHeader.h>
 #include <BlockChain/ChainType.h>
 #include <BlockChain/Chain.h>
+#include <BlockChain/ChainSnapshot.h>
 #include <Core/Models/DTOs/BlockWithOutputs.h>
 #include <PMMR/HeaderMMR.h>
 #include <PMMR/TxHashSetManager.h>
@@ -35,17 +36,47 @@ public:
 
 	BlockHeaderPtr GetTipBlockHeader(const EChainType chainType) const;
 	BlockHeaderPtr GetBlockHeaderByHash(const Hash& hash) const;
+	std::vector<BlockHeaderPtr> GetBlockHeadersByHash(const std::vector<Hash>& hashes) const;
 	BlockHeaderPtr GetBlockHeaderByHeight(const uint64_t height, const EChainType chainType) const;
 	BlockHeaderPtr GetBlockHeaderByCommitment(const Commitment& outputCommitment) const;
 
+	//
+	// True if the header is (or is an ancestor of) the NODE.ASSUME_VALID header, and both are on the candidate chain.
+	//
+	bool IsAssumedValid(const BlockHeader& header) const;
+
 	std::unique_ptr<FullBlock> GetBlockByHash(const Hash& hash) const;
 	std::unique_ptr<FullBlock> GetBlockByHeight(const uint64_t height) const;
-	std::shared_ptr<const FullBlock> GetOrphanBlock(const uint64_t height, const Hash& hash) const;
+	std::shared_ptr<const FullBlock> GetOrphanBlock(const Hash& hash) const;
+	std::vector<std::shared_ptr<const FullBlock>> GetOrphanChildren(const Hash& previousHash) const;
 
-	std::unique_ptr<BlockWithOutputs> GetBlockWithOutputs(const uint64_t height) const;
+	//
+	// Returns the unspent outputs of each confirmed block from startHeight through maxHeight (or the tip, if lower).
+	// The outputs are read straight from the TxHashSet, located by the output MMR sizes in the headers, without loading the blocks.
+	//
+	std::vector<BlockWithOutputs> GetOutputsByHeight(const uint64_t startHeight, const uint64_t maxHeight) const;
 
 	std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t maxNumBlocks) const;
 
+	//
+	// Like GetBlocksNeeded, but starting no lower than firstHeight. Returns nothing once the orphan pool is half full,
+	// so prefetched blocks never push each other (or other orphans) out of it.
+	//
+	std::vector<std::pair<uint64_t, Hash>> GetBlocksToPrefetch(const uint64_t firstHeight, const uint64_t maxNumBlocks) const;
+
+	//
+	// The publisher is shared with readers that query the tips without taking this lock.
+	// A new snapshot is published on every Commit that changes a tip.
+	//
+	const ChainSnapshotPublisher::Ptr& GetSnapshotPublisher() const noexcept { return m_pSnapshotPublisher; }
+	void PublishSnapshot() const;
+
+	//
+	// Replicas reload everything a commit of the primary could have changed, except the header MMR,
+	// which is only used to validate new headers. Must be called in a batch, which is then rolled back, since nothing is written.
+	//
+	void CatchUpWithPrimary(const FullBlock& genesisBlock);
+
 	void Commit() final;
 	void Rollback() noexcept final;
 	void OnInitWrite() final;
@@ -162,6 +193,14 @@ private:
 		std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager
 	);
 
+	std::vector<std::pair<uint64_t, Hash>> GetBlocksNeeded(const uint64_t maxNumBlocks, const uint64_t firstHeight) const;
+
+	//
+	// If enabled, rewrites the commit notification file with the next sequence number and the confirmed tip,
+	// so replicas know to catch up. Replicas catch up whenever the file changes, so it doesn't matter that the sequence restarts from 0.
+	//
+	void NotifyReplicas();
+
 	const Config& m_config;
 	std::shared_ptr<Locked<ChainStore>> m_pChainStore;
 	std::shared_ptr<Locked<IBlockDB>> m_pBlockDB;
@@ -169,6 +208,8 @@ private:
 	std::shared_ptr<ITransactionPool> m_pTransactionPool;
 	std::shared_ptr<Locked<TxHashSetManager>> m_pTxHashSetManager;
 	std::shared_ptr<OrphanPool> m_pOrphanPool;
+	ChainSnapshotPublisher::Ptr m_pSnapshotPublisher;
+	uint64_t m_commitSequence;
 
 	// Writers
 	Writer<ChainStore> m_chainStoreWriter;
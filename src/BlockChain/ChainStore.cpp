@@ -6,12 +6,29 @@
 #include <map>
 
 ChainStore::ChainStore(const Chain::Ptr& pConfirmedChain, const Chain::Ptr& pCandidateChain)
-	: m_pConfirmedChain(pConfirmedChain), m_pCandidateChain(pCandidateChain)
+	: m_pConfirmedChain(pConfirmedChain), m_pCandidateChain(pCandidateChain), m_commonHeightHint(0)
 {
 
 }
 
 std::shared_ptr<Locked<ChainStore>> ChainStore::Load(const Config& config, std::shared_ptr<BlockIndex> pGenesisIndex)
+{
+	std::pair<Chain::Ptr, Chain::Ptr> chains = LoadChains(config, pGenesisIndex);
+
+	auto pChainStore = std::shared_ptr<ChainStore>(new ChainStore(chains.first, chains.second));
+	return std::make_shared<Locked<ChainStore>>(Locked<ChainStore>(pChainStore));
+}
+
+void ChainStore::Reload(const Config& config)
+{
+	auto pGenesisIndex = std::make_shared<BlockIndex>(config.GetEnvironment().GetGenesisBlock().GetHash(), 0);
+	std::pair<Chain::Ptr, Chain::Ptr> chains = LoadChains(config, pGenesisIndex);
+
+	m_pConfirmedChain = chains.first;
+	m_pCandidateChain = chains.second;
+}
+
+std::pair<Chain::Ptr, Chain::Ptr> ChainStore::LoadChains(const Config& config, std::shared_ptr<BlockIndex> pGenesisIndex)
 {
 	LOG_TRACE("Loading Chain");
 	std::shared_ptr<BlockIndexAllocator> pAllocator = std::make_shared<BlockIndexAllocator>();
@@ -42,8 +59,7 @@ std::shared_ptr<Locked<ChainStore>> ChainStore::Load(const Config& config, std::
 
 	//pAllocator->AddChain(pSyncChain);
 
-	auto pChainStore = std::shared_ptr<ChainStore>(new ChainStore(pConfirmedChain, pCandidateChain));
-	return std::make_shared<Locked<ChainStore>>(Locked<ChainStore>(pChainStore));
+	return std::make_pair(pConfirmedChain, pCandidateChain);
 }
 
 void ChainStore::Commit()
@@ -79,18 +95,70 @@ std::shared_ptr<const BlockIndex> ChainStore::FindCommonIndex(const EChainType c
 	std::shared_ptr<const Chain> pChain1 = GetChain(chainType1);
 	std::shared_ptr<const Chain> pChain2 = GetChain(chainType2);
 
-	uint64_t height = (std::min)(pChain1->GetHeight(), pChain2->GetHeight());
-	std::shared_ptr<const BlockIndex> pChain1Index = pChain1->GetByHeight(height);
-	std::shared_ptr<const BlockIndex> pChain2Index = pChain2->GetByHeight(height);
+	const uint64_t commonHeight = FindCommonHeight(*pChain1, *pChain2, m_commonHeightHint);
+	m_commonHeightHint = commonHeight;
+
+	return pChain1->GetByHeight(commonHeight);
+}
+
+//
+// Each hash commits to every block before it, so the heights where both chains have the same block are a prefix of them.
+// The end of that prefix is bracketed by galloping away from the hint, then found by binary search,
+// so it takes O(log distance) comparisons rather than one per block since the fork.
+//
+uint64_t ChainStore::FindCommonHeight(const Chain& chain1, const Chain& chain2, const uint64_t hint)
+{
+	const uint64_t maxHeight = (std::min)(chain1.GetHeight(), chain2.GetHeight());
+	const uint64_t start = (std::min)(hint, maxHeight);
 
-	while (pChain1Index->GetHash() != pChain2Index->GetHash())
+	// Both chains start at genesis, so height 0 is always common. common is always a shared height, and diverged never is.
+	uint64_t common = 0;
+	uint64_t diverged = maxHeight + 1;
+	if (chain1.HasSameBlock(chain2, start))
 	{
-		--height;
-		pChain1Index = pChain1->GetByHeight(height);
-		pChain2Index = pChain2->GetByHeight(height);
+		common = start;
+		for (uint64_t step = 1; common < maxHeight; step *= 2)
+		{
+			const uint64_t height = (std::min)(common + step, maxHeight);
+			if (!chain1.HasSameBlock(chain2, height))
+			{
+				diverged = height;
+				break;
+			}
+
+			common = height;
+		}
+	}
+	else
+	{
+		diverged = start;
+		for (uint64_t step = 1; diverged > 0; step *= 2)
+		{
+			const uint64_t height = diverged - (std::min)(step, diverged);
+			if (chain1.HasSameBlock(chain2, height))
+			{
+				common = height;
+				break;
+			}
+
+			diverged = height;
+		}
+	}
+
+	while (diverged - common > 1)
+	{
+		const uint64_t height = common + (diverged - common) / 2;
+		if (chain1.HasSameBlock(chain2, height))
+		{
+			common = height;
+		}
+		else
+		{
+			diverged = height;
+		}
 	}
 
-	return pChain1Index;
+	return common;
 }
 
 void ChainStore::ReorgChain(const EChainType source, const EChainType destination)
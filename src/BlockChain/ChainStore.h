@@ -3,12 +3,18 @@
 #include <Config/Config.h>
 #include <Core/Traits/Lockable.h>
 #include <BlockChain/Chain.h>
+#include <atomic>
 
 class ChainStore : public Traits::IBatchable
 {
 public:
 	static std::shared_ptr<Locked<ChainStore>> Load(const Config& config, std::shared_ptr<BlockIndex>);
 
+	//
+	// Replaces both chains with the ones on disk, for replicas following the primary's commits.
+	//
+	void Reload(const Config& config);
+
 	void Commit() final;
 	void Rollback() noexcept final;
 	void OnInitWrite() final;
@@ -17,6 +23,11 @@ public:
 	std::shared_ptr<Chain> GetChain(const EChainType chainType);
 	std::shared_ptr<const Chain> GetChain(const EChainType chainType) const;
 	//std::shared_ptr<BlockIndex> GetOrCreateIndex(const Hash& hash, const uint64_t height);
+
+	//
+	// Returns the highest block both chains have. This starts from the last one found, which is usually still it or close to it,
+	// so asking again after blocks are added, rewound, or reorged only checks the heights around it.
+	//
 	std::shared_ptr<const BlockIndex> FindCommonIndex(const EChainType chainType1, const EChainType chainType2) const;
 
 	//
@@ -38,7 +49,13 @@ public:
 private:
 	ChainStore(const Chain::Ptr& pConfirmedChain, const Chain::Ptr& pCandidateChain);
 
+	static std::pair<Chain::Ptr, Chain::Ptr> LoadChains(const Config& config, std::shared_ptr<BlockIndex> pGenesisIndex);
+	static uint64_t FindCommonHeight(const Chain& chain1, const Chain& chain2, const uint64_t hint);
+
 	std::shared_ptr<Chain> m_pConfirmedChain;
 	std::shared_ptr<Chain> m_pCandidateChain;
 	//std::shared_ptr<Chain> m_pSyncChain;
+
+	// Where the candidate and confirmed chains last forked. It's only a hint, since the chains are also changed directly.
+	mutable std::atomic<uint64_t> m_commonHeightHint;
 };
\ No newline at end of file
@@ -1,119 +1,129 @@
 #include "OrphanPool.h"
 
-OrphanPool::OrphanPool() : m_orphanHeadersByHash(64)
+#include <Common/Logger.h>
+#include <Common/Metrics.h>
+
+static MetricGauge& NUM_ORPHANS = MetricsAPI::RegisterGauge("grin_orphan_blocks", "Number of blocks in the orphan pool.");
+static MetricGauge& ORPHAN_BYTES = MetricsAPI::RegisterGauge("grin_orphan_pool_bytes", "Estimated memory used by the orphan pool.");
+
+OrphanPool::OrphanPool(const size_t maxBytes)
+	: m_maxBytes(maxBytes), m_memoryUsage(0), m_orphanHeadersByHash(64)
 {
 
 }
 
-bool OrphanPool::IsOrphan(const uint64_t height, const Hash& hash) const
+bool OrphanPool::IsOrphan(const Hash& hash) const
 {
-	auto heightIter = m_orphansByHeight.find(height);
-	if (heightIter != m_orphansByHeight.cend())
-	{
-		for (auto orphanIter = heightIter->second.cbegin(); orphanIter != heightIter->second.cend(); orphanIter++)
-		{
-			if (orphanIter->GetHash() == hash)
-			{
-				return true;
-			}
-		}
-	}
-
-	return false;
+	return m_orphansByHash.find(hash) != m_orphansByHash.cend();
 }
 
 void OrphanPool::AddOrphanBlock(const FullBlock& block)
 {
-	if (!m_orphanHeadersByHash.Cached(block.GetHash()))
+	m_orphanHeadersByHash.Put(block.GetHash(), block.GetHeader());
+
+	auto iter = m_orphansByHash.find(block.GetHash());
+	if (iter != m_orphansByHash.end())
 	{
-		m_orphanHeadersByHash.Put(block.GetHash(), block.GetHeader());
+		m_lru.splice(m_lru.begin(), m_lru, iter->second.lruIter);
+		return;
 	}
 
-	auto heightIter = m_orphansByHeight.find(block.GetHeight());
-	if (heightIter != m_orphansByHeight.cend())
-	{
-		for (auto orphanIter = heightIter->second.cbegin(); orphanIter != heightIter->second.cend(); orphanIter++)
-		{
-			if (orphanIter->GetHash() == block.GetHash())
-			{
-				return;
-			}
-		}
+	m_lru.push_front(block.GetHash());
 
-		heightIter->second.emplace_back(Orphan(block));
-	}
-	else
+	const size_t memoryUsage = EstimateMemoryUsage(block);
+	m_orphansByHash.emplace(block.GetHash(), Entry{ Orphan(block), memoryUsage, m_lru.begin() });
+	m_orphansByPreviousHash.emplace(block.GetPreviousHash(), block.GetHash());
+	m_memoryUsage += memoryUsage;
+
+	// The orphan just added is never dropped, so a single block larger than the cap is still kept until it's connected.
+	while (m_maxBytes > 0 && m_memoryUsage > m_maxBytes && m_lru.size() > 1)
 	{
-		m_orphansByHeight[block.GetHeight()] = std::vector<Orphan>({ Orphan(block) });
+		auto evictIter = m_orphansByHash.find(m_lru.back());
+		LOG_DEBUG_F("Dropping orphan {} to stay within {} bytes", *evictIter->second.orphan.GetBlock(), m_maxBytes);
+		Erase(evictIter);
 	}
+
+	UpdateMetrics();
 }
 
-std::shared_ptr<const FullBlock> OrphanPool::GetOrphanBlock(const uint64_t height, const Hash& hash) const
+std::shared_ptr<const FullBlock> OrphanPool::GetOrphanBlock(const Hash& hash) const
 {
-	auto heightIter = m_orphansByHeight.find(height);
-	if (heightIter != m_orphansByHeight.cend())
+	auto iter = m_orphansByHash.find(hash);
+	if (iter != m_orphansByHash.cend())
 	{
-		for (auto orphanIter = heightIter->second.cbegin(); orphanIter != heightIter->second.cend(); orphanIter++)
-		{
-			if (orphanIter->GetHash() == hash)
-			{
-				return orphanIter->GetBlock();
-			}
-		}
+		return iter->second.orphan.GetBlock();
 	}
 
 	return std::shared_ptr<const FullBlock>(nullptr);
 }
 
-std::shared_ptr<const FullBlock> OrphanPool::GetNextOrphanBlock(const uint64_t height, const Hash& previousHash) const
+std::vector<std::shared_ptr<const FullBlock>> OrphanPool::GetChildren(const Hash& previousHash) const
 {
-	auto heightIter = m_orphansByHeight.find(height);
-	if (heightIter != m_orphansByHeight.cend())
+	std::vector<std::shared_ptr<const FullBlock>> children;
+
+	auto range = m_orphansByPreviousHash.equal_range(previousHash);
+	for (auto iter = range.first; iter != range.second; iter++)
 	{
-		for (auto orphanIter = heightIter->second.cbegin(); orphanIter != heightIter->second.cend(); orphanIter++)
-		{
-			if (orphanIter->GetBlock()->GetPreviousHash() == previousHash)
-			{
-				return orphanIter->GetBlock();
-			}
-		}
+		children.push_back(m_orphansByHash.at(iter->second).orphan.GetBlock());
 	}
 
-	return std::shared_ptr<const FullBlock>(nullptr);
+	return children;
 }
 
-void OrphanPool::RemoveOrphan(const uint64_t height, const Hash& hash)
+void OrphanPool::RemoveOrphan(const Hash& hash)
 {
-	auto iter = m_orphansByHeight.find(height);
-	if (iter != m_orphansByHeight.end())
+	auto iter = m_orphansByHash.find(hash);
+	if (iter != m_orphansByHash.end())
 	{
-		for (auto orphanIter = iter->second.begin(); orphanIter != iter->second.end(); orphanIter++)
-		{
-			if (orphanIter->GetHash() == hash)
-			{
-				iter->second.erase(orphanIter);
-				break;
-			}
-		}
+		Erase(iter);
+	}
+}
 
-		if (iter->second.empty())
+void OrphanPool::Erase(std::unordered_map<Hash, Entry>::iterator iter)
+{
+	const Hash& previousHash = iter->second.orphan.GetBlock()->GetPreviousHash();
+	auto range = m_orphansByPreviousHash.equal_range(previousHash);
+	for (auto prevIter = range.first; prevIter != range.second; prevIter++)
+	{
+		if (prevIter->second == iter->first)
 		{
-			m_orphansByHeight.erase(height);
+			m_orphansByPreviousHash.erase(prevIter);
+			break;
 		}
 	}
+
+	m_lru.erase(iter->second.lruIter);
+	m_memoryUsage -= iter->second.memoryUsage;
+	m_orphansByHash.erase(iter);
+
+	UpdateMetrics();
 }
 
-BlockHeaderPtr OrphanPool::GetOrphanHeader(const Hash& hash) const
+void OrphanPool::UpdateMetrics() const
 {
-	if (m_orphanHeadersByHash.Cached(hash))
+	NUM_ORPHANS.Set((int64_t)m_orphansByHash.size());
+	ORPHAN_BYTES.Set((int64_t)m_memoryUsage);
+}
+
+size_t OrphanPool::EstimateMemoryUsage(const FullBlock& block)
+{
+	size_t usage = sizeof(FullBlock) + sizeof(BlockHeader) + sizeof(Entry);
+	usage += block.GetInputs().size() * sizeof(TransactionInput);
+	usage += block.GetKernels().size() * sizeof(TransactionKernel);
+	for (const TransactionOutput& output : block.GetOutputs())
 	{
-		return m_orphanHeadersByHash.Get(hash);
+		usage += sizeof(TransactionOutput) + output.GetRangeProof().GetProofBytes().capacity();
 	}
 
-	return nullptr;
+	return usage;
+}
+
+BlockHeaderPtr OrphanPool::GetOrphanHeader(const Hash& hash) const
+{
+	return m_orphanHeadersByHash.Get(hash).value_or(nullptr);
 }
 
 void OrphanPool::AddOrphanHeader(BlockHeaderPtr pHeader)
 {
 	m_orphanHeadersByHash.Put(pHeader->GetHash(), pHeader);
-}
\ No newline at end of file
+}
@@ -4,24 +4,58 @@
 
 #include <Crypto/Hash.h>
 #include <Core/Models/FullBlock.h>
+#include <list>
 #include <unordered_map>
-#include <caches/Cache.h>
+#include <vector>
+#include <Common/ShardedCache.h>
 
+//
+// Blocks received before their parent was connected.
+// Orphans are indexed by hash and by previous hash, so the children of a newly connected block are found directly.
+// The estimated memory used is capped, and once it's exceeded the least recently added orphans are dropped.
+//
 class OrphanPool
 {
 public:
-	OrphanPool();
+	OrphanPool(const size_t maxBytes);
 
-	bool IsOrphan(const uint64_t height, const Hash& hash) const;
+	bool IsOrphan(const Hash& hash) const;
 	void AddOrphanBlock(const FullBlock& block);
-	std::shared_ptr<const FullBlock> GetOrphanBlock(const uint64_t height, const Hash& hash) const;
-	std::shared_ptr<const FullBlock> GetNextOrphanBlock(const uint64_t height, const Hash& previousHash) const;
-	void RemoveOrphan(const uint64_t height, const Hash& hash);
+	std::shared_ptr<const FullBlock> GetOrphanBlock(const Hash& hash) const;
+
+	//
+	// Returns the orphans whose previous block is the given one.
+	//
+	std::vector<std::shared_ptr<const FullBlock>> GetChildren(const Hash& previousHash) const;
+	void RemoveOrphan(const Hash& hash);
+
+	size_t GetNumOrphans() const noexcept { return m_orphansByHash.size(); }
+	size_t GetMemoryUsage() const noexcept { return m_memoryUsage; }
+	size_t GetMaxBytes() const noexcept { return m_maxBytes; }
 
 	void AddOrphanHeader(BlockHeaderPtr pHeader);
 	BlockHeaderPtr GetOrphanHeader(const Hash& hash) const;
 
 private:
-	std::unordered_map<uint64_t, std::vector<Orphan>> m_orphansByHeight;
-	LRUCache<Hash, BlockHeaderPtr> m_orphanHeadersByHash;
+	struct Entry
+	{
+		Orphan orphan;
+		size_t memoryUsage;
+		std::list<Hash>::iterator lruIter;
+	};
+
+	static size_t EstimateMemoryUsage(const FullBlock& block);
+	void Erase(std::unordered_map<Hash, Entry>::iterator iter);
+	void UpdateMetrics() const;
+
+	size_t m_maxBytes;
+	size_t m_memoryUsage;
+
+	std::unordered_map<Hash, Entry> m_orphansByHash;
+	std::unordered_multimap<Hash, Hash> m_orphansByPreviousHash;
+
+	// Most recently added first.
+	std::list<Hash> m_lru;
+
+	ShardedCache<Hash, BlockHeaderPtr> m_orphanHeadersByHash;
 };
@@ -146,6 +146,14 @@ EBlockChainStatus BlockHeaderProcessor::ProcessSyncHeaders(const std::vector<Blo
 		}
 	}
 
+	// The cuckoo cycles are independent of the chain state, so verify them all in parallel before taking the lock.
+	// Only the linkage, difficulty, and MMR checks are left to be done sequentially under the lock.
+	if (!BlockHeaderValidator::VerifyProofs(m_config, headers))
+	{
+		LOG_ERROR_F("Invalid proof of work in headers {} to {}", *headers.front(), *headers.back());
+		throw BAD_DATA_EXCEPTION("Header invalid.");
+	}
+
 	const size_t size = headers.size();
 	size_t index = 0;
 
@@ -203,8 +211,8 @@ EBlockChainStatus BlockHeaderProcessor::ProcessChunkedSyncHeaders(const std::vec
 	pCandidateChain->Rewind(newHeaders.front()->GetHeight() - 1);
 	pHeaderMMR->Rewind(newHeaders.front()->GetHeight());
 
-	// Validate the headers.
-	ValidateHeaders(pLockedState, newHeaders);
+	// Validate the headers. Their proofs were already verified by ProcessSyncHeaders.
+	ValidateHeaders(pLockedState, newHeaders, true);
 
 	// If total difficulty increases, accept sync chain as new candidate chain.
 	if (newHeaders.back()->GetTotalDifficulty() <= totalDifficulty)
@@ -245,7 +253,7 @@ void BlockHeaderProcessor::RewindMMR(Writer<ChainState> pLockedState, const std:
 	pHeaderMMR->Rewind(headers.front()->GetHeight());
 }
 
-void BlockHeaderProcessor::ValidateHeaders(Writer<ChainState> pLockedState, const std::vector<BlockHeaderPtr>& headers)
+void BlockHeaderProcessor::ValidateHeaders(Writer<ChainState> pLockedState, const std::vector<BlockHeaderPtr>& headers, const bool proofsVerified)
 {
 	LOG_TRACE("Validating headers");
 
@@ -264,7 +272,7 @@ void BlockHeaderProcessor::ValidateHeaders(Writer<ChainState> pLockedState, cons
 
 	for (auto pHeader : headers)
 	{
-		if (!validator.IsValidHeader(*pHeader, *pPreviousHeader))
+		if (!validator.IsValidHeader(*pHeader, *pPreviousHeader, proofsVerified))
 		{
 			LOG_ERROR_F("Header invalid: {}", *pHeader);
 			throw BAD_DATA_EXCEPTION("Header invalid.");
@@ -50,7 +50,8 @@ private:
 
 	void ValidateHeaders(
 		Writer<ChainState> pLockedState,
-		const std::vector<BlockHeaderPtr>& headers
+		const std::vector<BlockHeaderPtr>& headers,
+		const bool proofsVerified = false
 	);
 
 	const Config& m_config;
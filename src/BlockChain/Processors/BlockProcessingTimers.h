@@ -0,0 +1,56 @@
+#pragma once
+
+#include <BlockChain/BlockProcessingStats.h>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+//
+// Accumulates the time spent in each phase of adding blocks, for IBlockChain::GetProcessingStats.
+//
+class BlockProcessingTimers
+{
+public:
+	using Ptr = std::shared_ptr<BlockProcessingTimers>;
+	using Clock = std::chrono::steady_clock;
+
+	void AddValidateTime(const Clock::time_point& start, const uint64_t numRangeProofs, const uint64_t numKernels) noexcept
+	{
+		Add(m_validateUs, start);
+		m_numRangeProofs += numRangeProofs;
+		m_numKernels += numKernels;
+	}
+
+	void AddCommitTime(const Clock::time_point& start) noexcept { Add(m_commitUs, start); }
+	void AddApplyTime(const Clock::time_point& start) noexcept
+	{
+		Add(m_applyUs, start);
+		m_numBlocks++;
+	}
+
+	BlockProcessingStats GetStats() const noexcept
+	{
+		return BlockProcessingStats{
+			m_numBlocks.load(),
+			m_numRangeProofs.load(),
+			m_numKernels.load(),
+			std::chrono::microseconds(m_validateUs.load()),
+			std::chrono::microseconds(m_applyUs.load()),
+			std::chrono::microseconds(m_commitUs.load())
+		};
+	}
+
+private:
+	static void Add(std::atomic<int64_t>& totalUs, const Clock::time_point& start) noexcept
+	{
+		totalUs += std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+	}
+
+	std::atomic<uint64_t> m_numBlocks{ 0 };
+	std::atomic<uint64_t> m_numRangeProofs{ 0 };
+	std::atomic<uint64_t> m_numKernels{ 0 };
+	std::atomic<int64_t> m_validateUs{ 0 };
+	std::atomic<int64_t> m_applyUs{ 0 };
+	std::atomic<int64_t> m_commitUs{ 0 };
+};
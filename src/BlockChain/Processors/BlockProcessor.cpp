@@ -7,19 +7,109 @@
 #include <Core/Exceptions/BadDataException.h>
 #include <Consensus/BlockTime.h>
 #include <Common/Logger.h>
+#include <Common/Tracer.h>
 #include <Common/Util/HexUtil.h>
 #include <Common/Util/StringUtil.h>
 #include <algorithm>
 
-BlockProcessor::BlockProcessor(const Config& config, std::shared_ptr<Locked<ChainState>> pChainState)
-	: m_config(config), m_pChainState(pChainState)
+BlockProcessor::BlockProcessor(const Config& config, std::shared_ptr<Locked<ChainState>> pChainState, BlockProcessingTimers::Ptr pTimers)
+	: m_config(config), m_pChainState(pChainState), m_pTimers(pTimers)
 {
 
 }
 
 EBlockChainStatus BlockProcessor::ProcessBlock(const FullBlock& block)
-{	
-	const uint64_t candidateHeight = m_pChainState->Read()->GetHeight(EChainType::CANDIDATE);
+{
+	TRACE_SPAN("BlockProcessor::ProcessBlock");
+
+	const EBlockChainStatus headerStatus = ProcessHeader(block);
+	if (headerStatus == EBlockChainStatus::SUCCESS)
+	{
+		const EBlockChainStatus returnStatus = ProcessBlockInternal(block);
+		if (returnStatus == EBlockChainStatus::SUCCESS)
+		{
+			LOG_DEBUG_F("Block {} successfully processed.", block);
+		}
+
+		return returnStatus;
+	}
+
+	return headerStatus;
+}
+
+size_t BlockProcessor::ProcessBlocks(const std::vector<FullBlock::CPtr>& blocks)
+{
+	TRACE_SPAN("BlockProcessor::ProcessBlocks");
+
+	std::vector<FullBlock::CPtr> group;
+	for (const FullBlock::CPtr& pBlock : blocks)
+	{
+		if (ProcessHeader(*pBlock) != EBlockChainStatus::SUCCESS)
+		{
+			break;
+		}
+
+		group.push_back(pBlock);
+	}
+
+	auto pBatch = m_pChainState->BatchWrite();
+	auto pBlockDB = pBatch->GetBlockDB();
+	auto pConfirmedChain = pBatch->GetChainStore()->GetConfirmedChain();
+
+	size_t numAdded = 0;
+	for (const FullBlock::CPtr& pBlock : group)
+	{
+		// Same checks as ProcessBlockInternal, but anything other than the next block ends the group.
+		if (pConfirmedChain->GetTipHash() != pBlock->GetPreviousHash()
+			|| pBlockDB->GetBlockHeader(pBlock->GetHash()) == nullptr
+			|| pBlockDB->HasBlock(pBlock->GetHash()))
+		{
+			break;
+		}
+
+		ValidateAndAddBlock(*pBlock, pBatch);
+		pConfirmedChain->AddBlock(pBlock->GetHash(), pBlock->GetHeight());
+		++numAdded;
+	}
+
+	if (numAdded > 0)
+	{
+		const auto commitStart = BlockProcessingTimers::Clock::now();
+		pBatch->Commit();
+		m_pTimers->AddCommitTime(commitStart);
+
+		LOG_DEBUG_F("Blocks {} to {} successfully processed.", group.front()->GetHeight(), group[numAdded - 1]->GetHeight());
+	}
+
+	return numAdded;
+}
+
+void BlockProcessor::VerifySelfConsistent(const FullBlock& block, const bool assumeValid, BlockProcessingTimers& timers)
+{
+	if (block.WasValidated())
+	{
+		return;
+	}
+
+	const auto start = BlockProcessingTimers::Clock::now();
+	BlockValidator::VerifySelfConsistent(block, assumeValid);
+
+	// Only the structure of assumed valid blocks is checked.
+	timers.AddValidateTime(
+		start,
+		assumeValid ? 0 : block.GetOutputs().size(),
+		assumeValid ? 0 : block.GetKernels().size()
+	);
+}
+
+//
+// Returns SUCCESS if the header is valid (even if its block is an orphan) and the block is self-consistent.
+//
+EBlockChainStatus BlockProcessor::ProcessHeader(const FullBlock& block)
+{
+	TRACE_SPAN("BlockProcessor::ProcessHeader");
+
+	const uint64_t candidateHeight = m_pChainState->ScopedRead()->GetHeight(EChainType::CANDIDATE);
 	const uint64_t horizonHeight = Consensus::GetHorizonHeight(candidateHeight);
 
 	BlockHeaderPtr pHeader = block.GetHeader();
@@ -36,15 +126,10 @@ EBlockChainStatus BlockProcessor::ProcessBlock(const FullBlock& block)
 		|| headerStatus == EBlockChainStatus::ORPHANED)
 	{
 		// Verify block is self-consistent before locking
-		BlockValidator::VerifySelfConsistent(block);
+		const bool assumeValid = m_pChainState->ScopedRead()->IsAssumedValid(*pHeader);
+		VerifySelfConsistent(block, assumeValid, *m_pTimers);
 
-		const EBlockChainStatus returnStatus = ProcessBlockInternal(block);
-		if (returnStatus == EBlockChainStatus::SUCCESS)
-		{
-			LOG_DEBUG_F("Block {} successfully processed.", *pHeader);
-		}
-
-		return returnStatus;
+		return EBlockChainStatus::SUCCESS;
 	}
 
 	return headerStatus;
@@ -65,7 +150,7 @@ EBlockChainStatus BlockProcessor::ProcessBlockInternal(const FullBlock& block)
 	}
 
 	// 2. Check if block has already been processed.
-	if (pBatch->GetBlockDB()->GetBlock(block.GetHash()) != nullptr)
+	if (pBatch->GetBlockDB()->HasBlock(block.GetHash()))
 	{
 		LOG_TRACE_F("Block {} already processed.", block);
 		return EBlockChainStatus::ALREADY_EXISTS;
@@ -75,7 +160,7 @@ EBlockChainStatus BlockProcessor::ProcessBlockInternal(const FullBlock& block)
 	const BlockProcessingInfo info = DetermineBlockStatus(block, pBatch);
 	if (info.status == EBlockStatus::ORPHAN)
 	{
-		if (pOrphanPool->IsOrphan(block.GetHeight(), block.GetHash()))
+		if (pOrphanPool->IsOrphan(block.GetHash()))
 		{
 			LOG_TRACE_F("Block {} already processed as an orphan.", block);
 			return EBlockChainStatus::ALREADY_EXISTS;
@@ -96,7 +181,10 @@ EBlockChainStatus BlockProcessor::ProcessBlockInternal(const FullBlock& block)
 
 		ValidateAndAddBlock(block, pBatch);
 		pConfirmedChain->AddBlock(block.GetHash(), block.GetHeight());
+
+		const auto commitStart = BlockProcessingTimers::Clock::now();
 		pBatch->Commit();
+		m_pTimers->AddCommitTime(commitStart);
 
 		return EBlockChainStatus::SUCCESS;
 	}
@@ -122,25 +210,42 @@ BlockProcessor::BlockProcessingInfo BlockProcessor::DetermineBlockStatus(const F
 		return { EBlockStatus::NEXT_BLOCK, {} };
 	}
 
-	auto pForkBlock = std::make_shared<const FullBlock>(block);
-
-	std::vector<FullBlock::CPtr> reorgBlocks({ pForkBlock });
-	while (!pConfirmedChain->IsOnChain(pForkBlock->GetHeight() - 1, pForkBlock->GetPreviousHash()))
+	// The fork is found by walking back through the headers, which are cached, so the fork's blocks
+	// that aren't orphans can then be read in a single batch rather than one at a time.
+	std::vector<FullBlock::CPtr> reorgBlocks({ std::make_shared<const FullBlock>(block) });
+	std::vector<Hash> missingHashes;
+	std::vector<size_t> missingIndices;
+	BlockHeaderPtr pForkHeader = block.GetHeader();
+	while (!pConfirmedChain->IsOnChain(pForkHeader->GetHeight() - 1, pForkHeader->GetPreviousHash()))
 	{
-		Hash previousHash = pForkBlock->GetPreviousHash();
-		pForkBlock = pOrphanPool->GetOrphanBlock(pForkBlock->GetHeight() - 1, previousHash);
-		if (pForkBlock == nullptr)
+		const Hash previousHash = pForkHeader->GetPreviousHash();
+		pForkHeader = pBlockDB->GetBlockHeader(previousHash);
+		if (pForkHeader == nullptr)
 		{
-			pForkBlock = pBlockDB->GetBlock(previousHash);
+			LOG_TRACE_F("Mising previous header. Treating {} as orphan.", block);
+			return { EBlockStatus::ORPHAN, {} };
 		}
 
+		FullBlock::CPtr pForkBlock = pOrphanPool->GetOrphanBlock(previousHash);
 		if (pForkBlock == nullptr)
+		{
+			missingHashes.push_back(previousHash);
+			missingIndices.push_back(reorgBlocks.size());
+		}
+
+		reorgBlocks.push_back(pForkBlock);
+	}
+
+	std::vector<std::unique_ptr<FullBlock>> storedBlocks = pBlockDB->GetBlocks(missingHashes);
+	for (size_t i = 0; i < storedBlocks.size(); i++)
+	{
+		if (storedBlocks[i] == nullptr)
 		{
 			LOG_TRACE_F("Mising previous block. Treating {} as orphan.", block);
 			return { EBlockStatus::ORPHAN, {} };
 		}
 
-		reorgBlocks.push_back(pForkBlock);
+		reorgBlocks[missingIndices[i]] = std::move(storedBlocks[i]);
 	}
 
 	std::reverse(reorgBlocks.begin(), reorgBlocks.end());
@@ -155,6 +260,8 @@ BlockProcessor::BlockProcessingInfo BlockProcessor::DetermineBlockStatus(const F
 
 void BlockProcessor::HandleReorg(Writer<ChainState> pBatch, const std::vector<FullBlock::CPtr>& reorgBlocks)
 {
+	TRACE_SPAN("BlockProcessor::HandleReorg");
+
 	const uint64_t totalDifficulty = pBatch->GetTotalDifficulty(EChainType::CONFIRMED);
 
 	auto pTxHashSet = pBatch->GetTxHashSetManager()->GetTxHashSet();
@@ -172,25 +279,56 @@ void BlockProcessor::HandleReorg(Writer<ChainState> pBatch, const std::vector<Fu
 		throw BLOCK_CHAIN_EXCEPTION("Failed to find header.");
 	}
 
-	// TODO: Add rewound transactions back to TxPool
+	// Collect the blocks being disconnected, in order of increasing height.
+	auto pConfirmedChain = pBatch->GetChainStore()->GetConfirmedChain();
+	std::vector<Hash> disconnectedBlocks;
+	for (uint64_t height = pCommonHeader->GetHeight() + 1; height <= pConfirmedChain->GetHeight(); height++)
+	{
+		disconnectedBlocks.push_back(pConfirmedChain->GetHash(height));
+	}
 
 	pTxHashSet->Rewind(pBlockDB, *pCommonHeader);
 
-	for (const FullBlock::CPtr& pBlock : reorgBlocks)
+	// The rewind restored the inputs of the disconnected blocks' txs, so add them back to the TxPool.
+	auto pTxPool = pBatch->GetTransactionPool();
+	pTxPool->ReinjectBlockTransactions(disconnectedBlocks);
+
+	// If the reorg doesn't happen, the disconnected blocks are still confirmed, so their re-injected txs must be removed again.
+	auto reconcileDisconnected = [&]() {
+		for (const Hash& blockHash : disconnectedBlocks)
+		{
+			std::unique_ptr<FullBlock> pBlock = pBlockDB->GetBlock(blockHash);
+			if (pBlock != nullptr)
+			{
+				pTxPool->ReconcileBlock(pBlockDB, pTxHashSet, *pBlock);
+			}
+		}
+	};
+
+	try
 	{
-		ValidateAndAddBlock(*pBlock, pBatch);
+		for (const FullBlock::CPtr& pBlock : reorgBlocks)
+		{
+			ValidateAndAddBlock(*pBlock, pBatch);
+		}
+	}
+	catch (std::exception&)
+	{
+		reconcileDisconnected();
+		throw;
 	}
 
 	if (reorgBlocks.back()->GetTotalDifficulty() > totalDifficulty)
 	{
-		auto pConfirmedChain = pBatch->GetChainStore()->GetConfirmedChain();
 		pConfirmedChain->Rewind(reorgBlocks.front()->GetHeight() - 1);
 		for (const FullBlock::CPtr& pBlock : reorgBlocks)
 		{
 			pConfirmedChain->AddBlock(pBlock->GetHash(), pBlock->GetHeight());
 		}
 
+		const auto commitStart = BlockProcessingTimers::Clock::now();
 		pBatch->Commit();
+		m_pTimers->AddCommitTime(commitStart);
 	}
 	else
 	{
@@ -204,11 +342,17 @@ void BlockProcessor::HandleReorg(Writer<ChainState> pBatch, const std::vector<Fu
 		}
 
 		pBlockDB->Commit();
+
+		reconcileDisconnected();
 	}
 }
 
 void BlockProcessor::ValidateAndAddBlock(const FullBlock& block, Writer<ChainState> pBatch)
 {
+	TRACE_SPAN("BlockProcessor::ValidateAndAddBlock");
+
+	const auto start = BlockProcessingTimers::Clock::now();
+
 	auto pOrphanPool = pBatch->GetOrphanPool();
 	auto pBlockDB = pBatch->GetBlockDB();
 	auto pTxHashSet = pBatch->GetTxHashSetManager()->GetTxHashSet();
@@ -233,6 +377,8 @@ void BlockProcessor::ValidateAndAddBlock(const FullBlock& block, Writer<ChainSta
 	pBlockDB->RemoveOutputPositions(block.GetInputCommitments());
 	pBlockDB->AddBlockSums(block.GetHash(), blockSums);
 	pBlockDB->AddBlock(block);
-	pOrphanPool->RemoveOrphan(block.GetHeight(), block.GetHash());
+	pOrphanPool->RemoveOrphan(block.GetHash());
 	pTxPool->ReconcileBlock(pBlockDB, pTxHashSet, block);
+
+	m_pTimers->AddApplyTime(start);
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "BlockProcessingTimers.h"
 #include "../ChainState.h"
 
 #include <Config/Config.h>
@@ -21,11 +22,24 @@ class BlockProcessor
 		std::vector<FullBlock::CPtr> reorgBlocks;
 	};
 public:
-	BlockProcessor(const Config& config, std::shared_ptr<Locked<ChainState>> pChainState);
+	BlockProcessor(const Config& config, std::shared_ptr<Locked<ChainState>> pChainState, BlockProcessingTimers::Ptr pTimers);
 
 	EBlockChainStatus ProcessBlock(const FullBlock& block);
 
+	//
+	// Applies the leading run of blocks that each extend the confirmed chain in a single batch, committing once.
+	// Stops at the first block that isn't the next block (eg. orphans or forks), leaving it for ProcessBlock.
+	// Returns the number of blocks added. If any block fails, nothing is committed and the exception is rethrown.
+	//
+	size_t ProcessBlocks(const std::vector<FullBlock::CPtr>& blocks);
+
+	//
+	// Verifies the block is self-consistent (see BlockValidator::VerifySelfConsistent), unless it already was, recording the time taken.
+	//
+	static void VerifySelfConsistent(const FullBlock& block, const bool assumeValid, BlockProcessingTimers& timers);
+
 private:
+	EBlockChainStatus ProcessHeader(const FullBlock& block);
 	EBlockChainStatus ProcessBlockInternal(const FullBlock& block);
 	void HandleReorg(Writer<ChainState> pBatch, const std::vector<FullBlock::CPtr>& reorgBlocks);
 	void ValidateAndAddBlock(const FullBlock& block, Writer<ChainState> pLockedState);
@@ -34,4 +48,5 @@ private:
 
 	const Config& m_config;
 	std::shared_ptr<Locked<ChainState>> m_pChainState;
+	BlockProcessingTimers::Ptr m_pTimers;
 };
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <BlockChain/BlockChain.h>
 #include <Common/Util/StringUtil.h>
 #include <Common/Util/HexUtil.h>
+#include <Consensus/BlockTime.h>
+#include <algorithm>
 
 TxHashSetProcessor::TxHashSetProcessor(
 	const Config& config,
@@ -18,9 +20,9 @@ TxHashSetProcessor::TxHashSetProcessor(
 
 }
 
-bool TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const fs::path& path, SyncStatus& syncStatus)
+bool TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const fs::path& path, const TxHashSetDownload* pDownload, SyncStatus& syncStatus)
 {
-	auto pHeader = m_pChainState->Read()->GetBlockHeaderByHash(blockHash);
+	auto pHeader = m_pChainState->ScopedRead()->GetBlockHeaderByHash(blockHash);
 	if (pHeader == nullptr)
 	{
 		LOG_ERROR_F("Header not found for hash {}.", blockHash);
@@ -31,18 +33,53 @@ bool TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const fs::path&
 	m_pChainState->Write()->GetTxHashSetManager()->Close();
 
 	// 2. Load and Extract TxHashSet Zip
-	ITxHashSetPtr pTxHashSet = TxHashSetManager::LoadFromZip(m_config, path, pHeader);
+	ITxHashSetPtr pTxHashSet = TxHashSetManager::LoadFromZip(m_config, path, pHeader, pDownload);
 	if (pTxHashSet == nullptr)
 	{
 		LOG_ERROR_F("Failed to load {}", path);
 		return false;
 	}
 
+	return ValidateAndApply(pHeader, pTxHashSet, nullptr, syncStatus);
+}
+
+bool TxHashSetProcessor::ProcessSnapshot(const fs::path& directory, const TxHashSetManager::SnapshotManifest& manifest, SyncStatus& syncStatus)
+{
+	auto pHeader = m_pChainState->ScopedRead()->GetBlockHeaderByHash(manifest.pHeader->GetHash());
+	if (pHeader == nullptr)
+	{
+		LOG_ERROR_F("Header not found for snapshot {}.", *manifest.pHeader);
+		return false;
+	}
+
+	// 1. Close Existing TxHashSet
+	m_pChainState->Write()->GetTxHashSetManager()->Close();
+
+	// 2. Check and copy the snapshot files
+	ITxHashSetPtr pTxHashSet = TxHashSetManager::LoadSnapshot(m_config, directory, manifest);
+	if (pTxHashSet == nullptr)
+	{
+		LOG_ERROR_F("Failed to load snapshot {}", directory);
+		return false;
+	}
+
+	return ValidateAndApply(pHeader, pTxHashSet, &manifest.blockSums, syncStatus);
+}
+
+bool TxHashSetProcessor::ValidateAndApply(const BlockHeaderPtr& pHeader, const ITxHashSetPtr& pTxHashSet, const BlockSums* pExpectedSums, SyncStatus& syncStatus)
+{
 	// 3. Validate entire TxHashSet
 	auto pBlockSums = pTxHashSet->ValidateTxHashSet(*pHeader, m_blockChain, syncStatus);
 	if (pBlockSums == nullptr)
 	{
-		LOG_ERROR_F("Validation of {} failed.", path);
+		LOG_ERROR_F("Validation of TxHashSet for {} failed.", *pHeader);
+		return false;
+	}
+
+	if (pExpectedSums != nullptr
+		&& (pExpectedSums->GetOutputSum() != pBlockSums->GetOutputSum() || pExpectedSums->GetKernelSum() != pBlockSums->GetKernelSum()))
+	{
+		LOG_ERROR_F("BlockSums of TxHashSet for {} don't match the snapshot.", *pHeader);
 		return false;
 	}
 
@@ -55,6 +92,18 @@ bool TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const fs::path&
 	LOG_DEBUG("Saving output positions.");
 	pTxHashSet->SaveOutputPositions(pChainStateBatch->GetChainStore()->GetCandidateChain(), pChainStateBatch->GetBlockDB());
 
+	// The kernel index is rebuilt in the background (see BlockChain::IndexKernels).
+	pChainStateBatch->GetBlockDB()->ClearKernelPositions();
+
+	// NRD kernels are checked against the last week of blocks, which is the longest relative lock.
+	pChainStateBatch->GetBlockDB()->ClearNRDKernelPositions();
+	pTxHashSet->SaveNRDKernelPositions(
+		pChainStateBatch->GetChainStore()->GetCandidateChain(),
+		pChainStateBatch->GetBlockDB(),
+		pHeader->GetHeight() - (std::min)(pHeader->GetHeight(), Consensus::WEEK_HEIGHT),
+		pHeader->GetHeight()
+	);
+
 	// 6. Store TxHashSet
 	LOG_DEBUG("Using TxHashSet.");
 	pChainStateBatch->GetTxHashSetManager()->SetTxHashSet(pTxHashSet);
@@ -63,7 +112,7 @@ bool TxHashSetProcessor::ProcessTxHashSet(const Hash& blockHash, const fs::path&
 	LOG_DEBUG("Updating confirmed chain.");
 	if (!UpdateConfirmedChain(pChainStateBatch, *pHeader))
 	{
-		LOG_ERROR_F("Failed to update confirmed chain for {}.", path);
+		LOG_ERROR_F("Failed to update confirmed chain for {}.", *pHeader);
 		pChainStateBatch->GetTxHashSetManager()->Close();
 		return false;
 	}
@@ -3,6 +3,8 @@
 #include "../ChainState.h"
 
 #include <PMMR/TxHashSet.h>
+#include <PMMR/TxHashSetDownload.h>
+#include <PMMR/TxHashSetManager.h>
 #include <Config/Config.h>
 #include <Crypto/Hash.h>
 #include <P2P/SyncStatus.h>
@@ -18,9 +20,15 @@ class TxHashSetProcessor
 public:
 	TxHashSetProcessor(const Config& config, IBlockChain& blockChain, std::shared_ptr<Locked<ChainState>> pChainState);
 
-	bool ProcessTxHashSet(const Hash& blockHash, const fs::path& path, SyncStatus& syncStatus);
+	bool ProcessTxHashSet(const Hash& blockHash, const fs::path& path, const TxHashSetDownload* pDownload, SyncStatus& syncStatus);
+
+	//
+	// Like ProcessTxHashSet, but for a snapshot exported by one of our own nodes. The validated BlockSums must also match the manifest's.
+	//
+	bool ProcessSnapshot(const fs::path& directory, const TxHashSetManager::SnapshotManifest& manifest, SyncStatus& syncStatus);
 
 private:
+	bool ValidateAndApply(const BlockHeaderPtr& pHeader, const ITxHashSetPtr& pTxHashSet, const BlockSums* pExpectedSums, SyncStatus& syncStatus);
 	bool UpdateConfirmedChain(Writer<ChainState> pLockedState, const BlockHeader& blockHeader);
 
 	const Config& m_config;
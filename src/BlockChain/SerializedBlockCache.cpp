@@ -0,0 +1,87 @@
+#include "SerializedBlockCache.h"
+#include "CompactBlockFactory.h"
+
+#include <Core/Serialization/Serializer.h>
+
+SerializedBlockCache::Bytes SerializedBlockCache::Serialize(const FullBlock& block, const bool compact, const EProtocolVersion protocolVersion)
+{
+	Serializer serializer(protocolVersion);
+	if (compact)
+	{
+		CompactBlockFactory::CreateCompactBlock(block).Serialize(serializer);
+	}
+	else
+	{
+		block.Serialize(serializer);
+	}
+
+	return std::make_shared<const std::vector<uint8_t>>(serializer.GetBytes());
+}
+
+SerializedBlockCache::Bytes SerializedBlockCache::Get(const Hash& hash, const bool compact, const EProtocolVersion protocolVersion) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = m_entries.find(hash);
+	if (iter == m_entries.end() || iter->second.serialized[GetFormatIndex(compact, protocolVersion)] == nullptr)
+	{
+		++m_misses;
+		return nullptr;
+	}
+
+	m_lru.splice(m_lru.begin(), m_lru, iter->second.lruIter);
+	++m_hits;
+	return iter->second.serialized[GetFormatIndex(compact, protocolVersion)];
+}
+
+void SerializedBlockCache::Add(const Hash& hash, const bool compact, const EProtocolVersion protocolVersion, const Bytes& pSerialized)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = m_entries.find(hash);
+	if (iter != m_entries.end())
+	{
+		m_lru.splice(m_lru.begin(), m_lru, iter->second.lruIter);
+	}
+	else
+	{
+		m_lru.push_front(hash);
+		iter = m_entries.insert({ hash, Entry{ {}, m_lru.begin() } }).first;
+	}
+
+	iter->second.serialized[GetFormatIndex(compact, protocolVersion)] = pSerialized;
+
+	while (m_entries.size() > MAX_BLOCKS)
+	{
+		m_entries.erase(m_lru.back());
+		m_lru.pop_back();
+	}
+}
+
+void SerializedBlockCache::AddBlock(const FullBlock& block)
+{
+	// The compact block is created once and serialized for each version.
+	const CompactBlock compactBlock = CompactBlockFactory::CreateCompactBlock(block);
+
+	for (const EProtocolVersion protocolVersion : { EProtocolVersion::V1, EProtocolVersion::V2 })
+	{
+		Serializer blockSerializer(protocolVersion);
+		block.Serialize(blockSerializer);
+		Add(block.GetHash(), false, protocolVersion, std::make_shared<const std::vector<uint8_t>>(blockSerializer.GetBytes()));
+
+		Serializer compactSerializer(protocolVersion);
+		compactBlock.Serialize(compactSerializer);
+		Add(block.GetHash(), true, protocolVersion, std::make_shared<const std::vector<uint8_t>>(compactSerializer.GetBytes()));
+	}
+}
+
+CacheStats SerializedBlockCache::GetStats() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return CacheStats{ MAX_BLOCKS, m_entries.size(), m_hits, m_misses };
+}
+
+size_t SerializedBlockCache::GetFormatIndex(const bool compact, const EProtocolVersion protocolVersion)
+{
+	return (compact ? 2 : 0) + (protocolVersion == EProtocolVersion::V2 ? 1 : 0);
+}
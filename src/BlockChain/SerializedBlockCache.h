@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Common/CacheStats.h>
+#include <Core/Enums/ProtocolVersion.h>
+#include <Core/Models/FullBlock.h>
+#include <Crypto/Hash.h>
+#include <array>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//
+// Recent blocks and their compact blocks, serialized as they're sent to peers for each protocol version.
+// Every peer requests a new block at about the same time, so it's only serialized once instead of per request.
+//
+class SerializedBlockCache
+{
+public:
+	using Ptr = std::shared_ptr<SerializedBlockCache>;
+	using Bytes = std::shared_ptr<const std::vector<uint8_t>>;
+
+	SerializedBlockCache() : m_hits(0), m_misses(0) { }
+
+	// Blocks near the tip are the ones requested by many peers at once. Older ones are requested by syncing peers.
+	static constexpr size_t MAX_BLOCKS = 16;
+
+	static Bytes Serialize(const FullBlock& block, const bool compact, const EProtocolVersion protocolVersion);
+
+	//
+	// Returns nullptr if the block isn't cached in that form.
+	//
+	Bytes Get(const Hash& hash, const bool compact, const EProtocolVersion protocolVersion) const;
+	void Add(const Hash& hash, const bool compact, const EProtocolVersion protocolVersion, const Bytes& pSerialized);
+
+	//
+	// Caches the block and its compact block for every protocol version, so no request for it has to wait on serialization.
+	//
+	void AddBlock(const FullBlock& block);
+
+	CacheStats GetStats() const;
+
+private:
+	static constexpr size_t NUM_FORMATS = 4;
+	static size_t GetFormatIndex(const bool compact, const EProtocolVersion protocolVersion);
+
+	struct Entry
+	{
+		std::array<Bytes, NUM_FORMATS> serialized;
+		std::list<Hash>::iterator lruIter;
+	};
+
+	mutable std::mutex m_mutex;
+
+	// Most recently used at the front.
+	mutable std::list<Hash> m_lru;
+	std::unordered_map<Hash, Entry> m_entries;
+
+	mutable std::atomic<uint64_t> m_hits;
+	mutable std::atomic<uint64_t> m_misses;
+};
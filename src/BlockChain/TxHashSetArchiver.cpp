@@ -0,0 +1,147 @@
+#include "TxHashSetArchiver.h"
+
+#include <Consensus/BlockTime.h>
+#include <Core/Exceptions/BadDataException.h>
+#include <Common/Util/ThreadUtil.h>
+#include <Common/ThreadManager.h>
+#include <Common/Logger.h>
+
+TxHashSetArchiver::Ptr TxHashSetArchiver::Create(const Config& config, const std::shared_ptr<Locked<ChainState>>& pChainState)
+{
+	auto pArchiver = std::shared_ptr<TxHashSetArchiver>(new TxHashSetArchiver(config, pChainState));
+	pArchiver->m_archiveThread = std::thread(Thread_Archive, std::ref(*pArchiver.get()));
+
+	return pArchiver;
+}
+
+TxHashSetArchiver::~TxHashSetArchiver()
+{
+	m_terminate = true;
+	ThreadUtil::Join(m_archiveThread);
+}
+
+TxHashSetArchive::CPtr TxHashSetArchiver::GetArchive(const BlockHeaderPtr& pRequestedHeader)
+{
+	m_requested = true;
+
+	BlockHeaderPtr pHeader = pRequestedHeader;
+	if (pRequestedHeader->GetHeight() % Consensus::TXHASHSET_ARCHIVE_INTERVAL != 0)
+	{
+		BlockHeaderPtr pArchiveHeader = GetArchiveHeader();
+		if (pArchiveHeader != nullptr)
+		{
+			pHeader = pArchiveHeader;
+		}
+	}
+
+	return GetOrBuild(pHeader);
+}
+
+void TxHashSetArchiver::Thread_Archive(TxHashSetArchiver& archiver)
+{
+	ThreadManagerAPI::SetCurrentThreadName("TXHASHSET_ARCHIVER");
+	LOG_TRACE("BEGIN");
+
+	while (!archiver.m_terminate)
+	{
+		ThreadUtil::SleepFor(std::chrono::seconds(60), archiver.m_terminate);
+		if (archiver.m_terminate || !archiver.m_requested)
+		{
+			continue;
+		}
+
+		try
+		{
+			BlockHeaderPtr pArchiveHeader = archiver.GetArchiveHeader();
+			if (pArchiveHeader != nullptr)
+			{
+				archiver.GetOrBuild(pArchiveHeader);
+			}
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_F("Failed to build TxHashSet archive: {}", e.what());
+		}
+	}
+
+	LOG_TRACE("END");
+}
+
+BlockHeaderPtr TxHashSetArchiver::GetArchiveHeader() const
+{
+	auto pReader = m_pChainState->ScopedRead();
+	const uint64_t archiveHeight = Consensus::GetTxHashSetArchiveHeight(pReader->GetHeight(EChainType::CONFIRMED));
+	if (archiveHeight == 0)
+	{
+		return nullptr;
+	}
+
+	return pReader->GetBlockHeaderByHeight(archiveHeight, EChainType::CONFIRMED);
+}
+
+TxHashSetArchive::CPtr TxHashSetArchiver::GetOrBuild(const BlockHeaderPtr& pHeader)
+{
+	// Requests for the cached block don't wait on a build of a newer one.
+	TxHashSetArchive::CPtr pArchive = std::atomic_load(&m_pArchive);
+	if (pArchive != nullptr && pArchive->GetHeader()->GetHash() == pHeader->GetHash())
+	{
+		return pArchive;
+	}
+
+	std::unique_lock<std::mutex> buildLock(m_buildMutex);
+
+	pArchive = std::atomic_load(&m_pArchive);
+	if (pArchive != nullptr && pArchive->GetHeader()->GetHash() == pHeader->GetHash())
+	{
+		return pArchive;
+	}
+
+	pArchive = Build(pHeader);
+	std::atomic_store(&m_pArchive, pArchive);
+
+	return pArchive;
+}
+
+TxHashSetArchive::CPtr TxHashSetArchiver::Build(const BlockHeaderPtr& pHeader) const
+{
+	LOG_INFO_F("Building TxHashSet archive for {}", *pHeader);
+
+	std::unique_ptr<TxHashSetManager::SnapshotCopy> pCopy = Copy(pHeader);
+	TxHashSetArchive::CPtr pArchive = TxHashSetManager::BuildSnapshot(m_config, *pCopy);
+	LOG_INFO_F("Built TxHashSet archive for {}", *pHeader);
+
+	return pArchive;
+}
+
+void TxHashSetArchiver::Export(const BlockHeaderPtr& pHeader, const fs::path& destination) const
+{
+	LOG_INFO_F("Exporting TxHashSet snapshot of {}", *pHeader);
+
+	// BlockSums never change once added, so they don't need to be read along with the copy.
+	std::unique_ptr<BlockSums> pBlockSums = m_pChainState->Read()->GetBlockDB()->GetBlockSums(pHeader->GetHash());
+	if (pBlockSums == nullptr)
+	{
+		throw BAD_DATA_EXCEPTION("BlockSums not found for TxHashSet snapshot.");
+	}
+
+	std::unique_ptr<TxHashSetManager::SnapshotCopy> pCopy = Copy(pHeader);
+	TxHashSetManager::ExportSnapshot(m_config, *pCopy, *pBlockSums, destination);
+}
+
+std::unique_ptr<TxHashSetManager::SnapshotCopy> TxHashSetArchiver::Copy(const BlockHeaderPtr& pHeader) const
+{
+	auto pReader = m_pChainState->ScopedRead();
+	const uint64_t horizon = Consensus::GetHorizonHeight(pReader->GetHeight(EChainType::CONFIRMED));
+	if (pHeader->GetHeight() < horizon)
+	{
+		throw BAD_DATA_EXCEPTION("TxHashSet snapshot requested beyond horizon.");
+	}
+
+	BlockHeaderPtr pConfirmedHeader = pReader->GetBlockHeaderByHeight(pHeader->GetHeight(), EChainType::CONFIRMED);
+	if (pConfirmedHeader == nullptr || pConfirmedHeader->GetHash() != pHeader->GetHash())
+	{
+		throw BAD_DATA_EXCEPTION("TxHashSet snapshot requested for block not on confirmed chain.");
+	}
+
+	return pReader->GetTxHashSetManager()->CopySnapshot(*pReader->GetBlockDB(), pHeader);
+}
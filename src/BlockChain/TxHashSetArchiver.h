@@ -0,0 +1,68 @@
+#pragma once
+
+#include "ChainState.h"
+
+#include <Config/Config.h>
+#include <PMMR/TxHashSetArchive.h>
+#include <Core/Traits/Lockable.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+//
+// Builds the TxHashSet archives sent to syncing peers, keeping the most recent one so all of them share it.
+//
+// Archives are built for the block grin serves (see Consensus::GetTxHashSetArchiveHeight), which is what grin peers
+// and newer Grin++ peers request. Older Grin++ peers request arbitrary blocks, but accept an archive for any block, so they get that one too.
+// Once any peer has requested an archive, a new one is built in the background whenever the archive block moves,
+// so requests rarely have to wait for one.
+//
+// The TxHashSet files are copied under a chain state reader, but the rewind and zip happen without holding any lock,
+// so block processing only waits on the copy.
+//
+class TxHashSetArchiver
+{
+public:
+	using Ptr = std::shared_ptr<TxHashSetArchiver>;
+
+	static TxHashSetArchiver::Ptr Create(const Config& config, const std::shared_ptr<Locked<ChainState>>& pChainState);
+	~TxHashSetArchiver();
+
+	//
+	// Returns an archive to send a peer that requested the given block. Throws a BadDataException if it's beyond the horizon.
+	//
+	TxHashSetArchive::CPtr GetArchive(const BlockHeaderPtr& pRequestedHeader);
+
+	//
+	// Exports a snapshot of the given block to the destination directory (see TxHashSetManager::ExportSnapshot).
+	// Throws a BadDataException if it's beyond the horizon.
+	//
+	void Export(const BlockHeaderPtr& pHeader, const fs::path& destination) const;
+
+private:
+	TxHashSetArchiver(const Config& config, const std::shared_ptr<Locked<ChainState>>& pChainState)
+		: m_config(config), m_pChainState(pChainState), m_pArchive(nullptr), m_requested(false), m_terminate(false) { }
+
+	static void Thread_Archive(TxHashSetArchiver& archiver);
+
+	// Returns null while the confirmed chain is too short to have an archive block.
+	BlockHeaderPtr GetArchiveHeader() const;
+
+	TxHashSetArchive::CPtr GetOrBuild(const BlockHeaderPtr& pHeader);
+	TxHashSetArchive::CPtr Build(const BlockHeaderPtr& pHeader) const;
+
+	// Copies the TxHashSet files for the given block on the confirmed chain, under a chain state reader.
+	std::unique_ptr<TxHashSetManager::SnapshotCopy> Copy(const BlockHeaderPtr& pHeader) const;
+
+	const Config& m_config;
+	std::shared_ptr<Locked<ChainState>> m_pChainState;
+
+	// Only one archive is built at a time, and requesters of the block being built wait for it instead of building their own.
+	std::mutex m_buildMutex;
+	TxHashSetArchive::CPtr m_pArchive;
+
+	std::atomic_bool m_requested;
+	std::atomic_bool m_terminate;
+	std::thread m_archiveThread;
+};
@@ -7,6 +7,9 @@
 #include <Common/Logger.h>
 #include <PoW/PoWManager.h>
 #include <PMMR/HeaderMMR.h>
+#include <Common/ThreadPool.h>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 
 BlockHeaderValidator::BlockHeaderValidator(
@@ -18,7 +21,7 @@ BlockHeaderValidator::BlockHeaderValidator(
 
 }
 
-bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader) const
+bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader, const bool proofVerified) const
 {
 	// Validate Height
 	if (header.GetHeight() != (previousHeader.GetHeight() + 1))
@@ -50,7 +53,8 @@ bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockH
 	}
 
 	// Validate Proof Of Work
-	const bool validPoW = PoWManager(m_config, m_pBlockDB).IsPoWValid(header, previousHeader);
+	const PoWManager powManager(m_config, m_pBlockDB);
+	const bool validPoW = proofVerified ? powManager.IsDifficultyValid(header, previousHeader) : powManager.IsPoWValid(header, previousHeader);
 	if (!validPoW)
 	{
 		LOG_WARNING_F("Invalid Proof of Work for header {}", header);
@@ -66,4 +70,45 @@ bool BlockHeaderValidator::IsValidHeader(const BlockHeader& header, const BlockH
 
 	LOG_TRACE_F("Header {} valid", header);
 	return true;
+}
+
+bool BlockHeaderValidator::VerifyProofs(const Config& config, const std::vector<BlockHeaderPtr>& headers)
+{
+	std::atomic_size_t nextHeader = 0;
+	std::atomic_bool valid = true;
+
+	auto worker = [&config, &headers, &nextHeader, &valid]() {
+		// Cycle verification never reads from the block db.
+		const PoWManager powManager(config, nullptr);
+		while (valid)
+		{
+			const size_t headerIndex = nextHeader++;
+			if (headerIndex >= headers.size())
+			{
+				break;
+			}
+
+			try
+			{
+				const BlockHeader& header = *headers[headerIndex];
+				header.GetHash();
+
+				if (!powManager.IsProofValid(header))
+				{
+					LOG_WARNING_F("Invalid Proof of Work for header {}", header);
+					valid = false;
+				}
+			}
+			catch (std::exception& e)
+			{
+				LOG_ERROR_F("Failed to verify proof of work: {}", e.what());
+				valid = false;
+			}
+		}
+	};
+
+	ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+	threadPool.RunParallel((std::min)(threadPool.GetNumThreads() + 1, headers.size()), worker, ETaskPriority::HIGH);
+
+	return valid;
 }
\ No newline at end of file
@@ -12,7 +12,19 @@ class BlockHeaderValidator
 public:
 	BlockHeaderValidator(const Config& config, std::shared_ptr<const IBlockDB> pBlockDB, std::shared_ptr<const IHeaderMMR> pHeaderMMR);
 
-	bool IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader) const;
+	//
+	// Validates the header against its parent and the chain.
+	// When proofVerified is true, the cuckoo cycle is assumed to have been checked already (see VerifyProofs),
+	// and only the sequential linkage and difficulty checks are performed.
+	//
+	bool IsValidHeader(const BlockHeader& header, const BlockHeader& previousHeader, const bool proofVerified = false) const;
+
+	//
+	// Verifies the proof of work cycle of every header across a pool of worker threads, and caches each header's hash.
+	// Needs no chain state, so it should be run before taking the chain lock.
+	// Returns false as soon as any proof is found to be invalid.
+	//
+	static bool VerifyProofs(const Config& config, const std::vector<BlockHeaderPtr>& headers);
 
 	const Config& m_config;
 	std::shared_ptr<const IBlockDB> m_pBlockDB;
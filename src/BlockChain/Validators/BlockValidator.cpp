@@ -6,33 +6,47 @@
 #include <Core/Validation/TransactionBodyValidator.h>
 #include <Core/Validation/KernelSumValidator.h>
 #include <Common/Util/FunctionalUtil.h>
+#include <Common/Tracer.h>
 #include <Consensus/Common.h>
 #include <PMMR/TxHashSet.h>
 #include <algorithm>
 
 // Validates all the elements in a block that can be checked without additional data. 
 // Includes commitment sums and kernels, reward, etc.
-void BlockValidator::VerifySelfConsistent(const FullBlock& block)
+void BlockValidator::VerifySelfConsistent(const FullBlock& block, const bool assumeValid)
 {
+	TRACE_SPAN("BlockValidator::VerifySelfConsistent");
+
 	if (block.WasValidated())
 	{
 		LOG_TRACE_F("Block {} already validated", block);
 		return;
 	}
 
-	// TODO - NRD: Verify kernel variants
-	VerifyBody(block);
+	// NRD kernels are checked against the chain when the block is applied (see NRDKernelValidator).
+	VerifyBody(block, assumeValid);
 	VerifyKernelLockHeights(block);
 	VerifyCoinbase(block);
 
-	block.MarkAsValidated();
+	// Signatures and proofs were skipped, so the block mustn't be treated as fully validated if it's checked again later.
+	if (!assumeValid)
+	{
+		block.MarkAsValidated();
+	}
 }
 
-void BlockValidator::VerifyBody(const FullBlock& block)
+void BlockValidator::VerifyBody(const FullBlock& block, const bool assumeValid)
 {
 	try
 	{
-		TransactionBodyValidator().Validate(block.GetTransactionBody(), false);
+		if (assumeValid)
+		{
+			TransactionBodyValidator().ValidateStructure(block.GetTransactionBody(), false);
+		}
+		else
+		{
+			TransactionBodyValidator().Validate(block.GetTransactionBody(), false);
+		}
 	}
 	catch (std::exception& e)
 	{
@@ -11,10 +11,13 @@
 class BlockValidator
 {
 public:
-	static void VerifySelfConsistent(const FullBlock& block);
+	//
+	// With assumeValid (for ancestors of the NODE.ASSUME_VALID header), the rangeproofs and kernel signatures aren't verified.
+	//
+	static void VerifySelfConsistent(const FullBlock& block, const bool assumeValid = false);
 
 private:
-	static void VerifyBody(const FullBlock& block);
+	static void VerifyBody(const FullBlock& block, const bool assumeValid);
 	static void VerifyKernelLockHeights(const FullBlock& block);
 	static void VerifyCoinbase(const FullBlock& block);
 };
\ No newline at end of file
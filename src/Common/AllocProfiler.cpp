@@ -0,0 +1,157 @@
+#include <Common/AllocProfiler.h>
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static const std::array<const char*, (size_t)EAllocTag::COUNT> TAG_NAMES = {
+	"untagged",
+	"serializer",
+	"byte_buffer",
+	"pmmr_data",
+	"p2p_messages",
+	"txpool",
+	"wallet_db"
+};
+
+struct AllocTagCounters
+{
+	std::atomic<uint64_t> numAllocs{ 0 };
+	std::atomic<uint64_t> numBytes{ 0 };
+	std::atomic<uint64_t> numFrees{ 0 };
+	std::atomic<uint64_t> liveBytes{ 0 };
+	std::atomic<uint64_t> peakLiveBytes{ 0 };
+};
+
+// Constant-initialized, so they can be used by allocations made before main.
+static std::array<AllocTagCounters, (size_t)EAllocTag::COUNT> COUNTERS;
+static thread_local EAllocTag CURRENT_TAG = EAllocTag::UNTAGGED;
+
+namespace AllocProfilerAPI
+{
+	ALLOC_PROFILER_API bool IsEnabled()
+	{
+#ifdef GRINPP_ALLOC_PROFILING
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	ALLOC_PROFILER_API std::vector<AllocTagStats> GetStats()
+	{
+		std::vector<AllocTagStats> stats;
+		if (!IsEnabled())
+		{
+			return stats;
+		}
+
+		for (size_t i = 0; i < COUNTERS.size(); i++)
+		{
+			const AllocTagCounters& counters = COUNTERS[i];
+			stats.push_back(AllocTagStats{
+				TAG_NAMES[i],
+				counters.numAllocs.load(std::memory_order_relaxed),
+				counters.numBytes.load(std::memory_order_relaxed),
+				counters.numFrees.load(std::memory_order_relaxed),
+				counters.liveBytes.load(std::memory_order_relaxed),
+				counters.peakLiveBytes.load(std::memory_order_relaxed)
+			});
+		}
+
+		return stats;
+	}
+
+	ALLOC_PROFILER_API EAllocTag SetCurrentTag(const EAllocTag tag)
+	{
+		const EAllocTag previous = CURRENT_TAG;
+		CURRENT_TAG = tag;
+		return previous;
+	}
+}
+
+#ifdef GRINPP_ALLOC_PROFILING
+
+//
+// Prefixed to every allocation. Padded to the default new alignment, so the memory after it stays suitably aligned.
+//
+struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) AllocHeader
+{
+	size_t size;
+	EAllocTag tag;
+};
+
+static void* Allocate(const size_t size) noexcept
+{
+	AllocHeader* pHeader = (AllocHeader*)std::malloc(sizeof(AllocHeader) + size);
+	if (pHeader == nullptr)
+	{
+		return nullptr;
+	}
+
+	const EAllocTag tag = CURRENT_TAG;
+	pHeader->size = size;
+	pHeader->tag = tag;
+
+	AllocTagCounters& counters = COUNTERS[(size_t)tag];
+	counters.numAllocs.fetch_add(1, std::memory_order_relaxed);
+	counters.numBytes.fetch_add(size, std::memory_order_relaxed);
+
+	const uint64_t liveBytes = counters.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	uint64_t peakLiveBytes = counters.peakLiveBytes.load(std::memory_order_relaxed);
+	while (liveBytes > peakLiveBytes && !counters.peakLiveBytes.compare_exchange_weak(peakLiveBytes, liveBytes, std::memory_order_relaxed))
+	{
+	}
+
+	return pHeader + 1;
+}
+
+static void* AllocateOrThrow(const size_t size)
+{
+	while (true)
+	{
+		void* pData = Allocate(size);
+		if (pData != nullptr)
+		{
+			return pData;
+		}
+
+		std::new_handler handler = std::get_new_handler();
+		if (handler == nullptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		handler();
+	}
+}
+
+static void Free(void* pData) noexcept
+{
+	if (pData == nullptr)
+	{
+		return;
+	}
+
+	AllocHeader* pHeader = (AllocHeader*)pData - 1;
+	AllocTagCounters& counters = COUNTERS[(size_t)pHeader->tag];
+	counters.numFrees.fetch_add(1, std::memory_order_relaxed);
+	counters.liveBytes.fetch_sub(pHeader->size, std::memory_order_relaxed);
+
+	std::free(pHeader);
+}
+
+// Every replaceable form but the aligned ones, which keep their default implementations and so stay paired with each other.
+void* operator new(std::size_t size) { return AllocateOrThrow(size); }
+void* operator new[](std::size_t size) { return AllocateOrThrow(size); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return Allocate(size); }
+void operator delete(void* pData) noexcept { Free(pData); }
+void operator delete[](void* pData) noexcept { Free(pData); }
+void operator delete(void* pData, std::size_t) noexcept { Free(pData); }
+void operator delete[](void* pData, std::size_t) noexcept { Free(pData); }
+void operator delete(void* pData, const std::nothrow_t&) noexcept { Free(pData); }
+void operator delete[](void* pData, const std::nothrow_t&) noexcept { Free(pData); }
+
+#endif
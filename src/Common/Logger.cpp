@@ -2,10 +2,38 @@
 
 #include <spdlog/spdlog.h>
 #include <Common/Logger.h>
+#include <Common/Metrics.h>
 #include <Common/Util/FileUtil.h>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <memory>
 
+//
+// Counts the messages the async logger's worker takes off the queue, which lets Logger tell how full the queue is without blocking.
+//
+class DequeueCountingSink : public spdlog::sinks::sink
+{
+public:
+	DequeueCountingSink(const std::shared_ptr<spdlog::sinks::sink>& pSink, std::atomic<size_t>& queued)
+		: m_pSink(pSink), m_queued(queued) { }
+
+	void log(const spdlog::details::log_msg& msg) final
+	{
+		m_queued.fetch_sub(1, std::memory_order_relaxed);
+		m_pSink->log(msg);
+	}
+
+	void flush() final
+	{
+		m_pSink->flush();
+	}
+
+private:
+	std::shared_ptr<spdlog::sinks::sink> m_pSink;
+	std::atomic<size_t>& m_queued;
+};
+
 class Logger
 {
 public:
@@ -13,19 +41,57 @@ public:
 
 	void StartLogger(
 		const fs::path& logDirectory,
-		const spdlog::level::level_enum& logLevel
+		const spdlog::level::level_enum& logLevel,
+		const bool blockOnOverflow,
+		const uint32_t callSiteRateLimit
 	);
 	void StopLogger();
 	void Log(const LoggerAPI::LogFile file, const spdlog::level::level_enum logLevel, const std::string& eventText);
+	bool ShouldLog(const LoggerAPI::LogFile file, const spdlog::level::level_enum logLevel);
+	bool IsAllowed(const LoggerAPI::LogFile file, LoggerAPI::CallSite& callSite);
 	void Flush();
 
 private:
-	Logger() = default;
+	//
+	// An async log and its queue. Messages are counted as they're queued and as the worker takes them off,
+	// so when overflowing messages are dropped, it's done before spdlog would block.
+	//
+	struct AsyncLog
+	{
+		AsyncLog(const std::string& name)
+			: queued(0),
+			capacity(0),
+			pOverflowed(&MetricsAPI::RegisterCounter(DROPPED_METRIC, DROPPED_HELP, Labels(name, "overflow"))),
+			pRateLimited(&MetricsAPI::RegisterCounter(DROPPED_METRIC, DROPPED_HELP, Labels(name, "rate_limited"))) { }
+
+		std::shared_ptr<spdlog::logger> pLogger;
+		std::atomic<size_t> queued;
+		size_t capacity;
+		MetricCounter* pOverflowed;
+		MetricCounter* pRateLimited;
+	};
+
+	static constexpr const char* DROPPED_METRIC = "grin_log_messages_dropped_total";
+	static constexpr const char* DROPPED_HELP = "Log messages discarded instead of logged, by log and reason.";
 
-	std::shared_ptr<spdlog::logger> GetLogger(const LoggerAPI::LogFile file);
+	// Room left in the queue for flush requests, which aren't counted.
+	static constexpr size_t FLUSH_HEADROOM = 64;
 
-	std::shared_ptr<spdlog::logger> m_pNodeLogger;
-	std::shared_ptr<spdlog::logger> m_pWalletLogger;
+	Logger() : m_node("node"), m_wallet("wallet"), m_blockOnOverflow(true), m_callSiteRateLimit(0) { }
+
+	static std::string Labels(const std::string& log, const std::string& reason)
+	{
+		return MetricsWriter::Label("log", log) + "," + MetricsWriter::Label("reason", reason);
+	}
+
+	void Start(AsyncLog& log, const fs::path& logPath, const std::string& name, const size_t queueSize, const spdlog::level::level_enum& logLevel);
+
+	AsyncLog& GetLog(const LoggerAPI::LogFile file);
+
+	AsyncLog m_node;
+	AsyncLog m_wallet;
+	bool m_blockOnOverflow;
+	uint32_t m_callSiteRateLimit;
 };
 
 Logger& Logger::GetInstance()
@@ -34,30 +100,35 @@ Logger& Logger::GetInstance()
 	return instance;
 }
 
-void Logger::StartLogger(const fs::path& logDirectory, const spdlog::level::level_enum& logLevel)
+void Logger::StartLogger(
+	const fs::path& logDirectory,
+	const spdlog::level::level_enum& logLevel,
+	const bool blockOnOverflow,
+	const uint32_t callSiteRateLimit)
 {
 	FileUtil::CreateDirectories(logDirectory);
 
-	if (m_pNodeLogger == nullptr)
-	{
-		const fs::path logPath = logDirectory / "Node.log";
-		auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(StringUtil::ToWide(logPath.u8string()), 5 * 1024 * 1024, 10);
-		m_pNodeLogger = spdlog::create_async("NODE", sink, 32768, spdlog::async_overflow_policy::block_retry, nullptr, std::chrono::seconds(5));
-		spdlog::set_pattern("[%D %X.%e%z] [%l] %v");
-		if (m_pNodeLogger != nullptr)
-		{
-			m_pNodeLogger->set_level(logLevel);
-		}
-	}
-	if (m_pWalletLogger == nullptr)
+	m_blockOnOverflow = blockOnOverflow;
+	m_callSiteRateLimit = callSiteRateLimit;
+
+	Start(m_node, logDirectory / "Node.log", "NODE", 32768, logLevel);
+	Start(m_wallet, logDirectory / "Wallet.log", "WALLET", 8192, logLevel);
+}
+
+void Logger::Start(AsyncLog& log, const fs::path& logPath, const std::string& name, const size_t queueSize, const spdlog::level::level_enum& logLevel)
+{
+	if (log.pLogger == nullptr)
 	{
-		const fs::path logPath = logDirectory / "Wallet.log";
-		auto sink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(StringUtil::ToWide(logPath.u8string()), 5 * 1024 * 1024, 10);
-		m_pWalletLogger = spdlog::create_async("WALLET", sink, 8192, spdlog::async_overflow_policy::block_retry, nullptr, std::chrono::seconds(5));
+		auto fileSink = std::make_shared<spdlog::sinks::rotating_file_sink_mt>(StringUtil::ToWide(logPath.u8string()), 5 * 1024 * 1024, 10);
+		auto sink = std::make_shared<DequeueCountingSink>(fileSink, log.queued);
+
+		// A message that doesn't fit is dropped by Log before reaching spdlog, so the queue only ever fills up when blocking is preferred.
+		log.capacity = queueSize - FLUSH_HEADROOM;
+		log.pLogger = spdlog::create_async(name, sink, queueSize, spdlog::async_overflow_policy::block_retry, nullptr, std::chrono::seconds(5));
 		spdlog::set_pattern("[%D %X.%e%z] [%l] %v");
-		if (m_pWalletLogger != nullptr)
+		if (log.pLogger != nullptr)
 		{
-			m_pWalletLogger->set_level(logLevel);
+			log.pLogger->set_level(logLevel);
 		}
 	}
 }
@@ -65,15 +136,23 @@ void Logger::StartLogger(const fs::path& logDirectory, const spdlog::level::leve
 void Logger::StopLogger()
 {
 	Flush();
-	m_pNodeLogger.reset();
-	m_pWalletLogger.reset();
+	m_node.pLogger.reset();
+	m_wallet.pLogger.reset();
 }
 
 void Logger::Log(const LoggerAPI::LogFile file, const spdlog::level::level_enum logLevel, const std::string& eventText)
 {
-	auto pLogger = GetLogger(file);
-	if (pLogger != nullptr)
+	AsyncLog& log = GetLog(file);
+	auto pLogger = log.pLogger;
+	if (pLogger != nullptr && pLogger->should_log(logLevel))
 	{
+		if (log.queued.fetch_add(1, std::memory_order_relaxed) >= log.capacity && !m_blockOnOverflow)
+		{
+			log.queued.fetch_sub(1, std::memory_order_relaxed);
+			log.pOverflowed->Add();
+			return;
+		}
+
 		std::string eventTextClean = eventText;
 		size_t newlinePos = eventTextClean.find("\n");
 		while (newlinePos != std::string::npos)
@@ -100,34 +179,68 @@ void Logger::Log(const LoggerAPI::LogFile file, const spdlog::level::level_enum
 	}
 }
 
+bool Logger::ShouldLog(const LoggerAPI::LogFile file, const spdlog::level::level_enum logLevel)
+{
+	auto pLogger = GetLog(file).pLogger;
+	return pLogger != nullptr && pLogger->should_log(logLevel);
+}
+
+bool Logger::IsAllowed(const LoggerAPI::LogFile file, LoggerAPI::CallSite& callSite)
+{
+	if (m_callSiteRateLimit == 0)
+	{
+		return true;
+	}
+
+	// Whichever thread sees a new window first resets the count. Racing threads may let a few extra messages through, which is fine.
+	const int64_t window = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	int64_t currentWindow = callSite.window.load(std::memory_order_relaxed);
+	if (currentWindow != window && callSite.window.compare_exchange_strong(currentWindow, window, std::memory_order_relaxed))
+	{
+		callSite.count.store(0, std::memory_order_relaxed);
+	}
+
+	if (callSite.count.fetch_add(1, std::memory_order_relaxed) < m_callSiteRateLimit)
+	{
+		return true;
+	}
+
+	GetLog(file).pRateLimited->Add();
+	return false;
+}
+
 void Logger::Flush()
 {
-	if (m_pNodeLogger != nullptr)
+	if (m_node.pLogger != nullptr)
 	{
-		m_pNodeLogger->flush();
+		m_node.pLogger->flush();
 	}
 
-	if (m_pWalletLogger != nullptr)
+	if (m_wallet.pLogger != nullptr)
 	{
-		m_pWalletLogger->flush();
+		m_wallet.pLogger->flush();
 	}
 }
 
-std::shared_ptr<spdlog::logger> Logger::GetLogger(const LoggerAPI::LogFile file)
+Logger::AsyncLog& Logger::GetLog(const LoggerAPI::LogFile file)
 {
 	if (file == LoggerAPI::LogFile::WALLET)
 	{
-		return m_pWalletLogger;
+		return m_wallet;
 	}
 	else
 	{
-		return m_pNodeLogger;
+		return m_node;
 	}
 }
 
 namespace LoggerAPI
 {
-	LOGGER_API void Initialize(const fs::path& logDirectory, const std::string& logLevel)
+	LOGGER_API void Initialize(
+		const fs::path& logDirectory,
+		const std::string& logLevel,
+		const bool blockOnOverflow,
+		const uint32_t callSiteRateLimit)
 	{
 		spdlog::level::level_enum logLevelEnum = spdlog::level::level_enum::debug;
 		if (logLevel == "TRACE")
@@ -151,7 +264,7 @@ namespace LoggerAPI
 			logLevelEnum = spdlog::level::level_enum::err;
 		}
 
-		Logger::GetInstance().StartLogger(logDirectory, logLevelEnum);
+		Logger::GetInstance().StartLogger(logDirectory, logLevelEnum, blockOnOverflow, callSiteRateLimit);
 	}
 
 	LOGGER_API void Shutdown()
@@ -189,6 +302,21 @@ namespace LoggerAPI
 		Logger::GetInstance().Flush();
 	}
 
+	LOGGER_API bool IsTraceEnabled(const LogFile file)
+	{
+		return Logger::GetInstance().ShouldLog(file, spdlog::level::level_enum::trace);
+	}
+
+	LOGGER_API bool IsDebugEnabled(const LogFile file)
+	{
+		return Logger::GetInstance().ShouldLog(file, spdlog::level::level_enum::debug);
+	}
+
+	LOGGER_API bool IsAllowed(const LogFile file, CallSite& callSite)
+	{
+		return Logger::GetInstance().IsAllowed(file, callSite);
+	}
+
 
 	LOGGER_API void LogTrace(const LogFile file, const std::string& function, const size_t line, const std::string& message)
 	{
@@ -0,0 +1,147 @@
+#include <Common/MemoryBudget.h>
+#include <Common/Logger.h>
+
+#include <algorithm>
+#include <mutex>
+
+class MemoryBudget
+{
+public:
+	static MemoryBudget& GetInstance()
+	{
+		static MemoryBudget budget;
+		return budget;
+	}
+
+	uint64_t Register(MemoryConsumer&& consumer)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		const uint64_t id = m_nextId++;
+		m_consumers.push_back(Entry{ id, std::move(consumer), 0 });
+		Apportion();
+
+		return id;
+	}
+
+	void Unregister(const uint64_t id)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		// The remaining consumers keep their limits until the budget next changes, so unregistering never grows a cache unexpectedly.
+		m_consumers.erase(
+			std::remove_if(m_consumers.begin(), m_consumers.end(), [id](const Entry& entry) { return entry.id == id; }),
+			m_consumers.end()
+		);
+	}
+
+	void SetBudget(const size_t budgetBytes)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		m_budgetBytes = budgetBytes;
+		if (budgetBytes == 0)
+		{
+			for (Entry& entry : m_consumers)
+			{
+				entry.limitBytes = 0;
+			}
+		}
+
+		Apportion();
+	}
+
+	size_t GetBudget() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_budgetBytes;
+	}
+
+	std::vector<MemoryConsumerStats> GetStats() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		std::vector<MemoryConsumerStats> stats;
+		for (const Entry& entry : m_consumers)
+		{
+			stats.push_back(MemoryConsumerStats{
+				entry.consumer.name,
+				entry.consumer.priority,
+				entry.limitBytes,
+				entry.consumer.getUsage()
+			});
+		}
+
+		return stats;
+	}
+
+private:
+	struct Entry
+	{
+		uint64_t id;
+		MemoryConsumer consumer;
+		size_t limitBytes;
+	};
+
+	MemoryBudget() : m_budgetBytes(0), m_nextId(0) { }
+
+	// Must be called holding the lock.
+	void Apportion()
+	{
+		if (m_budgetBytes == 0)
+		{
+			return;
+		}
+
+		uint64_t totalPriority = 0;
+		for (const Entry& entry : m_consumers)
+		{
+			totalPriority += entry.consumer.priority;
+		}
+
+		for (Entry& entry : m_consumers)
+		{
+			const size_t share = totalPriority == 0 ? 0 : (size_t)(((double)m_budgetBytes * entry.consumer.priority) / totalPriority);
+			const size_t limitBytes = (std::max)(share, entry.consumer.minBytes);
+			if (limitBytes != entry.limitBytes)
+			{
+				LOG_DEBUG_F("Limiting {} to {}KB", entry.consumer.name, limitBytes / 1024);
+				entry.consumer.setLimit(limitBytes);
+				entry.limitBytes = limitBytes;
+			}
+		}
+	}
+
+	mutable std::mutex m_mutex;
+	size_t m_budgetBytes;
+	uint64_t m_nextId;
+	std::vector<Entry> m_consumers;
+};
+
+MemoryBudgetRegistration::~MemoryBudgetRegistration()
+{
+	MemoryBudget::GetInstance().Unregister(m_id);
+}
+
+namespace MemoryBudgetAPI
+{
+	MemoryBudgetRegistration::UPtr Register(MemoryConsumer&& consumer)
+	{
+		return std::make_unique<MemoryBudgetRegistration>(MemoryBudget::GetInstance().Register(std::move(consumer)));
+	}
+
+	void SetBudget(const size_t budgetBytes)
+	{
+		MemoryBudget::GetInstance().SetBudget(budgetBytes);
+	}
+
+	size_t GetBudget()
+	{
+		return MemoryBudget::GetInstance().GetBudget();
+	}
+
+	std::vector<MemoryConsumerStats> GetStats()
+	{
+		return MemoryBudget::GetInstance().GetStats();
+	}
+}
@@ -0,0 +1,198 @@
+#include <Common/Metrics.h>
+#include <fmt/format.h>
+#include <algorithm>
+#include <mutex>
+
+std::string MetricsWriter::Label(const std::string& name, const std::string& value)
+{
+	std::string escaped;
+	for (const char c : value)
+	{
+		if (c == '\\' || c == '"')
+		{
+			escaped += '\\';
+			escaped += c;
+		}
+		else if (c == '\n')
+		{
+			escaped += "\\n";
+		}
+		else
+		{
+			escaped += c;
+		}
+	}
+
+	return name + "=\"" + escaped + "\"";
+}
+
+void MetricsWriter::AddCounter(const std::string& name, const std::string& help, const std::string& labels, const uint64_t value)
+{
+	AddFamily(name, help, "counter");
+	AddSample(name, labels, std::to_string(value));
+}
+
+void MetricsWriter::AddGauge(const std::string& name, const std::string& help, const std::string& labels, const double value)
+{
+	AddFamily(name, help, "gauge");
+	AddSample(name, labels, fmt::format("{}", value));
+}
+
+void MetricsWriter::AddHistogram(const std::string& name, const std::string& help, const std::string& labels, const MetricHistogram& histogram)
+{
+	AddFamily(name, help, "histogram");
+
+	const std::string separator = labels.empty() ? "" : ",";
+	const std::vector<double>& bounds = histogram.GetBounds();
+
+	uint64_t count = 0;
+	for (size_t i = 0; i <= bounds.size(); i++)
+	{
+		count += histogram.GetBucketCount(i);
+
+		const std::string bound = i < bounds.size() ? fmt::format("{}", bounds[i]) : "+Inf";
+		AddSample(name + "_bucket", labels + separator + "le=\"" + bound + "\"", std::to_string(count));
+	}
+
+	AddSample(name + "_sum", labels, fmt::format("{}", histogram.GetSum()));
+	AddSample(name + "_count", labels, std::to_string(count));
+}
+
+void MetricsWriter::AddFamily(const std::string& name, const std::string& help, const std::string& type)
+{
+	if (name != m_lastFamily)
+	{
+		m_text += "# HELP " + name + " " + help + "\n";
+		m_text += "# TYPE " + name + " " + type + "\n";
+		m_lastFamily = name;
+	}
+}
+
+void MetricsWriter::AddSample(const std::string& name, const std::string& labels, const std::string& value)
+{
+	m_text += name;
+	if (!labels.empty())
+	{
+		m_text += "{" + labels + "}";
+	}
+
+	m_text += " " + value + "\n";
+}
+
+class MetricsRegistry
+{
+public:
+	static MetricsRegistry& GetInstance()
+	{
+		static MetricsRegistry registry;
+		return registry;
+	}
+
+	MetricCounter& RegisterCounter(const std::string& name, const std::string& help, const std::string& labels)
+	{
+		Entry& entry = Register(name, help, labels, [](Entry& newEntry) { newEntry.pCounter = std::make_unique<MetricCounter>(); });
+		return *entry.pCounter;
+	}
+
+	MetricGauge& RegisterGauge(const std::string& name, const std::string& help, const std::string& labels)
+	{
+		Entry& entry = Register(name, help, labels, [](Entry& newEntry) { newEntry.pGauge = std::make_unique<MetricGauge>(); });
+		return *entry.pGauge;
+	}
+
+	MetricHistogram& RegisterHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds, const std::string& labels)
+	{
+		Entry& entry = Register(name, help, labels, [&bounds](Entry& newEntry) { newEntry.pHistogram = std::make_unique<MetricHistogram>(bounds); });
+		return *entry.pHistogram;
+	}
+
+	void Write(MetricsWriter& writer) const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		std::vector<const Entry*> entries;
+		for (const std::unique_ptr<Entry>& pEntry : m_entries)
+		{
+			entries.push_back(pEntry.get());
+		}
+
+		// Stable, so labels keep the order they were registered in.
+		std::stable_sort(entries.begin(), entries.end(), [](const Entry* pLeft, const Entry* pRight) { return pLeft->name < pRight->name; });
+
+		for (const Entry* pEntry : entries)
+		{
+			if (pEntry->pCounter != nullptr)
+			{
+				writer.AddCounter(pEntry->name, pEntry->help, pEntry->labels, pEntry->pCounter->Get());
+			}
+			else if (pEntry->pGauge != nullptr)
+			{
+				writer.AddGauge(pEntry->name, pEntry->help, pEntry->labels, (double)pEntry->pGauge->Get());
+			}
+			else if (pEntry->pHistogram != nullptr)
+			{
+				writer.AddHistogram(pEntry->name, pEntry->help, pEntry->labels, *pEntry->pHistogram);
+			}
+		}
+	}
+
+private:
+	struct Entry
+	{
+		std::string name;
+		std::string help;
+		std::string labels;
+		std::unique_ptr<MetricCounter> pCounter;
+		std::unique_ptr<MetricGauge> pGauge;
+		std::unique_ptr<MetricHistogram> pHistogram;
+	};
+
+	template<typename Create>
+	Entry& Register(const std::string& name, const std::string& help, const std::string& labels, const Create& create)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		auto iter = std::find_if(m_entries.begin(), m_entries.end(), [&name, &labels](const std::unique_ptr<Entry>& pEntry) {
+			return pEntry->name == name && pEntry->labels == labels;
+		});
+		if (iter != m_entries.end())
+		{
+			return **iter;
+		}
+
+		auto pEntry = std::make_unique<Entry>();
+		pEntry->name = name;
+		pEntry->help = help;
+		pEntry->labels = labels;
+		create(*pEntry);
+
+		m_entries.push_back(std::move(pEntry));
+		return *m_entries.back();
+	}
+
+	mutable std::mutex m_mutex;
+	std::vector<std::unique_ptr<Entry>> m_entries;
+};
+
+namespace MetricsAPI
+{
+	MetricCounter& RegisterCounter(const std::string& name, const std::string& help, const std::string& labels)
+	{
+		return MetricsRegistry::GetInstance().RegisterCounter(name, help, labels);
+	}
+
+	MetricGauge& RegisterGauge(const std::string& name, const std::string& help, const std::string& labels)
+	{
+		return MetricsRegistry::GetInstance().RegisterGauge(name, help, labels);
+	}
+
+	MetricHistogram& RegisterHistogram(const std::string& name, const std::string& help, const std::vector<double>& bounds, const std::string& labels)
+	{
+		return MetricsRegistry::GetInstance().RegisterHistogram(name, help, bounds, labels);
+	}
+
+	void Write(MetricsWriter& writer)
+	{
+		MetricsRegistry::GetInstance().Write(writer);
+	}
+}
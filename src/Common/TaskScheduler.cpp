@@ -0,0 +1,398 @@
+#include <Common/TaskScheduler.h>
+#include <Common/Util/ThreadUtil.h>
+#include <Common/Logger.h>
+#include <algorithm>
+
+static std::mutex SCHEDULERS_MUTEX;
+static std::vector<const TaskScheduler*> SCHEDULERS;
+
+static uint64_t ToMicros(const std::chrono::steady_clock::duration& duration)
+{
+	return duration.count() > 0 ? (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(duration).count() : 0;
+}
+
+TaskScheduler::TaskScheduler(const std::chrono::milliseconds& tickDuration)
+	: m_tickDuration((std::max)(tickDuration, std::chrono::milliseconds(1))),
+	m_start(std::chrono::steady_clock::now()),
+	m_currentTick(0),
+	m_nextId(1),
+	m_numRunning(0),
+	m_stopping(false)
+{
+	m_wheel[0].resize((size_t)1 << LEVEL0_BITS);
+	for (size_t level = 1; level < NUM_LEVELS; level++)
+	{
+		m_wheel[level].resize((size_t)1 << LEVELN_BITS);
+	}
+
+	std::unique_lock<std::mutex> lock(SCHEDULERS_MUTEX);
+	SCHEDULERS.push_back(this);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+	Stop();
+
+	std::unique_lock<std::mutex> lock(SCHEDULERS_MUTEX);
+	SCHEDULERS.erase(std::remove(SCHEDULERS.begin(), SCHEDULERS.end(), this), SCHEDULERS.end());
+}
+
+TaskScheduler::Ptr TaskScheduler::Create(const std::chrono::milliseconds& tickDuration, const size_t numThreads)
+{
+	auto pScheduler = std::shared_ptr<TaskScheduler>(new TaskScheduler(tickDuration));
+	pScheduler->m_pPool = ThreadPool::Create("SCHEDULED", numThreads);
+	pScheduler->m_driverThread = std::thread(Thread_Tick, std::ref(*pScheduler));
+	return pScheduler;
+}
+
+void TaskScheduler::Stop()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_stopping = true;
+		for (auto& entry : m_tasks)
+		{
+			entry.second->removed = true;
+		}
+
+		m_tasks.clear();
+	}
+
+	m_wakeDriver.notify_all();
+	ThreadUtil::Join(m_driverThread);
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_runFinished.wait(lock, [this] { return m_numRunning == 0; });
+	}
+
+	if (m_pPool != nullptr)
+	{
+		m_pPool->Stop();
+	}
+}
+
+TaskScheduler::TaskId TaskScheduler::Interval(
+	const std::string& name,
+	const std::chrono::milliseconds& period,
+	std::function<void()>&& task,
+	const ETaskPriority priority)
+{
+	auto pTask = std::make_shared<Task>();
+	pTask->name = name;
+	pTask->priority = priority;
+	pTask->func = [task = std::move(task), period]() { task(); return period; };
+	pTask->periodTicks = (std::max)((uint64_t)1, (uint64_t)((period.count() + m_tickDuration.count() - 1) / m_tickDuration.count()));
+	pTask->lastDelay = period;
+
+	return AddTask(std::move(pTask), period);
+}
+
+TaskScheduler::TaskId TaskScheduler::Schedule(
+	const std::string& name,
+	const std::chrono::milliseconds& delay,
+	std::function<std::chrono::milliseconds()>&& task,
+	const ETaskPriority priority)
+{
+	auto pTask = std::make_shared<Task>();
+	pTask->name = name;
+	pTask->priority = priority;
+	pTask->func = std::move(task);
+	pTask->periodTicks = 0;
+	pTask->lastDelay = delay;
+
+	return AddTask(std::move(pTask), delay);
+}
+
+TaskScheduler::TaskId TaskScheduler::AddTask(TaskPtr&& pTask, const std::chrono::milliseconds& delay)
+{
+	const auto now = std::chrono::steady_clock::now();
+
+	pTask->removed = false;
+	pTask->running = false;
+	pTask->stats = ScheduledTaskStats{ pTask->name, 0, 0, 0, 0, 0, 0 };
+
+	TaskId taskId = 0;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		// The driver doesn't tick while there's nothing scheduled, so the wheel is first brought up to date.
+		// Whatever is left in it belongs to removed tasks, which are skipped wherever the wheel ends up.
+		if (m_tasks.empty())
+		{
+			m_currentTick = (std::max)(m_currentTick, GetElapsedTicks(now));
+		}
+
+		taskId = m_nextId++;
+		pTask->id = taskId;
+		pTask->expiryTick = GetExpiryTick(now + delay);
+		Insert(pTask);
+		m_tasks[taskId] = std::move(pTask);
+	}
+
+	m_wakeDriver.notify_all();
+	return taskId;
+}
+
+void TaskScheduler::RemoveTask(const TaskId taskId)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = m_tasks.find(taskId);
+	if (iter == m_tasks.end())
+	{
+		return;
+	}
+
+	// Its entry is left in the wheel, and dropped when its slot is next expired or cascaded.
+	TaskPtr pTask = iter->second;
+	pTask->removed = true;
+	m_tasks.erase(iter);
+
+	if (pTask->runningThread != std::this_thread::get_id())
+	{
+		m_runFinished.wait(lock, [&pTask] { return !pTask->running; });
+	}
+}
+
+std::vector<ScheduledTaskStats> TaskScheduler::GetStats() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	std::vector<ScheduledTaskStats> stats;
+	for (const auto& entry : m_tasks)
+	{
+		stats.push_back(entry.second->stats);
+	}
+
+	return stats;
+}
+
+std::vector<ScheduledTaskStats> TaskScheduler::GetAllStats()
+{
+	std::unique_lock<std::mutex> lock(SCHEDULERS_MUTEX);
+
+	std::vector<ScheduledTaskStats> stats;
+	for (const TaskScheduler* pScheduler : SCHEDULERS)
+	{
+		const std::vector<ScheduledTaskStats> schedulerStats = pScheduler->GetStats();
+		stats.insert(stats.end(), schedulerStats.begin(), schedulerStats.end());
+	}
+
+	return stats;
+}
+
+uint64_t TaskScheduler::GetElapsedTicks(const std::chrono::steady_clock::time_point& time) const
+{
+	if (time <= m_start)
+	{
+		return 0;
+	}
+
+	return (uint64_t)((time - m_start) / m_tickDuration);
+}
+
+uint64_t TaskScheduler::GetExpiryTick(const std::chrono::steady_clock::time_point& time) const
+{
+	const uint64_t elapsedTicks = GetElapsedTicks(time);
+	return GetTickTime(elapsedTicks) < time ? elapsedTicks + 1 : elapsedTicks;
+}
+
+std::chrono::steady_clock::time_point TaskScheduler::GetTickTime(const uint64_t tick) const
+{
+	return m_start + m_tickDuration * (int64_t)tick;
+}
+
+//
+// Adds the task to the finest level whose revolution reaches its expiry.
+// A task that's already due goes into the slot of the current tick, to be expired next.
+//
+void TaskScheduler::Insert(const TaskPtr& pTask)
+{
+	pTask->expiryTick = (std::max)(pTask->expiryTick, m_currentTick);
+	pTask->expiryTick = (std::min)(pTask->expiryTick, m_currentTick + MAX_TICKS);
+
+	const uint64_t ticksRemaining = pTask->expiryTick - m_currentTick;
+
+	size_t level = 0;
+	size_t shift = 0;
+	while (level + 1 < NUM_LEVELS && ticksRemaining >= ((uint64_t)1 << (LEVEL0_BITS + LEVELN_BITS * level)))
+	{
+		shift = LEVEL0_BITS + LEVELN_BITS * level;
+		level++;
+	}
+
+	std::vector<std::vector<TaskPtr>>& slots = m_wheel[level];
+	slots[(size_t)(pTask->expiryTick >> shift) & (slots.size() - 1)].push_back(pTask);
+}
+
+//
+// Re-adds the tasks of the level's current slot, which all expire within its revolution, to the finer levels.
+// Returns the slot's index, so the next level is only cascaded once this one wraps around.
+//
+size_t TaskScheduler::Cascade(const size_t level)
+{
+	const size_t shift = LEVEL0_BITS + LEVELN_BITS * (level - 1);
+	const size_t index = (size_t)(m_currentTick >> shift) & (((size_t)1 << LEVELN_BITS) - 1);
+
+	std::vector<TaskPtr> tasks;
+	tasks.swap(m_wheel[level][index]);
+	for (const TaskPtr& pTask : tasks)
+	{
+		if (!pTask->removed)
+		{
+			Insert(pTask);
+		}
+	}
+
+	return index;
+}
+
+void TaskScheduler::ExpireTick(std::vector<DueRun>& dueRuns)
+{
+	const size_t index = (size_t)m_currentTick & (((size_t)1 << LEVEL0_BITS) - 1);
+	if (index == 0)
+	{
+		size_t level = 1;
+		while (level < NUM_LEVELS && Cascade(level) == 0)
+		{
+			level++;
+		}
+	}
+
+	std::vector<TaskPtr> tasks;
+	tasks.swap(m_wheel[0][index]);
+
+	const auto dueTime = GetTickTime(m_currentTick);
+	for (const TaskPtr& pTask : tasks)
+	{
+		if (pTask->removed)
+		{
+			continue;
+		}
+
+		if (pTask->running)
+		{
+			++pTask->stats.overruns;
+		}
+		else
+		{
+			pTask->running = true;
+			++m_numRunning;
+			dueRuns.push_back(DueRun{ pTask, dueTime });
+		}
+
+		// Interval tasks stay on a fixed schedule, however long their runs take.
+		// Schedule tasks are re-added once their run has returned the next delay.
+		if (pTask->periodTicks > 0)
+		{
+			pTask->expiryTick = m_currentTick + pTask->periodTicks;
+			Insert(pTask);
+		}
+	}
+
+	++m_currentTick;
+}
+
+void TaskScheduler::Run(const DueRun& dueRun)
+{
+	Task& task = *dueRun.pTask;
+
+	bool removed = false;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		removed = task.removed;
+		task.runningThread = std::this_thread::get_id();
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	std::chrono::milliseconds nextDelay = task.lastDelay;
+	if (!removed)
+	{
+		try
+		{
+			ThreadActivity activity(task.name.c_str());
+			nextDelay = task.func();
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR_F("Exception thrown by scheduled task {}: {}", task.name, e.what());
+		}
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (!removed)
+		{
+			const uint64_t runMicros = ToMicros(end - start);
+			const uint64_t lagMicros = ToMicros(start - dueRun.dueTime);
+
+			ScheduledTaskStats& stats = task.stats;
+			++stats.runs;
+			stats.totalRunMicros += runMicros;
+			stats.maxRunMicros = (std::max)(stats.maxRunMicros, runMicros);
+			stats.totalLagMicros += lagMicros;
+			stats.maxLagMicros = (std::max)(stats.maxLagMicros, lagMicros);
+		}
+
+		task.running = false;
+		task.runningThread = std::thread::id();
+
+		if (!task.removed && task.periodTicks == 0)
+		{
+			task.lastDelay = nextDelay;
+			task.expiryTick = GetExpiryTick(end + nextDelay);
+			Insert(dueRun.pTask);
+		}
+
+		--m_numRunning;
+
+		// Notified under the lock, since Stop may return and the scheduler be destroyed as soon as it's released.
+		m_runFinished.notify_all();
+	}
+}
+
+void TaskScheduler::Thread_Tick(TaskScheduler& scheduler)
+{
+	ThreadManagerAPI::SetCurrentThreadName("SCHEDULER");
+	LOG_TRACE("BEGIN");
+
+	std::unique_lock<std::mutex> lock(scheduler.m_mutex);
+	while (!scheduler.m_stopping)
+	{
+		std::vector<DueRun> dueRuns;
+		const uint64_t elapsedTicks = scheduler.GetElapsedTicks(std::chrono::steady_clock::now());
+		while (scheduler.m_currentTick <= elapsedTicks)
+		{
+			scheduler.ExpireTick(dueRuns);
+		}
+
+		if (!dueRuns.empty())
+		{
+			// Posted without the lock, since a stopping pool runs tasks on the caller's thread.
+			lock.unlock();
+			for (const DueRun& dueRun : dueRuns)
+			{
+				scheduler.m_pPool->Post([&scheduler, dueRun]() { scheduler.Run(dueRun); }, dueRun.pTask->priority);
+			}
+			lock.lock();
+			continue;
+		}
+
+		ThreadWait wait;
+		if (scheduler.m_tasks.empty())
+		{
+			scheduler.m_wakeDriver.wait(lock, [&scheduler] { return scheduler.m_stopping || !scheduler.m_tasks.empty(); });
+		}
+		else
+		{
+			scheduler.m_wakeDriver.wait_until(lock, scheduler.GetTickTime(scheduler.m_currentTick));
+		}
+	}
+
+	LOG_TRACE("END");
+}
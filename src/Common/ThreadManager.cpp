@@ -1,9 +1,140 @@
 #include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <Common/Compat.h>
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <thread>
 #include <unordered_map>
 #include <shared_mutex>
 
+#if defined(__APPLE__)
+#include <mach/mach.h>
+#include <pthread.h>
+#elif !defined(_WIN32)
+#include <pthread.h>
+#include <time.h>
+#endif
+
+//
+// Reads a thread's CPU time (user and kernel) from the OS. Opened by the thread itself, but can be read from any thread while it's alive.
+//
+class ThreadCpuClock
+{
+public:
+	ThreadCpuClock()
+	{
+#if defined(_WIN32)
+		m_handle = OpenThread(THREAD_QUERY_LIMITED_INFORMATION, FALSE, GetCurrentThreadId());
+#elif defined(__APPLE__)
+		m_port = pthread_mach_thread_np(pthread_self());
+#else
+		m_valid = pthread_getcpuclockid(pthread_self(), &m_clock) == 0;
+#endif
+	}
+
+	~ThreadCpuClock()
+	{
+#if defined(_WIN32)
+		if (m_handle != NULL)
+		{
+			CloseHandle(m_handle);
+		}
+#endif
+	}
+
+	ThreadCpuClock(const ThreadCpuClock&) = delete;
+	ThreadCpuClock& operator=(const ThreadCpuClock&) = delete;
+
+	uint64_t GetMicros() const
+	{
+#if defined(_WIN32)
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		if (m_handle == NULL || !GetThreadTimes(m_handle, &creationTime, &exitTime, &kernelTime, &userTime))
+		{
+			return 0;
+		}
+
+		// FILETIMEs are in 100ns units.
+		auto toMicros = [](const FILETIME& time) { return ((((uint64_t)time.dwHighDateTime) << 32) | time.dwLowDateTime) / 10; };
+		return toMicros(kernelTime) + toMicros(userTime);
+#elif defined(__APPLE__)
+		thread_basic_info_data_t info;
+		mach_msg_type_number_t count = THREAD_BASIC_INFO_COUNT;
+		if (thread_info(m_port, THREAD_BASIC_INFO, (thread_info_t)&info, &count) != KERN_SUCCESS)
+		{
+			return 0;
+		}
+
+		return ((uint64_t)info.user_time.seconds + info.system_time.seconds) * 1'000'000
+			+ (uint64_t)info.user_time.microseconds + info.system_time.microseconds;
+#else
+		struct timespec time;
+		if (!m_valid || clock_gettime(m_clock, &time) != 0)
+		{
+			return 0;
+		}
+
+		return ((uint64_t)time.tv_sec * 1'000'000) + ((uint64_t)time.tv_nsec / 1000);
+#endif
+	}
+
+private:
+#if defined(_WIN32)
+	HANDLE m_handle;
+#elif defined(__APPLE__)
+	mach_port_t m_port;
+#else
+	clockid_t m_clock;
+	bool m_valid;
+#endif
+};
+
+//
+// A named thread's accounting. Only the thread itself writes to it, so waits and activity tags don't need the manager's lock.
+//
+struct ThreadRecord
+{
+	using Ptr = std::shared_ptr<ThreadRecord>;
+
+	ThreadRecord(const std::string& name_, const std::string& displayName_)
+		: name(name_), displayName(displayName_), started(std::chrono::steady_clock::now()), cpuAtStart(cpuClock.GetMicros()), waitMicros(0), pActivity(nullptr) { }
+
+	// The clock counts from the thread's creation, which may be before it was (re)named.
+	uint64_t GetCpuMicros() const
+	{
+		return cpuClock.GetMicros() - cpuAtStart;
+	}
+
+	uint64_t GetWallMicros() const
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+	}
+
+	std::string name;
+	std::string displayName;
+	ThreadCpuClock cpuClock;
+	std::chrono::steady_clock::time_point started;
+	uint64_t cpuAtStart;
+	std::atomic<uint64_t> waitMicros;
+	std::atomic<const char*> pActivity;
+};
+
+//
+// Folds the current thread's record into its name's totals when the thread exits, while its CPU clock can still be read.
+//
+struct ThreadRegistration
+{
+	~ThreadRegistration();
+
+	ThreadRecord::Ptr pRecord;
+};
+
+static thread_local ThreadRegistration CURRENT_THREAD;
+
 class ThreadManager
 {
 public:
@@ -14,11 +145,72 @@ public:
 	void SetThreadName(const std::thread::id& threadId, const std::string& threadName);
 	void SetCurrentThreadName(const std::string& threadName);
 
+	void ConfigureThreadPool(const size_t numThreads);
+	ThreadPool& GetThreadPool();
+
+	void ConfigureLatencyThreadPool(const size_t numThreads);
+	ThreadPool& GetLatencyThreadPool();
+
+	void ConfigureCpuAffinity(const std::map<std::string, std::vector<size_t>>& cpuSets);
+
+	std::vector<ThreadStats> GetThreadStats() const;
+	std::vector<ThreadGroupStats> GetThreadGroupStats() const;
+	void OnThreadExit(const ThreadRecord::Ptr& pRecord);
+
 private:
+	// Must be called holding the names lock.
+	void RegisterCurrentThread(const std::string& threadName, const std::string& displayName);
+	void AddToExited(const ThreadRecord& record);
+
 	mutable std::shared_mutex m_threadNamesMutex;
 	std::unordered_map<std::thread::id, std::string> m_threadNamesById;
+	std::unordered_map<std::thread::id, ThreadRecord::Ptr> m_recordsById;
+	std::map<std::string, ThreadGroupStats> m_exitedByName;
+
+	// Keyed by thread name prefix. Guarded by the names lock.
+	std::map<std::string, std::vector<size_t>> m_cpuSets;
+
+	std::mutex m_threadPoolMutex;
+	size_t m_threadPoolSize = 0;
+	ThreadPool::Ptr m_pThreadPool;
+	size_t m_latencyThreadPoolSize = 0;
+	ThreadPool::Ptr m_pLatencyThreadPool;
 };
 
+//
+// Restricts the current thread to the given CPUs. Returns false if the OS doesn't support it (eg. macOS) or none of the CPUs exist.
+//
+static bool SetCurrentThreadAffinity(const std::vector<size_t>& cpus)
+{
+#if defined(_WIN32)
+	DWORD_PTR mask = 0;
+	for (const size_t cpu : cpus)
+	{
+		if (cpu < sizeof(DWORD_PTR) * 8)
+		{
+			mask |= ((DWORD_PTR)1 << cpu);
+		}
+	}
+
+	return mask != 0 && SetThreadAffinityMask(GetCurrentThread(), mask) != 0;
+#elif defined(__APPLE__)
+	(void)cpus;
+	return false;
+#else
+	cpu_set_t cpuSet;
+	CPU_ZERO(&cpuSet);
+	for (const size_t cpu : cpus)
+	{
+		if (cpu < CPU_SETSIZE)
+		{
+			CPU_SET(cpu, &cpuSet);
+		}
+	}
+
+	return CPU_COUNT(&cpuSet) > 0 && pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#endif
+}
+
 ThreadManager& ThreadManager::GetInstance()
 {
 	static ThreadManager threadManager;
@@ -57,6 +249,164 @@ void ThreadManager::SetCurrentThreadName(const std::string& threadName)
 	std::stringstream ss;
 	ss << "[" << threadName << ":" << std::this_thread::get_id() << "]";
 	m_threadNamesById[std::this_thread::get_id()] = ss.str();
+	RegisterCurrentThread(threadName, ss.str());
+}
+
+void ThreadManager::RegisterCurrentThread(const std::string& threadName, const std::string& displayName)
+{
+	// A renamed thread's time so far is counted under its old name.
+	if (CURRENT_THREAD.pRecord != nullptr)
+	{
+		AddToExited(*CURRENT_THREAD.pRecord);
+	}
+
+	CURRENT_THREAD.pRecord = std::make_shared<ThreadRecord>(threadName, displayName);
+	m_recordsById[std::this_thread::get_id()] = CURRENT_THREAD.pRecord;
+
+	// The longest configured prefix of the name wins, eg. BLOCK_VERIFY_PIPE over BLOCK.
+	const std::vector<size_t>* pCpus = nullptr;
+	size_t matchLength = 0;
+	for (const auto& entry : m_cpuSets)
+	{
+		if (entry.first.size() >= matchLength && threadName.compare(0, entry.first.size(), entry.first) == 0)
+		{
+			pCpus = &entry.second;
+			matchLength = entry.first.size();
+		}
+	}
+
+	if (pCpus != nullptr)
+	{
+		SetCurrentThreadAffinity(*pCpus);
+	}
+}
+
+void ThreadManager::AddToExited(const ThreadRecord& record)
+{
+	auto iter = m_exitedByName.find(record.name);
+	if (iter == m_exitedByName.end())
+	{
+		iter = m_exitedByName.emplace(record.name, ThreadGroupStats{ record.name, 0, 0, 0, 0 }).first;
+	}
+
+	iter->second.cpuMicros += record.GetCpuMicros();
+	iter->second.waitMicros += record.waitMicros.load(std::memory_order_relaxed);
+	iter->second.wallMicros += record.GetWallMicros();
+}
+
+void ThreadManager::OnThreadExit(const ThreadRecord::Ptr& pRecord)
+{
+	std::unique_lock<std::shared_mutex> lockGuard(m_threadNamesMutex);
+
+	AddToExited(*pRecord);
+	m_recordsById.erase(std::this_thread::get_id());
+	m_threadNamesById.erase(std::this_thread::get_id());
+}
+
+std::vector<ThreadStats> ThreadManager::GetThreadStats() const
+{
+	// Records are only removed under the exclusive lock, before their thread exits, so every clock read here is of a live thread.
+	std::shared_lock<std::shared_mutex> readLock(m_threadNamesMutex);
+
+	std::vector<ThreadStats> stats;
+	stats.reserve(m_recordsById.size());
+	for (const auto& entry : m_recordsById)
+	{
+		const ThreadRecord& record = *entry.second;
+		const char* pActivity = record.pActivity.load(std::memory_order_relaxed);
+		stats.push_back(ThreadStats{
+			record.name,
+			record.displayName,
+			record.GetCpuMicros(),
+			record.waitMicros.load(std::memory_order_relaxed),
+			record.GetWallMicros(),
+			pActivity != nullptr ? std::string(pActivity) : ""
+		});
+	}
+
+	return stats;
+}
+
+std::vector<ThreadGroupStats> ThreadManager::GetThreadGroupStats() const
+{
+	std::map<std::string, ThreadGroupStats> groups;
+	{
+		std::shared_lock<std::shared_mutex> readLock(m_threadNamesMutex);
+		groups = m_exitedByName;
+	}
+
+	for (const ThreadStats& thread : GetThreadStats())
+	{
+		auto iter = groups.find(thread.name);
+		if (iter == groups.end())
+		{
+			iter = groups.emplace(thread.name, ThreadGroupStats{ thread.name, 0, 0, 0, 0 }).first;
+		}
+
+		++iter->second.numThreads;
+		iter->second.cpuMicros += thread.cpuMicros;
+		iter->second.waitMicros += thread.waitMicros;
+		iter->second.wallMicros += thread.wallMicros;
+	}
+
+	std::vector<ThreadGroupStats> stats;
+	for (auto& entry : groups)
+	{
+		stats.push_back(std::move(entry.second));
+	}
+
+	return stats;
+}
+
+ThreadRegistration::~ThreadRegistration()
+{
+	if (pRecord != nullptr)
+	{
+		ThreadManager::GetInstance().OnThreadExit(pRecord);
+	}
+}
+
+void ThreadManager::ConfigureThreadPool(const size_t numThreads)
+{
+	std::unique_lock<std::mutex> lock(m_threadPoolMutex);
+	m_threadPoolSize = numThreads;
+}
+
+ThreadPool& ThreadManager::GetThreadPool()
+{
+	std::unique_lock<std::mutex> lock(m_threadPoolMutex);
+	if (m_pThreadPool == nullptr)
+	{
+		const size_t numThreads = m_threadPoolSize > 0 ? m_threadPoolSize : ThreadPool::GetDefaultNumThreads();
+		m_pThreadPool = ThreadPool::Create("WORKER", numThreads);
+	}
+
+	return *m_pThreadPool;
+}
+
+void ThreadManager::ConfigureLatencyThreadPool(const size_t numThreads)
+{
+	std::unique_lock<std::mutex> lock(m_threadPoolMutex);
+	m_latencyThreadPoolSize = numThreads;
+}
+
+ThreadPool& ThreadManager::GetLatencyThreadPool()
+{
+	std::unique_lock<std::mutex> lock(m_threadPoolMutex);
+	if (m_pLatencyThreadPool == nullptr)
+	{
+		// Never shared with the worker pool, so validation waiting on its own tasks can't hold up peer messages.
+		const size_t numThreads = m_latencyThreadPoolSize > 0 ? m_latencyThreadPoolSize : (std::max)((size_t)2, ThreadPool::GetDefaultNumThreads() / 4);
+		m_pLatencyThreadPool = ThreadPool::Create("LATENCY", numThreads);
+	}
+
+	return *m_pLatencyThreadPool;
+}
+
+void ThreadManager::ConfigureCpuAffinity(const std::map<std::string, std::vector<size_t>>& cpuSets)
+{
+	std::unique_lock<std::shared_mutex> lockGuard(m_threadNamesMutex);
+	m_cpuSets = cpuSets;
 }
 
 namespace ThreadManagerAPI
@@ -76,4 +426,62 @@ namespace ThreadManagerAPI
 	{
 		ThreadManager::GetInstance().SetCurrentThreadName(threadName);
 	}
+
+	THREAD_MANAGER_API void ConfigureThreadPool(const size_t numThreads)
+	{
+		ThreadManager::GetInstance().ConfigureThreadPool(numThreads);
+	}
+
+	THREAD_MANAGER_API ThreadPool& GetThreadPool()
+	{
+		return ThreadManager::GetInstance().GetThreadPool();
+	}
+
+	THREAD_MANAGER_API void ConfigureLatencyThreadPool(const size_t numThreads)
+	{
+		ThreadManager::GetInstance().ConfigureLatencyThreadPool(numThreads);
+	}
+
+	THREAD_MANAGER_API ThreadPool& GetLatencyThreadPool()
+	{
+		return ThreadManager::GetInstance().GetLatencyThreadPool();
+	}
+
+	THREAD_MANAGER_API void ConfigureCpuAffinity(const std::map<std::string, std::vector<size_t>>& cpuSets)
+	{
+		ThreadManager::GetInstance().ConfigureCpuAffinity(cpuSets);
+	}
+
+	THREAD_MANAGER_API std::vector<ThreadPoolStats> GetThreadPoolStats()
+	{
+		return ThreadPool::GetAllStats();
+	}
+
+	THREAD_MANAGER_API std::vector<ThreadStats> GetThreadStats()
+	{
+		return ThreadManager::GetInstance().GetThreadStats();
+	}
+
+	THREAD_MANAGER_API std::vector<ThreadGroupStats> GetThreadGroupStats()
+	{
+		return ThreadManager::GetInstance().GetThreadGroupStats();
+	}
+
+	THREAD_MANAGER_API void AddCurrentThreadWait(const uint64_t micros)
+	{
+		if (CURRENT_THREAD.pRecord != nullptr)
+		{
+			CURRENT_THREAD.pRecord->waitMicros.fetch_add(micros, std::memory_order_relaxed);
+		}
+	}
+
+	THREAD_MANAGER_API const char* SetCurrentThreadActivity(const char* activity)
+	{
+		if (CURRENT_THREAD.pRecord == nullptr)
+		{
+			return nullptr;
+		}
+
+		return CURRENT_THREAD.pRecord->pActivity.exchange(activity, std::memory_order_relaxed);
+	}
 };
\ No newline at end of file
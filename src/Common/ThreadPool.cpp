@@ -0,0 +1,300 @@
+#include <Common/ThreadPool.h>
+#include <Common/Util/ThreadUtil.h>
+#include <Common/Logger.h>
+#include <algorithm>
+#include <chrono>
+
+static std::mutex POOLS_MUTEX;
+static std::vector<const ThreadPool*> POOLS;
+
+// Identifies the pool and worker the current thread belongs to, so tasks submitted from a worker stay on its own queue.
+static thread_local const ThreadPool* CURRENT_POOL = nullptr;
+static thread_local size_t CURRENT_WORKER = 0;
+
+ThreadPool::ThreadPool(const std::string& name, const size_t numThreads)
+	: m_name(name), m_pending(0), m_nextWorker(0), m_stopping(false), m_tasksCompleted(0), m_busyMicros(0)
+{
+	for (size_t i = 0; i < (std::max)((size_t)1, numThreads); i++)
+	{
+		m_workers.emplace_back(std::make_unique<Worker>());
+	}
+
+	std::unique_lock<std::mutex> lock(POOLS_MUTEX);
+	POOLS.push_back(this);
+}
+
+ThreadPool::~ThreadPool()
+{
+	Stop();
+
+	std::unique_lock<std::mutex> lock(POOLS_MUTEX);
+	POOLS.erase(std::remove(POOLS.begin(), POOLS.end(), this), POOLS.end());
+}
+
+ThreadPool::Ptr ThreadPool::Create(const std::string& name, const size_t numThreads)
+{
+	auto pPool = std::shared_ptr<ThreadPool>(new ThreadPool(name, numThreads));
+	for (size_t i = 0; i < pPool->m_workers.size(); i++)
+	{
+		pPool->m_threads.emplace_back(std::thread(Thread_Work, std::ref(*pPool), i));
+	}
+
+	LOG_INFO_F("Started {} {} threads", pPool->m_threads.size(), name);
+	return pPool;
+}
+
+void ThreadPool::Stop()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_stopping = true;
+	}
+
+	m_taskQueued.notify_all();
+	ThreadUtil::JoinAll(m_threads);
+	m_threads.clear();
+}
+
+void ThreadPool::Post(std::function<void()>&& task, const ETaskPriority priority)
+{
+	if (m_stopping)
+	{
+		// Nothing would be left to run it, so it's run on the caller's thread instead.
+		Run(task);
+		return;
+	}
+
+	const size_t workerIndex = CURRENT_POOL == this ? CURRENT_WORKER : (m_nextWorker++ % m_workers.size());
+
+	Worker& worker = *m_workers[workerIndex];
+	{
+		std::unique_lock<std::mutex> lock(worker.mutex);
+		worker.queues[(size_t)priority].emplace_back(std::move(task));
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		++m_pending;
+	}
+
+	m_taskQueued.notify_one();
+}
+
+void ThreadPool::RunParallel(const size_t numWorkers, const std::function<void()>& worker, const ETaskPriority priority)
+{
+	const size_t numTasks = (std::min)(numWorkers, m_workers.size() + 1);
+	if (numTasks <= 1)
+	{
+		worker();
+		return;
+	}
+
+	RunAll(std::vector<std::function<void()>>(numTasks, [&worker]() { worker(); }), priority);
+}
+
+void ThreadPool::RunAll(const std::vector<std::function<void()>>& tasks, const ETaskPriority priority)
+{
+	if (tasks.empty())
+	{
+		return;
+	}
+
+	auto pGroup = std::make_shared<TaskGroup>();
+	pGroup->numTasks = tasks.size() - 1;
+	pGroup->nextTask = 0;
+	pGroup->numFinished = 0;
+	pGroup->pException = nullptr;
+
+	// tasks is only used while one of them is left unstarted, and this doesn't return until all of them have finished.
+	for (size_t i = 0; i < pGroup->numTasks; i++)
+	{
+		Post([pGroup, &tasks]() { RunNextInGroup(*pGroup, tasks); }, priority);
+	}
+
+	// Tasks usually reference the caller's locals, so every task must finish before any exception is rethrown.
+	std::exception_ptr pException = nullptr;
+	try
+	{
+		tasks.back()();
+	}
+	catch (...)
+	{
+		pException = std::current_exception();
+	}
+
+	// Runs the tasks that no worker has got to yet, and then waits for the ones in progress.
+	// Nothing outside the group is run here, since the caller may be holding locks that other tasks need.
+	while (RunNextInGroup(*pGroup, tasks))
+	{
+
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(pGroup->mutex);
+
+		ThreadWait wait;
+		pGroup->finished.wait(lock, [&pGroup]() { return pGroup->numFinished == pGroup->numTasks; });
+
+		if (pException == nullptr)
+		{
+			pException = pGroup->pException;
+		}
+	}
+
+	if (pException != nullptr)
+	{
+		std::rethrow_exception(pException);
+	}
+}
+
+bool ThreadPool::RunNextInGroup(TaskGroup& group, const std::vector<std::function<void()>>& tasks)
+{
+	size_t index = 0;
+	{
+		std::unique_lock<std::mutex> lock(group.mutex);
+		if (group.nextTask == group.numTasks)
+		{
+			return false;
+		}
+
+		index = group.nextTask++;
+	}
+
+	std::exception_ptr pException = nullptr;
+	try
+	{
+		tasks[index]();
+	}
+	catch (...)
+	{
+		pException = std::current_exception();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(group.mutex);
+		if (group.pException == nullptr)
+		{
+			group.pException = pException;
+		}
+
+		++group.numFinished;
+	}
+
+	group.finished.notify_all();
+	return true;
+}
+
+ThreadPoolStats ThreadPool::GetStats() const
+{
+	return ThreadPoolStats{
+		m_name,
+		m_workers.size(),
+		(size_t)(std::max)((int64_t)0, m_pending.load()),
+		m_tasksCompleted.load(),
+		m_busyMicros.load()
+	};
+}
+
+size_t ThreadPool::GetDefaultNumThreads()
+{
+	return (std::max)((size_t)1, (size_t)std::thread::hardware_concurrency());
+}
+
+std::vector<ThreadPoolStats> ThreadPool::GetAllStats()
+{
+	std::unique_lock<std::mutex> lock(POOLS_MUTEX);
+
+	std::vector<ThreadPoolStats> stats;
+	for (const ThreadPool* pPool : POOLS)
+	{
+		stats.push_back(pPool->GetStats());
+	}
+
+	return stats;
+}
+
+//
+// Takes the newest task of the highest priority from the worker's own queue,
+// or else steals the oldest task of that priority from the other workers.
+//
+bool ThreadPool::TryPop(const size_t workerIndex, std::function<void()>& task)
+{
+	for (size_t priority = 0; priority < 3; priority++)
+	{
+		for (size_t i = 0; i < m_workers.size(); i++)
+		{
+			Worker& worker = *m_workers[(workerIndex + i) % m_workers.size()];
+
+			std::unique_lock<std::mutex> lock(worker.mutex);
+			auto& queue = worker.queues[priority];
+			if (!queue.empty())
+			{
+				if (i == 0)
+				{
+					task = std::move(queue.back());
+					queue.pop_back();
+				}
+				else
+				{
+					task = std::move(queue.front());
+					queue.pop_front();
+				}
+
+				--m_pending;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void ThreadPool::Run(std::function<void()>& task)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	try
+	{
+		task();
+	}
+	catch (const std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown by {} task: {}", m_name, e.what());
+	}
+
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	m_busyMicros += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+	++m_tasksCompleted;
+}
+
+void ThreadPool::Thread_Work(ThreadPool& pool, const size_t workerIndex)
+{
+	ThreadManagerAPI::SetCurrentThreadName(pool.m_name);
+	LOG_TRACE("BEGIN");
+
+	CURRENT_POOL = &pool;
+	CURRENT_WORKER = workerIndex;
+
+	std::function<void()> task;
+	while (true)
+	{
+		if (pool.TryPop(workerIndex, task))
+		{
+			pool.Run(task);
+			task = nullptr;
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(pool.m_sleepMutex);
+		if (pool.m_stopping && pool.m_pending <= 0)
+		{
+			break;
+		}
+
+		ThreadWait wait;
+		pool.m_taskQueued.wait(lock, [&pool]() { return pool.m_stopping || pool.m_pending > 0; });
+	}
+
+	CURRENT_POOL = nullptr;
+	LOG_TRACE("END");
+}
@@ -0,0 +1,247 @@
+#include <Common/Tracer.h>
+#include <Common/ThreadManager.h>
+#include <Common/Util/FileUtil.h>
+#include <fmt/format.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+struct TraceEvent
+{
+	const char* name;
+	uint64_t startMicros;
+	uint64_t endMicros;
+};
+
+//
+// The spans of a single thread. Only that thread writes to it, so its lock is only contended while dumping.
+// Buffers of threads that have exited are reused by new threads, so the old spans stay until they're overwritten.
+//
+struct TraceBuffer
+{
+	std::mutex mutex;
+	uint32_t threadId;
+	std::string threadName;
+	std::vector<TraceEvent> events;
+	size_t next = 0;
+};
+
+class Tracer
+{
+public:
+	static Tracer& GetInstance()
+	{
+		static Tracer tracer;
+		return tracer;
+	}
+
+	void Configure(const fs::path& directory, const size_t eventsPerThread)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_directory = directory;
+		m_eventsPerThread = eventsPerThread;
+	}
+
+	void SetEnabled(const bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+	bool IsEnabled() const noexcept { return m_enabled.load(std::memory_order_relaxed); }
+
+	uint64_t GetTimestamp() const noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - m_epoch).count();
+	}
+
+	void Record(const TraceEvent& event)
+	{
+		TraceBuffer& buffer = GetThreadBuffer();
+
+		std::unique_lock<std::mutex> lock(buffer.mutex);
+		if (buffer.events.size() < buffer.events.capacity())
+		{
+			buffer.events.push_back(event);
+		}
+		else
+		{
+			buffer.events[buffer.next] = event;
+		}
+
+		buffer.next = (buffer.next + 1) % buffer.events.capacity();
+	}
+
+	fs::path Dump()
+	{
+		std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		auto append = [&json, &first](const std::string& event) {
+			json += first ? "\n" : ",\n";
+			json += event;
+			first = false;
+		};
+
+		fs::path directory;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			directory = m_directory;
+
+			for (const std::shared_ptr<TraceBuffer>& pBuffer : m_buffers)
+			{
+				std::unique_lock<std::mutex> bufferLock(pBuffer->mutex);
+				append(fmt::format(
+					"{{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":{},\"args\":{{\"name\":\"{}\"}}}}",
+					pBuffer->threadId,
+					Escape(pBuffer->threadName)
+				));
+
+				// Oldest first, which is where the next span would go once the buffer has wrapped.
+				const size_t numEvents = pBuffer->events.size();
+				const size_t oldest = numEvents < pBuffer->events.capacity() ? 0 : pBuffer->next;
+				for (size_t i = 0; i < numEvents; i++)
+				{
+					const TraceEvent& event = pBuffer->events[(oldest + i) % numEvents];
+					append(fmt::format(
+						"{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":{},\"ts\":{},\"dur\":{}}}",
+						Escape(event.name),
+						pBuffer->threadId,
+						event.startMicros,
+						event.endMicros - event.startMicros
+					));
+				}
+			}
+		}
+
+		json += "\n]}\n";
+
+		const auto now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch());
+		const fs::path path = directory / ("trace_" + std::to_string(now.count()) + ".json");
+		FileUtil::CreateDirectories(directory);
+		FileUtil::WriteTextToFile(path, json);
+
+		return path;
+	}
+
+private:
+	//
+	// Returns the buffer of the calling thread to the pool when the thread exits.
+	//
+	struct ThreadBufferHolder
+	{
+		std::shared_ptr<TraceBuffer> pBuffer;
+
+		~ThreadBufferHolder()
+		{
+			if (pBuffer != nullptr)
+			{
+				Tracer::GetInstance().Release(pBuffer);
+			}
+		}
+	};
+
+	Tracer() : m_epoch(std::chrono::steady_clock::now()), m_enabled(false), m_eventsPerThread(16384) { }
+
+	TraceBuffer& GetThreadBuffer()
+	{
+		thread_local ThreadBufferHolder holder;
+		if (holder.pBuffer == nullptr)
+		{
+			holder.pBuffer = Acquire();
+		}
+
+		return *holder.pBuffer;
+	}
+
+	std::shared_ptr<TraceBuffer> Acquire()
+	{
+		const std::string threadName = ThreadManagerAPI::GetCurrentThreadName();
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		std::shared_ptr<TraceBuffer> pBuffer;
+		if (!m_released.empty())
+		{
+			pBuffer = m_released.back();
+			m_released.pop_back();
+		}
+		else
+		{
+			pBuffer = std::make_shared<TraceBuffer>();
+			pBuffer->events.reserve(std::max<size_t>(m_eventsPerThread, 1));
+			m_buffers.push_back(pBuffer);
+		}
+
+		// Given a new id, so the new thread's spans aren't shown as part of the old thread.
+		std::unique_lock<std::mutex> bufferLock(pBuffer->mutex);
+		pBuffer->threadId = m_nextThreadId++;
+		pBuffer->threadName = threadName;
+
+		return pBuffer;
+	}
+
+	void Release(const std::shared_ptr<TraceBuffer>& pBuffer)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_released.push_back(pBuffer);
+	}
+
+	static std::string Escape(const std::string& str)
+	{
+		std::string escaped;
+		for (const char c : str)
+		{
+			if (c == '\\' || c == '"')
+			{
+				escaped += '\\';
+				escaped += c;
+			}
+			else if ((unsigned char)c >= 0x20)
+			{
+				escaped += c;
+			}
+		}
+
+		return escaped;
+	}
+
+	const std::chrono::steady_clock::time_point m_epoch;
+	std::atomic<bool> m_enabled;
+
+	std::mutex m_mutex;
+	fs::path m_directory;
+	size_t m_eventsPerThread;
+	uint32_t m_nextThreadId = 1;
+	std::vector<std::shared_ptr<TraceBuffer>> m_buffers;
+	std::vector<std::shared_ptr<TraceBuffer>> m_released;
+};
+
+namespace TracerAPI
+{
+	TRACER_API void Configure(const fs::path& directory, const size_t eventsPerThread)
+	{
+		Tracer::GetInstance().Configure(directory, eventsPerThread);
+	}
+
+	TRACER_API void SetEnabled(const bool enabled)
+	{
+		Tracer::GetInstance().SetEnabled(enabled);
+	}
+
+	TRACER_API bool IsEnabled() noexcept
+	{
+		return Tracer::GetInstance().IsEnabled();
+	}
+
+	TRACER_API uint64_t GetTimestamp() noexcept
+	{
+		return Tracer::GetInstance().GetTimestamp();
+	}
+
+	TRACER_API void Record(const char* name, const uint64_t startMicros, const uint64_t endMicros)
+	{
+		Tracer::GetInstance().Record(TraceEvent{ name, startMicros, endMicros });
+	}
+
+	TRACER_API fs::path Dump()
+	{
+		return Tracer::GetInstance().Dump();
+	}
+}
@@ -1,9 +1,270 @@
 #include <Common/Util/HexUtil.h>
-#include <Common/GrinStr.h>
 #include <Common/Logger.h>
 
+#include <cctype>
 #include <string>
-#include <cppcodec/hex_lower.hpp>
+
+// The vectorized codecs are only implemented for x86-64 compilers that can target SSSE3/AVX2 per-function.
+#if defined(__GNUC__) && defined(__x86_64__)
+#define HEX_SIMD_SUPPORTED 1
+#include <immintrin.h>
+#else
+#define HEX_SIMD_SUPPORTED 0
+#endif
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+// Nibble value of each ASCII character, or -1 for non-hex characters.
+struct NibbleTable
+{
+	int8_t values[256];
+
+	NibbleTable()
+	{
+		for (int c = 0; c < 256; c++)
+		{
+			values[c] = -1;
+		}
+
+		for (int i = 0; i < 10; i++)
+		{
+			values['0' + i] = (int8_t)i;
+		}
+
+		for (int i = 0; i < 6; i++)
+		{
+			values['a' + i] = (int8_t)(10 + i);
+			values['A' + i] = (int8_t)(10 + i);
+		}
+	}
+};
+
+static const NibbleTable NIBBLES;
+
+static void EncodeScalar(const uint8_t* pData, const size_t numBytes, char* pOut) noexcept
+{
+	for (size_t i = 0; i < numBytes; i++)
+	{
+		pOut[2 * i] = HEX_DIGITS[pData[i] >> 4];
+		pOut[2 * i + 1] = HEX_DIGITS[pData[i] & 0x0f];
+	}
+}
+
+// Returns false if a non-hex character is found.
+static bool DecodeScalar(const char* pHex, const size_t numBytes, uint8_t* pOut) noexcept
+{
+	for (size_t i = 0; i < numBytes; i++)
+	{
+		const int8_t high = NIBBLES.values[(uint8_t)pHex[2 * i]];
+		const int8_t low = NIBBLES.values[(uint8_t)pHex[2 * i + 1]];
+		if (high < 0 || low < 0)
+		{
+			return false;
+		}
+
+		pOut[i] = (uint8_t)((high << 4) | low);
+	}
+
+	return true;
+}
+
+#if HEX_SIMD_SUPPORTED
+
+//
+// Encoding looks up each nibble in HEX_DIGITS with a byte shuffle, then interleaves the high and low digits.
+// Decoding converts each character to its nibble (digits and letters are range checked separately, with letters lowercased first),
+// then multiplies and adds each pair of nibbles into a byte.
+//
+__attribute__((target("ssse3"))) static void EncodeSSSE3(const uint8_t* pData, const size_t numBytes, char* pOut) noexcept
+{
+	const __m128i digits = _mm_loadu_si128((const __m128i*)HEX_DIGITS);
+	const __m128i mask = _mm_set1_epi8(0x0f);
+
+	size_t i = 0;
+	for (; i + 16 <= numBytes; i += 16)
+	{
+		const __m128i bytes = _mm_loadu_si128((const __m128i*)(pData + i));
+		const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(bytes, 4), mask));
+		const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(bytes, mask));
+		_mm_storeu_si128((__m128i*)(pOut + 2 * i), _mm_unpacklo_epi8(high, low));
+		_mm_storeu_si128((__m128i*)(pOut + 2 * i + 16), _mm_unpackhi_epi8(high, low));
+	}
+
+	EncodeScalar(pData + i, numBytes - i, pOut + 2 * i);
+}
+
+__attribute__((target("avx2"))) static void EncodeAVX2(const uint8_t* pData, const size_t numBytes, char* pOut) noexcept
+{
+	const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)HEX_DIGITS));
+	const __m256i mask = _mm256_set1_epi8(0x0f);
+
+	size_t i = 0;
+	for (; i + 32 <= numBytes; i += 32)
+	{
+		const __m256i bytes = _mm256_loadu_si256((const __m256i*)(pData + i));
+		const __m256i high = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(bytes, 4), mask));
+		const __m256i low = _mm256_shuffle_epi8(digits, _mm256_and_si256(bytes, mask));
+
+		// The unpacks interleave within each 128-bit lane, so the lanes are put back in order.
+		const __m256i lo = _mm256_unpacklo_epi8(high, low);
+		const __m256i hi = _mm256_unpackhi_epi8(high, low);
+		_mm256_storeu_si256((__m256i*)(pOut + 2 * i), _mm256_permute2x128_si256(lo, hi, 0x20));
+		_mm256_storeu_si256((__m256i*)(pOut + 2 * i + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+	}
+
+	EncodeSSSE3(pData + i, numBytes - i, pOut + 2 * i);
+}
+
+// Converts 16 characters to nibbles, or returns false if any isn't a hex digit.
+__attribute__((target("ssse3"))) static inline bool ToNibbles128(const __m128i chars, __m128i& nibbles) noexcept
+{
+	// Characters above 0x7f are negative, so they fail both signed range checks.
+	const __m128i isDigit = _mm_and_si128(_mm_cmpgt_epi8(chars, _mm_set1_epi8('0' - 1)), _mm_cmplt_epi8(chars, _mm_set1_epi8('9' + 1)));
+	const __m128i lower = _mm_or_si128(chars, _mm_set1_epi8(0x20));
+	const __m128i isLetter = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)), _mm_cmplt_epi8(lower, _mm_set1_epi8('f' + 1)));
+	if (_mm_movemask_epi8(_mm_or_si128(isDigit, isLetter)) != 0xffff)
+	{
+		return false;
+	}
+
+	nibbles = _mm_or_si128(
+		_mm_and_si128(isDigit, _mm_sub_epi8(chars, _mm_set1_epi8('0'))),
+		_mm_and_si128(isLetter, _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10)))
+	);
+	return true;
+}
+
+__attribute__((target("ssse3"))) static bool DecodeSSSE3(const char* pHex, const size_t numBytes, uint8_t* pOut) noexcept
+{
+	// Each high nibble (even byte) is multiplied by 16 and added to the low nibble after it.
+	const __m128i weights = _mm_set1_epi16(0x0110);
+
+	size_t i = 0;
+	for (; i + 16 <= numBytes; i += 16)
+	{
+		__m128i nibbles0;
+		__m128i nibbles1;
+		if (!ToNibbles128(_mm_loadu_si128((const __m128i*)(pHex + 2 * i)), nibbles0)
+			|| !ToNibbles128(_mm_loadu_si128((const __m128i*)(pHex + 2 * i + 16)), nibbles1))
+		{
+			return false;
+		}
+
+		const __m128i bytes = _mm_packus_epi16(_mm_maddubs_epi16(nibbles0, weights), _mm_maddubs_epi16(nibbles1, weights));
+		_mm_storeu_si128((__m128i*)(pOut + i), bytes);
+	}
+
+	return DecodeScalar(pHex + 2 * i, numBytes - i, pOut + i);
+}
+
+__attribute__((target("avx2"))) static inline bool ToNibbles256(const __m256i chars, __m256i& nibbles) noexcept
+{
+	const __m256i isDigit = _mm256_and_si256(_mm256_cmpgt_epi8(chars, _mm256_set1_epi8('0' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), chars));
+	const __m256i lower = _mm256_or_si256(chars, _mm256_set1_epi8(0x20));
+	const __m256i isLetter = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)), _mm256_cmpgt_epi8(_mm256_set1_epi8('f' + 1), lower));
+	if (_mm256_movemask_epi8(_mm256_or_si256(isDigit, isLetter)) != -1)
+	{
+		return false;
+	}
+
+	nibbles = _mm256_or_si256(
+		_mm256_and_si256(isDigit, _mm256_sub_epi8(chars, _mm256_set1_epi8('0'))),
+		_mm256_and_si256(isLetter, _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10)))
+	);
+	return true;
+}
+
+__attribute__((target("avx2"))) static bool DecodeAVX2(const char* pHex, const size_t numBytes, uint8_t* pOut) noexcept
+{
+	const __m256i weights = _mm256_set1_epi16(0x0110);
+
+	size_t i = 0;
+	for (; i + 32 <= numBytes; i += 32)
+	{
+		__m256i nibbles0;
+		__m256i nibbles1;
+		if (!ToNibbles256(_mm256_loadu_si256((const __m256i*)(pHex + 2 * i)), nibbles0)
+			|| !ToNibbles256(_mm256_loadu_si256((const __m256i*)(pHex + 2 * i + 32)), nibbles1))
+		{
+			return false;
+		}
+
+		// The pack works within each 128-bit lane, so the 64-bit quarters are put back in order.
+		const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(nibbles0, weights), _mm256_maddubs_epi16(nibbles1, weights));
+		_mm256_storeu_si256((__m256i*)(pOut + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+
+	return DecodeSSSE3(pHex + 2 * i, numBytes - i, pOut + i);
+}
+
+enum class EHexCodec
+{
+	SCALAR,
+	SSSE3,
+	AVX2
+};
+
+static EHexCodec DetectCodec() noexcept
+{
+	// __builtin_cpu_supports also checks that the OS saves the vector registers.
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return EHexCodec::AVX2;
+	}
+
+	if (__builtin_cpu_supports("ssse3"))
+	{
+		return EHexCodec::SSSE3;
+	}
+
+	return EHexCodec::SCALAR;
+}
+
+static EHexCodec GetCodec() noexcept
+{
+	static const EHexCodec CODEC = DetectCodec();
+	return CODEC;
+}
+
+static void Encode(const uint8_t* pData, const size_t numBytes, char* pOut) noexcept
+{
+	switch (GetCodec())
+	{
+		case EHexCodec::AVX2:
+			return EncodeAVX2(pData, numBytes, pOut);
+		case EHexCodec::SSSE3:
+			return EncodeSSSE3(pData, numBytes, pOut);
+		default:
+			return EncodeScalar(pData, numBytes, pOut);
+	}
+}
+
+static bool Decode(const char* pHex, const size_t numBytes, uint8_t* pOut) noexcept
+{
+	switch (GetCodec())
+	{
+		case EHexCodec::AVX2:
+			return DecodeAVX2(pHex, numBytes, pOut);
+		case EHexCodec::SSSE3:
+			return DecodeSSSE3(pHex, numBytes, pOut);
+		default:
+			return DecodeScalar(pHex, numBytes, pOut);
+	}
+}
+
+#else
+
+static void Encode(const uint8_t* pData, const size_t numBytes, char* pOut) noexcept
+{
+	EncodeScalar(pData, numBytes, pOut);
+}
+
+static bool Decode(const char* pHex, const size_t numBytes, uint8_t* pOut) noexcept
+{
+	return DecodeScalar(pHex, numBytes, pOut);
+}
+
+#endif
 
 bool HexUtil::IsValidHex(const std::string& data) noexcept
 {
@@ -16,27 +277,43 @@ bool HexUtil::IsValidHex(const std::string& data) noexcept
 
 std::vector<uint8_t> HexUtil::FromHex(const std::string& hex)
 {
-	GrinStr hex_clean = GrinStr(hex).ToLower().Trim();
-	if (hex_clean.StartsWith("0x")) {
-		hex_clean = hex_clean.substr(2);
+	// Trimmed and stripped of its prefix in place, rather than by copying the string.
+	size_t begin = 0;
+	size_t end = hex.size();
+	while (begin < end && std::isspace((unsigned char)hex[begin])) {
+		++begin;
 	}
 
-	if (!IsValidHex(hex_clean)) {
-		LOG_ERROR_F("Hex invalid: {}", hex_clean);
+	while (end > begin && std::isspace((unsigned char)hex[end - 1])) {
+		--end;
+	}
+
+	if (end - begin >= 2 && hex[begin] == '0' && (hex[begin + 1] == 'x' || hex[begin + 1] == 'X')) {
+		begin += 2;
+	}
+
+	std::vector<uint8_t> ret((end - begin) / 2);
+	if ((end - begin) % 2 != 0 || !Decode(hex.data() + begin, ret.size(), ret.data())) {
+		LOG_ERROR_F("Hex invalid: {}", hex.substr(begin, end - begin));
 		throw std::exception();
 	}
 
-	std::vector<uint8_t> ret;
-	cppcodec::hex_lower::decode(ret, hex_clean);
 	return ret;
 }
 
 std::string HexUtil::ConvertToHex(const std::vector<uint8_t>& data)
 {
-	return cppcodec::hex_lower::encode(data.data(), data.size());
+	return ConvertToHex(data.data(), data.size());
 }
 
 std::string HexUtil::ConvertToHex(const std::vector<uint8_t>& data, const size_t numBytes)
 {
-	return cppcodec::hex_lower::encode(data.data(), numBytes);
-}
\ No newline at end of file
+	return ConvertToHex(data.data(), numBytes);
+}
+
+std::string HexUtil::ConvertToHex(const uint8_t* pData, const size_t numBytes)
+{
+	std::string hex(numBytes * 2, '\0');
+	Encode(pData, numBytes, &hex[0]);
+	return hex;
+}
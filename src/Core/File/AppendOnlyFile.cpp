@@ -1,6 +1,7 @@
 #include <Core/File/AppendOnlyFile.h>
 #include <Core/Exceptions/FileException.h>
 #include <Common/Util/FileUtil.h>
+#include <algorithm>
 
 void AppendOnlyFile::Load()
 {
@@ -77,20 +78,93 @@ uint64_t AppendOnlyFile::GetSize() const noexcept
 
 bool AppendOnlyFile::Read(const uint64_t position, const uint64_t numBytes, std::vector<unsigned char>& data) const
 {
-	// TODO: Handle partial read from m_mmap and m_buffer
-	if (position < m_bufferIndex)
+	if ((position + numBytes) > GetSize())
 	{
-		m_pMappedFile->Read(position, numBytes, data);
+		return false;
 	}
-	else
+
+	data.resize(numBytes);
+	return Read(position, numBytes, data.data());
+}
+
+bool AppendOnlyFile::Read(const uint64_t position, const uint64_t numBytes, unsigned char* pData) const
+{
+	if ((position + numBytes) > GetSize())
+	{
+		return false;
+	}
+
+	if ((position + numBytes) <= m_bufferIndex)
+	{
+		m_pMappedFile->Read(position, numBytes, pData);
+	}
+	else if (position >= m_bufferIndex)
 	{
 		const uint64_t firstBufferIndex = position - m_bufferIndex;
 
-		data = std::vector<unsigned char>(
+		std::copy(
 			m_buffer.cbegin() + firstBufferIndex,
-			m_buffer.cbegin() + firstBufferIndex + numBytes
+			m_buffer.cbegin() + firstBufferIndex + numBytes,
+			pData
+		);
+	}
+	else
+	{
+		// Read spans both the mapped file and the unflushed buffer.
+		const uint64_t numMappedBytes = m_bufferIndex - position;
+		m_pMappedFile->Read(position, numMappedBytes, pData);
+
+		std::copy(
+			m_buffer.cbegin(),
+			m_buffer.cbegin() + (numBytes - numMappedBytes),
+			pData + numMappedBytes
 		);
 	}
 
 	return true;
+}
+
+bool AppendOnlyFile::Visit(const uint64_t position, const uint64_t numBytes, const std::function<void(const unsigned char*)>& visitor) const
+{
+	if ((position + numBytes) > GetSize())
+	{
+		return false;
+	}
+
+	if ((position + numBytes) <= m_bufferIndex)
+	{
+		m_pMappedFile->Visit(position, numBytes, visitor);
+	}
+	else if (position >= m_bufferIndex)
+	{
+		visitor(m_buffer.data() + (position - m_bufferIndex));
+	}
+	else
+	{
+		// Only ranges spanning both the mapped file and the unflushed buffer need to be copied.
+		std::vector<unsigned char> data(numBytes);
+		Read(position, numBytes, data.data());
+		visitor(data.data());
+	}
+
+	return true;
+}
+
+void AppendOnlyFile::Replace(const fs::path& path)
+{
+	Discard();
+
+	// Windows can't replace a file while it's mapped.
+	m_pMappedFile.reset();
+
+	FileUtil::RenameFile(path, m_path);
+	Load();
+}
+
+void AppendOnlyFile::SetAccessHint(const EFileAccess access)
+{
+	if (m_pMappedFile != nullptr)
+	{
+		m_pMappedFile->SetAccessHint(access);
+	}
 }
\ No newline at end of file
@@ -1,21 +1,49 @@
 #include "MappedFile_Nix.h"
+#include "ReadOnlyFile.h"
 
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
 #include <fstream>
 #include <filesystem.h>
 #include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <Core/Exceptions/FileException.h>
 #include <Common/Logger.h>
-#include <Common/Util/FileUtil.h>
+
+static uint64_t GetPageSize()
+{
+	static const uint64_t pageSize = (uint64_t)sysconf(_SC_PAGESIZE);
+	return pageSize;
+}
+
+static uint64_t RoundUpToPage(const uint64_t size)
+{
+	return ((size + GetPageSize() - 1) / GetPageSize()) * GetPageSize();
+}
 
 MappedFile::~MappedFile()
 {
 	LOG_TRACE_F("Closing File: {}", m_path);
 
 	Unmap();
+
+	if (m_fd >= 0)
+	{
+		close(m_fd);
+	}
 }
 
 IMappedFile::UPtr IMappedFile::Load(const fs::path& path)
 {
+	if (IsReadOnly())
+	{
+		return ReadOnlyFile::Open(path);
+	}
+
 	std::ifstream inFile(path, std::ios::in | std::ifstream::ate | std::ifstream::binary);
 	if (inFile.is_open())
 	{
@@ -34,29 +62,77 @@ IMappedFile::UPtr IMappedFile::Load(const fs::path& path)
 		outFile.close();
 	}
 
-	return std::unique_ptr<IMappedFile>(new MappedFile(path));
+	const int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+	if (fd < 0)
+	{
+		LOG_ERROR_F("Failed to open file: {} - error: {}", path, errno);
+		throw FILE_EXCEPTION_F("Failed to open file: {}", path);
+	}
+
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) != 0)
+	{
+		LOG_ERROR_F("Failed to stat file: {} - error: {}", path, errno);
+		close(fd);
+		throw FILE_EXCEPTION_F("Failed to stat file: {}", path);
+	}
+
+	const uint64_t fileSize = (uint64_t)fileStat.st_size;
+	std::unique_ptr<MappedFile> pMappedFile(new MappedFile(path, fd, fileSize));
+	pMappedFile->Map(fileSize);
+
+	return pMappedFile;
 }
 
 bool MappedFile::Write(const size_t startIndex, const std::vector<uint8_t>& data)
 {
 	std::unique_lock<std::mutex> lock(m_mutex);
 
-	Unmap();
+	const uint64_t newSize = startIndex + data.size();
+	if (newSize > m_allocatedSize)
+	{
+		Preallocate(newSize);
+	}
+
+	if (newSize != m_fileSize)
+	{
+		if (ftruncate(m_fd, (off_t)newSize) != 0)
+		{
+			LOG_ERROR_F("Failed to resize {} to {} bytes - error: {}", m_path, newSize, errno);
+			return false;
+		}
+
+		// Shrinking frees the space reserved past the end, too.
+		if (newSize < m_fileSize)
+		{
+			m_allocatedSize = newSize;
+		}
 
-	FileUtil::TruncateFile(m_path, startIndex);
+		m_fileSize = newSize;
+	}
 
 	if (!data.empty())
 	{
-		std::ofstream file(m_path, std::ios::out | std::ios::binary | std::ios::app);
-		if (!file.is_open())
+		if (newSize > m_mappedLength)
 		{
-			LOG_ERROR_F("Failed to open file: {}", m_path);
-			return false;
+			try
+			{
+				Map(newSize);
+			}
+			catch (FileException&)
+			{
+				return false;
+			}
 		}
 
-		file.seekp(startIndex, std::ios::beg);
-		file.write((const char*)data.data(), data.size());
-		file.close();
+		std::memcpy(m_pMapped + startIndex, data.data(), data.size());
+
+		// Starts writing back the new range without waiting on it, like the buffered writes this replaced.
+		const uint64_t syncStart = startIndex - (startIndex % GetPageSize());
+		if (msync(m_pMapped + syncStart, newSize - syncStart, MS_ASYNC) != 0)
+		{
+			LOG_WARNING_F("Failed to sync {} - error: {}", m_path, errno);
+		}
 	}
 
 	return true;
@@ -66,29 +142,103 @@ void MappedFile::Read(const uint64_t position, const uint64_t numBytes, std::vec
 {
 	std::unique_lock<std::mutex> lock(m_mutex);
 
-	if (!m_mmap.is_mapped())
-	{
-		Map();
-	}
-
 	data = std::vector<uint8_t>(
-		m_mmap.cbegin() + position,
-		m_mmap.cbegin() + position + numBytes
+		m_pMapped + position,
+		m_pMapped + position + numBytes
 	);
 }
 
-void MappedFile::Map() const
+void MappedFile::Read(const uint64_t position, const uint64_t numBytes, uint8_t* pData) const
 {
-	std::error_code error;
-	m_mmap = mio::make_mmap_source(m_path.c_str(), error);
-	if (error.value() != 0)
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	std::copy(m_pMapped + position, m_pMapped + position + numBytes, pData);
+}
+
+void MappedFile::Visit(const uint64_t position, const uint64_t numBytes, const std::function<void(const uint8_t*)>& visitor) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	visitor(m_pMapped + position);
+}
+
+void MappedFile::SetAccessHint(const EFileAccess access)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	m_access = access;
+	Advise();
+}
+
+//
+// Replaces the mapping with one covering at least minLength bytes, plus headroom.
+// The new mapping is created before the old one is removed, so a failure leaves the file readable.
+//
+void MappedFile::Map(const uint64_t minLength)
+{
+	const uint64_t headroom = (std::max)(MIN_MAP_HEADROOM_BYTES, minLength / 2);
+	const uint64_t length = RoundUpToPage(minLength + headroom);
+
+	void* pMapped = mmap(nullptr, (size_t)length, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+	if (pMapped == MAP_FAILED)
 	{
-		LOG_ERROR_F("Failed to mmap file: {}", error.value());
+		LOG_ERROR_F("Failed to mmap file: {} - error: {}", m_path, errno);
 		throw FILE_EXCEPTION_F("Failed to mmap file: {}", m_path);
 	}
+
+	Unmap();
+
+	m_pMapped = (uint8_t*)pMapped;
+	m_mappedLength = length;
+	Advise();
 }
 
-void MappedFile::Unmap() const
+void MappedFile::Unmap() noexcept
 {
-	m_mmap.unmap();
-}
\ No newline at end of file
+	if (m_pMapped != nullptr)
+	{
+		munmap(m_pMapped, (size_t)m_mappedLength);
+		m_pMapped = nullptr;
+		m_mappedLength = 0;
+	}
+}
+
+//
+// Reserves disk space past size without changing the file's size, so the next appends don't each allocate blocks.
+//
+void MappedFile::Preallocate(const uint64_t size)
+{
+	const uint64_t extent = std::clamp(size / 8, MIN_PREALLOCATE_BYTES, MAX_PREALLOCATE_BYTES);
+
+#if defined(__linux__)
+	if (fallocate(m_fd, FALLOC_FL_KEEP_SIZE, (off_t)m_fileSize, (off_t)(size + extent - m_fileSize)) != 0)
+	{
+		// Not every filesystem supports it. The file still grows as it's written, just without reserved space.
+		LOG_TRACE_F("Failed to preallocate {} - error: {}", m_path, errno);
+	}
+#endif
+
+	m_allocatedSize = size + extent;
+}
+
+void MappedFile::Advise() const noexcept
+{
+	if (m_pMapped == nullptr)
+	{
+		return;
+	}
+
+	if (m_access == EFileAccess::SEQUENTIAL)
+	{
+		madvise(m_pMapped, (size_t)m_mappedLength, MADV_SEQUENTIAL);
+
+#if defined(MADV_HUGEPAGE)
+		// Only honored by kernels that support huge pages for file mappings.
+		madvise(m_pMapped, (size_t)m_mappedLength, MADV_HUGEPAGE);
+#endif
+	}
+	else
+	{
+		madvise(m_pMapped, (size_t)m_mappedLength, MADV_NORMAL);
+	}
+}
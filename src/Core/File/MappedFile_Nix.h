@@ -1,30 +1,55 @@
 #include <Core/File/MappedFile.h>
 
-#pragma warning(push)
-#pragma warning(disable:4244)
-#pragma warning(disable:4267)
-#pragma warning(disable:4334)
-#pragma warning(disable:4018)
-#include <mio/mmap.hpp>
-#pragma warning(pop)
-
+//
+// The whole file is mapped read/write with headroom past its end, and disk space is reserved ahead of its size,
+// so appending is a memcpy into the mapping and an asynchronous msync of the new range, rather than a write and remap.
+//
 class MappedFile : public IMappedFile
 {
 public:
 	using UPtr = std::unique_ptr<MappedFile>;
 
-	MappedFile(const fs::path& path) noexcept
-		: m_path(path) { }
+	MappedFile(const fs::path& path, const int fd, const uint64_t fileSize) noexcept
+		: m_path(path),
+		m_fd(fd),
+		m_fileSize(fileSize),
+		m_allocatedSize(fileSize),
+		m_pMapped(nullptr),
+		m_mappedLength(0),
+		m_access(EFileAccess::NORMAL) { }
 	virtual ~MappedFile();
 
 	bool Write(const size_t startIndex, const std::vector<uint8_t>& data) final;
 	void Read(const uint64_t position, const uint64_t numBytes, std::vector<uint8_t>& data) const final;
+	void Read(const uint64_t position, const uint64_t numBytes, uint8_t* pData) const final;
+	void Visit(const uint64_t position, const uint64_t numBytes, const std::function<void(const uint8_t*)>& visitor) const final;
+	void SetAccessHint(const EFileAccess access) final;
 
 private:
-	void Map() const;
-	void Unmap() const;
+	friend IMappedFile::UPtr IMappedFile::Load(const fs::path& path);
+
+	// Disk space is reserved in extents of an eighth of the file size, within these bounds.
+	static constexpr uint64_t MIN_PREALLOCATE_BYTES = 1024 * 1024;
+	static constexpr uint64_t MAX_PREALLOCATE_BYTES = 64 * 1024 * 1024;
+
+	// The mapping extends past the end of the file by half its size, and at least this much.
+	// It only reserves address space, and pages past the end of the file become readable as it grows.
+	static constexpr uint64_t MIN_MAP_HEADROOM_BYTES = 256 * 1024 * 1024;
+
+	void Map(const uint64_t minLength);
+	void Unmap() noexcept;
+	void Preallocate(const uint64_t size);
+	void Advise() const noexcept;
 
 	fs::path m_path;
-	mutable mio::mmap_source m_mmap;
+	int m_fd;
+
+	// The logical size of the file, not counting space reserved past the end of it.
+	uint64_t m_fileSize;
+	uint64_t m_allocatedSize;
+
+	uint8_t* m_pMapped;
+	uint64_t m_mappedLength;
+	EFileAccess m_access;
 	mutable std::mutex m_mutex;
-};
\ No newline at end of file
+};
@@ -1,5 +1,7 @@
 #include "MappedFile_Win.h"
+#include "ReadOnlyFile.h"
 
+#include <algorithm>
 #include <fstream>
 #include <vector>
 #include <filesystem.h>
@@ -24,6 +26,11 @@ MappedFile::~MappedFile()
 
 IMappedFile::UPtr IMappedFile::Load(const fs::path& path)
 {
+	if (IsReadOnly())
+	{
+		return ReadOnlyFile::Open(path);
+	}
+
 	std::ifstream inFile(path, std::ios::in | std::ifstream::ate | std::ifstream::binary);
 	if (inFile.is_open())
 	{
@@ -111,6 +118,30 @@ void MappedFile::Read(const uint64_t position, const uint64_t numBytes, std::vec
 	);
 }
 
+void MappedFile::Read(const uint64_t position, const uint64_t numBytes, uint8_t* pData) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (!m_mmap.IsMapped())
+	{
+		Map();
+	}
+
+	std::copy(m_mmap.mapped_view + position, m_mmap.mapped_view + position + numBytes, pData);
+}
+
+void MappedFile::Visit(const uint64_t position, const uint64_t numBytes, const std::function<void(const uint8_t*)>& visitor) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	if (!m_mmap.IsMapped())
+	{
+		Map();
+	}
+
+	visitor((const uint8_t*)m_mmap.mapped_view + position);
+}
+
 void MappedFile::Map() const
 {
 	m_mmap.mapping_handle = CreateFileMapping(m_handle, 0, PAGE_READONLY, 0, 0, 0);
@@ -31,6 +31,11 @@ public:
 
 	bool Write(const size_t startIndex, const std::vector<uint8_t>& data) final;
 	void Read(const uint64_t position, const uint64_t numBytes, std::vector<uint8_t>& data) const final;
+	void Read(const uint64_t position, const uint64_t numBytes, uint8_t* pData) const final;
+	void Visit(const uint64_t position, const uint64_t numBytes, const std::function<void(const uint8_t*)>& visitor) const final;
+
+	// Read-ahead hints are only implemented for posix.
+	void SetAccessHint(const EFileAccess) final { }
 
 private:
 	void Map() const;
@@ -0,0 +1,64 @@
+#include "ReadOnlyFile.h"
+
+#include <Core/Exceptions/FileException.h>
+#include <Common/Logger.h>
+#include <atomic>
+
+static std::atomic_bool s_readOnly(false);
+
+void IMappedFile::SetReadOnly(const bool readOnly)
+{
+	s_readOnly = readOnly;
+}
+
+bool IMappedFile::IsReadOnly()
+{
+	return s_readOnly;
+}
+
+IMappedFile::UPtr ReadOnlyFile::Open(const fs::path& path)
+{
+	std::unique_ptr<ReadOnlyFile> pFile(new ReadOnlyFile(path));
+
+	// A missing file is treated as empty, and isn't created.
+	pFile->m_file.open(path, std::ios::in | std::ios::binary);
+	if (!pFile->m_file.is_open())
+	{
+		LOG_WARNING_F("File {} does not exist. Opening it as empty.", path);
+	}
+
+	return pFile;
+}
+
+void ReadOnlyFile::Read(const uint64_t position, const uint64_t numBytes, std::vector<uint8_t>& data) const
+{
+	data.resize(numBytes);
+	Read(position, numBytes, data.data());
+}
+
+void ReadOnlyFile::Read(const uint64_t position, const uint64_t numBytes, uint8_t* pData) const
+{
+	if (numBytes == 0)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	// Clears eof from a previous short read, so the file can be read again once it's grown.
+	m_file.clear();
+	m_file.seekg((std::streamoff)position, std::ios::beg);
+	m_file.read((char*)pData, (std::streamsize)numBytes);
+	if ((uint64_t)m_file.gcount() != numBytes)
+	{
+		LOG_ERROR_F("Failed to read {} bytes at {} from {}", numBytes, position, m_path);
+		throw FILE_EXCEPTION_F("Failed to read {} bytes at {} from {}", numBytes, position, m_path);
+	}
+}
+
+void ReadOnlyFile::Visit(const uint64_t position, const uint64_t numBytes, const std::function<void(const uint8_t*)>& visitor) const
+{
+	std::vector<uint8_t> data;
+	Read(position, numBytes, data);
+	visitor(data.data());
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Core/File/MappedFile.h>
+#include <fstream>
+#include <mutex>
+
+//
+// Used instead of a MappedFile once IMappedFile::SetReadOnly(true) is called, for files another process writes.
+// Reads copy from the file through a stream, so reading past the end of a file that was shrunk since it was opened
+// throws a FileException, rather than raising SIGBUS like touching a mapping past the end of its file would.
+//
+class ReadOnlyFile : public IMappedFile
+{
+public:
+	static IMappedFile::UPtr Open(const fs::path& path);
+	virtual ~ReadOnlyFile() = default;
+
+	bool Write(const size_t, const std::vector<uint8_t>&) final { return false; }
+	void Read(const uint64_t position, const uint64_t numBytes, std::vector<uint8_t>& data) const final;
+	void Read(const uint64_t position, const uint64_t numBytes, uint8_t* pData) const final;
+	void Visit(const uint64_t position, const uint64_t numBytes, const std::function<void(const uint8_t*)>& visitor) const final;
+	void SetAccessHint(const EFileAccess) final { }
+
+private:
+	ReadOnlyFile(const fs::path& path) : m_path(path) { }
+
+	fs::path m_path;
+	mutable std::ifstream m_file;
+	mutable std::mutex m_mutex;
+};
@@ -1,8 +1,12 @@
 #include <Core/Models/FullBlock.h>
+#include <algorithm>
 
 FullBlock::FullBlock(BlockHeaderPtr pBlockHeader, TransactionBody&& transactionBody)
 	: m_pBlockHeader(pBlockHeader), m_transactionBody(std::move(transactionBody)), m_validated(false) { }
 
+FullBlock::FullBlock(const FullBlock& other)
+	: m_pArena(nullptr), m_pBlockHeader(other.m_pBlockHeader), m_transactionBody(other.m_transactionBody), m_validated(other.m_validated) { }
+
 FullBlock::FullBlock()
 	: m_pBlockHeader(nullptr), m_transactionBody(), m_validated(false) { }
 
@@ -20,6 +24,45 @@ FullBlock FullBlock::Deserialize(ByteBuffer& byteBuffer)
 	return FullBlock(pBlockHeader, std::move(transactionBody));
 }
 
+FullBlock FullBlock::DeserializeWithArena(ByteBuffer& byteBuffer)
+{
+	// The rangeproofs are most of a block, so the remaining bytes are enough for them in a single allocation.
+	auto pArena = std::make_shared<std::pmr::monotonic_buffer_resource>(std::max<size_t>(byteBuffer.GetRemainingSize(), 1));
+
+	std::pmr::memory_resource* pPrevious = byteBuffer.SetMemoryResource(pArena.get());
+	try
+	{
+		FullBlock block = Deserialize(byteBuffer);
+		byteBuffer.SetMemoryResource(pPrevious);
+
+		block.m_pArena = std::move(pArena);
+		return block;
+	}
+	catch (...)
+	{
+		byteBuffer.SetMemoryResource(pPrevious);
+		throw;
+	}
+}
+
+//
+// Assigned by swapping, so the old body is always destroyed along with (and before) the arena it may have been allocated from.
+//
+FullBlock& FullBlock::operator=(const FullBlock& other)
+{
+	FullBlock copy(other);
+	return *this = std::move(copy);
+}
+
+FullBlock& FullBlock::operator=(FullBlock&& other) noexcept
+{
+	std::swap(m_pArena, other.m_pArena);
+	std::swap(m_pBlockHeader, other.m_pBlockHeader);
+	std::swap(m_transactionBody, other.m_transactionBody);
+	std::swap(m_validated, other.m_validated);
+	return *this;
+}
+
 Json::Value FullBlock::ToJSON() const
 {
 	Json::Value json;
@@ -8,6 +8,11 @@ ShortId::ShortId(CBigInteger<6>&& id)
 }
 
 ShortId ShortId::Create(const CBigInteger<32>& hash, const CBigInteger<32>& blockHash, const uint64_t nonce)
+{
+	return Create(hash, CalculateKeys(blockHash, nonce));
+}
+
+std::pair<uint64_t, uint64_t> ShortId::CalculateKeys(const CBigInteger<32>& blockHash, const uint64_t nonce)
 {
 	// take the block hash and the nonce and hash them together
 	Serializer serializer;
@@ -20,14 +25,19 @@ ShortId ShortId::Create(const CBigInteger<32>& hash, const CBigInteger<32>& bloc
 	const uint64_t k0 = byteBuffer.ReadU64_LE();
 	const uint64_t k1 = byteBuffer.ReadU64_LE();
 
+	return std::make_pair(k0, k1);
+}
+
+ShortId ShortId::Create(const CBigInteger<32>& hash, const std::pair<uint64_t, uint64_t>& keys)
+{
 	// SipHash24 our hash using the k0 and k1 keys
-	const uint64_t sipHash = Hasher::SipHash24(k0, k1, hash.GetData());
+	const uint64_t sipHash = Hasher::SipHash24(keys.first, keys.second, hash.GetData());
 
 	// construct a short_id from the resulting bytes (dropping the 2 most significant bytes)
-	Serializer serializer2;
-	serializer2.AppendLittleEndian<uint64_t>(sipHash);
+	Serializer serializer;
+	serializer.AppendLittleEndian<uint64_t>(sipHash);
 
-	return ShortId(CBigInteger<6>(&serializer2.GetBytes()[0]));
+	return ShortId(CBigInteger<6>(&serializer.GetBytes()[0]));
 }
 
 void ShortId::Serialize(Serializer& serializer) const
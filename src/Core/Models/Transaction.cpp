@@ -8,19 +8,59 @@ Transaction::Transaction(BlindingFactor&& offset, TransactionBody&& transactionB
 	: m_offset(std::move(offset)), m_transactionBody(std::move(transactionBody)) { }
 
 Transaction::Transaction(const Transaction& tx)
-	: m_offset(tx.m_offset), m_transactionBody(tx.m_transactionBody), m_hash(tx.GetHash()) { }
+	: m_offset(tx.m_offset), m_transactionBody(tx.m_transactionBody), m_validated(tx.WasValidated())
+{
+	CopyHash(tx);
+}
 
 Transaction::Transaction(Transaction&& tx) noexcept
-	: m_offset(std::move(tx.m_offset)), m_transactionBody(std::move(tx.m_transactionBody)), m_hash(std::move(tx.m_hash)) { }
+	: m_offset(std::move(tx.m_offset)), m_transactionBody(std::move(tx.m_transactionBody)), m_validated(tx.WasValidated())
+{
+	MoveHash(std::move(tx));
+}
 
 Transaction& Transaction::operator=(const Transaction& tx)
 {
 	m_offset = tx.m_offset;
 	m_transactionBody = tx.m_transactionBody;
-	m_hash = tx.GetHash();
+	CopyHash(tx);
+	m_validated = tx.WasValidated();
 	return *this;
 }
 
+Transaction& Transaction::operator=(Transaction&& tx) noexcept
+{
+	m_offset = std::move(tx.m_offset);
+	m_transactionBody = std::move(tx.m_transactionBody);
+	MoveHash(std::move(tx));
+	m_validated = tx.WasValidated();
+	return *this;
+}
+
+//
+// Copies the hash only if it's already been calculated, so copying never pays for hashing.
+// Not thread-safe for this transaction, the same as any other assignment, but tx may be hashed concurrently.
+//
+void Transaction::CopyHash(const Transaction& tx)
+{
+	if (tx.m_hashed.load(std::memory_order_acquire)) {
+		m_hash = tx.m_hash;
+		m_hashed.store(true, std::memory_order_release);
+	} else {
+		m_hashed.store(false, std::memory_order_release);
+	}
+}
+
+void Transaction::MoveHash(Transaction&& tx) noexcept
+{
+	const bool hashed = tx.m_hashed.exchange(false, std::memory_order_acq_rel);
+	if (hashed) {
+		m_hash = std::move(tx.m_hash);
+	}
+
+	m_hashed.store(hashed, std::memory_order_release);
+}
+
 void Transaction::Serialize(Serializer& serializer) const
 {
 	// Serialize BlindingFactor/Offset
@@ -63,12 +103,14 @@ Transaction Transaction::FromJSON(const Json::Value& transactionJSON)
 
 const Hash& Transaction::GetHash() const
 {
-	std::unique_lock lock(m_mutex);
-
-	if (m_hash == Hash{}) {
-		Serializer serializer;
-		Serialize(serializer);
-		m_hash = Hasher::Blake2b(serializer.GetBytes());
+	if (!m_hashed.load(std::memory_order_acquire)) {
+		std::unique_lock lock(m_mutex);
+		if (!m_hashed.load(std::memory_order_relaxed)) {
+			Serializer serializer;
+			Serialize(serializer);
+			m_hash = Hasher::Blake2b(serializer.GetBytes());
+			m_hashed.store(true, std::memory_order_release);
+		}
 	}
 
 	return m_hash;
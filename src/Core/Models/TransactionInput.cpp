@@ -1,16 +1,14 @@
 #include <Core/Models/TransactionInput.h>
+#include <Core/Models/TransactionOutput.h>
 
 #include <Core/Serialization/Serializer.h>
 #include <Core/Util/JsonUtil.h>
-#include <Crypto/Hasher.h>
 
 TransactionInput::TransactionInput(const EOutputFeatures features, Commitment&& commitment)
-	: m_features(features), m_commitment(std::move(commitment))
-{
-		Serializer serializer;
-		Serialize(serializer);
-		m_hash = Hasher::Blake2b(serializer.GetBytes());
-}
+	: m_features(features), m_commitment(std::move(commitment)), m_hash(TransactionOutput::CalculateHash(m_features, m_commitment)) { }
+
+TransactionInput::TransactionInput(const EOutputFeatures features, const Commitment& commitment)
+	: m_features(features), m_commitment(commitment), m_hash(TransactionOutput::CalculateHash(m_features, m_commitment)) { }
 
 void TransactionInput::Serialize(Serializer& serializer) const
 {
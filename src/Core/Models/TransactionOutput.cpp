@@ -1,29 +1,22 @@
 #include <Core/Models/TransactionOutput.h>
 #include <Core/Util/JsonUtil.h>
 #include <Crypto/Hasher.h>
+#include <algorithm>
+#include <array>
 
 TransactionOutput::TransactionOutput(const EOutputFeatures features, Commitment&& commitment, RangeProof&& rangeProof)
-	: m_features(features), m_commitment(std::move(commitment)), m_rangeProof(std::move(rangeProof))
-{
-		Serializer serializer;
-		// Serialize OutputFeatures
-		serializer.Append<uint8_t>((uint8_t)m_features);
-
-		// Serialize Commitment
-		m_commitment.Serialize(serializer);
-		m_hash = Hasher::Blake2b(serializer.GetBytes());
-}
+	: m_features(features), m_commitment(std::move(commitment)), m_rangeProof(std::move(rangeProof)), m_hash(CalculateHash(m_features, m_commitment)) { }
 
 TransactionOutput::TransactionOutput(const EOutputFeatures features, const Commitment& commitment, const RangeProof& rangeProof)
-	: m_features(features), m_commitment(commitment), m_rangeProof(rangeProof)
-{
-		Serializer serializer;
-		// Serialize OutputFeatures
-		serializer.Append<uint8_t>((uint8_t)m_features);
+	: m_features(features), m_commitment(commitment), m_rangeProof(rangeProof), m_hash(CalculateHash(m_features, m_commitment)) { }
 
-		// Serialize Commitment
-		m_commitment.Serialize(serializer);
-		m_hash = Hasher::Blake2b(serializer.GetBytes());
+Hash TransactionOutput::CalculateHash(const EOutputFeatures features, const Commitment& commitment)
+{
+	// OutputFeatures (1 byte) followed by the Commitment (33 bytes), hashed from the stack instead of a Serializer.
+	std::array<uint8_t, 1 + 33> preimage;
+	preimage[0] = (uint8_t)features;
+	std::copy(commitment.data(), commitment.data() + 33, preimage.begin() + 1);
+	return Hasher::Blake2b(preimage.data(), preimage.size());
 }
 
 void TransactionOutput::Serialize(Serializer& serializer) const
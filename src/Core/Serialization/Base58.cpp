@@ -30,6 +30,33 @@ static const int8_t mapBase58[256] = {
     -1,-1,-1,-1,-1,-1,-1,-1, -1,-1,-1,-1,-1,-1,-1,-1,
 };
 
+//
+// The conversions below work on limbs of 5 base58 digits (58^5 < 2^30) and 4 bytes (2^32),
+// rather than one digit and one byte at a time as in Bitcoin Core, so each step of the inner loop
+// does the work of ~20, and slatepacks containing whole slates can be armored and dearmored quickly.
+// Every intermediate value fits in 64 bits, since limb * 2^32 + carry < 2^62 + 2^34.
+//
+static const uint64_t BASE58_LIMB = 58ull * 58 * 58 * 58 * 58;
+static const int DIGITS_PER_LIMB = 5;
+static const uint64_t BASE256_LIMB = 1ull << 32;
+static const int BYTES_PER_LIMB = 4;
+
+// Multiplies the little-endian limbs by multiplier, adds value, and carries into new limbs as needed.
+static void MultiplyAdd(std::vector<uint32_t>& limbs, const uint64_t limbBase, const uint64_t multiplier, const uint64_t value)
+{
+    uint64_t carry = value;
+    for (uint32_t& limb : limbs) {
+        carry += (uint64_t)limb * multiplier;
+        limb = (uint32_t)(carry % limbBase);
+        carry /= limbBase;
+    }
+
+    while (carry != 0) {
+        limbs.push_back((uint32_t)(carry % limbBase));
+        carry /= limbBase;
+    }
+}
+
 std::vector<uint8_t> Base58::Decode(const char* psz, const bool include_version)
 {
     // Skip leading spaces.
@@ -39,7 +66,6 @@ std::vector<uint8_t> Base58::Decode(const char* psz, const bool include_version)
 
     // Skip and count leading '1's.
     int zeroes = 0;
-    int length = 0;
 
     if (include_version) {
         while (*psz == '1') {
@@ -48,54 +74,70 @@ std::vector<uint8_t> Base58::Decode(const char* psz, const bool include_version)
         }
     }
 
-    // Allocate enough space in big-endian base256 representation.
-    size_t size = strlen(psz) * 733 /1000 + 1; // log(58) / log(256), rounded up.
-    std::vector<unsigned char> b256(size);
-    // Process the characters.
-    static_assert(sizeof(mapBase58)/sizeof(mapBase58[0]) == 256, "mapBase58.size() should be 256"); // guarantee not out of range
-
-    while (*psz && !IsSpace(*psz)) {
-        // Decode base58 character
-        int carry = mapBase58[(uint8_t)*psz];
-        // Invalid b58 character
-        if (carry == -1) {
-            throw std::exception();
-        }
-
-        int i = 0;
-        for (std::vector<unsigned char>::reverse_iterator it = b256.rbegin(); (carry != 0 || i < length) && (it != b256.rend()); ++it, ++i) {
-            carry += 58 * (*it);
-            *it = carry % 256;
-            carry /= 256;
-        }
-
-        assert(carry == 0);
-        length = i;
-        psz++;
+    const char* pEnd = psz;
+    while (*pEnd && !IsSpace(*pEnd)) {
+        pEnd++;
     }
 
     // Skip trailing spaces.
-    while (IsSpace(*psz)) {
-        psz++;
+    const char* pTrailing = pEnd;
+    while (IsSpace(*pTrailing)) {
+        pTrailing++;
     }
 
-    if (*psz != 0) {
+    if (*pTrailing != 0) {
         throw std::exception();
     }
 
-    // Skip leading zeroes in b256.
-    std::vector<unsigned char>::iterator it = b256.begin() + (size - length);
-    while (it != b256.end() && *it == 0) {
-        it++;
+    static_assert(sizeof(mapBase58)/sizeof(mapBase58[0]) == 256, "mapBase58.size() should be 256"); // guarantee not out of range
+
+    // Little-endian base 2^32 limbs, with enough space allocated for the result.
+    const size_t numDigits = pEnd - psz;
+    std::vector<uint32_t> b256;
+    b256.reserve((numDigits * 733 / 1000) / BYTES_PER_LIMB + 1); // log(58) / log(256), rounded up.
+
+    // The first group takes the leftover digits, so the rest are whole limbs.
+    size_t groupSize = numDigits % DIGITS_PER_LIMB;
+    if (groupSize == 0) {
+        groupSize = DIGITS_PER_LIMB;
     }
 
-    // Copy result into output vector.
+    while (psz != pEnd) {
+        uint64_t value = 0;
+        uint64_t multiplier = 1;
+        for (size_t i = 0; i < groupSize; i++) {
+            // Decode base58 character
+            const int8_t digit = mapBase58[(uint8_t)*psz];
+            // Invalid b58 character
+            if (digit == -1) {
+                throw std::exception();
+            }
+
+            value = (value * 58) + digit;
+            multiplier *= 58;
+            psz++;
+        }
+
+        MultiplyAdd(b256, BASE256_LIMB, multiplier, value);
+        groupSize = DIGITS_PER_LIMB;
+    }
+
+    // Copy result into output vector, skipping leading zeroes.
     std::vector<uint8_t> result;
-    result.reserve(zeroes + (b256.end() - it));
+    result.reserve(zeroes + (b256.size() * BYTES_PER_LIMB));
     result.assign(zeroes, 0x00);
 
-    while (it != b256.end()) {
-        result.push_back(*(it++));
+    bool leading = true;
+    for (auto it = b256.rbegin(); it != b256.rend(); it++) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            const uint8_t byte = (uint8_t)(*it >> shift);
+            if (leading && byte == 0) {
+                continue;
+            }
+
+            leading = false;
+            result.push_back(byte);
+        }
     }
 
     return result;
@@ -105,7 +147,6 @@ std::string Base58::Encode(const unsigned char* pbegin, const unsigned char* pen
 {
     // Skip & count leading zeroes.
     int zeroes = 0;
-    int length = 0;
 
     if (include_version) {
         while (pbegin != pend && *pbegin == 0) {
@@ -114,34 +155,52 @@ std::string Base58::Encode(const unsigned char* pbegin, const unsigned char* pen
         }
     }
 
-    // Allocate enough space in big-endian base58 representation.
-    size_t size = (pend - pbegin) * 138 / 100 + 1; // log(256) / log(58), rounded up.
-    std::vector<unsigned char> b58(size);
-    // Process the bytes.
+    // Little-endian base 58^5 limbs, with enough space allocated for the result.
+    const size_t numBytes = pend - pbegin;
+    std::vector<uint32_t> b58;
+    b58.reserve((numBytes * 138 / 100) / DIGITS_PER_LIMB + 1); // log(256) / log(58), rounded up.
+
+    // The first group takes the leftover bytes, so the rest are whole limbs.
+    size_t groupSize = numBytes % BYTES_PER_LIMB;
+    if (groupSize == 0) {
+        groupSize = BYTES_PER_LIMB;
+    }
+
     while (pbegin != pend) {
-        int carry = *pbegin;
-        int i = 0;
-        // Apply "b58 = b58 * 256 + ch".
-        for (std::vector<unsigned char>::reverse_iterator it = b58.rbegin(); (carry != 0 || i < length) && (it != b58.rend()); it++, i++) {
-            carry += 256 * (*it);
-            *it = carry % 58;
-            carry /= 58;
+        uint64_t value = 0;
+        for (size_t i = 0; i < groupSize; i++) {
+            value = (value << 8) | *(pbegin++);
         }
 
-        assert(carry == 0);
-        length = i;
-        pbegin++;
+        // Apply "b58 = b58 * 256^groupSize + value".
+        MultiplyAdd(b58, BASE58_LIMB, 1ull << (8 * groupSize), value);
+        groupSize = BYTES_PER_LIMB;
     }
-    // Skip leading zeroes in base58 result.
-    std::vector<unsigned char>::iterator it = b58.begin() + (size - length);
-    while (it != b58.end() && *it == 0)
-        it++;
-    // Translate the result into a string.
+
+    // Translate the result into a string, skipping leading zeroes in base58 result.
     std::string str;
-    str.reserve(zeroes + (b58.end() - it));
+    str.reserve(zeroes + (b58.size() * DIGITS_PER_LIMB));
     str.assign(zeroes, '1');
-    while (it != b58.end())
-        str += pszBase58[*(it++)];
+
+    bool leading = true;
+    for (auto it = b58.rbegin(); it != b58.rend(); it++) {
+        char digits[DIGITS_PER_LIMB];
+        uint32_t limb = *it;
+        for (int i = DIGITS_PER_LIMB - 1; i >= 0; i--) {
+            digits[i] = (char)(limb % 58);
+            limb /= 58;
+        }
+
+        for (int i = 0; i < DIGITS_PER_LIMB; i++) {
+            if (leading && digits[i] == 0) {
+                continue;
+            }
+
+            leading = false;
+            str += pszBase58[(int)digits[i]];
+        }
+    }
+
     return str;
 }
 
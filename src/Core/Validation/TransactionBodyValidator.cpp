@@ -1,29 +1,34 @@
 #include <Core/Validation/TransactionBodyValidator.h>
 
 #include <Core/Validation/KernelSignatureValidator.h>
+#include <Core/Validation/CutThroughVerifier.h>
 #include <Core/Exceptions/BadDataException.h>
 #include <Consensus/BlockWeight.h>
 #include <Consensus/Sorting.h>
 #include <Common/Logger.h>
 #include <Common/Util/HexUtil.h>
 #include <Crypto/Crypto.h>
-#include <set>
 
 // Validates all relevant parts of a transaction body. 
 // Checks the excess value against the signature as well as range proofs for each output.
 void TransactionBodyValidator::Validate(const TransactionBody& transactionBody, const bool withReward)
 {
-	ValidateWeight(transactionBody, withReward);
-	VerifySorted(transactionBody);
-	VerifyCutThrough(transactionBody);
+	ValidateStructure(transactionBody, withReward);
 	VerifyRangeProofs(transactionBody.GetOutputs());
 	
-	if (!KernelSignatureValidator::VerifyKernelSignatures(transactionBody.GetKernels()))
+	if (!KernelSignatureValidator::VerifyKernelSignaturesParallel(transactionBody.GetKernels()))
 	{
 		throw BAD_DATA_EXCEPTION("Kernel signatures invalid");
 	}
 }
 
+void TransactionBodyValidator::ValidateStructure(const TransactionBody& transactionBody, const bool withReward)
+{
+	ValidateWeight(transactionBody, withReward);
+	VerifyKernelsSorted(transactionBody);
+	VerifyInputsAndOutputs(transactionBody);
+}
+
 // Verify the body is not too big in terms of number of inputs|outputs|kernels.
 void TransactionBodyValidator::ValidateWeight(const TransactionBody& transactionBody, const bool withReward)
 {
@@ -39,56 +44,44 @@ void TransactionBodyValidator::ValidateWeight(const TransactionBody& transaction
 	}
 }
 
-void TransactionBodyValidator::VerifySorted(const TransactionBody& transactionBody)
+void TransactionBodyValidator::VerifyKernelsSorted(const TransactionBody& transactionBody)
 {
-	// TODO: Check for duplicates?
-	const bool sorted = Consensus::IsSorted(transactionBody.GetInputs())
-		&& Consensus::IsSorted(transactionBody.GetOutputs())
-		&& Consensus::IsSorted(transactionBody.GetKernels());
-	if (!sorted)
+	if (!Consensus::IsSortedAndUnique(transactionBody.GetKernels()))
 	{
-		throw BAD_DATA_EXCEPTION("Inputs, outputs, and/or kernels not sorted.");
+		throw BAD_DATA_EXCEPTION("Kernels not sorted, or duplicated.");
 	}
 }
 
-// Verify that no input is spending an output from the same block.
-void TransactionBodyValidator::VerifyCutThrough(const TransactionBody& transactionBody)
+// Verify the inputs and outputs are sorted without duplicates, and that no input is spending an output from the same block.
+void TransactionBodyValidator::VerifyInputsAndOutputs(const TransactionBody& transactionBody)
 {
-	const std::vector<TransactionOutput>& outputs = transactionBody.GetOutputs();
-	const std::vector<TransactionInput>& inputs = transactionBody.GetInputs();
-
-	// Create set with output commitments
-	std::set<Commitment> commitments;
-	std::transform(
-		outputs.cbegin(),
-		outputs.cend(),
-		std::inserter(commitments, commitments.end()),
-		[](const TransactionOutput& output) { return output.GetCommitment(); }
-	);
-
-	// Verify none of the input commitments are in the commitments set
-	const bool invalid = std::any_of(
-		inputs.cbegin(),
-		inputs.cend(),
-		[&commitments](const TransactionInput& input) { return commitments.find(input.GetCommitment()) != commitments.cend(); }
-	);
-	if (invalid)
+	switch (CutThroughVerifier::Verify(transactionBody))
 	{
-		throw BAD_DATA_EXCEPTION("Cut-through not performed correctly.");
+		case CutThroughVerifier::EResult::VALID:
+			return;
+		case CutThroughVerifier::EResult::NOT_SORTED:
+			throw BAD_DATA_EXCEPTION("Inputs and/or outputs not sorted.");
+		case CutThroughVerifier::EResult::DUPLICATE:
+			throw BAD_DATA_EXCEPTION("Duplicate inputs and/or outputs.");
+		case CutThroughVerifier::EResult::CUT_THROUGH:
+			throw BAD_DATA_EXCEPTION("Cut-through not performed correctly.");
 	}
 }
 
 void TransactionBodyValidator::VerifyRangeProofs(const std::vector<TransactionOutput>& outputs)
 {
-	std::vector<std::pair<Commitment, RangeProof>> rangeProofs;
-	std::transform(
-		outputs.cbegin(),
-		outputs.cend(),
-		std::back_inserter(rangeProofs),
-		[](const TransactionOutput& output) { return std::make_pair(output.GetCommitment(), output.GetRangeProof()); }
-	);
+	std::vector<Commitment> commitments;
+	commitments.reserve(outputs.size());
+
+	std::vector<const RangeProof*> rangeProofs;
+	rangeProofs.reserve(outputs.size());
+	for (const TransactionOutput& output : outputs)
+	{
+		commitments.push_back(output.GetCommitment());
+		rangeProofs.push_back(&output.GetRangeProof());
+	}
 
-	if (!Crypto::VerifyRangeProofs(rangeProofs))
+	if (!Crypto::VerifyRangeProofs(commitments, rangeProofs))
 	{
 		throw BAD_DATA_EXCEPTION("Range proofs invalid.");
 	}
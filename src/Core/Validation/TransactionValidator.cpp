@@ -3,13 +3,27 @@
 
 #include <Common/Util/HexUtil.h>
 #include <Core/Validation/KernelSumValidator.h>
+#include <Core/Validation/KernelSignatureValidator.h>
+#include <Crypto/Crypto.h>
 #include <Common/Logger.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 
+// Batches smaller than this don't save enough per proof to be worth another thread.
+static const size_t MIN_TRANSACTIONS_PER_CHUNK = 8;
+
 // See: https://github.com/mimblewimble/docs/wiki/Validation-logic
 void TransactionValidator::Validate(const Transaction& transaction) const
 {
+	if (transaction.WasValidated())
+	{
+		LOG_TRACE_F("Transaction {} already validated", transaction);
+		return;
+	}
+
 	// Validate the "transaction body"
 	TransactionBodyValidator().Validate(transaction.GetBody(), true);
 
@@ -18,6 +32,124 @@ void TransactionValidator::Validate(const Transaction& transaction) const
 
 	// Verify the big "sum": all inputs plus reward+fee, all output commitments, all kernels plus the kernel excess
 	ValidateKernelSums(transaction);
+
+	transaction.MarkAsValidated();
+}
+
+std::vector<bool> TransactionValidator::ValidateBatch(const std::vector<TransactionPtr>& transactions) const
+{
+	// Written by several threads at once, which std::vector<bool> doesn't allow.
+	std::vector<uint8_t> valid(transactions.size(), 0);
+
+	ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+	const size_t maxChunks = (transactions.size() + MIN_TRANSACTIONS_PER_CHUNK - 1) / MIN_TRANSACTIONS_PER_CHUNK;
+	const size_t numChunks = (std::min)(threadPool.GetNumThreads() + 1, maxChunks);
+	if (numChunks <= 1)
+	{
+		ValidateChunk(transactions, 0, transactions.size(), valid);
+	}
+	else
+	{
+		const size_t chunkSize = (transactions.size() + numChunks - 1) / numChunks;
+		std::atomic_size_t nextChunk = 0;
+		threadPool.RunParallel(numChunks, [&]() {
+			for (size_t begin = (nextChunk++) * chunkSize; begin < transactions.size(); begin = (nextChunk++) * chunkSize)
+			{
+				ValidateChunk(transactions, begin, (std::min)(begin + chunkSize, transactions.size()), valid);
+			}
+		}, ETaskPriority::HIGH);
+	}
+
+	return std::vector<bool>(valid.cbegin(), valid.cend());
+}
+
+void TransactionValidator::ValidateChunk(const std::vector<TransactionPtr>& transactions, const size_t begin, const size_t end, std::vector<uint8_t>& valid) const
+{
+	// The checks that don't need any proofs are done first, so only structurally valid transactions get batched.
+	std::vector<TransactionPtr> unverified;
+	std::vector<size_t> indices;
+	for (size_t i = begin; i < end; i++)
+	{
+		const Transaction& transaction = *transactions[i];
+		if (transaction.WasValidated())
+		{
+			valid[i] = 1;
+			continue;
+		}
+
+		try
+		{
+			TransactionBodyValidator().ValidateStructure(transaction.GetBody(), true);
+			ValidateFeatures(transaction.GetBody());
+			ValidateKernelSums(transaction);
+
+			unverified.push_back(transactions[i]);
+			indices.push_back(i);
+		}
+		catch (std::exception& e)
+		{
+			LOG_DEBUG_F("Transaction {} invalid: {}", transaction, e.what());
+		}
+	}
+
+	std::vector<uint8_t> rejected(unverified.size(), 0);
+
+	std::vector<size_t> invalidRangeProofs;
+	FindInvalidRangeProofs(unverified, 0, unverified.size(), invalidRangeProofs);
+	for (const size_t index : invalidRangeProofs)
+	{
+		rejected[index] = 1;
+	}
+
+	// Kernels of a tx with a bad rangeproof are verified anyway, since that's still a single batch when the rest are valid.
+	for (const size_t index : KernelSignatureValidator::FindInvalidTransactions(unverified))
+	{
+		rejected[index] = 1;
+	}
+
+	for (size_t i = 0; i < unverified.size(); i++)
+	{
+		if (rejected[i] == 0)
+		{
+			unverified[i]->MarkAsValidated();
+			valid[indices[i]] = 1;
+		}
+	}
+}
+
+void TransactionValidator::FindInvalidRangeProofs(const std::vector<TransactionPtr>& transactions, const size_t begin, const size_t end, std::vector<size_t>& invalid)
+{
+	if (begin == end)
+	{
+		return;
+	}
+
+	std::vector<Commitment> commitments;
+	std::vector<const RangeProof*> rangeProofs;
+	for (size_t i = begin; i < end; i++)
+	{
+		for (const TransactionOutput& output : transactions[i]->GetOutputs())
+		{
+			commitments.push_back(output.GetCommitment());
+			rangeProofs.push_back(&output.GetRangeProof());
+		}
+	}
+
+	if (Crypto::VerifyRangeProofs(commitments, rangeProofs))
+	{
+		return;
+	}
+
+	if (end - begin == 1)
+	{
+		LOG_DEBUG_F("Invalid rangeproof in transaction ({})", *transactions[begin]);
+		invalid.push_back(begin);
+		return;
+	}
+
+	const size_t middle = begin + (end - begin) / 2;
+	FindInvalidRangeProofs(transactions, begin, middle, invalid);
+	FindInvalidRangeProofs(transactions, middle, end, invalid);
 }
 
 void TransactionValidator::ValidateFeatures(const TransactionBody& transactionBody) const
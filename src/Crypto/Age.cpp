@@ -26,14 +26,15 @@ std::vector<uint8_t> Age::Encrypt(
         file_key.GetData()
     );
 
-    Serializer serializer;
-    serializer.AppendStr(header.Encode());
-    serializer.AppendBigInteger(nonce);
+    const std::string encoded_header = header.Encode();
 
-    std::vector<uint8_t> encrypted_payload = ChaChaPoly::Init(payload_key).StreamEncrypt(payload);
-    serializer.AppendByteVector(encrypted_payload);
+    std::vector<uint8_t> encrypted(encoded_header.cbegin(), encoded_header.cend());
+    encrypted.insert(encrypted.end(), nonce.GetData().cbegin(), nonce.GetData().cend());
 
-    return serializer.GetBytes();
+    // Chunks are encrypted straight onto the end of the header, which grows the buffer once for the whole payload.
+    ChaChaPoly::Init(payload_key).StreamEncrypt(payload.data(), payload.size(), encrypted);
+
+    return encrypted;
 }
 
 std::vector<age::RecipientLine> Age::BuildRecipientLines(
@@ -68,7 +69,7 @@ std::vector<uint8_t> Age::Decrypt(
     const std::vector<uint8_t>& payload)
 {
     std::vector<std::string> encoded_header_lines;
-    ByteBuffer deserializer(payload);
+    ByteBuffer deserializer(payload.data(), payload.size());
     std::string encoded_header_line;
     while (true)
     {
@@ -86,7 +87,10 @@ std::vector<uint8_t> Age::Decrypt(
     }
 
     CBigInteger<16> file_key_nonce = deserializer.ReadBigInteger<16>();
-    std::vector<uint8_t> encrypted_payload = deserializer.ReadRemainingBytes();
+
+    // The payload is decrypted where it is, rather than copied out of the message first.
+    const uint8_t* pEncryptedPayload = payload.data() + deserializer.GetIndex();
+    const size_t encryptedPayloadSize = deserializer.GetRemainingSize();
 
     age::Header header = age::Header::Decode(encoded_header_lines);
 
@@ -97,7 +101,8 @@ std::vector<uint8_t> Age::Decrypt(
             recipient_line,
             file_key_nonce,
             header,
-            encrypted_payload
+            pEncryptedPayload,
+            encryptedPayloadSize
         );
         if (!decrypted.empty()) {
             return decrypted;
@@ -112,7 +117,8 @@ std::vector<uint8_t> Age::TryDecrypt(
     const age::RecipientLine& recipient_line,
     const CBigInteger<16>& file_key_nonce,
     const age::Header& /*header*/,
-    const std::vector<uint8_t>& encrypted_payload)
+    const uint8_t* pEncryptedPayload,
+    const size_t encryptedPayloadSize)
 {
     try
     {
@@ -142,7 +148,7 @@ std::vector<uint8_t> Age::TryDecrypt(
             decrypted_file_key
         );
 
-        return ChaChaPoly::Init(payload_key).StreamDecrypt(encrypted_payload);
+        return ChaChaPoly::Init(payload_key).StreamDecrypt(pEncryptedPayload, encryptedPayloadSize);
     }
     catch (const std::exception&)
     {
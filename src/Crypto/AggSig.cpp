@@ -8,10 +8,26 @@
 #include <Common/Logger.h>
 #include <Crypto/CSPRNG.h>
 #include <Crypto/CryptoException.h>
+#include <algorithm>
+#include <array>
+#include <thread>
 
 const uint64_t MAX_WIDTH = 1 << 20;
 const size_t SCRATCH_SPACE_SIZE = 256 * MAX_WIDTH;
 
+// Batch verification only needs scratch space for its multi-exponentiation, which splits its 2 points per signature
+// into batches that fit. These leave room for every point of the batch at once, up to the cap.
+static const size_t MIN_BATCH_SCRATCH_SPACE_SIZE = 1 << 20;
+static const size_t BATCH_SCRATCH_SPACE_PER_SIGNATURE = 4 * 1024;
+
+// Idle buffers are kept only if they're no bigger than a batch of this many signatures needs.
+static const size_t POOLED_BATCH_SIGNATURES = 1024;
+
+static size_t GetBatchScratchSpaceSize(const size_t numSignatures)
+{
+	return std::min(MIN_BATCH_SCRATCH_SPACE_SIZE + (numSignatures * BATCH_SCRATCH_SPACE_PER_SIGNATURE), SCRATCH_SPACE_SIZE);
+}
+
 static AggSig instance;
 
 AggSig& AggSig::GetInstance()
@@ -26,6 +42,7 @@ AggSig::AggSig()
 
 AggSig::~AggSig()
 {
+	m_batchScratches.clear();
 	secp256k1_context_destroy(m_pContext);
 }
 
@@ -214,76 +231,193 @@ std::unique_ptr<Signature> AggSig::AggregateSignatures(const std::vector<Compact
 	return std::unique_ptr<Signature>(nullptr);
 }
 
-bool AggSig::VerifyAggregateSignatures(const std::vector<const Signature*>& signatures, const std::vector<const Commitment*>& commitments, const std::vector<const Hash*>& messages) const
+//
+// Everything a batch verification needs besides its inputs. These are pooled and reused across batches,
+// so verifying a block (or a chunk of kernels) doesn't allocate and free a scratch space and a fresh set of parse buffers each time.
+//
+struct BatchVerifyScratch
+{
+	~BatchVerifyScratch()
+	{
+		if (pScratchSpace != nullptr)
+		{
+			secp256k1_scratch_space_destroy(pScratchSpace);
+		}
+	}
+
+	secp256k1_scratch_space* pScratchSpace = nullptr;
+	size_t scratchSpaceSize = 0;
+	std::vector<secp256k1_pubkey> pubKeys;
+	std::vector<secp256k1_pubkey*> pubKeyPtrs;
+	std::vector<secp256k1_schnorrsig> signatures;
+	std::vector<const secp256k1_schnorrsig*> signaturePtrs;
+	std::vector<const unsigned char*> messages;
+	std::vector<size_t> unverified;
+	std::vector<uint64_t> fingerprints;
+};
+
+std::unique_ptr<BatchVerifyScratch> AggSig::AcquireBatchScratch() const
+{
+	{
+		std::unique_lock<std::mutex> lock(m_batchScratchMutex);
+		if (!m_batchScratches.empty())
+		{
+			std::unique_ptr<BatchVerifyScratch> pScratch = std::move(m_batchScratches.back());
+			m_batchScratches.pop_back();
+			return pScratch;
+		}
+	}
+
+	return std::make_unique<BatchVerifyScratch>();
+}
+
+void AggSig::ReleaseBatchScratch(std::unique_ptr<BatchVerifyScratch>&& pScratch) const
+{
+	// Same as Bulletproofs::ReleaseVerifier: at most one idle buffer per core, and none left over from an unusually large batch.
+	const size_t maxIdle = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	if (pScratch->scratchSpaceSize > GetBatchScratchSpaceSize(POOLED_BATCH_SIGNATURES))
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_batchScratchMutex);
+	if (m_batchScratches.size() < maxIdle)
+	{
+		m_batchScratches.emplace_back(std::move(pScratch));
+	}
+}
+
+bool AggSig::VerifyAggregateSignatures(
+	const std::vector<const Signature*>& signatures,
+	const std::vector<const Commitment*>& commitments,
+	const std::vector<const Hash*>& messages,
+	const bool cacheResults) const
+{
+	std::unique_ptr<BatchVerifyScratch> pScratch = AcquireBatchScratch();
+	const bool verified = VerifyAggregateSignatures(*pScratch, signatures, commitments, messages, cacheResults);
+	ReleaseBatchScratch(std::move(pScratch));
+
+	return verified;
+}
+
+bool AggSig::VerifyAggregateSignatures(
+	BatchVerifyScratch& scratch,
+	const std::vector<const Signature*>& signatures,
+	const std::vector<const Commitment*>& commitments,
+	const std::vector<const Hash*>& messages,
+	const bool cacheResults) const
 {
+
+	// Signature (64 bytes), excess commitment (33 bytes) and message (32 bytes).
+	std::array<uint8_t, 64 + 33 + 32> preimage;
+	scratch.unverified.clear();
+	scratch.fingerprints.clear();
+	for (size_t i = 0; i < signatures.size(); i++)
+	{
+		const auto& signatureBytes = signatures[i]->GetSignatureBytes();
+		std::copy(signatureBytes.data(), signatureBytes.data() + 64, preimage.begin());
+		std::copy(commitments[i]->data(), commitments[i]->data() + 33, preimage.begin() + 64);
+		std::copy(messages[i]->data(), messages[i]->data() + 32, preimage.begin() + 64 + 33);
+
+		const uint64_t fingerprint = m_cache.Fingerprint(preimage.data(), preimage.size());
+		if (!m_cache.WasAlreadyVerified(fingerprint))
+		{
+			scratch.unverified.push_back(i);
+			scratch.fingerprints.push_back(fingerprint);
+		}
+	}
+
+	if (scratch.unverified.empty())
+	{
+		return true;
+	}
+
 	std::shared_lock<std::shared_mutex> readLock(m_mutex);
 
-	std::vector<secp256k1_pubkey> parsedPubKeys;
-	for (const Commitment* commitment : commitments)
+	const size_t numUnverified = scratch.unverified.size();
+	const size_t scratchSpaceSize = GetBatchScratchSpaceSize(numUnverified);
+	if (scratch.scratchSpaceSize < scratchSpaceSize)
 	{
+		if (scratch.pScratchSpace != nullptr)
+		{
+			secp256k1_scratch_space_destroy(scratch.pScratchSpace);
+			scratch.scratchSpaceSize = 0;
+		}
+
+		scratch.pScratchSpace = secp256k1_scratch_space_create(m_pContext, scratchSpaceSize);
+		if (scratch.pScratchSpace == nullptr)
+		{
+			throw CRYPTO_EXCEPTION_F("Failed to allocate {} byte scratch space", scratchSpaceSize);
+		}
+
+		scratch.scratchSpaceSize = scratchSpaceSize;
+	}
+	scratch.pubKeys.resize(numUnverified);
+	for (size_t j = 0; j < numUnverified; j++)
+	{
+		const Commitment* pCommitment = commitments[scratch.unverified[j]];
+
 		secp256k1_pedersen_commitment parsedCommitment;
-		const int commitmentResult = secp256k1_pedersen_commitment_parse(m_pContext, &parsedCommitment, commitment->data());
+		const int commitmentResult = secp256k1_pedersen_commitment_parse(m_pContext, &parsedCommitment, pCommitment->data());
 		if (commitmentResult == 1)
 		{
-			secp256k1_pubkey pubKey;
-			const int pubkeyResult = secp256k1_pedersen_commitment_to_pubkey(m_pContext, &pubKey, &parsedCommitment);
-			if (pubkeyResult == 1)
-			{
-				parsedPubKeys.emplace_back(std::move(pubKey));
-			}
-			else
+			const int pubkeyResult = secp256k1_pedersen_commitment_to_pubkey(m_pContext, &scratch.pubKeys[j], &parsedCommitment);
+			if (pubkeyResult != 1)
 			{
-				LOG_ERROR("Failed to convert commitment to pubkey: " + commitment->ToHex());
+				LOG_ERROR("Failed to convert commitment to pubkey: " + pCommitment->ToHex());
 				return false;
 			}
 		}
 		else
 		{
-			LOG_ERROR("Failed to parse commitment " + commitment->ToHex());
+			LOG_ERROR("Failed to parse commitment " + pCommitment->ToHex());
 			return false;
 		}
 	}
 
-	std::vector<secp256k1_pubkey*> pubKeyPtrs(parsedPubKeys.size());
-	for (size_t i = 0; i < parsedPubKeys.size(); i++)
+	scratch.pubKeyPtrs.resize(scratch.pubKeys.size());
+	for (size_t i = 0; i < scratch.pubKeys.size(); i++)
 	{
-		pubKeyPtrs[i] = &parsedPubKeys[i];
+		scratch.pubKeyPtrs[i] = &scratch.pubKeys[i];
 	}
 
-	std::vector<secp256k1_schnorrsig> parsedSignatures;
-	for (const Signature* signature : signatures)
+	scratch.signatures.resize(numUnverified);
+	scratch.signaturePtrs.resize(numUnverified);
+	for (size_t j = 0; j < numUnverified; j++)
 	{
-		secp256k1_schnorrsig parsedSig;
-		if (secp256k1_schnorrsig_parse(m_pContext, &parsedSig, signature->GetSignatureBytes().data()) == 0)
+		if (secp256k1_schnorrsig_parse(m_pContext, &scratch.signatures[j], signatures[scratch.unverified[j]]->GetSignatureBytes().data()) == 0)
 		{
 			return false;
 		}
 
-		parsedSignatures.emplace_back(std::move(parsedSig));
+		scratch.signaturePtrs[j] = &scratch.signatures[j];
 	}
 
-	std::vector<const secp256k1_schnorrsig*> signaturePtrs;
-	std::transform(
-		parsedSignatures.cbegin(),
-		parsedSignatures.cend(),
-		std::back_inserter(signaturePtrs),
-		[](const secp256k1_schnorrsig& parsedSig) { return &parsedSig; }
-	);
+	scratch.messages.resize(numUnverified);
+	for (size_t j = 0; j < numUnverified; j++)
+	{
+		scratch.messages[j] = messages[scratch.unverified[j]]->data();
+	}
 
-	std::vector<const unsigned char*> messageData;
-	std::transform(
-		messages.cbegin(),
-		messages.cend(),
-		std::back_inserter(messageData),
-		[](const Hash* pMessage) { return pMessage->data(); }
+	const int verifyResult = secp256k1_schnorrsig_verify_batch(
+		m_pContext,
+		scratch.pScratchSpace,
+		scratch.signaturePtrs.data(),
+		scratch.messages.data(),
+		scratch.pubKeyPtrs.data(),
+		numUnverified
 	);
 
-	secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(m_pContext, SCRATCH_SPACE_SIZE);
-	const int verifyResult = secp256k1_schnorrsig_verify_batch(m_pContext, pScratchSpace, signaturePtrs.data(), messageData.data(), pubKeyPtrs.data(), signatures.size());
-	secp256k1_scratch_space_destroy(pScratchSpace);
-
 	if (verifyResult == 1)
 	{
+		if (cacheResults)
+		{
+			for (const uint64_t fingerprint : scratch.fingerprints)
+			{
+				m_cache.AddToCache(fingerprint);
+			}
+		}
+
 		return true;
 	}
 	else
@@ -2,6 +2,8 @@
 
 #include <secp256k1-zkp/secp256k1_aggsig.h>
 
+#include "VerifiedCache.h"
+
 #include <Crypto/Commitment.h>
 #include <Crypto/SecretKey.h>
 #include <Crypto/Signature.h>
@@ -9,10 +11,12 @@
 #include <Crypto/Hash.h>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
 
 // Forward Declarations
 typedef struct secp256k1_context_struct secp256k1_context;
+struct BatchVerifyScratch;
 
 class AggSig
 {
@@ -29,13 +33,44 @@ public:
 	bool VerifyPartialSignature(const CompactSignature& partialSignature, const PublicKey& publicKey, const PublicKey& sumPubKeys, const PublicKey& sumPubNonces, const Hash& message) const;
 
 	std::unique_ptr<Signature> AggregateSignatures(const std::vector<CompactSignature>& signatures, const PublicKey& sumPubNonces) const;
-	bool VerifyAggregateSignatures(const std::vector<const Signature*>& signatures, const std::vector<const Commitment*>& publicKeys, const std::vector<const Hash*>& messages) const;
+	//
+	// Batch verifies the kernel signatures, skipping those already verified with the same excess and message.
+	// Verified signatures are only remembered when cacheResults is set, so a one-off verification of the whole
+	// kernel history (during sync) doesn't evict the mempool's kernels.
+	//
+	bool VerifyAggregateSignatures(
+		const std::vector<const Signature*>& signatures,
+		const std::vector<const Commitment*>& publicKeys,
+		const std::vector<const Hash*>& messages,
+		const bool cacheResults = true
+	) const;
 	bool VerifyAggregateSignature(const Signature& signature, const PublicKey& sumPubKeys, const Hash& message) const;
 
 	std::vector<secp256k1_ecdsa_signature> ParseCompactSignatures(const std::vector<CompactSignature>& signatures) const;
 	CompactSignature ToCompact(const Signature& signature) const;
 
+	void SetCacheCapacity(const size_t capacity) { m_cache.SetCapacity(capacity); }
+	CacheStats GetCacheStats() const { return m_cache.GetStats(); }
+
 private:
+	bool VerifyAggregateSignatures(
+		BatchVerifyScratch& scratch,
+		const std::vector<const Signature*>& signatures,
+		const std::vector<const Commitment*>& publicKeys,
+		const std::vector<const Hash*>& messages,
+		const bool cacheResults
+	) const;
+
+	std::unique_ptr<BatchVerifyScratch> AcquireBatchScratch() const;
+	void ReleaseBatchScratch(std::unique_ptr<BatchVerifyScratch>&& pScratch) const;
+
 	mutable std::shared_mutex m_mutex;
 	secp256k1_context* m_pContext;
+
+	// Keyed by the signature, excess commitment and message, which together are everything verification depends on.
+	mutable VerifiedCache m_cache;
+
+	// Idle batch verification buffers, shared by all verifying threads.
+	mutable std::mutex m_batchScratchMutex;
+	mutable std::vector<std::unique_ptr<BatchVerifyScratch>> m_batchScratches;
 };
\ No newline at end of file
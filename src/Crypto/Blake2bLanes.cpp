@@ -0,0 +1,323 @@
+#include "Blake2bLanes.h"
+
+#include <cstring>
+
+// The lanes are only implemented for x86-64 compilers that can target AVX2/AVX-512 per-function.
+#if defined(__GNUC__) && defined(__x86_64__)
+#define BLAKE2B_LANES_SUPPORTED 1
+#include <immintrin.h>
+#else
+#define BLAKE2B_LANES_SUPPORTED 0
+#endif
+
+#if BLAKE2B_LANES_SUPPORTED
+
+static const size_t BLOCK_SIZE = 128;
+
+static const uint64_t IV[8] = {
+	0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+	0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+// Parameter block for an unkeyed hash with a 32 byte output: digest length, key length 0, fanout 1, depth 1.
+static const uint64_t PARAMS = 0x01010020ULL;
+
+static const uint8_t SIGMA[12][16] = {
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 },
+	{ 11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4 },
+	{ 7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8 },
+	{ 9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13 },
+	{ 2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9 },
+	{ 12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11 },
+	{ 13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10 },
+	{ 6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5 },
+	{ 10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0 },
+	{ 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+	{ 14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3 }
+};
+
+//
+// The mixing function and rounds, written once for both vector widths.
+// The rounds are fully unrolled, so every message word index is a constant and m[] stays in registers.
+//
+#define BLAKE2B_G(ADD, XOR, ROR, r, i, a, b, c, d) \
+	v[a] = ADD(ADD(v[a], v[b]), m[SIGMA[r][2 * i]]); \
+	v[d] = ROR(XOR(v[d], v[a]), 32); \
+	v[c] = ADD(v[c], v[d]); \
+	v[b] = ROR(XOR(v[b], v[c]), 24); \
+	v[a] = ADD(ADD(v[a], v[b]), m[SIGMA[r][2 * i + 1]]); \
+	v[d] = ROR(XOR(v[d], v[a]), 16); \
+	v[c] = ADD(v[c], v[d]); \
+	v[b] = ROR(XOR(v[b], v[c]), 63);
+
+#define BLAKE2B_ROUND(ADD, XOR, ROR, r) \
+	BLAKE2B_G(ADD, XOR, ROR, r, 0, 0, 4, 8, 12) \
+	BLAKE2B_G(ADD, XOR, ROR, r, 1, 1, 5, 9, 13) \
+	BLAKE2B_G(ADD, XOR, ROR, r, 2, 2, 6, 10, 14) \
+	BLAKE2B_G(ADD, XOR, ROR, r, 3, 3, 7, 11, 15) \
+	BLAKE2B_G(ADD, XOR, ROR, r, 4, 0, 5, 10, 15) \
+	BLAKE2B_G(ADD, XOR, ROR, r, 5, 1, 6, 11, 12) \
+	BLAKE2B_G(ADD, XOR, ROR, r, 6, 2, 7, 8, 13) \
+	BLAKE2B_G(ADD, XOR, ROR, r, 7, 3, 4, 9, 14)
+
+#define BLAKE2B_ROUNDS(ADD, XOR, ROR) \
+	BLAKE2B_ROUND(ADD, XOR, ROR, 0) BLAKE2B_ROUND(ADD, XOR, ROR, 1) BLAKE2B_ROUND(ADD, XOR, ROR, 2) \
+	BLAKE2B_ROUND(ADD, XOR, ROR, 3) BLAKE2B_ROUND(ADD, XOR, ROR, 4) BLAKE2B_ROUND(ADD, XOR, ROR, 5) \
+	BLAKE2B_ROUND(ADD, XOR, ROR, 6) BLAKE2B_ROUND(ADD, XOR, ROR, 7) BLAKE2B_ROUND(ADD, XOR, ROR, 8) \
+	BLAKE2B_ROUND(ADD, XOR, ROR, 9) BLAKE2B_ROUND(ADD, XOR, ROR, 10) BLAKE2B_ROUND(ADD, XOR, ROR, 11)
+
+//
+// The messages split into blocks, with the last (partial or empty) block of each copied into zero padding.
+// Each block is staged back-to-back for every lane, so word w of every lane can be gathered into one vector.
+//
+class LaneBlocks
+{
+public:
+	LaneBlocks(const uint8_t* const* pInputs, const size_t numLanes, const size_t len)
+		: m_pInputs(pInputs), m_numLanes(numLanes), m_len(len), m_lastBlocks{}
+	{
+		m_numBlocks = len == 0 ? 1 : (len + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+		const size_t lastOffset = (m_numBlocks - 1) * BLOCK_SIZE;
+		for (size_t lane = 0; lane < numLanes; lane++)
+		{
+			if (len > lastOffset)
+			{
+				std::memcpy(m_lastBlocks[lane], pInputs[lane] + lastOffset, len - lastOffset);
+			}
+		}
+	}
+
+	size_t GetNumBlocks() const noexcept { return m_numBlocks; }
+	bool IsLast(const size_t block) const noexcept { return block + 1 == m_numBlocks; }
+
+	// The number of message bytes hashed once the block has been compressed.
+	uint64_t GetCounter(const size_t block) const noexcept { return IsLast(block) ? m_len : (block + 1) * BLOCK_SIZE; }
+
+	// Lane l's block starts at (l * BLOCK_SIZE). Blake2b words are little-endian, as is every x86 cpu.
+	const uint8_t* GetBlocks(const size_t block) noexcept
+	{
+		if (IsLast(block))
+		{
+			return &m_lastBlocks[0][0];
+		}
+
+		for (size_t lane = 0; lane < m_numLanes; lane++)
+		{
+			std::memcpy(m_blocks[lane], m_pInputs[lane] + (block * BLOCK_SIZE), BLOCK_SIZE);
+		}
+
+		return &m_blocks[0][0];
+	}
+
+	static void StoreOutputs(const uint64_t (&words)[4][Blake2bLanes::MAX_LANES], const size_t numLanes, uint8_t* const* pOutputs) noexcept
+	{
+		for (size_t lane = 0; lane < numLanes; lane++)
+		{
+			for (size_t w = 0; w < 4; w++)
+			{
+				std::memcpy(pOutputs[lane] + (w * 8), &words[w][lane], 8);
+			}
+		}
+	}
+
+private:
+	const uint8_t* const* m_pInputs;
+	size_t m_numLanes;
+	size_t m_len;
+	size_t m_numBlocks;
+	alignas(64) uint8_t m_blocks[Blake2bLanes::MAX_LANES][BLOCK_SIZE];
+	alignas(64) uint8_t m_lastBlocks[Blake2bLanes::MAX_LANES][BLOCK_SIZE];
+};
+
+//
+// AVX2 has no 64-bit rotate, so the byte-aligned rotations are byte shuffles, and the rest are shifts.
+//
+template <int N>
+__attribute__((target("avx2"))) static inline __m256i Ror256(const __m256i x)
+{
+	if constexpr (N == 32)
+	{
+		return _mm256_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1));
+	}
+	else if constexpr (N == 24)
+	{
+		const __m256i mask = _mm256_setr_epi8(
+			3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10,
+			3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10
+		);
+		return _mm256_shuffle_epi8(x, mask);
+	}
+	else if constexpr (N == 16)
+	{
+		const __m256i mask = _mm256_setr_epi8(
+			2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9,
+			2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9
+		);
+		return _mm256_shuffle_epi8(x, mask);
+	}
+	else
+	{
+		return _mm256_or_si256(_mm256_srli_epi64(x, N), _mm256_slli_epi64(x, 64 - N));
+	}
+}
+
+#define BLAKE2B_ROR256(x, n) Ror256<n>(x)
+#define BLAKE2B_ROR512(x, n) _mm512_or_si512(_mm512_srli_epi64(x, n), _mm512_slli_epi64(x, 64 - n))
+
+__attribute__((target("avx2"))) static void Hash4(const uint8_t* const* pInputs, const size_t len, uint8_t* const* pOutputs)
+{
+	LaneBlocks blocks(pInputs, 4, len);
+	const __m256i offsets = _mm256_setr_epi64x(0, BLOCK_SIZE, 2 * BLOCK_SIZE, 3 * BLOCK_SIZE);
+
+	__m256i h[8];
+	for (size_t i = 0; i < 8; i++)
+	{
+		h[i] = _mm256_set1_epi64x((long long)IV[i]);
+	}
+
+	h[0] = _mm256_xor_si256(h[0], _mm256_set1_epi64x((long long)PARAMS));
+
+	for (size_t block = 0; block < blocks.GetNumBlocks(); block++)
+	{
+		const long long* pBlocks = (const long long*)blocks.GetBlocks(block);
+
+		__m256i m[16];
+		for (size_t w = 0; w < 16; w++)
+		{
+			m[w] = _mm256_i64gather_epi64(pBlocks + w, offsets, 1);
+		}
+
+		__m256i v[16];
+		for (size_t i = 0; i < 8; i++)
+		{
+			v[i] = h[i];
+			v[i + 8] = _mm256_set1_epi64x((long long)IV[i]);
+		}
+
+		// Messages are far smaller than 2^64 bytes, so the high word of the counter is always 0.
+		v[12] = _mm256_xor_si256(v[12], _mm256_set1_epi64x((long long)blocks.GetCounter(block)));
+		if (blocks.IsLast(block))
+		{
+			v[14] = _mm256_xor_si256(v[14], _mm256_set1_epi64x(-1));
+		}
+
+		BLAKE2B_ROUNDS(_mm256_add_epi64, _mm256_xor_si256, BLAKE2B_ROR256)
+
+		for (size_t i = 0; i < 8; i++)
+		{
+			h[i] = _mm256_xor_si256(h[i], _mm256_xor_si256(v[i], v[i + 8]));
+		}
+	}
+
+	alignas(64) uint64_t outputWords[4][Blake2bLanes::MAX_LANES];
+	for (size_t w = 0; w < 4; w++)
+	{
+		_mm256_store_si256((__m256i*)outputWords[w], h[w]);
+	}
+
+	LaneBlocks::StoreOutputs(outputWords, 4, pOutputs);
+}
+
+__attribute__((target("avx512f"))) static void Hash8(const uint8_t* const* pInputs, const size_t len, uint8_t* const* pOutputs)
+{
+	LaneBlocks blocks(pInputs, 8, len);
+	const __m512i offsets = _mm512_setr_epi64(
+		0, BLOCK_SIZE, 2 * BLOCK_SIZE, 3 * BLOCK_SIZE, 4 * BLOCK_SIZE, 5 * BLOCK_SIZE, 6 * BLOCK_SIZE, 7 * BLOCK_SIZE
+	);
+
+	__m512i h[8];
+	for (size_t i = 0; i < 8; i++)
+	{
+		h[i] = _mm512_set1_epi64((long long)IV[i]);
+	}
+
+	h[0] = _mm512_xor_si512(h[0], _mm512_set1_epi64((long long)PARAMS));
+
+	for (size_t block = 0; block < blocks.GetNumBlocks(); block++)
+	{
+		const long long* pBlocks = (const long long*)blocks.GetBlocks(block);
+
+		__m512i m[16];
+		for (size_t w = 0; w < 16; w++)
+		{
+			m[w] = _mm512_i64gather_epi64(offsets, (const void*)(pBlocks + w), 1);
+		}
+
+		__m512i v[16];
+		for (size_t i = 0; i < 8; i++)
+		{
+			v[i] = h[i];
+			v[i + 8] = _mm512_set1_epi64((long long)IV[i]);
+		}
+
+		v[12] = _mm512_xor_si512(v[12], _mm512_set1_epi64((long long)blocks.GetCounter(block)));
+		if (blocks.IsLast(block))
+		{
+			v[14] = _mm512_xor_si512(v[14], _mm512_set1_epi64(-1));
+		}
+
+		BLAKE2B_ROUNDS(_mm512_add_epi64, _mm512_xor_si512, BLAKE2B_ROR512)
+
+		for (size_t i = 0; i < 8; i++)
+		{
+			h[i] = _mm512_xor_si512(h[i], _mm512_xor_si512(v[i], v[i + 8]));
+		}
+	}
+
+	alignas(64) uint64_t outputWords[4][Blake2bLanes::MAX_LANES];
+	for (size_t w = 0; w < 4; w++)
+	{
+		_mm512_store_si512((void*)outputWords[w], h[w]);
+	}
+
+	LaneBlocks::StoreOutputs(outputWords, 8, pOutputs);
+}
+
+static size_t DetectNumLanes() noexcept
+{
+	// __builtin_cpu_supports also checks that the OS saves the vector registers.
+	if (__builtin_cpu_supports("avx512f"))
+	{
+		return 8;
+	}
+
+	if (__builtin_cpu_supports("avx2"))
+	{
+		return 4;
+	}
+
+	return 0;
+}
+
+size_t Blake2bLanes::GetNumLanes() noexcept
+{
+	static const size_t NUM_LANES = DetectNumLanes();
+	return NUM_LANES;
+}
+
+void Blake2bLanes::Hash(const uint8_t* const* pInputs, const size_t len, uint8_t* const* pOutputs)
+{
+	if (GetNumLanes() == 8)
+	{
+		Hash8(pInputs, len, pOutputs);
+	}
+	else
+	{
+		Hash4(pInputs, len, pOutputs);
+	}
+}
+
+#else
+
+size_t Blake2bLanes::GetNumLanes() noexcept
+{
+	return 0;
+}
+
+void Blake2bLanes::Hash(const uint8_t* const*, const size_t, uint8_t* const*)
+{
+}
+
+#endif
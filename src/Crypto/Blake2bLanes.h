@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+//
+// Blake2b (unkeyed, with a 32 byte output) of several messages at once, one message per 64-bit lane
+// of an AVX2 (4 lanes) or AVX-512 (8 lanes) vector, chosen at runtime from what the cpu supports.
+// The messages must all be the same length, so every lane shares the same block counter and padding.
+//
+class Blake2bLanes
+{
+public:
+	static constexpr size_t MAX_LANES = 8;
+
+	//
+	// The number of messages Hash takes, or 0 if the cpu (or compiler) has no usable vector unit.
+	//
+	static size_t GetNumLanes() noexcept;
+
+	//
+	// Hashes GetNumLanes() messages of len bytes each, writing 32 bytes to each output.
+	//
+	static void Hash(const uint8_t* const* pInputs, const size_t len, uint8_t* const* pOutputs);
+};
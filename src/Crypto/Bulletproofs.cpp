@@ -1,15 +1,16 @@
 #include "Bulletproofs.h"
 #include "Pedersen.h"
+#include "Context.h"
 
 #include <secp256k1-zkp/secp256k1_bulletproofs.h>
 #include <Common/Util/FunctionalUtil.h>
 #include <Common/Logger.h>
 #include <Crypto/CSPRNG.h>
 #include <Crypto/CryptoException.h>
-
-const uint64_t MAX_WIDTH = 1 << 20;
-const size_t SCRATCH_SPACE_SIZE = 256 * MAX_WIDTH;
-const size_t MAX_GENERATORS = 256;
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <thread>
 
 static Bulletproofs instance;
 
@@ -21,40 +22,141 @@ Bulletproofs& Bulletproofs::GetInstance()
 Bulletproofs::Bulletproofs()
 {
 	m_pContext = secp256k1_context_create(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
-	m_pGenerators = secp256k1_bulletproof_generators_create(m_pContext, &secp256k1_generator_const_g, MAX_GENERATORS);
 }
 
 Bulletproofs::~Bulletproofs()
 {
-	secp256k1_bulletproof_generators_destroy(m_pContext, m_pGenerators);
 	secp256k1_context_destroy(m_pContext);
 }
 
-bool Bulletproofs::VerifyBulletproofs(const std::vector<std::pair<Commitment, RangeProof>>& rangeProofs) const
+bool Bulletproofs::VerifyBulletproofs(const std::vector<Commitment>& commitments, const std::vector<const RangeProof*>& rangeProofs) const
 {
-	std::shared_lock<std::shared_mutex> readLock(m_mutex);
+	assert(commitments.size() == rangeProofs.size());
+	if (commitments.empty()) {
+		return true;
+	}
 
-	const size_t numBits = 64;
-	const size_t proofLength = rangeProofs.front().second.GetProofBytes().size();
+	const size_t proofLength = rangeProofs.front()->GetProofBytes().size();
 
-	std::vector<Commitment> commitments;
-	commitments.reserve(rangeProofs.size());
+	std::vector<Commitment> unverified;
+	unverified.reserve(commitments.size());
 
 	std::vector<const unsigned char*> bulletproofPointers;
-	bulletproofPointers.reserve(rangeProofs.size());
-	for (const std::pair<Commitment, RangeProof>& rangeProof : rangeProofs)
+	bulletproofPointers.reserve(commitments.size());
+
+	std::vector<uint64_t> fingerprints;
+	fingerprints.reserve(commitments.size());
+
+	std::array<uint8_t, 33 + MAX_PROOF_SIZE> preimage;
+	for (size_t i = 0; i < commitments.size(); i++)
 	{
-		if (!m_cache.WasAlreadyVerified(rangeProof.first))
+		const auto& proofBytes = rangeProofs[i]->GetProofBytes();
+		if (proofBytes.size() > (size_t)MAX_PROOF_SIZE) {
+			return false;
+		}
+
+		std::copy(commitments[i].data(), commitments[i].data() + 33, preimage.begin());
+		std::copy(proofBytes.cbegin(), proofBytes.cend(), preimage.begin() + 33);
+
+		const uint64_t fingerprint = m_cache.Fingerprint(preimage.data(), 33 + proofBytes.size());
+		if (!m_cache.WasAlreadyVerified(fingerprint))
 		{
-			commitments.push_back(rangeProof.first);
-			bulletproofPointers.emplace_back(rangeProof.second.GetProofBytes().data());
+			unverified.push_back(commitments[i]);
+			bulletproofPointers.emplace_back(proofBytes.data());
+			fingerprints.push_back(fingerprint);
 		}
 	}
 
-	if (commitments.empty()) {
+	if (unverified.empty()) {
 		return true;
 	}
 
+	RangeProofVerifier::UPtr pVerifier = AcquireVerifier();
+	const bool verified = pVerifier->Verify(unverified, bulletproofPointers, proofLength);
+	ReleaseVerifier(std::move(pVerifier));
+
+	if (!verified) {
+		return false;
+	}
+
+	for (const uint64_t fingerprint : fingerprints)
+	{
+		m_cache.AddToCache(fingerprint);
+	}
+
+	return true;
+}
+
+RangeProofVerifier::UPtr Bulletproofs::AcquireVerifier() const
+{
+	{
+		std::unique_lock<std::mutex> lock(m_verifiersMutex);
+		if (!m_verifiers.empty())
+		{
+			RangeProofVerifier::UPtr pVerifier = std::move(m_verifiers.back());
+			m_verifiers.pop_back();
+			return pVerifier;
+		}
+	}
+
+	return RangeProofVerifier::Create();
+}
+
+std::unique_ptr<Context> Bulletproofs::AcquireProver() const
+{
+	{
+		std::unique_lock<std::mutex> lock(m_proversMutex);
+		if (!m_provers.empty())
+		{
+			std::unique_ptr<Context> pProver = std::move(m_provers.back());
+			m_provers.pop_back();
+			return pProver;
+		}
+	}
+
+	return std::make_unique<Context>();
+}
+
+void Bulletproofs::ReleaseProver(std::unique_ptr<Context>&& pProver) const
+{
+	// Same as ReleaseVerifier: at most one idle prover per core.
+	const size_t maxIdle = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+	std::unique_lock<std::mutex> lock(m_proversMutex);
+	if (m_provers.size() < maxIdle)
+	{
+		m_provers.emplace_back(std::move(pProver));
+	}
+}
+
+void Bulletproofs::ReleaseVerifier(RangeProofVerifier::UPtr&& pVerifier) const
+{
+	// Keep at most one idle verifier per core. Any extras from a burst of concurrent callers are freed.
+	const size_t maxIdle = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+	// A verifier that grew for an unusually large batch gives its scratch space back rather than holding it while idle.
+	if (pVerifier->GetReservedScratchSpace() > RangeProofVerifier::GetScratchSpaceSize(POOLED_SCRATCH_SPACE_PROOFS))
+	{
+		pVerifier->ReleaseScratchSpace();
+	}
+
+	std::unique_lock<std::mutex> lock(m_verifiersMutex);
+	if (m_verifiers.size() < maxIdle)
+	{
+		m_verifiers.emplace_back(std::move(pVerifier));
+	}
+}
+
+bool Bulletproofs::VerifyBatch(
+	const secp256k1_context* pContext,
+	secp256k1_scratch_space* pScratchSpace,
+	const secp256k1_bulletproof_generators* pGenerators,
+	const std::vector<Commitment>& commitments,
+	const std::vector<const unsigned char*>& proofs,
+	const size_t proofLength)
+{
+	const size_t numBits = 64;
+
 	// array of generator multiplied by value in pedersen commitments (cannot be NULL)
 	std::vector<secp256k1_generator> valueGenerators;
 	for (size_t i = 0; i < commitments.size(); i++)
@@ -62,47 +164,34 @@ bool Bulletproofs::VerifyBulletproofs(const std::vector<std::pair<Commitment, Ra
 		valueGenerators.push_back(secp256k1_generator_const_h);
 	}
 
-	std::vector<secp256k1_pedersen_commitment*> commitmentPointers = Pedersen::ConvertCommitments(*m_pContext, commitments);
+	const ParsedCommitments parsedCommitments(*pContext, commitments);
 
-	secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(m_pContext, SCRATCH_SPACE_SIZE);
-	const int result = secp256k1_bulletproof_rangeproof_verify_multi(m_pContext, pScratchSpace, m_pGenerators, bulletproofPointers.data(), commitments.size(), proofLength, NULL, commitmentPointers.data(), 1, numBits, valueGenerators.data(), NULL, NULL);
-	secp256k1_scratch_space_destroy(pScratchSpace);
-
-	Pedersen::CleanupCommitments(commitmentPointers);
+	const int result = secp256k1_bulletproof_rangeproof_verify_multi(pContext, pScratchSpace, pGenerators, proofs.data(), commitments.size(), proofLength, NULL, parsedCommitments.data(), 1, numBits, valueGenerators.data(), NULL, NULL);
 
 	if (result != 1) {
 		LOG_ERROR_F("Failed to validate {} rangeproofs", commitments.size());
 		return false;
 	}
 
-	for (const Commitment& commitment : commitments)
-	{
-		m_cache.AddToCache(commitment);
-	}
-
 	return true;
 }
 
 RangeProof Bulletproofs::GenerateRangeProof(const uint64_t amount, const SecretKey& key, const SecretKey& privateNonce, const SecretKey& rewindNonce, const ProofMessage& proofMessage) const
 {
-	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
-
-	const SecretKey randomSeed = CSPRNG::GenerateRandom32();
-	const int randomizeResult = secp256k1_context_randomize(m_pContext, randomSeed.data());
-	if (randomizeResult != 1) {
-		throw CryptoException("secp256k1_context_randomize failed with error: " + std::to_string(randomizeResult));
-	}
+	// Randomizing modifies the context, so each prover is only used by one thread at a time.
+	std::unique_ptr<Context> pProver = AcquireProver();
+	secp256k1_context* pContext = pProver->Randomized();
 
 	std::vector<uint8_t> proofBytes(MAX_PROOF_SIZE, 0);
 	size_t proofLen = MAX_PROOF_SIZE;
 
-	secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(m_pContext, SCRATCH_SPACE_SIZE);
+	secp256k1_scratch_space* pScratchSpace = secp256k1_scratch_space_create(pContext, SCRATCH_SPACE_SIZE);
 
 	std::vector<const unsigned char*> blindingFactors({ key.data() });
 	int result = secp256k1_bulletproof_rangeproof_prove(
-		m_pContext,
+		pContext,
 		pScratchSpace,
-		m_pGenerators,
+		pProver->GetGenerators(),
 		proofBytes.data(),
 		&proofLen,
 		NULL,
@@ -122,6 +211,7 @@ RangeProof Bulletproofs::GenerateRangeProof(const uint64_t amount, const SecretK
 		proofMessage.data()
 	);
 	secp256k1_scratch_space_destroy(pScratchSpace);
+	ReleaseProver(std::move(pProver));
 
 	if (result != 1) {
 		throw CRYPTO_EXCEPTION_F("secp256k1_bulletproof_rangeproof_prove failed with error: {}", result);
@@ -131,43 +221,79 @@ RangeProof Bulletproofs::GenerateRangeProof(const uint64_t amount, const SecretK
 	return RangeProof(std::move(proofBytes));
 }
 
-std::unique_ptr<RewoundProof> Bulletproofs::RewindProof(const Commitment& commitment, const RangeProof& rangeProof, const SecretKey& nonce) const
+static std::unique_ptr<RewoundProof> Rewind(
+	const secp256k1_context* pContext,
+	const secp256k1_pedersen_commitment* pCommitment,
+	const RangeProof& rangeProof,
+	const SecretKey& nonce)
 {
-	std::shared_lock<std::shared_mutex> readLock(m_mutex);
+	// Only single 64-bit proofs can be rewound, and every output's proof is one,
+	// so anything else can be rejected without touching secp256k1.
+	if (rangeProof.GetProofBytes().size() != (size_t)MAX_PROOF_SIZE)
+	{
+		return std::unique_ptr<RewoundProof>(nullptr);
+	}
+
+	uint64_t value;
+	SecretKey blinding_factor;
+	ProofMessage message;
+
+	int result = secp256k1_bulletproof_rangeproof_rewind(
+		pContext,
+		&value,
+		blinding_factor.data(),
+		rangeProof.GetProofBytes().data(),
+		rangeProof.GetProofBytes().size(),
+		0,
+		pCommitment,
+		&secp256k1_generator_const_h,
+		nonce.data(),
+		NULL,
+		0,
+		message.data()
+	);
+	if (result == 1)
+	{
+		return std::make_unique<RewoundProof>(RewoundProof(
+			value, 
+			std::make_unique<SecretKey>(std::move(blinding_factor)), 
+			std::move(message)
+		));
+	}
+
+	return std::unique_ptr<RewoundProof>(nullptr);
+}
 
-	std::vector<secp256k1_pedersen_commitment*> commitmentPointers = Pedersen::ConvertCommitments(*m_pContext, std::vector<Commitment>({ commitment }));
+std::unique_ptr<RewoundProof> Bulletproofs::RewindProof(const Commitment& commitment, const RangeProof& rangeProof, const SecretKey& nonce) const
+{
+	const ParsedCommitments parsedCommitments(*m_pContext, std::vector<Commitment>({ commitment }));
 
-	if (!commitmentPointers.empty())
+	if (!parsedCommitments.empty())
 	{
-		uint64_t value;
-		SecretKey blinding_factor;
-		ProofMessage message;
-
-		int result = secp256k1_bulletproof_rangeproof_rewind(
-			m_pContext,
-			&value,
-			blinding_factor.data(),
-			rangeProof.GetProofBytes().data(),
-			rangeProof.GetProofBytes().size(),
-			0,
-			commitmentPointers.front(),
-			&secp256k1_generator_const_h,
-			nonce.data(),
-			NULL,
-			0,
-			message.data()
-		);
-		Pedersen::CleanupCommitments(commitmentPointers);
-
-		if (result == 1)
-		{
-			return std::make_unique<RewoundProof>(RewoundProof(
-				value, 
-				std::make_unique<SecretKey>(std::move(blinding_factor)), 
-				std::move(message)
-			));
-		}
+		return Rewind(m_pContext, parsedCommitments.front(), rangeProof, nonce);
 	}
 
 	return std::unique_ptr<RewoundProof>(nullptr);
+}
+
+std::vector<std::unique_ptr<RewoundProof>> Bulletproofs::RewindProofs(
+	const std::vector<Commitment>& commitments,
+	const std::vector<const RangeProof*>& rangeProofs,
+	const std::vector<SecretKey>& nonces) const
+{
+	assert(commitments.size() == rangeProofs.size() && commitments.size() == nonces.size());
+
+	std::vector<std::unique_ptr<RewoundProof>> rewoundProofs(commitments.size());
+	if (commitments.empty())
+	{
+		return rewoundProofs;
+	}
+
+	const ParsedCommitments parsedCommitments(*m_pContext, commitments);
+	for (size_t i = 0; i < commitments.size(); i++)
+	{
+		rewoundProofs[i] = Rewind(m_pContext, parsedCommitments.data()[i], *rangeProofs[i], nonces[i]);
+	}
+
+	return rewoundProofs;
 }
\ No newline at end of file
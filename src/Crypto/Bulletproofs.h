@@ -1,27 +1,53 @@
 #pragma once
 
-#include "BulletProofsCache.h"
+#include "VerifiedCache.h"
 
 #include <Crypto/Commitment.h>
 #include <Crypto/RangeProof.h>
 #include <Crypto/BlindingFactor.h>
 #include <Crypto/ProofMessage.h>
 #include <Crypto/RewoundProof.h>
-#include <shared_mutex>
+#include <Crypto/RangeProofVerifier.h>
+#include <mutex>
 
 // Forward Declarations
 typedef struct secp256k1_context_struct secp256k1_context;
+typedef struct secp256k1_scratch_space_struct secp256k1_scratch_space;
 struct secp256k1_bulletproof_generators;
+class Context;
 
 class Bulletproofs
 {
 public:
+	static constexpr uint64_t MAX_WIDTH = 1 << 20;
+	static constexpr size_t SCRATCH_SPACE_SIZE = 256 * MAX_WIDTH;
+	static constexpr size_t MAX_GENERATORS = 256;
+
 	static Bulletproofs& GetInstance();
 	Bulletproofs();
 	~Bulletproofs();
 
-	bool VerifyBulletproofs(const std::vector<std::pair<Commitment, RangeProof>>& rangeProofs) const;
+	bool VerifyBulletproofs(const std::vector<Commitment>& commitments, const std::vector<const RangeProof*>& rangeProofs) const;
+
+	void SetCacheCapacity(const size_t capacity) { m_cache.SetCapacity(capacity); }
+	CacheStats GetCacheStats() const { return m_cache.GetStats(); }
+
+	//
+	// Verifies the rangeproofs as a single batch using the supplied context, generators, and scratch space.
+	// All proofs are expected to be the same length. Used by RangeProofVerifier and VerifyBulletproofs.
+	//
+	static bool VerifyBatch(
+		const secp256k1_context* pContext,
+		secp256k1_scratch_space* pScratchSpace,
+		const secp256k1_bulletproof_generators* pGenerators,
+		const std::vector<Commitment>& commitments,
+		const std::vector<const unsigned char*>& proofs,
+		const size_t proofLength
+	);
 
+	//
+	// Safe to call from any number of threads at once. Each call proves with its own context, taken from a pool of idle provers.
+	//
 	RangeProof GenerateRangeProof(
 		const uint64_t amount,
 		const SecretKey& key,
@@ -36,9 +62,35 @@ public:
 		const SecretKey& nonce
 	) const;
 
+	//
+	// Rewinds each rangeproof using the nonce at the same index, with a single commitment parse.
+	// Returns nullptr for each proof that couldn't be rewound with its nonce.
+	//
+	std::vector<std::unique_ptr<RewoundProof>> RewindProofs(
+		const std::vector<Commitment>& commitments,
+		const std::vector<const RangeProof*>& rangeProofs,
+		const std::vector<SecretKey>& nonces
+	) const;
+
 private:
-	mutable std::shared_mutex m_mutex;
+	// Idle verifiers keep at most the scratch space for a batch this size, which covers a typical block.
+	static constexpr size_t POOLED_SCRATCH_SPACE_PROOFS = 64;
+
+	RangeProofVerifier::UPtr AcquireVerifier() const;
+	void ReleaseVerifier(RangeProofVerifier::UPtr&& pVerifier) const;
+	std::unique_ptr<Context> AcquireProver() const;
+	void ReleaseProver(std::unique_ptr<Context>&& pProver) const;
+
+	// Only used for rewinding, which never modifies it, so it needs no lock.
 	secp256k1_context* m_pContext;
-	secp256k1_bulletproof_generators* m_pGenerators;
-	mutable BulletProofsCache m_cache;
+	// Keyed by the commitment and the proof, so a different proof for a verified commitment is still verified.
+	mutable VerifiedCache m_cache;
+
+	// Idle verifiers, each with its own context and scratch space, shared by all verifying threads.
+	mutable std::mutex m_verifiersMutex;
+	mutable std::vector<RangeProofVerifier::UPtr> m_verifiers;
+
+	// Idle provers, each with its own context and generators, shared by all proving threads.
+	mutable std::mutex m_proversMutex;
+	mutable std::vector<std::unique_ptr<Context>> m_provers;
 };
\ No newline at end of file
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <secp256k1-zkp/secp256k1_commitment.h>
+
+#include <Common/CacheStats.h>
+#include <Crypto/Commitment.h>
+#include <Crypto/CSPRNG.h>
+#include <Crypto/Hasher.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+//
+// Remembers recently parsed commitments, since the same UTXOs are parsed over and over by mempool, block and sum validation,
+// and parsing decompresses a curve point.
+//
+// Entries are found by a keyed 64-bit SipHash fingerprint, like VerifiedCache, but the full commitment is stored
+// and compared as well, so a fingerprint collision is only ever a miss.
+// A capacity of 0 disables the cache.
+//
+class CommitmentCache
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 10'000;
+	static constexpr size_t NUM_STRIPES = 16;
+
+	CommitmentCache(const size_t capacity = DEFAULT_CAPACITY)
+		: m_enabled(false), m_hits(0), m_misses(0)
+	{
+		const SecureVector key = CSPRNG::GenerateRandomBytes(16);
+		memcpy(&m_k0, key.data(), 8);
+		memcpy(&m_k1, key.data() + 8, 8);
+
+		SetCapacity(capacity);
+	}
+
+	void SetCapacity(const size_t capacity)
+	{
+		const size_t stripeCapacity = (capacity + NUM_STRIPES - 1) / NUM_STRIPES;
+		for (Stripe& stripe : m_stripes)
+		{
+			std::unique_lock<std::mutex> lock(stripe.mutex);
+			stripe.capacity = stripeCapacity;
+			stripe.Trim();
+		}
+
+		m_enabled = capacity > 0;
+	}
+
+	bool IsEnabled() const noexcept { return m_enabled; }
+
+	void Add(const Commitment& commitment, const secp256k1_pedersen_commitment& parsed)
+	{
+		const uint64_t fingerprint = Fingerprint(commitment);
+		Stripe& stripe = GetStripe(fingerprint);
+
+		std::unique_lock<std::mutex> lock(stripe.mutex);
+		auto iter = stripe.entries.find(fingerprint);
+		if (iter != stripe.entries.end())
+		{
+			stripe.lru.splice(stripe.lru.begin(), stripe.lru, iter->second);
+			return;
+		}
+
+		stripe.lru.push_front(Entry{ fingerprint, commitment, parsed });
+		stripe.entries[fingerprint] = stripe.lru.begin();
+		stripe.Trim();
+	}
+
+	bool Get(const Commitment& commitment, secp256k1_pedersen_commitment& parsed) const
+	{
+		const uint64_t fingerprint = Fingerprint(commitment);
+		Stripe& stripe = GetStripe(fingerprint);
+
+		std::unique_lock<std::mutex> lock(stripe.mutex);
+		auto iter = stripe.entries.find(fingerprint);
+		if (iter == stripe.entries.end() || iter->second->commitment != commitment)
+		{
+			lock.unlock();
+			++m_misses;
+			return false;
+		}
+
+		parsed = iter->second->parsed;
+		stripe.lru.splice(stripe.lru.begin(), stripe.lru, iter->second);
+		lock.unlock();
+
+		++m_hits;
+		return true;
+	}
+
+	CacheStats GetStats() const
+	{
+		CacheStats stats{ 0, 0, m_hits, m_misses };
+		for (const Stripe& stripe : m_stripes)
+		{
+			std::unique_lock<std::mutex> lock(stripe.mutex);
+			stats.capacity += stripe.capacity;
+			stats.size += stripe.entries.size();
+		}
+
+		return stats;
+	}
+
+private:
+	struct Entry
+	{
+		uint64_t fingerprint;
+		Commitment commitment;
+		secp256k1_pedersen_commitment parsed;
+	};
+
+	struct Stripe
+	{
+		mutable std::mutex mutex;
+		size_t capacity;
+
+		// Most recently used at the front.
+		std::list<Entry> lru;
+		std::unordered_map<uint64_t, std::list<Entry>::iterator> entries;
+
+		void Trim()
+		{
+			while (entries.size() > capacity)
+			{
+				entries.erase(lru.back().fingerprint);
+				lru.pop_back();
+			}
+		}
+	};
+
+	uint64_t Fingerprint(const Commitment& commitment) const
+	{
+		return Hasher::SipHash24(m_k0, m_k1, commitment.GetVec());
+	}
+
+	Stripe& GetStripe(const uint64_t fingerprint) const
+	{
+		return m_stripes[fingerprint % NUM_STRIPES];
+	}
+
+	uint64_t m_k0;
+	uint64_t m_k1;
+	std::atomic_bool m_enabled;
+	mutable std::array<Stripe, NUM_STRIPES> m_stripes;
+	mutable std::atomic<uint64_t> m_hits;
+	mutable std::atomic<uint64_t> m_misses;
+};
@@ -1,5 +1,7 @@
 #include <Crypto/Crypto.h>
+#include <Crypto/CryptoException.h>
 #include <Core/Traits/Lockable.h>
+#include <Common/Logger.h>
 #include <cassert>
 
 #include "Context.h"
@@ -29,6 +31,18 @@ Commitment Crypto::CommitBlinded(const uint64_t value, const BlindingFactor& bli
 }
 
 Commitment Crypto::AddCommitments(const std::vector<Commitment>& positive, const std::vector<Commitment>& negative)
+{
+	std::optional<Commitment> sum = TryAddCommitments(positive, negative);
+	if (!sum.has_value())
+	{
+		LOG_ERROR("secp256k1_pedersen_commit_sum returned infinity");
+		throw CryptoException("secp256k1_pedersen_commit_sum error");
+	}
+
+	return sum.value();
+}
+
+std::optional<Commitment> Crypto::TryAddCommitments(const std::vector<Commitment>& positive, const std::vector<Commitment>& negative)
 {
 	const Commitment zeroCommitment(CBigInteger<33>::ValueOf(0));
 
@@ -106,9 +120,37 @@ std::unique_ptr<RewoundProof> Crypto::RewindRangeProof(const Commitment& commitm
 	return Bulletproofs::GetInstance().RewindProof(commitment, rangeProof, nonce);
 }
 
-bool Crypto::VerifyRangeProofs(const std::vector<std::pair<Commitment, RangeProof>>& rangeProofs)
+std::vector<std::unique_ptr<RewoundProof>> Crypto::RewindRangeProofs(
+	const std::vector<Commitment>& commitments,
+	const std::vector<const RangeProof*>& rangeProofs,
+	const std::vector<SecretKey>& nonces)
+{
+	return Bulletproofs::GetInstance().RewindProofs(commitments, rangeProofs, nonces);
+}
+
+bool Crypto::VerifyRangeProofs(const std::vector<Commitment>& commitments, const std::vector<const RangeProof*>& rangeProofs)
 {
-	return Bulletproofs::GetInstance().VerifyBulletproofs(rangeProofs);
+	return Bulletproofs::GetInstance().VerifyBulletproofs(commitments, rangeProofs);
+}
+
+void Crypto::SetRangeProofCacheCapacity(const size_t capacity)
+{
+	Bulletproofs::GetInstance().SetCacheCapacity(capacity);
+}
+
+CacheStats Crypto::GetRangeProofCacheStats()
+{
+	return Bulletproofs::GetInstance().GetCacheStats();
+}
+
+void Crypto::SetCommitmentCacheCapacity(const size_t capacity)
+{
+	Pedersen::GetInstance().SetCommitmentCacheCapacity(capacity);
+}
+
+CacheStats Crypto::GetCommitmentCacheStats()
+{
+	return Pedersen::GetInstance().GetCommitmentCacheStats();
 }
 
 PublicKey Crypto::CalculatePublicKey(const SecretKey& privateKey)
@@ -163,9 +205,23 @@ CompactSignature Crypto::ToCompact(const Signature& signature)
 	return AggSig::GetInstance().ToCompact(signature);
 }
 
-bool Crypto::VerifyKernelSignatures(const std::vector<const Signature*>& signatures, const std::vector<const Commitment*>& publicKeys, const std::vector<const Hash*>& messages)
+bool Crypto::VerifyKernelSignatures(
+	const std::vector<const Signature*>& signatures,
+	const std::vector<const Commitment*>& publicKeys,
+	const std::vector<const Hash*>& messages,
+	const bool cacheResults)
+{
+	return AggSig::GetInstance().VerifyAggregateSignatures(signatures, publicKeys, messages, cacheResults);
+}
+
+void Crypto::SetKernelSignatureCacheCapacity(const size_t capacity)
+{
+	AggSig::GetInstance().SetCacheCapacity(capacity);
+}
+
+CacheStats Crypto::GetKernelSignatureCacheStats()
 {
-	return AggSig::GetInstance().VerifyAggregateSignatures(signatures, publicKeys, messages);
+	return AggSig::GetInstance().GetCacheStats();
 }
 
 SecretKey Crypto::GenerateSecureNonce()
@@ -8,6 +8,10 @@
 #include <bitcoin/hmac_sha512.h>
 
 #include "ThirdParty/siphash.h"
+#include "Blake2bLanes.h"
+
+#include <algorithm>
+#include <numeric>
 
 Hash Hasher::Blake2b(const std::vector<uint8_t>& input)
 {
@@ -43,6 +47,90 @@ Hash Hasher::Blake2b(const std::vector<uint8_t>& key, const uint8_t* input, cons
 	return output;
 }
 
+void Hasher::Blake2bBatch(const std::vector<std::pair<const uint8_t*, size_t>>& inputs, uint8_t* pOutput)
+{
+	auto hashOne = [&inputs, pOutput](const size_t index) {
+		int result = crypto_generichash_blake2b(pOutput + (index * HASH_SIZE), HASH_SIZE, inputs[index].first, inputs[index].second, nullptr, 0);
+		if (result != 0) {
+			throw CRYPTO_EXCEPTION_F("crypto_generichash_blake2b failed with error {}", result);
+		}
+	};
+
+	const size_t numLanes = Blake2bLanes::GetNumLanes();
+	if (numLanes == 0 || inputs.size() < numLanes)
+	{
+		for (size_t i = 0; i < inputs.size(); i++)
+		{
+			hashOne(i);
+		}
+
+		return;
+	}
+
+	// The lanes share a block counter, so only inputs of the same length can be hashed together.
+	std::vector<size_t> order(inputs.size());
+	std::iota(order.begin(), order.end(), 0);
+
+	const bool sameLength = std::all_of(inputs.cbegin(), inputs.cend(), [&inputs](const auto& input) { return input.second == inputs.front().second; });
+	if (!sameLength)
+	{
+		std::stable_sort(order.begin(), order.end(), [&inputs](const size_t a, const size_t b) { return inputs[a].second < inputs[b].second; });
+	}
+
+	const uint8_t* pLaneInputs[Blake2bLanes::MAX_LANES];
+	uint8_t* pLaneOutputs[Blake2bLanes::MAX_LANES];
+
+	size_t i = 0;
+	while (i < order.size())
+	{
+		const size_t len = inputs[order[i]].second;
+		size_t end = i;
+		while (end < order.size() && inputs[order[end]].second == len)
+		{
+			++end;
+		}
+
+		for (; i + numLanes <= end; i += numLanes)
+		{
+			for (size_t lane = 0; lane < numLanes; lane++)
+			{
+				pLaneInputs[lane] = inputs[order[i + lane]].first;
+				pLaneOutputs[lane] = pOutput + (order[i + lane] * HASH_SIZE);
+			}
+
+			Blake2bLanes::Hash(pLaneInputs, len, pLaneOutputs);
+		}
+
+		// Fewer left than there are lanes.
+		for (; i < end; i++)
+		{
+			hashOne(order[i]);
+		}
+	}
+}
+
+std::vector<Hash> Hasher::Blake2bBatch(const std::vector<std::vector<uint8_t>>& inputs)
+{
+	std::vector<std::pair<const uint8_t*, size_t>> pointers;
+	pointers.reserve(inputs.size());
+	for (const std::vector<uint8_t>& input : inputs)
+	{
+		pointers.push_back({ input.data(), input.size() });
+	}
+
+	std::vector<uint8_t> output(inputs.size() * HASH_SIZE);
+	Blake2bBatch(pointers, output.data());
+
+	std::vector<Hash> hashes;
+	hashes.reserve(inputs.size());
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		hashes.emplace_back(output.data() + (i * HASH_SIZE));
+	}
+
+	return hashes;
+}
+
 Hash Hasher::SHA256(const std::vector<uint8_t>& input)
 {
     return SHA256(input.data(), input.size());
@@ -115,7 +203,12 @@ CBigInteger<64> Hasher::HMAC_SHA512(const std::vector<uint8_t>& key, const uint8
 
 uint64_t Hasher::SipHash24(const uint64_t k0, const uint64_t k1, const std::vector<unsigned char>& data)
 {
-	const std::vector<uint64_t> key = { k0, k1 };
+	return SipHash24(k0, k1, data.data(), data.size());
+}
+
+uint64_t Hasher::SipHash24(const uint64_t k0, const uint64_t k1, const uint8_t* pData, const size_t len)
+{
+	const uint64_t key[2] = { k0, k1 };
 
-	return siphash24(&key[0], &data[0], data.size());
+	return siphash24(key, pData, len);
 }
\ No newline at end of file
@@ -41,33 +41,29 @@ Commitment Pedersen::PedersenCommit(const uint64_t value, const BlindingFactor&
 	throw CryptoException("Failed to create commitment.");
 }
 
-Commitment Pedersen::PedersenCommitSum(const std::vector<Commitment>& positive, const std::vector<Commitment>& negative) const
+std::optional<Commitment> Pedersen::PedersenCommitSum(const std::vector<Commitment>& positive, const std::vector<Commitment>& negative) const
 {
 	std::shared_lock<std::shared_mutex> readLock(m_mutex);
 
-	std::vector<secp256k1_pedersen_commitment*> positiveCommitments = Pedersen::ConvertCommitments(*m_pContext, positive);
-	std::vector<secp256k1_pedersen_commitment*> negativeCommitments = Pedersen::ConvertCommitments(*m_pContext, negative);
+	const ParsedCommitments positiveCommitments(*m_pContext, positive);
+	const ParsedCommitments negativeCommitments(*m_pContext, negative);
 
 	secp256k1_pedersen_commitment commitment;
 	const int result = secp256k1_pedersen_commit_sum(
 		m_pContext,
 		&commitment,
-		positiveCommitments.empty() ? nullptr : &positiveCommitments[0],
+		positiveCommitments.data(),
 		positiveCommitments.size(),
-		negativeCommitments.empty() ? nullptr : &negativeCommitments[0],
+		negativeCommitments.data(),
 		negativeCommitments.size()
 	);
 
-	Pedersen::CleanupCommitments(positiveCommitments);
-	Pedersen::CleanupCommitments(negativeCommitments);
-
+	// The commitments were all parsed above, so the sum can only fail by being infinite.
 	if (result != 1)
 	{
-		LOG_ERROR_F("secp256k1_pedersen_commit_sum returned result: {}", result);
-		throw CryptoException("secp256k1_pedersen_commit_sum error");
+		return std::nullopt;
 	}
 
-
 	std::vector<unsigned char> serializedCommitment(33);
 	const int serializeResult = secp256k1_pedersen_commitment_serialize(m_pContext, &serializedCommitment[0], &commitment);
 	if (serializeResult != 1)
@@ -76,7 +72,7 @@ Commitment Pedersen::PedersenCommitSum(const std::vector<Commitment>& positive,
 		throw CryptoException("secp256k1_pedersen_commitment_serialize error");
 	}
 
-	return Commitment(CBigInteger<33>(std::move(serializedCommitment)));
+	return std::make_optional(Commitment(CBigInteger<33>(std::move(serializedCommitment))));
 }
 
 BlindingFactor Pedersen::PedersenBlindSum(const std::vector<BlindingFactor>& positive, const std::vector<BlindingFactor>& negative) const
@@ -160,31 +156,38 @@ Commitment Pedersen::ToCommitment(const PublicKey& publicKey) const
 
 }
 
-std::vector<secp256k1_pedersen_commitment*> Pedersen::ConvertCommitments(const secp256k1_context& context, const std::vector<Commitment>& commitments)
+ParsedCommitments::ParsedCommitments(const secp256k1_context& context, const std::vector<Commitment>& commitments)
+	: m_size(commitments.size())
 {
-	std::vector<secp256k1_pedersen_commitment*> convertedCommitments(commitments.size(), NULL);
-	for (int i = 0; i < commitments.size(); i++)
+	secp256k1_pedersen_commitment* pCommitments = m_inlineCommitments.data();
+	m_ppCommitments = m_inlinePointers.data();
+	if (m_size > INLINE_CAPACITY)
 	{
-		secp256k1_pedersen_commitment* pCommitment = new secp256k1_pedersen_commitment();
-		const int parsed_result = secp256k1_pedersen_commitment_parse(&context, pCommitment, commitments[i].data());
-		convertedCommitments[i] = pCommitment;
+		const size_t pointersSize = m_size * sizeof(secp256k1_pedersen_commitment*);
+		m_pHeap = std::make_unique<uint8_t[]>(pointersSize + m_size * sizeof(secp256k1_pedersen_commitment));
+		m_ppCommitments = reinterpret_cast<secp256k1_pedersen_commitment**>(m_pHeap.get());
+		pCommitments = reinterpret_cast<secp256k1_pedersen_commitment*>(m_pHeap.get() + pointersSize);
+	}
 
+	CommitmentCache& cache = Pedersen::GetInstance().GetCommitmentCache();
+	const bool useCache = cache.IsEnabled();
+	for (size_t i = 0; i < m_size; i++)
+	{
+		m_ppCommitments[i] = &pCommitments[i];
+		if (useCache && cache.Get(commitments[i], pCommitments[i]))
+		{
+			continue;
+		}
+
+		const int parsed_result = secp256k1_pedersen_commitment_parse(&context, &pCommitments[i], commitments[i].data());
 		if (parsed_result != 1) {
-			CleanupCommitments(convertedCommitments);
 			LOG_ERROR_F("secp256k1_pedersen_commitment_parse failed with error {} for commitment {}", parsed_result, commitments[i]);
 			throw CRYPTO_EXCEPTION_F("secp256k1_pedersen_commitment_parse failed with error: {}", parsed_result);
 		}
-	}
 
-	return convertedCommitments;
-}
-
-void Pedersen::CleanupCommitments(std::vector<secp256k1_pedersen_commitment*>& commitments)
-{
-	for (secp256k1_pedersen_commitment* pCommitment : commitments)
-	{
-		delete pCommitment;
+		if (useCache)
+		{
+			cache.Add(commitments[i], pCommitments[i]);
+		}
 	}
-
-	commitments.clear();
-}
\ No newline at end of file
+}
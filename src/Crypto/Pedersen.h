@@ -6,11 +6,48 @@
 #include <Crypto/SecretKey.h>
 #include <Crypto/Commitment.h>
 #include <Crypto/PublicKey.h>
+#include <Common/CacheStats.h>
+#include <array>
+#include <memory>
+#include <optional>
 #include <shared_mutex>
 
+#include "CommitmentCache.h"
+
 // Forward Declarations
 typedef struct secp256k1_context_struct secp256k1_context;
 
+//
+// Commitments parsed for use by secp256k1, along with the array of pointers to them that secp256k1 expects.
+// Small batches live inline, and larger ones in a single allocation holding both the pointers and the commitments.
+// Parsed commitments are looked up in (and added to) the Pedersen commitment cache, when it's enabled.
+// Not copyable or movable, since the pointers refer to its own storage.
+//
+class ParsedCommitments
+{
+public:
+	ParsedCommitments(const secp256k1_context& context, const std::vector<Commitment>& commitments);
+
+	ParsedCommitments(const ParsedCommitments&) = delete;
+	ParsedCommitments& operator=(const ParsedCommitments&) = delete;
+
+	size_t size() const noexcept { return m_size; }
+	bool empty() const noexcept { return m_size == 0; }
+
+	// Returns nullptr when empty, as secp256k1 expects.
+	secp256k1_pedersen_commitment* const* data() const noexcept { return m_size == 0 ? nullptr : m_ppCommitments; }
+	secp256k1_pedersen_commitment* front() const noexcept { return m_ppCommitments[0]; }
+
+private:
+	static constexpr size_t INLINE_CAPACITY = 4;
+
+	size_t m_size;
+	secp256k1_pedersen_commitment** m_ppCommitments;
+	std::unique_ptr<uint8_t[]> m_pHeap;
+	std::array<secp256k1_pedersen_commitment*, INLINE_CAPACITY> m_inlinePointers;
+	std::array<secp256k1_pedersen_commitment, INLINE_CAPACITY> m_inlineCommitments;
+};
+
 class Pedersen
 {
 public:
@@ -19,17 +56,21 @@ public:
 	~Pedersen();
 
 	Commitment PedersenCommit(const uint64_t value, const BlindingFactor& blindingFactor) const;
-	Commitment PedersenCommitSum(const std::vector<Commitment>& positive, const std::vector<Commitment>& negative) const;
+
+	// Returns std::nullopt when the commitments sum to the point at infinity.
+	std::optional<Commitment> PedersenCommitSum(const std::vector<Commitment>& positive, const std::vector<Commitment>& negative) const;
 	BlindingFactor PedersenBlindSum(const std::vector<BlindingFactor>& positive, const std::vector<BlindingFactor>& negative) const;
 
 	SecretKey BlindSwitch(const SecretKey& secretKey, const uint64_t amount) const;
 
 	Commitment ToCommitment(const PublicKey& publicKey) const;
 
-	static std::vector<secp256k1_pedersen_commitment*> ConvertCommitments(const secp256k1_context& context, const std::vector<Commitment>& commitments);
-	static void CleanupCommitments(std::vector<secp256k1_pedersen_commitment*>& commitments);
+	void SetCommitmentCacheCapacity(const size_t capacity) { m_commitmentCache.SetCapacity(capacity); }
+	CacheStats GetCommitmentCacheStats() const { return m_commitmentCache.GetStats(); }
+	CommitmentCache& GetCommitmentCache() noexcept { return m_commitmentCache; }
 
 private:
 	mutable std::shared_mutex m_mutex;
 	secp256k1_context* m_pContext;
+	CommitmentCache m_commitmentCache;
 };
\ No newline at end of file
@@ -0,0 +1,113 @@
+#include <Crypto/RangeProofVerifier.h>
+#include <Crypto/CryptoException.h>
+
+#include "Bulletproofs.h"
+
+#include <secp256k1-zkp/secp256k1_bulletproofs.h>
+#include <algorithm>
+
+// The verifier's own scratch frames are a fixed size per proof, and the multi-exponentiation splits its points into
+// batches that fit whatever space is left over, so the size only has to cover the frames plus room for efficient batches.
+// These leave that room for every point of the batch at once. Above the cap, the multi-exponentiation just runs in batches.
+static const size_t MIN_SCRATCH_SPACE_SIZE = 1 << 20;
+static const size_t SCRATCH_SPACE_PER_PROOF = 64 * 1024;
+
+size_t RangeProofVerifier::GetScratchSpaceSize(const size_t numProofs)
+{
+	return std::min(MIN_SCRATCH_SPACE_SIZE + (numProofs * SCRATCH_SPACE_PER_PROOF), Bulletproofs::SCRATCH_SPACE_SIZE);
+}
+
+RangeProofVerifier::UPtr RangeProofVerifier::Create()
+{
+	secp256k1_context* pContext = secp256k1_context_create(SECP256K1_CONTEXT_VERIFY);
+	if (pContext == nullptr)
+	{
+		throw CRYPTO_EXCEPTION("secp256k1_context_create failed");
+	}
+
+	secp256k1_bulletproof_generators* pGenerators = secp256k1_bulletproof_generators_create(
+		pContext,
+		&secp256k1_generator_const_g,
+		Bulletproofs::MAX_GENERATORS
+	);
+	if (pGenerators == nullptr)
+	{
+		secp256k1_context_destroy(pContext);
+		throw CRYPTO_EXCEPTION("secp256k1_bulletproof_generators_create failed");
+	}
+
+	return RangeProofVerifier::UPtr(new RangeProofVerifier(pContext, pGenerators));
+}
+
+RangeProofVerifier::~RangeProofVerifier()
+{
+	if (m_pScratchSpace != nullptr)
+	{
+		secp256k1_scratch_space_destroy(m_pScratchSpace);
+	}
+
+	secp256k1_bulletproof_generators_destroy(m_pContext, m_pGenerators);
+	secp256k1_context_destroy(m_pContext);
+}
+
+bool RangeProofVerifier::Verify(const std::vector<std::pair<Commitment, RangeProof>>& rangeProofs)
+{
+	if (rangeProofs.empty())
+	{
+		return true;
+	}
+
+	std::vector<Commitment> commitments;
+	commitments.reserve(rangeProofs.size());
+
+	std::vector<const unsigned char*> bulletproofPointers;
+	bulletproofPointers.reserve(rangeProofs.size());
+	for (const std::pair<Commitment, RangeProof>& rangeProof : rangeProofs)
+	{
+		commitments.push_back(rangeProof.first);
+		bulletproofPointers.push_back(rangeProof.second.GetProofBytes().data());
+	}
+
+	const size_t proofLength = rangeProofs.front().second.GetProofBytes().size();
+	return Verify(commitments, bulletproofPointers, proofLength);
+}
+
+bool RangeProofVerifier::Verify(const std::vector<Commitment>& commitments, const std::vector<const unsigned char*>& proofs, const size_t proofLength)
+{
+	if (commitments.empty())
+	{
+		return true;
+	}
+
+	ReserveScratchSpace(GetScratchSpaceSize(commitments.size()));
+
+	return Bulletproofs::VerifyBatch(m_pContext, m_pScratchSpace, m_pGenerators, commitments, proofs, proofLength);
+}
+
+void RangeProofVerifier::ReleaseScratchSpace()
+{
+	if (m_pScratchSpace != nullptr)
+	{
+		secp256k1_scratch_space_destroy(m_pScratchSpace);
+		m_pScratchSpace = nullptr;
+		m_scratchSpaceSize = 0;
+	}
+}
+
+void RangeProofVerifier::ReserveScratchSpace(const size_t size)
+{
+	if (m_pScratchSpace != nullptr && m_scratchSpaceSize >= size)
+	{
+		return;
+	}
+
+	ReleaseScratchSpace();
+
+	m_pScratchSpace = secp256k1_scratch_space_create(m_pContext, size);
+	if (m_pScratchSpace == nullptr)
+	{
+		throw CRYPTO_EXCEPTION_F("Failed to allocate {} byte scratch space", size);
+	}
+
+	m_scratchSpaceSize = size;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <Common/CacheStats.h>
+#include <Common/ShardedCache.h>
+#include <Crypto/CSPRNG.h>
+#include <Crypto/Hasher.h>
+#include <cstring>
+
+//
+// Remembers elements that were recently verified (rangeproofs, kernel signatures), so the same element doesn't need
+// to be verified again when it's seen again, eg. in a block after being accepted to the mempool.
+//
+// Only a 64-bit SipHash fingerprint of everything verification depends on is stored. The SipHash key is random per process,
+// so fingerprint collisions cannot be targeted to skip verification of a different element.
+// Fingerprints are kept in a ShardedCache, so concurrent verifiers rarely contend on the same lock, and a burst of elements
+// that are only seen once (eg. a large block from a peer) doesn't evict the ones the mempool's txs will need again.
+//
+class VerifiedCache
+{
+public:
+	static constexpr size_t DEFAULT_CAPACITY = 100'000;
+
+	VerifiedCache(const size_t capacity = DEFAULT_CAPACITY)
+		: m_cache(capacity)
+	{
+		const SecureVector key = CSPRNG::GenerateRandomBytes(16);
+		memcpy(&m_k0, key.data(), 8);
+		memcpy(&m_k1, key.data() + 8, 8);
+	}
+
+	void SetCapacity(const size_t capacity) { m_cache.SetCapacity(capacity); }
+
+	//
+	// The fingerprint of an element, over all of the bytes its verification depends on.
+	//
+	uint64_t Fingerprint(const uint8_t* pData, const size_t len) const
+	{
+		return Hasher::SipHash24(m_k0, m_k1, pData, len);
+	}
+
+	void AddToCache(const uint64_t fingerprint) { m_cache.Put(fingerprint, true); }
+
+	bool WasAlreadyVerified(const uint64_t fingerprint) const { return m_cache.Get(fingerprint).has_value(); }
+
+	CacheStats GetStats() const { return m_cache.GetStats(); }
+
+private:
+	uint64_t m_k0;
+	uint64_t m_k1;
+	ShardedCache<uint64_t, bool> m_cache;
+};
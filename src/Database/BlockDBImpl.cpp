@@ -6,67 +6,642 @@
 #include <Core/Models/BlockSums.h>
 #include <Core/Models/OutputLocation.h>
 #include <Database/DatabaseException.h>
+#include <Consensus/BlockTime.h>
+#include <Crypto/Hasher.h>
+#include <Common/Util/FileUtil.h>
 #include <Common/Logger.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <Common/Tracer.h>
 #include <Common/Util/StringUtil.h>
+#include <atomic>
 #include <utility>
 #include <string>
 #include <filesystem.h>
+#include <chrono>
 
 using namespace rocksdb;
 
+//
+// The occurrences of an NRD kernel's excess commitment, oldest first.
+//
+class NRDKernelPositions : public Traits::ISerializable
+{
+public:
+	NRDKernelPositions(std::vector<OutputLocation>&& locations) : m_locations(std::move(locations)) { }
+
+	std::vector<OutputLocation>& GetLocations() noexcept { return m_locations; }
+
+	void Serialize(Serializer& serializer) const final
+	{
+		serializer.Append<uint16_t>((uint16_t)m_locations.size());
+		for (const OutputLocation& location : m_locations)
+		{
+			location.Serialize(serializer);
+		}
+	}
+
+	static NRDKernelPositions Deserialize(ByteBuffer& byteBuffer)
+	{
+		const uint16_t numLocations = byteBuffer.ReadU16();
+
+		std::vector<OutputLocation> locations;
+		locations.reserve(numLocations);
+		for (uint16_t i = 0; i < numLocations; i++)
+		{
+			locations.push_back(OutputLocation::Deserialize(byteBuffer));
+		}
+
+		return NRDKernelPositions(std::move(locations));
+	}
+
+private:
+	std::vector<OutputLocation> m_locations;
+};
+
+//
+// One part of a block (eg. its kernels) when DATABASE.SPLIT_BLOCKS is enabled.
+// T only needs a Serialize(Serializer&) method and a static Deserialize(ByteBuffer&).
+//
+template<typename T>
+class BlockPartList : public Traits::ISerializable
+{
+public:
+	BlockPartList(std::vector<T>&& items) : m_items(std::move(items)) { }
+
+	std::vector<T>& GetItems() noexcept { return m_items; }
+
+	void Serialize(Serializer& serializer) const final
+	{
+		serializer.Append<uint32_t>((uint32_t)m_items.size());
+		for (const T& item : m_items)
+		{
+			item.Serialize(serializer);
+		}
+	}
+
+	static BlockPartList Deserialize(ByteBuffer& byteBuffer)
+	{
+		const uint32_t numItems = byteBuffer.ReadU32();
+
+		std::vector<T> items;
+		items.reserve(numItems);
+		for (uint32_t i = 0; i < numItems; i++)
+		{
+			items.emplace_back(T::Deserialize(byteBuffer));
+		}
+
+		return BlockPartList(std::move(items));
+	}
+
+private:
+	std::vector<T> m_items;
+};
+
+// The tables holding each part of a block when DATABASE.SPLIT_BLOCKS is enabled, keyed by block hash. Headers are already in HEADER.
+static const std::vector<std::string> SPLIT_BLOCK_TABLES = { "BLOCK_INPUTS", "BLOCK_OUTPUTS", "BLOCK_PROOFS", "BLOCK_KERNELS" };
+
+template<typename T>
+static DBEntry<BlockPartList<T>> ToPartEntry(const rocksdb::Slice& key, std::vector<T>&& items)
+{
+	return DBEntry<BlockPartList<T>>(key, std::make_unique<const BlockPartList<T>>(std::move(items)));
+}
+
+template<typename T>
+static std::vector<std::unique_ptr<BlockPartList<T>>> ReadParts(
+	const RocksDB& rocksDB,
+	const std::string& tableName,
+	const std::vector<rocksdb::Slice>& keys,
+	const bool read)
+{
+	return read ? rocksDB.MultiGet<BlockPartList<T>>(tableName, keys) : std::vector<std::unique_ptr<BlockPartList<T>>>(keys.size());
+}
+
+static std::unique_ptr<BlockParts> ToBlockParts(const FullBlock& block, const uint8_t parts)
+{
+	auto pParts = std::make_unique<BlockParts>();
+	pParts->pHeader = block.GetHeader();
+	if ((parts & EBlockPart::INPUTS) != 0)
+	{
+		pParts->inputs = block.GetInputs();
+	}
+
+	for (const TransactionOutput& output : block.GetOutputs())
+	{
+		if ((parts & EBlockPart::OUTPUTS) != 0)
+		{
+			pParts->outputs.push_back(OutputIdentifier::FromOutput(output));
+		}
+
+		if ((parts & EBlockPart::RANGEPROOFS) != 0)
+		{
+			pParts->rangeProofs.push_back(output.GetRangeProof());
+		}
+	}
+
+	if ((parts & EBlockPart::KERNELS) != 0)
+	{
+		pParts->kernels = block.GetKernels();
+	}
+
+	return pParts;
+}
+
+static std::unique_ptr<FullBlock> ToFullBlock(BlockParts&& parts)
+{
+	std::vector<TransactionOutput> outputs;
+	outputs.reserve(parts.outputs.size());
+	for (size_t i = 0; i < parts.outputs.size(); i++)
+	{
+		outputs.emplace_back(parts.outputs[i].GetFeatures(), Commitment(parts.outputs[i].GetCommitment()), std::move(parts.rangeProofs[i]));
+	}
+
+	// Only validated blocks are stored, so each part is already sorted.
+	return std::make_unique<FullBlock>(
+		parts.pHeader,
+		TransactionBody(std::move(parts.inputs), std::move(outputs), std::move(parts.kernels))
+	);
+}
+
+static CompressionType GetCompressionType(const EDBCompression compression)
+{
+	switch (compression)
+	{
+		case EDBCompression::LZ4:
+			return kLZ4Compression;
+		case EDBCompression::ZSTD:
+			return kZSTD;
+		default:
+			return kNoCompression;
+	}
+}
+
 std::shared_ptr<BlockDB> BlockDB::OpenDB(const Config& config)
 {
-	fs::path dbPath = config.GetNodeConfig().GetDatabasePath() / "CHAIN/";
+	const fs::path dbPath = config.GetNodeConfig().GetChainDatabasePath();
 
-	ColumnFamilyDescriptor BLOCK_COLUMN = ColumnFamilyDescriptor("BLOCK", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
-	ColumnFamilyDescriptor HEADER_COLUMN = ColumnFamilyDescriptor("HEADER", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
-	ColumnFamilyDescriptor BLOCK_SUMS_COLUMN = ColumnFamilyDescriptor("BLOCK_SUMS", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
-	ColumnFamilyDescriptor OUTPUT_POS_COLUMN = ColumnFamilyDescriptor("OUTPUT_POS", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
-	ColumnFamilyDescriptor INPUT_BITMAP_COLUMN = ColumnFamilyDescriptor("INPUT_BITMAP", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
-	ColumnFamilyDescriptor SPENT_OUTPUTS_COLUMN = ColumnFamilyDescriptor("SPENT_OUTPUTS", *ColumnFamilyOptions().OptimizeForPointLookup(1024));
+	// All tables share one block cache. Hot tables are small and read constantly, while cold tables are large and rarely read.
+	const DatabaseConfig& dbConfig = config.GetNodeConfig().GetDatabase();
+	std::shared_ptr<Cache> pBlockCache = NewLRUCache(dbConfig.GetBlockCacheBytes());
+	const CompressionType coldCompression = GetCompressionType(dbConfig.GetColdCompression());
+	const ColumnFamilyOptions hotOptions = RocksDBFactory::CreateTableOptions(
+		pBlockCache,
+		dbConfig.GetBloomFilterBits(),
+		kNoCompression,
+		dbConfig.GetHotWriteBufferBytes()
+	);
+	const ColumnFamilyOptions coldOptions = RocksDBFactory::CreateTableOptions(
+		pBlockCache,
+		dbConfig.GetBloomFilterBits(),
+		coldCompression,
+		dbConfig.GetColdWriteBufferBytes()
+	);
+
+	LOG_INFO_F(
+		"Opening chain database with {}MB block cache, {} bloom filter bits, {} compression for cold tables, and {}MB/{}MB hot/cold write buffers",
+		dbConfig.GetBlockCacheBytes() / (1024 * 1024),
+		dbConfig.GetBloomFilterBits(),
+		coldCompression == kLZ4Compression ? "LZ4" : (coldCompression == kZSTD ? "ZSTD" : "no"),
+		dbConfig.GetHotWriteBufferBytes() / (1024 * 1024),
+		dbConfig.GetColdWriteBufferBytes() / (1024 * 1024)
+	);
+
+	ColumnFamilyDescriptor BLOCK_COLUMN = ColumnFamilyDescriptor("BLOCK", coldOptions);
+	ColumnFamilyDescriptor BLOCK_INPUTS_COLUMN = ColumnFamilyDescriptor("BLOCK_INPUTS", coldOptions);
+	ColumnFamilyDescriptor BLOCK_OUTPUTS_COLUMN = ColumnFamilyDescriptor("BLOCK_OUTPUTS", coldOptions);
+	ColumnFamilyDescriptor BLOCK_PROOFS_COLUMN = ColumnFamilyDescriptor("BLOCK_PROOFS", coldOptions);
+	ColumnFamilyDescriptor BLOCK_KERNELS_COLUMN = ColumnFamilyDescriptor("BLOCK_KERNELS", coldOptions);
+	ColumnFamilyDescriptor HEADER_COLUMN = ColumnFamilyDescriptor("HEADER", hotOptions);
+	ColumnFamilyDescriptor BLOCK_SUMS_COLUMN = ColumnFamilyDescriptor("BLOCK_SUMS", hotOptions);
+	ColumnFamilyDescriptor OUTPUT_POS_COLUMN = ColumnFamilyDescriptor("OUTPUT_POS", hotOptions);
+	ColumnFamilyDescriptor INPUT_BITMAP_COLUMN = ColumnFamilyDescriptor("INPUT_BITMAP", hotOptions);
+	ColumnFamilyDescriptor SPENT_OUTPUTS_COLUMN = ColumnFamilyDescriptor("SPENT_OUTPUTS", coldOptions);
+	ColumnFamilyDescriptor KERNEL_POS_COLUMN = ColumnFamilyDescriptor("KERNEL_POS", coldOptions);
+	ColumnFamilyDescriptor NRD_KERNEL_POS_COLUMN = ColumnFamilyDescriptor("NRD_KERNEL_POS", hotOptions);
+
+	std::vector<ColumnFamilyDescriptor> tableNames = {
+		ColumnFamilyDescriptor(),
+		BLOCK_COLUMN,
+		BLOCK_INPUTS_COLUMN,
+		BLOCK_OUTPUTS_COLUMN,
+		BLOCK_PROOFS_COLUMN,
+		BLOCK_KERNELS_COLUMN,
+		HEADER_COLUMN,
+		BLOCK_SUMS_COLUMN,
+		OUTPUT_POS_COLUMN,
+		INPUT_BITMAP_COLUMN,
+		SPENT_OUTPUTS_COLUMN,
+		KERNEL_POS_COLUMN,
+		NRD_KERNEL_POS_COLUMN
+	};
+
+	// Replicas only read, so they skip everything below that writes. Output positions are read from the OUTPUT_POS table,
+	// which the primary keeps up to date, since a mirror of it couldn't follow the primary's changes.
+	if (config.GetNodeConfig().IsReplica())
+	{
+		if (dbConfig.UseFlatFileBlocks())
+		{
+			throw DATABASE_EXCEPTION("Replicas don't support flat file blocks.");
+		}
+
+		LOG_INFO_F("Opening {} as a replica", dbPath);
+		std::shared_ptr<RocksDB> pSecondaryDB = RocksDBFactory::OpenSecondary(dbPath, config.GetNodeConfig().GetReplicaPath(), tableNames);
+		auto pReplicaDB = std::make_shared<BlockDB>(config, pSecondaryDB);
+		pReplicaDB->RegisterWithMemoryBudget(nullptr);
+		return pReplicaDB;
+	}
 
-	std::vector<ColumnFamilyDescriptor> tableNames = { ColumnFamilyDescriptor(), BLOCK_COLUMN, HEADER_COLUMN, BLOCK_SUMS_COLUMN, OUTPUT_POS_COLUMN, INPUT_BITMAP_COLUMN, SPENT_OUTPUTS_COLUMN };
 	std::shared_ptr<RocksDB> pRocksDB = RocksDBFactory::Open(dbPath, tableNames);
+
+	// Read before anything below writes, so it can be compared with the output positions checkpoint.
+	const uint64_t sequenceNumber = pRocksDB->GetLatestSequenceNumber();
 	pRocksDB->DeleteAll("INPUT_BITMAP");
 
-	return std::make_shared<BlockDB>(config, pRocksDB);
+	// Blocks applied or rewound while the index is disabled aren't reflected in it, so it's rebuilt from scratch once re-enabled.
+	if (!config.GetNodeConfig().IsKernelIndexEnabled())
+	{
+		pRocksDB->DeleteAll("KERNEL_POS");
+	}
+
+	auto pBlockDB = std::make_shared<BlockDB>(config, pRocksDB);
+	pBlockDB->RegisterWithMemoryBudget(pBlockCache);
+	if (dbConfig.UseFlatFileBlocks())
+	{
+		pBlockDB->OpenBlockStore(config.GetNodeConfig().GetDatabasePath() / "BLOCKS", dbConfig.GetBlockSegmentBytes());
+	}
+
+	pBlockDB->MigrateBlocks();
+
+	if (config.GetNodeConfig().IsUTXOIndexEnabled())
+	{
+		pBlockDB->LoadOutputPositions(sequenceNumber);
+	}
+
+	return pBlockDB;
+}
+
+BlockDB::~BlockDB()
+{
+	if (m_utxoIndexEnabled && !m_pRocksDB->IsTransactional())
+	{
+		try
+		{
+			WriteOutputPositionsCheckpoint();
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_F("Failed to write output positions checkpoint: {}", e.what());
+		}
+	}
+}
+
+void BlockDB::CatchUpWithPrimary()
+{
+	m_pRocksDB->CatchUpWithPrimary();
+}
+
+void BlockDB::RegisterWithMemoryBudget(const std::shared_ptr<rocksdb::Cache>& pBlockCache)
+{
+	m_memoryBudgetRegistrations.push_back(MemoryBudgetAPI::Register(MemoryConsumer{
+		"header_cache",
+		10,
+		HEADER_CACHE_ENTRY_BYTES * 128,
+		[this]() { return m_blockHeadersCache.Size() * HEADER_CACHE_ENTRY_BYTES; },
+		[this](const size_t limitBytes) { m_blockHeadersCache.SetCapacity(limitBytes / HEADER_CACHE_ENTRY_BYTES); }
+	}));
+
+	if (pBlockCache != nullptr)
+	{
+		m_memoryBudgetRegistrations.push_back(MemoryBudgetAPI::Register(MemoryConsumer{
+			"db_block_cache",
+			35,
+			8 * 1024 * 1024,
+			[pBlockCache]() { return pBlockCache->GetUsage(); },
+			[pBlockCache](const size_t limitBytes) { pBlockCache->SetCapacity(limitBytes); }
+		}));
+	}
+}
+
+void BlockDB::OpenBlockStore(const fs::path& directory, const size_t maxSegmentSize)
+{
+	m_pBlockStore = BlockFileStore::Open(directory, maxSegmentSize);
+}
+
+void BlockDB::MigrateBlocks()
+{
+	static constexpr size_t BLOCKS_PER_COMMIT = 1000;
+
+	// AddBlock writes to whichever layout is enabled. Only the block store needs committing, since rocksdb isn't in a batch yet.
+	size_t numMigrated = 0;
+	auto migrate = [this, &numMigrated](const FullBlock& block) {
+		if (numMigrated == 0)
+		{
+			LOG_INFO_F("Migrating blocks to the {}", m_pBlockStore != nullptr ? "block file store" : (m_splitBlocks ? "split block tables" : "BLOCK table"));
+		}
+
+		AddBlock(block);
+		if (++numMigrated % BLOCKS_PER_COMMIT == 0)
+		{
+			if (m_pBlockStore != nullptr)
+			{
+				m_pBlockStore->Commit();
+			}
+
+			LOG_INFO_F("Migrated {} blocks", numMigrated);
+		}
+	};
+
+	if (m_pBlockStore != nullptr || m_splitBlocks)
+	{
+		m_pRocksDB->ForEach<FullBlock>("BLOCK", [&migrate](const rocksdb::Slice&, FullBlock&& block) { migrate(block); });
+	}
+
+	std::vector<Hash> splitHashes;
+	if (!m_splitBlocks)
+	{
+		// Every block has at least one kernel, so the kernels table has an entry for every split block.
+		m_pRocksDB->ForEach<BlockPartList<TransactionKernel>>("BLOCK_KERNELS", [&splitHashes](const rocksdb::Slice& key, BlockPartList<TransactionKernel>&&) {
+			splitHashes.emplace_back((const unsigned char*)key.data());
+		});
+
+		for (size_t i = 0; i < splitHashes.size(); i += BLOCKS_PER_COMMIT)
+		{
+			const std::vector<Hash> hashes(splitHashes.begin() + i, splitHashes.begin() + (std::min)(i + BLOCKS_PER_COMMIT, splitHashes.size()));
+			std::vector<std::unique_ptr<BlockParts>> blocks = GetSplitBlockParts(hashes, EBlockPart::ALL);
+			for (size_t j = 0; j < blocks.size(); j++)
+			{
+				if (blocks[j] == nullptr)
+				{
+					LOG_WARNING_F("Block {} is missing its header or some of its parts. Skipping.", hashes[j]);
+					continue;
+				}
+
+				migrate(*ToFullBlock(std::move(*blocks[j])));
+			}
+		}
+	}
+
+	if (numMigrated > 0)
+	{
+		if (m_pBlockStore != nullptr)
+		{
+			m_pBlockStore->Commit();
+		}
+
+		// Only removed once every block is safely in its new layout, so an interrupted migration just starts over.
+		if (m_pBlockStore != nullptr || m_splitBlocks)
+		{
+			m_pRocksDB->DeleteAll("BLOCK");
+		}
+
+		LOG_INFO_F("Finished migrating {} blocks", numMigrated);
+	}
+
+	if (!splitHashes.empty())
+	{
+		for (const std::string& tableName : SPLIT_BLOCK_TABLES)
+		{
+			m_pRocksDB->DeleteAll(tableName);
+		}
+	}
+}
+
+void BlockDB::LoadOutputPositions(const uint64_t sequenceNumber)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	const bool fromCheckpoint = LoadOutputPositionsCheckpoint(sequenceNumber);
+	if (!fromCheckpoint)
+	{
+		m_outputPositions.clear();
+		m_pRocksDB->ForEach<OutputLocation>("OUTPUT_POS", [this](const rocksdb::Slice& key, OutputLocation&& location) {
+			std::vector<uint8_t> bytes((const uint8_t*)key.data(), (const uint8_t*)key.data() + key.size());
+			m_outputPositions.emplace(Commitment(CBigInteger<33>(std::move(bytes))), std::move(location));
+		});
+	}
+
+	m_utxoIndexEnabled = true;
+
+	LOG_INFO_F(
+		"Loaded {} output positions from the {} in {}ms",
+		m_outputPositions.size(),
+		fromCheckpoint ? "checkpoint" : "database",
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+	);
+}
+
+// Version, sequence number, and number of positions, followed by each commitment and location, and a checksum of everything before it.
+static const uint8_t OUTPUT_POSITIONS_CHECKPOINT_VERSION = 1;
+static const size_t OUTPUT_POSITIONS_CHECKPOINT_HEADER_SIZE = 1 + 8 + 8;
+static const size_t OUTPUT_POSITION_SIZE = 33 + 8 + 8;
+
+fs::path BlockDB::GetOutputPositionsCheckpointPath() const
+{
+	return m_config.GetNodeConfig().GetDatabasePath() / "output_positions.checkpoint";
+}
+
+bool BlockDB::LoadOutputPositionsCheckpoint(const uint64_t sequenceNumber)
+{
+	std::vector<uint8_t> data;
+	if (!FileUtil::ReadFile(GetOutputPositionsCheckpointPath(), data))
+	{
+		return false;
+	}
+
+	if (data.size() < OUTPUT_POSITIONS_CHECKPOINT_HEADER_SIZE + HASH_SIZE
+		|| Hasher::Blake2b(data.data(), data.size() - HASH_SIZE) != Hash(data.data() + data.size() - HASH_SIZE))
+	{
+		LOG_WARNING("Output positions checkpoint is corrupt");
+		return false;
+	}
+
+	try
+	{
+		ByteBuffer byteBuffer(data.data(), data.size() - HASH_SIZE);
+		const uint8_t version = byteBuffer.ReadU8();
+		const uint64_t checkpointSequenceNumber = byteBuffer.ReadU64();
+		const uint64_t numPositions = byteBuffer.ReadU64();
+		if (version != OUTPUT_POSITIONS_CHECKPOINT_VERSION || checkpointSequenceNumber != sequenceNumber)
+		{
+			LOG_INFO_F("Output positions checkpoint is stale (sequence {}, database at {})", checkpointSequenceNumber, sequenceNumber);
+			return false;
+		}
+
+		if (byteBuffer.GetRemainingSize() != numPositions * OUTPUT_POSITION_SIZE)
+		{
+			LOG_WARNING("Output positions checkpoint is truncated");
+			return false;
+		}
+
+		m_outputPositions.reserve(numPositions);
+		for (uint64_t i = 0; i < numPositions; i++)
+		{
+			Commitment commitment = Commitment::Deserialize(byteBuffer);
+			m_outputPositions.emplace(std::move(commitment), OutputLocation::Deserialize(byteBuffer));
+		}
+	}
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Failed to read output positions checkpoint: {}", e.what());
+		m_outputPositions.clear();
+		return false;
+	}
+
+	return true;
+}
+
+void BlockDB::WriteOutputPositionsCheckpoint() const
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	Serializer serializer;
+	serializer.Append<uint8_t>(OUTPUT_POSITIONS_CHECKPOINT_VERSION);
+	serializer.Append<uint64_t>(m_pRocksDB->GetLatestSequenceNumber());
+	serializer.Append<uint64_t>(m_outputPositions.size());
+	for (const auto& position : m_outputPositions)
+	{
+		position.first.Serialize(serializer);
+		position.second.Serialize(serializer);
+	}
+
+	const Hash checksum = Hasher::Blake2b(serializer.GetBytes());
+	serializer.AppendBigInteger(checksum);
+	FileUtil::SafeWriteToFile(GetOutputPositionsCheckpointPath(), serializer.GetBytes());
+
+	LOG_INFO_F(
+		"Wrote {} output positions to the checkpoint in {}ms",
+		m_outputPositions.size(),
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+	);
 }
 
 void BlockDB::Commit()
 {
+	TRACE_SPAN("BlockDB::Commit");
+
+	// Blocks are written first, so the chain never refers to a block that wasn't stored.
+	if (m_pBlockStore != nullptr)
+	{
+		m_pBlockStore->Commit();
+	}
+
 	m_pRocksDB->Commit();
 
+	if (m_outputPositionsCleared)
+	{
+		m_outputPositions.clear();
+		m_outputPositionsCleared = false;
+	}
+
+	for (auto& position : m_uncommittedPositions)
+	{
+		if (position.second.has_value())
+		{
+			m_outputPositions.insert_or_assign(position.first, position.second.value());
+		}
+		else
+		{
+			m_outputPositions.erase(position.first);
+		}
+	}
+
+	m_uncommittedPositions.clear();
+
 	for (auto pHeader : m_uncommitted)
 	{
 		m_blockHeadersCache.Put(pHeader->GetHash(), pHeader);
 	}
 
 	m_uncommitted.clear();
+
+	for (auto& sums : m_uncommittedSums)
+	{
+		m_blockSumsCache.Put(sums.first, sums.second);
+	}
+
+	m_uncommittedSums.clear();
 }
 
 void BlockDB::Rollback() noexcept
 {
 	m_uncommitted.clear();
+	m_uncommittedSums.clear();
+	m_uncommittedPositions.clear();
+	m_outputPositionsCleared = false;
+	if (m_pBlockStore != nullptr)
+	{
+		m_pBlockStore->Rollback();
+	}
+
 	m_pRocksDB->Rollback();
 }
 
 BlockHeaderPtr BlockDB::GetBlockHeader(const Hash& hash) const
 {
-	if (m_blockHeadersCache.Cached(hash))
+	std::optional<BlockHeaderPtr> cached = m_blockHeadersCache.Get(hash);
+	if (cached.has_value())
 	{
-		return m_blockHeadersCache.Get(hash);
+		return cached.value();
 	}
 
 	rocksdb::Slice key((const char*)hash.data(), hash.size());
 	auto pBlockHeader = m_pRocksDB->Get<BlockHeader>("HEADER", key);
 	if (pBlockHeader != nullptr)
 	{
-		return std::shared_ptr<BlockHeader>(std::move(pBlockHeader));
+		BlockHeaderPtr pHeader(std::move(pBlockHeader));
+
+		// Headers read during a batch may not be committed yet.
+		if (!m_pRocksDB->IsTransactional())
+		{
+			m_blockHeadersCache.Put(hash, pHeader);
+		}
+
+		return pHeader;
 	}
 
 	return nullptr;
 }
 
+std::vector<BlockHeaderPtr> BlockDB::GetBlockHeaders(const std::vector<Hash>& hashes) const
+{
+	std::vector<BlockHeaderPtr> headers(hashes.size());
+
+	// Only the headers that aren't cached are read from the database.
+	std::vector<size_t> missing;
+	std::vector<rocksdb::Slice> keys;
+	for (size_t i = 0; i < hashes.size(); i++)
+	{
+		std::optional<BlockHeaderPtr> cached = m_blockHeadersCache.Get(hashes[i]);
+		if (cached.has_value())
+		{
+			headers[i] = cached.value();
+		}
+		else
+		{
+			missing.push_back(i);
+			keys.emplace_back((const char*)hashes[i].data(), hashes[i].size());
+		}
+	}
+
+	if (!keys.empty())
+	{
+		auto found = m_pRocksDB->MultiGet<BlockHeader>("HEADER", keys);
+		for (size_t i = 0; i < missing.size(); i++)
+		{
+			if (found[i] != nullptr)
+			{
+				headers[missing[i]] = std::shared_ptr<BlockHeader>(std::move(found[i]));
+				if (!m_pRocksDB->IsTransactional())
+				{
+					m_blockHeadersCache.Put(hashes[missing[i]], headers[missing[i]]);
+				}
+			}
+		}
+	}
+
+	return headers;
+}
+
 void BlockDB::AddBlockHeader(BlockHeaderPtr pBlockHeader)
 {
 	LOG_TRACE_F("Adding header {}", *pBlockHeader);
@@ -108,22 +683,249 @@ void BlockDB::AddBlock(const FullBlock& block)
 {
 	LOG_TRACE_F("Adding block {}", block);
 
+	if (m_pBlockStore != nullptr)
+	{
+		m_pBlockStore->AddBlock(block);
+		return;
+	}
+
 	const std::vector<unsigned char>& hash = block.GetHash().GetData();
 	rocksdb::Slice key((const char*)hash.data(), hash.size());
-	m_pRocksDB->Put("BLOCK", DBEntry<FullBlock>(key, block));
+	if (!m_splitBlocks)
+	{
+		m_pRocksDB->Put("BLOCK", DBEntry<FullBlock>(key, block));
+		return;
+	}
+
+	// Headers are added well before their blocks, but a split block can't be read back without one.
+	if (GetBlockHeader(block.GetHash()) == nullptr)
+	{
+		AddBlockHeader(block.GetHeader());
+	}
+
+	std::vector<OutputIdentifier> outputs;
+	std::vector<RangeProof> rangeProofs;
+	outputs.reserve(block.GetOutputs().size());
+	rangeProofs.reserve(block.GetOutputs().size());
+	for (const TransactionOutput& output : block.GetOutputs())
+	{
+		outputs.push_back(OutputIdentifier::FromOutput(output));
+		rangeProofs.push_back(output.GetRangeProof());
+	}
+
+	m_pRocksDB->Put("BLOCK_INPUTS", ToPartEntry(key, std::vector<TransactionInput>(block.GetInputs())));
+	m_pRocksDB->Put("BLOCK_OUTPUTS", ToPartEntry(key, std::move(outputs)));
+	m_pRocksDB->Put("BLOCK_PROOFS", ToPartEntry(key, std::move(rangeProofs)));
+	m_pRocksDB->Put("BLOCK_KERNELS", ToPartEntry(key, std::vector<TransactionKernel>(block.GetKernels())));
 }
 
 std::unique_ptr<FullBlock> BlockDB::GetBlock(const Hash& hash) const
 {
+	if (m_pBlockStore != nullptr)
+	{
+		return m_pBlockStore->GetBlock(hash);
+	}
+
+	if (m_splitBlocks)
+	{
+		return std::move(GetBlocks({ hash }).front());
+	}
+
 	rocksdb::Slice key((const char*)hash.data(), hash.size());
 	return m_pRocksDB->Get<FullBlock>("BLOCK", key);
 }
 
+std::vector<std::unique_ptr<FullBlock>> BlockDB::GetBlocks(const std::vector<Hash>& hashes) const
+{
+	if (m_pBlockStore != nullptr)
+	{
+		// Blocks are deserialized straight from the mapped segments, so they're read on several threads at once.
+		std::vector<std::unique_ptr<FullBlock>> blocks(hashes.size());
+		std::atomic_size_t nextIndex = 0;
+		ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+		threadPool.RunParallel((std::min)(hashes.size(), threadPool.GetNumThreads()), [this, &hashes, &blocks, &nextIndex]() {
+			for (size_t i = nextIndex++; i < hashes.size(); i = nextIndex++)
+			{
+				blocks[i] = m_pBlockStore->GetBlock(hashes[i]);
+			}
+		});
+
+		return blocks;
+	}
+
+	if (m_splitBlocks)
+	{
+		std::vector<std::unique_ptr<BlockParts>> parts = GetSplitBlockParts(hashes, EBlockPart::ALL);
+		std::vector<std::unique_ptr<FullBlock>> blocks(hashes.size());
+		for (size_t i = 0; i < parts.size(); i++)
+		{
+			if (parts[i] != nullptr)
+			{
+				blocks[i] = ToFullBlock(std::move(*parts[i]));
+			}
+		}
+
+		return blocks;
+	}
+
+	std::vector<rocksdb::Slice> keys;
+	keys.reserve(hashes.size());
+	for (const Hash& hash : hashes)
+	{
+		keys.emplace_back((const char*)hash.data(), hash.size());
+	}
+
+	return m_pRocksDB->MultiGet<FullBlock>("BLOCK", keys);
+}
+
+bool BlockDB::HasBlock(const Hash& hash) const
+{
+	if (m_pBlockStore != nullptr)
+	{
+		return m_pBlockStore->HasBlock(hash);
+	}
+
+	if (m_splitBlocks)
+	{
+		return GetSplitBlockParts({ hash }, 0).front() != nullptr;
+	}
+
+	return GetBlock(hash) != nullptr;
+}
+
+std::vector<std::unique_ptr<BlockParts>> BlockDB::GetBlockParts(const std::vector<Hash>& hashes, const uint8_t parts) const
+{
+	if (m_splitBlocks)
+	{
+		return GetSplitBlockParts(hashes, parts);
+	}
+
+	// Whole blocks are stored together, so they're read in full and then split.
+	std::vector<std::unique_ptr<FullBlock>> blocks = GetBlocks(hashes);
+	std::vector<std::unique_ptr<BlockParts>> blockParts(blocks.size());
+	for (size_t i = 0; i < blocks.size(); i++)
+	{
+		if (blocks[i] != nullptr)
+		{
+			blockParts[i] = ToBlockParts(*blocks[i], parts);
+		}
+	}
+
+	return blockParts;
+}
+
+std::vector<std::unique_ptr<BlockParts>> BlockDB::GetSplitBlockParts(const std::vector<Hash>& hashes, const uint8_t parts) const
+{
+	std::vector<rocksdb::Slice> keys;
+	keys.reserve(hashes.size());
+	for (const Hash& hash : hashes)
+	{
+		keys.emplace_back((const char*)hash.data(), hash.size());
+	}
+
+	// The header alone doesn't mean the block is stored, so with no parts requested, the kernels are read to check.
+	const uint8_t partsToRead = (parts & EBlockPart::ALL) == 0 ? (uint8_t)EBlockPart::KERNELS : parts;
+	const bool readInputs = (partsToRead & EBlockPart::INPUTS) != 0;
+	const bool readOutputs = (partsToRead & EBlockPart::OUTPUTS) != 0;
+	const bool readProofs = (partsToRead & EBlockPart::RANGEPROOFS) != 0;
+	const bool readKernels = (partsToRead & EBlockPart::KERNELS) != 0;
+
+	const std::vector<BlockHeaderPtr> headers = GetBlockHeaders(hashes);
+	auto inputs = ReadParts<TransactionInput>(*m_pRocksDB, "BLOCK_INPUTS", keys, readInputs);
+	auto outputs = ReadParts<OutputIdentifier>(*m_pRocksDB, "BLOCK_OUTPUTS", keys, readOutputs);
+	auto rangeProofs = ReadParts<RangeProof>(*m_pRocksDB, "BLOCK_PROOFS", keys, readProofs);
+	auto kernels = ReadParts<TransactionKernel>(*m_pRocksDB, "BLOCK_KERNELS", keys, readKernels);
+
+	std::vector<std::unique_ptr<BlockParts>> blockParts(hashes.size());
+	for (size_t i = 0; i < hashes.size(); i++)
+	{
+		const bool found = headers[i] != nullptr
+			&& (!readInputs || inputs[i] != nullptr)
+			&& (!readOutputs || outputs[i] != nullptr)
+			&& (!readProofs || rangeProofs[i] != nullptr)
+			&& (!readKernels || kernels[i] != nullptr);
+		if (!found)
+		{
+			continue;
+		}
+
+		blockParts[i] = std::make_unique<BlockParts>();
+		blockParts[i]->pHeader = headers[i];
+		if (readInputs)
+		{
+			blockParts[i]->inputs = std::move(inputs[i]->GetItems());
+		}
+
+		if (readOutputs)
+		{
+			blockParts[i]->outputs = std::move(outputs[i]->GetItems());
+		}
+
+		if (readProofs)
+		{
+			blockParts[i]->rangeProofs = std::move(rangeProofs[i]->GetItems());
+		}
+
+		if ((parts & EBlockPart::KERNELS) != 0)
+		{
+			blockParts[i]->kernels = std::move(kernels[i]->GetItems());
+		}
+	}
+
+	return blockParts;
+}
+
 void BlockDB::ClearBlocks()
 {
+	if (m_pBlockStore != nullptr)
+	{
+		m_pBlockStore->ClearBlocks();
+		return;
+	}
+
 	LOG_WARNING("Deleting all blocks.");
 
-	m_pRocksDB->DeleteAll("BLOCK");
+	if (m_splitBlocks)
+	{
+		for (const std::string& tableName : SPLIT_BLOCK_TABLES)
+		{
+			m_pRocksDB->DeleteAll(tableName);
+		}
+	}
+	else
+	{
+		m_pRocksDB->DeleteAll("BLOCK");
+	}
+}
+
+void BlockDB::RemoveBlocks(const std::vector<Hash>& hashes)
+{
+	LOG_DEBUG_F("Removing {} blocks", hashes.size());
+
+	std::vector<std::string> keys;
+	std::transform(
+		hashes.begin(), hashes.end(),
+		std::back_inserter(keys),
+		[](const Hash& hash) { return std::string((const char*)hash.data(), hash.size()); }
+	);
+
+	if (m_pBlockStore != nullptr)
+	{
+		m_pBlockStore->RemoveBlocks(hashes);
+	}
+	else if (m_splitBlocks)
+	{
+		for (const std::string& tableName : SPLIT_BLOCK_TABLES)
+		{
+			m_pRocksDB->Delete(tableName, keys);
+		}
+	}
+	else
+	{
+		m_pRocksDB->Delete("BLOCK", keys);
+	}
+
+	m_pRocksDB->Delete("SPENT_OUTPUTS", keys);
 }
 
 void BlockDB::AddBlockSums(const Hash& blockHash, const BlockSums& blockSums)
@@ -131,11 +933,32 @@ void BlockDB::AddBlockSums(const Hash& blockHash, const BlockSums& blockSums)
 	LOG_TRACE_F("Adding BlockSums for block {}", blockHash);
 
 	rocksdb::Slice key((const char*)blockHash.data(), blockHash.size());
-	 m_pRocksDB->Put("BLOCK_SUMS", DBEntry<BlockSums>(key, blockSums));
+	m_pRocksDB->Put("BLOCK_SUMS", DBEntry<BlockSums>(key, blockSums));
+
+	auto pBlockSums = std::make_shared<const BlockSums>(blockSums);
+	if (m_pRocksDB->IsTransactional())
+	{
+		m_uncommittedSums.insert_or_assign(blockHash, pBlockSums);
+	}
+	else
+	{
+		m_blockSumsCache.Put(blockHash, pBlockSums);
+	}
 }
 
 std::unique_ptr<BlockSums> BlockDB::GetBlockSums(const Hash& blockHash) const
 {
+	auto uncommittedIter = m_uncommittedSums.find(blockHash);
+	if (uncommittedIter != m_uncommittedSums.cend())
+	{
+		return std::make_unique<BlockSums>(*uncommittedIter->second);
+	}
+
+	if (m_blockSumsCache.Cached(blockHash))
+	{
+		return std::make_unique<BlockSums>(*m_blockSumsCache.Get(blockHash));
+	}
+
 	rocksdb::Slice key((const char*)blockHash.data(), blockHash.size());
 	return m_pRocksDB->Get<BlockSums>("BLOCK_SUMS", key);
 }
@@ -145,6 +968,8 @@ void BlockDB::ClearBlockSums()
 	LOG_WARNING("Deleting all block sums.");
 
 	m_pRocksDB->DeleteAll("BLOCK_SUMS");
+	m_blockSumsCache.Clear();
+	m_uncommittedSums.clear();
 }
 
 void BlockDB::AddOutputPosition(const Commitment& outputCommitment, const OutputLocation& location)
@@ -152,14 +977,67 @@ void BlockDB::AddOutputPosition(const Commitment& outputCommitment, const Output
 	rocksdb::Slice key((const char*)outputCommitment.data(), outputCommitment.size());
 
 	m_pRocksDB->Put("OUTPUT_POS", DBEntry<OutputLocation>(key, location));
+
+	if (m_utxoIndexEnabled)
+	{
+		if (m_pRocksDB->IsTransactional())
+		{
+			m_uncommittedPositions.insert_or_assign(outputCommitment, std::make_optional(location));
+		}
+		else
+		{
+			m_outputPositions.insert_or_assign(outputCommitment, location);
+		}
+	}
 }
 
 std::unique_ptr<OutputLocation> BlockDB::GetOutputPosition(const Commitment& outputCommitment) const
 {
+	if (m_utxoIndexEnabled)
+	{
+		auto uncommittedIter = m_uncommittedPositions.find(outputCommitment);
+		if (uncommittedIter != m_uncommittedPositions.cend())
+		{
+			return uncommittedIter->second.has_value() ? std::make_unique<OutputLocation>(uncommittedIter->second.value()) : nullptr;
+		}
+
+		if (m_outputPositionsCleared)
+		{
+			return nullptr;
+		}
+
+		auto iter = m_outputPositions.find(outputCommitment);
+		return iter != m_outputPositions.cend() ? std::make_unique<OutputLocation>(iter->second) : nullptr;
+	}
+
 	rocksdb::Slice key((const char*)outputCommitment.data(), outputCommitment.size());
 	return m_pRocksDB->Get<OutputLocation>("OUTPUT_POS", key);
 }
 
+std::vector<std::unique_ptr<OutputLocation>> BlockDB::GetOutputPositions(const std::vector<Commitment>& outputCommitments) const
+{
+	if (m_utxoIndexEnabled)
+	{
+		std::vector<std::unique_ptr<OutputLocation>> positions;
+		positions.reserve(outputCommitments.size());
+		for (const Commitment& commitment : outputCommitments)
+		{
+			positions.push_back(GetOutputPosition(commitment));
+		}
+
+		return positions;
+	}
+
+	std::vector<rocksdb::Slice> keys;
+	keys.reserve(outputCommitments.size());
+	for (const Commitment& commitment : outputCommitments)
+	{
+		keys.emplace_back((const char*)commitment.data(), commitment.size());
+	}
+
+	return m_pRocksDB->MultiGet<OutputLocation>("OUTPUT_POS", keys);
+}
+
 void BlockDB::RemoveOutputPositions(const std::vector<Commitment>& outputCommitments)
 {
 	std::vector<std::string> keys;
@@ -170,6 +1048,21 @@ void BlockDB::RemoveOutputPositions(const std::vector<Commitment>& outputCommitm
 	);
 
 	m_pRocksDB->Delete("OUTPUT_POS", keys);
+
+	if (m_utxoIndexEnabled)
+	{
+		for (const Commitment& commitment : outputCommitments)
+		{
+			if (m_pRocksDB->IsTransactional())
+			{
+				m_uncommittedPositions.insert_or_assign(commitment, std::nullopt);
+			}
+			else
+			{
+				m_outputPositions.erase(commitment);
+			}
+		}
+	}
 }
 
 void BlockDB::ClearOutputPositions()
@@ -177,6 +1070,127 @@ void BlockDB::ClearOutputPositions()
 	LOG_WARNING("Deleting all output positions.");
 
 	m_pRocksDB->DeleteAll("OUTPUT_POS");
+
+	m_uncommittedPositions.clear();
+	if (m_pRocksDB->IsTransactional())
+	{
+		m_outputPositionsCleared = true;
+	}
+	else
+	{
+		m_outputPositions.clear();
+	}
+}
+
+void BlockDB::AddKernelPosition(const Commitment& excessCommitment, const OutputLocation& location)
+{
+	if (m_kernelIndexEnabled)
+	{
+		rocksdb::Slice key((const char*)excessCommitment.data(), excessCommitment.size());
+		m_pRocksDB->Put("KERNEL_POS", DBEntry<OutputLocation>(key, location));
+	}
+}
+
+std::unique_ptr<OutputLocation> BlockDB::GetKernelPosition(const Commitment& excessCommitment) const
+{
+	if (!m_kernelIndexEnabled)
+	{
+		return nullptr;
+	}
+
+	rocksdb::Slice key((const char*)excessCommitment.data(), excessCommitment.size());
+	return m_pRocksDB->Get<OutputLocation>("KERNEL_POS", key);
+}
+
+void BlockDB::RemoveKernelPositions(const std::vector<Commitment>& excessCommitments)
+{
+	if (m_kernelIndexEnabled)
+	{
+		std::vector<std::string> keys;
+		std::transform(
+			excessCommitments.begin(), excessCommitments.end(),
+			std::back_inserter(keys),
+			[](const Commitment& commit) { return std::string((const char*)commit.data(), commit.size()); }
+		);
+
+		m_pRocksDB->Delete("KERNEL_POS", keys);
+	}
+}
+
+void BlockDB::ClearKernelPositions()
+{
+	LOG_WARNING("Deleting all kernel positions.");
+
+	m_pRocksDB->DeleteAll("KERNEL_POS");
+}
+
+void BlockDB::AddNRDKernelPosition(const Commitment& excessCommitment, const OutputLocation& location)
+{
+	rocksdb::Slice key((const char*)excessCommitment.data(), excessCommitment.size());
+	std::unique_ptr<NRDKernelPositions> pPositions = m_pRocksDB->Get<NRDKernelPositions>("NRD_KERNEL_POS", key);
+
+	// Occurrences a week or more below this one can't fail a relative lock at or above its height, even after rewinding.
+	std::vector<OutputLocation> locations;
+	if (pPositions != nullptr)
+	{
+		for (const OutputLocation& previous : pPositions->GetLocations())
+		{
+			if (previous.GetBlockHeight() + Consensus::WEEK_HEIGHT > location.GetBlockHeight())
+			{
+				locations.push_back(previous);
+			}
+		}
+	}
+
+	locations.push_back(location);
+	m_pRocksDB->Put("NRD_KERNEL_POS", DBEntry<NRDKernelPositions>(key, NRDKernelPositions(std::move(locations))));
+}
+
+std::unique_ptr<OutputLocation> BlockDB::GetNRDKernelPosition(const Commitment& excessCommitment) const
+{
+	rocksdb::Slice key((const char*)excessCommitment.data(), excessCommitment.size());
+	std::unique_ptr<NRDKernelPositions> pPositions = m_pRocksDB->Get<NRDKernelPositions>("NRD_KERNEL_POS", key);
+	if (pPositions == nullptr || pPositions->GetLocations().empty())
+	{
+		return nullptr;
+	}
+
+	return std::make_unique<OutputLocation>(pPositions->GetLocations().back());
+}
+
+void BlockDB::RewindNRDKernelPositions(const std::vector<Commitment>& excessCommitments, const uint64_t kernelMMRSize)
+{
+	for (const Commitment& excessCommitment : excessCommitments)
+	{
+		rocksdb::Slice key((const char*)excessCommitment.data(), excessCommitment.size());
+		std::unique_ptr<NRDKernelPositions> pPositions = m_pRocksDB->Get<NRDKernelPositions>("NRD_KERNEL_POS", key);
+		if (pPositions == nullptr)
+		{
+			continue;
+		}
+
+		std::vector<OutputLocation>& locations = pPositions->GetLocations();
+		while (!locations.empty() && locations.back().GetMMRIndex() >= kernelMMRSize)
+		{
+			locations.pop_back();
+		}
+
+		if (locations.empty())
+		{
+			m_pRocksDB->Delete("NRD_KERNEL_POS", key);
+		}
+		else
+		{
+			m_pRocksDB->Put("NRD_KERNEL_POS", DBEntry<NRDKernelPositions>(key, NRDKernelPositions(std::move(locations))));
+		}
+	}
+}
+
+void BlockDB::ClearNRDKernelPositions()
+{
+	LOG_WARNING("Deleting all NRD kernel positions.");
+
+	m_pRocksDB->DeleteAll("NRD_KERNEL_POS");
 }
 
 void BlockDB::AddSpentPositions(const Hash& blockHash, const std::vector<SpentOutput>& outputPositions)
@@ -187,18 +1201,16 @@ void BlockDB::AddSpentPositions(const Hash& blockHash, const std::vector<SpentOu
 	m_pRocksDB->Put("SPENT_OUTPUTS", DBEntry<SpentOutputs>(key, std::make_unique<SpentOutputs>(outputPositions)));
 }
 
-std::unordered_map<Commitment, OutputLocation> BlockDB::GetSpentPositions(const Hash& blockHash) const
+std::vector<std::unique_ptr<SpentOutputs>> BlockDB::GetSpentOutputs(const std::vector<Hash>& blockHashes) const
 {
-	rocksdb::Slice key((const char*)blockHash.data(), blockHash.size());
-
-	auto pSpent = m_pRocksDB->Get<SpentOutputs>("SPENT_OUTPUTS", key);
-	if (pSpent == nullptr)
+	std::vector<rocksdb::Slice> keys;
+	keys.reserve(blockHashes.size());
+	for (const Hash& blockHash : blockHashes)
 	{
-		LOG_ERROR_F("Failed to retrieve spent positions for block ({})", blockHash);
-		throw DATABASE_EXCEPTION("Failed to retrieve spent positions");
+		keys.emplace_back((const char*)blockHash.data(), blockHash.size());
 	}
 
-	return pSpent->BuildMap();
+	return m_pRocksDB->MultiGet<SpentOutputs>("SPENT_OUTPUTS", keys);
 }
 
 void BlockDB::ClearSpentPositions()
@@ -210,10 +1222,29 @@ void BlockDB::ClearSpentPositions()
 
 void BlockDB::OnInitWrite()
 {
+	m_uncommittedPositions.clear();
+	m_outputPositionsCleared = false;
+	if (m_pBlockStore != nullptr)
+	{
+		m_pBlockStore->Rollback();
+	}
+
 	m_pRocksDB->OnInitWrite();
 }
 
 void BlockDB::OnEndWrite()
 {
 	m_pRocksDB->OnEndWrite();
-}
\ No newline at end of file
+}
+
+DBStats BlockDB::GetStats() const
+{
+	DBStats stats = m_pRocksDB->GetStats();
+	const CacheStats headerCacheStats = m_blockHeadersCache.GetStats();
+	stats.headerCacheHits = headerCacheStats.hits;
+	stats.headerCacheMisses = headerCacheStats.misses;
+	stats.headerCacheSize = headerCacheStats.size;
+	stats.headerCacheCapacity = headerCacheStats.capacity;
+
+	return stats;
+}
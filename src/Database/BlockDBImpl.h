@@ -1,20 +1,37 @@
 #pragma once
 
+#include "BlockFileStore.h"
+
 #include <Database/BlockDb.h>
 #include <Config/Config.h>
+#include <Core/Models/OutputLocation.h>
+#include <Crypto/Commitment.h>
+#include <Common/MemoryBudget.h>
+#include <Common/ShardedCache.h>
 #include <caches/Cache.h>
+#include <atomic>
 #include <mutex>
+#include <optional>
 #include <set>
+#include <unordered_map>
 
 // Forward Declarations
 class RocksDB;
+namespace rocksdb { class Cache; }
 
 class BlockDB : public IBlockDB
 {
 public:
 	BlockDB(const Config& config, const std::shared_ptr<RocksDB>& pRocksDB)
-		: m_config(config), m_pRocksDB(pRocksDB), m_blockHeadersCache(128) { }
-	virtual ~BlockDB() = default;
+		: m_config(config),
+		m_pRocksDB(pRocksDB),
+		m_blockHeadersCache(config.GetNodeConfig().GetDatabase().GetHeaderCacheSize()),
+		m_blockSumsCache(BLOCK_SUMS_CACHE_SIZE),
+		m_utxoIndexEnabled(false),
+		m_outputPositionsCleared(false),
+		m_kernelIndexEnabled(config.GetNodeConfig().IsKernelIndexEnabled()),
+		m_splitBlocks(config.GetNodeConfig().GetDatabase().UseSplitBlocks() && !config.GetNodeConfig().GetDatabase().UseFlatFileBlocks()) { }
+	virtual ~BlockDB();
 
 	static std::shared_ptr<BlockDB> OpenDB(const Config& config);
 
@@ -24,13 +41,18 @@ public:
 	void OnEndWrite() final;
 
 	BlockHeaderPtr GetBlockHeader(const Hash& hash) const final;
+	std::vector<BlockHeaderPtr> GetBlockHeaders(const std::vector<Hash>& hashes) const final;
 
 	void AddBlockHeader(BlockHeaderPtr pBlockHeader) final;
 	void AddBlockHeaders(const std::vector<BlockHeaderPtr>& blockHeaders) final;
 
 	void AddBlock(const FullBlock& block) final;
 	std::unique_ptr<FullBlock> GetBlock(const Hash& hash) const final;
+	std::vector<std::unique_ptr<FullBlock>> GetBlocks(const std::vector<Hash>& hashes) const final;
+	bool HasBlock(const Hash& hash) const final;
+	std::vector<std::unique_ptr<BlockParts>> GetBlockParts(const std::vector<Hash>& hashes, const uint8_t parts) const final;
 	void ClearBlocks() final;
+	void RemoveBlocks(const std::vector<Hash>& hashes) final;
 
 	void AddBlockSums(const Hash& blockHash, const BlockSums& blockSums) final;
 	std::unique_ptr<BlockSums> GetBlockSums(const Hash& blockHash) const final;
@@ -38,17 +60,101 @@ public:
 
 	void AddOutputPosition(const Commitment& outputCommitment, const OutputLocation& location) final;
 	std::unique_ptr<OutputLocation> GetOutputPosition(const Commitment& outputCommitment) const final;
+	std::vector<std::unique_ptr<OutputLocation>> GetOutputPositions(const std::vector<Commitment>& outputCommitments) const final;
 	void RemoveOutputPositions(const std::vector<Commitment>& outputCommitments) final;
 	void ClearOutputPositions() final;
 
+	void AddKernelPosition(const Commitment& excessCommitment, const OutputLocation& location) final;
+	std::unique_ptr<OutputLocation> GetKernelPosition(const Commitment& excessCommitment) const final;
+	void RemoveKernelPositions(const std::vector<Commitment>& excessCommitments) final;
+	void ClearKernelPositions() final;
+
+	void AddNRDKernelPosition(const Commitment& excessCommitment, const OutputLocation& location) final;
+	std::unique_ptr<OutputLocation> GetNRDKernelPosition(const Commitment& excessCommitment) const final;
+	void RewindNRDKernelPositions(const std::vector<Commitment>& excessCommitments, const uint64_t kernelMMRSize) final;
+	void ClearNRDKernelPositions() final;
+
 	void AddSpentPositions(const Hash& blockHash, const std::vector<SpentOutput>& outputPostions) final;
-	std::unordered_map<Commitment, OutputLocation> GetSpentPositions(const Hash& blockHash) const final;
+	std::vector<std::unique_ptr<SpentOutputs>> GetSpentOutputs(const std::vector<Hash>& blockHashes) const final;
 	void ClearSpentPositions() final;
 
+	DBStats GetStats() const final;
+	void CatchUpWithPrimary() final;
+
 private:
+	// BlockSums are only 2 commitments, so enough are kept to cover the blocks applied and rewound by most reorgs.
+	static constexpr size_t BLOCK_SUMS_CACHE_SIZE = 1024;
+
+	// Roughly what a cached header costs, including its proof of work and the cache's bookkeeping.
+	static constexpr size_t HEADER_CACHE_ENTRY_BYTES = 1024;
+
+	//
+	// Lets the memory budget size the header cache and (when given) the database's block cache.
+	//
+	void RegisterWithMemoryBudget(const std::shared_ptr<rocksdb::Cache>& pBlockCache);
+
 	const Config& m_config;
 	std::shared_ptr<RocksDB> m_pRocksDB;
-	FIFOCache<Hash, BlockHeaderPtr> m_blockHeadersCache;
+
+	//
+	// Deserialized headers, filled as batches commit and as committed headers are read. Internally synchronized,
+	// and scan-resistant (see ShardedCache), so serving old headers to syncing peers doesn't evict the recent ones validation uses.
+	//
+	mutable ShardedCache<Hash, BlockHeaderPtr> m_blockHeadersCache;
 
 	std::vector<BlockHeaderPtr> m_uncommitted;
+
+	//
+	// The most recently added BlockSums, so validating a block against its parent's sums doesn't read and deserialize them
+	// from the database. Like the header cache, only committed sums are cached, and the current batch's are kept aside until it commits.
+	//
+	FIFOCache<Hash, std::shared_ptr<const BlockSums>> m_blockSumsCache;
+	std::unordered_map<Hash, std::shared_ptr<const BlockSums>> m_uncommittedSums;
+
+	//
+	// When enabled, the OUTPUT_POS table is mirrored in memory, so the per-input and per-output lookups when applying blocks
+	// and validating txs don't hit the database. Loaded from the table on startup, and kept in sync by applying each batch's
+	// changes once it commits. Readers only ever see committed positions, and writers see their own uncommitted changes.
+	//
+	void LoadOutputPositions(const uint64_t sequenceNumber);
+
+	//
+	// So restarts don't have to rebuild the mirror by reading the whole table, it's written to a checkpoint file on shutdown,
+	// along with the sequence number of the database's last write and a checksum. The checkpoint is only loaded if the database
+	// still has the same sequence number when opened, ie. nothing was written since, and it's intact.
+	//
+	fs::path GetOutputPositionsCheckpointPath() const;
+	bool LoadOutputPositionsCheckpoint(const uint64_t sequenceNumber);
+	void WriteOutputPositionsCheckpoint() const;
+
+	//
+	// When enabled, full blocks are stored in a BlockFileStore instead of the BLOCK table.
+	//
+	void OpenBlockStore(const fs::path& directory, const size_t maxSegmentSize);
+
+	//
+	// Moves blocks stored in a layout that's no longer enabled (the BLOCK table, or the split block tables) into the enabled one on startup.
+	//
+	void MigrateBlocks();
+
+	BlockFileStore::Ptr m_pBlockStore;
+
+	//
+	// When enabled, each block's inputs, outputs, rangeproofs, and kernels are stored in the BLOCK_INPUTS, BLOCK_OUTPUTS, BLOCK_PROOFS,
+	// and BLOCK_KERNELS tables, rather than as one value in the BLOCK table. The header comes from the HEADER table.
+	// Reads only the tables for the parts requested. A block is only found if its header and every requested part are.
+	//
+	std::vector<std::unique_ptr<BlockParts>> GetSplitBlockParts(const std::vector<Hash>& hashes, const uint8_t parts) const;
+
+	bool m_utxoIndexEnabled;
+	std::unordered_map<Commitment, OutputLocation> m_outputPositions;
+
+	// Changes made by the current batch. A nullopt location means the position was removed.
+	std::unordered_map<Commitment, std::optional<OutputLocation>> m_uncommittedPositions;
+	bool m_outputPositionsCleared;
+
+	bool m_kernelIndexEnabled;
+	bool m_splitBlocks;
+
+	std::vector<MemoryBudgetRegistration::UPtr> m_memoryBudgetRegistrations;
 };
\ No newline at end of file
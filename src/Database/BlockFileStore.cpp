@@ -0,0 +1,325 @@
+#include "BlockFileStore.h"
+
+#include <Core/Exceptions/FileException.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Serialization/Serializer.h>
+#include <Common/Util/FileUtil.h>
+#include <Common/Util/StringUtil.h>
+#include <Common/Logger.h>
+#include <algorithm>
+#include <cstdio>
+
+BlockFileStore::Ptr BlockFileStore::Open(const fs::path& directory, const size_t maxSegmentSize)
+{
+	fs::create_directories(directory);
+
+	auto pStore = std::make_shared<BlockFileStore>(directory, maxSegmentSize);
+	pStore->Load();
+
+	return pStore;
+}
+
+void BlockFileStore::Load()
+{
+	m_pIndexFile = DataFile<INDEX_ENTRY_SIZE>::Load(m_directory / "index.dat");
+
+	uint32_t lastSegment = 0;
+	const uint64_t numEntries = m_pIndexFile->GetSize();
+	if (numEntries > 0)
+	{
+		m_pIndexFile->VisitData(0, numEntries, [this, numEntries, &lastSegment](const unsigned char* pData) {
+			for (uint64_t i = 0; i < numEntries; i++)
+			{
+				ByteBuffer byteBuffer(pData + (i * INDEX_ENTRY_SIZE), INDEX_ENTRY_SIZE);
+				Hash hash = byteBuffer.ReadBigInteger<32>();
+
+				Location location;
+				location.segment = byteBuffer.ReadU32();
+				location.offset = byteBuffer.ReadU64();
+				location.size = byteBuffer.ReadU32();
+				if (location.segment == REMOVED_SEGMENT)
+				{
+					m_locations.erase(hash);
+				}
+				else
+				{
+					lastSegment = (std::max)(lastSegment, location.segment);
+					m_locations.insert_or_assign(std::move(hash), location);
+				}
+			}
+		});
+	}
+
+	// Segments emptied by RemoveBlocks are deleted, so there may be gaps.
+	for (uint32_t segment = 0; segment <= lastSegment || FileUtil::Exists(GetSegmentPath(segment)); segment++)
+	{
+		if (FileUtil::Exists(GetSegmentPath(segment)))
+		{
+			LoadSegment(segment);
+		}
+		else
+		{
+			m_segments.push_back(nullptr);
+			m_numBlocksBySegment.push_back(0);
+		}
+	}
+
+	if (m_segments.empty() || m_segments.back() == nullptr)
+	{
+		LoadSegment((uint32_t)m_segments.size());
+	}
+
+	// The segments are flushed before the index, so every entry should refer to data on disk.
+	for (auto iter = m_locations.begin(); iter != m_locations.end();)
+	{
+		const Location& location = iter->second;
+		const auto& pSegment = m_segments[location.segment];
+		if (pSegment == nullptr || (location.offset + location.size) > pSegment->GetSize())
+		{
+			LOG_WARNING_F("Block {} not found at its indexed location", iter->first);
+			iter = m_locations.erase(iter);
+		}
+		else
+		{
+			++m_numBlocksBySegment[location.segment];
+			++iter;
+		}
+	}
+
+	LOG_INFO_F("Loaded {} blocks in {} segments from {}", m_locations.size(), m_segments.size(), m_directory);
+}
+
+void BlockFileStore::LoadSegment(const uint32_t segment)
+{
+	auto pSegment = std::make_shared<AppendOnlyFile>(GetSegmentPath(segment));
+	pSegment->Load();
+	m_segments.push_back(pSegment);
+	m_numBlocksBySegment.push_back(0);
+}
+
+fs::path BlockFileStore::GetSegmentPath(const uint32_t segment) const
+{
+	char fileName[16];
+	snprintf(fileName, sizeof(fileName), "blk%05u.dat", segment);
+	return m_directory / fileName;
+}
+
+void BlockFileStore::AddIndexEntry(const Hash& hash, const Location& location)
+{
+	Serializer serializer(INDEX_ENTRY_SIZE);
+	serializer.AppendBigInteger(hash);
+	serializer.Append<uint32_t>(location.segment);
+	serializer.Append<uint64_t>(location.offset);
+	serializer.Append<uint32_t>(location.size);
+	m_pIndexFile->AddData(serializer.GetBytes());
+}
+
+void BlockFileStore::Commit()
+{
+	if (m_cleared)
+	{
+		RemoveFiles();
+		Load();
+		m_cleared = false;
+	}
+
+	// Blocks are written back-to-back, and a new segment is started once the current one is full.
+	std::vector<std::pair<Hash, Location>> added;
+	for (const Hash& hash : m_uncommittedOrder)
+	{
+		const std::vector<unsigned char>& serialized = m_uncommitted.at(hash);
+		if (m_segments.back()->GetSize() > 0 && (m_segments.back()->GetSize() + serialized.size()) > m_maxSegmentSize)
+		{
+			if (!m_segments.back()->Flush())
+			{
+				throw FILE_EXCEPTION_F("Failed to flush block segment {}", m_segments.size() - 1);
+			}
+
+			LoadSegment((uint32_t)m_segments.size());
+		}
+
+		Location location;
+		location.segment = (uint32_t)(m_segments.size() - 1);
+		location.offset = m_segments.back()->GetSize();
+		location.size = (uint32_t)serialized.size();
+		m_segments.back()->Append(serialized);
+		added.push_back({ hash, location });
+	}
+
+	if (!m_segments.back()->Flush())
+	{
+		throw FILE_EXCEPTION_F("Failed to flush block segment {}", m_segments.size() - 1);
+	}
+
+	for (const auto& entry : added)
+	{
+		AddIndexEntry(entry.first, entry.second);
+	}
+
+	for (const Hash& hash : m_uncommittedRemovals)
+	{
+		if (m_locations.find(hash) != m_locations.end())
+		{
+			AddIndexEntry(hash, Location{ REMOVED_SEGMENT, 0, 0 });
+		}
+	}
+
+	m_pIndexFile->Commit();
+
+	for (auto& entry : added)
+	{
+		++m_numBlocksBySegment[entry.second.segment];
+		m_locations.insert_or_assign(std::move(entry.first), entry.second);
+	}
+
+	ApplyRemovals();
+
+	m_uncommitted.clear();
+	m_uncommittedOrder.clear();
+}
+
+void BlockFileStore::ApplyRemovals()
+{
+	for (const Hash& hash : m_uncommittedRemovals)
+	{
+		auto iter = m_locations.find(hash);
+		if (iter == m_locations.end())
+		{
+			continue;
+		}
+
+		const uint32_t segment = iter->second.segment;
+		m_locations.erase(iter);
+
+		// The last segment is still being appended to, so it's kept even when empty.
+		if (--m_numBlocksBySegment[segment] == 0 && segment + 1 < m_segments.size())
+		{
+			LOG_DEBUG_F("Deleting block segment {}", segment);
+			m_segments[segment].reset();
+			FileUtil::RemoveFile(GetSegmentPath(segment));
+		}
+	}
+
+	m_uncommittedRemovals.clear();
+}
+
+void BlockFileStore::Rollback() noexcept
+{
+	// Only matters when a Commit failed part way through.
+	for (auto& pSegment : m_segments)
+	{
+		if (pSegment != nullptr)
+		{
+			pSegment->Discard();
+		}
+	}
+
+	m_uncommitted.clear();
+	m_uncommittedOrder.clear();
+	m_uncommittedRemovals.clear();
+	m_cleared = false;
+}
+
+void BlockFileStore::AddBlock(const FullBlock& block)
+{
+	const Hash& hash = block.GetHash();
+	m_uncommittedRemovals.erase(hash);
+	if (m_uncommitted.find(hash) != m_uncommitted.end() || (!m_cleared && m_locations.find(hash) != m_locations.end()))
+	{
+		return;
+	}
+
+	Serializer serializer;
+	block.Serialize(serializer);
+	m_uncommitted.insert({ hash, serializer.GetBytes() });
+	m_uncommittedOrder.push_back(hash);
+}
+
+std::unique_ptr<FullBlock> BlockFileStore::GetBlock(const Hash& hash) const
+{
+	auto uncommittedIter = m_uncommitted.find(hash);
+	if (uncommittedIter != m_uncommitted.end())
+	{
+		ByteBuffer byteBuffer(uncommittedIter->second.data(), uncommittedIter->second.size());
+		return std::make_unique<FullBlock>(FullBlock::DeserializeWithArena(byteBuffer));
+	}
+
+	if (m_cleared || m_uncommittedRemovals.find(hash) != m_uncommittedRemovals.end())
+	{
+		return nullptr;
+	}
+
+	auto iter = m_locations.find(hash);
+	if (iter == m_locations.end())
+	{
+		return nullptr;
+	}
+
+	const Location& location = iter->second;
+	std::unique_ptr<FullBlock> pBlock = nullptr;
+	const bool found = m_segments[location.segment]->Visit(location.offset, location.size, [&pBlock, &location](const unsigned char* pData) {
+		ByteBuffer byteBuffer(pData, location.size);
+		pBlock = std::make_unique<FullBlock>(FullBlock::DeserializeWithArena(byteBuffer));
+	});
+	if (!found)
+	{
+		LOG_ERROR_F("Block {} not found in segment {}", hash, location.segment);
+		return nullptr;
+	}
+
+	return pBlock;
+}
+
+bool BlockFileStore::HasBlock(const Hash& hash) const
+{
+	if (m_uncommitted.find(hash) != m_uncommitted.end())
+	{
+		return true;
+	}
+
+	if (m_cleared || m_uncommittedRemovals.find(hash) != m_uncommittedRemovals.end())
+	{
+		return false;
+	}
+
+	return m_locations.find(hash) != m_locations.end();
+}
+
+void BlockFileStore::ClearBlocks()
+{
+	LOG_WARNING("Deleting all blocks.");
+
+	m_uncommitted.clear();
+	m_uncommittedOrder.clear();
+	m_uncommittedRemovals.clear();
+	m_cleared = true;
+}
+
+void BlockFileStore::RemoveBlocks(const std::vector<Hash>& hashes)
+{
+	for (const Hash& hash : hashes)
+	{
+		if (m_uncommitted.erase(hash) > 0)
+		{
+			m_uncommittedOrder.erase(std::remove(m_uncommittedOrder.begin(), m_uncommittedOrder.end(), hash), m_uncommittedOrder.end());
+		}
+
+		m_uncommittedRemovals.insert(hash);
+	}
+}
+
+void BlockFileStore::RemoveFiles()
+{
+	const size_t numSegments = m_segments.size();
+	m_segments.clear();
+	m_numBlocksBySegment.clear();
+	m_pIndexFile.reset();
+	m_locations.clear();
+
+	for (uint32_t segment = 0; segment < numSegments; segment++)
+	{
+		FileUtil::RemoveFile(GetSegmentPath(segment));
+	}
+
+	FileUtil::RemoveFile(m_directory / "index.dat");
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Core/File/AppendOnlyFile.h>
+#include <Core/File/DataFile.h>
+#include <Core/Models/FullBlock.h>
+#include <Core/Traits/Batchable.h>
+#include <Crypto/Hash.h>
+#include <filesystem.h>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+//
+// Stores full blocks in append-only segment files (blk00000.dat, blk00001.dat, ...), as an alternative to the BLOCK table.
+// Blocks are written once and never modified, so unlike in rocksdb they're never rewritten by compaction.
+//
+// Each block's location is recorded in index.dat as a fixed-size entry, which is loaded into memory on startup.
+// Reads deserialize straight from the mapped segment file.
+//
+// Blocks added during a batch are kept in memory until Commit, which flushes the segments before the index,
+// so the index never refers to data that isn't on disk.
+//
+class BlockFileStore : public Traits::IBatchable
+{
+public:
+	using Ptr = std::shared_ptr<BlockFileStore>;
+
+	static BlockFileStore::Ptr Open(const fs::path& directory, const size_t maxSegmentSize);
+
+	BlockFileStore(const fs::path& directory, const size_t maxSegmentSize)
+		: m_directory(directory), m_maxSegmentSize(maxSegmentSize), m_cleared(false) { }
+
+	void Commit() final;
+	void Rollback() noexcept final;
+
+	void AddBlock(const FullBlock& block);
+	std::unique_ptr<FullBlock> GetBlock(const Hash& hash) const;
+	bool HasBlock(const Hash& hash) const;
+	void ClearBlocks();
+
+	//
+	// Removes the blocks from the index. Segments are append-only, so the space is only reclaimed
+	// once every block in a segment has been removed, at which point the segment file is deleted.
+	//
+	void RemoveBlocks(const std::vector<Hash>& hashes);
+
+	size_t GetNumBlocks() const noexcept { return m_locations.size(); }
+
+private:
+	struct Location
+	{
+		uint32_t segment;
+		uint64_t offset;
+		uint32_t size;
+	};
+
+	// Hash (32) + segment (4) + offset (8) + size (4)
+	static constexpr size_t INDEX_ENTRY_SIZE = 48;
+
+	// Segment of an index entry recording that the block was removed.
+	static constexpr uint32_t REMOVED_SEGMENT = UINT32_MAX;
+
+	void Load();
+	void LoadSegment(const uint32_t segment);
+	fs::path GetSegmentPath(const uint32_t segment) const;
+	void AddIndexEntry(const Hash& hash, const Location& location);
+	void ApplyRemovals();
+	void RemoveFiles();
+
+	fs::path m_directory;
+	size_t m_maxSegmentSize;
+
+	// Segments whose blocks were all removed are nullptr.
+	std::vector<std::shared_ptr<AppendOnlyFile>> m_segments;
+	std::vector<size_t> m_numBlocksBySegment;
+	std::shared_ptr<DataFile<INDEX_ENTRY_SIZE>> m_pIndexFile;
+	std::unordered_map<Hash, Location> m_locations;
+
+	// Changes made by the current batch.
+	std::unordered_map<Hash, std::vector<unsigned char>> m_uncommitted;
+	std::vector<Hash> m_uncommittedOrder;
+	std::unordered_set<Hash> m_uncommittedRemovals;
+	bool m_cleared;
+};
@@ -1,6 +1,8 @@
 #include "DatabaseImpl.h"
 
 #include <Database/DatabaseException.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
 
 Database::Database(const Config& config, std::shared_ptr<Locked<IBlockDB>> pBlockDB, std::shared_ptr<Locked<IPeerDB>> pPeerDB)
 	: m_config(config), m_pBlockDB(pBlockDB), m_pPeerDB(pPeerDB)
@@ -10,8 +12,34 @@ Database::Database(const Config& config, std::shared_ptr<Locked<IBlockDB>> pBloc
 
 std::shared_ptr<IDatabase> Database::Open(const Config& config)
 {
-	std::shared_ptr<BlockDB> pBlockDB = BlockDB::OpenDB(config);
-	std::shared_ptr<PeerDB> pPeerDB(PeerDB::OpenDB(config));
+	const auto start = std::chrono::steady_clock::now();
+
+	// The block and peer databases are separate RocksDB instances, so they're opened at the same time.
+	ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+	std::future<std::shared_ptr<BlockDB>> blockDBOpened = threadPool.Submit([&config] { return BlockDB::OpenDB(config); });
+	std::shared_ptr<PeerDB> pPeerDB = nullptr;
+	std::exception_ptr pException = nullptr;
+	try
+	{
+		pPeerDB = PeerDB::OpenDB(config);
+	}
+	catch (...)
+	{
+		pException = std::current_exception();
+	}
+
+	threadPool.Wait(blockDBOpened);
+	if (pException != nullptr)
+	{
+		std::rethrow_exception(pException);
+	}
+
+	std::shared_ptr<BlockDB> pBlockDB = blockDBOpened.get();
+
+	LOG_INFO_F(
+		"Opened block and peer databases in {}ms",
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+	);
 
 	return std::shared_ptr<IDatabase>(new Database(config, std::make_shared<Locked<IBlockDB>>(pBlockDB), std::make_shared<Locked<IPeerDB>>(pPeerDB)));
 }
@@ -55,8 +55,7 @@ std::vector<PeerPtr> PeerDB::LoadAllPeers() const
 	std::unique_ptr<rocksdb::Iterator> it(m_pDatabase->NewIterator(rocksdb::ReadOptions()));
 	for (it->SeekToFirst(); it->Valid(); it->Next())
 	{
-		std::vector<unsigned char> data(it->value().data(), it->value().data() + it->value().size());
-		ByteBuffer byteBuffer(std::move(data));
+		ByteBuffer byteBuffer((const unsigned char*)it->value().data(), it->value().size());
 		peers.emplace_back(Peer::Deserialize(byteBuffer));
 	}
 
@@ -79,12 +78,11 @@ std::optional<PeerPtr> PeerDB::GetPeer(const IPAddress& address, const std::opti
 
 	Slice key((const char*)addressSerializer.data(), addressSerializer.size());
 
-	std::string value;
-	const Status status = m_pDatabase->Get(ReadOptions(), key, &value);
+	PinnableSlice value;
+	const Status status = m_pDatabase->Get(ReadOptions(), m_pDatabase->DefaultColumnFamily(), key, &value);
 	if (status.ok())
 	{
-		std::vector<unsigned char> data(value.data(), value.data() + value.size());
-		ByteBuffer byteBuffer(std::move(data));
+		ByteBuffer byteBuffer((const unsigned char*)value.data(), value.size());
 
 		return std::make_optional(Peer::Deserialize(byteBuffer));
 	}
@@ -4,16 +4,19 @@
 #include "DBEntry.h"
 #include <Core/Traits/Batchable.h>
 #include <Database/DatabaseException.h>
+#include <Database/DBStats.h>
 #include <Common/Logger.h>
 #include <Core/Serialization/ByteBuffer.h>
 
 #include <rocksdb/db.h>
 #include <rocksdb/slice.h>
 #include <rocksdb/options.h>
+#include <rocksdb/statistics.h>
 #include <rocksdb/utilities/optimistic_transaction_db.h>
 #include <rocksdb/utilities/transaction.h>
 #include <filesystem.h>
 #include <cassert>
+#include <functional>
 #include <memory>
 #include <vector>
 
@@ -23,6 +26,12 @@ public:
 	RocksDB(const std::shared_ptr<rocksdb::OptimisticTransactionDB>& pTransactionDB, const std::vector<RocksDBTable>& tables)
 		: m_pTransactionDB(pTransactionDB), m_tables(tables) { }
 
+	//
+	// A read-only secondary instance, following another process' (the primary's) database. See RocksDBFactory::OpenSecondary.
+	//
+	RocksDB(const std::shared_ptr<rocksdb::DB>& pSecondaryDB, const std::vector<RocksDBTable>& tables)
+		: m_pSecondaryDB(pSecondaryDB), m_tables(tables) { }
+
 	virtual ~RocksDB()
 	{
 		for (RocksDBTable& table : m_tables)
@@ -31,29 +40,54 @@ public:
 		}
 
 		m_pTransactionDB.reset();
+		m_pSecondaryDB.reset();
 	}
 
 	bool IsTransactional() const noexcept { return m_pTransaction != nullptr; }
+	bool IsSecondary() const noexcept { return m_pSecondaryDB != nullptr; }
+
+	//
+	// Replays the primary's new writes (from its MANIFEST and WAL), so they become visible to a secondary instance's reads.
+	//
+	void CatchUpWithPrimary()
+	{
+		assert(m_pSecondaryDB != nullptr);
+
+		const rocksdb::Status status = m_pSecondaryDB->TryCatchUpWithPrimary();
+		if (!status.ok())
+		{
+			LOG_ERROR_F("TryCatchUpWithPrimary failed with error {}", status.getState());
+			throw DATABASE_EXCEPTION_F("TryCatchUpWithPrimary failed with error {}", status.getState());
+		}
+	}
+
+	//
+	// The sequence number of the last committed write. It only changes when something is written.
+	//
+	uint64_t GetLatestSequenceNumber() const { return GetBaseDB()->GetLatestSequenceNumber(); }
 
 	template<typename T,
 		typename SFINAE = typename std::enable_if_t<std::is_base_of_v<Traits::ISerializable, T>>>
 	std::unique_ptr<T> Get(const RocksDBTable& table, const rocksdb::Slice& key) const
 	{
+		table.RecordReads(1);
+
+		// PinnableSlice lets rocksdb hand back the value in place (eg. from the block cache),
+		// so it's deserialized without being copied into a string and then a vector first.
 		rocksdb::Status status;
-		std::string itemStr;
+		rocksdb::PinnableSlice item;
 		if (m_pTransaction != nullptr)
 		{
-			status = m_pTransaction->Get(rocksdb::ReadOptions(), table.GetHandle(), key, &itemStr);
+			status = m_pTransaction->Get(rocksdb::ReadOptions(), table.GetHandle(), key, &item);
 		}
 		else
 		{
-			status = m_pTransactionDB->GetBaseDB()->Get(rocksdb::ReadOptions(), table.GetHandle(), key, &itemStr);
+			status = GetBaseDB()->Get(rocksdb::ReadOptions(), table.GetHandle(), key, &item);
 		}
 
 		if (status.ok())
 		{
-			std::vector<unsigned char> data(itemStr.data(), itemStr.data() + itemStr.size());
-			ByteBuffer byteBuffer(std::move(data));
+			ByteBuffer byteBuffer((const unsigned char*)item.data(), item.size());
 			return std::make_unique<T>(T::Deserialize(byteBuffer));
 		}
 		else if (status.IsNotFound())
@@ -81,10 +115,89 @@ public:
 		return Get<T>(GetTable(tableName), key);
 	}
 
+	//
+	// Looks up all of the keys in a single MultiGet, which batches the reads instead of doing them one at a time.
+	// Returns an entry for each key, in the same order, which is nullptr when the key was not found.
+	//
+	template<typename T,
+		typename SFINAE = typename std::enable_if_t<std::is_base_of_v<Traits::ISerializable, T>>>
+	std::vector<std::unique_ptr<T>> MultiGet(const std::string& tableName, const std::vector<rocksdb::Slice>& keys) const
+	{
+		const RocksDBTable& table = GetTable(tableName);
+		table.RecordReads(keys.size());
+
+		// Like Get, the values are pinned and deserialized in place.
+		std::vector<rocksdb::PinnableSlice> items(keys.size());
+		std::vector<rocksdb::Status> statuses(keys.size());
+		if (m_pTransaction != nullptr)
+		{
+			m_pTransaction->MultiGet(rocksdb::ReadOptions(), table.GetHandle(), keys.size(), keys.data(), items.data(), statuses.data());
+		}
+		else
+		{
+			GetBaseDB()->MultiGet(rocksdb::ReadOptions(), table.GetHandle(), keys.size(), keys.data(), items.data(), statuses.data());
+		}
+
+		std::vector<std::unique_ptr<T>> results;
+		results.reserve(keys.size());
+		for (size_t i = 0; i < keys.size(); i++)
+		{
+			if (statuses[i].ok())
+			{
+				ByteBuffer byteBuffer((const unsigned char*)items[i].data(), items[i].size());
+				results.push_back(std::make_unique<T>(T::Deserialize(byteBuffer)));
+			}
+			else if (statuses[i].IsNotFound())
+			{
+				results.push_back(nullptr);
+			}
+			else
+			{
+				const std::string errorMessage = StringUtil::Format(
+					"Error while attempting to retrieve {} from table {}. Error: {}",
+					keys[i].ToString(true),
+					table,
+					statuses[i].getState()
+				);
+				LOG_ERROR(errorMessage);
+				throw DATABASE_EXCEPTION(errorMessage);
+			}
+		}
+
+		return results;
+	}
+
+	//
+	// Calls the callback with every committed row of the table, in key order.
+	// Reads sequentially with a single iterator, so it's much faster than a point lookup per key.
+	//
+	template<typename T,
+		typename SFINAE = typename std::enable_if_t<std::is_base_of_v<Traits::ISerializable, T>>>
+	void ForEach(const std::string& tableName, const std::function<void(const rocksdb::Slice&, T&&)>& callback) const
+	{
+		const RocksDBTable& table = GetTable(tableName);
+
+		std::unique_ptr<rocksdb::Iterator> it(GetBaseDB()->NewIterator(rocksdb::ReadOptions(), table.GetHandle()));
+		for (it->SeekToFirst(); it->Valid(); it->Next())
+		{
+			ByteBuffer byteBuffer((const unsigned char*)it->value().data(), it->value().size());
+			callback(it->key(), T::Deserialize(byteBuffer));
+		}
+
+		if (!it->status().ok())
+		{
+			LOG_ERROR_F("Error while iterating table {}. Error: {}", table, it->status().getState());
+			throw DATABASE_EXCEPTION_F("Error while iterating table {}", table);
+		}
+	}
+
 	template<typename T,
 		typename SFINAE = typename std::enable_if_t<std::is_base_of_v<Traits::ISerializable, T>>>
 	void Put(const RocksDBTable& table, const DBEntry<T>& entry)
 	{
+		AssertWritable();
+		table.RecordWrites(1);
+
 		rocksdb::Status status;
 		std::vector<unsigned char> serialized = entry.SerializeValue();
 		rocksdb::Slice value((const char*)serialized.data(), serialized.size());
@@ -126,6 +239,8 @@ public:
     void Put(const RocksDBTable& table, const std::vector<DBEntry<T>>& entries)
 	{
 		assert(!entries.empty());
+		AssertWritable();
+		table.RecordWrites(entries.size());
 
 		std::shared_ptr<rocksdb::Transaction> pTempTransaction = nullptr;
 		if (m_pTransaction == nullptr)
@@ -172,6 +287,8 @@ public:
 	void Delete(const RocksDBTable& table, const rocksdb::Slice& key)
 	{
 		LOG_TRACE_F("Deleting {} from table {}", key.ToString(true), table);
+		AssertWritable();
+		table.RecordWrites(1);
 
 		rocksdb::Status status;
 		if (m_pTransaction != nullptr)
@@ -180,7 +297,7 @@ public:
 		}
 		else
 		{
-			status = m_pTransactionDB->GetBaseDB()->Delete(rocksdb::WriteOptions(), table.GetHandle(), key);
+			status = GetBaseDB()->Delete(rocksdb::WriteOptions(), table.GetHandle(), key);
 		}
 
 		if (!status.ok())
@@ -214,6 +331,7 @@ public:
 	void DeleteAll(const RocksDBTable& table)
 	{
 		LOG_WARNING_F("Deleting all rows from table {}", table);
+		AssertWritable();
 
 		rocksdb::Status status;
 		if (m_pTransaction != nullptr)
@@ -261,8 +379,58 @@ public:
 		DeleteAll(GetTable(tableName));
 	}
 
+	DBStats GetStats() const
+	{
+		DBStats stats{};
+
+		auto getProperty = [this](const RocksDBTable& table, const std::string& property) -> uint64_t {
+			uint64_t value = 0;
+			GetBaseDB()->GetIntProperty(table.GetHandle(), property, &value);
+			return value;
+		};
+
+		// The default table is unused.
+		for (size_t i = 1; i < m_tables.size(); i++)
+		{
+			const RocksDBTable& table = m_tables[i];
+
+			DBTableStats tableStats{};
+			tableStats.name = table.GetName();
+			tableStats.numReads = table.GetNumReads();
+			tableStats.numWrites = table.GetNumWrites();
+			tableStats.estimatedKeys = getProperty(table, "rocksdb.estimate-num-keys");
+			tableStats.sstBytes = getProperty(table, "rocksdb.total-sst-files-size");
+			tableStats.memtableBytes = getProperty(table, "rocksdb.cur-size-all-mem-tables");
+			stats.tables.push_back(tableStats);
+
+			stats.pendingCompactionBytes += getProperty(table, "rocksdb.estimate-pending-compaction-bytes");
+		}
+
+		// The block cache is shared, so its usage is the same through every table.
+		if (m_tables.size() > 1)
+		{
+			stats.blockCacheUsage = getProperty(m_tables[1], "rocksdb.block-cache-usage");
+		}
+
+		std::shared_ptr<rocksdb::Statistics> pStatistics = GetBaseDB()->GetDBOptions().statistics;
+		if (pStatistics != nullptr)
+		{
+			stats.blockCacheHits = pStatistics->getTickerCount(rocksdb::BLOCK_CACHE_HIT);
+			stats.blockCacheMisses = pStatistics->getTickerCount(rocksdb::BLOCK_CACHE_MISS);
+			stats.stallMicros = pStatistics->getTickerCount(rocksdb::STALL_MICROS);
+		}
+
+		return stats;
+	}
+
+	// Secondary instances never begin transactions, so there's nothing to commit or roll back.
 	void Commit() final
 	{
+		if (IsSecondary())
+		{
+			return;
+		}
+
 		assert(m_pTransaction != nullptr);
 
 		const rocksdb::Status status = m_pTransaction->Commit();
@@ -275,6 +443,11 @@ public:
 
 	void Rollback() noexcept final
 	{
+		if (IsSecondary())
+		{
+			return;
+		}
+
 		assert(m_pTransaction != nullptr);
 
 		const rocksdb::Status status = m_pTransaction->Rollback();
@@ -286,6 +459,11 @@ public:
 
 	void OnInitWrite() final
 	{
+		if (IsSecondary())
+		{
+			return;
+		}
+
 		m_pTransaction = std::shared_ptr<rocksdb::Transaction>(
 			m_pTransactionDB->BeginTransaction(rocksdb::WriteOptions())
 		);
@@ -297,6 +475,19 @@ public:
 	}
 
 private:
+	rocksdb::DB* GetBaseDB() const noexcept
+	{
+		return m_pSecondaryDB != nullptr ? m_pSecondaryDB.get() : m_pTransactionDB->GetBaseDB();
+	}
+
+	void AssertWritable() const
+	{
+		if (IsSecondary())
+		{
+			throw DATABASE_EXCEPTION("Attempted to write to a secondary (read-only) database.");
+		}
+	}
+
 	const RocksDBTable& GetTable(const std::string& name) const
 	{
 		for (const RocksDBTable& table : m_tables)
@@ -312,6 +503,7 @@ private:
 	}
 
 	std::shared_ptr<rocksdb::OptimisticTransactionDB> m_pTransactionDB;
+	std::shared_ptr<rocksdb::DB> m_pSecondaryDB;
 	std::vector<RocksDBTable> m_tables;
 
 	std::shared_ptr<rocksdb::Transaction> m_pTransaction;
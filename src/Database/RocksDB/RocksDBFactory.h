@@ -7,6 +7,10 @@
 #include <Common/Logger.h>
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
+#include <rocksdb/cache.h>
+#include <rocksdb/statistics.h>
+#include <rocksdb/filter_policy.h>
+#include <rocksdb/table.h>
 #include <filesystem.h>
 
 class RocksDBFactory
@@ -23,6 +27,7 @@ public:
 		options.IncreaseParallelism();
 		options.create_if_missing = true;
 		options.compression = rocksdb::kNoCompression;
+		options.statistics = rocksdb::CreateDBStatistics();
 
 		std::vector<rocksdb::ColumnFamilyDescriptor> columnDescriptors = CreateDescriptors(options, dbPath, tableNames);
 
@@ -39,6 +44,87 @@ public:
 		return std::make_shared<RocksDB>(std::shared_ptr<rocksdb::OptimisticTransactionDB>(pTransactionDB), tables);
     }
 
+	//
+	// Opens another process' database as a read-only secondary instance, which only sees the primary's writes up to
+	// the last RocksDB::CatchUpWithPrimary. The secondary's own info log and MANIFEST copy go in secondaryPath.
+	// Every table must already exist, since a secondary can't create them.
+	//
+	static std::shared_ptr<RocksDB> OpenSecondary(
+		const fs::path& primaryPath,
+		const fs::path& secondaryPath,
+		const std::vector<rocksdb::ColumnFamilyDescriptor>& tableNames)
+	{
+		fs::create_directories(secondaryPath);
+
+		rocksdb::Options options;
+		options.IncreaseParallelism();
+		options.compression = rocksdb::kNoCompression;
+		options.statistics = rocksdb::CreateDBStatistics();
+
+		// Required by secondary instances, which must be able to open any table file the primary's MANIFEST refers to.
+		options.max_open_files = -1;
+
+		std::vector<std::string> columnFamilies;
+		rocksdb::Status status = rocksdb::DB::ListColumnFamilies(options, primaryPath.u8string(), &columnFamilies);
+		if (!status.ok())
+		{
+			throw DATABASE_EXCEPTION_F("No database found at {}: {}", primaryPath, status.getState());
+		}
+
+		if (columnFamilies.size() != tableNames.size())
+		{
+			LOG_ERROR_F("Expected {} tables in {}, but found {}", tableNames.size(), primaryPath, columnFamilies.size());
+			throw DATABASE_EXCEPTION("Secondary db tables don't match the primary's.");
+		}
+
+		rocksdb::DB* pDB = nullptr;
+		std::vector<rocksdb::ColumnFamilyHandle*> columnHandles;
+		status = rocksdb::DB::OpenAsSecondary(options, primaryPath.u8string(), secondaryPath.u8string(), tableNames, &columnHandles, &pDB);
+		if (!status.ok())
+		{
+			throw DATABASE_EXCEPTION_F("DB::OpenAsSecondary failed with error {}", status.getState());
+		}
+
+		std::vector<RocksDBTable> tables;
+		for (size_t i = 0; i < tableNames.size(); i++)
+		{
+			tables.push_back(RocksDBTable(tableNames[i].name, std::shared_ptr<rocksdb::ColumnFamilyHandle>(columnHandles[i])));
+		}
+
+		return std::make_shared<RocksDB>(std::shared_ptr<rocksdb::DB>(pDB), tables);
+	}
+
+	//
+	// Builds the options for a table that uses the given (shared) block cache.
+	// bloomFilterBits - Bloom filter bits per key, or 0 for no bloom filter.
+	//
+	static rocksdb::ColumnFamilyOptions CreateTableOptions(
+		const std::shared_ptr<rocksdb::Cache>& pBlockCache,
+		const uint32_t bloomFilterBits,
+		const rocksdb::CompressionType compression,
+		const size_t writeBufferSize)
+	{
+		rocksdb::BlockBasedTableOptions tableOptions;
+		tableOptions.block_cache = pBlockCache;
+		tableOptions.data_block_index_type = rocksdb::BlockBasedTableOptions::kDataBlockBinaryAndHash;
+		if (bloomFilterBits > 0)
+		{
+			tableOptions.filter_policy.reset(rocksdb::NewBloomFilterPolicy((int)bloomFilterBits, false));
+		}
+
+		rocksdb::ColumnFamilyOptions options;
+		options.table_factory.reset(rocksdb::NewBlockBasedTableFactory(tableOptions));
+		options.compression = compression;
+		options.write_buffer_size = writeBufferSize;
+		if (bloomFilterBits > 0)
+		{
+			options.memtable_prefix_bloom_size_ratio = 0.02;
+			options.memtable_whole_key_filtering = true;
+		}
+
+		return options;
+	}
+
 private:
 	static std::vector<rocksdb::ColumnFamilyDescriptor> CreateDescriptors(
 		const rocksdb::Options& options,
@@ -93,8 +179,6 @@ private:
 			}
 			else
 			{
-				rocksdb::ColumnFamilyOptions columnFamilyOptions;
-				columnFamilyOptions.OptimizeForPointLookup(1024); // TODO: Pass in options
 				rocksdb::ColumnFamilyHandle* pHandle;
 
 				rocksdb::Status status = pTxDB->GetBaseDB()->CreateColumnFamily(tableNames[i].options, tableNames[i].name, &pHandle);
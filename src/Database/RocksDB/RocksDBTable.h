@@ -3,15 +3,17 @@
 #include <Core/Traits/Printable.h>
 #include <rocksdb/db.h>
 #include <rocksdb/options.h>
+#include <atomic>
+#include <memory>
 
 class RocksDBTable : public Traits::IPrintable
 {
 public:
     RocksDBTable() = default;
     RocksDBTable(const std::string & name, rocksdb::ColumnFamilyHandle* pFamilyHandle)
-        : m_name(name), m_pFamilyHandle(std::shared_ptr<rocksdb::ColumnFamilyHandle>(pFamilyHandle)) { }
+        : m_name(name), m_pFamilyHandle(std::shared_ptr<rocksdb::ColumnFamilyHandle>(pFamilyHandle)), m_pCounters(std::make_shared<Counters>()) { }
     RocksDBTable(const std::string& name, const std::shared_ptr<rocksdb::ColumnFamilyHandle>& pFamilyHandle)
-        : m_name(name), m_pFamilyHandle(pFamilyHandle) { }
+        : m_name(name), m_pFamilyHandle(pFamilyHandle), m_pCounters(std::make_shared<Counters>()) { }
     virtual ~RocksDBTable() = default;
 
     const std::string& GetName() const noexcept { return m_name; }
@@ -19,9 +21,24 @@ public:
 
     void CloseHandle() { m_pFamilyHandle.reset(); }
 
+    //
+    // Counts keys read and written, since startup. Shared by copies of the table.
+    //
+    void RecordReads(const uint64_t numKeys) const noexcept { m_pCounters->numReads.fetch_add(numKeys, std::memory_order_relaxed); }
+    void RecordWrites(const uint64_t numKeys) const noexcept { m_pCounters->numWrites.fetch_add(numKeys, std::memory_order_relaxed); }
+    uint64_t GetNumReads() const noexcept { return m_pCounters->numReads.load(std::memory_order_relaxed); }
+    uint64_t GetNumWrites() const noexcept { return m_pCounters->numWrites.load(std::memory_order_relaxed); }
+
     std::string Format() const final { return m_name; }
 
 private:
     std::string m_name;
     std::shared_ptr<rocksdb::ColumnFamilyHandle> m_pFamilyHandle;
+
+    struct Counters
+    {
+        std::atomic<uint64_t> numReads{ 0 };
+        std::atomic<uint64_t> numWrites{ 0 };
+    };
+    std::shared_ptr<Counters> m_pCounters;
 };
\ No newline at end of file
@@ -3,22 +3,59 @@
 #include <Net/Clients/HTTP/HTTPException.h>
 #include <Common/Util/StringUtil.h>
 #include <Common/Compat.h>
+#include <Common/ThreadManager.h>
 
 #include <civetweb.h>
+#include <cstring>
+#include <type_traits>
 
-std::shared_ptr<Server> Server::Create(const EServerType type, const std::optional<uint16_t>& port)
+//
+// Names civetweb's threads, so they're included in the thread stats and can be pinned with CPU_AFFINITY.
+// Thread type 1 is a worker handling requests, 0 the thread accepting connections, and 2 an internal helper.
+//
+template<typename R>
+static R OnInitThread(const mg_context*, int threadType)
+{
+	ThreadManagerAPI::SetCurrentThreadName(threadType == 1 ? "HTTP" : "HTTP_MASTER");
+	if constexpr (!std::is_void_v<R>)
+	{
+		return nullptr;
+	}
+}
+
+// init_thread returns void in older civetweb versions and void* in newer ones, so the callback's return type is deduced.
+template<typename R>
+static void SetInitThread(R(*&callback)(const mg_context*, int))
+{
+	callback = &OnInitThread<R>;
+}
+
+std::shared_ptr<Server> Server::Create(const EServerType type, const std::optional<uint16_t>& port, const HttpServerConfig& config)
 {
 	std::string listenerAddr = type == EServerType::LOCAL ? "127.0.0.1" : "0.0.0.0";
 	std::string listeningPort = StringUtil::Format("{}:{}", listenerAddr, port.value_or(0));
+	const std::string numThreads = std::to_string(config.GetNumThreads());
+	const std::string listenBacklog = std::to_string(config.GetListenBacklog());
+	const std::string keepAliveMs = std::to_string(config.GetKeepAliveMs());
 
 	const char* pOptions[] = {
-		"num_threads", "15",
+		"num_threads", numThreads.c_str(),
 		"listening_ports", listeningPort.c_str(),
+		"listen_backlog", listenBacklog.c_str(),
+		"enable_keep_alive", config.IsKeepAliveEnabled() ? "yes" : "no",
+		"keep_alive_timeout_ms", keepAliveMs.c_str(),
 		NULL
 	};
 
+	// The config is handed to civetweb as the context's user data, so HTTPUtil can find it from any connection.
+	auto pConfig = std::make_unique<const HttpServerConfig>(config);
+
+	mg_callbacks callbacks;
+	memset(&callbacks, 0, sizeof(callbacks));
+	SetInitThread(callbacks.init_thread);
+
 	mg_init_library(0);
-	auto pCivetContext = mg_start(NULL, 0, pOptions);
+	auto pCivetContext = mg_start(&callbacks, (void*)pConfig.get(), pOptions);
 	if (pCivetContext == nullptr)
 	{
 		LOG_ERROR("Failed to start server.");
@@ -33,7 +70,7 @@ std::shared_ptr<Server> Server::Create(const EServerType type, const std::option
 		throw HTTP_EXCEPTION("mg_get_server_ports failed.");
 	}
 
-	return std::shared_ptr<Server>(new Server(pCivetContext, (uint16_t)ports.port));
+	return std::shared_ptr<Server>(new Server(pCivetContext, (uint16_t)ports.port, std::move(pConfig)));
 }
 
 Server::~Server()
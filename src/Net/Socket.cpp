@@ -3,6 +3,8 @@
 #include <Common/Util/ThreadUtil.h>
 #include <Common/Logger.h>
 #include <Common/ShutdownManager.h>
+#include <algorithm>
+#include <cstring>
 
 static unsigned long DEFAULT_TIMEOUT = 5 * 1000; // 5s
 
@@ -10,13 +12,18 @@ static unsigned long DEFAULT_TIMEOUT = 5 * 1000; // 5s
 #define SOCKET_ERROR -1
 #endif
 
+// Size of a P2P message header, the least that's worth waking up for.
+static const size_t MIN_RECEIVE_SIZE = 11;
+
 Socket::Socket(const SocketAddress& address)
 	: m_address(address),
 	m_socketOpen(false),
 	m_blocking(true),
 	m_receiveBufferSize(0),
 	m_receiveTimeout(DEFAULT_TIMEOUT),
-	m_sendTimeout(DEFAULT_TIMEOUT)
+	m_sendTimeout(DEFAULT_TIMEOUT),
+	m_readAheadBegin(0),
+	m_readAheadEnd(0)
 {
 
 }
@@ -27,12 +34,30 @@ Socket::~Socket()
 	m_pContext.reset();
 }
 
-bool Socket::Connect(std::shared_ptr<asio::io_context> pContext)
+bool Socket::Connect(std::shared_ptr<asio::io_context> pContext, const std::chrono::milliseconds& timeout, const std::string& localIP)
 {
 	m_pContext = pContext;
 	asio::ip::tcp::endpoint endpoint(asio::ip::address(asio::ip::address_v4::from_string(m_address.GetIPAddress().Format())), m_address.GetPortNumber());
 
 	m_pSocket = std::make_shared<asio::ip::tcp::socket>(*pContext);
+	if (!localIP.empty())
+	{
+		asio::error_code bindError;
+		m_pSocket->open(asio::ip::tcp::v4(), bindError);
+		if (!bindError)
+		{
+			m_pSocket->bind(asio::ip::tcp::endpoint(asio::ip::address_v4::from_string(localIP, bindError), 0), bindError);
+		}
+
+		if (bindError)
+		{
+			LOG_WARNING_F("Failed to bind to {}: {}", localIP, bindError.message());
+			m_errorCode = bindError;
+			m_pSocket->close(bindError);
+			return false;
+		}
+	}
+
 	m_pSocket->async_connect(endpoint, [this](const asio::error_code & ec)
 		{
 			m_errorCode = ec;
@@ -66,12 +91,14 @@ bool Socket::Connect(std::shared_ptr<asio::io_context> pContext)
 		}
 	);
 
-	pContext->run();
-
-	auto timeout = std::chrono::system_clock::now() + std::chrono::seconds(1);
-	while (!m_errorCode && !m_socketOpen && std::chrono::system_clock::now() < timeout)
+	// Unreachable addresses would otherwise block until the OS gives up on them, which can take minutes.
+	pContext->run_for(timeout);
+	if (!pContext->stopped())
 	{
-		ThreadUtil::SleepFor(std::chrono::milliseconds(10), false);
+		// Closing aborts the connect, and the aborted handler is run before returning, since it references this socket.
+		asio::error_code ignoreError;
+		m_pSocket->close(ignoreError);
+		pContext->run();
 	}
 
 	return m_socketOpen;
@@ -125,6 +152,45 @@ bool Socket::Accept(std::shared_ptr<asio::io_context> pContext, asio::ip::tcp::a
 	return m_socketOpen;
 }
 
+bool Socket::Attach(std::shared_ptr<asio::io_context> pContext)
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	asio::error_code error;
+	const asio::ip::tcp protocol = m_pSocket->local_endpoint(error).protocol();
+	if (error)
+	{
+		return false;
+	}
+
+	const auto nativeHandle = m_pSocket->release(error);
+	if (error)
+	{
+		return false;
+	}
+
+	auto pSocket = std::make_shared<asio::ip::tcp::socket>(*pContext);
+	pSocket->assign(protocol, nativeHandle, error);
+	if (error)
+	{
+		LOG_WARNING_F("Failed to attach socket for {}: {}", m_address, error.message());
+		m_socketOpen = false;
+		return false;
+	}
+
+	m_pSocket = pSocket;
+	m_pContext = pContext;
+	return true;
+}
+
+void Socket::Cancel()
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	asio::error_code ignoreError;
+	m_pSocket->cancel(ignoreError);
+}
+
 bool Socket::CloseSocket()
 {
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
@@ -283,6 +349,34 @@ bool Socket::Send(const std::vector<uint8_t>& message, const bool incrementCount
 	return bytesWritten == message.size();
 }
 
+bool Socket::Send(const std::vector<std::shared_ptr<const std::vector<uint8_t>>>& messages, const bool incrementCount)
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	std::vector<asio::const_buffer> buffers;
+	buffers.reserve(messages.size());
+
+	size_t totalSize = 0;
+	for (const auto& pMessage : messages)
+	{
+		if (incrementCount)
+		{
+			m_rateCounter.AddMessageSent();
+		}
+
+		buffers.emplace_back(asio::buffer(pMessage->data(), pMessage->size()));
+		totalSize += pMessage->size();
+	}
+
+	const size_t bytesWritten = asio::write(*m_pSocket, buffers, m_errorCode);
+	if (m_errorCode && m_errorCode.value() != EAGAIN && m_errorCode.value() != EWOULDBLOCK)
+	{
+		throw SocketException(m_errorCode);
+	}
+
+	return bytesWritten == totalSize;
+}
+
 bool Socket::Receive(const size_t numBytes, const bool incrementCount, const ERetrievalMode mode, std::vector<uint8_t>& data)
 {
 	bool hasReceivedData = HasReceivedData();
@@ -312,11 +406,32 @@ bool Socket::Receive(const size_t numBytes, const bool incrementCount, const ERe
 		data.resize(numBytes);
 	}
 
+	size_t bytesRead = TakeBuffered(data.data(), numBytes);
+	if (bytesRead == numBytes)
+	{
+		if (incrementCount)
+		{
+			m_rateCounter.AddMessageReceived();
+		}
+
+		return true;
+	}
+
 	size_t numTries = 0;
-	size_t bytesRead = 0;
 	while (numTries++ < 3)
 	{
-		bytesRead += asio::read(*m_pSocket, asio::buffer(data.data() + bytesRead, numBytes - bytesRead), m_errorCode);
+		const size_t remaining = numBytes - bytesRead;
+		if (remaining >= READ_AHEAD_SIZE)
+		{
+			bytesRead += asio::read(*m_pSocket, asio::buffer(data.data() + bytesRead, remaining), m_errorCode);
+		}
+		else
+		{
+			// The rest of this message is read along with whatever else has arrived, so the next messages are served from memory.
+			FillReadAhead(remaining);
+			bytesRead += TakeBuffered(data.data() + bytesRead, remaining);
+		}
+
 		if (m_errorCode && m_errorCode.value() != EAGAIN && m_errorCode.value() != EWOULDBLOCK)
 		{
 			throw SocketException(m_errorCode);
@@ -341,6 +456,76 @@ bool Socket::Receive(const size_t numBytes, const bool incrementCount, const ERe
 	return false;
 }
 
+size_t Socket::ReceiveAvailable(const size_t numBytes, uint8_t* pOut)
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	size_t bytesRead = TakeBuffered(pOut, numBytes);
+	if (bytesRead == numBytes)
+	{
+		return bytesRead;
+	}
+
+	const size_t available = m_pSocket->available(m_errorCode);
+	if (m_errorCode)
+	{
+		throw SocketException(m_errorCode);
+	}
+
+	if (available == 0)
+	{
+		return bytesRead;
+	}
+
+	// Only what has already arrived is read, so neither read can block.
+	const size_t remaining = numBytes - bytesRead;
+	if (remaining >= READ_AHEAD_SIZE)
+	{
+		bytesRead += asio::read(*m_pSocket, asio::buffer(pOut + bytesRead, (std::min)(remaining, available)), m_errorCode);
+	}
+	else
+	{
+		FillReadAhead((std::min)(remaining, available));
+		bytesRead += TakeBuffered(pOut + bytesRead, remaining);
+	}
+
+	if (m_errorCode)
+	{
+		throw SocketException(m_errorCode);
+	}
+
+	return bytesRead;
+}
+
+size_t Socket::TakeBuffered(uint8_t* pOut, const size_t numBytes)
+{
+	const size_t numTaken = (std::min)(numBytes, m_readAheadEnd - m_readAheadBegin);
+	if (numTaken > 0)
+	{
+		std::memcpy(pOut, m_readAhead.data() + m_readAheadBegin, numTaken);
+		m_readAheadBegin += numTaken;
+	}
+
+	return numTaken;
+}
+
+void Socket::FillReadAhead(const size_t minBytes)
+{
+	if (m_readAhead.empty())
+	{
+		m_readAhead.resize(READ_AHEAD_SIZE);
+	}
+
+	// Only called once everything buffered has been taken.
+	m_readAheadBegin = 0;
+	m_readAheadEnd = asio::read(
+		*m_pSocket,
+		asio::buffer(m_readAhead.data(), m_readAhead.size()),
+		asio::transfer_at_least(minBytes),
+		m_errorCode
+	);
+}
+
 bool Socket::HasReceivedData()
 {
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
@@ -351,5 +536,24 @@ bool Socket::HasReceivedData()
 		throw SocketException(m_errorCode);
 	}
 	
-	return available >= 11;
+	return (m_readAheadEnd - m_readAheadBegin) + available >= MIN_RECEIVE_SIZE;
+}
+
+bool Socket::HasBufferedData() const
+{
+	std::shared_lock<std::shared_mutex> readLock(m_mutex);
+	return m_readAheadEnd - m_readAheadBegin >= MIN_RECEIVE_SIZE;
+}
+
+size_t Socket::GetNumBytesAvailable()
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	const size_t available = m_pSocket->available(m_errorCode);
+	if (m_errorCode && m_errorCode.value() != EAGAIN && m_errorCode.value() != EWOULDBLOCK)
+	{
+		throw SocketException(m_errorCode);
+	}
+
+	return (m_readAheadEnd - m_readAheadBegin) + available;
 }
\ No newline at end of file
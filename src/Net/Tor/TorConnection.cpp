@@ -4,17 +4,21 @@
 #include <Net/Clients/RPC/RPCClient.h>
 
 TorConnection::TorConnection(const TorAddress& address, SocketAddress&& proxyAddress)
-	: m_address(address)
+	: m_address(address), m_lastUsed(std::chrono::steady_clock::now())
 {
-	auto pSocksClient = std::shared_ptr<HTTPClient>((HTTPClient*)new SOCKSClient(std::move(proxyAddress)));
-	m_pRpcClient = std::make_shared<HttpRpcClient>(pSocksClient);
+	m_pHttpClient = std::shared_ptr<IHTTPClient>((IHTTPClient*)new SOCKSClient(std::move(proxyAddress)));
+	m_pRpcClient = std::make_shared<HttpRpcClient>(m_pHttpClient);
 }
 
 RPC::Response TorConnection::Invoke(const RPC::Request& request, const std::string& location)
 {
+	std::unique_lock<std::mutex> lock(m_mutex);
+
 	try
 	{
-		return m_pRpcClient->Invoke(m_address.ToString(), location, 80, request);
+		RPC::Response response = m_pRpcClient->Invoke(m_address.ToString(), location, 80, request);
+		m_lastUsed = std::chrono::steady_clock::now();
+		return response;
 	}
 	catch (TorException&)
 	{
@@ -24,4 +28,31 @@ RPC::Response TorConnection::Invoke(const RPC::Request& request, const std::stri
 	{
 		throw TOR_EXCEPTION(e.what());
 	}
-}
\ No newline at end of file
+}
+
+void TorConnection::Open()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	try
+	{
+		m_pHttpClient->Open(m_address.ToString(), 80);
+		m_lastUsed = std::chrono::steady_clock::now();
+	}
+	catch (std::exception& e)
+	{
+		throw TOR_EXCEPTION(e.what());
+	}
+}
+
+bool TorConnection::IsIdle(const std::chrono::steady_clock::duration& timeout) const
+{
+	// A connection in use holds the mutex, and isn't idle.
+	std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+	if (!lock.owns_lock())
+	{
+		return false;
+	}
+
+	return !m_pHttpClient->IsConnected() || (std::chrono::steady_clock::now() - m_lastUsed) > timeout;
+}
@@ -3,9 +3,10 @@
 
 #include <Net/Tor/TorException.h>
 #include <Common/Util/StringUtil.h>
-#include <cppcodec/base64_rfc4648.hpp>
-#include <Crypto/ED25519.h>
+#include <Common/Util/ThreadUtil.h>
+#include <Common/ShutdownManager.h>
 #include <filesystem.h>
+#include <algorithm>
 
 TorControl::TorControl(const TorConfig& config, std::shared_ptr<TorControlClient> pClient, ChildProcess::UCPtr&& pProcess)
 	: m_torConfig(config), m_pClient(pClient), m_pProcess(std::move(pProcess))
@@ -19,16 +20,15 @@ std::shared_ptr<TorControl> TorControl::Create(const TorConfig& torConfig) noexc
 	{
 		const fs::path command = fs::current_path() / "tor" / "tor";
 
+		// The data directory is kept between runs, so tor can bootstrap from its cached consensus and descriptors.
 #ifdef __linux__
 		std::error_code ec;
 		fs::path torDataPath = torConfig.GetTorDataPath() / ("data" + std::to_string(torConfig.GetControlPort()));
-		fs::remove_all(torDataPath, ec);
 		fs::create_directories(torDataPath, ec);
 		std::string torrcPath = (torConfig.GetTorDataPath() / ".torrc").u8string();
 #else
 		std::error_code ec;
 		fs::path torDataPath = "./tor/data" + std::to_string(torConfig.GetControlPort());
-		fs::remove_all(torDataPath, ec);
 		fs::create_directories(torDataPath, ec);
 		fs::remove("./tor/.torrc", ec);
 		fs::copy_file(torConfig.GetTorDataPath() / ".torrc", "./tor/.torrc", ec);
@@ -45,7 +45,6 @@ std::shared_ptr<TorControl> TorControl::Create(const TorConfig& torConfig) noexc
 			"--ignore-missing-torrc"
 		});
 
-		// TODO: Determine if process is already running.
 		ChildProcess::UCPtr pProcess = ChildProcess::Create(args);
 		if (pProcess == nullptr) {
 			// Fallback to tor on path
@@ -55,14 +54,23 @@ std::shared_ptr<TorControl> TorControl::Create(const TorConfig& torConfig) noexc
 
 		std::shared_ptr<TorControlClient> pClient = std::shared_ptr<TorControlClient>(new TorControlClient());
 
+		// The control port usually opens within a few hundred milliseconds, so it's checked often.
 		bool connected = false;
 		auto timeout = std::chrono::system_clock::now() + std::chrono::seconds(10);
 		while (!connected && std::chrono::system_clock::now() < timeout)
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds(500));
-
 			// Open control socket
 			connected = pClient->Connect(SocketAddress("127.0.0.1", torConfig.GetControlPort()));
+			if (!connected)
+			{
+				if (pProcess != nullptr && !pProcess->IsRunning())
+				{
+					LOG_ERROR_F("Tor exited with status {}", pProcess->GetExitStatus());
+					break;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			}
 		}
 
 		if (connected && Authenticate(pClient, torConfig.GetControlPassword())) {
@@ -77,6 +85,24 @@ std::shared_ptr<TorControl> TorControl::Create(const TorConfig& torConfig) noexc
 	return nullptr;
 }
 
+std::shared_ptr<TorControl> TorControl::Attach(const TorConfig& torConfig) noexcept
+{
+	try
+	{
+		std::shared_ptr<TorControlClient> pClient = std::shared_ptr<TorControlClient>(new TorControlClient());
+		if (pClient->Connect(SocketAddress("127.0.0.1", torConfig.GetControlPort())) && Authenticate(pClient, torConfig.GetControlPassword())) {
+			LOG_INFO_F("Attached to running tor process on control port {}", torConfig.GetControlPort());
+			return std::unique_ptr<TorControl>(new TorControl(torConfig, pClient, nullptr));
+		}
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception caught: {}", e.what());
+	}
+
+	return nullptr;
+}
+
 bool TorControl::Authenticate(const std::shared_ptr<TorControlClient>& pClient, const std::string& password)
 {
 	std::string command = StringUtil::Format("AUTHENTICATE \"{}\"\n", password);
@@ -92,22 +118,9 @@ bool TorControl::Authenticate(const std::shared_ptr<TorControlClient>& pClient,
 	}
 }
 
-std::string TorControl::AddOnion(const ed25519_secret_key_t& secretKey, const uint16_t externalPort, const uint16_t internalPort)
-{
-	// "ED25519-V3" key is the Base64 encoding of the concatenation of
-	// the 32-byte ed25519 secret scalar in little-endian
-	// and the 32-byte ed25519 PRF secret.
-	std::string serializedKey = cppcodec::base64_rfc4648::encode(ED25519::CalculateTorKey(secretKey).GetVec());
-
-	return AddOnion(serializedKey, externalPort, internalPort);
-}
-
 std::string TorControl::AddOnion(const std::string& serializedKey, const uint16_t externalPort, const uint16_t internalPort)
 {
-	// ADD_ONION ED25519-V3:<SERIALIZED_KEY> PORT=External,Internal
-	std::string command = StringUtil::Format("ADD_ONION ED25519-V3:{} Flags=DiscardPK Port={},{}\n", serializedKey, externalPort, internalPort);
-
-	std::vector<std::string> response = m_pClient->Invoke(command);
+	std::vector<std::string> response = m_pClient->Invoke(BuildAddOnion(serializedKey, externalPort, internalPort));
 	for (std::string& line : response)
 	{
 		if (StringUtil::StartsWith(line, "250-ServiceID=")) {
@@ -120,10 +133,119 @@ std::string TorControl::AddOnion(const std::string& serializedKey, const uint16_
 }
 
 bool TorControl::DelOnion(const TorAddress& torAddress)
+{
+	m_pClient->Invoke(BuildDelOnion(torAddress));
+	return true;
+}
+
+std::vector<bool> TorControl::UpdateOnions(
+	const std::vector<std::pair<std::string, uint16_t>>& additions,
+	const uint16_t externalPort,
+	const std::vector<TorAddress>& removals)
+{
+	std::vector<std::string> commands;
+	commands.reserve(additions.size() + removals.size());
+	for (const auto& addition : additions)
+	{
+		commands.push_back(BuildAddOnion(addition.first, externalPort, addition.second));
+	}
+
+	for (const TorAddress& removal : removals)
+	{
+		commands.push_back(BuildDelOnion(removal));
+	}
+
+	const std::vector<std::optional<std::vector<std::string>>> replies = m_pClient->InvokeAll(commands);
+
+	std::vector<bool> succeeded(commands.size(), false);
+	for (size_t i = 0; i < replies.size(); i++)
+	{
+		if (replies[i].has_value())
+		{
+			// Like AddOnion, an addition only succeeded if it returned the service's address.
+			succeeded[i] = i >= additions.size() || std::any_of(
+				replies[i].value().cbegin(), replies[i].value().cend(),
+				[](const std::string& line) { return StringUtil::StartsWith(line, "250-ServiceID="); }
+			);
+		}
+	}
+
+	return succeeded;
+}
+
+std::string TorControl::BuildAddOnion(const std::string& serializedKey, const uint16_t externalPort, const uint16_t internalPort)
+{
+	// ADD_ONION ED25519-V3:<SERIALIZED_KEY> PORT=External,Internal
+	return StringUtil::Format("ADD_ONION ED25519-V3:{} Flags=DiscardPK Port={},{}\n", serializedKey, externalPort, internalPort);
+}
+
+std::string TorControl::BuildDelOnion(const TorAddress& torAddress)
 {
 	// DEL_ONION ServiceId
-	std::string command = StringUtil::Format("DEL_ONION {}\n", torAddress.ToString());
+	return StringUtil::Format("DEL_ONION {}\n", torAddress.ToString());
+}
 
-	m_pClient->Invoke(command);
-	return true;
-}
\ No newline at end of file
+bool TorControl::WaitForBootstrap(const std::chrono::seconds& timeout) const
+{
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	const std::string& password = m_torConfig.GetControlPassword();
+	const uint16_t controlPort = m_torConfig.GetControlPort();
+
+	std::shared_ptr<TorControlClient> pClient = std::shared_ptr<TorControlClient>(new TorControlClient());
+	while (!ShutdownManagerAPI::WasShutdownRequested() && std::chrono::steady_clock::now() < deadline)
+	{
+		// A read that times out closes the socket, so the subscription is renewed,
+		// which also catches any progress made while it was closed.
+		if (!pClient->IsConnected())
+		{
+			try
+			{
+				if (SubscribeToBootstrap(pClient, password, controlPort)) {
+					return true;
+				}
+			}
+			catch (const TorException& e)
+			{
+				LOG_WARNING_F("Failed to subscribe to bootstrap status: {}", e.what());
+			}
+
+			if (!pClient->IsConnected()) {
+				ThreadUtil::SleepFor(std::chrono::milliseconds(500), ShutdownManagerAPI::WasShutdownRequested());
+				continue;
+			}
+		}
+
+		std::optional<std::string> event = pClient->ReadEvent(TOR_CONTROL_TIMEOUT);
+		if (event.has_value() && IsBootstrapped(event.value())) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TorControl::SubscribeToBootstrap(const std::shared_ptr<TorControlClient>& pClient, const std::string& password, const uint16_t controlPort)
+{
+	if (!pClient->Connect(SocketAddress("127.0.0.1", controlPort)) || !Authenticate(pClient, password)) {
+		return false;
+	}
+
+	// Subscribe before checking the current phase, so no progress is missed in between.
+	pClient->Invoke("SETEVENTS STATUS_CLIENT\n");
+
+	// 250-status/bootstrap-phase=NOTICE BOOTSTRAP PROGRESS=100 TAG=done SUMMARY="Done"
+	for (const std::string& line : pClient->Invoke("GETINFO status/bootstrap-phase\n"))
+	{
+		if (IsBootstrapped(line)) {
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool TorControl::IsBootstrapped(const std::string& status)
+{
+	// 650 STATUS_CLIENT NOTICE BOOTSTRAP PROGRESS=100 TAG=done SUMMARY="Done"
+	return status.find("BOOTSTRAP PROGRESS=100") != std::string::npos;
+}
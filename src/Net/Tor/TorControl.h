@@ -4,6 +4,7 @@
 #include <Config/TorConfig.h>
 #include <Net/Tor/TorAddress.h>
 #include <Common/ChildProcess.h>
+#include <chrono>
 
 // Forward Declarations
 class TorControlClient;
@@ -13,12 +14,37 @@ class TorControl
 public:
 	~TorControl() = default;
 
+	//
+	// Starts a new tor process, and connects to its control port.
+	//
 	static std::shared_ptr<TorControl> Create(const TorConfig& torConfig) noexcept;
 
-	std::string AddOnion(const ed25519_secret_key_t& secretKey, const uint16_t externalPort, const uint16_t internalPort);
+	//
+	// Connects to a tor process that's already listening on the configured control port,
+	// such as one left running by a previous instance. Returns nullptr if it can't be authenticated with.
+	//
+	static std::shared_ptr<TorControl> Attach(const TorConfig& torConfig) noexcept;
+
 	std::string AddOnion(const std::string& serializedKey, const uint16_t externalPort, const uint16_t internalPort);
 	bool DelOnion(const TorAddress& torAddress);
 
+	//
+	// Sends an ADD_ONION for each of the (serialized key, internal port) additions, and a DEL_ONION for each removal, in a single batch.
+	// Returns whether each command succeeded: the additions, followed by the removals, in the order given.
+	//
+	std::vector<bool> UpdateOnions(
+		const std::vector<std::pair<std::string, uint16_t>>& additions,
+		const uint16_t externalPort,
+		const std::vector<TorAddress>& removals
+	);
+
+	//
+	// Blocks until tor reports that it's finished bootstrapping, using STATUS_CLIENT events
+	// on a separate control connection, so other commands can be sent in the meantime.
+	// Returns false if it didn't finish within the timeout.
+	//
+	bool WaitForBootstrap(const std::chrono::seconds& timeout) const;
+
 	// TODO: Add GETINFO
 
 private:
@@ -29,8 +55,12 @@ private:
 	);
 
 	static bool Authenticate(const std::shared_ptr<TorControlClient>& pClient, const std::string& password);
+	static bool SubscribeToBootstrap(const std::shared_ptr<TorControlClient>& pClient, const std::string& password, const uint16_t controlPort);
+	static bool IsBootstrapped(const std::string& status);
+	static std::string BuildAddOnion(const std::string& serializedKey, const uint16_t externalPort, const uint16_t internalPort);
+	static std::string BuildDelOnion(const TorAddress& torAddress);
 
-	const TorConfig& m_torConfig;
+	TorConfig m_torConfig;
 	std::shared_ptr<TorControlClient> m_pClient;
 	ChildProcess::UCPtr m_pProcess;
 };
\ No newline at end of file
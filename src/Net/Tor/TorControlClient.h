@@ -3,6 +3,7 @@
 #include <Net/Clients/Client.h>
 #include <Net/Tor/TorException.h>
 #include <Common/Logger.h>
+#include <optional>
 
 static const std::chrono::seconds TOR_CONTROL_TIMEOUT = std::chrono::seconds(3);
 
@@ -23,8 +24,11 @@ public:
 		}
 	}
 
+	bool IsConnected() const noexcept { return IsOpen(); }
+
 	//
 	// Writes the given string to the socket, and reads each line until "250 OK" is read.
+	// Asynchronous events (prefixed with "650") that arrive in the meantime are skipped.
 	// throws TorException - If a line is read indicating a failure (ie not prefixed with "250").
 	//
 	std::vector<std::string> Invoke(const std::string& request) final
@@ -38,6 +42,12 @@ public:
 			std::string line = ReadLine(TOR_CONTROL_TIMEOUT).Trim();
 			while (line != "250 OK")
 			{
+				if (StringUtil::StartsWith(line, "650"))
+				{
+					line = ReadLine(TOR_CONTROL_TIMEOUT).Trim();
+					continue;
+				}
+
 				if (!StringUtil::StartsWith(line, "250"))
 				{
 					throw TOR_EXCEPTION("Failed with error: " + line);
@@ -58,4 +68,87 @@ public:
 			throw TOR_EXCEPTION(e.what());
 		}
 	}
+
+	//
+	// Writes all of the requests at once, then reads each of their replies in order, so a batch costs a single round trip.
+	// Unlike Invoke, a failed request doesn't throw. Its reply is std::nullopt, and the replies to the rest are still read.
+	// throws TorException - If the connection fails.
+	//
+	std::vector<std::optional<std::vector<std::string>>> InvokeAll(const std::vector<std::string>& requests)
+	{
+		try
+		{
+			std::string batch;
+			for (const std::string& request : requests)
+			{
+				batch += request;
+			}
+
+			Write(batch, TOR_CONTROL_TIMEOUT);
+
+			std::vector<std::optional<std::vector<std::string>>> replies;
+			replies.reserve(requests.size());
+			for (size_t i = 0; i < requests.size(); i++)
+			{
+				std::vector<std::string> reply;
+				std::string line = ReadLine(TOR_CONTROL_TIMEOUT).Trim();
+				while (line != "250 OK")
+				{
+					if (StringUtil::StartsWith(line, "250"))
+					{
+						reply.push_back(line);
+					}
+					else if (!StringUtil::StartsWith(line, "650"))
+					{
+						// Errors can span several lines ("552-..."), the last of which has a space after the status ("552 ...").
+						while (line.size() > 3 && line[3] == '-')
+						{
+							line = ReadLine(TOR_CONTROL_TIMEOUT).Trim();
+						}
+
+						break;
+					}
+
+					line = ReadLine(TOR_CONTROL_TIMEOUT).Trim();
+				}
+
+				if (line == "250 OK")
+				{
+					replies.push_back(std::make_optional(std::move(reply)));
+				}
+				else
+				{
+					LOG_WARNING_F("Tor command failed with error: {}", line);
+					replies.push_back(std::nullopt);
+				}
+			}
+
+			return replies;
+		}
+		catch (TorException&)
+		{
+			throw;
+		}
+		catch (std::exception& e)
+		{
+			throw TOR_EXCEPTION(e.what());
+		}
+	}
+
+	//
+	// Reads the next line from the socket, which is expected to be an event subscribed to with SETEVENTS.
+	// Returns std::nullopt if none arrives within the timeout, in which case the socket will have been closed.
+	//
+	std::optional<std::string> ReadEvent(const std::chrono::steady_clock::duration& timeout)
+	{
+		try
+		{
+			return std::make_optional<std::string>(ReadLine(timeout).Trim());
+		}
+		catch (std::exception&)
+		{
+			Close();
+			return std::nullopt;
+		}
+	}
 };
\ No newline at end of file
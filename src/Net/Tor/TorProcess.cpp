@@ -5,6 +5,8 @@
 #include <Common/Util/ThreadUtil.h>
 #include <Common/ShutdownManager.h>
 #include <Common/Logger.h>
+#include <Crypto/ED25519.h>
+#include <cppcodec/base64_rfc4648.hpp>
 #include <cstdlib>
 #include <memory>
 
@@ -14,6 +16,7 @@ TorProcess::~TorProcess()
 {
 	LOG_INFO("Terminating tor process");
 	ThreadUtil::Join(m_initThread);
+	m_pConnectPool->Stop();
 }
 
 TorProcess::Ptr TorProcess::Initialize(const fs::path& torDataPath, const uint16_t socksPort, const uint16_t controlPort) noexcept
@@ -30,25 +33,89 @@ void TorProcess::Thread_Initialize(TorProcess* pProcess)
 
 	try
 	{
+		TorConfig config{ pProcess->m_socksPort, pProcess->m_controlPort, pProcess->m_torDataPath };
 		if (!IsPortOpen(pProcess->m_socksPort) || !IsPortOpen(pProcess->m_controlPort)) {
-			LOG_WARNING("Tor port(s) in use. Trying to end tor process.");
+			// Usually a tor process left behind by a previous run, which can be used as-is.
+			pProcess->m_pControl = TorControl::Attach(config);
+			if (pProcess->m_pControl == nullptr) {
+				LOG_WARNING("Tor port(s) in use. Trying to end tor process.");
 #ifdef _WIN32
-    		system("taskkill /IM tor.exe /F");
+				system("taskkill /IM tor.exe /F");
 #else
-			system("killall tor");
+				system("killall tor");
 #endif
-			ThreadUtil::SleepFor(std::chrono::seconds(5), ShutdownManagerAPI::WasShutdownRequested());
+				WaitForPortsToClose(pProcess->m_socksPort, pProcess->m_controlPort);
+			}
+		}
+
+		if (pProcess->m_pControl == nullptr) {
+			LOG_INFO("Initializing Tor");
+			pProcess->m_pControl = TorControl::Create(config);
 		}
 
-		LOG_INFO("Initializing Tor");
-		TorConfig config{ pProcess->m_socksPort, pProcess->m_controlPort, pProcess->m_torDataPath };
-		pProcess->m_pControl = TorControl::Create(config);
 		LOG_INFO_F("Tor Initialized: {}", pProcess->m_pControl != nullptr);
+		pProcess->StartBootstrapDetection(pProcess->m_pControl);
 	}
 	catch (const std::exception& e)
 	{
 		LOG_ERROR_F("Exception thrown: {}", e);
+		pProcess->SetBootstrapped(false);
+	}
+}
+
+bool TorProcess::WaitForPortsToClose(const uint16_t socksPort, const uint16_t controlPort)
+{
+	const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+	while (!IsPortOpen(socksPort) || !IsPortOpen(controlPort))
+	{
+		if (std::chrono::steady_clock::now() >= timeout || ShutdownManagerAPI::WasShutdownRequested()) {
+			return false;
+		}
+
+		ThreadUtil::SleepFor(std::chrono::milliseconds(100), ShutdownManagerAPI::WasShutdownRequested());
+	}
+
+	return true;
+}
+
+void TorProcess::StartBootstrapDetection(const std::shared_ptr<TorControl>& pControl)
+{
+	if (pControl == nullptr) {
+		SetBootstrapped(false);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> bootstrapLock(m_bootstrapMutex);
+		m_bootstrapping = true;
+		m_bootstrapped = false;
+	}
+
+	// Runs on the pool, so listeners can be added while tor is still bootstrapping.
+	m_pConnectPool->Post([this, pControl]() {
+		const bool bootstrapped = pControl->WaitForBootstrap(TOR_BOOTSTRAP_TIMEOUT);
+		LOG_INFO_F("Tor bootstrapped: {}", bootstrapped);
+		SetBootstrapped(bootstrapped);
+	});
+}
+
+void TorProcess::SetBootstrapped(const bool bootstrapped)
+{
+	{
+		std::unique_lock<std::mutex> bootstrapLock(m_bootstrapMutex);
+		m_bootstrapping = false;
+		m_bootstrapped = bootstrapped;
 	}
+
+	m_bootstrapCV.notify_all();
+}
+
+bool TorProcess::WaitForBootstrap(const std::chrono::seconds& timeout)
+{
+	std::unique_lock<std::mutex> bootstrapLock(m_bootstrapMutex);
+	m_bootstrapCV.wait_for(bootstrapLock, timeout, [this] { return m_bootstrapped || !m_bootstrapping; });
+
+	return m_bootstrapped;
 }
 
 bool TorProcess::IsPortOpen(const uint16_t port)
@@ -67,7 +134,13 @@ bool TorProcess::RetryInit()
 	std::unique_lock<std::mutex> lock(m_mutex);
 
 	if (m_pControl == nullptr) {
-		m_pControl = TorControl::Create(TorConfig{ m_socksPort, m_controlPort, m_torDataPath });
+		TorConfig config{ m_socksPort, m_controlPort, m_torDataPath };
+		m_pControl = TorControl::Attach(config);
+		if (m_pControl == nullptr) {
+			m_pControl = TorControl::Create(config);
+		}
+
+		StartBootstrapDetection(m_pControl);
 	}
 
 	return m_pControl != nullptr;
@@ -75,28 +148,28 @@ bool TorProcess::RetryInit()
 
 std::shared_ptr<TorAddress> TorProcess::AddListener(const ed25519_secret_key_t& secretKey, const uint16_t portNumber)
 {
-	std::unique_lock<std::mutex> lock(m_mutex);
+	// "ED25519-V3" key is the Base64 encoding of the concatenation of
+	// the 32-byte ed25519 secret scalar in little-endian
+	// and the 32-byte ed25519 PRF secret.
+	std::string serializedKey = cppcodec::base64_rfc4648::encode(ED25519::CalculateTorKey(secretKey).GetVec());
 
-	try
+	return AddListener(serializedKey, portNumber);
+}
+
+std::shared_ptr<TorAddress> TorProcess::AddListener(const TorAddress& torAddress, const uint16_t portNumber)
+{
+	std::string serializedKey;
 	{
-		if (m_pControl != nullptr) {
-			const std::string address = m_pControl->AddOnion(secretKey, 80, portNumber);
-			if (!address.empty()) {
-				std::optional<TorAddress> torAddress = TorAddressParser::Parse(address);
-				if (!torAddress.has_value()) {
-					LOG_ERROR_F("Failed to parse listener address: {}", address);
-				} else {
-					return std::make_shared<TorAddress>(torAddress.value());
-				}
-			}
+		std::unique_lock<std::mutex> lock(m_mutex);
+		auto iter = m_listenerKeys.find(torAddress.ToString());
+		if (iter == m_listenerKeys.end()) {
+			return nullptr;
 		}
-	}
-	catch (const TorException& e)
-	{
-		LOG_ERROR_F("Failed to add listener: {}", e.what());
+
+		serializedKey = iter->second;
 	}
 
-	return nullptr;
+	return AddListener(serializedKey, portNumber);
 }
 
 std::shared_ptr<TorAddress> TorProcess::AddListener(const std::string& serializedKey, const uint16_t portNumber)
@@ -112,6 +185,8 @@ std::shared_ptr<TorAddress> TorProcess::AddListener(const std::string& serialize
 				if (!torAddress.has_value()) {
 					LOG_ERROR_F("Failed to parse listener address: {}", address);
 				} else {
+					m_listenerKeys[torAddress.value().ToString()] = serializedKey;
+					m_activeListeners.insert(torAddress.value().ToString());
 					return std::make_shared<TorAddress>(torAddress.value());
 				}
 			}
@@ -132,6 +207,7 @@ bool TorProcess::RemoveListener(const TorAddress& torAddress)
 	try
 	{
 		if (m_pControl != nullptr) {
+			m_activeListeners.erase(torAddress.ToString());
 			return m_pControl->DelOnion(torAddress);
 		}
 	}
@@ -143,17 +219,165 @@ bool TorProcess::RemoveListener(const TorAddress& torAddress)
 	return false;
 }
 
+std::optional<TorAddress> TorProcess::AddListenerAsync(const ed25519_secret_key_t& secretKey, const uint16_t portNumber)
+{
+	// While tor is starting, the init thread holds the lock, so the listener is queued to be sent once it's up.
+	{
+		std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+		if (lock.owns_lock() && m_pControl == nullptr) {
+			return std::nullopt;
+		}
+	}
+
+	std::string serializedKey = cppcodec::base64_rfc4648::encode(ED25519::CalculateTorKey(secretKey).GetVec());
+	const TorAddress torAddress = TorAddressParser::FromPubKey(ED25519::CalculatePubKey(secretKey));
+	QueueListenerChange(torAddress, std::make_optional(std::move(serializedKey)), portNumber);
+
+	return std::make_optional(torAddress);
+}
+
+void TorProcess::RemoveListenerAsync(const TorAddress& torAddress)
+{
+	QueueListenerChange(torAddress, std::nullopt, 0);
+}
+
+void TorProcess::QueueListenerChange(const TorAddress& torAddress, std::optional<std::string>&& serializedKey, const uint16_t portNumber)
+{
+	std::unique_lock<std::mutex> queuedLock(m_queuedMutex);
+	m_queuedChanges.insert_or_assign(torAddress.ToString(), ListenerChange{ torAddress, std::move(serializedKey), portNumber });
+
+	// Changes queued while a batch is being sent are picked up by the same task once it's done.
+	if (!m_sendingChanges) {
+		m_sendingChanges = true;
+		m_pConnectPool->Post([this]() { SendListenerChanges(); });
+	}
+}
+
+void TorProcess::SendListenerChanges()
+{
+	while (true)
+	{
+		std::unordered_map<std::string, ListenerChange> changes;
+		{
+			std::unique_lock<std::mutex> queuedLock(m_queuedMutex);
+			if (m_queuedChanges.empty()) {
+				m_sendingChanges = false;
+				return;
+			}
+
+			changes.swap(m_queuedChanges);
+		}
+
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		std::vector<std::pair<std::string, uint16_t>> additions;
+		std::vector<TorAddress> additionAddresses;
+		std::vector<TorAddress> removals;
+		for (auto& change : changes)
+		{
+			const bool active = m_activeListeners.find(change.first) != m_activeListeners.end();
+			if (change.second.serializedKey.has_value()) {
+				m_listenerKeys[change.first] = change.second.serializedKey.value();
+				if (!active) {
+					additions.push_back({ change.second.serializedKey.value(), change.second.portNumber });
+					additionAddresses.push_back(change.second.address);
+				}
+			} else if (active) {
+				removals.push_back(change.second.address);
+			}
+		}
+
+		if (additions.empty() && removals.empty()) {
+			continue;
+		}
+
+		if (m_pControl == nullptr) {
+			LOG_WARNING_F("Tor isn't running. Dropped {} listener changes.", additions.size() + removals.size());
+			continue;
+		}
+
+		try
+		{
+			const std::vector<bool> succeeded = m_pControl->UpdateOnions(additions, 80, removals);
+			for (size_t i = 0; i < additionAddresses.size(); i++)
+			{
+				if (succeeded[i]) {
+					m_activeListeners.insert(additionAddresses[i].ToString());
+				} else {
+					LOG_ERROR_F("Failed to add listener {}", additionAddresses[i].ToString());
+				}
+			}
+
+			// A removal that failed most likely means tor no longer had the listener, so it's forgotten either way.
+			for (const TorAddress& removal : removals)
+			{
+				m_activeListeners.erase(removal.ToString());
+			}
+
+			LOG_DEBUG_F("Sent {} listener additions and {} removals to tor", additions.size(), removals.size());
+		}
+		catch (const TorException& e)
+		{
+			LOG_ERROR_F("Failed to update listeners: {}", e.what());
+		}
+	}
+}
+
 std::shared_ptr<TorConnection> TorProcess::Connect(const TorAddress& address)
 {
-	std::unique_lock<std::mutex> lock(m_mutex);
+	// Circuits can't be built until tor has bootstrapped.
+	WaitForBootstrap(TOR_BOOTSTRAP_TIMEOUT);
+
+	std::unique_lock<std::mutex> lock(m_connectionsMutex);
 
 	try
 	{
-		return std::make_shared<TorConnection>(address, SocketAddress{ "127.0.0.1", m_socksPort });
+		for (auto iter = m_connections.begin(); iter != m_connections.end();)
+		{
+			if (iter->second->IsIdle(TOR_CONNECTION_IDLE_TIMEOUT))
+			{
+				iter = m_connections.erase(iter);
+			}
+			else
+			{
+				++iter;
+			}
+		}
+
+		auto iter = m_connections.find(address.ToString());
+		if (iter != m_connections.end())
+		{
+			return iter->second;
+		}
+
+		auto pConnection = std::make_shared<TorConnection>(address, SocketAddress{ "127.0.0.1", m_socksPort });
+		m_connections.insert({ address.ToString(), pConnection });
+		return pConnection;
 	}
 	catch (std::exception& e)
 	{
 		LOG_ERROR_F("Failed to create TorConnection: {}", e.what());
 		return nullptr;
 	}
-}
\ No newline at end of file
+}
+
+void TorProcess::PrewarmConnections(const std::vector<TorAddress>& addresses)
+{
+	for (const TorAddress& address : addresses)
+	{
+		std::shared_ptr<TorConnection> pConnection = Connect(address);
+		if (pConnection != nullptr)
+		{
+			m_pConnectPool->Post([pConnection]() {
+				try
+				{
+					pConnection->Open();
+				}
+				catch (const std::exception& e)
+				{
+					LOG_WARNING_F("Failed to prewarm connection to {}: {}", pConnection->GetAddress().ToString(), e.what());
+				}
+			});
+		}
+	}
+}
@@ -0,0 +1,141 @@
+#include <Net/Util/GzipUtil.h>
+#include <Net/Clients/HTTP/HTTPException.h>
+
+#include <zlib.h>
+#include <climits>
+#include <cstring>
+
+// 16 added to the window bits selects the gzip header and trailer, rather than zlib's.
+static const int GZIP_WINDOW_BITS = MAX_WBITS + 16;
+
+// Responses are compressed on the request threads, and hex-heavy JSON already shrinks several times over at the fastest level.
+static const int COMPRESSION_LEVEL = Z_BEST_SPEED;
+
+static const size_t BUFFER_SIZE = 16 * 1024;
+
+struct GzipEncoder::Stream
+{
+	z_stream zstream;
+};
+
+std::string GzipUtil::Compress(const std::string& data)
+{
+	return Compress(data.data(), data.size());
+}
+
+std::string GzipUtil::Compress(const void* pData, const size_t numBytes)
+{
+	GzipEncoder encoder;
+	std::string compressed = encoder.Write(pData, numBytes);
+	compressed.append(encoder.Finish());
+	return compressed;
+}
+
+std::string GzipUtil::Decompress(const std::string& data, const size_t maxSize)
+{
+	z_stream zstream;
+	std::memset(&zstream, 0, sizeof(zstream));
+	const int initStatus = inflateInit2(&zstream, GZIP_WINDOW_BITS);
+	if (initStatus != Z_OK)
+	{
+		throw HTTP_EXCEPTION_F("inflateInit2 failed with error {}", initStatus);
+	}
+
+	std::string decompressed;
+	unsigned char buffer[BUFFER_SIZE];
+
+	zstream.next_in = (Bytef*)data.data();
+	zstream.avail_in = (uInt)data.size();
+
+	int status = Z_OK;
+	while (status != Z_STREAM_END)
+	{
+		zstream.next_out = buffer;
+		zstream.avail_out = (uInt)sizeof(buffer);
+
+		status = inflate(&zstream, Z_NO_FLUSH);
+		if (status != Z_OK && status != Z_STREAM_END)
+		{
+			// Z_BUF_ERROR here means the input ended before the gzip trailer did.
+			inflateEnd(&zstream);
+			throw HTTP_EXCEPTION_F("Failed to decompress gzip body. Error: {}", status);
+		}
+
+		const size_t numDecompressed = sizeof(buffer) - zstream.avail_out;
+		if (decompressed.size() + numDecompressed > maxSize)
+		{
+			inflateEnd(&zstream);
+			throw HTTP_EXCEPTION_F("Decompressed body exceeds {} bytes", maxSize);
+		}
+
+		decompressed.append((const char*)buffer, numDecompressed);
+	}
+
+	inflateEnd(&zstream);
+	return decompressed;
+}
+
+GzipEncoder::GzipEncoder()
+	: m_pStream(std::make_unique<Stream>()), m_finished(false)
+{
+	std::memset(&m_pStream->zstream, 0, sizeof(m_pStream->zstream));
+	const int status = deflateInit2(&m_pStream->zstream, COMPRESSION_LEVEL, Z_DEFLATED, GZIP_WINDOW_BITS, 8, Z_DEFAULT_STRATEGY);
+	if (status != Z_OK)
+	{
+		throw HTTP_EXCEPTION_F("deflateInit2 failed with error {}", status);
+	}
+}
+
+GzipEncoder::~GzipEncoder()
+{
+	deflateEnd(&m_pStream->zstream);
+}
+
+std::string GzipEncoder::Write(const void* pData, const size_t numBytes)
+{
+	// Z_SYNC_FLUSH ends each write on a byte boundary, so the client never has to wait for the next chunk to decompress this one.
+	return Deflate(pData, numBytes, Z_SYNC_FLUSH);
+}
+
+std::string GzipEncoder::Finish()
+{
+	if (m_finished)
+	{
+		return "";
+	}
+
+	m_finished = true;
+	return Deflate(nullptr, 0, Z_FINISH);
+}
+
+std::string GzipEncoder::Deflate(const void* pData, const size_t numBytes, const int flush)
+{
+	if (numBytes > UINT_MAX)
+	{
+		throw HTTP_EXCEPTION_F("Can't compress {} bytes at once", numBytes);
+	}
+
+	z_stream& zstream = m_pStream->zstream;
+	zstream.next_in = (Bytef*)pData;
+	zstream.avail_in = (uInt)numBytes;
+
+	std::string compressed;
+	unsigned char buffer[BUFFER_SIZE];
+
+	// deflate has written everything once it leaves space in the output buffer.
+	do
+	{
+		zstream.next_out = buffer;
+		zstream.avail_out = (uInt)sizeof(buffer);
+
+		const int status = deflate(&zstream, flush);
+		if (status == Z_STREAM_ERROR)
+		{
+			throw HTTP_EXCEPTION_F("Failed to compress body. Error: {}", status);
+		}
+
+		compressed.append((const char*)buffer, sizeof(buffer) - zstream.avail_out);
+	} while (zstream.avail_out == 0);
+
+	return compressed;
+}
@@ -1,4 +1,6 @@
 #include <Net/Util/HTTPUtil.h>
+#include <Net/Util/GzipUtil.h>
+#include <Config/HttpServerConfig.h>
 #include <Core/Util/JsonUtil.h>
 #include <Net/Clients/HTTP/HTTPException.h>
 #include <Common/Util/StringUtil.h>
@@ -6,6 +8,16 @@
 #include <Common/Compat.h>
 
 #include <civetweb.h>
+#include <cstdlib>
+
+static const size_t MAX_RETAINED_BODY_SIZE = 1024 * 1024;
+
+// Servers started without an HttpServerConfig (eg. the wallet's owner API) don't compress their responses.
+static uint32_t GetGzipMinBytes(mg_connection* conn)
+{
+	const HttpServerConfig* pConfig = (const HttpServerConfig*)mg_get_user_data(mg_get_context(conn));
+	return pConfig != nullptr ? pConfig->GetGzipMinBytes() : 0;
+}
 
 // Strips away the base URI and any query strings.
 // Ex: Given "/v1/blocks/<hash>?compact" and baseURI "/v1/blocks/", this would return <hash>.
@@ -102,29 +114,120 @@ std::optional<Json::Value> HTTPUtil::GetRequestBody(mg_connection* conn)
 {
 	assert(conn != nullptr);
 
+	thread_local std::string buffer;
+	ReadRequestBody(conn, buffer);
+	if (buffer.empty())
+	{
+		return std::nullopt;
+	}
+
+	std::optional<Json::Value> jsonOpt = std::make_optional<Json::Value>();
+	const bool parsed = JsonUtil::Parse(buffer.data(), buffer.data() + buffer.size(), jsonOpt.value());
+	if (!parsed)
+	{
+		throw DESERIALIZATION_EXCEPTION_F("Failed to parse json: {}", buffer);
+	}
+
+	return jsonOpt;
+}
+
+void HTTPUtil::ReadRequestBody(mg_connection* conn, std::string& buffer)
+{
+	assert(conn != nullptr);
+
+	// An unusually large body (eg. a slate with many outputs) shouldn't stay allocated for the life of the thread.
+	if (buffer.capacity() > MAX_RETAINED_BODY_SIZE)
+	{
+		std::string().swap(buffer);
+	}
+
+	buffer.clear();
+
 	const struct mg_request_info* req_info = mg_get_request_info(conn);
 	const long long contentLength = req_info->content_length;
 	if (contentLength <= 0)
 	{
-		return std::nullopt;
+		return;
 	}
 
-	std::string requestBody;
-	requestBody.resize(contentLength);
+	buffer.resize((size_t)contentLength);
 
-	const int bytesRead = mg_read(conn, requestBody.data(), contentLength);
+	const int bytesRead = mg_read(conn, &buffer[0], (size_t)contentLength);
 	if (bytesRead != contentLength)
 	{
+		buffer.clear();
 		throw HTTPException();
 	}
+}
+
+std::vector<uint8_t> HTTPUtil::GetRequestBytes(mg_connection* conn)
+{
+	assert(conn != nullptr);
+
+	const struct mg_request_info* req_info = mg_get_request_info(conn);
+	const long long contentLength = req_info->content_length;
+	if (contentLength <= 0)
+	{
+		return {};
+	}
+
+	std::vector<uint8_t> requestBytes;
+	requestBytes.resize(contentLength);
+
+	const int bytesRead = mg_read(conn, requestBytes.data(), contentLength);
+	if (bytesRead != contentLength)
+	{
+		throw HTTPException();
+	}
+
+	return requestBytes;
+}
+
+bool HTTPUtil::AcceptsBinary(mg_connection* conn)
+{
+	assert(conn != nullptr);
+
+	const std::optional<std::string> acceptOpt = GetHeaderValue(conn, "Accept");
+	return acceptOpt.has_value() && acceptOpt.value().find(HTTP::CONTENT_TYPE_BINARY) != std::string::npos;
+}
+
+bool HTTPUtil::AcceptsGzip(mg_connection* conn)
+{
+	assert(conn != nullptr);
+
+	if (GetGzipMinBytes(conn) == 0)
+	{
+		return false;
+	}
 
-	Json::Value json;
-	if (!JsonUtil::Parse(requestBody, json))
+	const std::optional<std::string> acceptOpt = GetHeaderValue(conn, "Accept-Encoding");
+	if (!acceptOpt.has_value())
 	{
-		throw DESERIALIZATION_EXCEPTION_F("Failed to parse json: {}", requestBody);
+		return false;
 	}
 
-	return std::make_optional(json);
+	// Ex: "gzip, deflate" or "br;q=1.0, gzip;q=0.8". A quality of 0 means the encoding is not acceptable.
+	for (const std::string& encoding : StringUtil::Split(acceptOpt.value(), ","))
+	{
+		std::vector<std::string> parts = StringUtil::Split(encoding, ";");
+		if (parts.empty() || StringUtil::ToLower(StringUtil::Trim(parts[0])) != "gzip")
+		{
+			continue;
+		}
+
+		for (size_t i = 1; i < parts.size(); i++)
+		{
+			const std::string param = StringUtil::Trim(parts[i]);
+			if (StringUtil::StartsWith(param, "q=") && std::atof(param.substr(2).c_str()) <= 0.0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	return false;
 }
 
 int HTTPUtil::BuildSuccessResponseJSON(mg_connection* conn, const Json::Value& json)
@@ -141,26 +244,58 @@ int HTTPUtil::BuildSuccessResponse(mg_connection* conn, const std::string& respo
 {
 	assert(conn != nullptr);
 
-	unsigned long len = (unsigned long)response.size();
-
 	if (response.empty())
 	{
 		mg_printf(conn,
 			"HTTP/1.1 200 OK\r\n"
-			"Content-Length: 0\r\n"
-			"Connection: close\r\n\r\n");
+			"Content-Length: 0\r\n\r\n");
+		return 200;
 	}
-	else
+
+	return BuildSuccessResponse(conn, "application/json", response.data(), response.size());
+}
+
+int HTTPUtil::BuildSuccessResponseText(mg_connection* conn, const std::string& response)
+{
+	assert(conn != nullptr);
+
+	return BuildSuccessResponse(conn, "text/plain; version=0.0.4", response.data(), response.size());
+}
+
+int HTTPUtil::BuildSuccessResponseBinary(mg_connection* conn, const std::vector<uint8_t>& response)
+{
+	assert(conn != nullptr);
+
+	return BuildSuccessResponse(conn, HTTP::CONTENT_TYPE_BINARY, response.data(), response.size());
+}
+
+int HTTPUtil::BuildSuccessResponse(mg_connection* conn, const char* contentType, const void* pData, const size_t numBytes)
+{
+	if (numBytes >= GetGzipMinBytes(conn) && AcceptsGzip(conn))
 	{
+		const std::string compressed = GzipUtil::Compress(pData, numBytes);
+
 		mg_printf(conn,
 			"HTTP/1.1 200 OK\r\n"
 			"Content-Length: %lu\r\n"
-			"Content-Type: application/json\r\n"
-			"Connection: close\r\n\r\n",
-			len);
+			"Content-Type: %s\r\n"
+			"Content-Encoding: gzip\r\n"
+			"Vary: Accept-Encoding\r\n\r\n",
+			(unsigned long)compressed.size(),
+			contentType);
+
+		mg_write(conn, compressed.data(), compressed.size());
+		return 200;
 	}
 
-	mg_write(conn, response.c_str(), len);
+	mg_printf(conn,
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Length: %lu\r\n"
+		"Content-Type: %s\r\n\r\n",
+		(unsigned long)numBytes,
+		contentType);
+
+	mg_write(conn, pData, numBytes);
 
 	return 200;
 }
@@ -174,8 +309,7 @@ int HTTPUtil::BuildBadRequestResponse(mg_connection* conn, const std::string& re
 	mg_printf(conn,
 		"HTTP/1.1 400 Bad Request\r\n"
 		"Content-Length: %lu\r\n"
-		"Content-Type: text/plain\r\n"
-		"Connection: close\r\n\r\n",
+		"Content-Type: text/plain\r\n\r\n",
 		len);
 
 	mg_write(conn, response.c_str(), len);
@@ -192,8 +326,7 @@ int HTTPUtil::BuildConflictResponse(mg_connection* conn, const std::string& resp
 	mg_printf(conn,
 		"HTTP/1.1 409 Conflict\r\n"
 		"Content-Length: %lu\r\n"
-		"Content-Type: text/plain\r\n"
-		"Connection: close\r\n\r\n",
+		"Content-Type: text/plain\r\n\r\n",
 		len);
 
 	mg_write(conn, response.c_str(), len);
@@ -210,8 +343,7 @@ int HTTPUtil::BuildUnauthorizedResponse(mg_connection* conn, const std::string&
 	mg_printf(conn,
 		"HTTP/1.1 401 Unauthorized\r\n"
 		"Content-Length: %lu\r\n"
-		"Content-Type: text/plain\r\n"
-		"Connection: close\r\n\r\n",
+		"Content-Type: text/plain\r\n\r\n",
 		len);
 
 	mg_write(conn, response.c_str(), len);
@@ -228,8 +360,7 @@ int HTTPUtil::BuildNotFoundResponse(mg_connection* conn, const std::string& resp
 	mg_printf(conn,
 		"HTTP/1.1 404 Not Found\r\n"
 		"Content-Length: %lu\r\n"
-		"Content-Type: text/plain\r\n"
-		"Connection: close\r\n\r\n",
+		"Content-Type: text/plain\r\n\r\n",
 		len);
 
 	mg_write(conn, response.c_str(), len);
@@ -246,8 +377,7 @@ int HTTPUtil::BuildInternalErrorResponse(mg_connection* conn, const std::string&
 	mg_printf(conn,
 		"HTTP/1.1 500 Internal Server Error\r\n"
 		"Content-Length: %lu\r\n"
-		"Content-Type: text/plain\r\n"
-		"Connection: close\r\n\r\n",
+		"Content-Type: text/plain\r\n\r\n",
 		len);
 
 	mg_write(conn, response.c_str(), len);
@@ -0,0 +1,221 @@
+#include <Net/Util/JsonStreamWriter.h>
+#include <Net/Util/HTTPUtil.h>
+#include <Net/Util/GzipUtil.h>
+#include <Common/Logger.h>
+
+#include <civetweb.h>
+#include <cassert>
+#include <cstdio>
+#include <sstream>
+
+static const size_t CHUNK_SIZE = 64 * 1024;
+static const std::string INDENTATION = "   ";
+
+JsonStreamWriter::JsonStreamWriter(mg_connection* pConnection, const bool styled)
+	: m_pConnection(pConnection), m_styled(styled), m_started(false), m_finished(false), m_afterKey(false)
+{
+	assert(pConnection != nullptr);
+
+	Json::StreamWriterBuilder builder;
+	builder["indentation"] = styled ? INDENTATION : ""; // Removes whitespaces
+	m_pValueWriter = std::unique_ptr<Json::StreamWriter>(builder.newStreamWriter());
+
+	m_buffer.reserve(CHUNK_SIZE + 1024);
+
+	if (HTTPUtil::AcceptsGzip(pConnection))
+	{
+		m_pEncoder = std::make_unique<GzipEncoder>();
+	}
+}
+
+JsonStreamWriter::~JsonStreamWriter()
+{
+	// Ends the response if the handler threw part way through, so the client doesn't wait for more chunks.
+	if (m_started && !m_finished)
+	{
+		LOG_WARNING("Response ended before it was finished");
+		mg_write(m_pConnection, "0\r\n\r\n", 5);
+	}
+}
+
+std::unique_ptr<JsonStreamWriter> JsonStreamWriter::Create(mg_connection* pConnection)
+{
+	return std::make_unique<JsonStreamWriter>(pConnection, HTTPUtil::HasQueryParam(pConnection, "pretty"));
+}
+
+void JsonStreamWriter::BeginObject()
+{
+	BeginElement();
+	m_buffer.push_back('{');
+	m_hasElements.push_back(false);
+}
+
+void JsonStreamWriter::EndObject()
+{
+	Close('}');
+}
+
+void JsonStreamWriter::BeginArray()
+{
+	BeginElement();
+	m_buffer.push_back('[');
+	m_hasElements.push_back(false);
+}
+
+void JsonStreamWriter::EndArray()
+{
+	Close(']');
+}
+
+void JsonStreamWriter::Key(const std::string& key)
+{
+	assert(!m_afterKey);
+
+	BeginElement();
+	m_buffer.append(Json::valueToQuotedString(key.c_str()));
+	m_buffer.append(m_styled ? " : " : ":");
+	m_afterKey = true;
+}
+
+void JsonStreamWriter::Value(const Json::Value& value)
+{
+	BeginElement();
+
+	std::ostringstream stream;
+	m_pValueWriter->write(value, &stream);
+
+	if (m_styled && !m_hasElements.empty())
+	{
+		// The value is indented as if it were the root, so shift it to the current depth.
+		std::string indent = "\n";
+		for (size_t i = 0; i < m_hasElements.size(); i++)
+		{
+			indent.append(INDENTATION);
+		}
+
+		for (const char c : stream.str())
+		{
+			if (c == '\n')
+			{
+				m_buffer.append(indent);
+			}
+			else
+			{
+				m_buffer.push_back(c);
+			}
+		}
+	}
+	else
+	{
+		m_buffer.append(stream.str());
+	}
+
+	if (m_buffer.size() >= CHUNK_SIZE)
+	{
+		Flush();
+	}
+}
+
+int JsonStreamWriter::Finish()
+{
+	assert(m_hasElements.empty());
+
+	if (m_styled)
+	{
+		m_buffer.push_back('\n');
+	}
+
+	Flush();
+	if (m_pEncoder != nullptr)
+	{
+		WriteChunk(m_pEncoder->Finish());
+	}
+
+	mg_write(m_pConnection, "0\r\n\r\n", 5);
+	m_finished = true;
+
+	return 200;
+}
+
+void JsonStreamWriter::BeginElement()
+{
+	if (m_afterKey)
+	{
+		m_afterKey = false;
+		return;
+	}
+
+	if (!m_hasElements.empty())
+	{
+		if (m_hasElements.back())
+		{
+			m_buffer.push_back(',');
+		}
+
+		m_hasElements.back() = true;
+		NewLine();
+	}
+}
+
+void JsonStreamWriter::Close(const char closer)
+{
+	assert(!m_hasElements.empty() && !m_afterKey);
+
+	const bool hasElements = m_hasElements.back();
+	m_hasElements.pop_back();
+	if (hasElements)
+	{
+		NewLine();
+	}
+
+	m_buffer.push_back(closer);
+}
+
+void JsonStreamWriter::NewLine()
+{
+	if (m_styled)
+	{
+		m_buffer.push_back('\n');
+		for (size_t i = 0; i < m_hasElements.size(); i++)
+		{
+			m_buffer.append(INDENTATION);
+		}
+	}
+}
+
+void JsonStreamWriter::Flush()
+{
+	if (!m_started)
+	{
+		mg_printf(m_pConnection,
+			"HTTP/1.1 200 OK\r\n"
+			"Content-Type: application/json\r\n"
+			"%s"
+			"Transfer-Encoding: chunked\r\n\r\n",
+			m_pEncoder != nullptr ? "Content-Encoding: gzip\r\nVary: Accept-Encoding\r\n" : "");
+		m_started = true;
+	}
+
+	if (m_buffer.empty())
+	{
+		return;
+	}
+
+	WriteChunk(m_pEncoder != nullptr ? m_pEncoder->Write(m_buffer.data(), m_buffer.size()) : m_buffer);
+	m_buffer.clear();
+}
+
+void JsonStreamWriter::WriteChunk(const std::string& chunk)
+{
+	// A zero-length chunk would end the response.
+	if (chunk.empty())
+	{
+		return;
+	}
+
+	char chunkHeader[32];
+	const int headerLength = snprintf(chunkHeader, sizeof(chunkHeader), "%zx\r\n", chunk.size());
+	mg_write(m_pConnection, chunkHeader, headerLength);
+	mg_write(m_pConnection, chunk.data(), chunk.size());
+	mg_write(m_pConnection, "\r\n", 2);
+}
@@ -51,30 +51,23 @@ std::vector<uint64_t> BlockLocator::GetLocatorHeights(const SyncStatus& syncStat
 	return heights;
 }
 
-std::vector<BlockHeaderPtr> BlockLocator::LocateHeaders(const std::vector<Hash>& locatorHashes) const
+std::pair<uint64_t, uint64_t> BlockLocator::LocateHeaderRange(const std::vector<Hash>& locatorHashes) const
 {
-	std::vector<BlockHeaderPtr> blockHeaders;
-
 	auto pCommonHeader = FindCommonHeader(locatorHashes);
-	if (pCommonHeader != nullptr)
+	if (pCommonHeader == nullptr)
 	{
-		const uint64_t totalHeight = m_pBlockChain->GetHeight(EChainType::CANDIDATE);
-		const uint64_t headerHeight = pCommonHeader->GetHeight();
-		const uint64_t numHeadersToSend = (std::min)(totalHeight - headerHeight, (uint64_t)P2P::MAX_BLOCK_HEADERS);
-
-		for (int i = 1; i <= numHeadersToSend; i++)
-		{
-			auto pHeader = m_pBlockChain->GetBlockHeaderByHeight(headerHeight + i, EChainType::CANDIDATE);
-			if (pHeader == nullptr)
-			{
-				break;
-			}
+		return std::make_pair(0, 0);
+	}
 
-			blockHeaders.push_back(pHeader);
-		}
+	const uint64_t totalHeight = m_pBlockChain->GetHeight(EChainType::CANDIDATE);
+	const uint64_t headerHeight = pCommonHeader->GetHeight();
+	if (headerHeight >= totalHeight)
+	{
+		return std::make_pair(headerHeight + 1, 0);
 	}
-	
-	return blockHeaders;
+
+	const uint64_t numHeadersToSend = (std::min)(totalHeight - headerHeight, (uint64_t)P2P::MAX_BLOCK_HEADERS);
+	return std::make_pair(headerHeight + 1, numHeadersToSend);
 }
 
 BlockHeaderPtr BlockLocator::FindCommonHeader(const std::vector<Hash>& locatorHashes) const
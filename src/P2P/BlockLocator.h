@@ -12,7 +12,12 @@ public:
 		: m_pBlockChain(pBlockChain) { }
 
 	std::vector<Hash> GetLocators(const SyncStatus& syncStatus) const;
-	std::vector<BlockHeaderPtr> LocateHeaders(const std::vector<Hash>& locatorHashes) const;
+
+	//
+	// Returns the first height and number of candidate chain headers to send in response to the locator,
+	// which is at most P2P::MAX_BLOCK_HEADERS headers after the first header found from the locator.
+	//
+	std::pair<uint64_t, uint64_t> LocateHeaderRange(const std::vector<Hash>& locatorHashes) const;
 
 private:
 	std::vector<uint64_t> GetLocatorHeights(const SyncStatus& syncStatus) const;
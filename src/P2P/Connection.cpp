@@ -1,9 +1,13 @@
 #include "Connection.h"
 #include "MessageRetriever.h"
 #include "MessageProcessor.h"
+#include "MessageDispatcher.h"
 #include "ConnectionManager.h"
+#include "P2PMetrics.h"
+#include "MessageCompressor.h"
 #include "Messages/PingMessage.h"
 #include "Messages/GetPeerAddressesMessage.h"
+#include "Messages/GetBlockMessage.h"
 #include "Seed/HandShake.h"
 
 #include <Net/SocketException.h>
@@ -12,15 +16,72 @@
 #include <Common/Logger.h>
 #include <thread>
 #include <chrono>
+#include <cstdint>
+#include <future>
 #include <memory>
 
+static const std::chrono::seconds TIMER_INTERVAL(1);
+static const std::chrono::seconds PING_INTERVAL(10);
+static const std::chrono::seconds IDLE_TIMEOUT(30);
+
+// Unreachable peers are common, so outbound connections are only given a moment to be accepted.
+static const std::chrono::seconds OUTBOUND_CONNECT_TIMEOUT(2);
+
+// Caps the number of messages handled per readiness notification, so one busy peer can't monopolize a reactor thread.
+static const size_t MAX_MESSAGES_PER_WAKEUP = 16;
+
+// Caps the bytes coalesced into a single write, once the first queued message is included.
+static const size_t SEND_BUDGET_BYTES = 256 * 1024;
+
 void Connection::Disconnect(const bool wait)
 {
 	m_terminate = true;
-	if (wait) {
+
+	if (m_connectionThread.get_id() == std::this_thread::get_id()) {
+		ThreadUtil::Detach(m_connectionThread);
+	} else if (wait) {
 		ThreadUtil::Join(m_connectionThread);
-		m_connectedPeer.GetPeer()->SetConnected(false);
+	}
+
+	if (!m_started) {
+		if (wait) {
+			m_connectedPeer.GetPeer()->SetConnected(false);
+			m_pSocket.reset();
+		}
+
+		return;
+	}
+
+	auto pConnection = weak_from_this().lock();
+	if (pConnection == nullptr) {
+		// Being destroyed, so no handlers can still be outstanding.
+		Close();
 		m_pSocket.reset();
+	} else if (m_strand->running_in_this_thread()) {
+		// The handler that called this may still use the socket, so it's only released once the handler returns.
+		Close();
+		if (wait) {
+			asio::post(*m_strand, [pConnection]() { pConnection->m_pSocket.reset(); });
+		}
+	} else {
+		// The socket is released on the strand too, once Close has finished with it, however long that takes.
+		auto pClosed = std::make_shared<std::promise<void>>();
+		asio::post(*m_strand, [pConnection, pClosed, wait]() {
+			pConnection->Close();
+			if (wait) {
+				pConnection->m_pSocket.reset();
+			}
+
+			pClosed->set_value();
+		});
+
+		if (wait) {
+			pClosed->get_future().wait_for(std::chrono::seconds(5));
+		}
+	}
+
+	if (wait) {
+		m_connectedPeer.GetPeer()->SetConnected(false);
 	}
 }
 
@@ -43,7 +104,6 @@ Connection::Ptr Connection::CreateInbound(
 		pMessageProcessor
 	);
 	pConnection->m_connectionThread = std::thread(Thread_ProcessConnection, pConnection);
-	ThreadManagerAPI::SetThreadName(pConnection->m_connectionThread.get_id(), "PEER");
 	return pConnection;
 }
 
@@ -69,8 +129,8 @@ Connection::Ptr Connection::CreateOutbound(
 		pMessageProcessor
 	);
 
+	connectionManager.BeginDial();
 	pConnection->m_connectionThread = std::thread(Thread_ProcessConnection, pConnection);
-	ThreadManagerAPI::SetThreadName(pConnection->m_connectionThread.get_id(), "PEER");
 	return pConnection;
 }
 
@@ -86,51 +146,81 @@ bool Connection::IsConnectionActive() const
 
 void Connection::AddToSendQueue(const IMessage& message)
 {
-	m_sendQueue.push_back(message.Clone());
+	Enqueue(QueuedMessage{ message.Clone(), nullptr });
+}
+
+void Connection::AddToSendQueue(const SharedBytes& pSerializedMessage)
+{
+	Enqueue(QueuedMessage{ nullptr, pSerializedMessage });
+}
+
+void Connection::Enqueue(QueuedMessage&& message)
+{
+	m_sendQueue.push(std::move(message));
+
+	// Before the connection is started, queued messages are flushed by Start().
+	if (m_started && !m_flushScheduled.exchange(true)) {
+		auto pConnection = weak_from_this().lock();
+		if (pConnection != nullptr) {
+			asio::post(*m_strand, [pConnection]() { pConnection->FlushSendQueue(); });
+		}
+	}
 }
 
 bool Connection::ExceedsRateLimit() const
 {
-	return m_pSocket->GetRateCounter().GetSentInLastMinute() > 500
-		|| m_pSocket->GetRateCounter().GetReceivedInLastMinute() > 500;
+	return m_rateLimiter.IsAbusive();
 }
 
 //
-// Continuously checks for messages to send and/or receive until the connection is terminated.
-// This function runs in its own thread.
+// Establishes the connection and performs the handshake, then hands the connection off to the reactor.
+// This function runs in its own short-lived thread.
 //
 void Connection::Thread_ProcessConnection(std::shared_ptr<Connection> pConnection)
 {
+	// Named by the thread itself, so its CPU time is tracked (see ThreadManagerAPI::GetThreadStats).
+	ThreadManagerAPI::SetCurrentThreadName("PEER");
+
+	const bool outbound = pConnection->m_connectedPeer.GetDirection() == EDirection::OUTBOUND;
+
+	bool added = false;
 	try
 	{
-		pConnection->Connect();
+		added = pConnection->Connect();
 	}
 	catch (const std::exception& e)
+	{
+		LOG_ERROR_F("Exception caught: {}", e);
+	}
+
+	if (outbound) {
+		pConnection->m_connectionManager.EndDial();
+	}
+
+	if (!added)
 	{
 		if (pConnection->m_pSocket->IsSocketOpen()) {
 			pConnection->m_pSocket->CloseSocket();
 		}
 
-        LOG_ERROR_F("Exception caught: {}", e);
-        pConnection->m_terminate = true;
+		pConnection->m_terminate = true;
 		ThreadUtil::Detach(pConnection->m_connectionThread);
 		return;
 	}
 
 	pConnection->GetPeer()->SetConnected(true);
-	pConnection->Run();
-	pConnection->GetSocket()->CloseSocket();
-	pConnection->GetPeer()->SetConnected(false);
+	pConnection->Start();
 }
 
-void Connection::Connect()
+bool Connection::Connect()
 {
 	EDirection direction = m_pSocket->IsSocketOpen() ? EDirection::INBOUND : EDirection::OUTBOUND;
 	if (direction == EDirection::OUTBOUND)
 	{
 		m_pContext = std::make_shared<asio::io_context>();
-		if (!m_pSocket->Connect(m_pContext)) {
-			throw std::exception();
+		if (!m_pSocket->Connect(m_pContext, OUTBOUND_CONNECT_TIMEOUT, m_config.GetP2PConfig().GetBindIP())) {
+			LOG_TRACE_F("Failed to connect to {}", m_pSocket->GetSocketAddress());
+			return false;
 		}
 	}
 
@@ -140,110 +230,392 @@ void Connection::Connect()
 	}
 
 	LOG_DEBUG("Successful Handshake");
-	m_connectionManager.AddConnection(shared_from_this());
+
+	// The seeder dials more peers than it needs, so the ones that finish their handshake after the minimum is reached are dropped.
+	const size_t maxOutbound = direction == EDirection::OUTBOUND ? (size_t)m_config.GetP2PConfig().GetMinConnections() : SIZE_MAX;
+	if (!m_connectionManager.AddConnection(shared_from_this(), maxOutbound)) {
+		LOG_DEBUG_F("Enough outbound connections. Dropping {}", m_pSocket->GetSocketAddress());
+		return false;
+	}
+
 	SendMsg(GetPeerAddressesMessage(Capabilities::ECapability::FAST_SYNC_NODE));
+	return true;
 }
 
-void Connection::Run()
+//
+// Moves the socket onto the reactor, and starts waiting for messages and timer ticks.
+//
+void Connection::Start()
 {
-	auto lastPingTime = std::chrono::system_clock::now();
-	auto lastReceivedMessageTime = std::chrono::system_clock::now();
+	const std::shared_ptr<asio::io_context>& pReactorContext = m_connectionManager.GetReactor()->GetContext();
+	if (!m_pSocket->Attach(pReactorContext)) {
+		LOG_WARNING_F("Failed to register {} with the reactor", *this);
+		m_terminate = true;
+		m_pSocket->CloseSocket();
+		GetPeer()->SetConnected(false);
+		return;
+	}
 
-	while (!m_terminate && !GetPeer()->IsBanned())
+	m_pTimer = std::make_unique<asio::steady_timer>(*pReactorContext);
+	m_strand.emplace(asio::make_strand(pReactorContext->get_executor()));
+	m_lastPingTime = std::chrono::steady_clock::now();
+	m_lastReceivedTime = std::chrono::steady_clock::now();
+	m_started = true;
+
+	auto pConnection = shared_from_this();
+	asio::post(*m_strand, [pConnection]() {
+		if (pConnection->m_terminate) {
+			pConnection->Close();
+			return;
+		}
+
+		pConnection->WaitForData();
+		pConnection->ScheduleTimer();
+		pConnection->FlushSendQueue();
+	});
+}
+
+void Connection::WaitForData()
+{
+	auto pConnection = shared_from_this();
+
+	// Messages the socket already read ahead won't make it readable again, so they're handled right away.
+	if (m_pSocket->HasBufferedData()) {
+		asio::post(*m_strand, [pConnection]() { pConnection->OnDataReceived(asio::error_code()); });
+		return;
+	}
+
+	m_pSocket->AsyncWaitForData(asio::bind_executor(
+		*m_strand,
+		[pConnection](const asio::error_code& ec) { pConnection->OnDataReceived(ec); }
+	));
+}
+
+void Connection::OnDataReceived(const asio::error_code& ec)
+{
+	if (m_terminate || GetPeer()->IsBanned()) {
+		Close();
+		return;
+	}
+
+	if (ec) {
+		LOG_DEBUG_F("Failed waiting for data from {}: {}", *this, ec.message());
+		Close();
+		return;
+	}
+
+	try
 	{
+		// A readable socket with nothing to read means the peer closed the connection.
+		if (m_pSocket->GetNumBytesAvailable() == 0) {
+			LOG_DEBUG_F("{} closed the connection", *this);
+			Close();
+			return;
+		}
+
+		const MessageRetriever retriever(m_config, m_pBufferPool);
+		for (size_t i = 0; i < MAX_MESSAGES_PER_WAKEUP && !m_terminate && !m_readsSuspended; i++)
+		{
+			// Whatever part of a message has arrived is kept until the rest does, so a slow peer never holds up the reactor.
+			// One that never finishes its message is dropped by the idle timeout.
+			std::unique_ptr<RawMessage> pRawMessage = retriever.ContinueMessage(*m_pSocket, *GetPeer(), m_partialMessage);
+			if (pRawMessage == nullptr) {
+				break;
+			}
+
+			m_lastReceivedTime = std::chrono::steady_clock::now();
+
+			auto pMessageProcessor = m_pMessageProcessor.lock();
+			if (pMessageProcessor != nullptr) {
+				// Nothing more is read until the handler has read the rest from the socket, and called ResumeReading.
+				m_readsSuspended = MessageDispatcher::ReadsFromSocket(pRawMessage->GetMessageHeader().GetMessageType());
+				pMessageProcessor->ReceiveMessage(shared_from_this(), std::move(pRawMessage));
+			}
+		}
+
 		if (ExceedsRateLimit()) {
 			LOG_WARNING_F("Banning peer ({}) for exceeding rate limit.", GetIPAddress());
 			GetPeer()->Ban(EBanReason::Abusive);
-			break;
+			Close();
+			return;
 		}
+	}
+	catch (const DeserializationException&)
+	{
+		LOG_ERROR("Deserialization exception occurred");
+		Close();
+		return;
+	}
+	catch (const SocketException&)
+	{
+#ifdef _WIN32
+		const int lastError = WSAGetLastError();
 
-		auto now = std::chrono::system_clock::now();
-		if (lastPingTime + std::chrono::seconds(10) < now) {
-			uint64_t block_difficulty = m_pSyncStatus->GetBlockDifficulty();
-			uint64_t block_height = m_pSyncStatus->GetBlockHeight();
-			AddToSendQueue(PingMessage{ block_difficulty, block_height });
+		TCHAR* s = NULL;
+		FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
+			NULL, lastError, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR)&s, 0, NULL);
 
-			lastPingTime = now;
-		}
+		const std::string errorMessage = StringUtil::ToUTF8(s);
+		LOG_DEBUG("Socket exception occurred: " + errorMessage);
 
-		try
-		{
-			bool messageSentOrReceived = false;
-
-			// Check for received messages and if there is a new message, process it.
-			std::unique_ptr<RawMessage> pRawMessage = MessageRetriever(m_config).RetrieveMessage(
-				*m_pSocket,
-				*GetPeer(),
-				Socket::NON_BLOCKING
-			);
-
-			if (pRawMessage != nullptr) {
-				auto pMessageProcessor = m_pMessageProcessor.lock();
-				if (pMessageProcessor != nullptr) {
-					pMessageProcessor->ProcessMessage(*this, *pRawMessage);
-				}
+		LocalFree(s);
+#endif
+		Close();
+		return;
+	}
+	catch (const std::exception& e)
+	{
+		LOG_ERROR("Unknown exception occurred: " + std::string(e.what()));
+		Close();
+		return;
+	}
+	catch (...)
+	{
+		LOG_ERROR("Unknown error occurred.");
+		Close();
+		return;
+	}
 
-				lastReceivedMessageTime = std::chrono::system_clock::now();
-				messageSentOrReceived = true;
-			}
+	FlushSendQueue();
 
-			// Send the next message in the queue, if one exists.
-			auto pMessageToSend = m_sendQueue.copy_front();
-			if (pMessageToSend != nullptr) {
-				IMessagePtr pMessage = *pMessageToSend;
-				m_sendQueue.pop_front(1);
-				SendMsg(*pMessage);
-				messageSentOrReceived = true;
-			}
+	if (m_terminate || GetPeer()->IsBanned()) {
+		Close();
+	} else if (!m_readsSuspended) {
+		WaitForData();
+	}
+}
+
+void Connection::ScheduleTimer()
+{
+	auto pConnection = shared_from_this();
+	m_pTimer->expires_after(TIMER_INTERVAL);
+	m_pTimer->async_wait(asio::bind_executor(
+		*m_strand,
+		[pConnection](const asio::error_code& ec) { pConnection->OnTimer(ec); }
+	));
+}
+
+void Connection::OnTimer(const asio::error_code& ec)
+{
+	if (m_terminate || GetPeer()->IsBanned() || ec) {
+		Close();
+		return;
+	}
+
+	if (ExceedsRateLimit()) {
+		LOG_WARNING_F("Banning peer ({}) for exceeding rate limit.", GetIPAddress());
+		GetPeer()->Ban(EBanReason::Abusive);
+		Close();
+		return;
+	}
+
+	// While a handler is reading from the socket itself (eg. a txhashset download), its own reads time out instead.
+	auto now = std::chrono::steady_clock::now();
+	if (!m_readsSuspended && m_lastReceivedTime + IDLE_TIMEOUT < now) {
+		LOG_DEBUG_F("No messages received from {} in {}s", *this, IDLE_TIMEOUT.count());
+		Close();
+		return;
+	}
+
+	if (m_lastPingTime + PING_INTERVAL < now) {
+		uint64_t block_difficulty = m_pSyncStatus->GetBlockDifficulty();
+		uint64_t block_height = m_pSyncStatus->GetBlockHeight();
+		AddToSendQueue(PingMessage{ block_difficulty, block_height });
+
+		m_lastPingTime = now;
+	}
+
+	ScheduleTimer();
+}
+
+//
+// Serializes queued messages, and sends them with a single gathered write.
+// At least one message is sent, but no more than SEND_BUDGET_BYTES are added after that, so a run of large messages
+// (eg. blocks being served) is split across several strand turns instead of holding up reads, pings, and other peers.
+// Must be called from the strand.
+//
+void Connection::FlushSendQueue()
+{
+	// Exchanged (rather than stored) so this synchronizes with the producer that scheduled the flush,
+	// making sure its push is visible to try_pop below.
+	m_flushScheduled.exchange(false);
+
+	try
+	{
+		std::vector<SharedBytes> serializedMessages;
+		size_t numBytes = 0;
+
+		QueuedMessage messageToSend;
+		while (!m_terminate && (serializedMessages.empty() || numBytes < SEND_BUDGET_BYTES) && m_sendQueue.try_pop(messageToSend)) {
+			if (messageToSend.pSerialized != nullptr) {
+				// Serialized once for many peers, so counted here rather than in Serialize.
+				const std::vector<uint8_t>& serialized = *messageToSend.pSerialized;
+				if (serialized.size() >= P2PMetrics::HEADER_SIZE) {
+					P2PMetrics::OnMessageSent((MessageTypes::EMessageType)serialized[2], serialized.size());
+					m_connectedPeer.GetStats().OnMessageSent(serialized[2], serialized.size());
+				}
 
-			if (!messageSentOrReceived) {
-				if ((lastReceivedMessageTime + std::chrono::seconds(30)) < std::chrono::system_clock::now()) {
-					break;
+				std::unique_ptr<std::vector<uint8_t>> pCompressed = Compress(serialized);
+				if (pCompressed != nullptr) {
+					messageToSend.pSerialized = std::move(pCompressed);
 				}
 
-				ThreadUtil::SleepFor(std::chrono::milliseconds(5), m_terminate);
+				serializedMessages.emplace_back(std::move(messageToSend.pSerialized));
+			} else {
+				serializedMessages.emplace_back(std::make_shared<const std::vector<uint8_t>>(Serialize(*messageToSend.pMessage)));
 			}
+
+			numBytes += serializedMessages.back()->size();
+			messageToSend = QueuedMessage{};
 		}
-		catch (const DeserializationException&)
-		{
-			LOG_ERROR("Deserialization exception occurred");
-			break;
+
+		if (!serializedMessages.empty()) {
+			GetSocket()->Send(serializedMessages, true);
 		}
-		catch (const SocketException&)
-		{
-#ifdef _WIN32
-			const int lastError = WSAGetLastError();
 
-			TCHAR* s = NULL;
-			FormatMessage(FORMAT_MESSAGE_ALLOCATE_BUFFER | FORMAT_MESSAGE_FROM_SYSTEM | FORMAT_MESSAGE_IGNORE_INSERTS,
-				NULL, lastError, MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), (LPTSTR)&s, 0, NULL);
+		// Anything left over gets its own turn on the strand.
+		if (!m_sendQueue.empty() && !m_terminate && !m_flushScheduled.exchange(true)) {
+			auto pConnection = shared_from_this();
+			asio::post(*m_strand, [pConnection]() { pConnection->FlushSendQueue(); });
+		}
+	}
+	catch (const std::exception& e)
+	{
+		LOG_DEBUG_F("Failed to send to {}: {}", *this, e.what());
+		Close();
+	}
+}
 
-			const std::string errorMessage = StringUtil::ToUTF8(s);
-			LOG_DEBUG("Socket exception occurred: " + errorMessage);
+//
+// Cancels the timer and any pending wait, and closes the socket.
+// Must be called from the strand, or once no handlers can be outstanding.
+//
+void Connection::Close()
+{
+	m_terminate = true;
+	if (m_closed.exchange(true)) {
+		return;
+	}
 
-			LocalFree(s);
-#endif
-			break;
-		}
-		catch (const std::exception& e)
-		{
-			LOG_ERROR("Unknown exception occurred: " + std::string(e.what()));
-			break;
+	try
+	{
+		if (m_pTimer != nullptr) {
+			m_pTimer->cancel();
 		}
-		catch (...)
-		{
-			LOG_ERROR("Unknown error occurred.");
-			break;
+
+		if (m_pSocket != nullptr) {
+			m_pSocket->Cancel();
+			m_pSocket->CloseSocket();
 		}
 	}
+	catch (const std::exception& e)
+	{
+		LOG_DEBUG_F("Exception thrown while closing {}: {}", *this, e.what());
+	}
+
+	// Remembered, so the next connection to a new peer can prefer the ones that were fast.
+	const double throughputScore = m_connectedPeer.GetStats().GetThroughputScore();
+	if (throughputScore > 0.0) {
+		GetPeer()->UpdateThroughputScore(throughputScore);
+	}
+
+	GetPeer()->SetConnected(false);
+}
+
+bool Connection::AddKnownInventory(const Hash& hash)
+{
+	std::unique_lock<std::mutex> lock(m_inventoryMutex);
+	if (m_knownInventory.Contains(hash))
+	{
+		return false;
+	}
+
+	m_knownInventory.Insert(hash);
+	return true;
 }
 
 bool Connection::SendMsg(const IMessage& message)
+{
+	// Once started, the socket is only written to from the strand, so messages sent from anywhere else
+	// (eg. by handlers running on the thread pool) are queued instead.
+	if (m_started && !m_strand->running_in_this_thread()) {
+		AddToSendQueue(message);
+		return true;
+	}
+
+	return GetSocket()->Send(Serialize(message), true);
+}
+
+void Connection::Post(std::function<void(Connection&)>&& handler)
+{
+	if (!m_started) {
+		return;
+	}
+
+	auto pConnection = shared_from_this();
+	asio::post(*m_strand, [pConnection, handler = std::move(handler)]() {
+		if (!pConnection->m_terminate) {
+			handler(*pConnection);
+		}
+	});
+}
+
+void Connection::PostAfter(const std::chrono::milliseconds& delay, std::function<void(Connection&)>&& handler)
+{
+	if (!m_started) {
+		return;
+	}
+
+	auto pConnection = shared_from_this();
+	auto pTimer = std::make_shared<asio::steady_timer>(*m_connectionManager.GetReactor()->GetContext(), delay);
+	pTimer->async_wait(asio::bind_executor(
+		*m_strand,
+		[pConnection, pTimer, handler = std::move(handler)](const asio::error_code& ec) {
+			if (!ec && !pConnection->m_terminate) {
+				handler(*pConnection);
+			}
+		}
+	));
+}
+
+void Connection::ResumeReading()
+{
+	if (!m_started) {
+		return;
+	}
+
+	auto pConnection = shared_from_this();
+	asio::post(*m_strand, [pConnection]() {
+		pConnection->m_readsSuspended = false;
+		pConnection->m_lastReceivedTime = std::chrono::steady_clock::now();
+
+		if (pConnection->m_terminate) {
+			pConnection->Close();
+		} else {
+			pConnection->WaitForData();
+		}
+	});
+}
+
+std::vector<uint8_t> Connection::Serialize(const IMessage& message) const
 {
 	std::vector<uint8_t> serialized_message = message.Serialize(
 		m_config.GetEnvironment(),
 		GetProtocolVersion()
 	);
+	P2PMetrics::OnMessageSent(message.GetMessageType(), serialized_message.size());
+
+	// Requests are timed from when they're serialized, which is just before they're written.
+	PeerStats& stats = m_connectedPeer.GetStats();
+	stats.OnMessageSent((uint8_t)message.GetMessageType(), serialized_message.size());
+	if (message.GetMessageType() == MessageTypes::Ping) {
+		stats.OnPingSent();
+	} else if (message.GetMessageType() == MessageTypes::GetHeaders) {
+		stats.OnHeadersRequested();
+	} else if (message.GetMessageType() == MessageTypes::GetBlock) {
+		stats.OnBlockRequested(dynamic_cast<const GetBlockMessage&>(message).GetHash());
+	}
+
 	if (message.GetMessageType() != MessageTypes::Ping && message.GetMessageType() != MessageTypes::Pong) {
 		LOG_TRACE_F(
 			"Sending {}b '{}' message to {}",
@@ -253,7 +625,21 @@ bool Connection::SendMsg(const IMessage& message)
 		);
 	}
 
-	return GetSocket()->Send(serialized_message, true);
+	std::unique_ptr<std::vector<uint8_t>> pCompressed = Compress(serialized_message);
+	if (pCompressed != nullptr) {
+		return std::move(*pCompressed);
+	}
+
+	return serialized_message;
+}
+
+std::unique_ptr<std::vector<uint8_t>> Connection::Compress(const std::vector<uint8_t>& serializedMessage) const
+{
+	if (!GetCapabilities().HasCapability(Capabilities::COMPRESSION)) {
+		return nullptr;
+	}
+
+	return MessageCompressor::Compress(serializedMessage);
 }
 
 void Connection::BanPeer(const EBanReason reason)
@@ -1,26 +1,38 @@
 #pragma once
 
 #include "Messages/Message.h"
+#include "MessageBufferPool.h"
+#include "MessageRetriever.h"
+#include "MessageRateLimiter.h"
+#include "RollingBloomFilter.h"
 
 #include <Core/Enums/ProtocolVersion.h>
-#include <Common/ConcurrentQueue.h>
+#include <Common/MPSCQueue.h>
 #include <Net/Socket.h>
 #include <P2P/ConnectedPeer.h>
 #include <P2P/SyncStatus.h>
 #include <Config/Config.h>
 #include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <queue>
 
 // Forward Declarations
 class IMessage;
 class ConnectionManager;
 class MessageProcessor;
-class MessageRetriever;
+
+typedef std::shared_ptr<const std::vector<uint8_t>> SharedBytes;
 
 //
 // A Connection will be created for each ConnectedPeer.
-// Each Connection will run on its own thread, and will watch the socket for messages,
-// and will ping the peer when it hasn't been heard from in a while.
+// The handshake is performed on a short-lived thread. Once established, the connection is driven by the
+// ConnectionManager's reactor: it waits for the socket to become readable, reads whatever part of a message has arrived
+// without waiting for the rest, hands complete messages to the MessageProcessor,
+// and uses a timer to ping the peer and drop it when it hasn't been heard from in a while.
+// All socket work for a connection is serialized on its own strand.
 //
 class Connection : public Traits::IPrintable, public std::enable_shared_from_this<Connection>
 {
@@ -42,7 +54,14 @@ public:
 		m_connectedPeer(connectedPeer),
 		m_pSyncStatus(pSyncStatus),
 		m_pMessageProcessor(pMessageProcessor),
-		m_terminate(false) { }
+		m_pBufferPool(MessageBufferPool::Create()),
+		m_knownInventory(KNOWN_INVENTORY_SIZE, KNOWN_INVENTORY_FP_RATE),
+		m_rateLimiter(config.GetP2PConfig()),
+		m_terminate(false),
+		m_started(false),
+		m_closed(false),
+		m_flushScheduled(false),
+		m_readsSuspended(false) { }
 
 	Connection(const Connection&) = delete;
 	Connection& operator=(const Connection&) = delete;
@@ -74,11 +93,49 @@ public:
 	bool IsConnectionActive() const;
 
 	void AddToSendQueue(const IMessage& message);
+
+	//
+	// Queues a message that was already serialized for this connection's protocol version.
+	// The bytes are shared rather than copied, so a single serialization can be queued on many connections.
+	//
+	void AddToSendQueue(const SharedBytes& pSerializedMessage);
 	bool SendMsg(const IMessage& message);
+
+	//
+	// Runs the handler on the connection's strand, where it may read from and write to the socket directly.
+	// Dropped if the connection isn't started, or has been closed by the time it would run.
+	//
+	void Post(std::function<void(Connection&)>&& handler);
+
+	//
+	// Like Post, but runs the handler once delay has passed.
+	//
+	void PostAfter(const std::chrono::milliseconds& delay, std::function<void(Connection&)>&& handler);
+
+	//
+	// The connection stops reading once it receives a message whose handler reads the rest from the socket itself
+	// (see MessageDispatcher::ReadsFromSocket). The handler calls this when it's done, to start reading messages again.
+	//
+	void ResumeReading();
+
+	//
+	// True once the peer has kept flooding us with messages beyond their per-type rate limits.
+	//
 	bool ExceedsRateLimit() const;
+
+	// Only accessed from the strand.
+	MessageRateLimiter& GetRateLimiter() { return m_rateLimiter; }
+
+	//
+	// Records that the peer has seen the kernel or block with the given hash, because it announced it, sent it, or we relayed it.
+	// Returns false if it was (probably) already known, in which case it doesn't need to be relayed to the peer again.
+	//
+	bool AddKnownInventory(const Hash& hash);
+
 	void BanPeer(const EBanReason reason);
 
 	SocketPtr GetSocket() const { return m_pSocket; }
+	const Config& GetConfig() const { return m_config; }
 	PeerPtr GetPeer() { return m_connectedPeer.GetPeer(); }
 	PeerConstPtr GetPeer() const { return m_connectedPeer.GetPeer(); }
 	const ConnectedPeer& GetConnectedPeer() const { return m_connectedPeer; }
@@ -94,16 +151,45 @@ public:
 private:
 	static void Thread_ProcessConnection(std::shared_ptr<Connection> pConnection);
 
-	void Connect();
-	void Run();
+	//
+	// Returns false if an outbound connection couldn't be established, or was no longer needed once it was.
+	// Throws if the handshake fails.
+	//
+	bool Connect();
+	void Start();
+
+	struct QueuedMessage
+	{
+		// Exactly one of these is set.
+		IMessagePtr pMessage;
+		SharedBytes pSerialized;
+	};
+
+	void Enqueue(QueuedMessage&& message);
+	void WaitForData();
+	void OnDataReceived(const asio::error_code& ec);
+	void ScheduleTimer();
+	void OnTimer(const asio::error_code& ec);
+	void FlushSendQueue();
+	std::vector<uint8_t> Serialize(const IMessage& message) const;
+
+	//
+	// Returns the message compressed for sending, or nullptr if the peer doesn't accept compressed messages or it's not worth compressing.
+	//
+	std::unique_ptr<std::vector<uint8_t>> Compress(const std::vector<uint8_t>& serializedMessage) const;
+	void Close();
 
 	const Config& m_config;
 	ConnectionManager& m_connectionManager;
 	SyncStatusConstPtr m_pSyncStatus;
 
 	std::weak_ptr<MessageProcessor> m_pMessageProcessor;
+	MessageBufferPool::Ptr m_pBufferPool;
 
 	std::atomic<bool> m_terminate;
+	std::atomic<bool> m_started;
+	std::atomic<bool> m_closed;
+	std::atomic<bool> m_flushScheduled;
 	std::thread m_connectionThread;
 	const uint64_t m_connectionId;
 
@@ -112,7 +198,24 @@ private:
 	std::shared_ptr<asio::io_context> m_pContext;
 	mutable SocketPtr m_pSocket;
 
-	ConcurrentQueue<IMessagePtr> m_sendQueue;
+	// Only valid once started. Everything below is only accessed from the strand.
+	std::optional<asio::strand<asio::io_context::executor_type>> m_strand;
+	std::unique_ptr<asio::steady_timer> m_pTimer;
+	std::chrono::steady_clock::time_point m_lastPingTime;
+	std::chrono::steady_clock::time_point m_lastReceivedTime;
+	MessageRetriever::PartialMessage m_partialMessage;
+	bool m_readsSuspended;
+
+	// Kernel and block hashes the peer is known to have seen.
+	static constexpr size_t KNOWN_INVENTORY_SIZE = 20'000;
+	static constexpr double KNOWN_INVENTORY_FP_RATE = 0.000001;
+	mutable std::mutex m_inventoryMutex;
+	RollingBloomFilter m_knownInventory;
+
+	MessageRateLimiter m_rateLimiter;
+
+	// Written by any thread, drained only by FlushSendQueue on the strand.
+	MPSCQueue<QueuedMessage> m_sendQueue;
 };
 
 typedef std::shared_ptr<Connection> ConnectionPtr;
\ No newline at end of file
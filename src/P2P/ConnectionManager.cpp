@@ -4,9 +4,12 @@
 #include "Seed/Seeder.h"
 #include "Messages/GetPeerAddressesMessage.h"
 #include "Messages/PingMessage.h"
+#include "Messages/HeaderMessage.h"
+#include "Messages/CompactBlockMessage.h"
 
 #include <thread>
 #include <chrono>
+#include <map>
 #include <Common/ShutdownManager.h>
 #include <Common/ThreadManager.h>
 #include <Common/Logger.h>
@@ -14,11 +17,14 @@
 #include <Common/Util/StringUtil.h>
 #include <Common/Util/ThreadUtil.h>
 #include <Crypto/CSPRNG.h>
+#include <algorithm>
 
 ConnectionManager::ConnectionManager()
 	: m_connections(std::make_shared<std::vector<ConnectionPtr>>()),
+	m_pReactor(ConnectionReactor::Create()),
 	m_numOutbound(0),
-	m_numInbound(0)
+	m_numInbound(0),
+	m_numDialing(0)
 {
 
 }
@@ -35,6 +41,9 @@ void ConnectionManager::Shutdown()
 		ThreadUtil::Join(m_broadcastThread);
 
 		PruneConnections(false);
+
+		// Stopped only after every connection is closed, so their handlers can unwind.
+		m_pReactor->Stop();
 	}
 	catch (const std::exception& e)
 	{
@@ -55,7 +64,7 @@ std::shared_ptr<ConnectionManager> ConnectionManager::Create()
 
 void ConnectionManager::UpdateSyncStatus(SyncStatus& syncStatus) const
 {
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 
 	ConnectionPtr pMostWorkPeer = GetMostWorkPeer(*connections);
 	if (pMostWorkPeer != nullptr)
@@ -70,7 +79,7 @@ void ConnectionManager::UpdateSyncStatus(SyncStatus& syncStatus) const
 
 bool ConnectionManager::IsConnected(const IPAddress& address) const
 {
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 	return std::any_of(
 		connections->cbegin(),
 		connections->cend(),
@@ -85,19 +94,26 @@ std::vector<PeerPtr> ConnectionManager::GetMostWorkPeers() const
 {
 	std::vector<PeerPtr> mostWorkPeers;
 
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 
 	ConnectionPtr pMostWorkPeer = GetMostWorkPeer(*connections);
 	if (pMostWorkPeer != nullptr)
 	{
 		const uint64_t totalDifficulty = pMostWorkPeer->GetTotalDifficulty();
+		std::vector<ConnectionPtr> mostWorkConnections;
 		for (ConnectionPtr pConnection : *connections)
 		{
 			if (pConnection->GetTotalDifficulty() >= totalDifficulty && pConnection->GetHeight() > 0)
 			{
-				mostWorkPeers.push_back(pConnection->GetPeer());
+				mostWorkConnections.push_back(pConnection);
 			}
 		}
+
+		// Fastest first, so callers that go down the list try the fastest peers first.
+		for (const ConnectionPtr& pConnection : RankBySpeed(mostWorkConnections))
+		{
+			mostWorkPeers.push_back(pConnection->GetPeer());
+		}
 	}
 
 	return mostWorkPeers;
@@ -105,7 +121,7 @@ std::vector<PeerPtr> ConnectionManager::GetMostWorkPeers() const
 
 std::vector<ConnectedPeer> ConnectionManager::GetConnectedPeers() const
 {
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 
 	std::vector<ConnectedPeer> connectedPeers;
 	std::transform(
@@ -120,7 +136,7 @@ std::vector<ConnectedPeer> ConnectionManager::GetConnectedPeers() const
 
 std::optional<std::pair<uint64_t, ConnectedPeer>> ConnectionManager::GetConnectedPeer(const IPAddress& address) const
 {
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 
 	for (ConnectionPtr pConnection : *connections)
 	{
@@ -136,7 +152,7 @@ std::optional<std::pair<uint64_t, ConnectedPeer>> ConnectionManager::GetConnecte
 
 uint64_t ConnectionManager::GetMostWork() const
 {
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 	ConnectionPtr pConnection = GetMostWorkPeer(*connections);
 	if (pConnection != nullptr)
 	{
@@ -148,7 +164,7 @@ uint64_t ConnectionManager::GetMostWork() const
 
 uint64_t ConnectionManager::GetHighestHeight() const
 {
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 	ConnectionPtr pConnection = GetMostWorkPeer(*connections);
 	if (pConnection != nullptr)
 	{
@@ -160,7 +176,7 @@ uint64_t ConnectionManager::GetHighestHeight() const
 
 PeerPtr ConnectionManager::SendMessageToMostWorkPeer(const IMessage& message)
 {
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 	ConnectionPtr pConnection = GetMostWorkPeer(*connections);
 	if (pConnection != nullptr)
 	{
@@ -173,7 +189,7 @@ PeerPtr ConnectionManager::SendMessageToMostWorkPeer(const IMessage& message)
 
 bool ConnectionManager::SendMessageToPeer(const IMessage& message, PeerConstPtr pPeer)
 {
-	auto connections = m_connections.Read();
+	auto connections = m_connections.ScopedRead();
 	for (auto pConnection : *connections)
 	{
 		if (pConnection->GetIPAddress() == pPeer->GetIPAddress())
@@ -191,17 +207,44 @@ void ConnectionManager::BroadcastMessage(const IMessage& message, const uint64_t
 	m_sendQueue.push_back(MessageToBroadcast(sourceId, message.Clone()));
 }
 
-void ConnectionManager::AddConnection(ConnectionPtr pConnection)
+void ConnectionManager::BroadcastBlock(const HeaderMessage& headerMessage, const CompactBlockMessage& compactBlockMessage, const uint64_t sourceId)
+{
+	m_sendQueue.push_back(MessageToBroadcast(sourceId, headerMessage.Clone(), compactBlockMessage.Clone()));
+}
+
+bool ConnectionManager::AddConnection(ConnectionPtr pConnection, const size_t maxOutbound)
 {
+	auto connectionsWriter = m_connections.ScopedWrite();
+	if (pConnection->GetConnectedPeer().GetDirection() == EDirection::OUTBOUND)
+	{
+		const size_t numOutbound = std::count_if(
+			connectionsWriter->cbegin(),
+			connectionsWriter->cend(),
+			[](const ConnectionPtr& pExisting) { return pExisting->GetConnectedPeer().GetDirection() == EDirection::OUTBOUND; }
+		);
+		if (numOutbound >= maxOutbound)
+		{
+			return false;
+		}
+
+		// PruneConnections recounts these, but the seeder shouldn't have to wait for it to see the new connection.
+		m_numOutbound = numOutbound + 1;
+	}
+	else
+	{
+		++m_numInbound;
+	}
+
 	LOG_DEBUG_F("Adding connection: {}", pConnection->GetPeer());
-	m_connections.Write()->emplace_back(pConnection);
+	connectionsWriter->emplace_back(pConnection);
+	return true;
 }
 
 void ConnectionManager::PruneConnections(const bool bInactiveOnly)
 {
 	std::vector<ConnectionPtr> connectionsToClose;
 	{
-		auto connectionsWriter = m_connections.Write();
+		auto connectionsWriter = m_connections.ScopedWrite();
 		std::vector<ConnectionPtr>& connections = *connectionsWriter;
 
 		for (int i = (int)connections.size() - 1; i >= 0; i--)
@@ -290,34 +333,193 @@ ConnectionPtr ConnectionManager::GetMostWorkPeer(const std::vector<ConnectionPtr
 		return nullptr;
 	}
 
-	const size_t index = CSPRNG::GenerateRandom(0, mostWorkPeers.size() - 1);
+	// Random among the faster half, so the fastest peer isn't given every request.
+	mostWorkPeers = RankBySpeed(mostWorkPeers);
+	const size_t index = CSPRNG::GenerateRandom(0, (mostWorkPeers.size() - 1) / 2);
 
 	return mostWorkPeers[index];
 }
 
+//
+// Sorts by PeerStats::GetThroughputScore, fastest first.
+// Peers that haven't delivered a block yet are ranked after those that have, by ping round trip.
+//
+std::vector<ConnectionPtr> ConnectionManager::RankBySpeed(const std::vector<ConnectionPtr>& connections)
+{
+	struct Ranked
+	{
+		ConnectionPtr pConnection;
+		double score;
+		int64_t rttMicros;
+	};
+
+	std::vector<Ranked> ranked;
+	ranked.reserve(connections.size());
+	for (const ConnectionPtr& pConnection : connections)
+	{
+		const PeerStats& stats = pConnection->GetConnectedPeer().GetStats();
+		const std::optional<std::chrono::microseconds> rtt = stats.GetPingRtt();
+		ranked.push_back(Ranked{
+			pConnection,
+			stats.GetThroughputScore(),
+			rtt.has_value() ? rtt.value().count() : INT64_MAX
+		});
+	}
+
+	std::stable_sort(ranked.begin(), ranked.end(), [](const Ranked& left, const Ranked& right) {
+		if (left.score != right.score)
+		{
+			return left.score > right.score;
+		}
+
+		return left.rttMicros < right.rttMicros;
+	});
+
+	std::vector<ConnectionPtr> sorted;
+	sorted.reserve(ranked.size());
+	for (const Ranked& entry : ranked)
+	{
+		sorted.push_back(entry.pConnection);
+	}
+
+	return sorted;
+}
+
+//
+// Disconnects the outbound peer with the lowest throughput score, when it's below SLOW_PEER_RATIO of the median,
+// so the seeder replaces it with a new peer. Only peers that have delivered blocks are compared, and only once
+// there are at least MIN_PEERS_TO_ROTATE of them. Returns true if a peer was disconnected.
+//
+bool ConnectionManager::DisconnectSlowestPeer()
+{
+	ConnectionPtr pSlowest = nullptr;
+	{
+		auto connectionsWriter = m_connections.ScopedWrite();
+		std::vector<ConnectionPtr>& connections = *connectionsWriter;
+
+		std::vector<ConnectionPtr> measured;
+		for (const ConnectionPtr& pConnection : connections)
+		{
+			if (pConnection->GetConnectedPeer().GetDirection() == EDirection::OUTBOUND
+				&& pConnection->GetConnectedPeer().GetStats().GetThroughputScore() > 0.0)
+			{
+				measured.push_back(pConnection);
+			}
+		}
+
+		if (measured.size() < MIN_PEERS_TO_ROTATE)
+		{
+			return false;
+		}
+
+		const std::vector<ConnectionPtr> ranked = RankBySpeed(measured);
+		const double medianScore = ranked[ranked.size() / 2]->GetConnectedPeer().GetStats().GetThroughputScore();
+		const double slowestScore = ranked.back()->GetConnectedPeer().GetStats().GetThroughputScore();
+		if (slowestScore >= medianScore * SLOW_PEER_RATIO)
+		{
+			return false;
+		}
+
+		pSlowest = ranked.back();
+		LOG_INFO_F(
+			"Disconnecting slow peer {} ({:.0f} B/s, median {:.0f} B/s)",
+			pSlowest->GetIPAddress(),
+			slowestScore,
+			medianScore
+		);
+
+		connections.erase(std::find(connections.begin(), connections.end(), pSlowest));
+		--m_numOutbound;
+	}
+
+	pSlowest->Disconnect(true);
+	return true;
+}
+
+//
+// Returns the ids of up to HIGH_BANDWIDTH_PEERS connections that advertise Capabilities::COMPACT_BLOCK_PUSH, lowest ping round trip first.
+// Peers that haven't answered a ping yet are only chosen when there aren't enough that have.
+//
+std::vector<uint64_t> ConnectionManager::SelectPushPeers(const std::vector<ConnectionPtr>& connections, const uint64_t sourceId)
+{
+	std::vector<std::pair<int64_t, uint64_t>> candidates;
+	for (const ConnectionPtr& pConnection : connections)
+	{
+		if (pConnection->GetId() != sourceId && pConnection->GetCapabilities().HasCapability(Capabilities::COMPACT_BLOCK_PUSH))
+		{
+			const std::optional<std::chrono::microseconds> rtt = pConnection->GetConnectedPeer().GetStats().GetPingRtt();
+			candidates.push_back({ rtt.has_value() ? rtt.value().count() : INT64_MAX, pConnection->GetId() });
+		}
+	}
+
+	const size_t numPeers = (std::min)(candidates.size(), HIGH_BANDWIDTH_PEERS);
+	std::partial_sort(candidates.begin(), candidates.begin() + numPeers, candidates.end());
+
+	std::vector<uint64_t> peerIds;
+	for (size_t i = 0; i < numPeers; i++)
+	{
+		peerIds.push_back(candidates[i].second);
+	}
+
+	return peerIds;
+}
+
 void ConnectionManager::Thread_Broadcast(ConnectionManager& connectionManager)
 {
 	while (!ShutdownManagerAPI::WasShutdownRequested()) 
 	{
-		std::unique_ptr<MessageToBroadcast> pBroadcastMessage = connectionManager.m_sendQueue.copy_front();
-		if (pBroadcastMessage != nullptr)
+		MessageToBroadcast broadcastMessage;
+		if (connectionManager.m_sendQueue.pop(broadcastMessage, std::chrono::milliseconds(100)))
 		{
-			connectionManager.m_sendQueue.pop_front(1);
-			LOG_DEBUG_F("Broadcasting message: {}", MessageTypes::ToString(pBroadcastMessage->m_pMessage->GetMessageType()));
+			LOG_DEBUG_F("Broadcasting message: {}", MessageTypes::ToString(broadcastMessage.m_pMessage->GetMessageType()));
 
 			// TODO: This should only broadcast to 8(?) peers. Should maybe be configurable.
-			auto pConnections = connectionManager.m_connections.Read();
+			// The message is serialized once per protocol version, and the bytes are shared by every connection's queue.
+			std::map<EProtocolVersion, SharedBytes> serializedByVersion;
+			std::map<EProtocolVersion, SharedBytes> pushSerializedByVersion;
+
+			const std::optional<Hash> inventoryHash = broadcastMessage.m_pMessage->GetInventoryHash();
+			size_t numSkipped = 0;
+
+			auto pConnections = connectionManager.m_connections.ScopedRead();
+
+			std::vector<uint64_t> pushPeers;
+			if (broadcastMessage.m_pPushMessage != nullptr)
+			{
+				pushPeers = SelectPushPeers(*pConnections, broadcastMessage.m_sourceId);
+			}
+
 			for (ConnectionPtr pConnection : *pConnections)
 			{
-				if (pConnection->GetId() != pBroadcastMessage->m_sourceId)
+				if (pConnection->GetId() != broadcastMessage.m_sourceId)
 				{
-					pConnection->AddToSendQueue(*pBroadcastMessage->m_pMessage);
+					// Don't announce a kernel or block to a peer that already announced it to us, or that we've already told.
+					if (inventoryHash.has_value() && !pConnection->AddKnownInventory(inventoryHash.value()))
+					{
+						++numSkipped;
+						continue;
+					}
+
+					const EProtocolVersion version = pConnection->GetProtocolVersion();
+					const bool push = std::find(pushPeers.cbegin(), pushPeers.cend(), pConnection->GetId()) != pushPeers.cend();
+					const std::shared_ptr<IMessage>& pMessage = push ? broadcastMessage.m_pPushMessage : broadcastMessage.m_pMessage;
+
+					SharedBytes& pSerialized = (push ? pushSerializedByVersion : serializedByVersion)[version];
+					if (pSerialized == nullptr)
+					{
+						pSerialized = std::make_shared<const std::vector<uint8_t>>(
+							pMessage->Serialize(pConnection->GetConfig().GetEnvironment(), version)
+						);
+					}
+
+					pConnection->AddToSendQueue(pSerialized);
 				}
 			}
-		}
-		else
-		{
-			ThreadUtil::SleepFor(std::chrono::milliseconds(100), ShutdownManagerAPI::WasShutdownRequested());
+
+			if (numSkipped > 0)
+			{
+				LOG_TRACE_F("Skipped {} peers that had already seen {}", numSkipped, inventoryHash.value());
+			}
 		}
 	}
 }
\ No newline at end of file
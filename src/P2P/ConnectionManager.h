@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Connection.h"
+#include "ConnectionReactor.h"
 
 #include <Common/ConcurrentQueue.h>
 #include <Core/Traits/Lockable.h>
@@ -8,8 +9,13 @@
 #include <vector>
 #include <thread>
 #include <optional>
+#include <cstdint>
 #include <unordered_map>
 
+// Forward Declarations
+class HeaderMessage;
+class CompactBlockMessage;
+
 class ConnectionManager
 {
 public:
@@ -22,6 +28,14 @@ public:
 
 	size_t GetNumInbound() const { return m_numInbound; }
 	size_t GetNumOutbound() const { return m_numOutbound; }
+
+	//
+	// The number of outbound connections still connecting or handshaking.
+	// Counted by Connection, from CreateOutbound until the handshake completes or fails.
+	//
+	size_t GetNumDialing() const { return m_numDialing; }
+	void BeginDial() { ++m_numDialing; }
+	void EndDial() { --m_numDialing; }
 	size_t GetNumberOfActiveConnections() const { return m_connections.Read()->size(); }
 
 	bool IsConnected(const IPAddress& address) const;
@@ -35,33 +49,63 @@ public:
 	bool SendMessageToPeer(const IMessage& message, PeerConstPtr pPeer);
 	void BroadcastMessage(const IMessage& message, const uint64_t sourceId);
 
+	//
+	// Announces a newly accepted block. Up to HIGH_BANDWIDTH_PEERS of the lowest latency peers that advertise Capabilities::COMPACT_BLOCK_PUSH
+	// are sent the compact block right away, saving each hop the round trip to request it. Every other peer is sent the header.
+	//
+	void BroadcastBlock(const HeaderMessage& headerMessage, const CompactBlockMessage& compactBlockMessage, const uint64_t sourceId);
+
 	void PruneConnections(const bool bInactiveOnly);
-	void AddConnection(ConnectionPtr pConnection);
+	bool DisconnectSlowestPeer();
+
+	//
+	// Adds a connection that completed its handshake. Outbound connections are turned away once there are maxOutbound of them,
+	// so when more peers are dialed than needed, only the fastest to respond are kept. Returns whether the connection was added.
+	//
+	bool AddConnection(ConnectionPtr pConnection, const size_t maxOutbound = SIZE_MAX);
+
+	const ConnectionReactor::Ptr& GetReactor() const noexcept { return m_pReactor; }
 
 private:
 	ConnectionManager();
 
+	// Used by DisconnectSlowestPeer.
+	static constexpr size_t MIN_PEERS_TO_ROTATE = 4;
+	static constexpr double SLOW_PEER_RATIO = 0.25;
+
+	// Used by BroadcastBlock. Pushing to more peers than this mostly sends blocks the peers are already receiving from each other.
+	static constexpr size_t HIGH_BANDWIDTH_PEERS = 3;
+
 	ConnectionPtr GetMostWorkPeer(const std::vector<ConnectionPtr>& connections) const;
+	static std::vector<ConnectionPtr> RankBySpeed(const std::vector<ConnectionPtr>& connections);
+	static std::vector<uint64_t> SelectPushPeers(const std::vector<ConnectionPtr>& connections, const uint64_t sourceId);
 	static void Thread_Broadcast(ConnectionManager& connectionManager);
 	
 	Locked<std::vector<ConnectionPtr>> m_connections;
 
 	struct MessageToBroadcast
 	{
-		MessageToBroadcast(uint64_t sourceId, std::shared_ptr<IMessage> pMessage)
-			: m_sourceId(sourceId), m_pMessage(pMessage)
+		MessageToBroadcast() : m_sourceId(0) { }
+		MessageToBroadcast(uint64_t sourceId, std::shared_ptr<IMessage> pMessage, std::shared_ptr<IMessage> pPushMessage = nullptr)
+			: m_sourceId(sourceId), m_pMessage(pMessage), m_pPushMessage(pPushMessage)
 		{
 
 		}
 		uint64_t m_sourceId;
 		std::shared_ptr<IMessage> m_pMessage;
+
+		// Sent instead of m_pMessage to the peers chosen by SelectPushPeers, if set.
+		std::shared_ptr<IMessage> m_pPushMessage;
 	};
 
+	ConnectionReactor::Ptr m_pReactor;
+
 	ConcurrentQueue<MessageToBroadcast> m_sendQueue;
 	std::thread m_broadcastThread;
 
 	std::atomic<size_t> m_numOutbound;
 	std::atomic<size_t> m_numInbound;
+	std::atomic<size_t> m_numDialing;
 };
 
 typedef std::shared_ptr<ConnectionManager> ConnectionManagerPtr;
@@ -0,0 +1,65 @@
+#include "ConnectionReactor.h"
+
+#include <Common/Util/ThreadUtil.h>
+#include <Common/ThreadManager.h>
+#include <Common/Logger.h>
+#include <algorithm>
+
+ConnectionReactor::ConnectionReactor()
+	: m_pContext(std::make_shared<asio::io_context>()),
+	m_workGuard(asio::make_work_guard(*m_pContext))
+{
+
+}
+
+ConnectionReactor::~ConnectionReactor()
+{
+	Stop();
+}
+
+ConnectionReactor::Ptr ConnectionReactor::Create(const size_t numThreads)
+{
+	auto pReactor = std::shared_ptr<ConnectionReactor>(new ConnectionReactor());
+	for (size_t i = 0; i < (std::max)((size_t)1, numThreads); i++)
+	{
+		pReactor->m_threads.emplace_back(std::thread(Thread_Run, std::ref(*pReactor)));
+	}
+
+	LOG_INFO_F("Started {} P2P I/O threads", pReactor->m_threads.size());
+	return pReactor;
+}
+
+void ConnectionReactor::Stop()
+{
+	m_workGuard.reset();
+	m_pContext->stop();
+	ThreadUtil::JoinAll(m_threads);
+	m_threads.clear();
+}
+
+size_t ConnectionReactor::GetDefaultNumThreads()
+{
+	// Message handling is mostly bound by the chain and pool locks, so a few threads are enough for hundreds of peers.
+	// At least 2 are used, so one long-running message (eg. a TxHashSet download) can't stall every other peer.
+	return (std::min)((size_t)8, (std::max)((size_t)2, (size_t)std::thread::hardware_concurrency()));
+}
+
+void ConnectionReactor::Thread_Run(ConnectionReactor& reactor)
+{
+	ThreadManagerAPI::SetCurrentThreadName("P2P_IO");
+	LOG_TRACE("BEGIN");
+
+	while (!reactor.m_pContext->stopped())
+	{
+		try
+		{
+			reactor.m_pContext->run();
+		}
+		catch (const std::exception& e)
+		{
+			LOG_ERROR_F("Exception thrown: {}", e.what());
+		}
+	}
+
+	LOG_TRACE("END");
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <asio.hpp>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//
+// Drives the sockets of every established connection from a small, fixed pool of threads.
+// Connections register for readiness notifications and timers on the shared io_context,
+// so idle peers cost nothing, and a peer's messages are handled as soon as they arrive.
+//
+class ConnectionReactor
+{
+public:
+	using Ptr = std::shared_ptr<ConnectionReactor>;
+
+	static ConnectionReactor::Ptr Create(const size_t numThreads = GetDefaultNumThreads());
+	~ConnectionReactor();
+
+	void Stop();
+
+	const std::shared_ptr<asio::io_context>& GetContext() const noexcept { return m_pContext; }
+
+	static size_t GetDefaultNumThreads();
+
+private:
+	ConnectionReactor();
+
+	static void Thread_Run(ConnectionReactor& reactor);
+
+	std::shared_ptr<asio::io_context> m_pContext;
+	asio::executor_work_guard<asio::io_context::executor_type> m_workGuard;
+	std::vector<std::thread> m_threads;
+};
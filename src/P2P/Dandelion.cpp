@@ -5,19 +5,20 @@
 #include "Messages/StemTransactionMessage.h"
 
 #include <Common/Util/StringUtil.h>
-#include <Common/Util/ThreadUtil.h>
 #include <Crypto/CSPRNG.h>
-#include <Common/ThreadManager.h>
 #include <Common/Logger.h>
+#include <algorithm>
 
 Dandelion::Dandelion(
 	const Config& config,
+	const TaskScheduler::Ptr& pScheduler,
 	ConnectionManager& connectionManager,
 	const IBlockChain::Ptr& pBlockChain,
 	std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager,
 	const ITransactionPool::Ptr& pTransactionPool,
 	std::shared_ptr<const Locked<IBlockDB>> pBlockDB)
 	: m_config(config), 
+	m_pScheduler(pScheduler),
 	m_connectionManager(connectionManager), 
 	m_pBlockChain(pBlockChain),
 	m_pTxHashSetManager(pTxHashSetManager),
@@ -25,19 +26,20 @@ Dandelion::Dandelion(
 	m_pBlockDB(pBlockDB),
 	m_relayPeer(nullptr),
 	m_relayExpirationTime(std::chrono::system_clock::now()),
-	m_terminate(false)
+	m_taskId(0),
+	m_lastRun(std::chrono::system_clock::time_point::min())
 {
 
 }
 
 Dandelion::~Dandelion()
 {
-	m_terminate = true;
-	ThreadUtil::Join(m_dandelionThread);
+	m_pScheduler->RemoveTask(m_taskId);
 }
 
 std::shared_ptr<Dandelion> Dandelion::Create(
 	const Config& config,
+	const TaskScheduler::Ptr& pScheduler,
 	ConnectionManager& connectionManager,
 	const IBlockChain::Ptr& pBlockChain,
 	std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager,
@@ -46,6 +48,7 @@ std::shared_ptr<Dandelion> Dandelion::Create(
 {
 	auto pDandelion = std::shared_ptr<Dandelion>(new Dandelion(
 		config,
+		pScheduler,
 		connectionManager,
 		pBlockChain,
 		pTxHashSetManager,
@@ -53,7 +56,9 @@ std::shared_ptr<Dandelion> Dandelion::Create(
 		pBlockDB
 	));
 
-	pDandelion->m_dandelionThread = std::thread(Dandelion::Thread_Monitor, std::ref(*pDandelion));
+	// The destructor removes the task, and waits for a run in progress, before anything it uses is destroyed.
+	Dandelion* pDandelionRaw = pDandelion.get();
+	pDandelion->m_taskId = pScheduler->Schedule("DANDELION", std::chrono::milliseconds(0), [pDandelionRaw]() { return pDandelionRaw->Monitor(); });
 	return pDandelion;
 }
 
@@ -61,40 +66,36 @@ std::shared_ptr<Dandelion> Dandelion::Create(
 // With Dandelion, transactions can be broadcasted in stem or fluff phase.
 // When sent in stem phase, the transaction is relayed to only 1 node: the dandelion relay.
 // In order to maintain reliability a timer is started for each transaction sent in stem phase.
-// This function will monitor the stempool and test if the timer is expired for each transaction. 
-// In that case  the transaction will be sent in fluff phase (to multiple peers) instead of sending only to the peer relay.
-void Dandelion::Thread_Monitor(Dandelion& dandelion)
+// Rather than scanning the stempool every patience interval, this is scheduled for the pool's next deadline (a batch to stem or fluff,
+// or an expired embargo timer) and then only processes what's due. In that case the transaction will be sent in fluff phase
+// (to multiple peers) instead of sending only to the peer relay.
+// Returns the delay until it should next run.
+std::chrono::milliseconds Dandelion::Monitor()
 {
-	ThreadManagerAPI::SetCurrentThreadName("DANDELION");
-	LOG_DEBUG("BEGIN");
-
-	const DandelionConfig& config = dandelion.m_config.GetNodeConfig().GetDandelion();
-	while (!dandelion.m_terminate)
+	auto now = std::chrono::system_clock::now();
+	if (GetNextRunTime(now) <= now)
 	{
-		// This is the patience timer, we loop every n secs.
-		const uint8_t patience = config.GetPatienceSeconds();
-		ThreadUtil::SleepFor(std::chrono::seconds(patience), dandelion.m_terminate);
+		m_lastRun = now;
 
 		try
 		{
-			// Step 1: find all "ToStem" entries in stempool from last run.
-			// Aggregate them up to give a single (valid) aggregated tx and propagate it
+			// Step 1: once the oldest "ToStem" entry has waited the patience interval,
+			// aggregate all of them to give a single (valid) aggregated tx and propagate it
 			// to the next Dandelion relay along the stem.
-			if (!dandelion.ProcessStemPhase())
+			if (!ProcessStemPhase())
 			{
 				LOG_TRACE("Problem with stem phase");
 			}
 
-			// Step 2: find all "ToFluff" entries in stempool from last run.
-			// Aggregate them up to give a single (valid) aggregated tx and (re)add it
+			// Step 2: likewise for the "ToFluff" entries. Aggregate them up to give a single (valid) aggregated tx and (re)add it
 			// to our pool with stem=false (which will then broadcast it).
-			if (!dandelion.ProcessFluffPhase())
+			if (!ProcessFluffPhase())
 			{
 				LOG_TRACE("Problem with fluff phase");
 			}
 
-			// Step 3: now find all expired entries based on embargo timer.
-			if (!dandelion.ProcessExpiredEntries())
+			// Step 3: now fluff the entries whose embargo timer expired.
+			if (!ProcessExpiredEntries())
 			{
 				LOG_TRACE("Problem processing expired pool entries");
 			}
@@ -103,9 +104,26 @@ void Dandelion::Thread_Monitor(Dandelion& dandelion)
 		{
 			LOG_DEBUG_F("Exception thrown: {}", e.what());
 		}
+
+		now = std::chrono::system_clock::now();
+	}
+
+	return (std::max)(std::chrono::ceil<std::chrono::milliseconds>(GetNextRunTime(now) - now), std::chrono::milliseconds(0));
+}
+
+std::chrono::system_clock::time_point Dandelion::GetNextRunTime(const std::chrono::system_clock::time_point& now) const
+{
+	const std::chrono::seconds patience(m_config.GetNodeConfig().GetDandelion().GetPatienceSeconds());
+
+	// Deadlines that had already passed during the last run couldn't be handled then (eg. no relay peer), so are retried after the patience interval.
+	std::chrono::system_clock::time_point nextEvent = m_pTransactionPool->GetNextDandelionEvent();
+	if (nextEvent <= m_lastRun)
+	{
+		nextEvent = m_lastRun + patience;
 	}
 
-	LOG_DEBUG("END");
+	// A tx added in the meantime is due no sooner than the patience interval, so running at least that often never misses a deadline.
+	return (std::min)(nextEvent, now + patience);
 }
 
 bool Dandelion::ProcessStemPhase()
@@ -4,9 +4,8 @@
 #include <BlockChain/BlockChain.h>
 #include <TxPool/TransactionPool.h>
 #include <P2P/Peer.h>
+#include <Common/TaskScheduler.h>
 
-#include <thread>
-#include <atomic>
 #include <chrono>
 
 // Forward Declarations
@@ -17,6 +16,7 @@ class Dandelion
 public:
 	static std::shared_ptr<Dandelion> Create(
 		const Config& config,
+		const TaskScheduler::Ptr& pScheduler,
 		ConnectionManager& connectionManager,
 		const IBlockChain::Ptr& pBlockChain,
 		std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager,
@@ -28,6 +28,7 @@ public:
 private:
 	Dandelion(
 		const Config& config,
+		const TaskScheduler::Ptr& pScheduler,
 		ConnectionManager& connectionManager,
 		const IBlockChain::Ptr& pBlockChain,
 		std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager,
@@ -35,22 +36,24 @@ private:
 		std::shared_ptr<const Locked<IBlockDB>> pBlockDB
 	);
 
-	static void Thread_Monitor(Dandelion& dandelion);
+	std::chrono::milliseconds Monitor();
+	std::chrono::system_clock::time_point GetNextRunTime(const std::chrono::system_clock::time_point& now) const;
 
 	bool ProcessStemPhase();
 	bool ProcessFluffPhase();
 	bool ProcessExpiredEntries();
 
 	const Config& m_config;
+	TaskScheduler::Ptr m_pScheduler;
 	ConnectionManager& m_connectionManager;
 	IBlockChain::Ptr m_pBlockChain;
 	std::shared_ptr<Locked<TxHashSetManager>> m_pTxHashSetManager;
 	ITransactionPool::Ptr m_pTransactionPool;
 	std::shared_ptr<const Locked<IBlockDB>> m_pBlockDB;
 
-	std::atomic_bool m_terminate = true;
-	std::thread m_dandelionThread;
-
 	PeerPtr m_relayPeer;
 	std::chrono::time_point<std::chrono::system_clock> m_relayExpirationTime;
+
+	TaskScheduler::TaskId m_taskId;
+	std::chrono::system_clock::time_point m_lastRun;
 };
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "HeaderBatchCache.h"
+
+#include <Core/Serialization/Serializer.h>
+#include <Common/Logger.h>
+#include <algorithm>
+
+static int64_t GetCurrentSecond()
+{
+	return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+HeaderBatchCache::HeaderBatchCache(const IBlockChain::Ptr& pBlockChain)
+	: m_pBlockChain(pBlockChain), m_hits(0), m_misses(0)
+{
+	m_servedBytes.fill(0);
+	m_servedSeconds.fill(-1);
+}
+
+HeaderBatchCache::SerializedHeaders HeaderBatchCache::GetHeaders(const uint64_t firstHeight, const uint64_t numHeaders)
+{
+	SerializedHeaders headers{ 0, {} };
+
+	const uint64_t endHeight = firstHeight + numHeaders;
+	uint64_t height = firstHeight;
+	while (height < endHeight)
+	{
+		const uint64_t batchIndex = height / BATCH_SIZE;
+		const uint64_t batchStart = batchIndex * BATCH_SIZE;
+		const uint64_t batchEnd = (std::min)(endHeight, batchStart + BATCH_SIZE);
+
+		std::shared_ptr<const Batch> pBatch = GetBatch(batchIndex);
+		if (pBatch != nullptr)
+		{
+			const size_t begin = pBatch->offsets[height - batchStart];
+			const size_t end = pBatch->offsets[batchEnd - batchStart];
+			headers.bytes.insert(headers.bytes.end(), pBatch->bytes.begin() + begin, pBatch->bytes.begin() + end);
+			headers.numHeaders += (uint16_t)(batchEnd - height);
+			height = batchEnd;
+			continue;
+		}
+
+		// The batch isn't complete yet, so these are read and serialized individually.
+		Serializer serializer;
+		for (; height < batchEnd; height++)
+		{
+			auto pHeader = m_pBlockChain->GetBlockHeaderByHeight(height, EChainType::CANDIDATE);
+			if (pHeader == nullptr)
+			{
+				break;
+			}
+
+			pHeader->Serialize(serializer);
+			headers.numHeaders++;
+		}
+
+		headers.bytes.insert(headers.bytes.end(), serializer.GetBytes().begin(), serializer.GetBytes().end());
+		if (height < batchEnd)
+		{
+			break;
+		}
+	}
+
+	AddServedBytes(headers.bytes.size());
+	return headers;
+}
+
+std::shared_ptr<const HeaderBatchCache::Batch> HeaderBatchCache::GetBatch(const uint64_t batchIndex)
+{
+	const uint64_t lastHeight = (batchIndex + 1) * BATCH_SIZE - 1;
+	auto pLastHeader = m_pBlockChain->GetBlockHeaderByHeight(lastHeight, EChainType::CANDIDATE);
+	if (pLastHeader == nullptr)
+	{
+		return nullptr;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		auto iter = m_batches.find(batchIndex);
+		if (iter != m_batches.end() && iter->second.first->lastHash == pLastHeader->GetHash())
+		{
+			m_lru.splice(m_lru.begin(), m_lru, iter->second.second);
+			++m_hits;
+			return iter->second.first;
+		}
+	}
+
+	++m_misses;
+
+	// Built without the lock, since it reads BATCH_SIZE headers from the chain.
+	// Peers requesting the same batch at once may each build it, but only one copy is kept.
+	std::shared_ptr<const Batch> pBatch = BuildBatch(batchIndex, pLastHeader);
+	if (pBatch == nullptr)
+	{
+		return nullptr;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = m_batches.find(batchIndex);
+	if (iter != m_batches.end())
+	{
+		iter->second.first = pBatch;
+		m_lru.splice(m_lru.begin(), m_lru, iter->second.second);
+		return pBatch;
+	}
+
+	m_lru.push_front(batchIndex);
+	m_batches.insert({ batchIndex, std::make_pair(pBatch, m_lru.begin()) });
+
+	while (m_batches.size() > MAX_BATCHES)
+	{
+		m_batches.erase(m_lru.back());
+		m_lru.pop_back();
+	}
+
+	return pBatch;
+}
+
+std::shared_ptr<const HeaderBatchCache::Batch> HeaderBatchCache::BuildBatch(const uint64_t batchIndex, const BlockHeaderPtr& pLastHeader) const
+{
+	auto pBatch = std::make_shared<Batch>();
+	pBatch->lastHash = pLastHeader->GetHash();
+	pBatch->offsets.reserve(BATCH_SIZE + 1);
+
+	Serializer serializer;
+	BlockHeaderPtr pPrevHeader = nullptr;
+	for (uint64_t height = batchIndex * BATCH_SIZE; height < (batchIndex + 1) * BATCH_SIZE; height++)
+	{
+		auto pHeader = m_pBlockChain->GetBlockHeaderByHeight(height, EChainType::CANDIDATE);
+
+		// The candidate chain reorged while the batch was being read.
+		if (pHeader == nullptr || (pPrevHeader != nullptr && pHeader->GetPreviousHash() != pPrevHeader->GetHash()))
+		{
+			LOG_DEBUG_F("Candidate chain changed while caching headers at height {}", height);
+			return nullptr;
+		}
+
+		pBatch->offsets.push_back(serializer.size());
+		pHeader->Serialize(serializer);
+		pPrevHeader = pHeader;
+	}
+
+	if (pPrevHeader->GetHash() != pBatch->lastHash)
+	{
+		LOG_DEBUG_F("Candidate chain changed while caching headers at height {}", pLastHeader->GetHeight());
+		return nullptr;
+	}
+
+	pBatch->offsets.push_back(serializer.size());
+	pBatch->bytes = serializer.GetBytes();
+
+	return pBatch;
+}
+
+CacheStats HeaderBatchCache::GetStats() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return CacheStats{ MAX_BATCHES, m_batches.size(), m_hits, m_misses };
+}
+
+void HeaderBatchCache::AddServedBytes(const size_t numBytes)
+{
+	const int64_t second = GetCurrentSecond();
+	const size_t slot = (size_t)(second % m_servedBytes.size());
+
+	std::unique_lock<std::mutex> lock(m_rateMutex);
+	if (m_servedSeconds[slot] != second)
+	{
+		m_servedSeconds[slot] = second;
+		m_servedBytes[slot] = 0;
+	}
+
+	m_servedBytes[slot] += numBytes;
+}
+
+uint64_t HeaderBatchCache::GetServedBytesPerSecond() const
+{
+	const int64_t second = GetCurrentSecond();
+
+	// The current second is still in progress, so only the full seconds before it are counted.
+	uint64_t total = 0;
+	std::unique_lock<std::mutex> lock(m_rateMutex);
+	for (size_t slot = 0; slot < m_servedBytes.size(); slot++)
+	{
+		if (m_servedSeconds[slot] < second && m_servedSeconds[slot] >= second - (int64_t)RATE_WINDOW_SECS)
+		{
+			total += m_servedBytes[slot];
+		}
+	}
+
+	return total / RATE_WINDOW_SECS;
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <BlockChain/BlockChain.h>
+#include <Common/CacheStats.h>
+#include <Crypto/Hash.h>
+#include <P2P/Common.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//
+// Serialized candidate chain headers, cached in batches of BATCH_SIZE aligned on multiples of BATCH_SIZE heights,
+// so the GetHeaders ranges every syncing peer requests are answered by copying bytes instead of loading and reserializing each header.
+//
+// A batch is only cached once the candidate chain is past its last height. Each lookup compares the batch's last hash
+// to the candidate chain's header at that height, so batches left over from before a reorg are rebuilt.
+//
+class HeaderBatchCache
+{
+public:
+	using Ptr = std::shared_ptr<HeaderBatchCache>;
+
+	struct SerializedHeaders
+	{
+		uint16_t numHeaders;
+		std::vector<uint8_t> bytes;
+	};
+
+	HeaderBatchCache(const IBlockChain::Ptr& pBlockChain);
+
+	//
+	// Returns up to numHeaders serialized candidate chain headers, starting at firstHeight.
+	// Stops early if the candidate chain ends.
+	//
+	SerializedHeaders GetHeaders(const uint64_t firstHeight, const uint64_t numHeaders);
+
+	CacheStats GetStats() const;
+
+	//
+	// The average number of header bytes served per second over the last RATE_WINDOW_SECS seconds.
+	//
+	uint64_t GetServedBytesPerSecond() const;
+
+private:
+	static constexpr uint64_t BATCH_SIZE = P2P::MAX_BLOCK_HEADERS;
+
+	// Headers are a few hundred bytes, so this is roughly 50MB.
+	static constexpr size_t MAX_BATCHES = 256;
+
+	static constexpr size_t RATE_WINDOW_SECS = 10;
+
+	struct Batch
+	{
+		Hash lastHash;
+		std::vector<uint8_t> bytes;
+
+		// The offset of each header in bytes, followed by bytes.size().
+		std::vector<size_t> offsets;
+	};
+
+	std::shared_ptr<const Batch> GetBatch(const uint64_t batchIndex);
+	std::shared_ptr<const Batch> BuildBatch(const uint64_t batchIndex, const BlockHeaderPtr& pLastHeader) const;
+
+	void AddServedBytes(const size_t numBytes);
+
+	IBlockChain::Ptr m_pBlockChain;
+
+	mutable std::mutex m_mutex;
+
+	// Most recently used batch index at the front.
+	std::list<uint64_t> m_lru;
+	std::unordered_map<uint64_t, std::pair<std::shared_ptr<const Batch>, std::list<uint64_t>::iterator>> m_batches;
+
+	std::atomic<uint64_t> m_hits;
+	std::atomic<uint64_t> m_misses;
+
+	// Bytes served during each of the last RATE_WINDOW_SECS seconds, indexed by second modulo the window.
+	mutable std::mutex m_rateMutex;
+	std::array<uint64_t, RATE_WINDOW_SECS + 1> m_servedBytes;
+	std::array<int64_t, RATE_WINDOW_SECS + 1> m_servedSeconds;
+};
@@ -0,0 +1,84 @@
+#include "MessageBufferPool.h"
+
+#include <algorithm>
+
+MessageBufferPool::Ptr MessageBufferPool::Create(const size_t maxBuffers, const size_t maxBufferSize)
+{
+	return std::shared_ptr<MessageBufferPool>(new MessageBufferPool(maxBuffers, maxBufferSize));
+}
+
+MessageBufferPool::Buffer MessageBufferPool::Acquire(const size_t numBytes)
+{
+	std::unique_ptr<std::vector<uint8_t>> pBuffer;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (!m_buffers.empty())
+		{
+			// Prefer the smallest buffer that already fits, falling back to the largest one available.
+			auto iter = std::min_element(
+				m_buffers.begin(),
+				m_buffers.end(),
+				[numBytes](const auto& pLeft, const auto& pRight) {
+					const bool leftFits = pLeft->capacity() >= numBytes;
+					const bool rightFits = pRight->capacity() >= numBytes;
+					if (leftFits != rightFits)
+					{
+						return leftFits;
+					}
+
+					return leftFits ? pLeft->capacity() < pRight->capacity() : pLeft->capacity() > pRight->capacity();
+				}
+			);
+
+			pBuffer = std::move(*iter);
+			m_buffers.erase(iter);
+		}
+	}
+
+	if (pBuffer == nullptr)
+	{
+		pBuffer = std::make_unique<std::vector<uint8_t>>();
+	}
+
+	pBuffer->resize(numBytes);
+	return Buffer(pBuffer.release(), Releaser(weak_from_this()));
+}
+
+MessageBufferPool::Buffer MessageBufferPool::Wrap(std::vector<uint8_t>&& bytes)
+{
+	return Buffer(new std::vector<uint8_t>(std::move(bytes)), Releaser());
+}
+
+size_t MessageBufferPool::GetNumPooled() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_buffers.size();
+}
+
+void MessageBufferPool::Release(std::vector<uint8_t>* pBuffer)
+{
+	std::unique_ptr<std::vector<uint8_t>> pOwned(pBuffer);
+	if (pOwned->capacity() > m_maxBufferSize)
+	{
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (m_buffers.size() < m_maxBuffers)
+	{
+		m_buffers.emplace_back(std::move(pOwned));
+	}
+}
+
+void MessageBufferPool::Releaser::operator()(std::vector<uint8_t>* pBuffer) const
+{
+	auto pPool = m_pPool.lock();
+	if (pPool != nullptr)
+	{
+		pPool->Release(pBuffer);
+	}
+	else
+	{
+		delete pBuffer;
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+//
+// A small per-connection pool of receive buffers.
+// Buffers are handed out as MessageBufferPool::Buffer, which returns itself to the pool when released,
+// so steady-state message retrieval reuses the same few allocations instead of allocating for every message.
+//
+class MessageBufferPool : public std::enable_shared_from_this<MessageBufferPool>
+{
+public:
+	using Ptr = std::shared_ptr<MessageBufferPool>;
+
+	// Larger buffers (eg. for huge blocks) are freed rather than pinned for the connection's lifetime.
+	static constexpr size_t DEFAULT_MAX_BUFFER_SIZE = 4 * 1024 * 1024;
+	static constexpr size_t DEFAULT_MAX_BUFFERS = 4;
+
+	class Releaser
+	{
+	public:
+		Releaser() = default;
+		Releaser(const std::weak_ptr<MessageBufferPool>& pPool) : m_pPool(pPool) { }
+
+		void operator()(std::vector<uint8_t>* pBuffer) const;
+
+	private:
+		std::weak_ptr<MessageBufferPool> m_pPool;
+	};
+
+	using Buffer = std::unique_ptr<std::vector<uint8_t>, Releaser>;
+
+	static MessageBufferPool::Ptr Create(
+		const size_t maxBuffers = DEFAULT_MAX_BUFFERS,
+		const size_t maxBufferSize = DEFAULT_MAX_BUFFER_SIZE
+	);
+
+	//
+	// Returns a buffer of exactly numBytes, reusing a pooled allocation when one is available.
+	//
+	Buffer Acquire(const size_t numBytes);
+
+	//
+	// Wraps an unpooled vector, so callers without a pool can still produce a Buffer.
+	//
+	static Buffer Wrap(std::vector<uint8_t>&& bytes);
+
+	size_t GetNumPooled() const;
+
+private:
+	MessageBufferPool(const size_t maxBuffers, const size_t maxBufferSize)
+		: m_maxBuffers(maxBuffers), m_maxBufferSize(maxBufferSize) { }
+
+	void Release(std::vector<uint8_t>* pBuffer);
+
+	const size_t m_maxBuffers;
+	const size_t m_maxBufferSize;
+
+	mutable std::mutex m_mutex;
+	std::vector<std::unique_ptr<std::vector<uint8_t>>> m_buffers;
+};
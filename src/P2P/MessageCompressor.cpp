@@ -0,0 +1,110 @@
+#include "MessageCompressor.h"
+#include "P2PMetrics.h"
+
+#include <Core/Exceptions/DeserializationException.h>
+#include <Core/Serialization/Serializer.h>
+#include <zlib.h>
+#include <algorithm>
+#include <chrono>
+
+// Most of a block is commitments, proofs, and signatures, which barely compress, so the fastest level gets nearly all there is to get.
+static const int COMPRESSION_LEVEL = Z_BEST_SPEED;
+
+static uint64_t GetMicrosSince(const std::chrono::steady_clock::time_point& start)
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool MessageCompressor::IsCompressible(const MessageTypes::EMessageType messageType) noexcept
+{
+	return messageType == MessageTypes::Headers
+		|| messageType == MessageTypes::Block
+		|| messageType == MessageTypes::CompactBlockMsg;
+}
+
+std::unique_ptr<std::vector<uint8_t>> MessageCompressor::Compress(const std::vector<uint8_t>& serializedMessage)
+{
+	if (serializedMessage.size() < P2PMetrics::HEADER_SIZE + MIN_PAYLOAD_SIZE) {
+		return nullptr;
+	}
+
+	const auto messageType = (MessageTypes::EMessageType)serializedMessage[2];
+	if (!IsCompressible(messageType)) {
+		return nullptr;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const uint8_t* pPayload = serializedMessage.data() + P2PMetrics::HEADER_SIZE;
+	const size_t payloadSize = serializedMessage.size() - P2PMetrics::HEADER_SIZE;
+
+	// Compressed straight into the wrapped message, behind space for both headers.
+	const size_t prefixSize = P2PMetrics::HEADER_SIZE + INNER_HEADER_SIZE;
+	auto pWrapped = std::make_unique<std::vector<uint8_t>>(prefixSize + compressBound((uLong)payloadSize));
+	uLongf compressedSize = (uLongf)(pWrapped->size() - prefixSize);
+	const int status = compress2(pWrapped->data() + prefixSize, &compressedSize, pPayload, (uLong)payloadSize, COMPRESSION_LEVEL);
+
+	// Anything that doesn't save at least 1/16th is sent as-is, since the receiver would spend more time inflating it than it saves.
+	if (status != Z_OK || compressedSize + INNER_HEADER_SIZE > payloadSize - (payloadSize / 16)) {
+		P2PMetrics::OnMessageCompressed(messageType, payloadSize, payloadSize, GetMicrosSince(start));
+		return nullptr;
+	}
+
+	Serializer serializer(prefixSize);
+	serializer.Append<uint8_t>(serializedMessage[0]);
+	serializer.Append<uint8_t>(serializedMessage[1]);
+	serializer.Append<uint8_t>((uint8_t)MessageTypes::Compressed);
+	serializer.Append<uint64_t>(INNER_HEADER_SIZE + compressedSize);
+	serializer.Append<uint8_t>((uint8_t)messageType);
+	serializer.Append<uint64_t>(payloadSize);
+	std::copy(serializer.GetBytes().cbegin(), serializer.GetBytes().cend(), pWrapped->begin());
+	pWrapped->resize(prefixSize + compressedSize);
+
+	P2PMetrics::OnMessageCompressed(messageType, payloadSize, INNER_HEADER_SIZE + compressedSize, GetMicrosSince(start));
+	return pWrapped;
+}
+
+MessageHeader MessageCompressor::GetInnerHeader(const RawMessage& compressedMessage)
+{
+	ByteBuffer byteBuffer = compressedMessage.GetPayloadView();
+	const auto messageType = (MessageTypes::EMessageType)byteBuffer.ReadU8();
+	const uint64_t messageLength = byteBuffer.ReadU64();
+
+	if (!IsCompressible(messageType)) {
+		throw DESERIALIZATION_EXCEPTION_F("Compressed message can't wrap a {}", MessageTypes::ToString(messageType));
+	}
+
+	// The same limit MessageHeader::Deserialize applies to uncompressed messages.
+	if (messageLength > MessageTypes::GetMaximumSize(messageType) * 4) {
+		throw DESERIALIZATION_EXCEPTION("Compressed message is invalid. Message length too long");
+	}
+
+	return MessageHeader(compressedMessage.GetMessageHeader().GetMagicBytes(), messageType, messageLength);
+}
+
+void MessageCompressor::Decompress(const RawMessage& compressedMessage, std::vector<uint8_t>& payload)
+{
+	const auto start = std::chrono::steady_clock::now();
+	const std::vector<uint8_t>& compressed = compressedMessage.GetPayload();
+	if (compressed.size() < INNER_HEADER_SIZE) {
+		throw DESERIALIZATION_EXCEPTION("Compressed message is invalid. Missing inner header");
+	}
+
+	// uncompress fails with Z_BUF_ERROR rather than writing past the end, so the declared length is also the limit.
+	uLongf numDecompressed = (uLongf)payload.size();
+	const int status = uncompress(
+		payload.data(),
+		&numDecompressed,
+		compressed.data() + INNER_HEADER_SIZE,
+		(uLong)(compressed.size() - INNER_HEADER_SIZE)
+	);
+	if (status != Z_OK || numDecompressed != payload.size()) {
+		throw DESERIALIZATION_EXCEPTION_F("Failed to decompress message. Error: {}", status);
+	}
+
+	P2PMetrics::OnMessageDecompressed(
+		(MessageTypes::EMessageType)compressed[0],
+		compressed.size(),
+		payload.size(),
+		GetMicrosSince(start)
+	);
+}
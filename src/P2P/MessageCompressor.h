@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Messages/RawMessage.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//
+// Deflates large header and block messages for peers that advertise Capabilities::COMPRESSION.
+//
+// A compressed message is sent as a MessageTypes::Compressed message, whose payload is the wrapped message's type (u8)
+// and payload length (u64) followed by its zlib-compressed payload. MessageRetriever unwraps them as they're received,
+// so MessageProcessor and the handlers only ever see the original message.
+//
+class MessageCompressor
+{
+public:
+	// Smaller payloads (eg. a single header, or a compact block for a nearly empty block) aren't worth the CPU.
+	static constexpr size_t MIN_PAYLOAD_SIZE = 4 * 1024;
+
+	static bool IsCompressible(const MessageTypes::EMessageType messageType) noexcept;
+
+	//
+	// Returns the serialized message wrapped in a Compressed message, or nullptr if it's not a compressible type,
+	// is smaller than MIN_PAYLOAD_SIZE, or didn't shrink enough to be worth inflating on the other end.
+	//
+	static std::unique_ptr<std::vector<uint8_t>> Compress(const std::vector<uint8_t>& serializedMessage);
+
+	//
+	// Returns the header of the message wrapped in a Compressed message.
+	// Throws a DeserializationException if it's not a compressible type, or is longer than that type allows.
+	//
+	static MessageHeader GetInnerHeader(const RawMessage& compressedMessage);
+
+	//
+	// Inflates the wrapped payload into payload, which must already be sized to the inner header's length.
+	// Throws a DeserializationException if the compressed data is invalid, or doesn't inflate to exactly that length.
+	//
+	static void Decompress(const RawMessage& compressedMessage, std::vector<uint8_t>& payload);
+
+private:
+	// The wrapped message's type and payload length, which precede the compressed data.
+	static constexpr size_t INNER_HEADER_SIZE = 9;
+};
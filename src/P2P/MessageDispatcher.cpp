@@ -0,0 +1,265 @@
+#include "MessageDispatcher.h"
+#include "Connection.h"
+
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <Common/Logger.h>
+#include <algorithm>
+
+static const std::array<std::string, MessageDispatcher::NUM_PRIORITIES> PRIORITY_NAMES = {
+	"blocks", "compact_blocks", "transactions", "peer_addresses"
+};
+
+MessageDispatcher::MessageDispatcher(Handler&& handler)
+	: m_handler(std::move(handler)), m_stopped(false), m_numRunning(0), m_numQueued{}
+{
+	for (size_t i = 0; i < NUM_PRIORITIES; i++)
+	{
+		m_queuedGauges[i] = &MetricsAPI::RegisterGauge(
+			"grin_p2p_dispatch_queued_messages",
+			"Number of received P2P messages waiting to be handled, by priority.",
+			MetricsWriter::Label("priority", PRIORITY_NAMES[i])
+		);
+	}
+}
+
+MessageDispatcher::Ptr MessageDispatcher::Create(Handler&& handler)
+{
+	return std::shared_ptr<MessageDispatcher>(new MessageDispatcher(std::move(handler)));
+}
+
+bool MessageDispatcher::IsHandledInline(const MessageTypes::EMessageType messageType) noexcept
+{
+	switch (messageType)
+	{
+		case MessageTypes::Error:
+		case MessageTypes::Hand:
+		case MessageTypes::Shake:
+		case MessageTypes::Ping:
+		case MessageTypes::Pong:
+		case MessageTypes::BanReasonMsg:
+			return true;
+		default:
+			return false;
+	}
+}
+
+bool MessageDispatcher::ReadsFromSocket(const MessageTypes::EMessageType messageType) noexcept
+{
+	return messageType == MessageTypes::TxHashSetArchive;
+}
+
+MessageDispatcher::EPriority MessageDispatcher::GetPriority(const MessageTypes::EMessageType messageType) noexcept
+{
+	switch (messageType)
+	{
+		case MessageTypes::GetCompactBlock:
+		case MessageTypes::CompactBlockMsg:
+			return COMPACT_BLOCKS;
+		case MessageTypes::StemTransaction:
+		case MessageTypes::TransactionMsg:
+		case MessageTypes::GetTransactionMsg:
+		case MessageTypes::GetTransactions:
+		case MessageTypes::TransactionKernelMsg:
+			return TRANSACTIONS;
+		case MessageTypes::GetPeerAddrs:
+		case MessageTypes::PeerAddrs:
+			return PEER_ADDRESSES;
+		default:
+			return BLOCKS;
+	}
+}
+
+bool MessageDispatcher::Dispatch(const std::shared_ptr<Connection>& pConnection, std::unique_ptr<RawMessage>&& pRawMessage)
+{
+	const EPriority priority = GetPriority(pRawMessage->GetMessageHeader().GetMessageType());
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_stopped)
+		{
+			return false;
+		}
+
+		const uint64_t connectionId = pConnection->GetId();
+		PeerQueue& peer = m_peers[connectionId];
+		if (peer.pConnection == nullptr)
+		{
+			peer.pConnection = pConnection;
+		}
+
+		std::deque<std::unique_ptr<RawMessage>>& queue = peer.messages[priority];
+		if (priority >= TRANSACTIONS && queue.size() >= MAX_QUEUED_PER_PEER)
+		{
+			return false;
+		}
+
+		queue.push_back(std::move(pRawMessage));
+		++m_numQueued[priority];
+
+		if (!peer.running && queue.size() == 1)
+		{
+			m_ready[priority].push_back(connectionId);
+		}
+
+		UpdateMetrics();
+	}
+
+	Post(priority);
+	return true;
+}
+
+void MessageDispatcher::Stop()
+{
+	std::unordered_map<uint64_t, PeerQueue> peers;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_stopped = true;
+
+		// Destroyed after unlocking, since releasing the last reference to a connection closes it.
+		peers.swap(m_peers);
+		for (size_t i = 0; i < NUM_PRIORITIES; i++)
+		{
+			m_ready[i].clear();
+			m_numQueued[i] = 0;
+		}
+
+		UpdateMetrics();
+		m_idle.wait(lock, [this] { return m_numRunning == 0; });
+	}
+}
+
+void MessageDispatcher::Post(const EPriority priority)
+{
+	const ETaskPriority taskPriority = priority == BLOCKS ? ETaskPriority::HIGH
+		: (priority == PEER_ADDRESSES ? ETaskPriority::LOW : ETaskPriority::NORMAL);
+
+	auto pDispatcher = shared_from_this();
+	// Relaying blocks and transactions is latency-sensitive, so messages are handled on their own pool rather than queueing behind verification.
+	ThreadManagerAPI::GetLatencyThreadPool().Post([pDispatcher]() { pDispatcher->RunNext(); }, taskPriority);
+}
+
+//
+// Handles a single message. Tasks are posted once per message, so a task that finds nothing ready
+// (because the peer it was posted for is still running) just returns, and the peer's task posts another when it's done.
+//
+void MessageDispatcher::RunNext()
+{
+	uint64_t connectionId = 0;
+	std::shared_ptr<Connection> pConnection;
+	std::unique_ptr<RawMessage> pRawMessage;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_stopped)
+		{
+			return;
+		}
+
+		auto iter = std::find_if(m_ready.begin(), m_ready.end(), [](const std::deque<uint64_t>& ready) { return !ready.empty(); });
+		if (iter == m_ready.end())
+		{
+			return;
+		}
+
+		const size_t priority = std::distance(m_ready.begin(), iter);
+		connectionId = iter->front();
+
+		PeerQueue& peer = m_peers.at(connectionId);
+		pRawMessage = std::move(peer.messages[priority].front());
+		peer.messages[priority].pop_front();
+		--m_numQueued[priority];
+
+		peer.running = true;
+		UnmarkReady(connectionId);
+
+		pConnection = peer.pConnection;
+		++m_numRunning;
+		UpdateMetrics();
+	}
+
+	try
+	{
+		m_handler(*pConnection, *pRawMessage);
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception ({}) caught while handling message from {}", e.what(), *pConnection);
+	}
+	catch (...)
+	{
+		LOG_ERROR_F("Unknown exception caught while handling message from {}", *pConnection);
+	}
+
+	pRawMessage.reset();
+
+	std::optional<EPriority> nextPriority = std::nullopt;
+	std::shared_ptr<Connection> pFinished;
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		auto iter = m_peers.find(connectionId);
+		if (iter != m_peers.end())
+		{
+			PeerQueue& peer = iter->second;
+			peer.running = false;
+
+			for (size_t i = 0; i < NUM_PRIORITIES && !nextPriority.has_value(); i++)
+			{
+				if (!peer.messages[i].empty())
+				{
+					nextPriority = (EPriority)i;
+				}
+			}
+
+			if (nextPriority.has_value())
+			{
+				MarkReady(connectionId, peer);
+			}
+			else
+			{
+				pFinished = std::move(peer.pConnection);
+				m_peers.erase(iter);
+			}
+		}
+
+		if (--m_numRunning == 0 && m_stopped)
+		{
+			m_idle.notify_all();
+		}
+	}
+
+	if (nextPriority.has_value())
+	{
+		Post(nextPriority.value());
+	}
+}
+
+void MessageDispatcher::MarkReady(const uint64_t connectionId, const PeerQueue& peer)
+{
+	for (size_t i = 0; i < NUM_PRIORITIES; i++)
+	{
+		if (!peer.messages[i].empty())
+		{
+			m_ready[i].push_back(connectionId);
+		}
+	}
+}
+
+void MessageDispatcher::UnmarkReady(const uint64_t connectionId)
+{
+	for (std::deque<uint64_t>& ready : m_ready)
+	{
+		ready.erase(std::remove(ready.begin(), ready.end(), connectionId), ready.end());
+	}
+}
+
+void MessageDispatcher::UpdateMetrics() const
+{
+	for (size_t i = 0; i < NUM_PRIORITIES; i++)
+	{
+		m_queuedGauges[i]->Set((int64_t)m_numQueued[i]);
+	}
+}
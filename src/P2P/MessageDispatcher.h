@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Messages/MessageTypes.h"
+#include "Messages/RawMessage.h"
+
+#include <Common/Metrics.h>
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+// Forward Declarations
+class Connection;
+
+//
+// Hands received messages off to the shared thread pool, so a slow handler doesn't hold up its connection's strand,
+// which would delay the peer's pings and sends, and eventually trip its receive timeout.
+// Messages are queued by priority, and each worker takes the oldest message in the highest priority
+// queue that has any, from the peers with messages of that priority in turn, so one busy peer can't starve the others.
+// A peer's messages are handled one at a time, in the order they arrived within each priority.
+//
+class MessageDispatcher : public std::enable_shared_from_this<MessageDispatcher>
+{
+public:
+	using Ptr = std::shared_ptr<MessageDispatcher>;
+	using Handler = std::function<void(Connection&, const RawMessage&)>;
+
+	enum EPriority
+	{
+		BLOCKS = 0,		// Blocks, headers, and requests for them.
+		COMPACT_BLOCKS = 1,
+		TRANSACTIONS = 2,
+		PEER_ADDRESSES = 3,
+		NUM_PRIORITIES = 4
+	};
+
+	static MessageDispatcher::Ptr Create(Handler&& handler);
+
+	//
+	// Messages that are handled on the connection's strand, because they're cheap and time-sensitive (pings).
+	//
+	static bool IsHandledInline(const MessageTypes::EMessageType messageType) noexcept;
+
+	//
+	// Messages whose handler reads an attachment straight from the socket (txhashset archives).
+	// The connection stops reading until the handler calls Connection::ResumeReading.
+	//
+	static bool ReadsFromSocket(const MessageTypes::EMessageType messageType) noexcept;
+	static EPriority GetPriority(const MessageTypes::EMessageType messageType) noexcept;
+
+	//
+	// Queues the message to be handled on the thread pool.
+	// Returns false if it was dropped because the peer already has too many lower priority messages queued.
+	//
+	bool Dispatch(const std::shared_ptr<Connection>& pConnection, std::unique_ptr<RawMessage>&& pRawMessage);
+
+	//
+	// Drops every queued message, and waits for the handlers that are running to return.
+	// No handlers are called once this returns.
+	//
+	void Stop();
+
+private:
+	// Transactions and peer addresses beyond this many per peer are dropped. The others are bounded by what we request.
+	static constexpr size_t MAX_QUEUED_PER_PEER = 256;
+
+	struct PeerQueue
+	{
+		std::shared_ptr<Connection> pConnection;
+		std::array<std::deque<std::unique_ptr<RawMessage>>, NUM_PRIORITIES> messages;
+		bool running = false;
+	};
+
+	explicit MessageDispatcher(Handler&& handler);
+
+	void Post(const EPriority priority);
+	void RunNext();
+
+	// Must be called with the lock held, for a peer that isn't running.
+	void MarkReady(const uint64_t connectionId, const PeerQueue& peer);
+	void UnmarkReady(const uint64_t connectionId);
+	void UpdateMetrics() const;
+
+	Handler m_handler;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_idle;
+	bool m_stopped;
+	size_t m_numRunning;
+	std::unordered_map<uint64_t, PeerQueue> m_peers;
+
+	// For each priority, the peers that have messages of that priority and aren't running, in turn.
+	std::array<std::deque<uint64_t>, NUM_PRIORITIES> m_ready;
+	std::array<size_t, NUM_PRIORITIES> m_numQueued;
+	std::array<MetricGauge*, NUM_PRIORITIES> m_queuedGauges;
+};
@@ -2,6 +2,7 @@
 #include "BlockLocator.h"
 #include "ConnectionManager.h"
 #include "Pipeline/Pipeline.h"
+#include "P2PMetrics.h"
 
 // Network Messages
 #include "Messages/ErrorMessage.h"
@@ -15,6 +16,8 @@
 #include "Messages/GetHeadersMessage.h"
 #include "Messages/HeaderMessage.h"
 #include "Messages/HeadersMessage.h"
+#include "Messages/SerializedHeadersMessage.h"
+#include "Messages/SerializedMessage.h"
 #include "Messages/BlockMessage.h"
 #include "Messages/GetBlockMessage.h"
 #include "Messages/CompactBlockMessage.h"
@@ -26,9 +29,9 @@
 #include "Messages/TxHashSetRequestMessage.h"
 #include "Messages/TxHashSetArchiveMessage.h"
 #include "Messages/GetTransactionMessage.h"
+#include "Messages/GetTransactionsMessage.h"
 #include "Messages/TransactionKernelMessage.h"
 
-#include <Core/File/FileRemover.h>
 #include <Core/Exceptions/BadDataException.h>
 #include <Core/Exceptions/BlockChainException.h>
 #include <P2P/Common.h>
@@ -40,6 +43,7 @@
 #include <Common/Logger.h>
 #include <thread>
 #include <fstream>
+#include <unordered_set>
 
 static const int BUFFER_SIZE = 256 * 1024;
 
@@ -51,15 +55,81 @@ MessageProcessor::MessageProcessor(
 	Locked<PeerManager> peerManager,
 	const IBlockChain::Ptr& pBlockChain,
 	const std::shared_ptr<Pipeline>& pPipeline,
-	SyncStatusConstPtr pSyncStatus)
+	SyncStatusConstPtr pSyncStatus,
+	const HeaderBatchCache::Ptr& pHeaderCache)
 	: m_config(config),
 	m_connectionManager(connectionManager),
 	m_peerManager(peerManager),
 	m_pBlockChain(pBlockChain),
 	m_pPipeline(pPipeline),
-	m_pSyncStatus(pSyncStatus)
+	m_pSyncStatus(pSyncStatus),
+	m_pHeaderCache(pHeaderCache),
+	m_pTxRequester(TransactionRequester::Create())
 {
+	m_pDispatcher = MessageDispatcher::Create([this](Connection& connection, const RawMessage& rawMessage) {
+		const bool readsFromSocket = MessageDispatcher::ReadsFromSocket(rawMessage.GetMessageHeader().GetMessageType());
+		try
+		{
+			// The peer may have been dropped while the message was queued.
+			if (connection.IsConnectionActive())
+			{
+				ProcessMessage(connection, rawMessage);
+			}
+		}
+		catch (...)
+		{
+			if (readsFromSocket)
+			{
+				connection.ResumeReading();
+			}
+
+			throw;
+		}
+
+		if (readsFromSocket)
+		{
+			connection.ResumeReading();
+		}
+	});
+}
+
+MessageProcessor::~MessageProcessor()
+{
+	m_pDispatcher->Stop();
+}
 
+void MessageProcessor::ReceiveMessage(const std::shared_ptr<Connection>& pConnection, std::unique_ptr<RawMessage>&& pRawMessage)
+{
+	Connection& connection = *pConnection;
+	const EMessageType messageType = pRawMessage->GetMessageHeader().GetMessageType();
+	const uint64_t numBytes = P2PMetrics::HEADER_SIZE + pRawMessage->GetPayload().size();
+	P2PMetrics::OnMessageReceived(messageType, numBytes);
+	connection.GetConnectedPeer().GetStats().OnMessageReceived((uint8_t)messageType, numBytes);
+
+	if (!connection.GetRateLimiter().Allow(messageType, numBytes))
+	{
+		LOG_DEBUG_F("Skipping message({}) from ({}): rate limit exceeded", MessageTypes::ToString(messageType), connection);
+		P2PMetrics::OnMessageThrottled(messageType);
+	}
+	else if (MessageDispatcher::IsHandledInline(messageType))
+	{
+		ProcessMessage(connection, *pRawMessage);
+		return;
+	}
+	else if (m_pDispatcher->Dispatch(pConnection, std::move(pRawMessage)))
+	{
+		return;
+	}
+	else
+	{
+		LOG_DEBUG_F("Dropping message({}) from ({}): too many messages queued", MessageTypes::ToString(messageType), connection);
+	}
+
+	// Nothing will read the attachment that follows the dropped message, so the rest of the stream can't be parsed.
+	if (MessageDispatcher::ReadsFromSocket(messageType))
+	{
+		connection.Disconnect();
+	}
 }
 
 void MessageProcessor::ProcessMessage(Connection& connection, const RawMessage& rawMessage)
@@ -91,7 +161,7 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 {
 	const MessageHeader& header = rawMessage.GetMessageHeader();
 	EProtocolVersion protocolVersion = connection.GetProtocolVersion();
-	ByteBuffer byteBuffer(rawMessage.GetPayload(), protocolVersion);
+	ByteBuffer byteBuffer = rawMessage.GetPayloadView(protocolVersion);
 
 	switch (header.GetMessageType())
 	{
@@ -123,6 +193,7 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 		{
 			const PongMessage pongMessage = PongMessage::Deserialize(byteBuffer);
 			connection.UpdateTotals(pongMessage.GetTotalDifficulty(), pongMessage.GetHeight());
+			connection.GetConnectedPeer().GetStats().OnPongReceived();
 			break;
 		}
 		case GetPeerAddrs:
@@ -157,15 +228,17 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 			const GetHeadersMessage getHeadersMessage = GetHeadersMessage::Deserialize(byteBuffer);
 			const std::vector<Hash>& hashes = getHeadersMessage.GetHashes();
 
-			std::vector<BlockHeaderPtr> blockHeaders = BlockLocator(m_pBlockChain).LocateHeaders(hashes);
-			LOG_DEBUG_F("Sending {} headers to {}.", blockHeaders.size(), connection);
-                
-			connection.SendMsg(HeadersMessage{ std::move(blockHeaders) });
+			const std::pair<uint64_t, uint64_t> range = BlockLocator(m_pBlockChain).LocateHeaderRange(hashes);
+			HeaderBatchCache::SerializedHeaders headers = m_pHeaderCache->GetHeaders(range.first, range.second);
+			LOG_DEBUG_F("Sending {} headers to {}.", headers.numHeaders, connection);
+
+			connection.SendMsg(SerializedHeadersMessage{ headers.numHeaders, std::move(headers.bytes) });
 			break;
 		}
 		case Header:
 		{
 			auto pBlockHeader = HeaderMessage::Deserialize(byteBuffer).GetHeader();
+			connection.AddKnownInventory(pBlockHeader->GetHash());
 
 			if (pBlockHeader->GetTotalDifficulty() > connection.GetTotalDifficulty()) {
 				connection.UpdateTotals(pBlockHeader->GetTotalDifficulty(), pBlockHeader->GetHeight());
@@ -193,42 +266,47 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 		case Headers:
 		{
 			const HeadersMessage headersMessage = HeadersMessage::Deserialize(byteBuffer);
-			const std::vector<BlockHeaderPtr>& blockHeaders = headersMessage.GetHeaders();
+			std::vector<BlockHeaderPtr> blockHeaders = headersMessage.GetHeaders();
 
 			LOG_DEBUG_F("{} headers received from {}", blockHeaders.size(), connection);
+			connection.GetConnectedPeer().GetStats().OnHeadersReceived(blockHeaders.size());
 
-			const EBlockChainStatus status = m_pBlockChain->AddBlockHeaders(blockHeaders);
-			if (status == EBlockChainStatus::INVALID) {
-				connection.BanPeer(EBanReason::BadBlockHeader);
-			}
-
-			LOG_DEBUG_F("Headers message from {} finished processing", connection);
+			// Validated and added to the chain, in order, by the header pipe.
+			m_pPipeline->ProcessHeaders(connection, std::move(blockHeaders));
 			break;
 		}
 		case GetBlock:
 		{
 			const GetBlockMessage getBlockMessage = GetBlockMessage::Deserialize(byteBuffer);
-			std::unique_ptr<FullBlock> pBlock = m_pBlockChain->GetBlockByHash(getBlockMessage.GetHash());
-			if (pBlock != nullptr) {
-				connection.SendMsg(BlockMessage{ std::move(*pBlock) });
+			auto pSerializedBlock = m_pBlockChain->GetSerializedBlock(getBlockMessage.GetHash(), protocolVersion);
+			if (pSerializedBlock != nullptr) {
+				connection.SendMsg(SerializedMessage{ Block, pSerializedBlock });
 			}
 
 			break;
 		}
 		case Block:
 		{
-			const BlockMessage blockMessage = BlockMessage::Deserialize(byteBuffer);
-			const FullBlock& block = blockMessage.GetBlock();
+			BlockMessage blockMessage = BlockMessage::Deserialize(byteBuffer);
+			FullBlock& block = blockMessage.GetBlock();
+			connection.AddKnownInventory(block.GetHash());
+			connection.GetConnectedPeer().GetStats().OnBlockReceived(block.GetHash(), rawMessage.GetPayload().size());
 
 			LOG_TRACE_F("Block received: {}", block.GetHeight());
 
-			if (m_pSyncStatus->GetStatus() == ESyncStatus::SYNCING_BLOCKS) {
-				m_pPipeline->ProcessBlock(connection, block);
+			// Blocks prefetched while the TxHashSet is processed are verified by the pipe too, and kept as orphans until it's accepted.
+			if (m_pSyncStatus->GetStatus() == ESyncStatus::SYNCING_BLOCKS || m_pSyncStatus->GetStatus() == ESyncStatus::PROCESSING_TXHASHSET) {
+				// Moved, so the pipe keeps the block's arena rather than copying every rangeproof to the heap.
+				m_pPipeline->ProcessBlock(connection, std::move(block));
 			} else {
 				const EBlockChainStatus added = m_pBlockChain->AddBlock(block);
 				if (added == EBlockChainStatus::SUCCESS) {
-					const HeaderMessage headerMessage(block.GetHeader());
-					m_connectionManager.BroadcastMessage(headerMessage, connection.GetId());
+					std::unique_ptr<CompactBlock> pCompactBlock = m_pBlockChain->GetCompactBlockByHash(block.GetHash());
+					if (pCompactBlock != nullptr) {
+						RelayBlock(connection, *pCompactBlock);
+					} else {
+						m_connectionManager.BroadcastMessage(HeaderMessage{ block.GetHeader() }, connection.GetId());
+					}
 				} else if (added == EBlockChainStatus::ORPHANED) {
 					if (block.GetTotalDifficulty() > m_pBlockChain->GetTotalDifficulty(EChainType::CONFIRMED))
 					{
@@ -244,10 +322,10 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 		case GetCompactBlock:
 		{
 			const GetCompactBlockMessage getCompactBlockMessage = GetCompactBlockMessage::Deserialize(byteBuffer);
-			std::unique_ptr<CompactBlock> pCompactBlock = m_pBlockChain->GetCompactBlockByHash(getCompactBlockMessage.GetHash());
-			if (pCompactBlock != nullptr)
+			auto pSerializedBlock = m_pBlockChain->GetSerializedCompactBlock(getCompactBlockMessage.GetHash(), protocolVersion);
+			if (pSerializedBlock != nullptr)
 			{
-				connection.SendMsg(CompactBlockMessage{ *pCompactBlock });
+				connection.SendMsg(SerializedMessage{ CompactBlockMsg, pSerializedBlock });
 			}
 
 			break;
@@ -256,12 +334,18 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 		{
 			const CompactBlockMessage compactBlockMessage = CompactBlockMessage::Deserialize(byteBuffer);
 			const CompactBlock& compactBlock = compactBlockMessage.GetCompactBlock();
+			connection.AddKnownInventory(compactBlock.GetHash());
 
+			// Peers that advertise Capabilities::COMPACT_BLOCK_PUSH may send these unrequested, before (or instead of) the header.
 			const EBlockChainStatus added = m_pBlockChain->AddCompactBlock(compactBlock);
 			if (added == EBlockChainStatus::SUCCESS)
 			{
-				const HeaderMessage headerMessage(compactBlock.GetHeader());
-				m_connectionManager.BroadcastMessage(headerMessage, connection.GetId());
+				RelayBlock(connection, compactBlock);
+				break;
+			}
+			else if (added == EBlockChainStatus::INVALID)
+			{
+				connection.BanPeer(EBanReason::BadBlockHeader);
 				break;
 			}
 			else if (added == EBlockChainStatus::TRANSACTIONS_MISSING)
@@ -286,6 +370,8 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 		{
 			if (m_pSyncStatus->GetStatus() == ESyncStatus::NOT_SYNCING) {
 				TransactionPtr pTransaction = StemTransactionMessage::Deserialize(byteBuffer).GetTransaction();
+				AddKnownKernels(connection, *pTransaction);
+				m_pTxRequester->OnTransactionReceived(*pTransaction);
 				m_pPipeline->ProcessTransaction(connection, pTransaction, EPoolType::STEMPOOL);
 			}
 
@@ -296,6 +382,8 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 		{
 			if (m_pSyncStatus->GetStatus() == ESyncStatus::NOT_SYNCING) {
 				TransactionPtr pTransaction = TransactionMessage::Deserialize(byteBuffer).GetTransaction();
+				AddKnownKernels(connection, *pTransaction);
+				m_pTxRequester->OnTransactionReceived(*pTransaction);
 				m_pPipeline->ProcessTransaction(connection, pTransaction, EPoolType::MEMPOOL);
 			}
 
@@ -320,11 +408,29 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 			TransactionPtr pTransaction = m_pBlockChain->GetTransactionByKernelHash(kernelHash);
 			if (pTransaction != nullptr) {
 				LOG_DEBUG_F("Transaction {} found.", pTransaction);
+				AddKnownKernels(connection, *pTransaction);
 				connection.SendMsg(TransactionMessage{ pTransaction });
 			}
 
 			break;
 		}
+		case GetTransactions:
+		{
+			const GetTransactionsMessage getTransactionsMessage = GetTransactionsMessage::Deserialize(byteBuffer);
+			LOG_DEBUG_F("{} transactions requested by {}.", getTransactionsMessage.GetKernelHashes().size(), connection);
+
+			// A transaction with several of the requested kernels is only sent once.
+			std::unordered_set<Hash> sent;
+			for (const Hash& kernelHash : getTransactionsMessage.GetKernelHashes()) {
+				TransactionPtr pTransaction = m_pBlockChain->GetTransactionByKernelHash(kernelHash);
+				if (pTransaction != nullptr && sent.insert(pTransaction->GetHash()).second) {
+					AddKnownKernels(connection, *pTransaction);
+					connection.SendMsg(TransactionMessage{ pTransaction });
+				}
+			}
+
+			break;
+		}
 		case TransactionKernelMsg:
 		{
 			if (m_pSyncStatus->GetStatus() != ESyncStatus::NOT_SYNCING)
@@ -333,9 +439,10 @@ void MessageProcessor::ProcessMessageInternal(Connection& connection, const RawM
 			}
 
 			Hash kernelHash = TransactionKernelMessage::Deserialize(byteBuffer).GetKernelHash();
+			connection.AddKnownInventory(kernelHash);
 			TransactionPtr pTransaction = m_pBlockChain->GetTransactionByKernelHash(kernelHash);
 			if (pTransaction == nullptr) {
-				connection.SendMsg(GetTransactionMessage{ std::move(kernelHash) });
+				m_pTxRequester->OnAnnouncement(connection, kernelHash);
 			}
 
 			break;
@@ -365,23 +472,37 @@ void MessageProcessor::SendTxHashSet(Connection& connection, const TxHashSetRequ
 		return;
 	}
 
-	fs::path zipFilePath;
-	
+	// The archive is shared with any other peers syncing from us, and its zip is deleted once the last of them is done.
+	TxHashSetArchive::CPtr pArchive = nullptr;
 	try
 	{
-		zipFilePath = m_pBlockChain->SnapshotTxHashSet(pHeader);
+		pArchive = m_pBlockChain->SnapshotTxHashSet(pHeader);
 	}
-	catch (std::exception&)
+	catch (std::exception& e)
 	{
+		LOG_WARNING_F("Failed to snapshot TxHashSet for {}: {}", connection, e.what());
 		return;
 	}
 
-	// Hack until I can determine why zips aren't deleted.
-	FileRemover remover(zipFilePath);
+	// Handlers run on the thread pool, but the socket may only be written to from the connection's strand,
+	// so the archive is streamed from there once the snapshot is ready.
+	connection.Post([pArchive](Connection& strandConnection) {
+		try
+		{
+			StreamTxHashSet(strandConnection, *pArchive);
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_F("Exception ({}) caught while sending TxHashSet to {}", e.what(), strandConnection);
+		}
+	});
+}
 
+void MessageProcessor::StreamTxHashSet(Connection& connection, const TxHashSetArchive& archive)
+{
+	const fs::path& zipFilePath = archive.GetPath();
 	std::ifstream file(zipFilePath, std::ios::in | std::ios::ate | std::ios::binary);
 	if (!file.is_open()) {
-		FileUtil::RemoveFile(zipFilePath);
 		return;
 	}
 	
@@ -389,7 +510,10 @@ void MessageProcessor::SendTxHashSet(Connection& connection, const TxHashSetRequ
 	{
 		const uint64_t fileSize = FileUtil::GetFileSize(zipFilePath);
 		file.seekg(0);
-		TxHashSetArchiveMessage archiveMessage(Hash(pHeader->GetHash()), pHeader->GetHeight(), fileSize);
+
+		// Peers accept an archive for a different block than they asked for, as long as it's on their header chain.
+		const BlockHeaderPtr& pArchiveHeader = archive.GetHeader();
+		TxHashSetArchiveMessage archiveMessage(Hash(pArchiveHeader->GetHash()), pArchiveHeader->GetHeight(), fileSize);
 		connection.SendMsg(archiveMessage);
 
 		SocketPtr pSocket = connection.GetSocket();
@@ -408,7 +532,6 @@ void MessageProcessor::SendTxHashSet(Connection& connection, const TxHashSetRequ
 			if (!sent || ShutdownManagerAPI::WasShutdownRequested()) {
 				LOG_ERROR("Transmission ended abruptly");
 				file.close();
-				FileUtil::RemoveFile(zipFilePath);
 
 				return;
 			}
@@ -424,10 +547,25 @@ void MessageProcessor::SendTxHashSet(Connection& connection, const TxHashSetRequ
 		{
 			file.close();
 		}
-		FileUtil::RemoveFile(zipFilePath);
 		throw;
 	}
 
 	file.close();
-	FileUtil::RemoveFile(zipFilePath);
-}
\ No newline at end of file
+}
+
+void MessageProcessor::AddKnownKernels(Connection& connection, const Transaction& transaction)
+{
+	for (const TransactionKernel& kernel : transaction.GetKernels())
+	{
+		connection.AddKnownInventory(kernel.GetHash());
+	}
+}
+
+void MessageProcessor::RelayBlock(const Connection& connection, const CompactBlock& compactBlock)
+{
+	m_connectionManager.BroadcastBlock(
+		HeaderMessage{ compactBlock.GetHeader() },
+		CompactBlockMessage{ compactBlock },
+		connection.GetId()
+	);
+}
@@ -2,10 +2,14 @@
 
 #include "Messages/RawMessage.h"
 #include "Seed/PeerManager.h"
+#include "HeaderBatchCache.h"
+#include "MessageDispatcher.h"
+#include "TransactionRequester.h"
 
 #include <BlockChain/BlockChain.h>
 #include <P2P/ConnectedPeer.h>
 #include <Config/Config.h>
+#include <PMMR/TxHashSetArchive.h>
 #include <memory>
 
 // Forward Declarations
@@ -36,19 +40,44 @@ public:
 		Locked<PeerManager> peerManager,
 		const IBlockChain::Ptr& pBlockChain,
 		const std::shared_ptr<Pipeline>& pipeline,
-		SyncStatusConstPtr pSyncStatus
+		SyncStatusConstPtr pSyncStatus,
+		const HeaderBatchCache::Ptr& pHeaderCache
 	);
+	~MessageProcessor();
 
-	void ProcessMessage(Connection& connection, const RawMessage& rawMessage);
+	//
+	// Called on the connection's strand for each message received.
+	// Time-sensitive messages are handled right away, and the rest are queued to be handled on the thread pool.
+	//
+	void ReceiveMessage(const std::shared_ptr<Connection>& pConnection, std::unique_ptr<RawMessage>&& pRawMessage);
 
 private:
+	void ProcessMessage(Connection& connection, const RawMessage& rawMessage);
 	void ProcessMessageInternal(Connection& connection, const RawMessage& rawMessage);
 	void SendTxHashSet(Connection& connection, const TxHashSetRequestMessage& txHashSetRequestMessage);
 
+	//
+	// Writes the archive directly to the socket, so must be called from the connection's strand.
+	//
+	static void StreamTxHashSet(Connection& connection, const TxHashSetArchive& archive);
+
+	//
+	// A peer that sent us a transaction, or that we sent one to, doesn't need its kernels announced.
+	//
+	static void AddKnownKernels(Connection& connection, const Transaction& transaction);
+
+	//
+	// Relays a block that was just accepted from connection to the other peers. See ConnectionManager::BroadcastBlock.
+	//
+	void RelayBlock(const Connection& connection, const CompactBlock& compactBlock);
+
 	const Config& m_config;
 	ConnectionManager& m_connectionManager;
 	Locked<PeerManager> m_peerManager;
 	IBlockChain::Ptr m_pBlockChain;
 	std::shared_ptr<Pipeline> m_pPipeline;
 	SyncStatusConstPtr m_pSyncStatus;
+	HeaderBatchCache::Ptr m_pHeaderCache;
+	TransactionRequester::Ptr m_pTxRequester;
+	MessageDispatcher::Ptr m_pDispatcher;
 };
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "MessageRateLimiter.h"
+
+#include <algorithm>
+
+// A peer may have this many messages skipped at once, and this many per minute after that, before it's considered abusive.
+static const double MAX_THROTTLED_BURST = 500.0;
+static const double MAX_THROTTLED_PER_SEC = 500.0 / 60.0;
+
+MessageRateLimiter::Bucket MessageRateLimiter::Bucket::Create(const double rate, const double burstSecs)
+{
+	// Always room for at least one message, so rare messages like TxHashSetRequest can still be sent.
+	const double capacity = std::max(rate * burstSecs, 1.0);
+	return Bucket{ rate, capacity, capacity };
+}
+
+void MessageRateLimiter::Bucket::Refill(const double elapsedSecs) noexcept
+{
+	tokens = std::min(tokens + rate * elapsedSecs, capacity);
+}
+
+MessageRateLimiter::MessageRateLimiter(const P2PConfig& config)
+	: m_numThrottled(0)
+{
+	const double burstSecs = std::max(config.GetRateLimitBurstSecs(), 1.0);
+	const auto& overrides = config.GetRateLimits();
+	const Clock::time_point now = Clock::now();
+
+	for (size_t i = 0; i < NUM_MESSAGE_TYPES; i++)
+	{
+		const MessageTypes::EMessageType messageType = GetMessageType(i);
+
+		MessageRateLimit limit = GetDefaultLimit(messageType);
+		if (i < NUM_MESSAGE_TYPES - 1)
+		{
+			// ToString returns "Msg::<Name>".
+			auto iter = overrides.find(MessageTypes::ToString(messageType).substr(5));
+			if (iter != overrides.end())
+			{
+				limit = iter->second;
+			}
+		}
+
+		m_buckets[i] = TypeBuckets{
+			Bucket::Create(limit.messagesPerSec, burstSecs),
+			Bucket::Create(limit.bytesPerSec, burstSecs),
+			now
+		};
+	}
+
+	m_throttled = Bucket{ MAX_THROTTLED_PER_SEC, MAX_THROTTLED_BURST, MAX_THROTTLED_BURST };
+	m_lastThrottledRefill = now;
+}
+
+bool MessageRateLimiter::Allow(const MessageTypes::EMessageType messageType, const uint64_t numBytes)
+{
+	const Clock::time_point now = Clock::now();
+	TypeBuckets& buckets = m_buckets[GetIndex(messageType)];
+
+	const double elapsedSecs = std::chrono::duration<double>(now - buckets.lastRefill).count();
+	buckets.messages.Refill(elapsedSecs);
+	buckets.bytes.Refill(elapsedSecs);
+	buckets.lastRefill = now;
+
+	const bool allowed = (buckets.messages.IsUnlimited() || buckets.messages.tokens > 0.0)
+		&& (buckets.bytes.IsUnlimited() || buckets.bytes.tokens > 0.0);
+	if (allowed)
+	{
+		buckets.messages.tokens -= 1.0;
+		buckets.bytes.tokens -= (double)numBytes;
+		return true;
+	}
+
+	m_throttled.Refill(std::chrono::duration<double>(now - m_lastThrottledRefill).count());
+	m_lastThrottledRefill = now;
+	m_throttled.tokens -= 1.0;
+	++m_numThrottled;
+
+	return false;
+}
+
+//
+// Limits are well above what an honest peer sends: responses to our own requests are bounded by how much we ask for,
+// so they're generous, while unsolicited messages that are expensive to validate or relay are held much tighter.
+//
+MessageRateLimit MessageRateLimiter::GetDefaultLimit(const MessageTypes::EMessageType messageType)
+{
+	switch (messageType)
+	{
+		// Pings are sent every 10 seconds, and everything else here once per connection.
+		case MessageTypes::Error:
+		case MessageTypes::Hand:
+		case MessageTypes::Shake:
+		case MessageTypes::Ping:
+		case MessageTypes::Pong:
+		case MessageTypes::BanReasonMsg:
+			return MessageRateLimit{ 1.0, 0.0 };
+
+		// Peer addresses are requested when a peer is short on peers, and each one we receive has to be stored.
+		case MessageTypes::GetPeerAddrs:
+		case MessageTypes::PeerAddrs:
+			return MessageRateLimit{ 0.2, 0.0 };
+
+		// Each request costs a header lookup from the db, and each header a proof-of-work verification.
+		case MessageTypes::GetHeaders:
+			return MessageRateLimit{ 20.0, 0.0 };
+		case MessageTypes::Header:
+			return MessageRateLimit{ 20.0, 0.0 };
+		case MessageTypes::Headers:
+			return MessageRateLimit{ 20.0, 8.0 * 1024 * 1024 };
+
+		// Serving and receiving blocks during sync. The bytes limit still stops a peer from flooding us with unrequested blocks.
+		case MessageTypes::GetBlock:
+		case MessageTypes::GetCompactBlock:
+			return MessageRateLimit{ 256.0, 0.0 };
+		case MessageTypes::Block:
+			return MessageRateLimit{ 256.0, 64.0 * 1024 * 1024 };
+		case MessageTypes::CompactBlockMsg:
+			return MessageRateLimit{ 10.0, 1024.0 * 1024 };
+
+		// Every transaction is fully validated, rangeproofs and all, which costs roughly in proportion to its size.
+		case MessageTypes::StemTransaction:
+		case MessageTypes::TransactionMsg:
+			return MessageRateLimit{ 20.0, 256.0 * 1024 };
+		case MessageTypes::GetTransactionMsg:
+		case MessageTypes::TransactionKernelMsg:
+			return MessageRateLimit{ 50.0, 0.0 };
+		case MessageTypes::GetTransactions:
+			return MessageRateLimit{ 10.0, 0.0 };
+
+		// Building a txhashset archive is the most expensive thing a peer can ask of us.
+		case MessageTypes::TxHashSetRequest:
+			return MessageRateLimit{ 1.0 / 600.0, 0.0 };
+		case MessageTypes::TxHashSetArchive:
+			return MessageRateLimit{ 1.0 / 60.0, 0.0 };
+
+		case MessageTypes::GetKernels:
+		case MessageTypes::Kernels:
+			return MessageRateLimit{ 20.0, 8.0 * 1024 * 1024 };
+	}
+
+	return MessageRateLimit{ 1.0, 0.0 };
+}
+
+size_t MessageRateLimiter::GetIndex(const MessageTypes::EMessageType messageType) noexcept
+{
+	if ((size_t)messageType <= MessageTypes::Kernels)
+	{
+		return (size_t)messageType;
+	}
+
+	return messageType == MessageTypes::GetTransactions ? MessageTypes::Kernels + 1 : NUM_MESSAGE_TYPES - 1;
+}
+
+MessageTypes::EMessageType MessageRateLimiter::GetMessageType(const size_t index) noexcept
+{
+	return index == MessageTypes::Kernels + 1 ? MessageTypes::GetTransactions : (MessageTypes::EMessageType)index;
+}
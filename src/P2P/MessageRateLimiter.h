@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Messages/MessageTypes.h"
+
+#include <Config/P2PConfig.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+//
+// Per-message-type token buckets limiting how many messages, and how many bytes of them, a peer may send us.
+// The default rates are weighted by how expensive each message is to handle, so cheap responses to our own requests
+// (blocks and headers during sync) are allowed far more than transactions, which each cost a full validation.
+// A message that exceeds its limit is skipped rather than processed, and the peer is only considered abusive
+// once it keeps sending well past its limits.
+// Not thread-safe; it's only used from its connection's strand.
+//
+class MessageRateLimiter
+{
+public:
+	explicit MessageRateLimiter(const P2PConfig& config);
+
+	//
+	// Consumes the tokens for a message of the given type and size.
+	// Returns false if the message exceeds its limits, in which case it should be skipped.
+	//
+	bool Allow(const MessageTypes::EMessageType messageType, const uint64_t numBytes);
+
+	//
+	// True once the peer has had so many messages skipped that it's flooding us on purpose.
+	//
+	bool IsAbusive() const noexcept { return m_throttled.tokens <= 0.0; }
+
+	uint64_t GetNumThrottled() const noexcept { return m_numThrottled; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	// Every message type up to Kernels, then GetTransactions, plus one slot that unknown types are counted in.
+	static constexpr size_t NUM_MESSAGE_TYPES = MessageTypes::Kernels + 3;
+
+	//
+	// Tokens are only required to be positive, so a message larger than the whole bucket still gets through
+	// once, leaving the bucket in debt until it's refilled.
+	//
+	struct Bucket
+	{
+		double rate;
+		double capacity;
+		double tokens;
+
+		static Bucket Create(const double rate, const double burstSecs);
+
+		bool IsUnlimited() const noexcept { return rate <= 0.0; }
+		void Refill(const double elapsedSecs) noexcept;
+	};
+
+	struct TypeBuckets
+	{
+		Bucket messages;
+		Bucket bytes;
+		Clock::time_point lastRefill;
+	};
+
+	static MessageRateLimit GetDefaultLimit(const MessageTypes::EMessageType messageType);
+	static size_t GetIndex(const MessageTypes::EMessageType messageType) noexcept;
+	static MessageTypes::EMessageType GetMessageType(const size_t index) noexcept;
+
+	std::array<TypeBuckets, NUM_MESSAGE_TYPES> m_buckets;
+
+	// One token is taken for each skipped message. Running out means the peer is abusive.
+	Bucket m_throttled;
+	Clock::time_point m_lastThrottledRefill;
+	uint64_t m_numThrottled;
+};
@@ -1,9 +1,11 @@
 #include "MessageRetriever.h"
+#include "MessageCompressor.h"
 #include "Messages/MessageHeader.h"
 
 #include <P2P/Peer.h>
 #include <Core/Serialization/ByteBuffer.h>
 #include <Core/Serialization/Serializer.h>
+#include <Common/AllocProfiler.h>
 #include <Common/Logger.h>
 
 std::unique_ptr<RawMessage> MessageRetriever::RetrieveMessage(
@@ -11,31 +13,101 @@ std::unique_ptr<RawMessage> MessageRetriever::RetrieveMessage(
 	const Peer& peer,
 	const Socket::ERetrievalMode mode) const
 {
-	std::vector<uint8_t> headerBuffer;
-	const bool received = socket.Receive(11, true, mode, headerBuffer);
-	if (!received) {
-		return std::unique_ptr<RawMessage>(nullptr);
-	}
+	ScopedAllocTag allocTag(EAllocTag::P2P_MESSAGES);
 
-	ByteBuffer byteBuffer(std::move(headerBuffer));
-	MessageHeader messageHeader = MessageHeader::Deserialize(m_config.GetEnvironment(), byteBuffer);
+	MessageHeader messageHeader;
+	{
+		// Released before the payload is acquired, so both can reuse the same pooled allocation.
+		MessageBufferPool::Buffer pHeaderBuffer = AcquireBuffer(11);
+		const bool received = socket.Receive(11, true, mode, *pHeaderBuffer);
+		if (!received) {
+			return std::unique_ptr<RawMessage>(nullptr);
+		}
 
-	const auto type = messageHeader.GetMessageType();
-	if (type != MessageTypes::Ping && type != MessageTypes::Pong) {
-		LOG_TRACE_F( "Received '{}' message from {}", MessageTypes::ToString(type), peer);
+		ByteBuffer byteBuffer(pHeaderBuffer->data(), pHeaderBuffer->size());
+		messageHeader = MessageHeader::Deserialize(m_config.GetEnvironment(), byteBuffer);
 	}
 
-	std::vector<uint8_t> payload;
+	LogHeader(messageHeader, peer);
+
+	MessageBufferPool::Buffer pPayload = AcquireBuffer(messageHeader.GetMessageLength());
 	const bool bPayloadRetrieved = socket.Receive(
 		messageHeader.GetMessageLength(),
 		false,
 		Socket::BLOCKING,
-		payload
+		*pPayload
 	);
 	if (!bPayloadRetrieved) {
 		throw DESERIALIZATION_EXCEPTION("Expected payload not received");
 	}
 
+	return ToRawMessage(peer, std::move(messageHeader), std::move(pPayload));
+}
+
+std::unique_ptr<RawMessage> MessageRetriever::ContinueMessage(Socket& socket, const Peer& peer, PartialMessage& partial) const
+{
+	ScopedAllocTag allocTag(EAllocTag::P2P_MESSAGES);
+
+	if (!partial.header.has_value()) {
+		const size_t numHeaderBytes = partial.headerBytes.size();
+		partial.headerBytes.resize(11);
+		const size_t received = socket.ReceiveAvailable(11 - numHeaderBytes, partial.headerBytes.data() + numHeaderBytes);
+		partial.headerBytes.resize(numHeaderBytes + received);
+		if (partial.headerBytes.size() < 11) {
+			return std::unique_ptr<RawMessage>(nullptr);
+		}
+
+		ByteBuffer byteBuffer(partial.headerBytes.data(), partial.headerBytes.size());
+		partial.header = MessageHeader::Deserialize(m_config.GetEnvironment(), byteBuffer);
+		partial.headerBytes.clear();
+		socket.GetRateCounter().AddMessageReceived();
+
+		LogHeader(partial.header.value(), peer);
+		partial.pPayload = AcquireBuffer(partial.header->GetMessageLength());
+		partial.pPayload->resize(partial.header->GetMessageLength());
+		partial.payloadBytes = 0;
+	}
+
+	const size_t payloadSize = partial.pPayload->size();
+	partial.payloadBytes += socket.ReceiveAvailable(payloadSize - partial.payloadBytes, partial.pPayload->data() + partial.payloadBytes);
+	if (partial.payloadBytes < payloadSize) {
+		return std::unique_ptr<RawMessage>(nullptr);
+	}
+
+	MessageHeader messageHeader = std::move(partial.header.value());
+	partial.header.reset();
+	return ToRawMessage(peer, std::move(messageHeader), std::move(partial.pPayload));
+}
+
+void MessageRetriever::LogHeader(const MessageHeader& messageHeader, const Peer& peer) const
+{
+	const auto type = messageHeader.GetMessageType();
+	if (type != MessageTypes::Ping && type != MessageTypes::Pong) {
+		LOG_TRACE_F( "Received '{}' message from {}", MessageTypes::ToString(type), peer);
+	}
+}
+
+std::unique_ptr<RawMessage> MessageRetriever::ToRawMessage(const Peer& peer, MessageHeader&& messageHeader, MessageBufferPool::Buffer&& pPayload) const
+{
 	peer.UpdateLastContactTime();
-	return std::make_unique<RawMessage>(std::move(messageHeader), std::move(payload));
+
+	if (messageHeader.GetMessageType() == MessageTypes::Compressed) {
+		// Unwrapped here, so everything downstream sees the original message.
+		const RawMessage compressedMessage(std::move(messageHeader), std::move(pPayload));
+		MessageHeader innerHeader = MessageCompressor::GetInnerHeader(compressedMessage);
+		MessageBufferPool::Buffer pInnerPayload = AcquireBuffer(innerHeader.GetMessageLength());
+		MessageCompressor::Decompress(compressedMessage, *pInnerPayload);
+		return std::make_unique<RawMessage>(std::move(innerHeader), std::move(pInnerPayload));
+	}
+
+	return std::make_unique<RawMessage>(std::move(messageHeader), std::move(pPayload));
+}
+
+MessageBufferPool::Buffer MessageRetriever::AcquireBuffer(const size_t numBytes) const
+{
+	if (m_pBufferPool != nullptr) {
+		return m_pBufferPool->Acquire(numBytes);
+	}
+
+	return MessageBufferPool::Wrap(std::vector<uint8_t>(numBytes));
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
 #pragma once
 
 #include "Messages/RawMessage.h"
+#include "Messages/MessageHeader.h"
+#include "MessageBufferPool.h"
 
 #include <Net/Socket.h>
 #include <Config/Config.h>
 #include <memory>
+#include <optional>
 #include <vector>
 #include <string>
 
@@ -14,7 +17,8 @@ class Peer;
 class MessageRetriever
 {
 public:
-	MessageRetriever(const Config& config) : m_config(config) { }
+	MessageRetriever(const Config& config, const MessageBufferPool::Ptr& pBufferPool = nullptr)
+		: m_config(config), m_pBufferPool(pBufferPool) { }
 
 	std::unique_ptr<RawMessage> RetrieveMessage(
 		Socket& socket,
@@ -22,6 +26,28 @@ public:
 		const Socket::ERetrievalMode mode
 	) const;
 
+	//
+	// The part of a message that ContinueMessage has read so far.
+	//
+	struct PartialMessage
+	{
+		std::vector<uint8_t> headerBytes;
+		std::optional<MessageHeader> header;
+		MessageBufferPool::Buffer pPayload;
+		size_t payloadBytes = 0;
+	};
+
+	//
+	// Reads as much of the next message as has already arrived, without waiting for the rest.
+	// Returns the message once all of it has been read, or nullptr if there's more to come, with what was read kept in partial.
+	//
+	std::unique_ptr<RawMessage> ContinueMessage(Socket& socket, const Peer& peer, PartialMessage& partial) const;
+
 private:
+	MessageBufferPool::Buffer AcquireBuffer(const size_t numBytes) const;
+	void LogHeader(const MessageHeader& messageHeader, const Peer& peer) const;
+	std::unique_ptr<RawMessage> ToRawMessage(const Peer& peer, MessageHeader&& messageHeader, MessageBufferPool::Buffer&& pPayload) const;
+
 	const Config& m_config;
+	MessageBufferPool::Ptr m_pBufferPool;
 };
\ No newline at end of file
@@ -39,13 +39,14 @@ public:
 	//
 	MessageTypes::EMessageType GetMessageType() const final { return MessageTypes::Block; }
 	const FullBlock& GetBlock() const { return m_block; }
+	FullBlock& GetBlock() { return m_block; }
 
 	//
 	// Deserialization
 	//
 	static BlockMessage Deserialize(ByteBuffer& byteBuffer)
 	{
-		FullBlock block = FullBlock::Deserialize(byteBuffer);
+		FullBlock block = FullBlock::DeserializeWithArena(byteBuffer);
 		return BlockMessage(std::move(block));
 	}
 
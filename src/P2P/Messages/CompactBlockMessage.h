@@ -44,6 +44,7 @@ public:
 	//
 	MessageTypes::EMessageType GetMessageType() const final { return MessageTypes::CompactBlockMsg; }
 	const CompactBlock& GetCompactBlock() const { return m_block; }
+	std::optional<Hash> GetInventoryHash() const final { return std::make_optional(m_block.GetHash()); }
 
 	//
 	// Deserialization
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Message.h"
+
+#include <Crypto/Hash.h>
+#include <Core/Exceptions/DeserializationException.h>
+#include <P2P/Common.h>
+
+//
+// Requests the transactions for up to P2P::MAX_TX_REQUESTS kernel hashes at once.
+// Each transaction found is sent back as its own TransactionMessage, just as for GetTransactionMessage.
+//
+class GetTransactionsMessage : public IMessage
+{
+public:
+	//
+	// Constructors
+	//
+	GetTransactionsMessage(std::vector<Hash>&& kernelHashes)
+		: m_kernelHashes(std::move(kernelHashes))
+	{
+
+	}
+	GetTransactionsMessage(const GetTransactionsMessage& other) = default;
+	GetTransactionsMessage(GetTransactionsMessage&& other) noexcept = default;
+
+	//
+	// Destructor
+	//
+	virtual ~GetTransactionsMessage() = default;
+
+	//
+	// Operators
+	//
+	GetTransactionsMessage& operator=(const GetTransactionsMessage& other) = default;
+	GetTransactionsMessage& operator=(GetTransactionsMessage&& other) noexcept = default;
+
+	//
+	// Clone
+	//
+	IMessagePtr Clone() const final { return IMessagePtr(new GetTransactionsMessage(*this)); }
+
+	//
+	// Getters
+	//
+	MessageTypes::EMessageType GetMessageType() const final { return MessageTypes::GetTransactions; }
+	const std::vector<Hash>& GetKernelHashes() const { return m_kernelHashes; }
+
+	//
+	// Deserialization
+	//
+	static GetTransactionsMessage Deserialize(ByteBuffer& byteBuffer)
+	{
+		const uint16_t numHashes = byteBuffer.ReadU16();
+		if (numHashes > P2P::MAX_TX_REQUESTS)
+		{
+			throw DESERIALIZATION_EXCEPTION_F("Requested {} transactions at once", numHashes);
+		}
+
+		std::vector<Hash> kernelHashes;
+		kernelHashes.reserve(numHashes);
+		for (uint16_t i = 0; i < numHashes; i++)
+		{
+			kernelHashes.emplace_back(byteBuffer.ReadBigInteger<32>());
+		}
+
+		return GetTransactionsMessage(std::move(kernelHashes));
+	}
+
+protected:
+	void SerializeBody(Serializer& serializer) const final
+	{
+		serializer.Append<uint16_t>((uint16_t)m_kernelHashes.size());
+		for (const Hash& kernelHash : m_kernelHashes)
+		{
+			serializer.AppendBigInteger<32>(kernelHash);
+		}
+	}
+
+private:
+	std::vector<Hash> m_kernelHashes;
+};
@@ -39,6 +39,7 @@ public:
 	//
 	MessageTypes::EMessageType GetMessageType() const final { return MessageTypes::Header; }
 	const BlockHeaderPtr& GetHeader() const { return m_pHeader; }
+	std::optional<Hash> GetInventoryHash() const final { return std::make_optional(m_pHeader->GetHash()); }
 
 	//
 	// Deserialization
@@ -6,6 +6,8 @@
 #include <Config/Config.h>
 #include <Core/Serialization/ByteBuffer.h>
 #include <Core/Serialization/Serializer.h>
+#include <Crypto/Hash.h>
+#include <optional>
 
 class IMessage
 {
@@ -16,6 +18,12 @@ public:
 	virtual MessageTypes::EMessageType GetMessageType() const = 0;
 	virtual void SerializeBody(Serializer& serializer) const = 0;
 
+	//
+	// The hash of the kernel or block announced by the message, if it's an announcement.
+	// Broadcasts skip the peers already known to have seen it.
+	//
+	virtual std::optional<Hash> GetInventoryHash() const { return std::nullopt; }
+
 	std::vector<uint8_t> Serialize(const Environment& environment, const EProtocolVersion protocolVersion) const
 	{
 		Serializer serializer(protocolVersion);
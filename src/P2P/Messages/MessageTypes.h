@@ -30,7 +30,13 @@ namespace MessageTypes
 		GetTransactionMsg = 19,
 		TransactionKernelMsg = 20,
 		GetKernels = 21,
-		Kernels = 22
+		Kernels = 22,
+
+		// Grin++ only, and only sent to peers that advertise Capabilities::COMPRESSION. See MessageCompressor.
+		Compressed = 128,
+
+		// Grin++ only, and only sent to peers that advertise Capabilities::TX_BATCH_REQUESTS.
+		GetTransactions = 129
 	};
 
 	static uint64_t GetMaximumSize(const EMessageType messageType)
@@ -79,6 +85,10 @@ namespace MessageTypes
 				return 32;
 			case TransactionKernelMsg:
 				return 32;
+			case Compressed:
+				return P2P::MAX_BLOCK_SIZE;
+			case GetTransactions:
+				return 2 + 32 * ((uint64_t)P2P::MAX_TX_REQUESTS);
 		}
 
 		return 0;
@@ -130,6 +140,14 @@ namespace MessageTypes
 				return "Msg::GetTransactionMsg";
 			case TransactionKernelMsg:
 				return "Msg::TransactionKernelMsg";
+			case GetKernels:
+				return "Msg::GetKernels";
+			case Kernels:
+				return "Msg::Kernels";
+			case Compressed:
+				return "Msg::Compressed";
+			case GetTransactions:
+				return "Msg::GetTransactions";
 		}
 
 		return "UNKNOWN";
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "MessageHeader.h"
+#include "../MessageBufferPool.h"
 
+#include <Core/Serialization/ByteBuffer.h>
 #include <vector>
 
 class RawMessage
@@ -10,12 +12,17 @@ public:
 	//
 	// Constructors
 	//
+	RawMessage(MessageHeader&& messageHeader, MessageBufferPool::Buffer&& pPayload)
+		: m_messageHeader(messageHeader), m_pPayload(std::move(pPayload))
+	{
+
+	}
 	RawMessage(MessageHeader&& messageHeader, std::vector<unsigned char>&& payload)
-		: m_messageHeader(messageHeader), m_payload(std::move(payload))
+		: m_messageHeader(messageHeader), m_pPayload(MessageBufferPool::Wrap(std::move(payload)))
 	{
 
 	}
-	RawMessage(const RawMessage& other) = default;
+	RawMessage(const RawMessage& other) = delete;
 	RawMessage(RawMessage&& other) noexcept = default;
 
 	//
@@ -26,16 +33,24 @@ public:
 	//
 	// Operators
 	//
-	RawMessage& operator=(const RawMessage& other) = default;
+	RawMessage& operator=(const RawMessage& other) = delete;
 	RawMessage& operator=(RawMessage&& other) noexcept = default;
 
 	//
 	// Getters
 	//
 	const MessageHeader& GetMessageHeader() const { return m_messageHeader; }
-	const std::vector<unsigned char>& GetPayload() const { return m_payload; }
+	const std::vector<unsigned char>& GetPayload() const { return *m_pPayload; }
+
+	//
+	// Returns a non-owning ByteBuffer over the payload, which is only valid while this RawMessage is alive.
+	//
+	ByteBuffer GetPayloadView(const EProtocolVersion version = EProtocolVersion::V1) const
+	{
+		return ByteBuffer(m_pPayload->data(), m_pPayload->size(), version);
+	}
 
 private:
 	MessageHeader m_messageHeader;
-	std::vector<unsigned char> m_payload;
-};
\ No newline at end of file
+	MessageBufferPool::Buffer m_pPayload;
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "Message.h"
+
+#include <cstdint>
+#include <vector>
+
+//
+// A HeadersMessage whose headers are already serialized, so cached headers can be sent without reserializing them.
+// Only used for sending. Received headers are deserialized as a HeadersMessage.
+//
+class SerializedHeadersMessage : public IMessage
+{
+public:
+	//
+	// Constructors
+	//
+	SerializedHeadersMessage(const uint16_t numHeaders, std::vector<uint8_t>&& serializedHeaders)
+		: m_numHeaders(numHeaders), m_serializedHeaders(std::move(serializedHeaders))
+	{
+
+	}
+	SerializedHeadersMessage(const SerializedHeadersMessage& other) = default;
+	SerializedHeadersMessage(SerializedHeadersMessage&& other) noexcept = default;
+
+	//
+	// Destructor
+	//
+	virtual ~SerializedHeadersMessage() = default;
+
+	//
+	// Operators
+	//
+	SerializedHeadersMessage& operator=(const SerializedHeadersMessage& other) = default;
+	SerializedHeadersMessage& operator=(SerializedHeadersMessage&& other) noexcept = default;
+
+	//
+	// Clone
+	//
+	IMessagePtr Clone() const final { return IMessagePtr(new SerializedHeadersMessage(*this)); }
+
+	//
+	// Getters
+	//
+	MessageTypes::EMessageType GetMessageType() const final { return MessageTypes::Headers; }
+	uint16_t GetNumHeaders() const noexcept { return m_numHeaders; }
+
+protected:
+	void SerializeBody(Serializer& serializer) const final
+	{
+		serializer.Append<uint16_t>(m_numHeaders);
+		serializer.AppendByteVector(m_serializedHeaders);
+	}
+
+private:
+	uint16_t m_numHeaders;
+	std::vector<uint8_t> m_serializedHeaders;
+};
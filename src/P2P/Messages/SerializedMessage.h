@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Message.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//
+// A message whose body was already serialized for the connection's protocol version, eg. a cached block.
+// Only used for sending. The body is shared, so the same bytes can be sent to many peers without copying them first.
+//
+class SerializedMessage : public IMessage
+{
+public:
+	//
+	// Constructors
+	//
+	SerializedMessage(const MessageTypes::EMessageType messageType, const std::shared_ptr<const std::vector<uint8_t>>& pBody)
+		: m_messageType(messageType), m_pBody(pBody)
+	{
+
+	}
+	SerializedMessage(const SerializedMessage& other) = default;
+	SerializedMessage(SerializedMessage&& other) noexcept = default;
+
+	//
+	// Destructor
+	//
+	virtual ~SerializedMessage() = default;
+
+	//
+	// Operators
+	//
+	SerializedMessage& operator=(const SerializedMessage& other) = default;
+	SerializedMessage& operator=(SerializedMessage&& other) noexcept = default;
+
+	//
+	// Clone
+	//
+	IMessagePtr Clone() const final { return IMessagePtr(new SerializedMessage(*this)); }
+
+	//
+	// Getters
+	//
+	MessageTypes::EMessageType GetMessageType() const final { return m_messageType; }
+
+protected:
+	void SerializeBody(Serializer& serializer) const final
+	{
+		serializer.AppendByteVector(*m_pBody);
+	}
+
+private:
+	MessageTypes::EMessageType m_messageType;
+	std::shared_ptr<const std::vector<uint8_t>> m_pBody;
+};
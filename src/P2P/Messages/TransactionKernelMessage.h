@@ -44,6 +44,7 @@ public:
 	//
 	MessageTypes::EMessageType GetMessageType() const final { return MessageTypes::TransactionKernelMsg; }
 	const Hash& GetKernelHash() const { return m_kernelHash; }
+	std::optional<Hash> GetInventoryHash() const final { return std::make_optional(m_kernelHash); }
 
 	//
 	// Deserialization
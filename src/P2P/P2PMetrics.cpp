@@ -0,0 +1,156 @@
+#include "P2PMetrics.h"
+#include "MessageCompressor.h"
+
+#include <Common/Metrics.h>
+#include <array>
+
+// One past the highest known message type, which is where unknown types are counted.
+static constexpr size_t NUM_MESSAGE_TYPES = MessageTypes::Kernels + 2;
+
+struct DirectionCounters
+{
+	std::array<MetricCounter*, NUM_MESSAGE_TYPES> messages;
+	std::array<MetricCounter*, NUM_MESSAGE_TYPES> bytes;
+};
+
+static std::string GetTypeLabel(const size_t messageType)
+{
+	if (messageType == NUM_MESSAGE_TYPES - 1)
+	{
+		return "Unknown";
+	}
+
+	// ToString returns "Msg::<Name>".
+	return MessageTypes::ToString((MessageTypes::EMessageType)messageType).substr(5);
+}
+
+static DirectionCounters RegisterCounters(const std::string& direction)
+{
+	DirectionCounters counters;
+	for (size_t i = 0; i < NUM_MESSAGE_TYPES; i++)
+	{
+		const std::string labels = MetricsWriter::Label("type", GetTypeLabel(i));
+		counters.messages[i] = &MetricsAPI::RegisterCounter(
+			"grin_p2p_messages_" + direction + "_total",
+			"Number of P2P messages " + direction + ", by message type.",
+			labels
+		);
+		counters.bytes[i] = &MetricsAPI::RegisterCounter(
+			"grin_p2p_bytes_" + direction + "_total",
+			"Bytes of P2P messages " + direction + ", including headers, by message type.",
+			labels
+		);
+	}
+
+	return counters;
+}
+
+static size_t GetIndex(const MessageTypes::EMessageType messageType)
+{
+	return (size_t)messageType < NUM_MESSAGE_TYPES - 1 ? (size_t)messageType : NUM_MESSAGE_TYPES - 1;
+}
+
+static void Record(const DirectionCounters& counters, const MessageTypes::EMessageType messageType, const uint64_t numBytes)
+{
+	const size_t index = GetIndex(messageType);
+	counters.messages[index]->Add();
+	counters.bytes[index]->Add(numBytes);
+}
+
+void P2PMetrics::OnMessageReceived(const MessageTypes::EMessageType messageType, const uint64_t numBytes)
+{
+	static const DirectionCounters received = RegisterCounters("received");
+	Record(received, messageType, numBytes);
+}
+
+void P2PMetrics::OnMessageSent(const MessageTypes::EMessageType messageType, const uint64_t numBytes)
+{
+	static const DirectionCounters sent = RegisterCounters("sent");
+	Record(sent, messageType, numBytes);
+}
+
+void P2PMetrics::OnMessageThrottled(const MessageTypes::EMessageType messageType)
+{
+	static const std::array<MetricCounter*, NUM_MESSAGE_TYPES> throttled = []() {
+		std::array<MetricCounter*, NUM_MESSAGE_TYPES> counters;
+		for (size_t i = 0; i < NUM_MESSAGE_TYPES; i++)
+		{
+			counters[i] = &MetricsAPI::RegisterCounter(
+				"grin_p2p_messages_throttled_total",
+				"Number of P2P messages skipped for exceeding their rate limit, by message type.",
+				MetricsWriter::Label("type", GetTypeLabel(i))
+			);
+		}
+
+		return counters;
+	}();
+
+	throttled[GetIndex(messageType)]->Add();
+}
+
+struct CompressionCounters
+{
+	// Only registered for the compressible types.
+	std::array<MetricCounter*, NUM_MESSAGE_TYPES> uncompressedBytes{};
+	std::array<MetricCounter*, NUM_MESSAGE_TYPES> compressedBytes{};
+	std::array<MetricCounter*, NUM_MESSAGE_TYPES> micros{};
+};
+
+static CompressionCounters RegisterCompressionCounters(const std::string& direction)
+{
+	CompressionCounters counters;
+	for (size_t i = 0; i < NUM_MESSAGE_TYPES - 1; i++)
+	{
+		if (!MessageCompressor::IsCompressible((MessageTypes::EMessageType)i))
+		{
+			continue;
+		}
+
+		const std::string labels = MetricsWriter::Label("direction", direction) + "," + MetricsWriter::Label("type", GetTypeLabel(i));
+		counters.uncompressedBytes[i] = &MetricsAPI::RegisterCounter(
+			"grin_p2p_compression_uncompressed_bytes_total",
+			"Payload bytes of P2P messages considered for compression, before compressing.",
+			labels
+		);
+		counters.compressedBytes[i] = &MetricsAPI::RegisterCounter(
+			"grin_p2p_compression_compressed_bytes_total",
+			"Payload bytes of P2P messages considered for compression, as sent or received.",
+			labels
+		);
+		counters.micros[i] = &MetricsAPI::RegisterCounter(
+			"grin_p2p_compression_microseconds_total",
+			"Time spent compressing or decompressing P2P messages.",
+			labels
+		);
+	}
+
+	return counters;
+}
+
+static void RecordCompression(
+	const CompressionCounters& counters,
+	const MessageTypes::EMessageType messageType,
+	const uint64_t uncompressedBytes,
+	const uint64_t compressedBytes,
+	const uint64_t micros)
+{
+	const size_t index = GetIndex(messageType);
+	if (counters.micros[index] != nullptr)
+	{
+		counters.uncompressedBytes[index]->Add(uncompressedBytes);
+		counters.compressedBytes[index]->Add(compressedBytes);
+		counters.micros[index]->Add(micros);
+	}
+}
+
+void P2PMetrics::OnMessageCompressed(const MessageTypes::EMessageType messageType, const uint64_t numBytesIn, const uint64_t numBytesOut, const uint64_t micros)
+{
+	static const CompressionCounters sent = RegisterCompressionCounters("sent");
+	RecordCompression(sent, messageType, numBytesIn, numBytesOut, micros);
+}
+
+void P2PMetrics::OnMessageDecompressed(const MessageTypes::EMessageType messageType, const uint64_t numBytesIn, const uint64_t numBytesOut, const uint64_t micros)
+{
+	static const CompressionCounters received = RegisterCompressionCounters("received");
+	RecordCompression(received, messageType, numBytesOut, numBytesIn, micros);
+}
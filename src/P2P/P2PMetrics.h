@@ -0,0 +1,30 @@
+#pragma once
+
+#include "Messages/MessageTypes.h"
+
+#include <cstddef>
+#include <cstdint>
+
+//
+// Per-message-type counts of the messages and bytes exchanged with peers, exported by the /metrics endpoint.
+// The counters are registered on first use, so recording a message is just a few relaxed atomic adds.
+//
+class P2PMetrics
+{
+public:
+	// The size of the magic bytes, message type, and message length that precede each payload.
+	static constexpr size_t HEADER_SIZE = 11;
+
+	static void OnMessageReceived(const MessageTypes::EMessageType messageType, const uint64_t numBytes);
+	static void OnMessageSent(const MessageTypes::EMessageType messageType, const uint64_t numBytes);
+
+	// A received message that was skipped for exceeding its rate limit.
+	static void OnMessageThrottled(const MessageTypes::EMessageType messageType);
+
+	//
+	// Payload bytes before and after compressing a message for a peer that supports it (equal when it wasn't worth sending compressed),
+	// and the time spent. The per-type counters above count messages as if they'd been sent uncompressed.
+	//
+	static void OnMessageCompressed(const MessageTypes::EMessageType messageType, const uint64_t numBytesIn, const uint64_t numBytesOut, const uint64_t micros);
+	static void OnMessageDecompressed(const MessageTypes::EMessageType messageType, const uint64_t numBytesIn, const uint64_t numBytesOut, const uint64_t micros);
+};
@@ -4,6 +4,8 @@
 #include "Pipeline/Pipeline.h"
 #include "Sync/Syncer.h"
 #include "Messages/TransactionKernelMessage.h"
+#include "Messages/HeaderMessage.h"
+#include "Messages/CompactBlockMessage.h"
 
 #include <Core/Context.h>
 #include <BlockChain/BlockChain.h>
@@ -15,14 +17,18 @@ P2PServer::P2PServer(
 	std::shared_ptr<Pipeline> pPipeline,
 	std::unique_ptr<Seeder>&& pSeeder,
 	std::shared_ptr<Syncer> pSyncer,
-	std::shared_ptr<Dandelion> pDandelion)
+	std::shared_ptr<Dandelion> pDandelion,
+	const HeaderBatchCache::Ptr& pHeaderCache,
+	std::shared_ptr<ReplicaFollower> pReplicaFollower)
 	: m_pSyncStatus(pSyncStatus),
 	m_pPeerManager(pPeerManager),
 	m_pConnectionManager(pConnectionManager),
 	m_pPipeline(pPipeline),
 	m_pSeeder(std::move(pSeeder)),
 	m_pSyncer(pSyncer),
-	m_pDandelion(pDandelion)
+	m_pDandelion(pDandelion),
+	m_pHeaderCache(pHeaderCache),
+	m_pReplicaFollower(pReplicaFollower)
 {
 
 }
@@ -30,6 +36,7 @@ P2PServer::P2PServer(
 P2PServer::~P2PServer()
 {
 	LOG_INFO("Shutting down P2P server");
+	m_pReplicaFollower.reset();
 	m_pDandelion.reset();
 	m_pSyncer.reset();
 	m_pSeeder.reset();
@@ -58,9 +65,29 @@ std::shared_ptr<P2PServer> P2PServer::Create(
 
 	const Config& config = pContext->GetConfig();
 
+	// Header Cache
+	auto pHeaderCache = std::make_shared<HeaderBatchCache>(pBlockChain);
+
+	if (config.GetNodeConfig().IsReplica())
+	{
+		LOG_INFO_F("Following primary at {}", config.GetNodeConfig().GetReplicaOf().value());
+		return std::shared_ptr<P2PServer>(new P2PServer(
+			pSyncStatus,
+			peerManager,
+			pConnectionManager,
+			nullptr,
+			nullptr,
+			nullptr,
+			nullptr,
+			pHeaderCache,
+			ReplicaFollower::Create(config, pBlockChain, pSyncStatus)
+		));
+	}
+
 	// Pipeline
 	std::shared_ptr<Pipeline> pPipeline = Pipeline::Create(
 		config,
+		pContext->GetScheduler(),
 		pConnectionManager,
 		pBlockChain,
 		pSyncStatus
@@ -73,11 +100,14 @@ std::shared_ptr<P2PServer> P2PServer::Create(
 		*peerManager,
 		pBlockChain,
 		pPipeline,
-		pSyncStatus
+		pSyncStatus,
+		pHeaderCache
 	);
 
 	// Syncer
 	std::shared_ptr<Syncer> pSyncer = Syncer::Create(
+		config,
+		pContext->GetScheduler(),
 		pConnectionManager,
 		pBlockChain,
 		pPipeline,
@@ -87,6 +117,7 @@ std::shared_ptr<P2PServer> P2PServer::Create(
 	// Dandelion
 	std::shared_ptr<Dandelion> pDandelion = Dandelion::Create(
 		config,
+		pContext->GetScheduler(),
 		*pConnectionManager,
 		pBlockChain,
 		pTxHashSetManager,
@@ -102,7 +133,9 @@ std::shared_ptr<P2PServer> P2PServer::Create(
 		pPipeline,
 		std::move(pSeeder),
 		pSyncer,
-		pDandelion
+		pDandelion,
+		pHeaderCache,
+		nullptr
 	));
 }
 
@@ -175,6 +208,15 @@ void P2PServer::BroadcastTransaction(const TransactionPtr& pTransaction)
 	}
 }
 
+void P2PServer::BroadcastBlock(const CompactBlock& compactBlock)
+{
+	m_pConnectionManager->BroadcastBlock(
+		HeaderMessage{ compactBlock.GetHeader() },
+		CompactBlockMessage{ compactBlock },
+		0
+	);
+}
+
 namespace P2PAPI
 {
 	EXPORT std::shared_ptr<IP2PServer> StartP2PServer(
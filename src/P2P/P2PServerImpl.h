@@ -2,8 +2,10 @@
 
 #include "Dandelion.h"
 #include "ConnectionManager.h"
+#include "HeaderBatchCache.h"
 #include "Pipeline/Pipeline.h"
 #include "Sync/Syncer.h"
+#include "Sync/ReplicaFollower.h"
 #include "Seed/Seeder.h"
 #include "Seed/PeerManager.h"
 
@@ -36,6 +38,16 @@ public:
 	bool UnbanAllPeers() final;
 
 	void BroadcastTransaction(const TransactionPtr& pTransaction) final;
+	void BroadcastBlock(const CompactBlock& compactBlock) final;
+
+	CacheStats GetHeaderCacheStats() const final { return m_pHeaderCache->GetStats(); }
+	uint64_t GetServedHeaderBytesPerSecond() const final { return m_pHeaderCache->GetServedBytesPerSecond(); }
+	std::vector<uint8_t> GetSerializedHeaders(const uint64_t firstHeight, const uint64_t numHeaders, uint64_t& numHeadersFound) const final
+	{
+		HeaderBatchCache::SerializedHeaders headers = m_pHeaderCache->GetHeaders(firstHeight, (std::min)(numHeaders, MAX_HEADERS_PER_REQUEST));
+		numHeadersFound = headers.numHeaders;
+		return std::move(headers.bytes);
+	}
 
 private:
 	P2PServer(
@@ -45,7 +57,9 @@ private:
 		std::shared_ptr<Pipeline> pPipeline,
 		std::unique_ptr<Seeder>&& pSeeder,
 		std::shared_ptr<Syncer> pSyncer,
-		std::shared_ptr<Dandelion> pDandelion
+		std::shared_ptr<Dandelion> pDandelion,
+		const HeaderBatchCache::Ptr& pHeaderCache,
+		std::shared_ptr<ReplicaFollower> pReplicaFollower
 	);
 
 	SyncStatusConstPtr m_pSyncStatus;
@@ -55,4 +69,8 @@ private:
 	std::unique_ptr<Seeder> m_pSeeder;
 	std::shared_ptr<Syncer> m_pSyncer;
 	std::shared_ptr<Dandelion> m_pDandelion;
+	HeaderBatchCache::Ptr m_pHeaderCache;
+
+	// Replicas don't connect to peers, so they only have a follower, and no pipeline, seeder, syncer, or dandelion.
+	std::shared_ptr<ReplicaFollower> m_pReplicaFollower;
 };
\ No newline at end of file
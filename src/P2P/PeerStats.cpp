@@ -0,0 +1,55 @@
+#include <P2P/PeerStats.h>
+
+#include "Messages/MessageTypes.h"
+
+static Json::Value ToJSON(const std::optional<std::chrono::microseconds>& latency)
+{
+	if (!latency.has_value())
+	{
+		return Json::Value(Json::nullValue);
+	}
+
+	return latency.value().count() / 1000.0;
+}
+
+Json::Value PeerStats::ToJSON() const
+{
+	// Only the types that have been exchanged with the peer are included.
+	Json::Value messagesNode(Json::objectValue);
+	for (size_t i = 0; i < NUM_MESSAGE_TYPES; i++)
+	{
+		const MessageCounts counts = GetMessageCounts((uint8_t)i);
+		if (counts.messagesReceived == 0 && counts.messagesSent == 0)
+		{
+			continue;
+		}
+
+		Json::Value countsNode;
+		countsNode["messages_received"] = Json::UInt64(counts.messagesReceived);
+		countsNode["bytes_received"] = Json::UInt64(counts.bytesReceived);
+		countsNode["messages_sent"] = Json::UInt64(counts.messagesSent);
+		countsNode["bytes_sent"] = Json::UInt64(counts.bytesSent);
+
+		const std::string name = i < NUM_MESSAGE_TYPES - 1 ? MessageTypes::ToString((MessageTypes::EMessageType)i).substr(5) : "Unknown";
+		messagesNode[name] = countsNode;
+	}
+
+	Json::Value statsNode;
+	statsNode["messages"] = messagesNode;
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	statsNode["ping_rtt_ms"] = ::ToJSON(m_pingRtt.GetLatency());
+	statsNode["header_latency_ms"] = ::ToJSON(m_headerLatency.GetLatency());
+	statsNode["block_latency_ms"] = ::ToJSON(m_blockLatency.GetLatency());
+	statsNode["headers_received"] = Json::UInt64(m_headersReceived);
+	statsNode["blocks_received"] = Json::UInt64(m_blocksReceived);
+
+	const std::optional<double> headerThroughput = m_headerLatency.GetThroughput();
+	statsNode["headers_per_sec"] = headerThroughput.has_value() ? Json::Value(headerThroughput.value()) : Json::Value(Json::nullValue);
+	const std::optional<double> blockThroughput = m_blockLatency.GetThroughput();
+	statsNode["block_bytes_per_sec"] = blockThroughput.has_value() ? Json::Value(blockThroughput.value()) : Json::Value(Json::nullValue);
+	lock.unlock();
+
+	statsNode["throughput_score"] = GetThroughputScore();
+	return statsNode;
+}
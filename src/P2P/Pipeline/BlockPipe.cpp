@@ -6,29 +6,87 @@
 #include <Common/ThreadManager.h>
 #include <Common/Logger.h>
 #include <BlockChain/BlockChain.h>
+#include <algorithm>
 
-BlockPipe::BlockPipe(const Config& config, const IBlockChain::Ptr& pBlockChain)
-	: m_config(config), m_pBlockChain(pBlockChain), m_terminate(false)
+BlockPipe::BlockPipe(const Config& config, const TaskScheduler::Ptr& pScheduler, const IBlockChain::Ptr& pBlockChain)
+	: m_config(config), m_pScheduler(pScheduler), m_pBlockChain(pBlockChain), m_postProcessTaskId(0), m_terminate(false)
 {
 }
 
 BlockPipe::~BlockPipe()
 {
-	m_terminate = true;
+	{
+		std::unique_lock<std::mutex> lock(m_verifyMutex);
+		m_terminate = true;
+	}
+
+	m_blockQueued.notify_all();
+	m_blockVerified.notify_all();
+	m_blocksToProcess.wake_all();
 
+	m_pScheduler->RemoveTask(m_postProcessTaskId);
+	ThreadUtil::JoinAll(m_verifyThreads);
 	ThreadUtil::Join(m_blockThread);
-	ThreadUtil::Join(m_processThread);
 }
 
-std::shared_ptr<BlockPipe> BlockPipe::Create(const Config& config, const IBlockChain::Ptr& pBlockChain)
+std::shared_ptr<BlockPipe> BlockPipe::Create(const Config& config, const TaskScheduler::Ptr& pScheduler, const IBlockChain::Ptr& pBlockChain)
 {
-	std::shared_ptr<BlockPipe> pBlockPipe = std::shared_ptr<BlockPipe>(new BlockPipe(config, pBlockChain));
+	std::shared_ptr<BlockPipe> pBlockPipe = std::shared_ptr<BlockPipe>(new BlockPipe(config, pScheduler, pBlockChain));
+
+	const size_t numVerifyThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	for (size_t i = 0; i < numVerifyThreads; i++)
+	{
+		pBlockPipe->m_verifyThreads.emplace_back(std::thread(Thread_VerifyBlocks, std::ref(*pBlockPipe.get())));
+	}
+
 	pBlockPipe->m_blockThread = std::thread(Thread_ProcessNewBlocks, std::ref(*pBlockPipe.get()));
-	pBlockPipe->m_processThread = std::thread(Thread_PostProcessBlocks, std::ref(*pBlockPipe.get()));
+
+	BlockPipe* pBlockPipeRaw = pBlockPipe.get();
+	pBlockPipe->m_postProcessTaskId = pScheduler->Schedule(
+		"BLOCK_POSTPROCESS",
+		std::chrono::milliseconds(0),
+		[pBlockPipeRaw]() { return pBlockPipeRaw->PostProcessBlocks(); },
+		ETaskPriority::LOW
+	);
 
 	return pBlockPipe;
 }
 
+void BlockPipe::Thread_VerifyBlocks(BlockPipe& pipeline)
+{
+	ThreadManagerAPI::SetCurrentThreadName("BLOCK_VERIFY_PIPE");
+	LOG_TRACE("BEGIN");
+
+	while (true)
+	{
+		std::unique_lock<std::mutex> lock(pipeline.m_verifyMutex);
+		{
+			ThreadWait wait;
+			pipeline.m_blockQueued.wait(lock, [&pipeline] { return pipeline.m_terminate || !pipeline.m_blocksToVerify.empty(); });
+		}
+
+		if (pipeline.m_terminate)
+		{
+			break;
+		}
+
+		BlockEntryPtr pBlockEntry = pipeline.m_blocksToVerify.front();
+		pipeline.m_blocksToVerify.pop_front();
+		lock.unlock();
+
+		ThreadActivity activity("verify_block");
+		const bool valid = pipeline.m_pBlockChain->VerifySelfConsistent(*pBlockEntry->m_pBlock);
+
+		lock.lock();
+		pBlockEntry->m_status = valid ? EVerifyStatus::VALID : EVerifyStatus::INVALID;
+		lock.unlock();
+
+		pipeline.m_blockVerified.notify_all();
+	}
+
+	LOG_TRACE("END");
+}
+
 void BlockPipe::Thread_ProcessNewBlocks(BlockPipe& pipeline)
 {
 	ThreadManagerAPI::SetCurrentThreadName("BLOCK_PREPROCESS_PIPE");
@@ -36,29 +94,52 @@ void BlockPipe::Thread_ProcessNewBlocks(BlockPipe& pipeline)
 
 	while (!pipeline.m_terminate)
 	{
-		std::vector<BlockEntry> blocksToProcess = pipeline.m_blocksToProcess.copy_front(8); // TODO: Use number of CPU threads.
-		if (!blocksToProcess.empty())
+		std::unique_ptr<BlockEntryPtr> pNextEntry = nullptr;
 		{
-			if (blocksToProcess.size() == 1)
+			ThreadWait wait;
+			pNextEntry = pipeline.m_blocksToProcess.wait_front(std::chrono::milliseconds(100));
+		}
+
+		if (pNextEntry != nullptr)
+		{
+			const BlockEntryPtr& pBlockEntry = *pNextEntry;
+
+			// Blocks are added in the order received, once their context-free verification completes.
+			EVerifyStatus status = EVerifyStatus::PENDING;
 			{
-				ProcessNewBlock(pipeline, blocksToProcess.front());
+				ThreadWait wait;
+				std::unique_lock<std::mutex> lock(pipeline.m_verifyMutex);
+				pipeline.m_blockVerified.wait(lock, [&pipeline, &pBlockEntry] {
+					return pipeline.m_terminate || pBlockEntry->m_status != EVerifyStatus::PENDING;
+				});
+				status = pBlockEntry->m_status;
 			}
-			else
+
+			size_t numProcessed = 1;
+			if (status == EVerifyStatus::VALID)
 			{
-				std::vector<std::thread> tasks;
-				for (const BlockEntry& blockEntry : blocksToProcess)
+				ThreadActivity activity("add_blocks");
+				const std::vector<BlockEntryPtr> group = GetCommitGroup(pipeline);
+				if (group.size() > 1)
 				{
-					tasks.push_back(std::thread([&pipeline, blockEntry] { ProcessNewBlock(pipeline, blockEntry); }));
+					ProcessNewBlocks(pipeline, group);
+					numProcessed = group.size();
 				}
-
-				ThreadUtil::JoinAll(tasks);
+				else
+				{
+					ProcessNewBlock(pipeline, *pBlockEntry);
+				}
+			}
+			else if (status == EVerifyStatus::INVALID)
+			{
+				pBlockEntry->m_peer->Ban(EBanReason::BadBlock);
+			}
+			else
+			{
+				break;
 			}
 
-			pipeline.m_blocksToProcess.pop_front(blocksToProcess.size());
-		}
-		else
-		{
-			ThreadUtil::SleepFor(std::chrono::milliseconds(5), pipeline.m_terminate);
+			pipeline.m_blocksToProcess.pop_front(numProcessed);
 		}
 	}
 
@@ -69,7 +150,7 @@ void BlockPipe::ProcessNewBlock(BlockPipe& pipeline, const BlockEntry& blockEntr
 {
 	try
 	{
-		const EBlockChainStatus status = pipeline.m_pBlockChain->AddBlock(blockEntry.m_block);
+		const EBlockChainStatus status = pipeline.m_pBlockChain->AddBlock(*blockEntry.m_pBlock);
 		if (status == EBlockChainStatus::INVALID)
 		{
 			blockEntry.m_peer->Ban(EBanReason::BadBlock);
@@ -77,42 +158,139 @@ void BlockPipe::ProcessNewBlock(BlockPipe& pipeline, const BlockEntry& blockEntr
 	}
 	catch (std::exception& e)
 	{
-		LOG_ERROR_F("Exception ({}) caught while attempting to add block {}.", e.what(), blockEntry.m_block);
+		LOG_ERROR_F("Exception ({}) caught while attempting to add block {}.", e.what(), *blockEntry.m_pBlock);
 		blockEntry.m_peer->Ban(EBanReason::BadBlock);
 	}
 }
 
-void BlockPipe::Thread_PostProcessBlocks(BlockPipe& pipeline)
+void BlockPipe::ProcessNewBlocks(BlockPipe& pipeline, const std::vector<BlockEntryPtr>& blockEntries)
 {
-	ThreadManagerAPI::SetCurrentThreadName("BLOCK_POSTPROCESS_PIPE");
-	LOG_TRACE("BEGIN");
+	std::vector<FullBlock::CPtr> blocks;
+	std::transform(
+		blockEntries.cbegin(), blockEntries.cend(),
+		std::back_inserter(blocks),
+		[](const BlockEntryPtr& pBlockEntry) { return pBlockEntry->m_pBlock; }
+	);
 
-	while (!pipeline.m_terminate)
+	try
 	{
-		if (!pipeline.m_pBlockChain->ProcessNextOrphanBlock())
+		const std::vector<EBlockChainStatus> statuses = pipeline.m_pBlockChain->AddBlocks(blocks);
+		for (size_t i = 0; i < statuses.size(); i++)
 		{
-			ThreadUtil::SleepFor(std::chrono::milliseconds(5), pipeline.m_terminate);
+			if (statuses[i] == EBlockChainStatus::INVALID)
+			{
+				blockEntries[i]->m_peer->Ban(EBanReason::BadBlock);
+			}
 		}
 	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception ({}) caught while attempting to add {} blocks.", e.what(), blocks.size());
+	}
+}
 
-	LOG_TRACE("END");
+//
+// Returns the entries at the front of the queue to add together: the front entry, which has already been verified,
+// followed by the consecutive entries whose verification has also completed successfully.
+// Blocks are only grouped while far behind the header chain, so once at the tip, every block is committed as it arrives.
+//
+std::vector<BlockPipe::BlockEntryPtr> BlockPipe::GetCommitGroup(BlockPipe& pipeline)
+{
+	const size_t maxGroupSize = (std::max)(pipeline.m_config.GetNodeConfig().GetBlockCommitGroupSize(), (size_t)1);
+	std::vector<BlockEntryPtr> entries = pipeline.m_blocksToProcess.copy_front(maxGroupSize);
+	if (entries.size() <= 1)
+	{
+		return entries;
+	}
+
+	ChainSnapshot::CPtr pSnapshot = pipeline.m_pBlockChain->GetSnapshot();
+	if (pSnapshot->GetHeight(EChainType::CANDIDATE) < pSnapshot->GetHeight(EChainType::CONFIRMED) + maxGroupSize)
+	{
+		entries.resize(1);
+		return entries;
+	}
+
+	size_t groupSize = 1;
+	{
+		std::unique_lock<std::mutex> lock(pipeline.m_verifyMutex);
+		while (groupSize < entries.size()
+			&& entries[groupSize]->m_status == EVerifyStatus::VALID
+			&& entries[groupSize]->m_pBlock->GetPreviousHash() == entries[groupSize - 1]->m_pBlock->GetHash())
+		{
+			++groupSize;
+		}
+	}
+
+	entries.resize(groupSize);
+	return entries;
 }
 
-bool BlockPipe::AddBlockToProcess(PeerPtr pPeer, const FullBlock& block)
+//
+// Runs a batch of each kind of post-processing, returning the delay until the next batch: none while any has more to do, 500ms otherwise.
+//
+std::chrono::milliseconds BlockPipe::PostProcessBlocks()
 {
-	std::function<bool(const BlockEntry&, const BlockEntry&)> comparator = [](const BlockEntry& blockEntry1, const BlockEntry& blockEntry2)
+	// Orphans are connected as soon as their parent is added, so this is only a fallback, eg. for an orphan whose parent failed to connect at first.
+	bool processedOrphan = false;
+	bool morePruning = false;
+	bool moreReverifying = false;
+	bool moreIndexing = false;
+	{
+		ThreadActivity activity("process_orphans");
+		processedOrphan = m_pBlockChain->ProcessNextOrphanBlock();
+	}
 	{
-		return blockEntry1.m_block.GetHash() == blockEntry2.m_block.GetHash();
+		ThreadActivity activity("prune_blocks");
+		morePruning = m_pBlockChain->PruneBlocks();
+	}
+	{
+		ThreadActivity activity("reverify_assumed_valid");
+		moreReverifying = m_pBlockChain->ReverifyAssumedValid();
+	}
+	{
+		ThreadActivity activity("index_kernels");
+		moreIndexing = m_pBlockChain->IndexKernels();
+	}
+	{
+		ThreadActivity activity("compact_txhashset");
+		m_pBlockChain->CompactTxHashSet();
+	}
+
+	if (processedOrphan || morePruning || moreReverifying || moreIndexing)
+	{
+		return std::chrono::milliseconds(0);
+	}
+
+	return std::chrono::milliseconds(500);
+}
+
+bool BlockPipe::AddBlockToProcess(PeerPtr pPeer, FullBlock&& block)
+{
+	std::function<bool(const BlockEntryPtr&, const BlockEntryPtr&)> comparator = [](const BlockEntryPtr& pBlockEntry1, const BlockEntryPtr& pBlockEntry2)
+	{
+		return pBlockEntry1->m_pBlock->GetHash() == pBlockEntry2->m_pBlock->GetHash();
 	};
 
-	return m_blocksToProcess.push_back_unique(BlockEntry(pPeer, block), comparator);
+	BlockEntryPtr pBlockEntry = std::make_shared<BlockEntry>(pPeer, std::move(block));
+	if (!m_blocksToProcess.push_back_unique(BlockEntryPtr(pBlockEntry), comparator))
+	{
+		return false;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_verifyMutex);
+		m_blocksToVerify.push_back(pBlockEntry);
+	}
+
+	m_blockQueued.notify_one();
+	return true;
 }
 
 bool BlockPipe::IsProcessingBlock(const Hash& hash) const
 {
-	std::function<bool(const BlockEntry&, const Hash&)> comparator = [](const BlockEntry& blockEntry, const Hash& hash)
+	std::function<bool(const BlockEntryPtr&, const Hash&)> comparator = [](const BlockEntryPtr& pBlockEntry, const Hash& hash)
 	{
-		return blockEntry.m_block.GetHash() == hash;
+		return pBlockEntry->m_pBlock->GetHash() == hash;
 	};
 
 	return m_blocksToProcess.contains<Hash>(hash, comparator);
@@ -5,55 +5,90 @@
 #include <Core/Models/FullBlock.h>
 #include <BlockChain/BlockChain.h>
 #include <Common/ConcurrentQueue.h>
+#include <Common/TaskScheduler.h>
 #include <string>
 #include <cstdint>
 #include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 // Forward Declarations
 class Config;
 class TxHashSetArchiveMessage;
 class Transaction;
 
+//
+// Processes new blocks in two stages:
+// 1. Context-free verification (rangeproofs, kernel signatures, cut-through) runs on a persistent pool of workers, one per CPU thread.
+// 2. Blocks are then added to the chain in the order they were received, by a single thread.
+//    While far behind the header chain, runs of consecutive verified blocks are added together in a single commit.
+// Orphans, pruning, reverification and indexing are then caught up on by a task of the scheduler.
+//
 class BlockPipe
 {
 public:
 	static std::shared_ptr<BlockPipe> Create(
 		const Config& config,
+		const TaskScheduler::Ptr& pScheduler,
 		const IBlockChain::Ptr& pBlockChain
 	);
 	~BlockPipe();
 
-	bool AddBlockToProcess(PeerPtr pPeer, const FullBlock& block);
+	bool AddBlockToProcess(PeerPtr pPeer, FullBlock&& block);
 	bool IsProcessingBlock(const Hash& hash) const;
 
 private:
-	BlockPipe(const Config& config, const IBlockChain::Ptr& pBlockChain);
+	BlockPipe(const Config& config, const TaskScheduler::Ptr& pScheduler, const IBlockChain::Ptr& pBlockChain);
 
 	const Config& m_config;
+	TaskScheduler::Ptr m_pScheduler;
 	IBlockChain::Ptr m_pBlockChain;
 
+	enum class EVerifyStatus
+	{
+		PENDING,
+		VALID,
+		INVALID
+	};
+
 	struct BlockEntry
 	{
-		BlockEntry(PeerPtr pPeer, const FullBlock& fullBlock)
-			: m_peer(pPeer), m_block(fullBlock)
+		BlockEntry(PeerPtr pPeer, FullBlock&& fullBlock)
+			: m_peer(pPeer), m_pBlock(std::make_shared<const FullBlock>(std::move(fullBlock))), m_status(EVerifyStatus::PENDING)
 		{
 
 		}
 
 		PeerPtr m_peer;
-		FullBlock m_block;
+		FullBlock::CPtr m_pBlock;
+
+		// Guarded by m_verifyMutex
+		EVerifyStatus m_status;
 	};
+	using BlockEntryPtr = std::shared_ptr<BlockEntry>;
+
+	// Verify Blocks
+	static void Thread_VerifyBlocks(BlockPipe& pipeline);
+	std::vector<std::thread> m_verifyThreads;
+	std::mutex m_verifyMutex;
+	std::condition_variable m_blockQueued;
+	std::condition_variable m_blockVerified;
+	std::deque<BlockEntryPtr> m_blocksToVerify;
 
-	// Pre-Process New Blocks
+	// Process New Blocks
 	static void Thread_ProcessNewBlocks(BlockPipe& pipeline);
 	static void ProcessNewBlock(BlockPipe& pipeline, const BlockEntry& blockEntry);
+	static void ProcessNewBlocks(BlockPipe& pipeline, const std::vector<BlockEntryPtr>& blockEntries);
+	static std::vector<BlockEntryPtr> GetCommitGroup(BlockPipe& pipeline);
 	std::thread m_blockThread;
-	ConcurrentQueue<BlockEntry> m_blocksToProcess;
+	ConcurrentQueue<BlockEntryPtr> m_blocksToProcess;
 
 	// Process Next Block
-	std::thread m_processThread;
-	static void Thread_PostProcessBlocks(BlockPipe& pipeline);
+	TaskScheduler::TaskId m_postProcessTaskId;
+	std::chrono::milliseconds PostProcessBlocks();
 
 	std::atomic_bool m_terminate;
-};
\ No newline at end of file
+};
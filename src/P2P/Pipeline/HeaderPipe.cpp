@@ -0,0 +1,243 @@
+#include "HeaderPipe.h"
+
+#include <Common/Util/ThreadUtil.h>
+#include <Common/ThreadManager.h>
+#include <Common/Logger.h>
+#include <algorithm>
+
+// Batches that still don't connect to the chain after this long are dropped.
+static const std::chrono::seconds UNCONNECTED_BATCH_TIMEOUT(30);
+
+// A peer's batch only counts as requested if it arrives within this long of the request.
+static const std::chrono::seconds REQUEST_TIMEOUT(30);
+
+// Batches beyond these are dropped. HeaderSyncer stops requesting well before the pipe is full.
+static const size_t MAX_QUEUED_BATCHES = 16;
+static const size_t MAX_OUTSTANDING_REQUESTS = 16;
+
+HeaderPipe::HeaderPipe(const Config& config, const IBlockChain::Ptr& pBlockChain)
+	: m_config(config), m_pBlockChain(pBlockChain), m_disagreement(false), m_terminate(false)
+{
+
+}
+
+HeaderPipe::~HeaderPipe()
+{
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_terminate = true;
+	}
+
+	m_batchAdded.notify_all();
+	ThreadUtil::Join(m_headerThread);
+}
+
+std::shared_ptr<HeaderPipe> HeaderPipe::Create(const Config& config, const IBlockChain::Ptr& pBlockChain)
+{
+	std::shared_ptr<HeaderPipe> pHeaderPipe = std::shared_ptr<HeaderPipe>(new HeaderPipe(config, pBlockChain));
+	pHeaderPipe->m_headerThread = std::thread(Thread_ProcessHeaders, std::ref(*pHeaderPipe.get()));
+
+	return pHeaderPipe;
+}
+
+void HeaderPipe::OnHeadersRequested(const PeerPtr& pPeer)
+{
+	const auto now = std::chrono::system_clock::now();
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (!m_requests.empty() && (m_requests.front().m_expires < now || m_requests.size() >= MAX_OUTSTANDING_REQUESTS))
+	{
+		m_requests.pop_front();
+	}
+
+	m_requests.emplace_back(HeadersRequest{ pPeer, now + REQUEST_TIMEOUT });
+}
+
+void HeaderPipe::AddHeadersToProcess(PeerPtr pPeer, std::vector<BlockHeaderPtr>&& headers)
+{
+	if (headers.empty())
+	{
+		return;
+	}
+
+	bool requested = false;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		requested = TakeRequest(pPeer);
+	}
+
+	// Nothing is held for an unsolicited batch (eg. a peer announcing its new headers), so it's only taken if it can be processed now.
+	if (!requested && !ConnectsToCandidateChain(headers.front()))
+	{
+		LOG_DEBUG_F("Dropping {} unsolicited headers from {} that don't connect to the chain", headers.size(), pPeer);
+		return;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (m_batches.size() >= MAX_QUEUED_BATCHES)
+		{
+			LOG_WARNING_F("Header pipe is full. Dropping {} headers from {}", headers.size(), pPeer);
+			return;
+		}
+
+		if (requested && (m_pFurthestReceived == nullptr || headers.back()->GetHeight() > m_pFurthestReceived->GetHeight()))
+		{
+			m_pFurthestReceived = headers.back();
+		}
+
+		m_batches.emplace_back(HeaderBatch{ pPeer, std::move(headers), std::chrono::system_clock::now(), requested });
+	}
+
+	m_batchAdded.notify_one();
+}
+
+BlockHeaderPtr HeaderPipe::GetFurthestHeaderReceived() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_pFurthestReceived;
+}
+
+bool HeaderPipe::TakeDisagreement()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	if (!m_disagreement)
+	{
+		return false;
+	}
+
+	m_disagreement = false;
+	m_pFurthestReceived = nullptr;
+	return true;
+}
+
+size_t HeaderPipe::GetNumPendingBatches() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return m_batches.size();
+}
+
+bool HeaderPipe::ConnectsToCandidateChain(const BlockHeaderPtr& pFirstHeader) const
+{
+	if (pFirstHeader->GetHeight() == 0)
+	{
+		// Invalid, but let the chain reject it.
+		return true;
+	}
+
+	auto pPreviousHeader = m_pBlockChain->GetBlockHeaderByHeight(pFirstHeader->GetHeight() - 1, EChainType::CANDIDATE);
+	return pPreviousHeader != nullptr && pPreviousHeader->GetHash() == pFirstHeader->GetPreviousHash();
+}
+
+bool HeaderPipe::TakeRequest(const PeerPtr& pPeer)
+{
+	const auto now = std::chrono::system_clock::now();
+	auto iter = std::find_if(
+		m_requests.begin(),
+		m_requests.end(),
+		[&pPeer, &now](const HeadersRequest& request) { return request.m_peer == pPeer && now <= request.m_expires; }
+	);
+	if (iter == m_requests.end())
+	{
+		return false;
+	}
+
+	m_requests.erase(iter);
+	return true;
+}
+
+void HeaderPipe::Thread_ProcessHeaders(HeaderPipe& pipeline)
+{
+	ThreadManagerAPI::SetCurrentThreadName("HEADER_PIPE");
+	LOG_TRACE("BEGIN");
+
+	while (true)
+	{
+		try
+		{
+			std::unique_lock<std::mutex> lock(pipeline.m_mutex);
+			{
+				ThreadWait wait;
+				pipeline.m_batchAdded.wait(lock, [&pipeline] { return pipeline.m_terminate || !pipeline.m_batches.empty(); });
+			}
+
+			if (pipeline.m_terminate)
+			{
+				break;
+			}
+
+			// The first headers are copied out, so the candidate chain's lock isn't taken while holding m_mutex.
+			std::vector<BlockHeaderPtr> firstHeaders;
+			firstHeaders.reserve(pipeline.m_batches.size());
+			for (const HeaderBatch& batch : pipeline.m_batches)
+			{
+				firstHeaders.push_back(batch.m_headers.front());
+			}
+
+			lock.unlock();
+
+			// Batches usually arrive in order, so the front batch is checked first.
+			auto connected = std::find_if(
+				firstHeaders.cbegin(),
+				firstHeaders.cend(),
+				[&pipeline](const BlockHeaderPtr& pFirstHeader) { return pipeline.ConnectsToCandidateChain(pFirstHeader); }
+			);
+			const size_t index = (size_t)std::distance(firstHeaders.cbegin(), connected);
+
+			// Only this thread removes batches, and others are only added at the back, so index still refers to the same batch.
+			lock.lock();
+			if (index == firstHeaders.size())
+			{
+				const auto now = std::chrono::system_clock::now();
+				const HeaderBatch& oldest = pipeline.m_batches.front();
+				if (oldest.m_received + UNCONNECTED_BATCH_TIMEOUT < now)
+				{
+					LOG_WARNING_F(
+						"Headers {} to {} from {} never connected to the chain. Dropping them.",
+						*oldest.m_headers.front(),
+						*oldest.m_headers.back(),
+						oldest.m_peer
+					);
+
+					// An unsolicited batch connected when it arrived, so it can only have been left behind by a reorg.
+					pipeline.m_disagreement = pipeline.m_disagreement || oldest.m_requested;
+					pipeline.m_batches.pop_front();
+				}
+				else
+				{
+					// Wait for the missing batch to arrive.
+					ThreadWait wait;
+					pipeline.m_batchAdded.wait_for(lock, std::chrono::milliseconds(100));
+				}
+
+				continue;
+			}
+
+			HeaderBatch batch = std::move(pipeline.m_batches[index]);
+			pipeline.m_batches.erase(pipeline.m_batches.begin() + index);
+			lock.unlock();
+
+			LOG_DEBUG_F("Processing {} headers from {}", batch.m_headers.size(), batch.m_peer);
+
+			ThreadActivity activity("add_headers");
+			const EBlockChainStatus status = pipeline.m_pBlockChain->AddBlockHeaders(batch.m_headers);
+			if (status == EBlockChainStatus::INVALID || status == EBlockChainStatus::UNKNOWN_ERROR)
+			{
+				if (status == EBlockChainStatus::INVALID)
+				{
+					LOG_WARNING_F("Banning peer {} for '{}'.", batch.m_peer, BanReason::Format(EBanReason::BadBlockHeader));
+					batch.m_peer->Ban(EBanReason::BadBlockHeader);
+				}
+
+				lock.lock();
+				pipeline.m_disagreement = true;
+			}
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_F("Exception caught: {}", e.what());
+		}
+	}
+
+	LOG_TRACE("END");
+}
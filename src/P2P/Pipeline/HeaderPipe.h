@@ -0,0 +1,91 @@
+#pragma once
+
+#include <P2P/Peer.h>
+#include <Core/Models/BlockHeader.h>
+#include <BlockChain/BlockChain.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Forward Declarations
+class Config;
+
+//
+// Feeds batches of headers (from HeadersMessages) to the chain on a dedicated thread, in chain order.
+// A batch that doesn't connect to the candidate chain yet is held until the batch before it has been processed,
+// so batches requested from different peers can arrive in any order, and downloading overlaps with validation.
+//
+// Only batches answering a GetHeaders sent through OnHeadersRequested are held, and at most MAX_QUEUED_BATCHES of them.
+// Unsolicited batches are only taken if they connect to the candidate chain as they arrive.
+//
+// The pipe also tracks the furthest header received so far (processed or not),
+// which lets HeaderSyncer request the next range before the earlier ones are validated.
+//
+class HeaderPipe
+{
+public:
+	static std::shared_ptr<HeaderPipe> Create(const Config& config, const IBlockChain::Ptr& pBlockChain);
+	~HeaderPipe();
+
+	//
+	// Records that headers were requested from the peer, so its next batch is held until it connects.
+	//
+	void OnHeadersRequested(const PeerPtr& pPeer);
+
+	void AddHeadersToProcess(PeerPtr pPeer, std::vector<BlockHeaderPtr>&& headers);
+
+	//
+	// Returns the last header of the furthest batch received, or nullptr if none have been received.
+	//
+	BlockHeaderPtr GetFurthestHeaderReceived() const;
+
+	//
+	// Returns true (once) if a batch has been invalid, or a requested batch never connected to the chain, since the last call.
+	// Also forgets the furthest header received, since it can no longer be trusted.
+	//
+	bool TakeDisagreement();
+
+	size_t GetNumPendingBatches() const;
+
+private:
+	HeaderPipe(const Config& config, const IBlockChain::Ptr& pBlockChain);
+
+	struct HeaderBatch
+	{
+		PeerPtr m_peer;
+		std::vector<BlockHeaderPtr> m_headers;
+		std::chrono::time_point<std::chrono::system_clock> m_received;
+		bool m_requested;
+	};
+
+	struct HeadersRequest
+	{
+		PeerPtr m_peer;
+		std::chrono::time_point<std::chrono::system_clock> m_expires;
+	};
+
+	// Called without m_mutex, since it reads the candidate chain.
+	bool ConnectsToCandidateChain(const BlockHeaderPtr& pFirstHeader) const;
+
+	// Consumes the peer's oldest outstanding request, if it has one. Called with m_mutex held.
+	bool TakeRequest(const PeerPtr& pPeer);
+
+	static void Thread_ProcessHeaders(HeaderPipe& pipeline);
+
+	const Config& m_config;
+	IBlockChain::Ptr m_pBlockChain;
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_batchAdded;
+	std::deque<HeaderBatch> m_batches;
+	std::deque<HeadersRequest> m_requests;
+	BlockHeaderPtr m_pFurthestReceived;
+	bool m_disagreement;
+
+	std::thread m_headerThread;
+	std::atomic_bool m_terminate;
+};
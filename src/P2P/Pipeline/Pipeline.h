@@ -3,6 +3,7 @@
 #include "../ConnectionManager.h"
 #include "../Connection.h"
 #include "BlockPipe.h"
+#include "HeaderPipe.h"
 #include "TransactionPipe.h"
 #include "TxHashSetPipe.h"
 
@@ -18,24 +19,32 @@ class Pipeline
 public:
 	static std::shared_ptr<Pipeline> Create(
 		const Config& config,
+		const TaskScheduler::Ptr& pScheduler,
 		ConnectionManagerPtr pConnectionManager,
 		const IBlockChain::Ptr& pBlockChain,
 		SyncStatusPtr pSyncStatus)
 	{
-		std::shared_ptr<BlockPipe> pBlockPipe = BlockPipe::Create(config, pBlockChain);
+		std::shared_ptr<BlockPipe> pBlockPipe = BlockPipe::Create(config, pScheduler, pBlockChain);
+		std::shared_ptr<HeaderPipe> pHeaderPipe = HeaderPipe::Create(config, pBlockChain);
 		std::shared_ptr<TransactionPipe> pTransactionPipe = TransactionPipe::Create(config, pConnectionManager, pBlockChain);
 		std::shared_ptr<TxHashSetPipe> pTxHashSetPipe = TxHashSetPipe::Create(config, pBlockChain, pSyncStatus);
 
-		return std::shared_ptr<Pipeline>(new Pipeline(pBlockPipe, pTransactionPipe, pTxHashSetPipe));
+		return std::shared_ptr<Pipeline>(new Pipeline(pBlockPipe, pHeaderPipe, pTransactionPipe, pTxHashSetPipe));
 	}
 
 	std::shared_ptr<BlockPipe> GetBlockPipe() { return m_pBlockPipe; }
+	std::shared_ptr<HeaderPipe> GetHeaderPipe() { return m_pHeaderPipe; }
 	std::shared_ptr<TransactionPipe> GetTransactionPipe() { return m_pTransactionPipe; }
 	std::shared_ptr<TxHashSetPipe> GetTxHashSetPipe() { return m_pTxHashSetPipe; }
 
-	void ProcessBlock(Connection& connection, const FullBlock& block)
+	void ProcessBlock(Connection& connection, FullBlock&& block)
 	{
-		m_pBlockPipe->AddBlockToProcess(connection.GetPeer(), block);
+		m_pBlockPipe->AddBlockToProcess(connection.GetPeer(), std::move(block));
+	}
+
+	void ProcessHeaders(Connection& connection, std::vector<BlockHeaderPtr>&& headers)
+	{
+		m_pHeaderPipe->AddHeadersToProcess(connection.GetPeer(), std::move(headers));
 	}
 
 	void ProcessTransaction(Connection& connection, const TransactionPtr& pTransaction, const EPoolType poolType)
@@ -51,9 +60,11 @@ public:
 private:
 	Pipeline(
 		std::shared_ptr<BlockPipe> pBlockPipe,
+		std::shared_ptr<HeaderPipe> pHeaderPipe,
 		std::shared_ptr<TransactionPipe> pTransactionPipe,
 		std::shared_ptr<TxHashSetPipe> pTxHashSetPipe)
 		: m_pBlockPipe(pBlockPipe),
+		m_pHeaderPipe(pHeaderPipe),
 		m_pTransactionPipe(pTransactionPipe),
 		m_pTxHashSetPipe(pTxHashSetPipe)
 	{
@@ -61,6 +72,7 @@ private:
 	}
 
 	std::shared_ptr<BlockPipe> m_pBlockPipe;
+	std::shared_ptr<HeaderPipe> m_pHeaderPipe;
 	std::shared_ptr<TransactionPipe> m_pTransactionPipe;
 	std::shared_ptr<TxHashSetPipe> m_pTxHashSetPipe;
 };
\ No newline at end of file
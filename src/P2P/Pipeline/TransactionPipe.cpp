@@ -6,6 +6,13 @@
 #include <Common/ThreadManager.h>
 #include <Common/Logger.h>
 #include <BlockChain/BlockChain.h>
+#include <algorithm>
+
+static const size_t MAX_BATCH_SIZE = 64;
+
+// How long to wait for more transactions to arrive before validating a batch that isn't full, so their proofs are verified together.
+static const std::chrono::milliseconds BATCH_LINGER = std::chrono::milliseconds(5);
+static const size_t SEEN_FILTER_SIZE = 20'000;
 
 TransactionPipe::TransactionPipe(const Config& config, const std::shared_ptr<ConnectionManager>& pConnectionManager, const std::shared_ptr<IBlockChain>& pBlockChain)
 	: m_config(config), m_pConnectionManager(pConnectionManager), m_pBlockChain(pBlockChain), m_terminate(false)
@@ -16,6 +23,7 @@ TransactionPipe::TransactionPipe(const Config& config, const std::shared_ptr<Con
 TransactionPipe::~TransactionPipe()
 {
 	m_terminate = true;
+	m_transactionsToProcess.wake_all();
 
 	ThreadUtil::Join(m_transactionThread);
 }
@@ -40,32 +48,48 @@ void TransactionPipe::Thread_ProcessTransactions(TransactionPipe& pipeline)
 	{
 		try
 		{
-			std::unique_ptr<TxEntry> pTxEntry = pipeline.m_transactionsToProcess.copy_front();
-			if (pTxEntry != nullptr)
+			// Entries stay queued while they're processed, so duplicates received meanwhile are still rejected.
 			{
-				const EBlockChainStatus status = pipeline.m_pBlockChain->AddTransaction(pTxEntry->pTransaction, pTxEntry->poolType);
-				if (status == EBlockChainStatus::SUCCESS && pTxEntry->poolType == EPoolType::MEMPOOL)
+				ThreadWait wait;
+				if (pipeline.m_transactionsToProcess.wait_front(std::chrono::milliseconds(100)) == nullptr)
 				{
-					// Broacast TransactionKernelMsg
-					const std::vector<TransactionKernel>& kernels = pTxEntry->pTransaction->GetKernels();
-					for (auto& kernel : kernels)
-					{
-						const TransactionKernelMessage message(kernel.GetHash());
-						LOG_DEBUG_F("Broadcasting kernel {}", kernel.GetHash());
-						pipeline.m_pConnectionManager->BroadcastMessage(message, pTxEntry->m_connectionId);
-					}
+					continue;
 				}
-				else if (status == EBlockChainStatus::INVALID)
+
+				const auto lingerUntil = std::chrono::steady_clock::now() + BATCH_LINGER;
+				while (pipeline.m_transactionsToProcess.size() < MAX_BATCH_SIZE && std::chrono::steady_clock::now() < lingerUntil && !pipeline.m_terminate)
 				{
-					pTxEntry->m_peer->Ban(EBanReason::BadTransaction);
+					std::this_thread::sleep_for(std::chrono::milliseconds(1));
 				}
+			}
+
+			ThreadActivity activity("process_transactions");
+
+			const std::vector<TxEntry> batch = pipeline.m_transactionsToProcess.copy_front(MAX_BATCH_SIZE);
 
-				pipeline.m_transactionsToProcess.pop_front(1);
+			// Context-free validation doesn't need any locks, so the whole batch is validated at once, with its proofs batch verified.
+			std::vector<TransactionPtr> transactions;
+			transactions.reserve(batch.size());
+			for (const TxEntry& entry : batch)
+			{
+				transactions.push_back(entry.pTransaction);
 			}
-			else
+
+			const std::vector<bool> valid = pipeline.m_pBlockChain->VerifySelfConsistent(transactions);
+
+			for (size_t i = 0; i < batch.size(); i++)
 			{
-				ThreadUtil::SleepFor(std::chrono::milliseconds(5), pipeline.m_terminate);
+				try
+				{
+					pipeline.ProcessTransaction(batch[i], valid[i]);
+				}
+				catch (std::exception& e)
+				{
+					LOG_ERROR_F("Exception ({}) caught while processing transaction {}", e.what(), *batch[i].pTransaction);
+				}
 			}
+
+			pipeline.m_transactionsToProcess.pop_front(batch.size());
 		}
 		catch (std::exception& e)
 		{
@@ -76,12 +100,72 @@ void TransactionPipe::Thread_ProcessTransactions(TransactionPipe& pipeline)
 	LOG_TRACE("END");
 }
 
+void TransactionPipe::ProcessTransaction(const TxEntry& txEntry, const bool valid)
+{
+	if (!valid)
+	{
+		MarkAsSeen(txEntry.pTransaction->GetHash());
+		txEntry.m_peer->Ban(EBanReason::BadTransaction);
+		return;
+	}
+
+	// Already validated, so only the UTXO checks and pool insertion remain.
+	const EBlockChainStatus status = m_pBlockChain->AddTransaction(txEntry.pTransaction, txEntry.poolType);
+	if (status == EBlockChainStatus::SUCCESS && txEntry.poolType == EPoolType::MEMPOOL)
+	{
+		MarkAsSeen(txEntry.pTransaction->GetHash());
+
+		// Broacast TransactionKernelMsg
+		const std::vector<TransactionKernel>& kernels = txEntry.pTransaction->GetKernels();
+		for (auto& kernel : kernels)
+		{
+			const TransactionKernelMessage message(kernel.GetHash());
+			LOG_DEBUG_F("Broadcasting kernel {}", kernel.GetHash());
+			m_pConnectionManager->BroadcastMessage(message, txEntry.m_connectionId);
+		}
+	}
+	else if (status == EBlockChainStatus::INVALID)
+	{
+		MarkAsSeen(txEntry.pTransaction->GetHash());
+		txEntry.m_peer->Ban(EBanReason::BadTransaction);
+	}
+}
+
+bool TransactionPipe::WasSeen(const Hash& hash) const
+{
+	std::unique_lock<std::mutex> lock(m_seenMutex);
+	return m_seen.find(hash) != m_seen.end();
+}
+
+void TransactionPipe::MarkAsSeen(const Hash& hash)
+{
+	std::unique_lock<std::mutex> lock(m_seenMutex);
+	if (!m_seen.insert(hash).second)
+	{
+		return;
+	}
+
+	m_seenOrder.push_back(hash);
+	if (m_seenOrder.size() > SEEN_FILTER_SIZE)
+	{
+		m_seen.erase(m_seenOrder.front());
+		m_seenOrder.pop_front();
+	}
+}
+
 bool TransactionPipe::AddTransactionToProcess(Connection& connection, const TransactionPtr& pTransaction, const EPoolType poolType)
 {
+	// Stem txs that were only added to the stempool aren't remembered, so they're still accepted once fluffed.
+	if (WasSeen(pTransaction->GetHash()))
+	{
+		LOG_TRACE_F("Transaction {} already seen", *pTransaction);
+		return false;
+	}
+
 	std::function<bool(const TxEntry&, const TxEntry&)> comparator = [](const TxEntry& txEntry1, const TxEntry& txEntry2)
 	{
 		return txEntry1.pTransaction->GetHash() == txEntry2.pTransaction->GetHash();
 	};
 
 	return m_transactionsToProcess.push_back_unique(TxEntry(connection.GetId(), connection.GetPeer(), pTransaction, poolType), comparator);
-}
\ No newline at end of file
+}
@@ -10,6 +10,8 @@
 #include <atomic>
 #include <thread>
 #include <deque>
+#include <mutex>
+#include <unordered_set>
 
 // Forward Declarations
 class Config;
@@ -18,6 +20,13 @@ class ConnectionManager;
 class IBlockChain;
 class TxHashSetArchiveMessage;
 
+//
+// Adds transactions received from peers to the pool.
+// Queued transactions are taken in batches, waiting a few milliseconds for a batch to fill, and the context-free checks
+// (rangeproofs, kernel signatures, kernel sums) for the whole batch run in parallel on the shared thread pool, with the proofs batch verified.
+// Only the UTXO checks and pool insertion are done one at a time, in the order received.
+// Recently accepted or rejected transactions are remembered by hash, so the copies relayed by other peers are dropped without being validated again.
+//
 class TransactionPipe
 {
 public:
@@ -41,8 +50,6 @@ private:
 	std::shared_ptr<ConnectionManager> m_pConnectionManager;
 	std::shared_ptr<IBlockChain> m_pBlockChain;
 
-	static void Thread_ProcessTransactions(TransactionPipe& pipeline);
-	std::thread m_transactionThread;
 	struct TxEntry
 	{
 		TxEntry(const uint64_t connectionId, PeerPtr pPeer, TransactionPtr txn, const EPoolType type)
@@ -57,7 +64,19 @@ private:
 		EPoolType poolType;
 	};
 
+	static void Thread_ProcessTransactions(TransactionPipe& pipeline);
+	void ProcessTransaction(const TxEntry& txEntry, const bool valid);
+
+	bool WasSeen(const Hash& hash) const;
+	void MarkAsSeen(const Hash& hash);
+
+	std::thread m_transactionThread;
 	ConcurrentQueue<TxEntry> m_transactionsToProcess;
 
+	// Hashes of the last SEEN_FILTER_SIZE txs that were added to the mempool or found invalid, oldest first.
+	mutable std::mutex m_seenMutex;
+	std::unordered_set<Hash> m_seen;
+	std::deque<Hash> m_seenOrder;
+
 	std::atomic_bool m_terminate;
 };
\ No newline at end of file
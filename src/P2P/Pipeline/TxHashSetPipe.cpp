@@ -64,8 +64,17 @@ void TxHashSetPipe::ReceiveTxHashSet(Connection& connection, const TxHashSetArch
 	);
 	const fs::path txHashSetPath =  fs::temp_directory_path() / fileName;
 
+	// Extracts and verifies what it can while the rest is still downloading.
+	TxHashSetDownload::Ptr pDownload = nullptr;
+
 	try
 	{
+		BlockHeaderPtr pHeader = m_pBlockChain->GetBlockHeaderByHash(txHashSetArchiveMessage.GetBlockHash());
+		if (pHeader != nullptr)
+		{
+			pDownload = std::make_shared<TxHashSetDownload>(m_config, pHeader);
+		}
+
 		std::ofstream fout;
 		fout.open(txHashSetPath, std::ios::binary | std::ios::out | std::ios::trunc);
 
@@ -91,6 +100,11 @@ void TxHashSetPipe::ReceiveTxHashSet(Connection& connection, const TxHashSetArch
 			fout.write((char*)&buffer[0], bytesToRead);
 			bytesReceived += bytesToRead;
 
+			if (pDownload != nullptr)
+			{
+				pDownload->Append(buffer.data(), bytesToRead);
+			}
+
 			m_pSyncStatus->UpdateDownloaded(bytesReceived);
 		}
 
@@ -115,11 +129,17 @@ void TxHashSetPipe::ReceiveTxHashSet(Connection& connection, const TxHashSetArch
 		std::ref(*this),
 		connection.GetPeer(),
 		txHashSetArchiveMessage.GetBlockHash(),
-		txHashSetPath.u8string()
+		txHashSetPath.u8string(),
+		pDownload
 	);
 }
 
-void TxHashSetPipe::Thread_ProcessTxHashSet(TxHashSetPipe& pipeline, PeerPtr pPeer, const Hash blockHash, const fs::path path)
+void TxHashSetPipe::Thread_ProcessTxHashSet(
+	TxHashSetPipe& pipeline,
+	PeerPtr pPeer,
+	const Hash blockHash,
+	const fs::path path,
+	TxHashSetDownload::Ptr pDownload)
 {
 	try
 	{
@@ -131,7 +151,12 @@ void TxHashSetPipe::Thread_ProcessTxHashSet(TxHashSetPipe& pipeline, PeerPtr pPe
 		pSyncStatus->UpdateProcessingStatus(0);
 		pSyncStatus->UpdateStatus(ESyncStatus::PROCESSING_TXHASHSET);
 
-		const EBlockChainStatus processStatus = pipeline.m_pBlockChain->ProcessTransactionHashSet(blockHash, path, *pSyncStatus);
+		if (pDownload != nullptr)
+		{
+			pDownload->Finish();
+		}
+
+		const EBlockChainStatus processStatus = pipeline.m_pBlockChain->ProcessTransactionHashSet(blockHash, path, pDownload, *pSyncStatus);
 		if (processStatus == EBlockChainStatus::INVALID)
 		{
 			LOG_ERROR("Invalid TxHashSet received.");
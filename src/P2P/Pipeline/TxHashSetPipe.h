@@ -47,7 +47,13 @@ private:
 	IBlockChain::Ptr m_pBlockChain;
 	SyncStatusPtr m_pSyncStatus;
 
-	static void Thread_ProcessTxHashSet(TxHashSetPipe& pipeline, PeerPtr pPeer, const Hash blockHash, const fs::path path);
+	static void Thread_ProcessTxHashSet(
+		TxHashSetPipe& pipeline,
+		PeerPtr pPeer,
+		const Hash blockHash,
+		const fs::path path,
+		TxHashSetDownload::Ptr pDownload
+	);
 	std::thread m_txHashSetThread;
 
 	std::atomic_bool m_processing;
@@ -0,0 +1,73 @@
+#include "RollingBloomFilter.h"
+
+#include <Common/Util/BitUtil.h>
+#include <Crypto/CSPRNG.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+RollingBloomFilter::RollingBloomFilter(const size_t capacity, const double falsePositiveRate)
+	: m_generationCapacity((std::max)(capacity / 2, (size_t)1)),
+	m_tweak(CSPRNG::GenerateRandom(0, (std::numeric_limits<uint64_t>::max)())),
+	m_current(0),
+	m_numInserted(0)
+{
+	// Optimal bloom filter parameters: m = -n*ln(p) / ln(2)^2 bits and k = (m/n)*ln(2) hash functions.
+	// Each generation has its own false positive rate, and both are checked, so each is sized for half the overall rate.
+	const double generationRate = falsePositiveRate / 2;
+	const double bits = -((double)m_generationCapacity * std::log(generationRate)) / (std::log(2.0) * std::log(2.0));
+	m_numBits = (std::max)((size_t)std::ceil(bits / 64) * 64, (size_t)64);
+	m_numHashes = (std::max)((size_t)std::round(((double)m_numBits / m_generationCapacity) * std::log(2.0)), (size_t)1);
+
+	for (std::vector<uint64_t>& generation : m_generations)
+	{
+		generation.resize(m_numBits / 64, 0);
+	}
+}
+
+void RollingBloomFilter::Insert(const Hash& hash)
+{
+	if (m_numInserted == m_generationCapacity)
+	{
+		m_current = 1 - m_current;
+		std::fill(m_generations[m_current].begin(), m_generations[m_current].end(), 0);
+		m_numInserted = 0;
+	}
+
+	std::vector<uint64_t>& generation = m_generations[m_current];
+	for (size_t i = 0; i < m_numHashes; i++)
+	{
+		const size_t bit = GetBitIndex(hash, i);
+		generation[bit / 64] |= ((uint64_t)1 << (bit % 64));
+	}
+
+	++m_numInserted;
+}
+
+bool RollingBloomFilter::Contains(const Hash& hash) const
+{
+	return Contains(m_generations[m_current], hash) || Contains(m_generations[1 - m_current], hash);
+}
+
+bool RollingBloomFilter::Contains(const std::vector<uint64_t>& generation, const Hash& hash) const
+{
+	for (size_t i = 0; i < m_numHashes; i++)
+	{
+		const size_t bit = GetBitIndex(hash, i);
+		if ((generation[bit / 64] & ((uint64_t)1 << (bit % 64))) == 0)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// Double hashing (h1 + i*h2), with h1 and h2 taken from different words of the hash.
+size_t RollingBloomFilter::GetBitIndex(const Hash& hash, const size_t i) const
+{
+	const uint64_t h1 = BitUtil::ConvertToU64(hash[0], hash[1], hash[2], hash[3], hash[4], hash[5], hash[6], hash[7]) ^ m_tweak;
+	const uint64_t h2 = BitUtil::ConvertToU64(hash[8], hash[9], hash[10], hash[11], hash[12], hash[13], hash[14], hash[15]) | 1;
+
+	return (size_t)((h1 + (i * h2)) % m_numBits);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Crypto/Hash.h>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+//
+// A probabilistic set of the most recently inserted hashes, with a fixed memory footprint.
+// Two bloom filters are kept, each holding half of the capacity. Inserts go to the newest, and once it's full the older one is
+// cleared and takes its place, so at least the last capacity/2 (and at most capacity) inserts are remembered.
+// Contains may return false positives at roughly the configured rate, but never false negatives for remembered hashes.
+// Not thread-safe.
+//
+class RollingBloomFilter
+{
+public:
+	RollingBloomFilter(const size_t capacity, const double falsePositiveRate);
+
+	void Insert(const Hash& hash);
+	bool Contains(const Hash& hash) const;
+
+private:
+	bool Contains(const std::vector<uint64_t>& generation, const Hash& hash) const;
+	size_t GetBitIndex(const Hash& hash, const size_t i) const;
+
+	size_t m_generationCapacity;
+	size_t m_numBits;
+	size_t m_numHashes;
+
+	// Hashes are already uniformly distributed, but are tweaked so filters on different nodes collide differently.
+	uint64_t m_tweak;
+
+	std::array<std::vector<uint64_t>, 2> m_generations;
+	size_t m_current;
+	size_t m_numInserted;
+};
@@ -2,6 +2,7 @@
 
 #include <Common/Logger.h>
 #include <asio.hpp>
+#include <future>
 
 DNSSeeder::DNSSeeder(const Config& config)
 	: m_config(config)
@@ -13,6 +14,18 @@ std::vector<SocketAddress> DNSSeeder::GetPeersFromDNS() const
 {
 	std::vector<SocketAddress> addresses;
 
+	// Configured seeds replace the DNS seeds entirely, so nodes in a private network (eg. a test harness) only find each other.
+	const std::vector<std::string>& configuredSeeds = m_config.GetP2PConfig().GetSeeds();
+	if (!configuredSeeds.empty())
+	{
+		for (const std::string& seed : configuredSeeds)
+		{
+			addresses.emplace_back(SocketAddress(IPAddress::Parse(seed), m_config.GetEnvironment().GetP2PPort()));
+		}
+
+		return addresses;
+	}
+
 	std::vector<std::string> dnsSeeds;
 	if (m_config.GetEnvironment().IsMainnet())
 	{
@@ -36,20 +49,28 @@ std::vector<SocketAddress> DNSSeeder::GetPeersFromDNS() const
 		};
 	}
 
-	for (auto seed : dnsSeeds)
+	// Resolution blocks, so the seeds are all resolved at once, each on its own thread,
+	// rather than waiting on each seed (or its timeout) in turn.
+	std::vector<std::future<std::vector<IPAddress>>> resolved;
+	for (const std::string& seed : dnsSeeds)
 	{
 		LOG_TRACE_F("Checking seed: {}", seed);
-		const std::vector<IPAddress> ipAddresses = Resolve(seed);
-		for (const IPAddress ipAddress : ipAddresses)
+		resolved.push_back(std::async(std::launch::async, [this, seed]() { return Resolve(seed); }));
+	}
+
+	for (auto& ipAddressesFuture : resolved)
+	{
+		const std::vector<IPAddress> ipAddresses = ipAddressesFuture.get();
+		for (const IPAddress& ipAddress : ipAddresses)
 		{
 			LOG_TRACE_F("IP Address: {}", ipAddress);
 			addresses.emplace_back(SocketAddress(ipAddress, m_config.GetEnvironment().GetP2PPort()));
 		}
+	}
 
-		if (!m_config.GetEnvironment().IsMainnet())
-		{
-			addresses.emplace_back(SocketAddress("100.26.68.39", 13414));
-		}
+	if (!m_config.GetEnvironment().IsMainnet())
+	{
+		addresses.emplace_back(SocketAddress("100.26.68.39", 13414));
 	}
 
 	return addresses;
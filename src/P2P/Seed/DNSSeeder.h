@@ -18,7 +18,7 @@ public:
 	DNSSeeder(const Config& config);
 
 	//
-	// Connects to one of the "trusted" DNS seeds, and retrieves a collection of IP addresses to MimbleWimble nodes.
+	// Queries all of the "trusted" DNS seeds concurrently, and retrieves a collection of IP addresses to MimbleWimble nodes.
 	//
 	std::vector<SocketAddress> GetPeersFromDNS() const;
 
@@ -54,7 +54,7 @@ bool HandShake::PerformOutboundHandshake(Socket& socket, ConnectedPeer& connecte
 			const MessageTypes::EMessageType messageType = pReceivedMessage->GetMessageHeader().GetMessageType();
 			if (messageType == MessageTypes::Shake)
 			{
-				ByteBuffer byteBuffer(pReceivedMessage->GetPayload());
+				ByteBuffer byteBuffer = pReceivedMessage->GetPayloadView();
 				const ShakeMessage shakeMessage = ShakeMessage::Deserialize(byteBuffer);
 
 				const uint32_t version = (std::min)(P2P::PROTOCOL_VERSION, shakeMessage.GetVersion());
@@ -67,7 +67,7 @@ bool HandShake::PerformOutboundHandshake(Socket& socket, ConnectedPeer& connecte
 			}
 			else if (messageType == MessageTypes::BanReasonMsg)
 			{
-				ByteBuffer byteBuffer(pReceivedMessage->GetPayload());
+				ByteBuffer byteBuffer = pReceivedMessage->GetPayloadView();
 				const BanReasonMessage banReasonMessage = BanReasonMessage::Deserialize(byteBuffer);
 
 				LOG_DEBUG_F("Ban message received from ({}) with reason ({})", socket, std::to_string(banReasonMessage.GetBanReason()));
@@ -96,7 +96,7 @@ bool HandShake::PerformInboundHandshake(Socket& socket, ConnectedPeer& connected
 	{
 		if (pReceivedMessage->GetMessageHeader().GetMessageType() == MessageTypes::Hand)
 		{
-			ByteBuffer byteBuffer(pReceivedMessage->GetPayload());
+			ByteBuffer byteBuffer = pReceivedMessage->GetPayloadView();
 			const HandMessage handMessage = HandMessage::Deserialize(byteBuffer);
 
 			if (handMessage.GetNonce() != NONCE && !m_connectionManager.IsConnected(connectedPeer.GetPeer()->GetIPAddress()))
@@ -146,7 +146,10 @@ bool HandShake::TransmitHandMessage(Socket& socket) const
 	const uint16_t portNumber = socket.GetPort();
 
 	const uint32_t version = P2P::PROTOCOL_VERSION;
-	const Capabilities capabilities(Capabilities::FAST_SYNC_NODE); // LIGHT_CLIENT: Read P2P Config once light-clients are supported
+	Capabilities capabilities(Capabilities::FAST_SYNC_NODE); // LIGHT_CLIENT: Read P2P Config once light-clients are supported
+	capabilities.AddCapability(Capabilities::COMPRESSION);
+	capabilities.AddCapability(Capabilities::COMPACT_BLOCK_PUSH);
+	capabilities.AddCapability(Capabilities::TX_BATCH_REQUESTS);
 	const uint64_t nonce = NONCE;
 	Hash hash = m_config.GetEnvironment().GetGenesisHash();
 	const uint64_t totalDifficulty = m_pSyncStatus->GetBlockDifficulty();
@@ -165,7 +168,10 @@ bool HandShake::TransmitHandMessage(Socket& socket) const
 
 bool HandShake::TransmitShakeMessage(Socket& socket, const uint32_t protocolVersion) const
 {
-	const Capabilities capabilities(Capabilities::FAST_SYNC_NODE); // LIGHT_CLIENT: Read P2P Config once light-clients are supported
+	Capabilities capabilities(Capabilities::FAST_SYNC_NODE); // LIGHT_CLIENT: Read P2P Config once light-clients are supported
+	capabilities.AddCapability(Capabilities::COMPRESSION);
+	capabilities.AddCapability(Capabilities::COMPACT_BLOCK_PUSH);
+	capabilities.AddCapability(Capabilities::TX_BATCH_REQUESTS);
 	Hash hash = m_config.GetEnvironment().GetGenesisHash();
 	const uint64_t totalDifficulty = m_pSyncStatus->GetBlockDifficulty();
 	const std::string& userAgent = P2P::USER_AGENT;
@@ -8,9 +8,12 @@
 #include <Common/Logger.h>
 #include <Common/ThreadManager.h>
 #include <Crypto/CSPRNG.h>
+#include <algorithm>
+#include <cstdint>
+#include <random>
 
 PeerManager::PeerManager(const Context::Ptr& pContext, std::shared_ptr<Locked<IPeerDB>> pPeerDB)
-	: m_taskId(0), m_pContext(pContext), m_pPeerDB(pPeerDB)
+	: m_taskId(0), m_pContext(pContext), m_pPeerDB(pPeerDB), m_numUnflushed(0)
 {
 
 }
@@ -20,81 +23,142 @@ PeerManager::~PeerManager()
 	LOG_INFO("Shutting down peer manager");
 
 	m_pContext->GetScheduler()->RemoveTask(m_taskId);
-	Thread_ManagePeers(*this);
+	Flush();
 }
 
 std::shared_ptr<Locked<PeerManager>> PeerManager::Create(const Context::Ptr& pContext, std::shared_ptr<Locked<IPeerDB>> pPeerDB)
 {
 	std::shared_ptr<PeerManager> pPeerManager(new PeerManager(pContext, pPeerDB));
 
-	pPeerManager->m_peersByAddress.clear();
 	const std::vector<PeerPtr> peers = pPeerDB->Read()->LoadAllPeers();
 	for (const PeerPtr& peer : peers)
 	{
-		pPeerManager->m_peersByAddress.emplace(peer->GetIPAddress(), PeerEntry(peer));
+		PeerEntry entry(peer);
+		entry.m_persisted = true;
+		pPeerManager->AddEntry(peer->GetIPAddress(), std::move(entry));
 	}
 
 	std::shared_ptr<Locked<PeerManager>> pLocked = std::make_shared<Locked<PeerManager>>(Locked<PeerManager>(pPeerManager));
 
 	std::weak_ptr<Locked<PeerManager>> pLockedWeak(pLocked);
-	const uint64_t taskId = pContext->GetScheduler()->interval(std::chrono::seconds(15), [pLockedWeak]() {
+	const TaskScheduler::TaskId taskId = pContext->GetScheduler()->Interval("PEER_MANAGER", std::chrono::seconds(15), [pLockedWeak]() {
 		auto pLocked = pLockedWeak.lock();
 		if (pLocked != nullptr)
 		{
 			auto pWriter = pLocked->Write();
-			PeerManager::Thread_ManagePeers(*pWriter.GetShared());
+			PeerManager::ManagePeers(*pWriter.GetShared());
 		}
-	});
+	}, ETaskPriority::LOW);
 
 	pPeerManager->SetTaskId(taskId);
 
 	return pLocked;
 }
 
-void PeerManager::Thread_ManagePeers(PeerManager& peerManager)
+void PeerManager::ManagePeers(PeerManager& peerManager)
 {
-	ThreadManagerAPI::SetCurrentThreadName("PEER_MANAGER");
 	LOG_TRACE("BEGIN");
 
+	peerManager.Flush();
+
+	LOG_TRACE("END");
+}
+
+void PeerManager::Flush()
+{
+	m_numUnflushed = 0;
+
 	try
 	{
 		std::vector<PeerPtr> peersToUpdate;
 		std::vector<PeerPtr> peersToDelete;
+		std::vector<IPAddress> expiredAddresses;
 
-		{
-			const time_t minimumContactTime = std::chrono::system_clock::to_time_t(
-				std::chrono::system_clock::now() - std::chrono::hours(24 * 7)
-			);
+		const time_t minimumContactTime = std::chrono::system_clock::to_time_t(
+			std::chrono::system_clock::now() - std::chrono::hours(24 * 7)
+		);
 
-			for (auto iter : peerManager.m_peersByAddress)
+		for (auto& iter : m_peersByAddress)
+		{
+			PeerEntry& peerEntry = iter.second;
+			if (peerEntry.m_peer->IsDirty())
 			{
-				PeerEntry& peerEntry = iter.second;
-				if (peerEntry.m_peer->IsDirty())
-				{
-					peersToUpdate.push_back(peerEntry.m_peer);
-					peerEntry.m_peer->SetDirty(false);
-				}
-				else if (peerEntry.m_peer->GetLastContactTime() < minimumContactTime)
+				peersToUpdate.push_back(peerEntry.m_peer);
+				peerEntry.m_peer->SetDirty(false);
+				peerEntry.m_persisted = true;
+			}
+			else if (peerEntry.m_peer->GetLastContactTime() < minimumContactTime)
+			{
+				expiredAddresses.push_back(iter.first);
+
+				// Most expired peers are addresses that were never connected to, and so were never written.
+				if (peerEntry.m_persisted)
 				{
 					peersToDelete.push_back(peerEntry.m_peer);
 				}
 			}
+		}
+
+		for (const IPAddress& address : expiredAddresses)
+		{
+			RemoveEntry(address);
+		}
 
-			for (PeerPtr pPeer : peersToDelete)
+		if (!peersToUpdate.empty() || !peersToDelete.empty())
+		{
+			auto pPeerDB = m_pPeerDB->Write();
+			if (!peersToUpdate.empty())
 			{
-				peerManager.m_peersByAddress.erase(pPeer->GetIPAddress());
+				pPeerDB->SavePeers(peersToUpdate);
 			}
-		}
 
-		peerManager.m_pPeerDB->Write()->SavePeers(peersToUpdate);
-		peerManager.m_pPeerDB->Write()->DeletePeers(peersToDelete);
+			if (!peersToDelete.empty())
+			{
+				pPeerDB->DeletePeers(peersToDelete);
+			}
+		}
 	}
 	catch (std::exception& e)
 	{
 		LOG_ERROR_F("Exception thrown: {}", e.what());
 	}
+}
 
-	LOG_TRACE("END");
+void PeerManager::AddEntry(const IPAddress& address, PeerEntry&& entry)
+{
+	entry.m_index = m_addresses.size();
+	if (m_peersByAddress.emplace(address, std::move(entry)).second)
+	{
+		m_addresses.push_back(address);
+	}
+}
+
+void PeerManager::RemoveEntry(const IPAddress& address)
+{
+	auto iter = m_peersByAddress.find(address);
+	if (iter == m_peersByAddress.end())
+	{
+		return;
+	}
+
+	// The last address takes the removed one's place.
+	const size_t index = iter->second.m_index;
+	if (index + 1 != m_addresses.size())
+	{
+		m_addresses[index] = m_addresses.back();
+		m_peersByAddress.at(m_addresses[index]).m_index = index;
+	}
+
+	m_addresses.pop_back();
+	m_peersByAddress.erase(iter);
+}
+
+void PeerManager::OnChanged()
+{
+	if (++m_numUnflushed >= FLUSH_THRESHOLD)
+	{
+		Flush();
+	}
 }
 
 bool PeerManager::ArePeersNeeded(const Capabilities::ECapability& preferredCapability) const
@@ -141,7 +205,7 @@ PeerPtr PeerManager::GetPeer(const IPAddress& address)
 	}
 
 	PeerPtr pPeer = std::make_shared<Peer>(address);
-	m_peersByAddress.emplace(address, PeerEntry(pPeer));
+	AddEntry(address, PeerEntry(pPeer));
 	return pPeer;
 }
 
@@ -156,12 +220,16 @@ std::optional<PeerConstPtr> PeerManager::GetPeer(const IPAddress& address) const
 	return m_pPeerDB->Read()->GetPeer(address, std::nullopt);
 }
 
+//
+// Picks the fastest of a few random candidates, going by the throughput measured the last time we were connected to them.
+// Candidates that were never measured rank as the average of those that were, so new peers still get tried.
+//
 PeerPtr PeerManager::GetNewPeer(const Capabilities::ECapability& preferredCapability)
 {
-	std::vector<PeerPtr> peers = GetPeersWithCapability(preferredCapability, 1, true);
+	std::vector<PeerPtr> peers = GetPeersWithCapability(preferredCapability, NEW_PEER_CANDIDATES, true);
 	if (peers.empty())
 	{
-		peers = GetPeersWithCapability(Capabilities::UNKNOWN, 1, true);
+		peers = GetPeersWithCapability(Capabilities::UNKNOWN, NEW_PEER_CANDIDATES, true);
 	}
 	
 	if (peers.empty())
@@ -169,7 +237,30 @@ PeerPtr PeerManager::GetNewPeer(const Capabilities::ECapability& preferredCapabi
 		return nullptr;
 	}
 
-	return peers.front();
+	double totalScore = 0.0;
+	size_t numMeasured = 0;
+	for (const PeerPtr& pPeer : peers)
+	{
+		if (pPeer->GetThroughputScore() > 0.0)
+		{
+			totalScore += pPeer->GetThroughputScore();
+			++numMeasured;
+		}
+	}
+
+	const double unmeasuredScore = numMeasured > 0 ? totalScore / numMeasured : 0.0;
+	auto getScore = [unmeasuredScore](const PeerPtr& pPeer) {
+		return pPeer->GetThroughputScore() > 0.0 ? pPeer->GetThroughputScore() : unmeasuredScore;
+	};
+
+	PeerPtr pBest = *std::max_element(
+		peers.cbegin(),
+		peers.cend(),
+		[&getScore](const PeerPtr& pLeft, const PeerPtr& pRight) { return getScore(pLeft) < getScore(pRight); }
+	);
+
+	m_peersByAddress.at(pBest->GetIPAddress()).m_lastAttempt = TimeUtil::Now();
+	return pBest;
 }
 
 std::vector<PeerPtr> PeerManager::GetAllPeers()
@@ -222,7 +313,7 @@ void PeerManager::AddFreshPeers(const std::vector<SocketAddress>& peerAddresses)
 		const IPAddress& ipAddress = socketAddress.GetIPAddress();
 		if (m_peersByAddress.find(ipAddress) == m_peersByAddress.end())
 		{
-			m_peersByAddress.emplace(ipAddress, PeerEntry(std::make_shared<Peer>(ipAddress)));
+			AddEntry(ipAddress, PeerEntry(std::make_shared<Peer>(ipAddress)));
 		}
 	}
 }
@@ -238,8 +329,10 @@ void PeerManager::BanPeer(const IPAddress& address, const EBanReason banReason)
 	{
 		PeerPtr peer = std::make_shared<Peer>(address, 0, Capabilities(0), "");
 		peer->Ban(banReason);
-		m_peersByAddress.emplace(address, PeerEntry(peer, TimeUtil::Now()));
+		AddEntry(address, PeerEntry(peer, TimeUtil::Now()));
 	}
+
+	OnChanged();
 }
 
 void PeerManager::UnbanPeer(const IPAddress& address)
@@ -248,6 +341,7 @@ void PeerManager::UnbanPeer(const IPAddress& address)
 	if (iter != m_peersByAddress.end())
 	{
 		iter->second.m_peer->Unban();
+		OnChanged();
 	}
 }
 
@@ -267,7 +361,50 @@ std::vector<PeerPtr> PeerManager::GetPeersWithCapability(
 	const time_t maxBanTime = std::chrono::system_clock::to_time_t(
 		std::chrono::system_clock::now() - std::chrono::seconds(P2P::BAN_WINDOW)
 	);
-	
+
+	auto isCandidate = [&](const PeerEntry& peerEntry) {
+		const PeerPtr& peer = peerEntry.m_peer;
+		if (connectingToPeer && peer->GetLastBanTime() > maxBanTime)
+		{
+			return false;
+		}
+
+		if (!peer->GetCapabilities().HasCapability(preferredCapability))
+		{
+			return false;
+		}
+
+		if (connectingToPeer && (peer->IsConnected() || std::difftime(currentTime, peerEntry.m_lastAttempt) <= P2P::RETRY_WINDOW))
+		{
+			return false;
+		}
+
+		return std::find(peersFound.cbegin(), peersFound.cend(), peer) == peersFound.cend();
+	};
+
+	// Random picks from m_addresses usually fill the candidates without walking the map.
+	std::mt19937_64 engine(CSPRNG::GenerateRandom(0, UINT64_MAX));
+	std::uniform_int_distribution<size_t> distribution(0, m_addresses.size() - 1);
+	const size_t numSamples = (std::min)(numPeers, (size_t)maxPeers * SAMPLES_PER_PEER);
+	for (size_t i = 0; i < numSamples; i++)
+	{
+		const PeerEntry& peerEntry = m_peersByAddress.at(m_addresses[distribution(engine)]);
+		if (isCandidate(peerEntry))
+		{
+			peersFound.push_back(peerEntry.m_peer);
+			if (peersFound.size() == maxPeers)
+			{
+				return peersFound;
+			}
+		}
+	}
+
+	// A new peer only needs one candidate, so the map is only scanned when candidates are too rare to be found at random.
+	if (connectingToPeer && !peersFound.empty())
+	{
+		return peersFound;
+	}
+
 	auto iter = m_peersByAddress.begin();
 	std::advance(iter, CSPRNG::GenerateRandom(0, numPeers));
 
@@ -279,29 +416,12 @@ std::vector<PeerPtr> PeerManager::GetPeersWithCapability(
 			iter = m_peersByAddress.begin();
 		}
 
-		PeerEntry& peerEntry = iter->second;
-		const PeerPtr& peer = peerEntry.m_peer;
-
-		if (connectingToPeer && peer->GetLastBanTime() > maxBanTime)
-		{
-			continue;
-		}
-
-		const bool hasCapability = peer->GetCapabilities().HasCapability(preferredCapability);
-		if (hasCapability)
+		if (isCandidate(iter->second))
 		{
-			if (!connectingToPeer || (!peerEntry.m_peer->IsConnected() && std::difftime(currentTime, peerEntry.m_lastAttempt) > P2P::RETRY_WINDOW))
+			peersFound.push_back(iter->second.m_peer);
+			if (peersFound.size() == maxPeers)
 			{
-				if (connectingToPeer)
-				{
-					peerEntry.m_lastAttempt = currentTime;
-				}
-
-				peersFound.push_back(peer);
-				if (peersFound.size() == maxPeers)
-				{
-					return peersFound;
-				}
+				return peersFound;
 			}
 		}
 	}
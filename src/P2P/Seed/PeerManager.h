@@ -46,22 +46,50 @@ private:
 	struct PeerEntry
 	{
 		PeerEntry(const PeerPtr& pPeer)
-			: m_peer(pPeer), m_lastAttempt(0)//, m_connected(false), m_dirty(false)
+			: m_peer(pPeer), m_lastAttempt(0), m_persisted(false), m_index(0)
 		{
 
 		}
 
 		PeerEntry(const PeerPtr& pPeer, const time_t& lastAttempt)
-			: m_peer(pPeer), m_lastAttempt(lastAttempt)
+			: m_peer(pPeer), m_lastAttempt(lastAttempt), m_persisted(false), m_index(0)
 		{
 
 		}
 
 		PeerPtr m_peer;
 		time_t m_lastAttempt;
+
+		// Whether the peer has been written to the PeerDB, so expiring it needs a delete.
+		bool m_persisted;
+
+		// The peer's position in m_addresses.
+		size_t m_index;
 	};
 
-	static void Thread_ManagePeers(PeerManager& peerManager);
+	// Number of random candidates GetNewPeer chooses between.
+	static constexpr uint16_t NEW_PEER_CANDIDATES = 8;
+
+	// Random picks made per requested peer before GetPeersWithCapability falls back to scanning every peer.
+	static constexpr size_t SAMPLES_PER_PEER = 4;
+
+	//
+	// Changes made through the PeerManager (bans and unbans) are written on the next interval,
+	// unless this many build up first. Peers marked dirty by their connections are only written on the interval.
+	//
+	static constexpr size_t FLUSH_THRESHOLD = 256;
+
+	static void ManagePeers(PeerManager& peerManager);
+
+	//
+	// Writes dirty peers to the PeerDB in a single batch, and expires peers that haven't been seen in a week.
+	// Each peer is written at most once per flush, however many times it changed.
+	//
+	void Flush();
+
+	void AddEntry(const IPAddress& address, PeerEntry&& entry);
+	void RemoveEntry(const IPAddress& address);
+	void OnChanged();
 
 	std::vector<PeerPtr> GetPeersWithCapability(const Capabilities::ECapability& preferredCapability, const uint16_t maxPeers, const bool connectingToPeer) const;
 
@@ -72,4 +100,10 @@ private:
 	std::shared_ptr<Locked<IPeerDB>> m_pPeerDB;
 
 	mutable std::map<IPAddress, PeerEntry> m_peersByAddress;
+
+	// Every address in m_peersByAddress, in no particular order, so peers can be picked at random without walking the map.
+	std::vector<IPAddress> m_addresses;
+
+	// The number of changes made through the PeerManager since the last flush.
+	size_t m_numUnflushed;
 };
\ No newline at end of file
@@ -14,12 +14,18 @@
 #include <Common/Logger.h>
 #include <algorithm>
 
+static const std::chrono::seconds PEER_ROTATION_INTERVAL(60);
+
+// Missing outbound connections are dialed this many times over, and the first peers to complete their handshakes are kept.
+static const size_t DIALS_PER_MISSING_CONNECTION = 2;
+static const size_t MAX_CONCURRENT_DIALS = 32;
+
 Seeder::~Seeder()
 {
 	LOG_INFO("Shutting down seeder");
 	m_terminate = true;
+	m_pContext->GetScheduler()->RemoveTask(m_seedTaskId);
 	ThreadUtil::Join(m_listenerThread);
-	ThreadUtil::Join(m_seedThread);
 }
 
 std::unique_ptr<Seeder> Seeder::Create(
@@ -28,7 +34,8 @@ std::unique_ptr<Seeder> Seeder::Create(
 	Locked<PeerManager> peerManager,
 	const IBlockChain::Ptr& pBlockChain,
 	std::shared_ptr<Pipeline> pPipeline,
-	SyncStatusConstPtr pSyncStatus)
+	SyncStatusConstPtr pSyncStatus,
+	const HeaderBatchCache::Ptr& pHeaderCache)
 {
 	auto pMessageProcessor = std::make_shared<MessageProcessor>(
 		pContext->GetConfig(),
@@ -36,7 +43,8 @@ std::unique_ptr<Seeder> Seeder::Create(
 		peerManager,
 		pBlockChain,
 		pPipeline,
-		pSyncStatus
+		pSyncStatus,
+		pHeaderCache
 	);
 	std::unique_ptr<Seeder> pSeeder(new Seeder(
 		pContext,
@@ -46,51 +54,59 @@ std::unique_ptr<Seeder> Seeder::Create(
 		pMessageProcessor,
 		pSyncStatus
 	));
-	pSeeder->m_seedThread = std::thread(Thread_Seed, std::ref(*pSeeder.get()));
+	Seeder* pSeederRaw = pSeeder.get();
+	pSeeder->m_seedTaskId = pContext->GetScheduler()->Interval("SEED", std::chrono::milliseconds(100), [pSeederRaw]() { pSeederRaw->Seed(); });
 	pSeeder->m_listenerThread = std::thread(Thread_Listener, std::ref(*pSeeder.get()));
 	return pSeeder;
 }
 
 //
-// Continuously checks the number of connected peers, and connects to additional peers when the number of connections drops below the minimum.
-// This function operates in its own thread.
+// Checks the number of connected peers, and connects to additional peers when the number of connections drops below the minimum.
+// This function is run every 100ms by the context's scheduler.
 //
-void Seeder::Thread_Seed(Seeder& seeder)
+void Seeder::Seed()
 {
-	ThreadManagerAPI::SetCurrentThreadName("SEED");
-	LOG_TRACE("BEGIN");
-
-	auto lastConnectTime = std::chrono::system_clock::now() - std::chrono::seconds(10);
+	const size_t minimumConnections = m_pContext->GetConfig().GetP2PConfig().GetMinConnections();
 
-	const size_t minimumConnections = seeder.m_pContext->GetConfig().GetP2PConfig().GetMinConnections();
-	while (!seeder.m_terminate)
+	try
 	{
-		try
+		m_connectionManager.PruneConnections(true);
+
+		auto now = std::chrono::system_clock::now();
+
+		// While downloading blocks, the slowest peer is periodically swapped for a new one,
+		// so the download settles on the fastest peers available.
+		if (m_pSyncStatus->GetStatus() == ESyncStatus::SYNCING_BLOCKS && m_lastRotateTime + PEER_ROTATION_INTERVAL < now)
+		{
+			m_lastRotateTime = now;
+			m_connectionManager.DisconnectSlowestPeer();
+		}
+
+		// Dials still in progress count towards the target, so slow handshakes don't cause extra dials to pile up.
+		const size_t numOutbound = m_connectionManager.GetNumOutbound();
+		const size_t numDialing = m_connectionManager.GetNumDialing();
+		if (numOutbound < minimumConnections)
 		{
-			seeder.m_connectionManager.PruneConnections(true);
+			const size_t targetDials = (std::min)(MAX_CONCURRENT_DIALS, (minimumConnections - numOutbound) * DIALS_PER_MISSING_CONNECTION);
+			if (numDialing < targetDials)
+			{
+				LOG_TRACE_F("Attempting to add {} connections", targetDials - numDialing);
+			}
 
-			auto now = std::chrono::system_clock::now();
-			const size_t numOutbound = seeder.m_connectionManager.GetNumOutbound();
-			if (numOutbound < minimumConnections && lastConnectTime + std::chrono::seconds(2) < now)
+			for (size_t i = numDialing; i < targetDials; i++)
 			{
-				lastConnectTime = now;
-				const size_t connectionsToAdd = (std::min)((size_t)15, (minimumConnections - numOutbound));
-				LOG_TRACE_F("Attempting to add {} connections", connectionsToAdd);
-				for (size_t i = 0; i < connectionsToAdd; i++)
+				// Stop once the candidates run out. The first empty attempt falls back to the DNS seeds.
+				if (SeedNewConnection() == nullptr)
 				{
-					seeder.SeedNewConnection();
+					break;
 				}
 			}
 		}
-		catch (std::exception& e)
-		{
-			LOG_WARNING_F("Exception thrown: {}", e.what());
-		}
-
-		ThreadUtil::SleepFor(std::chrono::milliseconds(100), seeder.m_terminate);
 	}
-
-	LOG_TRACE("END");
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Exception thrown: {}", e.what());
+	}
 }
 
 //
@@ -105,7 +121,11 @@ void Seeder::Thread_Listener(Seeder& seeder)
 	try
 	{
 		const uint16_t portNumber = seeder.m_pContext->GetConfig().GetEnvironment().GetP2PPort();
-		asio::ip::tcp::acceptor acceptor(*seeder.m_pAsioContext, asio::ip::tcp::endpoint(asio::ip::tcp::v4(), portNumber));
+		const std::string& bindIP = seeder.m_pContext->GetConfig().GetP2PConfig().GetBindIP();
+		const asio::ip::tcp::endpoint listenEndpoint = bindIP.empty()
+			? asio::ip::tcp::endpoint(asio::ip::tcp::v4(), portNumber)
+			: asio::ip::tcp::endpoint(asio::ip::address_v4::from_string(bindIP), portNumber);
+		asio::ip::tcp::acceptor acceptor(*seeder.m_pAsioContext, listenEndpoint);
 		asio::error_code errorCode;
 		acceptor.listen(asio::socket_base::max_listen_connections, errorCode);
 
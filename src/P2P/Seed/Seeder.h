@@ -9,6 +9,7 @@
 #include <cstdint>
 #include <memory>
 #include <atomic>
+#include <chrono>
 #include <thread>
 #include <optional>
 #include <asio.hpp>
@@ -28,7 +29,8 @@ public:
 		Locked<PeerManager> peerManager,
 		const IBlockChain::Ptr& pBlockChain,
 		std::shared_ptr<Pipeline> pPipeline,
-		SyncStatusConstPtr pSyncStatus
+		SyncStatusConstPtr pSyncStatus,
+		const HeaderBatchCache::Ptr& pHeaderCache
 	);
 	~Seeder();
 
@@ -47,9 +49,11 @@ private:
 		m_pMessageProcessor(pMessageProcessor),
 		m_pSyncStatus(pSyncStatus),
 		m_pAsioContext(std::make_shared<asio::io_context>()),
-		m_terminate(false) { }
+		m_terminate(false),
+		m_seedTaskId(0),
+		m_lastRotateTime(std::chrono::system_clock::now()) { }
 
-	static void Thread_Seed(Seeder& seeder);
+	void Seed();
 	static void Thread_Listener(Seeder& seeder);
 
 	ConnectionPtr SeedNewConnection();
@@ -64,7 +68,8 @@ private:
 	std::atomic<bool> m_terminate = true;
 
 	std::shared_ptr<asio::io_context> m_pAsioContext;
-	std::thread m_seedThread;
+	uint64_t m_seedTaskId;
+	std::chrono::system_clock::time_point m_lastRotateTime;
 	std::thread m_listenerThread;
 	mutable std::atomic_bool m_usedDNS = false;
 	mutable uint64_t m_nextId = { 1 };
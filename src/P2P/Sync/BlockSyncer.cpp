@@ -4,7 +4,26 @@
 
 #include <Common/Logger.h>
 #include <Common/Util/StringUtil.h>
-#include <Crypto/CSPRNG.h>
+#include <algorithm>
+#include <cmath>
+
+// How often requests are retired and the window is refilled.
+static const std::chrono::milliseconds UPDATE_INTERVAL(100);
+
+// How often each peer's throughput estimate is refreshed.
+static const std::chrono::seconds SAMPLE_INTERVAL(1);
+
+// Every peer may have at least this many blocks outstanding, which also serves as the slow start for new peers.
+static const size_t MIN_BLOCKS_IN_FLIGHT = 16;
+
+// Peers are given enough blocks to stay busy for this long at their measured rate.
+static const double TARGET_BUFFER_SECONDS = 5.0;
+
+static const std::chrono::seconds BASE_TIMEOUT(10);
+static const std::chrono::seconds MAX_TIMEOUT(60);
+
+// Peers that stall this many times in a row are no longer used.
+static const size_t MAX_STALLS = 3;
 
 bool BlockSyncer::SyncBlocks(const SyncStatus& syncStatus, const bool startup)
 {
@@ -13,12 +32,11 @@ bool BlockSyncer::SyncBlocks(const SyncStatus& syncStatus, const bool startup)
 
 	if (networkHeight >= (chainHeight + 5) || (startup && networkHeight > chainHeight))
 	{
-		if (IsBlockSyncDue(syncStatus))
+		const auto now = std::chrono::system_clock::now();
+		if (now >= m_nextUpdate)
 		{
-			RequestBlocks();
-
-			m_lastHeight = chainHeight;
-			m_timeout = std::chrono::system_clock::now() + std::chrono::seconds(5);
+			m_nextUpdate = now + UPDATE_INTERVAL;
+			UpdateRequests(m_pBlockChain->GetBlocksNeeded(m_config.GetBlockSyncWindow()));
 		}
 
 		return true;
@@ -27,148 +45,265 @@ bool BlockSyncer::SyncBlocks(const SyncStatus& syncStatus, const bool startup)
 	return false;
 }
 
-bool BlockSyncer::IsBlockSyncDue(const SyncStatus& syncStatus)
+void BlockSyncer::PrefetchBlocks(const uint64_t firstHeight)
 {
-	const uint64_t chainHeight = syncStatus.GetBlockHeight();
-
-	const uint64_t blocksDownloaded = (chainHeight - m_lastHeight);
-	if (blocksDownloaded > 0)
+	const auto now = std::chrono::system_clock::now();
+	if (now >= m_nextUpdate)
 	{
-		LOG_TRACE_F("{} blocks received since last check.", blocksDownloaded);
-	}
+		m_nextUpdate = now + UPDATE_INTERVAL;
 
-	// Remove downloaded blocks from queue.
-	for (size_t i = m_lastHeight; i <= chainHeight; i++)
-	{
-		m_requestedBlocks.erase(i);
+		// Nothing is listed while the orphan pool is half full, which says nothing about which requests were received.
+		std::vector<std::pair<uint64_t, Hash>> blocksNeeded = m_pBlockChain->GetBlocksToPrefetch(firstHeight, m_config.GetBlockSyncWindow());
+		if (!blocksNeeded.empty())
+		{
+			UpdateRequests(blocksNeeded);
+		}
 	}
+}
 
-	m_lastHeight = chainHeight;
+void BlockSyncer::UpdateRequests(const std::vector<std::pair<uint64_t, Hash>>& blocksNeeded)
+{
+	RetireRequests(blocksNeeded);
+	UpdateThroughput();
+	RequestBlocks(blocksNeeded);
+}
 
-	// Check if blocks were received, and we're ready to request next batch.
-	if (m_requestedBlocks.size() < 15)
+//
+// Removes requests for blocks that have been received (confirmed, orphaned, or in the block pipe),
+// and frees up the heights of requests that have timed out so they can be reassigned.
+//
+void BlockSyncer::RetireRequests(const std::vector<std::pair<uint64_t, Hash>>& blocksNeeded)
+{
+	std::unordered_set<uint64_t> neededHeights;
+	for (const auto& blockNeeded : blocksNeeded)
 	{
-		LOG_TRACE("Requesting next batch.");
-		return true;
+		neededHeights.insert(blockNeeded.first);
 	}
 
-	// Make sure we have valid requests for the first 15 blocks.
-	std::vector<std::pair<uint64_t, Hash>> blocksNeeded = m_pBlockChain->GetBlocksNeeded(15);
-	for (auto iter = blocksNeeded.cbegin(); iter != blocksNeeded.cend(); iter++)
+	// When the window is full, heights past its end are simply not listed yet, rather than received.
+	const bool windowFull = blocksNeeded.size() >= m_config.GetBlockSyncWindow();
+	const uint64_t lastNeededHeight = blocksNeeded.empty() ? 0 : blocksNeeded.back().first;
+
+	const auto now = std::chrono::system_clock::now();
+	auto iter = m_requestedBlocks.begin();
+	while (iter != m_requestedBlocks.end())
 	{
-		auto requestedBlocksIter = m_requestedBlocks.find(iter->first);
-		if (requestedBlocksIter == m_requestedBlocks.end())
+		const uint64_t height = iter->first;
+		PeerStats& stats = m_peerStats[iter->second.PEER->GetIPAddress()];
+
+		bool received = neededHeights.find(height) == neededHeights.end() && (!windowFull || height <= lastNeededHeight);
+		if (!received && m_pPipeline->GetBlockPipe()->IsProcessingBlock(iter->second.HASH))
 		{
-			LOG_TRACE("Block not requested yet. Requesting now.");
-			return true;
+			received = true;
 		}
 
-		if (IsSlowPeer(requestedBlocksIter->second.PEER))
+		if (received)
 		{
-			LOG_TRACE("Waiting on block from banned peer. Requesting from valid peer now.");
-			return true;
+			stats.IN_FLIGHT -= (std::min)(stats.IN_FLIGHT, (size_t)1);
+			stats.DELIVERED++;
+			stats.STALLS = 0;
+			iter = m_requestedBlocks.erase(iter);
 		}
-
-		if (requestedBlocksIter->second.TIMEOUT < std::chrono::system_clock::now())
+		else if (iter->second.TIMEOUT < now)
 		{
-			if (m_pPipeline->GetBlockPipe()->IsProcessingBlock(iter->second))
+			LOG_DEBUG_F("Block {} from {} timed out. Reassigning.", height, iter->second.PEER);
+
+			stats.IN_FLIGHT -= (std::min)(stats.IN_FLIGHT, (size_t)1);
+			stats.BLOCKS_PER_SECOND /= 2;
+			if (++stats.STALLS >= MAX_STALLS && m_slowPeers.insert(iter->second.PEER->GetIPAddress()).second)
 			{
-				continue;
+				LOG_INFO_F("No longer requesting blocks from slow peer {}", iter->second.PEER);
 			}
 
-			LOG_WARNING("Block request timed out. Requesting again.");
-			return true;
+			m_stalledBy[height] = iter->second.PEER->GetIPAddress();
+			iter = m_requestedBlocks.erase(iter);
+		}
+		else
+		{
+			++iter;
 		}
 	}
 
-	return false;
+	for (auto stalledIter = m_stalledBy.begin(); stalledIter != m_stalledBy.end();)
+	{
+		if (neededHeights.find(stalledIter->first) == neededHeights.end())
+		{
+			stalledIter = m_stalledBy.erase(stalledIter);
+		}
+		else
+		{
+			++stalledIter;
+		}
+	}
 }
 
-bool BlockSyncer::RequestBlocks()
+void BlockSyncer::UpdateThroughput()
 {
-	LOG_TRACE("Requesting blocks.");
+	const auto now = std::chrono::system_clock::now();
+	const double elapsed = std::chrono::duration<double>(now - m_lastSample).count();
+	if (elapsed < std::chrono::duration<double>(SAMPLE_INTERVAL).count())
+	{
+		return;
+	}
 
-	std::vector<PeerPtr> mostWorkPeers = m_pConnectionManager.lock()->GetMostWorkPeers();
-	const uint64_t numPeers = mostWorkPeers.size();
-	if (mostWorkPeers.empty())
+	m_lastSample = now;
+
+	for (auto& peerStats : m_peerStats)
 	{
-		LOG_DEBUG("No most-work peers found.");
-		return false;
+		PeerStats& stats = peerStats.second;
+		if (stats.IN_FLIGHT > 0 || stats.DELIVERED > 0)
+		{
+			const double rate = stats.DELIVERED / elapsed;
+			stats.BLOCKS_PER_SECOND = stats.BLOCKS_PER_SECOND == 0 ? rate : (0.7 * stats.BLOCKS_PER_SECOND) + (0.3 * rate);
+		}
+
+		stats.DELIVERED = 0;
 	}
+}
 
-	const uint64_t numBlocksNeeded = 16 * numPeers;
-	std::vector<std::pair<uint64_t, Hash>> blocksNeeded = m_pBlockChain->GetBlocksNeeded(2 * numBlocksNeeded);
+bool BlockSyncer::RequestBlocks(const std::vector<std::pair<uint64_t, Hash>>& blocksNeeded)
+{
 	if (blocksNeeded.empty())
 	{
 		LOG_TRACE("No blocks needed.");
 		return false;
 	}
 
-	size_t blockIndex = 0;
+	auto pConnectionManager = m_pConnectionManager.lock();
+	std::vector<PeerPtr> mostWorkPeers = pConnectionManager->GetMostWorkPeers();
+	mostWorkPeers.erase(
+		std::remove_if(mostWorkPeers.begin(), mostWorkPeers.end(), [](const PeerPtr& pPeer) { return pPeer->IsBanned(); }),
+		mostWorkPeers.end()
+	);
+
+	std::vector<PeerPtr> peers;
+	std::copy_if(
+		mostWorkPeers.cbegin(),
+		mostWorkPeers.cend(),
+		std::back_inserter(peers),
+		[this](const PeerPtr& pPeer) { return !IsSlowPeer(pPeer); }
+	);
+
+	if (peers.empty() && !mostWorkPeers.empty())
+	{
+		LOG_DEBUG("Only slow peers available. Giving them another chance.");
+		m_slowPeers.clear();
+		peers = mostWorkPeers;
+	}
 
-	std::vector<std::pair<uint64_t, Hash>> blocksToRequest;
+	if (peers.empty())
+	{
+		LOG_DEBUG("No most-work peers found.");
+		return false;
+	}
 
-	while (blockIndex < blocksNeeded.size())
+	// Forget peers that are gone and have nothing outstanding.
+	std::unordered_set<IPAddress> connectedAddresses;
+	for (const PeerPtr& pPeer : peers)
 	{
-		if (m_pPipeline->GetBlockPipe()->IsProcessingBlock(blocksNeeded[blockIndex].second))
-		{
-			++blockIndex;
-			continue;
-		}
+		connectedAddresses.insert(pPeer->GetIPAddress());
+	}
 
-		auto iter = m_requestedBlocks.find(blocksNeeded[blockIndex].first);
-		if (iter != m_requestedBlocks.end())
+	for (auto iter = m_peerStats.begin(); iter != m_peerStats.end();)
+	{
+		if (iter->second.IN_FLIGHT == 0 && connectedAddresses.find(iter->first) == connectedAddresses.end())
 		{
-			if (IsSlowPeer(iter->second.PEER) || iter->second.TIMEOUT < std::chrono::system_clock::now())
-			{
-				if (!iter->second.PEER->IsBanned())
-				{
-					LOG_ERROR_F("Banning peer {} for fraud height.", iter->second.PEER);
-					iter->second.PEER->Ban(EBanReason::FraudHeight);
-				}
-
-				m_slowPeers.insert(iter->second.PEER->GetIPAddress());
-
-				blocksToRequest.emplace_back(blocksNeeded[blockIndex]);
-			}
+			iter = m_peerStats.erase(iter);
 		}
 		else
 		{
-			blocksToRequest.emplace_back(blocksNeeded[blockIndex]);
+			++iter;
 		}
+	}
 
-		if (blocksToRequest.size() >= numBlocksNeeded)
+	std::vector<PeerStats*> candidates;
+	for (const PeerPtr& pPeer : peers)
+	{
+		auto iter = m_peerStats.find(pPeer->GetIPAddress());
+		if (iter == m_peerStats.end())
 		{
-			break;
+			iter = m_peerStats.emplace(pPeer->GetIPAddress(), PeerStats{ pPeer, 0, 0, 0, 0.0 }).first;
 		}
 
-		++blockIndex;
+		iter->second.PEER = pPeer;
+		candidates.push_back(&iter->second);
 	}
 
-	size_t nextPeer = CSPRNG::GenerateRandom(0, mostWorkPeers.size() - 1);
-	for (size_t i = 0; i < blocksToRequest.size(); i++)
+	size_t numRequested = 0;
+	for (const auto& blockNeeded : blocksNeeded)
 	{
-		const GetBlockMessage getBlockMessage(blocksToRequest[i].second);
-		if (m_pConnectionManager.lock()->SendMessageToPeer(getBlockMessage, mostWorkPeers[nextPeer]))
+		if (m_requestedBlocks.find(blockNeeded.first) != m_requestedBlocks.end()
+			|| m_pPipeline->GetBlockPipe()->IsProcessingBlock(blockNeeded.second))
 		{
-			RequestedBlock blockRequested;
-			blockRequested.BLOCK_HEIGHT = blocksToRequest[i].first;
-			blockRequested.PEER = mostWorkPeers[nextPeer];
-			blockRequested.TIMEOUT = std::chrono::system_clock::now() + std::chrono::seconds(10);
+			continue;
+		}
+
+		// Stripe across peers by giving each block to the peer with the most spare capacity,
+		// avoiding the peer that last stalled on this height when there's any alternative.
+		auto stalledIter = m_stalledBy.find(blockNeeded.first);
 
-			m_requestedBlocks[blockRequested.BLOCK_HEIGHT] = std::move(blockRequested);
+		PeerStats* pBestPeer = nullptr;
+		size_t bestSpare = 0;
+		for (PeerStats* pStats : candidates)
+		{
+			if (stalledIter != m_stalledBy.end() && candidates.size() > 1 && stalledIter->second == pStats->PEER->GetIPAddress())
+			{
+				continue;
+			}
+
+			const size_t limit = GetInFlightLimit(*pStats);
+			if (pStats->IN_FLIGHT < limit && (limit - pStats->IN_FLIGHT) > bestSpare)
+			{
+				pBestPeer = pStats;
+				bestSpare = limit - pStats->IN_FLIGHT;
+			}
 		}
 
-		if ((i + 1) % 16 == 0)
+		if (pBestPeer == nullptr)
 		{
-			nextPeer = (nextPeer + 1) % mostWorkPeers.size();
+			// Every peer is at its limit.
+			break;
+		}
+
+		const GetBlockMessage getBlockMessage(blockNeeded.second);
+		if (pConnectionManager->SendMessageToPeer(getBlockMessage, pBestPeer->PEER))
+		{
+			RequestedBlock blockRequested;
+			blockRequested.PEER = pBestPeer->PEER;
+			blockRequested.HASH = blockNeeded.second;
+			blockRequested.TIMEOUT = std::chrono::system_clock::now() + GetRequestTimeout(*pBestPeer);
+
+			m_requestedBlocks[blockNeeded.first] = std::move(blockRequested);
+			pBestPeer->IN_FLIGHT++;
+			m_stalledBy.erase(blockNeeded.first);
+			numRequested++;
 		}
 	}
 
-	if (!blocksToRequest.empty())
+	if (numRequested > 0)
 	{
-		LOG_TRACE_F("{} blocks requested from {} peers.", blocksToRequest.size(), numPeers);
+		LOG_TRACE_F("{} blocks requested from {} peers. {} now in flight.", numRequested, candidates.size(), m_requestedBlocks.size());
 	}
 
 	return true;
-}
\ No newline at end of file
+}
+
+size_t BlockSyncer::GetInFlightLimit(const PeerStats& stats) const
+{
+	const size_t maxInFlight = (std::max)((size_t)1, (size_t)m_config.GetMaxBlocksInFlightPerPeer());
+	const size_t minInFlight = (std::min)(MIN_BLOCKS_IN_FLIGHT, maxInFlight);
+
+	const size_t sized = (size_t)std::ceil(stats.BLOCKS_PER_SECOND * TARGET_BUFFER_SECONDS);
+	return (std::max)(minInFlight, (std::min)(sized, maxInFlight));
+}
+
+//
+// Blocks queued behind a peer's other outstanding blocks take longer to arrive, so the timeout grows with the queue.
+//
+std::chrono::system_clock::duration BlockSyncer::GetRequestTimeout(const PeerStats& stats) const
+{
+	const double queueSeconds = stats.IN_FLIGHT / (std::max)(stats.BLOCKS_PER_SECOND, 1.0);
+	const auto timeout = BASE_TIMEOUT + std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::duration<double>(queueSeconds));
+
+	return (std::min)(std::chrono::duration_cast<std::chrono::system_clock::duration>(MAX_TIMEOUT), timeout);
+}
@@ -4,6 +4,7 @@
 #include "../Pipeline/Pipeline.h"
 
 #include <BlockChain/BlockChain.h>
+#include <Config/P2PConfig.h>
 #include <chrono>
 #include <deque>
 #include <unordered_set>
@@ -13,42 +14,73 @@
 // Forward Declarations
 class SyncStatus;
 
+//
+// Downloads blocks for the candidate chain using a sliding window striped across all most-work peers.
+//
+// Up to P2PConfig::GetBlockSyncWindow() needed blocks are kept requested at once. Each peer's share is limited
+// by its measured throughput (blocks delivered per second), so fast peers are given more of the window.
+// Blocks that arrive out of order are held in the orphan pool until their parents arrive.
+// Requests that stall are reassigned to another peer, and peers that stall repeatedly are no longer used.
+//
 class BlockSyncer
 {
 public:
 	BlockSyncer(
 		const std::weak_ptr<ConnectionManager>& pConnectionManager,
 		const IBlockChain::Ptr& pBlockChain,
-		const std::shared_ptr<Pipeline>& pPipeline
+		const std::shared_ptr<Pipeline>& pPipeline,
+		const P2PConfig& config
 	) : m_pConnectionManager(pConnectionManager),
 		m_pBlockChain(pBlockChain),
 		m_pPipeline(pPipeline),
-		m_timeout(std::chrono::system_clock::now()),
-		m_lastHeight(0),
-		m_highestRequested(0) { }
+		m_config(config),
+		m_nextUpdate(std::chrono::system_clock::now()),
+		m_lastSample(std::chrono::system_clock::now()) { }
 
 	bool SyncBlocks(const SyncStatus& syncStatus, const bool startup);
 
+	//
+	// Downloads the blocks from firstHeight on, while the TxHashSet below them is still being validated.
+	// They're verified and held in the orphan pool, so they can be applied as soon as the TxHashSet is accepted.
+	//
+	void PrefetchBlocks(const uint64_t firstHeight);
+
 private:
-	bool IsBlockSyncDue(const SyncStatus& syncStatus);
-	bool RequestBlocks();
+	struct RequestedBlock
+	{
+		PeerPtr PEER;
+		Hash HASH;
+		std::chrono::time_point<std::chrono::system_clock> TIMEOUT;
+	};
+
+	struct PeerStats
+	{
+		PeerPtr PEER;
+		size_t IN_FLIGHT;
+		size_t DELIVERED; // Since the last throughput sample
+		size_t STALLS; // Consecutive
+		double BLOCKS_PER_SECOND;
+	};
+
+	void UpdateRequests(const std::vector<std::pair<uint64_t, Hash>>& blocksNeeded);
+	void RetireRequests(const std::vector<std::pair<uint64_t, Hash>>& blocksNeeded);
+	void UpdateThroughput();
+	bool RequestBlocks(const std::vector<std::pair<uint64_t, Hash>>& blocksNeeded);
+
+	size_t GetInFlightLimit(const PeerStats& stats) const;
+	std::chrono::system_clock::duration GetRequestTimeout(const PeerStats& stats) const;
 	bool IsSlowPeer(PeerConstPtr pPeer) const { return m_slowPeers.find(pPeer->GetIPAddress()) != m_slowPeers.end(); }
 
 	std::weak_ptr<ConnectionManager> m_pConnectionManager;
 	IBlockChain::Ptr m_pBlockChain;
 	std::shared_ptr<Pipeline> m_pPipeline;
+	const P2PConfig& m_config;
 
-	std::chrono::time_point<std::chrono::system_clock> m_timeout;
-	uint64_t m_lastHeight;
-	uint64_t m_highestRequested;
+	std::chrono::time_point<std::chrono::system_clock> m_nextUpdate;
+	std::chrono::time_point<std::chrono::system_clock> m_lastSample;
 
-	struct RequestedBlock
-	{
-		PeerPtr PEER;
-		uint64_t BLOCK_HEIGHT;
-		std::chrono::time_point<std::chrono::system_clock> TIMEOUT;
-		// TODO: Add retry?
-	};
 	std::unordered_map<uint64_t, RequestedBlock> m_requestedBlocks;
+	std::unordered_map<IPAddress, PeerStats> m_peerStats;
+	std::unordered_map<uint64_t, IPAddress> m_stalledBy;
 	std::unordered_set<IPAddress> m_slowPeers;
-};
\ No newline at end of file
+};
@@ -3,6 +3,15 @@
 #include "../Messages/GetHeadersMessage.h"
 
 #include <Common/Logger.h>
+#include <P2P/Common.h>
+
+// Ranges that time out this many times in a row cause a fall back to single-peer mode.
+static const size_t MAX_RANGE_ATTEMPTS = 3;
+
+// Stops requesting new ranges while this many received batches are still waiting to be validated.
+static const size_t MAX_PENDING_BATCHES = 8;
+
+static const std::chrono::seconds RANGE_TIMEOUT(12);
 
 bool HeaderSyncer::SyncHeaders(const SyncStatus& syncStatus, const bool startup)
 {
@@ -17,7 +26,13 @@ bool HeaderSyncer::SyncHeaders(const SyncStatus& syncStatus, const bool startup)
 
 	if (networkHeight >= (chainHeight + 5) || (startup && networkHeight > chainHeight))
 	{
-		if (IsHeaderSyncDue(syncStatus))
+		UpdateMode(syncStatus);
+
+		if (m_parallel)
+		{
+			SyncHeadersParallel(syncStatus);
+		}
+		else if (IsHeaderSyncDue(syncStatus))
 		{
 			RequestHeaders(syncStatus);
 		}
@@ -27,10 +42,147 @@ bool HeaderSyncer::SyncHeaders(const SyncStatus& syncStatus, const bool startup)
 
 	m_pPeer = nullptr;
 	m_retried = false;
+	m_parallel = false;
+	m_parallelDisabled = false;
+	m_rangeRequest.reset();
 
 	return false;
 }
 
+void HeaderSyncer::UpdateMode(const SyncStatus& syncStatus)
+{
+	auto pHeaderPipe = m_pPipeline->GetHeaderPipe();
+	if (pHeaderPipe->TakeDisagreement())
+	{
+		if (m_parallel)
+		{
+			FallBackToSinglePeer("Header batches disagreed");
+		}
+
+		m_parallelDisabled = true;
+	}
+
+	if (m_parallel || m_parallelDisabled || !m_config.IsParallelHeaderSyncEnabled())
+	{
+		return;
+	}
+
+	// The initial locator exchange must have produced a batch, and there must be enough left to be worth splitting.
+	BlockHeaderPtr pFurthest = pHeaderPipe->GetFurthestHeaderReceived();
+	if (pFurthest != nullptr
+		&& pFurthest->GetHeight() >= syncStatus.GetHeaderHeight()
+		&& syncStatus.GetNetworkHeight() > (pFurthest->GetHeight() + (2 * P2P::MAX_BLOCK_HEADERS)))
+	{
+		LOG_INFO_F("Switching to parallel header sync at height {}", pFurthest->GetHeight());
+		m_parallel = true;
+		m_rangeRequest.reset();
+	}
+}
+
+void HeaderSyncer::SyncHeadersParallel(const SyncStatus& syncStatus)
+{
+	auto pHeaderPipe = m_pPipeline->GetHeaderPipe();
+	BlockHeaderPtr pFurthest = pHeaderPipe->GetFurthestHeaderReceived();
+	if (pFurthest == nullptr)
+	{
+		FallBackToSinglePeer("No headers received");
+		return;
+	}
+
+	if (m_rangeRequest.has_value())
+	{
+		if (pFurthest->GetHeight() > m_rangeRequest->ANCHOR_HEIGHT)
+		{
+			LOG_TRACE_F("Header range after {} received from {}", m_rangeRequest->ANCHOR_HEIGHT, m_rangeRequest->PEER);
+			m_rangeRequest.reset();
+		}
+		else if (m_rangeRequest->TIMEOUT < std::chrono::system_clock::now())
+		{
+			const size_t attempts = m_rangeRequest->ATTEMPTS;
+			if (attempts >= MAX_RANGE_ATTEMPTS)
+			{
+				FallBackToSinglePeer("Header range requests keep timing out");
+				return;
+			}
+
+			LOG_DEBUG_F("Header range after {} from {} timed out. Requesting from another peer.", m_rangeRequest->ANCHOR_HEIGHT, m_rangeRequest->PEER);
+			m_rangeRequest.reset();
+			RequestRange(syncStatus, pFurthest, attempts);
+			return;
+		}
+		else
+		{
+			return;
+		}
+	}
+
+	// Don't download too far ahead of validation.
+	if (pHeaderPipe->GetNumPendingBatches() >= MAX_PENDING_BATCHES)
+	{
+		return;
+	}
+
+	// Everything has been received, and is just waiting to be validated.
+	if (pFurthest->GetHeight() >= syncStatus.GetNetworkHeight())
+	{
+		return;
+	}
+
+	RequestRange(syncStatus, pFurthest, 0);
+}
+
+//
+// Requests the headers after pAnchor from the next peer in rotation.
+// The usual locators follow the anchor, so a peer that doesn't have it still responds from the best common header.
+//
+bool HeaderSyncer::RequestRange(const SyncStatus& syncStatus, const BlockHeaderPtr& pAnchor, const size_t attempts)
+{
+	auto pConnectionManager = m_pConnectionManager.lock();
+	std::vector<PeerPtr> mostWorkPeers = pConnectionManager->GetMostWorkPeers();
+	if (mostWorkPeers.empty())
+	{
+		return false;
+	}
+
+	PeerPtr pPeer = mostWorkPeers[m_nextPeer++ % mostWorkPeers.size()];
+
+	std::vector<Hash> locators{ pAnchor->GetHash() };
+	for (Hash& locator : BlockLocator(m_pBlockChain).GetLocators(syncStatus))
+	{
+		if (locators.size() >= P2P::MAX_LOCATORS)
+		{
+			break;
+		}
+
+		if (locator != pAnchor->GetHash())
+		{
+			locators.emplace_back(std::move(locator));
+		}
+	}
+
+	const GetHeadersMessage getHeadersMessage(std::move(locators));
+	if (!pConnectionManager->SendMessageToPeer(getHeadersMessage, pPeer))
+	{
+		return false;
+	}
+
+	m_pPipeline->GetHeaderPipe()->OnHeadersRequested(pPeer);
+	LOG_TRACE_F("Requested headers after {} from {}", pAnchor->GetHeight(), pPeer);
+	m_rangeRequest = RangeRequest{ pPeer, pAnchor->GetHeight(), attempts + 1, std::chrono::system_clock::now() + RANGE_TIMEOUT };
+	return true;
+}
+
+void HeaderSyncer::FallBackToSinglePeer(const std::string& reason)
+{
+	LOG_INFO_F("{}. Falling back to single-peer header sync.", reason);
+
+	m_parallel = false;
+	m_parallelDisabled = true;
+	m_rangeRequest.reset();
+	m_pPeer = nullptr;
+	m_retried = false;
+}
+
 bool HeaderSyncer::IsHeaderSyncDue(const SyncStatus& syncStatus)
 {
 	if (m_pPeer == nullptr)
@@ -103,6 +255,7 @@ bool HeaderSyncer::RequestHeaders(const SyncStatus& syncStatus)
 	if (m_pPeer != nullptr)
 	{
 		LOG_TRACE("Headers requested.");
+		m_pPipeline->GetHeaderPipe()->OnHeadersRequested(m_pPeer);
 		m_timeout = std::chrono::system_clock::now() + std::chrono::seconds(12);
 		m_lastHeight = syncStatus.GetHeaderHeight();
 	}
@@ -1,23 +1,41 @@
 #pragma once
 
 #include "../ConnectionManager.h"
+#include "../Pipeline/Pipeline.h"
 
 #include <BlockChain/BlockChain.h>
+#include <Config/P2PConfig.h>
 #include <chrono>
+#include <optional>
 
 // Forward Declarations
 class SyncStatus;
 
+//
+// Downloads headers in batches of P2P::MAX_BLOCK_HEADERS.
+//
+// Sync always starts with a locator exchange with a single peer. Once the first batch arrives, and if enabled,
+// it switches to parallel mode: as soon as a range has been received (before the HeaderPipe validates it),
+// the range after it is requested from the next peer in rotation, so downloading from several peers overlaps with validation.
+// If batches disagree (one is invalid or never connects), it falls back to single-peer mode until sync completes.
+//
 class HeaderSyncer
 {
 public:
-	HeaderSyncer(const std::weak_ptr<ConnectionManager>& pConnectionManager, const IBlockChain::Ptr& pBlockChain)
-		: m_pConnectionManager(pConnectionManager), m_pBlockChain(pBlockChain)
+	HeaderSyncer(
+		const std::weak_ptr<ConnectionManager>& pConnectionManager,
+		const IBlockChain::Ptr& pBlockChain,
+		const std::shared_ptr<Pipeline>& pPipeline,
+		const P2PConfig& config
+	) : m_pConnectionManager(pConnectionManager), m_pBlockChain(pBlockChain), m_pPipeline(pPipeline), m_config(config)
 	{
 		m_timeout = std::chrono::system_clock::now();
 		m_lastHeight = 0;
 		m_pPeer = nullptr;
 		m_retried = false;
+		m_parallel = false;
+		m_parallelDisabled = false;
+		m_nextPeer = 0;
 	}
 
 	bool SyncHeaders(const SyncStatus& syncStatus, const bool startup);
@@ -26,11 +44,33 @@ private:
 	bool IsHeaderSyncDue(const SyncStatus& syncStatus);
 	bool RequestHeaders(const SyncStatus& syncStatus);
 
+	void UpdateMode(const SyncStatus& syncStatus);
+	void SyncHeadersParallel(const SyncStatus& syncStatus);
+	bool RequestRange(const SyncStatus& syncStatus, const BlockHeaderPtr& pAnchor, const size_t attempts);
+	void FallBackToSinglePeer(const std::string& reason);
+
 	std::weak_ptr<ConnectionManager> m_pConnectionManager;
 	IBlockChain::Ptr m_pBlockChain;
+	std::shared_ptr<Pipeline> m_pPipeline;
+	const P2PConfig& m_config;
 
+	// Single-peer mode
 	std::chrono::time_point<std::chrono::system_clock> m_timeout;
 	uint64_t m_lastHeight;
 	PeerPtr m_pPeer;
 	bool m_retried;
-};
\ No newline at end of file
+
+	// Parallel mode
+	struct RangeRequest
+	{
+		PeerPtr PEER;
+		uint64_t ANCHOR_HEIGHT;
+		size_t ATTEMPTS;
+		std::chrono::time_point<std::chrono::system_clock> TIMEOUT;
+	};
+
+	bool m_parallel;
+	bool m_parallelDisabled;
+	size_t m_nextPeer;
+	std::optional<RangeRequest> m_rangeRequest;
+};
@@ -0,0 +1,77 @@
+#include "ReplicaFollower.h"
+
+#include <Common/Util/FileUtil.h>
+#include <Common/Util/ThreadUtil.h>
+#include <Common/ThreadManager.h>
+#include <Common/Logger.h>
+
+ReplicaFollower::ReplicaFollower(const Config& config, const IBlockChain::Ptr& pBlockChain, SyncStatusPtr pSyncStatus)
+	: m_config(config),
+	m_pBlockChain(pBlockChain),
+	m_pSyncStatus(pSyncStatus),
+	m_terminate(false)
+{
+
+}
+
+ReplicaFollower::~ReplicaFollower()
+{
+	m_terminate = true;
+	ThreadUtil::Join(m_followThread);
+}
+
+std::shared_ptr<ReplicaFollower> ReplicaFollower::Create(
+	const Config& config,
+	const IBlockChain::Ptr& pBlockChain,
+	SyncStatusPtr pSyncStatus)
+{
+	auto pFollower = std::shared_ptr<ReplicaFollower>(new ReplicaFollower(config, pBlockChain, pSyncStatus));
+	pFollower->m_followThread = std::thread(Thread_Follow, std::ref(*pFollower));
+	return pFollower;
+}
+
+void ReplicaFollower::Thread_Follow(ReplicaFollower& follower)
+{
+	ThreadManagerAPI::SetCurrentThreadName("REPLICA_FOLLOWER");
+	LOG_DEBUG("BEGIN");
+
+	const fs::path& notificationPath = follower.m_config.GetNodeConfig().GetCommitNotificationPath();
+	if (!FileUtil::Exists(notificationPath))
+	{
+		LOG_WARNING_F("{} not found. Replicas only follow primaries with NOTIFY_REPLICAS enabled.", notificationPath);
+	}
+
+	follower.m_pBlockChain->UpdateSyncStatus(*follower.m_pSyncStatus);
+	follower.m_pSyncStatus->UpdateStatus(ESyncStatus::NOT_SYNCING);
+
+	const std::chrono::milliseconds pollInterval(follower.m_config.GetNodeConfig().GetReplicaPollMs());
+	while (!follower.m_terminate)
+	{
+		// The first notification seen is always caught up with, in case the primary committed while this node was loading.
+		follower.CatchUp();
+		ThreadUtil::SleepFor(pollInterval, follower.m_terminate);
+	}
+
+	LOG_DEBUG("END");
+}
+
+void ReplicaFollower::CatchUp()
+{
+	std::vector<uint8_t> notification;
+	if (!FileUtil::ReadFile(m_config.GetNodeConfig().GetCommitNotificationPath(), notification) || notification == m_lastNotification)
+	{
+		return;
+	}
+
+	try
+	{
+		m_pBlockChain->CatchUpWithPrimary();
+		m_pBlockChain->UpdateSyncStatus(*m_pSyncStatus);
+		m_lastNotification = std::move(notification);
+	}
+	catch (std::exception& e)
+	{
+		// Caught up with again on the next poll.
+		LOG_WARNING_F("Failed to catch up with primary: {}", e.what());
+	}
+}
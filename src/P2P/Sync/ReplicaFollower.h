@@ -0,0 +1,40 @@
+#pragma once
+
+#include <P2P/SyncStatus.h>
+#include <Config/Config.h>
+#include <BlockChain/BlockChain.h>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+//
+// Runs instead of the Syncer on replicas (see NodeConfig::IsReplica), which never sync from peers.
+// Polls the primary's commit notification file, and catches the chain up with the primary whenever it changes.
+//
+class ReplicaFollower
+{
+public:
+	static std::shared_ptr<ReplicaFollower> Create(
+		const Config& config,
+		const IBlockChain::Ptr& pBlockChain,
+		SyncStatusPtr pSyncStatus
+	);
+	~ReplicaFollower();
+
+private:
+	ReplicaFollower(const Config& config, const IBlockChain::Ptr& pBlockChain, SyncStatusPtr pSyncStatus);
+
+	static void Thread_Follow(ReplicaFollower& follower);
+	void CatchUp();
+
+	const Config& m_config;
+	IBlockChain::Ptr m_pBlockChain;
+	SyncStatusPtr m_pSyncStatus;
+
+	// The contents of the last notification caught up with.
+	std::vector<uint8_t> m_lastNotification;
+
+	std::atomic_bool m_terminate;
+	std::thread m_followThread;
+};
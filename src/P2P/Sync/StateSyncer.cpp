@@ -9,8 +9,11 @@ bool StateSyncer::SyncState(SyncStatus& syncStatus)
 {
 	if (IsStateSyncDue(syncStatus))
 	{
-		syncStatus.UpdateStatus(ESyncStatus::SYNCING_TXHASHSET);
-		RequestState(syncStatus);
+		if (!ImportSnapshot(syncStatus))
+		{
+			syncStatus.UpdateStatus(ESyncStatus::SYNCING_TXHASHSET);
+			RequestState(syncStatus);
+		}
 
 		return true;
 	}
@@ -87,6 +90,38 @@ bool StateSyncer::IsStateSyncDue(const SyncStatus& syncStatus) const
 	return false;
 }
 
+bool StateSyncer::ImportSnapshot(SyncStatus& syncStatus)
+{
+	const std::optional<fs::path>& importPath = m_config.GetNodeConfig().GetSnapshotImportPath();
+	if (!importPath.has_value() || m_snapshotImported)
+	{
+		return false;
+	}
+
+	syncStatus.UpdateProcessingStatus(0);
+	syncStatus.UpdateStatus(ESyncStatus::PROCESSING_TXHASHSET);
+
+	const EBlockChainStatus status = m_pBlockChain->ImportTxHashSetSnapshot(importPath.value(), syncStatus);
+	if (status == EBlockChainStatus::ORPHANED)
+	{
+		// Header sync hasn't reached the snapshot's block yet, so it's tried again on the next pass.
+		LOG_DEBUG_F("Waiting for headers to reach snapshot {}", importPath.value());
+		syncStatus.UpdateStatus(ESyncStatus::SYNCING_HEADERS);
+		return true;
+	}
+
+	m_snapshotImported = true;
+	if (status == EBlockChainStatus::SUCCESS)
+	{
+		LOG_INFO_F("Imported TxHashSet snapshot {}", importPath.value());
+		syncStatus.UpdateStatus(ESyncStatus::SYNCING_BLOCKS);
+		return true;
+	}
+
+	LOG_ERROR_F("Failed to import TxHashSet snapshot {}. Requesting TxHashSet from peers instead.", importPath.value());
+	return false;
+}
+
 bool StateSyncer::RequestState(const SyncStatus& syncStatus)
 {
 	if (m_pPeer != nullptr)
@@ -99,7 +134,7 @@ bool StateSyncer::RequestState(const SyncStatus& syncStatus)
 	if (!ShutdownManagerAPI::WasShutdownRequested())
 	{
 		const uint64_t headerHeight = syncStatus.GetHeaderHeight();
-		const uint64_t requestedHeight = headerHeight - Consensus::STATE_SYNC_THRESHOLD;
+		const uint64_t requestedHeight = Consensus::GetTxHashSetArchiveHeight(headerHeight);
 		Hash hash = m_pBlockChain->GetBlockHeaderByHeight(requestedHeight, EChainType::CANDIDATE)->GetHash();
 
 		const TxHashSetRequestMessage txHashSetRequestMessage(std::move(hash), requestedHeight);
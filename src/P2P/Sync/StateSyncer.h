@@ -3,6 +3,7 @@
 #include "../ConnectionManager.h"
 
 #include <BlockChain/BlockChain.h>
+#include <Config/Config.h>
 #include <chrono>
 
 // Forward Declarations
@@ -11,24 +12,39 @@ class SyncStatus;
 class StateSyncer
 {
 public:
-	StateSyncer(const std::weak_ptr<ConnectionManager>& pConnectionManager, const IBlockChain::Ptr& pBlockChain)
-		: m_pConnectionManager(pConnectionManager), m_pBlockChain(pBlockChain)
+	StateSyncer(const Config& config, const std::weak_ptr<ConnectionManager>& pConnectionManager, const IBlockChain::Ptr& pBlockChain)
+		: m_config(config), m_pConnectionManager(pConnectionManager), m_pBlockChain(pBlockChain)
 	{
 		m_timeRequested = std::chrono::system_clock::now();
 		m_requestedHeight = 0;
 		m_pPeer = nullptr;
+		m_snapshotImported = false;
 	}
 
 	bool SyncState(SyncStatus& syncStatus);
 
+	//
+	// The height of the block whose TxHashSet was last requested, or 0 if none has been.
+	//
+	uint64_t GetRequestedHeight() const noexcept { return m_requestedHeight; }
+
 private:
 	bool IsStateSyncDue(const SyncStatus& syncStatus) const;
 	bool RequestState(const SyncStatus& syncStatus);
 
+	//
+	// Imports the configured snapshot, if there is one and it hasn't been tried yet. Returns false if the TxHashSet should be requested from peers.
+	//
+	bool ImportSnapshot(SyncStatus& syncStatus);
+
+	const Config& m_config;
 	std::chrono::time_point<std::chrono::system_clock> m_timeRequested;
 	uint64_t m_requestedHeight;
 	PeerPtr m_pPeer;
 
+	// Set once the configured snapshot was imported or failed, so it's only tried once.
+	bool m_snapshotImported;
+
 	std::weak_ptr<ConnectionManager> m_pConnectionManager;
 	IBlockChain::Ptr m_pBlockChain;
 };
\ No newline at end of file
@@ -0,0 +1,158 @@
+#include "SyncTelemetryTracker.h"
+
+#include <Common/Logger.h>
+
+static const std::chrono::seconds SAMPLE_INTERVAL(1);
+static const std::chrono::seconds RATE_WINDOW(60);
+
+SyncTelemetryTracker::SyncTelemetryTracker(const std::chrono::seconds& logInterval)
+	: m_logInterval(logInterval),
+	m_status(ESyncStatus::SYNCING_HEADERS),
+	m_lastSample(Clock::now()),
+	m_lastLog(Clock::now())
+{
+
+}
+
+void SyncTelemetryTracker::Update(SyncStatus& syncStatus)
+{
+	const Clock::time_point now = Clock::now();
+	if (now - m_lastSample < SAMPLE_INTERVAL)
+	{
+		return;
+	}
+
+	// The time since the last sample is attributed to the status seen then.
+	m_timeInStatus[m_status] += now - m_lastSample;
+	m_lastSample = now;
+
+	const ESyncStatus status = syncStatus.GetStatus();
+	if (status != m_status)
+	{
+		m_status = status;
+		m_samples.clear();
+	}
+
+	m_samples.push_back(TakeSample(syncStatus, now));
+	while (m_samples.size() > 2 && now - m_samples.front().time > RATE_WINDOW)
+	{
+		m_samples.pop_front();
+	}
+
+	SyncTelemetry::CPtr pTelemetry = Measure(syncStatus);
+	syncStatus.UpdateTelemetry(pTelemetry);
+
+	if (m_logInterval.count() > 0 && syncStatus.IsSyncing() && now - m_lastLog >= m_logInterval)
+	{
+		m_lastLog = now;
+		Log(syncStatus, *pTelemetry);
+	}
+}
+
+SyncTelemetryTracker::Sample SyncTelemetryTracker::TakeSample(const SyncStatus& syncStatus, const Clock::time_point& now)
+{
+	return Sample{
+		now,
+		syncStatus.GetHeaderHeight(),
+		syncStatus.GetBlockHeight(),
+		syncStatus.GetDownloaded(),
+		syncStatus.GetRangeProofsVerified(),
+		syncStatus.GetKernelsVerified(),
+		syncStatus.GetProcessingStatus()
+	};
+}
+
+SyncTelemetry::CPtr SyncTelemetryTracker::Measure(const SyncStatus& syncStatus) const
+{
+	auto pTelemetry = std::make_shared<SyncTelemetry>();
+	for (const auto& iter : m_timeInStatus)
+	{
+		pTelemetry->timeInStatus[iter.first] = std::chrono::duration_cast<std::chrono::milliseconds>(iter.second);
+	}
+
+	if (m_samples.size() < 2)
+	{
+		return pTelemetry;
+	}
+
+	const Sample& first = m_samples.front();
+	const Sample& last = m_samples.back();
+	const double seconds = std::chrono::duration<double>(last.time - first.time).count();
+
+	// Counters can move backwards, eg. when a TxHashSet download restarts, which is treated as no progress.
+	auto getRate = [seconds](const uint64_t from, const uint64_t to) {
+		return to > from ? (to - from) / seconds : 0.0;
+	};
+
+	pTelemetry->headersPerSec = getRate(first.headerHeight, last.headerHeight);
+	pTelemetry->blocksPerSec = getRate(first.blockHeight, last.blockHeight);
+	pTelemetry->bytesDownloadedPerSec = getRate(first.downloaded, last.downloaded);
+	pTelemetry->rangeProofsPerSec = getRate(first.rangeProofs, last.rangeProofs);
+	pTelemetry->kernelsPerSec = getRate(first.kernels, last.kernels);
+
+	auto getETA = [](const uint64_t current, const uint64_t target, const double rate) -> std::optional<uint64_t> {
+		if (rate <= 0.0 || target <= current)
+		{
+			return std::nullopt;
+		}
+
+		return std::make_optional((uint64_t)((target - current) / rate));
+	};
+
+	switch (m_status)
+	{
+		case ESyncStatus::SYNCING_HEADERS:
+			pTelemetry->etaSecs = getETA(last.headerHeight, syncStatus.GetNetworkHeight(), pTelemetry->headersPerSec);
+			break;
+		case ESyncStatus::SYNCING_TXHASHSET:
+			pTelemetry->etaSecs = getETA(last.downloaded, syncStatus.GetDownloadSize(), pTelemetry->bytesDownloadedPerSec);
+			break;
+		case ESyncStatus::PROCESSING_TXHASHSET:
+			pTelemetry->etaSecs = getETA(last.processingStatus, 100, getRate(first.processingStatus, last.processingStatus));
+			break;
+		case ESyncStatus::SYNCING_BLOCKS:
+			pTelemetry->etaSecs = getETA(last.blockHeight, last.headerHeight, pTelemetry->blocksPerSec);
+			break;
+		default:
+			break;
+	}
+
+	return pTelemetry;
+}
+
+void SyncTelemetryTracker::Log(const SyncStatus& syncStatus, const SyncTelemetry& telemetry)
+{
+	const std::string eta = telemetry.etaSecs.has_value() ? std::to_string(telemetry.etaSecs.value()) + "s" : "unknown";
+
+	switch (syncStatus.GetStatus())
+	{
+		case ESyncStatus::SYNCING_HEADERS:
+			LOG_INFO_F(
+				"Sync: headers {}/{} at {:.1f}/s, ETA {}",
+				syncStatus.GetHeaderHeight(), syncStatus.GetNetworkHeight(), telemetry.headersPerSec, eta
+			);
+			break;
+		case ESyncStatus::SYNCING_TXHASHSET:
+			LOG_INFO_F(
+				"Sync: TxHashSet {}/{} bytes at {:.1f} KB/s, ETA {}",
+				syncStatus.GetDownloaded(), syncStatus.GetDownloadSize(), telemetry.bytesDownloadedPerSec / 1000, eta
+			);
+			break;
+		case ESyncStatus::PROCESSING_TXHASHSET:
+			LOG_INFO_F(
+				"Sync: validating TxHashSet {}% at {:.1f} rangeproofs/s and {:.1f} kernels/s, ETA {}",
+				syncStatus.GetProcessingStatus(), telemetry.rangeProofsPerSec, telemetry.kernelsPerSec, eta
+			);
+			break;
+		case ESyncStatus::SYNCING_BLOCKS:
+			LOG_INFO_F(
+				"Sync: blocks {}/{} at {:.1f}/s ({:.1f} rangeproofs/s, {:.1f} kernels/s), ETA {}",
+				syncStatus.GetBlockHeight(), syncStatus.GetHeaderHeight(), telemetry.blocksPerSec,
+				telemetry.rangeProofsPerSec, telemetry.kernelsPerSec, eta
+			);
+			break;
+		default:
+			LOG_INFO_F("Sync: waiting, {} connections", syncStatus.GetNumActiveConnections());
+			break;
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <P2P/SyncStatus.h>
+#include <chrono>
+#include <deque>
+#include <map>
+
+//
+// Measures the throughput of each sync phase from periodic samples of the SyncStatus, publishing a SyncTelemetry
+// back to it once a second, and logging a summary every logInterval while syncing.
+// Rates only use samples from the current status, so eg. the block height jumping after a TxHashSet is applied isn't counted as block throughput.
+//
+class SyncTelemetryTracker
+{
+public:
+	explicit SyncTelemetryTracker(const std::chrono::seconds& logInterval);
+
+	//
+	// Called on every pass of the sync loop. Does nothing until a second has passed since the last sample.
+	//
+	void Update(SyncStatus& syncStatus);
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Sample
+	{
+		Clock::time_point time;
+		uint64_t headerHeight;
+		uint64_t blockHeight;
+		uint64_t downloaded;
+		uint64_t rangeProofs;
+		uint64_t kernels;
+		uint8_t processingStatus;
+	};
+
+	static Sample TakeSample(const SyncStatus& syncStatus, const Clock::time_point& now);
+	SyncTelemetry::CPtr Measure(const SyncStatus& syncStatus) const;
+	static void Log(const SyncStatus& syncStatus, const SyncTelemetry& telemetry);
+
+	std::chrono::seconds m_logInterval;
+	ESyncStatus m_status;
+	Clock::time_point m_lastSample;
+	Clock::time_point m_lastLog;
+	std::deque<Sample> m_samples;
+	std::map<ESyncStatus, Clock::duration> m_timeInStatus;
+};
@@ -2,110 +2,119 @@
 #include "HeaderSyncer.h"
 #include "StateSyncer.h"
 #include "BlockSyncer.h"
+#include "SyncTelemetryTracker.h"
 
 #include <BlockChain/BlockChain.h>
 #include <P2P/SyncStatus.h>
-#include <Common/ThreadManager.h>
 #include <Common/Logger.h>
-#include <Common/Util/ThreadUtil.h>
 
 static const int MINIMUM_NUM_PEERS = 4;
 
 Syncer::Syncer(
+	const Config& config,
+	const TaskScheduler::Ptr& pScheduler,
 	std::weak_ptr<ConnectionManager> pConnectionManager,
 	const IBlockChain::Ptr& pBlockChain,
 	std::shared_ptr<Pipeline> pPipeline,
 	SyncStatusPtr pSyncStatus)
-	: m_pConnectionManager(pConnectionManager),
+	: m_config(config),
+	m_pScheduler(pScheduler),
+	m_pConnectionManager(pConnectionManager),
 	m_pBlockChain(pBlockChain),
 	m_pPipeline(pPipeline),
 	m_pSyncStatus(pSyncStatus),
-	m_terminate(false)
+	m_pHeaderSyncer(std::make_unique<HeaderSyncer>(pConnectionManager, pBlockChain, pPipeline, config.GetP2PConfig())),
+	m_pStateSyncer(std::make_unique<StateSyncer>(config, pConnectionManager, pBlockChain)),
+	m_pBlockSyncer(std::make_unique<BlockSyncer>(pConnectionManager, pBlockChain, pPipeline, config.GetP2PConfig())),
+	m_pTelemetryTracker(std::make_unique<SyncTelemetryTracker>(std::chrono::seconds(config.GetNodeConfig().GetSyncStatsLogSecs()))),
+	m_startup(true),
+	m_taskId(0)
 {
 
 }
 
 Syncer::~Syncer()
 {
-	m_terminate = true;
-	ThreadUtil::Join(m_syncThread);
+	m_pScheduler->RemoveTask(m_taskId);
 }
 
 std::shared_ptr<Syncer> Syncer::Create(
+	const Config& config,
+	const TaskScheduler::Ptr& pScheduler,
 	std::weak_ptr<ConnectionManager> pConnectionManager,
 	const IBlockChain::Ptr& pBlockChain,
 	std::shared_ptr<Pipeline> pPipeline,
 	SyncStatusPtr pSyncStatus)
 {
 	std::shared_ptr<Syncer> pSyncer = std::shared_ptr<Syncer>(new Syncer(
+		config,
+		pScheduler,
 		pConnectionManager,
 		pBlockChain,
 		pPipeline,
 		pSyncStatus
 	));
-	pSyncer->m_syncThread = std::thread(Thread_Sync, std::ref(*pSyncer));
+
+	Syncer* pSyncerRaw = pSyncer.get();
+	pSyncer->m_taskId = pScheduler->Interval("SYNC", std::chrono::milliseconds(10), [pSyncerRaw]() { pSyncerRaw->Sync(); });
 
 	return pSyncer;
 }
 
-void Syncer::Thread_Sync(Syncer& syncer)
+//
+// Advances whichever stage of the sync is in progress. Run every 10ms by the context's scheduler.
+//
+void Syncer::Sync()
 {
-	ThreadManagerAPI::SetCurrentThreadName("SYNC");
-	LOG_DEBUG("BEGIN");
-
-	HeaderSyncer headerSyncer(syncer.m_pConnectionManager, syncer.m_pBlockChain);
-	StateSyncer stateSyncer(syncer.m_pConnectionManager, syncer.m_pBlockChain);
-	BlockSyncer blockSyncer(syncer.m_pConnectionManager, syncer.m_pBlockChain, syncer.m_pPipeline);
-	bool startup = true;
-
-	while (!syncer.m_terminate)
+	try
 	{
-		try
-		{
-			ThreadUtil::SleepFor(std::chrono::milliseconds(10), syncer.m_terminate);
-			syncer.UpdateSyncStatus();
+		UpdateSyncStatus();
+		m_pTelemetryTracker->Update(*m_pSyncStatus);
 
-			if (syncer.m_pSyncStatus->GetNumActiveConnections() >= MINIMUM_NUM_PEERS)
+		if (m_pSyncStatus->GetNumActiveConnections() >= MINIMUM_NUM_PEERS)
+		{
+			// Sync Headers
+			if (m_pHeaderSyncer->SyncHeaders(*m_pSyncStatus, m_startup))
 			{
-				// Sync Headers
-				if (headerSyncer.SyncHeaders(*syncer.m_pSyncStatus, startup))
+				if (m_pSyncStatus->GetStatus() != ESyncStatus::SYNCING_TXHASHSET && m_pSyncStatus->GetStatus() != ESyncStatus::PROCESSING_TXHASHSET)
 				{
-					if (syncer.m_pSyncStatus->GetStatus() != ESyncStatus::SYNCING_TXHASHSET && syncer.m_pSyncStatus->GetStatus() != ESyncStatus::PROCESSING_TXHASHSET)
-					{
-						syncer.m_pSyncStatus->UpdateStatus(ESyncStatus::SYNCING_HEADERS);
-					}
-					continue;
-				}
-
-				// Sync State (TxHashSet)
-				if (stateSyncer.SyncState(*syncer.m_pSyncStatus))
-				{
-					continue;
+					m_pSyncStatus->UpdateStatus(ESyncStatus::SYNCING_HEADERS);
 				}
+				return;
+			}
 
-				// Sync Blocks
-				if (blockSyncer.SyncBlocks(*syncer.m_pSyncStatus, startup))
+			// Sync State (TxHashSet)
+			if (m_pStateSyncer->SyncState(*m_pSyncStatus))
+			{
+				// The network would otherwise be idle while the downloaded TxHashSet is validated.
+				if (m_pSyncStatus->GetStatus() == ESyncStatus::PROCESSING_TXHASHSET && m_pStateSyncer->GetRequestedHeight() > 0)
 				{
-					syncer.m_pSyncStatus->UpdateStatus(ESyncStatus::SYNCING_BLOCKS);
-					continue;
+					m_pBlockSyncer->PrefetchBlocks(m_pStateSyncer->GetRequestedHeight() + 1);
 				}
 
-				startup = false;
-
-				syncer.m_pSyncStatus->UpdateStatus(ESyncStatus::NOT_SYNCING);
+				return;
 			}
-			else if (syncer.m_pSyncStatus->GetStatus() != ESyncStatus::PROCESSING_TXHASHSET)
+
+			// Sync Blocks
+			if (m_pBlockSyncer->SyncBlocks(*m_pSyncStatus, m_startup))
 			{
-				syncer.m_pSyncStatus->UpdateStatus(ESyncStatus::WAITING_FOR_PEERS);
+				m_pSyncStatus->UpdateStatus(ESyncStatus::SYNCING_BLOCKS);
+				return;
 			}
+
+			m_startup = false;
+
+			m_pSyncStatus->UpdateStatus(ESyncStatus::NOT_SYNCING);
 		}
-		catch (std::exception& e)
+		else if (m_pSyncStatus->GetStatus() != ESyncStatus::PROCESSING_TXHASHSET)
 		{
-			LOG_ERROR_F("Exception thrown: {}", e);
+			m_pSyncStatus->UpdateStatus(ESyncStatus::WAITING_FOR_PEERS);
 		}
 	}
-
-	LOG_DEBUG("END");
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e);
+	}
 }
 
 void Syncer::UpdateSyncStatus()
@@ -4,17 +4,24 @@
 #include "../Pipeline/Pipeline.h"
 
 #include <P2P/SyncStatus.h>
+#include <Config/Config.h>
 #include <BlockChain/BlockChain.h>
-#include <atomic>
-#include <thread>
+#include <Common/TaskScheduler.h>
+#include <memory>
 
 // Forward Declarations
 class SyncStatus;
+class HeaderSyncer;
+class StateSyncer;
+class BlockSyncer;
+class SyncTelemetryTracker;
 
 class Syncer
 {
 public:
 	static std::shared_ptr<Syncer> Create(
+		const Config& config,
+		const TaskScheduler::Ptr& pScheduler,
 		std::weak_ptr<ConnectionManager> pConnectionManager,
 		const IBlockChain::Ptr& pBlockChain,
 		std::shared_ptr<Pipeline> pPipeline,
@@ -24,20 +31,29 @@ public:
 
 private:
 	Syncer(
+		const Config& config,
+		const TaskScheduler::Ptr& pScheduler,
 		std::weak_ptr<ConnectionManager> pConnectionManager,
 		const IBlockChain::Ptr& pBlockChain,
 		std::shared_ptr<Pipeline> pPipeline,
 		SyncStatusPtr pSyncStatus
 	);
 
-	static void Thread_Sync(Syncer& syncer);
+	void Sync();
 	void UpdateSyncStatus();
 
+	const Config& m_config;
+	TaskScheduler::Ptr m_pScheduler;
 	std::weak_ptr<ConnectionManager> m_pConnectionManager;
 	IBlockChain::Ptr m_pBlockChain;
 	std::shared_ptr<Pipeline> m_pPipeline;
 	SyncStatusPtr m_pSyncStatus;
 
-	std::atomic<bool> m_terminate;
-	std::thread m_syncThread;
+	std::unique_ptr<HeaderSyncer> m_pHeaderSyncer;
+	std::unique_ptr<StateSyncer> m_pStateSyncer;
+	std::unique_ptr<BlockSyncer> m_pBlockSyncer;
+	std::unique_ptr<SyncTelemetryTracker> m_pTelemetryTracker;
+	bool m_startup;
+
+	TaskScheduler::TaskId m_taskId;
 };
\ No newline at end of file
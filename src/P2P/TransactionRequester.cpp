@@ -0,0 +1,140 @@
+#include "TransactionRequester.h"
+#include "Connection.h"
+#include "Messages/GetTransactionMessage.h"
+#include "Messages/GetTransactionsMessage.h"
+
+#include <Common/Logger.h>
+
+void TransactionRequester::OnAnnouncement(Connection& connection, const Hash& kernelHash)
+{
+	const uint64_t connectionId = connection.GetId();
+	const Clock::time_point now = Clock::now();
+
+	bool scheduleFlush = false;
+	bool scheduleRetry = false;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		ExpireInFlight(now);
+
+		PeerQueues& queues = m_peerQueues[connectionId];
+		queues.updatedAt = now;
+
+		auto iter = m_inFlight.find(kernelHash);
+		if (iter == m_inFlight.end())
+		{
+			m_inFlight.insert({ kernelHash, InFlight{ connectionId, now } });
+
+			std::vector<Hash>& pending = queues.pending;
+			pending.push_back(kernelHash);
+			scheduleFlush = pending.size() == 1;
+		}
+		else if (iter->second.connectionId != connectionId)
+		{
+			std::vector<Hash>& fallbacks = queues.fallbacks;
+			fallbacks.push_back(kernelHash);
+			scheduleRetry = fallbacks.size() == 1;
+		}
+	}
+
+	// One timer per peer per window, rather than one per kernel.
+	auto pRequester = shared_from_this();
+	if (scheduleFlush)
+	{
+		connection.PostAfter(BATCH_WINDOW, [pRequester](Connection& target) { pRequester->Flush(target); });
+	}
+
+	if (scheduleRetry)
+	{
+		connection.PostAfter(REQUEST_TIMEOUT + BATCH_WINDOW, [pRequester](Connection& target) { pRequester->Retry(target); });
+	}
+}
+
+void TransactionRequester::OnTransactionReceived(const Transaction& transaction)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (const TransactionKernel& kernel : transaction.GetKernels())
+	{
+		m_inFlight.erase(kernel.GetHash());
+	}
+}
+
+void TransactionRequester::Flush(Connection& connection)
+{
+	std::vector<Hash> kernelHashes;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		kernelHashes.swap(m_peerQueues[connection.GetId()].pending);
+	}
+
+	SendRequests(connection, std::move(kernelHashes));
+}
+
+void TransactionRequester::Retry(Connection& connection)
+{
+	const uint64_t connectionId = connection.GetId();
+	const Clock::time_point now = Clock::now();
+
+	std::vector<Hash> kernelHashes;
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		std::vector<Hash> fallbacks;
+		fallbacks.swap(m_peerQueues[connectionId].fallbacks);
+
+		for (const Hash& kernelHash : fallbacks)
+		{
+			// Anything no longer in flight either arrived, or expired without any peer delivering it.
+			auto iter = m_inFlight.find(kernelHash);
+			if (iter != m_inFlight.end() && iter->second.connectionId != connectionId && now - iter->second.requestedAt >= REQUEST_TIMEOUT)
+			{
+				iter->second = InFlight{ connectionId, now };
+				kernelHashes.push_back(kernelHash);
+			}
+		}
+	}
+
+	if (!kernelHashes.empty())
+	{
+		LOG_DEBUG_F("Requesting {} transactions from {} that weren't delivered by another peer", kernelHashes.size(), connection);
+		SendRequests(connection, std::move(kernelHashes));
+	}
+}
+
+void TransactionRequester::ExpireInFlight(const Clock::time_point& now)
+{
+	if (now - m_lastExpiration < REQUEST_TIMEOUT && m_inFlight.size() < MAX_IN_FLIGHT)
+	{
+		return;
+	}
+
+	m_lastExpiration = now;
+	for (auto iter = m_inFlight.begin(); iter != m_inFlight.end();)
+	{
+		iter = (now - iter->second.requestedAt >= EXPIRATION || m_inFlight.size() >= MAX_IN_FLIGHT) ? m_inFlight.erase(iter) : std::next(iter);
+	}
+
+	// Queues are drained well within EXPIRATION, unless the peer disconnected before its timers fired.
+	for (auto iter = m_peerQueues.begin(); iter != m_peerQueues.end();)
+	{
+		const bool drained = iter->second.pending.empty() && iter->second.fallbacks.empty();
+		iter = (drained || now - iter->second.updatedAt >= EXPIRATION) ? m_peerQueues.erase(iter) : std::next(iter);
+	}
+}
+
+void TransactionRequester::SendRequests(Connection& connection, std::vector<Hash>&& kernelHashes)
+{
+	if (!connection.GetCapabilities().HasCapability(Capabilities::TX_BATCH_REQUESTS))
+	{
+		for (Hash& kernelHash : kernelHashes)
+		{
+			connection.SendMsg(GetTransactionMessage{ std::move(kernelHash) });
+		}
+
+		return;
+	}
+
+	for (size_t i = 0; i < kernelHashes.size(); i += P2P::MAX_TX_REQUESTS)
+	{
+		const size_t end = (std::min)(kernelHashes.size(), i + P2P::MAX_TX_REQUESTS);
+		connection.SendMsg(GetTransactionsMessage{ std::vector<Hash>(kernelHashes.begin() + i, kernelHashes.begin() + end) });
+	}
+}
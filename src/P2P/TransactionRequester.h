@@ -0,0 +1,77 @@
+#pragma once
+
+#include <Crypto/Hash.h>
+#include <Core/Models/Transaction.h>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// Forward Declarations
+class Connection;
+
+//
+// Fetches the transactions for announced kernels we don't have.
+//
+// Announcements are collected for BATCH_WINDOW, then requested together: with one GetTransactionsMessage from peers that advertise
+// Capabilities::TX_BATCH_REQUESTS, and one GetTransactionMessage per kernel from the rest.
+// Each kernel is only requested from one peer at a time. A kernel announced by other peers while it's in flight is remembered,
+// and requested from one of them if it still hasn't arrived after REQUEST_TIMEOUT.
+//
+class TransactionRequester : public std::enable_shared_from_this<TransactionRequester>
+{
+public:
+	using Ptr = std::shared_ptr<TransactionRequester>;
+
+	static constexpr std::chrono::milliseconds BATCH_WINDOW{ 100 };
+	static constexpr std::chrono::milliseconds REQUEST_TIMEOUT{ 5'000 };
+
+	static TransactionRequester::Ptr Create() { return std::shared_ptr<TransactionRequester>(new TransactionRequester()); }
+
+	//
+	// Called for each announced kernel that isn't in the transaction pool.
+	//
+	void OnAnnouncement(Connection& connection, const Hash& kernelHash);
+
+	//
+	// Called for each transaction received, whether it was requested or not.
+	//
+	void OnTransactionReceived(const Transaction& transaction);
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	// In flight entries are dropped this long after being requested (or once there are too many), whether or not they arrived.
+	static constexpr std::chrono::milliseconds EXPIRATION{ 4 * REQUEST_TIMEOUT };
+	static constexpr size_t MAX_IN_FLIGHT = 50'000;
+
+	TransactionRequester() = default;
+
+	struct InFlight
+	{
+		uint64_t connectionId;
+		Clock::time_point requestedAt;
+	};
+
+	struct PeerQueues
+	{
+		// Waiting to be requested from the peer at the end of the batch window.
+		std::vector<Hash> pending;
+
+		// Announced by the peer while in flight from another, to be requested from this peer if that one doesn't deliver.
+		std::vector<Hash> fallbacks;
+
+		Clock::time_point updatedAt;
+	};
+
+	void Flush(Connection& connection);
+	void Retry(Connection& connection);
+	void ExpireInFlight(const Clock::time_point& now);
+	static void SendRequests(Connection& connection, std::vector<Hash>&& kernelHashes);
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<Hash, InFlight> m_inFlight;
+	std::unordered_map<uint64_t, PeerQueues> m_peerQueues;
+	Clock::time_point m_lastExpiration;
+};
@@ -0,0 +1,258 @@
+#pragma once
+
+#include "MMRUtil.h"
+#include "MMRHashUtil.h"
+
+#include <Crypto/Hash.h>
+#include <Core/File/BitmapFile.h>
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+//
+// The MMR of a leafset's bitmap, split into 1024-leaf (128 byte) chunks, whose root is the UBMT root committed to by v3+ headers.
+//
+// The MMR's hashes are kept in memory, so once built, only the chunks whose bits changed are rehashed (along with their parents).
+// Changes are recorded as the leafset is modified, and applied the next time the root is requested.
+// Rewinds and rollbacks invalidate every chunk from the first one they touch, which are then re-appended.
+//
+class BitmapChunkMMR
+{
+public:
+	static constexpr uint64_t LEAVES_PER_CHUNK = 1024;
+	static constexpr uint64_t BYTES_PER_CHUNK = LEAVES_PER_CHUNK / 8;
+
+	BitmapChunkMMR() : m_numChunks(0), m_built(false), m_firstRewoundChunk(UINT64_MAX), m_firstUncommittedRewind(UINT64_MAX) { }
+
+	void OnChanged(const uint64_t leafIndex)
+	{
+		if (m_built)
+		{
+			m_changedChunks.insert(leafIndex / LEAVES_PER_CHUNK);
+			m_uncommittedChunks.insert(leafIndex / LEAVES_PER_CHUNK);
+		}
+	}
+
+	void OnRewind(const uint64_t numLeaves)
+	{
+		if (m_built)
+		{
+			m_firstRewoundChunk = (std::min)(m_firstRewoundChunk, numLeaves / LEAVES_PER_CHUNK);
+			m_firstUncommittedRewind = (std::min)(m_firstUncommittedRewind, numLeaves / LEAVES_PER_CHUNK);
+		}
+	}
+
+	void OnCommit()
+	{
+		m_uncommittedChunks.clear();
+		m_firstUncommittedRewind = UINT64_MAX;
+	}
+
+	//
+	// The bitmap's uncommitted changes are discarded, so the chunks they touched have to be rehashed from the committed bits.
+	//
+	void OnRollback()
+	{
+		m_changedChunks.insert(m_uncommittedChunks.cbegin(), m_uncommittedChunks.cend());
+		m_firstRewoundChunk = (std::min)(m_firstRewoundChunk, m_firstUncommittedRewind);
+		OnCommit();
+	}
+
+	Hash Root(const BitmapFile& bitmap, const uint64_t numOutputs)
+	{
+		const uint64_t numChunks = (numOutputs + LEAVES_PER_CHUNK - 1) / LEAVES_PER_CHUNK;
+
+		// Chunks from the first rewound one on (or past the requested size) are dropped, and appended again below.
+		Truncate((std::min)({ m_numChunks, m_firstRewoundChunk, numChunks }));
+		m_firstRewoundChunk = UINT64_MAX;
+
+		for (const uint64_t chunkIndex : m_changedChunks)
+		{
+			if (chunkIndex >= m_numChunks)
+			{
+				break;
+			}
+
+			UpdateChunk(bitmap, chunkIndex);
+		}
+		m_changedChunks.clear();
+
+		while (m_numChunks < numChunks)
+		{
+			AppendChunk(bitmap, m_numChunks);
+		}
+
+		m_built = true;
+		return BagPeaks();
+	}
+
+	//
+	// The root the MMR would have if the given chunks were replaced (or appended) and it had numChunks chunks, all without changing it.
+	// The MMR must be up to date (see Root), and every chunk past the MMR's last one must be given.
+	//
+	Hash SpeculativeRoot(const std::map<uint64_t, std::vector<unsigned char>>& chunks, const uint64_t numChunks) const
+	{
+		std::map<uint64_t, Hash> replaced;
+		std::vector<Hash> appended;
+		auto getHash = [this, &replaced, &appended](const uint64_t position) -> const Hash& {
+			if (position >= m_hashes.size())
+			{
+				return appended[position - m_hashes.size()];
+			}
+
+			auto iter = replaced.find(position);
+			return iter != replaced.end() ? iter->second : m_hashes[position];
+		};
+
+		for (auto iter = chunks.cbegin(); iter != chunks.cend() && iter->first < m_numChunks; iter++)
+		{
+			uint64_t position = MMRUtil::GetPMMRIndex(iter->first);
+			replaced[position] = MMRHashUtil::HashLeafWithIndex(iter->second, position);
+
+			uint64_t parentPosition = MMRUtil::GetParentIndex(position);
+			while (parentPosition < m_hashes.size())
+			{
+				const uint64_t siblingPosition = MMRUtil::GetSiblingIndex(position);
+				const bool isLeft = siblingPosition > position;
+				replaced[parentPosition] = MMRHashUtil::HashParentWithIndex(
+					getHash(isLeft ? position : siblingPosition),
+					getHash(isLeft ? siblingPosition : position),
+					parentPosition
+				);
+
+				position = parentPosition;
+				parentPosition = MMRUtil::GetParentIndex(position);
+			}
+		}
+
+		for (uint64_t chunkIndex = m_numChunks; chunkIndex < numChunks; chunkIndex++)
+		{
+			uint64_t position = m_hashes.size() + appended.size();
+			appended.push_back(MMRHashUtil::HashLeafWithIndex(chunks.at(chunkIndex), position));
+
+			uint64_t peak = 1;
+			while (MMRUtil::GetHeight(position + 1) > 0)
+			{
+				const uint64_t leftSiblingPosition = (position + 1) - (2 * peak);
+				Hash parentHash = MMRHashUtil::HashParentWithIndex(getHash(leftSiblingPosition), getHash(position), position + 1);
+
+				++position;
+				peak *= 2;
+				appended.push_back(std::move(parentHash));
+			}
+		}
+
+		return BagPeaks(m_hashes.size() + appended.size(), getHash);
+	}
+
+private:
+	std::vector<unsigned char> GetChunk(const BitmapFile& bitmap, const uint64_t chunkIndex) const
+	{
+		std::vector<unsigned char> bytes(BYTES_PER_CHUNK);
+		for (uint64_t i = 0; i < BYTES_PER_CHUNK; i++)
+		{
+			bytes[i] = bitmap.GetByte((chunkIndex * BYTES_PER_CHUNK) + i);
+		}
+
+		return bytes;
+	}
+
+	// The same hashes MMRHashUtil::AddHashes would write to a hash file.
+	void AppendChunk(const BitmapFile& bitmap, const uint64_t chunkIndex)
+	{
+		uint64_t position = m_hashes.size();
+		m_hashes.push_back(MMRHashUtil::HashLeafWithIndex(GetChunk(bitmap, chunkIndex), position));
+
+		uint64_t peak = 1;
+		while (MMRUtil::GetHeight(position + 1) > 0)
+		{
+			const uint64_t leftSiblingPosition = (position + 1) - (2 * peak);
+			const Hash& leftHash = m_hashes[leftSiblingPosition];
+			const Hash& rightHash = m_hashes[position];
+
+			++position;
+			peak *= 2;
+
+			m_hashes.push_back(MMRHashUtil::HashParentWithIndex(leftHash, rightHash, position));
+		}
+
+		++m_numChunks;
+	}
+
+	void UpdateChunk(const BitmapFile& bitmap, const uint64_t chunkIndex)
+	{
+		uint64_t position = MMRUtil::GetPMMRIndex(chunkIndex);
+		m_hashes[position] = MMRHashUtil::HashLeafWithIndex(GetChunk(bitmap, chunkIndex), position);
+
+		uint64_t parentPosition = MMRUtil::GetParentIndex(position);
+		while (parentPosition < m_hashes.size())
+		{
+			const uint64_t siblingPosition = MMRUtil::GetSiblingIndex(position);
+			const bool isLeft = siblingPosition > position;
+			m_hashes[parentPosition] = MMRHashUtil::HashParentWithIndex(
+				m_hashes[isLeft ? position : siblingPosition],
+				m_hashes[isLeft ? siblingPosition : position],
+				parentPosition
+			);
+
+			position = parentPosition;
+			parentPosition = MMRUtil::GetParentIndex(position);
+		}
+	}
+
+	void Truncate(const uint64_t numChunks)
+	{
+		if (numChunks < m_numChunks)
+		{
+			// Like GetPMMRIndex, the size of an MMR with numChunks leaves is the position its next leaf would have.
+			m_hashes.resize(MMRUtil::GetPMMRIndex(numChunks));
+			m_numChunks = numChunks;
+		}
+	}
+
+	Hash BagPeaks() const
+	{
+		return BagPeaks(m_hashes.size(), [this](const uint64_t position) -> const Hash& { return m_hashes[position]; });
+	}
+
+	// Same as MMRHashUtil::Root.
+	template<typename GetHash>
+	static Hash BagPeaks(const uint64_t size, const GetHash& getHash)
+	{
+		if (size == 0)
+		{
+			return ZERO_HASH;
+		}
+
+		Hash hash = ZERO_HASH;
+		const MMRUtil::Peaks peaks = MMRUtil::GetPeaks(size);
+		for (auto iter = peaks.rbegin(); iter != peaks.rend(); iter++)
+		{
+			const Hash& peakHash = getHash(*iter);
+			if (hash == ZERO_HASH)
+			{
+				hash = peakHash;
+			}
+			else
+			{
+				hash = MMRHashUtil::HashParentWithIndex(peakHash, hash, size);
+			}
+		}
+
+		return hash;
+	}
+
+	std::vector<Hash> m_hashes;
+	uint64_t m_numChunks;
+
+	// Changes are only tracked once the MMR has been built, so leafsets whose UBMT root is never needed (eg. rangeproofs') don't keep them.
+	bool m_built;
+	std::set<uint64_t> m_changedChunks;
+	uint64_t m_firstRewoundChunk;
+
+	std::set<uint64_t> m_uncommittedChunks;
+	uint64_t m_firstUncommittedRewind;
+};
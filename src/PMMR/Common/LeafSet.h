@@ -3,6 +3,7 @@
 #include "PruneList.h"
 #include "MMRUtil.h"
 #include "MMRHashUtil.h"
+#include "BitmapChunkMMR.h"
 
 #include <string>
 #include <Crypto/Hash.h>
@@ -13,7 +14,19 @@
 #include <Common/Util/FileUtil.h>
 #include <Core/Serialization/Serializer.h>
 
-#include <filesystem.h>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+
+//
+// The leafset as of an earlier block, stored as its difference from the current leafset:
+// every leaf at or past numLeaves was added since, and the restored leaves were spent since.
+//
+struct LeafSetSnapshot
+{
+	uint64_t numLeaves;
+	std::vector<uint64_t> restoredLeaves;
+};
 
 class LeafSet
 {
@@ -25,49 +38,148 @@ public:
 		return std::shared_ptr<LeafSet>(new LeafSet(path, pBitmapFile));
 	}
 
-	void Add(const uint64_t leafIndex) { m_pBitmap->Set(leafIndex); }
-	void Remove(const uint64_t leafIndex) { m_pBitmap->Unset(leafIndex); }
+	void Add(const uint64_t leafIndex)
+	{
+		m_pBitmap->Set(leafIndex);
+
+		std::unique_lock<std::mutex> lock(m_ubmtMutex);
+		m_ubmt.OnChanged(leafIndex);
+	}
+
+	void Remove(const uint64_t leafIndex)
+	{
+		m_pBitmap->Unset(leafIndex);
+
+		std::unique_lock<std::mutex> lock(m_ubmtMutex);
+		m_ubmt.OnChanged(leafIndex);
+	}
+
 	bool Contains(const uint64_t leafIndex) const { return m_pBitmap->IsSet(leafIndex); }
 
-	void Rewind(const uint64_t numLeaves, const std::vector<uint64_t>& leavesToAdd) { m_pBitmap->Rewind(numLeaves, leavesToAdd); }
-	void Commit() { m_pBitmap->Commit(); }
-	void Rollback() noexcept { m_pBitmap->Rollback(); }
-	void Snapshot(const Hash& blockHash)
+	// Returns up to maxLeaves of the unspent leaves in [firstLeaf, endLeaf), in order.
+	std::vector<uint64_t> GetUnspentLeaves(const uint64_t firstLeaf, const uint64_t endLeaf, const size_t maxLeaves) const
 	{
-		GrinStr pathStr = m_path.u8string() + "." + HASH::ShortHash(blockHash);
-		Roaring snapshotBitmap = m_pBitmap->ToRoaring();
+		return m_pBitmap->GetSetLeaves(firstLeaf, endLeaf, maxLeaves);
+	}
+
+	void Rewind(const uint64_t numLeaves, const std::vector<uint64_t>& leavesToAdd)
+	{
+		m_pBitmap->Rewind(numLeaves, leavesToAdd);
+
+		std::unique_lock<std::mutex> lock(m_ubmtMutex);
+		for (const uint64_t leafIndex : leavesToAdd)
+		{
+			m_ubmt.OnChanged(leafIndex);
+		}
+
+		m_ubmt.OnRewind(numLeaves);
+	}
+
+	void Commit()
+	{
+		m_pBitmap->Commit();
+
+		std::unique_lock<std::mutex> lock(m_ubmtMutex);
+		m_ubmt.OnCommit();
+	}
+
+	void Rollback() noexcept
+	{
+		m_pBitmap->Rollback();
+
+		std::unique_lock<std::mutex> lock(m_ubmtMutex);
+		m_ubmt.OnRollback();
+	}
+
+	//
+	// Reconstructs the bitmap of a snapshot from the current leafset, without modifying it.
+	//
+	Roaring ToRoaring(const LeafSetSnapshot& snapshot) const
+	{
+		Roaring bitmap = m_pBitmap->ToRoaring(snapshot.numLeaves);
+		for (const uint64_t leafIndex : snapshot.restoredLeaves)
+		{
+			bitmap.add((uint32_t)(MMRUtil::GetPMMRIndex(leafIndex) + 1));
+		}
+
+		return bitmap;
+	}
+
+	//
+	// Writes the snapshot's bitmap to the given path, in the serialized Roaring format used by TxHashSet archives.
+	//
+	void WriteSnapshot(const LeafSetSnapshot& snapshot, const fs::path& path) const
+	{
+		Roaring snapshotBitmap = ToRoaring(snapshot);
+		snapshotBitmap.runOptimize();
 
 		const size_t numBytes = snapshotBitmap.getSizeInBytes();
 		std::vector<unsigned char> bytes(numBytes);
 		const size_t bytesWritten = snapshotBitmap.write((char*)bytes.data());
 		if (bytesWritten != numBytes)
 		{
-			throw std::exception(); // TODO: Handle this.
+			throw FILE_EXCEPTION_F("Failed to serialize leafset snapshot {}", path);
 		}
 
-		FileUtil::SafeWriteToFile(pathStr.ToPath(), bytes);
+		FileUtil::SafeWriteToFile(path, bytes);
 	}
 
+	//
+	// The UBMT root of the first numOutputs leaves. The first call hashes every chunk of the bitmap,
+	// and later calls only rehash the chunks changed since (see BitmapChunkMMR).
+	//
 	Hash Root(const uint64_t numOutputs) const
 	{
-		const fs::path path = fs::temp_directory_path() / "UBMT";
-		std::shared_ptr<HashFile> pHashFile = HashFile::Load(path);
-		pHashFile->Rewind(0);
-
-		size_t index = 0;
-		std::vector<uint8_t> bytes(128);
-		const uint64_t numChunks = (numOutputs + 1023) / 1024;
-		for (size_t i = 0; i < numChunks; i++)
+		std::unique_lock<std::mutex> lock(m_ubmtMutex);
+		return m_ubmt.Root(*m_pBitmap, numOutputs);
+	}
+
+	//
+	// The UBMT root the leafset would have with numOutputs leaves, if every leaf from numLeaves on was added,
+	// and the given leaves were then removed. The leafset itself, which must have numLeaves leaves, is left unchanged.
+	//
+	Hash SpeculativeRoot(const uint64_t numLeaves, const uint64_t numOutputs, const std::unordered_set<uint64_t>& removedLeaves) const
+	{
+		constexpr uint64_t LEAVES_PER_CHUNK = BitmapChunkMMR::LEAVES_PER_CHUNK;
+
+		std::set<uint64_t> chunkIndices;
+		for (uint64_t chunkIndex = numLeaves / LEAVES_PER_CHUNK; chunkIndex * LEAVES_PER_CHUNK < numOutputs; chunkIndex++)
 		{
-			for (size_t j = 0; j < 128; j++)
+			chunkIndices.insert(chunkIndex);
+		}
+
+		for (const uint64_t leafIndex : removedLeaves)
+		{
+			chunkIndices.insert(leafIndex / LEAVES_PER_CHUNK);
+		}
+
+		std::map<uint64_t, std::vector<unsigned char>> chunks;
+		for (const uint64_t chunkIndex : chunkIndices)
+		{
+			std::vector<unsigned char> bytes(BitmapChunkMMR::BYTES_PER_CHUNK);
+			for (uint64_t i = 0; i < bytes.size(); i++)
 			{
-				bytes[j] = m_pBitmap->GetByte(index++);
+				bytes[i] = m_pBitmap->GetByte((chunkIndex * BitmapChunkMMR::BYTES_PER_CHUNK) + i);
 			}
 
-			MMRHashUtil::AddHashes(pHashFile, bytes, nullptr);
+			const uint64_t firstLeaf = chunkIndex * LEAVES_PER_CHUNK;
+			for (uint64_t leafIndex = (std::max)(firstLeaf, numLeaves); leafIndex < (std::min)(firstLeaf + LEAVES_PER_CHUNK, numOutputs); leafIndex++)
+			{
+				bytes[(leafIndex - firstLeaf) / 8] |= (1 << (7 - (leafIndex % 8)));
+			}
+
+			chunks[chunkIndex] = std::move(bytes);
+		}
+
+		for (const uint64_t leafIndex : removedLeaves)
+		{
+			const uint64_t offset = leafIndex % LEAVES_PER_CHUNK;
+			chunks[leafIndex / LEAVES_PER_CHUNK][offset / 8] &= ~(1 << (7 - (offset % 8)));
 		}
 
-		return MMRHashUtil::Root(pHashFile, pHashFile->GetSize(), nullptr);
+		std::unique_lock<std::mutex> lock(m_ubmtMutex);
+		m_ubmt.Root(*m_pBitmap, numLeaves);
+		return m_ubmt.SpeculativeRoot(chunks, (numOutputs + LEAVES_PER_CHUNK - 1) / LEAVES_PER_CHUNK);
 	}
 
 private:
@@ -79,4 +191,7 @@ private:
 
 	fs::path m_path;
 	std::shared_ptr<BitmapFile> m_pBitmap;
+
+	mutable std::mutex m_ubmtMutex;
+	mutable BitmapChunkMMR m_ubmt;
 };
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <Core/File/MappedFile.h>
 #include <Crypto/Hash.h>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 class MMR
 {
@@ -25,11 +27,22 @@ public:
 	//
 	virtual std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const = 0;
 
+	//
+	// Gets the hashes for the mmr index range [firstIndex, lastIndex] using a single contiguous read.
+	// Hashes are returned back-to-back (HASH_SIZE bytes each). Pruned nodes are all zeros.
+	//
+	virtual std::vector<uint8_t> GetHashes(const uint64_t firstIndex, const uint64_t lastIndex) const = 0;
+
 	//
 	// Gets the last n leaf hashes.
 	//
 	virtual std::vector<Hash> GetLastLeafHashes(const uint64_t numHashes) const = 0;
 
+	//
+	// Hints how the MMR's hash and data files are about to be read.
+	//
+	virtual void SetAccessHint(const EFileAccess access) = 0;
+
 	//
 	// Flushes all working changes to disk.
 	//
@@ -0,0 +1,71 @@
+#include "MMRHashOverlay.h"
+#include "MMRUtil.h"
+#include "MMRHashUtil.h"
+
+#include <Core/Exceptions/TxHashSetException.h>
+#include <Common/Util/StringUtil.h>
+
+void MMRHashOverlay::Append(const std::vector<uint8_t>& serializedLeaf)
+{
+	uint64_t position = GetSize();
+	m_hashes.push_back(MMRHashUtil::HashLeafWithIndex(serializedLeaf, position));
+
+	// The left siblings are all peaks, which are never compacted away.
+	uint64_t peak = 1;
+	while (MMRUtil::GetHeight(position + 1) > 0)
+	{
+		const uint64_t leftSiblingPosition = (position + 1) - (2 * peak);
+		const Hash leftHash = GetHashAt(leftSiblingPosition);
+		if (leftHash == ZERO_HASH)
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Hash missing at {}", leftSiblingPosition));
+		}
+
+		++position;
+		peak *= 2;
+
+		Hash parentHash = MMRHashUtil::HashParentWithIndex(leftHash, m_hashes.back(), position);
+		m_hashes.emplace_back(std::move(parentHash));
+	}
+}
+
+Hash MMRHashOverlay::Root() const
+{
+	const uint64_t size = GetSize();
+	if (size == 0)
+	{
+		return ZERO_HASH;
+	}
+
+	// Bag the peaks from right to left, skipping pruned peaks, exactly as MMRHashUtil::Root does.
+	Hash hash = ZERO_HASH;
+	const MMRUtil::Peaks peaks = MMRUtil::GetPeaks(size);
+	for (auto iter = peaks.rbegin(); iter != peaks.rend(); iter++)
+	{
+		const Hash peakHash = GetHashAt(*iter);
+		if (peakHash != ZERO_HASH)
+		{
+			if (hash == ZERO_HASH)
+			{
+				hash = peakHash;
+			}
+			else
+			{
+				hash = MMRHashUtil::HashParentWithIndex(peakHash, hash, size);
+			}
+		}
+	}
+
+	return hash;
+}
+
+Hash MMRHashOverlay::GetHashAt(const uint64_t mmrIndex) const
+{
+	if (mmrIndex >= m_baseSize)
+	{
+		return m_hashes[mmrIndex - m_baseSize];
+	}
+
+	std::unique_ptr<Hash> pHash = m_pMMR->GetHashAt(mmrIndex);
+	return pHash != nullptr ? *pHash : ZERO_HASH;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "MMR.h"
+
+#include <Crypto/Hash.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//
+// Hashes appended on top of an MMR, kept in memory so the MMR itself is left unchanged.
+//
+// Only the MMR's peaks are ever read from it, both for the parents of appended leaves and for the root,
+// so building on top of even a large MMR costs little more than hashing the appended leaves.
+// The MMR must not change while the overlay is in use.
+//
+class MMRHashOverlay
+{
+public:
+	MMRHashOverlay(std::shared_ptr<const MMR> pMMR)
+		: m_pMMR(pMMR), m_baseSize(pMMR->GetSize()) { }
+
+	//
+	// The size of the MMR with the appended hashes.
+	//
+	uint64_t GetSize() const noexcept { return m_baseSize + m_hashes.size(); }
+
+	//
+	// Appends the hash of the leaf, and of any parents it completes, the same way MMRHashUtil::AddHashes does.
+	//
+	void Append(const std::vector<uint8_t>& serializedLeaf);
+
+	//
+	// Returns the same hash as MMR::Root(GetSize()) would, had the leaves been appended to the MMR.
+	//
+	Hash Root() const;
+
+private:
+	// Returns ZERO_HASH if the node has been pruned.
+	Hash GetHashAt(const uint64_t mmrIndex) const;
+
+	std::shared_ptr<const MMR> m_pMMR;
+	uint64_t m_baseSize;
+	std::vector<Hash> m_hashes;
+};
@@ -4,6 +4,12 @@
 
 #include <Crypto/Hasher.h>
 #include <Core/Serialization/Serializer.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <thread>
 
 void MMRHashUtil::AddHashes(
 	std::shared_ptr<HashFile> pHashFile,
@@ -38,6 +44,79 @@ void MMRHashUtil::AddHashes(
 	}
 }
 
+void MMRHashUtil::AddHashes(
+	std::shared_ptr<HashFile> pHashFile,
+	const std::vector<std::vector<unsigned char>>& serializedLeaves,
+	std::shared_ptr<const PruneList> pPruneList)
+{
+	if (serializedLeaves.empty())
+	{
+		return;
+	}
+
+	// Calculate first position
+	uint64_t firstPosition = pHashFile->GetSize();
+	if (pPruneList != nullptr)
+	{
+		firstPosition += pPruneList->GetTotalShift();
+	}
+
+	// A leaf's position only depends on the number of leaves before it, so the leaves are hashed independently.
+	std::vector<uint64_t> leafPositions(serializedLeaves.size());
+	uint64_t nextPosition = firstPosition;
+	for (size_t i = 0; i < serializedLeaves.size(); i++)
+	{
+		leafPositions[i] = nextPosition++;
+		while (MMRUtil::GetHeight(nextPosition) > 0)
+		{
+			++nextPosition;
+		}
+	}
+
+	const std::vector<unsigned char> leafHashes = HashLeaves(serializedLeaves, leafPositions);
+
+	std::vector<unsigned char> newHashes;
+	newHashes.reserve(serializedLeaves.size() * 2 * HASH_SIZE);
+
+	auto getHash = [&](const uint64_t mmrIndex) -> Hash {
+		if (mmrIndex >= firstPosition)
+		{
+			return Hash(newHashes.data() + ((mmrIndex - firstPosition) * HASH_SIZE));
+		}
+
+		return GetHashAt(pHashFile, mmrIndex, pPruneList);
+	};
+
+	// The parents depend on the hashes before them, so they're computed in order.
+	uint64_t position = firstPosition;
+	for (size_t i = 0; i < serializedLeaves.size(); i++)
+	{
+		// Add in the new leaf hash
+		const unsigned char* pLeafHash = leafHashes.data() + (i * HASH_SIZE);
+		newHashes.insert(newHashes.end(), pLeafHash, pLeafHash + HASH_SIZE);
+
+		// Add parent hashes
+		uint64_t peak = 1;
+		while (MMRUtil::GetHeight(position + 1) > 0)
+		{
+			const uint64_t leftSiblingPosition = (position + 1) - (2 * peak);
+
+			const Hash leftHash = getHash(leftSiblingPosition);
+			const Hash rightHash = getHash(position);
+
+			++position;
+			peak *= 2;
+
+			const Hash parentHash = HashParentWithIndex(leftHash, rightHash, position);
+			newHashes.insert(newHashes.end(), parentHash.data(), parentHash.data() + HASH_SIZE);
+		}
+
+		++position;
+	}
+
+	pHashFile->AddData(newHashes);
+}
+
 Hash MMRHashUtil::Root(
 	std::shared_ptr<const HashFile> pHashFile,
 	const uint64_t size,
@@ -49,8 +128,8 @@ Hash MMRHashUtil::Root(
 	}
 
 	Hash hash = ZERO_HASH;
-	const std::vector<uint64_t> peakIndices = MMRUtil::GetPeakIndices(size);
-	for (auto iter = peakIndices.crbegin(); iter != peakIndices.crend(); iter++)
+	const MMRUtil::Peaks peaks = MMRUtil::GetPeaks(size);
+	for (auto iter = peaks.rbegin(); iter != peaks.rend(); iter++)
 	{
 		const uint64_t shiftedIndex = GetShiftedIndex(*iter, pPruneList);
 		Hash peakHash = pHashFile->GetDataAt(shiftedIndex);
@@ -107,6 +186,55 @@ uint64_t MMRHashUtil::GetShiftedIndex(const uint64_t mmrIndex, std::shared_ptr<c
 	}
 }
 
+std::vector<uint8_t> MMRHashUtil::GetHashes(
+	std::shared_ptr<const HashFile> pHashFile,
+	const uint64_t firstIndex,
+	const uint64_t lastIndex,
+	std::shared_ptr<const PruneList> pPruneList)
+{
+	const uint64_t numHashes = (lastIndex - firstIndex) + 1;
+	if (pPruneList == nullptr)
+	{
+		return pHashFile->GetDataRange(firstIndex, numHashes);
+	}
+
+	// Compacted nodes are not stored in the hash file,
+	// so the remaining nodes in the range are stored back-to-back.
+	std::vector<bool> compacted(numHashes);
+	uint64_t firstStored = lastIndex + 1;
+	uint64_t numStored = 0;
+	for (uint64_t i = 0; i < numHashes; i++)
+	{
+		compacted[i] = pPruneList->IsCompacted(firstIndex + i);
+		if (!compacted[i])
+		{
+			firstStored = std::min(firstStored, firstIndex + i);
+			++numStored;
+		}
+	}
+
+	std::vector<uint8_t> hashes(numHashes * HASH_SIZE, 0);
+	if (numStored == 0)
+	{
+		return hashes;
+	}
+
+	const uint64_t shiftedIndex = GetShiftedIndex(firstStored, pPruneList);
+	const std::vector<uint8_t> stored = pHashFile->GetDataRange(shiftedIndex, numStored);
+
+	auto storedIter = stored.cbegin();
+	for (uint64_t i = 0; i < numHashes; i++)
+	{
+		if (!compacted[i])
+		{
+			std::copy(storedIter, storedIter + HASH_SIZE, hashes.begin() + (i * HASH_SIZE));
+			storedIter += HASH_SIZE;
+		}
+	}
+
+	return hashes;
+}
+
 std::vector<Hash> MMRHashUtil::GetLastLeafHashes(
 	std::shared_ptr<const HashFile> pHashFile,
 	std::shared_ptr<const LeafSet> pLeafSet,
@@ -140,6 +268,63 @@ std::vector<Hash> MMRHashUtil::GetLastLeafHashes(
 	return hashes;
 }
 
+std::vector<unsigned char> MMRHashUtil::HashLeaves(const std::vector<std::vector<unsigned char>>& serializedLeaves, const std::vector<uint64_t>& leafPositions)
+{
+	std::vector<unsigned char> leafHashes(serializedLeaves.size() * HASH_SIZE);
+	auto hashLeaves = [&serializedLeaves, &leafPositions, &leafHashes](const size_t first, const size_t end) {
+		// Same layout as HashLeafWithIndex (big-endian index, then the leaf), for every leaf in one buffer,
+		// so that leaves of the same size can be hashed several at a time.
+		size_t totalSize = 0;
+		for (size_t i = first; i < end; i++)
+		{
+			totalSize += 8 + serializedLeaves[i].size();
+		}
+
+		std::vector<unsigned char> preimages(totalSize);
+		std::vector<std::pair<const uint8_t*, size_t>> inputs;
+		inputs.reserve(end - first);
+
+		unsigned char* pPreimage = preimages.data();
+		for (size_t i = first; i < end; i++)
+		{
+			for (size_t j = 0; j < 8; j++)
+			{
+				pPreimage[j] = (unsigned char)(leafPositions[i] >> (8 * (7 - j)));
+			}
+
+			std::copy(serializedLeaves[i].cbegin(), serializedLeaves[i].cend(), pPreimage + 8);
+			inputs.push_back({ pPreimage, 8 + serializedLeaves[i].size() });
+			pPreimage += 8 + serializedLeaves[i].size();
+		}
+
+		Hasher::Blake2bBatch(inputs, leafHashes.data() + (first * HASH_SIZE));
+	};
+
+	const size_t maxThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+	const size_t numThreads = std::min(maxThreads, serializedLeaves.size() / MIN_LEAVES_PER_THREAD);
+	if (numThreads <= 1)
+	{
+		hashLeaves(0, serializedLeaves.size());
+		return leafHashes;
+	}
+
+	std::atomic_size_t nextChunk = 0;
+	ThreadManagerAPI::GetThreadPool().RunParallel(numThreads, [&]() {
+		while (true)
+		{
+			const size_t first = (nextChunk++) * MIN_LEAVES_PER_THREAD;
+			if (first >= serializedLeaves.size())
+			{
+				break;
+			}
+
+			hashLeaves(first, std::min(first + MIN_LEAVES_PER_THREAD, serializedLeaves.size()));
+		}
+	});
+
+	return leafHashes;
+}
+
 Hash MMRHashUtil::HashLeafWithIndex(const std::vector<unsigned char>& serializedLeaf, const uint64_t mmrIndex)
 {
 	Serializer hashSerializer;
@@ -155,4 +340,18 @@ Hash MMRHashUtil::HashParentWithIndex(const Hash& leftChild, const Hash& rightCh
 	serializer.AppendBigInteger<32>(leftChild);
 	serializer.AppendBigInteger<32>(rightChild);
 	return Hasher::Blake2b(serializer.GetBytes());
+}
+
+Hash MMRHashUtil::HashParentWithIndex(const uint8_t* pLeftChild, const uint8_t* pRightChild, const uint64_t parentIndex)
+{
+	// Same layout as the Serializer-based overload (big-endian index, left, right), without the heap allocations.
+	std::array<uint8_t, 8 + (2 * HASH_SIZE)> preimage;
+	for (size_t i = 0; i < 8; i++)
+	{
+		preimage[i] = (uint8_t)(parentIndex >> (8 * (7 - i)));
+	}
+
+	std::copy(pLeftChild, pLeftChild + HASH_SIZE, preimage.begin() + 8);
+	std::copy(pRightChild, pRightChild + HASH_SIZE, preimage.begin() + 8 + HASH_SIZE);
+	return Hasher::Blake2b(preimage.data(), preimage.size());
 }
\ No newline at end of file
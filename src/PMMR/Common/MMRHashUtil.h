@@ -19,6 +19,17 @@ public:
 		std::shared_ptr<const PruneList> pPruneList
 	);
 
+	//
+	// Appends the hashes for all of the leaves (and resulting parents) with a single write to the hash file.
+	// Large batches have their leaves hashed on the shared thread pool, and then the parents are computed in order.
+	// Parents are computed in memory, so only pre-existing peaks are read back from the hash file.
+	//
+	static void AddHashes(
+		std::shared_ptr<HashFile> pHashFile,
+		const std::vector<std::vector<unsigned char>>& serializedLeaves,
+		std::shared_ptr<const PruneList> pPruneList
+	);
+
 	static Hash Root(
 		std::shared_ptr<const HashFile> pHashFile,
 		const uint64_t size,
@@ -31,6 +42,17 @@ public:
 		std::shared_ptr<const PruneList> pPruneList
 	);
 
+	//
+	// Reads the hashes for the mmr index range [firstIndex, lastIndex] with a single contiguous read.
+	// Hashes are returned back-to-back (HASH_SIZE bytes each), with compacted nodes left as all zeros.
+	//
+	static std::vector<uint8_t> GetHashes(
+		std::shared_ptr<const HashFile> pHashFile,
+		const uint64_t firstIndex,
+		const uint64_t lastIndex,
+		std::shared_ptr<const PruneList> pPruneList
+	);
+
 	static std::vector<Hash> GetLastLeafHashes(
 		std::shared_ptr<const HashFile> pHashFile,
 		std::shared_ptr<const LeafSet> pLeafSet,
@@ -38,9 +60,15 @@ public:
 		const uint64_t numHashes
 	);
 
+	static Hash HashLeafWithIndex(const std::vector<unsigned char>& serializedLeaf, const uint64_t mmrIndex);
 	static Hash HashParentWithIndex(const Hash& leftChild, const Hash& rightChild, const uint64_t parentIndex);
+	static Hash HashParentWithIndex(const uint8_t* pLeftChild, const uint8_t* pRightChild, const uint64_t parentIndex);
 
 private:
-	static Hash HashLeafWithIndex(const std::vector<unsigned char>& serializedLeaf, const uint64_t mmrIndex);
+	// Below this, hashing the leaves isn't worth handing off to other threads.
+	static constexpr size_t MIN_LEAVES_PER_THREAD = 256;
+
+	// Returns the leaf hashes back-to-back (HASH_SIZE bytes each), in the same order as the leaves.
+	static std::vector<unsigned char> HashLeaves(const std::vector<std::vector<unsigned char>>& serializedLeaves, const std::vector<uint64_t>& leafPositions);
 	static uint64_t GetShiftedIndex(const uint64_t mmrIndex, std::shared_ptr<const PruneList> pPruneList);
 };
\ No newline at end of file
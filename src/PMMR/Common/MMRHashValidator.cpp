@@ -0,0 +1,214 @@
+#include "MMRHashValidator.h"
+#include "MMRUtil.h"
+
+#include <Crypto/Hasher.h>
+#include <Common/ThreadPool.h>
+#include <Common/Logger.h>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+static const size_t UPPER_NODES_PER_TASK = 1024;
+
+bool MMRHashValidator::Validate(const std::vector<std::shared_ptr<const MMR>>& mmrs) const
+{
+	std::vector<Task> tasks;
+	for (const std::shared_ptr<const MMR>& pMMR : mmrs)
+	{
+		std::vector<uint64_t> upperIndices;
+
+		const MMRUtil::Peaks peaks = MMRUtil::GetPeaks(pMMR->GetSize());
+		for (auto iter = peaks.begin(); iter != peaks.end(); iter++)
+		{
+			AddTasks(pMMR, *iter, iter.GetHeight(), tasks, upperIndices);
+		}
+
+		for (size_t i = 0; i < upperIndices.size(); i += UPPER_NODES_PER_TASK)
+		{
+			const size_t end = std::min(i + UPPER_NODES_PER_TASK, upperIndices.size());
+
+			Task task{ pMMR, 0, 0, 0, {} };
+			task.parentIndices.assign(upperIndices.cbegin() + i, upperIndices.cbegin() + end);
+			tasks.emplace_back(std::move(task));
+		}
+	}
+
+	LOG_DEBUG_F("Validating MMR hashes in {} tasks", tasks.size());
+	return RunTasks(tasks);
+}
+
+void MMRHashValidator::AddTasks(
+	const std::shared_ptr<const MMR>& pMMR,
+	const uint64_t rootIndex,
+	const uint64_t height,
+	std::vector<Task>& subtreeTasks,
+	std::vector<uint64_t>& upperIndices) const
+{
+	if (height == 0)
+	{
+		return;
+	}
+
+	if (height <= m_subtreeHeight)
+	{
+		const uint64_t firstIndex = rootIndex - ((1ULL << (height + 1)) - 2);
+		subtreeTasks.emplace_back(Task{ pMMR, firstIndex, rootIndex, height, {} });
+		return;
+	}
+
+	upperIndices.push_back(rootIndex);
+	AddTasks(pMMR, MMRUtil::GetLeftChildIndex(rootIndex, height), height - 1, subtreeTasks, upperIndices);
+	AddTasks(pMMR, MMRUtil::GetRightChildIndex(rootIndex), height - 1, subtreeTasks, upperIndices);
+}
+
+bool MMRHashValidator::RunTasks(const std::vector<Task>& tasks) const
+{
+	std::atomic_size_t nextTask = 0;
+	std::atomic_bool valid = true;
+
+	auto worker = [&tasks, &nextTask, &valid]() {
+		while (valid)
+		{
+			const size_t taskIndex = nextTask++;
+			if (taskIndex >= tasks.size())
+			{
+				break;
+			}
+
+			try
+			{
+				const Task& task = tasks[taskIndex];
+				const bool taskValid = task.parentIndices.empty() ? ValidateSubtree(task) : ValidateParents(task);
+				if (!taskValid)
+				{
+					valid = false;
+				}
+			}
+			catch (std::exception& e)
+			{
+				LOG_ERROR_F("Failed to validate MMR hashes: {}", e.what());
+				valid = false;
+			}
+		}
+	};
+
+	ThreadManagerAPI::GetThreadPool().RunParallel(std::min(m_numThreads, tasks.size()), worker, ETaskPriority::HIGH);
+
+	return valid;
+}
+
+bool MMRHashValidator::ValidateSubtree(const Task& task)
+{
+	const std::vector<uint8_t> hashes = task.pMMR->GetHashes(task.firstIndex, task.rootIndex);
+
+	std::vector<Parent> parents;
+	parents.reserve((size_t)((task.rootIndex - task.firstIndex) / 2));
+	AddSubtreeParents(hashes, task.firstIndex, task.rootIndex, task.height, parents);
+
+	return ValidateParentHashes(parents);
+}
+
+void MMRHashValidator::AddSubtreeParents(
+	const std::vector<uint8_t>& hashes,
+	const uint64_t firstIndex,
+	const uint64_t rootIndex,
+	const uint64_t height,
+	std::vector<Parent>& parents)
+{
+	if (height == 0)
+	{
+		return;
+	}
+
+	const uint64_t leftIndex = MMRUtil::GetLeftChildIndex(rootIndex, height);
+	const uint64_t rightIndex = MMRUtil::GetRightChildIndex(rootIndex);
+	AddSubtreeParents(hashes, firstIndex, leftIndex, height - 1, parents);
+	AddSubtreeParents(hashes, firstIndex, rightIndex, height - 1, parents);
+
+	parents.push_back(Parent{
+		hashes.data() + ((rootIndex - firstIndex) * HASH_SIZE),
+		hashes.data() + ((leftIndex - firstIndex) * HASH_SIZE),
+		hashes.data() + ((rightIndex - firstIndex) * HASH_SIZE),
+		rootIndex
+	});
+}
+
+bool MMRHashValidator::ValidateParents(const Task& task)
+{
+	// Each parent's hashes, in the order parent, left, right.
+	std::vector<uint8_t> hashes(task.parentIndices.size() * 3 * HASH_SIZE);
+	std::vector<Parent> parents;
+	parents.reserve(task.parentIndices.size());
+
+	for (size_t i = 0; i < task.parentIndices.size(); i++)
+	{
+		const uint64_t parentIndex = task.parentIndices[i];
+		const uint64_t height = MMRUtil::GetHeight(parentIndex);
+
+		// The right child immediately precedes its parent, so both can be read at once.
+		const std::vector<uint8_t> rightAndParent = task.pMMR->GetHashes(MMRUtil::GetRightChildIndex(parentIndex), parentIndex);
+		const std::vector<uint8_t> left = task.pMMR->GetHashes(
+			MMRUtil::GetLeftChildIndex(parentIndex, height),
+			MMRUtil::GetLeftChildIndex(parentIndex, height)
+		);
+
+		uint8_t* pParent = hashes.data() + (i * 3 * HASH_SIZE);
+		std::copy(rightAndParent.cbegin() + HASH_SIZE, rightAndParent.cend(), pParent);
+		std::copy(left.cbegin(), left.cend(), pParent + HASH_SIZE);
+		std::copy(rightAndParent.cbegin(), rightAndParent.cbegin() + HASH_SIZE, pParent + (2 * HASH_SIZE));
+
+		parents.push_back(Parent{ pParent, pParent + HASH_SIZE, pParent + (2 * HASH_SIZE), parentIndex });
+	}
+
+	return ValidateParentHashes(parents);
+}
+
+bool MMRHashValidator::ValidateParentHashes(const std::vector<Parent>& parents)
+{
+	auto isPruned = [](const uint8_t* pHash) {
+		return std::all_of(pHash, pHash + HASH_SIZE, [](const uint8_t byte) { return byte == 0; });
+	};
+
+	// Same layout as MMRHashUtil::HashParentWithIndex (big-endian index, left, right).
+	static const size_t PREIMAGE_SIZE = 8 + (2 * HASH_SIZE);
+
+	std::vector<const Parent*> unpruned;
+	unpruned.reserve(parents.size());
+	for (const Parent& parent : parents)
+	{
+		if (!isPruned(parent.pParent) && !isPruned(parent.pLeft) && !isPruned(parent.pRight))
+		{
+			unpruned.push_back(&parent);
+		}
+	}
+
+	std::vector<uint8_t> preimages(unpruned.size() * PREIMAGE_SIZE);
+	std::vector<std::pair<const uint8_t*, size_t>> inputs;
+	inputs.reserve(unpruned.size());
+	for (size_t i = 0; i < unpruned.size(); i++)
+	{
+		uint8_t* pPreimage = preimages.data() + (i * PREIMAGE_SIZE);
+		for (size_t j = 0; j < 8; j++)
+		{
+			pPreimage[j] = (uint8_t)(unpruned[i]->parentIndex >> (8 * (7 - j)));
+		}
+
+		std::copy(unpruned[i]->pLeft, unpruned[i]->pLeft + HASH_SIZE, pPreimage + 8);
+		std::copy(unpruned[i]->pRight, unpruned[i]->pRight + HASH_SIZE, pPreimage + 8 + HASH_SIZE);
+		inputs.push_back({ pPreimage, PREIMAGE_SIZE });
+	}
+
+	std::vector<uint8_t> expectedHashes(unpruned.size() * HASH_SIZE);
+	Hasher::Blake2bBatch(inputs, expectedHashes.data());
+
+	for (size_t i = 0; i < unpruned.size(); i++)
+	{
+		if (std::memcmp(expectedHashes.data() + (i * HASH_SIZE), unpruned[i]->pParent, HASH_SIZE) != 0)
+		{
+			LOG_ERROR_F("Invalid parent hash at index ({})", unpruned[i]->parentIndex);
+			return false;
+		}
+	}
+
+	return true;
+}
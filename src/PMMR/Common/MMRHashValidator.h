@@ -0,0 +1,81 @@
+#pragma once
+
+#include "MMR.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//
+// Validates every parent hash of one or more MMRs across a pool of worker threads.
+//
+// Each MMR is split into fixed-height subtrees, which are independent of one another and are stored contiguously,
+// so they can be validated in parallel with a single hash file read per subtree.
+// The few nodes above the subtrees (within each peak) are validated separately once their children are known to be valid.
+//
+class MMRHashValidator
+{
+public:
+	// Subtrees of height 12 cover 8191 nodes (~256KB of hashes) each.
+	static constexpr uint64_t DEFAULT_SUBTREE_HEIGHT = 12;
+
+	MMRHashValidator(const size_t numThreads, const uint64_t subtreeHeight = DEFAULT_SUBTREE_HEIGHT)
+		: m_numThreads(numThreads == 0 ? 1 : numThreads), m_subtreeHeight(subtreeHeight) { }
+
+	//
+	// Returns true if every unpruned parent in every MMR matches the hash of its children.
+	// Validation stops early once any invalid hash is found.
+	//
+	bool Validate(const std::vector<std::shared_ptr<const MMR>>& mmrs) const;
+
+private:
+	struct Task
+	{
+		std::shared_ptr<const MMR> pMMR;
+
+		// Subtree tasks validate every parent in [firstIndex, rootIndex].
+		uint64_t firstIndex;
+		uint64_t rootIndex;
+		uint64_t height;
+
+		// Upper tasks validate each listed parent individually.
+		std::vector<uint64_t> parentIndices;
+	};
+
+	void AddTasks(
+		const std::shared_ptr<const MMR>& pMMR,
+		const uint64_t peakIndex,
+		const uint64_t height,
+		std::vector<Task>& subtreeTasks,
+		std::vector<uint64_t>& upperIndices
+	) const;
+
+	// A parent to validate, pointing into hashes read by its task.
+	struct Parent
+	{
+		const uint8_t* pParent;
+		const uint8_t* pLeft;
+		const uint8_t* pRight;
+		uint64_t parentIndex;
+	};
+
+	bool RunTasks(const std::vector<Task>& tasks) const;
+
+	static bool ValidateSubtree(const Task& task);
+	static void AddSubtreeParents(
+		const std::vector<uint8_t>& hashes,
+		const uint64_t firstIndex,
+		const uint64_t rootIndex,
+		const uint64_t height,
+		std::vector<Parent>& parents
+	);
+	static bool ValidateParents(const Task& task);
+
+	//
+	// Hashes every unpruned parent's children in one batch, so they're hashed several at a time where the cpu allows.
+	//
+	static bool ValidateParentHashes(const std::vector<Parent>& parents);
+
+	size_t m_numThreads;
+	uint64_t m_subtreeHeight;
+};
@@ -0,0 +1,56 @@
+#include "MMRRootTracker.h"
+#include "MMRUtil.h"
+#include "MMRHashUtil.h"
+
+Hash MMRRootTracker::Root(const uint64_t size)
+{
+	if (size == 0)
+	{
+		return ZERO_HASH;
+	}
+
+	UpdatePeaks(size);
+
+	// Bag the peaks from right to left, skipping pruned peaks, exactly as MMRHashUtil::Root does.
+	Hash hash = ZERO_HASH;
+	for (auto iter = m_peaks.crbegin(); iter != m_peaks.crend(); iter++)
+	{
+		if (iter->hash != ZERO_HASH)
+		{
+			if (hash == ZERO_HASH)
+			{
+				hash = iter->hash;
+			}
+			else
+			{
+				hash = MMRHashUtil::HashParentWithIndex(iter->hash, hash, size);
+			}
+		}
+	}
+
+	return hash;
+}
+
+void MMRRootTracker::UpdatePeaks(const uint64_t size)
+{
+	const MMRUtil::Peaks peaks = MMRUtil::GetPeaks(size);
+
+	// Keep the leading peaks that are unchanged, since a node's hash never changes once it exists.
+	auto iter = peaks.begin();
+	size_t numUnchanged = 0;
+	while (numUnchanged < m_peaks.size()
+		&& iter != peaks.end()
+		&& m_peaks[numUnchanged].mmrIndex == *iter)
+	{
+		++numUnchanged;
+		++iter;
+	}
+
+	m_peaks.resize(numUnchanged, Peak{ 0, ZERO_HASH });
+
+	for (; iter != peaks.end(); iter++)
+	{
+		std::unique_ptr<Hash> pHash = m_pMMR->GetHashAt(*iter);
+		m_peaks.emplace_back(Peak{ *iter, pHash != nullptr ? *pHash : ZERO_HASH });
+	}
+}
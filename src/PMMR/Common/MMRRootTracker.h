@@ -0,0 +1,39 @@
+#pragma once
+
+#include "MMR.h"
+
+#include <Crypto/Hash.h>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+//
+// Calculates MMR roots for a sequence of sizes, keeping the peaks from the previous size.
+//
+// Consecutive sizes share most of their peaks, so only the peaks that changed are read from the MMR.
+// When sizes are visited in ascending order (e.g. once per header), the peak reads amount to a single forward pass over the hash file.
+//
+class MMRRootTracker
+{
+public:
+	MMRRootTracker(std::shared_ptr<const MMR> pMMR)
+		: m_pMMR(pMMR) { }
+
+	//
+	// Returns the same hash as MMR::Root(size).
+	// Sizes may be given in any order, but ascending order reads the fewest peaks.
+	//
+	Hash Root(const uint64_t size);
+
+private:
+	struct Peak
+	{
+		uint64_t mmrIndex;
+		Hash hash;
+	};
+
+	void UpdatePeaks(const uint64_t size);
+
+	std::shared_ptr<const MMR> m_pMMR;
+	std::vector<Peak> m_peaks;
+};
@@ -1,23 +1,261 @@
 #pragma once
 
+#include <Common/Util/BitUtil.h>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <vector>
 
+//
+// Index arithmetic for MMRs, whose nodes are numbered by their zero-based postorder traversal index (mmrIndex).
+// An MMR with L leaves has 2L - popcount(L) nodes, and a peak of height h for each bit h set in L,
+// so everything here is a few popcount/clz operations, and (besides GetPeakIndices) constexpr and allocation-free.
+//
+// Height      Index
+//
+// 2:            6
+// 1:         2     5
+// 0:       0   1 3   4
+//
 class MMRUtil
 {
 public:
-	static uint64_t GetHeight(const uint64_t mmrIndex);
-	static uint64_t GetParentIndex(const uint64_t mmrIndex);
-	static uint64_t GetSiblingIndex(const uint64_t mmrIndex);
-	static uint64_t GetLeftChildIndex(const uint64_t mmrIndex, const uint64_t height);
-	static uint64_t GetRightChildIndex(const uint64_t mmrIndex);
+	//
+	// Iterates over the peaks of an MMR, yielding the mmrIndex of each.
+	// Left to right visits the tallest peak first, and right to left the order peaks are bagged in.
+	//
+	template<bool RIGHT_TO_LEFT>
+	class PeakIterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = uint64_t;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const uint64_t*;
+		using reference = uint64_t;
+
+		// leafBits has a bit set for the height of each peak not yet visited.
+		// offset is the number of nodes before the current peak (left to right), or up to and including it (right to left).
+		constexpr PeakIterator(const uint64_t leafBits, const uint64_t offset) noexcept
+			: m_leafBits(leafBits), m_offset(offset) { }
+
+		constexpr uint64_t GetHeight() const noexcept
+		{
+			if constexpr (RIGHT_TO_LEFT)
+			{
+				return BitUtil::GetLowestBit(m_leafBits);
+			}
+			else
+			{
+				return BitUtil::GetHighestBit(m_leafBits);
+			}
+		}
+
+		constexpr uint64_t operator*() const noexcept
+		{
+			if constexpr (RIGHT_TO_LEFT)
+			{
+				return m_offset - 1;
+			}
+			else
+			{
+				return m_offset + GetPeakSize() - 1;
+			}
+		}
+
+		constexpr PeakIterator& operator++() noexcept
+		{
+			if constexpr (RIGHT_TO_LEFT)
+			{
+				m_offset -= GetPeakSize();
+			}
+			else
+			{
+				m_offset += GetPeakSize();
+			}
+
+			m_leafBits &= ~(1ULL << GetHeight());
+			return *this;
+		}
+
+		constexpr PeakIterator operator++(int) noexcept
+		{
+			PeakIterator prev = *this;
+			++(*this);
+			return prev;
+		}
+
+		constexpr bool operator==(const PeakIterator& other) const noexcept { return m_leafBits == other.m_leafBits; }
+		constexpr bool operator!=(const PeakIterator& other) const noexcept { return m_leafBits != other.m_leafBits; }
+
+	private:
+		constexpr uint64_t GetPeakSize() const noexcept { return (2ULL << GetHeight()) - 1; }
+
+		uint64_t m_leafBits;
+		uint64_t m_offset;
+	};
+
+	//
+	// The peaks of an MMR with the given size (# of nodes), without allocating.
+	// Has no peaks when the size does not represent a complete MMR (ie. siblings exist, but no parent).
+	//
+	class Peaks
+	{
+	public:
+		constexpr explicit Peaks(const uint64_t size) noexcept
+			: m_size(size), m_leafBits(GetLeafIndex(size))
+		{
+			if (GetPMMRIndex(m_leafBits) != size)
+			{
+				m_leafBits = 0;
+			}
+		}
+
+		constexpr PeakIterator<false> begin() const noexcept { return PeakIterator<false>(m_leafBits, 0); }
+		constexpr PeakIterator<false> end() const noexcept { return PeakIterator<false>(0, m_size); }
+		constexpr PeakIterator<true> rbegin() const noexcept { return PeakIterator<true>(m_leafBits, m_size); }
+		constexpr PeakIterator<true> rend() const noexcept { return PeakIterator<true>(0, 0); }
+
+		constexpr size_t size() const noexcept { return BitUtil::CountBitsSet(m_leafBits); }
+		constexpr bool empty() const noexcept { return m_leafBits == 0; }
+
+	private:
+		uint64_t m_size;
+		uint64_t m_leafBits;
+	};
+
+	//
+	// Calculates the height of the node at the given position (mmrIndex).
+	// Jumps left to the same height in the leftmost (perfect) subtree until reaching its root, whose 1-based index is all ones.
+	//
+	static constexpr uint64_t GetHeight(const uint64_t mmrIndex) noexcept
+	{
+		uint64_t position = mmrIndex + 1;
+		while ((position & (position + 1)) != 0)
+		{
+			position -= (1ULL << BitUtil::GetHighestBit(position)) - 1;
+		}
+
+		return BitUtil::GetHighestBit(position);
+	}
+
+	static constexpr uint64_t GetParentIndex(const uint64_t mmrIndex) noexcept
+	{
+		const uint64_t height = GetHeight(mmrIndex);
+
+		if (GetHeight(mmrIndex + 1) == (height + 1))
+		{
+			// mmrIndex points to a right sibling, so the next node is the parent.
+			return mmrIndex + 1;
+		}
+		else
+		{
+			// mmrIndex is the left sibling, so the parent node is mmrIndex + 2^(height + 1).
+			return mmrIndex + (1ULL << (height + 1));
+		}
+	}
+
+	static constexpr uint64_t GetSiblingIndex(const uint64_t mmrIndex) noexcept
+	{
+		const uint64_t height = GetHeight(mmrIndex);
+
+		if (GetHeight(mmrIndex + 1) == (height + 1))
+		{
+			// mmrIndex points to a right sibling, so add 1 and subtract 2^(height + 1) to get the left sibling.
+			return mmrIndex + 1 - (1ULL << (height + 1));
+		}
+		else
+		{
+			// mmrIndex is the left sibling, so add 2^(height + 1) - 1 to get the right sibling.
+			return mmrIndex + (1ULL << (height + 1)) - 1;
+		}
+	}
+
+	// WARNING: Assumes mmrIndex is a parent.
+	static constexpr uint64_t GetLeftChildIndex(const uint64_t mmrIndex, const uint64_t height) noexcept
+	{
+		return mmrIndex - (1ULL << height);
+	}
+
+	// WARNING: Assumes mmrIndex is a parent.
+	static constexpr uint64_t GetRightChildIndex(const uint64_t mmrIndex) noexcept
+	{
+		return mmrIndex - 1;
+	}
+
+	//
+	// Calculates the postorder traversal index of all peaks in an MMR with the given size (# of nodes).
+	// Returns empty when the size does not represent a complete MMR (ie. siblings exist, but no parent).
+	// Prefer iterating over GetPeaks(size), which doesn't allocate.
+	//
 	static std::vector<uint64_t> GetPeakIndices(const uint64_t size);
-	static uint64_t GetNumNodes(const uint64_t mmrIndex);
-	static uint64_t GetNumLeaves(const uint64_t lastMMRIndex);
-	static bool IsLeaf(const uint64_t mmrIndex);
-	static uint64_t GetPMMRIndex(const uint64_t leafIndex);
-	static uint64_t GetLeafIndex(const uint64_t mmrIndex);
-
-private:
-	static std::vector<uint64_t> GetPeakSizes(const uint64_t size);
-};
\ No newline at end of file
+	static constexpr Peaks GetPeaks(const uint64_t size) noexcept { return Peaks(size); }
+
+	//
+	// The size of the smallest complete MMR containing the given node, ie. the node and all of the parents completed by it.
+	//
+	static constexpr uint64_t GetNumNodes(const uint64_t mmrIndex) noexcept
+	{
+		uint64_t numNodes = mmrIndex;
+		uint64_t height = GetHeight(numNodes);
+		uint64_t nextNodeHeight = GetHeight(++numNodes);
+		while (nextNodeHeight > height)
+		{
+			height = nextNodeHeight;
+			nextNodeHeight = GetHeight(++numNodes);
+		}
+
+		return numNodes;
+	}
+
+	//
+	// The number of leaves up to and including the given node, ie. one more than the leaf index of the last leaf under it.
+	// A node's right child is the node just before it, so that leaf is height nodes before it.
+	//
+	static constexpr uint64_t GetNumLeaves(const uint64_t lastMMRIndex) noexcept
+	{
+		// The last index of an empty MMR (size - 1) wraps around.
+		if (lastMMRIndex == UINT64_MAX)
+		{
+			return 0;
+		}
+
+		return GetLeafIndex(lastMMRIndex - GetHeight(lastMMRIndex)) + 1;
+	}
+
+	static constexpr bool IsLeaf(const uint64_t mmrIndex) noexcept
+	{
+		return GetHeight(mmrIndex) == 0;
+	}
+
+	static constexpr uint64_t GetPMMRIndex(const uint64_t leafIndex) noexcept
+	{
+		return (2 * leafIndex) - BitUtil::CountBitsSet(leafIndex);
+	}
+
+	//
+	// The number of leaves in the peaks that fit in the first position nodes, tallest first, with each peak shorter than the last.
+	// For a leaf, that's its leaf index, and for a complete MMR size, its number of leaves.
+	//
+	static constexpr uint64_t GetLeafIndex(const uint64_t position) noexcept
+	{
+		uint64_t leafIndex = 0;
+		uint64_t numLeft = position;
+		uint64_t maxHeight = 64;
+		while (numLeft > 0 && maxHeight > 0)
+		{
+			// The tallest peak that fits has 2^(height + 1) - 1 nodes.
+			uint64_t height = BitUtil::GetHighestBit(numLeft + 1) - 1;
+			if (height >= maxHeight)
+			{
+				height = maxHeight - 1;
+			}
+
+			leafIndex += (1ULL << height);
+			numLeft -= (2ULL << height) - 1;
+			maxHeight = height;
+		}
+
+		return leafIndex;
+	}
+};
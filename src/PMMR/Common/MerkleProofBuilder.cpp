@@ -0,0 +1,242 @@
+#include "MerkleProofBuilder.h"
+#include "MMRHashUtil.h"
+#include "MMRUtil.h"
+
+#include <Core/Exceptions/TxHashSetException.h>
+#include <Common/Util/StringUtil.h>
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+MerkleProof MerkleProofBuilder::BuildProof(const MMR& mmr, const uint64_t mmrIndex, const uint64_t mmrSize) const
+{
+	const MMRUtil::Peaks peaks = MMRUtil::GetPeaks(mmrSize);
+	if (mmrIndex >= mmrSize || peaks.empty() || !MMRUtil::IsLeaf(mmrIndex))
+	{
+		throw TXHASHSET_EXCEPTION(StringUtil::Format("Leaf {} not in MMR of size {}", mmrIndex, mmrSize));
+	}
+
+	// The leaf is under the first peak at or after it.
+	std::vector<uint64_t> peakIndices;
+	peakIndices.reserve(peaks.size());
+	uint64_t peakIndex = 0;
+	uint64_t peakHeight = 0;
+	for (auto iter = peaks.begin(); iter != peaks.end(); iter++)
+	{
+		if (*iter >= mmrIndex && (peakIndices.empty() || peakIndices.back() < mmrIndex))
+		{
+			peakIndex = *iter;
+			peakHeight = iter.GetHeight();
+		}
+
+		peakIndices.push_back(*iter);
+	}
+
+	std::vector<Hash> path;
+	path.reserve(peakHeight + peakIndices.size());
+
+	// The siblings below CACHED_HEIGHT (or below the peak, if it's shorter) are all within the leaf's subtree of that height.
+	const uint64_t lowerHeight = std::min(peakHeight, CACHED_HEIGHT);
+	uint64_t subtreeRoot = mmrIndex;
+	for (uint64_t height = 0; height < lowerHeight; height++)
+	{
+		subtreeRoot = MMRUtil::GetParentIndex(subtreeRoot);
+	}
+
+	const uint64_t subtreeFirst = subtreeRoot + 2 - (2ULL << lowerHeight);
+	const std::vector<uint8_t> subtreeHashes = mmr.GetHashes(subtreeFirst, subtreeRoot);
+
+	uint64_t node = mmrIndex;
+	for (uint64_t height = 0; height < lowerHeight; height++)
+	{
+		const uint64_t siblingIndex = MMRUtil::GetSiblingIndex(node);
+		Hash sibling(subtreeHashes.data() + ((siblingIndex - subtreeFirst) * HASH_SIZE));
+		if (sibling == ZERO_HASH)
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Hash missing at {}", siblingIndex));
+		}
+
+		path.emplace_back(std::move(sibling));
+		node = MMRUtil::GetParentIndex(node);
+	}
+
+	if (peakHeight > lowerHeight)
+	{
+		std::shared_ptr<const CachedPeak> pPeak = GetCachedPeak(mmr, peakIndex, peakHeight, GetHash(mmr, peakIndex), peakIndices);
+		for (uint64_t height = lowerHeight; height < peakHeight; height++)
+		{
+			const uint64_t siblingIndex = MMRUtil::GetSiblingIndex(node);
+			auto iter = pPeak->upperHashes.find(siblingIndex);
+			if (iter == pPeak->upperHashes.end())
+			{
+				throw TXHASHSET_EXCEPTION(StringUtil::Format("Hash missing at {}", siblingIndex));
+			}
+
+			path.push_back(iter->second);
+			node = MMRUtil::GetParentIndex(node);
+		}
+	}
+
+	// The peaks to the right are bagged the same way as MMRHashUtil::Root does.
+	auto peakIter = peaks.rbegin();
+	Hash rightPeaks = ZERO_HASH;
+	for (; *peakIter != peakIndex; peakIter++)
+	{
+		const Hash peakHash = GetHash(mmr, *peakIter);
+		rightPeaks = rightPeaks == ZERO_HASH ? peakHash : MMRHashUtil::HashParentWithIndex(peakHash, rightPeaks, mmrSize);
+	}
+
+	if (rightPeaks != ZERO_HASH)
+	{
+		path.emplace_back(std::move(rightPeaks));
+	}
+
+	// Followed by each of the peaks to the left, nearest first.
+	for (peakIter++; peakIter != peaks.rend(); peakIter++)
+	{
+		path.emplace_back(GetHash(mmr, *peakIter));
+	}
+
+	return MerkleProof(mmrSize, std::move(path));
+}
+
+Hash MerkleProofBuilder::CalculateRoot(const MerkleProof& proof, const Hash& leafHash, const uint64_t mmrIndex)
+{
+	const uint64_t mmrSize = proof.GetMMRSize();
+	const MMRUtil::Peaks peaks = MMRUtil::GetPeaks(mmrSize);
+	if (mmrIndex >= mmrSize || peaks.empty() || !MMRUtil::IsLeaf(mmrIndex))
+	{
+		return ZERO_HASH;
+	}
+
+	// The leaf is under the first peak at or after it.
+	uint64_t peakHeight = 0;
+	size_t numLeftPeaks = 0;
+	bool foundPeak = false;
+	bool hasRightPeaks = false;
+	for (auto iter = peaks.begin(); iter != peaks.end(); iter++)
+	{
+		if (*iter < mmrIndex)
+		{
+			++numLeftPeaks;
+		}
+		else if (!foundPeak)
+		{
+			peakHeight = iter.GetHeight();
+			foundPeak = true;
+		}
+		else
+		{
+			hasRightPeaks = true;
+		}
+	}
+
+	const std::vector<Hash>& path = proof.GetPath();
+	if (path.size() != peakHeight + (hasRightPeaks ? 1 : 0) + numLeftPeaks)
+	{
+		return ZERO_HASH;
+	}
+
+	auto pathIter = path.cbegin();
+	Hash hash = leafHash;
+	uint64_t node = mmrIndex;
+	for (uint64_t height = 0; height < peakHeight; height++)
+	{
+		// A right child's parent is the node just after it.
+		const uint64_t parentIndex = MMRUtil::GetParentIndex(node);
+		if (parentIndex == node + 1)
+		{
+			hash = MMRHashUtil::HashParentWithIndex(*pathIter++, hash, parentIndex);
+		}
+		else
+		{
+			hash = MMRHashUtil::HashParentWithIndex(hash, *pathIter++, parentIndex);
+		}
+
+		node = parentIndex;
+	}
+
+	if (hasRightPeaks)
+	{
+		hash = MMRHashUtil::HashParentWithIndex(hash, *pathIter++, mmrSize);
+	}
+
+	for (; pathIter != path.cend(); pathIter++)
+	{
+		hash = MMRHashUtil::HashParentWithIndex(*pathIter, hash, mmrSize);
+	}
+
+	return hash;
+}
+
+std::shared_ptr<const MerkleProofBuilder::CachedPeak> MerkleProofBuilder::GetCachedPeak(
+	const MMR& mmr,
+	const uint64_t peakIndex,
+	const uint64_t peakHeight,
+	const Hash& peakHash,
+	const std::vector<uint64_t>& currentPeaks) const
+{
+	{
+		std::shared_lock<std::shared_mutex> readLock(m_mutex);
+		auto iter = m_peaks.find(peakIndex);
+		if (iter != m_peaks.end() && iter->second->peakHash == peakHash)
+		{
+			return iter->second;
+		}
+	}
+
+	// Built without holding the lock, so proofs under other peaks aren't held up.
+	// Concurrent misses for the same peak may each build it, but that only happens once per peak.
+	auto pPeak = std::make_shared<CachedPeak>();
+	pPeak->peakHash = peakHash;
+
+	std::vector<std::pair<uint64_t, uint64_t>> nodes{ { peakIndex, peakHeight } };
+	while (!nodes.empty())
+	{
+		const auto [index, height] = nodes.back();
+		nodes.pop_back();
+
+		// Everything below a missing (compacted) node is compacted too.
+		std::unique_ptr<Hash> pHash = mmr.GetHashAt(index);
+		if (pHash == nullptr)
+		{
+			continue;
+		}
+
+		pPeak->upperHashes.emplace(index, std::move(*pHash));
+		if (height > CACHED_HEIGHT)
+		{
+			nodes.emplace_back(MMRUtil::GetLeftChildIndex(index, height), height - 1);
+			nodes.emplace_back(MMRUtil::GetRightChildIndex(index), height - 1);
+		}
+	}
+
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	// Peaks the MMR has since grown (or rewound) past won't be asked for again.
+	for (auto iter = m_peaks.begin(); iter != m_peaks.end();)
+	{
+		if (std::find(currentPeaks.cbegin(), currentPeaks.cend(), iter->first) == currentPeaks.cend())
+		{
+			iter = m_peaks.erase(iter);
+		}
+		else
+		{
+			iter++;
+		}
+	}
+
+	m_peaks[peakIndex] = pPeak;
+	return pPeak;
+}
+
+Hash MerkleProofBuilder::GetHash(const MMR& mmr, const uint64_t mmrIndex)
+{
+	std::unique_ptr<Hash> pHash = mmr.GetHashAt(mmrIndex);
+	if (pHash == nullptr)
+	{
+		throw TXHASHSET_EXCEPTION(StringUtil::Format("Hash missing at {}", mmrIndex));
+	}
+
+	return *pHash;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "MMR.h"
+
+#include <Core/Models/MerkleProof.h>
+#include <Crypto/Hash.h>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+//
+// Builds merkle proofs for the leaves of an MMR.
+//
+// The siblings below CACHED_HEIGHT all lie within the leaf's subtree of that height, so they're read with a single contiguous read.
+// The nodes at or above CACHED_HEIGHT are kept in memory for each peak, keyed by the peak's hash, which commits to all of them,
+// so a peak stays cached until the MMR grows (or rewinds) past it. Only the tallest peaks have any such nodes,
+// and those change least often.
+//
+// Safe to call from any number of threads at once. Callers must keep the MMR from changing while a proof is built,
+// eg. by holding the chain state's read lock.
+//
+class MerkleProofBuilder
+{
+public:
+	// Subtrees of this height (2047 nodes, or 64KB of hashes) are read at once.
+	static constexpr uint64_t CACHED_HEIGHT = 10;
+
+	//
+	// Builds the proof of the leaf at mmrIndex in the MMR as of the given size.
+	// Throws a TxHashSetException if the leaf isn't in the MMR, or a hash along its path is missing.
+	//
+	MerkleProof BuildProof(const MMR& mmr, const uint64_t mmrIndex, const uint64_t mmrSize) const;
+
+	//
+	// Recalculates the root of the MMR from the leaf's hash and its proof, for comparing against the root from a header.
+	// Returns ZERO_HASH if the proof doesn't have the number of hashes expected for the leaf and MMR size.
+	//
+	static Hash CalculateRoot(const MerkleProof& proof, const Hash& leafHash, const uint64_t mmrIndex);
+
+private:
+	struct CachedPeak
+	{
+		Hash peakHash;
+		std::unordered_map<uint64_t, Hash> upperHashes;
+	};
+
+	std::shared_ptr<const CachedPeak> GetCachedPeak(
+		const MMR& mmr,
+		const uint64_t peakIndex,
+		const uint64_t peakHeight,
+		const Hash& peakHash,
+		const std::vector<uint64_t>& currentPeaks
+	) const;
+
+	static Hash GetHash(const MMR& mmr, const uint64_t mmrIndex);
+
+	mutable std::shared_mutex m_mutex;
+	mutable std::unordered_map<uint64_t, std::shared_ptr<const CachedPeak>> m_peaks;
+};
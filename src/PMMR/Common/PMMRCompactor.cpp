@@ -0,0 +1,319 @@
+#include "PMMRCompactor.h"
+#include "MMRUtil.h"
+
+#include <Core/Exceptions/FileException.h>
+#include <Common/Util/FileUtil.h>
+#include <Common/Util/StringUtil.h>
+#include <Common/Logger.h>
+#include <Crypto/Hash.h>
+#include <algorithm>
+#include <sstream>
+
+static const std::string COMPACTED_EXTENSION = ".compact";
+
+PMMRCompactor::PMMRCompactor(
+	const fs::path& hashPath,
+	const fs::path& dataPath,
+	const size_t dataSize,
+	const std::shared_ptr<const PruneList>& pPruneList,
+	Roaring&& unspentAtHorizon,
+	const uint64_t horizonSize)
+	: m_hashPath(hashPath),
+	m_dataPath(dataPath),
+	m_compactedHashPath(fs::path(hashPath) += COMPACTED_EXTENSION),
+	m_compactedDataPath(fs::path(dataPath) += COMPACTED_EXTENSION),
+	m_compactedPruneListPath(fs::path(pPruneList->GetFilePath()) += COMPACTED_EXTENSION),
+	m_dataSize(dataSize),
+	m_pPruneList(pPruneList),
+	m_unspentAtHorizon(std::move(unspentAtHorizon)),
+	m_horizonSize(horizonSize),
+	m_numPrunedLeaves(0),
+	m_pCompactedPruneList(nullptr),
+	m_committed(false)
+{
+
+}
+
+PMMRCompactor::~PMMRCompactor()
+{
+	// Once swapped in, the compacted files are gone. If the swap didn't finish, the manifest still needs them.
+	if (m_committed)
+	{
+		return;
+	}
+
+	for (const auto& staged : GetStagedFiles())
+	{
+		if (FileUtil::Exists(staged.first))
+		{
+			FileUtil::RemoveFile(staged.first);
+		}
+	}
+}
+
+void PMMRCompactor::Build()
+{
+	std::vector<uint64_t> leavesToPrune;
+	const uint64_t numLeaves = MMRUtil::GetNumLeaves(m_horizonSize - 1);
+	for (uint64_t leafIndex = 0; leafIndex < numLeaves; leafIndex++)
+	{
+		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(leafIndex);
+		if (!m_unspentAtHorizon.contains((uint32_t)(mmrIndex + 1)) && !m_pPruneList->IsPruned(mmrIndex))
+		{
+			leavesToPrune.push_back(mmrIndex);
+		}
+	}
+
+	m_numPrunedLeaves = leavesToPrune.size();
+	if (leavesToPrune.empty())
+	{
+		return;
+	}
+
+	m_pCompactedPruneList = m_pPruneList->WithPrunedLeaves(leavesToPrune);
+
+	{
+		std::ifstream input(m_hashPath, std::ios::in | std::ios::binary);
+		std::ofstream output(m_compactedHashPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!input.is_open() || !output.is_open())
+		{
+			throw FILE_EXCEPTION_F("Failed to open {} for compaction", m_hashPath);
+		}
+
+		ForEachKeptHash([this, &input, &output](const uint64_t first, const uint64_t end) {
+			const uint64_t position = first - m_pPruneList->GetShift(first);
+			CopyRange(input, output, position * HASH_SIZE, (end - first) * HASH_SIZE);
+		});
+	}
+
+	{
+		std::ifstream input(m_dataPath, std::ios::in | std::ios::binary);
+		std::ofstream output(m_compactedDataPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!input.is_open() || !output.is_open())
+		{
+			throw FILE_EXCEPTION_F("Failed to open {} for compaction", m_dataPath);
+		}
+
+		ForEachKeptLeaf([this, &input, &output](const uint64_t first, const uint64_t end) {
+			const uint64_t position = first - m_pPruneList->GetLeafShift(MMRUtil::GetPMMRIndex(first));
+			CopyRange(input, output, position * m_dataSize, (end - first) * m_dataSize);
+		});
+	}
+}
+
+void PMMRCompactor::Finish(const std::vector<uint8_t>& hashSuffix, const std::vector<uint8_t>& dataSuffix)
+{
+	std::ofstream hashOutput(m_compactedHashPath, std::ios::out | std::ios::binary | std::ios::app);
+	std::ofstream dataOutput(m_compactedDataPath, std::ios::out | std::ios::binary | std::ios::app);
+	if (!hashOutput.is_open() || !dataOutput.is_open())
+	{
+		throw FILE_EXCEPTION_F("Failed to open compacted files for {}", m_hashPath);
+	}
+
+	hashOutput.write((const char*)hashSuffix.data(), hashSuffix.size());
+	dataOutput.write((const char*)dataSuffix.data(), dataSuffix.size());
+	hashOutput.close();
+	dataOutput.close();
+	if (hashOutput.fail() || dataOutput.fail())
+	{
+		throw FILE_EXCEPTION_F("Failed to write compacted files for {}", m_hashPath);
+	}
+
+	m_pCompactedPruneList->Write(m_compactedPruneListPath);
+}
+
+PMMRCompactor::StagedFiles PMMRCompactor::GetStagedFiles() const
+{
+	return {
+		{ m_compactedHashPath, m_hashPath },
+		{ m_compactedDataPath, m_dataPath },
+		{ m_compactedPruneListPath, m_pPruneList->GetFilePath() }
+	};
+}
+
+void PMMRCompactor::WriteManifest(const fs::path& manifestPath, const std::vector<const PMMRCompactor*>& compactors)
+{
+	const fs::path directory = manifestPath.parent_path();
+
+	std::string manifest;
+	for (const PMMRCompactor* pCompactor : compactors)
+	{
+		if (pCompactor->IsEmpty())
+		{
+			continue;
+		}
+
+		for (const auto& staged : pCompactor->GetStagedFiles())
+		{
+			manifest += staged.first.lexically_relative(directory).generic_u8string() + "\t";
+			manifest += staged.second.lexically_relative(directory).generic_u8string() + "\n";
+		}
+	}
+
+	// Written to a temporary file and renamed, so a partial manifest is never seen.
+	FileUtil::SafeWriteToFile(manifestPath, std::vector<uint8_t>(manifest.cbegin(), manifest.cend()));
+}
+
+void PMMRCompactor::Recover(const fs::path& manifestPath, const std::vector<fs::path>& stagingDirs)
+{
+	std::vector<uint8_t> bytes;
+	if (FileUtil::ReadFile(manifestPath, bytes))
+	{
+		const fs::path directory = manifestPath.parent_path();
+		std::istringstream manifest(std::string(bytes.cbegin(), bytes.cend()));
+
+		std::string line;
+		while (std::getline(manifest, line))
+		{
+			const size_t separator = line.find('\t');
+			if (separator == std::string::npos)
+			{
+				throw FILE_EXCEPTION_F("Invalid compaction manifest {}", manifestPath);
+			}
+
+			// Files already moved into place are no longer staged.
+			const fs::path stagedPath = directory / fs::u8path(line.substr(0, separator));
+			const fs::path currentPath = directory / fs::u8path(line.substr(separator + 1));
+			if (FileUtil::Exists(stagedPath))
+			{
+				LOG_INFO_F("Finishing interrupted compaction of {}", currentPath);
+				FileUtil::RenameFile(stagedPath, currentPath);
+			}
+		}
+
+		FileUtil::RemoveFile(manifestPath);
+		return;
+	}
+
+	std::vector<fs::path> uncommitted;
+	for (const fs::path& stagingDir : stagingDirs)
+	{
+		std::error_code ec;
+		for (const auto& entry : fs::directory_iterator(stagingDir, ec))
+		{
+			if (entry.path().extension() == COMPACTED_EXTENSION)
+			{
+				uncommitted.push_back(entry.path());
+			}
+		}
+	}
+
+	for (const fs::path& path : uncommitted)
+	{
+		LOG_INFO_F("Removing {} from an uncommitted compaction", path);
+		FileUtil::RemoveFile(path);
+	}
+}
+
+uint64_t PMMRCompactor::GetHashSuffixStart() const
+{
+	return m_horizonSize - m_pPruneList->GetShift(m_horizonSize - 1);
+}
+
+uint64_t PMMRCompactor::GetDataSuffixStart() const
+{
+	return MMRUtil::GetNumLeaves(m_horizonSize - 1) - m_pPruneList->GetLeafShift(m_horizonSize - 1);
+}
+
+uint64_t PMMRCompactor::GetNumRemovedHashes() const
+{
+	return IsEmpty() ? 0 : m_pCompactedPruneList->GetTotalShift() - m_pPruneList->GetTotalShift();
+}
+
+uint64_t PMMRCompactor::GetNumRemovedData() const
+{
+	if (IsEmpty())
+	{
+		return 0;
+	}
+
+	return m_pCompactedPruneList->GetLeafShift(m_horizonSize - 1) - m_pPruneList->GetLeafShift(m_horizonSize - 1);
+}
+
+//
+// The compacted prune list's roots are all below the horizon (an MMR of horizonSize contains the parent of any two of its nodes),
+// and each root's subtree is contiguous in postorder, ending at the root. So the kept hashes are the gaps between those subtrees,
+// plus the roots themselves. Roots that were already pruned are covered by the new ones, so each gap is contiguous in the current file too.
+//
+void PMMRCompactor::ForEachKeptHash(const CopyFunc& copy) const
+{
+	uint64_t nextIndex = 0;
+	const Roaring& prunedRoots = m_pCompactedPruneList->GetPrunedRoots();
+	for (auto iter = prunedRoots.begin(); iter != prunedRoots.end(); iter++)
+	{
+		const uint64_t rootIndex = *iter - 1;
+		const uint64_t height = MMRUtil::GetHeight(rootIndex);
+		if (height > 0)
+		{
+			const uint64_t firstIndex = rootIndex + 2 - (2ULL << height);
+			if (firstIndex > nextIndex)
+			{
+				copy(nextIndex, firstIndex);
+			}
+
+			nextIndex = rootIndex;
+		}
+	}
+
+	if (m_horizonSize > nextIndex)
+	{
+		copy(nextIndex, m_horizonSize);
+	}
+}
+
+//
+// Leaf data is only kept for leaves that aren't under a pruned root of height 1 or more (see PruneList::GetLeafShift).
+//
+void PMMRCompactor::ForEachKeptLeaf(const CopyFunc& copy) const
+{
+	uint64_t nextLeaf = 0;
+	const Roaring& prunedRoots = m_pCompactedPruneList->GetPrunedRoots();
+	for (auto iter = prunedRoots.begin(); iter != prunedRoots.end(); iter++)
+	{
+		const uint64_t rootIndex = *iter - 1;
+		const uint64_t height = MMRUtil::GetHeight(rootIndex);
+		if (height > 0)
+		{
+			const uint64_t firstLeaf = MMRUtil::GetLeafIndex(rootIndex + 2 - (2ULL << height));
+			if (firstLeaf > nextLeaf)
+			{
+				copy(nextLeaf, firstLeaf);
+			}
+
+			nextLeaf = firstLeaf + (1ULL << height);
+		}
+	}
+
+	const uint64_t numLeaves = MMRUtil::GetNumLeaves(m_horizonSize - 1);
+	if (numLeaves > nextLeaf)
+	{
+		copy(nextLeaf, numLeaves);
+	}
+}
+
+void PMMRCompactor::CopyRange(std::ifstream& input, std::ofstream& output, const uint64_t offset, const uint64_t numBytes)
+{
+	static const uint64_t CHUNK_SIZE = 1024 * 1024;
+
+	std::vector<char> buffer((size_t)(std::min)(numBytes, CHUNK_SIZE));
+	input.seekg((std::streamoff)offset);
+
+	uint64_t numCopied = 0;
+	while (numCopied < numBytes)
+	{
+		const uint64_t chunkSize = (std::min)(numBytes - numCopied, CHUNK_SIZE);
+		input.read(buffer.data(), (std::streamsize)chunkSize);
+		if ((uint64_t)input.gcount() != chunkSize)
+		{
+			throw FILE_EXCEPTION_F("Failed to read {} bytes at {} for compaction", chunkSize, offset + numCopied);
+		}
+
+		output.write(buffer.data(), (std::streamsize)chunkSize);
+		numCopied += chunkSize;
+	}
+
+	if (output.fail())
+	{
+		throw FILE_EXCEPTION("Failed to write compacted file");
+	}
+}
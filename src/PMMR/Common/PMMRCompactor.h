@@ -0,0 +1,114 @@
+#pragma once
+
+#include "PruneList.h"
+
+#include <Roaring.h>
+#include <filesystem.h>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//
+// Compacts a pruneable MMR up to a horizon, off to the side. Leaves spent before the horizon are added to a new prune list,
+// and the hash and data files are rewritten without the nodes and leaves that the new pruned roots make unnecessary.
+//
+// Nothing below the horizon changes once the chain is past it (only spending and appending happen above it),
+// so Build reads the flushed files directly and needs no lock. Finish then appends whatever is past the horizon,
+// which callers do under the write lock, right before swapping the compacted files in.
+//
+// The compacted files are staged next to the current ones, and only replace them once a manifest of them is written.
+// Until then, a crash leaves the current files untouched. Afterwards, Recover finishes moving the staged files into place.
+//
+class PMMRCompactor
+{
+public:
+	using UPtr = std::unique_ptr<PMMRCompactor>;
+
+	// Each staged file, paired with the current file it replaces.
+	using StagedFiles = std::vector<std::pair<fs::path, fs::path>>;
+
+	//
+	// unspentAtHorizon is the leafset as of the horizon (1-based mmr indices, as from LeafSet::ToRoaring),
+	// and horizonSize the size of the MMR as of the horizon.
+	//
+	PMMRCompactor(
+		const fs::path& hashPath,
+		const fs::path& dataPath,
+		const size_t dataSize,
+		const std::shared_ptr<const PruneList>& pPruneList,
+		Roaring&& unspentAtHorizon,
+		const uint64_t horizonSize
+	);
+	~PMMRCompactor();
+
+	//
+	// Finds the leaves to prune and, if there are any, writes the compacted files up to the horizon.
+	//
+	void Build();
+
+	//
+	// Appends the rest of the hashes and data (read from the current files, starting at GetHashSuffixStart and GetDataSuffixStart),
+	// and stages the compacted prune list.
+	//
+	void Finish(const std::vector<uint8_t>& hashSuffix, const std::vector<uint8_t>& dataSuffix);
+
+	//
+	// Called once the staged files are listed in a manifest. They're then left for Recover, rather than removed with the compactor.
+	//
+	void SetCommitted() noexcept { m_committed = true; }
+
+	//
+	// Lists the staged files of the non-empty compactors, which commits them: from then on, they replace the current files,
+	// either as the caller swaps them in, or through Recover if it crashes first. Paths are stored relative to the manifest.
+	//
+	static void WriteManifest(const fs::path& manifestPath, const std::vector<const PMMRCompactor*>& compactors);
+
+	//
+	// Moves any staged files that are still listed in the manifest into place, and removes the manifest.
+	// Without a manifest, nothing was committed, so any files staged in the directories are removed instead.
+	//
+	static void Recover(const fs::path& manifestPath, const std::vector<fs::path>& stagingDirs);
+
+	bool IsEmpty() const noexcept { return m_pCompactedPruneList == nullptr; }
+	uint64_t GetHorizonSize() const noexcept { return m_horizonSize; }
+	uint64_t GetNumPrunedLeaves() const noexcept { return m_numPrunedLeaves; }
+
+	// The positions (in entries, not bytes) in the current files where everything past the horizon starts.
+	uint64_t GetHashSuffixStart() const;
+	uint64_t GetDataSuffixStart() const;
+
+	// The number of entries removed from each file.
+	uint64_t GetNumRemovedHashes() const;
+	uint64_t GetNumRemovedData() const;
+
+	const fs::path& GetCompactedHashPath() const noexcept { return m_compactedHashPath; }
+	const fs::path& GetCompactedDataPath() const noexcept { return m_compactedDataPath; }
+	const fs::path& GetCompactedPruneListPath() const noexcept { return m_compactedPruneListPath; }
+	StagedFiles GetStagedFiles() const;
+	const std::shared_ptr<PruneList>& GetCompactedPruneList() const noexcept { return m_pCompactedPruneList; }
+
+private:
+	using CopyFunc = std::function<void(const uint64_t, const uint64_t)>;
+
+	// Calls copy with each range of positions [first, end) below the horizon that the compacted file keeps.
+	void ForEachKeptHash(const CopyFunc& copy) const;
+	void ForEachKeptLeaf(const CopyFunc& copy) const;
+
+	static void CopyRange(std::ifstream& input, std::ofstream& output, const uint64_t offset, const uint64_t numBytes);
+
+	fs::path m_hashPath;
+	fs::path m_dataPath;
+	fs::path m_compactedHashPath;
+	fs::path m_compactedDataPath;
+	fs::path m_compactedPruneListPath;
+	size_t m_dataSize;
+	std::shared_ptr<const PruneList> m_pPruneList;
+	Roaring m_unspentAtHorizon;
+	uint64_t m_horizonSize;
+
+	uint64_t m_numPrunedLeaves;
+	std::shared_ptr<PruneList> m_pCompactedPruneList;
+	bool m_committed;
+};
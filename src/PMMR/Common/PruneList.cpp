@@ -17,11 +17,7 @@ std::shared_ptr<PruneList> PruneList::Load(const fs::path& filePath)
 	if (FileUtil::ReadFile(filePath, data))
 	{
 		Roaring prunedRoots = Roaring::readSafe((const char*)&data[0], data.size());
-		PruneList* pPruneList = new PruneList(filePath, std::move(prunedRoots));
-		pPruneList->BuildPrunedCache();
-		pPruneList->BuildShiftCaches();
-
-		return std::shared_ptr<PruneList>(pPruneList);
+		return std::shared_ptr<PruneList>(new PruneList(filePath, std::move(prunedRoots)));
 	}
 	else
 	{
@@ -30,6 +26,11 @@ std::shared_ptr<PruneList> PruneList::Load(const fs::path& filePath)
 }
 
 void PruneList::Flush()
+{
+	Write(m_filePath);
+}
+
+void PruneList::Write(const fs::path& filePath)
 {
 	// Run the optimization step on the bitmap.
 	m_prunedRoots.runOptimize();
@@ -41,12 +42,7 @@ void PruneList::Flush()
 		std::vector<unsigned char> buffer(size);
 		m_prunedRoots.write((char*)&buffer[0]);
 
-		FileUtil::SafeWriteToFile(m_filePath, buffer);
-
-		// Rebuild our "shift caches" here as we are flushing changes to disk
-		// and the contents of our prune_list has likely changed.
-		BuildPrunedCache();
-		BuildShiftCaches();
+		FileUtil::SafeWriteToFile(filePath, buffer);
 	}
 }
 
@@ -54,6 +50,8 @@ void PruneList::Flush()
 // Compacts the list if pruning the additional node means a parent can get pruned as well.
 void PruneList::Add(const uint64_t position)
 {
+	EnsureCaches();
+
 	uint64_t currentIndex = position;
 	while (true)
 	{
@@ -71,10 +69,81 @@ void PruneList::Add(const uint64_t position)
 			break;
 		}
 	}
+
+	UpdateCaches(currentIndex);
+}
+
+// Every node in the new root's subtree is now pruned. Subtrees are contiguous in postorder, so only the cache entries
+// of the roots within it are recomputed, and the entries of the roots after it all move by the same amount.
+void PruneList::UpdateCaches(const uint64_t rootIndex)
+{
+	const uint64_t height = MMRUtil::GetHeight(rootIndex);
+	const uint64_t firstIndex = rootIndex + 2 - (2ULL << height);
+	m_prunedCache.addRange(firstIndex + 1, rootIndex + 2);
+
+	const uint64_t numBefore = m_prunedRoots.rank((uint32_t)firstIndex);
+	const uint64_t numThrough = m_prunedRoots.rank((uint32_t)(rootIndex + 1));
+	const uint64_t numAfter = m_prunedRoots.cardinality() - numThrough;
+	const uint64_t numReplaced = m_shiftCache.size() - numBefore - numAfter;
+
+	uint64_t shift = (numBefore > 0) ? m_shiftCache[numBefore - 1] : 0;
+	uint64_t leafShift = (numBefore > 0) ? m_leafShiftCache[numBefore - 1] : 0;
+	const uint64_t replacedShift = (numBefore + numReplaced > 0) ? m_shiftCache[numBefore + numReplaced - 1] : 0;
+	const uint64_t replacedLeafShift = (numBefore + numReplaced > 0) ? m_leafShiftCache[numBefore + numReplaced - 1] : 0;
+
+	std::vector<uint64_t> shifts;
+	std::vector<uint64_t> leafShifts;
+	for (uint64_t rank = numBefore; rank < numThrough; rank++)
+	{
+		uint32_t root = 0;
+		m_prunedRoots.select((uint32_t)rank, &root);
+
+		const uint64_t rootHeight = MMRUtil::GetHeight(root - 1);
+		shift += 2ULL * ((1ULL << rootHeight) - 1);
+		leafShift += (rootHeight == 0) ? 0 : 1ULL << rootHeight;
+		shifts.push_back(shift);
+		leafShifts.push_back(leafShift);
+	}
+
+	for (size_t i = numBefore + numReplaced; i < m_shiftCache.size(); i++)
+	{
+		m_shiftCache[i] = shift + (m_shiftCache[i] - replacedShift);
+		m_leafShiftCache[i] = leafShift + (m_leafShiftCache[i] - replacedLeafShift);
+	}
+
+	m_shiftCache.erase(m_shiftCache.begin() + numBefore, m_shiftCache.begin() + numBefore + numReplaced);
+	m_shiftCache.insert(m_shiftCache.begin() + numBefore, shifts.cbegin(), shifts.cend());
+	m_leafShiftCache.erase(m_leafShiftCache.begin() + numBefore, m_leafShiftCache.begin() + numBefore + numReplaced);
+	m_leafShiftCache.insert(m_leafShiftCache.begin() + numBefore, leafShifts.cbegin(), leafShifts.cend());
+}
+
+std::shared_ptr<PruneList> PruneList::WithPrunedLeaves(const std::vector<uint64_t>& leafIndices) const
+{
+	EnsureCaches();
+
+	Roaring prunedRoots = m_prunedRoots;
+	Roaring pruned = m_prunedCache;
+	for (const uint64_t leafIndex : leafIndices)
+	{
+		// Same as Add: merge with each pruned sibling on the way up.
+		uint64_t currentIndex = leafIndex;
+		pruned.add((uint32_t)(currentIndex + 1));
+		while (pruned.contains((uint32_t)(MMRUtil::GetSiblingIndex(currentIndex) + 1)))
+		{
+			prunedRoots.remove((uint32_t)(MMRUtil::GetSiblingIndex(currentIndex) + 1));
+			currentIndex = MMRUtil::GetParentIndex(currentIndex);
+			pruned.add((uint32_t)(currentIndex + 1));
+		}
+
+		prunedRoots.add((uint32_t)(currentIndex + 1));
+	}
+
+	return std::shared_ptr<PruneList>(new PruneList(m_filePath, std::move(prunedRoots)));
 }
 
 bool PruneList::IsPruned(const uint64_t position) const
 {
+	EnsureCaches();
 	return m_prunedCache.contains(position + 1);
 }
 
@@ -90,7 +159,8 @@ bool PruneList::IsCompacted(const uint64_t position) const
 
 uint64_t PruneList::GetTotalShift() const
 {
-	return GetShift(m_prunedRoots.maximum());
+	EnsureCaches();
+	return m_shiftCache.empty() ? 0 : m_shiftCache.back();
 }
 
 uint64_t PruneList::GetShift(const uint64_t position) const
@@ -100,6 +170,7 @@ uint64_t PruneList::GetShift(const uint64_t position) const
 		return 0;
 	}
 
+	EnsureCaches();
 	if (m_shiftCache.empty())
 	{
 		return 0;
@@ -134,6 +205,7 @@ uint64_t PruneList::GetLeafShift(const uint64_t position) const
 		return 0;
 	}
 
+	EnsureCaches();
 	if (m_leafShiftCache.empty())
 	{
 		return 0;
@@ -149,34 +221,35 @@ uint64_t PruneList::GetLeafShift(const uint64_t position) const
 	}
 }
 
-void PruneList::BuildPrunedCache()
+// Readers share the TxHashSet lock, so the first lookups may race to build the caches.
+void PruneList::EnsureCaches() const
+{
+	std::call_once(m_cachesBuilt, [this]() {
+		BuildPrunedCache();
+		BuildShiftCaches();
+	});
+}
+
+void PruneList::BuildPrunedCache() const
 {
 	if (m_prunedRoots.isEmpty())
 	{
 		return;
 	}
 
-	const uint64_t maximum = m_prunedRoots.maximum();
-	m_prunedCache = Roaring(roaring_bitmap_create_with_capacity(maximum));
-	for (uint64_t position = 0; position < maximum; position++)
+	// A position is pruned if it's in the subtree of any pruned root, and subtrees are contiguous in postorder.
+	m_prunedCache = Roaring();
+	for (auto iter = m_prunedRoots.begin(); iter != m_prunedRoots.end(); iter++)
 	{
-		uint64_t parent = position;
-		while (parent < maximum)
-		{
-			if (m_prunedRoots.contains(parent + 1))
-			{
-				m_prunedCache.add(position + 1);
-				break;
-			}
-
-			parent = MMRUtil::GetParentIndex(parent);
-		}
+		const uint64_t rootIndex = *iter - 1;
+		const uint64_t height = MMRUtil::GetHeight(rootIndex);
+		m_prunedCache.addRange(rootIndex + 3 - (2ULL << height), rootIndex + 2);
 	}
 
 	m_prunedCache.runOptimize();
 }
 
-void PruneList::BuildShiftCaches()
+void PruneList::BuildShiftCaches() const
 {
 	if (m_prunedRoots.isEmpty())
 	{
@@ -185,24 +258,19 @@ void PruneList::BuildShiftCaches()
 
 	m_shiftCache.clear();
 	m_leafShiftCache.clear();
+	m_shiftCache.reserve(m_prunedRoots.cardinality());
+	m_leafShiftCache.reserve(m_prunedRoots.cardinality());
 
-	// TODO: Use m_prunedRoots.iterate instead of looping through all values and checking contains.
-	const uint64_t maximum = m_prunedRoots.maximum();
-	for (uint64_t position = 0; position < maximum; position++)
+	uint64_t shift = 0;
+	uint64_t leafShift = 0;
+	for (auto iter = m_prunedRoots.begin(); iter != m_prunedRoots.end(); iter++)
 	{
-		if (m_prunedRoots.contains(position + 1))
-		{
-			const uint64_t height = MMRUtil::GetHeight(position);
+		const uint64_t height = MMRUtil::GetHeight(*iter - 1);
 
-			// Add to shift cache
-			const uint64_t previousShift = GetShift(position - 1);
-			const uint64_t currentShift = 2ULL * ((1ULL << height) - 1);
-			m_shiftCache.push_back(previousShift + currentShift);
+		shift += 2ULL * ((1ULL << height) - 1);
+		m_shiftCache.push_back(shift);
 
-			// Add to leaf shift cache
-			const uint64_t previousLeafShift = GetLeafShift(position - 1);
-			const uint64_t currentLeafShift = (height == 0) ? 0 : 1ULL << height;
-			m_leafShiftCache.push_back(previousLeafShift + currentLeafShift);
-		}
+		leafShift += (height == 0) ? 0 : 1ULL << height;
+		m_leafShiftCache.push_back(leafShift);
 	}
 }
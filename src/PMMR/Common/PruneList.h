@@ -6,8 +6,15 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
 #include <cstdint>
 
+//
+// Tracks the roots of pruned subtrees, along with how far each position is shifted by the pruned nodes before it.
+// The shifts are cached as running totals indexed by root rank, so each lookup is a single rank query.
+// Add updates the caches in place, which is O(1) when roots are added left to right, as they are when compacting.
+// The caches are built on first use rather than at load, so opening the TxHashSet doesn't wait on them.
+//
 class PruneList
 {
 public:
@@ -15,6 +22,11 @@ public:
 
 	void Flush();
 
+	// Writes the prune list to the given path instead of its own, eg. to stage a compacted copy.
+	void Write(const fs::path& filePath);
+
+	const fs::path& GetFilePath() const noexcept { return m_filePath; }
+
 	// Adds the node to the prune list.
 	// Compacts if pruning the node means a parent can get pruned as well.
 	void Add(const uint64_t mmrIndex);
@@ -31,16 +43,29 @@ public:
 	uint64_t GetShift(const uint64_t mmrIndex) const;
 	uint64_t GetLeafShift(const uint64_t mmrIndex) const;
 
+	// The 1-based mmr indices of the pruned roots.
+	const Roaring& GetPrunedRoots() const noexcept { return m_prunedRoots; }
+
+	//
+	// Returns a copy with the given leaves (ascending mmr indices) pruned, leaving this one untouched, eg. for compaction.
+	// Unlike calling Add for each leaf, only the roots are updated as leaves are added, and the copy's caches are built on first use.
+	//
+	std::shared_ptr<PruneList> WithPrunedLeaves(const std::vector<uint64_t>& leafIndices) const;
+
 private:
 	PruneList(const fs::path& filePath, Roaring&& prunedRoots);
 
-	void BuildPrunedCache();
-	void BuildShiftCaches();
+	void EnsureCaches() const;
+	void BuildPrunedCache() const;
+	void BuildShiftCaches() const;
+	void UpdateCaches(const uint64_t rootIndex);
 
 	fs::path m_filePath;
 
 	Roaring m_prunedRoots;
-	Roaring m_prunedCache;
-	std::vector<uint64_t> m_shiftCache;
-	std::vector<uint64_t> m_leafShiftCache;
+
+	mutable std::once_flag m_cachesBuilt;
+	mutable Roaring m_prunedCache;
+	mutable std::vector<uint64_t> m_shiftCache;
+	mutable std::vector<uint64_t> m_leafShiftCache;
 };
\ No newline at end of file
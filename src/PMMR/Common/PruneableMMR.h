@@ -7,6 +7,7 @@
 
 #include "MMRUtil.h"
 #include "MMRHashUtil.h"
+#include "PMMRCompactor.h"
 
 #include <Core/File/DataFile.h>
 #include <Roaring.h>
@@ -15,6 +16,9 @@
 #include <Core/Serialization/ByteBuffer.h>
 #include <Core/Traits/Lockable.h>
 #include <Common/Logger.h>
+#include <Common/ThreadPool.h>
+#include <algorithm>
+#include <utility>
 
 template<size_t DATA_SIZE, class DATA_TYPE>
 class PruneableMMR : public MMR, public Traits::IBatchable
@@ -53,6 +57,45 @@ public:
 		MMRHashUtil::AddHashes(m_pHashFile, serializer.GetBytes(), m_pPruneList);
 	}
 
+	//
+	// Appends all of the objects with one write each to the data and hash files.
+	//
+	void Append(const std::vector<DATA_TYPE>& objects)
+	{
+		if (objects.empty())
+		{
+			return;
+		}
+
+		SetDirty(true);
+
+		const uint64_t totalShift = m_pPruneList->GetTotalShift();
+		const uint64_t mmrIndex = m_pHashFile->GetSize() + totalShift;
+		const uint64_t firstLeafIndex = MMRUtil::GetLeafIndex(mmrIndex);
+
+		std::vector<std::vector<unsigned char>> serializedLeaves;
+		serializedLeaves.reserve(objects.size());
+
+		std::vector<unsigned char> data;
+		data.reserve(objects.size() * DATA_SIZE);
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			// Add to LeafSet
+			m_pLeafSet->Add(firstLeafIndex + i);
+
+			Serializer serializer;
+			objects[i].Serialize(serializer);
+			data.insert(data.end(), serializer.GetBytes().cbegin(), serializer.GetBytes().cend());
+			serializedLeaves.emplace_back(serializer.GetBytes());
+		}
+
+		// Add to data file
+		m_pDataFile->AddData(data);
+
+		// Add hashes
+		MMRHashUtil::AddHashes(m_pHashFile, serializedLeaves, m_pPruneList);
+	}
+
 	void Remove(const uint64_t mmrIndex)
 	{
 		LOG_TRACE_F("Spending output at index ({})", mmrIndex);
@@ -111,6 +154,19 @@ public:
 		return std::make_unique<Hash>(std::move(hash));
 	}
 
+	std::vector<uint8_t> GetHashes(const uint64_t firstIndex, const uint64_t lastIndex) const final
+	{
+		return MMRHashUtil::GetHashes(m_pHashFile, firstIndex, lastIndex, m_pPruneList);
+	}
+
+	void SetAccessHint(const EFileAccess access) final
+	{
+		m_pHashFile->SetAccessHint(access);
+		m_pDataFile->SetAccessHint(access);
+	}
+
+	std::shared_ptr<const LeafSet> GetLeafSet() const { return m_pLeafSet; }
+
 	std::vector<Hash> GetLastLeafHashes(const uint64_t numHashes) const final
 	{
 		return MMRHashUtil::GetLastLeafHashes(m_pHashFile, m_pLeafSet, m_pPruneList, numHashes);
@@ -139,12 +195,13 @@ public:
 
 			try
 			{
-				std::vector<unsigned char> data = m_pDataFile->GetDataAt(shiftedIndex);
-				if (data.size() == DATA_SIZE)
-				{
-					ByteBuffer byteBuffer(std::move(data));
-					return std::make_unique<DATA_TYPE>(DATA_TYPE::Deserialize(byteBuffer));
-				}
+				std::unique_ptr<DATA_TYPE> pData = nullptr;
+				m_pDataFile->VisitData(shiftedIndex, 1, [&pData](const unsigned char* pBytes) {
+					ByteBuffer byteBuffer(pBytes, DATA_SIZE);
+					pData = std::make_unique<DATA_TYPE>(DATA_TYPE::Deserialize(byteBuffer));
+				});
+
+				return pData;
 			}
 			catch (FileException&)
 			{
@@ -155,14 +212,187 @@ public:
 		return std::unique_ptr<DATA_TYPE>(nullptr);
 	}
 
+	//
+	// Returns the given unspent leaves (ascending leaf indices, eg. from LeafSet::GetUnspentLeaves), paired with their mmr indices.
+	// Unspent leaves are never compacted, so they're all read from the data file with a single visit spanning them.
+	// Variable-length fields (eg. rangeproofs) are allocated from pMemoryResource, which defaults to the heap.
+	//
+	std::vector<std::pair<uint64_t, DATA_TYPE>> GetLeaves(
+		const std::vector<uint64_t>& leafIndices,
+		std::pmr::memory_resource* pMemoryResource = std::pmr::get_default_resource()) const
+	{
+		std::vector<std::pair<uint64_t, DATA_TYPE>> leaves;
+		if (leafIndices.empty())
+		{
+			return leaves;
+		}
+
+		auto getPosition = [this](const uint64_t leafIndex) {
+			return leafIndex - m_pPruneList->GetLeafShift(MMRUtil::GetPMMRIndex(leafIndex));
+		};
+
+		const uint64_t firstPosition = getPosition(leafIndices.front());
+		const uint64_t numPositions = (getPosition(leafIndices.back()) - firstPosition) + 1;
+
+		leaves.reserve(leafIndices.size());
+		m_pDataFile->VisitData(firstPosition, numPositions, [&](const unsigned char* pBytes) {
+			for (const uint64_t leafIndex : leafIndices)
+			{
+				ByteBuffer byteBuffer(pBytes + ((getPosition(leafIndex) - firstPosition) * DATA_SIZE), DATA_SIZE);
+				byteBuffer.SetMemoryResource(pMemoryResource);
+				leaves.emplace_back(std::make_pair(MMRUtil::GetPMMRIndex(leafIndex), DATA_TYPE::Deserialize(byteBuffer)));
+			}
+		});
+
+		return leaves;
+	}
+
+	//
+	// Returns every unpruned leaf in the mmr index range [firstIndex, lastIndex], paired with its mmr index.
+	// Leaves that aren't compacted are stored consecutively, so the whole range is read from the data file at once.
+	//
+	std::vector<std::pair<uint64_t, DATA_TYPE>> GetUnprunedLeaves(const uint64_t firstIndex, const uint64_t lastIndex) const
+	{
+		std::vector<std::pair<uint64_t, DATA_TYPE>> leaves;
+		if (GetSize() == 0)
+		{
+			return leaves;
+		}
+
+		const uint64_t lastLeafIndex = std::min(lastIndex, GetSize() - 1);
+
+		// Find the first and last leaves still in the data file.
+		std::vector<uint64_t> storedIndices;
+		for (uint64_t mmrIndex = firstIndex; mmrIndex <= lastLeafIndex; mmrIndex++)
+		{
+			if (MMRUtil::IsLeaf(mmrIndex) && !m_pPruneList->IsCompacted(mmrIndex))
+			{
+				storedIndices.push_back(mmrIndex);
+			}
+		}
+
+		if (storedIndices.empty())
+		{
+			return leaves;
+		}
+
+		const uint64_t firstPosition = (MMRUtil::GetNumLeaves(storedIndices.front()) - 1) - m_pPruneList->GetLeafShift(storedIndices.front());
+		m_pDataFile->VisitData(firstPosition, storedIndices.size(), [this, &storedIndices, &leaves](const unsigned char* pBytes) {
+			ByteBuffer byteBuffer(pBytes, storedIndices.size() * DATA_SIZE);
+
+			for (size_t i = 0; i < storedIndices.size(); i++)
+			{
+				if (m_pLeafSet->Contains(MMRUtil::GetLeafIndex(storedIndices[i])))
+				{
+					leaves.emplace_back(std::make_pair(storedIndices[i], DATA_TYPE::Deserialize(byteBuffer)));
+				}
+
+				// Entries are fixed-size, but variable-length types may not consume the whole entry.
+				byteBuffer.Skip(((i + 1) * DATA_SIZE) - byteBuffer.GetIndex());
+			}
+		});
+
+		return leaves;
+	}
+
+	//
+	// Captures what a PMMRCompactor needs to prune everything spent before the horizon, given the MMR's size as of the horizon block
+	// and the leaves spent since. Only this needs the read lock, since the leafset changes with every block.
+	//
+	PMMRCompactor::UPtr CreateCompactor(const uint64_t horizonSize, const std::vector<uint64_t>& spentSinceHorizon) const
+	{
+		LeafSetSnapshot snapshot;
+		snapshot.numLeaves = MMRUtil::GetNumLeaves(horizonSize - 1);
+		std::copy_if(
+			spentSinceHorizon.cbegin(),
+			spentSinceHorizon.cend(),
+			std::back_inserter(snapshot.restoredLeaves),
+			[&snapshot](const uint64_t leafIndex) { return leafIndex < snapshot.numLeaves; }
+		);
+
+		return std::make_unique<PMMRCompactor>(
+			m_pHashFile->GetPath(),
+			m_pDataFile->GetPath(),
+			DATA_SIZE,
+			m_pPruneList,
+			m_pLeafSet->ToRoaring(snapshot),
+			horizonSize
+		);
+	}
+
+	//
+	// Appends everything past the horizon to the compactor's files, and checks them against the current ones.
+	// Called under the write lock, with no uncommitted changes. Nothing is replaced until SwapInCompaction.
+	//
+	void StageCompaction(PMMRCompactor& compactor)
+	{
+		if (compactor.IsEmpty())
+		{
+			return;
+		}
+
+		if (IsDirty())
+		{
+			throw TXHASHSET_EXCEPTION("Can't compact with uncommitted changes");
+		}
+
+		const uint64_t size = GetSize();
+		const uint64_t hashStart = compactor.GetHashSuffixStart();
+		const uint64_t dataStart = compactor.GetDataSuffixStart();
+		if (size < compactor.GetHorizonSize() || m_pHashFile->GetSize() < hashStart || m_pDataFile->GetSize() < dataStart)
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Rewound past compaction horizon ({})", compactor.GetHorizonSize()));
+		}
+
+		compactor.Finish(
+			m_pHashFile->GetDataRange(hashStart, m_pHashFile->GetSize() - hashStart),
+			m_pDataFile->GetDataRange(dataStart, m_pDataFile->GetSize() - dataStart)
+		);
+
+		// Nothing is replaced unless the compacted files have the expected sizes and the same root.
+		const std::shared_ptr<PruneList>& pPruneList = compactor.GetCompactedPruneList();
+		{
+			std::shared_ptr<HashFile> pCompactedHashes = HashFile::Load(compactor.GetCompactedHashPath());
+			if (pCompactedHashes->GetSize() + pPruneList->GetTotalShift() != size
+				|| MMRHashUtil::Root(pCompactedHashes, size, pPruneList) != Root(size))
+			{
+				throw TXHASHSET_EXCEPTION(StringUtil::Format("Compacted hashes don't match at size {}", size));
+			}
+		}
+
+		const uint64_t numData = MMRUtil::GetNumLeaves(size - 1) - pPruneList->GetLeafShift(size - 1);
+		if (FileUtil::GetFileSize(compactor.GetCompactedDataPath()) != numData * DATA_SIZE)
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Compacted data doesn't match at size {}", size));
+		}
+	}
+
+	//
+	// Moves the staged files over the current ones and loads them. Only called once the compaction is committed to a manifest.
+	//
+	void SwapInCompaction(const PMMRCompactor& compactor)
+	{
+		if (compactor.IsEmpty())
+		{
+			return;
+		}
+
+		m_pHashFile->Replace(compactor.GetCompactedHashPath());
+		m_pDataFile->Replace(compactor.GetCompactedDataPath());
+		FileUtil::RenameFile(compactor.GetCompactedPruneListPath(), m_pPruneList->GetFilePath());
+		m_pPruneList = compactor.GetCompactedPruneList();
+	}
+
 	void Commit() final
 	{
 		if (IsDirty())
 		{
 			LOG_TRACE_F("Flushing with size ({})", GetSize());
-			m_pHashFile->Commit();
-			m_pDataFile->Commit();
-			m_pLeafSet->Commit();
+			ThreadManagerAPI::GetThreadPool().RunAll({
+				[this] { m_pHashFile->Commit(); },
+				[this] { m_pDataFile->Commit(); },
+				[this] { m_pLeafSet->Commit(); }
+			}, ETaskPriority::HIGH);
 			SetDirty(false);
 		}
 	}
@@ -6,8 +6,8 @@
 #include <Core/Serialization/Serializer.h>
 #include <Config/Config.h>
 
-HeaderMMR::HeaderMMR(std::shared_ptr<Locked<HashFile>> pHashFile)
-	: m_pLockedHashFile(pHashFile)
+HeaderMMR::HeaderMMR(std::shared_ptr<Locked<HashFile>> pHashFile, Peaks&& peaks)
+	: m_pLockedHashFile(pHashFile), m_peaks(std::move(peaks))
 {
 
 }
@@ -15,8 +15,12 @@ HeaderMMR::HeaderMMR(std::shared_ptr<Locked<HashFile>> pHashFile)
 std::shared_ptr<HeaderMMR> HeaderMMR::Load(const fs::path& path)
 {
 	std::shared_ptr<HashFile> pHashFile = HashFile::Load(path);
+
+	Peaks peaks{ 0, {} };
+	UpdatePeaks(peaks, *pHashFile);
+
 	auto locked = std::make_shared<Locked<HashFile>>(pHashFile);
-	return std::make_shared<HeaderMMR>(HeaderMMR(locked));
+	return std::make_shared<HeaderMMR>(HeaderMMR(locked, std::move(peaks)));
 }
 
 void HeaderMMR::Commit()
@@ -26,6 +30,7 @@ void HeaderMMR::Commit()
 		const uint64_t height = MMRUtil::GetNumLeaves(m_batchDataOpt.value().hashFile->GetSize());
 		LOG_TRACE_F("Flushing - Height: {}, Size: {}", height - 1, m_batchDataOpt.value().hashFile->GetSize());
 		m_batchDataOpt.value().hashFile->Commit();
+		m_peaks = m_batchDataOpt.value().peaks;
 		SetDirty(false);
 	}
 }
@@ -36,6 +41,7 @@ void HeaderMMR::Rollback() noexcept
 	{
 		LOG_DEBUG("Discarding changes.");
 		m_batchDataOpt.value().hashFile->Rollback();
+		m_batchDataOpt.value().peaks = m_peaks;
 		SetDirty(false);
 	}
 }
@@ -47,6 +53,7 @@ void HeaderMMR::Rewind(const uint64_t size)
 	{
 		LOG_DEBUG_F("Rewinding to height {} - {} hashes", size, mmrSize);
 		m_batchDataOpt.value().hashFile->Rewind(mmrSize);
+		UpdatePeaks(m_batchDataOpt.value().peaks, *m_batchDataOpt.value().hashFile);
 		SetDirty(true);
 	}
 }
@@ -62,6 +69,30 @@ void HeaderMMR::AddHeader(const BlockHeader& header)
 
 	// Add hashes
 	MMRHashUtil::AddHashes(m_batchDataOpt.value().hashFile.GetShared(), serializedHeader, nullptr);
+	UpdatePeaks(m_batchDataOpt.value().peaks, *m_batchDataOpt.value().hashFile);
+	SetDirty(true);
+}
+
+void HeaderMMR::AddHeaders(const std::vector<BlockHeaderPtr>& headers)
+{
+	if (headers.empty())
+	{
+		return;
+	}
+
+	LOG_TRACE_F("Adding {} headers at height {} - MMR size {}", headers.size(), headers.front()->GetHeight(), m_batchDataOpt.value().hashFile->GetSize());
+
+	std::vector<std::vector<unsigned char>> serializedHeaders;
+	serializedHeaders.reserve(headers.size());
+	for (const BlockHeaderPtr& pHeader : headers)
+	{
+		Serializer serializer;
+		pHeader->GetProofOfWork().SerializeCycle(serializer);
+		serializedHeaders.push_back(serializer.GetBytes());
+	}
+
+	MMRHashUtil::AddHashes(m_batchDataOpt.value().hashFile.GetShared(), serializedHeaders, nullptr);
+	UpdatePeaks(m_batchDataOpt.value().peaks, *m_batchDataOpt.value().hashFile);
 	SetDirty(true);
 }
 
@@ -69,6 +100,12 @@ Hash HeaderMMR::Root(const uint64_t lastHeight) const
 {
 	const uint64_t position = MMRUtil::GetNumNodes(MMRUtil::GetPMMRIndex(lastHeight));
 
+	const Peaks& peaks = m_batchDataOpt.has_value() ? m_batchDataOpt.value().peaks : m_peaks;
+	if (position == peaks.size)
+	{
+		return BagPeaks(peaks);
+	}
+
 	if (m_batchDataOpt.has_value())
 	{
 		return MMRHashUtil::Root(m_batchDataOpt.value().hashFile.GetShared(), position, nullptr);
@@ -79,6 +116,55 @@ Hash HeaderMMR::Root(const uint64_t lastHeight) const
 	}
 }
 
+void HeaderMMR::UpdatePeaks(Peaks& peaks, const HashFile& hashFile)
+{
+	const uint64_t size = hashFile.GetSize();
+
+	std::vector<std::pair<uint64_t, Hash>> updated;
+	auto iter = peaks.peaks.cbegin();
+	for (const uint64_t peakIndex : MMRUtil::GetPeaks(size))
+	{
+		while (iter != peaks.peaks.cend() && iter->first < peakIndex)
+		{
+			iter++;
+		}
+
+		if (iter != peaks.peaks.cend() && iter->first == peakIndex)
+		{
+			updated.push_back(*iter);
+		}
+		else
+		{
+			updated.emplace_back(peakIndex, Hash(hashFile.GetDataAt(peakIndex)));
+		}
+	}
+
+	peaks.size = size;
+	peaks.peaks = std::move(updated);
+}
+
+// Bags the peaks from right to left, the same as MMRHashUtil::Root.
+Hash HeaderMMR::BagPeaks(const Peaks& peaks)
+{
+	Hash hash = ZERO_HASH;
+	for (auto iter = peaks.peaks.crbegin(); iter != peaks.peaks.crend(); iter++)
+	{
+		if (iter->second != ZERO_HASH)
+		{
+			if (hash == ZERO_HASH)
+			{
+				hash = iter->second;
+			}
+			else
+			{
+				hash = MMRHashUtil::HashParentWithIndex(iter->second, hash, peaks.size);
+			}
+		}
+	}
+
+	return hash;
+}
+
 namespace HeaderMMRAPI
 {
 	PMMR_API std::shared_ptr<Locked<IHeaderMMR>> OpenHeaderMMR(const Config& config)
@@ -6,6 +6,8 @@
 #include <Core/Models/BlockHeader.h>
 #include <optional>
 #include <string>
+#include <utility>
+#include <vector>
 
 class HeaderMMR : public IHeaderMMR
 {
@@ -13,6 +15,7 @@ public:
 	static std::shared_ptr<HeaderMMR> Load(const fs::path& path);
 
 	void AddHeader(const BlockHeader& header) final;
+	void AddHeaders(const std::vector<BlockHeaderPtr>& headers) final;
 	Hash Root(const uint64_t lastHeight) const final;
 	void Rewind(const uint64_t size) final;
 
@@ -20,16 +23,38 @@ public:
 	void Rollback() noexcept final;
 
 private:
-	HeaderMMR(std::shared_ptr<Locked<HashFile>> pHashFile);
+	//
+	// The peaks of an MMR of the given size, in index order.
+	// Header validation asks for the root of the whole MMR before each header is added,
+	// so bagging these avoids reading the peaks back from the hash file each time.
+	//
+	struct Peaks
+	{
+		uint64_t size;
+		std::vector<std::pair<uint64_t, Hash>> peaks;
+	};
+
+	HeaderMMR(std::shared_ptr<Locked<HashFile>> pHashFile, Peaks&& peaks);
+
+	//
+	// Updates the peaks to the hash file's current size. Peaks that are still peaks keep their hashes,
+	// so only the new ones are read. After an add, they're the nodes that were just appended.
+	//
+	static void UpdatePeaks(Peaks& peaks, const HashFile& hashFile);
+	static Hash BagPeaks(const Peaks& peaks);
 
 	std::shared_ptr<Locked<HashFile>> m_pLockedHashFile;
 
+	// The peaks of the committed hash file.
+	Peaks m_peaks;
+
 	void OnInitWrite() final
 	{
 		SetDirty(false);
 
 		BatchData batch;
 		batch.hashFile = m_pLockedHashFile->BatchWrite();
+		batch.peaks = m_peaks;
 		m_batchDataOpt = std::make_optional(std::move(batch));
 	}
 
@@ -41,6 +66,7 @@ private:
 	struct BatchData
 	{
 		Writer<HashFile> hashFile;
+		Peaks peaks;
 	};
 	std::optional<BatchData> m_batchDataOpt;
 };
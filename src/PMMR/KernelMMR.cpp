@@ -3,6 +3,7 @@
 #include "Common/MMRHashUtil.h"
 
 #include <Core/Traits/Lockable.h>
+#include <Common/ThreadPool.h>
 #include <Common/Util/StringUtil.h>
 #include <Common/Logger.h>
 
@@ -39,18 +40,39 @@ std::unique_ptr<TransactionKernel> KernelMMR::GetKernelAt(const uint64_t mmrInde
 	{
 		const uint64_t numLeaves = MMRUtil::GetNumLeaves(mmrIndex);
 
-		std::vector<unsigned char> data = m_pDataFile->GetDataAt(numLeaves - 1);
+		std::unique_ptr<TransactionKernel> pKernel = nullptr;
+		m_pDataFile->VisitData(numLeaves - 1, 1, [&pKernel](const unsigned char* pBytes) {
+			ByteBuffer byteBuffer(pBytes, KERNEL_SIZE);
+			pKernel = std::make_unique<TransactionKernel>(TransactionKernel::Deserialize(byteBuffer));
+		});
 
-		if (data.size() == KERNEL_SIZE)
-		{
-			ByteBuffer byteBuffer(std::move(data));
-			return std::make_unique<TransactionKernel>(TransactionKernel::Deserialize(byteBuffer));
-		}
+		return pKernel;
 	}
 
 	return std::unique_ptr<TransactionKernel>(nullptr);
 }
 
+std::vector<TransactionKernel> KernelMMR::GetKernels(const uint64_t firstLeafIndex, const uint64_t numKernels) const
+{
+	std::vector<TransactionKernel> kernels;
+	kernels.reserve(numKernels);
+
+	m_pDataFile->VisitData(firstLeafIndex, numKernels, [numKernels, &kernels](const unsigned char* pBytes) {
+		ByteBuffer byteBuffer(pBytes, numKernels * KERNEL_SIZE);
+		for (uint64_t i = 0; i < numKernels; i++)
+		{
+			kernels.emplace_back(TransactionKernel::Deserialize(byteBuffer));
+		}
+	});
+
+	return kernels;
+}
+
+std::vector<uint8_t> KernelMMR::GetHashes(const uint64_t firstIndex, const uint64_t lastIndex) const
+{
+	return MMRHashUtil::GetHashes(m_pHashFile, firstIndex, lastIndex, nullptr);
+}
+
 std::vector<Hash> KernelMMR::GetLastLeafHashes(const uint64_t numHashes) const
 {
 	return MMRHashUtil::GetLastLeafHashes(m_pHashFile, nullptr, nullptr, numHashes);
@@ -63,10 +85,18 @@ bool KernelMMR::Rewind(const uint64_t size)
 	return true;
 }
 
+void KernelMMR::SetAccessHint(const EFileAccess access)
+{
+	m_pHashFile->SetAccessHint(access);
+	m_pDataFile->SetAccessHint(access);
+}
+
 void KernelMMR::Commit()
 {
-	m_pHashFile->Commit();
-	m_pDataFile->Commit();
+	ThreadManagerAPI::GetThreadPool().RunAll({
+		[this] { m_pHashFile->Commit(); },
+		[this] { m_pDataFile->Commit(); }
+	}, ETaskPriority::HIGH);
 }
 
 void KernelMMR::Rollback() noexcept
@@ -84,4 +114,26 @@ void KernelMMR::ApplyKernel(const TransactionKernel& kernel)
 
 	// Add hashes
 	MMRHashUtil::AddHashes(m_pHashFile, serializer.GetBytes(), nullptr);
+}
+
+void KernelMMR::ApplyKernels(const std::vector<TransactionKernel>& kernels)
+{
+	std::vector<std::vector<unsigned char>> serializedKernels;
+	serializedKernels.reserve(kernels.size());
+
+	std::vector<unsigned char> data;
+	data.reserve(kernels.size() * KERNEL_SIZE);
+	for (const TransactionKernel& kernel : kernels)
+	{
+		Serializer serializer;
+		kernel.Serialize(serializer);
+		data.insert(data.end(), serializer.GetBytes().cbegin(), serializer.GetBytes().cend());
+		serializedKernels.emplace_back(serializer.GetBytes());
+	}
+
+	// Add to data file
+	m_pDataFile->AddData(data);
+
+	// Add hashes
+	MMRHashUtil::AddHashes(m_pHashFile, serializedKernels, nullptr);
 }
\ No newline at end of file
@@ -20,18 +20,32 @@ public:
 	virtual ~KernelMMR() = default;
 
 	std::unique_ptr<TransactionKernel> GetKernelAt(const uint64_t mmrIndex) const;
+
+	//
+	// Deserializes numKernels consecutive kernels, starting at leaf firstLeafIndex, from a single data file read.
+	//
+	std::vector<TransactionKernel> GetKernels(const uint64_t firstLeafIndex, const uint64_t numKernels) const;
+	uint64_t GetNumKernels() const { return m_pDataFile->GetSize(); }
+
 	bool Rewind(const uint64_t size);
 
 	Hash Root(const uint64_t size) const final;
 	uint64_t GetSize() const final { return m_pHashFile->GetSize(); }
 	std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const final { return std::make_unique<Hash>(m_pHashFile->GetDataAt(mmrIndex)); }
+	std::vector<uint8_t> GetHashes(const uint64_t firstIndex, const uint64_t lastIndex) const final;
 	std::vector<Hash> GetLastLeafHashes(const uint64_t numHashes) const final;
+	void SetAccessHint(const EFileAccess access) final;
 
 	void Commit() final;
 	void Rollback() noexcept final;
 
 	void ApplyKernel(const TransactionKernel& kernel);
 
+	//
+	// Appends all of the kernels with one write each to the data and hash files.
+	//
+	void ApplyKernels(const std::vector<TransactionKernel>& kernels);
+
 private:
 	KernelMMR(std::shared_ptr<HashFile> pHashFile, std::shared_ptr<DataFile<KERNEL_SIZE>> pDataFile);
 
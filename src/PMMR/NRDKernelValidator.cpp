@@ -0,0 +1,43 @@
+#include "NRDKernelValidator.h"
+
+#include <Core/Models/OutputLocation.h>
+#include <Database/BlockDb.h>
+#include <Common/Logger.h>
+
+bool NRDKernelValidator::Validate(
+	const IBlockDB& blockDB,
+	const std::vector<TransactionKernel>& kernels,
+	const uint64_t blockHeight,
+	const std::unordered_set<Commitment>& pendingExcesses)
+{
+	std::unordered_set<Commitment> excesses;
+	for (const TransactionKernel& kernel : kernels)
+	{
+		if (kernel.GetFeatures() != EKernelFeatures::NO_RECENT_DUPLICATE)
+		{
+			continue;
+		}
+
+		const Commitment& excess = kernel.GetExcessCommitment();
+		if (pendingExcesses.count(excess) > 0 || !excesses.insert(excess).second)
+		{
+			LOG_INFO_F("NRD kernel ({}) duplicated at height {}", excess, blockHeight);
+			return false;
+		}
+
+		std::unique_ptr<OutputLocation> pPrevious = blockDB.GetNRDKernelPosition(excess);
+		if (pPrevious != nullptr && blockHeight < pPrevious->GetBlockHeight() + kernel.GetLockHeight())
+		{
+			LOG_INFO_F(
+				"NRD kernel ({}) at height {} is within {} blocks of its duplicate at height {}",
+				excess,
+				blockHeight,
+				kernel.GetLockHeight(),
+				pPrevious->GetBlockHeight()
+			);
+			return false;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <Core/Models/TransactionKernel.h>
+#include <Crypto/Commitment.h>
+#include <unordered_set>
+#include <vector>
+
+// Forward Declarations
+class IBlockDB;
+
+//
+// Checks the relative lock heights of NRD (no recent duplicate) kernels: an NRD kernel is only valid if no other NRD kernel
+// with the same excess commitment was included fewer than its relative lock height blocks earlier.
+// Each kernel is a single lookup in the NRD kernel index (see IBlockDB::GetNRDKernelPosition), rather than a scan of the kernel MMR.
+//
+class NRDKernelValidator
+{
+public:
+	//
+	// Returns false if any NRD kernel fails its relative lock when included at blockHeight.
+	// pendingExcesses are the NRD excess commitments already included at blockHeight (eg. by earlier transactions in the block),
+	// which aren't in the index yet. Kernels with the same excess in the same block always fail, since relative locks are at least 1.
+	//
+	static bool Validate(
+		const IBlockDB& blockDB,
+		const std::vector<TransactionKernel>& kernels,
+		const uint64_t blockHeight,
+		const std::unordered_set<Commitment>& pendingExcesses
+	);
+};
@@ -0,0 +1,131 @@
+#include <PMMR/TxHashSetDownload.h>
+
+#include "KernelMMR.h"
+#include "TxHashSetValidator.h"
+#include "Zip/ZipStreamExtractor.h"
+
+#include <Common/Util/FileUtil.h>
+#include <Common/Util/StringUtil.h>
+#include <Common/Util/ThreadUtil.h>
+#include <Common/ThreadManager.h>
+#include <Common/Logger.h>
+#include <P2P/SyncStatus.h>
+
+TxHashSetDownload::TxHashSetDownload(const Config& config, const BlockHeaderPtr& pHeader)
+	: m_config(config),
+	m_pHeader(pHeader),
+	m_stagingPath(config.GetNodeConfig().GetTxHashSetPath().parent_path() / "TXHASHSET_STAGING" / pHeader->ShortHash()),
+	m_failed(false),
+	m_kernelSignaturesVerified(false)
+{
+	// Staged next to the TxHashSet, so LoadFromZip can move the folders instead of copying them.
+	FileUtil::RemoveFile(m_stagingPath);
+
+	// The same files TxHashSetZip extracts.
+	std::unordered_map<std::string, fs::path> entryPaths;
+	const std::vector<std::string> kernelFiles = { "pmmr_data.bin", "pmmr_hash.bin" };
+	for (const std::string& file : kernelFiles)
+	{
+		entryPaths.insert({ "kernel/" + file, m_stagingPath / "kernel" / file });
+	}
+
+	const std::vector<std::string> folders = { "output", "rangeproof" };
+	const std::vector<std::string> files = { "pmmr_data.bin", "pmmr_hash.bin", "pmmr_prun.bin", "pmmr_leaf.bin." + pHeader->ShortHash() };
+	for (const std::string& folder : folders)
+	{
+		for (const std::string& file : files)
+		{
+			entryPaths.insert({ folder + "/" + file, m_stagingPath / folder / file });
+		}
+	}
+
+	for (const auto& entry : entryPaths)
+	{
+		m_remainingEntries.insert(entry.first);
+	}
+
+	m_pExtractor = std::make_unique<ZipStreamExtractor>(
+		entryPaths,
+		[this](const std::string& entryName) { OnEntryExtracted(entryName); }
+	);
+}
+
+TxHashSetDownload::~TxHashSetDownload()
+{
+	ThreadUtil::Join(m_kernelThread);
+	FileUtil::RemoveFile(m_stagingPath);
+}
+
+void TxHashSetDownload::Append(const unsigned char* pData, const size_t numBytes) noexcept
+{
+	if (m_failed)
+	{
+		return;
+	}
+
+	try
+	{
+		m_pExtractor->Append(pData, numBytes);
+	}
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Can't extract TxHashSet while downloading, so it will be extracted afterwards: {}", e.what());
+		m_failed = true;
+	}
+}
+
+void TxHashSetDownload::Finish()
+{
+	ThreadUtil::Join(m_kernelThread);
+
+	if (!m_failed && !IsExtracted())
+	{
+		LOG_WARNING_F("TxHashSet download ended with {} files not extracted", m_remainingEntries.size());
+	}
+}
+
+bool TxHashSetDownload::IsExtracted() const noexcept
+{
+	return !m_failed && m_pExtractor->IsComplete() && m_remainingEntries.empty();
+}
+
+void TxHashSetDownload::OnEntryExtracted(const std::string& entryName)
+{
+	m_remainingEntries.erase(entryName);
+
+	const bool kernelsExtracted = m_remainingEntries.count("kernel/pmmr_data.bin") == 0
+		&& m_remainingEntries.count("kernel/pmmr_hash.bin") == 0;
+	if (kernelsExtracted && !m_kernelThread.joinable())
+	{
+		m_kernelThread = std::thread(Thread_VerifyKernelSignatures, std::ref(*this));
+	}
+}
+
+//
+// The kernel folder usually comes first in the zip, so its signatures, the most expensive part
+// of validation after the rangeproofs, are verified while the outputs and rangeproofs are still downloading.
+//
+void TxHashSetDownload::Thread_VerifyKernelSignatures(TxHashSetDownload& download)
+{
+	ThreadManagerAPI::SetCurrentThreadName("TXHASHSET_KERNELS");
+
+	try
+	{
+		const FullBlock& genesisBlock = download.m_config.GetEnvironment().GetGenesisBlock();
+		std::shared_ptr<KernelMMR> pKernelMMR = KernelMMR::Load(download.m_stagingPath, genesisBlock);
+		pKernelMMR->Rewind(download.m_pHeader->GetKernelMMRSize());
+		pKernelMMR->Commit();
+
+		// Progress is only reported for validation steps that run after the download.
+		SyncStatus syncStatus;
+		download.m_kernelSignaturesVerified = TxHashSetValidator::ValidateKernelSignatures(*pKernelMMR, syncStatus);
+		if (!download.m_kernelSignaturesVerified)
+		{
+			LOG_WARNING("Kernel signature verification failed during download. Will retry during validation.");
+		}
+	}
+	catch (std::exception& e)
+	{
+		LOG_WARNING_F("Failed to verify kernel signatures during download: {}", e.what());
+	}
+}
@@ -1,17 +1,25 @@
 #include "TxHashSetImpl.h"
 #include "TxHashSetValidator.h"
+#include "TxHashSetOverlay.h"
+#include "NRDKernelValidator.h"
 #include "Common/MMRUtil.h"
 #include "Common/MMRHashUtil.h"
 
-#include <Common/Util/ThreadUtil.h>
+#include <Consensus/HardForks.h>
+#include <Common/ThreadPool.h>
 #include <Common/Util/HexUtil.h>
 #include <Common/Util/FileUtil.h>
 #include <Common/Util/StringUtil.h>
 #include <BlockChain/BlockChain.h>
 #include <Database/BlockDb.h>
 #include <Common/Logger.h>
+#include <Common/Tracer.h>
 #include <P2P/SyncStatus.h>
-#include <thread>
+#include <algorithm>
+#include <set>
+#include <functional>
+#include <future>
+#include <memory_resource>
 
 TxHashSet::TxHashSet(
 	const Config& config,
@@ -24,69 +32,51 @@ TxHashSet::TxHashSet(
 	m_pOutputPMMR(pOutputPMMR),
 	m_pRangeProofPMMR(pRangeProofPMMR),
 	m_pBlockHeader(pBlockHeader),
-	m_pBlockHeaderBackup(pBlockHeader)
+	m_pBlockHeaderBackup(pBlockHeader),
+	m_kernelSignaturesVerified(false),
+	m_proofsTrusted(false)
 {
 
 }
 
 bool TxHashSet::IsValid(std::shared_ptr<const IBlockDB> pBlockDB, const Transaction& transaction) const
 {
-	// Validate inputs
-	const uint64_t maximumBlockHeight = Consensus::GetMaxCoinbaseHeight(
+	return CreateOverlay(pBlockDB)->IsValid(transaction);
+}
+
+ITxHashSetOverlay::UPtr TxHashSet::CreateOverlay(std::shared_ptr<const IBlockDB> pBlockDB) const
+{
+	const uint64_t maximumCoinbaseHeight = Consensus::GetMaxCoinbaseHeight(
 		m_config.GetEnvironment().GetType(),
 		m_pBlockHeader->GetHeight() + 1 // Add one since this is used by TransactionPool
 	);
-	for (const TransactionInput& input : transaction.GetInputs())
-	{
-		const Commitment& commitment = input.GetCommitment();
-		std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->GetOutputPosition(commitment);
-		if (pOutputPosition == nullptr)
-		{
-			return false;
-		}
 
-		std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetAt(pOutputPosition->GetMMRIndex());
-		if (pOutput == nullptr || pOutput->GetCommitment() != commitment || pOutput->GetFeatures() != input.GetFeatures())
-		{
-			LOG_DEBUG_F("Output ({}) not found at mmrIndex ({})",  commitment, pOutputPosition->GetMMRIndex());
-			return false;
-		}
-
-		if (input.GetFeatures() == EOutputFeatures::COINBASE_OUTPUT)
-		{
-			if (pOutputPosition->GetBlockHeight() > maximumBlockHeight)
-			{
-				LOG_INFO_F("Coinbase ({}) not mature", transaction);
-				return false;
-			}
-		}
-	}
-
-	// Validate outputs
-	for (const TransactionOutput& output : transaction.GetOutputs())
-	{
-		std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->GetOutputPosition(output.GetCommitment());
-		if (pOutputPosition != nullptr)
-		{
-			std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetAt(pOutputPosition->GetMMRIndex());
-			if (pOutput != nullptr && pOutput->GetCommitment() == output.GetCommitment())
-			{
-				return false;
-			}
-		}
-	}
-
-	return true;
+	return std::make_unique<TxHashSetOverlay>(
+		pBlockDB,
+		m_pKernelMMR,
+		m_pOutputPMMR,
+		m_pRangeProofPMMR,
+		m_pBlockHeader->GetHeight() + 1,
+		maximumCoinbaseHeight,
+		Consensus::GetHeaderVersion(m_config.GetEnvironment().GetType(), m_pBlockHeader->GetHeight() + 1)
+	);
 }
 
 std::unique_ptr<BlockSums> TxHashSet::ValidateTxHashSet(const BlockHeader& header, const IBlockChain& blockChain, SyncStatus& syncStatus)
 {
 	std::unique_ptr<BlockSums> pBlockSums = nullptr;
 
+	// Validation reads every hash and rangeproof once, front to back.
+	const bool sequentialScanHints = m_config.GetNodeConfig().IsSequentialScanHintEnabled();
+	if (sequentialScanHints)
+	{
+		SetAccessHint(EFileAccess::SEQUENTIAL);
+	}
+
 	try
 	{
 		LOG_INFO("Validating TxHashSet for block " + header.GetHash().ToHex());
-		pBlockSums = TxHashSetValidator(blockChain).Validate(*this, header, syncStatus);
+		pBlockSums = TxHashSetValidator(blockChain).Validate(*this, header, m_kernelSignaturesVerified, m_proofsTrusted, syncStatus);
 		if (pBlockSums != nullptr)
 		{
 			LOG_INFO("Successfully validated TxHashSet");
@@ -97,21 +87,48 @@ std::unique_ptr<BlockSums> TxHashSet::ValidateTxHashSet(const BlockHeader& heade
 		LOG_ERROR("Exception thrown while processing TxHashSet");
 	}
 
+	if (sequentialScanHints)
+	{
+		SetAccessHint(EFileAccess::NORMAL);
+	}
+
 	return pBlockSums;
 }
 
+void TxHashSet::SetAccessHint(const EFileAccess access)
+{
+	m_pKernelMMR->SetAccessHint(access);
+	m_pOutputPMMR->SetAccessHint(access);
+	m_pRangeProofPMMR->SetAccessHint(access);
+}
+
 bool TxHashSet::ApplyBlock(std::shared_ptr<IBlockDB> pBlockDB, const FullBlock& block)
 {
+	TRACE_SPAN("TxHashSet::ApplyBlock");
+
+	const std::vector<TransactionKernel>& blockKernels = block.GetKernels();
+	if (!NRDKernelValidator::Validate(*pBlockDB, blockKernels, block.GetHeight(), {}))
+	{
+		LOG_ERROR_F("NRD kernel relative lock failed for block {}", block);
+		return false;
+	}
+
 	Roaring blockInputBitmap;
 
 	// Prune inputs
+	const std::vector<TransactionInput>& blockInputs = block.GetInputs();
 	std::vector<SpentOutput> spentPositions;
-	spentPositions.reserve(block.GetInputs().size());
+	spentPositions.reserve(blockInputs.size());
 
-	for (const TransactionInput& input : block.GetInputs())
+	std::vector<Commitment> inputCommitments;
+	inputCommitments.reserve(blockInputs.size());
+	std::transform(blockInputs.cbegin(), blockInputs.cend(), std::back_inserter(inputCommitments), [](const TransactionInput& input) { return input.GetCommitment(); });
+	const std::vector<std::unique_ptr<OutputLocation>> inputPositions = pBlockDB->GetOutputPositions(inputCommitments);
+
+	for (size_t i = 0; i < blockInputs.size(); i++)
 	{
-		const Commitment& commitment = input.GetCommitment();
-		std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->GetOutputPosition(commitment);
+		const Commitment& commitment = inputCommitments[i];
+		const std::unique_ptr<OutputLocation>& pOutputPosition = inputPositions[i];
 		if (pOutputPosition == nullptr)
 		{
 			LOG_WARNING_F("Output position not found for commitment ({}) in block ({})", commitment, block);
@@ -128,9 +145,24 @@ bool TxHashSet::ApplyBlock(std::shared_ptr<IBlockDB> pBlockDB, const FullBlock&
 	pBlockDB->AddSpentPositions(block.GetHash(), spentPositions);
 
 	// Append new outputs
-	for (const TransactionOutput& output : block.GetOutputs())
+	const std::vector<TransactionOutput>& blockOutputs = block.GetOutputs();
+	const uint64_t firstLeafIndex = MMRUtil::GetNumLeaves(m_pOutputPMMR->GetSize() - 1);
+
+	std::set<Commitment> blockCommitments;
+	std::vector<OutputIdentifier> outputIdentifiers;
+	outputIdentifiers.reserve(blockOutputs.size());
+	std::vector<RangeProof> rangeProofs;
+	rangeProofs.reserve(blockOutputs.size());
+
+	std::vector<Commitment> outputCommitments;
+	outputCommitments.reserve(blockOutputs.size());
+	std::transform(blockOutputs.cbegin(), blockOutputs.cend(), std::back_inserter(outputCommitments), [](const TransactionOutput& output) { return output.GetCommitment(); });
+	const std::vector<std::unique_ptr<OutputLocation>> outputPositions = pBlockDB->GetOutputPositions(outputCommitments);
+
+	for (size_t i = 0; i < blockOutputs.size(); i++)
 	{
-		std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->GetOutputPosition(output.GetCommitment());
+		const TransactionOutput& output = blockOutputs[i];
+		const std::unique_ptr<OutputLocation>& pOutputPosition = outputPositions[i];
 		if (pOutputPosition != nullptr && m_pOutputPMMR->IsUnpruned(pOutputPosition->GetMMRIndex()))
 		{
 			LOG_ERROR_F("Output {} already exists at position {} and height {}",
@@ -141,19 +173,40 @@ bool TxHashSet::ApplyBlock(std::shared_ptr<IBlockDB> pBlockDB, const FullBlock&
 			return false;
 		}
 
-		const uint64_t mmrIndex = m_pOutputPMMR->GetSize();
-		const uint64_t blockHeight = block.GetHeight();
+		// The outputs aren't appended until all are checked, so duplicates within the block are caught here.
+		if (!blockCommitments.insert(output.GetCommitment()).second)
+		{
+			LOG_ERROR_F("Output {} appears more than once in block {}", output, block);
+			return false;
+		}
 
-		m_pOutputPMMR->Append(OutputIdentifier::FromOutput(output));
-		m_pRangeProofPMMR->Append(output.GetRangeProof());
+		outputIdentifiers.emplace_back(OutputIdentifier::FromOutput(output));
+		rangeProofs.emplace_back(output.GetRangeProof());
+	}
+
+	// Append new outputs, rangeproofs, and kernels. The positions are added to the block db here, since it's shared by all three.
+	const uint64_t firstKernelLeafIndex = m_pKernelMMR->GetNumKernels();
+	ThreadManagerAPI::GetThreadPool().RunAll({
+		[this, &blockKernels] { m_pKernelMMR->ApplyKernels(blockKernels); },
+		[this, &rangeProofs] { m_pRangeProofPMMR->Append(rangeProofs); },
+		[this, &outputIdentifiers] { m_pOutputPMMR->Append(outputIdentifiers); }
+	}, ETaskPriority::HIGH);
 
-		pBlockDB->AddOutputPosition(output.GetCommitment(), OutputLocation(mmrIndex, blockHeight));
+	for (size_t i = 0; i < blockOutputs.size(); i++)
+	{
+		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(firstLeafIndex + i);
+		pBlockDB->AddOutputPosition(blockOutputs[i].GetCommitment(), OutputLocation(mmrIndex, block.GetHeight()));
 	}
 
-	// Append new kernels
-	for (const TransactionKernel& kernel : block.GetKernels())
+	for (size_t i = 0; i < blockKernels.size(); i++)
 	{
-		m_pKernelMMR->ApplyKernel(kernel);
+		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(firstKernelLeafIndex + i);
+		pBlockDB->AddKernelPosition(blockKernels[i].GetExcessCommitment(), OutputLocation(mmrIndex, block.GetHeight()));
+
+		if (blockKernels[i].GetFeatures() == EKernelFeatures::NO_RECENT_DUPLICATE)
+		{
+			pBlockDB->AddNRDKernelPosition(blockKernels[i].GetExcessCommitment(), OutputLocation(mmrIndex, block.GetHeight()));
+		}
 	}
 
 	m_pBlockHeader = block.GetHeader();
@@ -163,13 +216,28 @@ bool TxHashSet::ApplyBlock(std::shared_ptr<IBlockDB> pBlockDB, const FullBlock&
 
 bool TxHashSet::ValidateRoots(const BlockHeader& blockHeader) const
 {
-	if (m_pKernelMMR->Root(blockHeader.GetKernelMMRSize()) != blockHeader.GetKernelRoot())
+	Hash kernelRoot;
+	Hash rangeProofRoot;
+	Hash outputRoot;
+	Hash UBMT;
+	ThreadManagerAPI::GetThreadPool().RunAll({
+		[this, &blockHeader, &kernelRoot] { kernelRoot = m_pKernelMMR->Root(blockHeader.GetKernelMMRSize()); },
+		[this, &blockHeader, &rangeProofRoot] { rangeProofRoot = m_pRangeProofPMMR->Root(blockHeader.GetOutputMMRSize()); },
+		[this, &blockHeader, &outputRoot, &UBMT] {
+			outputRoot = m_pOutputPMMR->Root(blockHeader.GetOutputMMRSize());
+			if (blockHeader.GetVersion() >= 3)
+			{
+				UBMT = m_pOutputPMMR->UBMTRoot(MMRUtil::GetNumLeaves(blockHeader.GetOutputMMRSize() - 1));
+			}
+		}
+	}, ETaskPriority::HIGH);
+
+	if (kernelRoot != blockHeader.GetKernelRoot())
 	{
 		LOG_ERROR_F("Kernel root not matching for header ({})", blockHeader);
 		return false;
 	}
 
-	Hash outputRoot = m_pOutputPMMR->Root(blockHeader.GetOutputMMRSize());
 	if (blockHeader.GetVersion() < 3)
 	{
 		if (outputRoot != blockHeader.GetOutputRoot())
@@ -180,7 +248,6 @@ bool TxHashSet::ValidateRoots(const BlockHeader& blockHeader) const
 	}
 	else
 	{
-		Hash UBMT = m_pOutputPMMR->UBMTRoot(MMRUtil::GetNumLeaves(blockHeader.GetOutputMMRSize() - 1));
 		Hash merged = MMRHashUtil::HashParentWithIndex(outputRoot, UBMT, blockHeader.GetOutputMMRSize());
 		if (merged != blockHeader.GetOutputRoot())
 		{
@@ -189,7 +256,7 @@ bool TxHashSet::ValidateRoots(const BlockHeader& blockHeader) const
 		}
 	}
 
-	if (m_pRangeProofPMMR->Root(blockHeader.GetOutputMMRSize()) != blockHeader.GetRangeProofRoot())
+	if (rangeProofRoot != blockHeader.GetRangeProofRoot())
 	{
 		LOG_ERROR_F("RangeProof root not matching for header ({})", blockHeader);
 		return false;
@@ -198,45 +265,15 @@ bool TxHashSet::ValidateRoots(const BlockHeader& blockHeader) const
 	return true;
 }
 
-TxHashSetRoots TxHashSet::GetRoots(const std::shared_ptr<const IBlockDB>& pBlockDB, const TransactionBody& body)
+TxHashSetRoots TxHashSet::GetRoots(const std::shared_ptr<const IBlockDB>& pBlockDB, const TransactionBody& body) const
 {
-	for (const auto& kernel : body.GetKernels())
-	{
-		m_pKernelMMR->ApplyKernel(kernel);
-	}
-
-	for (const auto& input : body.GetInputs())
-	{
-		const auto pOutputPosition = pBlockDB->GetOutputPosition(input.GetCommitment());
-		if (pOutputPosition == nullptr)
-		{
-			throw std::exception();
-		}
-
-		m_pOutputPMMR->Remove(pOutputPosition->GetMMRIndex());
-		m_pRangeProofPMMR->Remove(pOutputPosition->GetMMRIndex());
-	}
-
-	for (const auto& output : body.GetOutputs())
+	ITxHashSetOverlay::UPtr pOverlay = CreateOverlay(pBlockDB);
+	if (!pOverlay->Apply(body))
 	{
-		m_pOutputPMMR->Append(OutputIdentifier::FromOutput(output));
-		m_pRangeProofPMMR->Append(output.GetRangeProof());
+		throw TXHASHSET_EXCEPTION("Inputs or outputs invalid for current UTXO set");
 	}
 
-	const uint64_t numKernels = (MMRUtil::GetLeafIndex(m_pBlockHeader->GetKernelMMRSize())) + body.GetKernels().size();
-	const uint64_t kernelSize = MMRUtil::GetPMMRIndex(numKernels);
-	const auto kernelRoot = m_pKernelMMR->Root(kernelSize);
-
-	const uint64_t numOutputs = (MMRUtil::GetLeafIndex(m_pBlockHeader->GetOutputMMRSize())) + body.GetOutputs().size();
-	const uint64_t outputSize = MMRUtil::GetPMMRIndex(numOutputs);
-	const auto outputRoot = m_pOutputPMMR->Root(outputSize);
-	const auto rangeProofRoot = m_pRangeProofPMMR->Root(outputSize);
-
-	return TxHashSetRoots(
-		{ kernelRoot, kernelSize },
-		{ outputRoot, outputSize },
-		{ rangeProofRoot, outputSize }
-	);
+	return pOverlay->GetRoots();
 }
 
 void TxHashSet::SaveOutputPositions(const Chain::CPtr& pChain, std::shared_ptr<IBlockDB> pBlockDB) const
@@ -267,6 +304,111 @@ void TxHashSet::SaveOutputPositions(const Chain::CPtr& pChain, std::shared_ptr<I
 	}
 }
 
+uint64_t TxHashSet::GetNumKernels(const Chain::CPtr& pChain, const IBlockDB& blockDB, const uint64_t height) const
+{
+	auto pIndex = pChain->GetByHeight(height);
+	BlockHeaderPtr pHeader = pIndex != nullptr ? blockDB.GetBlockHeader(pIndex->GetHash()) : nullptr;
+	if (pHeader == nullptr)
+	{
+		throw TXHASHSET_EXCEPTION(StringUtil::Format("Header not found at height {}", height));
+	}
+
+	return MMRUtil::GetNumLeaves(pHeader->GetKernelMMRSize() - 1);
+}
+
+void TxHashSet::SaveKernelPositions(const Chain::CPtr& pChain, std::shared_ptr<IBlockDB> pBlockDB, const uint64_t firstHeight, const uint64_t lastHeight) const
+{
+	ForEachKernel(pChain, *pBlockDB, firstHeight, lastHeight, [&pBlockDB](const TransactionKernel& kernel, const OutputLocation& location) {
+		pBlockDB->AddKernelPosition(kernel.GetExcessCommitment(), location);
+	});
+}
+
+void TxHashSet::SaveNRDKernelPositions(const Chain::CPtr& pChain, std::shared_ptr<IBlockDB> pBlockDB, const uint64_t firstHeight, const uint64_t lastHeight) const
+{
+	ForEachKernel(pChain, *pBlockDB, firstHeight, lastHeight, [&pBlockDB](const TransactionKernel& kernel, const OutputLocation& location) {
+		if (kernel.GetFeatures() == EKernelFeatures::NO_RECENT_DUPLICATE)
+		{
+			pBlockDB->AddNRDKernelPosition(kernel.GetExcessCommitment(), location);
+		}
+	});
+}
+
+void TxHashSet::ForEachKernel(
+	const Chain::CPtr& pChain,
+	const IBlockDB& blockDB,
+	const uint64_t firstHeight,
+	const uint64_t lastHeight,
+	const std::function<void(const TransactionKernel&, const OutputLocation&)>& callback) const
+{
+	uint64_t firstLeafIndex = firstHeight == 0 ? 0 : GetNumKernels(pChain, blockDB, firstHeight - 1);
+	for (uint64_t height = firstHeight; height <= lastHeight; height++)
+	{
+		const uint64_t numKernels = GetNumKernels(pChain, blockDB, height);
+		if (numKernels > firstLeafIndex)
+		{
+			const std::vector<TransactionKernel> kernels = m_pKernelMMR->GetKernels(firstLeafIndex, numKernels - firstLeafIndex);
+			for (size_t i = 0; i < kernels.size(); i++)
+			{
+				const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(firstLeafIndex + i);
+				callback(kernels[i], OutputLocation(mmrIndex, height));
+			}
+		}
+
+		firstLeafIndex = numKernels;
+	}
+}
+
+std::unique_ptr<LocatedTxKernel> TxHashSet::FindKernel(
+	const Chain::CPtr& pChain,
+	std::shared_ptr<const IBlockDB> pBlockDB,
+	const Commitment& excessCommitment,
+	const uint64_t firstHeight,
+	const uint64_t lastHeight) const
+{
+	static const uint64_t KERNELS_PER_READ = 1000;
+
+	if (firstHeight > lastHeight)
+	{
+		return nullptr;
+	}
+
+	const uint64_t firstLeafIndex = firstHeight == 0 ? 0 : GetNumKernels(pChain, *pBlockDB, firstHeight - 1);
+	uint64_t endLeafIndex = GetNumKernels(pChain, *pBlockDB, lastHeight);
+	while (endLeafIndex > firstLeafIndex)
+	{
+		const uint64_t startLeafIndex = endLeafIndex - (std::min)(KERNELS_PER_READ, endLeafIndex - firstLeafIndex);
+		std::vector<TransactionKernel> kernels = m_pKernelMMR->GetKernels(startLeafIndex, endLeafIndex - startLeafIndex);
+		for (size_t i = kernels.size(); i > 0; i--)
+		{
+			if (kernels[i - 1].GetExcessCommitment() == excessCommitment)
+			{
+				// The kernel's block is the lowest one whose kernel MMR includes it.
+				const uint64_t leafIndex = startLeafIndex + i - 1;
+				uint64_t low = firstHeight;
+				uint64_t high = lastHeight;
+				while (low < high)
+				{
+					const uint64_t mid = low + ((high - low) / 2);
+					if (GetNumKernels(pChain, *pBlockDB, mid) > leafIndex)
+					{
+						high = mid;
+					}
+					else
+					{
+						low = mid + 1;
+					}
+				}
+
+				return std::make_unique<LocatedTxKernel>(std::move(kernels[i - 1]), low, MMRUtil::GetPMMRIndex(leafIndex));
+			}
+		}
+
+		endLeafIndex = startLeafIndex;
+	}
+
+	return nullptr;
+}
+
 std::vector<Hash> TxHashSet::GetLastKernelHashes(const uint64_t numberOfKernels) const
 {
 	return m_pKernelMMR->GetLastLeafHashes(numberOfKernels);
@@ -277,109 +419,256 @@ std::vector<Hash> TxHashSet::GetLastOutputHashes(const uint64_t numberOfOutputs)
 	return m_pOutputPMMR->GetLastLeafHashes(numberOfOutputs);
 }
 
+std::unique_ptr<MerkleProof> TxHashSet::GetOutputMerkleProof(const Commitment& commitment, const uint64_t mmrIndex, const uint64_t mmrSize) const
+{
+	std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetAt(mmrIndex);
+	if (pOutput == nullptr || pOutput->GetCommitment() != commitment)
+	{
+		return nullptr;
+	}
+
+	return std::make_unique<MerkleProof>(m_outputProofBuilder.BuildProof(*m_pOutputPMMR, mmrIndex, mmrSize));
+}
+
 std::vector<Hash> TxHashSet::GetLastRangeProofHashes(const uint64_t numberOfRangeProofs) const
 {
 	return m_pRangeProofPMMR->GetLastLeafHashes(numberOfRangeProofs);
 }
 
 OutputRange TxHashSet::GetOutputsByLeafIndex(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t maxNumOutputs) const
+{
+	return ScanOutputs(pBlockDB, startIndex, maxNumOutputs).ToRange();
+}
+
+OutputScanBatch TxHashSet::ScanOutputs(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t maxNumOutputs) const
 {
 	const uint64_t outputSize = m_pOutputPMMR->GetSize();
-	
-	uint64_t leafIndex = startIndex;
+	const uint64_t maxLeafIndex = MMRUtil::GetNumLeaves(outputSize - 1);
+
+	// Every rangeproof fits in an arena sized for the largest possible proofs, so the whole batch needs a single allocation.
+	const std::vector<uint64_t> leafIndices = m_pOutputPMMR->GetLeafSet()->GetUnspentLeaves(startIndex, maxLeafIndex, (size_t)maxNumOutputs);
+	auto pArena = std::make_shared<std::pmr::monotonic_buffer_resource>((std::max)(leafIndices.size() * MAX_PROOF_SIZE, (size_t)1));
+	std::vector<OutputDTO> outputs = ReadUnspentOutputs(*pBlockDB, leafIndices, pArena.get());
+
+	const uint64_t lastRetrievedIndex = outputs.empty() ? 0 : MMRUtil::GetNumLeaves(outputs.back().GetLocation().GetMMRIndex());
+
+	return OutputScanBatch(maxLeafIndex, lastRetrievedIndex, std::move(outputs), std::move(pArena));
+}
+
+std::vector<OutputDTO> TxHashSet::GetOutputsByMMRIndex(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t lastIndex) const
+{
+	const uint64_t lastLeafIndex = (std::min)(lastIndex, m_pOutputPMMR->GetSize() - 1);
+	if (m_pOutputPMMR->GetSize() == 0 || startIndex > lastLeafIndex)
+	{
+		return std::vector<OutputDTO>();
+	}
+
+	const uint64_t firstLeaf = MMRUtil::GetLeafIndex(startIndex);
+	const uint64_t endLeaf = MMRUtil::GetNumLeaves(lastLeafIndex);
+	const std::vector<uint64_t> leafIndices = m_pOutputPMMR->GetLeafSet()->GetUnspentLeaves(firstLeaf, endLeaf, (size_t)(endLeaf - firstLeaf));
+
+	return ReadUnspentOutputs(*pBlockDB, leafIndices, std::pmr::get_default_resource());
+}
+
+std::vector<OutputDTO> TxHashSet::ReadUnspentOutputs(
+	const IBlockDB& blockDB,
+	const std::vector<uint64_t>& leafIndices,
+	std::pmr::memory_resource* pMemoryResource) const
+{
+	// The outputs, rangeproofs, and positions are each read in one batch.
+	const auto outputLeaves = m_pOutputPMMR->GetLeaves(leafIndices);
+	auto proofLeaves = m_pRangeProofPMMR->GetLeaves(leafIndices, pMemoryResource);
+
+	std::vector<Commitment> commitments;
+	commitments.reserve(outputLeaves.size());
+	for (const auto& outputLeaf : outputLeaves)
+	{
+		commitments.push_back(outputLeaf.second.GetCommitment());
+	}
+
+	const std::vector<std::unique_ptr<OutputLocation>> positions = blockDB.GetOutputPositions(commitments);
+
 	std::vector<OutputDTO> outputs;
-	outputs.reserve(maxNumOutputs);
-	while (outputs.size() < maxNumOutputs)
+	outputs.reserve(outputLeaves.size());
+	for (size_t i = 0; i < outputLeaves.size(); i++)
 	{
-		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(leafIndex++);
-		if (mmrIndex >= outputSize)
+		const uint64_t mmrIndex = outputLeaves[i].first;
+		if (positions[i] == nullptr || positions[i]->GetMMRIndex() != mmrIndex)
 		{
-			break;
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Failed to build OutputDTO at index {}", mmrIndex));
 		}
 
-		std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetAt(mmrIndex);
-		if (pOutput != nullptr)
-		{
-			std::unique_ptr<RangeProof> pRangeProof = m_pRangeProofPMMR->GetAt(mmrIndex);
-			std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->GetOutputPosition(pOutput->GetCommitment());
-			if (pRangeProof == nullptr || pOutputPosition == nullptr || pOutputPosition->GetMMRIndex() != mmrIndex)
-			{
-				throw TXHASHSET_EXCEPTION(StringUtil::Format("Failed to build OutputDTO at index {}", mmrIndex));
-			}
+		// Moving the rangeproof keeps it in pMemoryResource.
+		outputs.emplace_back(OutputDTO(false, OutputIdentifier(outputLeaves[i].second), OutputLocation(*positions[i]), std::move(proofLeaves[i].second)));
+	}
 
-			outputs.emplace_back(OutputDTO(false, *pOutput, *pOutputPosition, *pRangeProof));
+	return outputs;
+}
+
+BlockHeaderPtr TxHashSet::GetBlocksSince(
+	const IBlockDB& blockDB,
+	const BlockHeaderPtr& pTip,
+	const BlockHeader& header,
+	std::vector<Hash>& blockHashes)
+{
+	BlockHeaderPtr pHeader = pTip;
+	while (*pHeader != header)
+	{
+		blockHashes.push_back(pHeader->GetHash());
+
+		pHeader = blockDB.GetBlockHeader(pHeader->GetPreviousHash());
+		if (pHeader == nullptr)
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Previous header not found while rewinding to {}", header));
 		}
 	}
 
-	const uint64_t maxLeafIndex = MMRUtil::GetNumLeaves(outputSize - 1);
-	const uint64_t lastRetrievedIndex = outputs.empty() ? 0 : MMRUtil::GetNumLeaves(outputs.back().GetLocation().GetMMRIndex());
-
-	return OutputRange(maxLeafIndex, lastRetrievedIndex, std::move(outputs));
+	return pHeader;
 }
 
-std::vector<OutputDTO> TxHashSet::GetOutputsByMMRIndex(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t lastIndex) const
+std::vector<std::unique_ptr<SpentOutputs>> TxHashSet::GetSpentOutputs(const IBlockDB& blockDB, const std::vector<Hash>& blockHashes)
 {
-	std::vector<OutputDTO> outputs;
-	uint64_t mmrIndex = startIndex;
-	while (mmrIndex <= lastIndex)
+	std::vector<std::unique_ptr<SpentOutputs>> spentOutputs = blockDB.GetSpentOutputs(blockHashes);
+	for (size_t i = 0; i < blockHashes.size(); i++)
 	{
-		std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetAt(mmrIndex);
-		if (pOutput != nullptr)
+		if (spentOutputs[i] == nullptr)
 		{
-			std::unique_ptr<RangeProof> pRangeProof = m_pRangeProofPMMR->GetAt(mmrIndex);
-			std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->GetOutputPosition(pOutput->GetCommitment());
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Spent outputs not found for block {}", blockHashes[i]));
+		}
+	}
+
+	return spentOutputs;
+}
+
+std::vector<uint64_t> TxHashSet::GetLeavesSpentSince(const IBlockDB& blockDB, const BlockHeader& header) const
+{
+	std::vector<Hash> blockHashes;
+	GetBlocksSince(blockDB, m_pBlockHeaderBackup, header, blockHashes);
 
-			outputs.emplace_back(OutputDTO(false, *pOutput, *pOutputPosition, *pRangeProof));
+	std::vector<uint64_t> spentLeaves;
+	for (const auto& pSpentOutputs : GetSpentOutputs(blockDB, blockHashes))
+	{
+		for (const SpentOutput& spent : pSpentOutputs->GetSpentOutputs())
+		{
+			spentLeaves.push_back(MMRUtil::GetLeafIndex(spent.GetLocation().GetMMRIndex()));
 		}
+	}
 
-		++mmrIndex;
+	return spentLeaves;
+}
+
+void TxHashSet::RewindSnapshot(const BlockHeaderPtr& pHeader, const std::vector<uint64_t>& spentLeaves)
+{
+	m_pKernelMMR->Rewind(pHeader->GetKernelMMRSize());
+	m_pOutputPMMR->Rewind(pHeader->GetOutputMMRSize(), spentLeaves);
+	m_pRangeProofPMMR->Rewind(pHeader->GetOutputMMRSize(), spentLeaves);
+	m_pBlockHeader = pHeader;
+}
+
+void TxHashSet::SnapshotLeafSets(const BlockHeader& header, const std::vector<uint64_t>& spentLeaves, const fs::path& directory) const
+{
+	LeafSetSnapshot snapshot;
+	snapshot.numLeaves = MMRUtil::GetNumLeaves(header.GetOutputMMRSize() - 1);
+	for (const uint64_t leafIndex : spentLeaves)
+	{
+		// Outputs created and spent since the block are past numLeaves, so they're not restored.
+		if (leafIndex < snapshot.numLeaves)
+		{
+			snapshot.restoredLeaves.push_back(leafIndex);
+		}
 	}
 
-	return outputs;
+	const std::string fileName = StringUtil::Format("pmmr_leaf.bin.{}", header.ShortHash());
+	m_pOutputPMMR->GetLeafSet()->WriteSnapshot(snapshot, directory / "output" / fileName);
+	m_pRangeProofPMMR->GetLeafSet()->WriteSnapshot(snapshot, directory / "rangeproof" / fileName);
 }
 
+//
+// Rewinds every block since the given one at once: the blocks and their spent outputs are each read in a single batch,
+// and each MMR is rewound once, restoring the union of the leaves spent by all of them.
+// Only the inputs, output commitments, and kernels of the blocks are needed, so their rangeproofs aren't read.
+//
 void TxHashSet::Rewind(std::shared_ptr<IBlockDB> pBlockDB, const BlockHeader& header)
 {
-	std::vector<uint64_t> leavesToAdd;
-	while (*m_pBlockHeader != header)
+	std::vector<Hash> blockHashes;
+	BlockHeaderPtr pHeader = GetBlocksSince(*pBlockDB, m_pBlockHeader, header, blockHashes);
+
+	const std::vector<std::unique_ptr<BlockParts>> blocks = pBlockDB->GetBlockParts(
+		blockHashes,
+		EBlockPart::INPUTS | EBlockPart::OUTPUTS | EBlockPart::KERNELS
+	);
+	const std::vector<std::unique_ptr<SpentOutputs>> spentOutputs = GetSpentOutputs(*pBlockDB, blockHashes);
+
+	std::vector<Commitment> outputsCreated;
+	std::vector<Commitment> kernelsCreated;
+	std::vector<Commitment> nrdKernelsCreated;
+	for (size_t i = 0; i < blocks.size(); i++)
 	{
-		auto pBlock = pBlockDB->GetBlock(m_pBlockHeader->GetHash());
-		if (pBlock == nullptr)
+		if (blocks[i] == nullptr)
 		{
-			throw TXHASHSET_EXCEPTION(StringUtil::Format("Block not found for {}", *m_pBlockHeader));
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Block not found for {}", blockHashes[i]));
 		}
 
-		std::unordered_map<Commitment, OutputLocation> spentOutputs = pBlockDB->GetSpentPositions(m_pBlockHeader->GetHash());
+		if (spentOutputs[i]->GetSpentOutputs().size() != blocks[i]->inputs.size())
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Spent outputs don't match the inputs of {}", *blocks[i]->pHeader));
+		}
 
-		pBlockDB->RemoveOutputPositions(pBlock->GetOutputCommitments());
+		for (const OutputIdentifier& output : blocks[i]->outputs)
+		{
+			outputsCreated.push_back(output.GetCommitment());
+		}
 
-		for (const auto& input : pBlock->GetInputs())
+		for (const TransactionKernel& kernel : blocks[i]->kernels)
 		{
-			auto iter = spentOutputs.find(input.GetCommitment());
-			if (iter == spentOutputs.end())
+			kernelsCreated.push_back(kernel.GetExcessCommitment());
+			if (kernel.GetFeatures() == EKernelFeatures::NO_RECENT_DUPLICATE)
 			{
-				throw TXHASHSET_EXCEPTION(StringUtil::Format("Spent output not found for {}", input.GetCommitment()));
+				nrdKernelsCreated.push_back(kernel.GetExcessCommitment());
 			}
-
-			pBlockDB->AddOutputPosition(input.GetCommitment(), iter->second);
-			leavesToAdd.push_back(MMRUtil::GetLeafIndex(iter->second.GetMMRIndex()));
 		}
+	}
+
+	// An excess reused by an earlier block (eg. an NRD kernel) loses its entry too, though the lookup falls back to a scan.
+	// The NRD index keeps earlier occurrences, so those are restored.
+	pBlockDB->RemoveOutputPositions(outputsCreated);
+	pBlockDB->RemoveKernelPositions(kernelsCreated);
+	pBlockDB->RewindNRDKernelPositions(nrdKernelsCreated, header.GetKernelMMRSize());
 
-		m_pBlockHeader = pBlockDB->GetBlockHeader(m_pBlockHeader->GetPreviousHash());
+	// Outputs that were both created and spent since the block don't exist at it, so only older spent outputs are restored.
+	// The positions are restored after every created output was removed, in case a commitment was spent and then created again.
+	std::vector<uint64_t> leavesToAdd;
+	for (const auto& pSpentOutputs : spentOutputs)
+	{
+		for (const SpentOutput& spent : pSpentOutputs->GetSpentOutputs())
+		{
+			if (spent.GetLocation().GetMMRIndex() < header.GetOutputMMRSize())
+			{
+				pBlockDB->AddOutputPosition(spent.GetCommitment(), spent.GetLocation());
+				leavesToAdd.push_back(MMRUtil::GetLeafIndex(spent.GetLocation().GetMMRIndex()));
+			}
+		}
 	}
 
+	std::sort(leavesToAdd.begin(), leavesToAdd.end());
+	m_pBlockHeader = pHeader;
+
 	m_pKernelMMR->Rewind(header.GetKernelMMRSize());
 	m_pOutputPMMR->Rewind(header.GetOutputMMRSize(), leavesToAdd);
 	m_pRangeProofPMMR->Rewind(header.GetOutputMMRSize(), leavesToAdd);
 }
 
+//
+// The kernel, output, and rangeproof MMRs each have their own files, and each MMR commits its files concurrently too,
+// so the writes and syncs of every dirty file are in flight at once rather than one file after another.
+//
 void TxHashSet::Commit()
 {
-	std::vector<std::thread> threads;
-	threads.emplace_back(std::thread([this] { this->m_pKernelMMR->Commit(); }));
-	threads.emplace_back(std::thread([this] { this->m_pOutputPMMR->Commit(); }));
-	threads.emplace_back(std::thread([this] { this->m_pRangeProofPMMR->Commit(); }));
-	ThreadUtil::JoinAll(threads);
+	ThreadManagerAPI::GetThreadPool().RunAll({
+		[this] { m_pKernelMMR->Commit(); },
+		[this] { m_pOutputPMMR->Commit(); },
+		[this] { m_pRangeProofPMMR->Commit(); }
+	}, ETaskPriority::HIGH);
 
 	m_pBlockHeaderBackup = m_pBlockHeader;
 }
@@ -392,7 +681,63 @@ void TxHashSet::Rollback() noexcept
 	m_pBlockHeader = m_pBlockHeaderBackup;
 }
 
-void TxHashSet::Compact()
+fs::path TxHashSet::GetCompactionManifestPath(const fs::path& txHashSetPath)
+{
+	return txHashSetPath / "compaction.manifest";
+}
+
+void TxHashSet::RecoverCompaction(const fs::path& txHashSetPath)
 {
-	// TODO: Implement
+	PMMRCompactor::Recover(
+		GetCompactionManifestPath(txHashSetPath),
+		{ txHashSetPath / "output", txHashSetPath / "rangeproof" }
+	);
+}
+
+ITxHashSetCompaction::UPtr TxHashSet::PrepareCompaction(const IBlockDB& blockDB, const BlockHeaderPtr& pHorizonHeader) const
+{
+	const std::vector<uint64_t> spentLeaves = GetLeavesSpentSince(blockDB, *pHorizonHeader);
+	const uint64_t horizonSize = pHorizonHeader->GetOutputMMRSize();
+
+	return std::make_unique<TxHashSetCompaction>(
+		this,
+		pHorizonHeader,
+		m_pOutputPMMR->CreateCompactor(horizonSize, spentLeaves),
+		m_pRangeProofPMMR->CreateCompactor(horizonSize, spentLeaves)
+	);
+}
+
+void TxHashSet::ApplyCompaction(ITxHashSetCompaction& compaction)
+{
+	TxHashSetCompaction* pCompaction = dynamic_cast<TxHashSetCompaction*>(&compaction);
+	if (pCompaction == nullptr || pCompaction->GetTxHashSet() != this)
+	{
+		throw TXHASHSET_EXCEPTION("Compaction was prepared for a different TxHashSet");
+	}
+
+	PMMRCompactor& outputCompactor = pCompaction->GetOutputCompactor();
+	PMMRCompactor& rangeProofCompactor = pCompaction->GetRangeProofCompactor();
+	m_pOutputPMMR->StageCompaction(outputCompactor);
+	m_pRangeProofPMMR->StageCompaction(rangeProofCompactor);
+
+	// Once the manifest is written, the compaction is committed. Each file swap is a rename, and if any are interrupted,
+	// RecoverCompaction finishes them on the next startup, so the output and rangeproof files are never left out of step.
+	const fs::path manifestPath = GetCompactionManifestPath(m_config.GetNodeConfig().GetTxHashSetPath());
+	PMMRCompactor::WriteManifest(manifestPath, { &outputCompactor, &rangeProofCompactor });
+	outputCompactor.SetCommitted();
+	rangeProofCompactor.SetCommitted();
+
+	m_pOutputPMMR->SwapInCompaction(outputCompactor);
+	m_pRangeProofPMMR->SwapInCompaction(rangeProofCompactor);
+	FileUtil::RemoveFile(manifestPath);
+
+	LOG_INFO_F(
+		"Compacted to {}: pruned {} outputs, removing {} output hashes, {} outputs, {} rangeproof hashes, and {} rangeproofs",
+		*pCompaction->GetHorizonHeader(),
+		outputCompactor.GetNumPrunedLeaves(),
+		outputCompactor.GetNumRemovedHashes(),
+		outputCompactor.GetNumRemovedData(),
+		rangeProofCompactor.GetNumRemovedHashes(),
+		rangeProofCompactor.GetNumRemovedData()
+	);
 }
\ No newline at end of file
@@ -3,12 +3,50 @@
 #include "KernelMMR.h"
 #include "OutputPMMR.h"
 #include "RangeProofPMMR.h"
+#include "Common/MerkleProofBuilder.h"
 
 #include <PMMR/TxHashSet.h>
 #include <Config/Config.h>
+#include <Core/Models/SpentOutput.h>
+#include <functional>
+#include <memory_resource>
 #include <shared_mutex>
 #include <string>
 
+class TxHashSetCompaction : public ITxHashSetCompaction
+{
+public:
+	TxHashSetCompaction(
+		const ITxHashSet* pTxHashSet,
+		const BlockHeaderPtr& pHorizonHeader,
+		PMMRCompactor::UPtr&& pOutputCompactor,
+		PMMRCompactor::UPtr&& pRangeProofCompactor)
+		: m_pTxHashSet(pTxHashSet),
+		m_pHorizonHeader(pHorizonHeader),
+		m_pOutputCompactor(std::move(pOutputCompactor)),
+		m_pRangeProofCompactor(std::move(pRangeProofCompactor)) { }
+
+	void Build() final
+	{
+		m_pOutputCompactor->Build();
+		m_pRangeProofCompactor->Build();
+	}
+
+	const BlockHeaderPtr& GetHorizonHeader() const noexcept final { return m_pHorizonHeader; }
+	bool IsEmpty() const noexcept final { return m_pOutputCompactor->IsEmpty() && m_pRangeProofCompactor->IsEmpty(); }
+	uint64_t GetNumPrunedOutputs() const noexcept final { return m_pOutputCompactor->GetNumPrunedLeaves(); }
+
+	const ITxHashSet* GetTxHashSet() const noexcept { return m_pTxHashSet; }
+	PMMRCompactor& GetOutputCompactor() noexcept { return *m_pOutputCompactor; }
+	PMMRCompactor& GetRangeProofCompactor() noexcept { return *m_pRangeProofCompactor; }
+
+private:
+	const ITxHashSet* m_pTxHashSet;
+	BlockHeaderPtr m_pHorizonHeader;
+	PMMRCompactor::UPtr m_pOutputCompactor;
+	PMMRCompactor::UPtr m_pRangeProofCompactor;
+};
+
 class TxHashSet : public ITxHashSet
 {
 public:
@@ -21,36 +59,127 @@ public:
 	);
 	virtual ~TxHashSet() = default;
 
+	//
+	// Finishes a compaction that was committed but interrupted before all of its files were swapped in,
+	// or discards the staged files of one that wasn't committed. Called before the MMRs are loaded.
+	//
+	static void RecoverCompaction(const fs::path& txHashSetPath);
+
 	BlockHeaderPtr GetFlushedBlockHeader() const noexcept final { return m_pBlockHeaderBackup; }
 
 	bool IsValid(std::shared_ptr<const IBlockDB> pBlockDB, const Transaction& transaction) const final;
+	ITxHashSetOverlay::UPtr CreateOverlay(std::shared_ptr<const IBlockDB> pBlockDB) const final;
 	std::unique_ptr<BlockSums> ValidateTxHashSet(const BlockHeader& header, const IBlockChain& blockChain, SyncStatus& syncStatus) final;
 	bool ApplyBlock(std::shared_ptr<IBlockDB> pBlockDB, const FullBlock& block) final;
 	bool ValidateRoots(const BlockHeader& blockHeader) const final;
-	TxHashSetRoots GetRoots(const std::shared_ptr<const IBlockDB>& pBlockDB, const TransactionBody& body) final;
+	TxHashSetRoots GetRoots(const std::shared_ptr<const IBlockDB>& pBlockDB, const TransactionBody& body) const final;
 	void SaveOutputPositions(const Chain::CPtr& pChain, std::shared_ptr<IBlockDB> pBlockDB) const final;
+	void SaveKernelPositions(const Chain::CPtr& pChain, std::shared_ptr<IBlockDB> pBlockDB, const uint64_t firstHeight, const uint64_t lastHeight) const final;
+	void SaveNRDKernelPositions(const Chain::CPtr& pChain, std::shared_ptr<IBlockDB> pBlockDB, const uint64_t firstHeight, const uint64_t lastHeight) const final;
+	std::unique_ptr<LocatedTxKernel> FindKernel(
+		const Chain::CPtr& pChain,
+		std::shared_ptr<const IBlockDB> pBlockDB,
+		const Commitment& excessCommitment,
+		const uint64_t firstHeight,
+		const uint64_t lastHeight
+	) const final;
 
 	std::vector<Hash> GetLastKernelHashes(const uint64_t numberOfKernels) const final;
 	std::vector<Hash> GetLastOutputHashes(const uint64_t numberOfOutputs) const final;
 	std::vector<Hash> GetLastRangeProofHashes(const uint64_t numberOfRangeProofs) const final;
 	OutputRange GetOutputsByLeafIndex(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t maxNumOutputs) const final;
+	OutputScanBatch ScanOutputs(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t maxNumOutputs) const final;
 	std::vector<OutputDTO> GetOutputsByMMRIndex(std::shared_ptr<const IBlockDB> pBlockDB, const uint64_t startIndex, const uint64_t lastIndex) const final;
+	std::unique_ptr<MerkleProof> GetOutputMerkleProof(const Commitment& commitment, const uint64_t mmrIndex, const uint64_t mmrSize) const final;
 
+	std::vector<uint64_t> GetLeavesSpentSince(const IBlockDB& blockDB, const BlockHeader& header) const final;
 	void Rewind(std::shared_ptr<IBlockDB> pBlockDB, const BlockHeader& header) final;
 	void Commit() final;
 	void Rollback() noexcept final;
-	void Compact() final;
+	ITxHashSetCompaction::UPtr PrepareCompaction(const IBlockDB& blockDB, const BlockHeaderPtr& pHorizonHeader) const final;
+	void ApplyCompaction(ITxHashSetCompaction& compaction) final;
 
 	std::shared_ptr<KernelMMR> GetKernelMMR() { return m_pKernelMMR; }
 	std::shared_ptr<OutputPMMR> GetOutputPMMR() { return m_pOutputPMMR; }
 	std::shared_ptr<RangeProofPMMR> GetRangeProofPMMR() { return m_pRangeProofPMMR; }
 
+	//
+	// Rewinds the MMRs of a copied TxHashSet to the given block, using the leaves from GetLeavesSpentSince.
+	// Unlike Rewind, this leaves the database alone, since the copy is only used to build an archive.
+	//
+	void RewindSnapshot(const BlockHeaderPtr& pHeader, const std::vector<uint64_t>& spentLeaves);
+
+	//
+	// Writes the output and rangeproof leafsets as of the given block to output/pmmr_leaf.bin.<ShortHash>
+	// and rangeproof/pmmr_leaf.bin.<ShortHash> under the directory, for TxHashSet archives.
+	//
+	void SnapshotLeafSets(const BlockHeader& header, const std::vector<uint64_t>& spentLeaves, const fs::path& directory) const;
+
+	//
+	// Skips kernel signature verification in ValidateTxHashSet, for kernels verified by TxHashSetDownload.
+	//
+	void SetKernelSignaturesVerified(const bool verified) noexcept { m_kernelSignaturesVerified = verified; }
+
+	//
+	// Skips rangeproof and kernel signature verification in ValidateTxHashSet, for snapshots signed by the operator key.
+	//
+	void SetProofsTrusted(const bool trusted) noexcept { m_proofsTrusted = trusted; }
+
 private:
+	//
+	// Reads the given unspent leaves (ascending, eg. from LeafSet::GetUnspentLeaves) and their positions,
+	// with the rangeproofs allocated from pMemoryResource.
+	//
+	std::vector<OutputDTO> ReadUnspentOutputs(
+		const IBlockDB& blockDB,
+		const std::vector<uint64_t>& leafIndices,
+		std::pmr::memory_resource* pMemoryResource
+	) const;
+
+	//
+	// Returns the number of kernels in the kernel MMR as of the block on the chain at the given height.
+	//
+	uint64_t GetNumKernels(const Chain::CPtr& pChain, const IBlockDB& blockDB, const uint64_t height) const;
+
+	//
+	// Calls callback with each kernel of the blocks on the chain from firstHeight through lastHeight, and its position.
+	//
+	void ForEachKernel(
+		const Chain::CPtr& pChain,
+		const IBlockDB& blockDB,
+		const uint64_t firstHeight,
+		const uint64_t lastHeight,
+		const std::function<void(const TransactionKernel&, const OutputLocation&)>& callback
+	) const;
+
+	void SetAccessHint(const EFileAccess access);
+
+	static fs::path GetCompactionManifestPath(const fs::path& txHashSetPath);
+
+	//
+	// Collects the hashes of the blocks from pTip back to (but not including) the given block, newest first.
+	// Only headers are read, so the blocks can then be looked up in a single batch. Returns the given block's header.
+	//
+	static BlockHeaderPtr GetBlocksSince(
+		const IBlockDB& blockDB,
+		const BlockHeaderPtr& pTip,
+		const BlockHeader& header,
+		std::vector<Hash>& blockHashes
+	);
+
+	//
+	// Looks up the outputs spent by each of the blocks in a single batch, throwing if any are missing.
+	//
+	static std::vector<std::unique_ptr<SpentOutputs>> GetSpentOutputs(const IBlockDB& blockDB, const std::vector<Hash>& blockHashes);
+
 	const Config& m_config;
 	std::shared_ptr<KernelMMR> m_pKernelMMR;
 	std::shared_ptr<OutputPMMR> m_pOutputPMMR;
 	std::shared_ptr<RangeProofPMMR> m_pRangeProofPMMR;
+	MerkleProofBuilder m_outputProofBuilder;
 
 	BlockHeaderPtr m_pBlockHeader;
 	BlockHeaderPtr m_pBlockHeaderBackup;
+	bool m_kernelSignaturesVerified;
+	bool m_proofsTrusted;
 };
@@ -4,12 +4,20 @@
 #include "Zip/TxHashSetZip.h"
 #include "Zip/Zipper.h"
 
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
 #include <Common/Util/FileUtil.h>
 #include <Common/Util/StringUtil.h>
 #include <Core/File/FileRemover.h>
+#include <Core/Exceptions/TxHashSetException.h>
 #include <Common/Logger.h>
+#include <Crypto/ED25519.h>
+#include <Crypto/Hasher.h>
 
 #include <filesystem.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 
 TxHashSetManager::TxHashSetManager(const Config& config)
 	: m_config(config), m_pTxHashSet(nullptr)
@@ -21,16 +29,75 @@ std::shared_ptr<ITxHashSet> TxHashSetManager::Open(BlockHeaderPtr pConfirmedTip,
 {
 	Close();
 
-	std::shared_ptr<KernelMMR> pKernelMMR = KernelMMR::Load(m_config.GetNodeConfig().GetTxHashSetPath(), genesisBlock);
-	std::shared_ptr<OutputPMMR> pOutputPMMR = OutputPMMR::Load(m_config.GetNodeConfig().GetTxHashSetPath(), genesisBlock);
-	std::shared_ptr<RangeProofPMMR> pRangeProofPMMR = RangeProofPMMR::Load(m_config.GetNodeConfig().GetTxHashSetPath(), genesisBlock);
+	const auto start = std::chrono::steady_clock::now();
+	const fs::path txHashSetPath = m_config.GetNodeConfig().GetTxHashSetPath();
+	TxHashSet::RecoverCompaction(txHashSetPath);
+
+	// The MMRs are in separate folders, so they're loaded at the same time.
+	ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+	std::future<std::shared_ptr<KernelMMR>> kernelLoaded = threadPool.Submit([&txHashSetPath, &genesisBlock] { return KernelMMR::Load(txHashSetPath, genesisBlock); });
+	std::future<std::shared_ptr<OutputPMMR>> outputLoaded = threadPool.Submit([&txHashSetPath, &genesisBlock] { return OutputPMMR::Load(txHashSetPath, genesisBlock); });
+	std::shared_ptr<RangeProofPMMR> pRangeProofPMMR = nullptr;
+	std::exception_ptr pException = nullptr;
+	try
+	{
+		pRangeProofPMMR = RangeProofPMMR::Load(txHashSetPath, genesisBlock);
+	}
+	catch (...)
+	{
+		pException = std::current_exception();
+	}
+
+	threadPool.Wait(kernelLoaded);
+	threadPool.Wait(outputLoaded);
+	if (pException != nullptr)
+	{
+		std::rethrow_exception(pException);
+	}
+
+	std::shared_ptr<KernelMMR> pKernelMMR = kernelLoaded.get();
+	std::shared_ptr<OutputPMMR> pOutputPMMR = outputLoaded.get();
+
+	LOG_INFO_F(
+		"Loaded TxHashSet in {}ms",
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+	);
 
 	m_pTxHashSet = std::shared_ptr<TxHashSet>(new TxHashSet(m_config, pKernelMMR, pOutputPMMR, pRangeProofPMMR, pConfirmedTip));
 
 	return m_pTxHashSet;
 }
 
-std::shared_ptr<ITxHashSet> TxHashSetManager::LoadFromZip(const Config& config, const fs::path& zipFilePath, BlockHeaderPtr pHeader)
+// Creates the leafset BitmapFile from the Roaring file included in the zip.
+static void CreateLeafSet(const fs::path& folderPath)
+{
+	Roaring bitmap;
+	std::vector<unsigned char> bytes;
+	if (FileUtil::ReadFile(folderPath / "pmmr_leaf.bin", bytes))
+	{
+		bitmap = Roaring::readSafe((const char*)bytes.data(), bytes.size());
+	}
+
+	BitmapFile::Create(folderPath / "pmmr_leafset.bin", bitmap);
+}
+
+// Replaces the TxHashSet folders with the ones TxHashSetDownload extracted, calling onFolderExtracted for each like TxHashSetZip::Extract.
+static void MoveStagedFolders(const fs::path& stagingPath, const fs::path& txHashSetPath, const TxHashSetZip::FolderCallback& onFolderExtracted)
+{
+	const std::vector<std::string> folders = { "kernel", "output", "rangeproof" };
+	for (const std::string& folder : folders)
+	{
+		FileUtil::RemoveFile(txHashSetPath / folder);
+		FileUtil::RenameFile(stagingPath / folder, txHashSetPath / folder);
+		onFolderExtracted(folder);
+	}
+}
+
+std::shared_ptr<ITxHashSet> TxHashSetManager::LoadFromZip(
+	const Config& config,
+	const fs::path& zipFilePath,
+	BlockHeaderPtr pHeader,
+	const TxHashSetDownload* pDownload)
 {
 	FileRemover fileRemover(zipFilePath);
 
@@ -38,49 +105,53 @@ std::shared_ptr<ITxHashSet> TxHashSetManager::LoadFromZip(const Config& config,
 	const FullBlock& genesisBlock = config.GetEnvironment().GetGenesisBlock();
 	const TxHashSetZip zip(config);
 
-	try
-	{
-		if (zip.Extract(zipFilePath, *pHeader))
+	// Each MMR is rewound on its extraction thread as soon as its folder is written, while the other folders are still inflating.
+	std::shared_ptr<KernelMMR> pKernelMMR = nullptr;
+	std::shared_ptr<OutputPMMR> pOutputPMMR = nullptr;
+	std::shared_ptr<RangeProofPMMR> pRangeProofPMMR = nullptr;
+	auto onFolderExtracted = [&](const std::string& folderName) {
+		if (folderName == "kernel")
 		{
-			LOG_INFO_F("{} extracted successfully", zipFilePath);
-			FileUtil::RemoveFile(zipFilePath);
-
-			// Rewind Kernel MMR
-			std::shared_ptr<KernelMMR> pKernelMMR = KernelMMR::Load(txHashSetPath, genesisBlock);
+			pKernelMMR = KernelMMR::Load(txHashSetPath, genesisBlock);
 			pKernelMMR->Rewind(pHeader->GetKernelMMRSize());
 			pKernelMMR->Commit();
+		}
+		else if (folderName == "output")
+		{
+			CreateLeafSet(txHashSetPath / "output");
 
-			// Create output BitmapFile from Roaring file
-			const fs::path leafPath = txHashSetPath / "output" / "pmmr_leaf.bin";
-			Roaring outputBitmap;
-			std::vector<unsigned char> outputBytes;
-			if (FileUtil::ReadFile(leafPath, outputBytes))
-			{
-				outputBitmap = Roaring::readSafe((const char*)outputBytes.data(), outputBytes.size());
-			}
-			BitmapFile::Create(txHashSetPath / "output" / "pmmr_leafset.bin", outputBitmap);
-
-			// Rewind Output MMR
-			std::shared_ptr<OutputPMMR> pOutputPMMR = OutputPMMR::Load(txHashSetPath, genesisBlock);
+			pOutputPMMR = OutputPMMR::Load(txHashSetPath, genesisBlock);
 			pOutputPMMR->Rewind(pHeader->GetOutputMMRSize(), {});
 			pOutputPMMR->Commit();
+		}
+		else if (folderName == "rangeproof")
+		{
+			CreateLeafSet(txHashSetPath / "rangeproof");
 
-			// Create rangeproof BitmapFile from Roaring file
-			const fs::path rangeproofPath = txHashSetPath / "rangeproof" / "pmmr_leaf.bin";
-			Roaring rangeproofBitmap;
-			std::vector<unsigned char> rangeproofBytes;
-			if (FileUtil::ReadFile(rangeproofPath, rangeproofBytes))
-			{
-				rangeproofBitmap = Roaring::readSafe((const char*)rangeproofBytes.data(), rangeproofBytes.size());
-			}
-			BitmapFile::Create(txHashSetPath / "rangeproof" / "pmmr_leafset.bin", rangeproofBitmap);
-
-			// Rewind RangeProof MMR
-			std::shared_ptr<RangeProofPMMR> pRangeProofPMMR = RangeProofPMMR::Load(txHashSetPath, genesisBlock);
+			pRangeProofPMMR = RangeProofPMMR::Load(txHashSetPath, genesisBlock);
 			pRangeProofPMMR->Rewind(pHeader->GetOutputMMRSize(), {});
 			pRangeProofPMMR->Commit();
+		}
+	};
+
+	try
+	{
+		const bool streamed = pDownload != nullptr && pDownload->IsExtracted() && pDownload->GetHeader()->GetHash() == pHeader->GetHash();
+		if (streamed)
+		{
+			LOG_INFO_F("Using TxHashSet files extracted while downloading {}", zipFilePath);
+			MoveStagedFolders(pDownload->GetStagingPath(), txHashSetPath, onFolderExtracted);
+		}
 
-			return std::shared_ptr<TxHashSet>(new TxHashSet(config, pKernelMMR, pOutputPMMR, pRangeProofPMMR, pHeader));
+		if (streamed || zip.Extract(zipFilePath, *pHeader, onFolderExtracted))
+		{
+			LOG_INFO_F("{} extracted successfully", zipFilePath);
+			FileUtil::RemoveFile(zipFilePath);
+
+			auto pTxHashSet = std::shared_ptr<TxHashSet>(new TxHashSet(config, pKernelMMR, pOutputPMMR, pRangeProofPMMR, pHeader));
+			pTxHashSet->SetKernelSignaturesVerified(streamed && pDownload->AreKernelSignaturesVerified());
+
+			return pTxHashSet;
 		}
 	}
 	catch (std::exception& e)
@@ -91,57 +162,47 @@ std::shared_ptr<ITxHashSet> TxHashSetManager::LoadFromZip(const Config& config,
 	return nullptr;
 }
 
-fs::path TxHashSetManager::SaveSnapshot(std::shared_ptr<IBlockDB> pBlockDB, BlockHeaderPtr pHeader) const
+std::unique_ptr<TxHashSetManager::SnapshotCopy> TxHashSetManager::CopySnapshot(const IBlockDB& blockDB, BlockHeaderPtr pHeader) const
 {
 	if (m_pTxHashSet == nullptr)
 	{
-		throw std::exception();
+		throw TXHASHSET_EXCEPTION("TxHashSet not open");
 	}
 
-	fs::path snapshotDir = fs::temp_directory_path() / "Snapshots" / pHeader->ShortHash();
-	FileRemover snapshotRemover(snapshotDir);
+	// Copies from the same block can overlap, eg. one still being zipped while a newer one is requested.
+	static std::atomic<uint64_t> nextCopyId = 0;
+	const std::string dirName = StringUtil::Format("{}.{}", pHeader->ShortHash(), nextCopyId++);
+	auto pCopy = std::make_unique<SnapshotCopy>(pHeader, fs::temp_directory_path() / "Snapshots" / dirName);
+
+	FileUtil::CopyDirectory(m_config.GetNodeConfig().GetTxHashSetPath(), pCopy->directory);
+	pCopy->pFlushedHeader = m_pTxHashSet->GetFlushedBlockHeader();
+	pCopy->spentLeaves = m_pTxHashSet->GetLeavesSpentSince(blockDB, *pHeader);
 
-	const std::string fileName = StringUtil::Format("TxHashSet.{}.zip", pHeader->ShortHash());
+	return pCopy;
+}
+
+TxHashSetArchive::CPtr TxHashSetManager::BuildSnapshot(const Config& config, const SnapshotCopy& snapshotCopy)
+{
+	const fs::path& snapshotDir = snapshotCopy.directory;
+	const std::string fileName = StringUtil::Format("TxHashSet.{}.zip", snapshotDir.filename().u8string());
 	fs::path zipFilePath = fs::temp_directory_path() / "Snapshots" / fileName;
 
 	try
 	{
-		BlockHeaderPtr pFlushedHeader = nullptr;
-
-		{
-			// Copy to Snapshots/Hash // TODO: If already exists, just use that.
-			FileUtil::CopyDirectory(m_config.GetNodeConfig().GetTxHashSetPath(), snapshotDir);
+		const FullBlock& genesisBlock = config.GetEnvironment().GetGenesisBlock();
 
-			pFlushedHeader = m_pTxHashSet->GetFlushedBlockHeader();
-		}
-
-		{
-			const FullBlock& genesisBlock = m_config.GetEnvironment().GetGenesisBlock();
+		// Load Snapshot TxHashSet
+		auto pKernelMMR = KernelMMR::Load(snapshotDir, genesisBlock);
+		auto pOutputPMMR = OutputPMMR::Load(snapshotDir, genesisBlock);
+		auto pRangeProofPMMR = RangeProofPMMR::Load(snapshotDir, genesisBlock);
+		TxHashSet snapshotTxHashSet(config, pKernelMMR, pOutputPMMR, pRangeProofPMMR, snapshotCopy.pFlushedHeader);
 
-			// Load Snapshot TxHashSet
-			auto pKernelMMR = KernelMMR::Load(snapshotDir, genesisBlock);
-			auto pOutputPMMR = OutputPMMR::Load(snapshotDir, genesisBlock);
-			auto pRangeProofPMMR = RangeProofPMMR::Load(snapshotDir, genesisBlock);
-			TxHashSet snapshotTxHashSet(m_config, pKernelMMR, pOutputPMMR, pRangeProofPMMR, pFlushedHeader);
-
-			// Rewind Snapshot TxHashSet
-			snapshotTxHashSet.Rewind(pBlockDB, *pHeader);
-
-			// Flush Snapshot TxHashSet
-			snapshotTxHashSet.Commit();
-		}
+		// The archived leafsets are reconstructed from the copied ones and the leaves spent since the block.
+		snapshotTxHashSet.SnapshotLeafSets(*snapshotCopy.pHeader, snapshotCopy.spentLeaves, snapshotDir);
 
-		// Rename pmmr_leaf files
-		const std::string newFileName = StringUtil::Format("pmmr_leaf.bin.{}", pHeader->ShortHash());
-		FileUtil::RenameFile(
-			snapshotDir / "output" / "pmmr_leaf.bin",
-			snapshotDir / "output" / newFileName
-		);
-
-		FileUtil::RenameFile(
-			snapshotDir / "rangeproof" / "pmmr_leaf.bin",
-			snapshotDir / "rangeproof" / newFileName
-		);
+		// Rewind and flush Snapshot TxHashSet
+		snapshotTxHashSet.RewindSnapshot(snapshotCopy.pHeader, snapshotCopy.spentLeaves);
+		snapshotTxHashSet.Commit();
 
 		// Create Zip
 		const std::vector<fs::path> pathsToZip = {
@@ -157,5 +218,260 @@ fs::path TxHashSetManager::SaveSnapshot(std::shared_ptr<IBlockDB> pBlockDB, Bloc
 		throw;
 	}
 
-	return zipFilePath;
+	return std::make_shared<const TxHashSetArchive>(snapshotCopy.pHeader, zipFilePath);
+}
+
+// Version, block header, BlockSums, and each file's path, size, and digest,
+// followed by whether it's signed, and if so, the signer's key and signature of the Blake2b hash of everything before it.
+static const uint8_t SNAPSHOT_MANIFEST_VERSION = 1;
+static const char* SNAPSHOT_MANIFEST_FILE = "snapshot.manifest";
+static const std::vector<std::string> SNAPSHOT_FOLDERS = { "kernel", "output", "rangeproof" };
+
+// The MMR data files are several GB, so they're digested a chunk at a time, and the digest is the hash of the chunk hashes.
+static const size_t SNAPSHOT_DIGEST_CHUNK_SIZE = 64 * 1024 * 1024;
+
+static Hash DigestSnapshotFile(const fs::path& filePath)
+{
+	std::ifstream file(filePath, std::ios::in | std::ios::binary);
+	if (!file.is_open())
+	{
+		throw TXHASHSET_EXCEPTION(StringUtil::Format("Failed to open {}", filePath));
+	}
+
+	std::vector<uint8_t> chunk(SNAPSHOT_DIGEST_CHUNK_SIZE);
+	std::vector<uint8_t> chunkHashes;
+	while (file)
+	{
+		file.read((char*)chunk.data(), chunk.size());
+		const size_t numRead = (size_t)file.gcount();
+		if (numRead == 0)
+		{
+			break;
+		}
+
+		const Hash chunkHash = Hasher::Blake2b(chunk.data(), numRead);
+		chunkHashes.insert(chunkHashes.end(), chunkHash.GetData().cbegin(), chunkHash.GetData().cend());
+	}
+
+	if (file.bad())
+	{
+		throw TXHASHSET_EXCEPTION(StringUtil::Format("Failed to read {}", filePath));
+	}
+
+	return Hasher::Blake2b(chunkHashes);
+}
+
+// Manifest paths are "<folder>/<file name>", so nothing outside the snapshot's MMR folders is ever read or replaced.
+static bool IsSnapshotFilePath(const std::string& path)
+{
+	const size_t separator = path.find('/');
+	if (separator == std::string::npos || path.find('/', separator + 1) != std::string::npos)
+	{
+		return false;
+	}
+
+	const std::string folder = path.substr(0, separator);
+	const std::string fileName = path.substr(separator + 1);
+	return std::find(SNAPSHOT_FOLDERS.cbegin(), SNAPSHOT_FOLDERS.cend(), folder) != SNAPSHOT_FOLDERS.cend()
+		&& !fileName.empty() && fileName != "." && fileName != ".." && fileName.find('\\') == std::string::npos;
+}
+
+void TxHashSetManager::ExportSnapshot(
+	const Config& config,
+	const SnapshotCopy& snapshotCopy,
+	const BlockSums& blockSums,
+	const fs::path& destination)
+{
+	if (FileUtil::Exists(destination))
+	{
+		throw TXHASHSET_EXCEPTION(StringUtil::Format("{} already exists", destination));
+	}
+
+	const fs::path& snapshotDir = snapshotCopy.directory;
+	const FullBlock& genesisBlock = config.GetEnvironment().GetGenesisBlock();
+
+	{
+		auto pKernelMMR = KernelMMR::Load(snapshotDir, genesisBlock);
+		auto pOutputPMMR = OutputPMMR::Load(snapshotDir, genesisBlock);
+		auto pRangeProofPMMR = RangeProofPMMR::Load(snapshotDir, genesisBlock);
+		TxHashSet snapshotTxHashSet(config, pKernelMMR, pOutputPMMR, pRangeProofPMMR, snapshotCopy.pFlushedHeader);
+
+		// The rewound leafsets are flushed to the copy's bitmap files, so no Roaring leafsets are needed.
+		snapshotTxHashSet.RewindSnapshot(snapshotCopy.pHeader, snapshotCopy.spentLeaves);
+		snapshotTxHashSet.Commit();
+	}
+
+	try
+	{
+		Serializer serializer;
+		serializer.Append<uint8_t>(SNAPSHOT_MANIFEST_VERSION);
+		snapshotCopy.pHeader->Serialize(serializer);
+		blockSums.Serialize(serializer);
+
+		std::vector<std::string> filePaths;
+		for (const std::string& folder : SNAPSHOT_FOLDERS)
+		{
+			FileUtil::CreateDirectories(destination / folder);
+			for (const auto& entry : fs::directory_iterator(snapshotDir / folder))
+			{
+				if (entry.is_regular_file())
+				{
+					const std::string fileName = entry.path().filename().u8string();
+					fs::copy_file(entry.path(), destination / folder / fileName);
+					filePaths.push_back(folder + "/" + fileName);
+				}
+			}
+		}
+
+		// Digested from the destination, so the manifest describes exactly what was written.
+		serializer.Append<uint32_t>((uint32_t)filePaths.size());
+		for (const std::string& filePath : filePaths)
+		{
+			const fs::path path = destination / filePath;
+			serializer.AppendVarStr(filePath);
+			serializer.Append<uint64_t>(FileUtil::GetFileSize(path));
+			serializer.AppendBigInteger(DigestSnapshotFile(path));
+		}
+
+		const std::optional<SecretKey>& signingKey = config.GetNodeConfig().GetSnapshotSigningKey();
+		if (signingKey.has_value())
+		{
+			const Hash manifestHash = Hasher::Blake2b(serializer.GetBytes());
+			const ed25519_keypair_t keypair = ED25519::CalculateKeypair(signingKey.value());
+			const ed25519_signature_t signature = ED25519::Sign(keypair.secret_key, manifestHash.GetData());
+
+			serializer.Append<uint8_t>(1);
+			serializer.AppendBigInteger(keypair.public_key.bytes);
+			serializer.AppendBigInteger(signature.bytes);
+		}
+		else
+		{
+			serializer.Append<uint8_t>(0);
+		}
+
+		FileUtil::SafeWriteToFile(destination / SNAPSHOT_MANIFEST_FILE, serializer.GetBytes());
+	}
+	catch (...)
+	{
+		FileUtil::RemoveFile(destination);
+		throw;
+	}
+
+	LOG_INFO_F("Exported TxHashSet snapshot of {} to {}", *snapshotCopy.pHeader, destination);
+}
+
+std::unique_ptr<TxHashSetManager::SnapshotManifest> TxHashSetManager::ReadSnapshotManifest(const Config& config, const fs::path& directory)
+{
+	std::vector<uint8_t> data;
+	if (!FileUtil::ReadFile(directory / SNAPSHOT_MANIFEST_FILE, data))
+	{
+		throw TXHASHSET_EXCEPTION(StringUtil::Format("No snapshot manifest found in {}", directory));
+	}
+
+	ByteBuffer byteBuffer(data);
+	const uint8_t version = byteBuffer.ReadU8();
+	if (version != SNAPSHOT_MANIFEST_VERSION)
+	{
+		throw TXHASHSET_EXCEPTION(StringUtil::Format("Unsupported snapshot manifest version {}", version));
+	}
+
+	auto pHeader = std::make_shared<const BlockHeader>(BlockHeader::Deserialize(byteBuffer));
+	BlockSums blockSums = BlockSums::Deserialize(byteBuffer);
+
+	const uint32_t numFiles = byteBuffer.ReadU32();
+	std::vector<SnapshotManifest::File> files;
+	for (uint32_t i = 0; i < numFiles; i++)
+	{
+		std::string path = byteBuffer.ReadVarStr();
+		if (!IsSnapshotFilePath(path))
+		{
+			throw TXHASHSET_EXCEPTION(StringUtil::Format("Invalid snapshot file path {}", path));
+		}
+
+		const uint64_t size = byteBuffer.ReadU64();
+		files.push_back(SnapshotManifest::File{ std::move(path), size, byteBuffer.ReadBigInteger<32>() });
+	}
+
+	bool trusted = false;
+	const size_t signedSize = data.size() - byteBuffer.GetRemainingSize();
+	if (byteBuffer.ReadU8() != 0)
+	{
+		const ed25519_public_key_t signer(byteBuffer.ReadBigInteger<32>());
+		const ed25519_signature_t signature(byteBuffer.ReadBigInteger<64>());
+		const Hash manifestHash = Hasher::Blake2b(data.data(), signedSize);
+		if (!ED25519::VerifySignature(signer, signature, manifestHash.GetData()))
+		{
+			throw TXHASHSET_EXCEPTION("Invalid snapshot manifest signature");
+		}
+
+		const std::optional<ed25519_public_key_t>& operatorKey = config.GetNodeConfig().GetSnapshotOperatorKey();
+		trusted = operatorKey.has_value() && operatorKey.value() == signer;
+		if (!trusted)
+		{
+			LOG_WARNING_F("Snapshot manifest signed by {}, which is not the operator key", signer);
+		}
+	}
+
+	if (byteBuffer.GetRemainingSize() != 0)
+	{
+		throw TXHASHSET_EXCEPTION("Unexpected data after snapshot manifest");
+	}
+
+	return std::unique_ptr<SnapshotManifest>(new SnapshotManifest{ pHeader, std::move(blockSums), std::move(files), trusted });
+}
+
+ITxHashSetPtr TxHashSetManager::LoadSnapshot(const Config& config, const fs::path& directory, const SnapshotManifest& manifest)
+{
+	const fs::path& txHashSetPath = config.GetNodeConfig().GetTxHashSetPath();
+	const FullBlock& genesisBlock = config.GetEnvironment().GetGenesisBlock();
+
+	try
+	{
+		// Every file is checked before any of the current TxHashSet files are replaced.
+		for (const SnapshotManifest::File& file : manifest.files)
+		{
+			const fs::path path = directory / file.path;
+			if (!FileUtil::Exists(path) || FileUtil::GetFileSize(path) != file.size || DigestSnapshotFile(path) != file.digest)
+			{
+				LOG_ERROR_F("Snapshot file {} doesn't match its manifest", path);
+				return nullptr;
+			}
+		}
+
+		for (const std::string& folder : SNAPSHOT_FOLDERS)
+		{
+			FileUtil::RemoveFile(txHashSetPath / folder);
+			FileUtil::CreateDirectories(txHashSetPath / folder);
+		}
+
+		for (const SnapshotManifest::File& file : manifest.files)
+		{
+			fs::copy_file(directory / file.path, txHashSetPath / file.path);
+		}
+
+		const BlockHeaderPtr& pHeader = manifest.pHeader;
+		auto pKernelMMR = KernelMMR::Load(txHashSetPath, genesisBlock);
+		pKernelMMR->Rewind(pHeader->GetKernelMMRSize());
+		pKernelMMR->Commit();
+
+		auto pOutputPMMR = OutputPMMR::Load(txHashSetPath, genesisBlock);
+		pOutputPMMR->Rewind(pHeader->GetOutputMMRSize(), {});
+		pOutputPMMR->Commit();
+
+		auto pRangeProofPMMR = RangeProofPMMR::Load(txHashSetPath, genesisBlock);
+		pRangeProofPMMR->Rewind(pHeader->GetOutputMMRSize(), {});
+		pRangeProofPMMR->Commit();
+
+		auto pTxHashSet = std::shared_ptr<TxHashSet>(new TxHashSet(config, pKernelMMR, pOutputPMMR, pRangeProofPMMR, pHeader));
+		pTxHashSet->SetProofsTrusted(manifest.trusted);
+
+		LOG_INFO_F("Loaded {} TxHashSet snapshot of {} from {}", manifest.trusted ? "trusted" : "untrusted", *pHeader, directory);
+		return pTxHashSet;
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Failed to load snapshot: {}", e.what());
+	}
+
+	return nullptr;
 }
@@ -0,0 +1,194 @@
+#include "TxHashSetOverlay.h"
+#include "NRDKernelValidator.h"
+
+#include <Core/Models/Transaction.h>
+#include <Core/Serialization/Serializer.h>
+#include <Database/BlockDb.h>
+#include <Common/Logger.h>
+#include <algorithm>
+#include <set>
+
+TxHashSetOverlay::TxHashSetOverlay(
+	std::shared_ptr<const IBlockDB> pBlockDB,
+	std::shared_ptr<const KernelMMR> pKernelMMR,
+	std::shared_ptr<const OutputPMMR> pOutputPMMR,
+	std::shared_ptr<const RangeProofPMMR> pRangeProofPMMR,
+	const uint64_t blockHeight,
+	const uint64_t maximumCoinbaseHeight,
+	const uint16_t headerVersion)
+	: m_pBlockDB(pBlockDB),
+	m_pOutputPMMR(pOutputPMMR),
+	m_blockHeight(blockHeight),
+	m_maximumCoinbaseHeight(maximumCoinbaseHeight),
+	m_headerVersion(headerVersion),
+	m_numBaseOutputs(MMRUtil::GetNumLeaves(pOutputPMMR->GetSize() - 1)),
+	m_kernelHashes(pKernelMMR),
+	m_outputHashes(pOutputPMMR),
+	m_rangeProofHashes(pRangeProofPMMR)
+{
+
+}
+
+bool TxHashSetOverlay::IsValid(const Transaction& transaction) const
+{
+	std::vector<uint64_t> spentIndices;
+	return FindSpentOutputs(transaction.GetBody(), spentIndices)
+		&& NRDKernelValidator::Validate(*m_pBlockDB, transaction.GetKernels(), m_blockHeight, m_nrdExcesses);
+}
+
+bool TxHashSetOverlay::Apply(const TransactionBody& body)
+{
+	std::vector<uint64_t> spentIndices;
+	if (!FindSpentOutputs(body, spentIndices) || !NRDKernelValidator::Validate(*m_pBlockDB, body.GetKernels(), m_blockHeight, m_nrdExcesses))
+	{
+		return false;
+	}
+
+	m_spent.insert(spentIndices.cbegin(), spentIndices.cend());
+
+	for (const TransactionOutput& output : body.GetOutputs())
+	{
+		const uint64_t mmrIndex = m_outputHashes.GetSize();
+
+		Serializer outputSerializer;
+		OutputIdentifier::FromOutput(output).Serialize(outputSerializer);
+		m_outputHashes.Append(outputSerializer.GetBytes());
+
+		Serializer rangeProofSerializer;
+		output.GetRangeProof().Serialize(rangeProofSerializer);
+		m_rangeProofHashes.Append(rangeProofSerializer.GetBytes());
+
+		m_appended[output.GetCommitment()] = AppendedOutput{ mmrIndex, output.GetFeatures() };
+	}
+
+	for (const TransactionKernel& kernel : body.GetKernels())
+	{
+		Serializer serializer;
+		kernel.Serialize(serializer);
+		m_kernelHashes.Append(serializer.GetBytes());
+
+		if (kernel.GetFeatures() == EKernelFeatures::NO_RECENT_DUPLICATE)
+		{
+			m_nrdExcesses.insert(kernel.GetExcessCommitment());
+		}
+	}
+
+	return true;
+}
+
+TxHashSetRoots TxHashSetOverlay::GetRoots() const
+{
+	Hash outputRoot = m_outputHashes.Root();
+	if (m_headerVersion >= 3)
+	{
+		outputRoot = MMRHashUtil::HashParentWithIndex(outputRoot, SpeculativeUBMTRoot(), m_outputHashes.GetSize());
+	}
+
+	return TxHashSetRoots(
+		{ m_kernelHashes.Root(), m_kernelHashes.GetSize() },
+		{ outputRoot, m_outputHashes.GetSize() },
+		{ m_rangeProofHashes.Root(), m_rangeProofHashes.GetSize() }
+	);
+}
+
+Hash TxHashSetOverlay::SpeculativeUBMTRoot() const
+{
+	std::unordered_set<uint64_t> spentLeaves;
+	spentLeaves.reserve(m_spent.size());
+	for (const uint64_t mmrIndex : m_spent)
+	{
+		spentLeaves.insert(MMRUtil::GetLeafIndex(mmrIndex));
+	}
+
+	const uint64_t numOutputs = MMRUtil::GetNumLeaves(m_outputHashes.GetSize() - 1);
+	return m_pOutputPMMR->GetLeafSet()->SpeculativeRoot(m_numBaseOutputs, numOutputs, spentLeaves);
+}
+
+bool TxHashSetOverlay::FindSpentOutputs(const TransactionBody& body, std::vector<uint64_t>& spentIndices) const
+{
+	// The positions of all inputs and outputs are looked up in a single batch.
+	const std::vector<TransactionInput>& inputs = body.GetInputs();
+	const std::vector<TransactionOutput>& outputs = body.GetOutputs();
+	std::vector<Commitment> commitments;
+	commitments.reserve(inputs.size() + outputs.size());
+	std::transform(inputs.cbegin(), inputs.cend(), std::back_inserter(commitments), [](const TransactionInput& input) { return input.GetCommitment(); });
+	std::transform(outputs.cbegin(), outputs.cend(), std::back_inserter(commitments), [](const TransactionOutput& output) { return output.GetCommitment(); });
+	const std::vector<std::unique_ptr<OutputLocation>> positions = m_pBlockDB->GetOutputPositions(commitments);
+
+	// Validate inputs
+	spentIndices.reserve(inputs.size());
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		const TransactionInput& input = inputs[i];
+		const Commitment& commitment = input.GetCommitment();
+
+		// Outputs appended by the overlay are a block or more above the TxHashSet, so an appended coinbase is never mature.
+		auto appendedIter = m_appended.find(commitment);
+		if (appendedIter != m_appended.end() && m_spent.count(appendedIter->second.mmrIndex) == 0)
+		{
+			if (appendedIter->second.features != input.GetFeatures() || input.GetFeatures() == EOutputFeatures::COINBASE_OUTPUT)
+			{
+				return false;
+			}
+
+			spentIndices.push_back(appendedIter->second.mmrIndex);
+			continue;
+		}
+
+		const std::unique_ptr<OutputLocation>& pOutputPosition = positions[i];
+		if (pOutputPosition == nullptr || m_spent.count(pOutputPosition->GetMMRIndex()) > 0)
+		{
+			return false;
+		}
+
+		std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetAt(pOutputPosition->GetMMRIndex());
+		if (pOutput == nullptr || pOutput->GetCommitment() != commitment || pOutput->GetFeatures() != input.GetFeatures())
+		{
+			LOG_DEBUG_F("Output ({}) not found at mmrIndex ({})", commitment, pOutputPosition->GetMMRIndex());
+			return false;
+		}
+
+		if (input.GetFeatures() == EOutputFeatures::COINBASE_OUTPUT && pOutputPosition->GetBlockHeight() > m_maximumCoinbaseHeight)
+		{
+			LOG_INFO_F("Coinbase ({}) not mature", commitment);
+			return false;
+		}
+
+		spentIndices.push_back(pOutputPosition->GetMMRIndex());
+	}
+
+	// An output can't be spent twice by the same body.
+	if (std::set<uint64_t>(spentIndices.cbegin(), spentIndices.cend()).size() != spentIndices.size())
+	{
+		return false;
+	}
+
+	// Validate outputs
+	std::set<Commitment> outputCommitments;
+	for (size_t i = 0; i < outputs.size(); i++)
+	{
+		const Commitment& commitment = outputs[i].GetCommitment();
+		if (!outputCommitments.insert(commitment).second)
+		{
+			return false;
+		}
+
+		auto appendedIter = m_appended.find(commitment);
+		if (appendedIter != m_appended.end() && m_spent.count(appendedIter->second.mmrIndex) == 0)
+		{
+			return false;
+		}
+
+		const std::unique_ptr<OutputLocation>& pOutputPosition = positions[inputs.size() + i];
+		if (pOutputPosition != nullptr && m_spent.count(pOutputPosition->GetMMRIndex()) == 0)
+		{
+			std::unique_ptr<OutputIdentifier> pOutput = m_pOutputPMMR->GetAt(pOutputPosition->GetMMRIndex());
+			if (pOutput != nullptr && pOutput->GetCommitment() == commitment)
+			{
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
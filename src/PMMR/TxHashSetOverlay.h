@@ -0,0 +1,78 @@
+#pragma once
+
+#include "KernelMMR.h"
+#include "OutputPMMR.h"
+#include "RangeProofPMMR.h"
+#include "Common/MMRHashOverlay.h"
+
+#include <PMMR/TxHashSet.h>
+#include <Crypto/Commitment.h>
+#include <map>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+// Forward Declarations
+class IBlockDB;
+
+class TxHashSetOverlay : public ITxHashSetOverlay
+{
+public:
+	//
+	// Everything applied is treated as included in a block at blockHeight, for checking NRD kernels.
+	// Coinbase outputs created above maximumCoinbaseHeight can't be spent yet.
+	// From headerVersion 3 on, the output root returned by GetRoots is merged with the UBMT root, as in the block's header.
+	//
+	TxHashSetOverlay(
+		std::shared_ptr<const IBlockDB> pBlockDB,
+		std::shared_ptr<const KernelMMR> pKernelMMR,
+		std::shared_ptr<const OutputPMMR> pOutputPMMR,
+		std::shared_ptr<const RangeProofPMMR> pRangeProofPMMR,
+		const uint64_t blockHeight,
+		const uint64_t maximumCoinbaseHeight,
+		const uint16_t headerVersion
+	);
+
+	bool IsValid(const Transaction& transaction) const final;
+	bool Apply(const TransactionBody& body) final;
+	TxHashSetRoots GetRoots() const final;
+
+private:
+	struct AppendedOutput
+	{
+		uint64_t mmrIndex;
+		EOutputFeatures features;
+	};
+
+	//
+	// Checks the body's inputs and outputs, and if they're valid, returns the mmr indices of the outputs spent by its inputs.
+	// Otherwise, returns false.
+	//
+	bool FindSpentOutputs(const TransactionBody& body, std::vector<uint64_t>& spentIndices) const;
+
+	//
+	// The UBMT root of the leafset with the overlay's outputs appended and spent, computed from the leafset's chunk MMR
+	// by rehashing only the chunks the overlay touches.
+	//
+	Hash SpeculativeUBMTRoot() const;
+
+	std::shared_ptr<const IBlockDB> m_pBlockDB;
+	std::shared_ptr<const OutputPMMR> m_pOutputPMMR;
+	uint64_t m_blockHeight;
+	uint64_t m_maximumCoinbaseHeight;
+	uint16_t m_headerVersion;
+	uint64_t m_numBaseOutputs;
+
+	MMRHashOverlay m_kernelHashes;
+	MMRHashOverlay m_outputHashes;
+	MMRHashOverlay m_rangeProofHashes;
+
+	// The mmr indices of every output spent by the overlay, whether it's in the TxHashSet or was appended by the overlay.
+	std::unordered_set<uint64_t> m_spent;
+
+	// The outputs appended by the overlay, by commitment. Only the ones not in m_spent are unspent.
+	std::map<Commitment, AppendedOutput> m_appended;
+
+	// The excess commitments of the NRD kernels appended by the overlay.
+	std::unordered_set<Commitment> m_nrdExcesses;
+};
@@ -4,16 +4,27 @@
 #include "Common/MMR.h"
 #include "Common/MMRUtil.h"
 #include "Common/MMRHashUtil.h"
+#include "Common/MMRHashValidator.h"
+#include "Common/MMRRootTracker.h"
 
 #include <Core/Validation/KernelSignatureValidator.h>
+#include <Crypto/RangeProofVerifier.h>
 #include <Core/Validation/KernelSumValidator.h>
 #include <Consensus/Common.h>
 #include <Common/Util/HexUtil.h>
 #include <Common/Logger.h>
+#include <Common/Util/ThreadUtil.h>
+#include <Common/ThreadPool.h>
 #include <BlockChain/BlockChain.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
 #include <thread>
 
-std::unique_ptr<BlockSums> TxHashSetValidator::Validate(TxHashSet& txHashSet, const BlockHeader& blockHeader, SyncStatus& syncStatus) const
+std::unique_ptr<BlockSums> TxHashSetValidator::Validate(TxHashSet& txHashSet, const BlockHeader& blockHeader, const bool kernelSignaturesVerified, const bool proofsTrusted, SyncStatus& syncStatus) const
 {
 	std::shared_ptr<const KernelMMR> pKernelMMR = txHashSet.GetKernelMMR();
 	std::shared_ptr<const OutputPMMR> pOutputPMMR = txHashSet.GetOutputPMMR();
@@ -29,21 +40,7 @@ std::unique_ptr<BlockSums> TxHashSetValidator::Validate(TxHashSet& txHashSet, co
 	syncStatus.UpdateProcessingStatus(5);
 
 	// Validate MMR hashes in parallel
-	std::vector<std::thread> threads;
-	std::atomic_bool mmrHashesValidated = true;
-	threads.emplace_back(std::thread([this, pKernelMMR, &mmrHashesValidated] { if (!this->ValidateMMRHashes(pKernelMMR)) { mmrHashesValidated = false; }}));
-	threads.emplace_back(std::thread([this, pOutputPMMR, &mmrHashesValidated] { if (!this->ValidateMMRHashes(pOutputPMMR)) { mmrHashesValidated = false; }}));
-	threads.emplace_back(std::thread([this, pRangeProofPMMR, &mmrHashesValidated] { if (!this->ValidateMMRHashes(pRangeProofPMMR)) { mmrHashesValidated = false; }}));
-
-	for (auto& thread : threads)
-	{
-		if (thread.joinable())
-		{
-			thread.join();
-		}
-	}
-
-	if (!mmrHashesValidated)
+	if (!ValidateMMRHashes({ pKernelMMR, pOutputPMMR, pRangeProofPMMR }))
 	{
 		LOG_ERROR("Invalid MMR hashes");
 		return std::unique_ptr<BlockSums>(nullptr);
@@ -62,7 +59,7 @@ std::unique_ptr<BlockSums> TxHashSetValidator::Validate(TxHashSet& txHashSet, co
 
 	// Validate the full kernel history (kernel MMR root for every block header).
 	LOG_DEBUG("Validating kernel history");
-	if (!ValidateKernelHistory(*txHashSet.GetKernelMMR(), blockHeader, syncStatus))
+	if (!ValidateKernelHistory(pKernelMMR, blockHeader, syncStatus))
 	{
 		LOG_ERROR("Invalid kernel history");
 		return std::unique_ptr<BlockSums>(nullptr);
@@ -87,6 +84,22 @@ std::unique_ptr<BlockSums> TxHashSetValidator::Validate(TxHashSet& txHashSet, co
 
 	syncStatus.UpdateProcessingStatus(40);
 
+	// The MMR roots, sums, and kernel history above are always checked, but proofs and signatures under a trusted header are not.
+	if (m_blockChain.IsAssumedValid(blockHeader))
+	{
+		LOG_INFO_F("Skipping rangeproof and kernel signature verification for assumed valid header {}", blockHeader);
+		syncStatus.UpdateProcessingStatus(100);
+		return pBlockSums;
+	}
+
+	// Same for snapshots signed by the operator key.
+	if (proofsTrusted)
+	{
+		LOG_INFO_F("Skipping rangeproof and kernel signature verification for trusted snapshot of {}", blockHeader);
+		syncStatus.UpdateProcessingStatus(100);
+		return pBlockSums;
+	}
+
 	// Validate the rangeproof associated with each unspent output.
 	LOG_DEBUG("Validating range proofs");
 	LoggerAPI::Flush();
@@ -98,13 +111,20 @@ std::unique_ptr<BlockSums> TxHashSetValidator::Validate(TxHashSet& txHashSet, co
 
 	syncStatus.UpdateProcessingStatus(70);
 
-	// Validate kernel signatures
-	LOG_DEBUG("Validating kernel signatures");
-	LoggerAPI::Flush();
-	if (!ValidateKernelSignatures(*txHashSet.GetKernelMMR(), syncStatus))
+	// Validate kernel signatures, unless they were already verified while downloading.
+	if (kernelSignaturesVerified)
 	{
-		LOG_ERROR("Failed to verify kernel signatures");
-		return std::unique_ptr<BlockSums>(nullptr);
+		LOG_DEBUG("Kernel signatures already verified");
+	}
+	else
+	{
+		LOG_DEBUG("Validating kernel signatures");
+		LoggerAPI::Flush();
+		if (!ValidateKernelSignatures(*txHashSet.GetKernelMMR(), syncStatus))
+		{
+			LOG_ERROR("Failed to verify kernel signatures");
+			return std::unique_ptr<BlockSums>(nullptr);
+		}
 	}
 
 	LOG_DEBUG("Success");
@@ -138,49 +158,20 @@ bool TxHashSetValidator::ValidateSizes(TxHashSet& txHashSet, const BlockHeader&
 	return true;
 }
 
-// TODO: This probably belongs in MMRHashUtil.
-bool TxHashSetValidator::ValidateMMRHashes(std::shared_ptr<const MMR> pMMR) const
+bool TxHashSetValidator::ValidateMMRHashes(const std::vector<std::shared_ptr<const MMR>>& mmrs) const
 {
-	try
-	{
-		const uint64_t size = pMMR->GetSize();
-		for (uint64_t i = 0; i < size; i++)
-		{
-			const uint64_t height = MMRUtil::GetHeight(i);
-			if (height > 0)
-			{
-				const std::unique_ptr<Hash> pParentHash = pMMR->GetHashAt(i);
-				if (pParentHash != nullptr)
-				{
-					const uint64_t leftIndex = MMRUtil::GetLeftChildIndex(i, height);
-					const std::unique_ptr<Hash> pLeftHash = pMMR->GetHashAt(leftIndex);
-
-					const uint64_t rightIndex = MMRUtil::GetRightChildIndex(i);
-					const std::unique_ptr<Hash> pRightHash = pMMR->GetHashAt(rightIndex);
-
-					if (pLeftHash != nullptr && pRightHash != nullptr)
-					{
-						const Hash expectedHash = MMRHashUtil::HashParentWithIndex(*pLeftHash, *pRightHash, i);
-						if (*pParentHash != expectedHash)
-						{
-							LOG_ERROR_F("Invalid parent hash at index ({})", i);
-							return false;
-						}
-					}
-				}
-			}
-		}
-	}
-	catch (...)
-	{
-		return false;
-	}
+	const size_t numThreads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
 
-	return true;
+	return MMRHashValidator(numThreads).Validate(mmrs);
 }
 
-bool TxHashSetValidator::ValidateKernelHistory(const KernelMMR& kernelMMR, const BlockHeader& blockHeader, SyncStatus& syncStatus) const
+//
+// Headers are visited in height order, so MMRRootTracker only needs to read the kernel peaks added since the previous header.
+//
+bool TxHashSetValidator::ValidateKernelHistory(const std::shared_ptr<const KernelMMR>& pKernelMMR, const BlockHeader& blockHeader, SyncStatus& syncStatus) const
 {
+	MMRRootTracker rootTracker(pKernelMMR);
+
 	const uint64_t totalHeight = blockHeader.GetHeight();
 	for (uint64_t height = 0; height <= totalHeight; height++)
 	{
@@ -191,7 +182,7 @@ bool TxHashSetValidator::ValidateKernelHistory(const KernelMMR& kernelMMR, const
 			return false;
 		}
 		
-		if (kernelMMR.Root(pHeader->GetKernelMMRSize()) != pHeader->GetKernelRoot())
+		if (rootTracker.Root(pHeader->GetKernelMMRSize()) != pHeader->GetKernelRoot())
 		{
 			LOG_ERROR_F("Kernel root not matching for header at height ({})", height);
 			return false;
@@ -206,126 +197,330 @@ bool TxHashSetValidator::ValidateKernelHistory(const KernelMMR& kernelMMR, const
 	return true;
 }
 
+//
+// Sums the output commitments and the kernel excesses in chunks of READ_CHUNK_SIZE mmr leaves on the shared thread pool.
+// Each chunk is reduced to a single partial sum as soon as it's read, so memory use is bounded by the number of chunks in flight,
+// and the partial sums are added together once every chunk is done.
+//
 BlockSums TxHashSetValidator::ValidateKernelSums(TxHashSet& txHashSet, const BlockHeader& blockHeader) const
 {
 	// Calculate overage
 	const int64_t overage = 0 - (Consensus::REWARD * (1 + blockHeader.GetHeight()));
 
-	// Determine output commitments
+	// Number of mmr indices (or kernels) read from the data files at a time.
+	const uint64_t READ_CHUNK_SIZE = 8192;
+
 	std::shared_ptr<const OutputPMMR> pOutputPMMR = txHashSet.GetOutputPMMR();
-	std::vector<Commitment> outputCommitments;
-	for (uint64_t i = 0; i < blockHeader.GetOutputMMRSize(); i++)
-	{
-		std::unique_ptr<OutputIdentifier> pOutput = pOutputPMMR->GetAt(i);
-		if (pOutput != nullptr)
+	const uint64_t outputMMRSize = blockHeader.GetOutputMMRSize();
+	const uint64_t numOutputChunks = (outputMMRSize + READ_CHUNK_SIZE - 1) / READ_CHUNK_SIZE;
+
+	std::shared_ptr<const KernelMMR> pKernelMMR = txHashSet.GetKernelMMR();
+	const uint64_t numKernels = MMRUtil::GetNumLeaves(blockHeader.GetKernelMMRSize() - 1);
+	const uint64_t numKernelChunks = (numKernels + READ_CHUNK_SIZE - 1) / READ_CHUNK_SIZE;
+
+	// A chunk without any unspent outputs, or whose commitments cancel out, has no partial sum.
+	std::vector<std::optional<Commitment>> partialSums(numOutputChunks + numKernelChunks);
+	std::atomic_uint64_t nextChunk = 0;
+
+	auto sumChunk = [&](const uint64_t chunk) -> std::optional<Commitment> {
+		std::vector<Commitment> commitments;
+		commitments.reserve(READ_CHUNK_SIZE);
+
+		if (chunk < numOutputChunks)
 		{
-			outputCommitments.push_back(pOutput->GetCommitment());
+			const uint64_t first = chunk * READ_CHUNK_SIZE;
+			const uint64_t last = std::min(first + READ_CHUNK_SIZE, outputMMRSize) - 1;
+			for (auto& output : pOutputPMMR->GetUnprunedLeaves(first, last))
+			{
+				commitments.emplace_back(output.second.GetCommitment());
+			}
+		}
+		else
+		{
+			const uint64_t first = (chunk - numOutputChunks) * READ_CHUNK_SIZE;
+			for (const TransactionKernel& kernel : pKernelMMR->GetKernels(first, std::min(READ_CHUNK_SIZE, numKernels - first)))
+			{
+				commitments.emplace_back(kernel.GetExcessCommitment());
+			}
 		}
-	}
 
-	// Determine kernel excess commitments
-	std::shared_ptr<const KernelMMR> pKernelMMR = txHashSet.GetKernelMMR();
-	std::vector<Commitment> excessCommitments;
-	for (uint64_t i = 0; i < blockHeader.GetKernelMMRSize(); i++)
+		return SumChunk(commitments);
+	};
+
+	ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+	threadPool.RunParallel(threadPool.GetNumThreads() + 1, [&]() {
+		for (uint64_t chunk = nextChunk++; chunk < partialSums.size(); chunk = nextChunk++)
+		{
+			partialSums[chunk] = sumChunk(chunk);
+		}
+	}, ETaskPriority::HIGH);
+
+	std::vector<Commitment> outputSums;
+	std::vector<Commitment> kernelSums;
+	for (uint64_t chunk = 0; chunk < partialSums.size(); chunk++)
 	{
-		std::unique_ptr<TransactionKernel> pKernel = pKernelMMR->GetKernelAt(i);
-		if (pKernel != nullptr)
+		if (partialSums[chunk].has_value())
 		{
-			excessCommitments.push_back(pKernel->GetExcessCommitment());
+			(chunk < numOutputChunks ? outputSums : kernelSums).push_back(partialSums[chunk].value());
 		}
 	}
 
 	return KernelSumValidator::ValidateKernelSums(
 		std::vector<Commitment>(),
-		outputCommitments,
-		excessCommitments,
+		outputSums,
+		kernelSums,
 		overage,
 		blockHeader.GetTotalKernelOffset(),
 		std::nullopt
 	);
 }
 
-bool TxHashSetValidator::ValidateRangeProofs(TxHashSet& txHashSet, SyncStatus& syncStatus) const
+std::optional<Commitment> TxHashSetValidator::SumChunk(const std::vector<Commitment>& commitments)
 {
-	std::vector<std::pair<Commitment, RangeProof>> rangeProofs;
-
-	size_t i = 0;
-	LOG_INFO("BEGIN");
-	const uint64_t outputMMRSize = txHashSet.GetOutputPMMR()->GetSize();
-	for (uint64_t mmrIndex = 0; mmrIndex < outputMMRSize; mmrIndex++)
+	if (commitments.empty())
 	{
-		std::unique_ptr<OutputIdentifier> pOutput = txHashSet.GetOutputPMMR()->GetAt(mmrIndex);
-		if (pOutput != nullptr)
+		return std::nullopt;
+	}
+
+	return Crypto::TryAddCommitments(commitments, std::vector<Commitment>());
+}
+
+//
+// Reads the outputs and rangeproofs on this thread, and hands off batches of RANGEPROOF_BATCH_SIZE
+// to a pool of worker threads, each verifying with its own RangeProofVerifier.
+// At most MAX_QUEUED_BATCHES_PER_WORKER batches per worker are buffered, and all work stops on the first failure.
+//
+bool TxHashSetValidator::ValidateRangeProofs(TxHashSet& txHashSet, SyncStatus& syncStatus) const
+{
+	typedef std::vector<std::pair<Commitment, RangeProof>> RangeProofBatch;
+	const size_t RANGEPROOF_BATCH_SIZE = 1000;
+	const size_t MAX_QUEUED_BATCHES_PER_WORKER = 2;
+
+	const size_t numWorkers = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+	const size_t maxQueuedBatches = numWorkers * MAX_QUEUED_BATCHES_PER_WORKER;
+
+	std::mutex mutex;
+	std::condition_variable batchQueued;
+	std::condition_variable batchDequeued;
+	std::deque<RangeProofBatch> batches;
+	bool finishedReading = false;
+	bool failed = false;
+
+	auto fail = [&mutex, &failed, &batchQueued, &batchDequeued]() {
+		std::unique_lock<std::mutex> lock(mutex);
+		failed = true;
+		lock.unlock();
+
+		batchQueued.notify_all();
+		batchDequeued.notify_all();
+	};
+
+	auto worker = [&]() {
+		try
 		{
-			std::unique_ptr<RangeProof> pRangeProof = txHashSet.GetRangeProofPMMR()->GetAt(mmrIndex);
-			if (pRangeProof == nullptr)
+			RangeProofVerifier::UPtr pVerifier = RangeProofVerifier::Create();
+			while (true)
 			{
-				LOG_ERROR_F("No rangeproof found at mmr index ({})", mmrIndex);
-				return false;
+				std::unique_lock<std::mutex> lock(mutex);
+				batchQueued.wait(lock, [&]() { return failed || finishedReading || !batches.empty(); });
+				if (failed || batches.empty())
+				{
+					return;
+				}
+
+				RangeProofBatch batch = std::move(batches.front());
+				batches.pop_front();
+				lock.unlock();
+				batchDequeued.notify_one();
+
+				if (!pVerifier->Verify(batch))
+				{
+					fail();
+					return;
+				}
+
+				syncStatus.AddTxHashSetRangeProofsVerified(batch.size());
 			}
+		}
+		catch (std::exception& e)
+		{
+			LOG_ERROR_F("Failed to verify rangeproofs: {}", e.what());
+			fail();
+		}
+	};
 
-			rangeProofs.emplace_back(std::make_pair(pOutput->GetCommitment(), *pRangeProof));
-			++i;
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < numWorkers; i++)
+	{
+		workers.emplace_back(std::thread(worker));
+	}
+
+	auto queueBatch = [&](RangeProofBatch&& batch) -> bool {
+		std::unique_lock<std::mutex> lock(mutex);
+		batchDequeued.wait(lock, [&]() { return failed || batches.size() < maxQueuedBatches; });
+		if (failed)
+		{
+			return false;
+		}
+
+		batches.emplace_back(std::move(batch));
+		lock.unlock();
+		batchQueued.notify_one();
+		return true;
+	};
 
-			if (rangeProofs.size() >= 1000)
+	size_t numProofs = 0;
+	bool readSucceeded = true;
+	try
+	{
+		RangeProofBatch rangeProofs;
+		rangeProofs.reserve(RANGEPROOF_BATCH_SIZE);
+
+		// Outputs and rangeproofs are read a chunk of mmr indices at a time, each with a single data file read.
+		const uint64_t READ_CHUNK_SIZE = 4096;
+
+		const uint64_t outputMMRSize = txHashSet.GetOutputPMMR()->GetSize();
+		for (uint64_t first = 0; first < outputMMRSize && readSucceeded; first += READ_CHUNK_SIZE)
+		{
+			const uint64_t last = std::min(first + READ_CHUNK_SIZE, outputMMRSize) - 1;
+			auto outputs = txHashSet.GetOutputPMMR()->GetUnprunedLeaves(first, last);
+			auto proofs = txHashSet.GetRangeProofPMMR()->GetUnprunedLeaves(first, last);
+
+			size_t proofIndex = 0;
+			for (auto& output : outputs)
 			{
-				if (!Crypto::VerifyRangeProofs(rangeProofs))
+				while (proofIndex < proofs.size() && proofs[proofIndex].first < output.first)
 				{
-					return false;
+					++proofIndex;
 				}
 
-				rangeProofs.clear();
+				if (proofIndex >= proofs.size() || proofs[proofIndex].first != output.first)
+				{
+					LOG_ERROR_F("No rangeproof found at mmr index ({})", output.first);
+					readSucceeded = false;
+					break;
+				}
+
+				rangeProofs.emplace_back(std::make_pair(output.second.GetCommitment(), std::move(proofs[proofIndex].second)));
+				++numProofs;
+
+				if (rangeProofs.size() >= RANGEPROOF_BATCH_SIZE)
+				{
+					readSucceeded = queueBatch(std::move(rangeProofs));
+					if (!readSucceeded)
+					{
+						break;
+					}
+
+					rangeProofs = RangeProofBatch();
+					rangeProofs.reserve(RANGEPROOF_BATCH_SIZE);
 
-				syncStatus.UpdateProcessingStatus((uint8_t)(40 + ((30.0 * mmrIndex) / outputMMRSize)));
+					syncStatus.UpdateProcessingStatus((uint8_t)(40 + ((30.0 * output.first) / outputMMRSize)));
+				}
 			}
 		}
-	}
 
-	if (!rangeProofs.empty())
-	{
-		if (!Crypto::VerifyRangeProofs(rangeProofs))
+		if (readSucceeded && !rangeProofs.empty())
 		{
-			return false;
+			readSucceeded = queueBatch(std::move(rangeProofs));
 		}
 	}
+	catch (...)
+	{
+		fail();
+		ThreadUtil::JoinAll(workers);
+		throw;
+	}
+
+	if (!readSucceeded)
+	{
+		fail();
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		finishedReading = true;
+	}
 
-	LOG_INFO_F("SUCCESS ({})", i);
+	batchQueued.notify_all();
+	ThreadUtil::JoinAll(workers);
+
+	if (failed)
+	{
+		return false;
+	}
+
+	LOG_INFO_F("Verified {} rangeproofs using {} workers", numProofs, numWorkers);
 	return true;
 }
 
-bool TxHashSetValidator::ValidateKernelSignatures(const KernelMMR& kernelMMR, SyncStatus& syncStatus) const
+//
+// Splits the kernels into chunks of KERNEL_CHUNK_SIZE, which a pool of worker threads claim in order,
+// read straight from the kernel data file, and batch verify. Progress is reported as each chunk completes.
+//
+bool TxHashSetValidator::ValidateKernelSignatures(const KernelMMR& kernelMMR, SyncStatus& syncStatus)
 {
-	std::vector<TransactionKernel> kernels;
+	const uint64_t KERNEL_CHUNK_SIZE = 2000;
 
-	const uint64_t mmrSize = kernelMMR.GetSize();
-	for (uint64_t i = 0; i < mmrSize; i++)
-	{
-		std::unique_ptr<TransactionKernel> pKernel = kernelMMR.GetKernelAt(i);
-		if (pKernel != nullptr)
+	const uint64_t numKernels = kernelMMR.GetNumKernels();
+	const uint64_t numChunks = (numKernels + KERNEL_CHUNK_SIZE - 1) / KERNEL_CHUNK_SIZE;
+
+	std::atomic_uint64_t nextChunk = 0;
+	std::atomic_uint64_t chunksCompleted = 0;
+	std::atomic_bool valid = true;
+
+	auto worker = [&]() {
+		while (valid)
 		{
-			kernels.push_back(*pKernel);
+			const uint64_t chunk = nextChunk++;
+			if (chunk >= numChunks)
+			{
+				break;
+			}
 
-			if (kernels.size() >= 2000)
+			try
 			{
-				if (!KernelSignatureValidator::VerifyKernelSignatures(kernels))
+				const uint64_t firstLeafIndex = chunk * KERNEL_CHUNK_SIZE;
+				const uint64_t chunkSize = std::min(KERNEL_CHUNK_SIZE, numKernels - firstLeafIndex);
+
+				// Not cached, since the whole kernel history would only evict the mempool's kernels.
+				const std::vector<TransactionKernel> kernels = kernelMMR.GetKernels(firstLeafIndex, chunkSize);
+				if (!KernelSignatureValidator::VerifyKernelSignatures(kernels, false))
 				{
-					return false;
+					LOG_ERROR_F("Invalid kernel signature in leaves [{}, {})", firstLeafIndex, firstLeafIndex + chunkSize);
+					valid = false;
+					break;
 				}
 
-				kernels.clear();
-
-				syncStatus.UpdateProcessingStatus((uint8_t)(70 + ((30.0 * i) / mmrSize)));
+				syncStatus.AddTxHashSetKernelsVerified(chunkSize);
 			}
+			catch (std::exception& e)
+			{
+				LOG_ERROR_F("Failed to verify kernel signatures: {}", e.what());
+				valid = false;
+				break;
+			}
+
+			const uint64_t completed = ++chunksCompleted;
+			syncStatus.UpdateProcessingStatus((uint8_t)(70 + ((30.0 * completed) / numChunks)));
 		}
+	};
+
+	const size_t numWorkers = (size_t)std::min<uint64_t>(std::max<size_t>(std::thread::hardware_concurrency(), 1), numChunks);
+
+	std::vector<std::thread> workers;
+	for (size_t i = 0; i < numWorkers; i++)
+	{
+		workers.emplace_back(std::thread(worker));
 	}
 
-	if (!kernels.empty())
+	ThreadUtil::JoinAll(workers);
+
+	if (!valid)
 	{
-		if (!KernelSignatureValidator::VerifyKernelSignatures(kernels))
-		{
-			return false;
-		}
+		return false;
 	}
 
+	LOG_INFO_F("Verified {} kernel signatures using {} workers", numKernels, numWorkers);
 	return true;
-}
\ No newline at end of file
+}
@@ -3,14 +3,16 @@
 #include <Core/Models/BlockHeader.h>
 #include <Core/Models/BlockSums.h>
 #include <P2P/SyncStatus.h>
+#include <Crypto/Commitment.h>
 #include "Common/HashFile.h"
+#include <optional>
+#include <vector>
 
 // Forward Declarations
 class TxHashSet;
 class KernelMMR;
 class IBlockChain;
 class MMR;
-class Commitment;
 
 class TxHashSetValidator
 {
@@ -21,15 +23,31 @@ public:
 	std::unique_ptr<BlockSums> Validate(
 		TxHashSet& txHashSet,
 		const BlockHeader& blockHeader,
+		const bool kernelSignaturesVerified,
+		const bool proofsTrusted,
 		SyncStatus& syncStatus
 	) const;
 
+	//
+	// Also used by TxHashSetDownload to verify the kernels before the rest of the TxHashSet is downloaded.
+	//
+	static bool ValidateKernelSignatures(
+		const KernelMMR& kernelMMR,
+		SyncStatus& syncStatus
+	);
+
+	//
+	// Reduces a chunk of commitments read by ValidateKernelSums to its partial sum.
+	// Returns std::nullopt if the chunk is empty or its commitments cancel out, eg. a kernel excess and its negation.
+	//
+	static std::optional<Commitment> SumChunk(const std::vector<Commitment>& commitments);
+
 private:
 	bool ValidateSizes(TxHashSet& txHashSet, const BlockHeader& blockHeader) const;
-	bool ValidateMMRHashes(std::shared_ptr<const MMR> pMMR) const;
+	bool ValidateMMRHashes(const std::vector<std::shared_ptr<const MMR>>& mmrs) const;
 
 	bool ValidateKernelHistory(
-		const KernelMMR& kernelMMR,
+		const std::shared_ptr<const KernelMMR>& pKernelMMR,
 		const BlockHeader& blockHeader,
 		SyncStatus& syncStatus
 	) const;
@@ -44,10 +62,5 @@ private:
 		SyncStatus& syncStatus
 	) const;
 
-	bool ValidateKernelSignatures(
-		const KernelMMR& kernelMMR,
-		SyncStatus& syncStatus
-	) const;
-
 	const IBlockChain& m_blockChain;
 };
\ No newline at end of file
@@ -5,7 +5,10 @@
 #include <Common/Util/FileUtil.h>
 #include <Core/Exceptions/FileException.h>
 #include <Common/Logger.h>
+#include <Common/Util/ThreadUtil.h>
 #include <filesystem.h>
+#include <exception>
+#include <thread>
 
 TxHashSetZip::TxHashSetZip(const Config& config)
 	: m_config(config)
@@ -13,76 +16,78 @@ TxHashSetZip::TxHashSetZip(const Config& config)
 
 }
 
-bool TxHashSetZip::Extract(const fs::path& path, const BlockHeader& header) const
+bool TxHashSetZip::Extract(const fs::path& path, const BlockHeader& header, const FolderCallback& onFolderExtracted) const
 {
-	try
-	{
-		std::shared_ptr<ZipFile> pZipFile = ZipFile::Load(path);
-
-		// Extract kernel folder.
-		ExtractKernelFolder(*pZipFile);
-
-		// Extract output folder.
-		ExtractFolder(*pZipFile, "output", header);
+	const std::vector<std::string> folders = { "kernel", "output", "rangeproof" };
 
-		// Extract rangeProof folder.
-		ExtractFolder(*pZipFile, "rangeproof", header);
-
-		LOG_INFO("Successfully extracted zip file.");
-		return true;
-	}
-	catch (std::exception& e)
+	std::vector<std::exception_ptr> errors(folders.size());
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < folders.size(); i++)
 	{
-		LOG_ERROR_F("Failed to extract {}. Exception thrown: {}", path, e.what());
+		threads.emplace_back(std::thread([this, &path, &header, &onFolderExtracted, &folders, &errors, i]() {
+			try
+			{
+				// minizip handles keep the current file position, so each thread needs its own.
+				std::shared_ptr<ZipFile> pZipFile = ZipFile::Load(path);
+
+				if (folders[i] == "kernel")
+				{
+					ExtractKernelFolder(*pZipFile);
+				}
+				else
+				{
+					ExtractFolder(*pZipFile, folders[i], header);
+				}
+
+				LOG_DEBUG_F("Extracted {} folder", folders[i]);
+				if (onFolderExtracted)
+				{
+					onFolderExtracted(folders[i]);
+				}
+			}
+			catch (...)
+			{
+				errors[i] = std::current_exception();
+			}
+		}));
 	}
 
-	return false;
-}
-
-void TxHashSetZip::ExtractKernelFolder(const ZipFile& zipFile) const
-{
-	std::error_code ec;
-
-	const fs::path kernelPath = m_config.GetNodeConfig().GetTxHashSetPath() / "kernel";
-	const bool exists = fs::exists(kernelPath, ec);
-	if (ec)
-	{
-		LOG_ERROR_F("fs::exists failed with error: {}", ec.message());
-		throw FILE_EXCEPTION_F("fs::exists failed with error: {}", ec.message());
-	}
+	ThreadUtil::JoinAll(threads);
 
-	if (exists)
+	bool success = true;
+	for (size_t i = 0; i < folders.size(); i++)
 	{
-		LOG_DEBUG("Kernel folder exists. Deleting its contents now.");
-		const uint64_t removedFiles = fs::remove_all(kernelPath, ec);
-		if (ec)
+		if (errors[i] != nullptr)
 		{
-			LOG_ERROR_F("fs::remove_all failed with error: {}", ec.message());
-			throw FILE_EXCEPTION_F("fs::remove_all failed with error: {}", ec.message());
+			try
+			{
+				std::rethrow_exception(errors[i]);
+			}
+			catch (std::exception& e)
+			{
+				LOG_ERROR_F("Failed to extract {} folder from {}. Exception thrown: {}", folders[i], path, e.what());
+			}
+			catch (...)
+			{
+				LOG_ERROR_F("Failed to extract {} folder from {}.", folders[i], path);
+			}
+
+			success = false;
 		}
-
-		LOG_DEBUG_F("{} files removed", removedFiles);
 	}
 
-	const bool kernelDirCreated = fs::create_directories(kernelPath, ec);
-	if (!kernelDirCreated || ec)
+	if (success)
 	{
-		LOG_ERROR_F("Failed to create Kernel folder. Error: {}", ec.message());
-		throw FILE_EXCEPTION_F("Failed to create Kernel folder. Error: {}", ec.message());
+		LOG_INFO("Successfully extracted zip file.");
 	}
 
-	const std::vector<std::string> kernelFiles = { "pmmr_data.bin", "pmmr_hash.bin" };
-	for (const std::string& file : kernelFiles)
-	{
-		zipFile.ExtractFile("kernel/" + file, kernelPath / file);
-	}
+	return success;
 }
 
-void TxHashSetZip::ExtractFolder(const ZipFile& zipFile, const std::string& folderName, const BlockHeader& header) const
+void TxHashSetZip::PrepareFolder(const fs::path& dir) const
 {
 	std::error_code ec;
 
-	const fs::path dir = m_config.GetNodeConfig().GetTxHashSetPath() / folderName;
 	const bool exists = fs::exists(dir, ec);
 	if (ec)
 	{
@@ -109,6 +114,24 @@ void TxHashSetZip::ExtractFolder(const ZipFile& zipFile, const std::string& fold
 		LOG_ERROR_F("Failed to create {}. Error: {}", dir, ec.message());
 		throw FILE_EXCEPTION_F("Failed to create {}. Error: {}", dir, ec.message());
 	}
+}
+
+void TxHashSetZip::ExtractKernelFolder(const ZipFile& zipFile) const
+{
+	const fs::path kernelPath = m_config.GetNodeConfig().GetTxHashSetPath() / "kernel";
+	PrepareFolder(kernelPath);
+
+	const std::vector<std::string> kernelFiles = { "pmmr_data.bin", "pmmr_hash.bin" };
+	for (const std::string& file : kernelFiles)
+	{
+		zipFile.ExtractFile("kernel/" + file, kernelPath / file);
+	}
+}
+
+void TxHashSetZip::ExtractFolder(const ZipFile& zipFile, const std::string& folderName, const BlockHeader& header) const
+{
+	const fs::path dir = m_config.GetNodeConfig().GetTxHashSetPath() / folderName;
+	PrepareFolder(dir);
 
 	const std::vector<std::string> files = { "pmmr_data.bin", "pmmr_hash.bin", "pmmr_prun.bin", "pmmr_leaf.bin." + header.ShortHash() };
 	for (const std::string& file : files)
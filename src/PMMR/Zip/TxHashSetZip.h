@@ -3,6 +3,8 @@
 #include <Core/Models/BlockHeader.h>
 #include <Config/Config.h>
 #include <filesystem.h>
+#include <functional>
+#include <string>
 
 // Forward Declarations
 class ZipFile;
@@ -10,15 +12,24 @@ class ZipFile;
 class TxHashSetZip
 {
 public:
+	//
+	// Called on the extracting thread as soon as the named folder ("kernel", "output" or "rangeproof") is fully written.
+	// Exceptions thrown by the callback fail the extraction.
+	//
+	using FolderCallback = std::function<void(const std::string& folderName)>;
+
 	TxHashSetZip(const Config& config);
 
-	bool Extract(const fs::path& path, const BlockHeader& header) const;
+	//
+	// Extracts the kernel, output, and rangeproof folders concurrently, each from its own handle to the zip file.
+	// Returns false if any folder failed to extract, after waiting for the others to finish.
+	//
+	bool Extract(const fs::path& path, const BlockHeader& header, const FolderCallback& onFolderExtracted = nullptr) const;
 
 private:
 	void ExtractKernelFolder(const ZipFile& zipFile) const;
 	void ExtractFolder(const ZipFile& zipFile, const std::string& folderName, const BlockHeader& header) const;
-	void ExtractOutputFolder(const ZipFile& zipFile, const BlockHeader& header) const;
-	void ExtractRangeProofFolder(const ZipFile& zipFile, const BlockHeader& header) const;
+	void PrepareFolder(const fs::path& dir) const;
 
 	const Config& m_config;
 };
\ No newline at end of file
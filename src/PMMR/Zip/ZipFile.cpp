@@ -49,16 +49,30 @@ void ZipFile::ExtractFile(const std::string& path, const fs::path& destination)
 		throw FILE_EXCEPTION("Failed to write to destination");
 	}
 
-	unsigned char buffer[256];
+	// Inflate in large chunks, since the MMR data files are hundreds of MB.
+	const unsigned int BUFFER_SIZE = 1024 * 1024;
+	std::vector<unsigned char> buffer(BUFFER_SIZE);
 	int readSize;
-	while ((readSize = unzReadCurrentFile(m_unzFile, &buffer, 256)) > 0)
+	while ((readSize = unzReadCurrentFile(m_unzFile, buffer.data(), BUFFER_SIZE)) > 0)
 	{
-		destinationFile.write((const char*)&buffer[0], readSize);
+		destinationFile.write((const char*)buffer.data(), readSize);
 	}
 
 	destinationFile.close();
 
 	unzCloseCurrentFile(m_unzFile);
+
+	if (readSize < 0)
+	{
+		LOG_ERROR_F("Failed to inflate path ({}) in zip file ({}). Error: {}", path, m_zipFilePath, readSize);
+		throw FILE_EXCEPTION("Failed to inflate file");
+	}
+
+	if (!destinationFile)
+	{
+		LOG_ERROR_F("Failed to write to destination ({}).", destination);
+		throw FILE_EXCEPTION("Failed to write to destination");
+	}
 }
 
 std::vector<std::string> ZipFile::ListFiles() const
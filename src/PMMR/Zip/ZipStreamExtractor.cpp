@@ -0,0 +1,349 @@
+#include "ZipStreamExtractor.h"
+
+#include <Core/Exceptions/FileException.h>
+#include <Common/Logger.h>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+static const uint32_t LOCAL_HEADER_SIGNATURE = 0x04034b50;
+static const uint32_t CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+static const uint32_t DATA_DESCRIPTOR_SIGNATURE = 0x08074b50;
+static const size_t LOCAL_HEADER_SIZE = 30;
+
+static const uint16_t FLAG_ENCRYPTED = 0x0001;
+static const uint16_t FLAG_DATA_DESCRIPTOR = 0x0008;
+static const uint16_t METHOD_STORED = 0;
+static const uint16_t METHOD_DEFLATED = 8;
+static const uint16_t ZIP64_EXTRA_FIELD = 0x0001;
+
+static const size_t OUTPUT_BUFFER_SIZE = 256 * 1024;
+
+// Zip fields are little endian.
+static uint16_t ReadU16(const unsigned char* pData)
+{
+	return (uint16_t)(pData[0] | (pData[1] << 8));
+}
+
+static uint32_t ReadU32(const unsigned char* pData)
+{
+	return (uint32_t)ReadU16(pData) | ((uint32_t)ReadU16(pData + 2) << 16);
+}
+
+static uint64_t ReadU64(const unsigned char* pData)
+{
+	return (uint64_t)ReadU32(pData) | ((uint64_t)ReadU32(pData + 4) << 32);
+}
+
+ZipStreamExtractor::ZipStreamExtractor(const std::unordered_map<std::string, fs::path>& entryPaths, const EntryCallback& onEntryExtracted)
+	: m_entryPaths(entryPaths),
+	m_onEntryExtracted(onEntryExtracted),
+	m_state(EState::LOCAL_HEADER),
+	m_inflating(false),
+	m_output(OUTPUT_BUFFER_SIZE)
+{
+	std::memset(&m_inflater, 0, sizeof(m_inflater));
+	m_entry.extracting = false;
+}
+
+ZipStreamExtractor::~ZipStreamExtractor()
+{
+	if (m_inflating)
+	{
+		inflateEnd(&m_inflater);
+	}
+}
+
+void ZipStreamExtractor::Append(const unsigned char* pData, const size_t numBytes)
+{
+	if (m_state == EState::DONE)
+	{
+		return;
+	}
+
+	m_buffer.insert(m_buffer.end(), pData, pData + numBytes);
+
+	size_t offset = 0;
+	while (m_state != EState::DONE)
+	{
+		const EState previousState = m_state;
+		const unsigned char* pNext = m_buffer.data() + offset;
+		const size_t available = m_buffer.size() - offset;
+
+		size_t consumed = 0;
+		switch (m_state)
+		{
+			case EState::LOCAL_HEADER:
+				consumed = ConsumeLocalHeader(pNext, available);
+				break;
+			case EState::ENTRY_DATA:
+				consumed = ConsumeEntryData(pNext, available);
+				break;
+			case EState::DATA_DESCRIPTOR:
+				consumed = ConsumeDataDescriptor(pNext, available);
+				break;
+			case EState::DONE:
+				break;
+		}
+
+		offset += consumed;
+		if (consumed == 0 && m_state == previousState)
+		{
+			break;
+		}
+	}
+
+	// Only an incomplete header or descriptor is left over, so this is rarely more than a few bytes.
+	m_buffer.erase(m_buffer.begin(), m_buffer.begin() + offset);
+}
+
+size_t ZipStreamExtractor::ConsumeLocalHeader(const unsigned char* pData, const size_t numBytes)
+{
+	if (numBytes < 4)
+	{
+		return 0;
+	}
+
+	const uint32_t signature = ReadU32(pData);
+	if (signature == CENTRAL_HEADER_SIGNATURE)
+	{
+		m_state = EState::DONE;
+		return 0;
+	}
+
+	if (signature != LOCAL_HEADER_SIGNATURE)
+	{
+		throw FILE_EXCEPTION_F("Unexpected zip signature {}", signature);
+	}
+
+	if (numBytes < LOCAL_HEADER_SIZE)
+	{
+		return 0;
+	}
+
+	const uint16_t flags = ReadU16(pData + 6);
+	const uint16_t method = ReadU16(pData + 8);
+	const uint32_t crc = ReadU32(pData + 14);
+	uint64_t compressedSize = ReadU32(pData + 18);
+	uint64_t uncompressedSize = ReadU32(pData + 22);
+	const uint16_t nameLength = ReadU16(pData + 26);
+	const uint16_t extraLength = ReadU16(pData + 28);
+
+	const size_t headerLength = LOCAL_HEADER_SIZE + nameLength + extraLength;
+	if (numBytes < headerLength)
+	{
+		return 0;
+	}
+
+	std::string name((const char*)pData + LOCAL_HEADER_SIZE, nameLength);
+	std::replace(name.begin(), name.end(), '\\', '/');
+
+	// The zip64 extra field replaces whichever sizes are 0xFFFFFFFF, in that order.
+	bool zip64 = false;
+	const unsigned char* pExtra = pData + LOCAL_HEADER_SIZE + nameLength;
+	for (size_t i = 0; i + 4 <= extraLength;)
+	{
+		const uint16_t fieldId = ReadU16(pExtra + i);
+		const uint16_t fieldLength = ReadU16(pExtra + i + 2);
+		if (fieldId == ZIP64_EXTRA_FIELD)
+		{
+			zip64 = true;
+
+			size_t fieldOffset = i + 4;
+			if (uncompressedSize == UINT32_MAX && fieldOffset + 8 <= extraLength)
+			{
+				uncompressedSize = ReadU64(pExtra + fieldOffset);
+				fieldOffset += 8;
+			}
+
+			if (compressedSize == UINT32_MAX && fieldOffset + 8 <= extraLength)
+			{
+				compressedSize = ReadU64(pExtra + fieldOffset);
+			}
+		}
+
+		i += 4 + fieldLength;
+	}
+
+	if ((flags & FLAG_ENCRYPTED) != 0)
+	{
+		throw FILE_EXCEPTION_F("Zip entry {} is encrypted", name);
+	}
+
+	if (method != METHOD_STORED && method != METHOD_DEFLATED)
+	{
+		throw FILE_EXCEPTION_F("Zip entry {} uses unsupported compression method {}", name, method);
+	}
+
+	const bool hasDataDescriptor = (flags & FLAG_DATA_DESCRIPTOR) != 0;
+	if (method == METHOD_STORED && hasDataDescriptor)
+	{
+		throw FILE_EXCEPTION_F("Size of stored zip entry {} isn't known until after its data", name);
+	}
+
+	m_entry.name = name;
+	m_entry.method = method;
+	m_entry.hasDataDescriptor = hasDataDescriptor;
+	m_entry.zip64 = zip64;
+	m_entry.expectedCrc = crc;
+	m_entry.remainingBytes = compressedSize;
+	m_entry.crc = crc32(0L, Z_NULL, 0);
+	m_entry.extracting = false;
+
+	auto iter = m_entryPaths.find(name);
+	if (iter != m_entryPaths.end())
+	{
+		fs::create_directories(iter->second.parent_path());
+		m_entry.file.open(iter->second, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!m_entry.file.is_open())
+		{
+			throw FILE_EXCEPTION_F("Failed to open {}", iter->second);
+		}
+
+		m_entry.extracting = true;
+	}
+
+	if (method == METHOD_DEFLATED)
+	{
+		// Raw deflate, since zip entries have no zlib header.
+		std::memset(&m_inflater, 0, sizeof(m_inflater));
+		const int status = inflateInit2(&m_inflater, -MAX_WBITS);
+		if (status != Z_OK)
+		{
+			throw FILE_EXCEPTION_F("inflateInit2 failed with error {}", status);
+		}
+
+		m_inflating = true;
+	}
+
+	m_state = EState::ENTRY_DATA;
+	return headerLength;
+}
+
+size_t ZipStreamExtractor::ConsumeEntryData(const unsigned char* pData, const size_t numBytes)
+{
+	if (m_entry.method == METHOD_STORED)
+	{
+		const size_t numToCopy = (size_t)std::min<uint64_t>(numBytes, m_entry.remainingBytes);
+		WriteOutput(pData, numToCopy);
+		m_entry.remainingBytes -= numToCopy;
+
+		if (m_entry.remainingBytes == 0)
+		{
+			FinishEntry();
+		}
+
+		return numToCopy;
+	}
+
+	if (numBytes == 0)
+	{
+		return 0;
+	}
+
+	m_inflater.next_in = (Bytef*)pData;
+	m_inflater.avail_in = (uInt)std::min<size_t>(numBytes, UINT_MAX);
+
+	int status = Z_OK;
+	while (status != Z_STREAM_END)
+	{
+		m_inflater.next_out = m_output.data();
+		m_inflater.avail_out = (uInt)m_output.size();
+
+		status = inflate(&m_inflater, Z_NO_FLUSH);
+		if (status == Z_BUF_ERROR)
+		{
+			// No progress is possible until more input arrives.
+			break;
+		}
+
+		if (status != Z_OK && status != Z_STREAM_END)
+		{
+			throw FILE_EXCEPTION_F("Failed to inflate zip entry {}. Error: {}", m_entry.name, status);
+		}
+
+		WriteOutput(m_output.data(), m_output.size() - m_inflater.avail_out);
+
+		// A full output buffer means zlib may have more to write, even once all input is consumed.
+		if (m_inflater.avail_in == 0 && m_inflater.avail_out != 0)
+		{
+			break;
+		}
+	}
+
+	const size_t consumed = numBytes - m_inflater.avail_in;
+	if (status == Z_STREAM_END)
+	{
+		inflateEnd(&m_inflater);
+		m_inflating = false;
+
+		if (m_entry.hasDataDescriptor)
+		{
+			m_state = EState::DATA_DESCRIPTOR;
+		}
+		else
+		{
+			FinishEntry();
+		}
+	}
+
+	return consumed;
+}
+
+size_t ZipStreamExtractor::ConsumeDataDescriptor(const unsigned char* pData, const size_t numBytes)
+{
+	if (numBytes < 4)
+	{
+		return 0;
+	}
+
+	// The signature is optional, and the sizes are 8 bytes each for zip64 entries.
+	const size_t signatureLength = ReadU32(pData) == DATA_DESCRIPTOR_SIGNATURE ? 4 : 0;
+	const size_t descriptorLength = signatureLength + 4 + (m_entry.zip64 ? 16 : 8);
+	if (numBytes < descriptorLength)
+	{
+		return 0;
+	}
+
+	m_entry.expectedCrc = ReadU32(pData + signatureLength);
+	FinishEntry();
+
+	return descriptorLength;
+}
+
+void ZipStreamExtractor::WriteOutput(const unsigned char* pData, const size_t numBytes)
+{
+	if (m_entry.extracting && numBytes > 0)
+	{
+		m_entry.file.write((const char*)pData, numBytes);
+		m_entry.crc = crc32(m_entry.crc, pData, (uInt)numBytes);
+	}
+}
+
+void ZipStreamExtractor::FinishEntry()
+{
+	m_state = EState::LOCAL_HEADER;
+
+	if (!m_entry.extracting)
+	{
+		return;
+	}
+
+	m_entry.file.close();
+	m_entry.extracting = false;
+	if (m_entry.file.fail())
+	{
+		throw FILE_EXCEPTION_F("Failed to write zip entry {}", m_entry.name);
+	}
+
+	if (m_entry.crc != m_entry.expectedCrc)
+	{
+		throw FILE_EXCEPTION_F("CRC mismatch for zip entry {}", m_entry.name);
+	}
+
+	LOG_TRACE_F("Extracted {}", m_entry.name);
+	if (m_onEntryExtracted)
+	{
+		m_onEntryExtracted(m_entry.name);
+	}
+}
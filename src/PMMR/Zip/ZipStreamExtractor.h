@@ -0,0 +1,85 @@
+#pragma once
+
+#include <filesystem.h>
+#include <zlib.h>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+//
+// Extracts entries from a zip file as its bytes arrive, using each entry's local header instead of the
+// central directory, which isn't available until the whole file is received.
+// Deflated entries end where their deflate stream does, so they can be streamed even when their sizes follow
+// in a data descriptor. Stored entries can only be streamed when their local header includes their size.
+//
+class ZipStreamExtractor
+{
+public:
+	//
+	// Called once an entry is fully written and its CRC is verified, with the entry's name in the zip.
+	// Exceptions thrown by the callback fail the extraction.
+	//
+	using EntryCallback = std::function<void(const std::string& entryName)>;
+
+	//
+	// Only entries named in entryPaths are extracted, each to its mapped path. All others are skipped.
+	//
+	ZipStreamExtractor(const std::unordered_map<std::string, fs::path>& entryPaths, const EntryCallback& onEntryExtracted);
+	~ZipStreamExtractor();
+
+	//
+	// Consumes the next bytes of the zip file.
+	// Throws a FileException if the zip is malformed or can't be streamed, after which the extractor can't be used.
+	//
+	void Append(const unsigned char* pData, const size_t numBytes);
+
+	//
+	// True once the central directory is reached, meaning every entry has been read.
+	//
+	bool IsComplete() const noexcept { return m_state == EState::DONE; }
+
+private:
+	enum class EState
+	{
+		LOCAL_HEADER,
+		ENTRY_DATA,
+		DATA_DESCRIPTOR,
+		DONE
+	};
+
+	struct Entry
+	{
+		std::string name;
+		uint16_t method;
+		bool hasDataDescriptor;
+		bool zip64;
+		uint32_t expectedCrc;
+		uint64_t remainingBytes;
+
+		bool extracting;
+		std::ofstream file;
+		uint32_t crc;
+	};
+
+	// Each returns the number of bytes consumed, or 0 (without changing state) if more bytes are needed.
+	size_t ConsumeLocalHeader(const unsigned char* pData, const size_t numBytes);
+	size_t ConsumeEntryData(const unsigned char* pData, const size_t numBytes);
+	size_t ConsumeDataDescriptor(const unsigned char* pData, const size_t numBytes);
+
+	void WriteOutput(const unsigned char* pData, const size_t numBytes);
+	void FinishEntry();
+
+	std::unordered_map<std::string, fs::path> m_entryPaths;
+	EntryCallback m_onEntryExtracted;
+
+	EState m_state;
+	std::vector<unsigned char> m_buffer;
+	Entry m_entry;
+
+	z_stream m_inflater;
+	bool m_inflating;
+	std::vector<unsigned char> m_output;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cstdint>
 #include <chrono>
 #include <ctime>
@@ -47,4 +48,124 @@ static u64 sipblock(siphash_keys& keys, const word_t edge, u64* buf)
     }
 
     return buf[edge & EDGE_BLOCK_MASK];
+}
+
+template <int rotE = 21>
+SIPHASH_LANES_TARGET static void sipnodes_lanes(const siphash_keys& keys, const u64* nonces, const u32 numNonces, u64* hashes)
+{
+    for (u32 n = 0; n < numNonces; n += SIPHASH_LANES)
+    {
+        // the last group is padded by repeating the final nonce
+        u64 laneNonces[SIPHASH_LANES], laneHashes[SIPHASH_LANES];
+        for (u32 i = 0; i < SIPHASH_LANES; i++)
+        {
+            laneNonces[i] = nonces[(std::min)(n + i, numNonces - 1)];
+        }
+
+        siphash_state_lanes<rotE> shs(keys);
+        shs.hash24(laneNonces);
+        shs.xor_lanes(laneHashes);
+
+        for (u32 i = 0; i < SIPHASH_LANES && n + i < numNonces; i++)
+        {
+            hashes[n + i] = laneHashes[i];
+        }
+    }
+}
+
+// hashes each of nonces[0..numNonces) with its own fresh siphash_state, SIPHASH_LANES at a time when supported
+// (the batched form of calling hash24 on a new state per nonce, as cuckatoo's sipnode does)
+template <int rotE = 21>
+static void sipnodes(const siphash_keys& keys, const u64* nonces, const u32 numNonces, u64* hashes)
+{
+    static const bool useLanes = SIPHASH_LANES_SUPPORTED();
+    if (useLanes)
+    {
+        sipnodes_lanes<rotE>(keys, nonces, numNonces, hashes);
+        return;
+    }
+
+    for (u32 n = 0; n < numNonces; n++)
+    {
+        siphash_state<rotE> shs(keys);
+        shs.hash24(nonces[n]);
+        hashes[n] = shs.xor_lanes();
+    }
+}
+
+template <int rotE = 21>
+SIPHASH_LANES_TARGET static void sipblocks_lanes(const siphash_keys& keys, const word_t* edges, const u32 numEdges, u64 (*bufs)[EDGE_BLOCK_SIZE])
+{
+    for (u32 n = 0; n < numEdges; n += SIPHASH_LANES)
+    {
+        // the last group is padded by repeating the final edge
+        u64 edge0[SIPHASH_LANES];
+        for (u32 i = 0; i < SIPHASH_LANES; i++)
+        {
+            edge0[i] = edges[(std::min)(n + i, numEdges - 1)] & ~EDGE_BLOCK_MASK;
+        }
+
+        siphash_state_lanes<rotE> shs(keys);
+        for (u32 j = 0; j < EDGE_BLOCK_SIZE; j++)
+        {
+            u64 nonces[SIPHASH_LANES], hashes[SIPHASH_LANES];
+            for (u32 i = 0; i < SIPHASH_LANES; i++)
+            {
+                nonces[i] = edge0[i] + j;
+            }
+
+            shs.hash24(nonces);
+            shs.xor_lanes(hashes);
+
+            for (u32 i = 0; i < SIPHASH_LANES && n + i < numEdges; i++)
+            {
+                bufs[n + i][j] = hashes[i];
+            }
+        }
+    }
+}
+
+// fills bufs[n] with the EDGE_BLOCK_SIZE raw siphash outputs (before any xoring) for the block containing edges[n].
+// the outputs within a block are chained through a single state, so rather than splitting a block
+// across lanes, the lanes hash the blocks of SIPHASH_LANES different edges side by side when supported.
+template <int rotE = 21>
+static void sipblocks(const siphash_keys& keys, const word_t* edges, const u32 numEdges, u64 (*bufs)[EDGE_BLOCK_SIZE])
+{
+    static const bool useLanes = SIPHASH_LANES_SUPPORTED();
+    if (useLanes)
+    {
+        sipblocks_lanes<rotE>(keys, edges, numEdges, bufs);
+        return;
+    }
+
+    for (u32 n = 0; n < numEdges; n++)
+    {
+        siphash_state<rotE> shs(keys);
+        const word_t edge0 = edges[n] & ~EDGE_BLOCK_MASK;
+        for (u32 j = 0; j < EDGE_BLOCK_SIZE; j++)
+        {
+            shs.hash24(edge0 + j);
+            bufs[n][j] = shs.xor_lanes();
+        }
+    }
+}
+
+// siphash output for edge given the raw outputs of its block, as returned by sipblock (cuckaroo, cuckarood)
+static u64 sipblock_edge(const u64* buf, const word_t edge)
+{
+    const u32 i = edge & EDGE_BLOCK_MASK;
+    return i == EDGE_BLOCK_MASK ? buf[i] : (buf[i] ^ buf[EDGE_BLOCK_MASK]);
+}
+
+// siphash output for edge given the raw outputs of its block, where every output is xored
+// with all the outputs after it (cuckaroom, cuckarooz)
+static u64 sipblock_suffix_edge(const u64* buf, const word_t edge)
+{
+    u64 result = 0;
+    for (u32 i = edge & EDGE_BLOCK_MASK; i < EDGE_BLOCK_SIZE; i++)
+    {
+        result ^= buf[i];
+    }
+
+    return result;
 }
\ No newline at end of file
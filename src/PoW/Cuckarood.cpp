@@ -18,7 +18,7 @@
 int verify_cuckarood(const word_t edges[PROOFSIZE], siphash_keys& keys)
 {
     word_t xor0 = 0, xor1 = 0;
-    u64 sips[EDGE_BLOCK_SIZE];
+    u64 sips[PROOFSIZE][EDGE_BLOCK_SIZE];
     word_t uvs[2 * PROOFSIZE];
     u32 ndir[2] = { 0, 0 };
 
@@ -30,7 +30,13 @@ int verify_cuckarood(const word_t edges[PROOFSIZE], siphash_keys& keys)
             return POW_TOO_BIG;
         if (n && edges[n] <= edges[n - 1])
             return POW_TOO_SMALL;
-        u64 edge = sipblock<25>(keys, edges[n], sips);
+        ndir[dir]++;
+    }
+    sipblocks<25>(keys, edges, PROOFSIZE, sips);
+    ndir[0] = ndir[1] = 0;
+    for (u32 n = 0; n < PROOFSIZE; n++) {
+        u32 dir = edges[n] & 1;
+        u64 edge = sipblock_edge(sips[n], edges[n]);
         xor0 ^= uvs[4 * ndir[dir] + 2 * dir] = edge & NODE1MASK;
         // printf("%2d %8x\t", 4 * ndir[dir] + 2 * dir , edge        & NODE1MASK);
         xor1 ^= uvs[4 * ndir[dir] + 2 * dir + 1] = (edge >> 32) & NODE1MASK;
@@ -14,31 +14,11 @@
 // used to mask siphash output
 #define NODEMASK ((word_t)NNODES - 1)
 
-// fills buffer with EDGE_BLOCK_SIZE siphash outputs for block containing edge in cuckaroo graph
-// return siphash output for given edge
-uint64_t cuckarooz_sipblock(siphash_keys& keys, const word_t edge, uint64_t* buf)
-{
-    siphash_state<> shs(keys);
-    word_t edge0 = edge & ~EDGE_BLOCK_MASK;
-    for (uint32_t i = 0; i < EDGE_BLOCK_SIZE; i++)
-    {
-        shs.hash24(edge0 + i);
-        buf[i] = shs.xor_lanes();
-    }
-
-    for (uint32_t i = EDGE_BLOCK_MASK; i; i--)
-    {
-        buf[i - 1] ^= buf[i];
-    }
-
-    return buf[edge & EDGE_BLOCK_MASK];
-}
-
 // verify that edges are ascending and form a cycle in header-generated graph
 int verify_cuckarooz(const word_t edges[PROOFSIZE], siphash_keys& keys)
 {
     word_t xoruv = 0;
-    u64 sips[EDGE_BLOCK_SIZE];
+    u64 sips[PROOFSIZE][EDGE_BLOCK_SIZE];
     word_t uv[2 * PROOFSIZE];
 
     for (u32 n = 0; n < PROOFSIZE; n++)
@@ -50,8 +30,12 @@ int verify_cuckarooz(const word_t edges[PROOFSIZE], siphash_keys& keys)
         if (n && edges[n] <= edges[n - 1]) {
             return POW_TOO_SMALL;
         }
+    }
 
-        u64 edge = cuckarooz_sipblock(keys, edges[n], sips);
+    sipblocks(keys, edges, PROOFSIZE, sips);
+    for (u32 n = 0; n < PROOFSIZE; n++)
+    {
+        u64 edge = sipblock_suffix_edge(sips[n], edges[n]);
         xoruv ^= uv[2 * n] = edge & NODEMASK;
         xoruv ^= uv[2 * n + 1] = (edge >> 32) & NODEMASK;
     }
@@ -15,6 +15,7 @@ word_t sipnode(siphash_keys* keys, word_t edge, u32 uorv, const word_t edgeMask)
 int verify_cuckatoo(const word_t edges[PROOFSIZE], siphash_keys* keys, const uint8_t edgeBits)
 {
     word_t uvs[2 * PROOFSIZE], xor0, xor1;
+    u64 nonces[2 * PROOFSIZE];
     xor0 = xor1 = (PROOFSIZE / 2) & 1;
 
     // number of edges
@@ -33,8 +34,16 @@ int verify_cuckatoo(const word_t edges[PROOFSIZE], siphash_keys* keys, const uin
             return POW_TOO_SMALL;
         }
 
-        xor0 ^= uvs[2 * n] = sipnode(keys, edges[n], 0, edgeMask);
-        xor1 ^= uvs[2 * n + 1] = sipnode(keys, edges[n], 1, edgeMask);
+        nonces[2 * n] = 2 * edges[n];
+        nonces[2 * n + 1] = 2 * edges[n] + 1;
+    }
+
+    // same as sipnode, for all the endpoints at once
+    sipnodes(*keys, nonces, 2 * PROOFSIZE, uvs);
+    for (u32 n = 0; n < PROOFSIZE; n++)
+    {
+        xor0 ^= uvs[2 * n] &= edgeMask;
+        xor1 ^= uvs[2 * n + 1] &= edgeMask;
     }
 
     // optional check for obviously bad proofs
@@ -1,5 +1,6 @@
 #include "DifficultyCalculator.h"
 #include "DifficultyLoader.h"
+#include "DifficultyWindowCache.h"
 
 #include <Consensus/BlockDifficulty.h>
 
@@ -30,11 +31,25 @@ HeaderInfo DifficultyCalculator::CalculateNextDifficulty(const BlockHeader& head
 	// to latest, and pad with simulated pre-genesis data to allow earlier
 	// adjustment if there isn't enough window data length will be
 	// DIFFICULTY_ADJUST_WINDOW + 1 (for initial block time bound)
-	const std::vector<HeaderInfo> difficultyData = DifficultyLoader(m_pBlockDB).LoadDifficultyData(header);
+	return CalculateNextDifficulty(header.GetHeight(), LoadDifficultyData(header));
+}
+
+std::vector<HeaderInfo> DifficultyCalculator::LoadDifficultyData(const BlockHeader& header) const
+{
+	std::vector<HeaderInfo> difficultyData;
+	if (!DifficultyWindowCache::GetInstance().GetWindow(header.GetPreviousHash(), difficultyData))
+	{
+		difficultyData = DifficultyLoader(m_pBlockDB).LoadDifficultyData(header);
+	}
+
+	return difficultyData;
+}
 
+HeaderInfo DifficultyCalculator::CalculateNextDifficulty(const uint64_t height, const std::vector<HeaderInfo>& difficultyData) const
+{
 	// First, get the ratio of secondary PoW vs primary, skipping initial header
 	const std::vector<HeaderInfo> difficultyDataSkipFirst(difficultyData.cbegin() + 1, difficultyData.cend());
-	const uint64_t sec_pow_scaling = SecondaryPOWScaling(header.GetHeight(), difficultyDataSkipFirst);
+	const uint64_t sec_pow_scaling = SecondaryPOWScaling(height, difficultyDataSkipFirst);
 
 	// Get the timestamp delta across the window
 	const uint64_t ts_delta = difficultyData[DIFFICULTY_ADJUST_WINDOW].GetTimestamp() - difficultyData[0].GetTimestamp();
@@ -57,6 +72,26 @@ HeaderInfo DifficultyCalculator::CalculateNextDifficulty(const BlockHeader& head
 	return HeaderInfo::FromDiffAndScaling(difficulty, sec_pow_scaling);
 }
 
+void DifficultyCalculator::CacheNextWindow(
+	const BlockHeader& header,
+	const BlockHeader& previousHeader,
+	const std::vector<HeaderInfo>& difficultyData)
+{
+	// Windows closer to genesis are padded with simulated data, so they can't simply be rolled forward.
+	if (header.GetHeight() <= DIFFICULTY_ADJUST_WINDOW || difficultyData.size() != (DIFFICULTY_ADJUST_WINDOW + 1))
+	{
+		return;
+	}
+
+	const HeaderInfo headerInfo(
+		header.GetTimestamp(),
+		header.GetTotalDifficulty() - previousHeader.GetTotalDifficulty(),
+		header.GetScalingDifficulty(),
+		header.GetProofOfWork().IsSecondary()
+	);
+	DifficultyWindowCache::GetInstance().AddNextWindow(header.GetHash(), difficultyData, headerInfo);
+}
+
 // Count, in units of 1/100 (a percent), the number of "secondary" (AR) blocks in the provided window of blocks.
 uint64_t DifficultyCalculator::ARCount(const std::vector<HeaderInfo>& difficultyData) const
 {
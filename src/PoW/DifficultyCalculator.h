@@ -12,6 +12,27 @@ public:
 
 	HeaderInfo CalculateNextDifficulty(const BlockHeader& blockHeader) const;
 
+	//
+	// Returns the DIFFICULTY_ADJUST_WINDOW + 1 entries (earliest to latest) preceding the header.
+	// Uses the DifficultyWindowCache when the previous header's window is cached, otherwise loads it from the block db.
+	//
+	std::vector<HeaderInfo> LoadDifficultyData(const BlockHeader& blockHeader) const;
+
+	//
+	// Calculates the next difficulty for the header at the given height, using difficultyData from LoadDifficultyData.
+	//
+	HeaderInfo CalculateNextDifficulty(const uint64_t height, const std::vector<HeaderInfo>& difficultyData) const;
+
+	//
+	// Caches the window that follows blockHeader, so its child can be validated without touching the block db.
+	// Must only be called once the header's proof of work has been verified.
+	//
+	static void CacheNextWindow(
+		const BlockHeader& blockHeader,
+		const BlockHeader& previousHeader,
+		const std::vector<HeaderInfo>& difficultyData
+	);
+
 private:
 	uint64_t ARCount(const std::vector<HeaderInfo>& difficultyData) const;
 	uint64_t ScalingFactorSum(const std::vector<HeaderInfo>& difficultyData) const;
@@ -0,0 +1,58 @@
+#include "DifficultyWindowCache.h"
+
+#include <algorithm>
+
+DifficultyWindowCache& DifficultyWindowCache::GetInstance()
+{
+	static DifficultyWindowCache cache;
+	return cache;
+}
+
+bool DifficultyWindowCache::GetWindow(const Hash& tipHash, std::vector<HeaderInfo>& window) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = std::find_if(
+		m_windows.crbegin(),
+		m_windows.crend(),
+		[&tipHash](const Entry& entry) { return entry.TIP_HASH == tipHash; }
+	);
+	if (iter == m_windows.crend())
+	{
+		return false;
+	}
+
+	window = iter->WINDOW;
+	return true;
+}
+
+void DifficultyWindowCache::AddNextWindow(const Hash& tipHash, const std::vector<HeaderInfo>& previousWindow, const HeaderInfo& tipInfo)
+{
+	if (previousWindow.empty())
+	{
+		return;
+	}
+
+	std::vector<HeaderInfo> window;
+	window.reserve(previousWindow.size());
+	window.insert(window.end(), previousWindow.cbegin() + 1, previousWindow.cend());
+	window.push_back(tipInfo);
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = std::find_if(
+		m_windows.cbegin(),
+		m_windows.cend(),
+		[&tipHash](const Entry& entry) { return entry.TIP_HASH == tipHash; }
+	);
+	if (iter != m_windows.cend())
+	{
+		return;
+	}
+
+	m_windows.push_back(Entry{ tipHash, std::move(window) });
+	while (m_windows.size() > MAX_WINDOWS)
+	{
+		m_windows.pop_front();
+	}
+}
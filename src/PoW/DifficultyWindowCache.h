@@ -0,0 +1,47 @@
+#pragma once
+
+#include "HeaderInfo.h"
+
+#include <Crypto/Hash.h>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+//
+// Keeps the difficulty windows following the most recently validated headers,
+// so validating consecutive headers only pops the oldest entry and pushes the newest,
+// instead of walking back DIFFICULTY_ADJUST_WINDOW headers through the block db.
+//
+// Windows are keyed by the hash of the newest header they include, which commits to (via its PoW) everything in the window.
+// Only windows following headers whose proof of work was verified are added.
+// After a reorg, lookups for the new branch simply miss and the caller falls back to the DifficultyLoader.
+//
+class DifficultyWindowCache
+{
+public:
+	static DifficultyWindowCache& GetInstance();
+
+	//
+	// Copies the difficulty window (earliest to latest) ending at the header with the given hash.
+	// Returns false if the window is not cached.
+	//
+	bool GetWindow(const Hash& tipHash, std::vector<HeaderInfo>& window) const;
+
+	//
+	// Caches the window ending at tipHash, built by dropping the earliest entry of previousWindow and appending tipInfo.
+	//
+	void AddNextWindow(const Hash& tipHash, const std::vector<HeaderInfo>& previousWindow, const HeaderInfo& tipInfo);
+
+private:
+	// A few windows are kept, so competing forks near the tip don't evict each other.
+	static constexpr size_t MAX_WINDOWS = 8;
+
+	struct Entry
+	{
+		Hash TIP_HASH;
+		std::vector<HeaderInfo> WINDOW;
+	};
+
+	mutable std::mutex m_mutex;
+	std::deque<Entry> m_windows;
+};
@@ -1,6 +1,7 @@
 #include <PoW/PoWManager.h>
 
 #include "PoWValidator.h"
+#include "VerifiedPoWCache.h"
 
 PoWManager::PoWManager(const Config& config, std::shared_ptr<const IBlockDB> pBlockDB)
 	: m_config(config), m_pBlockDB(pBlockDB)
@@ -16,4 +17,29 @@ bool PoWManager::IsPoWValid(const BlockHeader& header, const BlockHeader& previo
 	}
 
 	return PoWValidator(m_config, m_pBlockDB).IsPoWValid(header, previousHeader);
+}
+
+bool PoWManager::IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const
+{
+	if (m_config.GetEnvironment().IsAutomatedTesting())
+	{
+		return true;
+	}
+
+	return PoWValidator(m_config, m_pBlockDB).IsDifficultyValid(header, previousHeader);
+}
+
+bool PoWManager::IsProofValid(const BlockHeader& header) const
+{
+	if (m_config.GetEnvironment().IsAutomatedTesting())
+	{
+		return true;
+	}
+
+	return PoWValidator(m_config, m_pBlockDB).IsProofValid(header);
+}
+
+CacheStats PoWManager::GetProofCacheStats()
+{
+	return VerifiedPoWCache::GetInstance().GetStats();
 }
\ No newline at end of file
@@ -7,6 +7,7 @@
 #include "Cuckaroom.h"
 #include "Cuckarooz.h"
 #include "Cuckatoo.h"
+#include "VerifiedPoWCache.h"
 
 #include <Consensus/BlockTime.h>
 #include <Consensus/BlockDifficulty.h>
@@ -18,6 +19,33 @@ PoWValidator::PoWValidator(const Config& config, std::shared_ptr<const IBlockDB>
 }
 
 bool PoWValidator::IsPoWValid(const BlockHeader& header, const BlockHeader& previousHeader) const
+{
+	std::vector<HeaderInfo> difficultyData;
+	if (!ValidateDifficulty(header, previousHeader, difficultyData) || !IsProofValid(header))
+	{
+		return false;
+	}
+
+	DifficultyCalculator::CacheNextWindow(header, previousHeader, difficultyData);
+	return true;
+}
+
+bool PoWValidator::IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const
+{
+	std::vector<HeaderInfo> difficultyData;
+	if (!ValidateDifficulty(header, previousHeader, difficultyData))
+	{
+		return false;
+	}
+
+	DifficultyCalculator::CacheNextWindow(header, previousHeader, difficultyData);
+	return true;
+}
+
+bool PoWValidator::ValidateDifficulty(
+	const BlockHeader& header,
+	const BlockHeader& previousHeader,
+	std::vector<HeaderInfo>& difficultyData) const
 {
 	// Validate Total Difficulty
 	if (header.GetTotalDifficulty() <= previousHeader.GetTotalDifficulty())
@@ -34,7 +62,9 @@ bool PoWValidator::IsPoWValid(const BlockHeader& header, const BlockHeader& prev
 	}
 
 	// Explicit check to ensure total_difficulty has increased by exactly the _network_ difficulty of the previous block.
-	const HeaderInfo nextHeaderInfo = DifficultyCalculator(m_pBlockDB).CalculateNextDifficulty(header);
+	const DifficultyCalculator difficultyCalculator(m_pBlockDB);
+	difficultyData = difficultyCalculator.LoadDifficultyData(header);
+	const HeaderInfo nextHeaderInfo = difficultyCalculator.CalculateNextDifficulty(header.GetHeight(), difficultyData);
 	if (targetDifficulty != nextHeaderInfo.GetDifficulty())
 	{
 		LOG_WARNING_F("Target difficulty invalid for block {} with previous block {}", header, previousHeader);
@@ -48,6 +78,29 @@ bool PoWValidator::IsPoWValid(const BlockHeader& header, const BlockHeader& prev
 		return false;
 	}
 
+	return true;
+}
+
+bool PoWValidator::IsProofValid(const BlockHeader& header) const
+{
+	VerifiedPoWCache& cache = VerifiedPoWCache::GetInstance();
+	const Hash key = VerifiedPoWCache::GetKey(header);
+	if (cache.WasVerified(key))
+	{
+		return true;
+	}
+
+	if (!VerifyProof(header))
+	{
+		return false;
+	}
+
+	cache.AddVerified(key);
+	return true;
+}
+
+bool PoWValidator::VerifyProof(const BlockHeader& header) const
+{
 	const ProofOfWork& proofOfWork = header.GetProofOfWork();
 	const EPoWType powType = PoWUtil(m_config).DeterminePoWType(header.GetVersion(), proofOfWork.GetEdgeBits());
 	if (powType == EPoWType::CUCKAROO)
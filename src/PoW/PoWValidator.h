@@ -3,6 +3,8 @@
 #include <Core/Models/BlockHeader.h>
 #include <Config/Config.h>
 #include <Database/BlockDb.h>
+#include "HeaderInfo.h"
+#include <vector>
 
 class PoWValidator
 {
@@ -11,7 +13,23 @@ public:
 
 	bool IsPoWValid(const BlockHeader& header, const BlockHeader& previousHeader) const;
 
+	//
+	// Checks the total and secondary scaling difficulty against the chain.
+	// Requires the previous difficulty window to be available in the block db.
+	// The header's proof must already have been verified, since its difficulty window is cached for its children.
+	//
+	bool IsDifficultyValid(const BlockHeader& header, const BlockHeader& previousHeader) const;
+
+	//
+	// Verifies the cuckoo cycle only. Depends on nothing but the header itself,
+	// so it can run for many headers in parallel without holding any chain locks.
+	// Proofs already verified are found in the VerifiedPoWCache rather than verified again.
+	//
+	bool IsProofValid(const BlockHeader& header) const;
+
 private:
+	bool VerifyProof(const BlockHeader& header) const;
+	bool ValidateDifficulty(const BlockHeader& header, const BlockHeader& previousHeader, std::vector<HeaderInfo>& difficultyData) const;
 	uint64_t GetMaximumDifficulty(const BlockHeader& header) const;
 
 	const Config& m_config;
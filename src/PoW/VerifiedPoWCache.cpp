@@ -0,0 +1,61 @@
+#include "VerifiedPoWCache.h"
+
+#include <Core/Serialization/Serializer.h>
+#include <Crypto/Hasher.h>
+
+VerifiedPoWCache& VerifiedPoWCache::GetInstance()
+{
+	static VerifiedPoWCache cache;
+	return cache;
+}
+
+Hash VerifiedPoWCache::GetKey(const BlockHeader& header)
+{
+	Serializer serializer;
+	serializer.AppendByteVector(header.GetPreProofOfWork());
+	header.GetProofOfWork().Serialize(serializer);
+	return Hasher::Blake2b(serializer.GetBytes());
+}
+
+bool VerifiedPoWCache::WasVerified(const Hash& key) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = m_entries.find(key);
+	if (iter == m_entries.end())
+	{
+		++m_misses;
+		return false;
+	}
+
+	m_lru.splice(m_lru.begin(), m_lru, iter->second);
+	++m_hits;
+	return true;
+}
+
+void VerifiedPoWCache::AddVerified(const Hash& key)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+
+	auto iter = m_entries.find(key);
+	if (iter != m_entries.end())
+	{
+		m_lru.splice(m_lru.begin(), m_lru, iter->second);
+		return;
+	}
+
+	m_lru.push_front(key);
+	m_entries[key] = m_lru.begin();
+
+	while (m_entries.size() > MAX_ENTRIES)
+	{
+		m_entries.erase(m_lru.back());
+		m_lru.pop_back();
+	}
+}
+
+CacheStats VerifiedPoWCache::GetStats() const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	return CacheStats{ MAX_ENTRIES, m_entries.size(), m_hits, m_misses };
+}
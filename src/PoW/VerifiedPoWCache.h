@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Common/CacheStats.h>
+#include <Core/Models/BlockHeader.h>
+#include <Crypto/Hash.h>
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+//
+// Remembers the headers whose cuckoo cycle was recently verified, so a header seen again
+// (broadcast, then in a headers batch, then in its compact and full block, or after a reorg) isn't re-verified.
+//
+// The header hash only commits to the cycle, so entries are keyed by a hash of the pre-PoW bytes,
+// edge bits, and proof nonces instead. A different header reusing a verified proof never hits.
+// Only valid proofs are added.
+//
+class VerifiedPoWCache
+{
+public:
+	static VerifiedPoWCache& GetInstance();
+
+	static Hash GetKey(const BlockHeader& header);
+
+	bool WasVerified(const Hash& key) const;
+	void AddVerified(const Hash& key);
+
+	CacheStats GetStats() const;
+
+private:
+	VerifiedPoWCache() : m_hits(0), m_misses(0) { }
+
+	// Comfortably more than a headers batch plus the blocks near the tip.
+	static constexpr size_t MAX_ENTRIES = 4096;
+
+	mutable std::mutex m_mutex;
+
+	// Most recently used at the front.
+	mutable std::list<Hash> m_lru;
+	std::unordered_map<Hash, std::list<Hash>::iterator> m_entries;
+
+	mutable std::atomic<uint64_t> m_hits;
+	mutable std::atomic<uint64_t> m_misses;
+};
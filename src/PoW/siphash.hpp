@@ -58,4 +58,67 @@ public:
     v2 ^= 0xff;
     sip_round(); sip_round(); sip_round(); sip_round();
   }
-};
\ No newline at end of file
+};
+
+// number of independent siphash states advanced together by siphash_state_lanes (one 256-bit vector)
+#define SIPHASH_LANES 4
+
+// SIPHASH_LANES_TARGET marks functions running siphash_state_lanes, so they're compiled for a
+// vector unit with 64-bit lanes, and SIPHASH_LANES_SUPPORTED() checks at runtime that the cpu has it.
+// without one (eg. plain SSE2, which has no 64-bit rotates) the lanes are slower than scalar hashing.
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SIPHASH_LANES_TARGET __attribute__((target("avx2")))
+#define SIPHASH_LANES_SUPPORTED() __builtin_cpu_supports("avx2")
+#elif defined(__aarch64__)
+#define SIPHASH_LANES_TARGET
+#define SIPHASH_LANES_SUPPORTED() true
+#else
+#define SIPHASH_LANES_TARGET
+#define SIPHASH_LANES_SUPPORTED() false
+#endif
+
+// SIPHASH_LANES siphash_states, each with its own nonce stream.
+// every step of a round is applied across all lanes, so the compiler keeps the states in
+// vector registers (AVX2/NEON) instead of running the lanes one after another.
+template <int rotE = 21>
+class siphash_state_lanes {
+public:
+  uint64_t v0[SIPHASH_LANES];
+  uint64_t v1[SIPHASH_LANES];
+  uint64_t v2[SIPHASH_LANES];
+  uint64_t v3[SIPHASH_LANES];
+
+  siphash_state_lanes(const siphash_keys &sk) {
+    for (int i = 0; i < SIPHASH_LANES; i++) {
+      v0[i] = sk.k0; v1[i] = sk.k1; v2[i] = sk.k2; v3[i] = sk.k3;
+    }
+  }
+  void xor_lanes(uint64_t *out) const {
+    for (int i = 0; i < SIPHASH_LANES; i++) {
+      out[i] = (v0[i] ^ v1[i]) ^ (v2[i] ^ v3[i]);
+    }
+  }
+  static uint64_t rotl(uint64_t x, uint64_t b) {
+    return (x << b) | (x >> (64 - b));
+  }
+  void sip_round() {
+    for (int i = 0; i < SIPHASH_LANES; i++) {
+      v0[i] += v1[i]; v2[i] += v3[i]; v1[i] = rotl(v1[i],13);
+      v3[i] = rotl(v3[i],16); v1[i] ^= v0[i]; v3[i] ^= v2[i];
+      v0[i] = rotl(v0[i],32); v2[i] += v1[i]; v0[i] += v3[i];
+      v1[i] = rotl(v1[i],17);   v3[i] = rotl(v3[i],rotE);
+      v1[i] ^= v2[i]; v3[i] ^= v0[i]; v2[i] = rotl(v2[i],32);
+    }
+  }
+  void hash24(const uint64_t *nonces) {
+    for (int i = 0; i < SIPHASH_LANES; i++) {
+      v3[i] ^= nonces[i];
+    }
+    sip_round(); sip_round();
+    for (int i = 0; i < SIPHASH_LANES; i++) {
+      v0[i] ^= nonces[i];
+      v2[i] ^= 0xff;
+    }
+    sip_round(); sip_round(); sip_round(); sip_round();
+  }
+};
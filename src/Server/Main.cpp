@@ -18,11 +18,13 @@
 #include <thread>
 #include <chrono>
 #include <atomic>
+#include <map>
 
 using namespace std::chrono;
 
 ConfigPtr Initialize(const EEnvironmentType environment, const bool headless);
 void Run(const ConfigPtr& pConfig, const Options& options);
+void LogThreadStats(std::map<std::string, ThreadGroupStats>& previous);
 
 int main(int argc, char* argv[])
 {
@@ -75,7 +77,12 @@ ConfigPtr Initialize(const EEnvironmentType environment, const bool headless)
 
 	try
 	{
-		LoggerAPI::Initialize(pConfig->GetLogDirectory(), pConfig->GetLogLevel());
+		LoggerAPI::Initialize(
+			pConfig->GetLogDirectory(),
+			pConfig->GetLogLevel(),
+			pConfig->BlockOnLogOverflow(),
+			pConfig->GetLogCallSiteRateLimit()
+		);
 	}
 	catch (std::exception& e)
 	{
@@ -129,6 +136,10 @@ void Run(const ConfigPtr& pConfig, const Options& options)
 		);
 	}
 
+	const seconds threadStatsInterval(pContext->GetConfig().GetNodeConfig().GetThreadStatsLogSecs());
+	std::map<std::string, ThreadGroupStats> previousThreadStats;
+	steady_clock::time_point lastThreadStats = steady_clock::now();
+
 	system_clock::time_point startTime = system_clock::now();
 	while (true)
 	{
@@ -150,8 +161,47 @@ void Run(const ConfigPtr& pConfig, const Options& options)
 			pNode->UpdateDisplay(secondsRunning);
 		}
 
+		if (pNode != nullptr && threadStatsInterval.count() > 0 && steady_clock::now() >= lastThreadStats + threadStatsInterval)
+		{
+			LogThreadStats(previousThreadStats);
+			lastThreadStats = steady_clock::now();
+		}
+
 		ThreadUtil::SleepFor(seconds(1), ShutdownManagerAPI::WasShutdownRequested());
 	}
 
 	LOG_INFO_F("Closing Grin++ v{}", GRINPP_VERSION);
+}
+
+//
+// Logs each thread name's share of CPU and wait time since the last log, so busy threads can be spotted without a profiler.
+//
+void LogThreadStats(std::map<std::string, ThreadGroupStats>& previous)
+{
+	for (const ThreadGroupStats& group : ThreadManagerAPI::GetThreadGroupStats())
+	{
+		ThreadGroupStats delta = group;
+		auto iter = previous.find(group.name);
+		if (iter != previous.end())
+		{
+			delta.cpuMicros -= iter->second.cpuMicros;
+			delta.waitMicros -= iter->second.waitMicros;
+			delta.wallMicros -= iter->second.wallMicros;
+		}
+
+		previous[group.name] = group;
+		if (delta.wallMicros == 0)
+		{
+			continue;
+		}
+
+		LOG_INFO_F(
+			"Threads {} (x{}): {:.1f}s CPU ({:.1f}%), {:.1f}% waiting",
+			group.name,
+			group.numThreads,
+			delta.cpuMicros / 1'000'000.0,
+			(delta.cpuMicros * 100.0) / delta.wallMicros,
+			(delta.waitMicros * 100.0) / delta.wallMicros
+		);
+	}
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "../NodeContext.h"
 
 #include <Net/Util/HTTPUtil.h>
+#include <Net/Util/JsonStreamWriter.h>
 #include <Core/Models/CompactBlock.h>
 #include <Common/Util/StringUtil.h>
 #include <Common/Logger.h>
@@ -16,15 +17,18 @@
 //
 // Return results as "compact blocks" by passing "?compact" query
 // GET /v1/blocks/<hash>?compact
+//
+// Indent the results by passing "?pretty" query
+// GET /v1/blocks/<hash>?pretty
 int BlockAPI::GetBlock_Handler(struct mg_connection* conn, void* pNodeContext)
 {
+	std::unique_ptr<JsonStreamWriter> pWriter = nullptr;
 	try
 	{
 		const std::string requestedBlock = HTTPUtil::GetURIParam(conn, "/v1/blocks/");
-		const std::string queryString = HTTPUtil::GetQueryString(conn);
 
 		IBlockChain::Ptr pBlockChain = ((NodeContext*)pNodeContext)->m_pBlockChain;
-		if (queryString == "compact")
+		if (HTTPUtil::HasQueryParam(conn, "compact"))
 		{
 			std::unique_ptr<FullBlock> pBlock = GetBlock(requestedBlock, pBlockChain);
 			if (pBlock != nullptr)
@@ -33,7 +37,9 @@ int BlockAPI::GetBlock_Handler(struct mg_connection* conn, void* pNodeContext)
 					pBlockChain->GetCompactBlockByHash(pBlock->GetHash());
 				if (pCompactBlock != nullptr)
 				{
-					return HTTPUtil::BuildSuccessResponse(conn, pCompactBlock->ToJSON().toStyledString());
+					pWriter = JsonStreamWriter::Create(conn);
+					pWriter->Value(pCompactBlock->ToJSON());
+					return pWriter->Finish();
 				}
 			}
 		}
@@ -42,13 +48,49 @@ int BlockAPI::GetBlock_Handler(struct mg_connection* conn, void* pNodeContext)
 			std::unique_ptr<FullBlock> pFullBlock = GetBlock(requestedBlock, pBlockChain);
 			if (pFullBlock != nullptr)
 			{
-				return HTTPUtil::BuildSuccessResponse(conn, pFullBlock->ToJSON().toStyledString());
+				// Same as FullBlock::ToJSON, but written one input, output, or kernel at a time.
+				pWriter = JsonStreamWriter::Create(conn);
+				pWriter->BeginObject();
+				pWriter->Member("header", pFullBlock->GetHeader()->ToJSON());
+
+				pWriter->Key("inputs");
+				pWriter->BeginArray();
+				for (const TransactionInput& input : pFullBlock->GetInputs())
+				{
+					pWriter->Value(input.ToJSON());
+				}
+				pWriter->EndArray();
+
+				pWriter->Key("outputs");
+				pWriter->BeginArray();
+				for (const TransactionOutput& output : pFullBlock->GetOutputs())
+				{
+					Json::Value outputJSON = output.ToJSON();
+					outputJSON["block_height"] = pFullBlock->GetHeight();
+					pWriter->Value(outputJSON);
+				}
+				pWriter->EndArray();
+
+				pWriter->Key("kernels");
+				pWriter->BeginArray();
+				for (const TransactionKernel& kernel : pFullBlock->GetKernels())
+				{
+					pWriter->Value(kernel.ToJSON());
+				}
+				pWriter->EndArray();
+
+				pWriter->EndObject();
+				return pWriter->Finish();
 			}
 		}
 	}
 	catch (std::exception& e)
 	{
 		LOG_ERROR_F("Exception thrown: {}", e.what());
+		if (pWriter != nullptr && pWriter->HasStarted())
+		{
+			return 500;
+		}
 	}
 
 	return HTTPUtil::BuildBadRequestResponse(conn, "BLOCK NOT FOUND");
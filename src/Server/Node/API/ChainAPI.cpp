@@ -2,28 +2,36 @@
 #include "../NodeContext.h"
 
 #include <Net/Util/HTTPUtil.h>
+#include <Net/Util/JsonStreamWriter.h>
 #include <Common/Util/StringUtil.h>
 #include <Crypto/Crypto.h>
 #include <json/json.h>
 #include <BlockChain/BlockChain.h>
 #include <Database/BlockDb.h>
+#include <Wallet/NodeClient.h>
+#include <algorithm>
 
 int ChainAPI::GetChain_Handler(struct mg_connection* conn, void* pNodeContext)
 {
-	IBlockChain::Ptr pBlockChain = ((NodeContext*)pNodeContext)->m_pBlockChain;
+	NodeContext* pServer = (NodeContext*)pNodeContext;
 
 	try
 	{
-		auto pTip = pBlockChain->GetTipBlockHeader(EChainType::CONFIRMED);
+		ChainSnapshot::CPtr pSnapshot = pServer->m_pBlockChain->GetSnapshot();
+		const BlockHeaderPtr& pTip = pSnapshot->GetTip(EChainType::CONFIRMED);
 		if (pTip != nullptr)
 		{
-			Json::Value chainNode;
-			chainNode["height"] = pTip->GetHeight();
-			chainNode["last_block_pushed"] = pTip->GetHash().ToHex();
-			chainNode["prev_block_to_last"] = pTip->GetPreviousHash().ToHex();
-			chainNode["total_difficulty"] = pTip->GetTotalDifficulty();
+			const ResponseCache::Version version{ pSnapshot->GetGeneration(), 0, 0 };
+			auto pBody = pServer->m_pResponseCache->Get("chain", version, [&pTip]() {
+				Json::Value chainNode;
+				chainNode["height"] = pTip->GetHeight();
+				chainNode["last_block_pushed"] = pTip->GetHash().ToHex();
+				chainNode["prev_block_to_last"] = pTip->GetPreviousHash().ToHex();
+				chainNode["total_difficulty"] = pTip->GetTotalDifficulty();
+				return chainNode.toStyledString();
+			});
 
-			return HTTPUtil::BuildSuccessResponse(conn, chainNode.toStyledString());
+			return HTTPUtil::BuildSuccessResponse(conn, *pBody);
 		}
 	}
 	catch (std::exception& e)
@@ -38,6 +46,7 @@ int ChainAPI::GetChainOutputsByHeight_Handler(struct mg_connection* conn, void*
 {
 	NodeContext* pServer = (NodeContext*)pNodeContext;
 
+	std::unique_ptr<JsonStreamWriter> pWriter = nullptr;
 	try
 	{
 		uint64_t startHeight = 0;
@@ -76,9 +85,10 @@ int ChainAPI::GetChainOutputsByHeight_Handler(struct mg_connection* conn, void*
 			endHeight = startHeight;
 		}
 
-		Json::Value json;
-
 		std::vector<BlockWithOutputs> blocksWithOutputs = pServer->m_pBlockChain->GetOutputsByHeight(startHeight, endHeight);
+
+		pWriter = JsonStreamWriter::Create(conn);
+		pWriter->BeginArray();
 		for (const BlockWithOutputs& block : blocksWithOutputs)
 		{
 			/*
@@ -101,25 +111,31 @@ int ChainAPI::GetChainOutputsByHeight_Handler(struct mg_connection* conn, void*
 			  }
 			]
 			*/
-			Json::Value blockJSON;
-			blockJSON["header"] = block.GetBlockIdentifier().ToJSON();
+			pWriter->BeginObject();
+			pWriter->Member("header", block.GetBlockIdentifier().ToJSON());
 
-			Json::Value outputsJSON;
+			pWriter->Key("outputs");
+			pWriter->BeginArray();
 			for (const OutputDTO& output : block.GetOutputs())
 			{
-				outputsJSON.append(output.ToJSON());
+				pWriter->Value(output.ToJSON());
 			}
 
-			blockJSON["outputs"] = outputsJSON;
-
-			json.append(blockJSON);
+			pWriter->EndArray();
+			pWriter->EndObject();
 		}
 
-		return HTTPUtil::BuildSuccessResponse(conn, json.toStyledString());
+		pWriter->EndArray();
+		return pWriter->Finish();
 	}
 	catch (std::exception& e)
 	{
 		LOG_ERROR_F("Excpetion thrown: {}", e.what());
+		if (pWriter != nullptr && pWriter->HasStarted())
+		{
+			return 500;
+		}
+
 		return HTTPUtil::BuildBadRequestResponse(conn, "Expected /v1/chain/outputs/byheight?start_height=1&end_height=100");
 	}
 }
@@ -127,7 +143,12 @@ int ChainAPI::GetChainOutputsByHeight_Handler(struct mg_connection* conn, void*
 int ChainAPI::GetChainOutputsByIds_Handler(struct mg_connection* conn, void* pNodeContext)
 {
 	NodeContext* pServer = (NodeContext*)pNodeContext;
+	if (HTTPUtil::GetHTTPMethod(conn) == HTTP::EHTTPMethod::POST)
+	{
+		return GetChainOutputsByIdsBinary(conn, pNodeContext);
+	}
 
+	std::unique_ptr<JsonStreamWriter> pWriter = nullptr;
 	try
 	{
 		std::vector<std::string> ids;
@@ -151,29 +172,138 @@ int ChainAPI::GetChainOutputsByIds_Handler(struct mg_connection* conn, void* pNo
 			}
 		}
 
-		std::shared_ptr<Locked<IBlockDB>> pBlockDB = pServer->m_pDatabase->GetBlockDB();
+		if (ids.size() > MAX_OUTPUTS_BY_COMMITMENT)
+		{
+			return HTTPUtil::BuildBadRequestResponse(conn, StringUtil::Format("At most {} ids may be requested at once", MAX_OUTPUTS_BY_COMMITMENT));
+		}
 
-		Json::Value rootNode;
+		std::vector<Commitment> commitments;
+		commitments.reserve(ids.size());
 		for (const std::string& id : ids)
 		{
-			Commitment commitment = Commitment::FromHex(id);
-			std::unique_ptr<OutputLocation> pOutputPosition = pBlockDB->Read()->GetOutputPosition(commitment);
+			commitments.push_back(Commitment::FromHex(id));
+		}
+
+		const std::vector<std::unique_ptr<OutputLocation>> positions = pServer->m_pDatabase->GetBlockDB()->Read()->GetOutputPositions(commitments);
+
+		pWriter = JsonStreamWriter::Create(conn);
+		pWriter->BeginArray();
+		for (size_t i = 0; i < commitments.size(); i++)
+		{
+			const std::unique_ptr<OutputLocation>& pOutputPosition = positions[i];
 			if (pOutputPosition != nullptr)
 			{
 				Json::Value outputNode;
-				outputNode["commit"] = commitment.Format();
+				outputNode["commit"] = commitments[i].Format();
 				outputNode["height"] = pOutputPosition->GetBlockHeight();
 				outputNode["mmr_index"] = pOutputPosition->GetMMRIndex() + 1;
 
-				rootNode.append(outputNode);
+				pWriter->Value(outputNode);
 			}
 		}
 
-		return HTTPUtil::BuildSuccessResponse(conn, rootNode.toStyledString());
+		pWriter->EndArray();
+		return pWriter->Finish();
 	}
 	catch (std::exception& e)
 	{
 		LOG_ERROR_F("Exception thrown: {}", e.what());
+		if (pWriter != nullptr && pWriter->HasStarted())
+		{
+			return 500;
+		}
+
 		return HTTPUtil::BuildBadRequestResponse(conn, "Expected /v1/txhashset/outputs?start_index=1&max=100");
 	}
-}
\ No newline at end of file
+}
+
+//
+// POST /v1/chain/outputs/byids
+//
+// Binary variant used by Grin++ wallets. The request body is a u64 count followed by that many commitments,
+// and the response is a u64 count followed by the commitment and OutputLocation of each one found.
+// At most MAX_OUTPUTS_BY_COMMITMENT commitments are accepted, and they're looked up with a single batched read.
+//
+int ChainAPI::GetChainOutputsByIdsBinary(struct mg_connection* conn, void* pNodeContext)
+{
+	NodeContext* pServer = (NodeContext*)pNodeContext;
+
+	try
+	{
+		ByteBuffer byteBuffer(HTTPUtil::GetRequestBytes(conn));
+		const uint64_t numCommitments = byteBuffer.ReadU64();
+		if (numCommitments > MAX_OUTPUTS_BY_COMMITMENT)
+		{
+			return HTTPUtil::BuildBadRequestResponse(conn, StringUtil::Format("At most {} commitments may be requested at once", MAX_OUTPUTS_BY_COMMITMENT));
+		}
+
+		std::vector<Commitment> commitments;
+		commitments.reserve((std::min)(numCommitments, (uint64_t)byteBuffer.GetRemainingSize()));
+		for (uint64_t i = 0; i < numCommitments; i++)
+		{
+			commitments.push_back(Commitment::Deserialize(byteBuffer));
+		}
+
+		const std::vector<std::unique_ptr<OutputLocation>> positions = pServer->m_pDatabase->GetBlockDB()->Read()->GetOutputPositions(commitments);
+		const size_t numFound = std::count_if(positions.cbegin(), positions.cend(), [](const auto& pPosition) { return pPosition != nullptr; });
+
+		Serializer serializer;
+		serializer.Append<uint64_t>(numFound);
+		for (size_t i = 0; i < commitments.size(); i++)
+		{
+			if (positions[i] != nullptr)
+			{
+				commitments[i].Serialize(serializer);
+				positions[i]->Serialize(serializer);
+			}
+		}
+
+		return HTTPUtil::BuildSuccessResponseBinary(conn, serializer.GetBytes());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+		return HTTPUtil::BuildBadRequestResponse(conn, "Expected a u64 count followed by that many commitments");
+	}
+}
+
+int ChainAPI::GetChainLockProfile_Handler(struct mg_connection* conn, void* pNodeContext)
+{
+	IBlockChain::Ptr pBlockChain = ((NodeContext*)pNodeContext)->m_pBlockChain;
+
+	try
+	{
+		Json::Value sitesNode(Json::arrayValue);
+		for (const LockSiteStats& site : pBlockChain->GetChainLockProfile())
+		{
+			Json::Value siteNode;
+			siteNode["call_site"] = site.callSite;
+			siteNode["num_reads"] = Json::UInt64(site.numReads);
+			siteNode["num_writes"] = Json::UInt64(site.numWrites);
+			siteNode["total_wait_micros"] = Json::UInt64(site.totalWaitMicros);
+			siteNode["max_wait_micros"] = Json::UInt64(site.maxWaitMicros);
+			siteNode["total_hold_micros"] = Json::UInt64(site.totalHoldMicros);
+			siteNode["max_hold_micros"] = Json::UInt64(site.maxHoldMicros);
+			siteNode["total_waiters_ahead"] = Json::UInt64(site.totalWaitersAhead);
+			siteNode["max_waiters_ahead"] = Json::UInt64(site.maxWaitersAhead);
+
+			// Bucket i counts holds shorter than 2^i microseconds (and at least 2^(i-1)).
+			Json::Value holdHistogramNode(Json::arrayValue);
+			for (const uint64_t count : site.holdBuckets)
+			{
+				holdHistogramNode.append(Json::UInt64(count));
+			}
+			siteNode["hold_histogram"] = holdHistogramNode;
+
+			sitesNode.append(siteNode);
+		}
+
+		return HTTPUtil::BuildSuccessResponse(conn, sitesNode.toStyledString());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+	}
+
+	return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to build lock profile.");
+}
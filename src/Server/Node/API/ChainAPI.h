@@ -9,4 +9,8 @@ public:
 	static int GetChain_Handler(struct mg_connection* conn, void* pNodeContext);
 	static int GetChainOutputsByHeight_Handler(struct mg_connection* conn, void* pNodeContext);
 	static int GetChainOutputsByIds_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int GetChainLockProfile_Handler(struct mg_connection* conn, void* pNodeContext);
+
+private:
+	static int GetChainOutputsByIdsBinary(struct mg_connection* conn, void* pNodeContext);
 };
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "../NodeContext.h"
 
 #include <Net/Util/HTTPUtil.h>
+#include <Net/Util/JsonStreamWriter.h>
+#include <P2P/P2PServer.h>
 #include <BlockChain/BlockChain.h>
 #include <Common/Logger.h>
 #include <Common/Util/StringUtil.h>
@@ -37,6 +39,86 @@ int HeaderAPI::GetHeader_Handler(struct mg_connection* conn, void* pNodeContext)
 	return HTTPUtil::BuildBadRequestResponse(conn, response);
 }
 
+//
+// Handles requests to retrieve a range of candidate chain headers, for light clients and explorers indexing the chain.
+// The headers come from the P2P server's cache of serialized headers, and at most IP2PServer::MAX_HEADERS_PER_REQUEST are returned.
+// Clients that accept binary get a u64 count followed by the consensus-serialized headers.
+//
+// APIs:
+// GET /v1/headers?start_height=1&max=100
+//
+int HeaderAPI::GetHeaders_Handler(struct mg_connection* conn, void* pNodeContext)
+{
+	NodeContext* pServer = (NodeContext*)pNodeContext;
+
+	std::unique_ptr<JsonStreamWriter> pWriter = nullptr;
+	try
+	{
+		uint64_t startHeight = 0;
+		uint64_t max = 100;
+		const std::string queryString = HTTPUtil::GetQueryString(conn);
+		if (!queryString.empty())
+		{
+			std::vector<std::string> tokens = StringUtil::Split(queryString, "&");
+			for (const std::string& token : tokens)
+			{
+				std::vector<std::string> keyValue = StringUtil::Split(token, "=");
+				if (StringUtil::StartsWith(token, "start_height="))
+				{
+					if (keyValue.size() != 2)
+					{
+						return HTTPUtil::BuildBadRequestResponse(conn, "Expected /v1/headers?start_height=1&max=100");
+					}
+
+					startHeight = std::stoull(keyValue[1]);
+				}
+				else if (StringUtil::StartsWith(token, "max="))
+				{
+					if (keyValue.size() != 2)
+					{
+						return HTTPUtil::BuildBadRequestResponse(conn, "Expected /v1/headers?start_height=1&max=100");
+					}
+
+					max = std::stoull(keyValue[1]);
+				}
+			}
+		}
+
+		uint64_t numHeaders = 0;
+		const std::vector<uint8_t> serializedHeaders = pServer->m_pP2PServer->GetSerializedHeaders(startHeight, max, numHeaders);
+
+		if (HTTPUtil::AcceptsBinary(conn))
+		{
+			Serializer serializer;
+			serializer.Append<uint64_t>(numHeaders);
+			serializer.AppendByteVector(serializedHeaders);
+			return HTTPUtil::BuildSuccessResponseBinary(conn, serializer.GetBytes());
+		}
+
+		ByteBuffer byteBuffer(serializedHeaders);
+
+		pWriter = JsonStreamWriter::Create(conn);
+		pWriter->BeginArray();
+		for (uint64_t i = 0; i < numHeaders; i++)
+		{
+			pWriter->Value(BlockHeader::Deserialize(byteBuffer).ToJSON());
+		}
+
+		pWriter->EndArray();
+		return pWriter->Finish();
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+		if (pWriter != nullptr && pWriter->HasStarted())
+		{
+			return 500;
+		}
+	}
+
+	return HTTPUtil::BuildBadRequestResponse(conn, "Expected /v1/headers?start_height=1&max=100");
+}
+
 BlockHeaderPtr HeaderAPI::GetHeader(const std::string& requestedHeader, const IBlockChain::Ptr& pBlockChain)
 {
 	if (requestedHeader.length() == 64 && HexUtil::IsValidHex(requestedHeader))
@@ -10,6 +10,7 @@ class HeaderAPI
 {
 public:
 	static int GetHeader_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int GetHeaders_Handler(struct mg_connection* conn, void* pNodeContext);
 
 private:
 	static BlockHeaderPtr GetHeader(const std::string& requestedHeader, const IBlockChain::Ptr& pBlockChain);
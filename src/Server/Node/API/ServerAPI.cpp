@@ -3,6 +3,14 @@
 
 #include <Net/Util/HTTPUtil.h>
 #include <P2P/Common.h>
+#include <Common/AllocProfiler.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <Common/Logger.h>
+#include <Common/MemoryBudget.h>
+#include <Common/TaskScheduler.h>
+#include <Common/Tracer.h>
+#include <Database/BlockDb.h>
 #include <json/json.h>
 
 /*
@@ -30,9 +38,19 @@ int ServerAPI::V1_Handler(struct mg_connection* conn, void*)
 		json.append("GET /v1/blocks/<hash>?compact");
 		json.append("GET /v1/blocks/<height>?compact");
 		json.append("GET /v1/blocks/<output commit>?compact");
+		json.append("GET /v1/headers/<hash>");
+		json.append("GET /v1/headers/<height>");
+		json.append("GET /v1/headers/<output commit>");
+		json.append("GET /v1/headers?start_height=1&max=100");
 		json.append("GET /v1/chain/");
 		json.append("GET /v1/chain/outputs/byids?id=xxx,yyy&id=zzz");
 		json.append("GET /v1/chain/outputs/byheight?start_height=100&end_height=200");
+		json.append("GET /v1/stats/db");
+		json.append("GET /v1/stats/allocations");
+		json.append("GET /v1/trace");
+		json.append("POST /v1/trace?enable");
+		json.append("POST /v1/trace?disable");
+		json.append("POST /v1/trace?dump");
 		json.append("GET /v1/peers/all");
 		json.append("GET /v1/peers/connected");
 		json.append("GET /v1/peers/a.b.c.d");
@@ -43,6 +61,8 @@ int ServerAPI::V1_Handler(struct mg_connection* conn, void*)
 		json.append("GET /v1/txhashset/lastoutputs?n=###");
 		json.append("GET /v1/txhashset/lastrangeproofs?n=###");
 		json.append("GET /v1/txhashset/outputs?start_index=1&max=100");
+		json.append("POST /v1/txhashset/snapshot?height=###");
+		json.append("GET /metrics");
 
 		return HTTPUtil::BuildSuccessResponse(conn, json.toStyledString());
 	}
@@ -56,49 +76,108 @@ int ServerAPI::GetStatus_Handler(struct mg_connection* conn, void* pNodeContext)
 {
 	NodeContext* pServer = (NodeContext*)pNodeContext;
 	
-	auto pTip = pServer->m_pBlockChain->GetTipBlockHeader(EChainType::CONFIRMED);
+	// Tip and header height come from the same snapshot, so they're consistent with each other.
+	ChainSnapshot::CPtr pSnapshot = pServer->m_pBlockChain->GetSnapshot();
+	const BlockHeaderPtr& pTip = pSnapshot->GetTip(EChainType::CONFIRMED);
 	if (pTip == nullptr)
 	{
 		return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to find tip.");
 	}
 
-	Json::Value statusNode;
-	statusNode["protocol_version"] = P2P::PROTOCOL_VERSION;
-	statusNode["user_agent"] = P2P::USER_AGENT;
+	// Peers, sync progress, and thread pool stats change constantly, so the status is also re-rendered once it's a second old.
+	const ResponseCache::Version version{ pSnapshot->GetGeneration(), pSnapshot->GetHeight(EChainType::CANDIDATE), pServer->m_pTransactionPool->GetEventSequence() };
+	auto pBody = pServer->m_pResponseCache->Get("status", version, [pServer, &pSnapshot, &pTip]() {
+		Json::Value statusNode;
+		statusNode["protocol_version"] = P2P::PROTOCOL_VERSION;
+		statusNode["user_agent"] = P2P::USER_AGENT;
 
-	SyncStatusConstPtr pSyncStatus = pServer->m_pP2PServer->GetSyncStatus();
-	statusNode["sync_status"] = GetStatusString(*pSyncStatus);
+		SyncStatusConstPtr pSyncStatus = pServer->m_pP2PServer->GetSyncStatus();
+		statusNode["sync_status"] = GetStatusString(pSyncStatus->GetStatus());
 
-	Json::Value stateNode;
-	stateNode["downloaded"] = pSyncStatus->GetDownloaded();
-	stateNode["download_size"] = pSyncStatus->GetDownloadSize();
-	stateNode["processing_status"] = pSyncStatus->GetProcessingStatus();
-	statusNode["state"] = stateNode;
+		Json::Value stateNode;
+		stateNode["downloaded"] = pSyncStatus->GetDownloaded();
+		stateNode["download_size"] = pSyncStatus->GetDownloadSize();
+		stateNode["processing_status"] = pSyncStatus->GetProcessingStatus();
+		statusNode["state"] = stateNode;
+		statusNode["sync_telemetry"] = ToJSON(*pSyncStatus->GetTelemetry());
 
-	Json::Value networkNode;
-	networkNode["height"] = pSyncStatus->GetNetworkHeight();
-	networkNode["total_difficulty"] = pSyncStatus->GetNetworkDifficulty();
-	const std::pair<size_t, size_t> numConnections = pServer->m_pP2PServer->GetNumberOfConnectedPeers();
-	networkNode["num_inbound"] = Json::UInt64(numConnections.first);
-	networkNode["num_outbound"] = Json::UInt64(numConnections.second);
-	statusNode["network"] = networkNode;
+		Json::Value networkNode;
+		networkNode["height"] = pSyncStatus->GetNetworkHeight();
+		networkNode["total_difficulty"] = pSyncStatus->GetNetworkDifficulty();
+		const std::pair<size_t, size_t> numConnections = pServer->m_pP2PServer->GetNumberOfConnectedPeers();
+		networkNode["num_inbound"] = Json::UInt64(numConnections.first);
+		networkNode["num_outbound"] = Json::UInt64(numConnections.second);
+		statusNode["network"] = networkNode;
 
-	Json::Value tipNode;
-	tipNode["height"] = pTip->GetHeight();
-	tipNode["hash"] = pTip->GetHash().ToHex();
-	tipNode["previous_hash"] = pTip->GetPreviousHash().ToHex();
-	tipNode["total_difficulty"] = pTip->GetTotalDifficulty();
-	statusNode["chain"] = tipNode;
+		Json::Value tipNode;
+		tipNode["height"] = pTip->GetHeight();
+		tipNode["hash"] = pTip->GetHash().ToHex();
+		tipNode["previous_hash"] = pTip->GetPreviousHash().ToHex();
+		tipNode["total_difficulty"] = pTip->GetTotalDifficulty();
+		statusNode["chain"] = tipNode;
 
-	const uint64_t headerHeight = pServer->m_pBlockChain->GetHeight(EChainType::CANDIDATE);
-	statusNode["header_height"] = headerHeight;
+		const uint64_t headerHeight = pSnapshot->GetHeight(EChainType::CANDIDATE);
+		statusNode["header_height"] = headerHeight;
 
-	return HTTPUtil::BuildSuccessResponse(conn, statusNode.toStyledString());
+		Json::Value threadPoolsNode(Json::arrayValue);
+		for (const ThreadPoolStats& stats : ThreadManagerAPI::GetThreadPoolStats())
+		{
+			Json::Value poolNode;
+			poolNode["name"] = stats.name;
+			poolNode["num_threads"] = Json::UInt64(stats.numThreads);
+			poolNode["queue_depth"] = Json::UInt64(stats.queueDepth);
+			poolNode["tasks_completed"] = Json::UInt64(stats.tasksCompleted);
+			poolNode["busy_micros"] = Json::UInt64(stats.busyMicros);
+			threadPoolsNode.append(poolNode);
+		}
+		statusNode["thread_pools"] = threadPoolsNode;
+
+		const TxPoolStats txPoolStats = pServer->m_pTransactionPool->GetStats();
+		Json::Value txPoolNode;
+		txPoolNode["mempool"] = ToJSON(txPoolStats.memPool);
+		txPoolNode["stempool"] = ToJSON(txPoolStats.stemPool);
+		statusNode["tx_pool"] = txPoolNode;
+
+		return statusNode.toStyledString();
+	}, std::chrono::milliseconds(1000));
+
+	return HTTPUtil::BuildSuccessResponse(conn, *pBody);
 }
 
-std::string ServerAPI::GetStatusString(const SyncStatus& syncStatus)
+Json::Value ServerAPI::ToJSON(const PoolStats& stats)
+{
+	Json::Value poolNode;
+	poolNode["num_transactions"] = Json::UInt64(stats.numTransactions);
+	poolNode["memory_usage"] = Json::UInt64(stats.memoryUsage);
+	poolNode["max_bytes"] = Json::UInt64(stats.maxBytes);
+	poolNode["num_evicted"] = Json::UInt64(stats.numEvicted);
+	return poolNode;
+}
+
+Json::Value ServerAPI::ToJSON(const SyncTelemetry& telemetry)
+{
+	Json::Value telemetryNode;
+	telemetryNode["headers_per_sec"] = telemetry.headersPerSec;
+	telemetryNode["blocks_per_sec"] = telemetry.blocksPerSec;
+	telemetryNode["bytes_downloaded_per_sec"] = telemetry.bytesDownloadedPerSec;
+	telemetryNode["rangeproofs_per_sec"] = telemetry.rangeProofsPerSec;
+	telemetryNode["kernels_per_sec"] = telemetry.kernelsPerSec;
+	telemetryNode["eta_secs"] = telemetry.etaSecs.has_value() ? Json::Value(Json::UInt64(telemetry.etaSecs.value())) : Json::Value(Json::nullValue);
+
+	// Statuses reported under the same name (eg. a failed TxHashSet download) are added together.
+	Json::Value timeNode(Json::objectValue);
+	for (const auto& iter : telemetry.timeInStatus)
+	{
+		const std::string status = GetStatusString(iter.first);
+		timeNode[status] = Json::UInt64(timeNode.get(status, 0).asUInt64() + iter.second.count());
+	}
+	telemetryNode["time_in_status_ms"] = timeNode;
+
+	return telemetryNode;
+}
+
+std::string ServerAPI::GetStatusString(const ESyncStatus status)
 {
-	const ESyncStatus status = syncStatus.GetStatus();
 	switch (status)
 	{
 		case ESyncStatus::SYNCING_HEADERS:
@@ -139,4 +218,428 @@ int ServerAPI::ResyncChain_Handler(struct mg_connection* conn, void* pNodeContex
 	pServer->m_pP2PServer->UnbanAllPeers();
 
 	return HTTPUtil::BuildSuccessResponse(conn, "");
-}
\ No newline at end of file
+}
+
+int ServerAPI::GetDBStats_Handler(struct mg_connection* conn, void* pNodeContext)
+{
+	NodeContext* pServer = (NodeContext*)pNodeContext;
+
+	try
+	{
+		const DBStats stats = pServer->m_pDatabase->GetBlockDB()->ScopedRead()->GetStats();
+
+		Json::Value tablesNode(Json::arrayValue);
+		for (const DBTableStats& table : stats.tables)
+		{
+			Json::Value tableNode;
+			tableNode["name"] = table.name;
+			tableNode["num_reads"] = Json::UInt64(table.numReads);
+			tableNode["num_writes"] = Json::UInt64(table.numWrites);
+			tableNode["estimated_keys"] = Json::UInt64(table.estimatedKeys);
+			tableNode["sst_bytes"] = Json::UInt64(table.sstBytes);
+			tableNode["memtable_bytes"] = Json::UInt64(table.memtableBytes);
+			tablesNode.append(tableNode);
+		}
+
+		const uint64_t blockCacheLookups = stats.blockCacheHits + stats.blockCacheMisses;
+		Json::Value blockCacheNode;
+		blockCacheNode["hits"] = Json::UInt64(stats.blockCacheHits);
+		blockCacheNode["misses"] = Json::UInt64(stats.blockCacheMisses);
+		blockCacheNode["hit_ratio"] = blockCacheLookups > 0 ? (double)stats.blockCacheHits / blockCacheLookups : 0.0;
+		blockCacheNode["usage_bytes"] = Json::UInt64(stats.blockCacheUsage);
+
+		const uint64_t headerCacheLookups = stats.headerCacheHits + stats.headerCacheMisses;
+		Json::Value headerCacheNode;
+		headerCacheNode["hits"] = Json::UInt64(stats.headerCacheHits);
+		headerCacheNode["misses"] = Json::UInt64(stats.headerCacheMisses);
+		headerCacheNode["hit_ratio"] = headerCacheLookups > 0 ? (double)stats.headerCacheHits / headerCacheLookups : 0.0;
+		headerCacheNode["size"] = Json::UInt64(stats.headerCacheSize);
+		headerCacheNode["capacity"] = Json::UInt64(stats.headerCacheCapacity);
+
+		Json::Value statsNode;
+		statsNode["tables"] = tablesNode;
+		statsNode["block_cache"] = blockCacheNode;
+		statsNode["header_cache"] = headerCacheNode;
+		statsNode["stall_micros"] = Json::UInt64(stats.stallMicros);
+		statsNode["pending_compaction_bytes"] = Json::UInt64(stats.pendingCompactionBytes);
+
+		return HTTPUtil::BuildSuccessResponse(conn, statsNode.toStyledString());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+	}
+
+	return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to retrieve database stats.");
+}
+
+//
+// Exports the registered metrics (P2P traffic, block latency, orphans), along with gauges and counters
+// sampled from the node's existing stats, in the Prometheus text format.
+//
+int ServerAPI::GetMetrics_Handler(struct mg_connection* conn, void* pNodeContext)
+{
+	NodeContext* pServer = (NodeContext*)pNodeContext;
+
+	try
+	{
+		MetricsWriter writer;
+		MetricsAPI::Write(writer);
+
+		ChainSnapshot::CPtr pSnapshot = pServer->m_pBlockChain->GetSnapshot();
+		writer.AddGauge("grin_chain_height", "Height of the confirmed chain tip.", "", (double)pSnapshot->GetHeight(EChainType::CONFIRMED));
+		writer.AddGauge("grin_header_height", "Height of the most-work header chain.", "", (double)pSnapshot->GetHeight(EChainType::CANDIDATE));
+
+		SyncStatusConstPtr pSyncStatus = pServer->m_pP2PServer->GetSyncStatus();
+		writer.AddGauge("grin_network_height", "Highest height reported by connected peers.", "", (double)pSyncStatus->GetNetworkHeight());
+
+		const std::pair<size_t, size_t> numConnections = pServer->m_pP2PServer->GetNumberOfConnectedPeers();
+		writer.AddGauge("grin_peers_connected", "Number of connected peers.", MetricsWriter::Label("direction", "inbound"), (double)numConnections.first);
+		writer.AddGauge("grin_peers_connected", "Number of connected peers.", MetricsWriter::Label("direction", "outbound"), (double)numConnections.second);
+
+		const BlockProcessingStats processingStats = pServer->m_pBlockChain->GetProcessingStats();
+		writer.AddCounter("grin_blocks_processed_total", "Number of blocks validated and applied.", "", processingStats.numBlocks);
+		const std::string phaseHelp = "Time spent processing blocks, by phase.";
+		writer.AddCounter("grin_block_phase_micros_total", phaseHelp, MetricsWriter::Label("phase", "validate"), (uint64_t)processingStats.validateTime.count());
+		writer.AddCounter("grin_block_phase_micros_total", phaseHelp, MetricsWriter::Label("phase", "apply"), (uint64_t)processingStats.applyTime.count());
+		writer.AddCounter("grin_block_phase_micros_total", phaseHelp, MetricsWriter::Label("phase", "commit"), (uint64_t)processingStats.commitTime.count());
+
+		WritePoolMetrics(writer, pServer->m_pTransactionPool->GetStats());
+		WriteMemoryMetrics(writer);
+
+		// Each family is written in its own loop, since a family's samples have to be contiguous.
+		const std::vector<ThreadPoolStats> threadPools = ThreadManagerAPI::GetThreadPoolStats();
+		for (const ThreadPoolStats& stats : threadPools)
+		{
+			writer.AddGauge("grin_thread_pool_queue_depth", "Tasks waiting to run, by thread pool.", MetricsWriter::Label("pool", stats.name), (double)stats.queueDepth);
+		}
+		for (const ThreadPoolStats& stats : threadPools)
+		{
+			writer.AddGauge("grin_thread_pool_threads", "Worker threads, by thread pool.", MetricsWriter::Label("pool", stats.name), (double)stats.numThreads);
+		}
+		for (const ThreadPoolStats& stats : threadPools)
+		{
+			writer.AddCounter("grin_thread_pool_tasks_completed_total", "Tasks completed, by thread pool.", MetricsWriter::Label("pool", stats.name), stats.tasksCompleted);
+		}
+		for (const ThreadPoolStats& stats : threadPools)
+		{
+			writer.AddCounter("grin_thread_pool_busy_micros_total", "Time spent running tasks, by thread pool.", MetricsWriter::Label("pool", stats.name), stats.busyMicros);
+		}
+
+		const std::vector<ThreadGroupStats> threadGroups = ThreadManagerAPI::GetThreadGroupStats();
+		for (const ThreadGroupStats& group : threadGroups)
+		{
+			writer.AddCounter("grin_thread_cpu_micros_total", "CPU time, by thread name.", MetricsWriter::Label("thread", group.name), group.cpuMicros);
+		}
+		for (const ThreadGroupStats& group : threadGroups)
+		{
+			writer.AddCounter("grin_thread_wait_micros_total", "Time spent sleeping or waiting for work, by thread name.", MetricsWriter::Label("thread", group.name), group.waitMicros);
+		}
+
+		const std::vector<ScheduledTaskStats> scheduledTasks = TaskScheduler::GetAllStats();
+		for (const ScheduledTaskStats& task : scheduledTasks)
+		{
+			writer.AddCounter("grin_scheduled_task_runs_total", "Runs completed, by periodic task.", MetricsWriter::Label("task", task.name), task.runs);
+		}
+		for (const ScheduledTaskStats& task : scheduledTasks)
+		{
+			writer.AddCounter("grin_scheduled_task_overruns_total", "Runs skipped because the previous run hadn't finished, by periodic task.", MetricsWriter::Label("task", task.name), task.overruns);
+		}
+		for (const ScheduledTaskStats& task : scheduledTasks)
+		{
+			writer.AddCounter("grin_scheduled_task_run_micros_total", "Time spent running, by periodic task.", MetricsWriter::Label("task", task.name), task.totalRunMicros);
+		}
+		for (const ScheduledTaskStats& task : scheduledTasks)
+		{
+			writer.AddGauge("grin_scheduled_task_max_run_micros", "Longest run, by periodic task.", MetricsWriter::Label("task", task.name), (double)task.maxRunMicros);
+		}
+		for (const ScheduledTaskStats& task : scheduledTasks)
+		{
+			writer.AddCounter("grin_scheduled_task_lag_micros_total", "Time between runs coming due and starting, by periodic task.", MetricsWriter::Label("task", task.name), task.totalLagMicros);
+		}
+		for (const ScheduledTaskStats& task : scheduledTasks)
+		{
+			writer.AddGauge("grin_scheduled_task_max_lag_micros", "Longest time between a run coming due and starting, by periodic task.", MetricsWriter::Label("task", task.name), (double)task.maxLagMicros);
+		}
+
+		// Only populated while chain lock profiling is enabled.
+		const std::vector<LockSiteStats> lockSites = pServer->m_pBlockChain->GetChainLockProfile();
+		for (const LockSiteStats& site : lockSites)
+		{
+			writer.AddCounter("grin_chain_lock_wait_micros_total", "Time spent waiting for the chain lock, by call site.", MetricsWriter::Label("site", site.callSite), site.totalWaitMicros);
+		}
+		for (const LockSiteStats& site : lockSites)
+		{
+			writer.AddGauge("grin_chain_lock_max_wait_micros", "Longest wait for the chain lock, by call site.", MetricsWriter::Label("site", site.callSite), (double)site.maxWaitMicros);
+		}
+		for (const LockSiteStats& site : lockSites)
+		{
+			writer.AddCounter("grin_chain_lock_hold_micros_total", "Time spent holding the chain lock, by call site.", MetricsWriter::Label("site", site.callSite), site.totalHoldMicros);
+		}
+		for (const LockSiteStats& site : lockSites)
+		{
+			writer.AddCounter("grin_chain_lock_acquisitions_total", "Chain lock acquisitions, by call site.", MetricsWriter::Label("site", site.callSite), site.numReads + site.numWrites);
+		}
+
+		const DBStats dbStats = pServer->m_pDatabase->GetBlockDB()->ScopedRead()->GetStats();
+		for (const DBTableStats& table : dbStats.tables)
+		{
+			writer.AddCounter("grin_db_reads_total", "Database reads, by table.", MetricsWriter::Label("table", table.name), table.numReads);
+		}
+		for (const DBTableStats& table : dbStats.tables)
+		{
+			writer.AddCounter("grin_db_writes_total", "Database writes, by table.", MetricsWriter::Label("table", table.name), table.numWrites);
+		}
+		for (const DBTableStats& table : dbStats.tables)
+		{
+			writer.AddGauge("grin_db_sst_bytes", "Size of the database's sorted tables on disk, by table.", MetricsWriter::Label("table", table.name), (double)table.sstBytes);
+		}
+		const std::string cacheHelp = "Database cache lookups, by cache and result.";
+		writer.AddCounter("grin_db_cache_lookups_total", cacheHelp, MetricsWriter::Label("cache", "block") + "," + MetricsWriter::Label("result", "hit"), dbStats.blockCacheHits);
+		writer.AddCounter("grin_db_cache_lookups_total", cacheHelp, MetricsWriter::Label("cache", "block") + "," + MetricsWriter::Label("result", "miss"), dbStats.blockCacheMisses);
+		writer.AddCounter("grin_db_cache_lookups_total", cacheHelp, MetricsWriter::Label("cache", "header") + "," + MetricsWriter::Label("result", "hit"), dbStats.headerCacheHits);
+		writer.AddCounter("grin_db_cache_lookups_total", cacheHelp, MetricsWriter::Label("cache", "header") + "," + MetricsWriter::Label("result", "miss"), dbStats.headerCacheMisses);
+		writer.AddCounter("grin_db_stall_micros_total", "Time writes were stalled by the database.", "", dbStats.stallMicros);
+		writer.AddGauge("grin_db_pending_compaction_bytes", "Bytes the database estimates it still has to compact.", "", (double)dbStats.pendingCompactionBytes);
+
+		return HTTPUtil::BuildSuccessResponseText(conn, writer.GetText());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+	}
+
+	return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to retrieve metrics.");
+}
+
+//
+// GET reports whether spans are being recorded.
+// POST with "enable" or "disable" starts or stops recording, and with "dump" writes the recorded spans to a Chrome trace file.
+//
+int ServerAPI::Trace_Handler(struct mg_connection* conn, void*)
+{
+	try
+	{
+		const HTTP::EHTTPMethod method = HTTPUtil::GetHTTPMethod(conn);
+		if (method == HTTP::EHTTPMethod::POST)
+		{
+			if (HTTPUtil::HasQueryParam(conn, "enable"))
+			{
+				TracerAPI::SetEnabled(true);
+			}
+			else if (HTTPUtil::HasQueryParam(conn, "disable"))
+			{
+				TracerAPI::SetEnabled(false);
+			}
+			else if (HTTPUtil::HasQueryParam(conn, "dump"))
+			{
+				const fs::path path = TracerAPI::Dump();
+				LOG_INFO_F("Trace written to {}", path.u8string());
+
+				Json::Value dumpNode;
+				dumpNode["path"] = path.u8string();
+				return HTTPUtil::BuildSuccessResponse(conn, dumpNode.toStyledString());
+			}
+			else
+			{
+				return HTTPUtil::BuildBadRequestResponse(conn, "Expected enable, disable, or dump.");
+			}
+		}
+		else if (method != HTTP::EHTTPMethod::GET)
+		{
+			return HTTPUtil::BuildNotFoundResponse(conn, "Not Found");
+		}
+
+		Json::Value traceNode;
+		traceNode["enabled"] = TracerAPI::IsEnabled();
+		return HTTPUtil::BuildSuccessResponse(conn, traceNode.toStyledString());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+	}
+
+	return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to update tracing.");
+}
+
+//
+// GET reports the memory budget, and each cache and pool's share of it.
+// POST with budget_mb sets the budget, re-apportioning it immediately (0 stops managing the caches and pools).
+//
+int ServerAPI::Memory_Handler(struct mg_connection* conn, void*)
+{
+	try
+	{
+		const HTTP::EHTTPMethod method = HTTPUtil::GetHTTPMethod(conn);
+		if (method == HTTP::EHTTPMethod::POST)
+		{
+			const std::optional<std::string> budgetOpt = HTTPUtil::GetQueryParam(conn, "budget_mb");
+			if (!budgetOpt.has_value())
+			{
+				return HTTPUtil::BuildBadRequestResponse(conn, "Expected budget_mb.");
+			}
+
+			size_t budgetMB = 0;
+			try
+			{
+				budgetMB = (size_t)std::stoull(budgetOpt.value());
+			}
+			catch (std::exception&)
+			{
+				return HTTPUtil::BuildBadRequestResponse(conn, "budget_mb must be a number.");
+			}
+
+			LOG_INFO_F("Setting memory budget to {}MB", budgetMB);
+			MemoryBudgetAPI::SetBudget(budgetMB * 1024 * 1024);
+		}
+		else if (method != HTTP::EHTTPMethod::GET)
+		{
+			return HTTPUtil::BuildNotFoundResponse(conn, "Not Found");
+		}
+
+		Json::Value memoryNode;
+		memoryNode["budget_bytes"] = (Json::UInt64)MemoryBudgetAPI::GetBudget();
+
+		Json::Value consumersNode(Json::arrayValue);
+		for (const MemoryConsumerStats& stats : MemoryBudgetAPI::GetStats())
+		{
+			Json::Value consumerNode;
+			consumerNode["name"] = stats.name;
+			consumerNode["priority"] = stats.priority;
+			consumerNode["limit_bytes"] = (Json::UInt64)stats.limitBytes;
+			consumerNode["usage_bytes"] = (Json::UInt64)stats.usageBytes;
+			consumersNode.append(consumerNode);
+		}
+		memoryNode["consumers"] = consumersNode;
+
+		return HTTPUtil::BuildSuccessResponse(conn, memoryNode.toStyledString());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+	}
+
+	return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to update the memory budget.");
+}
+
+//
+// Reports the CPU and wait time of every named thread, the totals of each thread name, and the run time and lag of each periodic task.
+//
+int ServerAPI::GetThreads_Handler(struct mg_connection* conn, void*)
+{
+	try
+	{
+		Json::Value threadsNode(Json::arrayValue);
+		for (const ThreadStats& thread : ThreadManagerAPI::GetThreadStats())
+		{
+			Json::Value threadNode;
+			threadNode["name"] = thread.displayName;
+			threadNode["cpu_micros"] = (Json::UInt64)thread.cpuMicros;
+			threadNode["wait_micros"] = (Json::UInt64)thread.waitMicros;
+			threadNode["wall_micros"] = (Json::UInt64)thread.wallMicros;
+			threadNode["activity"] = thread.activity;
+			threadsNode.append(threadNode);
+		}
+
+		Json::Value groupsNode(Json::arrayValue);
+		for (const ThreadGroupStats& group : ThreadManagerAPI::GetThreadGroupStats())
+		{
+			Json::Value groupNode;
+			groupNode["name"] = group.name;
+			groupNode["num_threads"] = (Json::UInt64)group.numThreads;
+			groupNode["cpu_micros"] = (Json::UInt64)group.cpuMicros;
+			groupNode["wait_micros"] = (Json::UInt64)group.waitMicros;
+			groupNode["wall_micros"] = (Json::UInt64)group.wallMicros;
+			groupsNode.append(groupNode);
+		}
+
+		Json::Value tasksNode(Json::arrayValue);
+		for (const ScheduledTaskStats& task : TaskScheduler::GetAllStats())
+		{
+			Json::Value taskNode;
+			taskNode["name"] = task.name;
+			taskNode["runs"] = (Json::UInt64)task.runs;
+			taskNode["overruns"] = (Json::UInt64)task.overruns;
+			taskNode["run_micros"] = (Json::UInt64)task.totalRunMicros;
+			taskNode["max_run_micros"] = (Json::UInt64)task.maxRunMicros;
+			taskNode["lag_micros"] = (Json::UInt64)task.totalLagMicros;
+			taskNode["max_lag_micros"] = (Json::UInt64)task.maxLagMicros;
+			tasksNode.append(taskNode);
+		}
+
+		Json::Value statsNode;
+		statsNode["threads"] = threadsNode;
+		statsNode["groups"] = groupsNode;
+		statsNode["scheduled_tasks"] = tasksNode;
+		return HTTPUtil::BuildSuccessResponse(conn, statsNode.toStyledString());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+	}
+
+	return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to retrieve thread stats.");
+}
+
+//
+// Reports the allocations counted under each subsystem's tag. Only populated in builds with GRINPP_ALLOC_PROFILING.
+//
+int ServerAPI::GetAllocations_Handler(struct mg_connection* conn, void*)
+{
+	try
+	{
+		Json::Value tagsNode(Json::arrayValue);
+		for (const AllocTagStats& tag : AllocProfilerAPI::GetStats())
+		{
+			Json::Value tagNode;
+			tagNode["tag"] = tag.name;
+			tagNode["allocations"] = (Json::UInt64)tag.numAllocs;
+			tagNode["bytes"] = (Json::UInt64)tag.numBytes;
+			tagNode["frees"] = (Json::UInt64)tag.numFrees;
+			tagNode["live_bytes"] = (Json::UInt64)tag.liveBytes;
+			tagNode["peak_live_bytes"] = (Json::UInt64)tag.peakLiveBytes;
+			tagsNode.append(tagNode);
+		}
+
+		Json::Value statsNode;
+		statsNode["enabled"] = AllocProfilerAPI::IsEnabled();
+		statsNode["tags"] = tagsNode;
+		return HTTPUtil::BuildSuccessResponse(conn, statsNode.toStyledString());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+	}
+
+	return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to retrieve allocation stats.");
+}
+
+void ServerAPI::WritePoolMetrics(MetricsWriter& writer, const TxPoolStats& stats)
+{
+	const std::string memPool = MetricsWriter::Label("pool", "mempool");
+	const std::string stemPool = MetricsWriter::Label("pool", "stempool");
+
+	writer.AddGauge("grin_txpool_transactions", "Transactions in the pool.", memPool, (double)stats.memPool.numTransactions);
+	writer.AddGauge("grin_txpool_transactions", "Transactions in the pool.", stemPool, (double)stats.stemPool.numTransactions);
+	writer.AddGauge("grin_txpool_bytes", "Estimated memory used by the pool.", memPool, (double)stats.memPool.memoryUsage);
+	writer.AddGauge("grin_txpool_bytes", "Estimated memory used by the pool.", stemPool, (double)stats.stemPool.memoryUsage);
+	writer.AddCounter("grin_txpool_evicted_total", "Transactions evicted to stay within the pool's size limit.", memPool, stats.memPool.numEvicted);
+	writer.AddCounter("grin_txpool_evicted_total", "Transactions evicted to stay within the pool's size limit.", stemPool, stats.stemPool.numEvicted);
+	writer.AddCounter("grin_txpool_reconciled_blocks_total", "Connected blocks the pools were reconciled with.", "", stats.numBlocksReconciled);
+	writer.AddCounter("grin_txpool_reconcile_micros_total", "Time spent reconciling the pools with connected blocks.", "", stats.reconcileMicros);
+}
+
+void ServerAPI::WriteMemoryMetrics(MetricsWriter& writer)
+{
+	writer.AddGauge("grin_memory_budget_bytes", "Memory shared by the caches and pools. 0 if unmanaged.", "", (double)MemoryBudgetAPI::GetBudget());
+
+	const std::vector<MemoryConsumerStats> consumers = MemoryBudgetAPI::GetStats();
+	for (const MemoryConsumerStats& consumer : consumers)
+	{
+		writer.AddGauge("grin_memory_usage_bytes", "Estimated memory used, by cache or pool.", MetricsWriter::Label("consumer", consumer.name), (double)consumer.usageBytes);
+	}
+	for (const MemoryConsumerStats& consumer : consumers)
+	{
+		writer.AddGauge("grin_memory_limit_bytes", "Share of the memory budget, by cache or pool.", MetricsWriter::Label("consumer", consumer.name), (double)consumer.limitBytes);
+	}
+}
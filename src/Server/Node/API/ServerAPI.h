@@ -1,10 +1,13 @@
 #pragma once
 
+#include <TxPool/PoolStats.h>
+#include <P2P/SyncStatus.h>
+#include <Common/Metrics.h>
+#include <json/json.h>
 #include <string>
 
 // Forward Declarations
 struct mg_connection;
-class SyncStatus;
 
 class ServerAPI
 {
@@ -12,7 +15,17 @@ public:
 	static int V1_Handler(struct mg_connection* conn, void* pVoid);
 	static int GetStatus_Handler(struct mg_connection* conn, void* pNodeContext);
 	static int ResyncChain_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int GetDBStats_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int GetMetrics_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int Trace_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int Memory_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int GetThreads_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int GetAllocations_Handler(struct mg_connection* conn, void* pNodeContext);
 
 private:
-	static std::string GetStatusString(const SyncStatus& syncStatus);
+	static std::string GetStatusString(const ESyncStatus status);
+	static Json::Value ToJSON(const PoolStats& stats);
+	static Json::Value ToJSON(const SyncTelemetry& telemetry);
+	static void WritePoolMetrics(MetricsWriter& writer, const TxPoolStats& stats);
+	static void WriteMemoryMetrics(MetricsWriter& writer);
 };
\ No newline at end of file
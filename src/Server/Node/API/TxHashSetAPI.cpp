@@ -2,8 +2,10 @@
 #include "../NodeContext.h"
 
 #include <Net/Util/HTTPUtil.h>
+#include <Net/Util/JsonStreamWriter.h>
 #include <Common/Util/StringUtil.h>
 #include <Crypto/Hasher.h>
+#include <Consensus/BlockTime.h>
 #include <json/json.h>
 
 /*
@@ -12,8 +14,16 @@
   "get txhashset/lastrangeproofs",
   "get txhashset/lastkernels?n=100",
   "get txhashset/outputs?start_index=1&max=100",
+  "post txhashset/snapshot?height=###",
 */
 
+//
+// The roots and last hashes only change along with the confirmed tip.
+//
+static ResponseCache::Version GetTipVersion(const ChainSnapshot& snapshot)
+{
+	return ResponseCache::Version{ snapshot.GetGeneration(), 0, 0 };
+}
 
 int TxHashSetAPI::GetRoots_Handler(struct mg_connection* conn, void* pNodeContext)
 {
@@ -21,15 +31,19 @@ int TxHashSetAPI::GetRoots_Handler(struct mg_connection* conn, void* pNodeContex
 
 	try
 	{
-		auto pTipHeader = pServer->m_pBlockChain->GetTipBlockHeader(EChainType::CONFIRMED);
+		ChainSnapshot::CPtr pSnapshot = pServer->m_pBlockChain->GetSnapshot();
+		const BlockHeaderPtr& pTipHeader = pSnapshot->GetTip(EChainType::CONFIRMED);
 		if (pTipHeader != nullptr)
 		{
-			Json::Value rootNode;
-			rootNode["output_root_hash"] = pTipHeader->GetOutputRoot().ToHex();
-			rootNode["range_proof_root_hash"] = pTipHeader->GetRangeProofRoot().ToHex();
-			rootNode["kernel_root_hash"] = pTipHeader->GetKernelRoot().ToHex();
-
-			return HTTPUtil::BuildSuccessResponse(conn, rootNode.toStyledString());
+			auto pBody = pServer->m_pResponseCache->Get("txhashset/roots", GetTipVersion(*pSnapshot), [&pTipHeader]() {
+				Json::Value rootNode;
+				rootNode["output_root_hash"] = pTipHeader->GetOutputRoot().ToHex();
+				rootNode["range_proof_root_hash"] = pTipHeader->GetRangeProofRoot().ToHex();
+				rootNode["kernel_root_hash"] = pTipHeader->GetKernelRoot().ToHex();
+				return rootNode.toStyledString();
+			});
+
+			return HTTPUtil::BuildSuccessResponse(conn, *pBody);
 		}
 		else
 		{
@@ -62,18 +76,24 @@ int TxHashSetAPI::GetLastKernels_Handler(struct mg_connection* conn, void* pNode
 			numHashes = std::stoull(numHashesStr);
 		}
 
+		// Read before the TxHashSet, so a tip committed in between only makes the cached body newer than its version.
+		const ResponseCache::Version version = GetTipVersion(*pServer->m_pBlockChain->GetSnapshot());
 		auto pTxHashSet = pServer->m_pTxHashSetManager->GetTxHashSet();
 		if (pTxHashSet != nullptr)
 		{
-			Json::Value json;
+			auto pBody = pServer->m_pResponseCache->Get(StringUtil::Format("txhashset/lastkernels?n={}", numHashes), version, [&pTxHashSet, numHashes]() {
+				Json::Value json;
 
-			std::vector<Hash> hashes = pTxHashSet->GetLastKernelHashes(numHashes);
-			for (const Hash& hash : hashes)
-			{
-				json.append(hash.ToHex());
-			}
+				std::vector<Hash> hashes = pTxHashSet->GetLastKernelHashes(numHashes);
+				for (const Hash& hash : hashes)
+				{
+					json.append(hash.ToHex());
+				}
 
-			return HTTPUtil::BuildSuccessResponse(conn, json.toStyledString());
+				return json.toStyledString();
+			});
+
+			return HTTPUtil::BuildSuccessResponse(conn, *pBody);
 		}
 	}
 	catch (std::exception& e)
@@ -104,20 +124,25 @@ int TxHashSetAPI::GetLastOutputs_Handler(struct mg_connection* conn, void* pNode
 			numHashes = std::stoull(numHashesStr);
 		}
 
+		const ResponseCache::Version version = GetTipVersion(*pServer->m_pBlockChain->GetSnapshot());
 		auto pTxHashSet = pServer->m_pTxHashSetManager->GetTxHashSet();
 		if (pTxHashSet != nullptr)
 		{
-			Json::Value rootNode;
+			auto pBody = pServer->m_pResponseCache->Get(StringUtil::Format("txhashset/lastoutputs?n={}", numHashes), version, [&pTxHashSet, numHashes]() {
+				Json::Value rootNode;
 
-			std::vector<Hash> hashes = pTxHashSet->GetLastOutputHashes(numHashes);
-			for (const Hash& hash : hashes)
-			{
-				Json::Value outputNode;
-				outputNode["hash"] = hash.ToHex();
-				rootNode.append(outputNode);
-			}
+				std::vector<Hash> hashes = pTxHashSet->GetLastOutputHashes(numHashes);
+				for (const Hash& hash : hashes)
+				{
+					Json::Value outputNode;
+					outputNode["hash"] = hash.ToHex();
+					rootNode.append(outputNode);
+				}
 
-			return HTTPUtil::BuildSuccessResponse(conn, rootNode.toStyledString());
+				return rootNode.toStyledString();
+			});
+
+			return HTTPUtil::BuildSuccessResponse(conn, *pBody);
 		}
 	}
 	catch (std::exception& e)
@@ -148,20 +173,25 @@ int TxHashSetAPI::GetLastRangeproofs_Handler(struct mg_connection* conn, void* p
 			numHashes = std::stoull(numHashesStr);
 		}
 
+		const ResponseCache::Version version = GetTipVersion(*pServer->m_pBlockChain->GetSnapshot());
 		auto pTxHashSet = pServer->m_pTxHashSetManager->GetTxHashSet();
 		if (pTxHashSet != nullptr)
 		{
-			Json::Value rootNode;
+			auto pBody = pServer->m_pResponseCache->Get(StringUtil::Format("txhashset/lastrangeproofs?n={}", numHashes), version, [&pTxHashSet, numHashes]() {
+				Json::Value rootNode;
 
-			std::vector<Hash> hashes = pTxHashSet->GetLastRangeProofHashes(numHashes);
-			for (const Hash& hash : hashes)
-			{
-				Json::Value rangeProofNode;
-				rangeProofNode["hash"] = hash.ToHex();
-				rootNode.append(rangeProofNode);
-			}
+				std::vector<Hash> hashes = pTxHashSet->GetLastRangeProofHashes(numHashes);
+				for (const Hash& hash : hashes)
+				{
+					Json::Value rangeProofNode;
+					rangeProofNode["hash"] = hash.ToHex();
+					rootNode.append(rangeProofNode);
+				}
+
+				return rootNode.toStyledString();
+			});
 
-			return HTTPUtil::BuildSuccessResponse(conn, rootNode.toStyledString());
+			return HTTPUtil::BuildSuccessResponse(conn, *pBody);
 		}
 	}
 	catch (std::exception& e)
@@ -197,6 +227,7 @@ int TxHashSetAPI::GetOutputs_Handler(struct mg_connection* conn, void* pNodeCont
 	uint64_t startIndex = 1;
 	uint64_t max = 100;
 
+	std::unique_ptr<JsonStreamWriter> pWriter = nullptr;
 	try
 	{
 		const std::string queryString = HTTPUtil::GetQueryString(conn);
@@ -236,14 +267,24 @@ int TxHashSetAPI::GetOutputs_Handler(struct mg_connection* conn, void* pNodeCont
 		auto pTxHashSet = pServer->m_pTxHashSetManager->GetTxHashSet();
 		if (pTxHashSet != nullptr)
 		{
-			Json::Value rootNode;
-
 			auto pBlockDB = pServer->m_pDatabase->GetBlockDB()->Read();
 			OutputRange range = pTxHashSet->GetOutputsByLeafIndex(pBlockDB.GetShared(), startIndex, max);
-			rootNode["highest_index"] = range.GetHighestIndex();
-			rootNode["last_retrieved_index"] = range.GetLastRetrievedIndex();
 
-			Json::Value outputsNode;
+			// Grin++ wallets ask for the consensus-serialized range, which is about half the size and faster to parse.
+			if (HTTPUtil::AcceptsBinary(conn))
+			{
+				Serializer serializer;
+				range.Serialize(serializer);
+				return HTTPUtil::BuildSuccessResponseBinary(conn, serializer.GetBytes());
+			}
+
+			pWriter = JsonStreamWriter::Create(conn);
+			pWriter->BeginObject();
+			pWriter->Member("highest_index", range.GetHighestIndex());
+			pWriter->Member("last_retrieved_index", range.GetLastRetrievedIndex());
+
+			pWriter->Key("outputs");
+			pWriter->BeginArray();
 			for (const OutputDTO& info : range.GetOutputs())
 			{
 				Json::Value outputNode;
@@ -260,18 +301,65 @@ int TxHashSetAPI::GetOutputs_Handler(struct mg_connection* conn, void* pNodeCont
 				outputNode["block_height"] = info.GetLocation().GetBlockHeight();
 				outputNode["merkle_proof"] = Json::nullValue;
 				outputNode["mmr_index"] = info.GetLocation().GetMMRIndex() + 1;
-				outputsNode.append(outputNode);
+				pWriter->Value(outputNode);
 			}
 
-			rootNode["outputs"] = outputsNode;
+			pWriter->EndArray();
+			pWriter->EndObject();
 
-			return HTTPUtil::BuildSuccessResponse(conn, rootNode.toStyledString());
+			return pWriter->Finish();
 		}
 	}
 	catch (std::exception& e)
 	{
 		LOG_ERROR_F("Exception thrown: {}", e.what());
+		if (pWriter != nullptr && pWriter->HasStarted())
+		{
+			return 500;
+		}
 	}
 
 	return HTTPUtil::BuildInternalErrorResponse(conn, "Failed to find TxHashSet.");
-}
\ No newline at end of file
+}
+//
+// Exports a snapshot for bootstrapping our own nodes (see IBlockChain::ExportTxHashSetSnapshot).
+// Defaults to the block TxHashSet archives are built for.
+//
+int TxHashSetAPI::ExportSnapshot_Handler(struct mg_connection* conn, void* pNodeContext)
+{
+	NodeContext* pServer = (NodeContext*)pNodeContext;
+
+	if (HTTPUtil::GetHTTPMethod(conn) != HTTP::EHTTPMethod::POST)
+	{
+		return HTTPUtil::BuildBadRequestResponse(conn, "Expected POST /v1/txhashset/snapshot?height=###");
+	}
+
+	try
+	{
+		uint64_t height = Consensus::GetTxHashSetArchiveHeight(pServer->m_pBlockChain->GetHeight(EChainType::CONFIRMED));
+		const std::optional<std::string> heightOpt = HTTPUtil::GetQueryParam(conn, "height");
+		if (heightOpt.has_value())
+		{
+			height = std::stoull(heightOpt.value());
+		}
+
+		BlockHeaderPtr pHeader = pServer->m_pBlockChain->GetBlockHeaderByHeight(height, EChainType::CONFIRMED);
+		if (pHeader == nullptr)
+		{
+			return HTTPUtil::BuildNotFoundResponse(conn, StringUtil::Format("No confirmed block at height {}", height));
+		}
+
+		const fs::path snapshotPath = pServer->m_pBlockChain->ExportTxHashSetSnapshot(pHeader);
+
+		Json::Value rootNode;
+		rootNode["height"] = Json::UInt64(pHeader->GetHeight());
+		rootNode["hash"] = pHeader->GetHash().ToHex();
+		rootNode["path"] = snapshotPath.u8string();
+		return HTTPUtil::BuildSuccessResponseJSON(conn, rootNode);
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Exception thrown: {}", e.what());
+		return HTTPUtil::BuildBadRequestResponse(conn, e.what());
+	}
+}
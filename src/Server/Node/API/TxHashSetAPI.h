@@ -11,4 +11,5 @@ public:
 	static int GetLastOutputs_Handler(struct mg_connection* conn, void* pNodeContext);
 	static int GetLastRangeproofs_Handler(struct mg_connection* conn, void* pNodeContext);
 	static int GetOutputs_Handler(struct mg_connection* conn, void* pNodeContext);
+	static int ExportSnapshot_Handler(struct mg_connection* conn, void* pNodeContext);
 };
\ No newline at end of file
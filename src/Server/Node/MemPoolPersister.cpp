@@ -0,0 +1,181 @@
+#include "MemPoolPersister.h"
+
+#include <Common/Util/ThreadUtil.h>
+#include <Common/ThreadManager.h>
+#include <Common/Logger.h>
+#include <Database/BlockDb.h>
+#include <chrono>
+
+MemPoolPersister::MemPoolPersister(
+	const Config& config,
+	const IDatabasePtr& pDatabase,
+	const TxHashSetManager::Ptr& pTxHashSetManager,
+	const ITransactionPool::Ptr& pTransactionPool,
+	const IBlockChain::Ptr& pBlockChain)
+	: m_config(config),
+	m_pDatabase(pDatabase),
+	m_pTxHashSetManager(pTxHashSetManager),
+	m_pTransactionPool(pTransactionPool),
+	m_pBlockChain(pBlockChain),
+	m_reloaded(false),
+	m_terminate(false)
+{
+
+}
+
+MemPoolPersister::~MemPoolPersister()
+{
+	m_terminate = true;
+	ThreadUtil::Join(m_thread);
+
+	if (m_reloaded)
+	{
+		Save();
+	}
+}
+
+MemPoolPersister::UPtr MemPoolPersister::Create(
+	const Config& config,
+	const IDatabasePtr& pDatabase,
+	const TxHashSetManager::Ptr& pTxHashSetManager,
+	const ITransactionPool::Ptr& pTransactionPool,
+	const IBlockChain::Ptr& pBlockChain)
+{
+	if (config.GetNodeConfig().GetMemPoolSaveSecs() == 0)
+	{
+		return nullptr;
+	}
+
+	auto pPersister = std::unique_ptr<MemPoolPersister>(new MemPoolPersister(
+		config,
+		pDatabase,
+		pTxHashSetManager,
+		pTransactionPool,
+		pBlockChain
+	));
+
+	pPersister->m_thread = std::thread(MemPoolPersister::Thread_Persist, std::ref(*pPersister));
+	return pPersister;
+}
+
+void MemPoolPersister::Thread_Persist(MemPoolPersister& persister)
+{
+	ThreadManagerAPI::SetCurrentThreadName("MEMPOOL_PERSIST");
+	LOG_DEBUG("BEGIN");
+
+	// When syncing from scratch, there's no TxHashSet to check the saved txs against until it's been downloaded.
+	while (!persister.m_terminate && persister.m_pTxHashSetManager->GetTxHashSet() == nullptr)
+	{
+		ThreadUtil::SleepFor(std::chrono::seconds(1), persister.m_terminate);
+	}
+
+	if (!persister.m_terminate)
+	{
+		persister.Reload();
+		persister.m_reloaded = !persister.m_terminate;
+	}
+
+	const std::chrono::seconds saveInterval(persister.m_config.GetNodeConfig().GetMemPoolSaveSecs());
+	while (!persister.m_terminate)
+	{
+		ThreadUtil::SleepFor(saveInterval, persister.m_terminate);
+		if (!persister.m_terminate)
+		{
+			persister.Save();
+		}
+	}
+
+	LOG_DEBUG("END");
+}
+
+void MemPoolPersister::Reload()
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	std::vector<std::pair<EPoolType, TransactionPtr>> saved;
+	try
+	{
+		saved = TxPoolAPI::LoadTransactions(m_config.GetNodeConfig().GetMemPoolPath());
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Failed to load the saved pool txs. Error: {}", e.what());
+		return;
+	}
+
+	if (saved.empty())
+	{
+		return;
+	}
+
+	// Verified as a batch on the worker pool. Txs that pass are marked as validated, so the pool doesn't verify them again.
+	std::vector<TransactionPtr> transactions;
+	transactions.reserve(saved.size());
+	for (const auto& entry : saved)
+	{
+		transactions.push_back(entry.second);
+	}
+
+	const std::vector<bool> valid = m_pBlockChain->VerifySelfConsistent(transactions);
+
+	// Added in the order they were saved, so txs are added after the txs whose outputs they spend.
+	// Each tx is added under its own read lock, so block processing isn't held up for the whole reload.
+	size_t numAdded = 0;
+	for (size_t i = 0; i < saved.size() && !m_terminate; i++)
+	{
+		if (!valid[i])
+		{
+			continue;
+		}
+
+		auto pTipHeader = m_pBlockChain->GetTipBlockHeader(EChainType::CONFIRMED);
+		auto pTxHashSet = m_pTxHashSetManager->GetTxHashSet();
+		if (pTipHeader == nullptr || pTxHashSet == nullptr)
+		{
+			break;
+		}
+
+		try
+		{
+			auto pBlockDB = m_pDatabase->GetBlockDB()->Read();
+			const EAddTransactionStatus status = m_pTransactionPool->AddTransaction(
+				pBlockDB.GetShared(),
+				pTxHashSet,
+				saved[i].second,
+				saved[i].first,
+				*pTipHeader
+			);
+			if (status == EAddTransactionStatus::ADDED)
+			{
+				++numAdded;
+			}
+		}
+		catch (std::exception& e)
+		{
+			LOG_WARNING_F("Failed to reload {}. Error: {}", saved[i].second, e.what());
+		}
+	}
+
+	LOG_INFO_F(
+		"Reloaded {}/{} saved pool txs in {}ms",
+		numAdded,
+		saved.size(),
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+	);
+}
+
+void MemPoolPersister::Save() const
+{
+	try
+	{
+		const size_t numSaved = m_pTransactionPool->SaveTransactions(
+			m_config.GetNodeConfig().GetMemPoolPath(),
+			m_config.GetNodeConfig().IsStemPoolPersisted()
+		);
+		LOG_DEBUG_F("Saved {} pool txs", numSaved);
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR_F("Failed to save the pool txs. Error: {}", e.what());
+	}
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <Config/Config.h>
+#include <BlockChain/BlockChain.h>
+#include <Database/Database.h>
+#include <PMMR/TxHashSetManager.h>
+#include <TxPool/TransactionPool.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+
+//
+// Saves the mempool on shutdown and every NodeConfig::GetMemPoolSaveSecs(), so it isn't empty after a restart,
+// when compact blocks couldn't be hydrated from it and block templates would be missing its fees.
+//
+// On startup, the saved txs are reloaded in the background, once the TxHashSet is available. Their signatures and
+// rangeproofs are verified in parallel, and then each is added to the pool, which checks it against the current UTXO set.
+//
+class MemPoolPersister
+{
+public:
+	using UPtr = std::unique_ptr<MemPoolPersister>;
+
+	static UPtr Create(
+		const Config& config,
+		const IDatabasePtr& pDatabase,
+		const TxHashSetManager::Ptr& pTxHashSetManager,
+		const ITransactionPool::Ptr& pTransactionPool,
+		const IBlockChain::Ptr& pBlockChain
+	);
+
+	//
+	// Stops the thread, and saves the mempool one last time.
+	//
+	~MemPoolPersister();
+
+private:
+	MemPoolPersister(
+		const Config& config,
+		const IDatabasePtr& pDatabase,
+		const TxHashSetManager::Ptr& pTxHashSetManager,
+		const ITransactionPool::Ptr& pTransactionPool,
+		const IBlockChain::Ptr& pBlockChain
+	);
+
+	static void Thread_Persist(MemPoolPersister& persister);
+
+	void Reload();
+	void Save() const;
+
+	const Config& m_config;
+	IDatabasePtr m_pDatabase;
+	TxHashSetManager::Ptr m_pTxHashSetManager;
+	ITransactionPool::Ptr m_pTransactionPool;
+	IBlockChain::Ptr m_pBlockChain;
+
+	// Nothing is saved until the previous run's txs were reloaded, so a shutdown during startup doesn't overwrite them.
+	std::atomic_bool m_reloaded;
+	std::atomic_bool m_terminate;
+	std::thread m_thread;
+};
@@ -95,6 +95,12 @@ void Node::UpdateDisplay(const int secondsRunning)
 		std::cout << "\nStatus: Syncing blocks";
 	}
 
+	const SyncTelemetry::CPtr pTelemetry = pSyncStatus->GetTelemetry();
+	if (status != ESyncStatus::NOT_SYNCING && pTelemetry->etaSecs.has_value())
+	{
+		std::cout << "\nETA: " << pTelemetry->etaSecs.value() << "s";
+	}
+
 	std::cout << "\nNumConnections: " << pSyncStatus->GetNumActiveConnections();
 	std::cout << "\nHeader Height: " << pSyncStatus->GetHeaderHeight();
 	std::cout << "\nHeader Difficulty: " << pSyncStatus->GetHeaderDifficulty();
@@ -1,8 +1,16 @@
 #pragma once
 
 #include "../NodeContext.h"
+#include "../MemPoolPersister.h"
 
 #include <Core/Context.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <Common/Tracer.h>
+#include <Common/Logger.h>
+#include <Common/MemoryBudget.h>
+#include <Core/File/MappedFile.h>
+#include <Crypto/Crypto.h>
 #include <Wallet/NodeClient.h>
 #include <BlockChain/BlockChain.h>
 #include <Database/Database.h>
@@ -18,23 +26,73 @@ public:
 		const TxHashSetManager::Ptr& pTxHashSetManager,
 		const ITransactionPool::Ptr& pTransactionPool,
 		const IBlockChain::Ptr& pBlockChain,
-		IP2PServerPtr pP2PServer)
+		IP2PServerPtr pP2PServer,
+		MemPoolPersister::UPtr&& pMemPoolPersister)
 		: m_pDatabase(pDatabase),
 		m_pTxHashSetManager(pTxHashSetManager),
 		m_pTransactionPool(pTransactionPool),
 		m_pBlockChain(pBlockChain),
-		m_pP2PServer(pP2PServer)
+		m_pP2PServer(pP2PServer),
+		m_pMemPoolPersister(std::move(pMemPoolPersister))
 	{
-
+		RegisterWithMemoryBudget();
 	}
 
 	static std::shared_ptr<DefaultNodeClient> Create(const Context::Ptr& pContext)
 	{
-		auto pDatabase = DatabaseAPI::OpenDatabase(pContext->GetConfig());
+		Crypto::SetRangeProofCacheCapacity(pContext->GetConfig().GetNodeConfig().GetRangeProofCacheSize());
+		Crypto::SetCommitmentCacheCapacity(pContext->GetConfig().GetNodeConfig().GetCommitmentCacheSize());
+		Crypto::SetKernelSignatureCacheCapacity(pContext->GetConfig().GetNodeConfig().GetKernelSignatureCacheSize());
+		MemoryBudgetAPI::SetBudget(pContext->GetConfig().GetNodeConfig().GetMemoryBudgetBytes());
+		// Threads are pinned as they're named, so the CPU sets must be configured before the pools and pipes start.
+		const NodeConfig& nodeConfig = pContext->GetConfig().GetNodeConfig();
+		for (const auto& cpuSet : nodeConfig.GetCpuAffinity())
+		{
+			LOG_INFO_F("Pinning {} threads to {} CPUs", cpuSet.first.empty() ? "other" : cpuSet.first, cpuSet.second.size());
+		}
+
+		ThreadManagerAPI::ConfigureCpuAffinity(nodeConfig.GetCpuAffinity());
+		ThreadManagerAPI::ConfigureThreadPool(nodeConfig.GetNumWorkerThreads());
+		ThreadManagerAPI::ConfigureLatencyThreadPool(nodeConfig.GetNumLatencyWorkerThreads());
+		TracerAPI::Configure(pContext->GetConfig().GetLogDirectory(), pContext->GetConfig().GetNodeConfig().GetTraceEventsPerThread());
+
+		// Replicas read the primary's files while it writes them, so none are mapped writable or created (see ReadOnlyFile).
+		IMappedFile::SetReadOnly(pContext->GetConfig().GetNodeConfig().IsReplica());
+
+		const auto start = std::chrono::steady_clock::now();
+		auto getElapsedMs = [](const std::chrono::steady_clock::time_point& since) {
+			return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+		};
+
+		// The databases and the header MMR don't depend on each other, so they're opened at the same time.
+		// The chain depends on all of them, and the P2P server on the chain.
+		ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+		std::future<IDatabasePtr> databaseOpened = threadPool.Submit([pContext] { return DatabaseAPI::OpenDatabase(pContext->GetConfig()); });
+		std::shared_ptr<Locked<IHeaderMMR>> pHeaderMMR = nullptr;
+		std::exception_ptr pException = nullptr;
+		try
+		{
+			pHeaderMMR = HeaderMMRAPI::OpenHeaderMMR(pContext->GetConfig());
+		}
+		catch (...)
+		{
+			pException = std::current_exception();
+		}
+
+		threadPool.Wait(databaseOpened);
+		if (pException != nullptr)
+		{
+			std::rethrow_exception(pException);
+		}
+
+		auto pDatabase = databaseOpened.get();
+		LOG_INFO_F("Startup: opened databases and header MMR in {}ms", getElapsedMs(start));
+
 		auto pTxHashSetManager = std::make_shared<TxHashSetManager>(pContext->GetConfig());
 		auto pLockedTxHashSetManager = std::make_shared<Locked<TxHashSetManager>>(pTxHashSetManager);
 		auto pTransactionPool = TxPoolAPI::CreateTransactionPool(pContext->GetConfig());
-		auto pHeaderMMR = HeaderMMRAPI::OpenHeaderMMR(pContext->GetConfig());
+
+		const auto chainStart = std::chrono::steady_clock::now();
 		auto pBlockChainServer = BlockChainAPI::OpenBlockChain(
 			pContext->GetConfig(),
 			pDatabase->GetBlockDB(),
@@ -42,6 +100,9 @@ public:
 			pTransactionPool,
 			pHeaderMMR
 		);
+		LOG_INFO_F("Startup: loaded chain in {}ms", getElapsedMs(chainStart));
+
+		const auto p2pStart = std::chrono::steady_clock::now();
 		auto pP2PServer = P2PAPI::StartP2PServer(
 			pContext,
 			pBlockChainServer,
@@ -49,13 +110,25 @@ public:
 			pDatabase,
 			pTransactionPool
 		);
+		LOG_INFO_F("Startup: started P2P server in {}ms", getElapsedMs(p2pStart));
+
+		// Reloads the previous run's mempool in the background.
+		auto pMemPoolPersister = MemPoolPersister::Create(
+			pContext->GetConfig(),
+			pDatabase,
+			pTxHashSetManager,
+			pTransactionPool,
+			pBlockChainServer
+		);
+		LOG_INFO_F("Startup: node ready in {}ms", getElapsedMs(start));
 
 		return std::make_shared<DefaultNodeClient>(
 			pDatabase,
 			pTxHashSetManager,
 			pTransactionPool,
 			pBlockChainServer,
-			pP2PServer
+			pP2PServer,
+			std::move(pMemPoolPersister)
 		);
 	}
     
@@ -84,13 +157,20 @@ public:
 
 	std::map<Commitment, OutputLocation> GetOutputsByCommitment(const std::vector<Commitment>& commitments) const final
 	{
+		// Every page is read under the same lock, so the locations are all from the same chain state.
 		std::map<Commitment, OutputLocation> outputs;
-		for (const Commitment& commitment : commitments)
+		auto pBlockDB = m_pDatabase->GetBlockDB()->Read();
+		for (size_t begin = 0; begin < commitments.size(); begin += MAX_OUTPUTS_BY_COMMITMENT)
 		{
-			std::unique_ptr<OutputLocation> pOutputPosition = m_pDatabase->GetBlockDB()->Read()->GetOutputPosition(commitment);
-			if (pOutputPosition != nullptr)
+			const size_t end = (std::min)(begin + MAX_OUTPUTS_BY_COMMITMENT, commitments.size());
+			const std::vector<Commitment> page(commitments.cbegin() + begin, commitments.cbegin() + end);
+			const std::vector<std::unique_ptr<OutputLocation>> positions = pBlockDB->GetOutputPositions(page);
+			for (size_t i = 0; i < page.size(); i++)
 			{
-				outputs.insert(std::make_pair(commitment, *pOutputPosition));
+				if (positions[i] != nullptr)
+				{
+					outputs.insert(std::make_pair(page[i], *positions[i]));
+				}
 			}
 		}
 
@@ -116,6 +196,20 @@ public:
 		);
 	}
 
+	std::unique_ptr<OutputScanBatch> ScanOutputs(const uint64_t startIndex, const uint64_t maxNumOutputs) const final
+	{
+		auto pTxHashSet = m_pTxHashSetManager->GetTxHashSet();
+		if (pTxHashSet == nullptr)
+		{
+			return std::unique_ptr<OutputScanBatch>(nullptr);
+		}
+
+		auto pBlockDB = m_pDatabase->GetBlockDB()->Read();
+		return std::make_unique<OutputScanBatch>(
+			pTxHashSet->ScanOutputs(pBlockDB.GetShared(), startIndex, maxNumOutputs)
+		);
+	}
+
 	bool PostTransaction(TransactionPtr pTransaction, const EPoolType poolType) final
 	{
 		auto pTipHeader = m_pBlockChain->GetTipBlockHeader(EChainType::CONFIRMED);
@@ -157,9 +251,48 @@ public:
 	IP2PServerPtr GetP2PServer() { return m_pP2PServer; }
 
 private:
+	// Rough bytes per entry, including the cache's own bookkeeping.
+	static constexpr size_t VERIFIED_CACHE_ENTRY_BYTES = 128;
+	static constexpr size_t COMMITMENT_CACHE_ENTRY_BYTES = 160;
+
+	//
+	// The crypto caches are process-wide, but are only sized for the node, so they're registered by it.
+	//
+	void RegisterWithMemoryBudget()
+	{
+		m_memoryBudgetRegistrations.push_back(MemoryBudgetAPI::Register(MemoryConsumer{
+			"rangeproof_cache",
+			15,
+			1024 * VERIFIED_CACHE_ENTRY_BYTES,
+			[] { return Crypto::GetRangeProofCacheStats().size * VERIFIED_CACHE_ENTRY_BYTES; },
+			[](const size_t limitBytes) { Crypto::SetRangeProofCacheCapacity(limitBytes / VERIFIED_CACHE_ENTRY_BYTES); }
+		}));
+
+		m_memoryBudgetRegistrations.push_back(MemoryBudgetAPI::Register(MemoryConsumer{
+			"kernel_sig_cache",
+			10,
+			1024 * VERIFIED_CACHE_ENTRY_BYTES,
+			[] { return Crypto::GetKernelSignatureCacheStats().size * VERIFIED_CACHE_ENTRY_BYTES; },
+			[](const size_t limitBytes) { Crypto::SetKernelSignatureCacheCapacity(limitBytes / VERIFIED_CACHE_ENTRY_BYTES); }
+		}));
+
+		m_memoryBudgetRegistrations.push_back(MemoryBudgetAPI::Register(MemoryConsumer{
+			"commitment_cache",
+			5,
+			1024 * COMMITMENT_CACHE_ENTRY_BYTES,
+			[] { return Crypto::GetCommitmentCacheStats().size * COMMITMENT_CACHE_ENTRY_BYTES; },
+			[](const size_t limitBytes) { Crypto::SetCommitmentCacheCapacity(limitBytes / COMMITMENT_CACHE_ENTRY_BYTES); }
+		}));
+	}
+
 	IDatabasePtr m_pDatabase;
 	TxHashSetManager::Ptr m_pTxHashSetManager;
 	ITransactionPool::Ptr m_pTransactionPool;
 	IBlockChain::Ptr m_pBlockChain;
 	IP2PServerPtr m_pP2PServer;
+
+	std::vector<MemoryBudgetRegistration::UPtr> m_memoryBudgetRegistrations;
+
+	// Declared last, so the mempool is saved before anything it uses is shut down.
+	MemPoolPersister::UPtr m_pMemPoolPersister;
 };
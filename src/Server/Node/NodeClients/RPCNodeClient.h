@@ -4,6 +4,7 @@
 #include <Net/Connections/HttpConnection.h>
 #include <Common/Exceptions/UnimplementedException.h>
 #include <Common/Macros.h>
+#include <atomic>
 #include <memory>
 
 // TODO: Implement caching & retry policies
@@ -17,7 +18,7 @@ class RPCNodeClient : public INodeClient
 
 public:
 	RPCNodeClient(const ENodeType type, HttpConnection::UPtr&& pConnection)
-		: m_type(type), m_pConnection(std::move(pConnection)) { }
+		: m_type(type), m_pConnection(std::move(pConnection)), m_binarySupported(type == ENodeType::GRINPP) { }
 
 	static INodeClientPtr Create(const std::string& host, const uint16_t port)
 	{
@@ -61,6 +62,39 @@ public:
 	//
 	std::map<Commitment, OutputLocation> GetOutputsByCommitment(const std::vector<Commitment>& commitments) const final
 	{
+		if (m_binarySupported)
+		{
+			try
+			{
+				std::map<Commitment, OutputLocation> outputsByCommitment;
+				for (size_t begin = 0; begin < commitments.size(); begin += MAX_OUTPUTS_BY_COMMITMENT)
+				{
+					const size_t end = (std::min)(begin + MAX_OUTPUTS_BY_COMMITMENT, commitments.size());
+
+					Serializer serializer;
+					serializer.Append<uint64_t>(end - begin);
+					for (size_t i = begin; i < end; i++)
+					{
+						commitments[i].Serialize(serializer);
+					}
+
+					ByteBuffer byteBuffer(m_pConnection->InvokeBinary(HTTP::EHTTPMethod::POST, "/v1/chain/outputs/byids", serializer.GetBytes()));
+					const uint64_t numOutputs = byteBuffer.ReadU64();
+					for (uint64_t i = 0; i < numOutputs; i++)
+					{
+						Commitment commitment = Commitment::Deserialize(byteBuffer);
+						outputsByCommitment.insert({ std::move(commitment), OutputLocation::Deserialize(byteBuffer) });
+					}
+				}
+
+				return outputsByCommitment;
+			}
+			catch (HTTPException& e)
+			{
+				DisableBinary(e);
+			}
+		}
+
 		Json::Value commitsJson;
 		for (const Commitment& commit : commitments)
 		{
@@ -74,7 +108,7 @@ public:
 		params.append(false);
 		params.append(false);
 
-		auto response = Invoke("get_outputs");
+		auto response = Invoke("get_outputs", params);
 
 		std::map<Commitment, OutputLocation> outputsByCommitment;
 		for (const auto& output : response)
@@ -105,6 +139,25 @@ public:
 	//
 	std::unique_ptr<OutputRange> GetOutputsByLeafIndex(const uint64_t startIndex, const uint64_t maxNumOutputs) const final
 	{
+		if (m_binarySupported)
+		{
+			try
+			{
+				const std::string location = StringUtil::Format(
+					"/v1/txhashset/outputs?start_index={}&max={}",
+					startIndex,
+					maxNumOutputs
+				);
+
+				ByteBuffer byteBuffer(m_pConnection->InvokeBinary(HTTP::EHTTPMethod::GET, location));
+				return std::make_unique<OutputRange>(OutputRange::Deserialize(byteBuffer));
+			}
+			catch (HTTPException& e)
+			{
+				DisableBinary(e);
+			}
+		}
+
 		Json::Value params(Json::arrayValue);
 		params.append(Json::UInt64(startIndex));
 		params.append(Json::nullValue);
@@ -130,6 +183,15 @@ public:
 	}
 
 private:
+	//
+	// Falls back to the JSON RPCs, e.g. for Grin++ nodes that predate the binary REST APIs.
+	//
+	void DisableBinary(const HTTPException& e) const
+	{
+		WALLET_WARNING_F("Binary node API failed ({}). Using JSON instead.", e.what());
+		m_binarySupported = false;
+	}
+
 	Json::Value Invoke(const std::string& method, const Json::Value& params) const
 	{
 		auto response = m_pConnection->Invoke(method, params);
@@ -152,4 +214,7 @@ private:
 
 	ENodeType m_type;
 	HttpConnection::UPtr m_pConnection;
+
+	// Grin++ nodes can serve outputs consensus-serialized, which is about half the size of JSON.
+	mutable std::atomic_bool m_binarySupported;
 };
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <P2P/P2PServer.h>
 #include <PMMR/TxHashSetManager.h>
 #include <TxPool/TransactionPool.h>
+#include <Net/Util/ResponseCache.h>
 
 struct NodeContext
 {
@@ -13,4 +14,7 @@ struct NodeContext
 	IP2PServerPtr m_pP2PServer;
 	TxHashSetManager::Ptr m_pTxHashSetManager;
 	ITransactionPool::Ptr m_pTransactionPool;
+
+	// Shared by the API handlers whose responses only change along with the tip or the mempool.
+	ResponseCache::Ptr m_pResponseCache = std::make_shared<ResponseCache>();
 };
\ No newline at end of file
@@ -21,16 +21,33 @@ static int Shutdown_Handler(struct mg_connection* conn, void*)
 NodeRestServer::UPtr NodeRestServer::Create(const Config& config, std::shared_ptr<NodeContext> pNodeContext)
 {
 	const uint16_t port = config.GetServerConfig().GetRestAPIPort();
-	ServerPtr pServer = Server::Create(EServerType::LOCAL, std::make_optional<uint16_t>(port));
-	NodeServer::UPtr pV2Server = NodeServer::Create(pServer, pNodeContext->m_pBlockChain, pNodeContext->m_pP2PServer);
+	ServerPtr pServer = Server::Create(
+		EServerType::LOCAL,
+		std::make_optional<uint16_t>(port),
+		config.GetServerConfig().GetNodeAPIConfig()
+	);
+	NodeServer::UPtr pV2Server = NodeServer::Create(
+		pServer,
+		pNodeContext->m_pBlockChain,
+		pNodeContext->m_pP2PServer,
+		pNodeContext->m_pTransactionPool,
+		pNodeContext->m_pResponseCache
+	);
 
 	/* Add v1 handlers */
 	pServer->AddListener("/v1/status", ServerAPI::GetStatus_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/resync", ServerAPI::ResyncChain_Handler, pNodeContext.get());
+	pServer->AddListener("/v1/stats/db", ServerAPI::GetDBStats_Handler, pNodeContext.get());
+	pServer->AddListener("/v1/trace", ServerAPI::Trace_Handler, pNodeContext.get());
+	pServer->AddListener("/v1/memory", ServerAPI::Memory_Handler, pNodeContext.get());
+	pServer->AddListener("/v1/stats/threads", ServerAPI::GetThreads_Handler, pNodeContext.get());
+	pServer->AddListener("/v1/stats/allocations", ServerAPI::GetAllocations_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/headers/", HeaderAPI::GetHeader_Handler, pNodeContext.get());
+	pServer->AddListener("/v1/headers", HeaderAPI::GetHeaders_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/blocks/", BlockAPI::GetBlock_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/chain/outputs/byids", ChainAPI::GetChainOutputsByIds_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/chain/outputs/byheight", ChainAPI::GetChainOutputsByHeight_Handler, pNodeContext.get());
+	pServer->AddListener("/v1/chain/lockprofile", ChainAPI::GetChainLockProfile_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/chain", ChainAPI::GetChain_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/peers/all", PeersAPI::GetAllPeers_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/peers/connected", PeersAPI::GetConnectedPeers_Handler, pNodeContext.get());
@@ -40,7 +57,9 @@ NodeRestServer::UPtr NodeRestServer::Create(const Config& config, std::shared_pt
 	pServer->AddListener("/v1/txhashset/lastoutputs", TxHashSetAPI::GetLastOutputs_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/txhashset/lastrangeproofs", TxHashSetAPI::GetLastRangeproofs_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/txhashset/outputs", TxHashSetAPI::GetOutputs_Handler, pNodeContext.get());
+	pServer->AddListener("/v1/txhashset/snapshot", TxHashSetAPI::ExportSnapshot_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/shutdown", Shutdown_Handler, pNodeContext.get());
+	pServer->AddListener("/metrics", ServerAPI::GetMetrics_Handler, pNodeContext.get());
 	pServer->AddListener("/v1/", ServerAPI::V1_Handler, pNodeContext.get());
 
 	return std::make_unique<NodeRestServer>(pNodeContext, std::move(pV2Server));
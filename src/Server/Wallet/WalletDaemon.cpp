@@ -40,7 +40,8 @@ std::unique_ptr<WalletDaemon> WalletDaemon::Create(
 
 	auto pOwnerServer = OwnerServer::Create(
 		pTorProcess,
-		pWalletManager
+		pWalletManager,
+		config.GetServerConfig().GetOwnerAPIConfig()
 	);
 
 	return std::make_unique<WalletDaemon>(
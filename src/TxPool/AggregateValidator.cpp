@@ -0,0 +1,186 @@
+#include "AggregateValidator.h"
+
+#include <Core/Exceptions/BadDataException.h>
+#include <Core/Validation/KernelSignatureValidator.h>
+#include <Core/Validation/KernelSumValidator.h>
+#include <Consensus/BlockWeight.h>
+#include <Common/Logger.h>
+#include <Crypto/Crypto.h>
+#include <Database/BlockDb.h>
+#include <algorithm>
+#include <numeric>
+
+AggregateValidator::AggregateValidator(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet)
+	: m_pBlockDB(pBlockDB), m_pTxHashSet(pTxHashSet)
+{
+
+}
+
+bool AggregateValidator::Add(const TransactionPtr& pTransaction, const bool kernelSignaturesVerified)
+{
+	std::vector<TransactionInput> chainInputs;
+	std::vector<Commitment> cutThrough;
+
+	try
+	{
+		Validate(*pTransaction, kernelSignaturesVerified, chainInputs, cutThrough);
+	}
+	catch (std::exception& e)
+	{
+		LOG_DEBUG_F("Transaction ({}) not valid in aggregate: {}", *pTransaction, e.what());
+		return false;
+	}
+
+	for (const Commitment& commitment : cutThrough)
+	{
+		m_outputs.erase(commitment);
+	}
+
+	for (const TransactionInput& input : chainInputs)
+	{
+		m_inputs.insert(input.GetCommitment());
+	}
+
+	const std::set<Commitment> ownInputs = [&pTransaction]() {
+		std::set<Commitment> commitments;
+		for (const TransactionInput& input : pTransaction->GetInputs())
+		{
+			commitments.insert(input.GetCommitment());
+		}
+
+		return commitments;
+	}();
+
+	for (const TransactionOutput& output : pTransaction->GetOutputs())
+	{
+		if (ownInputs.find(output.GetCommitment()) == ownInputs.end())
+		{
+			m_outputs.insert(output.GetCommitment());
+		}
+	}
+
+	for (const TransactionKernel& kernel : pTransaction->GetKernels())
+	{
+		m_kernels.insert(kernel.GetExcessCommitment());
+	}
+
+	return true;
+}
+
+void AggregateValidator::Validate(
+	const Transaction& transaction,
+	const bool kernelSignaturesVerified,
+	std::vector<TransactionInput>& chainInputs,
+	std::vector<Commitment>& cutThrough) const
+{
+	const std::vector<TransactionInput>& inputs = transaction.GetInputs();
+	const std::vector<TransactionOutput>& outputs = transaction.GetOutputs();
+	const std::vector<TransactionKernel>& kernels = transaction.GetKernels();
+
+	// Verify no output or kernel includes invalid features (coinbase)
+	const bool hasCoinbase = std::any_of(outputs.cbegin(), outputs.cend(), [](const TransactionOutput& output) { return output.IsCoinbase(); })
+		|| std::any_of(kernels.cbegin(), kernels.cend(), [](const TransactionKernel& kernel) { return kernel.IsCoinbase(); });
+	if (hasCoinbase)
+	{
+		throw BAD_DATA_EXCEPTION("Transaction contains coinbase outputs or kernels.");
+	}
+
+	std::set<Commitment> ownOutputs;
+	for (const TransactionOutput& output : outputs)
+	{
+		const Commitment& commitment = output.GetCommitment();
+		if (!ownOutputs.insert(commitment).second || m_outputs.count(commitment) > 0 || m_inputs.count(commitment) > 0)
+		{
+			throw BAD_DATA_EXCEPTION("Duplicate output.");
+		}
+	}
+
+	// Inputs spending outputs of the aggregate (or of the tx itself) are cut-through. The rest must spend distinct UTXOs.
+	std::set<Commitment> ownInputs;
+	size_t numOwnCutThrough = 0;
+	for (const TransactionInput& input : inputs)
+	{
+		const Commitment& commitment = input.GetCommitment();
+		if (!ownInputs.insert(commitment).second)
+		{
+			throw BAD_DATA_EXCEPTION("Duplicate input.");
+		}
+
+		if (ownOutputs.count(commitment) > 0)
+		{
+			++numOwnCutThrough;
+		}
+		else if (m_outputs.count(commitment) > 0)
+		{
+			cutThrough.push_back(commitment);
+		}
+		else if (m_inputs.count(commitment) > 0)
+		{
+			throw BAD_DATA_EXCEPTION("Input already spent by aggregate.");
+		}
+		else
+		{
+			chainInputs.push_back(input);
+		}
+	}
+
+	for (const TransactionKernel& kernel : kernels)
+	{
+		if (m_kernels.count(kernel.GetExcessCommitment()) > 0)
+		{
+			throw BAD_DATA_EXCEPTION("Duplicate kernel.");
+		}
+	}
+
+	// Verify the aggregate, after cut-through, is not too big. Checked as if it was a block, with an additional output and kernel for reward.
+	const uint64_t numInputs = m_inputs.size() + chainInputs.size();
+	const uint64_t numOutputs = m_outputs.size() - cutThrough.size() + outputs.size() - numOwnCutThrough + 1;
+	const uint64_t numKernels = m_kernels.size() + kernels.size() + 1;
+	const uint64_t weight = (numInputs * Consensus::BLOCK_INPUT_WEIGHT)
+		+ (numOutputs * Consensus::BLOCK_OUTPUT_WEIGHT)
+		+ (numKernels * Consensus::BLOCK_KERNEL_WEIGHT);
+	if (weight > Consensus::MAX_BLOCK_WEIGHT)
+	{
+		throw BAD_DATA_EXCEPTION("Aggregate weight invalid");
+	}
+
+	std::vector<Commitment> commitments;
+	commitments.reserve(outputs.size());
+
+	std::vector<const RangeProof*> rangeProofs;
+	rangeProofs.reserve(outputs.size());
+	for (const TransactionOutput& output : outputs)
+	{
+		commitments.push_back(output.GetCommitment());
+		rangeProofs.push_back(&output.GetRangeProof());
+	}
+
+	if (!Crypto::VerifyRangeProofs(commitments, rangeProofs))
+	{
+		throw BAD_DATA_EXCEPTION("Range proofs invalid.");
+	}
+
+	if (!kernelSignaturesVerified && !KernelSignatureValidator::VerifyKernelSignatures(kernels))
+	{
+		throw BAD_DATA_EXCEPTION("Kernel signatures invalid");
+	}
+
+	const int64_t overage = std::accumulate(
+		kernels.cbegin(),
+		kernels.cend(),
+		(int64_t)0,
+		[](int64_t overage, const TransactionKernel& kernel) { return overage + (int64_t)kernel.GetFee(); }
+	);
+	KernelSumValidator::ValidateKernelSums(transaction.GetBody(), overage, transaction.GetOffset(), std::nullopt);
+
+	// Validate the tx delta against current chain state.
+	// Check all inputs not cut-through are in the current UTXO set.
+	// Check all outputs are unique in current UTXO set.
+	std::vector<TransactionInput> utxoInputs = chainInputs;
+	std::vector<TransactionOutput> newOutputs = outputs;
+	Transaction delta(BlindingFactor(transaction.GetOffset()), TransactionBody(std::move(utxoInputs), std::move(newOutputs), {}));
+	if (!m_pTxHashSet->IsValid(m_pBlockDB, delta))
+	{
+		throw BAD_DATA_EXCEPTION("Inputs or outputs invalid for current UTXO set.");
+	}
+}
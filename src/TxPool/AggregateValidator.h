@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Core/Models/Transaction.h>
+#include <PMMR/TxHashSet.h>
+#include <Crypto/Commitment.h>
+#include <set>
+
+// Forward Declarations
+class IBlockDB;
+
+//
+// Validates transactions one at a time as additions to a running aggregate.
+// Accepting a transaction is equivalent to aggregating it with everything accepted so far and fully validating the result,
+// but only the delta contributed by the new transaction is checked:
+//   * its own range proofs, kernel signatures and kernel sums (sums are additive, so balanced txs make a balanced aggregate)
+//   * its inputs, which must either spend an output of the aggregate (cut-through) or an unspent output not already spent by the aggregate
+//   * its outputs and kernels, which must not already exist in the aggregate or the UTXO set
+//   * the weight of the aggregate after cut-through
+//
+class AggregateValidator
+{
+public:
+	AggregateValidator(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet);
+
+	//
+	// Adds the transaction to the aggregate and returns true if the aggregate remains valid.
+	// Otherwise, returns false and leaves the aggregate unchanged.
+	// Kernel signature verification is skipped when the caller has already batch verified them.
+	//
+	bool Add(const TransactionPtr& pTransaction, const bool kernelSignaturesVerified);
+
+private:
+	void Validate(const Transaction& transaction, const bool kernelSignaturesVerified, std::vector<TransactionInput>& chainInputs, std::vector<Commitment>& cutThrough) const;
+
+	std::shared_ptr<const IBlockDB> m_pBlockDB;
+	ITxHashSetConstPtr m_pTxHashSet;
+
+	// Outputs created by the aggregate that it hasn't spent itself.
+	std::set<Commitment> m_outputs;
+
+	// UTXOs spent by the aggregate.
+	std::set<Commitment> m_inputs;
+
+	std::set<Commitment> m_kernels;
+};
@@ -0,0 +1,140 @@
+#include "BlockTemplateBuilder.h"
+
+#include <Core/Util/FeeUtil.h>
+#include <Core/Util/TransactionUtil.h>
+#include <Database/BlockDb.h>
+#include <Common/Logger.h>
+#include <algorithm>
+#include <chrono>
+
+void BlockTemplateBuilder::AddTransaction(const TransactionPtr& pTransaction)
+{
+	if (m_dirty || m_pAggregate == nullptr)
+	{
+		return;
+	}
+
+	if (!TryAdd(pTransaction))
+	{
+		// It may have been rejected only because the block is full, in which case it should displace cheaper txs.
+		const double feeRate = (double)FeeUtil::CalculateActualFee(*pTransaction) / FeeUtil::CalculateTxWeight(*pTransaction);
+		if (feeRate > m_minFeeRate)
+		{
+			m_dirty = true;
+		}
+	}
+}
+
+BlockTemplate::CPtr BlockTemplateBuilder::GetTemplate(
+	const Pool& memPool,
+	std::shared_ptr<const IBlockDB> pBlockDB,
+	ITxHashSetConstPtr pTxHashSet,
+	const BlockHeaderPtr& pTipHeader)
+{
+	if (m_dirty || m_pTipHeader == nullptr || m_pTipHeader->GetHash() != pTipHeader->GetHash())
+	{
+		Rebuild(memPool, pBlockDB, pTxHashSet, pTipHeader);
+	}
+
+	if (m_pTemplate == nullptr)
+	{
+		// Only the txs appended since the last request need to be aggregated.
+		if (m_numAggregated < m_selected.size())
+		{
+			std::vector<TransactionPtr> transactions;
+			if (m_pAggregateTx != nullptr)
+			{
+				transactions.push_back(m_pAggregateTx);
+			}
+
+			transactions.insert(transactions.end(), m_selected.cbegin() + m_numAggregated, m_selected.cend());
+			m_pAggregateTx = TransactionUtil::Aggregate(transactions);
+			m_numAggregated = m_selected.size();
+		}
+
+		m_pTemplate = std::make_shared<const BlockTemplate>(m_pTipHeader, m_pAggregateTx, m_selected.size(), m_fees);
+	}
+
+	return m_pTemplate;
+}
+
+void BlockTemplateBuilder::Rebuild(
+	const Pool& memPool,
+	std::shared_ptr<const IBlockDB> pBlockDB,
+	ITxHashSetConstPtr pTxHashSet,
+	const BlockHeaderPtr& pTipHeader)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	m_pTipHeader = pTipHeader;
+	m_pAggregate = std::make_unique<AggregateValidator>(pBlockDB, pTxHashSet);
+	m_selected.clear();
+	m_fees = 0;
+	m_minFeeRate = 0.0;
+	m_pAggregateTx = nullptr;
+	m_numAggregated = 0;
+	m_pTemplate = nullptr;
+	m_dirty = false;
+
+	// A tx that pays more than its parent is visited first, so it's retried once its parent has been selected.
+	std::vector<TransactionPtr> deferred;
+	for (const TransactionPtr& pTransaction : memPool.GetTransactionsByFeeRate())
+	{
+		if (!TryAdd(pTransaction))
+		{
+			const bool spendsPoolOutput = std::any_of(
+				pTransaction->GetInputs().cbegin(),
+				pTransaction->GetInputs().cend(),
+				[&memPool](const TransactionInput& input) { return memPool.FindTransactionByOutput(input.GetCommitment()) != nullptr; }
+			);
+			if (spendsPoolOutput)
+			{
+				deferred.push_back(pTransaction);
+			}
+		}
+	}
+
+	bool progress = true;
+	while (progress && !deferred.empty())
+	{
+		progress = false;
+		auto iter = deferred.begin();
+		while (iter != deferred.end())
+		{
+			if (TryAdd(*iter))
+			{
+				iter = deferred.erase(iter);
+				progress = true;
+			}
+			else
+			{
+				++iter;
+			}
+		}
+	}
+
+	LOG_DEBUG_F(
+		"Built block template on {} with {} txs in {}ms",
+		*pTipHeader,
+		m_selected.size(),
+		std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count()
+	);
+}
+
+bool BlockTemplateBuilder::TryAdd(const TransactionPtr& pTransaction)
+{
+	// Kernel signatures were verified when the tx was added to the pool.
+	if (!m_pAggregate->Add(pTransaction, true))
+	{
+		return false;
+	}
+
+	const uint64_t fee = FeeUtil::CalculateActualFee(*pTransaction);
+	const double feeRate = (double)fee / FeeUtil::CalculateTxWeight(*pTransaction);
+
+	m_minFeeRate = m_selected.empty() ? feeRate : (std::min)(m_minFeeRate, feeRate);
+	m_selected.push_back(pTransaction);
+	m_fees += fee;
+	m_pTemplate = nullptr;
+	return true;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Pool.h"
+#include "AggregateValidator.h"
+
+#include <TxPool/BlockTemplate.h>
+#include <Core/Models/BlockHeader.h>
+#include <Core/Models/Transaction.h>
+#include <PMMR/TxHashSet.h>
+#include <memory>
+#include <vector>
+
+// Forward Declarations
+class IBlockDB;
+
+//
+// Maintains the block template for the mempool, selecting transactions by fee rate until the block is full.
+//
+// The template is only rebuilt from scratch after a block is connected, or when a newly added transaction pays more
+// than what's already selected but doesn't fit. Otherwise, new mempool transactions are validated against the running
+// aggregate and appended, and the aggregate transaction is only extended with them when a template is requested.
+// Callers must serialize access, which TransactionPool does with its mutex.
+//
+class BlockTemplateBuilder
+{
+public:
+	//
+	// Forces a rebuild on the next request, eg. after transactions were removed from the mempool.
+	//
+	void Invalidate() noexcept { m_dirty = true; }
+
+	//
+	// Appends a transaction just added to the mempool to the template, if it's still valid with it and it fits.
+	//
+	void AddTransaction(const TransactionPtr& pTransaction);
+
+	BlockTemplate::CPtr GetTemplate(
+		const Pool& memPool,
+		std::shared_ptr<const IBlockDB> pBlockDB,
+		ITxHashSetConstPtr pTxHashSet,
+		const BlockHeaderPtr& pTipHeader
+	);
+
+private:
+	void Rebuild(
+		const Pool& memPool,
+		std::shared_ptr<const IBlockDB> pBlockDB,
+		ITxHashSetConstPtr pTxHashSet,
+		const BlockHeaderPtr& pTipHeader
+	);
+	bool TryAdd(const TransactionPtr& pTransaction);
+
+	bool m_dirty = true;
+	BlockHeaderPtr m_pTipHeader;
+	std::unique_ptr<AggregateValidator> m_pAggregate;
+
+	std::vector<TransactionPtr> m_selected;
+	uint64_t m_fees = 0;
+	double m_minFeeRate = 0.0;
+
+	// The aggregate of the first m_numAggregated selected transactions.
+	TransactionPtr m_pAggregateTx;
+	size_t m_numAggregated = 0;
+
+	BlockTemplate::CPtr m_pTemplate;
+};
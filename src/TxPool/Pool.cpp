@@ -1,218 +1,505 @@
 #include "Pool.h"
-#include "ValidTransactionFinder.h"
+#include "ShortIdIndex.h"
 
 #include <Core/Util/TransactionUtil.h>
+#include <Common/AllocProfiler.h>
 #include <Common/Util/VectorUtil.h>
 #include <Common/Logger.h>
+#include <Common/Tracer.h>
+#include <Crypto/CSPRNG.h>
 #include <algorithm>
+#include <chrono>
+#include <iterator>
 #include <unordered_map>
+#include <unordered_set>
 
 std::vector<TransactionPtr> Pool::GetTransactionsByShortId(const Hash& hash, const uint64_t nonce, const std::set<ShortId>& missingShortIds) const
 {
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
+	const ShortIdIndex index = ShortIdIndex::Build(GetTransactions(), hash, nonce);
+
 	std::vector<TransactionPtr> transactionsFound;
-	for (const TxPoolEntry& txPoolEntry : m_transactions)
+	transactionsFound.reserve(missingShortIds.size());
+	for (const ShortId& shortId : missingShortIds)
 	{
-		for (const TransactionKernel& kernel : txPoolEntry.GetTransaction()->GetKernels())
+		TransactionPtr pTransaction = index.Find(shortId);
+		if (pTransaction != nullptr)
 		{
-			const ShortId shortId = ShortId::Create(kernel.GetHash(), hash, nonce);
-			if (missingShortIds.find(shortId) != missingShortIds.cend())
-			{
-				transactionsFound.push_back(txPoolEntry.GetTransaction());
-
-				if (transactionsFound.size() == missingShortIds.size())
-				{
-					return transactionsFound;
-				}
-			}
+			transactionsFound.push_back(pTransaction);
 		}
 	}
 
+	LOG_DEBUG_F("Found {}/{} short ids in {} kernels", transactionsFound.size(), missingShortIds.size(), index.GetNumKernels());
 	return transactionsFound;
 }
 
-void Pool::AddTransaction(TransactionPtr pTransaction, const EDandelionStatus status)
+std::vector<TransactionPtr> Pool::AddTransaction(TransactionPtr pTransaction, const EDandelionStatus status)
 {
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
+	if (m_entryByTxHash.find(pTransaction->GetHash()) != m_entryByTxHash.cend())
+	{
+		LOG_DEBUG_F("Transaction already in pool: {}", pTransaction->GetHash());
+		return {};
+	}
+
 	LOG_DEBUG_F("Transaction added: {}", pTransaction->GetHash());
 
-	m_transactions.emplace_back(TxPoolEntry(pTransaction, status, std::time_t()));
+	const uint64_t entryId = m_nextEntryId++;
+	const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	auto iter = m_entries.emplace(entryId, TxPoolEntry(pTransaction, status, now)).first;
+	if (m_embargoSeconds > 0)
+	{
+		iter->second.SetEmbargoExpiration(now + m_embargoSeconds + (std::time_t)CSPRNG::GenerateRandom(0, 30));
+	}
+
+	Index(entryId, iter->second);
+
+	return EvictToFit();
+}
+
+std::vector<TransactionPtr> Pool::SetMaxBytes(const size_t maxBytes)
+{
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
+	m_maxBytes = maxBytes;
+	return EvictToFit();
+}
+
+PoolStats Pool::GetStats() const
+{
+	return PoolStats{ m_entries.size(), m_memoryUsage, m_maxBytes, m_numEvicted };
 }
 
 bool Pool::ContainsTransaction(const Transaction& transaction) const
 {
-	for (const TxPoolEntry& txPoolEntry : m_transactions)
+	auto iter = m_entryByTxHash.find(transaction.GetHash());
+	if (iter == m_entryByTxHash.cend())
 	{
-		if (*txPoolEntry.GetTransaction() == transaction)
-		{
-			return true;
-		}
+		return false;
 	}
 
-	return false;
+	return *m_entries.at(iter->second).GetTransaction() == transaction;
 }
 
 std::vector<TransactionPtr> Pool::FindTransactionsByKernel(const std::set<TransactionKernel>& kernels) const
 {
-	std::set<TransactionPtr> transactionSet;
-	for (const TxPoolEntry& txPoolEntry : m_transactions)
+	FlatHashSet<uint64_t> entryIds;
+	std::vector<TransactionPtr> transactions;
+	for (const TransactionKernel& kernel : kernels)
 	{
-		for (const TransactionKernel& kernel : txPoolEntry.GetTransaction()->GetKernels())
+		auto range = m_entriesByKernelHash.equal_range(kernel.GetHash());
+		for (auto iter = range.first; iter != range.second; iter++)
 		{
-			if (kernels.count(kernel) > 0)
+			if (entryIds.insert(iter->second).second)
 			{
-				transactionSet.insert(txPoolEntry.GetTransaction());
+				transactions.push_back(m_entries.at(iter->second).GetTransaction());
 			}
 		}
 	}
 
+	return transactions;
+}
+
+TransactionPtr Pool::FindTransactionByKernelHash(const Hash& kernelHash) const
+{
+	auto iter = m_entriesByKernelHash.find(kernelHash);
+	if (iter != m_entriesByKernelHash.cend())
+	{
+		return m_entries.at(iter->second).GetTransaction();
+	}
+
+	return nullptr;
+}
+
+std::vector<TransactionPtr> Pool::GetTransactionsByFeeRate() const
+{
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
 	std::vector<TransactionPtr> transactions;
-	std::copy(transactionSet.begin(), transactionSet.end(), std::back_inserter(transactions));
+	transactions.reserve(m_entriesByFeeRate.size());
+	for (const FeeRateKey& key : m_entriesByFeeRate)
+	{
+		transactions.push_back(m_entries.at(key.entryId).GetTransaction());
+	}
 
 	return transactions;
 }
 
-TransactionPtr Pool::FindTransactionByKernelHash(const Hash& kernelHash) const
+TransactionPtr Pool::FindTransactionByOutput(const Commitment& outputCommitment) const
 {
-	for (const TxPoolEntry& txPoolEntry : m_transactions)
+	auto iter = m_entriesByOutput.find(outputCommitment);
+	if (iter != m_entriesByOutput.cend())
 	{
-		for (const TransactionKernel& kernel : txPoolEntry.GetTransaction()->GetKernels())
-		{
-			if (kernel.GetHash() == kernelHash)
-			{
-				return txPoolEntry.GetTransaction();
-			}
-		}
+		return m_entries.at(iter->second).GetTransaction();
 	}
 
 	return nullptr;
 }
 
+std::vector<TransactionPtr> Pool::FindTransactionsByInput(const Commitment& inputCommitment) const
+{
+	std::vector<TransactionPtr> transactions;
+
+	auto range = m_entriesByInput.equal_range(inputCommitment);
+	for (auto iter = range.first; iter != range.second; iter++)
+	{
+		transactions.push_back(m_entries.at(iter->second).GetTransaction());
+	}
+
+	return transactions;
+}
+
 std::vector<TransactionPtr> Pool::FindTransactionsByStatus(const EDandelionStatus status) const
 {
 	std::vector<TransactionPtr> transactions;
-	for (const TxPoolEntry& txPoolEntry : m_transactions)
+
+	auto bucketIter = m_entriesByStatus.find(status);
+	if (bucketIter != m_entriesByStatus.cend())
 	{
-		if (txPoolEntry.GetStatus() == status)
+		for (const uint64_t entryId : bucketIter->second)
 		{
-			transactions.push_back(txPoolEntry.GetTransaction());
+			transactions.push_back(m_entries.at(entryId).GetTransaction());
 		}
 	}
 
 	return transactions;
 }
 
-std::vector<TransactionPtr> Pool::GetExpiredTransactions(const uint16_t embargoSeconds) const
+// Entry ids increase as transactions are added, so the first entry in the bucket is the oldest.
+std::optional<std::time_t> Pool::GetOldestTimestamp(const EDandelionStatus status) const
 {
-	const std::time_t cutoff = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now() - std::chrono::seconds(embargoSeconds));
+	auto bucketIter = m_entriesByStatus.find(status);
+	if (bucketIter == m_entriesByStatus.cend() || bucketIter->second.empty())
+	{
+		return std::nullopt;
+	}
+
+	return std::make_optional(m_entries.at(*bucketIter->second.cbegin()).GetTimestamp());
+}
+
+std::vector<TransactionPtr> Pool::TakeExpiredTransactions(const std::time_t now, const std::time_t retryTime)
+{
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
+	std::vector<std::pair<std::time_t, uint64_t>> expired;
+	for (auto iter = m_entriesByEmbargoExpiration.cbegin(); iter != m_entriesByEmbargoExpiration.cend() && iter->first <= now; iter++)
+	{
+		expired.push_back(*iter);
+	}
 
 	std::vector<TransactionPtr> transactions;
-	for (const TxPoolEntry& txPoolEntry : m_transactions)
+	transactions.reserve(expired.size());
+	for (const auto& expiration : expired)
 	{
-		if (txPoolEntry.GetTimestamp() < cutoff)
-		{
-			transactions.push_back(txPoolEntry.GetTransaction());
-		}
+		TxPoolEntry& entry = m_entries.at(expiration.second);
+		transactions.push_back(entry.GetTransaction());
+
+		m_entriesByEmbargoExpiration.erase(expiration);
+		entry.SetEmbargoExpiration(retryTime);
+		m_entriesByEmbargoExpiration.insert({ retryTime, expiration.second });
 	}
 
 	return transactions;
 }
 
-void Pool::RemoveTransaction(const Transaction& transaction)
+std::optional<std::time_t> Pool::GetNextEmbargoExpiration() const
 {
-	auto iter = m_transactions.begin();
-	while (iter != m_transactions.end())
+	if (m_entriesByEmbargoExpiration.empty())
 	{
-		if (transaction == *iter->GetTransaction())
-		{
-			m_transactions.erase(iter);
-			break;
-		}
+		return std::nullopt;
+	}
+
+	return std::make_optional(m_entriesByEmbargoExpiration.cbegin()->first);
+}
 
-		++iter;
+void Pool::RemoveTransaction(const Transaction& transaction)
+{
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
+	auto hashIter = m_entryByTxHash.find(transaction.GetHash());
+	if (hashIter != m_entryByTxHash.end())
+	{
+		Erase(m_entries.find(hashIter->second));
 	}
 }
 
 // Quick reconciliation step - we can evict any txs in the pool where
-// inputs or kernels intersect with the block.
-void Pool::ReconcileBlock(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet, const FullBlock& block, TransactionPtr pMemPoolAggTx)
+// inputs, outputs or kernels intersect with the block, along with their dependents.
+Pool::Reconciliation Pool::ReconcileBlock(const FullBlock& block, const std::vector<TransactionPtr>& removedParents)
 {
-	std::vector<TransactionPtr> filteredTransactions;
-	std::unordered_map<Hash, TxPoolEntry> filteredEntriesByHash;
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
+	TRACE_SPAN("Pool::ReconcileBlock");
+
+	std::unordered_set<Commitment> blockOutputs;
+	for (const TransactionOutput& output : block.GetOutputs())
+	{
+		blockOutputs.insert(output.GetCommitment());
+	}
+
+	FlatHashSet<Hash> blockKernels;
+	for (const TransactionKernel& kernel : block.GetKernels())
+	{
+		blockKernels.insert(kernel.GetHash());
+	}
+
+	// Outputs of removed txs, which the pool txs that remain can no longer spend.
+	std::vector<Commitment> lostOutputs;
+	for (const TransactionPtr& pParent : removedParents)
+	{
+		AddOutputs(*pParent, lostOutputs);
+	}
+
+	Reconciliation reconciliation;
 
-	// Filter txs in the pool based on the latest block.
 	// Reject any txs where we see a matching tx kernel in the block.
 	// Also reject any txs where we see a conflicting tx,
 	// where an input is spent in a different tx.
-	for (auto& txPoolEntry : m_transactions)
+	for (const uint64_t entryId : FindConflicts(block))
 	{
-		if (!ShouldEvict(*txPoolEntry.GetTransaction(), block))
-		{
-			filteredTransactions.push_back(txPoolEntry.GetTransaction());
-			filteredEntriesByHash.insert(std::pair<Hash, TxPoolEntry>(txPoolEntry.GetTransaction()->GetHash(), txPoolEntry));
-		}
+		auto iter = m_entries.find(entryId);
+		TransactionPtr pTransaction = iter->second.GetTransaction();
+
+		const bool mined = std::any_of(
+			pTransaction->GetKernels().cbegin(),
+			pTransaction->GetKernels().cend(),
+			[&blockKernels](const TransactionKernel& kernel) { return blockKernels.count(kernel.GetHash()) > 0; }
+		);
+		(mined ? reconciliation.mined : reconciliation.evicted).push_back(pTransaction);
+
+		AddOutputs(*pTransaction, lostOutputs);
+		Erase(iter);
 	}
 
-	m_transactions.clear();
+	// Then reject the descendants of anything removed, unless the block created the output they spend.
+	EvictDependents(std::move(lostOutputs), blockOutputs, reconciliation.evicted);
 
-	std::vector<TransactionPtr> validTransactions = ValidTransactionFinder::FindValidTransactions(pBlockDB, pTxHashSet, filteredTransactions, pMemPoolAggTx);
-	for (auto& pTransaction : validTransactions)
-	{
-		const TxPoolEntry& txPoolEntry = filteredEntriesByHash.at(pTransaction->GetHash());
-		m_transactions.push_back(txPoolEntry);
-	}
+	return reconciliation;
 }
 
 void Pool::ChangeStatus(const std::vector<TransactionPtr>& transactions, const EDandelionStatus status)
 {
-	for (auto& txPoolEntry : m_transactions)
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
+	for (auto& pTransaction : transactions)
 	{
-		for (auto& transaction : transactions)
+		auto hashIter = m_entryByTxHash.find(pTransaction->GetHash());
+		if (hashIter == m_entryByTxHash.end())
 		{
-			if (txPoolEntry.GetTransaction() == transaction)
-			{
-				txPoolEntry.SetStatus(status);
-				break;
-			}
+			continue;
 		}
+
+		TxPoolEntry& entry = m_entries.at(hashIter->second);
+		m_entriesByStatus[entry.GetStatus()].erase(hashIter->second);
+		entry.SetStatus(status);
+		m_entriesByStatus[status].insert(hashIter->second);
 	}
 }
 
-bool Pool::ShouldEvict(const Transaction& transaction, const FullBlock& block) const
+// Looks up each of the block's inputs, outputs, and kernels in the indexes,
+// so finding conflicts depends only on the size of the block, not the size of the pool.
+// Outputs are included since a pool tx creating an output the block already created can never become valid.
+std::set<uint64_t> Pool::FindConflicts(const FullBlock& block) const
 {
-	const std::vector<TransactionInput>& blockInputs = block.GetInputs();
-	for (const TransactionInput& input : transaction.GetInputs())
+	std::set<uint64_t> conflicts;
+
+	for (const TransactionInput& input : block.GetInputs())
 	{
-		if (std::find(blockInputs.begin(), blockInputs.end(), input) != blockInputs.end())
+		auto range = m_entriesByInput.equal_range(input.GetCommitment());
+		for (auto iter = range.first; iter != range.second; iter++)
 		{
-			return true;
+			conflicts.insert(iter->second);
 		}
 	}
 
-	const std::vector<TransactionKernel>& blockKernels = block.GetKernels();
-	for (const TransactionKernel& kernel : transaction.GetKernels())
+	for (const TransactionOutput& output : block.GetOutputs())
 	{
-		if (std::find(blockKernels.begin(), blockKernels.end(), kernel) != blockKernels.end())
+		auto range = m_entriesByOutput.equal_range(output.GetCommitment());
+		for (auto iter = range.first; iter != range.second; iter++)
 		{
-			return true;
+			conflicts.insert(iter->second);
 		}
 	}
 
-	return false;
+	for (const TransactionKernel& kernel : block.GetKernels())
+	{
+		auto range = m_entriesByKernelHash.equal_range(kernel.GetHash());
+		for (auto iter = range.first; iter != range.second; iter++)
+		{
+			conflicts.insert(iter->second);
+		}
+	}
+
+	return conflicts;
 }
 
 TransactionPtr Pool::Aggregate() const
 {
-	if (m_transactions.empty())
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
+
+	if (m_entries.empty())
 	{
 		return nullptr;
 	}
 
-	LOG_INFO_F("Aggregating {} transactions", m_transactions.size());
+	LOG_INFO_F("Aggregating {} transactions", m_entries.size());
+
+	return TransactionUtil::Aggregate(GetTransactions());
+}
+
+void Pool::Clear()
+{
+	m_entries.clear();
+	m_entryByTxHash.clear();
+	m_entriesByKernelHash.clear();
+	m_entriesByInput.clear();
+	m_entriesByOutput.clear();
+	m_entriesByStatus.clear();
+	m_entriesByFeeRate.clear();
+	m_entriesByEmbargoExpiration.clear();
+	m_memoryUsage = 0;
+}
+
+std::vector<TransactionPtr> Pool::GetTransactions() const
+{
+	ScopedAllocTag allocTag(EAllocTag::TXPOOL);
 
 	std::vector<TransactionPtr> transactions;
-	for (const TxPoolEntry& entry : m_transactions)
+	transactions.reserve(m_entries.size());
+	for (const auto& entry : m_entries)
 	{
-		transactions.push_back(entry.GetTransaction());
+		transactions.push_back(entry.second.GetTransaction());
+	}
+
+	return transactions;
+}
+
+void Pool::Index(const uint64_t entryId, const TxPoolEntry& entry)
+{
+	const Transaction& transaction = *entry.GetTransaction();
+
+	m_entryByTxHash[transaction.GetHash()] = entryId;
+	for (const TransactionKernel& kernel : transaction.GetKernels())
+	{
+		m_entriesByKernelHash.emplace(kernel.GetHash(), entryId);
+	}
+
+	for (const TransactionInput& input : transaction.GetInputs())
+	{
+		m_entriesByInput.emplace(input.GetCommitment(), entryId);
+	}
+
+	for (const TransactionOutput& output : transaction.GetOutputs())
+	{
+		m_entriesByOutput.emplace(output.GetCommitment(), entryId);
+	}
+
+	m_entriesByStatus[entry.GetStatus()].insert(entryId);
+	m_entriesByFeeRate.insert(FeeRateKey{ entry.GetFeeRate(), entryId });
+	if (entry.GetEmbargoExpiration() > 0)
+	{
+		m_entriesByEmbargoExpiration.insert({ entry.GetEmbargoExpiration(), entryId });
+	}
+
+	m_memoryUsage += entry.GetMemoryUsage();
+}
+
+void Pool::Unindex(const uint64_t entryId, const TxPoolEntry& entry)
+{
+	const Transaction& transaction = *entry.GetTransaction();
+
+	m_entryByTxHash.erase(transaction.GetHash());
+	for (const TransactionKernel& kernel : transaction.GetKernels())
+	{
+		EraseIndex(m_entriesByKernelHash, kernel.GetHash(), entryId);
+	}
+
+	for (const TransactionInput& input : transaction.GetInputs())
+	{
+		EraseIndex(m_entriesByInput, input.GetCommitment(), entryId);
+	}
+
+	for (const TransactionOutput& output : transaction.GetOutputs())
+	{
+		EraseIndex(m_entriesByOutput, output.GetCommitment(), entryId);
 	}
 
-	return TransactionUtil::Aggregate(transactions);
+	m_entriesByStatus[entry.GetStatus()].erase(entryId);
+	m_entriesByFeeRate.erase(FeeRateKey{ entry.GetFeeRate(), entryId });
+	m_entriesByEmbargoExpiration.erase({ entry.GetEmbargoExpiration(), entryId });
+	m_memoryUsage -= entry.GetMemoryUsage();
+}
+
+std::vector<TransactionPtr> Pool::EvictToFit()
+{
+	std::vector<TransactionPtr> evicted;
+	while (m_maxBytes > 0 && m_memoryUsage > m_maxBytes && !m_entriesByFeeRate.empty())
+	{
+		auto iter = m_entries.find(std::prev(m_entriesByFeeRate.end())->entryId);
+		TransactionPtr pTransaction = iter->second.GetTransaction();
+		LOG_DEBUG_F("Evicting transaction ({}) with fee rate {} to stay within {} bytes", *pTransaction, iter->second.GetFeeRate(), m_maxBytes);
+
+		std::vector<Commitment> lostOutputs;
+		AddOutputs(*pTransaction, lostOutputs);
+		evicted.push_back(pTransaction);
+		Erase(iter);
+
+		EvictDependents(std::move(lostOutputs), {}, evicted);
+	}
+
+	m_numEvicted += evicted.size();
+	return evicted;
+}
+
+void Pool::EvictDependents(std::vector<Commitment>&& lostOutputs, const std::unordered_set<Commitment>& recreatedOutputs, std::vector<TransactionPtr>& evicted)
+{
+	while (!lostOutputs.empty())
+	{
+		const Commitment commitment = lostOutputs.back();
+		lostOutputs.pop_back();
+		if (recreatedOutputs.count(commitment) > 0)
+		{
+			continue;
+		}
+
+		std::vector<uint64_t> dependents;
+		auto range = m_entriesByInput.equal_range(commitment);
+		for (auto iter = range.first; iter != range.second; iter++)
+		{
+			dependents.push_back(iter->second);
+		}
+
+		for (const uint64_t entryId : dependents)
+		{
+			auto iter = m_entries.find(entryId);
+			if (iter != m_entries.end())
+			{
+				TransactionPtr pTransaction = iter->second.GetTransaction();
+				LOG_DEBUG_F("Evicting transaction ({}) spending removed output {}", *pTransaction, commitment);
+
+				evicted.push_back(pTransaction);
+				AddOutputs(*pTransaction, lostOutputs);
+				Erase(iter);
+			}
+		}
+	}
+}
+
+void Pool::AddOutputs(const Transaction& transaction, std::vector<Commitment>& commitments)
+{
+	for (const TransactionOutput& output : transaction.GetOutputs())
+	{
+		commitments.push_back(output.GetCommitment());
+	}
+}
+
+void Pool::Erase(EntryMap::iterator iter)
+{
+	if (iter != m_entries.end())
+	{
+		Unindex(iter->first, iter->second);
+		m_entries.erase(iter);
+	}
 }
\ No newline at end of file
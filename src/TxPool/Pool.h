@@ -3,6 +3,7 @@
 #include "TxPoolEntry.h"
 
 #include <TxPool/DandelionStatus.h>
+#include <TxPool/PoolStats.h>
 #include <Core/Models/Transaction.h>
 #include <Core/Models/TransactionKernel.h>
 #include <Core/Models/FullBlock.h>
@@ -10,23 +11,47 @@
 #include <Config/Config.h>
 #include <PMMR/TxHashSetManager.h>
 #include <Crypto/Hash.h>
+#include <Crypto/Commitment.h>
+#include <Common/FlatHashMap.h>
+#include <ctime>
+#include <map>
+#include <optional>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 
 class Pool
 {
 public:
+	//
+	// The transactions removed from the pool by ReconcileBlock.
+	//
+	struct Reconciliation
+	{
+		// Transactions sharing a kernel with the block.
+		std::vector<TransactionPtr> mined;
+
+		// Transactions that conflict with the block, or that spend an output of a removed transaction the block didn't create.
+		std::vector<TransactionPtr> evicted;
+	};
+
 	Pool() = default;
 	~Pool() = default;
 
-	void AddTransaction(TransactionPtr pTransaction, const EDandelionStatus status);
+	//
+	// Adds the transaction, then evicts the lowest fee rate transactions (and their dependents) until the pool is within its budget.
+	// Returns the evicted transactions, which may include the one just added.
+	//
+	std::vector<TransactionPtr> AddTransaction(TransactionPtr pTransaction, const EDandelionStatus status);
 	bool ContainsTransaction(const Transaction& transaction) const;
 	void RemoveTransaction(const Transaction& transaction);
-	void ReconcileBlock(
-		std::shared_ptr<const IBlockDB> pBlockDB,
-		ITxHashSetConstPtr pTxHashSet,
-		const FullBlock& block,
-		TransactionPtr pMemPoolAggTx
-	);
+
+	//
+	// Removes the transactions that conflict with the block's inputs, outputs or kernels, followed by every transaction that depends on
+	// an output of a removed transaction (or of removedParents, from another pool) that the block didn't create.
+	// Every other transaction is unaffected by the block, so is neither touched nor revalidated.
+	//
+	Reconciliation ReconcileBlock(const FullBlock& block, const std::vector<TransactionPtr>& removedParents);
 	void ChangeStatus(const std::vector<TransactionPtr>& transactions, const EDandelionStatus status);
 
 	std::vector<TransactionPtr> GetTransactionsByShortId(
@@ -37,13 +62,106 @@ public:
 	std::vector<TransactionPtr> FindTransactionsByKernel(const std::set<TransactionKernel>& kernels) const;
 	TransactionPtr FindTransactionByKernelHash(const Hash& kernelHash) const;
 	std::vector<TransactionPtr> FindTransactionsByStatus(const EDandelionStatus status) const;
-	std::vector<TransactionPtr> GetExpiredTransactions(const uint16_t embargoSeconds) const;
+
+	//
+	// Returns when the oldest transaction with the given status was added, or nullopt if there are none.
+	//
+	std::optional<std::time_t> GetOldestTimestamp(const EDandelionStatus status) const;
+
+	//
+	// Returns the transactions whose embargo had expired by the given time, only visiting those entries.
+	// Their embargo is pushed back to retryTime, so they're returned again then if they're still in the pool, eg. because they couldn't be fluffed.
+	//
+	std::vector<TransactionPtr> TakeExpiredTransactions(const std::time_t now, const std::time_t retryTime);
+	std::optional<std::time_t> GetNextEmbargoExpiration() const;
+
+	//
+	// Returns every transaction, the highest fee per unit of weight first.
+	//
+	std::vector<TransactionPtr> GetTransactionsByFeeRate() const;
+
+	//
+	// Returns every transaction, in the order they were added.
+	//
+	std::vector<TransactionPtr> GetTransactions() const;
+
+	TransactionPtr FindTransactionByOutput(const Commitment& outputCommitment) const;
+	std::vector<TransactionPtr> FindTransactionsByInput(const Commitment& inputCommitment) const;
 
 	TransactionPtr Aggregate() const;
-	void Clear() { m_transactions.clear(); }
+	void Clear();
+
+	//
+	// Limits the estimated memory used by the pool. 0 means unbounded.
+	// Returns the transactions evicted (lowest fee rate first) to fit.
+	//
+	std::vector<TransactionPtr> SetMaxBytes(const size_t maxBytes);
+
+	//
+	// Starts an embargo timer of embargoSeconds, plus up to 30 random seconds, for each transaction added from now on. 0 disables embargoes.
+	//
+	void SetEmbargo(const uint16_t embargoSeconds) noexcept { m_embargoSeconds = embargoSeconds; }
+	PoolStats GetStats() const;
 
 private:
-	bool ShouldEvict(const Transaction& transaction, const FullBlock& block) const;
+	using EntryMap = std::map<uint64_t, TxPoolEntry>;
+
+	//
+	// Orders entries by fee rate, highest first, and then by the order they were added in.
+	//
+	struct FeeRateKey
+	{
+		double feeRate;
+		uint64_t entryId;
+
+		bool operator<(const FeeRateKey& other) const noexcept
+		{
+			return feeRate != other.feeRate ? feeRate > other.feeRate : entryId < other.entryId;
+		}
+	};
+
+	std::set<uint64_t> FindConflicts(const FullBlock& block) const;
+
+	void Index(const uint64_t entryId, const TxPoolEntry& entry);
+	void Unindex(const uint64_t entryId, const TxPoolEntry& entry);
+	void Erase(EntryMap::iterator iter);
+
+	std::vector<TransactionPtr> EvictToFit();
+	void EvictDependents(std::vector<Commitment>&& lostOutputs, const std::unordered_set<Commitment>& recreatedOutputs, std::vector<TransactionPtr>& evicted);
+	static void AddOutputs(const Transaction& transaction, std::vector<Commitment>& commitments);
+
+	template<typename K>
+	static void EraseIndex(std::unordered_multimap<K, uint64_t>& index, const K& key, const uint64_t entryId)
+	{
+		auto range = index.equal_range(key);
+		for (auto iter = range.first; iter != range.second; iter++)
+		{
+			if (iter->second == entryId)
+			{
+				index.erase(iter);
+				return;
+			}
+		}
+	}
+
+	//
+	// Entries are keyed by an increasing id, so iterating them preserves the order transactions were added in,
+	// which ValidTransactionFinder relies on when one transaction spends the output of another.
+	//
+	EntryMap m_entries;
+	uint64_t m_nextEntryId = 0;
+
+	// Secondary indexes, maintained on every add, remove, and status change.
+	FlatHashMap<Hash, uint64_t> m_entryByTxHash;
+	std::unordered_multimap<Hash, uint64_t> m_entriesByKernelHash;
+	std::unordered_multimap<Commitment, uint64_t> m_entriesByInput;
+	std::unordered_multimap<Commitment, uint64_t> m_entriesByOutput;
+	std::map<EDandelionStatus, std::set<uint64_t>> m_entriesByStatus;
+	std::set<FeeRateKey> m_entriesByFeeRate;
+	std::set<std::pair<std::time_t, uint64_t>> m_entriesByEmbargoExpiration;
 
-	std::vector<TxPoolEntry> m_transactions;
+	size_t m_maxBytes = 0;
+	size_t m_memoryUsage = 0;
+	uint64_t m_numEvicted = 0;
+	uint16_t m_embargoSeconds = 0;
 };
\ No newline at end of file
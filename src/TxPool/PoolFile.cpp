@@ -0,0 +1,57 @@
+#include "PoolFile.h"
+
+#include <Core/Exceptions/DeserializationException.h>
+#include <Core/Exceptions/FileException.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Serialization/Serializer.h>
+
+void PoolFile::Write(const fs::path& path, const std::vector<std::pair<EPoolType, TransactionPtr>>& transactions)
+{
+	Serializer serializer(EProtocolVersion::V2);
+	serializer.Append<uint8_t>(VERSION);
+	for (const auto& transaction : transactions)
+	{
+		serializer.Append<uint8_t>((uint8_t)transaction.first);
+		transaction.second->Serialize(serializer);
+	}
+
+	FileUtil::SafeWriteToFile(path, serializer.GetBytes());
+}
+
+std::vector<std::pair<EPoolType, TransactionPtr>> PoolFile::Read(const fs::path& path)
+{
+	if (!FileUtil::Exists(path))
+	{
+		return {};
+	}
+
+	std::vector<uint8_t> bytes;
+	if (!FileUtil::ReadFile(path, bytes))
+	{
+		throw FILE_EXCEPTION_F("Failed to read {}", path.u8string());
+	}
+
+	ByteBuffer byteBuffer(std::move(bytes), EProtocolVersion::V2);
+	const uint8_t version = byteBuffer.ReadU8();
+	if (version != VERSION)
+	{
+		throw DESERIALIZATION_EXCEPTION_F("Unsupported pool file version {}", version);
+	}
+
+	std::vector<std::pair<EPoolType, TransactionPtr>> transactions;
+	while (byteBuffer.GetRemainingSize() > 0)
+	{
+		const uint8_t poolType = byteBuffer.ReadU8();
+		if (poolType != (uint8_t)EPoolType::MEMPOOL && poolType != (uint8_t)EPoolType::STEMPOOL)
+		{
+			throw DESERIALIZATION_EXCEPTION_F("Unknown pool type {}", poolType);
+		}
+
+		transactions.push_back(std::make_pair(
+			(EPoolType)poolType,
+			std::make_shared<Transaction>(Transaction::Deserialize(byteBuffer))
+		));
+	}
+
+	return transactions;
+}
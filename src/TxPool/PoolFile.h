@@ -0,0 +1,26 @@
+#pragma once
+
+#include <TxPool/PoolType.h>
+#include <Core/Models/Transaction.h>
+#include <Common/Util/FileUtil.h>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+//
+// The file the pools are saved to between runs: a version byte, then each tx's pool type followed by the tx (protocol version 2,
+// so kernels only contain the fields their features use), in the order they were added to the pool.
+//
+class PoolFile
+{
+public:
+	static void Write(const fs::path& path, const std::vector<std::pair<EPoolType, TransactionPtr>>& transactions);
+
+	//
+	// Returns the saved txs, or none if the file doesn't exist. Throws a DeserializationException if the file is corrupt.
+	//
+	static std::vector<std::pair<EPoolType, TransactionPtr>> Read(const fs::path& path);
+
+private:
+	static constexpr uint8_t VERSION = 1;
+};
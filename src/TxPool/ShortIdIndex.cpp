@@ -0,0 +1,88 @@
+#include "ShortIdIndex.h"
+
+#include <Common/ThreadPool.h>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+ShortIdIndex ShortIdIndex::Build(const std::vector<TransactionPtr>& transactions, const Hash& blockHash, const uint64_t nonce)
+{
+	std::vector<std::pair<const TransactionKernel*, const TransactionPtr*>> kernels;
+	for (const TransactionPtr& pTransaction : transactions)
+	{
+		for (const TransactionKernel& kernel : pTransaction->GetKernels())
+		{
+			kernels.push_back(std::make_pair(&kernel, &pTransaction));
+		}
+	}
+
+	const std::pair<uint64_t, uint64_t> keys = ShortId::CalculateKeys(blockHash, nonce);
+	std::vector<uint64_t> ids(kernels.size());
+
+	auto worker = [&kernels, &keys, &ids](const size_t begin, const size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			ids[i] = ToKey(ShortId::Create(kernels[i].first->GetHash(), keys));
+		}
+	};
+
+	const size_t numThreads = (std::min)(
+		(size_t)(std::max)(1u, std::thread::hardware_concurrency()),
+		(std::max)((size_t)1, kernels.size() / MIN_KERNELS_PER_THREAD)
+	);
+	if (numThreads <= 1)
+	{
+		worker(0, kernels.size());
+	}
+	else
+	{
+		const size_t kernelsPerThread = (kernels.size() + numThreads - 1) / numThreads;
+
+		std::atomic_size_t nextChunk = 0;
+		ThreadManagerAPI::GetThreadPool().RunParallel(numThreads, [&]() {
+			while (true)
+			{
+				const size_t begin = (nextChunk++) * kernelsPerThread;
+				if (begin >= kernels.size())
+				{
+					break;
+				}
+
+				worker(begin, (std::min)(begin + kernelsPerThread, kernels.size()));
+			}
+		}, ETaskPriority::HIGH);
+	}
+
+	ShortIdIndex index;
+	index.m_transactionsById.reserve(kernels.size());
+	for (size_t i = 0; i < kernels.size(); i++)
+	{
+		// On a (48-bit) collision, the first transaction wins, as it did when searching the pool in order.
+		index.m_transactionsById.insert({ ids[i], *kernels[i].second });
+	}
+
+	return index;
+}
+
+TransactionPtr ShortIdIndex::Find(const ShortId& shortId) const
+{
+	auto iter = m_transactionsById.find(ToKey(shortId));
+	if (iter != m_transactionsById.cend())
+	{
+		return iter->second;
+	}
+
+	return nullptr;
+}
+
+uint64_t ShortIdIndex::ToKey(const ShortId& shortId)
+{
+	uint64_t key = 0;
+	const CBigInteger<6>& id = shortId.GetId();
+	for (size_t i = 0; i < 6; i++)
+	{
+		key = (key << 8) | id[i];
+	}
+
+	return key;
+}
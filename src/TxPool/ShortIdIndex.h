@@ -0,0 +1,37 @@
+#pragma once
+
+#include <Core/Models/Transaction.h>
+#include <Core/Models/ShortId.h>
+#include <Crypto/Hash.h>
+#include <unordered_map>
+#include <vector>
+
+//
+// Maps the kernel short ids of every pool transaction, keyed for one specific block (hash + nonce), to their transactions.
+//
+// Short ids are keyed per block, so they can't be maintained as transactions are added.
+// Instead, the siphash keys are derived once and the short ids for the whole pool are computed in a single parallel pass,
+// after which each of a compact block's missing ids is resolved with one lookup.
+//
+class ShortIdIndex
+{
+public:
+	static ShortIdIndex Build(const std::vector<TransactionPtr>& transactions, const Hash& blockHash, const uint64_t nonce);
+
+	//
+	// Returns the transaction containing the kernel with the given short id, or nullptr if none.
+	//
+	TransactionPtr Find(const ShortId& shortId) const;
+
+	size_t GetNumKernels() const noexcept { return m_transactionsById.size(); }
+
+private:
+	ShortIdIndex() = default;
+
+	// Below this many kernels, the threads cost more than siphashing them.
+	static constexpr size_t MIN_KERNELS_PER_THREAD = 512;
+
+	static uint64_t ToKey(const ShortId& shortId);
+
+	std::unordered_map<uint64_t, TransactionPtr> m_transactionsById;
+};
@@ -1,13 +1,16 @@
 #include "TransactionPoolImpl.h"
 #include "ValidTransactionFinder.h"
+#include "PoolFile.h"
 
 #include <Core/Util/TransactionUtil.h>
 #include <Database/BlockDb.h>
 #include <Consensus/BlockTime.h>
 #include <Crypto/CSPRNG.h>
 #include <Common/Logger.h>
+#include <Common/Tracer.h>
 #include <Core/Util/FeeUtil.h>
 #include <Core/Validation/TransactionValidator.h>
+#include <algorithm>
 
 std::vector<TransactionPtr> TransactionPool::GetTransactionsByShortId(const Hash& hash, const uint64_t nonce, const std::set<ShortId>& missingShortIds) const
 {
@@ -23,6 +26,8 @@ EAddTransactionStatus TransactionPool::AddTransaction(
 	const EPoolType poolType,
 	const BlockHeader& lastConfirmedBlock)
 {
+	TRACE_SPAN("TransactionPool::AddTransaction");
+
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
 
 	if (poolType == EPoolType::MEMPOOL && m_memPool.ContainsTransaction(*pTransaction))
@@ -68,27 +73,158 @@ EAddTransactionStatus TransactionPool::AddTransaction(
 
 	if (poolType == EPoolType::MEMPOOL)
 	{
-		m_memPool.AddTransaction(pTransaction, EDandelionStatus::FLUFFED);
 		m_stemPool.RemoveTransaction(*pTransaction);
+		if (!AddToMemPool(pTransaction))
+		{
+			LOG_INFO_F("Mempool full, fee rate too low for transaction ({})", *pTransaction);
+			return EAddTransactionStatus::LOW_FEE;
+		}
 	}
 	else if (poolType == EPoolType::STEMPOOL)
 	{
 		const uint8_t random = (uint8_t)CSPRNG::GenerateRandom(0, 100);
+		EDandelionStatus status = EDandelionStatus::TO_FLUFF;
 		if (random <= m_config.GetNodeConfig().GetDandelion().GetStemProbability())
 		{
 			LOG_INFO_F("Stemming transaction ({})", *pTransaction);
-			m_stemPool.AddTransaction(pTransaction, EDandelionStatus::TO_STEM);
+			status = EDandelionStatus::TO_STEM;
 		}
 		else
 		{
 			LOG_INFO_F("Fluffing transaction ({})", *pTransaction);
-			m_stemPool.AddTransaction(pTransaction, EDandelionStatus::TO_FLUFF);
+		}
+
+		if (Contains(m_stemPool.AddTransaction(pTransaction, status), *pTransaction))
+		{
+			LOG_INFO_F("Stempool full, fee rate too low for transaction ({})", *pTransaction);
+			return EAddTransactionStatus::LOW_FEE;
 		}
 	}
 
 	return EAddTransactionStatus::ADDED;
 }
 
+bool TransactionPool::AddToMemPool(const TransactionPtr& pTransaction)
+{
+	const std::vector<TransactionPtr> evicted = m_memPool.AddTransaction(pTransaction, EDandelionStatus::FLUFFED);
+	if (evicted.empty())
+	{
+		AddEvent(EPoolEventType::ADDED, pTransaction);
+		m_blockTemplate.AddTransaction(pTransaction);
+		return true;
+	}
+
+	const bool added = !Contains(evicted, *pTransaction);
+	if (added)
+	{
+		AddEvent(EPoolEventType::ADDED, pTransaction);
+	}
+
+	for (const TransactionPtr& pEvicted : evicted)
+	{
+		if (pEvicted->GetHash() != pTransaction->GetHash())
+		{
+			AddEvent(EPoolEventType::EVICTED, pEvicted);
+		}
+	}
+
+	// Evicted txs may already be in the template.
+	m_blockTemplate.Invalidate();
+	return added;
+}
+
+void TransactionPool::RegisterWithMemoryBudget()
+{
+	m_memoryBudgetRegistrations.push_back(MemoryBudgetAPI::Register(MemoryConsumer{
+		"mempool",
+		20,
+		1024 * 1024,
+		[this]() { return GetStats().memPool.memoryUsage; },
+		[this](const size_t limitBytes) { SetMemPoolMaxBytes(limitBytes); }
+	}));
+	m_memoryBudgetRegistrations.push_back(MemoryBudgetAPI::Register(MemoryConsumer{
+		"stempool",
+		5,
+		256 * 1024,
+		[this]() { return GetStats().stemPool.memoryUsage; },
+		[this](const size_t limitBytes) { SetStemPoolMaxBytes(limitBytes); }
+	}));
+}
+
+void TransactionPool::SetMemPoolMaxBytes(const size_t maxBytes)
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	const std::vector<TransactionPtr> evicted = m_memPool.SetMaxBytes(maxBytes);
+	if (!evicted.empty())
+	{
+		LOG_INFO_F("Evicted {} txs to fit the mempool in {}KB", evicted.size(), maxBytes / 1024);
+		AddEvents(EPoolEventType::EVICTED, evicted);
+		m_blockTemplate.Invalidate();
+	}
+}
+
+void TransactionPool::SetStemPoolMaxBytes(const size_t maxBytes)
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+	m_stemPool.SetMaxBytes(maxBytes);
+}
+
+bool TransactionPool::Contains(const std::vector<TransactionPtr>& transactions, const Transaction& transaction)
+{
+	return std::any_of(
+		transactions.cbegin(),
+		transactions.cend(),
+		[&transaction](const TransactionPtr& pTransaction) { return pTransaction->GetHash() == transaction.GetHash(); }
+	);
+}
+
+void TransactionPool::AddEvent(const EPoolEventType type, const TransactionPtr& pTransaction)
+{
+	m_events.emplace_back(m_eventSequence + 1, type, pTransaction);
+	while (m_events.size() > MAX_EVENTS)
+	{
+		m_events.pop_front();
+	}
+
+	// Incremented last, so anyone who sees the new sequence can also read the event.
+	++m_eventSequence;
+}
+
+void TransactionPool::AddEvents(const EPoolEventType type, const std::vector<TransactionPtr>& transactions)
+{
+	for (const TransactionPtr& pTransaction : transactions)
+	{
+		AddEvent(type, pTransaction);
+	}
+}
+
+TxPoolStats TransactionPool::GetStats() const
+{
+	std::shared_lock<std::shared_mutex> readLock(m_mutex);
+
+	return TxPoolStats{ m_memPool.GetStats(), m_stemPool.GetStats(), m_numBlocksReconciled, m_reconcileMicros };
+}
+
+std::optional<std::vector<TxPoolEvent>> TransactionPool::GetEventsSince(const uint64_t sequence) const
+{
+	std::shared_lock<std::shared_mutex> readLock(m_mutex);
+
+	if (sequence >= m_eventSequence)
+	{
+		return std::make_optional(std::vector<TxPoolEvent>{});
+	}
+
+	if (m_events.empty() || m_events.front().GetSequence() > sequence + 1)
+	{
+		return std::nullopt;
+	}
+
+	// Sequences are consecutive, so the first event wanted is at a known offset.
+	const size_t offset = (size_t)(sequence + 1 - m_events.front().GetSequence());
+	return std::make_optional(std::vector<TxPoolEvent>(m_events.cbegin() + offset, m_events.cend()));
+}
+
 std::vector<TransactionPtr> TransactionPool::FindTransactionsByKernel(const std::set<TransactionKernel>& kernels) const
 {
 	std::shared_lock<std::shared_mutex> readLock(m_mutex);
@@ -109,28 +245,104 @@ TransactionPtr TransactionPool::FindTransactionByKernelHash(const Hash& kernelHa
 	return pTransaction;
 }
 
-void TransactionPool::ReconcileBlock(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet, const FullBlock& block)
+void TransactionPool::ReconcileBlock(std::shared_ptr<const IBlockDB>, ITxHashSetConstPtr, const FullBlock& block)
 {
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+	const auto start = std::chrono::steady_clock::now();
 
 	// First reconcile the txpool.
-	m_memPool.ReconcileBlock(pBlockDB, pTxHashSet, block, nullptr);
+	Pool::Reconciliation memPool = m_memPool.ReconcileBlock(block, {});
+
+	// Now reconcile our stempool, accounting for the txpool txs that were removed.
+	std::vector<TransactionPtr> removedFromMemPool = memPool.mined;
+	removedFromMemPool.insert(removedFromMemPool.end(), memPool.evicted.cbegin(), memPool.evicted.cend());
+	Pool::Reconciliation stemPool = m_stemPool.ReconcileBlock(block, removedFromMemPool);
+	AddEvents(EPoolEventType::MINED, memPool.mined);
+	AddEvents(EPoolEventType::EVICTED, memPool.evicted);
+
+	LOG_DEBUG_F(
+		"Reconciled block {}: {} mined, {} evicted",
+		block,
+		memPool.mined.size() + stemPool.mined.size(),
+		memPool.evicted.size() + stemPool.evicted.size()
+	);
 
-	// Now reconcile our stempool, accounting for the updated txpool txs.
-	auto pMemPoolAggTx = m_memPool.Aggregate();
-	m_stemPool.ReconcileBlock(pBlockDB, pTxHashSet, block, pMemPoolAggTx);
+	std::vector<TransactionPtr> mined = std::move(memPool.mined);
+	mined.insert(mined.end(), stemPool.mined.cbegin(), stemPool.mined.cend());
+	m_reorgCache.emplace_back(block.GetHash(), std::move(mined));
+	m_blockTemplate.Invalidate();
+	while (m_reorgCache.size() > REORG_CACHE_BLOCKS)
+	{
+		m_reorgCache.pop_front();
+	}
+
+	++m_numBlocksReconciled;
+	m_reconcileMicros += (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
+
+void TransactionPool::ReinjectBlockTransactions(const std::vector<Hash>& disconnectedBlocks)
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	for (const Hash& blockHash : disconnectedBlocks)
+	{
+		auto iter = std::find_if(
+			m_reorgCache.begin(),
+			m_reorgCache.end(),
+			[&blockHash](const std::pair<Hash, std::vector<TransactionPtr>>& block) { return block.first == blockHash; }
+		);
+		if (iter == m_reorgCache.end())
+		{
+			continue;
+		}
+
+		LOG_INFO_F("Re-injecting {} transactions from block {}", iter->second.size(), blockHash);
+
+		// These were valid in the pool before the block was connected, and the rewind restored their inputs.
+		// Any that conflict with the new chain are evicted as its blocks are reconciled.
+		for (const TransactionPtr& pTransaction : iter->second)
+		{
+			const std::vector<TransactionPtr> evicted = m_memPool.AddTransaction(pTransaction, EDandelionStatus::FLUFFED);
+			if (!Contains(evicted, *pTransaction))
+			{
+				AddEvent(EPoolEventType::ADDED, pTransaction);
+			}
+
+			for (const TransactionPtr& pEvicted : evicted)
+			{
+				if (pEvicted->GetHash() != pTransaction->GetHash())
+				{
+					AddEvent(EPoolEventType::EVICTED, pEvicted);
+				}
+			}
+
+			m_stemPool.RemoveTransaction(*pTransaction);
+		}
+
+		m_reorgCache.erase(iter);
+		m_blockTemplate.Invalidate();
+	}
+}
+
+BlockTemplate::CPtr TransactionPool::GetBlockTemplate(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet, const BlockHeaderPtr& pTipHeader)
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	return m_blockTemplate.GetTemplate(m_memPool, pBlockDB, pTxHashSet, pTipHeader);
 }
 
 TransactionPtr TransactionPool::GetTransactionToStem(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet)
 {
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
 
-	const std::vector<TransactionPtr> transactionsToStem = m_stemPool.FindTransactionsByStatus(EDandelionStatus::TO_STEM);
-	if (transactionsToStem.empty())
+	const std::optional<std::time_t> deadline = GetPatienceDeadline(EDandelionStatus::TO_STEM);
+	if (!deadline.has_value() || deadline.value() > std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()))
 	{
 		return nullptr;
 	}
 
+	const std::vector<TransactionPtr> transactionsToStem = m_stemPool.FindTransactionsByStatus(EDandelionStatus::TO_STEM);
+
 	auto pMemPoolAggTx = m_memPool.Aggregate();
 
 	std::vector<TransactionPtr> validTransactionsToStem = ValidTransactionFinder::FindValidTransactions(
@@ -155,12 +367,14 @@ TransactionPtr TransactionPool::GetTransactionToFluff(std::shared_ptr<const IBlo
 {
 	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
 
-	std::vector<TransactionPtr> transactionsToFluff = m_stemPool.FindTransactionsByStatus(EDandelionStatus::TO_FLUFF);
-	if (transactionsToFluff.empty())
+	const std::optional<std::time_t> deadline = GetPatienceDeadline(EDandelionStatus::TO_FLUFF);
+	if (!deadline.has_value() || deadline.value() > std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()))
 	{
 		return nullptr;
 	}
 
+	std::vector<TransactionPtr> transactionsToFluff = m_stemPool.FindTransactionsByStatus(EDandelionStatus::TO_FLUFF);
+
 	auto pMemPoolAggTx = m_memPool.Aggregate();
 
 	std::vector<TransactionPtr> validTransactionsToFluff = ValidTransactionFinder::FindValidTransactions(
@@ -176,7 +390,7 @@ TransactionPtr TransactionPool::GetTransactionToFluff(std::shared_ptr<const IBlo
 
 	TransactionPtr pTransactionToFluff = TransactionUtil::Aggregate(validTransactionsToFluff);
 
-	m_memPool.AddTransaction(pTransactionToFluff, EDandelionStatus::FLUFFED);
+	AddToMemPool(pTransactionToFluff);
 	for (auto& pTransaction : validTransactionsToFluff)
 	{
 		m_stemPool.RemoveTransaction(*pTransaction);
@@ -185,12 +399,68 @@ TransactionPtr TransactionPool::GetTransactionToFluff(std::shared_ptr<const IBlo
 	return pTransactionToFluff;
 }
 
-std::vector<TransactionPtr> TransactionPool::GetExpiredTransactions() const
+std::vector<TransactionPtr> TransactionPool::GetExpiredTransactions()
+{
+	std::unique_lock<std::shared_mutex> writeLock(m_mutex);
+
+	// Any that fail to be fluffed are retried after the patience interval.
+	const std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+	const uint8_t patienceSeconds = m_config.GetNodeConfig().GetDandelion().GetPatienceSeconds();
+	return m_stemPool.TakeExpiredTransactions(now, now + patienceSeconds);
+}
+
+std::chrono::system_clock::time_point TransactionPool::GetNextDandelionEvent() const
 {
 	std::shared_lock<std::shared_mutex> readLock(m_mutex);
 
-	const uint16_t embargoSeconds = m_config.GetNodeConfig().GetDandelion().GetEmbargoSeconds() + (uint16_t)CSPRNG::GenerateRandom(0, 30);
-	return m_stemPool.GetExpiredTransactions(embargoSeconds);
+	std::optional<std::time_t> next = m_stemPool.GetNextEmbargoExpiration();
+	for (const EDandelionStatus status : { EDandelionStatus::TO_STEM, EDandelionStatus::TO_FLUFF })
+	{
+		const std::optional<std::time_t> deadline = GetPatienceDeadline(status);
+		if (deadline.has_value() && (!next.has_value() || deadline.value() < next.value()))
+		{
+			next = deadline;
+		}
+	}
+
+	return next.has_value() ? std::chrono::system_clock::from_time_t(next.value()) : std::chrono::system_clock::time_point::max();
+}
+
+std::optional<std::time_t> TransactionPool::GetPatienceDeadline(const EDandelionStatus status) const
+{
+	const std::optional<std::time_t> oldest = m_stemPool.GetOldestTimestamp(status);
+	if (!oldest.has_value())
+	{
+		return std::nullopt;
+	}
+
+	return std::make_optional(oldest.value() + m_config.GetNodeConfig().GetDandelion().GetPatienceSeconds());
+}
+
+size_t TransactionPool::SaveTransactions(const fs::path& path, const bool includeStemPool) const
+{
+	std::vector<std::pair<EPoolType, TransactionPtr>> transactions;
+	{
+		std::shared_lock<std::shared_mutex> readLock(m_mutex);
+
+		// Each pool is in the order its txs were added, so a tx is always saved after the txs whose outputs it spends.
+		for (const TransactionPtr& pTransaction : m_memPool.GetTransactions())
+		{
+			transactions.push_back(std::make_pair(EPoolType::MEMPOOL, pTransaction));
+		}
+
+		if (includeStemPool)
+		{
+			for (const TransactionPtr& pTransaction : m_stemPool.GetTransactions())
+			{
+				transactions.push_back(std::make_pair(EPoolType::STEMPOOL, pTransaction));
+			}
+		}
+	}
+
+	// Serialized without the lock, since the txs themselves are immutable.
+	PoolFile::Write(path, transactions);
+	return transactions.size();
 }
 
 namespace TxPoolAPI
@@ -199,4 +469,9 @@ namespace TxPoolAPI
 	{
 		return std::shared_ptr<TransactionPool>(new TransactionPool(config));
 	}
+
+	TX_POOL_API std::vector<std::pair<EPoolType, TransactionPtr>> LoadTransactions(const fs::path& path)
+	{
+		return PoolFile::Read(path);
+	}
 }
\ No newline at end of file
@@ -1,11 +1,15 @@
 #pragma once
 
 #include "Pool.h"
+#include "BlockTemplateBuilder.h"
 
 #include <TxPool/TransactionPool.h>
 #include <Core/Models/Transaction.h>
 #include <Core/Models/ShortId.h>
 #include <Crypto/Hash.h>
+#include <Common/MemoryBudget.h>
+#include <atomic>
+#include <deque>
 #include <shared_mutex>
 #include <set>
 
@@ -13,7 +17,13 @@ class TransactionPool : public ITransactionPool
 {
 public:
 	TransactionPool(const Config& config)
-		: m_config(config), m_memPool(), m_stemPool() { }
+		: m_config(config), m_memPool(), m_stemPool(), m_eventSequence(0), m_numBlocksReconciled(0), m_reconcileMicros(0)
+	{
+		m_memPool.SetMaxBytes(config.GetNodeConfig().GetMemPoolMaxBytes());
+		m_stemPool.SetMaxBytes(config.GetNodeConfig().GetStemPoolMaxBytes());
+		m_stemPool.SetEmbargo(config.GetNodeConfig().GetDandelion().GetEmbargoSeconds());
+		RegisterWithMemoryBudget();
+	}
     virtual ~TransactionPool() = default;
 
 	std::vector<TransactionPtr> GetTransactionsByShortId(const Hash& hash, const uint64_t nonce, const std::set<ShortId>& missingShortIds) const final;
@@ -21,16 +31,68 @@ public:
 	std::vector<TransactionPtr> FindTransactionsByKernel(const std::set<TransactionKernel>& kernels) const final;
 	TransactionPtr FindTransactionByKernelHash(const Hash& kernelHash) const final;
 	void ReconcileBlock(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet, const FullBlock& block) final;
+	void ReinjectBlockTransactions(const std::vector<Hash>& disconnectedBlocks) final;
+	BlockTemplate::CPtr GetBlockTemplate(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet, const BlockHeaderPtr& pTipHeader) final;
 
 	// Dandelion
 	TransactionPtr GetTransactionToStem(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet) final;
 	TransactionPtr GetTransactionToFluff(std::shared_ptr<const IBlockDB> pBlockDB, ITxHashSetConstPtr pTxHashSet) final;
-	std::vector<TransactionPtr> GetExpiredTransactions() const final;
+	std::vector<TransactionPtr> GetExpiredTransactions() final;
+	std::chrono::system_clock::time_point GetNextDandelionEvent() const final;
+
+	TxPoolStats GetStats() const final;
+	uint64_t GetEventSequence() const noexcept final { return m_eventSequence; }
+	std::optional<std::vector<TxPoolEvent>> GetEventsSince(const uint64_t sequence) const final;
+	size_t SaveTransactions(const fs::path& path, const bool includeStemPool) const final;
 
 private:
+	//
+	// Adds the tx to the mempool, keeping the block template in sync with any evictions.
+	// Returns false if the tx itself was evicted, since it paid the lowest fee rate in a full mempool.
+	//
+	bool AddToMemPool(const TransactionPtr& pTransaction);
+
+	//
+	// Lets the memory budget size both pools. Both are then always bounded, with txs evicted from the mempool reported like any other eviction.
+	//
+	void RegisterWithMemoryBudget();
+	void SetMemPoolMaxBytes(const size_t maxBytes);
+	void SetStemPoolMaxBytes(const size_t maxBytes);
+	static bool Contains(const std::vector<TransactionPtr>& transactions, const Transaction& transaction);
+
+	//
+	// Records mempool events for subscribers. Must be called holding the write lock.
+	//
+	void AddEvent(const EPoolEventType type, const TransactionPtr& pTransaction);
+	void AddEvents(const EPoolEventType type, const std::vector<TransactionPtr>& transactions);
+
+	//
+	// Returns when the oldest stempool tx with the given status will have waited the patience interval.
+	//
+	std::optional<std::time_t> GetPatienceDeadline(const EDandelionStatus status) const;
+
 	const Config& m_config;
 	mutable std::shared_mutex m_mutex;
 
 	Pool m_memPool;
 	Pool m_stemPool;
+	BlockTemplateBuilder m_blockTemplate;
+
+	//
+	// The pool transactions mined in each of the most recent blocks, to re-inject if those blocks are disconnected by a reorg.
+	//
+	static constexpr size_t REORG_CACHE_BLOCKS = 30;
+	std::deque<std::pair<Hash, std::vector<TransactionPtr>>> m_reorgCache;
+
+	//
+	// The most recent mempool events. Subscribers that fall further behind than this refetch the whole pool.
+	//
+	static constexpr size_t MAX_EVENTS = 1000;
+	std::deque<TxPoolEvent> m_events;
+	std::atomic<uint64_t> m_eventSequence;
+
+	uint64_t m_numBlocksReconciled;
+	uint64_t m_reconcileMicros;
+
+	std::vector<MemoryBudgetRegistration::UPtr> m_memoryBudgetRegistrations;
 };
@@ -2,6 +2,7 @@
 
 #include <Core/Models/Transaction.h>
 #include <TxPool/DandelionStatus.h>
+#include <Core/Util/FeeUtil.h>
 #include <ctime>
 
 class TxPoolEntry
@@ -11,7 +12,13 @@ public:
 	// Constructors
 	//
 	TxPoolEntry(TransactionPtr pTransaction, const EDandelionStatus status, const std::time_t timestamp)
-		: m_pTransaction(pTransaction), m_status(status), m_timestamp(timestamp)
+		: m_pTransaction(pTransaction),
+		m_status(status),
+		m_timestamp(timestamp),
+		m_embargoExpiration(0),
+		m_fee(FeeUtil::CalculateActualFee(*pTransaction)),
+		m_weight(FeeUtil::CalculateTxWeight(*pTransaction)),
+		m_memoryUsage(EstimateMemoryUsage(*pTransaction))
 	{
 
 	}
@@ -40,14 +47,46 @@ public:
 	inline TransactionPtr GetTransaction() const { return m_pTransaction; }
 	inline EDandelionStatus GetStatus() const { return m_status; }
 	inline std::time_t GetTimestamp() const { return m_timestamp; }
+	inline std::time_t GetEmbargoExpiration() const { return m_embargoExpiration; }
+	inline uint64_t GetFee() const { return m_fee; }
+	inline uint64_t GetWeight() const { return m_weight; }
+	inline double GetFeeRate() const { return (double)m_fee / m_weight; }
+	inline size_t GetMemoryUsage() const { return m_memoryUsage; }
 
 	//
 	// Setters
 	//
 	inline void SetStatus(const EDandelionStatus status) { m_status = status; }
 
+	//
+	// The time the embargo timer fires, after which a stem tx that hasn't been seen fluffed is fluffed by this node. 0 when not embargoed.
+	//
+	inline void SetEmbargoExpiration(const std::time_t embargoExpiration) { m_embargoExpiration = embargoExpiration; }
+
 private:
+	//
+	// Approximates the heap used by the transaction, including a node in each of the pool's indexes.
+	//
+	static size_t EstimateMemoryUsage(const Transaction& transaction)
+	{
+		constexpr size_t INDEX_NODE_SIZE = 64;
+
+		size_t usage = sizeof(Transaction) + sizeof(TxPoolEntry) + (4 * INDEX_NODE_SIZE);
+		usage += transaction.GetInputs().size() * (sizeof(TransactionInput) + INDEX_NODE_SIZE);
+		usage += transaction.GetKernels().size() * (sizeof(TransactionKernel) + INDEX_NODE_SIZE);
+		for (const TransactionOutput& output : transaction.GetOutputs())
+		{
+			usage += sizeof(TransactionOutput) + INDEX_NODE_SIZE + output.GetRangeProof().GetProofBytes().capacity();
+		}
+
+		return usage;
+	}
+
 	TransactionPtr m_pTransaction;
 	EDandelionStatus m_status;
 	std::time_t m_timestamp;
+	std::time_t m_embargoExpiration;
+	uint64_t m_fee;
+	uint64_t m_weight;
+	size_t m_memoryUsage;
 };
\ No newline at end of file
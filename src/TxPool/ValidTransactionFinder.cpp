@@ -1,10 +1,7 @@
 #include "ValidTransactionFinder.h"
+#include "AggregateValidator.h"
 
-#include <Core/Util/TransactionUtil.h>
-#include <Core/Validation/TransactionValidator.h>
-#include <Core/Validation/KernelSumValidator.h>
-#include <Common/Util/FunctionalUtil.h>
-#include <PMMR/TxHashSetManager.h>
+#include <Core/Validation/KernelSignatureValidator.h>
 #include <Database/BlockDb.h>
 
 std::vector<TransactionPtr> ValidTransactionFinder::FindValidTransactions(
@@ -13,51 +10,32 @@ std::vector<TransactionPtr> ValidTransactionFinder::FindValidTransactions(
 	const std::vector<TransactionPtr>& transactions,
 	TransactionPtr pExtraTransaction)
 {
+	// Drop transactions with a bad kernel signature up front, using a single batch verification when there are none.
+	const std::vector<size_t> invalidSignatures = KernelSignatureValidator::FindInvalidTransactions(transactions);
+
+	// The aggregate always includes the extra tx, so nothing is valid if it isn't.
+	AggregateValidator aggregate(pBlockDB, pTxHashSet);
+	if (pExtraTransaction != nullptr && !aggregate.Add(pExtraTransaction, false))
+	{
+		return std::vector<TransactionPtr>();
+	}
+
 	std::vector<TransactionPtr> validTransactions;
-	for (TransactionPtr pTransaction : transactions)
+	size_t nextInvalid = 0;
+	for (size_t i = 0; i < transactions.size(); i++)
 	{
-		std::vector<TransactionPtr> candidateTransactions = validTransactions;
-		if (pExtraTransaction != nullptr)
+		if (nextInvalid < invalidSignatures.size() && invalidSignatures[nextInvalid] == i)
 		{
-			candidateTransactions.push_back(pExtraTransaction);
+			++nextInvalid;
+			continue;
 		}
 
-		candidateTransactions.push_back(pTransaction);
-
-		// Build a single aggregate tx from candidate txs.
-		TransactionPtr pAggregatedTransaction = TransactionUtil::Aggregate(candidateTransactions);
-
-		// We know the tx is valid if the entire aggregate tx is valid.
-		if (IsValidTransaction(pBlockDB, pTxHashSet, pAggregatedTransaction))
+		// We know the tx is valid if the aggregate of it and every tx accepted before it is valid.
+		if (aggregate.Add(transactions[i], true))
 		{
-			validTransactions.push_back(pTransaction);
+			validTransactions.push_back(transactions[i]);
 		}
 	}
 
 	return validTransactions;
 }
-
-bool ValidTransactionFinder::IsValidTransaction(
-	std::shared_ptr<const IBlockDB> pBlockDB,
-	ITxHashSetConstPtr pTxHashSet,
-	TransactionPtr pTransaction)
-{
-	try
-	{
-		TransactionValidator().Validate(*pTransaction);
-
-		// Validate the tx against current chain state.
-		// Check all inputs are in the current UTXO set.
-		// Check all outputs are unique in current UTXO set.
-		if (!pTxHashSet->IsValid(pBlockDB, *pTransaction))
-		{
-			return false;
-		}
-	}
-	catch (std::exception&)
-	{
-		return false;
-	}
-
-	return true;
-}
\ No newline at end of file
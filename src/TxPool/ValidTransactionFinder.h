@@ -7,6 +7,10 @@
 // Forward Declarations
 class IBlockDB;
 
+//
+// Finds, in order, the transactions that are valid when aggregated with every transaction accepted before them (and with the extra tx, if any).
+// Each transaction is validated incrementally against the running aggregate, rather than re-validating the whole aggregate per candidate.
+//
 class ValidTransactionFinder
 {
 public:
@@ -16,11 +20,4 @@ public:
 		const std::vector<TransactionPtr>& transactions,
 		TransactionPtr pExtraTransaction
 	);
-
-private:
-	static bool IsValidTransaction(
-		std::shared_ptr<const IBlockDB> pBlockDB,
-		ITxHashSetConstPtr pTxHashSet,
-		TransactionPtr pTransaction
-	);
 };
\ No newline at end of file
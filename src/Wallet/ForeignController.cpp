@@ -4,6 +4,8 @@
 #include <Wallet/SessionToken.h>
 #include <Wallet/Keychain/KeyChain.h>
 #include <Wallet/WalletManager.h>
+#include <Net/Util/HTTPUtil.h>
+#include <Common/Util/StringUtil.h>
 
 struct ForeignController::Context
 {
@@ -14,20 +16,79 @@ struct ForeignController::Context
 	ForeignServer::UPtr m_pServer;
 };
 
-ForeignController::ForeignController(IWalletManager& walletManager)
-	: m_walletManager(walletManager)
+ForeignController::ForeignController(const Config& config, IWalletManager& walletManager)
+	: m_config(config), m_walletManager(walletManager)
 {
-
+	if (config.GetWalletConfig().UseSharedForeignListener())
+	{
+		m_pSharedServer = Server::Create(EServerType::PUBLIC, std::nullopt, config.GetServerConfig().GetForeignAPIConfig());
+		m_pSharedServer->AddListener("/v2/foreign", SharedForeignHandler, this);
+		m_pSharedServer->AddListener("/status", ForeignServer::StatusListener, nullptr);
+	}
 }
 
 ForeignController::~ForeignController()
 {
+	if (m_pSharedServer != nullptr)
+	{
+		// Stops accepting requests before the RPCServers they're routed to are destroyed.
+		m_pSharedServer.reset();
+	}
+
 	for (auto& iter : m_contextsByUsername)
 	{
 		iter.second->m_pServer.reset();
 	}
 }
 
+int ForeignController::SharedForeignHandler(mg_connection* pConnection, void* pController)
+{
+	ForeignController* pForeignController = (ForeignController*)pController;
+
+	const std::optional<std::string> hostOpt = HTTPUtil::GetHeaderValue(pConnection, "Host");
+	if (hostOpt.has_value())
+	{
+		RPCServerPtr pRPCServer = nullptr;
+		{
+			std::shared_lock<std::shared_mutex> lock(pForeignController->m_serversMutex);
+			auto iter = pForeignController->m_serversByAddress.find(NormalizeHost(hostOpt.value()));
+			if (iter != pForeignController->m_serversByAddress.end())
+			{
+				pRPCServer = iter->second;
+			}
+		}
+
+		if (pRPCServer != nullptr)
+		{
+			return pRPCServer->HandleRequest(pConnection);
+		}
+	}
+
+	return HTTPUtil::BuildNotFoundResponse(pConnection, "No wallet is listening at this address");
+}
+
+//
+// "ABC...XYZ.onion:80" -> "abc...xyz"
+//
+std::string ForeignController::NormalizeHost(const std::string& host)
+{
+	std::string normalized = StringUtil::ToLower(host);
+
+	const size_t portPos = normalized.find(':');
+	if (portPos != std::string::npos)
+	{
+		normalized.resize(portPos);
+	}
+
+	const std::string suffix = ".onion";
+	if (normalized.size() >= suffix.size() && normalized.compare(normalized.size() - suffix.size(), suffix.size(), suffix) == 0)
+	{
+		normalized.resize(normalized.size() - suffix.size());
+	}
+
+	return normalized;
+}
+
 std::pair<uint16_t, std::optional<TorAddress>> ForeignController::StartListener(
 	const TorProcess::Ptr& pTorProcess,
 	const std::string& username,
@@ -46,12 +107,26 @@ std::pair<uint16_t, std::optional<TorAddress>> ForeignController::StartListener(
 		);
 	}
 
-	auto pServer = ForeignServer::Create(
-		keyChain,
-		pTorProcess,
-		m_walletManager,
-		token
-	);
+	ForeignServer::UPtr pServer = nullptr;
+	if (m_pSharedServer != nullptr)
+	{
+		pServer = ForeignServer::CreateShared(keyChain, pTorProcess, m_walletManager, token, m_pSharedServer);
+		if (pServer->GetTorAddress().has_value())
+		{
+			std::unique_lock<std::shared_mutex> serversLock(m_serversMutex);
+			m_serversByAddress[NormalizeHost(pServer->GetTorAddress().value().ToString())] = pServer->GetRPCServer();
+		}
+	}
+	else
+	{
+		pServer = ForeignServer::Create(
+			keyChain,
+			pTorProcess,
+			m_walletManager,
+			token,
+			m_config.GetServerConfig().GetForeignAPIConfig()
+		);
+	}
 
 	auto response = std::make_pair(pServer->GetPortNumber(), pServer->GetTorAddress());
 
@@ -73,6 +148,13 @@ bool ForeignController::StopListener(const std::string& username)
 	iter->second->m_numReferences--;
 	if (iter->second->m_numReferences == 0)
 	{
+		const std::optional<TorAddress>& torAddress = iter->second->m_pServer->GetTorAddress();
+		if (m_pSharedServer != nullptr && torAddress.has_value())
+		{
+			std::unique_lock<std::shared_mutex> serversLock(m_serversMutex);
+			m_serversByAddress.erase(NormalizeHost(torAddress.value().ToString()));
+		}
+
 		m_contextsByUsername.erase(iter);
 	}
 
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <Config/Config.h>
 #include <Net/Tor/TorProcess.h>
+#include <Net/Servers/RPC/RPCServer.h>
 #include <unordered_map>
 #include <optional>
 #include <string>
 #include <mutex>
+#include <shared_mutex>
 
 // Forward Declarations
 class IWalletManager;
@@ -14,7 +17,7 @@ class KeyChain;
 class ForeignController
 {
 public:
-	ForeignController(IWalletManager& walletManager);
+	ForeignController(const Config& config, IWalletManager& walletManager);
 	~ForeignController();
 
 	std::pair<uint16_t, std::optional<TorAddress>> StartListener(
@@ -28,8 +31,17 @@ public:
 private:
 	struct Context;
 
+	static int SharedForeignHandler(mg_connection* pConnection, void* pController);
+	static std::string NormalizeHost(const std::string& host);
+
+	const Config& m_config;
 	IWalletManager& m_walletManager;
 
 	mutable std::mutex m_contextsMutex;
 	std::unordered_map<std::string, std::unique_ptr<Context>> m_contextsByUsername;
+
+	// Only set when WALLET.SHARED_FOREIGN_LISTENER is enabled. Requests are routed to each wallet's RPCServer by onion address.
+	ServerPtr m_pSharedServer;
+	mutable std::shared_mutex m_serversMutex;
+	std::unordered_map<std::string, RPCServerPtr> m_serversByAddress;
 };
\ No newline at end of file
@@ -11,7 +11,10 @@
 #include <Common/Util/VectorUtil.h>
 
 KeyChain::KeyChain(const Config& config, PrivateExtKey&& masterKey, SecretKey&& bulletProofNonce)
-	: m_config(config), m_masterKey(std::move(masterKey)), m_bulletProofNonce(std::move(bulletProofNonce))
+	: m_config(config),
+	m_masterKey(std::move(masterKey)),
+	m_bulletProofNonce(std::move(bulletProofNonce)),
+	m_enhancedRewindNonceHash(Hasher::Blake2b(Crypto::CalculatePublicKey(m_masterKey.GetPrivateKey()).GetCompressedVec()))
 {
 
 }
@@ -31,15 +34,58 @@ KeyChain KeyChain::FromRandom(const Config& config)
 
 SecretKey KeyChain::DerivePrivateKey(const KeyChainPath& keyPath) const
 {
-	KeyGenerator keygen(m_config);
+	const std::vector<uint32_t>& keyIndices = keyPath.GetKeyIndices();
+	if (keyIndices.empty())
+	{
+		return m_masterKey.GetPrivateKey();
+	}
+
+	const std::vector<uint32_t> parentIndices(keyIndices.cbegin(), keyIndices.cend() - 1);
+	const PrivateExtKey parentKey = DeriveParentKey(parentIndices);
+
+	return KeyGenerator(m_config).GenerateChildPrivateKey(parentKey, keyIndices.back()).GetPrivateKey();
+}
 
+PrivateExtKey KeyChain::DeriveParentKey(const std::vector<uint32_t>& parentIndices) const
+{
+	if (parentIndices.empty())
+	{
+		return m_masterKey;
+	}
+
+	std::unique_lock<std::mutex> lock(m_parentKeysMutex);
+	auto iter = m_parentKeys.find(parentIndices);
+	if (iter != m_parentKeys.end())
+	{
+		return iter->second;
+	}
+
+	// Continues from the deepest cached ancestor, caching each key along the way.
+	KeyGenerator keygen(m_config);
 	PrivateExtKey privateKey(m_masterKey);
-	for (const uint32_t childIndex : keyPath.GetKeyIndices())
+	std::vector<uint32_t> indices;
+	for (const uint32_t childIndex : parentIndices)
 	{
+		indices.push_back(childIndex);
+
+		auto ancestorIter = m_parentKeys.find(indices);
+		if (ancestorIter != m_parentKeys.end())
+		{
+			privateKey = ancestorIter->second;
+			continue;
+		}
+
 		privateKey = keygen.GenerateChildPrivateKey(privateKey, childIndex);
+
+		if (m_parentKeys.size() >= MAX_CACHED_PARENT_KEYS)
+		{
+			m_parentKeys.clear();
+		}
+
+		m_parentKeys.insert({ indices, privateKey });
 	}
 
-	return privateKey.GetPrivateKey();
+	return privateKey;
 }
 
 SecretKey KeyChain::DerivePrivateKey(const KeyChainPath& keyPath, const uint64_t amount) const
@@ -57,21 +103,25 @@ ed25519_keypair_t KeyChain::DeriveED25519Key(const KeyChainPath& keyPath) const
 
 std::unique_ptr<RewoundProof> KeyChain::RewindRangeProof(const Commitment& commitment, const RangeProof& rangeProof, const EBulletproofType& bulletproofType) const
 {
-	if (bulletproofType == EBulletproofType::ORIGINAL)
-	{
-		const SecretKey nonce = CreateNonce(commitment, m_bulletProofNonce);
-		return Crypto::RewindRangeProof(commitment, rangeProof, nonce);
-	}
-	else if (bulletproofType == EBulletproofType::ENHANCED)
-	{
-		PublicKey masterPublicKey = Crypto::CalculatePublicKey(m_masterKey.GetPrivateKey());
+	const SecretKey nonce = CreateNonce(commitment, GetRewindNonceHash(bulletproofType));
+	return Crypto::RewindRangeProof(commitment, rangeProof, nonce);
+}
 
-		const SecretKey rewindNonceHash = Hasher::Blake2b(masterPublicKey.GetCompressedVec());
+std::vector<std::unique_ptr<RewoundProof>> KeyChain::RewindRangeProofs(
+	const std::vector<Commitment>& commitments,
+	const std::vector<const RangeProof*>& rangeProofs,
+	const EBulletproofType& bulletproofType) const
+{
+	const SecretKey& rewindNonceHash = GetRewindNonceHash(bulletproofType);
 
-		return Crypto::RewindRangeProof(commitment, rangeProof, CreateNonce(commitment, rewindNonceHash));
+	std::vector<SecretKey> nonces;
+	nonces.reserve(commitments.size());
+	for (const Commitment& commitment : commitments)
+	{
+		nonces.push_back(CreateNonce(commitment, rewindNonceHash));
 	}
 
-	throw UNIMPLEMENTED_EXCEPTION;
+	return Crypto::RewindRangeProofs(commitments, rangeProofs, nonces);
 }
 
 RangeProof KeyChain::GenerateRangeProof(
@@ -93,10 +143,7 @@ RangeProof KeyChain::GenerateRangeProof(
 	{
 		const SecretKey privateNonceHash = Hasher::Blake2b(m_masterKey.GetPrivateKey().GetVec());
 
-		PublicKey masterPublicKey = Crypto::CalculatePublicKey(m_masterKey.GetPrivateKey());
-		const SecretKey rewindNonceHash = Hasher::Blake2b(masterPublicKey.GetCompressedVec());
-
-		return Crypto::GenerateRangeProof(amount, blindingFactor, CreateNonce(commitment, privateNonceHash), CreateNonce(commitment, rewindNonceHash), proofMessage);
+		return Crypto::GenerateRangeProof(amount, blindingFactor, CreateNonce(commitment, privateNonceHash), CreateNonce(commitment, m_enhancedRewindNonceHash), proofMessage);
 	}
 	
 	throw UNIMPLEMENTED_EXCEPTION;
@@ -105,4 +152,18 @@ RangeProof KeyChain::GenerateRangeProof(
 SecretKey KeyChain::CreateNonce(const Commitment& commitment, const SecretKey& nonceHash) const
 {
 	return Hasher::Blake2b(commitment.GetVec(), nonceHash.GetVec());
+}
+
+const SecretKey& KeyChain::GetRewindNonceHash(const EBulletproofType& bulletproofType) const
+{
+	if (bulletproofType == EBulletproofType::ORIGINAL)
+	{
+		return m_bulletProofNonce;
+	}
+	else if (bulletproofType == EBulletproofType::ENHANCED)
+	{
+		return m_enhancedRewindNonceHash;
+	}
+
+	throw UNIMPLEMENTED_EXCEPTION;
 }
\ No newline at end of file
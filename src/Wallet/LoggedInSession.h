@@ -2,15 +2,46 @@
 
 #include "WalletImpl.h"
 #include <Wallet/Wallet.h>
+#include <Wallet/SessionToken.h>
+#include <Wallet/Exceptions/SessionTokenException.h>
 
 #include <Common/Secure.h>
+#include <Crypto/Hasher.h>
 
 struct LoggedInSession
 {
 	LoggedInSession(const Locked<Wallet>& wallet, const Locked<WalletImpl>& walletImpl, SecureVector&& encryptedSeedWithCS)
-		: m_wallet(wallet), m_walletImpl(walletImpl), m_encryptedSeedWithCS(std::move(encryptedSeedWithCS)) { }
+		: m_wallet(wallet),
+		m_walletImpl(walletImpl),
+		m_pRestoreProgress(walletImpl.Read()->GetRestoreProgress()),
+		m_encryptedSeedWithCS(std::move(encryptedSeedWithCS)) { }
+
+	//
+	// Decrypts the seed with the session's token key. Throws SessionTokenException if the checksum doesn't match.
+	//
+	SecureVector DecryptSeed(const SessionToken& token) const
+	{
+		std::vector<unsigned char> seedWithCS(m_encryptedSeedWithCS.size());
+		for (size_t i = 0; i < seedWithCS.size(); i++)
+		{
+			seedWithCS[i] = m_encryptedSeedWithCS[i] ^ token.GetTokenKey()[i];
+		}
+
+		SecureVector seed(seedWithCS.cbegin(), seedWithCS.cbegin() + seedWithCS.size() - 4);
+		CBigInteger<32> hash = Hasher::SHA256((const std::vector<unsigned char>&)seed);
+		for (int i = 0; i < 4; i++)
+		{
+			if (seedWithCS[(seedWithCS.size() - 4) + i] != hash[i])
+			{
+				throw SessionTokenException();
+			}
+		}
+
+		return seed;
+	}
 
 	Locked<Wallet> m_wallet;
 	Locked<WalletImpl> m_walletImpl;
+	RestoreProgress::Ptr m_pRestoreProgress;
 	SecureVector m_encryptedSeedWithCS;
-};
\ No newline at end of file
+};
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <Wallet/WalletDB/Models/OutputDataEntity.h>
+#include <Crypto/Commitment.h>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+//
+// The outputs selected by sends that are still being built, and so aren't LOCKED in the wallet database yet.
+// Shared between concurrent sends from the same wallet, so only coin selection needs to be serialized, not the whole slate build.
+//
+class OutputReservations
+{
+public:
+	using Ptr = std::shared_ptr<OutputReservations>;
+
+	std::unordered_set<Commitment> GetReserved() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_reserved;
+	}
+
+	//
+	// Reserves every one of the outputs, or none of them if any is already reserved.
+	//
+	bool TryReserve(const std::vector<OutputDataEntity>& outputs)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (const OutputDataEntity& output : outputs)
+		{
+			if (m_reserved.find(output.GetCommitment()) != m_reserved.end())
+			{
+				return false;
+			}
+		}
+
+		for (const OutputDataEntity& output : outputs)
+		{
+			m_reserved.insert(output.GetCommitment());
+		}
+
+		return true;
+	}
+
+	void Release(const std::vector<Commitment>& commitments)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (const Commitment& commitment : commitments)
+		{
+			m_reserved.erase(commitment);
+		}
+	}
+
+private:
+	mutable std::mutex m_mutex;
+	std::unordered_set<Commitment> m_reserved;
+};
+
+//
+// Releases the reserved outputs when it goes out of scope, once the send has either LOCKED them in the database or failed.
+//
+class OutputReservation
+{
+public:
+	OutputReservation(const OutputReservations::Ptr& pReservations, const std::vector<OutputDataEntity>& outputs)
+		: m_pReservations(pReservations)
+	{
+		for (const OutputDataEntity& output : outputs)
+		{
+			m_commitments.push_back(output.GetCommitment());
+		}
+	}
+
+	~OutputReservation()
+	{
+		m_pReservations->Release(m_commitments);
+	}
+
+	OutputReservation(const OutputReservation&) = delete;
+	OutputReservation& operator=(const OutputReservation&) = delete;
+
+private:
+	OutputReservations::Ptr m_pReservations;
+	std::vector<Commitment> m_commitments;
+};
@@ -5,107 +5,226 @@
 #include <Consensus/BlockTime.h>
 #include <Consensus/HardForks.h>
 #include <Common/Logger.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <atomic>
+#include <future>
 
 static const uint64_t NUM_OUTPUTS_PER_BATCH = 1000;
 
-std::vector<OutputDataEntity> OutputRestorer::FindAndRewindOutputs(const std::shared_ptr<IWalletDB>& pBatch, const bool fromGenesis) const
+// Outputs are rewound in chunks of this size, each as a single batched call into secp256k1.
+// Rewinding is cheap enough that splitting a batch finer than this costs more in scheduling than it saves.
+static const size_t NUM_OUTPUTS_PER_REWIND = 50;
+
+std::vector<OutputDataEntity> OutputRestorer::FindAndRewindOutputs(uint64_t& restoreLeafIndex, const bool fromGenesis, const Checkpoint& checkpoint) const
 {
 	const uint64_t chainHeight = m_pNodeClient->GetChainHeight();
 
-	uint64_t nextLeafIndex = fromGenesis ? 0 : pBatch->GetRestoreLeafIndex() + 1;
-	uint64_t highestIndex = 0;
+	uint64_t nextLeafIndex = fromGenesis ? 0 : restoreLeafIndex + 1;
+	m_pProgress->Start(nextLeafIndex);
+
+	std::unique_ptr<OutputScanBatch> pBatch = m_pNodeClient->ScanOutputs(nextLeafIndex, NUM_OUTPUTS_PER_BATCH);
+	if (pBatch == nullptr || pBatch->GetLastRetrievedIndex() == 0) {
+		// No new outputs since last restore
+		m_pProgress->Finish();
+		return std::vector<OutputDataEntity>();
+	}
+
+	// Cache this, rather than use the new response from pBatch.
+	// Otherwise, pBatch->GetHighestIndex() could continue to rise slowly during sync, tying up this thread.
+	const uint64_t highestIndex = pBatch->GetHighestIndex();
+	m_pProgress->SetHighestLeafIndex(highestIndex);
 
 	std::vector<OutputDataEntity> walletOutputs;
-	while (true)
+	size_t numBatches = 0;
+	try
 	{
-		std::unique_ptr<OutputRange> pOutputRange = m_pNodeClient->GetOutputsByLeafIndex(nextLeafIndex, NUM_OUTPUTS_PER_BATCH);
-		if (pOutputRange == nullptr || pOutputRange->GetLastRetrievedIndex() == 0) {
-			// No new outputs since last restore
-			return std::vector<OutputDataEntity>();
-		}
-
-		const std::vector<OutputDTO>& outputs = pOutputRange->GetOutputs();
-		for (const OutputDTO& output : outputs)
+		while (true)
 		{
-			std::unique_ptr<OutputDataEntity> pOutputDataEntity = GetWalletOutput(output, chainHeight);
-			if (pOutputDataEntity != nullptr) {
-				walletOutputs.emplace_back(*pOutputDataEntity);
+			nextLeafIndex = pBatch->GetLastRetrievedIndex() + 1;
+
+			// Fetch the next batch while this one is being rewound.
+			std::future<std::unique_ptr<OutputScanBatch>> nextBatch;
+			if (nextLeafIndex <= highestIndex) {
+				nextBatch = std::async(std::launch::async, [this, nextLeafIndex]() {
+					return m_pNodeClient->ScanOutputs(nextLeafIndex, NUM_OUTPUTS_PER_BATCH);
+				});
 			}
-		}
 
-		if (highestIndex == 0) {
-			// Cache this, rather than use the new response from pOutputRange.
-			// Otherwise, pOutputRange->GetHighestIndex() could continue to rise slowly during sync, tying up this thread.
-			highestIndex = pOutputRange->GetHighestIndex();
-		}
+			std::vector<OutputDataEntity> found = RewindOutputs(pBatch->GetOutputs(), chainHeight);
+			m_pProgress->Update(nextLeafIndex, found.size());
+			walletOutputs.insert(walletOutputs.end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+
+			if (!nextBatch.valid()) {
+				break;
+			}
+
+			// The last batch is left to the caller, which commits it along with everything else.
+			if (++numBatches % NUM_BATCHES_PER_CHECKPOINT == 0 && checkpoint) {
+				checkpoint(walletOutputs, nextLeafIndex - 1);
+				walletOutputs.clear();
+			}
+
+			pBatch = nextBatch.get();
+			if (pBatch == nullptr) {
+				m_pProgress->Finish();
+				return std::vector<OutputDataEntity>();
+			}
 
-		nextLeafIndex = pOutputRange->GetLastRetrievedIndex() + 1;
-		if (nextLeafIndex > highestIndex) {
-			break;
+			if (pBatch->GetLastRetrievedIndex() == 0) {
+				// Every remaining output up to highestIndex has been spent.
+				nextLeafIndex = highestIndex + 1;
+				break;
+			}
 		}
 	}
+	catch (...)
+	{
+		m_pProgress->Finish();
+		throw;
+	}
 
-	pBatch->UpdateRestoreLeafIndex(nextLeafIndex - 1);
+	restoreLeafIndex = nextLeafIndex - 1;
+	m_pProgress->Finish();
 
 	return walletOutputs;
 }
 
-std::unique_ptr<OutputDataEntity> OutputRestorer::GetWalletOutput(const OutputDTO& output, const uint64_t currentBlockHeight) const
+std::vector<OutputDataEntity> OutputRestorer::RewindOutputs(const std::vector<OutputDTO>& outputs, const uint64_t currentBlockHeight) const
 {
-	EBulletproofType type = EBulletproofType::ORIGINAL;
-	std::unique_ptr<RewoundProof> pRewoundProof = nullptr;
-	const uint64_t outputBlockHeight = output.GetLocation().GetBlockHeight();
-	if (Consensus::GetHeaderVersion(m_config.GetEnvironment().GetType(), ((std::max)(outputBlockHeight, 2 * Consensus::WEEK_HEIGHT) - (2 * Consensus::WEEK_HEIGHT))) == 1)
+	std::vector<std::unique_ptr<OutputDataEntity>> results(outputs.size());
+
+	const size_t numChunks = (outputs.size() + NUM_OUTPUTS_PER_REWIND - 1) / NUM_OUTPUTS_PER_REWIND;
+	std::atomic_size_t nextChunk = 0;
+	auto worker = [this, &outputs, &results, &nextChunk, numChunks, currentBlockHeight]() {
+		for (size_t chunk = nextChunk++; chunk < numChunks; chunk = nextChunk++)
+		{
+			const size_t begin = chunk * NUM_OUTPUTS_PER_REWIND;
+			const size_t end = (std::min)(begin + NUM_OUTPUTS_PER_REWIND, outputs.size());
+			RewindChunk(outputs, begin, end, currentBlockHeight, results);
+		}
+	};
+
+	// Restores are background work, so they yield to block and transaction validation.
+	const size_t numWorkers = (std::max)((size_t)1, numChunks);
+	ThreadManagerAPI::GetThreadPool().RunParallel(numWorkers, worker, ETaskPriority::LOW);
+
+	std::vector<OutputDataEntity> walletOutputs;
+	for (std::unique_ptr<OutputDataEntity>& pOutputDataEntity : results)
 	{
-		pRewoundProof = m_keyChain.RewindRangeProof(output.GetIdentifier().GetCommitment(), output.GetRangeProof(), EBulletproofType::ORIGINAL);
+		if (pOutputDataEntity != nullptr) {
+			walletOutputs.emplace_back(std::move(*pOutputDataEntity));
+		}
 	}
 
-	if (pRewoundProof == nullptr)
+	return walletOutputs;
+}
+
+void OutputRestorer::RewindChunk(
+	const std::vector<OutputDTO>& outputs,
+	const size_t begin,
+	const size_t end,
+	const uint64_t currentBlockHeight,
+	std::vector<std::unique_ptr<OutputDataEntity>>& results) const
+{
+	// Outputs created before the second hard fork may use either proof type, so ORIGINAL is tried first.
+	std::vector<size_t> originalIndices;
+	std::vector<size_t> enhancedIndices;
+	for (size_t i = begin; i < end; i++)
 	{
-		type = EBulletproofType::ENHANCED;
-		pRewoundProof = m_keyChain.RewindRangeProof(output.GetIdentifier().GetCommitment(), output.GetRangeProof(), EBulletproofType::ENHANCED);
+		const uint64_t outputBlockHeight = outputs[i].GetLocation().GetBlockHeight();
+		if (Consensus::GetHeaderVersion(m_config.GetEnvironment().GetType(), ((std::max)(outputBlockHeight, 2 * Consensus::WEEK_HEIGHT) - (2 * Consensus::WEEK_HEIGHT))) == 1)
+		{
+			originalIndices.push_back(i);
+		}
+		else
+		{
+			enhancedIndices.push_back(i);
+		}
 	}
 
-	if (pRewoundProof != nullptr)
+	std::vector<std::unique_ptr<RewoundProof>> originalProofs = RewindRangeProofs(outputs, originalIndices, EBulletproofType::ORIGINAL);
+	for (size_t i = 0; i < originalIndices.size(); i++)
 	{
-		WALLET_INFO_F("Found own output: {}", output.GetIdentifier().GetCommitment());
-
-		KeyChainPath keyChainPath(pRewoundProof->GetProofMessage().ToKeyIndices(type));
-		const std::unique_ptr<SecretKey>& pBlindingFactor = pRewoundProof->GetBlindingFactor();
-		BlindingFactor blindingFactor(ZERO_HASH);
-		if (pBlindingFactor != nullptr && type == EBulletproofType::ORIGINAL)
+		if (originalProofs[i] != nullptr)
 		{
-			blindingFactor = pBlindingFactor->GetBytes();
+			results[originalIndices[i]] = GetWalletOutput(outputs[originalIndices[i]], *originalProofs[i], EBulletproofType::ORIGINAL, currentBlockHeight);
 		}
 		else
 		{
-			blindingFactor = m_keyChain.DerivePrivateKey(keyChainPath, pRewoundProof->GetAmount()).GetBytes();
+			enhancedIndices.push_back(originalIndices[i]);
+		}
+	}
+
+	std::vector<std::unique_ptr<RewoundProof>> enhancedProofs = RewindRangeProofs(outputs, enhancedIndices, EBulletproofType::ENHANCED);
+	for (size_t i = 0; i < enhancedIndices.size(); i++)
+	{
+		if (enhancedProofs[i] != nullptr)
+		{
+			results[enhancedIndices[i]] = GetWalletOutput(outputs[enhancedIndices[i]], *enhancedProofs[i], EBulletproofType::ENHANCED, currentBlockHeight);
 		}
+	}
+}
 
-		TransactionOutput txOutput(
-			output.GetIdentifier().GetFeatures(),
-			Commitment(output.GetIdentifier().GetCommitment()),
-			RangeProof(output.GetRangeProof())
-		);
-		const uint64_t amount = pRewoundProof->GetAmount();
-		const EOutputStatus status = DetermineStatus(output, currentBlockHeight);
-		const uint64_t mmrIndex = output.GetLocation().GetMMRIndex();
-		const uint64_t blockHeight = output.GetLocation().GetBlockHeight();
-
-		return std::make_unique<OutputDataEntity>(
-			std::move(keyChainPath), 
-			blindingFactor.ToSecretKey(), 
-			std::move(txOutput), 
-			amount, 
-			status, 
-			std::make_optional(mmrIndex), 
-			std::make_optional(blockHeight),
-			std::nullopt,
-			std::nullopt
-		);
+std::vector<std::unique_ptr<RewoundProof>> OutputRestorer::RewindRangeProofs(
+	const std::vector<OutputDTO>& outputs,
+	const std::vector<size_t>& indices,
+	const EBulletproofType type) const
+{
+	std::vector<Commitment> commitments;
+	std::vector<const RangeProof*> rangeProofs;
+	commitments.reserve(indices.size());
+	rangeProofs.reserve(indices.size());
+	for (const size_t index : indices)
+	{
+		commitments.push_back(outputs[index].GetIdentifier().GetCommitment());
+		rangeProofs.push_back(&outputs[index].GetRangeProof());
+	}
+
+	return m_keyChain.RewindRangeProofs(commitments, rangeProofs, type);
+}
+
+std::unique_ptr<OutputDataEntity> OutputRestorer::GetWalletOutput(
+	const OutputDTO& output,
+	const RewoundProof& rewoundProof,
+	const EBulletproofType type,
+	const uint64_t currentBlockHeight) const
+{
+	WALLET_INFO_F("Found own output: {}", output.GetIdentifier().GetCommitment());
+
+	KeyChainPath keyChainPath(rewoundProof.GetProofMessage().ToKeyIndices(type));
+	const std::unique_ptr<SecretKey>& pBlindingFactor = rewoundProof.GetBlindingFactor();
+	BlindingFactor blindingFactor(ZERO_HASH);
+	if (pBlindingFactor != nullptr && type == EBulletproofType::ORIGINAL)
+	{
+		blindingFactor = pBlindingFactor->GetBytes();
+	}
+	else
+	{
+		blindingFactor = m_keyChain.DerivePrivateKey(keyChainPath, rewoundProof.GetAmount()).GetBytes();
 	}
 
-	return nullptr;
+	TransactionOutput txOutput(
+		output.GetIdentifier().GetFeatures(),
+		Commitment(output.GetIdentifier().GetCommitment()),
+		RangeProof(output.GetRangeProof())
+	);
+	const uint64_t amount = rewoundProof.GetAmount();
+	const EOutputStatus status = DetermineStatus(output, currentBlockHeight);
+	const uint64_t mmrIndex = output.GetLocation().GetMMRIndex();
+	const uint64_t blockHeight = output.GetLocation().GetBlockHeight();
+
+	return std::make_unique<OutputDataEntity>(
+		std::move(keyChainPath), 
+		blindingFactor.ToSecretKey(), 
+		std::move(txOutput), 
+		amount, 
+		status, 
+		std::make_optional(mmrIndex), 
+		std::make_optional(blockHeight),
+		std::nullopt,
+		std::nullopt
+	);
 }
 
 EOutputStatus OutputRestorer::DetermineStatus(const OutputDTO& output, const uint64_t currentBlockHeight) const
@@ -5,6 +5,11 @@
 #include <Wallet/WalletDB/Models/OutputDataEntity.h>
 #include <Config/Config.h>
 #include <Core/Models/DTOs/OutputDTO.h>
+#include <Core/Models/DTOs/OutputScanBatch.h>
+#include <Crypto/RewoundProof.h>
+#include <Crypto/BulletproofType.h>
+#include "RestoreProgress.h"
+#include <functional>
 
 // Forward Declarations
 class KeyChain;
@@ -12,17 +17,58 @@ class KeyChain;
 class OutputRestorer
 {
 public:
-	OutputRestorer(const Config& config, INodeClientConstPtr pNodeClient, const KeyChain& keyChain)
-		: m_config(config), m_pNodeClient(pNodeClient), m_keyChain(keyChain) { }
+	using Checkpoint = std::function<void(std::vector<OutputDataEntity>& found, const uint64_t lastScannedIndex)>;
 
+	// 100k outputs, so a checkpoint's write is small next to the scan between them.
+	static const size_t NUM_BATCHES_PER_CHECKPOINT = 100;
+
+	OutputRestorer(const Config& config, INodeClientConstPtr pNodeClient, const KeyChain& keyChain, const RestoreProgress::Ptr& pProgress)
+		: m_config(config), m_pNodeClient(pNodeClient), m_keyChain(keyChain), m_pProgress(pProgress) { }
+
+	//
+	// Scans the outputs added since the last restore (or every output, if fromGenesis) for ones belonging to the wallet.
+	// The next batch is fetched from the node while the current one is rewound, and rewinds are spread over the worker pool.
+	// Batches come from INodeClient::ScanOutputs, so an in-process node hands them over without copying the rangeproofs.
+	// restoreLeafIndex is the last leaf index already scanned, and is updated to the last one scanned by this call.
+	// It doesn't touch the wallet database itself, so no lock is needed while it waits on the node.
+	// Every NUM_BATCHES_PER_CHECKPOINT batches, the outputs found so far are handed to checkpoint along with the last leaf index scanned,
+	// so they can be persisted. Only the outputs found after the last checkpoint are returned.
+	//
 	std::vector<OutputDataEntity> FindAndRewindOutputs(
-		const std::shared_ptr<IWalletDB>& pBatch,
-		const bool fromGenesis
+		uint64_t& restoreLeafIndex,
+		const bool fromGenesis,
+		const Checkpoint& checkpoint
+	) const;
+
+	//
+	// Rewinds a batch of scanned outputs, returning the ones belonging to the wallet. Used directly by OutputScanner,
+	// which fetches each batch once and rewinds it for every logged in wallet.
+	//
+	std::vector<OutputDataEntity> RewindOutputs(
+		const std::vector<OutputDTO>& outputs,
+		const uint64_t currentBlockHeight
 	) const;
 
 private:
+
+	void RewindChunk(
+		const std::vector<OutputDTO>& outputs,
+		const size_t begin,
+		const size_t end,
+		const uint64_t currentBlockHeight,
+		std::vector<std::unique_ptr<OutputDataEntity>>& results
+	) const;
+
+	std::vector<std::unique_ptr<RewoundProof>> RewindRangeProofs(
+		const std::vector<OutputDTO>& outputs,
+		const std::vector<size_t>& indices,
+		const EBulletproofType type
+	) const;
+
 	std::unique_ptr<OutputDataEntity> GetWalletOutput(
 		const OutputDTO& output,
+		const RewoundProof& rewoundProof,
+		const EBulletproofType type,
 		const uint64_t currentBlockHeight
 	) const;
 
@@ -34,4 +80,5 @@ private:
 	const Config& m_config;
 	INodeClientConstPtr m_pNodeClient;
 	const KeyChain& m_keyChain;
+	RestoreProgress::Ptr m_pProgress;
 };
\ No newline at end of file
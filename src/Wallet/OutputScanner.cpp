@@ -0,0 +1,297 @@
+#include "OutputScanner.h"
+#include "OutputRestorer.h"
+#include "WalletRefresher.h"
+
+#include <Wallet/Keychain/KeyChain.h>
+#include <Common/Logger.h>
+#include <Common/ThreadManager.h>
+#include <Common/Util/ThreadUtil.h>
+#include <algorithm>
+#include <future>
+#include <unordered_set>
+
+// Same batch size as OutputRestorer.
+static const uint64_t NUM_OUTPUTS_PER_BATCH = 1000;
+
+// How often the chain height is checked for new blocks.
+static const std::chrono::seconds SCAN_INTERVAL(1);
+
+//
+// A wallet being scanned, with the keychain its outputs are rewound with and the outputs found so far.
+//
+struct OutputScanner::Target
+{
+	Target(
+		const Config& config,
+		const INodeClientConstPtr& pNodeClient,
+		SecureVector&& masterSeed,
+		const Locked<IWalletDB>& walletDB,
+		const RestoreProgress::Ptr& pProgress,
+		const uint64_t restoreLeafIndex)
+		: m_masterSeed(std::move(masterSeed)),
+		m_walletDB(walletDB),
+		m_pProgress(pProgress),
+		m_keyChain(KeyChain::FromSeed(config, m_masterSeed)),
+		m_restorer(config, pNodeClient, m_keyChain, pProgress),
+		m_restoreLeafIndex(restoreLeafIndex) { }
+
+	SecureVector m_masterSeed;
+	Locked<IWalletDB> m_walletDB;
+	RestoreProgress::Ptr m_pProgress;
+	KeyChain m_keyChain;
+	OutputRestorer m_restorer;
+	uint64_t m_restoreLeafIndex;
+	std::vector<OutputDataEntity> m_found;
+};
+
+std::unique_ptr<OutputScanner> OutputScanner::Create(const Config& config, const INodeClientConstPtr& pNodeClient)
+{
+	std::unique_ptr<OutputScanner> pScanner(new OutputScanner(config, pNodeClient));
+	pScanner->m_scanThread = std::thread(Thread_Scan, std::ref(*pScanner.get()));
+	return pScanner;
+}
+
+OutputScanner::~OutputScanner()
+{
+	LOG_INFO("Shutting down output scanner");
+	m_terminate = true;
+	ThreadUtil::Join(m_scanThread);
+}
+
+void OutputScanner::AddWallet(const SessionToken& token, const std::shared_ptr<LoggedInSession>& pSession)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_walletsMutex);
+		m_walletsBySessionId.insert_or_assign(token.GetSessionId(), std::make_pair(token, pSession));
+	}
+
+	m_walletAdded = true;
+}
+
+void OutputScanner::RemoveWallet(const SessionToken& token)
+{
+	std::unique_lock<std::mutex> lock(m_walletsMutex);
+	m_walletsBySessionId.erase(token.GetSessionId());
+}
+
+//
+// Checks the chain height, and scans for every wallet whenever it changes or a wallet logs in.
+// This function operates in its own thread.
+//
+void OutputScanner::Thread_Scan(OutputScanner& scanner)
+{
+	ThreadManagerAPI::SetCurrentThreadName("OUTPUT_SCAN");
+	LOG_TRACE("BEGIN");
+
+	uint64_t lastScannedHeight = 0;
+	while (!scanner.m_terminate)
+	{
+		try
+		{
+			const bool walletAdded = scanner.m_walletAdded.exchange(false);
+			const uint64_t chainHeight = scanner.m_pNodeClient->GetChainHeight();
+			if (walletAdded || chainHeight != lastScannedHeight)
+			{
+				scanner.Scan(chainHeight);
+				lastScannedHeight = chainHeight;
+			}
+		}
+		catch (std::exception& e)
+		{
+			WALLET_WARNING_F("Exception thrown: {}", e.what());
+		}
+
+		ThreadUtil::SleepFor(SCAN_INTERVAL, scanner.m_terminate);
+	}
+
+	LOG_TRACE("END");
+}
+
+void OutputScanner::Scan(const uint64_t chainHeight)
+{
+	std::vector<std::pair<SessionToken, std::shared_ptr<LoggedInSession>>> wallets;
+	{
+		std::unique_lock<std::mutex> lock(m_walletsMutex);
+		for (const auto& entry : m_walletsBySessionId)
+		{
+			wallets.push_back(entry.second);
+		}
+	}
+
+	// Sessions of the same user share a wallet database, so each user is only scanned once.
+	std::unordered_set<std::string> usernames;
+	std::vector<std::unique_ptr<Target>> targets;
+	for (const auto& wallet : wallets)
+	{
+		const std::shared_ptr<LoggedInSession>& pSession = wallet.second;
+		try
+		{
+			Locked<IWalletDB> walletDB = pSession->m_walletImpl.Read()->GetDatabase();
+			if (!usernames.insert(pSession->m_walletImpl.Read()->GetUsername()).second)
+			{
+				continue;
+			}
+
+			uint64_t restoreLeafIndex = 0;
+			{
+				// Like WalletRefresher, wallets are skipped while the node resyncs, and once they've been refreshed at this height.
+				auto pReader = walletDB.Read();
+				if (chainHeight <= pReader->GetRefreshBlockHeight())
+				{
+					continue;
+				}
+
+				restoreLeafIndex = pReader->GetRestoreLeafIndex();
+			}
+
+			targets.push_back(std::make_unique<Target>(
+				m_config,
+				m_pNodeClient,
+				pSession->DecryptSeed(wallet.first),
+				walletDB,
+				pSession->m_pRestoreProgress,
+				restoreLeafIndex
+			));
+		}
+		catch (std::exception& e)
+		{
+			WALLET_WARNING_F("Failed to load wallet for output scan. Error: {}", e.what());
+		}
+	}
+
+	if (targets.empty())
+	{
+		return;
+	}
+
+	uint64_t nextLeafIndex = (*std::min_element(
+		targets.cbegin(), targets.cend(),
+		[](const auto& pLeft, const auto& pRight) { return pLeft->m_restoreLeafIndex < pRight->m_restoreLeafIndex; }
+	))->m_restoreLeafIndex + 1;
+
+	WALLET_DEBUG_F("Scanning outputs from leaf index {} for {} wallets", nextLeafIndex, targets.size());
+	for (const auto& pTarget : targets)
+	{
+		pTarget->m_pProgress->Start(pTarget->m_restoreLeafIndex + 1);
+	}
+
+	// The last leaf index scanned for every wallet. Each wallet's own restore index is kept if it's already past it.
+	uint64_t scannedIndex = 0;
+	try
+	{
+		std::unique_ptr<OutputScanBatch> pBatch = m_pNodeClient->ScanOutputs(nextLeafIndex, NUM_OUTPUTS_PER_BATCH);
+		if (pBatch == nullptr)
+		{
+			for (const auto& pTarget : targets)
+			{
+				pTarget->m_pProgress->Finish();
+			}
+
+			return;
+		}
+
+		if (pBatch->GetLastRetrievedIndex() != 0)
+		{
+			// Cached for the same reason as in OutputRestorer, so the scan doesn't chase the tip during sync.
+			const uint64_t highestIndex = pBatch->GetHighestIndex();
+			for (const auto& pTarget : targets)
+			{
+				pTarget->m_pProgress->SetHighestLeafIndex(highestIndex);
+			}
+
+			size_t numBatches = 0;
+			while (true)
+			{
+				nextLeafIndex = pBatch->GetLastRetrievedIndex() + 1;
+
+				// Fetch the next batch while this one is being rewound.
+				std::future<std::unique_ptr<OutputScanBatch>> nextBatch;
+				if (nextLeafIndex <= highestIndex) {
+					nextBatch = std::async(std::launch::async, [this, nextLeafIndex]() {
+						return m_pNodeClient->ScanOutputs(nextLeafIndex, NUM_OUTPUTS_PER_BATCH);
+					});
+				}
+
+				for (const auto& pTarget : targets)
+				{
+					// Batches a wallet already scanned are skipped. One it only partly scanned is rewound whole,
+					// since outputs a wallet already has are ignored when the scan is applied.
+					if (pBatch->GetLastRetrievedIndex() > pTarget->m_restoreLeafIndex)
+					{
+						std::vector<OutputDataEntity> found = pTarget->m_restorer.RewindOutputs(pBatch->GetOutputs(), chainHeight);
+						pTarget->m_pProgress->Update(nextLeafIndex, found.size());
+						pTarget->m_found.insert(pTarget->m_found.end(), std::make_move_iterator(found.begin()), std::make_move_iterator(found.end()));
+					}
+				}
+
+				if (!nextBatch.valid()) {
+					break;
+				}
+
+				// Checkpointed the same way as a wallet's own restore, so a long scan isn't repeated if it's interrupted.
+				if (++numBatches % OutputRestorer::NUM_BATCHES_PER_CHECKPOINT == 0) {
+					for (const auto& pTarget : targets)
+					{
+						if (nextLeafIndex - 1 > pTarget->m_restoreLeafIndex)
+						{
+							WalletRefresher(m_config, m_pNodeClient, pTarget->m_pProgress).Checkpoint(
+								pTarget->m_masterSeed,
+								pTarget->m_walletDB,
+								pTarget->m_found,
+								nextLeafIndex - 1,
+								false
+							);
+							pTarget->m_found.clear();
+						}
+					}
+				}
+
+				pBatch = nextBatch.get();
+				if (pBatch == nullptr || m_terminate) {
+					for (const auto& pTarget : targets)
+					{
+						pTarget->m_pProgress->Finish();
+					}
+
+					return;
+				}
+
+				if (pBatch->GetLastRetrievedIndex() == 0) {
+					// Every remaining output up to highestIndex has been spent.
+					nextLeafIndex = highestIndex + 1;
+					break;
+				}
+			}
+
+			scannedIndex = nextLeafIndex - 1;
+		}
+	}
+	catch (...)
+	{
+		for (const auto& pTarget : targets)
+		{
+			pTarget->m_pProgress->Finish();
+		}
+
+		throw;
+	}
+
+	for (const auto& pTarget : targets)
+	{
+		pTarget->m_pProgress->Finish();
+
+		try
+		{
+			WalletRefresher(m_config, m_pNodeClient, pTarget->m_pProgress).ApplyScan(
+				pTarget->m_masterSeed,
+				pTarget->m_walletDB,
+				std::move(pTarget->m_found),
+				(std::max)(pTarget->m_restoreLeafIndex, scannedIndex)
+			);
+		}
+		catch (std::exception& e)
+		{
+			WALLET_WARNING_F("Failed to apply output scan. Error: {}", e.what());
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "LoggedInSession.h"
+
+#include <Config/Config.h>
+#include <Wallet/NodeClient.h>
+#include <Wallet/SessionToken.h>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+//
+// Scans the outputs added to the chain for every logged in wallet at once.
+// Each time the chain height changes, the new outputs are fetched from the node a single time,
+// and each batch is rewound with every wallet's keychain, so each additional wallet only adds the cost of its rewinds.
+// The outputs found are written to the wallet they belong to, the same as its own refresh would,
+// so refreshes requested through the wallet API usually find nothing left to scan.
+//
+// Like the foreign listener, each wallet is kept by its session token, so its seed is only decrypted for the length of a scan.
+//
+class OutputScanner
+{
+public:
+	static std::unique_ptr<OutputScanner> Create(const Config& config, const INodeClientConstPtr& pNodeClient);
+	~OutputScanner();
+
+	void AddWallet(const SessionToken& token, const std::shared_ptr<LoggedInSession>& pSession);
+	void RemoveWallet(const SessionToken& token);
+
+private:
+	OutputScanner(const Config& config, const INodeClientConstPtr& pNodeClient)
+		: m_config(config), m_pNodeClient(pNodeClient), m_terminate(false), m_walletAdded(false) { }
+
+	struct Target;
+
+	static void Thread_Scan(OutputScanner& scanner);
+	void Scan(const uint64_t chainHeight);
+
+	const Config& m_config;
+	INodeClientConstPtr m_pNodeClient;
+
+	mutable std::mutex m_walletsMutex;
+	std::unordered_map<uint64_t, std::pair<SessionToken, std::shared_ptr<LoggedInSession>>> m_walletsBySessionId;
+
+	std::atomic_bool m_terminate;
+
+	// Set when a wallet logs in, so it's caught up without waiting for the next block.
+	std::atomic_bool m_walletAdded;
+	std::thread m_scanThread;
+};
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Wallet/Models/DTOs/RestoreProgressDTO.h>
+#include <atomic>
+#include <memory>
+
+//
+// Progress of the output scan run by OutputRestorer.
+// Shared between the wallet doing the scan and its session, so it can be read without waiting on the wallet lock.
+//
+class RestoreProgress
+{
+public:
+	using Ptr = std::shared_ptr<RestoreProgress>;
+
+	RestoreProgress()
+		: m_scanning(false), m_nextLeafIndex(0), m_highestLeafIndex(0), m_outputsFound(0) { }
+
+	void Start(const uint64_t nextLeafIndex)
+	{
+		m_nextLeafIndex = nextLeafIndex;
+		m_highestLeafIndex = 0;
+		m_outputsFound = 0;
+		m_scanning = true;
+	}
+
+	void SetHighestLeafIndex(const uint64_t highestLeafIndex) { m_highestLeafIndex = highestLeafIndex; }
+
+	void Update(const uint64_t nextLeafIndex, const uint64_t outputsFound)
+	{
+		m_nextLeafIndex = nextLeafIndex;
+		m_outputsFound += outputsFound;
+	}
+
+	void Finish() { m_scanning = false; }
+
+	RestoreProgressDTO ToDTO() const
+	{
+		return RestoreProgressDTO(m_scanning, m_nextLeafIndex, m_highestLeafIndex, m_outputsFound);
+	}
+
+private:
+	std::atomic_bool m_scanning;
+	std::atomic<uint64_t> m_nextLeafIndex;
+	std::atomic<uint64_t> m_highestLeafIndex;
+	std::atomic<uint64_t> m_outputsFound;
+};
@@ -0,0 +1,88 @@
+#include "SeedUnlocker.h"
+#include "Keychain/SeedEncrypter.h"
+
+#include <Common/Logger.h>
+#include <Crypto/AES256.h>
+#include <Crypto/CSPRNG.h>
+#include <Crypto/Hasher.h>
+#include <Wallet/WalletDB/WalletStore.h>
+
+SeedUnlocker::Ptr SeedUnlocker::Create(const Config& config, const std::shared_ptr<IWalletStore>& pWalletStore)
+{
+	ThreadPool::Ptr pKdfPool = ThreadPool::Create("KDF", config.GetWalletConfig().GetKdfThreads());
+	return std::make_shared<SeedUnlocker>(pWalletStore, pKdfPool);
+}
+
+EncryptedSeed SeedUnlocker::Encrypt(const SecureVector& walletSeed, const SecureString& password) const
+{
+	return m_pKdfPool->Submit([&walletSeed, &password]() {
+		return SeedEncrypter::EncryptWalletSeed(walletSeed, password);
+	}).get();
+}
+
+SecureVector SeedUnlocker::Unlock(const std::string& username, const SecureString& password) const
+{
+	std::unique_ptr<SecureVector> pRemembered = GetRemembered(username, password);
+	if (pRemembered != nullptr)
+	{
+		WALLET_DEBUG_F("Unlocked remembered seed for {}", username);
+		return *pRemembered;
+	}
+
+	const EncryptedSeed encryptedSeed = m_pWalletStore->LoadWalletSeed(username);
+	return m_pKdfPool->Submit([&encryptedSeed, &password]() {
+		return SeedEncrypter::DecryptWalletSeed(encryptedSeed, password);
+	}).get();
+}
+
+void SeedUnlocker::Remember(const std::string& username, const SecureVector& walletSeed, const SecureString& password)
+{
+	UnlockedSeed unlockedSeed;
+	unlockedSeed.salt = CBigInteger<32>(CSPRNG::GenerateRandomBytes(32).data());
+	unlockedSeed.iv = CBigInteger<16>(CSPRNG::GenerateRandomBytes(16).data());
+
+	const SecretKey key = DeriveKey(password, unlockedSeed.salt);
+	unlockedSeed.encrypted = AES256::Encrypt(walletSeed, key, unlockedSeed.iv);
+	unlockedSeed.check = Hasher::HMAC_SHA256(key.data(), key.size(), walletSeed.data(), walletSeed.size());
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_unlockedSeeds.insert_or_assign(username, std::move(unlockedSeed));
+}
+
+void SeedUnlocker::Forget(const std::string& username)
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_unlockedSeeds.erase(username);
+}
+
+SecretKey SeedUnlocker::DeriveKey(const SecureString& password, const CBigInteger<32>& salt)
+{
+	return SecretKey(Hasher::HMAC_SHA256(salt.data(), salt.size(), (const uint8_t*)password.data(), password.size()));
+}
+
+std::unique_ptr<SecureVector> SeedUnlocker::GetRemembered(const std::string& username, const SecureString& password) const
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	auto iter = m_unlockedSeeds.find(username);
+	if (iter == m_unlockedSeeds.end())
+	{
+		return nullptr;
+	}
+
+	const UnlockedSeed& unlockedSeed = iter->second;
+	const SecretKey key = DeriveKey(password, unlockedSeed.salt);
+	try
+	{
+		SecureVector walletSeed = AES256::Decrypt(unlockedSeed.encrypted, key, unlockedSeed.iv);
+		if (Hasher::HMAC_SHA256(key.data(), key.size(), walletSeed.data(), walletSeed.size()) == unlockedSeed.check)
+		{
+			return std::make_unique<SecureVector>(std::move(walletSeed));
+		}
+	}
+	catch (std::exception&)
+	{
+		// Wrong password. Left for the KDF to reject.
+	}
+
+	return nullptr;
+}
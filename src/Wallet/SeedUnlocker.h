@@ -0,0 +1,71 @@
+#pragma once
+
+#include <Common/Secure.h>
+#include <Common/ThreadPool.h>
+#include <Config/Config.h>
+#include <Crypto/BigInteger.h>
+#include <Crypto/SecretKey.h>
+#include <Wallet/WalletDB/Models/EncryptedSeed.h>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Forward Declarations
+class IWalletStore;
+
+//
+// Encrypts and decrypts wallet seeds using the user's password.
+//
+// The scrypt KDF is slow and memory-hard by design, so it runs on a small dedicated pool, which bounds how many
+// run at once, and callers shouldn't hold the session manager's lock while waiting on it.
+//
+// Once a user logs in, their seed is also kept encrypted under a key derived from the password using HMAC-SHA256,
+// so later logins and password checks for that user skip the KDF. That's no weaker than the decrypted seed already
+// held by the logged in wallet. Wrong passwords always fall back to the KDF, and the seed is forgotten once
+// the user's last session logs out.
+//
+class SeedUnlocker
+{
+public:
+	using Ptr = std::shared_ptr<SeedUnlocker>;
+
+	static SeedUnlocker::Ptr Create(const Config& config, const std::shared_ptr<IWalletStore>& pWalletStore);
+
+	SeedUnlocker(const std::shared_ptr<IWalletStore>& pWalletStore, const ThreadPool::Ptr& pKdfPool)
+		: m_pWalletStore(pWalletStore), m_pKdfPool(pKdfPool) { }
+
+	EncryptedSeed Encrypt(const SecureVector& walletSeed, const SecureString& password) const;
+
+	//
+	// Decrypts the user's seed, without the KDF if it's remembered.
+	//
+	// Throws KeyChainException if the password is wrong.
+	//
+	SecureVector Unlock(const std::string& username, const SecureString& password) const;
+
+	//
+	// Lets the seed be unlocked without the KDF until Forget is called.
+	//
+	void Remember(const std::string& username, const SecureVector& walletSeed, const SecureString& password);
+	void Forget(const std::string& username);
+
+private:
+	struct UnlockedSeed
+	{
+		CBigInteger<32> salt;
+		CBigInteger<16> iv;
+		std::vector<uint8_t> encrypted;
+		CBigInteger<32> check;
+	};
+
+	static SecretKey DeriveKey(const SecureString& password, const CBigInteger<32>& salt);
+	std::unique_ptr<SecureVector> GetRemembered(const std::string& username, const SecureString& password) const;
+
+	std::shared_ptr<IWalletStore> m_pWalletStore;
+	ThreadPool::Ptr m_pKdfPool;
+
+	mutable std::mutex m_mutex;
+	std::unordered_map<std::string, UnlockedSeed> m_unlockedSeeds;
+};
@@ -1,23 +1,63 @@
 #include "SessionManager.h"
 #include "ForeignController.h"
-#include "Keychain/SeedEncrypter.h"
 
 #include <Common/Logger.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
 #include <Common/Util/VectorUtil.h>
 #include <Crypto/Hasher.h>
 #include <Crypto/CSPRNG.h>
 #include <Wallet/Exceptions/SessionTokenException.h>
 #include <Wallet/WalletDB/WalletStore.h>
+#include <algorithm>
+
+// Each batch is written (and the wallet's database write-locked) separately, so the migration never holds up the wallet for long.
+static const size_t SLATE_MIGRATION_BATCH_SIZE = 50;
+
+//
+// Rewrites the wallet's slates that were saved in an older format, eg. before slates were stored compactly.
+//
+static void MigrateSlates(Locked<IWalletDB> walletDB, const SecureVector& seed)
+{
+	try
+	{
+		size_t numMigrated = 0;
+		while (true)
+		{
+			auto pBatch = walletDB.BatchWrite();
+			const size_t numInBatch = pBatch->MigrateSlates(seed, SLATE_MIGRATION_BATCH_SIZE);
+			pBatch->Commit();
+
+			numMigrated += numInBatch;
+			if (numInBatch < SLATE_MIGRATION_BATCH_SIZE)
+			{
+				break;
+			}
+		}
+
+		if (numMigrated > 0)
+		{
+			WALLET_INFO_F("Migrated {} slates", numMigrated);
+		}
+	}
+	catch (std::exception& e)
+	{
+		WALLET_ERROR_F("Failed to migrate slates: {}", e.what());
+	}
+}
 
 SessionManager::SessionManager(
 	const Config& config,
 	const std::shared_ptr<const INodeClient>& pNodeClient,
 	const std::shared_ptr<IWalletStore>& pWalletDB,
+	const SeedUnlocker::Ptr& pSeedUnlocker,
 	std::unique_ptr<ForeignController>&& pForeignController)
 	: m_config(config),
 	m_pNodeClient(pNodeClient),
 	m_pWalletDB(pWalletDB),
-	m_pForeignController(std::move(pForeignController))
+	m_pSeedUnlocker(pSeedUnlocker),
+	m_pForeignController(std::move(pForeignController)),
+	m_pOutputScanner(OutputScanner::Create(config, pNodeClient))
 {
 	m_nextSessionId = CSPRNG::GenerateRandom(0, UINT64_MAX);
 }
@@ -25,97 +65,46 @@ SessionManager::SessionManager(
 SessionManager::~SessionManager()
 {
 	LOG_INFO("Shutting down session manager");
+	m_pOutputScanner.reset();
+
+	std::unique_lock<std::shared_mutex> lock(m_sessionsMutex);
 	for (auto iter = m_sessionsById.begin(); iter != m_sessionsById.end(); iter++)
 	{
 		m_pForeignController->StopListener(iter->second->m_wallet.Read()->GetUsername());
 	}
 }
 
-Locked<SessionManager> SessionManager::Create(
+SessionManager::Ptr SessionManager::Create(
 	const Config& config,
 	const std::shared_ptr<const INodeClient>& pNodeClient,
 	const std::shared_ptr<IWalletStore>& pWalletDB,
+	const SeedUnlocker::Ptr& pSeedUnlocker,
 	IWalletManager& walletManager)
 {
-	auto pForeignController = std::make_unique<ForeignController>(walletManager);
-	auto pSessionManager = std::make_shared<SessionManager>(
+	auto pForeignController = std::make_unique<ForeignController>(config, walletManager);
+	return std::make_shared<SessionManager>(
 		config,
 		pNodeClient,
 		pWalletDB,
+		pSeedUnlocker,
 		std::move(pForeignController)
 	);
-	return Locked<SessionManager>(pSessionManager);
 }
 
 void SessionManager::Authenticate(const std::string& username, const SecureString& password) const
 {
-	std::unique_ptr<EncryptedSeed> pSeed = nullptr;
-
-	try
-	{
-		pSeed = std::make_unique<EncryptedSeed>(m_pWalletDB->LoadWalletSeed(username));
-	}
-	catch (std::exception&)
-	{
-		WALLET_ERROR_F("User '{}' not found.", username);
-		throw;
-	}
-
-	try
-	{
-		SecureVector decryptedSeed = SeedEncrypter().DecryptWalletSeed(*pSeed, password);
-	}
-	catch (std::exception&)
-	{
-		WALLET_ERROR_F("Invalid password provided for user '{}'", username);
-		throw;
-	}
+	GetSeed(username, password);
 }
 
 SecureVector SessionManager::GetSeed(const std::string& username, const SecureString& password) const
 {
-	std::unique_ptr<EncryptedSeed> pSeed = nullptr;
-
-	try
-	{
-		pSeed = std::make_unique<EncryptedSeed>(m_pWalletDB->LoadWalletSeed(username));
-	}
-	catch (std::exception&)
-	{
-		WALLET_ERROR_F("User '{}' not found.", username);
-		throw;
-	}
-
-	try
-	{
-		return SeedEncrypter().DecryptWalletSeed(*pSeed, password);
-	}
-	catch (std::exception&)
-	{
-		WALLET_ERROR_F("Invalid password provided for user '{}'", username);
-		throw;
-	}
-}
-
-SessionToken SessionManager::Login(
-	const TorProcess::Ptr& pTorProcess,
-	const std::string& username,
-	const SecureString& password)
-{
-	WALLET_DEBUG_F("Logging in with username: {}", username);
 	try
 	{
-		EncryptedSeed seed = m_pWalletDB->LoadWalletSeed(username);
-
-		SecureVector decryptedSeed = SeedEncrypter().DecryptWalletSeed(seed, password);
-
-		WALLET_INFO("Valid password provided. Logging in now.");
-		m_pWalletDB->OpenWallet(username, decryptedSeed);
-		return Login(pTorProcess, username, decryptedSeed);
+		return m_pSeedUnlocker->Unlock(username, password);
 	}
 	catch (std::exception&)
 	{
-		WALLET_ERROR("Wallet seed not decrypted. Wrong password?");
+		WALLET_ERROR_F("Failed to unlock seed for user '{}'. Wrong password?", username);
 		throw;
 	}
 }
@@ -163,12 +152,18 @@ SessionToken SessionManager::Login(
 		walletImpl.Read()->GetSlatepackAddress()
 	);
 
-	m_sessionsById[sessionId] = std::make_shared<LoggedInSession>(
+	auto pSession = std::make_shared<LoggedInSession>(
 		wallet,
 		walletImpl,
 		std::move(encryptedSeedWithCS)
 	);
 
+	std::unique_lock<std::mutex> loginLock(m_loginMutex);
+	{
+		std::unique_lock<std::shared_mutex> lock(m_sessionsMutex);
+		m_sessionsById[sessionId] = pSession;
+	}
+
 	KeyChain keyChain = KeyChain::FromSeed(m_config, seed);
 	auto listenerInfo = m_pForeignController->StartListener(
 		pTorProcess,
@@ -183,65 +178,76 @@ SessionToken SessionManager::Login(
 		walletImpl.Write()->SetTorAddress(listenerInfo.second.value());
 	}
 
+	m_pOutputScanner->AddWallet(token, pSession);
+
+	ThreadManagerAPI::GetThreadPool().Post(
+		[pWalletDB, seed]() { MigrateSlates(pWalletDB, seed); },
+		ETaskPriority::LOW
+	);
+
 	return token;
 }
 
 void SessionManager::Logout(const SessionToken& token)
 {
-	auto iter = m_sessionsById.find(token.GetSessionId());
-	if (iter != m_sessionsById.end())
-	{
-		m_pForeignController->StopListener(iter->second->m_wallet.Read()->GetUsername());
-		m_sessionsById.erase(iter);
-	}
-}
+	std::unique_lock<std::mutex> loginLock(m_loginMutex);
 
-SecureVector SessionManager::GetSeed(const SessionToken& token) const
-{
-	auto iter = m_sessionsById.find(token.GetSessionId());
-	if (iter != m_sessionsById.end())
+	std::shared_ptr<LoggedInSession> pSession = nullptr;
+	std::string username;
+	bool loggedIn = false;
 	{
-		std::shared_ptr<const LoggedInSession> pSession = iter->second;
-		
-		std::vector<unsigned char> seedWithCS(pSession->m_encryptedSeedWithCS.size());
-		for (size_t i = 0; i < seedWithCS.size(); i++)
+		std::unique_lock<std::shared_mutex> lock(m_sessionsMutex);
+		auto iter = m_sessionsById.find(token.GetSessionId());
+		if (iter == m_sessionsById.end())
 		{
-			seedWithCS[i] = pSession->m_encryptedSeedWithCS[i] ^ token.GetTokenKey()[i];
+			return;
 		}
 
-		SecureVector seed(seedWithCS.cbegin(), seedWithCS.cbegin() + seedWithCS.size() - 4);
-		CBigInteger<32> hash = Hasher::SHA256((const std::vector<unsigned char>&)seed);
-		for (int i = 0; i < 4; i++)
-		{
-			if (seedWithCS[(seedWithCS.size() - 4) + i] != hash[i])
-			{
-				throw SessionTokenException();
-			}
-		}
+		pSession = iter->second;
+		m_sessionsById.erase(iter);
 
-		return seed;
+		username = pSession->m_wallet.Read()->GetUsername();
+		loggedIn = std::any_of(
+			m_sessionsById.cbegin(), m_sessionsById.cend(),
+			[&username](const auto& entry) { return entry.second->m_wallet.Read()->GetUsername() == username; }
+		);
 	}
 
-	throw SessionTokenException();
+	m_pOutputScanner->RemoveWallet(token);
+	m_pForeignController->StopListener(username);
+	pSession->m_walletImpl.Read()->GetDatabase().Write()->ClearCache();
+	if (!loggedIn) {
+		m_pSeedUnlocker->Forget(username);
+	}
+}
+
+SecureVector SessionManager::GetSeed(const SessionToken& token) const
+{
+	return FindSession(token)->DecryptSeed(token);
 }
 
 Locked<Wallet> SessionManager::GetWallet(const SessionToken& token) const
 {
-	auto iter = m_sessionsById.find(token.GetSessionId());
-	if (iter != m_sessionsById.end())
-	{
-		return iter->second->m_wallet;
-	}
+	return FindSession(token)->m_wallet;
+}
 
-	throw SessionTokenException();
+RestoreProgress::Ptr SessionManager::GetRestoreProgress(const SessionToken& token) const
+{
+	return FindSession(token)->m_pRestoreProgress;
 }
 
 Locked<WalletImpl> SessionManager::GetWalletImpl(const SessionToken& token) const
 {
+	return FindSession(token)->m_walletImpl;
+}
+
+std::shared_ptr<LoggedInSession> SessionManager::FindSession(const SessionToken& token) const
+{
+	std::shared_lock<std::shared_mutex> lock(m_sessionsMutex);
 	auto iter = m_sessionsById.find(token.GetSessionId());
 	if (iter != m_sessionsById.end())
 	{
-		return iter->second->m_walletImpl;
+		return iter->second;
 	}
 
 	throw SessionTokenException();
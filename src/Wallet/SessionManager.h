@@ -2,13 +2,18 @@
 
 #include <Common/Compat.h>
 #include "LoggedInSession.h"
+#include "OutputScanner.h"
+#include "SeedUnlocker.h"
 
 #include <Crypto/SecretKey.h>
 #include <Common/Secure.h>
 #include <Config/Config.h>
 #include <Net/Tor/TorProcess.h>
 #include <Wallet/SessionToken.h>
+#include <atomic>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <unordered_map>
 
 // Forward Declarations
@@ -17,30 +22,38 @@ class IWalletStore;
 class IWalletManager;
 class ForeignController;
 
+//
+// Thread safe. The sessions are only locked long enough to find, add or remove one,
+// so a slow login, logout or wallet operation never holds up other sessions.
+//
 class SessionManager
 {
 public:
+	using Ptr = std::shared_ptr<SessionManager>;
+
 	SessionManager(
 		const Config& config,
 		const std::shared_ptr<const INodeClient>& pNodeClient,
 		const std::shared_ptr<IWalletStore>& pWalletDB,
+		const SeedUnlocker::Ptr& pSeedUnlocker,
 		std::unique_ptr<ForeignController>&& pForeignController
 	);
 	~SessionManager();
 
-	static Locked<SessionManager> Create(
+	static SessionManager::Ptr Create(
 		const Config& config,
 		const std::shared_ptr<const INodeClient>& pNodeClient,
 		const std::shared_ptr<IWalletStore>& pWalletDB,
+		const SeedUnlocker::Ptr& pSeedUnlocker,
 		IWalletManager& walletManager
 	);
 
 	void Authenticate(const std::string& username, const SecureString& password) const;
-	SessionToken Login(
-		const TorProcess::Ptr& pTorProcess,
-		const std::string& username,
-		const SecureString& password
-	);
+
+	//
+	// Logs in with an already decrypted seed. Use SeedUnlocker to decrypt it first.
+	// The wallet is loaded before the session is added, so other sessions aren't blocked while it loads.
+	//
 	SessionToken Login(
 		const TorProcess::Ptr& pTorProcess,
 		const std::string& username,
@@ -52,16 +65,29 @@ public:
 	SecureVector GetSeed(const std::string& username, const SecureString& password) const;
 
 	Locked<Wallet> GetWallet(const SessionToken& token) const;
+	RestoreProgress::Ptr GetRestoreProgress(const SessionToken& token) const;
 	Locked<WalletImpl> GetWalletImpl(const SessionToken& token) const;
 
 private:
+	// Throws SessionTokenException if no session matches the token.
+	std::shared_ptr<LoggedInSession> FindSession(const SessionToken& token) const;
+
+	// Serializes logins and logouts, so a logout can't stop the listener started by a login for the same user.
+	// Looking up sessions never waits on it.
+	std::mutex m_loginMutex;
+
+	mutable std::shared_mutex m_sessionsMutex;
 	std::unordered_map<uint64_t, std::shared_ptr<LoggedInSession>> m_sessionsById;
 	// TODO: Keep multimap of sessions per username
 
-	uint64_t m_nextSessionId;
+	std::atomic<uint64_t> m_nextSessionId;
 
 	const Config& m_config;
 	std::shared_ptr<const INodeClient> m_pNodeClient;
 	std::shared_ptr<IWalletStore> m_pWalletDB;
+	SeedUnlocker::Ptr m_pSeedUnlocker;
 	std::unique_ptr<ForeignController> m_pForeignController;
+
+	// Scans new blocks for the outputs of every logged in wallet.
+	std::unique_ptr<OutputScanner> m_pOutputScanner;
 };
\ No newline at end of file
@@ -6,46 +6,71 @@
 
 // If strategy is "ALL", spend all available coins to reduce the fee.
 std::vector<OutputDataEntity> CoinSelection::SelectCoinsToSpend(
-	const std::vector<OutputDataEntity>& availableCoins, 
+	const CoinIndex& availableCoins,
 	const uint64_t amount,
 	const uint64_t feeBase,
 	const ESelectionStrategy& strategy,
 	const std::set<Commitment>& inputs,
 	const int64_t numOutputs,
-	const int64_t numKernels)
+	const int64_t numKernels,
+	const std::unordered_set<Commitment>& excluded)
 {
 	if (strategy == ESelectionStrategy::CUSTOM)
 	{
-		return SelectUsingCustomInputs(availableCoins, amount, feeBase, inputs, numOutputs, numKernels);
+		return SelectUsingCustomInputs(availableCoins, amount, feeBase, inputs, numOutputs, numKernels, excluded);
 	}
 	else if (strategy == ESelectionStrategy::SMALLEST)
 	{
-		return SelectUsingSmallestInputs(availableCoins, amount, feeBase, numOutputs, numKernels);
+		return SelectUsingSmallestInputs(availableCoins, amount, feeBase, numOutputs, numKernels, excluded);
+	}
+	else if (strategy == ESelectionStrategy::FEWEST)
+	{
+		return SelectUsingFewestInputs(availableCoins, amount, feeBase, numOutputs, numKernels, excluded);
 	}
 	else if (strategy == ESelectionStrategy::ALL)
 	{
-		return SelectUsingAllInputs(availableCoins, amount, feeBase, numOutputs, numKernels);
+		return SelectUsingAllInputs(availableCoins, amount, feeBase, numOutputs, numKernels, excluded);
 	}
 
 	WALLET_ERROR("Unsupported selection strategy used.");
 	throw InsufficientFundsException();
 }
 
+std::vector<OutputDataEntity> CoinSelection::SelectAll(
+	const CoinIndex& availableCoins,
+	const std::unordered_set<Commitment>& excluded)
+{
+	std::vector<OutputDataEntity> coins;
+	coins.reserve(availableCoins.GetCoins().size());
+	for (const auto& [coinAmount, coin] : availableCoins.GetCoins())
+	{
+		if (excluded.count(coin.GetCommitment()) == 0)
+		{
+			coins.push_back(coin);
+		}
+	}
+
+	return coins;
+}
+
 std::vector<OutputDataEntity> CoinSelection::SelectUsingSmallestInputs(
-	const std::vector<OutputDataEntity>& availableCoins,
+	const CoinIndex& availableCoins,
 	const uint64_t amount,
 	const uint64_t feeBase,
 	const int64_t numOutputs,
-	const int64_t numKernels)
+	const int64_t numKernels,
+	const std::unordered_set<Commitment>& excluded)
 {
-	std::vector<OutputDataEntity> sortedCoins = availableCoins;
-	std::sort(sortedCoins.begin(), sortedCoins.end());
-
 	uint64_t amountFound = 0;
 	std::vector<OutputDataEntity> selectedCoins;
-	for (const OutputDataEntity& coin : sortedCoins)
+	for (const auto& [coinAmount, coin] : availableCoins.GetCoins())
 	{
-		amountFound += coin.GetAmount();
+		if (excluded.count(coin.GetCommitment()) > 0)
+		{
+			continue;
+		}
+
+		amountFound += coinAmount;
 		selectedCoins.push_back(coin);
 
 		const uint64_t fee = FeeUtil::CalculateFee(feeBase, (int64_t)selectedCoins.size(), numOutputs, numKernels);
@@ -60,22 +85,77 @@ std::vector<OutputDataEntity> CoinSelection::SelectUsingSmallestInputs(
 	throw InsufficientFundsException();
 }
 
+std::vector<OutputDataEntity> CoinSelection::SelectUsingFewestInputs(
+	const CoinIndex& availableCoins,
+	const uint64_t amount,
+	const uint64_t feeBase,
+	const int64_t numOutputs,
+	const int64_t numKernels,
+	const std::unordered_set<Commitment>& excluded)
+{
+	const CoinIndex::Coins& coins = availableCoins.GetCoins();
+
+	uint64_t amountFound = 0;
+	std::vector<const OutputDataEntity*> selectedCoins;
+	for (auto iter = coins.crbegin(); iter != coins.crend(); iter++)
+	{
+		if (excluded.count(iter->second.GetCommitment()) > 0)
+		{
+			continue;
+		}
+
+		amountFound += iter->first;
+		selectedCoins.push_back(&iter->second);
+
+		const uint64_t fee = FeeUtil::CalculateFee(feeBase, (int64_t)selectedCoins.size(), numOutputs, numKernels);
+		if (amountFound >= (amount + fee))
+		{
+			// Every coin smaller than the last one selected is unselected, so any of them that covers the rest can replace it.
+			const uint64_t remaining = (amount + fee) - (amountFound - iter->first);
+			for (auto replacement = coins.lower_bound(remaining); replacement != coins.end() && replacement->first < iter->first; replacement++)
+			{
+				if (excluded.count(replacement->second.GetCommitment()) == 0)
+				{
+					selectedCoins.back() = &replacement->second;
+					break;
+				}
+			}
+
+			std::vector<OutputDataEntity> selected;
+			for (const OutputDataEntity* pCoin : selectedCoins)
+			{
+				selected.push_back(*pCoin);
+			}
+
+			return selected;
+		}
+	}
+
+	// Not enough coins found.
+	WALLET_ERROR("Not enough funds.");
+	throw InsufficientFundsException();
+}
+
 std::vector<OutputDataEntity> CoinSelection::SelectUsingAllInputs(
-	const std::vector<OutputDataEntity>& availableCoins,
+	const CoinIndex& availableCoins,
 	const uint64_t amount,
 	const uint64_t feeBase,
 	const int64_t numOutputs,
-	const int64_t numKernels)
+	const int64_t numKernels,
+	const std::unordered_set<Commitment>& excluded)
 {
+	std::vector<OutputDataEntity> selectedCoins = SelectAll(availableCoins, excluded);
+
 	uint64_t amountFound = 0;
-	for (const OutputDataEntity& coin : availableCoins)
+	for (const OutputDataEntity& coin : selectedCoins)
 	{
 		amountFound += coin.GetAmount();
 	}
 
-	const uint64_t fee = FeeUtil::CalculateFee(feeBase, (int64_t)availableCoins.size(), numOutputs, numKernels);
-	if (amount < amount + fee) {
-		return availableCoins;
+	const uint64_t fee = FeeUtil::CalculateFee(feeBase, (int64_t)selectedCoins.size(), numOutputs, numKernels);
+	if (amountFound >= (amount + fee))
+	{
+		return selectedCoins;
 	}
 
 	// Not enough coins found.
@@ -84,21 +164,23 @@ std::vector<OutputDataEntity> CoinSelection::SelectUsingAllInputs(
 }
 
 std::vector<OutputDataEntity> CoinSelection::SelectUsingCustomInputs(
-	const std::vector<OutputDataEntity>& availableCoins,
+	const CoinIndex& availableCoins,
 	const uint64_t amount,
 	const uint64_t feeBase,
 	const std::set<Commitment>& inputs,
 	const int64_t numOutputs,
-	const int64_t numKernels)
+	const int64_t numKernels,
+	const std::unordered_set<Commitment>& excluded)
 {
 	uint64_t amountFound = 0;
 	std::vector<OutputDataEntity> selectedCoins;
-	for (const OutputDataEntity& coin : availableCoins)
+	for (const Commitment& input : inputs)
 	{
-		if (inputs.find(coin.GetOutput().GetCommitment()) != inputs.end())
+		const OutputDataEntity* pCoin = availableCoins.Find(input);
+		if (pCoin != nullptr && excluded.count(input) == 0)
 		{
-			amountFound += coin.GetAmount();
-			selectedCoins.push_back(coin);
+			amountFound += pCoin->GetAmount();
+			selectedCoins.push_back(*pCoin);
 		}
 	}
 
@@ -111,4 +193,4 @@ std::vector<OutputDataEntity> CoinSelection::SelectUsingCustomInputs(
 	// Not enough coins selected.
 	WALLET_ERROR("Not enough funds.");
 	throw InsufficientFundsException();
-}
\ No newline at end of file
+}
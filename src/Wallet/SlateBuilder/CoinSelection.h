@@ -1,45 +1,77 @@
 #pragma once
 
 #include <Wallet/WalletDB/Models/OutputDataEntity.h>
+#include <Wallet/WalletDB/CoinIndex.h>
 #include <Wallet/Enums/SelectionStrategy.h>
 #include <set>
+#include <unordered_set>
 
+//
+// Selects coins from the wallet's CoinIndex, visiting only as many coins as it selects
+// (plus any excluded ones it has to skip), rather than sorting or copying every coin.
+//
 class CoinSelection
 {
 public:
+	//
+	// Coins in excluded are never selected, eg. because another send in the same batch already spends them.
+	//
 	static std::vector<OutputDataEntity> SelectCoinsToSpend(
-		const std::vector<OutputDataEntity>& availableCoins,
+		const CoinIndex& availableCoins,
 		const uint64_t amount,
 		const uint64_t feeBase,
 		const ESelectionStrategy& strategy,
 		const std::set<Commitment>& inputs,
 		const int64_t numOutputs,
-		const int64_t numKernels
+		const int64_t numKernels,
+		const std::unordered_set<Commitment>& excluded = std::unordered_set<Commitment>()
+	);
+
+	// Every available coin not in excluded.
+	static std::vector<OutputDataEntity> SelectAll(
+		const CoinIndex& availableCoins,
+		const std::unordered_set<Commitment>& excluded
 	);
 
 private:
 	static std::vector<OutputDataEntity> SelectUsingSmallestInputs(
-		const std::vector<OutputDataEntity>& availableCoins,
+		const CoinIndex& availableCoins,
+		const uint64_t amount,
+		const uint64_t feeBase,
+		const int64_t numOutputs,
+		const int64_t numKernels,
+		const std::unordered_set<Commitment>& excluded
+	);
+
+	//
+	// Takes the largest coins until the amount and fee are covered, which uses the fewest possible inputs,
+	// then swaps the last one for the smallest coin that still covers the rest, to keep the change small.
+	//
+	static std::vector<OutputDataEntity> SelectUsingFewestInputs(
+		const CoinIndex& availableCoins,
 		const uint64_t amount,
 		const uint64_t feeBase,
 		const int64_t numOutputs,
-		const int64_t numKernels
+		const int64_t numKernels,
+		const std::unordered_set<Commitment>& excluded
 	);
 
 	static std::vector<OutputDataEntity> SelectUsingAllInputs(
-		const std::vector<OutputDataEntity>& availableCoins,
+		const CoinIndex& availableCoins,
 		const uint64_t amount,
 		const uint64_t feeBase,
 		const int64_t numOutputs,
-		const int64_t numKernels
+		const int64_t numKernels,
+		const std::unordered_set<Commitment>& excluded
 	);
 
 	static std::vector<OutputDataEntity> SelectUsingCustomInputs(
-		const std::vector<OutputDataEntity>& availableCoins,
+		const CoinIndex& availableCoins,
 		const uint64_t amount,
 		const uint64_t feeBase,
 		const std::set<Commitment>& inputs,
 		const int64_t numOutputs,
-		const int64_t numKernels
+		const int64_t numKernels,
+		const std::unordered_set<Commitment>& excluded
 	);
-};
\ No newline at end of file
+};
@@ -4,33 +4,67 @@
 
 #include <Wallet/WalletDB/Models/OutputDataEntity.h>
 #include <Wallet/Exceptions/InsufficientFundsException.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <atomic>
+#include <memory>
 
 class OutputBuilder
 {
 public:
-	static std::vector<OutputDataEntity> CreateOutputs(
-		std::shared_ptr<WalletImpl> pWallet,
-		std::shared_ptr<IWalletDB> pBatch,
-		const SecureVector& masterSeed, 
-		const uint64_t totalAmount, 
-		const uint32_t walletTxId, 
-		const uint8_t numOutputs,
-		const EBulletproofType& bulletproofType)
+	//
+	// Reserves the key chain paths for the outputs, in order.
+	//
+	static std::vector<KeyChainPath> ReservePaths(const std::shared_ptr<const WalletImpl>& pWallet, const std::shared_ptr<IWalletDB>& pBatch, const uint8_t numOutputs)
 	{
-		std::vector<OutputDataEntity> outputs;
+		std::vector<KeyChainPath> keyChainPaths;
 		for (uint8_t i = 0; i < numOutputs; i++)
 		{
-			// If 3 outputs are requested for 11 nanogrins, the first output will contain 5, while the others contain 3.
-			uint64_t coinAmount = (totalAmount / numOutputs);
-			if (i == 0)
+			keyChainPaths.emplace_back(pBatch->GetNextChildPath(pWallet->GetUserPath()));
+		}
+
+		return keyChainPaths;
+	}
+
+	//
+	// The outputs (mostly their rangeproofs) are generated concurrently on the shared thread pool,
+	// so building many outputs takes about as long as building one per core. Doesn't need the wallet database.
+	//
+	static std::vector<OutputDataEntity> CreateOutputs(
+		const std::shared_ptr<const WalletImpl>& pWallet,
+		const SecureVector& masterSeed,
+		const uint64_t totalAmount,
+		const uint32_t walletTxId,
+		const std::vector<KeyChainPath>& keyChainPaths,
+		const EBulletproofType& bulletproofType)
+	{
+		const size_t numOutputs = keyChainPaths.size();
+		std::vector<std::unique_ptr<OutputDataEntity>> results(numOutputs);
+		std::atomic_size_t nextOutput = 0;
+		auto worker = [&]() {
+			for (size_t i = nextOutput++; i < numOutputs; i = nextOutput++)
 			{
-				coinAmount += (totalAmount % numOutputs);
+				// If 3 outputs are requested for 11 nanogrins, the first output will contain 5, while the others contain 3.
+				uint64_t coinAmount = (totalAmount / numOutputs);
+				if (i == 0)
+				{
+					coinAmount += (totalAmount % numOutputs);
+				}
+
+				results[i] = std::make_unique<OutputDataEntity>(
+					pWallet->CreateBlindedOutput(masterSeed, coinAmount, keyChainPaths[i], walletTxId, bulletproofType)
+				);
 			}
+		};
 
-			KeyChainPath keyChainPath = pBatch->GetNextChildPath(pWallet->GetUserPath());
-			outputs.emplace_back(pWallet->CreateBlindedOutput(masterSeed, coinAmount, keyChainPath, walletTxId, bulletproofType));
+		ThreadManagerAPI::GetThreadPool().RunParallel(numOutputs, worker);
+
+		std::vector<OutputDataEntity> outputs;
+		for (std::unique_ptr<OutputDataEntity>& pOutput : results)
+		{
+			outputs.emplace_back(std::move(*pOutput));
 		}
 
 		return outputs;
 	}
-};
\ No newline at end of file
+};
@@ -11,6 +11,9 @@
 #include <Consensus/HardForks.h>
 #include <Net/Tor/TorAddressParser.h>
 #include <Crypto/ED25519.h>
+#include <algorithm>
+#include <chrono>
+#include <unordered_set>
 
 SendSlateBuilder::SendSlateBuilder(const Config& config, INodeClientConstPtr pNodeClient)
 	: m_config(config), m_pNodeClient(pNodeClient)
@@ -28,18 +31,130 @@ Slate SendSlateBuilder::BuildSendSlate(
 	const std::optional<std::string>& addressOpt,
 	const SelectionStrategyDTO& strategy,
 	const uint16_t slateVersion) const
+{
+	auto pWallet = wallet.Read();
+	pWallet->RefreshOutputs(masterSeed, false);
+
+	// Select inputs using desired selection strategy.
+	std::vector<Selection> selections = ReserveInputs(*pWallet, masterSeed, {
+		[&](const CoinIndex& availableCoins, const std::unordered_set<Commitment>& excluded) {
+			return SelectInputs(availableCoins, excluded, amount, feeBase, maxChangeOutputs, sendEntireBalance, strategy);
+		}
+	});
+	OutputReservation reservation(pWallet->GetReservations(), selections.front().inputs);
+
+	return Build(
+		pWallet.GetShared(),
+		masterSeed,
+		selections.front().amountToSend,
+		selections.front().fee,
+		selections.front().numChangeOutputs,
+		selections.front().inputs,
+		addressOpt,
+		slateVersion
+	);
+}
+
+std::vector<Slate> SendSlateBuilder::BuildSendSlates(
+	Locked<WalletImpl> wallet,
+	const SecureVector& masterSeed,
+	const std::vector<SendCriteria>& sends) const
+{
+	auto pWallet = wallet.Read();
+	pWallet->RefreshOutputs(masterSeed, false);
+
+	// Inputs are selected for every send first, so a send the wallet can't afford fails the batch before anything is written.
+	std::vector<Selector> selectors;
+	for (const SendCriteria& send : sends)
+	{
+		selectors.push_back([&send, this](const CoinIndex& availableCoins, const std::unordered_set<Commitment>& excluded) {
+			return SelectInputs(availableCoins, excluded, send.GetAmount(), send.GetFeeBase(), send.GetNumOutputs(), false, send.GetSelectionStrategy());
+		});
+	}
+
+	std::vector<Selection> selections = ReserveInputs(*pWallet, masterSeed, selectors);
+
+	std::vector<OutputDataEntity> reserved;
+	for (const Selection& selection : selections)
+	{
+		reserved.insert(reserved.end(), selection.inputs.cbegin(), selection.inputs.cend());
+	}
+	OutputReservation reservation(pWallet->GetReservations(), reserved);
+
+	std::vector<Slate> slates;
+	for (size_t i = 0; i < sends.size(); i++)
+	{
+		slates.push_back(Build(
+			pWallet.GetShared(),
+			masterSeed,
+			selections[i].amountToSend,
+			selections[i].fee,
+			selections[i].numChangeOutputs,
+			selections[i].inputs,
+			sends[i].GetAddress(),
+			sends[i].GetSlateVersion()
+		));
+	}
+
+	return slates;
+}
+
+std::vector<SendSlateBuilder::Selection> SendSlateBuilder::ReserveInputs(
+	const WalletImpl& wallet,
+	const SecureVector& masterSeed,
+	const std::vector<Selector>& selectors) const
+{
+	const OutputReservations::Ptr& pReservations = wallet.GetReservations();
+	while (true)
+	{
+		// Reserving while the database's read lock is held means none of the inputs can be LOCKED by a send committing in the meantime.
+		auto pDatabase = wallet.GetDatabase().Read();
+		const CoinIndex& availableCoins = pDatabase->GetCoinIndex(masterSeed);
+
+		std::unordered_set<Commitment> excluded = pReservations->GetReserved();
+		std::vector<OutputDataEntity> selected;
+		std::vector<Selection> selections;
+		for (const Selector& select : selectors)
+		{
+			Selection selection = select(availableCoins, excluded);
+			for (const OutputDataEntity& input : selection.inputs)
+			{
+				excluded.insert(input.GetCommitment());
+				selected.push_back(input);
+			}
+
+			selections.push_back(std::move(selection));
+		}
+
+		if (pReservations->TryReserve(selected))
+		{
+			return selections;
+		}
+
+		WALLET_DEBUG("Selected inputs were reserved by another send. Selecting again.");
+	}
+}
+
+SendSlateBuilder::Selection SendSlateBuilder::SelectInputs(
+	const CoinIndex& availableCoins,
+	const std::unordered_set<Commitment>& excluded,
+	const uint64_t amount,
+	const uint64_t feeBase,
+	const uint8_t maxChangeOutputs,
+	const bool sendEntireBalance,
+	const SelectionStrategyDTO& strategy) const
 {
 	const uint8_t numChangeOutputs = sendEntireBalance ? 0 : maxChangeOutputs;
 	const uint8_t totalNumOutputs = 1 + numChangeOutputs;
 	const uint64_t numKernels = 1;
 
-	// Select inputs using desired selection strategy.
-	auto pWallet = wallet.Write();
-	const std::vector<OutputDataEntity> availableCoins = pWallet->GetAllAvailableCoins(masterSeed);
-
 	// Filter all coins to find inputs to spend
-	std::vector<OutputDataEntity> inputs = availableCoins;
-	if (!sendEntireBalance)
+	std::vector<OutputDataEntity> inputs;
+	if (sendEntireBalance)
+	{
+		inputs = CoinSelection::SelectAll(availableCoins, excluded);
+	}
+	else
 	{
 		inputs = CoinSelection::SelectCoinsToSpend(
 			availableCoins,
@@ -48,7 +163,8 @@ Slate SendSlateBuilder::BuildSendSlate(
 			strategy.GetStrategy(),
 			strategy.GetInputs(),
 			totalNumOutputs,
-			numKernels
+			numKernels,
+			excluded
 		);
 	}
 
@@ -71,20 +187,11 @@ Slate SendSlateBuilder::BuildSendSlate(
 		fee = inputTotal - amountToSend;
 	}
 
-	return Build(
-		pWallet.GetShared(),
-		masterSeed,
-		amountToSend,
-		fee,
-		sendEntireBalance ? 0 : numChangeOutputs,
-		inputs,
-		addressOpt,
-		slateVersion
-	);
+	return Selection{ std::move(inputs), amountToSend, fee, numChangeOutputs };
 }
 
 Slate SendSlateBuilder::Build(
-	const std::shared_ptr<WalletImpl>& pWallet,
+	const std::shared_ptr<const WalletImpl>& pWallet,
 	const SecureVector& masterSeed,
 	const uint64_t amountToSend,
 	const uint64_t fee,
@@ -93,12 +200,21 @@ Slate SendSlateBuilder::Build(
 	const std::optional<std::string>& addressOpt,
 	const uint16_t slateVersion) const
 {
+	const auto start = std::chrono::steady_clock::now();
 	const uint64_t blockHeight = m_pNodeClient->GetChainHeight() + 1;
 
-	auto pBatch = pWallet->GetDatabase().BatchWrite();
-	const uint32_t walletTxId = pBatch->GetNextTransactionId();
+	// The tx id and change output paths are reserved up front, so the change outputs are built without holding the database's lock.
+	uint32_t walletTxId = 0;
+	std::vector<KeyChainPath> changePaths;
+	{
+		auto pBatch = pWallet->GetDatabase().BatchWrite();
+		walletTxId = pBatch->GetNextTransactionId();
+		changePaths = OutputBuilder::ReservePaths(pWallet, pBatch.GetShared(), numChangeOutputs);
+		pBatch->Commit();
+	}
 
 	// Create change outputs with total blinding factor xC
+	const auto outputsStart = std::chrono::steady_clock::now();
 	std::vector<OutputDataEntity> changeOutputs;
 	if (numChangeOutputs > 0)
 	{
@@ -110,15 +226,16 @@ Slate SendSlateBuilder::Build(
 		const uint64_t changeAmount = inputTotal - (amountToSend + fee);
 		changeOutputs = OutputBuilder::CreateOutputs(
 			pWallet,
-			pBatch.GetShared(),
 			masterSeed,
 			changeAmount,
 			walletTxId,
-			numChangeOutputs,
+			changePaths,
 			EBulletproofType::ENHANCED
 		);
 	}
 
+	const auto outputsCreated = std::chrono::steady_clock::now();
+
 	// Select random transaction offset, and calculate secret key used in kernel signature.
 	BlindingFactor transactionOffset = CSPRNG::GenerateRandom32();
 	SigningKeys signing_keys = SlateUtil::CalculateSigningKeys(
@@ -178,6 +295,7 @@ Slate SendSlateBuilder::Build(
 		proofOpt
 	);
 
+	auto pBatch = pWallet->GetDatabase().BatchWrite();
 	UpdateDatabase(
 		pBatch.GetShared(),
 		masterSeed,
@@ -190,6 +308,16 @@ Slate SendSlateBuilder::Build(
 
 	pBatch->Commit();
 
+	const auto end = std::chrono::steady_clock::now();
+	WALLET_INFO_F(
+		"Built slate {} with {} inputs and {} change outputs in {}ms ({}ms creating change outputs)",
+		uuids::to_string(slate.GetId()),
+		inputs.size(),
+		changeOutputs.size(),
+		std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count(),
+		std::chrono::duration_cast<std::chrono::milliseconds>(outputsCreated - outputsStart).count()
+	);
+
 	return slate;
 }
 
@@ -9,7 +9,11 @@
 #include <Wallet/Models/DTOs/SelectionStrategyDTO.h>
 #include <Wallet/Models/Slate/Slate.h>
 #include <Wallet/WalletDB/Models/SlateContextEntity.h>
+#include <API/Wallet/Owner/Models/SendCriteria.h>
+#include <functional>
 #include <optional>
+#include <unordered_set>
+#include <vector>
 
 class SendSlateBuilder
 {
@@ -18,6 +22,7 @@ public:
 
 	//
 	// Creates a slate for sending grins from the provided wallet.
+	// Only holds a read lock on the wallet, and reserves the selected inputs, so sends from the same wallet can be built concurrently.
 	//
 	Slate BuildSendSlate(
 		Locked<WalletImpl> wallet, 
@@ -30,9 +35,53 @@ public:
 		const SelectionStrategyDTO& strategy,
 		const uint16_t slateVersion) const;
 
+	//
+	// Creates a slate for each send, refreshing the available coins only once.
+	// Each send spends different inputs, all of which are reserved before any slate is built.
+	//
+	std::vector<Slate> BuildSendSlates(
+		Locked<WalletImpl> wallet,
+		const SecureVector& masterSeed,
+		const std::vector<SendCriteria>& sends
+	) const;
+
 private:
+	struct Selection
+	{
+		std::vector<OutputDataEntity> inputs;
+		uint64_t amountToSend;
+		uint64_t fee;
+		uint8_t numChangeOutputs;
+	};
+
+	using Selector = std::function<Selection(const CoinIndex& availableCoins, const std::unordered_set<Commitment>& excluded)>;
+
+	//
+	// Runs each selector, excluding the inputs reserved by other sends and those selected by the previous selectors,
+	// and then reserves every selected input. Selection is retried if another send reserved one of them in the meantime.
+	// The caller must release the reservations once the inputs are LOCKED in the database (or the send failed).
+	//
+	std::vector<Selection> ReserveInputs(
+		const WalletImpl& wallet,
+		const SecureVector& masterSeed,
+		const std::vector<Selector>& selectors
+	) const;
+
+	//
+	// Coins in excluded are never selected.
+	//
+	Selection SelectInputs(
+		const CoinIndex& availableCoins,
+		const std::unordered_set<Commitment>& excluded,
+		const uint64_t amount,
+		const uint64_t feeBase,
+		const uint8_t maxChangeOutputs,
+		const bool sendEntireBalance,
+		const SelectionStrategyDTO& strategy
+	) const;
+
 	Slate Build(
-		const std::shared_ptr<WalletImpl>& pWallet,
+		const std::shared_ptr<const WalletImpl>& pWallet,
 		const SecureVector& masterSeed,
 		const uint64_t amountToSend,
 		const uint64_t fee,
@@ -37,7 +37,9 @@ WalletBalanceDTO Wallet::GetBalance() const
 	uint64_t spendable = 0;
 
     auto pWalletDB = m_walletDB.Read();
-	const std::vector<OutputDataEntity> outputs = pWalletDB->GetOutputs(m_master_seed);
+
+	// Spent outputs don't count towards any of the balances, so they're never loaded.
+	const std::vector<OutputDataEntity> outputs = pWalletDB->GetUnspentOutputs(m_master_seed);
 	for (const OutputDataEntity& outputData : outputs)
 	{
 		const EOutputStatus status = outputData.GetStatus();
@@ -90,7 +92,8 @@ std::vector<WalletOutputDTO> Wallet::GetOutputs(const bool includeSpent, const b
 {
     std::vector<WalletOutputDTO> filtered_outputs;
 
-	const std::vector<OutputDataEntity> all_outputs = m_walletDB.Read()->GetOutputs(m_master_seed);
+	auto pWalletDB = m_walletDB.Read();
+	const std::vector<OutputDataEntity> all_outputs = includeSpent ? pWalletDB->GetOutputs(m_master_seed) : pWalletDB->GetUnspentOutputs(m_master_seed);
 	for (const OutputDataEntity& output_data : all_outputs)
 	{
 		const EOutputStatus status = output_data.GetStatus();
@@ -141,10 +144,18 @@ SlateContextEntity Wallet::GetSlateContext(const uuids::uuid& slateId) const
 
 std::optional<TorAddress> Wallet::AddTorListener(const KeyChainPath& path, const TorProcess::Ptr& pTorProcess)
 {
-	KeyChain keyChain = KeyChain::FromSeed(*m_pConfig, m_master_seed);
-	ed25519_keypair_t torKey = keyChain.DeriveED25519Key(path);
+	std::shared_ptr<TorAddress> pTorAddress = nullptr;
+	if (m_torAddressOpt.has_value()) {
+		pTorAddress = pTorProcess->AddListener(m_torAddressOpt.value(), GetListenerPort());
+	}
+
+	if (pTorAddress == nullptr) {
+		KeyChain keyChain = KeyChain::FromSeed(*m_pConfig, m_master_seed);
+		ed25519_keypair_t torKey = keyChain.DeriveED25519Key(path);
+
+		pTorAddress = pTorProcess->AddListener(torKey.secret_key, GetListenerPort());
+	}
 
-	std::shared_ptr<TorAddress> pTorAddress = pTorProcess->AddListener(torKey.secret_key, GetListenerPort());
 	if (pTorAddress != nullptr) {
 		SetTorAddress(*pTorAddress);
 	}
@@ -157,16 +168,8 @@ FeeEstimateDTO Wallet::EstimateFee(const EstimateFeeCriteria& criteria) const
 	// Select inputs using desired selection strategy.
 	const uint8_t totalNumOutputs = criteria.GetNumChangeOutputs() + 1;
 	const uint64_t numKernels = 1;
-	std::vector<OutputDataEntity> all_outputs = m_walletDB.Read()->GetOutputs(m_master_seed);
-    std::vector<OutputDataEntity> available_coins;
-    std::copy_if(
-        all_outputs.cbegin(), all_outputs.cend(),
-        std::back_inserter(available_coins),
-        [](const OutputDataEntity& output_data) { return output_data.GetStatus() == EOutputStatus::SPENDABLE; }
-    );
-
-	std::vector<OutputDataEntity> inputs = CoinSelection().SelectCoinsToSpend(
-		available_coins,
+	std::vector<OutputDataEntity> inputs = CoinSelection::SelectCoinsToSpend(
+		m_walletDB.Read()->GetCoinIndex(m_master_seed),
 		criteria.GetAmount(),
 		criteria.GetFeeBase(),
 		criteria.GetSelectionStrategy().GetStrategy(),
@@ -217,9 +220,9 @@ FeeEstimateDTO Wallet::EstimateFee(const EstimateFeeCriteria& criteria) const
 
 // }
 
-void Wallet::CancelTx(const uint32_t walletTxId)
+void Wallet::CancelTx(const uint32_t walletTxId) const
 {
-    auto pBatch = m_walletDB.BatchWrite();
+    auto pBatch = GetDatabase().BatchWrite();
 	std::unique_ptr<WalletTx> pWalletTx = pBatch->GetTransactionById(m_master_seed, walletTxId);
 	if (pWalletTx != nullptr) {
 		CancelTx::CancelWalletTx(m_master_seed, pBatch.GetShared(), *pWalletTx);
@@ -227,11 +230,11 @@ void Wallet::CancelTx(const uint32_t walletTxId)
 	}
 }
 
-BuildCoinbaseResponse Wallet::BuildCoinbase(const BuildCoinbaseCriteria& criteria)
+BuildCoinbaseResponse Wallet::BuildCoinbase(const BuildCoinbaseCriteria& criteria) const
 {
     const KeyChain keyChain = KeyChain::FromSeed(*m_pConfig, m_master_seed);
 
-	auto pDatabase = m_walletDB.BatchWrite();
+	auto pDatabase = GetDatabase().BatchWrite();
 
 	const uint64_t amount = Consensus::REWARD + criteria.GetFees();
 	const KeyChainPath keyChainPath = criteria.GetPath().value_or(
@@ -290,8 +293,13 @@ BuildCoinbaseResponse Wallet::BuildCoinbase(const BuildCoinbaseCriteria& criteri
 
 SlatepackMessage Wallet::DecryptSlatepack(const std::string& armoredSlatepack) const
 {
-	KeyChain keychain = KeyChain::FromSeed(*m_pConfig, m_master_seed);
+	return Armor::Unpack(armoredSlatepack, m_decryptKey);
+}
+
+x25519_keypair_t Wallet::DeriveDecryptKey(const Config& config, const SecureVector& master_seed)
+{
+	KeyChain keychain = KeyChain::FromSeed(config, master_seed);
 	ed25519_keypair_t decrypt_key = keychain.DeriveED25519Key(KeyChainPath::FromString("m/0/1/0"));
-	
-	return Armor::Unpack(armoredSlatepack, Curve25519::ToX25519(decrypt_key));
+
+	return Curve25519::ToX25519(decrypt_key);
 }
\ No newline at end of file
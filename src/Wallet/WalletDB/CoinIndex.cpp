@@ -0,0 +1,60 @@
+#include <Wallet/WalletDB/CoinIndex.h>
+
+void CoinIndex::Load(const std::vector<OutputDataEntity>& outputs)
+{
+	Clear();
+
+	m_loaded = true;
+	Update(outputs);
+}
+
+void CoinIndex::Update(const std::vector<OutputDataEntity>& outputs)
+{
+	if (!m_loaded)
+	{
+		return;
+	}
+
+	for (const OutputDataEntity& output : outputs)
+	{
+		const Commitment& commitment = output.GetCommitment();
+		Remove(commitment);
+
+		if (output.GetStatus() == EOutputStatus::SPENDABLE)
+		{
+			auto iter = m_coins.insert({ output.GetAmount(), output });
+			m_coinsByCommitment.insert({ commitment, iter });
+			m_total += output.GetAmount();
+		}
+	}
+}
+
+void CoinIndex::Clear()
+{
+	m_coins.clear();
+	m_coinsByCommitment.clear();
+	m_total = 0;
+	m_loaded = false;
+}
+
+const OutputDataEntity* CoinIndex::Find(const Commitment& commitment) const
+{
+	auto iter = m_coinsByCommitment.find(commitment);
+	if (iter != m_coinsByCommitment.end())
+	{
+		return &iter->second->second;
+	}
+
+	return nullptr;
+}
+
+void CoinIndex::Remove(const Commitment& commitment)
+{
+	auto iter = m_coinsByCommitment.find(commitment);
+	if (iter != m_coinsByCommitment.end())
+	{
+		m_total -= iter->second->first;
+		m_coins.erase(iter->second);
+		m_coinsByCommitment.erase(iter);
+	}
+}
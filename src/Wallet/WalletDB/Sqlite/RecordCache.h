@@ -0,0 +1,159 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+//
+// Write-through cache of a table's decrypted records, so reads don't need to query or decrypt every row.
+// Records are returned in the order they were first added, which matches the table's rowid order.
+//
+// Every write happens in a transaction, so writes are kept apart until Commit and a Rollback can discard them.
+// The table can't be loaded once the current transaction has written to it, since it would contain uncommitted rows.
+//
+template<typename K, typename V>
+class RecordCache
+{
+public:
+	RecordCache(const std::function<K(const V&)>& getKey)
+		: m_getKey(getKey), m_loaded(false), m_uncachedWrites(false) { }
+
+	bool IsLoaded() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return m_loaded;
+	}
+
+	bool CanLoad() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		return !m_loaded && !m_uncachedWrites;
+	}
+
+	void Load(const std::vector<V>& records)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_records.clear();
+		m_indexByKey.clear();
+		for (const V& record : records)
+		{
+			Put(m_records, m_indexByKey, record);
+		}
+
+		m_loaded = true;
+	}
+
+	void Clear()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_records.clear();
+		m_indexByKey.clear();
+		m_pending.clear();
+		m_pendingIndexByKey.clear();
+		m_loaded = false;
+		m_uncachedWrites = false;
+	}
+
+	// Records the rows written by the current transaction.
+	void Put(const std::vector<V>& records)
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		if (!m_loaded)
+		{
+			m_uncachedWrites = !records.empty() || m_uncachedWrites;
+			return;
+		}
+
+		for (const V& record : records)
+		{
+			Put(m_pending, m_pendingIndexByKey, record);
+		}
+	}
+
+	void Commit()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		for (const V& record : m_pending)
+		{
+			Put(m_records, m_indexByKey, record);
+		}
+
+		m_pending.clear();
+		m_pendingIndexByKey.clear();
+		m_uncachedWrites = false;
+	}
+
+	void Rollback()
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_pending.clear();
+		m_pendingIndexByKey.clear();
+		m_uncachedWrites = false;
+	}
+
+	std::vector<V> GetAll() const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		std::vector<V> records = m_records;
+		for (const V& record : m_pending)
+		{
+			auto iter = m_indexByKey.find(m_getKey(record));
+			if (iter != m_indexByKey.end())
+			{
+				records[iter->second] = record;
+			}
+			else
+			{
+				records.push_back(record);
+			}
+		}
+
+		return records;
+	}
+
+	std::unique_ptr<V> Get(const K& key) const
+	{
+		std::unique_lock<std::mutex> lock(m_mutex);
+		auto pendingIter = m_pendingIndexByKey.find(key);
+		if (pendingIter != m_pendingIndexByKey.end())
+		{
+			return std::make_unique<V>(m_pending[pendingIter->second]);
+		}
+
+		auto iter = m_indexByKey.find(key);
+		if (iter != m_indexByKey.end())
+		{
+			return std::make_unique<V>(m_records[iter->second]);
+		}
+
+		return nullptr;
+	}
+
+private:
+	void Put(std::vector<V>& records, std::unordered_map<K, size_t>& indexByKey, const V& record)
+	{
+		K key = m_getKey(record);
+		auto iter = indexByKey.find(key);
+		if (iter != indexByKey.end())
+		{
+			records[iter->second] = record;
+		}
+		else
+		{
+			indexByKey.insert({ std::move(key), records.size() });
+			records.push_back(record);
+		}
+	}
+
+	std::function<K(const V&)> m_getKey;
+
+	mutable std::mutex m_mutex;
+	bool m_loaded;
+	bool m_uncachedWrites;
+	std::vector<V> m_records;
+	std::unordered_map<K, size_t> m_indexByKey;
+	std::vector<V> m_pending;
+	std::unordered_map<K, size_t> m_pendingIndexByKey;
+};
@@ -14,7 +14,13 @@
 
 SqliteDB::Statement::~Statement()
 {
-	if (!m_finalized && sqlite3_finalize(m_pStatement) != SQLITE_OK) {
+	if (m_finalized) {
+		return;
+	}
+
+	if (m_pCache != nullptr) {
+		m_pCache->ReleaseStatement(m_sql, m_pStatement);
+	} else if (sqlite3_finalize(m_pStatement) != SQLITE_OK) {
 		WALLET_ERROR_F("Error finalizing statement: {}", sqlite3_errmsg(m_pDatabase));
     }
 }
@@ -27,6 +33,11 @@ bool SqliteDB::Statement::Step()
 void SqliteDB::Statement::Finalize()
 {
     m_finalized = true;
+	if (m_pCache != nullptr) {
+		m_pCache->ReleaseStatement(m_sql, m_pStatement);
+		return;
+	}
+
 	if (sqlite3_finalize(m_pStatement) != SQLITE_OK) {
 		WALLET_ERROR_F("Error finalizing statement: {}", sqlite3_errmsg(m_pDatabase));
 		throw WALLET_STORE_EXCEPTION("Error finalizing statement.");
@@ -50,6 +61,13 @@ std::vector<uint8_t> SqliteDB::Statement::GetColumnBytes(const int col) const
     return std::vector<uint8_t>{ pBytes, pBytes + size };
 }
 
+std::string SqliteDB::Statement::GetColumnString(const int col) const
+{
+    const unsigned char* pText = sqlite3_column_text(m_pStatement, col);
+    const int size = sqlite3_column_bytes(m_pStatement, col);
+    return pText != nullptr ? std::string((const char*)pText, (size_t)size) : std::string();
+}
+
 /**
  * 
  * SqliteDB
@@ -58,10 +76,15 @@ std::vector<uint8_t> SqliteDB::Statement::GetColumnBytes(const int col) const
 
 SqliteDB::~SqliteDB()
 {
+	for (auto& entry : m_statements)
+	{
+		sqlite3_finalize(entry.second);
+	}
+
 	sqlite3_close(m_pDatabase);
 }
 
-SqliteDB::Ptr SqliteDB::Open(const fs::path& db_path, const std::string& username)
+SqliteDB::Ptr SqliteDB::Open(const fs::path& db_path, const std::string& username, const std::string& synchronous)
 {
 	if (!FileUtil::Exists(db_path)) {
 		throw WALLET_STORE_EXCEPTION("Wallet does not exist.");
@@ -75,7 +98,11 @@ SqliteDB::Ptr SqliteDB::Open(const fs::path& db_path, const std::string& usernam
         throw WALLET_STORE_EXCEPTION("Failed to open wallet.db");
     }
 
-    return std::make_shared<SqliteDB>(pDatabase, username);
+    auto pSqliteDB = std::make_shared<SqliteDB>(pDatabase, username);
+    pSqliteDB->Execute("PRAGMA journal_mode=WAL;");
+    pSqliteDB->Execute("PRAGMA synchronous=" + synchronous + ";");
+
+    return pSqliteDB;
 }
 
 void SqliteDB::Execute(const std::string& command)
@@ -90,14 +117,8 @@ void SqliteDB::Execute(const std::string& command)
 
 void SqliteDB::Update(const std::string& statement, const std::vector<IParameter::UPtr>& parameters)
 {
-	sqlite3_stmt* stmt = nullptr;
-	if (sqlite3_prepare_v2(m_pDatabase, statement.c_str(), -1, &stmt, NULL) != SQLITE_OK) {
-		WALLET_ERROR_F("Error while compiling sql: {}", sqlite3_errmsg(m_pDatabase));
-		sqlite3_finalize(stmt);
-		throw WALLET_STORE_EXCEPTION("Error compiling statement.");
-	}
-
-    SqliteDB::Statement::UPtr pStatement = std::make_unique<SqliteDB::Statement>(m_pDatabase, stmt);
+	sqlite3_stmt* stmt = PrepareStatement(statement);
+    SqliteDB::Statement::UPtr pStatement = std::make_unique<SqliteDB::Statement>(m_pDatabase, stmt, this, statement);
 
     int index = 1;
     for (const auto& pParam : parameters)
@@ -111,12 +132,8 @@ void SqliteDB::Update(const std::string& statement, const std::vector<IParameter
 
 SqliteDB::Statement::UPtr SqliteDB::Query(const std::string& query, const std::vector<IParameter::UPtr>& parameters)
 {
-	sqlite3_stmt* stmt = nullptr;
-	if (sqlite3_prepare_v2(m_pDatabase, query.c_str(), -1, &stmt, NULL) != SQLITE_OK) {
-		WALLET_ERROR_F("Error while compiling sql: {}", sqlite3_errmsg(m_pDatabase));
-		sqlite3_finalize(stmt);
-		throw WALLET_STORE_EXCEPTION("Error compiling statement.");
-	}
+	sqlite3_stmt* stmt = PrepareStatement(query);
+    SqliteDB::Statement::UPtr pStatement = std::make_unique<SqliteDB::Statement>(m_pDatabase, stmt, this, query);
 
     int index = 1;
     for (const auto& pParam : parameters)
@@ -124,7 +141,43 @@ SqliteDB::Statement::UPtr SqliteDB::Query(const std::string& query, const std::v
         pParam->Bind(stmt, index++);
     }
 
-    return std::make_unique<SqliteDB::Statement>(m_pDatabase, stmt);
+    return pStatement;
+}
+
+sqlite3_stmt* SqliteDB::PrepareStatement(const std::string& sql)
+{
+	{
+		std::unique_lock<std::mutex> lock(m_statementsMutex);
+		auto iter = m_statements.find(sql);
+		if (iter != m_statements.end()) {
+			sqlite3_stmt* stmt = iter->second;
+			m_statements.erase(iter);
+			return stmt;
+		}
+	}
+
+	sqlite3_stmt* stmt = nullptr;
+	if (sqlite3_prepare_v2(m_pDatabase, sql.c_str(), -1, &stmt, NULL) != SQLITE_OK) {
+		WALLET_ERROR_F("Error while compiling sql: {}", sqlite3_errmsg(m_pDatabase));
+		sqlite3_finalize(stmt);
+		throw WALLET_STORE_EXCEPTION("Error compiling statement.");
+	}
+
+	return stmt;
+}
+
+void SqliteDB::ReleaseStatement(const std::string& sql, sqlite3_stmt* pStatement) noexcept
+{
+	// Errors from the last step are reported again by reset, but they've already been handled.
+	sqlite3_reset(pStatement);
+	sqlite3_clear_bindings(pStatement);
+
+	std::unique_lock<std::mutex> lock(m_statementsMutex);
+	if (m_statements.size() < MAX_CACHED_STATEMENTS) {
+		m_statements.insert({ sql, pStatement });
+	} else {
+		sqlite3_finalize(pStatement);
+	}
 }
 
 std::string SqliteDB::GetError() const
@@ -154,6 +207,14 @@ void IntParameter::Bind(sqlite3_stmt* stmt, const int index) const
     }
 }
 
+void Int64Parameter::Bind(sqlite3_stmt* stmt, const int index) const
+{
+	if (sqlite3_bind_int64(stmt, index, m_value) != SQLITE_OK) {
+		WALLET_ERROR_F("Failed to bind: {}", m_value);
+		throw WALLET_STORE_EXCEPTION("Failed to bind.");
+    }
+}
+
 void BlobParameter::Bind(sqlite3_stmt* stmt, const int index) const
 {
 	if (sqlite3_bind_blob(stmt, index, (const void*)m_blob.data(), (int)m_blob.size(), NULL) != SQLITE_OK) {
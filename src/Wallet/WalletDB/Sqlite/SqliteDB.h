@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 // Forward Declarations
 struct sqlite3;
@@ -18,7 +20,11 @@ public:
         using UPtr = std::unique_ptr<Statement>;
 
         Statement(sqlite3* pDatabase, sqlite3_stmt* pStatement)
-            : m_pDatabase(pDatabase), m_pStatement(pStatement), m_finalized(false) { }
+            : m_pDatabase(pDatabase), m_pStatement(pStatement), m_finalized(false), m_pCache(nullptr) { }
+
+        // Statements from the cache are reset and returned to it, rather than finalized.
+        Statement(sqlite3* pDatabase, sqlite3_stmt* pStatement, SqliteDB* pCache, const std::string& sql)
+            : m_pDatabase(pDatabase), m_pStatement(pStatement), m_finalized(false), m_pCache(pCache), m_sql(sql) { }
         ~Statement();
 
         bool Step();
@@ -27,11 +33,14 @@ public:
         int GetColumnInt(const int col) const;
         int64_t GetColumnInt64(const int col) const;
         std::vector<uint8_t> GetColumnBytes(const int col) const;
+        std::string GetColumnString(const int col) const;
 
     private:
         sqlite3* m_pDatabase;
         sqlite3_stmt* m_pStatement;
         bool m_finalized;
+        SqliteDB* m_pCache;
+        std::string m_sql;
     };
 
     class IParameter
@@ -45,7 +54,11 @@ public:
 
     using Ptr = std::shared_ptr<SqliteDB>;
 
-    static SqliteDB::Ptr Open(const fs::path& db_path, const std::string& username);
+    //
+    // Opens the database in WAL mode, so commits only append to the log instead of rewriting pages,
+    // with the given PRAGMA synchronous level (OFF, NORMAL, FULL, or EXTRA).
+    //
+    static SqliteDB::Ptr Open(const fs::path& db_path, const std::string& username, const std::string& synchronous);
 
     SqliteDB(sqlite3* pDatabase, const std::string& username)
         : m_pDatabase(pDatabase), m_username(username) { }
@@ -57,8 +70,18 @@ public:
     std::string GetError() const;
 
 private:
+    // Statements that were prepared from text that's already been seen are reused, so they aren't recompiled.
+    // The cache is bounded, since some statements have their values formatted into the text.
+    static constexpr size_t MAX_CACHED_STATEMENTS = 64;
+
+    sqlite3_stmt* PrepareStatement(const std::string& sql);
+    void ReleaseStatement(const std::string& sql, sqlite3_stmt* pStatement) noexcept;
+
     sqlite3* m_pDatabase;
     std::string m_username;
+
+    std::mutex m_statementsMutex;
+    std::unordered_multimap<std::string, sqlite3_stmt*> m_statements;
 };
 
 class TextParameter : public SqliteDB::IParameter
@@ -91,6 +114,21 @@ private:
     int m_value;
 };
 
+class Int64Parameter : public SqliteDB::IParameter
+{
+public:
+    Int64Parameter(const int64_t value) : m_value(value) { }
+    static SqliteDB::IParameter::UPtr New(const int64_t value)
+    {
+        return SqliteDB::IParameter::UPtr((SqliteDB::IParameter*)new Int64Parameter(value));
+    }
+
+    void Bind(sqlite3_stmt* stmt, const int index) const final;
+
+private:
+    int64_t m_value;
+};
+
 class BlobParameter : public SqliteDB::IParameter
 {
 public:
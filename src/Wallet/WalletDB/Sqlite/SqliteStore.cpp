@@ -17,7 +17,10 @@ static const uint8_t ENCRYPTION_FORMAT = 0;
 
 std::shared_ptr<SqliteStore> SqliteStore::Open(const Config& config)
 {
-	return std::make_shared<SqliteStore>(SqliteStore(config.GetWalletConfig().GetWalletDirectory()));
+	return std::make_shared<SqliteStore>(SqliteStore(
+		config.GetWalletConfig().GetWalletDirectory(),
+		config.GetWalletConfig().GetSqliteSynchronous()
+	));
 }
 
 fs::path SqliteStore::GetDBFile(const std::string& username) const
@@ -43,7 +46,7 @@ Locked<IWalletDB> SqliteStore::OpenWallet(const std::string& username, const Sec
 		throw WALLET_STORE_EXCEPTION("Wallet does not exist.");
 	}
 	
-	SqliteDB::Ptr pDatabase = SqliteDB::Open(dbFile, username);
+	SqliteDB::Ptr pDatabase = SqliteDB::Open(dbFile, username, m_synchronous);
 
 	const int version = VersionTable::GetCurrentVersion(*pDatabase);
 	if (version < LATEST_SCHEMA_VERSION) {
@@ -52,6 +55,7 @@ Locked<IWalletDB> SqliteStore::OpenWallet(const std::string& username, const Sec
 
 		VersionTable::UpdateSchema(*pDatabase, version);
 		OutputsTable::UpdateSchema(*pDatabase, masterSeed, version);
+		TransactionsTable::UpdateSchema(*pDatabase, masterSeed, version);
 		MetadataTable::UpdateSchema(*pDatabase, version);
 		SlateContextTable::UpdateSchema(*pDatabase, version);
 		SlateTable::UpdateSchema(*pDatabase, version);
@@ -123,7 +127,7 @@ SqliteDB::Ptr SqliteStore::CreateWalletDB(const std::string& username)
 
 	try
 	{
-		SqliteDB::Ptr pDatabase = SqliteDB::Open(walletDBFile, username);
+		SqliteDB::Ptr pDatabase = SqliteDB::Open(walletDBFile, username, m_synchronous);
 
 		SqliteTransaction transaction(pDatabase);
 		transaction.Begin();
@@ -22,11 +22,13 @@ public:
 	EncryptedSeed LoadWalletSeed(const std::string& username) const final;
 
 private:
-	SqliteStore(const fs::path& walletDirectory) : m_walletDirectory(walletDirectory) { }
+	SqliteStore(const fs::path& walletDirectory, const std::string& synchronous)
+		: m_walletDirectory(walletDirectory), m_synchronous(synchronous) { }
 
 	SqliteDB::Ptr CreateWalletDB(const std::string& username);
 	fs::path GetDBFile(const std::string& username) const;
 
 	const fs::path& m_walletDirectory;
+	std::string m_synchronous;
 	std::unordered_map<std::string, Locked<IWalletDB>> m_userDBs;
 };
\ No newline at end of file
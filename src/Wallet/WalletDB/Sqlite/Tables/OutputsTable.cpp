@@ -4,6 +4,7 @@
 #include <Common/Logger.h>
 #include <Common/Util/StringUtil.h>
 #include <Wallet/WalletDB/WalletStoreException.h>
+#include <algorithm>
 
 // TABLE: outputs
 // id: INTEGER PRIMARY KEY
@@ -15,11 +16,25 @@ void OutputsTable::CreateTable(SqliteDB& database)
 {
 	std::string table_creation_cmd = "create table outputs(id INTEGER PRIMARY KEY, commitment TEXT UNIQUE NOT NULL, status INTEGER NOT NULL, transaction_id INTEGER, encrypted BLOB NOT NULL);";
 	database.Execute(table_creation_cmd);
+
+	CreateIndexes(database);
+}
+
+void OutputsTable::CreateIndexes(SqliteDB& database)
+{
+	std::string index_creation_cmd = "create index if not exists outputs_status on outputs(status);";
+	index_creation_cmd += "create index if not exists outputs_transaction_id on outputs(transaction_id);";
+	database.Execute(index_creation_cmd);
 }
 
 void OutputsTable::UpdateSchema(SqliteDB& database, const SecureVector& masterSeed, const int previousVersion)
 {
+	if (previousVersion >= 3) {
+		return;
+	}
+
 	if (previousVersion >= 1) {
+		CreateIndexes(database);
 		return;
 	}
 
@@ -40,6 +55,8 @@ void OutputsTable::UpdateSchema(SqliteDB& database, const SecureVector& masterSe
 	// Rename "new_outputs" table to "outputs"
 	const std::string rename_table_cmd = "ALTER TABLE new_outputs RENAME TO outputs";
 	database.Execute(rename_table_cmd);
+
+	CreateIndexes(database);
 }
 
 void OutputsTable::AddOutputs(SqliteDB& database, const SecureVector& masterSeed, const std::vector<OutputDataEntity>& outputs)
@@ -49,16 +66,18 @@ void OutputsTable::AddOutputs(SqliteDB& database, const SecureVector& masterSeed
 
 void OutputsTable::AddOutputs(SqliteDB& database, const SecureVector& masterSeed, const std::vector<OutputDataEntity>& outputs, const std::string& tableName)
 {
+	// The same statement is used for every row, so it's only compiled once.
+	std::string insert_output_cmd = "insert into " + tableName + "(commitment, status, transaction_id, encrypted) values(?, ?, ?, ?)";
+	insert_output_cmd += " ON CONFLICT(commitment) DO UPDATE SET status=excluded.status, transaction_id=excluded.transaction_id, encrypted=excluded.encrypted";
+
+	const SecretKey key = WalletEncryptionUtil::CreateSecureKey(masterSeed, "OUTPUT");
 	for (const OutputDataEntity& output : outputs)
 	{
 		WALLET_DEBUG_F("Saving output: {}", output.GetOutput());
 
-		std::string insert_output_cmd = "insert into " + tableName + "(commitment, status, transaction_id, encrypted) values(?, ?, ?, ?)";
-		insert_output_cmd += " ON CONFLICT(commitment) DO UPDATE SET status=excluded.status, transaction_id=excluded.transaction_id, encrypted=excluded.encrypted";
-
 		Serializer serializer;
 		output.Serialize(serializer);
-		std::vector<uint8_t> encrypted = WalletEncryptionUtil::Encrypt(masterSeed, "OUTPUT", serializer.GetSecureBytes());
+		std::vector<uint8_t> encrypted = WalletEncryptionUtil::Encrypt(key, serializer.GetSecureBytes());
 
 		std::vector<SqliteDB::IParameter::UPtr> parameters;
 		parameters.push_back(std::make_unique<TextParameter>(output.GetOutput().GetCommitment().ToHex()));
@@ -87,11 +106,57 @@ std::vector<OutputDataEntity> OutputsTable::GetOutputs(SqliteDB& database, const
 	std::string get_encrypted_query = "select encrypted from outputs";
 	auto pStatement = database.Query(get_encrypted_query);
 
+	return ReadOutputs(*pStatement, masterSeed);
+}
+
+std::vector<OutputDataEntity> OutputsTable::GetUnspentOutputs(SqliteDB& database, const SecureVector& masterSeed)
+{
+	// Uses the unencrypted status column, so spent outputs are never decrypted.
+	std::string get_encrypted_query = "select encrypted from outputs where status<>?";
+	std::vector<SqliteDB::IParameter::UPtr> parameters;
+	parameters.push_back(IntParameter::New((int)EOutputStatus::SPENT));
+
+	auto pStatement = database.Query(get_encrypted_query, parameters);
+
+	return ReadOutputs(*pStatement, masterSeed);
+}
+
+std::vector<OutputDataEntity> OutputsTable::GetOutputs(SqliteDB& database, const SecureVector& masterSeed, const std::vector<uint32_t>& walletTxIds)
+{
+	// Queried in chunks, to stay well under sqlite's limit on the number of parameters.
+	std::vector<OutputDataEntity> outputs;
+	for (size_t i = 0; i < walletTxIds.size(); i += MAX_IDS_PER_QUERY)
+	{
+		const size_t numIds = (std::min)(MAX_IDS_PER_QUERY, walletTxIds.size() - i);
+
+		std::string get_encrypted_query = "select encrypted from outputs where transaction_id in (?";
+		std::vector<SqliteDB::IParameter::UPtr> parameters;
+		parameters.push_back(IntParameter::New((int)walletTxIds[i]));
+		for (size_t j = 1; j < numIds; j++)
+		{
+			get_encrypted_query += ",?";
+			parameters.push_back(IntParameter::New((int)walletTxIds[i + j]));
+		}
+
+		get_encrypted_query += ") order by id";
+
+		auto pStatement = database.Query(get_encrypted_query, parameters);
+		std::vector<OutputDataEntity> chunk = ReadOutputs(*pStatement, masterSeed);
+		outputs.insert(outputs.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+	}
+
+	return outputs;
+}
+
+std::vector<OutputDataEntity> OutputsTable::ReadOutputs(SqliteDB::Statement& statement, const SecureVector& masterSeed)
+{
+	const SecretKey key = WalletEncryptionUtil::CreateSecureKey(masterSeed, "OUTPUT");
+
 	std::vector<OutputDataEntity> outputs;
-	while (pStatement->Step())
+	while (statement.Step())
 	{
-		std::vector<uint8_t> encrypted = pStatement->GetColumnBytes(0);
-		SecureVector decrypted = WalletEncryptionUtil::Decrypt(masterSeed, "OUTPUT", encrypted);
+		std::vector<uint8_t> encrypted = statement.GetColumnBytes(0);
+		SecureVector decrypted = WalletEncryptionUtil::Decrypt(key, encrypted);
 		std::vector<uint8_t> decryptedUnsafe(decrypted.begin(), decrypted.end());
 
 		ByteBuffer byteBuffer(std::move(decryptedUnsafe));
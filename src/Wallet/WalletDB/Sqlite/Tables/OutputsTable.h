@@ -13,8 +13,14 @@ public:
 
 	static void AddOutputs(SqliteDB& database, const SecureVector& masterSeed, const std::vector<OutputDataEntity>& outputs);
 	static std::vector<OutputDataEntity> GetOutputs(SqliteDB& database, const SecureVector& masterSeed);
+	static std::vector<OutputDataEntity> GetUnspentOutputs(SqliteDB& database, const SecureVector& masterSeed);
+	static std::vector<OutputDataEntity> GetOutputs(SqliteDB& database, const SecureVector& masterSeed, const std::vector<uint32_t>& walletTxIds);
 
 private:
+	static constexpr size_t MAX_IDS_PER_QUERY = 500;
+
+	static void CreateIndexes(SqliteDB& database);
 	static void AddOutputs(SqliteDB& database, const SecureVector& masterSeed, const std::vector<OutputDataEntity>& outputs, const std::string& tableName);
 	static std::vector<OutputDataEntity> GetOutputs(SqliteDB& database, const SecureVector& masterSeed, const int version);
+	static std::vector<OutputDataEntity> ReadOutputs(SqliteDB::Statement& statement, const SecureVector& masterSeed);
 };
\ No newline at end of file
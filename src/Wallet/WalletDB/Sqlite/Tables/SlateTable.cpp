@@ -8,17 +8,34 @@
 #include <Common/Logger.h>
 #include <Wallet/WalletDB/WalletStoreException.h>
 
+#include <zlib.h>
+
+// Slates are well under this, so anything larger is corrupt.
+static const size_t MAX_SLATE_SIZE = 16 * 1024 * 1024;
+
 void SlateTable::CreateTable(SqliteDB& database)
 {
-	std::string table_creation_cmd = "create table slate(slate_id TEXT NOT NULL, stage TEXT NOT NULL, iv BLOB NOT NULL, slate BLOB NOT NULL);";
+	std::string table_creation_cmd = "create table slate(slate_id TEXT NOT NULL, stage TEXT NOT NULL, iv BLOB NOT NULL, slate BLOB NOT NULL, format INTEGER NOT NULL DEFAULT 0);";
 	// TODO: Add indices
 	database.Execute(table_creation_cmd);
+
+	CreateProofTable(database);
+}
+
+void SlateTable::CreateProofTable(SqliteDB& database)
+{
+	std::string table_creation_cmd = "create table slate_proof(slate_id TEXT NOT NULL, commitment TEXT NOT NULL, iv BLOB NOT NULL, proof BLOB NOT NULL, PRIMARY KEY(slate_id, commitment));";
+	database.Execute(table_creation_cmd);
 }
 
 void SlateTable::UpdateSchema(SqliteDB& database, const int previousVersion)
 {
 	if (previousVersion < 2) {
 		CreateTable(database);
+	} else if (previousVersion < 4) {
+		// Existing rows are left LEGACY, and rewritten in the background by MigrateSlates.
+		database.Execute("ALTER TABLE slate ADD COLUMN format INTEGER NOT NULL DEFAULT 0;");
+		CreateProofTable(database);
 	}
 }
 
@@ -28,16 +45,17 @@ void SlateTable::SaveSlate(
 	const Slate& slate)
 {
 	// TODO: Update if it already exists?
-	std::string insert_slate_cmd = "insert into slate values(?, ?, ?, ?)";
+	std::string insert_slate_cmd = "insert into slate values(?, ?, ?, ?, ?)";
 
 	CBigInteger<16> iv(CSPRNG::GenerateRandomBytes(16).data());
-	std::vector<uint8_t> encrypted = Encrypt(masterSeed, iv, slate);
+	std::vector<uint8_t> encrypted = EncryptCompact(database, masterSeed, iv, slate);
 
 	std::vector<SqliteDB::IParameter::UPtr> parameters;
 	parameters.push_back(TextParameter::New(uuids::to_string(slate.slateId)));
 	parameters.push_back(TextParameter::New(slate.stage.ToString()));
 	parameters.push_back(BlobParameter::New(iv.GetData()));
 	parameters.push_back(BlobParameter::New(encrypted));
+	parameters.push_back(IntParameter::New(EFormat::COMPACT));
 	
 	database.Update(insert_slate_cmd, parameters);
 }
@@ -48,7 +66,7 @@ std::unique_ptr<Slate> SlateTable::LoadSlate(
 	const uuids::uuid& slateId,
 	const SlateStage& stage)
 {
-	std::string get_slate_query = StringUtil::Format("SELECT iv, slate FROM slate WHERE slate_id='{}' and stage='{}'", uuids::to_string(slateId), stage.ToString());
+	std::string get_slate_query = StringUtil::Format("SELECT iv, slate, format FROM slate WHERE slate_id='{}' and stage='{}'", uuids::to_string(slateId), stage.ToString());
 	auto pStatement = database.Query(get_slate_query);
 
 	if (!pStatement->Step()) {
@@ -69,8 +87,14 @@ std::unique_ptr<Slate> SlateTable::LoadSlate(
 	try
 	{
 		std::vector<uint8_t> encrypted = pStatement->GetColumnBytes(1);
+		const int format = pStatement->GetColumnInt(2);
+		pStatement.reset();
+
+		if (format == EFormat::LEGACY) {
+			return std::make_unique<Slate>(DecryptLegacy(masterSeed, slateId, iv, encrypted));
+		}
 
-		return std::make_unique<Slate>(Decrypt(masterSeed, slateId, iv, encrypted));
+		return std::make_unique<Slate>(DecryptCompact(database, masterSeed, slateId, iv, encrypted));
 	}
 	catch (std::exception& e)
 	{
@@ -79,21 +103,125 @@ std::unique_ptr<Slate> SlateTable::LoadSlate(
 	}
 }
 
-// Binary serializes a slate, encrypts it with AES256 using a random 16-byte IV, and returns it as: `IV | encrypted_slate`
-std::vector<uint8_t> SlateTable::Encrypt(
+size_t SlateTable::MigrateSlates(
+	SqliteDB& database,
+	const SecureVector& masterSeed,
+	const size_t maxSlates)
+{
+	struct LegacyRow
+	{
+		int64_t rowId;
+		uuids::uuid slateId;
+		CBigInteger<16> iv;
+		std::vector<uint8_t> encrypted;
+	};
+
+	// The rows are read before any are rewritten, so the query isn't stepped while the table changes under it.
+	std::vector<LegacyRow> rows;
+	{
+		std::string get_legacy_query = StringUtil::Format("SELECT rowid, slate_id, iv, slate FROM slate WHERE format={} LIMIT {}", (int)EFormat::LEGACY, maxSlates);
+		auto pStatement = database.Query(get_legacy_query);
+		while (pStatement->Step())
+		{
+			std::optional<uuids::uuid> slateIdOpt = uuids::uuid::from_string(pStatement->GetColumnString(1));
+			std::vector<uint8_t> iv_bytes = pStatement->GetColumnBytes(2);
+			if (!slateIdOpt.has_value() || iv_bytes.size() != 16) {
+				throw WALLET_STORE_EXCEPTION("Slate corrupted.");
+			}
+
+			rows.push_back(LegacyRow{
+				pStatement->GetColumnInt64(0),
+				slateIdOpt.value(),
+				CBigInteger<16>(std::move(iv_bytes)),
+				pStatement->GetColumnBytes(3)
+			});
+		}
+	}
+
+	for (const LegacyRow& row : rows)
+	{
+		Slate slate = DecryptLegacy(masterSeed, row.slateId, row.iv, row.encrypted);
+
+		CBigInteger<16> iv(CSPRNG::GenerateRandomBytes(16).data());
+		std::vector<uint8_t> encrypted = EncryptCompact(database, masterSeed, iv, slate);
+
+		std::vector<SqliteDB::IParameter::UPtr> parameters;
+		parameters.push_back(BlobParameter::New(iv.GetData()));
+		parameters.push_back(BlobParameter::New(encrypted));
+		parameters.push_back(IntParameter::New(EFormat::COMPACT));
+		parameters.push_back(Int64Parameter::New(row.rowId));
+
+		database.Update("UPDATE slate SET iv=?, slate=?, format=? WHERE rowid=?", parameters);
+	}
+
+	return rows.size();
+}
+
+//
+// COMPACT: `u32 size | deflate(slate without rangeproofs | u8 per commitment, 1 if its proof is in slate_proof)`, encrypted with AES256.
+//
+std::vector<uint8_t> SlateTable::EncryptCompact(
+	SqliteDB& database,
 	const SecureVector& masterSeed,
 	const CBigInteger<16>& iv,
 	const Slate& slate)
 {
-	// Encrypt slate
-	Serializer serializer;
-	slate.Serialize(serializer);
 	SecretKey aes_key = DeriveAESKey(masterSeed, slate.slateId);
+	SaveProofs(database, aes_key, slate);
+
+	Slate stripped = slate;
+	for (SlateCommitment& commitment : stripped.commitments)
+	{
+		commitment.proofOpt = std::nullopt;
+	}
+
+	Serializer serializer;
+	stripped.Serialize(serializer);
+	for (const SlateCommitment& commitment : slate.commitments)
+	{
+		serializer.Append<uint8_t>(commitment.proofOpt.has_value() ? 1 : 0);
+	}
+
+	return AES256::Encrypt(Compress(serializer.GetSecureBytes()), aes_key, iv);
+}
+
+Slate SlateTable::DecryptCompact(
+	SqliteDB& database,
+	const SecureVector& masterSeed,
+	const uuids::uuid& slateId,
+	const CBigInteger<16>& iv,
+	const std::vector<uint8_t>& encrypted)
+{
+	SecretKey aesKey = DeriveAESKey(masterSeed, slateId);
+	SecureVector decrypted = Decompress(AES256::Decrypt(encrypted, aesKey, iv));
+
+	ByteBuffer byteBuffer(decrypted.data(), decrypted.size());
+	Slate slate = Slate::Deserialize(byteBuffer);
+
+	std::unordered_map<Commitment, RangeProof> proofs;
+	for (SlateCommitment& commitment : slate.commitments)
+	{
+		if (byteBuffer.ReadU8() == 0) {
+			continue;
+		}
+
+		if (proofs.empty()) {
+			proofs = LoadProofs(database, aesKey, slateId);
+		}
+
+		auto iter = proofs.find(commitment.commitment);
+		if (iter == proofs.end()) {
+			throw WALLET_STORE_EXCEPTION_F("Rangeproof missing for {}", commitment.commitment);
+		}
 
-	return AES256::Encrypt(serializer.GetSecureBytes(), aes_key, iv);
+		commitment.proofOpt = std::make_optional<RangeProof>(iter->second);
+	}
+
+	return slate;
 }
 
-Slate SlateTable::Decrypt(
+// LEGACY: The binary serialized slate, encrypted with AES256.
+Slate SlateTable::DecryptLegacy(
 	const SecureVector& masterSeed,
 	const uuids::uuid& slateId,
 	const CBigInteger<16>& iv,
@@ -102,10 +230,96 @@ Slate SlateTable::Decrypt(
 	SecretKey aesKey = DeriveAESKey(masterSeed, slateId);
 	SecureVector decrypted = AES256::Decrypt(encrypted, aesKey, iv);
 
-	ByteBuffer byteBuffer(std::vector<uint8_t>{ decrypted.data(), decrypted.data() + decrypted.size() });
+	ByteBuffer byteBuffer(decrypted.data(), decrypted.size());
 	return Slate::Deserialize(byteBuffer);
 }
 
+void SlateTable::SaveProofs(SqliteDB& database, const SecretKey& aesKey, const Slate& slate)
+{
+	// A stage's proofs are usually already stored by an earlier stage, in which case they're ignored.
+	for (const SlateCommitment& commitment : slate.commitments)
+	{
+		if (!commitment.proofOpt.has_value()) {
+			continue;
+		}
+
+		Serializer serializer;
+		commitment.proofOpt.value().Serialize(serializer);
+
+		CBigInteger<16> iv(CSPRNG::GenerateRandomBytes(16).data());
+
+		std::vector<SqliteDB::IParameter::UPtr> parameters;
+		parameters.push_back(TextParameter::New(uuids::to_string(slate.slateId)));
+		parameters.push_back(TextParameter::New(commitment.commitment.ToHex()));
+		parameters.push_back(BlobParameter::New(iv.GetData()));
+		parameters.push_back(BlobParameter::New(AES256::Encrypt(serializer.GetSecureBytes(), aesKey, iv)));
+
+		database.Update("insert or ignore into slate_proof values(?, ?, ?, ?)", parameters);
+	}
+}
+
+std::unordered_map<Commitment, RangeProof> SlateTable::LoadProofs(SqliteDB& database, const SecretKey& aesKey, const uuids::uuid& slateId)
+{
+	std::unordered_map<Commitment, RangeProof> proofs;
+
+	std::string get_proofs_query = StringUtil::Format("SELECT commitment, iv, proof FROM slate_proof WHERE slate_id='{}'", uuids::to_string(slateId));
+	auto pStatement = database.Query(get_proofs_query);
+	while (pStatement->Step())
+	{
+		std::vector<uint8_t> iv_bytes = pStatement->GetColumnBytes(1);
+		if (iv_bytes.size() != 16) {
+			throw WALLET_STORE_EXCEPTION("Rangeproof corrupted.");
+		}
+
+		SecureVector decrypted = AES256::Decrypt(pStatement->GetColumnBytes(2), aesKey, CBigInteger<16>(std::move(iv_bytes)));
+		ByteBuffer byteBuffer(decrypted.data(), decrypted.size());
+		proofs.insert({ Commitment::FromHex(pStatement->GetColumnString(0)), RangeProof::Deserialize(byteBuffer) });
+	}
+
+	return proofs;
+}
+
+SecureVector SlateTable::Compress(const SecureVector& data)
+{
+	uLongf compressedSize = compressBound((uLong)data.size());
+	SecureVector compressed(4 + compressedSize);
+
+	const int status = compress2(compressed.data() + 4, &compressedSize, data.data(), (uLong)data.size(), Z_BEST_COMPRESSION);
+	if (status != Z_OK) {
+		throw WALLET_STORE_EXCEPTION_F("Failed to compress slate. Error: {}", status);
+	}
+
+	const uint32_t size = (uint32_t)data.size();
+	compressed[0] = (uint8_t)(size >> 24);
+	compressed[1] = (uint8_t)(size >> 16);
+	compressed[2] = (uint8_t)(size >> 8);
+	compressed[3] = (uint8_t)size;
+	compressed.resize(4 + compressedSize);
+
+	return compressed;
+}
+
+SecureVector SlateTable::Decompress(const SecureVector& compressed)
+{
+	if (compressed.size() < 4) {
+		throw WALLET_STORE_EXCEPTION("Slate corrupted.");
+	}
+
+	const size_t size = ((size_t)compressed[0] << 24) | ((size_t)compressed[1] << 16) | ((size_t)compressed[2] << 8) | (size_t)compressed[3];
+	if (size > MAX_SLATE_SIZE) {
+		throw WALLET_STORE_EXCEPTION("Slate corrupted.");
+	}
+
+	SecureVector decompressed(size);
+	uLongf decompressedSize = (uLongf)size;
+	const int status = uncompress(decompressed.data(), &decompressedSize, compressed.data() + 4, (uLong)(compressed.size() - 4));
+	if (status != Z_OK || decompressedSize != size) {
+		throw WALLET_STORE_EXCEPTION_F("Failed to decompress slate. Error: {}", status);
+	}
+
+	return decompressed;
+}
+
 Hash SlateTable::DeriveAESKey(const SecureVector& masterSeed, const uuids::uuid& slateId)
 {
 	Serializer serializer;
@@ -3,10 +3,17 @@
 #include <Common/Secure.h>
 #include <uuid.h>
 #include <Wallet/Models/Slate/Slate.h>
+#include <unordered_map>
 
 // Forward Declarations
 class SqliteDB;
 
+//
+// Slates are stored encrypted, one row per stage. Rows are written in the COMPACT format:
+// the slate's rangeproofs are moved to the slate_proof table, where each is stored once for every stage of the slate it's in,
+// and the rest of the slate is deflated before it's encrypted.
+// Rows written before schema version 4 are LEGACY, and are rewritten as COMPACT by MigrateSlates.
+//
 class SlateTable
 {
 public:
@@ -26,18 +33,49 @@ public:
 		const Slate& slate
 	);
 
+	//
+	// Rewrites up to maxSlates LEGACY rows as COMPACT. Returns the number rewritten, so 0 once there are none left.
+	//
+	static size_t MigrateSlates(
+		SqliteDB& database,
+		const SecureVector& masterSeed,
+		const size_t maxSlates
+	);
+
 private:
-	static std::vector<uint8_t> Encrypt(
+	enum EFormat
+	{
+		LEGACY = 0,
+		COMPACT = 1
+	};
+
+	static void CreateProofTable(SqliteDB& database);
+
+	static std::vector<uint8_t> EncryptCompact(
+		SqliteDB& database,
 		const SecureVector& masterSeed,
 		const CBigInteger<16>& iv,
 		const Slate& slate
 	);
-	static Slate Decrypt(
+	static Slate DecryptCompact(
+		SqliteDB& database,
 		const SecureVector& masterSeed,
 		const uuids::uuid& slateId,
 		const CBigInteger<16>& iv,
 		const std::vector<uint8_t>& encrypted
 	);
+	static Slate DecryptLegacy(
+		const SecureVector& masterSeed,
+		const uuids::uuid& slateId,
+		const CBigInteger<16>& iv,
+		const std::vector<uint8_t>& encrypted
+	);
+
+	static void SaveProofs(SqliteDB& database, const SecretKey& aesKey, const Slate& slate);
+	static std::unordered_map<Commitment, RangeProof> LoadProofs(SqliteDB& database, const SecretKey& aesKey, const uuids::uuid& slateId);
+
+	static SecureVector Compress(const SecureVector& data);
+	static SecureVector Decompress(const SecureVector& compressed);
 
 	static Hash DeriveAESKey(const SecureVector& masterSeed, const uuids::uuid& slateId);
 };
\ No newline at end of file
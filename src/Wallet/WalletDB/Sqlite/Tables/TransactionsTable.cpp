@@ -10,28 +10,54 @@
 // id: INTEGER PRIMARY KEY
 // slate_id: TEXT
 // encrypted: BLOB NOT NULL
+// type: INTEGER
+// tx_time: INTEGER
+//
+// type and tx_time (see WalletTxQuery::GetTime) aren't sensitive, so they're stored unencrypted
+// to allow transactions to be filtered and paged without decrypting them.
 void TransactionsTable::CreateTable(SqliteDB& database)
 {
-	const std::string table_creation_cmd = "create table transactions(id INTEGER PRIMARY KEY, slate_id TEXT, encrypted BLOB NOT NULL);";
+	const std::string table_creation_cmd = "create table transactions(id INTEGER PRIMARY KEY, slate_id TEXT, encrypted BLOB NOT NULL, type INTEGER, tx_time INTEGER);";
 	database.Execute(table_creation_cmd);
+
+	CreateIndexes(database);
+}
+
+void TransactionsTable::CreateIndexes(SqliteDB& database)
+{
+	std::string index_creation_cmd = "create index if not exists transactions_type on transactions(type);";
+	index_creation_cmd += "create index if not exists transactions_tx_time on transactions(tx_time);";
+	database.Execute(index_creation_cmd);
 }
 
-void TransactionsTable::UpdateSchema(SqliteDB& /*database*/, const SecureVector& /*masterSeed*/, const int /*previousVersion*/)
+void TransactionsTable::UpdateSchema(SqliteDB& database, const SecureVector& masterSeed, const int previousVersion)
 {
-	return;
+	if (previousVersion >= 3) {
+		return;
+	}
+
+	std::string add_columns_cmd = "ALTER TABLE transactions ADD COLUMN type INTEGER;";
+	add_columns_cmd += "ALTER TABLE transactions ADD COLUMN tx_time INTEGER;";
+	database.Execute(add_columns_cmd);
+
+	// Rewriting every transaction populates the new columns.
+	AddTransactions(database, masterSeed, GetTransactions(database, masterSeed));
+
+	CreateIndexes(database);
 }
 
 void TransactionsTable::AddTransactions(SqliteDB& database, const SecureVector& masterSeed, const std::vector<WalletTx>& transactions)
 {
+	// The same statement is used for every row, so it's only compiled once.
+	std::string insert_tx_cmd = "insert into transactions(id, slate_id, encrypted, type, tx_time) values(?, ?, ?, ?, ?)";
+	insert_tx_cmd += " ON CONFLICT(id) DO UPDATE SET slate_id=excluded.slate_id, encrypted=excluded.encrypted, type=excluded.type, tx_time=excluded.tx_time";
+
+	const SecretKey key = WalletEncryptionUtil::CreateSecureKey(masterSeed, "WALLET_TX");
 	for (const WalletTx& walletTx : transactions)
 	{
-		sqlite3_stmt* stmt = nullptr;
-		std::string insert_tx_cmd = "insert into transactions(id, slate_id, encrypted) values(?, ?, ?)";
-		insert_tx_cmd += " ON CONFLICT(id) DO UPDATE SET slate_id=excluded.slate_id, encrypted=excluded.encrypted";
-
 		Serializer serializer;
 		walletTx.Serialize(serializer);
-		std::vector<uint8_t> encrypted = WalletEncryptionUtil::Encrypt(masterSeed, "WALLET_TX", serializer.GetSecureBytes());
+		std::vector<uint8_t> encrypted = WalletEncryptionUtil::Encrypt(key, serializer.GetSecureBytes());
 
 		std::vector<SqliteDB::IParameter::UPtr> parameters;
 		parameters.push_back(IntParameter::New((int)walletTx.GetId()));
@@ -43,6 +69,8 @@ void TransactionsTable::AddTransactions(SqliteDB& database, const SecureVector&
 		}
 		
 		parameters.push_back(BlobParameter::New(encrypted));
+		parameters.push_back(IntParameter::New((int)walletTx.GetType()));
+		parameters.push_back(Int64Parameter::New(WalletTxQuery::GetTime(walletTx)));
 		
 		database.Update(insert_tx_cmd, parameters);
 	}
@@ -53,11 +81,55 @@ std::vector<WalletTx> TransactionsTable::GetTransactions(SqliteDB& database, con
 	std::string get_tx_query = "select encrypted from transactions";
 	auto pStatement = database.Query(get_tx_query);
 
+	return ReadTransactions(*pStatement, masterSeed);
+}
+
+std::vector<WalletTx> TransactionsTable::GetTransactions(SqliteDB& database, const SecureVector& masterSeed, const WalletTxQuery& query)
+{
+	// Only the selected page of transactions is decrypted.
+	std::string get_tx_query = "select encrypted from transactions where 1=1";
+	std::vector<SqliteDB::IParameter::UPtr> parameters;
+
+	if (!query.GetTypes().empty()) {
+		get_tx_query += " and type in (";
+		for (auto iter = query.GetTypes().cbegin(); iter != query.GetTypes().cend(); iter++)
+		{
+			get_tx_query += iter == query.GetTypes().cbegin() ? "?" : ",?";
+			parameters.push_back(IntParameter::New((int)*iter));
+		}
+
+		get_tx_query += ")";
+	}
+
+	if (query.GetStartTimeMs().has_value()) {
+		get_tx_query += " and tx_time>=?";
+		parameters.push_back(Int64Parameter::New(query.GetStartTimeMs().value()));
+	}
+
+	if (query.GetEndTimeMs().has_value()) {
+		get_tx_query += " and tx_time<=?";
+		parameters.push_back(Int64Parameter::New(query.GetEndTimeMs().value()));
+	}
+
+	// A negative limit means no limit.
+	get_tx_query += " order by id limit ? offset ?";
+	parameters.push_back(Int64Parameter::New(query.GetLimit().has_value() ? (int64_t)query.GetLimit().value() : -1));
+	parameters.push_back(Int64Parameter::New((int64_t)query.GetOffset()));
+
+	auto pStatement = database.Query(get_tx_query, parameters);
+
+	return ReadTransactions(*pStatement, masterSeed);
+}
+
+std::vector<WalletTx> TransactionsTable::ReadTransactions(SqliteDB::Statement& statement, const SecureVector& masterSeed)
+{
+	const SecretKey key = WalletEncryptionUtil::CreateSecureKey(masterSeed, "WALLET_TX");
+
 	std::vector<WalletTx> transactions;
-	while (pStatement->Step())
+	while (statement.Step())
 	{
-		std::vector<uint8_t> encrypted = pStatement->GetColumnBytes(0);
-		SecureVector decrypted = WalletEncryptionUtil::Decrypt(masterSeed, "WALLET_TX", encrypted);
+		std::vector<uint8_t> encrypted = statement.GetColumnBytes(0);
+		SecureVector decrypted = WalletEncryptionUtil::Decrypt(key, encrypted);
 		std::vector<uint8_t> decryptedUnsafe(decrypted.data(), decrypted.data() + decrypted.size());
 
 		ByteBuffer byteBuffer(std::move(decryptedUnsafe));
@@ -2,9 +2,9 @@
 
 #include <Common/Secure.h>
 #include <Wallet/WalletTx.h>
+#include <Wallet/WalletDB/Models/WalletTxQuery.h>
 
-// Forward Declarations
-class SqliteDB;
+#include "../SqliteDB.h"
 
 class TransactionsTable
 {
@@ -14,5 +14,10 @@ public:
 
 	static void AddTransactions(SqliteDB& database, const SecureVector& masterSeed, const std::vector<WalletTx>& transactions);
 	static std::vector<WalletTx> GetTransactions(SqliteDB& database, const SecureVector& masterSeed);
+	static std::vector<WalletTx> GetTransactions(SqliteDB& database, const SecureVector& masterSeed, const WalletTxQuery& query);
 	static std::unique_ptr<WalletTx> GetTransactionById(SqliteDB& database, const SecureVector& masterSeed, const uint32_t walletTxId);
+
+private:
+	static void CreateIndexes(SqliteDB& database);
+	static std::vector<WalletTx> ReadTransactions(SqliteDB::Statement& statement, const SecureVector& masterSeed);
 };
\ No newline at end of file
@@ -9,7 +9,7 @@
 void VersionTable::CreateTable(SqliteDB& database)
 {
 	std::string table_creation_cmd = "create table version(schema_version INTEGER PRIMARY KEY);";
-	table_creation_cmd += "insert into version(schema_version) values (2)";
+	table_creation_cmd += StringUtil::Format("insert into version(schema_version) values ({})", LATEST_SCHEMA_VERSION);
 
 	database.Execute(table_creation_cmd);
 }
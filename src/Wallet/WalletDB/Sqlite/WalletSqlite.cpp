@@ -10,9 +10,12 @@
 
 #include <Wallet/WalletDB/WalletStoreException.h>
 #include <Wallet/Models/Slate/SlateStage.h>
+#include <Common/AllocProfiler.h>
 #include <Common/Util/FileUtil.h>
 #include <Common/Util/StringUtil.h>
 #include <Common/Logger.h>
+#include <algorithm>
+#include <unordered_set>
 
 static const uint8_t ENCRYPTION_FORMAT = 0;
 static const int LATEST_SCHEMA_VERSION = 1;
@@ -20,12 +23,30 @@ static const int LATEST_SCHEMA_VERSION = 1;
 void WalletSqlite::Commit()
 {
 	m_pTransaction->Commit();
+	m_outputCache.Commit();
+	m_transactionCache.Commit();
+
+	std::unique_lock<std::mutex> lock(m_coinIndexMutex);
+	m_coinIndex.Update(m_pendingCoins);
+	m_pendingCoins.clear();
+
 	SetDirty(false);
 }
 
 void WalletSqlite::Rollback() noexcept
 {
 	m_pTransaction->Rollback();
+	m_outputCache.Rollback();
+	m_transactionCache.Rollback();
+
+	// The index may have been loaded after this transaction's writes, so it can't be trusted to exclude them.
+	std::unique_lock<std::mutex> lock(m_coinIndexMutex);
+	if (!m_pendingCoins.empty())
+	{
+		m_coinIndex.Clear();
+		m_pendingCoins.clear();
+	}
+
 	SetDirty(false);
 }
 
@@ -67,46 +88,179 @@ KeyChainPath WalletSqlite::GetNextChildPath(const KeyChainPath& parentPath)
 
 std::unique_ptr<Slate> WalletSqlite::LoadSlate(const SecureVector& masterSeed, const uuids::uuid& slateId, const SlateStage& stage) const
 {
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
 	return SlateTable::LoadSlate(*m_pDatabase, masterSeed, slateId, stage);
 }
 
 void WalletSqlite::SaveSlate(const SecureVector& masterSeed, const Slate& slate)
 {
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
 	SlateTable::SaveSlate(*m_pDatabase, masterSeed, slate);
 }
 
+size_t WalletSqlite::MigrateSlates(const SecureVector& masterSeed, const size_t maxSlates)
+{
+	return SlateTable::MigrateSlates(*m_pDatabase, masterSeed, maxSlates);
+}
+
 std::unique_ptr<SlateContextEntity> WalletSqlite::LoadSlateContext(const SecureVector& masterSeed, const uuids::uuid& slateId) const
 {
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
 	return SlateContextTable::LoadSlateContext(*m_pDatabase, masterSeed, slateId);
 }
 
 void WalletSqlite::SaveSlateContext(const SecureVector& masterSeed, const uuids::uuid& slateId, const SlateContextEntity& slateContext)
 {
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
 	SlateContextTable::SaveSlateContext(*m_pDatabase, masterSeed, slateId, slateContext);
 }
 
 void WalletSqlite::AddOutputs(const SecureVector& masterSeed, const std::vector<OutputDataEntity>& outputs)
 {
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
 	OutputsTable::AddOutputs(*m_pDatabase, masterSeed, outputs);
+	m_outputCache.Put(outputs);
+	m_pendingCoins.insert(m_pendingCoins.end(), outputs.cbegin(), outputs.cend());
 }
 
 std::vector<OutputDataEntity> WalletSqlite::GetOutputs(const SecureVector& masterSeed) const
 {
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	if (m_outputCache.CanLoad())
+	{
+		m_outputCache.Load(OutputsTable::GetOutputs(*m_pDatabase, masterSeed));
+	}
+
+	if (m_outputCache.IsLoaded())
+	{
+		return m_outputCache.GetAll();
+	}
+
 	return OutputsTable::GetOutputs(*m_pDatabase, masterSeed);
 }
 
+std::vector<OutputDataEntity> WalletSqlite::GetUnspentOutputs(const SecureVector& masterSeed) const
+{
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	if (m_outputCache.IsLoaded())
+	{
+		std::vector<OutputDataEntity> outputs = m_outputCache.GetAll();
+		outputs.erase(
+			std::remove_if(
+				outputs.begin(), outputs.end(),
+				[](const OutputDataEntity& output) { return output.GetStatus() == EOutputStatus::SPENT; }
+			),
+			outputs.end()
+		);
+		return outputs;
+	}
+
+	// Not worth loading the whole table just for the unspent outputs.
+	return OutputsTable::GetUnspentOutputs(*m_pDatabase, masterSeed);
+}
+
+std::vector<OutputDataEntity> WalletSqlite::GetOutputs(const SecureVector& masterSeed, const std::vector<uint32_t>& walletTxIds) const
+{
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	if (m_outputCache.IsLoaded())
+	{
+		const std::unordered_set<uint32_t> ids(walletTxIds.cbegin(), walletTxIds.cend());
+
+		std::vector<OutputDataEntity> outputs = m_outputCache.GetAll();
+		outputs.erase(
+			std::remove_if(
+				outputs.begin(), outputs.end(),
+				[&ids](const OutputDataEntity& output) {
+					return !output.GetWalletTxId().has_value() || ids.count(output.GetWalletTxId().value()) == 0;
+				}
+			),
+			outputs.end()
+		);
+		return outputs;
+	}
+
+	return OutputsTable::GetOutputs(*m_pDatabase, masterSeed, walletTxIds);
+}
+
 void WalletSqlite::AddTransaction(const SecureVector& masterSeed, const WalletTx& walletTx)
 {
-	TransactionsTable::AddTransactions(*m_pDatabase, masterSeed, std::vector<WalletTx>({ walletTx }));
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	AddTransactions(masterSeed, std::vector<WalletTx>({ walletTx }));
+}
+
+void WalletSqlite::AddTransactions(const SecureVector& masterSeed, const std::vector<WalletTx>& walletTxs)
+{
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	TransactionsTable::AddTransactions(*m_pDatabase, masterSeed, walletTxs);
+	m_transactionCache.Put(walletTxs);
 }
 
 std::vector<WalletTx> WalletSqlite::GetTransactions(const SecureVector& masterSeed) const
 {
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	if (m_transactionCache.CanLoad())
+	{
+		m_transactionCache.Load(TransactionsTable::GetTransactions(*m_pDatabase, masterSeed));
+	}
+
+	if (m_transactionCache.IsLoaded())
+	{
+		return m_transactionCache.GetAll();
+	}
+
 	return TransactionsTable::GetTransactions(*m_pDatabase, masterSeed);
 }
 
+std::vector<WalletTx> WalletSqlite::GetTransactions(const SecureVector& masterSeed, const WalletTxQuery& query) const
+{
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	if (!m_transactionCache.IsLoaded())
+	{
+		// Paging through the table shouldn't decrypt all of it.
+		return TransactionsTable::GetTransactions(*m_pDatabase, masterSeed, query);
+	}
+
+	std::vector<WalletTx> matching;
+	uint64_t skipped = 0;
+	for (const WalletTx& walletTx : m_transactionCache.GetAll())
+	{
+		if (query.GetLimit().has_value() && matching.size() >= query.GetLimit().value()) {
+			break;
+		}
+
+		if (query.Matches(walletTx)) {
+			if (skipped < query.GetOffset()) {
+				++skipped;
+			} else {
+				matching.push_back(walletTx);
+			}
+		}
+	}
+
+	return matching;
+}
+
 std::unique_ptr<WalletTx> WalletSqlite::GetTransactionById(const SecureVector& masterSeed, const uint32_t walletTxId) const
 {
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	if (m_transactionCache.IsLoaded())
+	{
+		return m_transactionCache.Get(walletTxId);
+	}
+
 	return TransactionsTable::GetTransactionById(*m_pDatabase, masterSeed, walletTxId);
 }
 
@@ -149,6 +303,28 @@ void WalletSqlite::UpdateRestoreLeafIndex(const uint64_t lastLeafIndex)
 	SaveMetadata(UserMetadata(metadata.GetNextTxId(), metadata.GetRefreshBlockHeight(), lastLeafIndex));
 }
 
+const CoinIndex& WalletSqlite::GetCoinIndex(const SecureVector& masterSeed) const
+{
+	ScopedAllocTag allocTag(EAllocTag::WALLET_DB);
+
+	std::unique_lock<std::mutex> lock(m_coinIndexMutex);
+	if (!m_coinIndex.IsLoaded())
+	{
+		m_coinIndex.Load(GetOutputs(masterSeed));
+	}
+
+	return m_coinIndex;
+}
+
+void WalletSqlite::ClearCache()
+{
+	m_outputCache.Clear();
+	m_transactionCache.Clear();
+
+	std::unique_lock<std::mutex> lock(m_coinIndexMutex);
+	m_coinIndex.Clear();
+}
+
 UserMetadata WalletSqlite::GetMetadata() const
 {
 	return MetadataTable::GetMetadata(*m_pDatabase);
@@ -3,16 +3,23 @@
 #include "../UserMetadata.h"
 #include "SqliteTransaction.h"
 #include "SqliteDB.h"
+#include "RecordCache.h"
 
 #include <Wallet/WalletDB/WalletDB.h>
 #include <Wallet/WalletDB/Models/SlateContextEntity.h>
+#include <mutex>
 #include <unordered_map>
 
 class WalletSqlite : public IWalletDB
 {
 public:
 	explicit WalletSqlite(const fs::path& walletDirectory, const std::string& username, const SqliteDB::Ptr& pDatabase)
-		: m_walletDirectory(walletDirectory), m_username(username), m_pDatabase(pDatabase), m_pTransaction(nullptr) { }
+		: m_walletDirectory(walletDirectory),
+		m_username(username),
+		m_pDatabase(pDatabase),
+		m_pTransaction(nullptr),
+		m_outputCache([](const OutputDataEntity& output) { return output.GetOutput().GetCommitment(); }),
+		m_transactionCache([](const WalletTx& walletTx) { return walletTx.GetId(); }) { }
 	virtual ~WalletSqlite() = default;
 
 	void Commit() final;
@@ -32,6 +39,7 @@ public:
 		const SecureVector& masterSeed,
 		const Slate& slate
 	) final;
+	size_t MigrateSlates(const SecureVector& masterSeed, const size_t maxSlates) final;
 
 	std::unique_ptr<SlateContextEntity> LoadSlateContext(
 		const SecureVector& masterSeed,
@@ -45,9 +53,14 @@ public:
 
 	void AddOutputs(const SecureVector& masterSeed, const std::vector<OutputDataEntity>& outputs) final;
 	std::vector<OutputDataEntity> GetOutputs(const SecureVector& masterSeed) const final;
+	std::vector<OutputDataEntity> GetUnspentOutputs(const SecureVector& masterSeed) const final;
+	std::vector<OutputDataEntity> GetOutputs(const SecureVector& masterSeed, const std::vector<uint32_t>& walletTxIds) const final;
+	const CoinIndex& GetCoinIndex(const SecureVector& masterSeed) const final;
 
 	void AddTransaction(const SecureVector& masterSeed, const WalletTx& walletTx) final;
+	void AddTransactions(const SecureVector& masterSeed, const std::vector<WalletTx>& walletTxs) final;
 	std::vector<WalletTx> GetTransactions(const SecureVector& masterSeed) const final;
+	std::vector<WalletTx> GetTransactions(const SecureVector& masterSeed, const WalletTxQuery& query) const final;
 	std::unique_ptr<WalletTx> GetTransactionById(const SecureVector& masterSeed, const uint32_t walletTxId) const final;
 
 	uint32_t GetNextTransactionId() final;
@@ -56,6 +69,8 @@ public:
 	uint64_t GetRestoreLeafIndex() const final;
 	void UpdateRestoreLeafIndex(const uint64_t lastLeafIndex) final;
 
+	void ClearCache() final;
+
 private:
 	UserMetadata GetMetadata() const;
 	void SaveMetadata(const UserMetadata& userMetadata);
@@ -64,4 +79,15 @@ private:
 	std::string m_username;
 	SqliteDB::Ptr m_pDatabase;
 	std::unique_ptr<SqliteTransaction> m_pTransaction;
+
+	// Decrypted outputs and transactions, loaded on first read.
+	// Kept until the wallet's sessions log out, so repeated reads skip sqlite and AES.
+	mutable RecordCache<Commitment, OutputDataEntity> m_outputCache;
+	mutable RecordCache<uint32_t, WalletTx> m_transactionCache;
+
+	// Only changed on commit (under the write lock) or when first loaded, which the mutex guards,
+	// since concurrent readers can load it.
+	mutable std::mutex m_coinIndexMutex;
+	mutable CoinIndex m_coinIndex;
+	std::vector<OutputDataEntity> m_pendingCoins;
 };
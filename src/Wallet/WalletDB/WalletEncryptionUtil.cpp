@@ -10,10 +10,14 @@ std::vector<uint8_t> WalletEncryptionUtil::Encrypt(
 	const SecureVector& masterSeed,
 	const std::string& dataType,
 	const SecureVector& bytes)
+{
+	return Encrypt(WalletEncryptionUtil::CreateSecureKey(masterSeed, dataType), bytes);
+}
+
+std::vector<uint8_t> WalletEncryptionUtil::Encrypt(const SecretKey& key, const SecureVector& bytes)
 {
 	const SecureVector randomNumber = CSPRNG::GenerateRandomBytes(16);
 	const CBigInteger<16> iv = CBigInteger<16>(randomNumber.data());
-	const SecretKey key = WalletEncryptionUtil::CreateSecureKey(masterSeed, dataType);
 
 	const std::vector<uint8_t> encryptedBytes = AES256::Encrypt(bytes, key, iv);
 
@@ -28,6 +32,11 @@ SecureVector WalletEncryptionUtil::Decrypt(
 	const SecureVector& masterSeed,
 	const std::string& dataType,
 	const std::vector<uint8_t>& encrypted)
+{
+	return Decrypt(WalletEncryptionUtil::CreateSecureKey(masterSeed, dataType), encrypted);
+}
+
+SecureVector WalletEncryptionUtil::Decrypt(const SecretKey& key, const std::vector<uint8_t>& encrypted)
 {
 	ByteBuffer byteBuffer(encrypted);
 
@@ -43,7 +52,6 @@ SecureVector WalletEncryptionUtil::Decrypt(
 	const CBigInteger<16> iv = byteBuffer.ReadBigInteger<16>();
 	const std::vector<uint8_t> encryptedBytes =
 		byteBuffer.ReadVector(byteBuffer.GetRemainingSize());
-	const SecretKey key = WalletEncryptionUtil::CreateSecureKey(masterSeed, dataType);
 
 	return AES256::Decrypt(encryptedBytes, key, iv);
 }
@@ -20,6 +20,12 @@ public:
 		const std::vector<uint8_t>& encrypted
 	);
 
-private:
+	//
+	// Derives the key used to encrypt records of the given type.
+	// Callers encrypting or decrypting many records should derive it once and use the overloads below.
+	//
 	static SecretKey CreateSecureKey(const SecureVector& masterSeed, const std::string& dataType);
+
+	static std::vector<uint8_t> Encrypt(const SecretKey& key, const SecureVector& bytes);
+	static SecureVector Decrypt(const SecretKey& key, const std::vector<uint8_t>& encrypted);
 };
\ No newline at end of file
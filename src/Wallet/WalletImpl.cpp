@@ -23,7 +23,9 @@ WalletImpl::WalletImpl(
 	m_walletDB(walletDB),
 	m_username(username),
 	m_userPath(std::move(userPath)),
-	m_address(address)
+	m_address(address),
+	m_pRestoreProgress(std::make_shared<RestoreProgress>()),
+	m_pReservations(std::make_shared<OutputReservations>())
 {
 
 }
@@ -44,7 +46,7 @@ Locked<WalletImpl> WalletImpl::LoadWallet(
 	}));
 }
 
-WalletSummaryDTO WalletImpl::GetWalletSummary(const SecureVector& masterSeed)
+WalletSummaryDTO WalletImpl::GetWalletSummary(const SecureVector& masterSeed) const
 {
 	WalletBalanceDTO balance = GetBalance(masterSeed);
 	
@@ -56,7 +58,7 @@ WalletSummaryDTO WalletImpl::GetWalletSummary(const SecureVector& masterSeed)
 	);
 }
 
-WalletBalanceDTO WalletImpl::GetBalance(const SecureVector& masterSeed)
+WalletBalanceDTO WalletImpl::GetBalance(const SecureVector& masterSeed) const
 {
 	uint64_t awaitingConfirmation = 0;
 	uint64_t immature = 0;
@@ -95,28 +97,9 @@ WalletBalanceDTO WalletImpl::GetBalance(const SecureVector& masterSeed)
 	);
 }
 
-std::vector<OutputDataEntity> WalletImpl::RefreshOutputs(const SecureVector& masterSeed, const bool fromGenesis)
+std::vector<OutputDataEntity> WalletImpl::RefreshOutputs(const SecureVector& masterSeed, const bool fromGenesis) const
 {
-	return WalletRefresher(m_config, m_pNodeClient).Refresh(masterSeed, m_walletDB, fromGenesis);
-}
-
-std::vector<OutputDataEntity> WalletImpl::GetAllAvailableCoins(const SecureVector& masterSeed)
-{
-	const KeyChain keyChain = KeyChain::FromSeed(m_config, masterSeed);
-
-	std::vector<OutputDataEntity> coins;
-
-	std::vector<Commitment> commitments;
-	const std::vector<OutputDataEntity> outputs = RefreshOutputs(masterSeed, false);
-	for (const OutputDataEntity& output : outputs)
-	{
-		if (output.GetStatus() == EOutputStatus::SPENDABLE)
-		{
-			coins.emplace_back(output);
-		}
-	}
-
-	return coins;
+	return WalletRefresher(m_config, m_pNodeClient, m_pRestoreProgress).Refresh(masterSeed, m_walletDB, fromGenesis);
 }
 
 OutputDataEntity WalletImpl::CreateBlindedOutput(
@@ -124,7 +107,7 @@ OutputDataEntity WalletImpl::CreateBlindedOutput(
 	const uint64_t amount,
 	const KeyChainPath& keyChainPath,
 	const uint32_t walletTxId,
-	const EBulletproofType& bulletproofType)
+	const EBulletproofType& bulletproofType) const
 {
 	const KeyChain keyChain = KeyChain::FromSeed(m_config, masterSeed);
 
@@ -18,6 +18,8 @@
 #include <Crypto/SecretKey.h>
 #include <Crypto/BulletproofType.h>
 #include <API/Wallet/Foreign/Models/BuildCoinbaseResponse.h>
+#include "RestoreProgress.h"
+#include "OutputReservations.h"
 #include <string>
 
 // Forward Declarations
@@ -47,22 +49,31 @@ public:
 	void SetListenerPort(const uint16_t port) { m_listenerPort = port; }
 	uint16_t GetListenerPort() const { return m_listenerPort; }
 
-	WalletSummaryDTO GetWalletSummary(const SecureVector& masterSeed);
-	WalletBalanceDTO GetBalance(const SecureVector& masterSeed);
+	WalletSummaryDTO GetWalletSummary(const SecureVector& masterSeed) const;
+	WalletBalanceDTO GetBalance(const SecureVector& masterSeed) const;
 
 	std::unique_ptr<WalletTx> GetTxById(const SecureVector& masterSeed, const uint32_t walletTxId) const;
 	std::unique_ptr<WalletTx> GetTxBySlateId(const SecureVector& masterSeed, const uuids::uuid& slateId) const;
 
-	std::vector<OutputDataEntity> RefreshOutputs(const SecureVector& masterSeed, const bool fromGenesis);
+	//
+	// Only locks the wallet database while reading and writing it, not while waiting on the node,
+	// so it can be called with a read lock on this wallet.
+	//
+	std::vector<OutputDataEntity> RefreshOutputs(const SecureVector& masterSeed, const bool fromGenesis) const;
+
+	// Updated while RefreshOutputs scans for outputs, so it can be read without this wallet's lock.
+	const RestoreProgress::Ptr& GetRestoreProgress() const noexcept { return m_pRestoreProgress; }
+
+	// The outputs selected by sends in progress, so concurrent sends holding read locks on this wallet don't select the same ones.
+	const OutputReservations::Ptr& GetReservations() const noexcept { return m_pReservations; }
 
-	std::vector<OutputDataEntity> GetAllAvailableCoins(const SecureVector& masterSeed);
 	OutputDataEntity CreateBlindedOutput(
 		const SecureVector& masterSeed,
 		const uint64_t amount,
 		const KeyChainPath& keyChainPath,
 		const uint32_t walletTxId,
 		const EBulletproofType& bulletproofType
-	);
+	) const;
 
 	BuildCoinbaseResponse CreateCoinbase(
 		const SecureVector& masterSeed,
@@ -88,4 +99,6 @@ private:
 	SlatepackAddress m_address;
 	std::optional<TorAddress> m_torAddressOpt;
 	uint16_t m_listenerPort;
+	RestoreProgress::Ptr m_pRestoreProgress;
+	OutputReservations::Ptr m_pReservations;
 };
\ No newline at end of file
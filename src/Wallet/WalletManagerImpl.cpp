@@ -1,6 +1,5 @@
 #include "WalletManagerImpl.h"
 #include "CancelTx.h"
-#include "Keychain/SeedEncrypter.h"
 #include "Keychain/Mnemonic.h"
 #include "SlateBuilder/ReceiveSlateBuilder.h"
 #include "SlateBuilder/SendSlateBuilder.h"
@@ -25,7 +24,8 @@ WalletManager::WalletManager(const Config& config, INodeClientPtr pNodeClient, s
 	: m_config(config),
 	m_pNodeClient(pNodeClient),
 	m_pWalletStore(pWalletStore),
-	m_sessionManager(SessionManager::Create(config, pNodeClient, pWalletStore, *this))
+	m_pSeedUnlocker(SeedUnlocker::Create(config, pWalletStore)),
+	m_pSessionManager(SessionManager::Create(config, pNodeClient, pWalletStore, m_pSeedUnlocker, *this))
 {
 
 }
@@ -37,10 +37,10 @@ WalletManager::~WalletManager()
 
 Locked<Wallet> WalletManager::GetWallet(const SessionToken& token)
 {
-	SecureVector masterSeed = m_sessionManager.Read()->GetSeed(token);
-	m_sessionManager.Read()->GetWalletImpl(token).Write()->RefreshOutputs(masterSeed, false);
+	SecureVector masterSeed = m_pSessionManager->GetSeed(token);
+	m_pSessionManager->GetWalletImpl(token).Read()->RefreshOutputs(masterSeed, false);
 
-	return m_sessionManager.Read()->GetWallet(token);
+	return m_pSessionManager->GetWallet(token);
 }
 
 CreateWalletResponse WalletManager::InitializeNewWallet(
@@ -55,20 +55,21 @@ CreateWalletResponse WalletManager::InitializeNewWallet(
 
 	const size_t entropyBytes = (4 * criteria.GetNumWords()) / 3;
 	const SecureVector walletSeed = CSPRNG::GenerateRandomBytes(entropyBytes);
-	const EncryptedSeed encryptedSeed = SeedEncrypter().EncryptWalletSeed(walletSeed, criteria.GetPassword());
+	const EncryptedSeed encryptedSeed = m_pSeedUnlocker->Encrypt(walletSeed, criteria.GetPassword());
 	SecureString walletWords = Mnemonic::CreateMnemonic(walletSeed.data(), walletSeed.size());
 
 	m_pWalletStore->CreateWallet(criteria.GetUsername(), encryptedSeed);
 
 	WALLET_INFO_F("Wallet created with username: {}", criteria.GetUsername());
 
-	SessionToken token = m_sessionManager.Write()->Login(
+	SessionToken token = m_pSessionManager->Login(
 		pTorProcess,
 		criteria.GetUsername(),
 		walletSeed
 	);
+	m_pSeedUnlocker->Remember(criteria.GetUsername(), walletSeed, criteria.GetPassword());
 
-	auto pWallet = m_sessionManager.Read()->GetWallet(token).Read();
+	auto pWallet = m_pSessionManager->GetWallet(token).Read();
 	return CreateWalletResponse(
 		token,
 		pWallet->GetListenerPort(),
@@ -87,14 +88,15 @@ LoginResponse WalletManager::RestoreFromSeed(
 	{
 		SecureVector entropy = Mnemonic::ToEntropy(criteria.GetSeedWords());
 
-		const EncryptedSeed encryptedSeed = SeedEncrypter().EncryptWalletSeed(entropy, criteria.GetPassword());
+		const EncryptedSeed encryptedSeed = m_pSeedUnlocker->Encrypt(entropy, criteria.GetPassword());
 
 		m_pWalletStore->CreateWallet(criteria.GetUsername(), encryptedSeed);
 
 		WALLET_INFO_F("Wallet restored for username: {}", criteria.GetUsername());
-		SessionToken token = m_sessionManager.Write()->Login(pTorProcess, criteria.GetUsername(), entropy);
+		SessionToken token = m_pSessionManager->Login(pTorProcess, criteria.GetUsername(), entropy);
+		m_pSeedUnlocker->Remember(criteria.GetUsername(), entropy, criteria.GetPassword());
 
-		auto pWallet = m_sessionManager.Read()->GetWallet(token).Read();
+		auto pWallet = m_pSessionManager->GetWallet(token).Read();
 		return LoginResponse(
 			token,
 			pWallet->GetListenerPort(),
@@ -111,7 +113,7 @@ LoginResponse WalletManager::RestoreFromSeed(
 
 SecureString WalletManager::GetSeedWords(const GetSeedPhraseCriteria& criteria)
 {
-	const SecureVector masterSeed = m_sessionManager.Read()->GetSeed(
+	const SecureVector masterSeed = m_pSeedUnlocker->Unlock(
 		criteria.GetUsername(),
 		criteria.GetPassword()
 	);
@@ -122,10 +124,10 @@ void WalletManager::CheckForOutputs(const SessionToken& token, const bool fromGe
 {
 	try
 	{
-		const SecureVector masterSeed = m_sessionManager.Read()->GetSeed(token);
-		Locked<WalletImpl> wallet = m_sessionManager.Read()->GetWalletImpl(token);
+		const SecureVector masterSeed = m_pSessionManager->GetSeed(token);
+		Locked<WalletImpl> wallet = m_pSessionManager->GetWalletImpl(token);
 
-		wallet.Write()->RefreshOutputs(masterSeed, fromGenesis);
+		wallet.Read()->RefreshOutputs(masterSeed, fromGenesis);
 	}
 	catch(const std::exception& e)
 	{
@@ -134,15 +136,32 @@ void WalletManager::CheckForOutputs(const SessionToken& token, const bool fromGe
 	}
 }
 
+RestoreProgressDTO WalletManager::GetRestoreProgress(const SessionToken& token) const
+{
+	return m_pSessionManager->GetRestoreProgress(token)->ToDTO();
+}
+
 std::optional<TorAddress> WalletManager::AddTorListener(const SessionToken& token, const KeyChainPath& path, const TorProcess::Ptr& pTorProcess)
 {
-	Locked<Wallet> wallet = m_sessionManager.Read()->GetWallet(token);
-	Locked<WalletImpl> walletImpl = m_sessionManager.Read()->GetWalletImpl(token);
+	Locked<Wallet> wallet = m_pSessionManager->GetWallet(token);
+	Locked<WalletImpl> walletImpl = m_pSessionManager->GetWalletImpl(token);
+
+	// Re-adding the wallet's existing listener only needs the key cached by the TorProcess.
+	std::shared_ptr<TorAddress> pTorAddress = nullptr;
+	const std::optional<TorAddress> existingAddress = wallet.Read()->GetTorAddress();
+	if (existingAddress.has_value())
+	{
+		pTorAddress = pTorProcess->AddListener(existingAddress.value(), wallet.Read()->GetListenerPort());
+	}
 
-	KeyChain keyChain = KeyChain::FromSeed(m_config, m_sessionManager.Read()->GetSeed(token));
-	ed25519_keypair_t torKey = keyChain.DeriveED25519Key(path);
+	if (pTorAddress == nullptr)
+	{
+		KeyChain keyChain = KeyChain::FromSeed(m_config, m_pSessionManager->GetSeed(token));
+		ed25519_keypair_t torKey = keyChain.DeriveED25519Key(path);
+
+		pTorAddress = pTorProcess->AddListener(torKey.secret_key, wallet.Read()->GetListenerPort());
+	}
 
-	std::shared_ptr<TorAddress> pTorAddress = pTorProcess->AddListener(torKey.secret_key, wallet.Read()->GetListenerPort());
 	if (pTorAddress != nullptr)
 	{
 		wallet.Write()->SetTorAddress(*pTorAddress);
@@ -165,16 +184,21 @@ LoginResponse WalletManager::Login(
 
 	try
 	{
-		SessionToken token = m_sessionManager.Write()->Login(
+		// The KDF runs before taking the session manager's lock, so other sessions aren't blocked on it.
+		const SecureVector seed = m_pSeedUnlocker->Unlock(criteria.GetUsername(), criteria.GetPassword());
+		WALLET_INFO("Valid password provided. Logging in now.");
+
+		SessionToken token = m_pSessionManager->Login(
 			pTorProcess,
 			criteria.GetUsername(),
-			criteria.GetPassword()
+			seed
 		);
+		m_pSeedUnlocker->Remember(criteria.GetUsername(), seed, criteria.GetPassword());
 
 		WALLET_INFO_F("Login successful for username: {}", criteria.GetUsername());
 		CheckForOutputs(token, false);
 
-		auto pWallet = m_sessionManager.Read()->GetWallet(token).Read();
+		auto pWallet = m_pSessionManager->GetWallet(token).Read();
 		return LoginResponse(
 			token,
 			pWallet->GetListenerPort(),
@@ -191,7 +215,7 @@ LoginResponse WalletManager::Login(
 
 void WalletManager::Logout(const SessionToken& token)
 {
-	m_sessionManager.Write()->Logout(token);
+	m_pSessionManager->Logout(token);
 }
 
 void WalletManager::DeleteWallet(const GrinStr& username, const SecureString& password)
@@ -201,9 +225,10 @@ void WalletManager::DeleteWallet(const GrinStr& username, const SecureString& pa
 	try
 	{
 		GrinStr usernameLower = username.ToLower();
-		m_sessionManager.Read()->Authenticate(usernameLower, password);
+		m_pSeedUnlocker->Unlock(usernameLower, password);
 
 		m_pWalletStore->DeleteWallet(usernameLower);
+		m_pSeedUnlocker->Forget(usernameLower);
 	}
 	catch (std::exception& e)
 	{
@@ -218,18 +243,20 @@ void WalletManager::ChangePassword(
 	const SecureString& newPassword)
 {
 	GrinStr usernameLower = username.ToLower();
-	EncryptedSeed encrypted = m_pWalletStore->LoadWalletSeed(usernameLower);
-	SecureVector walletSeed = SeedEncrypter().DecryptWalletSeed(encrypted, currentPassword);
+	SecureVector walletSeed = m_pSeedUnlocker->Unlock(usernameLower, currentPassword);
 
 	// Valid password - Re-encrypt seed
-	EncryptedSeed newSeed = SeedEncrypter().EncryptWalletSeed(walletSeed, newPassword);
+	EncryptedSeed newSeed = m_pSeedUnlocker->Encrypt(walletSeed, newPassword);
 	m_pWalletStore->ChangePassword(usernameLower, newSeed);
+
+	// The current password must no longer unlock it.
+	m_pSeedUnlocker->Forget(usernameLower);
 }
 
 Slate WalletManager::Send(const SendCriteria& sendCriteria)
 {
-	const SecureVector masterSeed = m_sessionManager.Read()->GetSeed(sendCriteria.GetToken());
-	Locked<WalletImpl> wallet = m_sessionManager.Read()->GetWalletImpl(sendCriteria.GetToken());
+	const SecureVector masterSeed = m_pSessionManager->GetSeed(sendCriteria.GetToken());
+	Locked<WalletImpl> wallet = m_pSessionManager->GetWalletImpl(sendCriteria.GetToken());
 
 	return SendSlateBuilder(m_config, m_pNodeClient).BuildSendSlate(
 		wallet,
@@ -244,10 +271,18 @@ Slate WalletManager::Send(const SendCriteria& sendCriteria)
 	);
 }
 
+std::vector<Slate> WalletManager::SendMany(const SessionToken& token, const std::vector<SendCriteria>& sends)
+{
+	const SecureVector masterSeed = m_pSessionManager->GetSeed(token);
+	Locked<WalletImpl> wallet = m_pSessionManager->GetWalletImpl(token);
+
+	return SendSlateBuilder(m_config, m_pNodeClient).BuildSendSlates(wallet, masterSeed, sends);
+}
+
 Slate WalletManager::Receive(const ReceiveCriteria& receiveCriteria)
 {
-	const SecureVector masterSeed = m_sessionManager.Read()->GetSeed(receiveCriteria.GetToken());
-	Locked<WalletImpl> wallet = m_sessionManager.Read()->GetWalletImpl(receiveCriteria.GetToken());
+	const SecureVector masterSeed = m_pSessionManager->GetSeed(receiveCriteria.GetToken());
+	Locked<WalletImpl> wallet = m_pSessionManager->GetWalletImpl(receiveCriteria.GetToken());
 
 	return ReceiveSlateBuilder(m_config).AddReceiverData(
 		wallet,
@@ -259,8 +294,8 @@ Slate WalletManager::Receive(const ReceiveCriteria& receiveCriteria)
 
 Slate WalletManager::Finalize(const FinalizeCriteria& finalizeCriteria, const TorProcess::Ptr& pTorProcess)
 {
-	const SecureVector masterSeed = m_sessionManager.Read()->GetSeed(finalizeCriteria.GetToken());
-	Locked<Wallet> wallet = m_sessionManager.Read()->GetWallet(finalizeCriteria.GetToken());
+	const SecureVector masterSeed = m_pSessionManager->GetSeed(finalizeCriteria.GetToken());
+	Locked<Wallet> wallet = m_pSessionManager->GetWallet(finalizeCriteria.GetToken());
 
 	auto finalized = FinalizeSlateBuilder(wallet.Write().GetShared()).Finalize(
 		finalizeCriteria.GetSlate()
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "SessionManager.h"
+#include "SeedUnlocker.h"
 
 #include <Wallet/WalletManager.h>
 #include <Wallet/NodeClient.h>
@@ -27,6 +28,7 @@ public:
 
 	SecureString GetSeedWords(const GetSeedPhraseCriteria& criteria) final;
 	void CheckForOutputs(const SessionToken& token, const bool fromGenesis) final;
+	RestoreProgressDTO GetRestoreProgress(const SessionToken& token) const final;
 
 	std::optional<TorAddress> AddTorListener(
 		const SessionToken& token,
@@ -49,6 +51,7 @@ public:
 	std::vector<GrinStr> GetAllAccounts() const final;
 
 	Slate Send(const SendCriteria& sendCriteria) final;
+	std::vector<Slate> SendMany(const SessionToken& token, const std::vector<SendCriteria>& sends) final;
 	Slate Receive(const ReceiveCriteria& receiveCriteria) final;
 	Slate Finalize(const FinalizeCriteria& finalizeCriteria, const TorProcess::Ptr& pTorProcess) final;
 
@@ -66,5 +69,6 @@ private:
 	const Config& m_config;
 	INodeClientPtr m_pNodeClient;
 	std::shared_ptr<IWalletStore> m_pWalletStore;
-	Locked<SessionManager> m_sessionManager;
+	SeedUnlocker::Ptr m_pSeedUnlocker;
+	SessionManager::Ptr m_pSessionManager;
 };
\ No newline at end of file
@@ -6,48 +6,218 @@
 #include <Wallet/WalletUtil.h>
 #include <Wallet/NodeClient.h>
 #include <Wallet/WalletDB/WalletDB.h>
+#include <algorithm>
+#include <set>
 #include <unordered_map>
 
-// TODO: Rewrite this && use cache - Shouldn't refresh when block height = same
-// 0. Initial login after upgrade - for every output, find matching WalletTx and update OutputDataEntity TxId. If none found, create new WalletTx.
-//
+// 0. Skip the refresh if no blocks were added since the last one.
 // 1. Check for own outputs in new blocks.
 // 2. For each output, look for OutputDataEntity with matching commitment. If no output found, create new WalletTx and OutputDataEntity.
-// 3. Refresh status for all OutputDataEntity by calling m_pNodeClient->GetOutputsByCommitment
-// 4. For all OutputDataEntity, update matching WalletTx status.
+// 3. Refresh status for all unspent OutputDataEntity by calling m_pNodeClient->GetOutputsByCommitment
+// 4. For each OutputDataEntity whose status changed, update matching WalletTx status.
+//
+// Spent outputs are only rechecked when refreshing fromGenesis, so their rows aren't loaded or decrypted on every refresh.
 
 std::vector<OutputDataEntity> WalletRefresher::Refresh(const SecureVector& masterSeed, Locked<IWalletDB> walletDB, const bool fromGenesis)
 {
-	auto pBatch = walletDB.BatchWrite();
+	// The wallet database is only read before asking the node for anything, and only written after,
+	// so other calls into the wallet aren't blocked while the node responds.
+	const uint64_t chainHeight = m_pNodeClient->GetChainHeight();
 
-	if (m_pNodeClient->GetChainHeight() < pBatch->GetRefreshBlockHeight())
+	std::vector<OutputDataEntity> walletOutputs;
+	uint64_t restoreLeafIndex = 0;
 	{
-		WALLET_TRACE("Skipping refresh since node is resyncing.");
-		return std::vector<OutputDataEntity>();
-	}
+		auto pReader = walletDB.Read();
+		const uint64_t refreshHeight = pReader->GetRefreshBlockHeight();
+		if (chainHeight < refreshHeight)
+		{
+			WALLET_TRACE("Skipping refresh since node is resyncing.");
+			return std::vector<OutputDataEntity>();
+		}
 
-	std::vector<OutputDataEntity> walletOutputs = pBatch->GetOutputs(masterSeed);
-	std::vector<WalletTx> walletTransactions = pBatch->GetTransactions(masterSeed);
+		// 0. Output statuses only change when blocks are added, so there's nothing to refresh.
+		if (!fromGenesis && chainHeight == refreshHeight)
+		{
+			WALLET_TRACE_F("Skipping refresh since chain height is unchanged at {}.", chainHeight);
+			return pReader->GetUnspentOutputs(masterSeed);
+		}
+
+		walletOutputs = fromGenesis ? pReader->GetOutputs(masterSeed) : pReader->GetUnspentOutputs(masterSeed);
+		restoreLeafIndex = pReader->GetRestoreLeafIndex();
+	}
 
 	// 1. Check for own outputs in new blocks.
 	KeyChain keyChain = KeyChain::FromSeed(m_config, masterSeed);
-	OutputRestorer restorer(m_config, m_pNodeClient, keyChain);
-	std::vector<OutputDataEntity> restoredOutputs = restorer.FindAndRewindOutputs(pBatch.GetShared(), fromGenesis);
+	OutputRestorer restorer(m_config, m_pNodeClient, keyChain, m_pProgress);
+	auto checkpoint = [this, &masterSeed, &walletDB, fromGenesis](std::vector<OutputDataEntity>& found, const uint64_t lastScannedIndex) {
+		Checkpoint(masterSeed, walletDB, found, lastScannedIndex, fromGenesis);
+	};
+	std::vector<OutputDataEntity> restoredOutputs = restorer.FindAndRewindOutputs(restoreLeafIndex, fromGenesis, checkpoint);
+
+	return Update(masterSeed, walletDB, std::move(walletOutputs), restoredOutputs, restoreLeafIndex, fromGenesis);
+}
+
+std::vector<OutputDataEntity> WalletRefresher::ApplyScan(
+	const SecureVector& masterSeed,
+	Locked<IWalletDB> walletDB,
+	std::vector<OutputDataEntity>&& restoredOutputs,
+	const uint64_t restoreLeafIndex)
+{
+	std::vector<OutputDataEntity> walletOutputs = walletDB.Read()->GetUnspentOutputs(masterSeed);
+	return Update(masterSeed, walletDB, std::move(walletOutputs), restoredOutputs, restoreLeafIndex, false);
+}
+
+void WalletRefresher::Checkpoint(
+	const SecureVector& masterSeed,
+	Locked<IWalletDB> walletDB,
+	std::vector<OutputDataEntity>& restoredOutputs,
+	const uint64_t restoreLeafIndex,
+	const bool fromGenesis)
+{
+	// Block times are looked up before the database is locked, so outputs the wallet already has may be looked up needlessly.
+	std::vector<std::optional<std::chrono::system_clock::time_point>> blockTimes(restoredOutputs.size());
+	for (size_t i = 0; i < restoredOutputs.size(); i++)
+	{
+		if (restoredOutputs[i].GetStatus() != EOutputStatus::SPENT)
+		{
+			blockTimes[i] = GetBlockTime(restoredOutputs[i]);
+		}
+	}
+
+	auto pBatch = walletDB.BatchWrite();
+
+	// Spent outputs are loaded too, since a restored output could match one of them.
+	std::vector<OutputDataEntity> walletOutputs = pBatch->GetOutputs(masterSeed);
+	const std::vector<OutputDataEntity> addedOutputs = AddRestoredOutputs(masterSeed, pBatch, restoredOutputs, blockTimes, walletOutputs, {});
+
+	// The refresh height is left alone, since the statuses of the wallet's other outputs haven't been refreshed.
+	if (fromGenesis || restoreLeafIndex > pBatch->GetRestoreLeafIndex())
+	{
+		pBatch->UpdateRestoreLeafIndex(restoreLeafIndex);
+	}
+
+	pBatch->Commit();
+	WALLET_INFO_F("Restore checkpointed at leaf index {} with {} new outputs", restoreLeafIndex, addedOutputs.size());
+}
+
+std::vector<OutputDataEntity> WalletRefresher::Update(
+	const SecureVector& masterSeed,
+	Locked<IWalletDB> walletDB,
+	std::vector<OutputDataEntity>&& walletOutputs,
+	std::vector<OutputDataEntity>& restoredOutputs,
+	const uint64_t restoreLeafIndex,
+	const bool fromGenesis)
+{
+	// Look up everything else needed from the node: the block times of restored outputs the wallet may not know about,
+	// and the locations of every unspent output.
+	std::vector<Commitment> commitments;
+	for (const OutputDataEntity& outputData : walletOutputs)
+	{
+		// TODO: What if commitment has mmr_index?
+		commitments.push_back(outputData.GetOutput().GetCommitment());
+	}
+
+	std::vector<std::optional<std::chrono::system_clock::time_point>> blockTimes(restoredOutputs.size());
+	for (size_t i = 0; i < restoredOutputs.size(); i++)
+	{
+		const Commitment& commitment = restoredOutputs[i].GetOutput().GetCommitment();
+		if (restoredOutputs[i].GetStatus() != EOutputStatus::SPENT && FindOutput(walletOutputs, commitment) == nullptr)
+		{
+			blockTimes[i] = GetBlockTime(restoredOutputs[i]);
+			commitments.push_back(commitment);
+		}
+	}
+
+	const uint64_t lastConfirmedHeight = m_pNodeClient->GetChainHeight();
+	const std::map<Commitment, OutputLocation> outputLocations = m_pNodeClient->GetOutputsByCommitment(commitments);
+	const std::set<Commitment> refreshedCommitments(commitments.cbegin(), commitments.cend());
+
+	auto pBatch = walletDB.BatchWrite();
+
+	// The outputs are reloaded, since they could've changed (eg. been locked by a send) while the node was queried.
+	walletOutputs = fromGenesis ? pBatch->GetOutputs(masterSeed) : pBatch->GetUnspentOutputs(masterSeed);
+
+	// Restored outputs could match an output that's already marked as spent, so those need to be checked too.
+	std::vector<OutputDataEntity> spentOutputs;
+	if (!fromGenesis && !restoredOutputs.empty())
+	{
+		for (OutputDataEntity& output : pBatch->GetOutputs(masterSeed))
+		{
+			if (output.GetStatus() == EOutputStatus::SPENT)
+			{
+				spentOutputs.emplace_back(std::move(output));
+			}
+		}
+	}
 
 	// 2. For each restored output, look for OutputDataEntity with matching commitment.
-	for (OutputDataEntity& restoredOutput : restoredOutputs)
+	std::vector<OutputDataEntity> addedOutputs = AddRestoredOutputs(masterSeed, pBatch, restoredOutputs, blockTimes, walletOutputs, spentOutputs);
+
+	// 3. Refresh status for all unspent OutputDataEntity using the locations returned by m_pNodeClient->GetOutputsByCommitment
+	std::vector<OutputDataEntity> changedOutputs = RefreshOutputs(
+		masterSeed,
+		pBatch,
+		walletOutputs,
+		refreshedCommitments,
+		outputLocations,
+		lastConfirmedHeight
+	);
+	changedOutputs.insert(changedOutputs.end(), addedOutputs.begin(), addedOutputs.end());
+
+	// 4. For each OutputDataEntity whose status changed, update matching WalletTx status.
+	if (!changedOutputs.empty())
+	{
+		std::vector<WalletTx> walletTransactions = pBatch->GetTransactions(masterSeed);
+		RefreshTransactions(masterSeed, pBatch, changedOutputs, walletTransactions);
+	}
+
+	// A refresh that finished while this one waited on the node may have already scanned further.
+	if (fromGenesis || restoreLeafIndex > pBatch->GetRestoreLeafIndex())
+	{
+		pBatch->UpdateRestoreLeafIndex(restoreLeafIndex);
+	}
+
+	pBatch->Commit();
+
+	walletOutputs.erase(
+		std::remove_if(
+			walletOutputs.begin(), walletOutputs.end(),
+			[](const OutputDataEntity& output) { return output.GetStatus() == EOutputStatus::SPENT; }
+		),
+		walletOutputs.end()
+	);
+	return walletOutputs;
+}
+
+std::vector<OutputDataEntity> WalletRefresher::AddRestoredOutputs(
+	const SecureVector& masterSeed,
+	Writer<IWalletDB> pBatch,
+	std::vector<OutputDataEntity>& restoredOutputs,
+	const std::vector<std::optional<std::chrono::system_clock::time_point>>& blockTimes,
+	std::vector<OutputDataEntity>& walletOutputs,
+	const std::vector<OutputDataEntity>& spentOutputs)
+{
+	std::vector<OutputDataEntity> addedOutputs;
+	std::vector<WalletTx> addedTransactions;
+	for (size_t i = 0; i < restoredOutputs.size(); i++)
 	{
+		OutputDataEntity& restoredOutput = restoredOutputs[i];
 		WALLET_INFO_F("Output found at index {}", restoredOutput.GetMMRIndex().value_or(0));
 
 		if (restoredOutput.GetStatus() != EOutputStatus::SPENT)
 		{
 			const Commitment& commitment = restoredOutput.GetOutput().GetCommitment();
 			std::unique_ptr<OutputDataEntity> pExistingOutput = FindOutput(walletOutputs, commitment);
+			if (pExistingOutput == nullptr)
+			{
+				pExistingOutput = FindOutput(spentOutputs, commitment);
+			}
+
 			if (pExistingOutput == nullptr)
 			{
 				WALLET_INFO_F("Restoring unknown output with commitment: {}", commitment);
 
-				auto blockTimeOpt = GetBlockTime(restoredOutput);
+				const auto& blockTimeOpt = blockTimes[i];
 
 				// If no output found, create new WalletTx and OutputDataEntity.
 				const uint32_t walletTxId = pBatch->GetNextTransactionId();
@@ -68,49 +238,36 @@ std::vector<OutputDataEntity> WalletRefresher::Refresh(const SecureVector& maste
 				);
 
 				restoredOutput.SetWalletTxId(walletTxId);
-				pBatch->AddOutputs(masterSeed, std::vector<OutputDataEntity>({ restoredOutput }));
-				pBatch->AddTransaction(masterSeed, walletTx);
-
 				walletOutputs.push_back(restoredOutput);
-				walletTransactions.emplace_back(std::move(walletTx));
+				addedOutputs.push_back(restoredOutput);
+				addedTransactions.emplace_back(std::move(walletTx));
 			}
 		}
 	}
 
-	// 3. Refresh status for all OutputDataEntity by calling m_pNodeClient->GetOutputsByCommitment
-	RefreshOutputs(masterSeed, pBatch, walletOutputs);
+	pBatch->AddOutputs(masterSeed, addedOutputs);
+	pBatch->AddTransactions(masterSeed, addedTransactions);
 
-	// 4. For all OutputDataEntity, update matching WalletTx status.
-	RefreshTransactions(masterSeed, pBatch, walletOutputs, walletTransactions);
-
-	pBatch->Commit();
-	return walletOutputs;
+	return addedOutputs;
 }
 
-void WalletRefresher::RefreshOutputs(const SecureVector& masterSeed, Writer<IWalletDB> pBatch, std::vector<OutputDataEntity>& walletOutputs)
+std::vector<OutputDataEntity> WalletRefresher::RefreshOutputs(
+	const SecureVector& masterSeed,
+	Writer<IWalletDB> pBatch,
+	std::vector<OutputDataEntity>& walletOutputs,
+	const std::set<Commitment>& refreshedCommitments,
+	const std::map<Commitment, OutputLocation>& outputLocations,
+	const uint64_t lastConfirmedHeight)
 {
-	std::vector<Commitment> commitments;
-
-	for (const OutputDataEntity& outputData : walletOutputs)
+	std::vector<OutputDataEntity> outputsToUpdate;
+	for (OutputDataEntity& outputData : walletOutputs)
 	{
-		const Commitment& commitment = outputData.GetOutput().GetCommitment();
-
-		/*if (outputData.GetStatus() == EOutputStatus::SPENT)// || outputData.GetStatus() == EOutputStatus::CANCELED)
+		// Outputs added after the node was queried are left for the next refresh.
+		if (refreshedCommitments.count(outputData.GetOutput().GetCommitment()) == 0)
 		{
-			WALLET_TRACE_F("No need to refresh spent/canceled output with commitment: " + commitment);
 			continue;
-		}*/
-
-		// TODO: What if commitment has mmr_index?
-		commitments.push_back(commitment);		
-	}
-
-	const uint64_t lastConfirmedHeight = m_pNodeClient->GetChainHeight();
+		}
 
-	std::vector<OutputDataEntity> outputsToUpdate;
-	const std::map<Commitment, OutputLocation> outputLocations = m_pNodeClient->GetOutputsByCommitment(commitments);
-	for (OutputDataEntity& outputData : walletOutputs)
-	{
 		auto iter = outputLocations.find(outputData.GetOutput().GetCommitment());
 		if (iter != outputLocations.cend())
 		{
@@ -162,7 +319,12 @@ void WalletRefresher::RefreshOutputs(const SecureVector& masterSeed, Writer<IWal
 	}
 
 	pBatch->AddOutputs(masterSeed, outputsToUpdate);
-	pBatch->UpdateRefreshBlockHeight(lastConfirmedHeight);
+	if (lastConfirmedHeight > pBatch->GetRefreshBlockHeight())
+	{
+		pBatch->UpdateRefreshBlockHeight(lastConfirmedHeight);
+	}
+
+	return outputsToUpdate;
 }
 
 void WalletRefresher::RefreshTransactions(
@@ -177,6 +339,9 @@ void WalletRefresher::RefreshTransactions(
 		walletTransactionsById.insert({ walletTx.GetId(), walletTx });
 	}
 
+	// Written together at the end, in the order they were updated.
+	std::vector<WalletTx> transactionsToUpdate;
+
 	for (const OutputDataEntity& output : refreshedOutputs)
 	{
 		if (output.GetWalletTxId().has_value())
@@ -195,14 +360,14 @@ void WalletRefresher::RefreshTransactions(
 						WALLET_DEBUG_F("Marking transaction as received: {}", walletTx.GetId());
 
 						walletTx.SetType(EWalletTxType::RECEIVED);
-						pBatch->AddTransaction(masterSeed, walletTx);
+						transactionsToUpdate.push_back(walletTx);
 					}
 					else if (walletTx.GetType() == EWalletTxType::SENDING_FINALIZED)
 					{
 						WALLET_DEBUG_F("Marking transaction as sent: {}", walletTx.GetId());
 
 						walletTx.SetType(EWalletTxType::SENT);
-						pBatch->AddTransaction(masterSeed, walletTx);
+						transactionsToUpdate.push_back(walletTx);
 					}
 				}
 			}
@@ -224,7 +389,7 @@ void WalletRefresher::RefreshTransactions(
 						WALLET_DEBUG_F("Output is spent. Marking transaction as sent: {}", walletTx.GetId());
 
 						walletTx.SetType(EWalletTxType::SENT);
-						pBatch->AddTransaction(masterSeed, walletTx);
+						transactionsToUpdate.push_back(walletTx);
 					}
 
 					break;
@@ -232,6 +397,8 @@ void WalletRefresher::RefreshTransactions(
 			}
 		}
 	}
+
+	pBatch->AddTransactions(masterSeed, transactionsToUpdate);
 }
 
 std::optional<std::chrono::system_clock::time_point> WalletRefresher::GetBlockTime(const OutputDataEntity& output) const
@@ -5,9 +5,12 @@
 #include <Wallet/NodeClient.h>
 #include <Wallet/WalletDB/WalletDB.h>
 #include <Wallet/WalletDB/Models/OutputDataEntity.h>
+#include "RestoreProgress.h"
 #include <Common/Secure.h>
 #include <Crypto/SecretKey.h>
 #include <cstdint>
+#include <map>
+#include <set>
 #include <string>
 
 // Forward Declarations
@@ -17,20 +20,73 @@ class Wallet;
 class WalletRefresher
 {
 public:
-	WalletRefresher(const Config& config, const INodeClientConstPtr& pNodeClient)
-		: m_config(config), m_pNodeClient(pNodeClient) { }
+	WalletRefresher(const Config& config, const INodeClientConstPtr& pNodeClient, const RestoreProgress::Ptr& pProgress)
+		: m_config(config), m_pNodeClient(pNodeClient), m_pProgress(pProgress) { }
 
+	//
+	// Updates the wallet's outputs and transactions with any blocks added since the last refresh,
+	// and returns every output that isn't spent.
+	// walletDB is read-locked, then briefly write-locked once the node has been queried, but never locked while waiting on the node.
+	//
 	std::vector<OutputDataEntity> Refresh(
 		const SecureVector& masterSeed,
 		Locked<IWalletDB> walletDB,
 		const bool fromGenesis
 	);
 
+	//
+	// Same as Refresh, but with the outputs found by a scan that already ran (see OutputScanner) through restoreLeafIndex,
+	// instead of scanning for them.
+	//
+	std::vector<OutputDataEntity> ApplyScan(
+		const SecureVector& masterSeed,
+		Locked<IWalletDB> walletDB,
+		std::vector<OutputDataEntity>&& restoredOutputs,
+		const uint64_t restoreLeafIndex
+	);
+
+	//
+	// Writes the outputs restored so far, and the last leaf index scanned, in their own transaction.
+	// Called every few batches during a long scan, so an interrupted restore resumes from the last checkpoint instead of starting over.
+	// Statuses of the wallet's other outputs, and the refresh height, are only updated once the scan finishes.
+	//
+	void Checkpoint(
+		const SecureVector& masterSeed,
+		Locked<IWalletDB> walletDB,
+		std::vector<OutputDataEntity>& restoredOutputs,
+		const uint64_t restoreLeafIndex,
+		const bool fromGenesis
+	);
+
 private:
-	void RefreshOutputs(
+	// Step 2 of the refresh. Adds each restored output (and a WalletTx for it) that isn't in walletOutputs or spentOutputs.
+	std::vector<OutputDataEntity> AddRestoredOutputs(
+		const SecureVector& masterSeed,
+		Writer<IWalletDB> pBatch,
+		std::vector<OutputDataEntity>& restoredOutputs,
+		const std::vector<std::optional<std::chrono::system_clock::time_point>>& blockTimes,
+		std::vector<OutputDataEntity>& walletOutputs,
+		const std::vector<OutputDataEntity>& spentOutputs
+	);
+
+	// Steps 2-4 of the refresh, once the outputs added since restoreLeafIndex have been scanned.
+	std::vector<OutputDataEntity> Update(
+		const SecureVector& masterSeed,
+		Locked<IWalletDB> walletDB,
+		std::vector<OutputDataEntity>&& walletOutputs,
+		std::vector<OutputDataEntity>& restoredOutputs,
+		const uint64_t restoreLeafIndex,
+		const bool fromGenesis
+	);
+
+	// Returns the outputs whose status changed. Only outputs in refreshedCommitments are checked against outputLocations.
+	std::vector<OutputDataEntity> RefreshOutputs(
 		const SecureVector& masterSeed,
 		Writer<IWalletDB> pBatch,
-		std::vector<OutputDataEntity>& walletOutputs
+		std::vector<OutputDataEntity>& walletOutputs,
+		const std::set<Commitment>& refreshedCommitments,
+		const std::map<Commitment, OutputLocation>& outputLocations,
+		const uint64_t lastConfirmedHeight
 	);
 
 	void RefreshTransactions(
@@ -49,4 +105,5 @@ private:
 
 	const Config& m_config;
 	INodeClientConstPtr m_pNodeClient;
+	RestoreProgress::Ptr m_pProgress;
 };
\ No newline at end of file
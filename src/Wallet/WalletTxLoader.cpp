@@ -8,9 +8,17 @@ std::vector<WalletTxDTO> WalletTxLoader::LoadTransactions(
 	const SecureVector& masterSeed,
     const ListTxsCriteria& criteria) const
 {
-	std::vector<OutputDataEntity> outputs = pWalletDB->GetOutputs(masterSeed);
 	std::vector<WalletTx> walletTransactions = LoadWalletTxs(pWalletDB, masterSeed, criteria);
 
+	std::vector<uint32_t> walletTxIds;
+	std::transform(
+		walletTransactions.cbegin(), walletTransactions.cend(),
+		std::back_inserter(walletTxIds),
+		[](const WalletTx& walletTx) { return walletTx.GetId(); }
+	);
+
+	std::vector<OutputDataEntity> outputs = pWalletDB->GetOutputs(masterSeed, walletTxIds);
+
 	std::vector<WalletTxDTO> walletTxDTOs;
 	std::transform(
 		walletTransactions.cbegin(), walletTransactions.cend(),
@@ -54,33 +62,23 @@ std::vector<WalletTx> WalletTxLoader::LoadWalletTxs(
 	const SecureVector& masterSeed,
 	const ListTxsCriteria& criteria) const
 {
-	std::vector<WalletTx> walletTxs = pWalletDB->GetTransactions(masterSeed);
-
-	std::vector<WalletTx> filteredTxs;
-	std::copy_if(
-		walletTxs.cbegin(), walletTxs.cend(),
-		std::back_inserter(filteredTxs),
-		[this, &criteria](const WalletTx& walletTx) { return this->MeetsCriteria(walletTx, criteria); }
-	);
-
-	return filteredTxs;
-}
-
-bool WalletTxLoader::MeetsCriteria(const WalletTx& walletTx, const ListTxsCriteria& criteria) const
-{
-	std::chrono::system_clock::time_point txDateTime = walletTx.GetCreationTime();
-	if (walletTx.GetConfirmationTime().has_value() && walletTx.GetConfirmationTime().value() < txDateTime) {
-		txDateTime = walletTx.GetConfirmationTime().value();
+	std::optional<int64_t> startTimeMs = std::nullopt;
+	if (criteria.GetStartRange().has_value()) {
+		startTimeMs = std::make_optional(TimeUtil::ToInt64(criteria.GetStartRange().value()));
 	}
 
-	if (criteria.GetStartRange().has_value() && criteria.GetStartRange().value() > txDateTime) {
-		return false;
+	std::optional<int64_t> endTimeMs = std::nullopt;
+	if (criteria.GetEndRange().has_value()) {
+		endTimeMs = std::make_optional(TimeUtil::ToInt64(criteria.GetEndRange().value()));
 	}
 
-	if (criteria.GetEndRange().has_value() && criteria.GetEndRange().value() < txDateTime) {
-		return false;
-	}
+	const WalletTxQuery query(
+		criteria.GetStatuses(),
+		startTimeMs,
+		endTimeMs,
+		criteria.GetLimit(),
+		criteria.GetOffset()
+	);
 
-	return criteria.GetStatuses().empty()
-		|| criteria.GetStatuses().count(walletTx.GetType()) > 0;
+	return pWalletDB->GetTransactions(masterSeed, query);
 }
\ No newline at end of file
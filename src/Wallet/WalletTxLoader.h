@@ -12,7 +12,7 @@ class WalletTxLoader
 {
 public:
     //
-    // Loads all transactions, and filters them using the given criteria.
+    // Loads the page of transactions meeting the given criteria, along with their outputs.
     //
     std::vector<WalletTxDTO> LoadTransactions(
         const std::shared_ptr<const IWalletDB>& pWalletDB,
@@ -31,9 +31,4 @@ private:
         const SecureVector& masterSeed,
         const ListTxsCriteria& criteria
     ) const;
-
-    bool MeetsCriteria(
-        const WalletTx& walletTx,
-        const ListTxsCriteria& criteria
-    ) const;
 };
\ No newline at end of file
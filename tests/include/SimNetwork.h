@@ -0,0 +1,696 @@
+#pragma once
+
+#include "TestServer.h"
+#include "TestMiner.h"
+#include "TxBuilder.h"
+
+#include <Core/Context.h>
+#include <Core/Util/FeeUtil.h>
+#include <Core/Util/TransactionUtil.h>
+#include <Consensus/BlockTime.h>
+#include <Config/ConfigProps.h>
+#include <Common/ThreadManager.h>
+#include <Common/Util/FileUtil.h>
+#include <P2P/P2PServer.h>
+#include <Wallet/Keychain/KeyChain.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// A network of full nodes run in this process, for measuring how quickly blocks and transactions reach every node.
+//
+// Nodes talk over real TCP on the loopback interface, each bound to its own address (127.0.0.2, 127.0.0.3, ...) on the usual port,
+// since peers are identified by IP. That's all of 127/8 on linux, but macOS needs the addresses aliased first (ifconfig lo0 alias).
+// Each node only knows its neighbours in the chosen topology (P2P.SEEDS), and by default dandelion always fluffs, so transactions are relayed right away.
+//
+// All nodes share one process, so the worker pool and crypto caches are shared too, and CPU time can only be broken down by thread name.
+//
+class SimNetwork
+{
+public:
+	enum class ETopology
+	{
+		LINE,	// Node i dials node i+1.
+		RING,	// LINE, plus the last node dials the first.
+		STAR,	// Every node dials node 0.
+		MESH,	// Every node dials every other.
+		RANDOM	// RING, plus each node dials randomDegree-2 random others.
+	};
+
+	struct Options
+	{
+		size_t numNodes = 8;
+		ETopology topology = ETopology::RING;
+		size_t randomDegree = 4;
+		uint64_t seed = 1;
+		std::chrono::seconds timeout = std::chrono::seconds(60);
+
+		// Dandelion's STEM_PROBABILITY. 0 fluffs every transaction right away.
+		uint8_t stemProbability = 0;
+
+		//
+		// Overrides the defaults with GRINPP_SIM_NODES, GRINPP_SIM_TOPOLOGY (LINE, RING, STAR, MESH or RANDOM) and GRINPP_SIM_DEGREE, if set.
+		//
+		static Options FromEnvironment() { return FromEnvironment(Options()); }
+
+		static Options FromEnvironment(Options options)
+		{
+			if (const char* pNodes = std::getenv("GRINPP_SIM_NODES"))
+			{
+				options.numNodes = (size_t)std::stoul(pNodes);
+			}
+
+			if (const char* pTopology = std::getenv("GRINPP_SIM_TOPOLOGY"))
+			{
+				options.topology = ParseTopology(pTopology);
+			}
+
+			if (const char* pDegree = std::getenv("GRINPP_SIM_DEGREE"))
+			{
+				options.randomDegree = (size_t)std::stoul(pDegree);
+			}
+
+			return options;
+		}
+	};
+
+	struct NodeTraffic
+	{
+		uint64_t bytesSent;
+		uint64_t bytesReceived;
+	};
+
+	//
+	// The latency of every (item, node) delivery, the traffic of every node, and the process' CPU time, over one run.
+	//
+	struct RelayReport
+	{
+		std::string name;
+		size_t numItems = 0;
+		size_t numMissed = 0;
+		double elapsedSecs = 0.0;
+		std::vector<double> latenciesMs;
+		std::vector<NodeTraffic> traffic;
+		std::vector<ThreadGroupStats> cpuByThread;
+
+		double Percentile(const double percentile) const
+		{
+			if (latenciesMs.empty())
+			{
+				return 0.0;
+			}
+
+			const size_t rank = (size_t)std::ceil((percentile / 100.0) * latenciesMs.size());
+			return latenciesMs[(std::max)(rank, (size_t)1) - 1];
+		}
+
+		void Print(std::ostream& out) const
+		{
+			out << std::fixed << std::setprecision(2);
+			out << "=== " << name << ": " << numItems << " items, " << latenciesMs.size() << " deliveries, " << numMissed << " missed, "
+				<< elapsedSecs << "s ===" << std::endl;
+			out << "latency ms: p50=" << Percentile(50) << " p90=" << Percentile(90) << " p99=" << Percentile(99) << " max=" << Percentile(100) << std::endl;
+
+			for (size_t i = 0; i < traffic.size(); i++)
+			{
+				out << "node " << i << ": sent=" << traffic[i].bytesSent << "B received=" << traffic[i].bytesReceived << "B" << std::endl;
+			}
+
+			uint64_t totalCpuMicros = 0;
+			for (const ThreadGroupStats& group : cpuByThread)
+			{
+				totalCpuMicros += group.cpuMicros;
+			}
+
+			out << "cpu: " << (totalCpuMicros / 1000.0) << "ms total, " << (totalCpuMicros / 1000.0 / (std::max)(traffic.size(), (size_t)1)) << "ms per node" << std::endl;
+			for (const ThreadGroupStats& group : cpuByThread)
+			{
+				if (group.cpuMicros > 0)
+				{
+					out << "  " << group.name << ": " << (group.cpuMicros / 1000.0) << "ms" << std::endl;
+				}
+			}
+		}
+	};
+
+	SimNetwork(const Options& options)
+		: m_options(options),
+		m_keyChain(KeyChain::FromRandom(*Config::Default(EEnvironmentType::AUTOMATED_TESTING))),
+		m_nextCoinbase(0),
+		m_nextOutput(0)
+	{
+		if (m_options.numNodes < 2 || m_options.numNodes > 250)
+		{
+			throw std::invalid_argument("SimNetwork supports 2 to 250 nodes");
+		}
+
+		m_baseDir = Config::Default(EEnvironmentType::AUTOMATED_TESTING)->GetDataDirectory() / "SIM";
+		FileUtil::RemoveFile(m_baseDir);
+
+		m_dials = BuildDials();
+		for (size_t i = 0; i < m_options.numNodes; i++)
+		{
+			m_nodes.push_back(Node{ TestServer::Create(BuildConfig(i)), nullptr, nullptr });
+		}
+	}
+
+	~SimNetwork()
+	{
+		for (Node& node : m_nodes)
+		{
+			node.pP2PServer.reset();
+		}
+
+		for (Node& node : m_nodes)
+		{
+			node.pContext.reset();
+		}
+
+		m_nodes.clear();
+		FileUtil::RemoveFile(m_baseDir);
+	}
+
+	size_t GetNumNodes() const noexcept { return m_nodes.size(); }
+	const TestServer::Ptr& GetServer(const size_t node) const { return m_nodes.at(node).pServer; }
+	const IP2PServerPtr& GetP2PServer(const size_t node) const { return m_nodes.at(node).pP2PServer; }
+	const KeyChain& GetKeyChain() const noexcept { return m_keyChain; }
+
+	//
+	// Hands out funded outputs that FloodTransactions won't spend, eg. to build other transactions with GetKeyChain.
+	//
+	std::vector<Test::Input> TakeSpendable(const size_t count)
+	{
+		if (m_nextOutput + count > m_spendable.size())
+		{
+			throw std::invalid_argument("Not enough funded outputs; call Fund first");
+		}
+
+		std::vector<Test::Input> inputs(m_spendable.begin() + m_nextOutput, m_spendable.begin() + m_nextOutput + count);
+		m_nextOutput += count;
+		return inputs;
+	}
+
+	//
+	// Mines enough blocks on every node for numOutputs mature coinbases to spend. Must be called before Connect.
+	// Coinbases mature after 25 blocks in AUTOMATED_TESTING (see Consensus::GetMaxCoinbaseHeight), so that many more are mined.
+	//
+	void Fund(const size_t numOutputs)
+	{
+		// TestMiner backdates blocks by 1000s plus their height, so too long a chain ends up too far in the future to be accepted.
+		if (numOutputs > 1000)
+		{
+			throw std::invalid_argument("SimNetwork can only fund 1000 outputs");
+		}
+
+		const uint64_t tipHeight = numOutputs + 25;
+		TestMiner miner(m_nodes.front().pServer);
+		std::vector<MinedBlock> blocks = miner.MineChain(m_keyChain, tipHeight + 1);
+		for (size_t i = 1; i < m_nodes.size(); i++)
+		{
+			for (size_t height = 1; height < blocks.size(); height++)
+			{
+				if (m_nodes[i].pServer->GetBlockChain()->AddBlock(blocks[height].block) != EBlockChainStatus::SUCCESS)
+				{
+					throw std::runtime_error("Failed to add funding block " + std::to_string(height) + " to node " + std::to_string(i));
+				}
+			}
+		}
+
+		for (size_t height = 1; height <= numOutputs; height++)
+		{
+			const MinedBlock& block = blocks[height];
+			m_spendable.push_back(Test::Input{
+				TransactionInput(EOutputFeatures::COINBASE_OUTPUT, Commitment(block.block.GetOutputs().front().GetCommitment())),
+				block.coinbasePath.value(),
+				block.coinbaseAmount
+			});
+		}
+	}
+
+	//
+	// Starts every node's P2P server, and waits until each is connected to all of its neighbours.
+	//
+	void Connect()
+	{
+		for (Node& node : m_nodes)
+		{
+			node.pContext = std::make_shared<Context>(node.pServer->GetConfig(), TaskScheduler::Create(), nullptr);
+			node.pP2PServer = P2PAPI::StartP2PServer(
+				node.pContext,
+				node.pServer->GetBlockChain(),
+				node.pServer->GetTxHashSetManager(),
+				node.pServer->GetDatabase(),
+				node.pServer->GetTxPool()
+			);
+		}
+
+		std::vector<size_t> degrees(m_nodes.size(), 0);
+		for (size_t i = 0; i < m_dials.size(); i++)
+		{
+			for (const size_t j : m_dials[i])
+			{
+				++degrees[i];
+				++degrees[j];
+			}
+		}
+
+		const auto deadline = std::chrono::steady_clock::now() + m_options.timeout;
+		for (size_t i = 0; i < m_nodes.size(); i++)
+		{
+			while (m_nodes[i].pP2PServer->GetConnectedPeers().size() < degrees[i] || m_nodes[i].pP2PServer->GetSyncStatus()->IsSyncing())
+			{
+				if (std::chrono::steady_clock::now() > deadline)
+				{
+					throw std::runtime_error("Node " + std::to_string(i) + " didn't connect to its " + std::to_string(degrees[i]) + " neighbours");
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
+			}
+		}
+	}
+
+	//
+	// Mines numBlocks blocks on the source node, one at a time, each only once the previous one reached every node.
+	// The first block includes the given transactions (eg. the ones from FloodTransactions), so compact blocks are rebuilt from the mempool.
+	//
+	RelayReport MineBlocks(const size_t source, const size_t numBlocks, const std::vector<TransactionPtr>& transactions = {})
+	{
+		const IBlockChain::Ptr& pBlockChain = m_nodes.at(source).pServer->GetBlockChain();
+		TestMiner miner(m_nodes.at(source).pServer);
+		TxBuilder txBuilder(m_keyChain);
+
+		std::vector<std::pair<uint64_t, Hash>> blocks(numBlocks);
+		auto inject = [&](const size_t i) {
+			std::vector<TransactionPtr> blockTxs = (i == 0) ? transactions : std::vector<TransactionPtr>();
+			uint64_t fees = 0;
+			for (const TransactionPtr& pTransaction : blockTxs)
+			{
+				for (const TransactionKernel& kernel : pTransaction->GetKernels())
+				{
+					fees += kernel.GetFee();
+				}
+			}
+
+			blockTxs.push_back(txBuilder.BuildCoinbaseTx(KeyChainPath({ 1, m_nextCoinbase++ }), Consensus::REWARD + fees).pTransaction);
+
+			const FullBlock block = miner.MineNextBlock(pBlockChain->GetTipBlockHeader(EChainType::CONFIRMED), *TransactionUtil::Aggregate(blockTxs));
+			if (pBlockChain->AddBlock(block) != EBlockChainStatus::SUCCESS)
+			{
+				throw std::runtime_error("Failed to add mined block");
+			}
+
+			blocks[i] = std::make_pair(block.GetHeight(), block.GetHash());
+		};
+
+		auto arrived = [&](const size_t node, const size_t i) {
+			BlockHeaderPtr pHeader = m_nodes[node].pServer->GetBlockChain()->GetBlockHeaderByHeight(blocks[i].first, EChainType::CONFIRMED);
+			return pHeader != nullptr && pHeader->GetHash() == blocks[i].second;
+		};
+
+		auto broadcast = [&](const size_t i) {
+			m_nodes[source].pP2PServer->BroadcastBlock(*pBlockChain->GetCompactBlockByHash(blocks[i].second));
+		};
+
+		return Measure("blocks", source, numBlocks, [&](const size_t i) { inject(i); broadcast(i); }, arrived, true);
+	}
+
+	//
+	// Builds count transactions spending funded outputs, then submits them to the source node at txsPerSec (0 means all at once).
+	// The transactions are returned through pTransactions, if given, eg. to mine them with MineBlocks.
+	//
+	RelayReport FloodTransactions(const size_t source, const size_t count, const double txsPerSec = 0.0, std::vector<TransactionPtr>* pTransactions = nullptr)
+	{
+		if (m_nextOutput + count > m_spendable.size())
+		{
+			throw std::invalid_argument("Not enough funded outputs; call Fund first");
+		}
+
+		// The signatures and rangeproofs are built up front, so they don't count towards the latency.
+		TxBuilder txBuilder(m_keyChain);
+		const uint64_t fee = FeeUtil::CalculateFee(1'000'000, 1, 1, 1);
+		std::vector<TransactionPtr> transactions;
+		for (size_t i = 0; i < count; i++)
+		{
+			const Test::Input& input = m_spendable[m_nextOutput++];
+			Test::Output output{ KeyChainPath({ 2, (uint32_t)m_nextOutput }), input.amount - fee };
+			transactions.push_back(std::make_shared<Transaction>(txBuilder.BuildTx(fee, { input }, { output })));
+		}
+
+		const IBlockChain::Ptr& pBlockChain = m_nodes.at(source).pServer->GetBlockChain();
+		const auto start = std::chrono::steady_clock::now();
+		auto inject = [&](const size_t i) {
+			if (txsPerSec > 0.0)
+			{
+				std::this_thread::sleep_until(start + std::chrono::microseconds((int64_t)((i * 1'000'000) / txsPerSec)));
+			}
+
+			if (pBlockChain->AddTransaction(transactions[i], EPoolType::MEMPOOL) != EBlockChainStatus::SUCCESS)
+			{
+				throw std::runtime_error("Failed to add transaction " + std::to_string(i));
+			}
+
+			m_nodes[source].pP2PServer->BroadcastTransaction(transactions[i]);
+		};
+
+		auto arrived = [&](const size_t node, const size_t i) {
+			return m_nodes[node].pServer->GetTxPool()->FindTransactionByKernelHash(transactions[i]->GetKernels().front().GetHash()) != nullptr;
+		};
+
+		RelayReport report = Measure("transactions", source, count, inject, arrived, false);
+		if (pTransactions != nullptr)
+		{
+			*pTransactions = transactions;
+		}
+
+		return report;
+	}
+
+	static ETopology ParseTopology(const std::string& topology)
+	{
+		static const std::map<std::string, ETopology> TOPOLOGIES = {
+			{ "LINE", ETopology::LINE },
+			{ "RING", ETopology::RING },
+			{ "STAR", ETopology::STAR },
+			{ "MESH", ETopology::MESH },
+			{ "RANDOM", ETopology::RANDOM }
+		};
+
+		auto iter = TOPOLOGIES.find(topology);
+		if (iter == TOPOLOGIES.end())
+		{
+			throw std::invalid_argument("Unknown topology: " + topology);
+		}
+
+		return iter->second;
+	}
+
+private:
+	struct Node
+	{
+		TestServer::Ptr pServer;
+		Context::Ptr pContext;
+		IP2PServerPtr pP2PServer;
+	};
+
+	using Clock = std::chrono::steady_clock;
+
+	static std::string GetIP(const size_t node) { return "127.0.0." + std::to_string(node + 2); }
+
+	//
+	// The nodes each node dials. Every pair is only dialed one way, since a connection to a peer is used in both directions.
+	//
+	std::vector<std::set<size_t>> BuildDials() const
+	{
+		const size_t n = m_options.numNodes;
+		std::vector<std::set<size_t>> dials(n);
+		auto dial = [&dials](const size_t from, const size_t to) {
+			if (from != to && dials[to].count(from) == 0)
+			{
+				dials[from].insert(to);
+			}
+		};
+
+		for (size_t i = 0; i < n; i++)
+		{
+			switch (m_options.topology)
+			{
+				case ETopology::LINE:
+				{
+					if (i + 1 < n)
+					{
+						dial(i, i + 1);
+					}
+					break;
+				}
+				case ETopology::RING:
+				case ETopology::RANDOM:
+				{
+					dial(i, (i + 1) % n);
+					break;
+				}
+				case ETopology::STAR:
+				{
+					dial(i, 0);
+					break;
+				}
+				case ETopology::MESH:
+				{
+					for (size_t j = 0; j < i; j++)
+					{
+						dial(i, j);
+					}
+					break;
+				}
+			}
+		}
+
+		if (m_options.topology == ETopology::RANDOM)
+		{
+			std::mt19937_64 rng(m_options.seed);
+			std::uniform_int_distribution<size_t> distribution(0, n - 1);
+			const size_t numChords = (std::min)(m_options.randomDegree > 2 ? m_options.randomDegree - 2 : 0, n - 3);
+			for (size_t i = 0; i < n; i++)
+			{
+				// Bounded, so a small network that's already dense doesn't loop forever.
+				for (size_t attempt = 0; dials[i].size() < numChords + 1 && attempt < n * 4; attempt++)
+				{
+					dial(i, distribution(rng));
+				}
+			}
+		}
+
+		return dials;
+	}
+
+	ConfigPtr BuildConfig(const size_t node) const
+	{
+		Json::Value json;
+		json[ConfigProps::DATA_PATH] = (m_baseDir / ("NODE_" + std::to_string(node))).u8string();
+
+		Json::Value p2pJSON;
+		p2pJSON[ConfigProps::P2P::BIND_IP] = GetIP(node);
+		p2pJSON[ConfigProps::P2P::MIN_PEERS] = (Json::UInt)m_dials[node].size();
+		p2pJSON[ConfigProps::P2P::MAX_PEERS] = (Json::UInt)m_options.numNodes + 8;
+
+		Json::Value seedsJSON(Json::arrayValue);
+		for (const size_t neighbour : m_dials[node])
+		{
+			seedsJSON.append(GetIP(neighbour));
+		}
+		p2pJSON[ConfigProps::P2P::SEEDS] = seedsJSON;
+		json[ConfigProps::P2P::P2P] = p2pJSON;
+
+		json[ConfigProps::Dandelion::DANDELION][ConfigProps::Dandelion::STEM_PROBABILITY] = m_options.stemProbability;
+
+		return Config::Load(json, EEnvironmentType::AUTOMATED_TESTING);
+	}
+
+	std::vector<NodeTraffic> GetTraffic() const
+	{
+		std::vector<NodeTraffic> traffic;
+		for (const Node& node : m_nodes)
+		{
+			NodeTraffic nodeTraffic{ 0, 0 };
+			for (const ConnectedPeer& peer : node.pP2PServer->GetConnectedPeers())
+			{
+				for (size_t type = 0; type < PeerStats::NUM_MESSAGE_TYPES; type++)
+				{
+					const PeerStats::MessageCounts counts = peer.GetStats().GetMessageCounts((uint8_t)type);
+					nodeTraffic.bytesSent += counts.bytesSent;
+					nodeTraffic.bytesReceived += counts.bytesReceived;
+				}
+			}
+
+			traffic.push_back(nodeTraffic);
+		}
+
+		return traffic;
+	}
+
+	//
+	// Injects count items at the source (in order, waiting for each to reach every node first if sequential),
+	// while polling every other node until it has each of them, or timeout has passed since the last was injected.
+	//
+	template<typename Inject, typename Arrived>
+	RelayReport Measure(const std::string& name, const size_t source, const size_t count, const Inject& inject, const Arrived& arrived, const bool sequential)
+	{
+		const std::vector<NodeTraffic> trafficBefore = GetTraffic();
+		const std::vector<ThreadGroupStats> cpuBefore = ThreadManagerAPI::GetThreadGroupStats();
+
+		std::mutex mutex;
+		std::vector<Clock::time_point> sent;
+		sent.reserve(count);
+		std::atomic<size_t> numDone = 0;
+		std::atomic_bool injecting = true;
+		std::vector<double> latencies;
+		size_t numMissed = 0;
+
+		std::thread probe([&]() {
+			ThreadManagerAPI::SetCurrentThreadName("SIM_PROBE");
+
+			// (item, node) pairs still to arrive
+			std::vector<std::pair<size_t, size_t>> pending;
+			size_t numSeen = 0;
+			Clock::time_point lastInjected = Clock::now();
+			while (true)
+			{
+				// Read before the sent times, so nothing injected before it was cleared is missed.
+				const bool finished = !injecting;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					for (; numSeen < sent.size(); numSeen++)
+					{
+						for (size_t node = 0; node < m_nodes.size(); node++)
+						{
+							if (node != source)
+							{
+								pending.push_back(std::make_pair(numSeen, node));
+							}
+						}
+
+						lastInjected = Clock::now();
+					}
+				}
+
+				std::vector<std::pair<size_t, size_t>> stillPending;
+				for (const auto& item : pending)
+				{
+					if (arrived(item.second, item.first))
+					{
+						const double latency = std::chrono::duration<double, std::milli>(Clock::now() - sent[item.first]).count();
+						std::unique_lock<std::mutex> lock(mutex);
+						latencies.push_back(latency);
+					}
+					else
+					{
+						stillPending.push_back(item);
+					}
+				}
+				pending.swap(stillPending);
+
+				size_t done = numSeen;
+				for (const auto& item : pending)
+				{
+					done = (std::min)(done, item.first);
+				}
+				numDone = done;
+
+				if (finished && pending.empty())
+				{
+					break;
+				}
+
+				if (Clock::now() - lastInjected > m_options.timeout && (numSeen == count || sequential || finished))
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					numMissed = pending.size() + ((count - numSeen) * (m_nodes.size() - 1));
+					numDone = count;
+					break;
+				}
+
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		});
+
+		const Clock::time_point start = Clock::now();
+		try
+		{
+			for (size_t i = 0; i < count; i++)
+			{
+				if (sequential)
+				{
+					while (numDone < i)
+					{
+						std::this_thread::sleep_for(std::chrono::milliseconds(1));
+					}
+
+					if (numDone >= count)
+					{
+						break;
+					}
+				}
+
+				const Clock::time_point injectedAt = Clock::now();
+				inject(i);
+
+				std::unique_lock<std::mutex> lock(mutex);
+				sent.push_back(injectedAt);
+			}
+		}
+		catch (...)
+		{
+			injecting = false;
+			probe.join();
+			throw;
+		}
+
+		injecting = false;
+		probe.join();
+
+		RelayReport report;
+		report.name = name;
+		report.numItems = count;
+		report.numMissed = numMissed;
+		report.elapsedSecs = std::chrono::duration<double>(Clock::now() - start).count();
+		report.latenciesMs = std::move(latencies);
+		std::sort(report.latenciesMs.begin(), report.latenciesMs.end());
+
+		const std::vector<NodeTraffic> trafficAfter = GetTraffic();
+		for (size_t i = 0; i < trafficAfter.size(); i++)
+		{
+			report.traffic.push_back(NodeTraffic{
+				trafficAfter[i].bytesSent - (std::min)(trafficBefore[i].bytesSent, trafficAfter[i].bytesSent),
+				trafficAfter[i].bytesReceived - (std::min)(trafficBefore[i].bytesReceived, trafficAfter[i].bytesReceived)
+			});
+		}
+
+		std::map<std::string, ThreadGroupStats> before;
+		for (const ThreadGroupStats& group : cpuBefore)
+		{
+			before[group.name] = group;
+		}
+
+		for (ThreadGroupStats group : ThreadManagerAPI::GetThreadGroupStats())
+		{
+			auto iter = before.find(group.name);
+			if (iter != before.end())
+			{
+				group.cpuMicros -= (std::min)(iter->second.cpuMicros, group.cpuMicros);
+				group.waitMicros -= (std::min)(iter->second.waitMicros, group.waitMicros);
+				group.wallMicros -= (std::min)(iter->second.wallMicros, group.wallMicros);
+			}
+
+			report.cpuByThread.push_back(group);
+		}
+
+		std::sort(
+			report.cpuByThread.begin(), report.cpuByThread.end(),
+			[](const ThreadGroupStats& a, const ThreadGroupStats& b) { return a.cpuMicros > b.cpuMicros; }
+		);
+
+		return report;
+	}
+
+	Options m_options;
+	KeyChain m_keyChain;
+	fs::path m_baseDir;
+	std::vector<std::set<size_t>> m_dials;
+	std::vector<Node> m_nodes;
+
+	std::vector<Test::Input> m_spendable;
+	uint32_t m_nextCoinbase;
+	size_t m_nextOutput;
+};
@@ -67,6 +67,18 @@ public:
 		return std::make_unique<OutputRange>(pTxHashSet->GetOutputsByLeafIndex(pBlockDB.GetShared(), startIndex, maxNumOutputs));
 	}
 
+	std::unique_ptr<OutputScanBatch> ScanOutputs(const uint64_t startIndex, const uint64_t maxNumOutputs) const final
+	{
+		auto pTxHashSet = m_pTxHashSetManager.Read()->GetTxHashSet();
+		if (pTxHashSet == nullptr)
+		{
+			return std::unique_ptr<OutputScanBatch>(nullptr);
+		}
+
+		auto pBlockDB = m_pDatabase->GetBlockDB()->Read();
+		return std::make_unique<OutputScanBatch>(pTxHashSet->ScanOutputs(pBlockDB.GetShared(), startIndex, maxNumOutputs));
+	}
+
 	bool PostTransaction(TransactionPtr pTransaction, const EPoolType poolType) final
 	{
 		auto pTipHeader = m_pBlockChain->GetTipBlockHeader(EChainType::CONFIRMED);
@@ -18,7 +18,14 @@ public:
 
 	static TestServer::Ptr Create()
 	{
-		ConfigPtr pConfig = TestHelper::GetTestConfig();
+		return Create(TestHelper::GetTestConfig());
+	}
+
+	//
+	// Opens a server using the given config, eg. with its own DATA_PATH, so several can run at once.
+	//
+	static TestServer::Ptr Create(const ConfigPtr& pConfig)
+	{
 		LoggerAPI::Initialize(pConfig->GetLogDirectory(), pConfig->GetLogLevel());
 		IDatabasePtr pDatabase = DatabaseAPI::OpenDatabase(*pConfig);
 		auto pTxHashSetManager = std::make_shared<Locked<TxHashSetManager>>(std::make_shared<TxHashSetManager>(*pConfig));
@@ -21,7 +21,11 @@ public:
             *pTestServer->GetConfig(),
             pTestServer->GetNodeClient()
         );
-        auto pOwnerServer = OwnerServer::Create(TorProcessManager::GetProcess(0), pWalletManager);
+        auto pOwnerServer = OwnerServer::Create(
+            TorProcessManager::GetProcess(0),
+            pWalletManager,
+            pTestServer->GetConfig()->GetServerConfig().GetOwnerAPIConfig()
+        );
         return std::make_shared<TestWalletServer>(pWalletManager, std::move(pOwnerServer));
     }
 
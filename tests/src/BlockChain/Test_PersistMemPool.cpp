@@ -0,0 +1,69 @@
+#include <catch.hpp>
+
+#include <TestServer.h>
+#include <TestMiner.h>
+#include <TxBuilder.h>
+
+#include <BlockChain/BlockChain.h>
+#include <Database/Database.h>
+#include <Database/BlockDb.h>
+#include <PMMR/TxHashSetManager.h>
+#include <TxPool/TransactionPool.h>
+#include <Core/Exceptions/DeserializationException.h>
+
+static EAddTransactionStatus AddToPool(const TestServer::Ptr& pTestServer, const ITransactionPool::Ptr& pTxPool, const TransactionPtr& pTransaction)
+{
+	auto pTipHeader = pTestServer->GetBlockChain()->GetTipBlockHeader(EChainType::CONFIRMED);
+	auto pBlockDB = pTestServer->GetDatabase()->GetBlockDB()->Read();
+	auto pTxHashSet = pTestServer->GetTxHashSetManager()->Read()->GetTxHashSet();
+
+	return pTxPool->AddTransaction(pBlockDB.GetShared(), pTxHashSet, pTransaction, EPoolType::MEMPOOL, *pTipHeader);
+}
+
+TEST_CASE("TransactionPool - Save and Load")
+{
+	TestServer::Ptr pTestServer = TestServer::Create();
+	TestMiner miner(pTestServer);
+	KeyChain keyChain = KeyChain::FromRandom(*pTestServer->GetConfig());
+	TxBuilder txBuilder(keyChain);
+
+	// Coinbase maturity for tests is only 25
+	std::vector<MinedBlock> minedChain = miner.MineChain(keyChain, 30);
+	REQUIRE(minedChain.size() == 30);
+
+	const uint64_t fee = 20'000'000;
+	TransactionOutput outputToSpend = minedChain[1].block.GetOutputs().front();
+	Test::Input input({
+		{ outputToSpend.GetFeatures(), outputToSpend.GetCommitment() },
+		minedChain[1].coinbasePath.value(),
+		minedChain[1].coinbaseAmount
+	});
+	Test::Output output({ KeyChainPath({ 1, 0 }), minedChain[1].coinbaseAmount - fee });
+	auto pTransaction = std::make_shared<Transaction>(txBuilder.BuildTx(fee, { input }, { output }));
+
+	// Save the tx from the test server's pool.
+	REQUIRE(AddToPool(pTestServer, pTestServer->GetTxPool(), pTransaction) == EAddTransactionStatus::ADDED);
+	const fs::path path = pTestServer->GetConfig()->GetNodeConfig().GetMemPoolPath();
+	REQUIRE(pTestServer->GetTxPool()->SaveTransactions(path, true) == 1);
+
+	// Reload it into a new pool.
+	auto saved = TxPoolAPI::LoadTransactions(path);
+	REQUIRE(saved.size() == 1);
+	REQUIRE(saved.front().first == EPoolType::MEMPOOL);
+	REQUIRE(saved.front().second->GetHash() == pTransaction->GetHash());
+
+	auto pReloadedPool = TxPoolAPI::CreateTransactionPool(*pTestServer->GetConfig());
+	REQUIRE(AddToPool(pTestServer, pReloadedPool, saved.front().second) == EAddTransactionStatus::ADDED);
+	REQUIRE(pReloadedPool->FindTransactionsByKernel({ pTransaction->GetKernels().front() }).size() == 1);
+
+	// A truncated file is rejected, rather than loading part of a tx.
+	std::vector<uint8_t> bytes;
+	REQUIRE(FileUtil::ReadFile(path, bytes));
+	bytes.resize(bytes.size() - 1);
+	FileUtil::SafeWriteToFile(path, bytes);
+	REQUIRE_THROWS_AS(TxPoolAPI::LoadTransactions(path), DeserializationException);
+
+	// Nothing saved yet.
+	FileUtil::RemoveFile(path);
+	REQUIRE(TxPoolAPI::LoadTransactions(path).empty());
+}
@@ -0,0 +1,79 @@
+#include <catch.hpp>
+
+#include <TestServer.h>
+#include <TxBuilder.h>
+
+#include <BlockChain/BlockChain.h>
+#include <Crypto/Crypto.h>
+
+//
+// Builds a tx spending a made up output of the given amount, which is enough for the context-free checks.
+//
+static Transaction BuildSpend(TxBuilder& txBuilder, const KeyChain& keyChain, const uint32_t index)
+{
+	const uint64_t amount = 1'000'000'000 + index;
+	const KeyChainPath inputPath({ 0, index });
+	const SecretKey inputBlind = keyChain.DerivePrivateKey(inputPath, amount);
+
+	Test::Input input({
+		{ EOutputFeatures::DEFAULT, Crypto::CommitBlinded(amount, BlindingFactor(inputBlind.GetBytes())) },
+		inputPath,
+		amount
+	});
+	Test::Output output({ KeyChainPath({ 1, index }), amount });
+
+	return txBuilder.BuildTx(0, { input }, { output });
+}
+
+TEST_CASE("VerifySelfConsistent - Batch")
+{
+	TestServer::Ptr pTestServer = TestServer::Create();
+	KeyChain keyChain = KeyChain::FromRandom(*pTestServer->GetConfig());
+	TxBuilder txBuilder(keyChain);
+	auto pBlockChain = pTestServer->GetBlockChain();
+
+	std::vector<Transaction> built;
+	for (uint32_t i = 0; i < 20; i++)
+	{
+		built.push_back(BuildSpend(txBuilder, keyChain, i));
+	}
+
+	// Tx 5 gets tx 6's rangeproof, and tx 12 gets tx 13's kernel signature. Neither changes the kernel sums.
+	const TransactionOutput& output5 = built[5].GetOutputs().front();
+	TransactionOutput badOutput(output5.GetFeatures(), output5.GetCommitment(), built[6].GetOutputs().front().GetRangeProof());
+	built[5] = Transaction(
+		BlindingFactor(built[5].GetOffset()),
+		TransactionBody(std::vector<TransactionInput>(built[5].GetInputs()), { badOutput }, std::vector<TransactionKernel>(built[5].GetKernels()))
+	);
+
+	const TransactionKernel& kernel12 = built[12].GetKernels().front();
+	TransactionKernel badKernel(
+		kernel12.GetFeatures(),
+		kernel12.GetFee(),
+		kernel12.GetLockHeight(),
+		kernel12.GetExcessCommitment(),
+		built[13].GetKernels().front().GetExcessSignature()
+	);
+	built[12] = Transaction(
+		BlindingFactor(built[12].GetOffset()),
+		TransactionBody(std::vector<TransactionInput>(built[12].GetInputs()), std::vector<TransactionOutput>(built[12].GetOutputs()), { badKernel })
+	);
+
+	std::vector<TransactionPtr> transactions;
+	for (const Transaction& transaction : built)
+	{
+		transactions.push_back(std::make_shared<Transaction>(transaction));
+	}
+
+	const std::vector<bool> valid = pBlockChain->VerifySelfConsistent(transactions);
+	REQUIRE(valid.size() == transactions.size());
+	for (size_t i = 0; i < transactions.size(); i++)
+	{
+		const bool expected = (i != 5 && i != 12);
+		REQUIRE(valid[i] == expected);
+		REQUIRE(transactions[i]->WasValidated() == expected);
+
+		// Matches validating each tx on its own.
+		REQUIRE(pBlockChain->VerifySelfConsistent(Transaction(*transactions[i])) == expected);
+	}
+}
@@ -30,4 +30,136 @@ TEST_CASE("DataFile")
     pDataFile->Commit();
 
     REQUIRE(pDataFile->GetSize() == 4);
-}
\ No newline at end of file
+}
+
+TEST_CASE("DataFile::GetDataRange")
+{
+    auto pFile = TestFileUtil::CreateTempFile();
+    auto pDataFile = DataFile<32>::Load(pFile->GetPath());
+
+    std::vector<CBigInteger<32>> values;
+    for (size_t i = 0; i < 4; i++)
+    {
+        values.push_back(CSPRNG::GenerateRandom32());
+        pDataFile->AddData(values.back());
+    }
+    pDataFile->Commit();
+
+    // Leave the last 2 entries in the unflushed buffer so the read spans both.
+    for (size_t i = 0; i < 2; i++)
+    {
+        values.push_back(CSPRNG::GenerateRandom32());
+        pDataFile->AddData(values.back());
+    }
+
+    std::vector<unsigned char> range = pDataFile->GetDataRange(2, 4);
+    REQUIRE(range.size() == 4 * 32);
+    for (size_t i = 0; i < 4; i++)
+    {
+        REQUIRE(CBigInteger<32>(range.data() + (i * 32)) == values[i + 2]);
+    }
+
+    REQUIRE_THROWS(pDataFile->GetDataRange(4, 3));
+}
+
+TEST_CASE("DataFile::ReadData")
+{
+    auto pFile = TestFileUtil::CreateTempFile();
+    auto pDataFile = DataFile<32>::Load(pFile->GetPath());
+
+    std::vector<CBigInteger<32>> values;
+    for (size_t i = 0; i < 3; i++)
+    {
+        values.push_back(CSPRNG::GenerateRandom32());
+        pDataFile->AddData(values.back());
+    }
+    pDataFile->Commit();
+
+    values.push_back(CSPRNG::GenerateRandom32());
+    pDataFile->AddData(values.back());
+
+    // Reuse one buffer for reads from the mapped file, the unflushed buffer, and across both.
+    std::vector<unsigned char> buffer(2 * 32);
+
+    pDataFile->ReadData(0, 2, buffer.data());
+    REQUIRE(CBigInteger<32>(buffer.data()) == values[0]);
+    REQUIRE(CBigInteger<32>(buffer.data() + 32) == values[1]);
+
+    pDataFile->ReadData(3, 1, buffer.data());
+    REQUIRE(CBigInteger<32>(buffer.data()) == values[3]);
+
+    pDataFile->ReadData(2, 2, buffer.data());
+    REQUIRE(CBigInteger<32>(buffer.data()) == values[2]);
+    REQUIRE(CBigInteger<32>(buffer.data() + 32) == values[3]);
+
+    REQUIRE_THROWS(pDataFile->ReadData(3, 2, buffer.data()));
+}
+
+TEST_CASE("DataFile::VisitData")
+{
+    auto pFile = TestFileUtil::CreateTempFile();
+    auto pDataFile = DataFile<32>::Load(pFile->GetPath());
+
+    std::vector<CBigInteger<32>> values;
+    for (size_t i = 0; i < 3; i++)
+    {
+        values.push_back(CSPRNG::GenerateRandom32());
+        pDataFile->AddData(values.back());
+    }
+    pDataFile->Commit();
+
+    values.push_back(CSPRNG::GenerateRandom32());
+    pDataFile->AddData(values.back());
+
+    auto visitRange = [&pDataFile](const uint64_t position, const uint64_t numItems) {
+        std::vector<CBigInteger<32>> visited;
+        pDataFile->VisitData(position, numItems, [numItems, &visited](const unsigned char* pData) {
+            for (size_t i = 0; i < numItems; i++)
+            {
+                visited.push_back(CBigInteger<32>(pData + (i * 32)));
+            }
+        });
+        return visited;
+    };
+
+    // Mapped file only, buffer only, and spanning both.
+    REQUIRE(visitRange(0, 2) == std::vector<CBigInteger<32>>(values.begin(), values.begin() + 2));
+    REQUIRE(visitRange(3, 1) == std::vector<CBigInteger<32>>(values.begin() + 3, values.end()));
+    REQUIRE(visitRange(1, 3) == std::vector<CBigInteger<32>>(values.begin() + 1, values.end()));
+
+    REQUIRE_THROWS(pDataFile->VisitData(2, 3, [](const unsigned char*) {}));
+}
+
+TEST_CASE("DataFile::Reload")
+{
+    auto pFile = TestFileUtil::CreateTempFile();
+
+    std::vector<CBigInteger<32>> values;
+    {
+        auto pDataFile = DataFile<32>::Load(pFile->GetPath());
+        pDataFile->SetAccessHint(EFileAccess::SEQUENTIAL);
+        for (size_t i = 0; i < 5; i++)
+        {
+            values.push_back(CSPRNG::GenerateRandom32());
+            pDataFile->AddData(values.back());
+        }
+        pDataFile->Commit();
+
+        // Shrinking and growing in the same commit.
+        pDataFile->Rewind(3);
+        values.resize(3);
+        values.push_back(CSPRNG::GenerateRandom32());
+        pDataFile->AddData(values.back());
+        pDataFile->Commit();
+    }
+
+    // Space reserved past the end of the file isn't part of its size.
+    REQUIRE(FileUtil::GetFileSize(pFile->GetPath()) == 4 * 32);
+
+    auto pDataFile = DataFile<32>::Load(pFile->GetPath());
+    REQUIRE(pDataFile->GetSize() == 4);
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        REQUIRE(pDataFile->GetDataAt(i) == values[i].GetData());
+    }
+}
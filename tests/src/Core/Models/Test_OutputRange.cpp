@@ -0,0 +1,49 @@
+#include <catch.hpp>
+
+#include <Core/Models/DTOs/OutputRange.h>
+#include <Crypto/CSPRNG.h>
+
+TEST_CASE("OutputRange::Serialize")
+{
+	std::vector<OutputDTO> outputs;
+	for (uint64_t i = 0; i < 3; i++)
+	{
+		SecureVector proofBytes = CSPRNG::GenerateRandomBytes(675);
+		outputs.push_back(OutputDTO(
+			i == 1,
+			OutputIdentifier(i == 0 ? EOutputFeatures::COINBASE_OUTPUT : EOutputFeatures::DEFAULT, Commitment(CSPRNG::GenerateRandomBytes(33).data())),
+			OutputLocation(i * 3, 100 + i),
+			RangeProof(std::vector<unsigned char>(proofBytes.begin(), proofBytes.end()))
+		));
+	}
+
+	const OutputRange range(500, 7, std::vector<OutputDTO>(outputs));
+
+	Serializer serializer;
+	range.Serialize(serializer);
+
+	ByteBuffer byteBuffer(serializer.GetBytes());
+	const OutputRange deserialized = OutputRange::Deserialize(byteBuffer);
+	REQUIRE(byteBuffer.GetRemainingSize() == 0);
+	REQUIRE(deserialized.GetHighestIndex() == 500);
+	REQUIRE(deserialized.GetLastRetrievedIndex() == 7);
+	REQUIRE(deserialized.GetOutputs().size() == outputs.size());
+
+	for (size_t i = 0; i < outputs.size(); i++)
+	{
+		const OutputDTO& expected = outputs[i];
+		const OutputDTO& actual = deserialized.GetOutputs()[i];
+		REQUIRE(actual.IsSpent() == expected.IsSpent());
+		REQUIRE(actual.GetIdentifier().GetFeatures() == expected.GetIdentifier().GetFeatures());
+		REQUIRE(actual.GetIdentifier().GetCommitment() == expected.GetIdentifier().GetCommitment());
+		REQUIRE(actual.GetLocation().GetMMRIndex() == expected.GetLocation().GetMMRIndex());
+		REQUIRE(actual.GetLocation().GetBlockHeight() == expected.GetLocation().GetBlockHeight());
+		REQUIRE(actual.GetRangeProof() == expected.GetRangeProof());
+	}
+
+	// Serialized lengths are checked, so a truncated range fails instead of reading past the end.
+	std::vector<unsigned char> truncated = serializer.GetBytes();
+	truncated.resize(truncated.size() - 1);
+	ByteBuffer truncatedBuffer(std::move(truncated));
+	REQUIRE_THROWS(OutputRange::Deserialize(truncatedBuffer));
+}
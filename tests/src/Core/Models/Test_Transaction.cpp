@@ -0,0 +1,45 @@
+#include <catch.hpp>
+
+#include <Config/Genesis.h>
+#include <Core/Models/Transaction.h>
+#include <Crypto/Hasher.h>
+
+TEST_CASE("Transaction::GetHash")
+{
+	const FullBlock& genesis = Genesis::MAINNET_GENESIS;
+	const Transaction transaction(BlindingFactor(ZERO_HASH), TransactionBody(genesis.GetTransactionBody()));
+
+	Serializer serializer;
+	transaction.Serialize(serializer);
+	const Hash expectedHash = Hasher::Blake2b(serializer.GetBytes());
+
+	// Copies taken before and after the hash is calculated must both end up with the same hash.
+	const Transaction copiedBeforeHashing(transaction);
+	REQUIRE(transaction.GetHash() == expectedHash);
+
+	const Transaction copiedAfterHashing(transaction);
+	REQUIRE(copiedBeforeHashing.GetHash() == expectedHash);
+	REQUIRE(copiedAfterHashing.GetHash() == expectedHash);
+
+	Transaction temporary(transaction);
+	Transaction moved(std::move(temporary));
+	REQUIRE(moved.GetHash() == expectedHash);
+
+	Transaction assigned;
+	assigned = copiedAfterHashing;
+	REQUIRE(assigned.GetHash() == expectedHash);
+}
+
+TEST_CASE("TransactionInput hash matches the output it spends")
+{
+	const TransactionOutput& output = Genesis::MAINNET_GENESIS.GetOutputs().front();
+	const TransactionInput input(output.GetFeatures(), output.GetCommitment());
+
+	Serializer serializer;
+	input.Serialize(serializer);
+	REQUIRE(input.GetHash() == Hasher::Blake2b(serializer.GetBytes()));
+	REQUIRE(input.GetHash() == output.GetHash());
+
+	const TransactionInput copy(input);
+	REQUIRE(copy.GetHash() == input.GetHash());
+}
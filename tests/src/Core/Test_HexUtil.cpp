@@ -0,0 +1,74 @@
+#include <catch.hpp>
+
+#include <Common/Util/HexUtil.h>
+#include <Crypto/RangeProof.h>
+#include <random>
+
+static std::vector<uint8_t> RandomBytes(std::mt19937& random, const size_t numBytes)
+{
+	std::vector<uint8_t> bytes(numBytes);
+	for (uint8_t& byte : bytes)
+	{
+		byte = (uint8_t)random();
+	}
+
+	return bytes;
+}
+
+TEST_CASE("HexUtil")
+{
+	REQUIRE(HexUtil::ConvertToHex({ 0x00, 0x09, 0x0a, 0x7f, 0x80, 0xff }) == "00090a7f80ff");
+	REQUIRE(HexUtil::FromHex(" 0x00090A7f80FF\n") == std::vector<uint8_t>({ 0x00, 0x09, 0x0a, 0x7f, 0x80, 0xff }));
+	REQUIRE(HexUtil::FromHex("").empty());
+
+	// Every length up to a few vectors, so each codec's tail is covered.
+	std::mt19937 random(1);
+	for (size_t numBytes = 0; numBytes <= 130; numBytes++)
+	{
+		const std::vector<uint8_t> bytes = RandomBytes(random, numBytes);
+		const std::string hex = HexUtil::ConvertToHex(bytes);
+		REQUIRE(hex.size() == numBytes * 2);
+		REQUIRE(hex.find_first_not_of("0123456789abcdef") == std::string::npos);
+		REQUIRE(HexUtil::FromHex(hex) == bytes);
+
+		if (numBytes > 0)
+		{
+			// Odd lengths.
+			REQUIRE_THROWS(HexUtil::FromHex(hex.substr(1)));
+
+			// Invalid characters, including ones next to the digit and letter ranges and ones above 0x7f.
+			for (const char invalid : { '/', ':', '@', 'G', '`', 'g', 'x', (char)0x80, (char)0xb0 })
+			{
+				std::string bad = hex;
+				bad[random() % bad.size()] = invalid;
+				REQUIRE_THROWS(HexUtil::FromHex(bad));
+			}
+		}
+	}
+}
+
+//
+// Run with "[.benchmark]" to time encoding and decoding rangeproofs, the largest values the APIs hex encode.
+//
+TEST_CASE("HexUtil - Benchmark", "[.benchmark]")
+{
+	std::mt19937 random(1);
+	const std::vector<uint8_t> proof = RandomBytes(random, MAX_PROOF_SIZE);
+	const std::string hex = HexUtil::ConvertToHex(proof);
+
+	BENCHMARK("Encode 1000 rangeproofs")
+	{
+		for (size_t i = 0; i < 1000; i++)
+		{
+			HexUtil::ConvertToHex(proof);
+		}
+	}
+
+	BENCHMARK("Decode 1000 rangeproofs")
+	{
+		for (size_t i = 0; i < 1000; i++)
+		{
+			HexUtil::FromHex(hex);
+		}
+	}
+}
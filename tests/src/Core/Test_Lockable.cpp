@@ -0,0 +1,97 @@
+#include <catch.hpp>
+
+#include <Core/Traits/Lockable.h>
+
+class TestBatchable : public Traits::IBatchable
+{
+public:
+	void Commit() final { ++numCommits; }
+	void Rollback() noexcept final { ++numRollbacks; }
+
+	int value = 0;
+	int numCommits = 0;
+	int numRollbacks = 0;
+};
+
+TEST_CASE("Scoped writers commit or roll back like Writer")
+{
+	auto pObject = std::make_shared<TestBatchable>();
+	Locked<TestBatchable> locked(pObject);
+
+	{
+		auto pWriter = locked.ScopedWrite();
+		pWriter->value = 1;
+	}
+
+	REQUIRE(pObject->numCommits == 1);
+	REQUIRE(pObject->numRollbacks == 0);
+
+	{
+		auto pBatch = locked.ScopedBatchWrite();
+		pBatch->value = 2;
+	}
+
+	REQUIRE(pObject->numCommits == 1);
+	REQUIRE(pObject->numRollbacks == 1);
+
+	{
+		auto pBatch = locked.ScopedBatchWrite();
+		pBatch->Commit();
+		pBatch->SetDirty(false);
+	}
+
+	REQUIRE(pObject->numCommits == 2);
+	REQUIRE(pObject->numRollbacks == 1);
+	REQUIRE(locked.ScopedRead()->value == 2);
+}
+
+TEST_CASE("Moved scoped handles unlock once")
+{
+	Locked<int> locked(std::make_shared<int>(5));
+
+	{
+		auto pReader = locked.ScopedRead();
+		auto pMoved = std::move(pReader);
+		REQUIRE(*pMoved == 5);
+	}
+
+	*locked.ScopedWrite() = 6;
+	REQUIRE(*locked.Read() == 6);
+}
+
+TEST_CASE("Locked counts every acquisition in its wait histogram")
+{
+	Locked<int> locked(std::make_shared<int>(0));
+
+	locked.ScopedRead();
+	locked.Read();
+	locked.ScopedWrite();
+	locked.Write();
+
+	const LockWaitHistogram histogram = locked.GetWaitHistogram();
+	REQUIRE(histogram.numReads == 2);
+	REQUIRE(histogram.numWrites == 2);
+	REQUIRE(histogram.numContended == 0);
+	REQUIRE(histogram.buckets[0] == 4);
+}
+
+static void ReadTwice(const Locked<int>& locked)
+{
+	locked.Read();
+	locked.ScopedRead();
+}
+
+TEST_CASE("LockProfiler records each call site")
+{
+	Locked<int> locked(std::make_shared<int>(0));
+	locked.SetProfiler(std::make_shared<LockProfiler>("Test", std::chrono::seconds(0)));
+
+	ReadTwice(locked);
+
+	const std::vector<LockSiteStats> sites = locked.GetProfiler()->GetSiteStats();
+	REQUIRE(sites.size() == 1);
+	REQUIRE(sites[0].callSite == "ReadTwice");
+	REQUIRE(sites[0].numReads == 2);
+	REQUIRE(sites[0].numWrites == 0);
+	REQUIRE(sites[0].maxWaitersAhead == 0);
+}
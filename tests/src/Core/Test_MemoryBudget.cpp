@@ -0,0 +1,48 @@
+#include <catch.hpp>
+
+#include <Common/MemoryBudget.h>
+#include <atomic>
+
+TEST_CASE("MemoryBudget - Apportioned by priority")
+{
+	std::atomic<size_t> largeLimit = 0;
+	std::atomic<size_t> smallLimit = 0;
+
+	MemoryBudgetRegistration::UPtr pLarge = MemoryBudgetAPI::Register(MemoryConsumer{
+		"test_large", 3, 0,
+		[] { return (size_t)100; },
+		[&largeLimit](const size_t limitBytes) { largeLimit = limitBytes; }
+	});
+
+	// Unmanaged until there's a budget.
+	REQUIRE(largeLimit == 0);
+
+	MemoryBudgetAPI::SetBudget(1000);
+	REQUIRE(largeLimit == 1000);
+
+	MemoryBudgetRegistration::UPtr pSmall = MemoryBudgetAPI::Register(MemoryConsumer{
+		"test_small", 1, 400,
+		[] { return (size_t)50; },
+		[&smallLimit](const size_t limitBytes) { smallLimit = limitBytes; }
+	});
+
+	// The small consumer's share (250) is below its minimum.
+	REQUIRE(largeLimit == 750);
+	REQUIRE(smallLimit == 400);
+
+	MemoryBudgetAPI::SetBudget(4000);
+	REQUIRE(largeLimit == 3000);
+	REQUIRE(smallLimit == 1000);
+
+	const std::vector<MemoryConsumerStats> stats = MemoryBudgetAPI::GetStats();
+	REQUIRE(stats.size() == 2);
+	REQUIRE(stats[0].name == "test_large");
+	REQUIRE(stats[0].limitBytes == 3000);
+	REQUIRE(stats[0].usageBytes == 100);
+	REQUIRE(stats[1].usageBytes == 50);
+
+	pSmall.reset();
+	pLarge.reset();
+	MemoryBudgetAPI::SetBudget(0);
+	REQUIRE(MemoryBudgetAPI::GetStats().empty());
+}
@@ -0,0 +1,50 @@
+#include <catch.hpp>
+
+#include <Core/Serialization/Serializer.h>
+#include <Core/Serialization/ByteBuffer.h>
+
+TEST_CASE("Serializer writes integers big endian")
+{
+	Serializer serializer;
+	serializer.Append<uint8_t>(0x01);
+	serializer.Append<uint16_t>(0x0203);
+	serializer.Append<uint32_t>(0x04050607);
+	serializer.Append<uint64_t>(0x08090A0B0C0D0E0Full);
+
+	const std::vector<uint8_t> expected({ 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F });
+	REQUIRE(serializer.GetBytes() == expected);
+
+	ByteBuffer byteBuffer(serializer.GetBytes());
+	REQUIRE(byteBuffer.ReadU8() == 0x01);
+	REQUIRE(byteBuffer.ReadU16() == 0x0203);
+	REQUIRE(byteBuffer.ReadU32() == 0x04050607);
+	REQUIRE(byteBuffer.ReadU64() == 0x08090A0B0C0D0E0Full);
+	REQUIRE_THROWS_AS(byteBuffer.ReadU8(), DeserializationException);
+}
+
+TEST_CASE("Serializer writes little endian and signed integers")
+{
+	Serializer serializer;
+	serializer.AppendLittleEndian<uint64_t>(0x0102030405060708ull);
+	serializer.Append<int64_t>(-2);
+	serializer.Append<int32_t>(-3);
+
+	ByteBuffer byteBuffer(serializer.GetBytes());
+	REQUIRE(byteBuffer.ReadVector(8) == std::vector<uint8_t>({ 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01 }));
+	REQUIRE(byteBuffer.Read64() == -2);
+	REQUIRE(byteBuffer.Read32() == -3);
+
+	ByteBuffer leBuffer(serializer.GetBytes());
+	REQUIRE(leBuffer.ReadU64_LE() == 0x0102030405060708ull);
+}
+
+TEST_CASE("ByteBuffer reads big integers in place")
+{
+	const CBigInteger<32> value = CBigInteger<32>::FromHex("0102030405060708091011121314151617181920212223242526272829303132");
+
+	Serializer serializer;
+	serializer.AppendBigInteger<32>(value);
+
+	ByteBuffer byteBuffer(serializer.data(), serializer.size());
+	REQUIRE(byteBuffer.ReadBigInteger<32>() == value);
+}
@@ -0,0 +1,73 @@
+#include <catch.hpp>
+
+#include <Common/ShardedCache.h>
+
+TEST_CASE("ShardedCache - Get and Put")
+{
+	ShardedCache<uint64_t, uint64_t> cache(1024);
+	REQUIRE(!cache.Get(1).has_value());
+
+	cache.Put(1, 100);
+	REQUIRE(cache.Get(1) == std::make_optional<uint64_t>(100));
+
+	cache.Put(1, 200);
+	REQUIRE(cache.Get(1) == std::make_optional<uint64_t>(200));
+	REQUIRE(cache.Size() == 1);
+
+	const CacheStats stats = cache.GetStats();
+	REQUIRE(stats.hits == 2);
+	REQUIRE(stats.misses == 1);
+	REQUIRE(stats.capacity == 1024);
+}
+
+TEST_CASE("ShardedCache - Capacity")
+{
+	ShardedCache<uint64_t, uint64_t> cache(1024);
+	for (uint64_t i = 0; i < 10'000; i++)
+	{
+		cache.Put(i, i);
+	}
+
+	REQUIRE(cache.Size() <= 1024);
+
+	// The most recently added entries are still in the window.
+	REQUIRE(cache.Get(9'999) == std::make_optional<uint64_t>(9'999));
+
+	cache.SetCapacity(256);
+	REQUIRE(cache.Size() <= 256);
+	REQUIRE(cache.GetCapacity() == 256);
+}
+
+TEST_CASE("ShardedCache - Scan Resistance")
+{
+	ShardedCache<uint64_t, uint64_t> cache(1024);
+
+	// Hot entries, used over and over.
+	for (int round = 0; round < 5; round++)
+	{
+		for (uint64_t i = 0; i < 256; i++)
+		{
+			if (!cache.Get(i).has_value())
+			{
+				cache.Put(i, i);
+			}
+		}
+	}
+
+	// A scan of many entries that are each only read once.
+	for (uint64_t i = 1'000'000; i < 1'020'000; i++)
+	{
+		if (!cache.Get(i).has_value())
+		{
+			cache.Put(i, i);
+		}
+	}
+
+	size_t numHot = 0;
+	for (uint64_t i = 0; i < 256; i++)
+	{
+		numHot += cache.Get(i).has_value() ? 1 : 0;
+	}
+
+	REQUIRE(numHot >= 240);
+}
@@ -0,0 +1,65 @@
+#include <catch.hpp>
+
+#include <Common/ThreadManager.h>
+#include <Common/Util/ThreadUtil.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+TEST_CASE("ThreadManager - CPU and wait accounting")
+{
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool measured = false;
+	std::atomic_bool named = false;
+	std::atomic_bool terminate = false;
+
+	std::thread thread([&] {
+		ThreadManagerAPI::SetCurrentThreadName("TEST_ACCOUNTING");
+
+		// Burn some CPU, then sleep.
+		volatile uint64_t sum = 0;
+		const auto busyUntil = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+		while (std::chrono::steady_clock::now() < busyUntil)
+		{
+			sum = sum + 1;
+		}
+
+		ThreadUtil::SleepFor(std::chrono::milliseconds(50), terminate);
+
+		ThreadActivity activity("testing");
+		named = true;
+
+		std::unique_lock<std::mutex> lock(mutex);
+		cv.wait(lock, [&measured] { return measured; });
+	});
+
+	while (!named)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	const std::vector<ThreadStats> threads = ThreadManagerAPI::GetThreadStats();
+	auto iter = std::find_if(threads.cbegin(), threads.cend(), [](const ThreadStats& stats) { return stats.name == "TEST_ACCOUNTING"; });
+	REQUIRE(iter != threads.cend());
+	REQUIRE(iter->activity == "testing");
+	REQUIRE(iter->cpuMicros >= 10'000);
+	REQUIRE(iter->waitMicros >= 50'000);
+	REQUIRE(iter->wallMicros >= iter->waitMicros);
+
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		measured = true;
+	}
+	cv.notify_all();
+	thread.join();
+
+	// Exited threads still count towards their name's totals.
+	const std::vector<ThreadGroupStats> groups = ThreadManagerAPI::GetThreadGroupStats();
+	auto groupIter = std::find_if(groups.cbegin(), groups.cend(), [](const ThreadGroupStats& stats) { return stats.name == "TEST_ACCOUNTING"; });
+	REQUIRE(groupIter != groups.cend());
+	REQUIRE(groupIter->numThreads == 0);
+	REQUIRE(groupIter->cpuMicros >= 10'000);
+	REQUIRE(groupIter->waitMicros >= 50'000);
+}
@@ -0,0 +1,106 @@
+#include <catch.hpp>
+
+#include <Config/Genesis.h>
+#include <Core/Util/TransactionUtil.h>
+#include <Crypto/CSPRNG.h>
+
+static Commitment RandomCommitment()
+{
+	std::vector<unsigned char> bytes = CSPRNG::GenerateRandom32().GetData();
+	bytes.insert(bytes.begin(), 0x08);
+	return Commitment(CBigInteger<33>(std::move(bytes)));
+}
+
+//
+// Builds a tx with made up (but distinct) sorted inputs, outputs and kernels. Only hashes and commitments matter for aggregation.
+//
+static TransactionPtr BuildTx(const std::vector<Commitment>& spent, const std::vector<Commitment>& created, const uint64_t fee)
+{
+	const TransactionOutput& genesisOutput = Genesis::MAINNET_GENESIS.GetOutputs().front();
+	const TransactionKernel& genesisKernel = Genesis::MAINNET_GENESIS.GetKernels().front();
+
+	std::vector<TransactionInput> inputs;
+	for (const Commitment& commitment : spent)
+	{
+		inputs.push_back(TransactionInput(EOutputFeatures::DEFAULT, commitment));
+	}
+
+	std::vector<TransactionOutput> outputs;
+	for (const Commitment& commitment : created)
+	{
+		outputs.push_back(TransactionOutput(EOutputFeatures::DEFAULT, commitment, genesisOutput.GetRangeProof()));
+	}
+
+	std::vector<TransactionKernel> kernels;
+	for (uint64_t i = 0; i < 2; i++)
+	{
+		kernels.push_back(TransactionKernel(
+			EKernelFeatures::DEFAULT_KERNEL,
+			fee + i,
+			0,
+			RandomCommitment(),
+			genesisKernel.GetExcessSignature()
+		));
+	}
+
+	std::sort(inputs.begin(), inputs.end(), SortInputsByHash);
+	std::sort(outputs.begin(), outputs.end(), SortOutputsByHash);
+	std::sort(kernels.begin(), kernels.end(), SortKernelsByHash);
+
+	return std::make_shared<Transaction>(
+		BlindingFactor(CSPRNG::GenerateRandom32()),
+		TransactionBody(std::move(inputs), std::move(outputs), std::move(kernels))
+	);
+}
+
+TEST_CASE("TransactionUtil::Aggregate")
+{
+	std::vector<Commitment> commitments;
+	for (size_t i = 0; i < 12; i++)
+	{
+		commitments.push_back(RandomCommitment());
+	}
+
+	// Tx 1 spends tx 0's 2nd output, and tx 2 spends tx 1's 1st output.
+	std::vector<TransactionPtr> transactions = {
+		BuildTx({ commitments[0], commitments[1] }, { commitments[2], commitments[3], commitments[4] }, 1),
+		BuildTx({ commitments[3], commitments[5] }, { commitments[6], commitments[7] }, 10),
+		BuildTx({ commitments[6] }, { commitments[8] }, 20),
+		BuildTx({ commitments[9], commitments[10] }, { commitments[11] }, 30)
+	};
+
+	// Same as concatenating, cutting through and sorting.
+	std::vector<TransactionInput> expectedInputs;
+	std::vector<TransactionOutput> expectedOutputs;
+	std::vector<TransactionKernel> expectedKernels;
+	for (const TransactionPtr& pTransaction : transactions)
+	{
+		expectedInputs.insert(expectedInputs.end(), pTransaction->GetInputs().cbegin(), pTransaction->GetInputs().cend());
+		expectedOutputs.insert(expectedOutputs.end(), pTransaction->GetOutputs().cbegin(), pTransaction->GetOutputs().cend());
+		expectedKernels.insert(expectedKernels.end(), pTransaction->GetKernels().cbegin(), pTransaction->GetKernels().cend());
+	}
+
+	TransactionUtil::PerformCutThrough(expectedInputs, expectedOutputs);
+	std::sort(expectedInputs.begin(), expectedInputs.end(), SortInputsByHash);
+	std::sort(expectedOutputs.begin(), expectedOutputs.end(), SortOutputsByHash);
+	std::sort(expectedKernels.begin(), expectedKernels.end(), SortKernelsByHash);
+
+	TransactionPtr pAggregate = TransactionUtil::Aggregate(transactions);
+	REQUIRE(pAggregate->GetInputs().size() == 5);
+	REQUIRE(pAggregate->GetOutputs().size() == 5);
+	REQUIRE(pAggregate->GetInputs() == expectedInputs);
+	REQUIRE(pAggregate->GetOutputs() == expectedOutputs);
+	REQUIRE(pAggregate->GetKernels() == expectedKernels);
+
+	// Unsorted bodies still aggregate to a sorted tx.
+	std::vector<TransactionInput> reversedInputs(transactions[0]->GetInputs().crbegin(), transactions[0]->GetInputs().crend());
+	transactions[0] = std::make_shared<Transaction>(
+		BlindingFactor(transactions[0]->GetOffset()),
+		TransactionBody(std::move(reversedInputs), std::vector<TransactionOutput>(transactions[0]->GetOutputs()), std::vector<TransactionKernel>(transactions[0]->GetKernels()))
+	);
+
+	pAggregate = TransactionUtil::Aggregate(transactions);
+	REQUIRE(pAggregate->GetInputs() == expectedInputs);
+	REQUIRE(pAggregate->GetOutputs() == expectedOutputs);
+	REQUIRE(pAggregate->GetKernels() == expectedKernels);
+}
@@ -0,0 +1,65 @@
+#include <catch.hpp>
+
+#include <Core/Validation/CutThroughVerifier.h>
+#include <algorithm>
+
+static Commitment CreateCommitment(const uint8_t value)
+{
+	std::vector<uint8_t> bytes(33, 0);
+	bytes[0] = 0x08;
+	bytes[32] = value;
+	return Commitment(CBigInteger<33>(std::move(bytes)));
+}
+
+static TransactionInput CreateInput(const uint8_t value)
+{
+	return TransactionInput(EOutputFeatures::DEFAULT, CreateCommitment(value));
+}
+
+static TransactionOutput CreateOutput(const uint8_t value)
+{
+	return TransactionOutput(EOutputFeatures::DEFAULT, CreateCommitment(value), RangeProof(std::vector<uint8_t>(675, 0)));
+}
+
+template<class T>
+static std::vector<T> Sorted(std::vector<T> values)
+{
+	std::sort(values.begin(), values.end(), [](const T& a, const T& b) { return a.GetHash() < b.GetHash(); });
+	return values;
+}
+
+TEST_CASE("CutThroughVerifier accepts sorted, distinct inputs and outputs")
+{
+	const std::vector<TransactionInput> inputs = Sorted<TransactionInput>({ CreateInput(1), CreateInput(2), CreateInput(3) });
+	const std::vector<TransactionOutput> outputs = Sorted<TransactionOutput>({ CreateOutput(4), CreateOutput(5) });
+
+	REQUIRE(CutThroughVerifier::Verify(inputs, outputs) == CutThroughVerifier::EResult::VALID);
+	REQUIRE(CutThroughVerifier::Verify({}, outputs) == CutThroughVerifier::EResult::VALID);
+	REQUIRE(CutThroughVerifier::Verify(inputs, {}) == CutThroughVerifier::EResult::VALID);
+}
+
+TEST_CASE("CutThroughVerifier rejects an input spending an output of the same body")
+{
+	const std::vector<TransactionInput> inputs = Sorted<TransactionInput>({ CreateInput(1), CreateInput(2), CreateInput(3) });
+	const std::vector<TransactionOutput> outputs = Sorted<TransactionOutput>({ CreateOutput(2), CreateOutput(5) });
+
+	REQUIRE(CutThroughVerifier::Verify(inputs, outputs) == CutThroughVerifier::EResult::CUT_THROUGH);
+}
+
+TEST_CASE("CutThroughVerifier rejects unsorted and duplicated inputs and outputs")
+{
+	std::vector<TransactionInput> inputs = Sorted<TransactionInput>({ CreateInput(1), CreateInput(2), CreateInput(3) });
+	std::reverse(inputs.begin(), inputs.end());
+	REQUIRE(CutThroughVerifier::Verify(inputs, {}) == CutThroughVerifier::EResult::NOT_SORTED);
+
+	const std::vector<TransactionOutput> outputs = Sorted<TransactionOutput>({ CreateOutput(4), CreateOutput(4), CreateOutput(5) });
+	REQUIRE(CutThroughVerifier::Verify({}, outputs) == CutThroughVerifier::EResult::DUPLICATE);
+}
+
+TEST_CASE("CutThroughVerifier rejects an input spending an output of the same body with different features")
+{
+	const std::vector<TransactionInput> inputs = Sorted<TransactionInput>({ CreateInput(1), TransactionInput(EOutputFeatures::COINBASE_OUTPUT, CreateCommitment(2)) });
+	const std::vector<TransactionOutput> outputs = Sorted<TransactionOutput>({ CreateOutput(2), CreateOutput(5) });
+
+	REQUIRE(CutThroughVerifier::Verify(inputs, outputs) == CutThroughVerifier::EResult::CUT_THROUGH);
+}
@@ -0,0 +1,29 @@
+#include <catch.hpp>
+
+#include <Crypto/Hasher.h>
+#include <Crypto/CSPRNG.h>
+
+TEST_CASE("Blake2bBatch matches Blake2b")
+{
+	// Lengths around the 128 byte block size, with runs long enough to fill every lane and leave some over.
+	const std::vector<size_t> lengths = { 0, 1, 34, 72, 127, 128, 129, 256, 675, 700 };
+
+	std::vector<std::vector<uint8_t>> inputs;
+	for (size_t i = 0; i < 11; i++)
+	{
+		for (const size_t length : lengths)
+		{
+			const SecureVector input = CSPRNG::GenerateRandomBytes(length);
+			inputs.push_back(std::vector<uint8_t>(input.cbegin(), input.cend()));
+		}
+	}
+
+	const std::vector<Hash> hashes = Hasher::Blake2bBatch(inputs);
+	REQUIRE(hashes.size() == inputs.size());
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		REQUIRE(hashes[i] == Hasher::Blake2b(inputs[i]));
+	}
+
+	REQUIRE(Hasher::Blake2bBatch(std::vector<std::vector<uint8_t>>{}).empty());
+}
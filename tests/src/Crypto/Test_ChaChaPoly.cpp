@@ -14,4 +14,30 @@ TEST_CASE("ChaChaPoly - Stream Encryption")
 	std::vector<uint8_t> decrypted = ChaChaPoly::Init(encryption_key).StreamDecrypt(encrypted);
 
 	REQUIRE(vec == decrypted);
-}
\ No newline at end of file
+}
+
+TEST_CASE("ChaChaPoly - Stream Encryption Multiple Chunks")
+{
+	const SecretKey encryption_key = CSPRNG::GenerateRandom32();
+
+	// 2 full 64KB chunks and a partial one.
+	SecureVector random_data = CSPRNG::GenerateRandomBytes((2 * 64 * 1024) + 500);
+	std::vector<uint8_t> vec(random_data.cbegin(), random_data.cend());
+
+	std::vector<uint8_t> encrypted = ChaChaPoly::Init(encryption_key).StreamEncrypt(vec);
+	REQUIRE(encrypted.size() == vec.size() + (3 * 16));
+
+	// Encrypting onto the end of an existing buffer leaves what's already there.
+	std::vector<uint8_t> appended{ 1, 2, 3 };
+	ChaChaPoly::Init(encryption_key).StreamEncrypt(vec.data(), vec.size(), appended);
+	REQUIRE(appended.size() == encrypted.size() + 3);
+
+	std::vector<uint8_t> decrypted = ChaChaPoly::Init(encryption_key).StreamDecrypt(appended.data() + 3, appended.size() - 3);
+	REQUIRE(vec == decrypted);
+
+	// Any chunk being modified or dropped fails the whole payload.
+	encrypted[64 * 1024 + 20]++;
+	REQUIRE_THROWS(ChaChaPoly::Init(encryption_key).StreamDecrypt(encrypted));
+	encrypted[64 * 1024 + 20]--;
+	REQUIRE_THROWS(ChaChaPoly::Init(encryption_key).StreamDecrypt(encrypted.data(), 2 * (64 * 1024 + 16)));
+}
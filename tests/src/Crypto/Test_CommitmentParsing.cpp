@@ -0,0 +1,71 @@
+#include <catch.hpp>
+
+#include <Crypto/Crypto.h>
+#include <Crypto/CSPRNG.h>
+
+static std::vector<Commitment> RandomCommitments(const size_t count)
+{
+	std::vector<Commitment> commitments;
+	for (size_t i = 0; i < count; i++)
+	{
+		commitments.push_back(Crypto::CommitBlinded(i, CSPRNG::GenerateRandom32() / 2));
+	}
+
+	return commitments;
+}
+
+TEST_CASE("Crypto::AddCommitments - Commitment cache")
+{
+	const std::vector<Commitment> positive = RandomCommitments(100);
+	const std::vector<Commitment> negative = RandomCommitments(3);
+
+	Crypto::SetCommitmentCacheCapacity(0);
+	const Commitment uncached = Crypto::AddCommitments(positive, negative);
+
+	Crypto::SetCommitmentCacheCapacity(1000);
+	const CacheStats before = Crypto::GetCommitmentCacheStats();
+	REQUIRE(Crypto::AddCommitments(positive, negative) == uncached);
+	REQUIRE(Crypto::AddCommitments(positive, negative) == uncached);
+
+	const CacheStats after = Crypto::GetCommitmentCacheStats();
+	REQUIRE(after.misses - before.misses == 103);
+	REQUIRE(after.hits - before.hits == 103);
+	REQUIRE(after.size == 103);
+
+	// Single commitments are parsed inline, without any allocation.
+	REQUIRE(Crypto::AddCommitments({ positive[0] }, {}) == positive[0]);
+
+	Crypto::SetCommitmentCacheCapacity(0);
+	REQUIRE(Crypto::GetCommitmentCacheStats().size == 0);
+}
+
+//
+// Run with "[.benchmark]" to compare summing the same commitments with and without the parsed commitment cache.
+//
+TEST_CASE("Crypto::AddCommitments - Benchmark", "[.benchmark]")
+{
+	const std::vector<Commitment> commitments = RandomCommitments(1000);
+
+	Crypto::SetCommitmentCacheCapacity(0);
+	BENCHMARK("Sum 1000 commitments, uncached")
+	{
+		Crypto::AddCommitments(commitments, {});
+	}
+
+	Crypto::SetCommitmentCacheCapacity(10'000);
+	Crypto::AddCommitments(commitments, {});
+	BENCHMARK("Sum 1000 commitments, cached")
+	{
+		Crypto::AddCommitments(commitments, {});
+	}
+
+	BENCHMARK("Sum 2 commitments, 1000 times")
+	{
+		for (size_t i = 0; i + 1 < commitments.size(); i += 2)
+		{
+			Crypto::AddCommitments({ commitments[i] }, { commitments[i + 1] });
+		}
+	}
+
+	Crypto::SetCommitmentCacheCapacity(10'000);
+}
@@ -0,0 +1,101 @@
+#include <catch.hpp>
+
+#include <TestHelper.h>
+
+#include <Database/Database.h>
+#include <Database/BlockDb.h>
+#include <Config/Config.h>
+#include <Core/Models/FullBlock.h>
+#include <Core/Serialization/Serializer.h>
+#include <Core/Serialization/ByteBuffer.h>
+
+TEST_CASE("BlockDB - Serving Blocks")
+{
+	ConfigPtr pConfig = TestHelper::GetTestConfig();
+	IDatabasePtr pDatabase = DatabaseAPI::OpenDatabase(*pConfig);
+
+	const FullBlock& genesis = pConfig->GetEnvironment().GetGenesisBlock();
+	{
+		auto pBlockDB = pDatabase->GetBlockDB()->BatchWrite();
+		pBlockDB->AddBlock(genesis);
+		pBlockDB->Commit();
+	}
+
+	auto pBlockDB = pDatabase->GetBlockDB()->Read();
+	std::unique_ptr<FullBlock> pBlock = pBlockDB->GetBlock(genesis.GetHash());
+	REQUIRE(pBlock != nullptr);
+	REQUIRE(pBlock->GetHash() == genesis.GetHash());
+
+	std::vector<unsigned char> bytes;
+	{
+		Serializer serializer;
+		genesis.Serialize(serializer);
+		bytes = serializer.GetBytes();
+	}
+
+	// What each read cost before values were pinned: two full copies before deserializing.
+	BENCHMARK("Deserialize block from copied bytes")
+	{
+		const std::string value(bytes.cbegin(), bytes.cend());
+		ByteBuffer byteBuffer(std::vector<unsigned char>(value.cbegin(), value.cend()));
+		REQUIRE(FullBlock::Deserialize(byteBuffer).GetHash() == genesis.GetHash());
+	}
+
+	BENCHMARK("GetBlock")
+	{
+		REQUIRE(pBlockDB->GetBlock(genesis.GetHash()) != nullptr);
+	}
+}
+
+TEST_CASE("BlockDB - Split Blocks")
+{
+	TestHelper::GetTestConfig();
+
+	Json::Value json;
+	json[ConfigProps::Database::DATABASE][ConfigProps::Database::SPLIT_BLOCKS] = true;
+	ConfigPtr pSplitConfig = Config::Load(json, EEnvironmentType::AUTOMATED_TESTING);
+	IDatabasePtr pDatabase = DatabaseAPI::OpenDatabase(*pSplitConfig);
+
+	const FullBlock& genesis = pSplitConfig->GetEnvironment().GetGenesisBlock();
+	{
+		auto pBlockDB = pDatabase->GetBlockDB()->BatchWrite();
+		pBlockDB->AddBlock(genesis);
+		pBlockDB->Commit();
+	}
+
+	{
+		auto pBlockDB = pDatabase->GetBlockDB()->Read();
+		std::unique_ptr<FullBlock> pBlock = pBlockDB->GetBlock(genesis.GetHash());
+		REQUIRE(pBlock != nullptr);
+		REQUIRE(pBlock->GetHash() == genesis.GetHash());
+		REQUIRE(pBlock->Serialized() == genesis.Serialized());
+
+		REQUIRE(pBlockDB->HasBlock(genesis.GetHash()));
+		REQUIRE_FALSE(pBlockDB->HasBlock(Hash()));
+
+		// Only the requested parts are loaded.
+		std::vector<std::unique_ptr<BlockParts>> parts = pBlockDB->GetBlockParts({ genesis.GetHash(), Hash() }, EBlockPart::KERNELS);
+		REQUIRE(parts.size() == 2);
+		REQUIRE(parts[0] != nullptr);
+		REQUIRE(parts[0]->pHeader->GetHash() == genesis.GetHash());
+		REQUIRE(parts[0]->kernels == genesis.GetKernels());
+		REQUIRE(parts[0]->outputs.empty());
+		REQUIRE(parts[0]->rangeProofs.empty());
+		REQUIRE(parts[1] == nullptr);
+	}
+
+	// Once disabled, the split blocks are moved back into the BLOCK table.
+	pDatabase.reset();
+	ConfigPtr pConfig = Config::Default(EEnvironmentType::AUTOMATED_TESTING);
+	pDatabase = DatabaseAPI::OpenDatabase(*pConfig);
+
+	auto pBlockDB = pDatabase->GetBlockDB()->Read();
+	std::unique_ptr<FullBlock> pBlock = pBlockDB->GetBlock(genesis.GetHash());
+	REQUIRE(pBlock != nullptr);
+	REQUIRE(pBlock->Serialized() == genesis.Serialized());
+
+	std::vector<std::unique_ptr<BlockParts>> parts = pBlockDB->GetBlockParts({ genesis.GetHash() }, EBlockPart::OUTPUTS | EBlockPart::RANGEPROOFS);
+	REQUIRE(parts.front()->outputs.size() == genesis.GetOutputs().size());
+	REQUIRE(parts.front()->rangeProofs.front() == genesis.GetOutputs().front().GetRangeProof());
+	REQUIRE(parts.front()->kernels.empty());
+}
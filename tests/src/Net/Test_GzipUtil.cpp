@@ -0,0 +1,53 @@
+#include <catch.hpp>
+
+#include <Net/Util/GzipUtil.h>
+#include <Net/Clients/HTTP/HTTPException.h>
+#include <Common/Util/HexUtil.h>
+#include <algorithm>
+#include <random>
+
+TEST_CASE("GzipUtil")
+{
+	std::mt19937 random(1);
+	std::string json = "[";
+	for (int i = 0; i < 200; i++)
+	{
+		std::vector<uint8_t> commitment(33);
+		std::generate(commitment.begin(), commitment.end(), [&random]() { return (uint8_t)random(); });
+		json += "{\"commit\":\"" + HexUtil::ConvertToHex(commitment) + "\",\"spent\":false},";
+	}
+	json += "]";
+
+	const std::string compressed = GzipUtil::Compress(json);
+	REQUIRE(compressed.size() < json.size());
+	REQUIRE(GzipUtil::Decompress(compressed, json.size()) == json);
+	REQUIRE(GzipUtil::Decompress(GzipUtil::Compress(""), 0).empty());
+
+	// Bodies larger than maxSize are rejected.
+	REQUIRE_THROWS_AS(GzipUtil::Decompress(compressed, json.size() - 1), HTTPException);
+
+	// As are truncated or invalid bodies.
+	REQUIRE_THROWS_AS(GzipUtil::Decompress(compressed.substr(0, compressed.size() - 4), json.size()), HTTPException);
+	REQUIRE_THROWS_AS(GzipUtil::Decompress(json, json.size()), HTTPException);
+}
+
+TEST_CASE("GzipEncoder")
+{
+	const std::vector<std::string> parts{ "{\"outputs\":[", "\"08a1b2\",", "\"09c3d4\"", "]}" };
+
+	GzipEncoder encoder;
+	std::string compressed;
+	std::string expected;
+	for (const std::string& part : parts)
+	{
+		compressed += encoder.Write(part.data(), part.size());
+		expected += part;
+	}
+
+	// The gzip trailer is only written by Finish.
+	REQUIRE_THROWS_AS(GzipUtil::Decompress(compressed, expected.size()), HTTPException);
+
+	compressed += encoder.Finish();
+	REQUIRE(encoder.Finish().empty());
+	REQUIRE(GzipUtil::Decompress(compressed, expected.size()) == expected);
+}
@@ -0,0 +1,35 @@
+#include <catch.hpp>
+
+#include <Net/Util/ResponseCache.h>
+#include <thread>
+
+TEST_CASE("ResponseCache")
+{
+	ResponseCache cache;
+	int numRenders = 0;
+	auto render = [&numRenders]() { return std::to_string(++numRenders); };
+
+	// Served from the cache until the version changes.
+	REQUIRE(*cache.Get("status", ResponseCache::Version{ 1, 1, 1 }, render) == "1");
+	REQUIRE(*cache.Get("status", ResponseCache::Version{ 1, 1, 1 }, render) == "1");
+	REQUIRE(*cache.Get("status", ResponseCache::Version{ 2, 1, 1 }, render) == "2");
+	REQUIRE(*cache.Get("status", ResponseCache::Version{ 2, 1, 2 }, render) == "3");
+
+	// Each key is cached separately.
+	REQUIRE(*cache.Get("chain", ResponseCache::Version{ 2, 1, 2 }, render) == "4");
+	REQUIRE(*cache.Get("status", ResponseCache::Version{ 2, 1, 2 }, render) == "3");
+
+	// Bodies older than maxAge are re-rendered, even for the same version.
+	REQUIRE(*cache.Get("chain", ResponseCache::Version{ 2, 1, 2 }, render, std::chrono::milliseconds(1)) == "4");
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	REQUIRE(*cache.Get("chain", ResponseCache::Version{ 2, 1, 2 }, render, std::chrono::milliseconds(1)) == "5");
+
+	// Nothing is cached when rendering fails.
+	REQUIRE_THROWS(cache.Get("failing", ResponseCache::Version{ 2, 1, 2 }, []() -> std::string { throw std::runtime_error("failed"); }));
+	REQUIRE(*cache.Get("failing", ResponseCache::Version{ 2, 1, 2 }, render) == "6");
+
+	const CacheStats stats = cache.GetStats();
+	REQUIRE(stats.size == 3);
+	REQUIRE(stats.hits == 3);
+	REQUIRE(stats.misses == 7);
+}
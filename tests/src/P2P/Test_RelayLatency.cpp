@@ -0,0 +1,35 @@
+#include <catch.hpp>
+
+#include <SimNetwork.h>
+
+//
+// Relay benchmarks, which are hidden since they bind many loopback addresses and take minutes to fund.
+// Run with: P2P_Tests "[relay]", optionally setting GRINPP_SIM_NODES, GRINPP_SIM_TOPOLOGY and GRINPP_SIM_DEGREE.
+//
+TEST_CASE("Relay latency - blocks", "[.][relay]")
+{
+	SimNetwork network(SimNetwork::Options::FromEnvironment());
+	network.Connect();
+
+	SimNetwork::RelayReport report = network.MineBlocks(0, 20);
+	report.Print(std::cout);
+	REQUIRE(report.numMissed == 0);
+	REQUIRE(report.latenciesMs.size() == 20 * (network.GetNumNodes() - 1));
+}
+
+TEST_CASE("Relay latency - transaction flood", "[.][relay]")
+{
+	SimNetwork network(SimNetwork::Options::FromEnvironment());
+	network.Fund(100);
+	network.Connect();
+
+	std::vector<TransactionPtr> transactions;
+	SimNetwork::RelayReport txReport = network.FloodTransactions(0, 100, 50.0, &transactions);
+	txReport.Print(std::cout);
+	REQUIRE(txReport.numMissed == 0);
+
+	// The block's transactions are all in every mempool already, so it's relayed as a compact block.
+	SimNetwork::RelayReport blockReport = network.MineBlocks(network.GetNumNodes() - 1, 1, transactions);
+	blockReport.Print(std::cout);
+	REQUIRE(blockReport.numMissed == 0);
+}
@@ -0,0 +1,104 @@
+#include <catch.hpp>
+
+#include <PMMR/Common/MMRUtil.h>
+#include <Core/File/BitmapFile.h>
+#include <TestFileUtil.h>
+
+TEST_CASE("BitmapFile::Commit")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+
+	{
+		auto pBitmapFile = BitmapFile::Load(pFile->GetPath());
+		pBitmapFile->Set(3);
+		pBitmapFile->Set(12);
+		pBitmapFile->Commit();
+	}
+
+	{
+		auto pBitmapFile = BitmapFile::Load(pFile->GetPath());
+		REQUIRE(pBitmapFile->IsSet(3));
+		REQUIRE(pBitmapFile->IsSet(12));
+		REQUIRE(!pBitmapFile->IsSet(5));
+
+		// In place, and past the end of the file.
+		pBitmapFile->Unset(3);
+		pBitmapFile->Set(5);
+		pBitmapFile->Set(100);
+		pBitmapFile->Commit();
+
+		REQUIRE(!pBitmapFile->IsSet(3));
+		REQUIRE(pBitmapFile->IsSet(5));
+		REQUIRE(pBitmapFile->IsSet(100));
+	}
+
+	{
+		auto pBitmapFile = BitmapFile::Load(pFile->GetPath());
+		REQUIRE(!pBitmapFile->IsSet(3));
+		REQUIRE(pBitmapFile->IsSet(5));
+		REQUIRE(pBitmapFile->IsSet(12));
+		REQUIRE(!pBitmapFile->IsSet(64));
+		REQUIRE(pBitmapFile->IsSet(100));
+
+		// Rolled back changes are never written.
+		pBitmapFile->Set(64);
+		pBitmapFile->Rollback();
+		pBitmapFile->Commit();
+	}
+
+	REQUIRE(!BitmapFile::Load(pFile->GetPath())->IsSet(64));
+}
+
+TEST_CASE("BitmapFile::GetSetLeaves")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+	auto pBitmapFile = BitmapFile::Load(pFile->GetPath());
+	for (const uint64_t leafIndex : { 1, 7, 8, 200, 1000, 1001 })
+	{
+		pBitmapFile->Set(leafIndex);
+	}
+
+	// Uncommitted changes are included.
+	REQUIRE(pBitmapFile->GetSetLeaves(0, 2000, 10) == std::vector<uint64_t>({ 1, 7, 8, 200, 1000, 1001 }));
+
+	pBitmapFile->Commit();
+	REQUIRE(pBitmapFile->GetSetLeaves(0, 2000, 10) == std::vector<uint64_t>({ 1, 7, 8, 200, 1000, 1001 }));
+	REQUIRE(pBitmapFile->GetSetLeaves(2, 2000, 3) == std::vector<uint64_t>({ 7, 8, 200 }));
+	REQUIRE(pBitmapFile->GetSetLeaves(9, 1001, 10) == std::vector<uint64_t>({ 200, 1000 }));
+	REQUIRE(pBitmapFile->GetSetLeaves(1002, 5000, 10).empty());
+}
+
+TEST_CASE("BitmapFile::Rewind")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+
+	{
+		auto pBitmapFile = BitmapFile::Load(pFile->GetPath());
+		for (const uint64_t leafIndex : { 2, 10, 11, 13, 40, 100 })
+		{
+			pBitmapFile->Set(leafIndex);
+		}
+
+		pBitmapFile->Commit();
+	}
+
+	auto pBitmapFile = BitmapFile::Load(pFile->GetPath());
+
+	// Leaves in the same byte as numLeaves are cleared individually, and later bytes all at once.
+	pBitmapFile->Rewind(12, { 5, 10 });
+	pBitmapFile->Set(150);
+	pBitmapFile->Rewind(12, {});
+	pBitmapFile->Commit();
+
+	for (const uint64_t leafIndex : { 2, 5, 10, 11 })
+	{
+		REQUIRE(pBitmapFile->IsSet(leafIndex));
+	}
+
+	for (const uint64_t leafIndex : { 12, 13, 40, 100, 150 })
+	{
+		REQUIRE(!pBitmapFile->IsSet(leafIndex));
+	}
+
+	REQUIRE(BitmapFile::Load(pFile->GetPath())->GetSetLeaves(0, 200, 10) == std::vector<uint64_t>({ 2, 5, 10, 11 }));
+}
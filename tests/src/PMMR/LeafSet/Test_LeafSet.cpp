@@ -1,8 +1,129 @@
 #include <catch.hpp>
 
 #include <PMMR/Common/LeafSet.h>
+#include <TestFileUtil.h>
 
 TEST_CASE("LeafSet")
 {
     // TODO: Implement
-}
\ No newline at end of file
+}
+
+TEST_CASE("LeafSet::ToRoaring - Snapshot")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+	auto pLeafSet = LeafSet::Load(pFile->GetPath());
+	for (uint64_t i = 0; i < 10; i++)
+	{
+		pLeafSet->Add(i);
+	}
+
+	pLeafSet->Remove(2);
+	pLeafSet->Remove(5);
+	pLeafSet->Commit();
+
+	// As of a block with 8 leaves, after which leaf 2 was spent.
+	LeafSetSnapshot snapshot;
+	snapshot.numLeaves = 8;
+	snapshot.restoredLeaves = { 2 };
+
+	const Roaring bitmap = pLeafSet->ToRoaring(snapshot);
+	REQUIRE(bitmap.cardinality() == 7);
+	for (const uint64_t leafIndex : { 0, 1, 2, 3, 4, 6, 7 })
+	{
+		REQUIRE(bitmap.contains((uint32_t)(MMRUtil::GetPMMRIndex(leafIndex) + 1)));
+	}
+
+	// The current leafset is untouched.
+	REQUIRE(!pLeafSet->Contains(2));
+	REQUIRE(pLeafSet->Contains(9));
+}
+
+// Hashes every chunk of the leafset into a scratch hash file, the way the UBMT root used to be calculated.
+static Hash CalculateUBMTRoot(const LeafSet& leafSet, const uint64_t numOutputs)
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+	std::shared_ptr<HashFile> pHashFile = HashFile::Load(pFile->GetPath());
+
+	const uint64_t numChunks = (numOutputs + 1023) / 1024;
+	for (uint64_t i = 0; i < numChunks; i++)
+	{
+		std::vector<uint8_t> bytes(128, 0);
+		for (uint64_t j = 0; j < 1024; j++)
+		{
+			if (leafSet.Contains((i * 1024) + j))
+			{
+				bytes[j / 8] |= (uint8_t)(1 << (7 - (j % 8)));
+			}
+		}
+
+		MMRHashUtil::AddHashes(pHashFile, bytes, nullptr);
+	}
+
+	const Hash root = MMRHashUtil::Root(pHashFile, pHashFile->GetSize(), nullptr);
+	pHashFile->Rollback();
+	return root;
+}
+
+TEST_CASE("LeafSet::Root - Incremental")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+	auto pLeafSet = LeafSet::Load(pFile->GetPath());
+	REQUIRE(pLeafSet->Root(0) == ZERO_HASH);
+
+	for (uint64_t i = 0; i < 5000; i++)
+	{
+		pLeafSet->Add(i);
+	}
+	pLeafSet->Commit();
+	REQUIRE(pLeafSet->Root(5000) == CalculateUBMTRoot(*pLeafSet, 5000));
+
+	// Spends in a few chunks, and outputs added to the last chunk and past it.
+	pLeafSet->Remove(3);
+	pLeafSet->Remove(2100);
+	pLeafSet->Remove(4999);
+	for (uint64_t i = 5000; i < 7000; i++)
+	{
+		pLeafSet->Add(i);
+	}
+	REQUIRE(pLeafSet->Root(7000) == CalculateUBMTRoot(*pLeafSet, 7000));
+
+	// Rolled back to the committed leafset.
+	pLeafSet->Rollback();
+	REQUIRE(pLeafSet->Contains(2100));
+	REQUIRE(pLeafSet->Root(5000) == CalculateUBMTRoot(*pLeafSet, 5000));
+
+	// Rewound to 3000 leaves, with a spent leaf restored.
+	pLeafSet->Remove(10);
+	pLeafSet->Commit();
+	REQUIRE(pLeafSet->Root(5000) == CalculateUBMTRoot(*pLeafSet, 5000));
+	pLeafSet->Rewind(3000, { 10 });
+	pLeafSet->Commit();
+	REQUIRE(pLeafSet->Root(3000) == CalculateUBMTRoot(*pLeafSet, 3000));
+}
+
+TEST_CASE("LeafSet::SpeculativeRoot")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+	auto pLeafSet = LeafSet::Load(pFile->GetPath());
+	for (uint64_t i = 0; i < 5000; i++)
+	{
+		pLeafSet->Add(i);
+	}
+	pLeafSet->Commit();
+
+	// Appended leaves are spent both below and past the leafset's last chunk, including one that was just appended.
+	const std::unordered_set<uint64_t> removed({ 3, 2100, 4999, 6500 });
+	const Hash speculativeRoot = pLeafSet->SpeculativeRoot(5000, 7000, removed);
+	REQUIRE(pLeafSet->Root(5000) == CalculateUBMTRoot(*pLeafSet, 5000));
+
+	for (uint64_t i = 5000; i < 7000; i++)
+	{
+		pLeafSet->Add(i);
+	}
+	for (const uint64_t leafIndex : removed)
+	{
+		pLeafSet->Remove(leafIndex);
+	}
+	REQUIRE(speculativeRoot == pLeafSet->Root(7000));
+	REQUIRE(speculativeRoot == CalculateUBMTRoot(*pLeafSet, 7000));
+}
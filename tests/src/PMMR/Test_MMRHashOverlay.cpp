@@ -0,0 +1,76 @@
+#include <catch.hpp>
+
+#include <TestFileUtil.h>
+#include <PMMR/Common/PruneableMMR.h>
+#include <PMMR/Common/MMRHashOverlay.h>
+#include <PMMR/Common/MMRUtil.h>
+#include <Core/Models/OutputIdentifier.h>
+
+#define TEST_OUTPUT_SIZE 34
+
+using TestPMMR = PruneableMMR<TEST_OUTPUT_SIZE, OutputIdentifier>;
+
+static OutputIdentifier CreateOutput(const uint64_t leafIndex)
+{
+	std::vector<uint8_t> bytes(33, 0x09);
+	bytes[1] = (uint8_t)(leafIndex >> 8);
+	bytes[2] = (uint8_t)leafIndex;
+	return OutputIdentifier(EOutputFeatures::DEFAULT, Commitment(CBigInteger<33>(std::move(bytes))));
+}
+
+TEST_CASE("MMRHashOverlay")
+{
+	const std::vector<std::pair<uint64_t, uint64_t>> sizes{ { 1, 1 }, { 1, 7 }, { 3, 1 }, { 8, 8 }, { 13, 19 }, { 64, 1 }, { 100, 37 } };
+	for (const auto& [numLeaves, numAppended] : sizes)
+	{
+		auto pDirectory = TestFileUtil::CreateTempFile();
+		FileUtil::CreateDirectories(pDirectory->GetPath());
+		auto pPMMR = std::make_shared<TestPMMR>(
+			HashFile::Load(pDirectory->GetPath() / "pmmr_hash.bin"),
+			LeafSet::Load(pDirectory->GetPath() / "pmmr_leafset.bin"),
+			PruneList::Load(pDirectory->GetPath() / "pmmr_prun.bin"),
+			DataFile<TEST_OUTPUT_SIZE>::Load(pDirectory->GetPath() / "pmmr_data.bin")
+		);
+
+		for (uint64_t leafIndex = 0; leafIndex < numLeaves; leafIndex++)
+		{
+			pPMMR->Append(CreateOutput(leafIndex));
+		}
+
+		pPMMR->Commit();
+
+		// Spent leaves keep their hashes, so the overlay's root is unaffected by them.
+		for (uint64_t leafIndex = 0; leafIndex < numLeaves; leafIndex += 3)
+		{
+			pPMMR->Remove(MMRUtil::GetPMMRIndex(leafIndex));
+		}
+
+		const uint64_t size = pPMMR->GetSize();
+		const Hash root = pPMMR->Root(size);
+
+		MMRHashOverlay overlay(pPMMR);
+		REQUIRE(overlay.GetSize() == size);
+		REQUIRE(overlay.Root() == root);
+
+		for (uint64_t leafIndex = numLeaves; leafIndex < numLeaves + numAppended; leafIndex++)
+		{
+			Serializer serializer;
+			CreateOutput(leafIndex).Serialize(serializer);
+			overlay.Append(serializer.GetBytes());
+		}
+
+		// The MMR itself is unchanged.
+		REQUIRE(pPMMR->GetSize() == size);
+		REQUIRE(pPMMR->Root(size) == root);
+
+		// And the overlay matches the MMR with the same leaves appended.
+		for (uint64_t leafIndex = numLeaves; leafIndex < numLeaves + numAppended; leafIndex++)
+		{
+			pPMMR->Append(CreateOutput(leafIndex));
+		}
+
+		REQUIRE(overlay.GetSize() == pPMMR->GetSize());
+		REQUIRE(overlay.GetSize() == MMRUtil::GetPMMRIndex(numLeaves + numAppended));
+		REQUIRE(overlay.Root() == pPMMR->Root(pPMMR->GetSize()));
+	}
+}
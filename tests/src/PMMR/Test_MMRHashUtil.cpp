@@ -0,0 +1,42 @@
+#include <catch.hpp>
+
+#include <TestFileUtil.h>
+#include <PMMR/Common/MMRHashUtil.h>
+
+TEST_CASE("MMRHashUtil::AddHashes - Batched")
+{
+	auto pSequentialFile = TestFileUtil::CreateTempFile();
+	auto pBatchedFile = TestFileUtil::CreateTempFile();
+	std::shared_ptr<HashFile> pSequential = HashFile::Load(pSequentialFile->GetPath());
+	std::shared_ptr<HashFile> pBatched = HashFile::Load(pBatchedFile->GetPath());
+
+	// Append batches of varying sizes, committing part way through so parents span the file and the buffer.
+	// The last batch is large enough for its leaves to be hashed in parallel.
+	uint8_t leafNum = 0;
+	const std::vector<size_t> batchSizes = { 1, 3, 0, 7, 16, 2, 33, 2000 };
+	for (size_t batch = 0; batch < batchSizes.size(); batch++)
+	{
+		std::vector<std::vector<unsigned char>> leaves;
+		for (size_t i = 0; i < batchSizes[batch]; i++)
+		{
+			leaves.emplace_back(std::vector<unsigned char>(34, leafNum++));
+			MMRHashUtil::AddHashes(pSequential, leaves.back(), nullptr);
+		}
+
+		MMRHashUtil::AddHashes(pBatched, leaves, nullptr);
+		REQUIRE(pBatched->GetSize() == pSequential->GetSize());
+
+		if (batch == 3)
+		{
+			pSequential->Commit();
+			pBatched->Commit();
+		}
+	}
+
+	const uint64_t size = pSequential->GetSize();
+	REQUIRE(pBatched->GetDataRange(0, size) == pSequential->GetDataRange(0, size));
+	REQUIRE(MMRHashUtil::Root(pBatched, size, nullptr) == MMRHashUtil::Root(pSequential, size, nullptr));
+
+	pSequential->Rollback();
+	pBatched->Rollback();
+}
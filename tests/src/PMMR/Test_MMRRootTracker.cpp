@@ -0,0 +1,60 @@
+#include <catch.hpp>
+
+#include <TestFileUtil.h>
+#include <PMMR/Common/MMR.h>
+#include <PMMR/Common/MMRHashUtil.h>
+#include <PMMR/Common/MMRRootTracker.h>
+
+class TestMMR : public MMR
+{
+public:
+	TestMMR(std::shared_ptr<HashFile> pHashFile) : m_pHashFile(pHashFile) { }
+
+	uint64_t GetSize() const final { return m_pHashFile->GetSize(); }
+	Hash Root(const uint64_t size) const final { return MMRHashUtil::Root(m_pHashFile, size, nullptr); }
+	std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const final { return std::make_unique<Hash>(m_pHashFile->GetDataAt(mmrIndex)); }
+	std::vector<uint8_t> GetHashes(const uint64_t firstIndex, const uint64_t lastIndex) const final { return MMRHashUtil::GetHashes(m_pHashFile, firstIndex, lastIndex, nullptr); }
+	std::vector<Hash> GetLastLeafHashes(const uint64_t) const final { return {}; }
+	void SetAccessHint(const EFileAccess access) final { m_pHashFile->SetAccessHint(access); }
+	void Commit() final { m_pHashFile->Commit(); }
+	void Rollback() noexcept final { m_pHashFile->Rollback(); }
+
+private:
+	std::shared_ptr<HashFile> m_pHashFile;
+};
+
+TEST_CASE("MMRRootTracker::Root")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+	std::shared_ptr<HashFile> pHashFile = HashFile::Load(pFile->GetPath());
+
+	std::vector<uint64_t> sizes;
+	for (uint8_t i = 0; i < 100; i++)
+	{
+		MMRHashUtil::AddHashes(pHashFile, std::vector<unsigned char>(8, i), nullptr);
+		sizes.push_back(pHashFile->GetSize());
+	}
+
+	auto pMMR = std::make_shared<TestMMR>(pHashFile);
+
+	SECTION("Ascending sizes")
+	{
+		MMRRootTracker tracker(pMMR);
+		REQUIRE(tracker.Root(0) == ZERO_HASH);
+		for (const uint64_t size : sizes)
+		{
+			REQUIRE(tracker.Root(size) == pMMR->Root(size));
+		}
+	}
+
+	SECTION("Descending sizes")
+	{
+		MMRRootTracker tracker(pMMR);
+		for (auto iter = sizes.crbegin(); iter != sizes.crend(); iter++)
+		{
+			REQUIRE(tracker.Root(*iter) == pMMR->Root(*iter));
+		}
+	}
+
+	pHashFile->Rollback();
+}
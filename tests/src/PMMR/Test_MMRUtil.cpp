@@ -138,4 +138,96 @@ TEST_CASE("MMRUtil::GetNumLeaves")
 	REQUIRE(MMRUtil::GetNumLeaves(8) == 6);
 	REQUIRE(MMRUtil::GetNumLeaves(9) == 6);
 	REQUIRE(MMRUtil::GetNumLeaves(10) == 7);
-}
\ No newline at end of file
+}
+TEST_CASE("MMRUtil::GetPeaks")
+{
+	static_assert(MMRUtil::GetHeight(30) == 4);
+	static_assert(MMRUtil::GetNumLeaves(10) == 7);
+	static_assert(MMRUtil::GetPeaks(42).size() == 4);
+	static_assert(*MMRUtil::GetPeaks(42).rbegin() == 41);
+
+	for (uint64_t size = 0; size < 5000; size++)
+	{
+		const std::vector<uint64_t> expected = MMRUtil::GetPeakIndices(size);
+		const MMRUtil::Peaks peaks = MMRUtil::GetPeaks(size);
+		REQUIRE(peaks.size() == expected.size());
+		REQUIRE(peaks.empty() == expected.empty());
+
+		std::vector<uint64_t> leftToRight;
+		for (auto iter = peaks.begin(); iter != peaks.end(); iter++)
+		{
+			REQUIRE(iter.GetHeight() == MMRUtil::GetHeight(*iter));
+			leftToRight.push_back(*iter);
+		}
+
+		REQUIRE(leftToRight == expected);
+		REQUIRE(std::vector<uint64_t>(peaks.rbegin(), peaks.rend()) == std::vector<uint64_t>(expected.crbegin(), expected.crend()));
+	}
+}
+
+TEST_CASE("MMRUtil::GetLeafIndex")
+{
+	for (uint64_t leafIndex = 0; leafIndex < 5000; leafIndex++)
+	{
+		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(leafIndex);
+		REQUIRE(MMRUtil::IsLeaf(mmrIndex));
+		REQUIRE(MMRUtil::GetLeafIndex(mmrIndex) == leafIndex);
+		REQUIRE(MMRUtil::GetNumLeaves(mmrIndex) == leafIndex + 1);
+		REQUIRE(MMRUtil::GetNumLeaves(MMRUtil::GetNumNodes(mmrIndex) - 1) == leafIndex + 1);
+	}
+}
+
+TEST_CASE("MMRUtil - Benchmark", "[.benchmark]")
+{
+	const uint64_t numNodes = 1'000'000;
+
+	uint64_t total = 0;
+
+	BENCHMARK("GetHeight of 1,000,000 nodes")
+	{
+		for (uint64_t i = 0; i < numNodes; i++)
+		{
+			total += MMRUtil::GetHeight(i);
+		}
+	}
+
+	BENCHMARK("GetNumLeaves of 1,000,000 nodes")
+	{
+		for (uint64_t i = 0; i < numNodes; i++)
+		{
+			total += MMRUtil::GetNumLeaves(i);
+		}
+	}
+
+	BENCHMARK("GetLeafIndex of 1,000,000 leaves")
+	{
+		for (uint64_t i = 0; i < numNodes; i++)
+		{
+			total += MMRUtil::GetLeafIndex(MMRUtil::GetPMMRIndex(i));
+		}
+	}
+
+	BENCHMARK("GetPeakIndices of 1,000,000 sizes")
+	{
+		for (uint64_t size = 1; size <= numNodes; size++)
+		{
+			for (const uint64_t peakIndex : MMRUtil::GetPeakIndices(size))
+			{
+				total += peakIndex;
+			}
+		}
+	}
+
+	BENCHMARK("GetPeaks of 1,000,000 sizes")
+	{
+		for (uint64_t size = 1; size <= numNodes; size++)
+		{
+			for (const uint64_t peakIndex : MMRUtil::GetPeaks(size))
+			{
+				total += peakIndex;
+			}
+		}
+	}
+
+	REQUIRE(total > 0);
+}
@@ -0,0 +1,89 @@
+#include <catch.hpp>
+
+#include <TestFileUtil.h>
+#include <PMMR/Common/MMR.h>
+#include <PMMR/Common/MMRHashUtil.h>
+#include <PMMR/Common/MMRUtil.h>
+#include <PMMR/Common/MerkleProofBuilder.h>
+#include <Core/Exceptions/TxHashSetException.h>
+
+class ProofTestMMR : public MMR
+{
+public:
+	ProofTestMMR(std::shared_ptr<HashFile> pHashFile) : m_pHashFile(pHashFile) { }
+
+	uint64_t GetSize() const final { return m_pHashFile->GetSize(); }
+	Hash Root(const uint64_t size) const final { return MMRHashUtil::Root(m_pHashFile, size, nullptr); }
+	std::unique_ptr<Hash> GetHashAt(const uint64_t mmrIndex) const final { return std::make_unique<Hash>(m_pHashFile->GetDataAt(mmrIndex)); }
+	std::vector<uint8_t> GetHashes(const uint64_t firstIndex, const uint64_t lastIndex) const final { return MMRHashUtil::GetHashes(m_pHashFile, firstIndex, lastIndex, nullptr); }
+	std::vector<Hash> GetLastLeafHashes(const uint64_t) const final { return {}; }
+	void SetAccessHint(const EFileAccess access) final { m_pHashFile->SetAccessHint(access); }
+	void Commit() final { m_pHashFile->Commit(); }
+	void Rollback() noexcept final { m_pHashFile->Rollback(); }
+
+private:
+	std::shared_ptr<HashFile> m_pHashFile;
+};
+
+TEST_CASE("MerkleProofBuilder::BuildProof")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+	std::shared_ptr<HashFile> pHashFile = HashFile::Load(pFile->GetPath());
+
+	// Enough leaves for peaks both taller and shorter than CACHED_HEIGHT.
+	const uint64_t numLeaves = 5000;
+	std::vector<std::vector<unsigned char>> leaves;
+	for (uint64_t i = 0; i < numLeaves; i++)
+	{
+		leaves.emplace_back(std::vector<unsigned char>{ (uint8_t)(i >> 8), (uint8_t)i, 0x01, 0x02 });
+	}
+
+	MMRHashUtil::AddHashes(pHashFile, leaves, nullptr);
+	ProofTestMMR mmr(pHashFile);
+
+	MerkleProofBuilder builder;
+	const uint64_t mmrSize = mmr.GetSize();
+	const Hash root = mmr.Root(mmrSize);
+
+	SECTION("Every leaf")
+	{
+		for (uint64_t leafIndex = 0; leafIndex < numLeaves; leafIndex++)
+		{
+			const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(leafIndex);
+			const MerkleProof proof = builder.BuildProof(mmr, mmrIndex, mmrSize);
+			REQUIRE(proof.GetMMRSize() == mmrSize);
+			REQUIRE(MerkleProofBuilder::CalculateRoot(proof, *mmr.GetHashAt(mmrIndex), mmrIndex) == root);
+		}
+	}
+
+	SECTION("Smaller sizes")
+	{
+		for (uint64_t numSizeLeaves = 1; numSizeLeaves <= numLeaves; numSizeLeaves += 97)
+		{
+			const uint64_t size = MMRUtil::GetPMMRIndex(numSizeLeaves);
+			for (uint64_t leafIndex = 0; leafIndex < numSizeLeaves; leafIndex += 31)
+			{
+				const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(leafIndex);
+				const MerkleProof proof = builder.BuildProof(mmr, mmrIndex, size);
+				REQUIRE(MerkleProofBuilder::CalculateRoot(proof, *mmr.GetHashAt(mmrIndex), mmrIndex) == mmr.Root(size));
+			}
+		}
+	}
+
+	SECTION("Invalid proofs")
+	{
+		const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(1234);
+		const MerkleProof proof = builder.BuildProof(mmr, mmrIndex, mmrSize);
+		REQUIRE(MerkleProofBuilder::CalculateRoot(proof, *mmr.GetHashAt(mmrIndex + 1), mmrIndex) != root);
+		REQUIRE(MerkleProofBuilder::CalculateRoot(proof, *mmr.GetHashAt(mmrIndex), MMRUtil::GetPMMRIndex(1235)) != root);
+
+		std::vector<Hash> truncated = proof.GetPath();
+		truncated.pop_back();
+		REQUIRE(MerkleProofBuilder::CalculateRoot(MerkleProof(mmrSize, std::move(truncated)), *mmr.GetHashAt(mmrIndex), mmrIndex) == ZERO_HASH);
+
+		REQUIRE_THROWS_AS(builder.BuildProof(mmr, mmrIndex + 2, mmrSize), TxHashSetException);
+		REQUIRE_THROWS_AS(builder.BuildProof(mmr, mmrSize, mmrSize), TxHashSetException);
+	}
+
+	pHashFile->Rollback();
+}
\ No newline at end of file
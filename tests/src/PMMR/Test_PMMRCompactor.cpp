@@ -0,0 +1,230 @@
+#include <catch.hpp>
+
+#include <TestFileUtil.h>
+#include <PMMR/Common/PruneableMMR.h>
+#include <PMMR/Common/MMRUtil.h>
+#include <Core/Models/OutputIdentifier.h>
+#include <set>
+
+#define TEST_OUTPUT_SIZE 34
+
+using TestPMMR = PruneableMMR<TEST_OUTPUT_SIZE, OutputIdentifier>;
+
+static std::shared_ptr<TestPMMR> LoadTestPMMR(const fs::path& directory)
+{
+	return std::make_shared<TestPMMR>(
+		HashFile::Load(directory / "pmmr_hash.bin"),
+		LeafSet::Load(directory / "pmmr_leafset.bin"),
+		PruneList::Load(directory / "pmmr_prun.bin"),
+		DataFile<TEST_OUTPUT_SIZE>::Load(directory / "pmmr_data.bin")
+	);
+}
+
+static OutputIdentifier CreateOutput(const uint64_t leafIndex)
+{
+	std::vector<uint8_t> bytes(33, 0x08);
+	bytes[1] = (uint8_t)(leafIndex >> 8);
+	bytes[2] = (uint8_t)leafIndex;
+	return OutputIdentifier(EOutputFeatures::DEFAULT, Commitment(CBigInteger<33>(std::move(bytes))));
+}
+
+static void AppendOutputs(TestPMMR& pmmr, const uint64_t firstLeaf, const uint64_t endLeaf)
+{
+	std::vector<OutputIdentifier> outputs;
+	for (uint64_t leafIndex = firstLeaf; leafIndex < endLeaf; leafIndex++)
+	{
+		outputs.push_back(CreateOutput(leafIndex));
+	}
+
+	pmmr.Append(outputs);
+	pmmr.Commit();
+}
+
+//
+// Stages, commits, and swaps in the compaction, the same way TxHashSet::ApplyCompaction does.
+//
+static void ApplyCompaction(TestPMMR& pmmr, PMMRCompactor& compactor, const fs::path& manifestPath)
+{
+	pmmr.StageCompaction(compactor);
+	PMMRCompactor::WriteManifest(manifestPath, { &compactor });
+	compactor.SetCommitted();
+	pmmr.SwapInCompaction(compactor);
+	FileUtil::RemoveFile(manifestPath);
+}
+
+//
+// Spends the outputs below the leaf that the first compaction kept, so there's more to compact.
+//
+static void SpendRemaining(TestPMMR& pmmr, const uint64_t endLeaf, std::set<uint64_t>& spent)
+{
+	for (uint64_t leafIndex = 0; leafIndex < endLeaf; leafIndex++)
+	{
+		if ((leafIndex % 7) == 3 && spent.count(leafIndex) == 0)
+		{
+			pmmr.Remove(MMRUtil::GetPMMRIndex(leafIndex));
+			spent.insert(leafIndex);
+		}
+	}
+
+	pmmr.Commit();
+}
+
+//
+// Checks that every unspent output can still be read, and that the root is unchanged.
+//
+static void CheckPMMR(const TestPMMR& pmmr, const uint64_t numLeaves, const std::set<uint64_t>& spent, const Hash& root)
+{
+	REQUIRE(pmmr.GetSize() == MMRUtil::GetPMMRIndex(numLeaves));
+	REQUIRE(pmmr.Root(pmmr.GetSize()) == root);
+
+	for (uint64_t leafIndex = 0; leafIndex < numLeaves; leafIndex++)
+	{
+		std::unique_ptr<OutputIdentifier> pOutput = pmmr.GetAt(MMRUtil::GetPMMRIndex(leafIndex));
+		if (spent.count(leafIndex) > 0)
+		{
+			REQUIRE(pOutput == nullptr);
+		}
+		else
+		{
+			REQUIRE(pOutput != nullptr);
+			REQUIRE(pOutput->GetCommitment() == CreateOutput(leafIndex).GetCommitment());
+		}
+	}
+}
+
+TEST_CASE("PMMRCompactor")
+{
+	auto pDirectory = TestFileUtil::CreateTempFile();
+	FileUtil::CreateDirectories(pDirectory->GetPath());
+	std::shared_ptr<TestPMMR> pPMMR = LoadTestPMMR(pDirectory->GetPath());
+	const fs::path manifestPath = pDirectory->GetPath() / "compaction.manifest";
+
+	// Spends most of the first 600 outputs, including whole subtrees, and a few after.
+	const uint64_t horizonLeaves = 600;
+	std::set<uint64_t> spent;
+	AppendOutputs(*pPMMR, 0, 1000);
+	for (uint64_t leafIndex = 0; leafIndex < 1000; leafIndex++)
+	{
+		if ((leafIndex < horizonLeaves && (leafIndex % 7) != 3) || (leafIndex % 50) == 0)
+		{
+			pPMMR->Remove(MMRUtil::GetPMMRIndex(leafIndex));
+			spent.insert(leafIndex);
+		}
+	}
+
+	pPMMR->Commit();
+
+	// Leaves spent since the horizon have to stay, so they're restored by a rewind.
+	const std::vector<uint64_t> spentSinceHorizon{ 100, 101, 550 };
+	const uint64_t horizonSize = MMRUtil::GetPMMRIndex(horizonLeaves);
+	PMMRCompactor::UPtr pCompactor = pPMMR->CreateCompactor(horizonSize, spentSinceHorizon);
+	pCompactor->Build();
+	REQUIRE(!pCompactor->IsEmpty());
+
+	// Blocks processed while the compacted files are built are copied over when they're swapped in.
+	AppendOutputs(*pPMMR, 1000, 1100);
+	const Hash root = pPMMR->Root(pPMMR->GetSize());
+	const uint64_t hashFileSize = FileUtil::GetFileSize(pDirectory->GetPath() / "pmmr_hash.bin");
+	const uint64_t dataFileSize = FileUtil::GetFileSize(pDirectory->GetPath() / "pmmr_data.bin");
+
+	ApplyCompaction(*pPMMR, *pCompactor, manifestPath);
+	CheckPMMR(*pPMMR, 1100, spent, root);
+	REQUIRE(!FileUtil::Exists(pCompactor->GetCompactedHashPath()));
+	REQUIRE(!FileUtil::Exists(pCompactor->GetCompactedPruneListPath()));
+	REQUIRE(FileUtil::GetFileSize(pDirectory->GetPath() / "pmmr_hash.bin") == hashFileSize - (pCompactor->GetNumRemovedHashes() * 32));
+	REQUIRE(FileUtil::GetFileSize(pDirectory->GetPath() / "pmmr_data.bin") == dataFileSize - (pCompactor->GetNumRemovedData() * TEST_OUTPUT_SIZE));
+	REQUIRE(pCompactor->GetNumRemovedHashes() > 0);
+	REQUIRE(pCompactor->GetNumRemovedData() > 0);
+
+	// The leaves spent since the horizon weren't compacted.
+	for (const uint64_t leafIndex : spentSinceHorizon)
+	{
+		REQUIRE(pPMMR->GetHashAt(MMRUtil::GetPMMRIndex(leafIndex)) != nullptr);
+	}
+
+	SECTION("Reload")
+	{
+		pPMMR.reset();
+		pCompactor.reset();
+
+		std::shared_ptr<TestPMMR> pReloaded = LoadTestPMMR(pDirectory->GetPath());
+		CheckPMMR(*pReloaded, 1100, spent, root);
+	}
+
+	SECTION("Compact again")
+	{
+		// Pruned roots from the first compaction get merged into taller ones.
+		const uint64_t nextHorizonLeaves = 900;
+		SpendRemaining(*pPMMR, nextHorizonLeaves, spent);
+		const Hash nextRoot = pPMMR->Root(pPMMR->GetSize());
+
+		PMMRCompactor::UPtr pNextCompactor = pPMMR->CreateCompactor(MMRUtil::GetPMMRIndex(nextHorizonLeaves), {});
+		pNextCompactor->Build();
+		ApplyCompaction(*pPMMR, *pNextCompactor, manifestPath);
+		CheckPMMR(*pPMMR, 1100, spent, nextRoot);
+
+		// Nothing left to prune.
+		PMMRCompactor::UPtr pEmptyCompactor = pPMMR->CreateCompactor(MMRUtil::GetPMMRIndex(nextHorizonLeaves), {});
+		pEmptyCompactor->Build();
+		REQUIRE(pEmptyCompactor->IsEmpty());
+	}
+
+	SECTION("Rewound past horizon")
+	{
+		PMMRCompactor::UPtr pNextCompactor = pPMMR->CreateCompactor(MMRUtil::GetPMMRIndex(1050), {});
+		pNextCompactor->Build();
+
+		pPMMR->Rewind(MMRUtil::GetPMMRIndex(1020), {});
+		pPMMR->Commit();
+		REQUIRE_THROWS_AS(pPMMR->StageCompaction(*pNextCompactor), TxHashSetException);
+	}
+
+	SECTION("Recover interrupted swap")
+	{
+		SpendRemaining(*pPMMR, 900, spent);
+		const Hash nextRoot = pPMMR->Root(pPMMR->GetSize());
+
+		PMMRCompactor::UPtr pNextCompactor = pPMMR->CreateCompactor(MMRUtil::GetPMMRIndex(900), {});
+		pNextCompactor->Build();
+		pPMMR->StageCompaction(*pNextCompactor);
+		PMMRCompactor::WriteManifest(manifestPath, { pNextCompactor.get() });
+		pNextCompactor->SetCommitted();
+
+		// Crashes after only the hash file was moved into place.
+		FileUtil::RenameFile(pNextCompactor->GetCompactedHashPath(), pDirectory->GetPath() / "pmmr_hash.bin");
+		pPMMR.reset();
+		pNextCompactor.reset();
+
+		PMMRCompactor::Recover(manifestPath, { pDirectory->GetPath() });
+		REQUIRE(!FileUtil::Exists(manifestPath));
+
+		std::shared_ptr<TestPMMR> pReloaded = LoadTestPMMR(pDirectory->GetPath());
+		CheckPMMR(*pReloaded, 1100, spent, nextRoot);
+	}
+
+	SECTION("Discard uncommitted compaction")
+	{
+		const uint64_t compactedHashFileSize = FileUtil::GetFileSize(pDirectory->GetPath() / "pmmr_hash.bin");
+		SpendRemaining(*pPMMR, 900, spent);
+		const Hash nextRoot = pPMMR->Root(pPMMR->GetSize());
+
+		PMMRCompactor::UPtr pNextCompactor = pPMMR->CreateCompactor(MMRUtil::GetPMMRIndex(900), {});
+		pNextCompactor->Build();
+		pPMMR->StageCompaction(*pNextCompactor);
+
+		// Crashes before the manifest is written, leaving the staged files behind.
+		const fs::path stagedHashPath = pNextCompactor->GetCompactedHashPath();
+		pNextCompactor->SetCommitted();
+		pPMMR.reset();
+		pNextCompactor.reset();
+		REQUIRE(FileUtil::Exists(stagedHashPath));
+
+		PMMRCompactor::Recover(manifestPath, { pDirectory->GetPath() });
+		REQUIRE(!FileUtil::Exists(stagedHashPath));
+
+		// The spends were committed, but nothing more was compacted.
+		std::shared_ptr<TestPMMR> pReloaded = LoadTestPMMR(pDirectory->GetPath());
+		CheckPMMR(*pReloaded, 1100, spent, nextRoot);
+		REQUIRE(FileUtil::GetFileSize(pDirectory->GetPath() / "pmmr_hash.bin") == compactedHashFileSize);
+	}
+}
@@ -1,6 +1,8 @@
 #include <catch.hpp>
 
 #include <PMMR/Common/PruneList.h>
+#include <PMMR/Common/MMRUtil.h>
+#include <TestFileUtil.h>
 
 // start with an empty prune list (nothing shifted)
 TEST_CASE("PruneList::GetShift_Empty")
@@ -71,4 +73,72 @@ TEST_CASE("PruneList::GetShift Pruned 0,1,2")
 	REQUIRE(pPruneList->GetTotalShift() == 2);
 }
 
-// TODO: Finish this.
\ No newline at end of file
+// The shifts are updated as nodes are added, without waiting for a flush.
+// Pruning the sibling of a pruned subtree replaces its root with their parent.
+TEST_CASE("PruneList::GetShift Without Flush")
+{
+	auto pFile = TestFileUtil::CreateTempFile();
+	std::shared_ptr<PruneList> pPruneList = PruneList::Load(pFile->GetPath());
+
+	pPruneList->Add(3);
+	pPruneList->Add(4);
+
+	// PruneList contains: 5
+	REQUIRE(pPruneList->GetShift(4) == 0);
+	REQUIRE(pPruneList->GetShift(5) == 2);
+	REQUIRE(pPruneList->GetTotalShift() == 2);
+	REQUIRE(pPruneList->GetLeafShift(5) == 2);
+
+	pPruneList->Add(0);
+	pPruneList->Add(1);
+
+	// PruneList contains: 6
+	REQUIRE(pPruneList->GetShift(2) == 0);
+	REQUIRE(pPruneList->GetShift(5) == 0);
+	REQUIRE(pPruneList->GetShift(6) == 6);
+	REQUIRE(pPruneList->GetTotalShift() == 6);
+	REQUIRE(pPruneList->GetLeafShift(6) == 4);
+	REQUIRE(pPruneList->IsPruned(0));
+	REQUIRE(pPruneList->IsCompacted(5));
+}
+
+//
+// Run with "[.benchmark]" to time building a large prune list and translating positions with it.
+//
+TEST_CASE("PruneList - Benchmark", "[.benchmark]")
+{
+	const uint64_t numLeaves = 100'000;
+
+	BENCHMARK("Add 100,000 leaves, pruning every other pair")
+	{
+		auto pFile = TestFileUtil::CreateTempFile();
+		std::shared_ptr<PruneList> pPruneList = PruneList::Load(pFile->GetPath());
+		for (uint64_t i = 0; i < numLeaves; i += 4)
+		{
+			pPruneList->Add(MMRUtil::GetPMMRIndex(i));
+			pPruneList->Add(MMRUtil::GetPMMRIndex(i + 1));
+		}
+
+		REQUIRE(pPruneList->GetTotalShift() == numLeaves / 2);
+	}
+
+	auto pFile = TestFileUtil::CreateTempFile();
+	std::shared_ptr<PruneList> pPruneList = PruneList::Load(pFile->GetPath());
+	for (uint64_t i = 0; i < numLeaves; i += 4)
+	{
+		pPruneList->Add(MMRUtil::GetPMMRIndex(i));
+		pPruneList->Add(MMRUtil::GetPMMRIndex(i + 1));
+	}
+
+	uint64_t total = 0;
+	BENCHMARK("GetShift and GetLeafShift of 100,000 leaves")
+	{
+		for (uint64_t i = 0; i < numLeaves; i++)
+		{
+			const uint64_t mmrIndex = MMRUtil::GetPMMRIndex(i);
+			total += pPruneList->GetShift(mmrIndex) + pPruneList->GetLeafShift(mmrIndex);
+		}
+	}
+
+	REQUIRE(total > 0);
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include <catch.hpp>
+
+#include <PMMR/TxHashSetValidator.h>
+#include <Crypto/Crypto.h>
+#include <Crypto/CSPRNG.h>
+
+TEST_CASE("TxHashSetValidator::SumChunk")
+{
+	const BlindingFactor blind = CSPRNG::GenerateRandom32() / 2;
+	const BlindingFactor negatedBlind = Crypto::AddBlindingFactors(std::vector<BlindingFactor>(), { blind });
+
+	// A kernel excess and its negation cancel out.
+	const Commitment excess = Crypto::CommitBlinded(0, blind);
+	const Commitment negatedExcess = Crypto::CommitBlinded(0, negatedBlind);
+
+	const Commitment commitA = Crypto::CommitBlinded(3, CSPRNG::GenerateRandom32() / 2);
+	const Commitment commitB = Crypto::CommitBlinded(2, CSPRNG::GenerateRandom32() / 2);
+
+	REQUIRE_FALSE(TxHashSetValidator::SumChunk(std::vector<Commitment>()).has_value());
+	REQUIRE_FALSE(TxHashSetValidator::SumChunk({ excess, negatedExcess }).has_value());
+
+	// A chunk containing the cancelling pair still contributes the rest of its commitments.
+	std::optional<Commitment> chunk1 = TxHashSetValidator::SumChunk({ commitA, excess, negatedExcess });
+	std::optional<Commitment> chunk2 = TxHashSetValidator::SumChunk({ commitB });
+	REQUIRE(chunk1.has_value());
+	REQUIRE(chunk1.value() == commitA);
+	REQUIRE(chunk2.has_value());
+
+	const Commitment total = Crypto::AddCommitments({ chunk1.value(), chunk2.value() }, std::vector<Commitment>());
+	REQUIRE(total == Crypto::AddCommitments({ commitA, commitB }, std::vector<Commitment>()));
+}
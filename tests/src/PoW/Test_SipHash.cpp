@@ -0,0 +1,143 @@
+#include <catch.hpp>
+
+#include <PoW/Common.h>
+#include <Crypto/Hasher.h>
+
+// Same as cuckatoo's sipnode, before masking.
+static u64 ScalarSipNode(const siphash_keys& keys, const u64 nonce)
+{
+	siphash_state<> shs(keys);
+	shs.hash24(nonce);
+	return shs.xor_lanes();
+}
+
+// Same as the sipblock used by cuckaroom and cuckarooz.
+static u64 ScalarSuffixSipBlock(siphash_keys& keys, const word_t edge)
+{
+	u64 buf[EDGE_BLOCK_SIZE];
+	siphash_state<> shs(keys);
+	const word_t edge0 = edge & ~EDGE_BLOCK_MASK;
+	for (u32 i = 0; i < EDGE_BLOCK_SIZE; i++)
+	{
+		shs.hash24(edge0 + i);
+		buf[i] = shs.xor_lanes();
+	}
+
+	for (u32 i = EDGE_BLOCK_MASK; i; i--)
+	{
+		buf[i - 1] ^= buf[i];
+	}
+
+	return buf[edge & EDGE_BLOCK_MASK];
+}
+
+static std::vector<word_t> GetEdges()
+{
+	// Ascending, arbitrary, and including the first and last edge of a block.
+	std::vector<word_t> edges;
+	for (word_t i = 0; i < PROOFSIZE; i++)
+	{
+		edges.push_back((i * 0x9E3779B9ull) & ((1ull << 29) - 1));
+	}
+
+	std::sort(edges.begin(), edges.end());
+	edges[0] = 0;
+	edges[1] = EDGE_BLOCK_MASK;
+	return edges;
+}
+
+TEST_CASE("SipHash Lanes")
+{
+	const Hash hash = Hasher::Blake2b(std::vector<unsigned char>({ 1, 2, 3 }));
+	siphash_keys keys((const char*)hash.data());
+	const std::vector<word_t> edges = GetEdges();
+
+	SECTION("sipnodes")
+	{
+		// Not a multiple of SIPHASH_LANES, so the last group is partial.
+		std::vector<u64> nonces;
+		for (const word_t edge : edges)
+		{
+			nonces.push_back(2 * edge);
+			nonces.push_back(2 * edge + 1);
+		}
+
+		std::vector<u64> hashes(nonces.size());
+		sipnodes(keys, nonces.data(), (u32)nonces.size(), hashes.data());
+		for (size_t i = 0; i < nonces.size(); i++)
+		{
+			REQUIRE(hashes[i] == ScalarSipNode(keys, nonces[i]));
+		}
+	}
+
+	SECTION("sipblocks")
+	{
+		u64 bufs[PROOFSIZE][EDGE_BLOCK_SIZE];
+		sipblocks(keys, edges.data(), PROOFSIZE, bufs);
+
+		u64 sips[EDGE_BLOCK_SIZE];
+		for (u32 n = 0; n < PROOFSIZE; n++)
+		{
+			REQUIRE(sipblock_edge(bufs[n], edges[n]) == sipblock(keys, edges[n], sips));
+			REQUIRE(sipblock_suffix_edge(bufs[n], edges[n]) == ScalarSuffixSipBlock(keys, edges[n]));
+		}
+
+		sipblocks<25>(keys, edges.data(), PROOFSIZE, bufs);
+		for (u32 n = 0; n < PROOFSIZE; n++)
+		{
+			REQUIRE(sipblock_edge(bufs[n], edges[n]) == sipblock<25>(keys, edges[n], sips));
+		}
+	}
+}
+
+// Run with "[.benchmark]" to compare the scalar and lane siphash paths.
+TEST_CASE("SipHash - Benchmark", "[.benchmark]")
+{
+	const Hash hash = Hasher::Blake2b(std::vector<unsigned char>({ 1, 2, 3 }));
+	siphash_keys keys((const char*)hash.data());
+	const std::vector<word_t> edges = GetEdges();
+
+	std::vector<u64> nonces;
+	for (const word_t edge : edges)
+	{
+		nonces.push_back(2 * edge);
+		nonces.push_back(2 * edge + 1);
+	}
+
+	u64 hashes[2 * PROOFSIZE];
+	BENCHMARK("Cuckatoo endpoints - scalar")
+	{
+		for (size_t i = 0; i < nonces.size(); i++)
+		{
+			hashes[i] = ScalarSipNode(keys, nonces[i]);
+		}
+	}
+
+	BENCHMARK("Cuckatoo endpoints - lanes")
+	{
+		sipnodes(keys, nonces.data(), (u32)nonces.size(), hashes);
+	}
+
+	REQUIRE(hashes[0] == ScalarSipNode(keys, nonces[0]));
+
+	u64 sips[EDGE_BLOCK_SIZE];
+	BENCHMARK("Cuckaroo blocks - scalar")
+	{
+		for (u32 n = 0; n < PROOFSIZE; n++)
+		{
+			hashes[n] = sipblock(keys, edges[n], sips);
+		}
+	}
+
+	u64 bufs[PROOFSIZE][EDGE_BLOCK_SIZE];
+	BENCHMARK("Cuckaroo blocks - lanes")
+	{
+		sipblocks(keys, edges.data(), PROOFSIZE, bufs);
+		for (u32 n = 0; n < PROOFSIZE; n++)
+		{
+			hashes[n] = sipblock_edge(bufs[n], edges[n]);
+		}
+	}
+
+	REQUIRE(hashes[0] == sipblock(keys, edges[0], sips));
+}
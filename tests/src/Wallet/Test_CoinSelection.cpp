@@ -0,0 +1,119 @@
+#include <catch.hpp>
+
+#include <Wallet/SlateBuilder/CoinSelection.h>
+#include <Wallet/Exceptions/InsufficientFundsException.h>
+#include <Core/Util/FeeUtil.h>
+
+static OutputDataEntity CreateCoin(const uint64_t amount, const EOutputStatus status = EOutputStatus::SPENDABLE)
+{
+	static uint64_t nextCoin = 0;
+	std::vector<uint8_t> commitment(33, 0x08);
+	for (size_t i = 0; i < 8; i++)
+	{
+		commitment[1 + i] = (uint8_t)(nextCoin >> (i * 8));
+	}
+	nextCoin++;
+
+	return OutputDataEntity(
+		KeyChainPath::FromString("m/0/0"),
+		SecretKey(),
+		TransactionOutput(
+			EOutputFeatures::DEFAULT,
+			Commitment(CBigInteger<33>(std::move(commitment))),
+			RangeProof(std::vector<uint8_t>(675, 0))
+		),
+		amount,
+		status,
+		std::nullopt,
+		std::nullopt
+	);
+}
+
+static uint64_t Total(const std::vector<OutputDataEntity>& coins)
+{
+	uint64_t total = 0;
+	for (const OutputDataEntity& coin : coins)
+	{
+		total += coin.GetAmount();
+	}
+
+	return total;
+}
+
+TEST_CASE("CoinIndex")
+{
+	const OutputDataEntity coin1 = CreateCoin(5);
+	const OutputDataEntity coin2 = CreateCoin(3);
+	const OutputDataEntity locked = CreateCoin(7, EOutputStatus::LOCKED);
+
+	CoinIndex index;
+	index.Update({ coin1 });
+	REQUIRE_FALSE(index.IsLoaded());
+	REQUIRE(index.GetCoins().empty());
+
+	index.Load({ coin1, coin2, locked });
+	REQUIRE(index.IsLoaded());
+	REQUIRE(index.GetCoins().size() == 2);
+	REQUIRE(index.GetTotal() == 8);
+	REQUIRE(index.GetCoins().begin()->first == 3);
+	REQUIRE(index.Find(locked.GetCommitment()) == nullptr);
+
+	// Locking a coin removes it, and unlocking it adds it back.
+	OutputDataEntity lockedCoin1 = coin1;
+	lockedCoin1.SetStatus(EOutputStatus::LOCKED);
+	index.Update({ lockedCoin1 });
+	REQUIRE(index.GetCoins().size() == 1);
+	REQUIRE(index.GetTotal() == 3);
+	REQUIRE(index.Find(coin1.GetCommitment()) == nullptr);
+
+	OutputDataEntity unlocked = locked;
+	unlocked.SetStatus(EOutputStatus::SPENDABLE);
+	index.Update({ unlocked, coin2 });
+	REQUIRE(index.GetCoins().size() == 2);
+	REQUIRE(index.GetTotal() == 10);
+	REQUIRE(index.Find(unlocked.GetCommitment())->GetAmount() == 7);
+}
+
+TEST_CASE("CoinSelection - SMALLEST and FEWEST")
+{
+	const uint64_t feeBase = 1'000'000;
+	std::vector<OutputDataEntity> coins;
+	for (uint64_t i = 1; i <= 100; i++)
+	{
+		coins.push_back(CreateCoin(i * 100'000'000));
+	}
+
+	CoinIndex index;
+	index.Load(coins);
+
+	const uint64_t amount = 2'000'000'000;
+	std::vector<OutputDataEntity> smallest = CoinSelection::SelectCoinsToSpend(index, amount, feeBase, ESelectionStrategy::SMALLEST, {}, 2, 1);
+	REQUIRE(smallest.size() == 6);
+	REQUIRE(smallest.front().GetAmount() == 100'000'000);
+	REQUIRE(Total(smallest) >= amount + FeeUtil::CalculateFee(feeBase, 6, 2, 1));
+
+	// A single coin covers it, and the smallest one that does is picked.
+	std::vector<OutputDataEntity> fewest = CoinSelection::SelectCoinsToSpend(index, amount, feeBase, ESelectionStrategy::FEWEST, {}, 2, 1);
+	REQUIRE(fewest.size() == 1);
+	REQUIRE(fewest.front().GetAmount() == 2'100'000'000);
+
+	// The largest coins are taken first, with the last one shrunk to fit.
+	const uint64_t largeAmount = 25'000'000'000;
+	fewest = CoinSelection::SelectCoinsToSpend(index, largeAmount, feeBase, ESelectionStrategy::FEWEST, {}, 2, 1);
+	REQUIRE(fewest.size() == 3);
+	REQUIRE(fewest[0].GetAmount() == 10'000'000'000);
+	REQUIRE(fewest[1].GetAmount() == 9'900'000'000);
+	REQUIRE(fewest[2].GetAmount() == 5'200'000'000);
+	REQUIRE(Total(fewest) >= largeAmount + FeeUtil::CalculateFee(feeBase, 3, 2, 1));
+
+	// Excluded coins are skipped.
+	const std::unordered_set<Commitment> excluded{ coins[20].GetCommitment(), coins[99].GetCommitment() };
+	fewest = CoinSelection::SelectCoinsToSpend(index, amount, feeBase, ESelectionStrategy::FEWEST, {}, 2, 1, excluded);
+	REQUIRE(fewest.size() == 1);
+	REQUIRE(fewest.front().GetAmount() == 2'200'000'000);
+
+	REQUIRE_THROWS_AS(
+		CoinSelection::SelectCoinsToSpend(index, index.GetTotal(), feeBase, ESelectionStrategy::FEWEST, {}, 2, 1),
+		InsufficientFundsException
+	);
+}
@@ -15,4 +15,21 @@ TEST_CASE("KeyChain::KeyDerivation")
 	const CBigInteger<32> expected1234 = CBigInteger<32>::FromHex("f0953d1c040d179ce0c25d0dc9485a0f14761dbdd2ad90af12a9a77fe050df7e");
 
 	REQUIRE(key1234.GetBytes() == expected1234);
-}
\ No newline at end of file
+}
+TEST_CASE("KeyChain::KeyDerivation - Cached Parent Keys")
+{
+	ConfigPtr pConfig = ConfigLoader().Load(EEnvironmentType::MAINNET);
+	std::vector<uint8_t> masterSeed = CBigInteger<64>::FromHex("b873212f885ccffbf4692afcb84bc2e55886de2dfa07d90f5c3c239abc31c0a6ce047e30fd8bf6a281e71389aa82d73df74c7bbfb3b06b4639a5cee775cccd3c").GetData();
+
+	KeyChain keyChain = KeyChain::FromSeed(*pConfig, (const SecureVector&)masterSeed);
+
+	// Siblings and ancestors derived after m/1/2/3/4 reuse its cached parents.
+	const SecretKey key1235 = keyChain.DerivePrivateKey(KeyChainPath::FromString("m/1/2/3/5"));
+	const SecretKey key123 = keyChain.DerivePrivateKey(KeyChainPath::FromString("m/1/2/3"));
+	const SecretKey key1234 = keyChain.DerivePrivateKey(KeyChainPath::FromString("m/1/2/3/4"), 1234);
+	REQUIRE(key1234.GetBytes() == CBigInteger<32>::FromHex("f0953d1c040d179ce0c25d0dc9485a0f14761dbdd2ad90af12a9a77fe050df7e"));
+
+	KeyChain uncachedKeyChain = KeyChain::FromSeed(*pConfig, (const SecureVector&)masterSeed);
+	REQUIRE(key123.GetBytes() == uncachedKeyChain.DerivePrivateKey(KeyChainPath::FromString("m/1/2/3")).GetBytes());
+	REQUIRE(key1235.GetBytes() == KeyChain::FromSeed(*pConfig, (const SecureVector&)masterSeed).DerivePrivateKey(KeyChainPath::FromString("m/1/2/3/5")).GetBytes());
+}
@@ -0,0 +1,47 @@
+#include <catch.hpp>
+
+#include <Wallet/OutputReservations.h>
+
+static OutputDataEntity CreateCoin(const uint8_t id)
+{
+	std::vector<uint8_t> commitment(33, 0x08);
+	commitment[1] = id;
+
+	return OutputDataEntity(
+		KeyChainPath::FromString("m/0/0"),
+		SecretKey(),
+		TransactionOutput(
+			EOutputFeatures::DEFAULT,
+			Commitment(CBigInteger<33>(std::move(commitment))),
+			RangeProof(std::vector<uint8_t>(675, 0))
+		),
+		1000,
+		EOutputStatus::SPENDABLE,
+		std::nullopt,
+		std::nullopt
+	);
+}
+
+TEST_CASE("OutputReservations")
+{
+	auto pReservations = std::make_shared<OutputReservations>();
+	const OutputDataEntity coin1 = CreateCoin(1);
+	const OutputDataEntity coin2 = CreateCoin(2);
+	const OutputDataEntity coin3 = CreateCoin(3);
+
+	{
+		REQUIRE(pReservations->TryReserve({ coin1, coin2 }));
+		OutputReservation reservation(pReservations, { coin1, coin2 });
+
+		// All or nothing, so coin 3 isn't reserved by a send that also wanted coin 2.
+		REQUIRE_FALSE(pReservations->TryReserve({ coin3, coin2 }));
+		REQUIRE(pReservations->GetReserved().size() == 2);
+
+		REQUIRE(pReservations->TryReserve({ coin3 }));
+		pReservations->Release({ coin3.GetCommitment() });
+	}
+
+	// Released once the reservation goes out of scope.
+	REQUIRE(pReservations->GetReserved().empty());
+	REQUIRE(pReservations->TryReserve({ coin1, coin2, coin3 }));
+}
@@ -4,6 +4,7 @@
 #include <Wallet/Keychain/KeyGenerator.h>
 #include <Crypto/Crypto.h>
 #include <uuid.h>
+#include <thread>
 
 #include <Config/ConfigLoader.h>
 
@@ -50,4 +51,102 @@ TEST_CASE("REWIND_BULLETPROOF_ENHANCED")
 	REQUIRE(pRewoundProof != nullptr);
 	REQUIRE(amount == pRewoundProof->GetAmount());
 	REQUIRE(keyId.GetKeyIndices() == pRewoundProof->GetProofMessage().ToKeyIndices(EBulletproofType::ENHANCED));
-}
\ No newline at end of file
+}
+
+TEST_CASE("REWIND_BULLETPROOF_BATCH")
+{
+	ConfigPtr pConfig = ConfigLoader().Load(EEnvironmentType::MAINNET);
+
+	const CBigInteger<32> masterSeed = CSPRNG::GenerateRandom32();
+	const SecureVector masterSeedBytes(masterSeed.GetData().begin(), masterSeed.GetData().end());
+	KeyChain keyChain = KeyChain::FromSeed(*pConfig, masterSeedBytes);
+
+	const CBigInteger<32> otherSeed = CSPRNG::GenerateRandom32();
+	KeyChain otherKeyChain = KeyChain::FromSeed(*pConfig, SecureVector(otherSeed.GetData().begin(), otherSeed.GetData().end()));
+
+	// Every other output belongs to a different wallet.
+	std::vector<Commitment> commitments;
+	std::vector<RangeProof> rangeProofs;
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		const KeyChain& owner = (i % 2 == 0) ? keyChain : otherKeyChain;
+		KeyChainPath keyId(std::vector<uint32_t>({ 1, i }));
+		const uint64_t amount = 100 + i;
+		SecretKey blindingFactor = owner.DerivePrivateKey(keyId, amount);
+		Commitment commitment = Crypto::CommitBlinded(amount, BlindingFactor(blindingFactor.GetBytes()));
+
+		rangeProofs.push_back(owner.GenerateRangeProof(keyId, amount, commitment, blindingFactor, EBulletproofType::ENHANCED));
+		commitments.push_back(std::move(commitment));
+	}
+
+	std::vector<const RangeProof*> pRangeProofs;
+	for (const RangeProof& rangeProof : rangeProofs)
+	{
+		pRangeProofs.push_back(&rangeProof);
+	}
+
+	std::vector<std::unique_ptr<RewoundProof>> rewoundProofs = keyChain.RewindRangeProofs(commitments, pRangeProofs, EBulletproofType::ENHANCED);
+	REQUIRE(rewoundProofs.size() == 6);
+	for (uint32_t i = 0; i < 6; i++)
+	{
+		if (i % 2 == 0)
+		{
+			REQUIRE(rewoundProofs[i] != nullptr);
+			REQUIRE(rewoundProofs[i]->GetAmount() == 100 + i);
+			REQUIRE(rewoundProofs[i]->GetProofMessage().ToKeyIndices(EBulletproofType::ENHANCED) == std::vector<uint32_t>({ 1, i }));
+		}
+		else
+		{
+			REQUIRE(rewoundProofs[i] == nullptr);
+		}
+	}
+
+	// Proofs of the wrong type aren't rewound.
+	REQUIRE(keyChain.RewindRangeProofs(commitments, pRangeProofs, EBulletproofType::ORIGINAL)[0] == nullptr);
+}
+
+TEST_CASE("GENERATE_BULLETPROOFS_CONCURRENTLY")
+{
+	ConfigPtr pConfig = ConfigLoader().Load(EEnvironmentType::MAINNET);
+
+	const CBigInteger<32> masterSeed = CSPRNG::GenerateRandom32();
+	const SecureVector masterSeedBytes(masterSeed.GetData().begin(), masterSeed.GetData().end());
+	const KeyChain keyChain = KeyChain::FromSeed(*pConfig, masterSeedBytes);
+
+	const uint32_t numProofs = 8;
+	std::vector<Commitment> commitments(numProofs);
+	std::vector<std::unique_ptr<RangeProof>> rangeProofs(numProofs);
+	std::vector<std::thread> threads;
+	for (uint32_t i = 0; i < numProofs; i++)
+	{
+		threads.emplace_back([&keyChain, &commitments, &rangeProofs, i]() {
+			KeyChainPath keyId(std::vector<uint32_t>({ 1, i }));
+			const uint64_t amount = 1000 + i;
+			SecretKey blindingFactor = keyChain.DerivePrivateKey(keyId, amount);
+			commitments[i] = Crypto::CommitBlinded(amount, BlindingFactor(blindingFactor.GetBytes()));
+			rangeProofs[i] = std::make_unique<RangeProof>(
+				keyChain.GenerateRangeProof(keyId, amount, commitments[i], blindingFactor, EBulletproofType::ENHANCED)
+			);
+		});
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	std::vector<const RangeProof*> pRangeProofs;
+	for (const std::unique_ptr<RangeProof>& pRangeProof : rangeProofs)
+	{
+		pRangeProofs.push_back(pRangeProof.get());
+	}
+
+	REQUIRE(Crypto::VerifyRangeProofs(commitments, pRangeProofs));
+
+	std::vector<std::unique_ptr<RewoundProof>> rewoundProofs = keyChain.RewindRangeProofs(commitments, pRangeProofs, EBulletproofType::ENHANCED);
+	for (uint32_t i = 0; i < numProofs; i++)
+	{
+		REQUIRE(rewoundProofs[i] != nullptr);
+		REQUIRE(rewoundProofs[i]->GetAmount() == 1000 + i);
+	}
+}
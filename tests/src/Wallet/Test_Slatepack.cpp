@@ -4,6 +4,9 @@
 #include <Wallet/Models/Slatepack/SlatepackMessage.h>
 #include <Wallet/Models/Slatepack/Armor.h>
 #include <Crypto/ChaChaPoly.h>
+#include <Crypto/CSPRNG.h>
+#include <Core/Serialization/Base58.h>
+#include <Common/Util/HexUtil.h>
 
 TEST_CASE("SlatepackAddress")
 {
@@ -99,4 +102,65 @@ TEST_CASE("Slatepack - E2E")
     
     REQUIRE(Slate::Deserialize(received_slatepack_buffer) == sent_slate);
     REQUIRE(received_slatepack.m_sender == sender_address);
-}
\ No newline at end of file
+}
+
+TEST_CASE("Base58 - Encode/Decode")
+{
+    // Test vectors from Bitcoin Core's base58_encode_decode.json
+    const std::vector<std::pair<std::string, std::string>> vectors = {
+        { "", "" },
+        { "61", "2g" },
+        { "626262", "a3gV" },
+        { "636363", "aPEr" },
+        { "73696d706c792061206c6f6e6720737472696e67", "2cFupjhnEsSn59qHXstmK2ffpLv2" },
+        { "00eb15231dfceb60925886b67d065299925915aeb172c06647", "1NS17iag9jJgTHD1VXjvLCEnZuQ3rJDE9L" },
+        { "516b6fcd0f", "ABnLTmg" },
+        { "bf4f89001e670274dd", "3SEo3LWLoPntC" },
+        { "572e4794", "3EFU7m" },
+        { "ecac89cad93923c02321", "EJDM8drfXA6uyA" },
+        { "10c8511e", "Rt5zm" },
+        { "00000000000000000000", "1111111111" }
+    };
+
+    for (const auto& vector : vectors)
+    {
+        const std::vector<uint8_t> bytes = HexUtil::FromHex(vector.first);
+        REQUIRE(Base58::Encode(bytes) == vector.second);
+        REQUIRE(Base58::Decode(vector.second) == bytes);
+    }
+
+    REQUIRE(Base58::Decode("  2g  ") == HexUtil::FromHex("61"));
+    REQUIRE_THROWS(Base58::Decode("2g0"));
+    REQUIRE_THROWS(Base58::Decode("2g a3gV"));
+
+    // Sizes that don't divide evenly into limbs, as well as large ones.
+    for (const size_t size : { 1, 3, 4, 5, 7, 8, 33, 1000, 12345 })
+    {
+        const SecureVector random = CSPRNG::GenerateRandomBytes(size);
+        const std::vector<uint8_t> bytes(random.cbegin(), random.cend());
+        REQUIRE(Base58::SimpleDecodeCheck(Base58::SimpleEncodeCheck(bytes)) == bytes);
+    }
+}
+
+//
+// Run with "[.benchmark]" to time armoring and dearmoring slatepacks the size of small and large slates.
+//
+TEST_CASE("Base58 - Benchmark", "[.benchmark]")
+{
+    for (const size_t size : { 1'000, 10'000, 50'000 })
+    {
+        const SecureVector random = CSPRNG::GenerateRandomBytes(size);
+        const std::vector<uint8_t> bytes(random.cbegin(), random.cend());
+        const std::string encoded = Base58::SimpleEncodeCheck(bytes);
+
+        BENCHMARK("SimpleEncodeCheck " + std::to_string(size) + " bytes")
+        {
+            REQUIRE(Base58::SimpleEncodeCheck(bytes) == encoded);
+        }
+
+        BENCHMARK("SimpleDecodeCheck " + std::to_string(size) + " bytes")
+        {
+            REQUIRE(Base58::SimpleDecodeCheck(encoded) == bytes);
+        }
+    }
+}
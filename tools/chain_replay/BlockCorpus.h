@@ -0,0 +1,134 @@
+#pragma once
+
+#include <Config/EnvironmentType.h>
+#include <Core/Models/FullBlock.h>
+#include <Core/Serialization/ByteBuffer.h>
+#include <Core/Serialization/Serializer.h>
+#include <filesystem.h>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+//
+// A recorded sequence of consecutive full blocks, starting after genesis, for replaying a sync offline.
+//
+// Format: the 8 byte magic "GRINBLKS", a 1 byte format version, and a 1 byte EEnvironmentType,
+// followed by each block as a 4 byte big endian length and the block serialized as it is sent to peers (protocol version 1).
+// Headers are not stored separately, since every block includes its header.
+//
+namespace BlockCorpus
+{
+    static const char MAGIC[8] = { 'G', 'R', 'I', 'N', 'B', 'L', 'K', 'S' };
+    static const uint8_t FORMAT_VERSION = 1;
+
+    class Writer
+    {
+    public:
+        Writer(const fs::path& path, const EEnvironmentType environment)
+            : m_file(path, std::ios::out | std::ios::binary | std::ios::trunc)
+        {
+            if (!m_file.is_open())
+            {
+                throw std::runtime_error("Failed to create " + path.u8string());
+            }
+
+            m_file.write(MAGIC, sizeof(MAGIC));
+            m_file.put((char)FORMAT_VERSION);
+            m_file.put((char)environment);
+        }
+
+        void Write(const FullBlock& block)
+        {
+            Serializer serializer;
+            block.Serialize(serializer);
+
+            Serializer length;
+            length.Append<uint32_t>((uint32_t)serializer.size());
+
+            m_file.write((const char*)length.data(), length.size());
+            m_file.write((const char*)serializer.data(), serializer.size());
+            if (!m_file.good())
+            {
+                throw std::runtime_error("Failed to write block " + std::to_string(block.GetHeight()));
+            }
+        }
+
+        void Close()
+        {
+            m_file.close();
+            if (m_file.fail())
+            {
+                throw std::runtime_error("Failed to close corpus");
+            }
+        }
+
+    private:
+        std::ofstream m_file;
+    };
+
+    class Reader
+    {
+    public:
+        explicit Reader(const fs::path& path)
+            : m_file(path, std::ios::in | std::ios::binary)
+        {
+            if (!m_file.is_open())
+            {
+                throw std::runtime_error("Failed to open " + path.u8string());
+            }
+
+            char magic[sizeof(MAGIC)];
+            m_file.read(magic, sizeof(magic));
+            const int version = m_file.get();
+            const int environment = m_file.get();
+            if (!m_file.good() || !std::equal(magic, magic + sizeof(magic), MAGIC) || version != FORMAT_VERSION)
+            {
+                throw std::runtime_error(path.u8string() + " is not a block corpus");
+            }
+
+            m_environment = (EEnvironmentType)environment;
+        }
+
+        EEnvironmentType GetEnvironment() const noexcept { return m_environment; }
+
+        // The total size of the serialized blocks read so far.
+        uint64_t GetBlockBytesRead() const noexcept { return m_blockBytesRead; }
+
+        //
+        // Returns the next block, or nullptr once every block has been read.
+        //
+        FullBlock::CPtr Next()
+        {
+            uint8_t lengthBytes[4];
+            m_file.read((char*)lengthBytes, sizeof(lengthBytes));
+            if (m_file.gcount() == 0 && m_file.eof())
+            {
+                return nullptr;
+            }
+            else if (m_file.gcount() != sizeof(lengthBytes))
+            {
+                throw std::runtime_error("Corpus is truncated");
+            }
+
+            ByteBuffer lengthBuffer(lengthBytes, sizeof(lengthBytes));
+            std::vector<uint8_t> bytes(lengthBuffer.ReadU32());
+            m_file.read((char*)bytes.data(), bytes.size());
+            if (!m_file.good())
+            {
+                throw std::runtime_error("Corpus is truncated");
+            }
+
+            m_blockBytesRead += bytes.size();
+            ByteBuffer byteBuffer(std::move(bytes));
+            return std::make_shared<const FullBlock>(FullBlock::Deserialize(byteBuffer));
+        }
+
+    private:
+        std::ifstream m_file;
+        EEnvironmentType m_environment;
+        uint64_t m_blockBytesRead = 0;
+    };
+}
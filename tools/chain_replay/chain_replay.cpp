@@ -0,0 +1,408 @@
+#include "BlockCorpus.h"
+
+#include <BlockChain/BlockChain.h>
+#include <Common/Logger.h>
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
+#include <Common/Util/FileUtil.h>
+#include <Config/ConfigLoader.h>
+#include <Core/Util/JsonUtil.h>
+#include <Crypto/Crypto.h>
+#include <Database/Database.h>
+#include <P2P/Common.h>
+#include <PMMR/HeaderMMR.h>
+#include <PMMR/TxHashSetManager.h>
+#include <TxPool/TransactionPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//
+// Records the blocks of a synced node (export), and feeds them to a fresh chain with no network involved (replay),
+// reporting the throughput and time spent in each phase, so sync performance can be compared between builds and configs.
+//
+// The node must be stopped before exporting, since its database can only be opened by one process.
+//
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage()
+{
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  chain_replay export --out=<corpus> [--floonet] [--to-height=<height>]" << std::endl;
+    std::cout << "  chain_replay replay --corpus=<corpus> --data-dir=<empty dir> [--config=<server_config.json>] [--json=<path>]" << std::endl;
+}
+
+static std::optional<std::string> GetArg(int argc, char* argv[], const std::string& name)
+{
+    const std::string prefix = "--" + name + "=";
+    for (int i = 2; i < argc; i++)
+    {
+        if (strncmp(argv[i], prefix.c_str(), prefix.size()) == 0)
+        {
+            return std::string(argv[i] + prefix.size());
+        }
+    }
+
+    return std::nullopt;
+}
+
+static bool HasFlag(int argc, char* argv[], const std::string& name)
+{
+    const std::string flag = "--" + name;
+    for (int i = 2; i < argc; i++)
+    {
+        if (flag == argv[i])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static double ToSeconds(const Clock::duration& duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+static uint64_t GetPeakRSSBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize;
+    }
+
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+//
+// Everything the chain needs, opened the same way the node opens it, minus the P2P server.
+//
+struct NodeComponents
+{
+    ConfigPtr pConfig;
+    IDatabasePtr pDatabase;
+    std::shared_ptr<Locked<TxHashSetManager>> pTxHashSetManager;
+    ITransactionPool::Ptr pTxPool;
+    std::shared_ptr<Locked<IHeaderMMR>> pHeaderMMR;
+    IBlockChain::Ptr pBlockChain;
+
+    static std::unique_ptr<NodeComponents> Open(const ConfigPtr& pConfig)
+    {
+        const NodeConfig& nodeConfig = pConfig->GetNodeConfig();
+        Crypto::SetRangeProofCacheCapacity(nodeConfig.GetRangeProofCacheSize());
+        Crypto::SetCommitmentCacheCapacity(nodeConfig.GetCommitmentCacheSize());
+        ThreadManagerAPI::ConfigureThreadPool(nodeConfig.GetNumWorkerThreads());
+
+        auto pComponents = std::make_unique<NodeComponents>();
+        pComponents->pConfig = pConfig;
+        pComponents->pDatabase = DatabaseAPI::OpenDatabase(*pConfig);
+        pComponents->pTxHashSetManager = std::make_shared<Locked<TxHashSetManager>>(std::make_shared<TxHashSetManager>(*pConfig));
+        pComponents->pTxPool = TxPoolAPI::CreateTransactionPool(*pConfig);
+        pComponents->pHeaderMMR = HeaderMMRAPI::OpenHeaderMMR(*pConfig);
+        pComponents->pBlockChain = BlockChainAPI::OpenBlockChain(
+            *pConfig,
+            pComponents->pDatabase->GetBlockDB(),
+            pComponents->pTxHashSetManager,
+            pComponents->pTxPool,
+            pComponents->pHeaderMMR
+        );
+
+        return pComponents;
+    }
+
+    ~NodeComponents()
+    {
+        // Closed in the reverse order of opening, starting with the chain that depends on everything else.
+        pBlockChain.reset();
+        pHeaderMMR.reset();
+        pTxPool.reset();
+        pTxHashSetManager.reset();
+        pDatabase.reset();
+    }
+};
+
+static int Export(int argc, char* argv[])
+{
+    const std::optional<std::string> outPath = GetArg(argc, argv, "out");
+    if (!outPath.has_value())
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    const EEnvironmentType environment = HasFlag(argc, argv, "floonet") ? EEnvironmentType::FLOONET : EEnvironmentType::MAINNET;
+    ConfigPtr pConfig = ConfigLoader::Load(environment);
+    LoggerAPI::Initialize(pConfig->GetLogDirectory(), pConfig->GetLogLevel());
+
+    auto pComponents = NodeComponents::Open(pConfig);
+
+    uint64_t toHeight = pComponents->pBlockChain->GetHeight(EChainType::CONFIRMED);
+    const std::optional<std::string> toHeightArg = GetArg(argc, argv, "to-height");
+    if (toHeightArg.has_value())
+    {
+        toHeight = (std::min)(toHeight, (uint64_t)std::stoull(toHeightArg.value()));
+    }
+
+    BlockCorpus::Writer writer(fs::u8path(outPath.value()), environment);
+    for (uint64_t height = 1; height <= toHeight; height++)
+    {
+        std::unique_ptr<FullBlock> pBlock = pComponents->pBlockChain->GetBlockByHeight(height);
+        if (pBlock == nullptr)
+        {
+            std::cout << "Block " << height << " not found. Pruned nodes can't be exported." << std::endl;
+            return -1;
+        }
+
+        writer.Write(*pBlock);
+        if (height % 10000 == 0)
+        {
+            std::cout << "Exported " << height << "/" << toHeight << std::endl;
+        }
+    }
+
+    writer.Close();
+    std::cout << "Exported blocks 1 to " << toHeight << " to " << outPath.value() << std::endl;
+    return 0;
+}
+
+//
+// Wall clock time of each step of the replay. Block processing is split further by IBlockChain::GetProcessingStats.
+//
+struct ReplayTimes
+{
+    Clock::duration read{ 0 };
+    Clock::duration headers{ 0 };
+    Clock::duration validate{ 0 };
+    Clock::duration addBlocks{ 0 };
+};
+
+static bool AddBlocks(const IBlockChain::Ptr& pBlockChain, const std::vector<FullBlock::CPtr>& blocks, ReplayTimes& times)
+{
+    // Verified on every worker before being added in order, like BlockPipe does.
+    const auto validateStart = Clock::now();
+    std::atomic<size_t> nextIndex = 0;
+    std::atomic<bool> valid = true;
+    ThreadPool& threadPool = ThreadManagerAPI::GetThreadPool();
+    threadPool.RunParallel((std::min)(blocks.size(), threadPool.GetNumThreads() + 1), [&blocks, &pBlockChain, &nextIndex, &valid]() {
+        for (size_t index = nextIndex++; index < blocks.size(); index = nextIndex++)
+        {
+            if (!pBlockChain->VerifySelfConsistent(*blocks[index]))
+            {
+                valid = false;
+            }
+        }
+    });
+    times.validate += Clock::now() - validateStart;
+
+    if (!valid)
+    {
+        std::cout << "Invalid block between heights " << blocks.front()->GetHeight() << " and " << blocks.back()->GetHeight() << std::endl;
+        return false;
+    }
+
+    const auto addStart = Clock::now();
+    const std::vector<EBlockChainStatus> statuses = pBlockChain->AddBlocks(blocks);
+    times.addBlocks += Clock::now() - addStart;
+
+    for (size_t i = 0; i < statuses.size(); i++)
+    {
+        if (statuses[i] != EBlockChainStatus::SUCCESS && statuses[i] != EBlockChainStatus::ALREADY_EXISTS)
+        {
+            std::cout << "Failed to add block " << blocks[i]->GetHeight() << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static int Replay(int argc, char* argv[])
+{
+    const std::optional<std::string> corpusPath = GetArg(argc, argv, "corpus");
+    const std::optional<std::string> dataDir = GetArg(argc, argv, "data-dir");
+    if (!corpusPath.has_value() || !dataDir.has_value())
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    // A chain left over from a previous replay would turn every block into ALREADY_EXISTS.
+    if (FileUtil::Exists(fs::u8path(dataDir.value()) / "NODE"))
+    {
+        std::cout << dataDir.value() << " already contains a chain. Replays must start from an empty directory." << std::endl;
+        return -1;
+    }
+
+    BlockCorpus::Reader reader(fs::u8path(corpusPath.value()));
+
+    Json::Value configJSON;
+    const std::optional<std::string> configPath = GetArg(argc, argv, "config");
+    if (configPath.has_value())
+    {
+        std::vector<uint8_t> bytes;
+        if (!FileUtil::ReadFile(fs::u8path(configPath.value()), bytes))
+        {
+            std::cout << "Failed to read " << configPath.value() << std::endl;
+            return -1;
+        }
+
+        configJSON = JsonUtil::Parse(bytes);
+    }
+
+    configJSON[ConfigProps::DATA_PATH] = dataDir.value();
+    ConfigPtr pConfig = Config::Load(configJSON, reader.GetEnvironment());
+    LoggerAPI::Initialize(pConfig->GetLogDirectory(), pConfig->GetLogLevel());
+
+    auto pComponents = NodeComponents::Open(pConfig);
+    const IBlockChain::Ptr& pBlockChain = pComponents->pBlockChain;
+    const BlockProcessingStats startStats = pBlockChain->GetProcessingStats();
+    const size_t groupSize = (std::max)(pConfig->GetNodeConfig().GetBlockCommitGroupSize(), (size_t)1);
+
+    // Headers are added a batch ahead of their blocks, as they would arrive from peers, rather than all up front:
+    // once every header is known, earlier blocks would be beyond the horizon, which is only reachable by a TxHashSet download.
+    ReplayTimes times;
+    uint64_t numBlocks = 0;
+    const auto start = Clock::now();
+    while (true)
+    {
+        const auto readStart = Clock::now();
+        std::vector<FullBlock::CPtr> batch;
+        while (batch.size() < P2P::MAX_BLOCK_HEADERS)
+        {
+            FullBlock::CPtr pBlock = reader.Next();
+            if (pBlock == nullptr)
+            {
+                break;
+            }
+
+            batch.push_back(pBlock);
+        }
+        times.read += Clock::now() - readStart;
+
+        if (batch.empty())
+        {
+            break;
+        }
+
+        std::vector<BlockHeaderPtr> headers;
+        std::transform(batch.cbegin(), batch.cend(), std::back_inserter(headers), [](const FullBlock::CPtr& pBlock) { return pBlock->GetHeader(); });
+
+        const auto headersStart = Clock::now();
+        const EBlockChainStatus headerStatus = pBlockChain->AddBlockHeaders(headers);
+        times.headers += Clock::now() - headersStart;
+        if (headerStatus != EBlockChainStatus::SUCCESS && headerStatus != EBlockChainStatus::ALREADY_EXISTS)
+        {
+            std::cout << "Failed to add headers " << headers.front()->GetHeight() << " to " << headers.back()->GetHeight() << std::endl;
+            return -1;
+        }
+
+        for (size_t offset = 0; offset < batch.size(); offset += groupSize)
+        {
+            const std::vector<FullBlock::CPtr> group(batch.cbegin() + offset, batch.cbegin() + (std::min)(offset + groupSize, batch.size()));
+            if (!AddBlocks(pBlockChain, group, times))
+            {
+                return -1;
+            }
+        }
+
+        numBlocks += batch.size();
+        std::cout << "Replayed " << numBlocks << " blocks" << std::endl;
+    }
+
+    const Clock::duration total = Clock::now() - start;
+    const BlockProcessingStats endStats = pBlockChain->GetProcessingStats();
+    const auto applyTime = endStats.applyTime - startStats.applyTime;
+    const auto commitTime = endStats.commitTime - startStats.commitTime;
+    const auto validateCpuTime = endStats.validateTime - startStats.validateTime;
+    const uint64_t peakRSS = GetPeakRSSBytes();
+
+    const uint64_t numBytes = reader.GetBlockBytesRead();
+    const double seconds = ToSeconds(total);
+    printf("\nReplayed %llu blocks (%.1f MB) in %.2fs\n", (unsigned long long)numBlocks, numBytes / 1e6, seconds);
+    printf("  blocks/sec:             %.1f\n", seconds > 0 ? numBlocks / seconds : 0.0);
+    printf("  read corpus:            %.2fs\n", ToSeconds(times.read));
+    printf("  add headers:            %.2fs\n", ToSeconds(times.headers));
+    printf("  validate (wall):        %.2fs\n", ToSeconds(times.validate));
+    printf("  validate (all threads): %.2fs\n", ToSeconds(validateCpuTime));
+    printf("  apply:                  %.2fs\n", ToSeconds(applyTime));
+    printf("  commit:                 %.2fs\n", ToSeconds(commitTime));
+    printf("  other block processing: %.2fs\n", ToSeconds(times.addBlocks - applyTime - commitTime));
+    printf("  peak RSS:               %.1f MB\n", peakRSS / 1e6);
+
+    const std::optional<std::string> jsonPath = GetArg(argc, argv, "json");
+    if (jsonPath.has_value())
+    {
+        Json::Value json;
+        json["blocks"] = Json::UInt64(numBlocks);
+        json["bytes"] = Json::UInt64(numBytes);
+        json["total_secs"] = seconds;
+        json["blocks_per_sec"] = seconds > 0 ? numBlocks / seconds : 0.0;
+        json["read_secs"] = ToSeconds(times.read);
+        json["headers_secs"] = ToSeconds(times.headers);
+        json["validate_secs"] = ToSeconds(times.validate);
+        json["validate_thread_secs"] = ToSeconds(validateCpuTime);
+        json["apply_secs"] = ToSeconds(applyTime);
+        json["commit_secs"] = ToSeconds(commitTime);
+        json["add_blocks_secs"] = ToSeconds(times.addBlocks);
+        json["peak_rss_bytes"] = Json::UInt64(peakRSS);
+        FileUtil::WriteTextToFile(fs::u8path(jsonPath.value()), JsonUtil::WriteCondensed(json));
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    const std::string command = argc > 1 ? argv[1] : "";
+
+    try
+    {
+        if (command == "export")
+        {
+            return Export(argc, argv);
+        }
+        else if (command == "replay")
+        {
+            return Replay(argc, argv);
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Failed: " << e.what() << std::endl;
+        LoggerAPI::Flush();
+        return -1;
+    }
+
+    PrintUsage();
+    return -1;
+}
@@ -0,0 +1,630 @@
+#include <SimNetwork.h>
+#include <TxBuilder.h>
+#include <TestMiner.h>
+
+#include <BlockChain/BlockChain.h>
+#include <Common/Util/FileUtil.h>
+#include <Core/Util/FeeUtil.h>
+#include <Core/Util/JsonUtil.h>
+#include <Core/Util/TransactionUtil.h>
+#include <TxPool/PoolEvent.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+//
+// Generates a graph of chained spends (plus a fraction of invalid transactions), and measures how the transaction pool handles it:
+//   * injection: how fast txs are accepted, either added directly (as push_transaction does) or relayed by a peer,
+//     so they go through the receiving node's TransactionPipe
+//   * blocks: the time spent reconciling the pools, as blocks mining the injected txs are connected
+//   * dandelion: how long stemmed txs take to be fluffed into a mempool
+//   * memory: the pools' estimated usage, and the process' peak RSS
+//
+// Runs on a 2 node SimNetwork (see tests/include/SimNetwork.h), so needs 127.0.0.2 and 127.0.0.3 on the loopback interface.
+//
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage()
+{
+    std::cout << "Usage: mempool_stress [--roots=<n>] [--depth=<n>] [--fanout=<n>] [--invalid=<fraction>] [--mode=push|pipe]" << std::endl;
+    std::cout << "                      [--blocks=<n>] [--stem=<n>] [--seed=<n>] [--json=<path>]" << std::endl;
+}
+
+static std::optional<std::string> GetArg(int argc, char* argv[], const std::string& name)
+{
+    const std::string prefix = "--" + name + "=";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], prefix.c_str(), prefix.size()) == 0)
+        {
+            return std::string(argv[i] + prefix.size());
+        }
+    }
+
+    return std::nullopt;
+}
+
+static size_t GetSizeArg(int argc, char* argv[], const std::string& name, const size_t defaultValue)
+{
+    const std::optional<std::string> value = GetArg(argc, argv, name);
+    return value.has_value() ? (size_t)std::stoull(value.value()) : defaultValue;
+}
+
+static double ToSeconds(const Clock::duration& duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+static uint64_t GetPeakRSSBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return counters.PeakWorkingSetSize;
+    }
+
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+
+#ifdef __APPLE__
+    return usage.ru_maxrss;
+#else
+    return (uint64_t)usage.ru_maxrss * 1024;
+#endif
+#endif
+}
+
+static double Percentile(std::vector<double> values, const double percentile)
+{
+    if (values.empty())
+    {
+        return 0.0;
+    }
+
+    std::sort(values.begin(), values.end());
+    const size_t rank = (size_t)std::ceil((percentile / 100.0) * values.size());
+    return values[(std::max)(rank, (size_t)1) - 1];
+}
+
+enum class EInvalidKind
+{
+    // Spends an output another tx in the graph already spends.
+    DOUBLE_SPEND,
+
+    // Spends an output that was never created.
+    MISSING_INPUT,
+
+    // Has its kernel's fee changed after signing. Peers relaying these get banned, so they're only generated in push mode.
+    BAD_SIGNATURE
+};
+
+struct GeneratedTx
+{
+    TransactionPtr pTransaction;
+    bool valid;
+};
+
+//
+// Builds depth chained spends from each root: every tx spends the first output of the previous one, and creates fanout outputs.
+// Txs are ordered level by level, so every parent comes before its children.
+//
+class TxGraph
+{
+public:
+    TxGraph(const KeyChain& keyChain, const uint64_t seed)
+        : m_keyChain(keyChain), m_txBuilder(keyChain), m_rng(seed), m_nextPath(0) { }
+
+    std::vector<GeneratedTx> Generate(
+        const std::vector<Test::Input>& roots,
+        const size_t depth,
+        const size_t fanout,
+        const double invalidFraction,
+        const std::vector<EInvalidKind>& invalidKinds)
+    {
+        std::vector<Test::Input> tips = roots;
+        std::vector<GeneratedTx> txs;
+        std::bernoulli_distribution isInvalid(invalidFraction);
+        size_t numInvalid = 0;
+        for (size_t level = 0; level < depth; level++)
+        {
+            for (Test::Input& tip : tips)
+            {
+                Test::Tx tx = BuildSpend(tip, fanout);
+                txs.push_back(GeneratedTx{ tx.pTransaction, true });
+
+                if (!invalidKinds.empty() && isInvalid(m_rng))
+                {
+                    const EInvalidKind kind = invalidKinds[numInvalid++ % invalidKinds.size()];
+                    txs.push_back(GeneratedTx{ BuildInvalid(kind, tip, tx), false });
+                }
+
+                // The tx's outputs are sorted, so the first output built is found by its commitment.
+                const Test::Output& next = tx.outputs.front();
+                tip = Test::Input{ TransactionInput(EOutputFeatures::DEFAULT, Commit(next.path, next.amount)), next.path, next.amount };
+            }
+        }
+
+        return txs;
+    }
+
+    Test::Tx BuildSpend(const Test::Input& input, const size_t fanout)
+    {
+        const uint64_t fee = FeeUtil::CalculateFee(1'000'000, 1, (int64_t)fanout, 1);
+        const uint64_t amount = (input.amount - fee) / fanout;
+
+        std::vector<Test::Output> outputs;
+        for (size_t i = 0; i < fanout; i++)
+        {
+            // The first output gets the remainder, so the input is spent exactly.
+            const uint64_t outputAmount = i == 0 ? (input.amount - fee) - (amount * (fanout - 1)) : amount;
+            outputs.push_back(Test::Output{ KeyChainPath({ 3, m_nextPath++ }), outputAmount });
+        }
+
+        Transaction transaction = m_txBuilder.BuildTx(fee, { input }, outputs);
+        return Test::Tx{ std::make_shared<Transaction>(std::move(transaction)), { input }, outputs };
+    }
+
+private:
+    Commitment Commit(const KeyChainPath& path, const uint64_t amount) const
+    {
+        return Crypto::CommitBlinded(amount, BlindingFactor(m_keyChain.DerivePrivateKey(path, amount).GetBytes()));
+    }
+
+    TransactionPtr BuildInvalid(const EInvalidKind kind, const Test::Input& input, const Test::Tx& validTx)
+    {
+        switch (kind)
+        {
+            case EInvalidKind::DOUBLE_SPEND:
+            {
+                return BuildSpend(input, 1).pTransaction;
+            }
+            case EInvalidKind::MISSING_INPUT:
+            {
+                const KeyChainPath path({ 4, m_nextPath++ });
+                Test::Input missing{ TransactionInput(EOutputFeatures::DEFAULT, Commit(path, input.amount)), path, input.amount };
+                return BuildSpend(missing, 1).pTransaction;
+            }
+            case EInvalidKind::BAD_SIGNATURE:
+            {
+                const TransactionKernel& kernel = validTx.pTransaction->GetKernels().front();
+                TransactionKernel tampered(
+                    kernel.GetFeatures(),
+                    kernel.GetFee() + 1,
+                    kernel.GetLockHeight(),
+                    kernel.GetExcessCommitment(),
+                    kernel.GetExcessSignature()
+                );
+                return std::make_shared<Transaction>(
+                    BlindingFactor(validTx.pTransaction->GetOffset()),
+                    TransactionBody(
+                        std::vector<TransactionInput>(validTx.pTransaction->GetInputs()),
+                        std::vector<TransactionOutput>(validTx.pTransaction->GetOutputs()),
+                        std::vector<TransactionKernel>({ tampered })
+                    )
+                );
+            }
+        }
+
+        throw std::invalid_argument("Unknown invalid kind");
+    }
+
+    const KeyChain& m_keyChain;
+    TxBuilder m_txBuilder;
+    std::mt19937_64 m_rng;
+    uint32_t m_nextPath;
+};
+
+//
+// Records when each kernel first appeared in the node's mempool, from its pool events, so aggregated (eg. fluffed) txs are matched too.
+//
+class MempoolWatcher
+{
+public:
+    MempoolWatcher(const ITransactionPool::Ptr& pTxPool)
+        : m_pTxPool(pTxPool), m_sequence(pTxPool->GetEventSequence()) { }
+
+    void Poll()
+    {
+        if (m_pTxPool->GetEventSequence() == m_sequence)
+        {
+            return;
+        }
+
+        const auto now = Clock::now();
+        std::optional<std::vector<TxPoolEvent>> eventsOpt = m_pTxPool->GetEventsSince(m_sequence);
+        if (!eventsOpt.has_value())
+        {
+            // Fell behind. Missed kernels are just reported late, by the fallback lookup in Contains.
+            m_sequence = m_pTxPool->GetEventSequence();
+            return;
+        }
+
+        for (const TxPoolEvent& event : eventsOpt.value())
+        {
+            m_sequence = event.GetSequence();
+            if (event.GetType() == EPoolEventType::ADDED)
+            {
+                for (const TransactionKernel& kernel : event.GetTransaction()->GetKernels())
+                {
+                    m_added.emplace(kernel.GetHash(), now);
+                }
+            }
+        }
+    }
+
+    std::optional<Clock::time_point> GetAddedTime(const Hash& kernelHash) const
+    {
+        auto iter = m_added.find(kernelHash);
+        return iter != m_added.end() ? std::make_optional(iter->second) : std::nullopt;
+    }
+
+private:
+    ITransactionPool::Ptr m_pTxPool;
+    uint64_t m_sequence;
+    std::unordered_map<Hash, Clock::time_point> m_added;
+};
+
+struct InjectionResult
+{
+    size_t numAccepted = 0;
+    size_t numRejected = 0;
+    size_t numUnexpected = 0;
+    double seconds = 0.0;
+    std::vector<double> latenciesMs;
+};
+
+//
+// Adds every tx to the node directly, one at a time, like push_transaction does.
+//
+static InjectionResult InjectDirectly(const IBlockChain::Ptr& pBlockChain, const std::vector<GeneratedTx>& txs)
+{
+    InjectionResult result;
+    const auto start = Clock::now();
+    for (const GeneratedTx& tx : txs)
+    {
+        const auto txStart = Clock::now();
+        const bool accepted = pBlockChain->AddTransaction(tx.pTransaction, EPoolType::MEMPOOL) == EBlockChainStatus::SUCCESS;
+        result.latenciesMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - txStart).count());
+
+        accepted ? ++result.numAccepted : ++result.numRejected;
+        if (accepted != tx.valid)
+        {
+            ++result.numUnexpected;
+        }
+    }
+
+    result.seconds = ToSeconds(Clock::now() - start);
+    return result;
+}
+
+//
+// Relays every tx from the source node, so the target's TransactionPipe validates them in batches.
+// Latency is measured from when the tx was sent until it was in the target's mempool.
+//
+static InjectionResult InjectThroughPipe(SimNetwork& network, const size_t source, const size_t target, const std::vector<GeneratedTx>& txs, const std::chrono::seconds timeout)
+{
+    MempoolWatcher watcher(network.GetServer(target)->GetTxPool());
+    std::vector<Clock::time_point> sent;
+
+    InjectionResult result;
+    const auto start = Clock::now();
+    for (const GeneratedTx& tx : txs)
+    {
+        sent.push_back(Clock::now());
+        network.GetP2PServer(source)->BroadcastTransaction(tx.pTransaction);
+        watcher.Poll();
+    }
+
+    const size_t numValid = std::count_if(txs.cbegin(), txs.cend(), [](const GeneratedTx& tx) { return tx.valid; });
+    Clock::time_point lastAccepted = start;
+    while (Clock::now() - start < timeout)
+    {
+        watcher.Poll();
+
+        size_t numAccepted = 0;
+        for (const GeneratedTx& tx : txs)
+        {
+            if (watcher.GetAddedTime(tx.pTransaction->GetKernels().front().GetHash()).has_value())
+            {
+                ++numAccepted;
+            }
+        }
+
+        if (numAccepted >= numValid)
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // Waits a little longer, so invalid txs that would have been (wrongly) accepted are counted.
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    watcher.Poll();
+
+    for (size_t i = 0; i < txs.size(); i++)
+    {
+        std::optional<Clock::time_point> addedOpt = watcher.GetAddedTime(txs[i].pTransaction->GetKernels().front().GetHash());
+        if (addedOpt.has_value())
+        {
+            ++result.numAccepted;
+            result.latenciesMs.push_back(std::chrono::duration<double, std::milli>(addedOpt.value() - sent[i]).count());
+            lastAccepted = (std::max)(lastAccepted, addedOpt.value());
+        }
+        else
+        {
+            ++result.numRejected;
+        }
+
+        if (addedOpt.has_value() != txs[i].valid)
+        {
+            ++result.numUnexpected;
+        }
+    }
+
+    result.seconds = ToSeconds(lastAccepted - start);
+    return result;
+}
+
+struct BlockResult
+{
+    size_t numBlocks = 0;
+    size_t numMined = 0;
+    std::vector<double> addBlockMs;
+    std::vector<double> reconcileMs;
+};
+
+//
+// Mines the valid txs (in order, so parents are mined before or with their children) into numBlocks blocks on the node.
+// The blocks are then added to the other nodes too, so they don't start syncing in the middle of the dandelion phase.
+//
+static BlockResult MineBlocks(SimNetwork& network, const size_t node, const std::vector<GeneratedTx>& txs, const size_t numBlocks)
+{
+    std::vector<TransactionPtr> valid;
+    for (const GeneratedTx& tx : txs)
+    {
+        if (tx.valid)
+        {
+            valid.push_back(tx.pTransaction);
+        }
+    }
+
+    const std::shared_ptr<TestServer>& pServer = network.GetServer(node);
+    TestMiner miner(pServer);
+    TxBuilder txBuilder(network.GetKeyChain());
+
+    BlockResult result;
+    const size_t perBlock = (valid.size() + numBlocks - 1) / (std::max)(numBlocks, (size_t)1);
+    for (size_t i = 0; i < numBlocks; i++)
+    {
+        const size_t first = (std::min)(i * perBlock, valid.size());
+        std::vector<TransactionPtr> blockTxs(valid.begin() + first, valid.begin() + (std::min)(first + perBlock, valid.size()));
+
+        uint64_t fees = 0;
+        for (const TransactionPtr& pTransaction : blockTxs)
+        {
+            for (const TransactionKernel& kernel : pTransaction->GetKernels())
+            {
+                fees += kernel.GetFee();
+            }
+        }
+
+        blockTxs.push_back(txBuilder.BuildCoinbaseTx(KeyChainPath({ 5, (uint32_t)i }), Consensus::REWARD + fees).pTransaction);
+        const FullBlock block = miner.MineNextBlock(
+            pServer->GetBlockChain()->GetTipBlockHeader(EChainType::CONFIRMED),
+            *TransactionUtil::Aggregate(blockTxs)
+        );
+
+        const TxPoolStats before = pServer->GetTxPool()->GetStats();
+        const auto start = Clock::now();
+        if (pServer->GetBlockChain()->AddBlock(block) != EBlockChainStatus::SUCCESS)
+        {
+            throw std::runtime_error("Failed to add block " + std::to_string(block.GetHeight()));
+        }
+
+        result.addBlockMs.push_back(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+        const TxPoolStats after = pServer->GetTxPool()->GetStats();
+        result.reconcileMs.push_back((after.reconcileMicros - before.reconcileMicros) / 1000.0);
+        result.numMined += blockTxs.size() - 1;
+        ++result.numBlocks;
+
+        for (size_t other = 0; other < network.GetNumNodes(); other++)
+        {
+            if (other != node)
+            {
+                network.GetServer(other)->GetBlockChain()->AddBlock(block);
+            }
+        }
+    }
+
+    return result;
+}
+
+//
+// Stems each tx from the node, and waits until it's been fluffed (on its own or aggregated) into any node's mempool.
+//
+static std::vector<double> MeasureDandelion(SimNetwork& network, const size_t node, const std::vector<GeneratedTx>& txs, const std::chrono::seconds timeout)
+{
+    std::vector<MempoolWatcher> watchers;
+    for (size_t i = 0; i < network.GetNumNodes(); i++)
+    {
+        watchers.push_back(MempoolWatcher(network.GetServer(i)->GetTxPool()));
+    }
+
+    const auto start = Clock::now();
+    for (const GeneratedTx& tx : txs)
+    {
+        network.GetServer(node)->GetBlockChain()->AddTransaction(tx.pTransaction, EPoolType::STEMPOOL);
+    }
+
+    std::vector<double> delays;
+    std::vector<bool> fluffed(txs.size(), false);
+    while (delays.size() < txs.size() && Clock::now() - start < timeout)
+    {
+        for (MempoolWatcher& watcher : watchers)
+        {
+            watcher.Poll();
+        }
+
+        for (size_t i = 0; i < txs.size(); i++)
+        {
+            for (const MempoolWatcher& watcher : watchers)
+            {
+                std::optional<Clock::time_point> addedOpt = watcher.GetAddedTime(txs[i].pTransaction->GetKernels().front().GetHash());
+                if (!fluffed[i] && addedOpt.has_value())
+                {
+                    fluffed[i] = true;
+                    delays.push_back(std::chrono::duration<double, std::milli>(addedOpt.value() - start).count());
+                }
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+
+    return delays;
+}
+
+static void PrintLatencies(const char* label, const std::vector<double>& latenciesMs)
+{
+    printf("  %-22s p50=%.2fms p90=%.2fms p99=%.2fms max=%.2fms\n", label,
+        Percentile(latenciesMs, 50), Percentile(latenciesMs, 90), Percentile(latenciesMs, 99), Percentile(latenciesMs, 100));
+}
+
+static Json::Value LatenciesToJSON(const std::vector<double>& latenciesMs)
+{
+    Json::Value json;
+    json["count"] = Json::UInt64(latenciesMs.size());
+    json["p50_ms"] = Percentile(latenciesMs, 50);
+    json["p90_ms"] = Percentile(latenciesMs, 90);
+    json["p99_ms"] = Percentile(latenciesMs, 99);
+    json["max_ms"] = Percentile(latenciesMs, 100);
+    return json;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc > 1 && std::string(argv[1]) == "--help")
+    {
+        PrintUsage();
+        return 0;
+    }
+
+    const size_t numRoots = (std::max)(GetSizeArg(argc, argv, "roots", 50), (size_t)1);
+    const size_t depth = (std::max)(GetSizeArg(argc, argv, "depth", 10), (size_t)1);
+    const size_t fanout = (std::max)(GetSizeArg(argc, argv, "fanout", 2), (size_t)1);
+    const size_t numBlocks = GetSizeArg(argc, argv, "blocks", 5);
+    const size_t numStem = GetSizeArg(argc, argv, "stem", 20);
+    const uint64_t seed = GetSizeArg(argc, argv, "seed", 1);
+    const double invalidFraction = std::stod(GetArg(argc, argv, "invalid").value_or("0.1"));
+    const bool pipe = GetArg(argc, argv, "mode").value_or("push") == "pipe";
+
+    try
+    {
+        SimNetwork::Options options;
+        options.numNodes = 2;
+        options.topology = SimNetwork::ETopology::LINE;
+        options.stemProbability = 90;
+        options.timeout = std::chrono::seconds(300);
+
+        SimNetwork network(options);
+        network.Fund(numRoots + numStem);
+
+        // Pipe mode relays from node 0 to node 1. Push mode adds to node 0 directly, and node 1 just exists for dandelion.
+        const size_t target = pipe ? 1 : 0;
+        std::vector<EInvalidKind> invalidKinds = { EInvalidKind::DOUBLE_SPEND, EInvalidKind::MISSING_INPUT };
+        if (!pipe)
+        {
+            invalidKinds.push_back(EInvalidKind::BAD_SIGNATURE);
+        }
+
+        const auto generateStart = Clock::now();
+        TxGraph graph(network.GetKeyChain(), seed);
+        const std::vector<GeneratedTx> txs = graph.Generate(network.TakeSpendable(numRoots), depth, fanout, invalidFraction, invalidKinds);
+        std::vector<GeneratedTx> stemTxs;
+        for (const Test::Input& input : network.TakeSpendable(numStem))
+        {
+            stemTxs.push_back(GeneratedTx{ graph.BuildSpend(input, 1).pTransaction, true });
+        }
+        const double generateSecs = ToSeconds(Clock::now() - generateStart);
+
+        network.Connect();
+
+        const ITransactionPool::Ptr& pTxPool = network.GetServer(target)->GetTxPool();
+        const size_t memoryBefore = pTxPool->GetStats().memPool.memoryUsage;
+        const InjectionResult injection = pipe
+            ? InjectThroughPipe(network, 0, 1, txs, options.timeout)
+            : InjectDirectly(network.GetServer(0)->GetBlockChain(), txs);
+        const TxPoolStats afterInjection = pTxPool->GetStats();
+
+        const BlockResult blocks = MineBlocks(network, target, txs, numBlocks);
+        const std::vector<double> stemDelays = MeasureDandelion(network, 0, stemTxs, options.timeout);
+        const uint64_t peakRSS = GetPeakRSSBytes();
+
+        printf("\nGenerated %zu txs (%zu roots x %zu deep, %zu outputs each, %.0f%% invalid) in %.2fs\n",
+            txs.size(), numRoots, depth, fanout, invalidFraction * 100, generateSecs);
+        printf("Injection (%s): %zu accepted, %zu rejected, %zu unexpected, in %.2fs: %.1f accepted/sec\n",
+            pipe ? "pipe" : "push", injection.numAccepted, injection.numRejected, injection.numUnexpected,
+            injection.seconds, injection.seconds > 0 ? injection.numAccepted / injection.seconds : 0.0);
+        PrintLatencies(pipe ? "sent to mempool:" : "AddTransaction:", injection.latenciesMs);
+        printf("  mempool:                %zu txs, %.1f MB (+%.1f MB)\n", afterInjection.memPool.numTransactions,
+            afterInjection.memPool.memoryUsage / 1e6, (afterInjection.memPool.memoryUsage - (std::min)(memoryBefore, afterInjection.memPool.memoryUsage)) / 1e6);
+        printf("Blocks: %zu mining %zu txs, %zu txs left in the mempool\n", blocks.numBlocks, blocks.numMined, pTxPool->GetStats().memPool.numTransactions);
+        PrintLatencies("AddBlock:", blocks.addBlockMs);
+        PrintLatencies("ReconcileBlock:", blocks.reconcileMs);
+        printf("Dandelion: %zu/%zu stemmed txs fluffed\n", stemDelays.size(), stemTxs.size());
+        PrintLatencies("stem to fluff:", stemDelays);
+        printf("Peak RSS: %.1f MB\n", peakRSS / 1e6);
+
+        const std::optional<std::string> jsonPath = GetArg(argc, argv, "json");
+        if (jsonPath.has_value())
+        {
+            Json::Value json;
+            json["mode"] = pipe ? "pipe" : "push";
+            json["txs"] = Json::UInt64(txs.size());
+            json["accepted"] = Json::UInt64(injection.numAccepted);
+            json["rejected"] = Json::UInt64(injection.numRejected);
+            json["unexpected"] = Json::UInt64(injection.numUnexpected);
+            json["inject_secs"] = injection.seconds;
+            json["accepted_per_sec"] = injection.seconds > 0 ? injection.numAccepted / injection.seconds : 0.0;
+            json["inject_latency"] = LatenciesToJSON(injection.latenciesMs);
+            json["mempool_bytes"] = Json::UInt64(afterInjection.memPool.memoryUsage);
+            json["add_block_latency"] = LatenciesToJSON(blocks.addBlockMs);
+            json["reconcile_latency"] = LatenciesToJSON(blocks.reconcileMs);
+            json["stem_to_fluff_latency"] = LatenciesToJSON(stemDelays);
+            json["peak_rss_bytes"] = Json::UInt64(peakRSS);
+            FileUtil::WriteTextToFile(fs::u8path(jsonPath.value()), JsonUtil::WriteCondensed(json));
+        }
+
+        return injection.numUnexpected == 0 ? 0 : 1;
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Stress test failed: " << e.what() << std::endl;
+        return -1;
+    }
+}
@@ -0,0 +1,50 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+
+#include <Config/Genesis.h>
+#include <Core/Models/FullBlock.h>
+#include <Core/Serialization/Serializer.h>
+#include <Core/Serialization/ByteBuffer.h>
+
+//
+// Measures block serialization and deserialization throughput, using the mainnet genesis block.
+// Run it against two builds to compare the codec before and after a change.
+//
+int main(int argc, char* argv[])
+{
+    const size_t iterations = argc > 1 ? std::stoul(argv[1]) : 100000;
+    const FullBlock& block = Genesis::MAINNET_GENESIS;
+
+    Serializer reference;
+    block.Serialize(reference);
+    const std::vector<uint8_t> bytes = reference.GetBytes();
+
+    size_t totalBytes = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        Serializer serializer(bytes.size());
+        block.Serialize(serializer);
+        totalBytes += serializer.size();
+    }
+    const double serializeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t bytesRead = 0;
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        ByteBuffer byteBuffer(bytes.data(), bytes.size());
+        const FullBlock deserialized = FullBlock::Deserialize(byteBuffer);
+        bytesRead += byteBuffer.GetIndex();
+    }
+    const double deserializeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const double megabytesWritten = (double)totalBytes / (1024 * 1024);
+    const double megabytesRead = (double)bytesRead / (1024 * 1024);
+    std::cout << "Block size: " << bytes.size() << " bytes, iterations: " << iterations << std::endl;
+    std::cout << "Serialize:   " << (iterations / serializeSeconds) << " blocks/s, " << (megabytesWritten / serializeSeconds) << " MB/s" << std::endl;
+    std::cout << "Deserialize: " << (iterations / deserializeSeconds) << " blocks/s, " << (megabytesRead / deserializeSeconds) << " MB/s" << std::endl;
+
+    return 0;
+}
@@ -1,23 +1,66 @@
 #include <iostream>
 
+#include <Common/ThreadManager.h>
+#include <Common/ThreadPool.h>
 #include <Common/Util/FileUtil.h>
 #include <Core/Models/Transaction.h>
+#include <Core/Serialization/ByteBuffer.h>
 #include <Core/Util/JsonUtil.h>
 #include <Core/Validation/TransactionValidator.h>
 
 #include "../../src/P2P/Messages/TransactionMessage.h"
 
-int main(int argc, char* argv[])
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <string>
+
+//
+// Validates a single tx json file, or (in batch mode) a whole exported set of transactions,
+// checking them in chunks on the shared thread pool with batched rangeproof and kernel signature verification.
+//
+
+using Clock = std::chrono::steady_clock;
+
+static void PrintUsage()
 {
-    if (argc < 2)
+    std::cout << "Usage:" << std::endl;
+    std::cout << "  tx_verifier <tx.json>" << std::endl;
+    std::cout << "  tx_verifier batch (--dir=<dir> | --ndjson=<file|-> | --binary=<file|->) [--threads=<n>] [--batch-size=<n>] [--protocol=<1|2>] [--json=<path>]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  --dir:    every *.json file holds one tx json, and every other file holds serialized txs back to back." << std::endl;
+    std::cout << "  --ndjson: one tx json per line." << std::endl;
+    std::cout << "  --binary: serialized txs back to back, as in a tx message without its header." << std::endl;
+}
+
+static std::optional<std::string> GetArg(int argc, char* argv[], const std::string& name)
+{
+    const std::string prefix = "--" + name + "=";
+    for (int i = 2; i < argc; i++)
     {
-        std::cout << "Usage: tx_verifier <tx.json>" << std::endl;
-        return -1;
+        if (strncmp(argv[i], prefix.c_str(), prefix.size()) == 0)
+        {
+            return std::string(argv[i] + prefix.size());
+        }
     }
 
+    return std::nullopt;
+}
+
+static double ToSeconds(const Clock::duration& duration)
+{
+    return std::chrono::duration<double>(duration).count();
+}
+
+static int VerifySingle(const char* path)
+{
     std::vector<uint8_t> bytes;
-    if (!FileUtil::ReadFile(argv[1], bytes)) {
-        std::cout << "Failed to read json file at: " << argv[1] << std::endl;
+    if (!FileUtil::ReadFile(path, bytes)) {
+        std::cout << "Failed to read json file at: " << path << std::endl;
         return -1;
     }
 
@@ -60,4 +103,411 @@ int main(int argc, char* argv[])
     std::cout << HexUtil::ConvertToHex(std::vector<uint8_t>{ bytes.begin() + 11, bytes.end() }) << std::endl;
 
     return 0;
-}
\ No newline at end of file
+}
+
+//
+// A transaction read from the input, or the reason it couldn't be read.
+// The label (file, file:line or file@offset) is what failures are reported against.
+//
+struct InputTx
+{
+    std::string label;
+    TransactionPtr pTransaction;
+    std::string error;
+};
+
+//
+// Reads the transactions one at a time, so a batch never needs more than --batch-size of them in memory.
+// A binary stream can't be resynchronized after a bad tx, so the rest of that stream is skipped.
+//
+class TxReader
+{
+public:
+    TxReader(std::vector<fs::path>&& jsonFiles, std::vector<fs::path>&& binaryFiles, const EProtocolVersion protocol)
+        : m_jsonFiles(std::move(jsonFiles)), m_binaryFiles(std::move(binaryFiles)), m_protocol(protocol) { }
+
+    static std::unique_ptr<TxReader> FromDirectory(const fs::path& dir, const EProtocolVersion protocol)
+    {
+        std::vector<fs::path> jsonFiles;
+        std::vector<fs::path> binaryFiles;
+        for (const fs::directory_entry& entry : fs::directory_iterator(dir))
+        {
+            if (entry.is_regular_file())
+            {
+                (entry.path().extension() == ".json" ? jsonFiles : binaryFiles).push_back(entry.path());
+            }
+        }
+
+        std::sort(jsonFiles.begin(), jsonFiles.end());
+        std::sort(binaryFiles.begin(), binaryFiles.end());
+        return std::make_unique<TxReader>(std::move(jsonFiles), std::move(binaryFiles), protocol);
+    }
+
+    static std::unique_ptr<TxReader> FromNDJSON(const std::string& path, const EProtocolVersion protocol)
+    {
+        auto pReader = std::make_unique<TxReader>(std::vector<fs::path>{}, std::vector<fs::path>{}, protocol);
+        pReader->m_ndjsonLabel = path;
+        if (path == "-")
+        {
+            pReader->m_pLines = &std::cin;
+        }
+        else
+        {
+            pReader->m_ndjsonFile.open(fs::u8path(path));
+            if (!pReader->m_ndjsonFile.is_open())
+            {
+                throw std::runtime_error("Failed to open " + path);
+            }
+
+            pReader->m_pLines = &pReader->m_ndjsonFile;
+        }
+
+        return pReader;
+    }
+
+    static std::unique_ptr<TxReader> FromBinary(const std::string& path, const EProtocolVersion protocol)
+    {
+        auto pReader = std::make_unique<TxReader>(std::vector<fs::path>{}, std::vector<fs::path>{}, protocol);
+        if (path == "-")
+        {
+            pReader->m_stdinBinary = true;
+        }
+        else
+        {
+            pReader->m_binaryFiles.push_back(fs::u8path(path));
+        }
+
+        return pReader;
+    }
+
+    size_t GetNumFiles() const noexcept { return m_numFiles; }
+
+    bool Next(InputTx& tx)
+    {
+        while (true)
+        {
+            if (m_pBuffer != nullptr)
+            {
+                if (m_pBuffer->GetRemainingSize() > 0)
+                {
+                    const size_t offset = m_bufferSize - m_pBuffer->GetRemainingSize();
+                    tx = InputTx{ m_bufferLabel + "@" + std::to_string(offset), nullptr, "" };
+                    try
+                    {
+                        tx.pTransaction = std::make_shared<Transaction>(Transaction::Deserialize(*m_pBuffer));
+                    }
+                    catch (std::exception& e)
+                    {
+                        tx.error = std::string("Failed to deserialize: ") + e.what();
+                        m_pBuffer.reset();
+                    }
+
+                    return true;
+                }
+
+                m_pBuffer.reset();
+            }
+
+            if (m_pLines != nullptr)
+            {
+                std::string line;
+                while (std::getline(*m_pLines, line))
+                {
+                    ++m_lineNumber;
+                    if (line.find_first_not_of(" \t\r") != std::string::npos)
+                    {
+                        tx = FromJSON(m_ndjsonLabel + ":" + std::to_string(m_lineNumber), line);
+                        return true;
+                    }
+                }
+
+                m_pLines = nullptr;
+                ++m_numFiles;
+            }
+
+            if (m_nextJson < m_jsonFiles.size())
+            {
+                const fs::path& path = m_jsonFiles[m_nextJson++];
+                ++m_numFiles;
+
+                std::vector<uint8_t> bytes;
+                if (!FileUtil::ReadFile(path, bytes))
+                {
+                    tx = InputTx{ path.u8string(), nullptr, "Failed to read file" };
+                    return true;
+                }
+
+                tx = FromJSON(path.u8string(), std::string(bytes.cbegin(), bytes.cend()));
+                return true;
+            }
+
+            if (m_stdinBinary)
+            {
+                m_stdinBinary = false;
+                ++m_numFiles;
+                std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(std::cin)), std::istreambuf_iterator<char>());
+                StartBuffer("-", std::move(bytes));
+                continue;
+            }
+
+            if (m_nextBinary < m_binaryFiles.size())
+            {
+                const fs::path& path = m_binaryFiles[m_nextBinary++];
+                ++m_numFiles;
+
+                std::vector<uint8_t> bytes;
+                if (!FileUtil::ReadFile(path, bytes))
+                {
+                    tx = InputTx{ path.u8string(), nullptr, "Failed to read file" };
+                    return true;
+                }
+
+                StartBuffer(path.u8string(), std::move(bytes));
+                continue;
+            }
+
+            return false;
+        }
+    }
+
+private:
+    static InputTx FromJSON(const std::string& label, const std::string& text)
+    {
+        Json::Value json;
+        if (!JsonUtil::Parse(text, json))
+        {
+            return InputTx{ label, nullptr, "Failed to parse json" };
+        }
+
+        try
+        {
+            return InputTx{ label, std::make_shared<Transaction>(Transaction::FromJSON(json)), "" };
+        }
+        catch (std::exception& e)
+        {
+            return InputTx{ label, nullptr, std::string("Failed to parse transaction: ") + e.what() };
+        }
+    }
+
+    void StartBuffer(const std::string& label, std::vector<uint8_t>&& bytes)
+    {
+        m_bufferLabel = label;
+        m_bufferSize = bytes.size();
+        m_pBuffer = std::make_unique<ByteBuffer>(std::move(bytes), m_protocol);
+    }
+
+    std::vector<fs::path> m_jsonFiles;
+    std::vector<fs::path> m_binaryFiles;
+    EProtocolVersion m_protocol;
+    size_t m_nextJson = 0;
+    size_t m_nextBinary = 0;
+    size_t m_numFiles = 0;
+
+    std::ifstream m_ndjsonFile;
+    std::istream* m_pLines = nullptr;
+    std::string m_ndjsonLabel;
+    size_t m_lineNumber = 0;
+
+    bool m_stdinBinary = false;
+    std::unique_ptr<ByteBuffer> m_pBuffer;
+    std::string m_bufferLabel;
+    size_t m_bufferSize = 0;
+};
+
+struct Failure
+{
+    std::string label;
+    std::string hash;
+    std::string reason;
+};
+
+static int VerifyBatch(int argc, char* argv[])
+{
+    const std::optional<std::string> dir = GetArg(argc, argv, "dir");
+    const std::optional<std::string> ndjson = GetArg(argc, argv, "ndjson");
+    const std::optional<std::string> binary = GetArg(argc, argv, "binary");
+    if (dir.has_value() + ndjson.has_value() + binary.has_value() != 1)
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    const size_t batchSize = (std::max)((size_t)1, (size_t)std::stoull(GetArg(argc, argv, "batch-size").value_or("1000")));
+    const EProtocolVersion protocol = GetArg(argc, argv, "protocol").value_or("2") == "1" ? EProtocolVersion::V1 : EProtocolVersion::V2;
+
+    // The validator runs on the shared pool, which has to be sized before its first use.
+    ThreadManagerAPI::ConfigureThreadPool((size_t)std::stoull(GetArg(argc, argv, "threads").value_or("0")));
+    const size_t numThreads = ThreadManagerAPI::GetThreadPool().GetNumThreads();
+
+    std::unique_ptr<TxReader> pReader;
+    try
+    {
+        if (dir.has_value())
+        {
+            pReader = TxReader::FromDirectory(fs::u8path(dir.value()), protocol);
+        }
+        else if (ndjson.has_value())
+        {
+            pReader = TxReader::FromNDJSON(ndjson.value(), protocol);
+        }
+        else
+        {
+            pReader = TxReader::FromBinary(binary.value(), protocol);
+        }
+    }
+    catch (std::exception& e)
+    {
+        std::cout << e.what() << std::endl;
+        return -1;
+    }
+
+    size_t numRead = 0;
+    size_t numValid = 0;
+    size_t numOutputs = 0;
+    size_t numKernels = 0;
+    std::vector<Failure> parseFailures;
+    std::vector<Failure> validationFailures;
+    Clock::duration readTime{ 0 };
+    Clock::duration validateTime{ 0 };
+
+    const Clock::time_point start = Clock::now();
+    bool more = true;
+    while (more)
+    {
+        std::vector<TransactionPtr> transactions;
+        std::vector<std::string> labels;
+
+        const Clock::time_point readStart = Clock::now();
+        InputTx tx;
+        while (transactions.size() < batchSize && (more = pReader->Next(tx)))
+        {
+            ++numRead;
+            if (tx.pTransaction == nullptr)
+            {
+                parseFailures.push_back(Failure{ tx.label, "", tx.error });
+                continue;
+            }
+
+            numOutputs += tx.pTransaction->GetOutputs().size();
+            numKernels += tx.pTransaction->GetKernels().size();
+            transactions.push_back(tx.pTransaction);
+            labels.push_back(tx.label);
+        }
+        readTime += Clock::now() - readStart;
+
+        if (transactions.empty())
+        {
+            continue;
+        }
+
+        const Clock::time_point validateStart = Clock::now();
+        const std::vector<bool> valid = TransactionValidator().ValidateBatch(transactions);
+        validateTime += Clock::now() - validateStart;
+
+        for (size_t i = 0; i < transactions.size(); i++)
+        {
+            if (valid[i])
+            {
+                ++numValid;
+                continue;
+            }
+
+            // Batches only say which txs were rejected, so each rejected one is validated again on its own to learn why.
+            std::string reason = "Rejected by batch verification";
+            try
+            {
+                TransactionValidator().Validate(*transactions[i]);
+            }
+            catch (std::exception& e)
+            {
+                reason = e.what();
+            }
+
+            validationFailures.push_back(Failure{ labels[i], transactions[i]->GetHash().ToHex(), reason });
+        }
+    }
+
+    const double seconds = ToSeconds(Clock::now() - start);
+    const double validateSeconds = ToSeconds(validateTime);
+    const size_t numParsed = numRead - parseFailures.size();
+
+    printf("Verified %zu txs from %zu files in %.2fs on %zu threads\n", numRead, pReader->GetNumFiles(), seconds, numThreads);
+    printf("  valid:             %zu\n", numValid);
+    printf("  invalid:           %zu\n", validationFailures.size());
+    printf("  unreadable:        %zu\n", parseFailures.size());
+    printf("  read/parse:        %.2fs\n", ToSeconds(readTime));
+    printf("  validate:          %.2fs\n", validateSeconds);
+    if (validateSeconds > 0)
+    {
+        printf("  txs/sec:           %.1f\n", numParsed / validateSeconds);
+        printf("  rangeproofs/sec:   %.1f\n", numOutputs / validateSeconds);
+        printf("  kernels/sec:       %.1f\n", numKernels / validateSeconds);
+    }
+
+    for (const Failure& failure : parseFailures)
+    {
+        printf("UNREADABLE %s: %s\n", failure.label.c_str(), failure.reason.c_str());
+    }
+
+    for (const Failure& failure : validationFailures)
+    {
+        printf("INVALID %s (%s): %s\n", failure.label.c_str(), failure.hash.c_str(), failure.reason.c_str());
+    }
+
+    const std::optional<std::string> jsonPath = GetArg(argc, argv, "json");
+    if (jsonPath.has_value())
+    {
+        Json::Value json;
+        json["txs"] = Json::UInt64(numRead);
+        json["files"] = Json::UInt64(pReader->GetNumFiles());
+        json["threads"] = Json::UInt64(numThreads);
+        json["valid"] = Json::UInt64(numValid);
+        json["invalid"] = Json::UInt64(validationFailures.size());
+        json["unreadable"] = Json::UInt64(parseFailures.size());
+        json["total_secs"] = seconds;
+        json["read_secs"] = ToSeconds(readTime);
+        json["validate_secs"] = validateSeconds;
+        json["txs_per_sec"] = validateSeconds > 0 ? numParsed / validateSeconds : 0.0;
+        json["rangeproofs_per_sec"] = validateSeconds > 0 ? numOutputs / validateSeconds : 0.0;
+        json["kernels_per_sec"] = validateSeconds > 0 ? numKernels / validateSeconds : 0.0;
+
+        Json::Value failuresJSON(Json::arrayValue);
+        for (const Failure& failure : parseFailures)
+        {
+            Json::Value failureJSON;
+            failureJSON["source"] = failure.label;
+            failureJSON["reason"] = failure.reason;
+            failuresJSON.append(failureJSON);
+        }
+
+        for (const Failure& failure : validationFailures)
+        {
+            Json::Value failureJSON;
+            failureJSON["source"] = failure.label;
+            failureJSON["hash"] = failure.hash;
+            failureJSON["reason"] = failure.reason;
+            failuresJSON.append(failureJSON);
+        }
+
+        json["failures"] = failuresJSON;
+        FileUtil::WriteTextToFile(fs::u8path(jsonPath.value()), JsonUtil::WriteCondensed(json));
+    }
+
+    return (parseFailures.empty() && validationFailures.empty()) ? 0 : 1;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return -1;
+    }
+
+    if (strcmp(argv[1], "batch") == 0)
+    {
+        return VerifyBatch(argc, argv);
+    }
+
+    return VerifySingle(argv[1]);
+}
@@ -0,0 +1,447 @@
+#include <TestServer.h>
+#include <TestChain.h>
+#include <TestWallet.h>
+
+#include <API/Wallet/Owner/OwnerServer.h>
+#include <API/Wallet/Owner/Models/SendCriteria.h>
+#include <Common/Logger.h>
+#include <Common/Util/FileUtil.h>
+#include <Config/Config.h>
+#include <Core/Util/JsonUtil.h>
+#include <Net/Clients/RPC/RPCClient.h>
+#include <Wallet/WalletManager.h>
+#include <Server/Node/NodeClients/RPCNodeClient.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+//
+// Drives the owner (and optionally foreign) wallet APIs over HTTP with concurrent workers, and reports the latency percentiles
+// and throughput of each method, for sizing wallet servers.
+//
+// Each round, a worker logs into one of its wallets, checks its balance, sends 1 grin by slatepack to the next wallet,
+// has that wallet receive it, finalizes it (without posting), lists its txs, and logs out.
+// Every send locks an output until its tx confirms, so each wallet needs one spendable output per round.
+//
+// By default, the wallets are funded by mining on an in-process chain (AUTOMATED_TESTING, like the tests).
+// With --node, they're created (or logged into, if they exist in --data-dir) against a real node's API,
+// and need to be funded before rerunning, which the tool prints the addresses for.
+//
+
+using Clock = std::chrono::steady_clock;
+
+static const uint16_t OWNER_PORT = 3421;
+static const uint64_t SEND_AMOUNT = 1'000'000'000;
+static const uint64_t FEE_BASE = 1'000'000;
+
+static void PrintUsage()
+{
+    std::cout << "Usage: wallet_bench [--wallets=<n>] [--concurrency=<n>] [--rounds=<n>] [--receive=owner|foreign] [--json=<path>]" << std::endl;
+    std::cout << "                    [--node=<host>:<port> --data-dir=<dir> [--floonet] [--password=<password>]]" << std::endl;
+}
+
+static std::optional<std::string> GetArg(int argc, char* argv[], const std::string& name)
+{
+    const std::string prefix = "--" + name + "=";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strncmp(argv[i], prefix.c_str(), prefix.size()) == 0)
+        {
+            return std::string(argv[i] + prefix.size());
+        }
+    }
+
+    return std::nullopt;
+}
+
+static bool HasFlag(int argc, char* argv[], const std::string& name)
+{
+    const std::string flag = "--" + name;
+    for (int i = 1; i < argc; i++)
+    {
+        if (flag == argv[i])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static size_t GetSizeArg(int argc, char* argv[], const std::string& name, const size_t defaultValue)
+{
+    const std::optional<std::string> value = GetArg(argc, argv, name);
+    return value.has_value() ? (size_t)std::stoull(value.value()) : defaultValue;
+}
+
+//
+// Latencies of every call, by method.
+//
+class MethodStats
+{
+public:
+    struct Summary
+    {
+        std::string method;
+        size_t calls;
+        size_t errors;
+        double p50;
+        double p90;
+        double p99;
+        double max;
+    };
+
+    void Record(const std::string& method, const double latencyMs, const bool success)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Method& stats = m_methods[method];
+        stats.latenciesMs.push_back(latencyMs);
+        if (!success)
+        {
+            ++stats.errors;
+        }
+    }
+
+    std::vector<Summary> Summarize() const
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        std::vector<Summary> summaries;
+        for (const auto& entry : m_methods)
+        {
+            std::vector<double> sorted = entry.second.latenciesMs;
+            std::sort(sorted.begin(), sorted.end());
+            summaries.push_back(Summary{
+                entry.first,
+                sorted.size(),
+                entry.second.errors,
+                Percentile(sorted, 50),
+                Percentile(sorted, 90),
+                Percentile(sorted, 99),
+                sorted.empty() ? 0.0 : sorted.back()
+            });
+        }
+
+        return summaries;
+    }
+
+private:
+    struct Method
+    {
+        std::vector<double> latenciesMs;
+        size_t errors = 0;
+    };
+
+    static double Percentile(const std::vector<double>& sorted, const double percentile)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+
+        const size_t rank = (size_t)std::ceil((percentile / 100.0) * sorted.size());
+        return sorted[(std::max)(rank, (size_t)1) - 1];
+    }
+
+    mutable std::mutex m_mutex;
+    std::map<std::string, Method> m_methods;
+};
+
+struct BenchWallet
+{
+    std::string username;
+    TestWallet::Ptr pWallet;
+    std::string address;
+};
+
+//
+// Invokes the method, recording its latency. Returns the result, or std::nullopt if it failed.
+//
+static std::optional<Json::Value> Invoke(
+    MethodStats& stats,
+    const std::string& method,
+    const std::string& path,
+    const uint16_t port,
+    const Json::Value& params)
+{
+    const auto start = Clock::now();
+    std::optional<Json::Value> resultOpt = std::nullopt;
+    try
+    {
+        RPC::Response response = HttpRpcClient().Invoke("127.0.0.1", path, port, RPC::Request::BuildRequest(method, params));
+        if (response.GetResult().has_value())
+        {
+            resultOpt = response.GetResult();
+        }
+        else if (response.GetError().has_value())
+        {
+            LOG_WARNING_F("{} failed: {}", method, response.GetError().value().GetMsg());
+        }
+    }
+    catch (std::exception& e)
+    {
+        LOG_WARNING_F("{} failed: {}", method, e.what());
+    }
+
+    stats.Record(method, std::chrono::duration<double, std::milli>(Clock::now() - start).count(), resultOpt.has_value());
+    return resultOpt;
+}
+
+static Json::Value TokenParams(const std::string& token)
+{
+    Json::Value params;
+    params["session_token"] = token;
+    return params;
+}
+
+static void RunRound(MethodStats& stats, const BenchWallet& sender, const BenchWallet& receiver, const std::string& password, const bool foreignReceive)
+{
+    Json::Value loginParams;
+    loginParams["username"] = sender.username;
+    loginParams["password"] = password;
+    std::optional<Json::Value> loginOpt = Invoke(stats, "login", "/v2", OWNER_PORT, loginParams);
+    if (!loginOpt.has_value())
+    {
+        return;
+    }
+
+    const std::string token = JsonUtil::GetRequiredString(loginOpt.value(), "session_token");
+    Invoke(stats, "get_balance", "/v2", OWNER_PORT, TokenParams(token));
+
+    SendCriteria sendCriteria(
+        SessionToken::FromBase64(token),
+        SEND_AMOUNT,
+        FEE_BASE,
+        (uint8_t)1,
+        SelectionStrategyDTO(ESelectionStrategy::SMALLEST, {}),
+        std::make_optional<std::string>(receiver.address),
+        std::nullopt
+    );
+    std::optional<Json::Value> sendOpt = Invoke(stats, "send", "/v2", OWNER_PORT, sendCriteria.ToJSON());
+    if (sendOpt.has_value())
+    {
+        Json::Value finalizeParams = TokenParams(token);
+        std::optional<Json::Value> receiveOpt = std::nullopt;
+        if (foreignReceive)
+        {
+            // The foreign API takes and returns the slate itself, like a wallet reached over http would.
+            Json::Value receiveParams(Json::arrayValue);
+            receiveParams.append(JsonUtil::GetRequiredField(sendOpt.value(), "slate"));
+            receiveParams.append(Json::nullValue);
+            receiveParams.append(Json::nullValue);
+            receiveOpt = Invoke(stats, "receive_tx", "/v2/foreign", receiver.pWallet->GetListenerPort(), receiveParams);
+            if (receiveOpt.has_value())
+            {
+                finalizeParams["slate"] = receiveOpt.value().isMember("Ok") ? receiveOpt.value()["Ok"] : receiveOpt.value();
+            }
+        }
+        else
+        {
+            Json::Value receiveParams = TokenParams(receiver.pWallet->GetToken().ToBase64());
+            receiveParams["slatepack"] = JsonUtil::GetRequiredString(sendOpt.value(), "slatepack");
+            receiveOpt = Invoke(stats, "receive", "/v2", OWNER_PORT, receiveParams);
+            if (receiveOpt.has_value())
+            {
+                finalizeParams["slatepack"] = JsonUtil::GetRequiredString(receiveOpt.value(), "slatepack");
+            }
+        }
+
+        if (receiveOpt.has_value())
+        {
+            Invoke(stats, "finalize", "/v2", OWNER_PORT, finalizeParams);
+        }
+    }
+
+    Invoke(stats, "list_txs", "/v2", OWNER_PORT, TokenParams(token));
+    Invoke(stats, "logout", "/v2", OWNER_PORT, TokenParams(token));
+}
+
+static BenchWallet OpenWallet(const IWalletManagerPtr& pWalletManager, const std::string& username, const std::string& password)
+{
+    const std::vector<GrinStr> accounts = pWalletManager->GetAllAccounts();
+    if (std::find(accounts.cbegin(), accounts.cend(), username) != accounts.cend())
+    {
+        LoginResponse response = pWalletManager->Login(LoginCriteria(username, SecureString(password)), nullptr);
+        auto pWallet = TestWallet::Create(pWalletManager, response.GetToken(), response.GetPort(), std::nullopt);
+        return BenchWallet{ username, pWallet, pWallet->GetSlatepackAddress().ToString() };
+    }
+
+    CreateWalletResponse response = pWalletManager->InitializeNewWallet(CreateWalletCriteria(username, SecureString(password), 24), nullptr);
+    auto pWallet = TestWallet::Create(pWalletManager, response.GetToken(), response.GetListenerPort(), std::nullopt);
+    return BenchWallet{ username, pWallet, response.GetAddress().ToString() };
+}
+
+int main(int argc, char* argv[])
+{
+    if (HasFlag(argc, argv, "help"))
+    {
+        PrintUsage();
+        return 0;
+    }
+
+    const size_t numWallets = (std::max)(GetSizeArg(argc, argv, "wallets", 8), (size_t)2);
+    const size_t concurrency = (std::min)((std::max)(GetSizeArg(argc, argv, "concurrency", 4), (size_t)1), numWallets);
+    const size_t rounds = (std::max)(GetSizeArg(argc, argv, "rounds", 10), (size_t)1);
+    const bool foreignReceive = GetArg(argc, argv, "receive").value_or("owner") == "foreign";
+    const std::string password = GetArg(argc, argv, "password").value_or("P@ssw0rd123!");
+    const std::optional<std::string> nodeOpt = GetArg(argc, argv, "node");
+
+    try
+    {
+        TestServer::Ptr pTestServer = nullptr;
+        std::unique_ptr<TestChain> pChain = nullptr;
+        ConfigPtr pConfig = nullptr;
+        INodeClientPtr pNodeClient = nullptr;
+        if (nodeOpt.has_value())
+        {
+            const std::optional<std::string> dataDir = GetArg(argc, argv, "data-dir");
+            const size_t colon = nodeOpt.value().rfind(':');
+            if (!dataDir.has_value() || colon == std::string::npos)
+            {
+                PrintUsage();
+                return -1;
+            }
+
+            Json::Value configJSON;
+            configJSON[ConfigProps::DATA_PATH] = dataDir.value();
+            pConfig = Config::Load(configJSON, HasFlag(argc, argv, "floonet") ? EEnvironmentType::FLOONET : EEnvironmentType::MAINNET);
+            LoggerAPI::Initialize(pConfig->GetLogDirectory(), pConfig->GetLogLevel());
+            pNodeClient = RPCNodeClient::Create(nodeOpt.value().substr(0, colon), (uint16_t)std::stoul(nodeOpt.value().substr(colon + 1)));
+        }
+        else
+        {
+            // TestChain backdates blocks by 1000s plus their height, so longer chains end up too far in the future.
+            if (numWallets * rounds > 1500)
+            {
+                std::cout << "Funding more than 1500 outputs (wallets * rounds) isn't supported" << std::endl;
+                return -1;
+            }
+
+            const fs::path dataDir = Config::Default(EEnvironmentType::AUTOMATED_TESTING)->GetDataDirectory() / "WALLET_BENCH";
+            FileUtil::RemoveFile(dataDir);
+
+            Json::Value configJSON;
+            configJSON[ConfigProps::DATA_PATH] = dataDir.u8string();
+            pConfig = Config::Load(configJSON, EEnvironmentType::AUTOMATED_TESTING);
+            pTestServer = TestServer::Create(pConfig);
+            pChain = std::make_unique<TestChain>(pTestServer);
+            pNodeClient = pTestServer->GetNodeClient();
+        }
+
+        IWalletManagerPtr pWalletManager = WalletAPI::CreateWalletManager(*pConfig, pNodeClient);
+        OwnerServer::UPtr pOwnerServer = OwnerServer::Create(nullptr, pWalletManager, pConfig->GetServerConfig().GetOwnerAPIConfig());
+
+        std::vector<BenchWallet> wallets;
+        for (size_t i = 0; i < numWallets; i++)
+        {
+            wallets.push_back(OpenWallet(pWalletManager, "bench_" + std::to_string(i), password));
+        }
+
+        if (pChain != nullptr)
+        {
+            // Coinbases mature after 25 blocks in AUTOMATED_TESTING, so the last wallet mines a few extra.
+            for (size_t i = 0; i < numWallets; i++)
+            {
+                pChain->MineChain(wallets[i].pWallet, rounds + (i + 1 == numWallets ? 26 : 0));
+            }
+        }
+
+        for (const BenchWallet& wallet : wallets)
+        {
+            wallet.pWallet->RefreshWallet();
+        }
+
+        if (nodeOpt.has_value())
+        {
+            std::cout << "Each wallet needs " << rounds << " spendable outputs of at least 1.1 grin. Addresses:" << std::endl;
+            for (const BenchWallet& wallet : wallets)
+            {
+                std::cout << "  " << wallet.username << ": " << wallet.address << std::endl;
+            }
+        }
+
+        // Worker w sends from wallets w, w + concurrency, ..., each to the next wallet.
+        MethodStats stats;
+        std::atomic<size_t> roundsCompleted = 0;
+        std::vector<std::thread> workers;
+        const auto start = Clock::now();
+        for (size_t w = 0; w < concurrency; w++)
+        {
+            workers.push_back(std::thread([&, w]() {
+                for (size_t round = 0; round < rounds; round++)
+                {
+                    for (size_t i = w; i < wallets.size(); i += concurrency)
+                    {
+                        RunRound(stats, wallets[i], wallets[(i + 1) % wallets.size()], password, foreignReceive);
+                        ++roundsCompleted;
+                    }
+                }
+            }));
+        }
+
+        for (std::thread& worker : workers)
+        {
+            worker.join();
+        }
+
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        const std::vector<MethodStats::Summary> summaries = stats.Summarize();
+
+        printf("\n%zu wallets, %zu workers, %zu rounds (%zu sends) in %.2fs: %.1f sends/sec\n",
+            numWallets, concurrency, rounds, roundsCompleted.load(), seconds, seconds > 0 ? roundsCompleted / seconds : 0.0);
+        printf("  %-12s %8s %8s %10s %10s %10s %10s %10s\n", "method", "calls", "errors", "calls/sec", "p50 ms", "p90 ms", "p99 ms", "max ms");
+        for (const MethodStats::Summary& summary : summaries)
+        {
+            printf("  %-12s %8zu %8zu %10.1f %10.2f %10.2f %10.2f %10.2f\n",
+                summary.method.c_str(), summary.calls, summary.errors, seconds > 0 ? summary.calls / seconds : 0.0,
+                summary.p50, summary.p90, summary.p99, summary.max);
+        }
+
+        const std::optional<std::string> jsonPath = GetArg(argc, argv, "json");
+        if (jsonPath.has_value())
+        {
+            Json::Value json;
+            json["wallets"] = Json::UInt64(numWallets);
+            json["concurrency"] = Json::UInt64(concurrency);
+            json["rounds"] = Json::UInt64(rounds);
+            json["total_secs"] = seconds;
+            for (const MethodStats::Summary& summary : summaries)
+            {
+                Json::Value methodJSON;
+                methodJSON["calls"] = Json::UInt64(summary.calls);
+                methodJSON["errors"] = Json::UInt64(summary.errors);
+                methodJSON["calls_per_sec"] = seconds > 0 ? summary.calls / seconds : 0.0;
+                methodJSON["p50_ms"] = summary.p50;
+                methodJSON["p90_ms"] = summary.p90;
+                methodJSON["p99_ms"] = summary.p99;
+                methodJSON["max_ms"] = summary.max;
+                json["methods"][summary.method] = methodJSON;
+            }
+
+            FileUtil::WriteTextToFile(fs::u8path(jsonPath.value()), JsonUtil::WriteCondensed(json));
+        }
+
+        // The wallets log out before the wallet manager and chain they use are closed.
+        wallets.clear();
+        pOwnerServer.reset();
+        pWalletManager.reset();
+    }
+    catch (std::exception& e)
+    {
+        std::cout << "Benchmark failed: " << e.what() << std::endl;
+        return -1;
+    }
+
+    return 0;
+}